@@ -38,6 +38,7 @@
 #include <string.h>
 
 #include "absyntax.hh"
+#include "intern_pool.hh"
 //#include "../stage1_2/iec.hh" /* required for BOGUS_TOKEN_ID, etc... */
 #include "visitor.hh"
 #include "../main.hh" // required for ERROR() and ERROR_MSG() macros.
@@ -45,6 +46,13 @@
 
 
 
+/* The symbols allocated from the arena, indexed by their id (NULL once destroyed), and
+ * the memory handed out by operator new whose symbol has not yet been constructed.
+ */
+static std::vector<symbol_c *> &arena_symbols(void) {static std::vector<symbol_c *> symbols; return symbols;}
+static std::vector<void *>     &arena_pending(void) {static std::vector<void *>     pending; return pending;}
+
+
 /* The base class of all symbols */
 symbol_c::symbol_c(
                    int first_line, int first_column, const char *ffile, long int first_order,
@@ -61,6 +69,164 @@ symbol_c::symbol_c(
   this->token        = NULL;
   this->datatype     = NULL;
   this->scope        = NULL;
+  this->kind         = symbol_c_kind;
+  this->subtree_kinds = 0;
+  this->cached_type_generation = 0;
+  this->cached_type_category   = 0;
+  this->cached_basetype_decl   = NULL;
+  this->cached_equivtype_decl  = NULL;
+  this->cached_basetype_id     = NULL;
+  this->id           = next_id++;
+
+  /* only the symbols allocated from the arena are destroyed by release_arena() */
+  std::vector<void *> &pending = arena_pending();
+  for (int i = (int)pending.size() - 1; i >= 0; i--)
+    if (pending[i] == (void *)this) {
+      pending.erase(pending.begin() + i);
+      std::vector<symbol_c *> &symbols = arena_symbols();
+      if (symbols.size() <= id) symbols.resize(id + 1, NULL);
+      symbols[id] = this;
+      break;
+    }
+}
+
+
+symbol_c::~symbol_c(void) {
+  std::vector<symbol_c *> &symbols = arena_symbols();
+  if ((id < symbols.size()) && (symbols[id] == this)) symbols[id] = NULL;
+}
+
+
+uint32_t symbol_c::next_id = 0;
+
+
+
+/* the names of the source files, source_file_c::index being the position in the table (0 is not used). */
+static std::vector<const char *>            &source_file_names  (void) {static std::vector<const char *>           names; return names;}
+static std::map<const char *, uint32_t>     &source_file_indexes(void) {static std::map<const char *, uint32_t> indexes; return indexes;}
+
+uint32_t source_file_c::find(const char *name) {
+  /* the symbols are mostly created one file at a time */
+  static const char *last_name  = NULL;
+  static uint32_t    last_index = 0;
+  if (name == last_name) return last_index;
+
+  std::vector<const char *>        &names   = source_file_names();
+  std::map<const char *, uint32_t> &indexes = source_file_indexes();
+  if (names.empty()) names.push_back(NULL);
+  std::map<const char *, uint32_t>::iterator i = indexes.find(name);
+  if (i == indexes.end()) {
+    i = indexes.insert(std::make_pair(name, (uint32_t)names.size())).first;
+    names.push_back(name);
+  }
+  last_name  = name;
+  last_index = i->second;
+  return last_index;
+}
+
+const char *source_file_c::name(uint32_t index) {
+  return source_file_names()[index];
+}
+
+
+void symbol_c::add_subtree_kinds(uint64_t kinds) {
+  /* stop as soon as we reach an ancestor that already has all the bits */
+  for (symbol_c *s = this; (NULL != s) && ((s->subtree_kinds | kinds) != s->subtree_kinds); s = s->parent)
+    s->subtree_kinds |= kinds;
+}
+
+
+
+/* The arena from which all symbols are allocated. */
+#define ARENA_BLOCK_SIZE (1024*1024)
+#define ARENA_ALIGNMENT  16
+
+typedef struct arena_block_s {
+  struct arena_block_s *next;
+  size_t size, used;
+  unsigned long serial;  /* the blocks are numbered in the order they are created, starting at 1 */
+  /* the memory handed out to the symbols follows this header */
+} arena_block_t;
+
+#define ARENA_HEADER_SIZE ((sizeof(arena_block_t) + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1))
+
+static arena_block_t *arena = NULL;  /* the block currently being filled in is the first in the list */
+static unsigned long  arena_serial = 0;  /* of the last block created */
+
+
+void *symbol_c::operator new(size_t size) {
+  size = (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+
+  if ((NULL == arena) || (arena->size - arena->used < size)) {
+    /* very large objects get a block of their own, that is placed behind the current block so it does not waste the current block's free space */
+    size_t block_size = (size > ARENA_BLOCK_SIZE/4)? size : ARENA_BLOCK_SIZE;
+    arena_block_t *block = (arena_block_t *)malloc(ARENA_HEADER_SIZE + block_size);
+    if (NULL == block) ERROR_MSG("out of memory");
+    block->size   = block_size;
+    block->used   = 0;
+    block->serial = ++arena_serial;
+    if ((size > ARENA_BLOCK_SIZE/4) && (NULL != arena)) {
+      block->next = arena->next;
+      arena->next = block;
+    } else {
+      block->next = arena;
+      arena = block;
+    }
+    block->used = size;
+    arena_pending().push_back((char *)block + ARENA_HEADER_SIZE);
+    return (char *)block + ARENA_HEADER_SIZE;
+  }
+
+  void *ptr = (char *)arena + ARENA_HEADER_SIZE + arena->used;
+  arena->used += size;
+  arena_pending().push_back(ptr);
+  return ptr;
+}
+
+
+void symbol_c::operator delete(void *ptr) {
+  /* memory is only returned to the heap by release_arena() */
+  return;
+}
+
+
+symbol_c::arena_mark_t symbol_c::arena_mark(void) {
+  arena_mark_t mark;
+  mark.serial  = (NULL == arena)? 0 : arena->serial;
+  mark.used    = (NULL == arena)? 0 : arena->used;
+  mark.next_id = next_id;
+  return mark;
+}
+
+
+void symbol_c::release_arena(const arena_mark_t &mark) {
+  /* The blocks created after the mark are either in front of the block that was being filled in
+   * at the time (i.e. the one with the mark's serial), or right behind it (the very large objects).
+   * Removing them leaves the list as it was when the mark was taken.
+   */
+  /* First destroy the symbols created after the mark, so they free the memory they allocated on
+   * the heap (the candidate_datatypes, the elements of the lists, ...).
+   */
+  std::vector<symbol_c *> &symbols = arena_symbols();
+  for (size_t i = symbols.size(); i > mark.next_id; i--) {
+    symbol_c *symbol = symbols[i - 1];
+    symbols[i - 1] = NULL;
+    if (NULL != symbol) symbol->~symbol_c();
+  }
+  if (symbols.size() > mark.next_id) symbols.resize(mark.next_id);
+
+  arena_block_t **prev = &arena;
+  while (NULL != *prev) {
+    arena_block_t *block = *prev;
+    if (block->serial > mark.serial) {
+      *prev = block->next;
+      free(block);
+    } else {
+      if (block->serial == mark.serial) block->used = mark.used;
+      prev = &block->next;
+    }
+  }
+  next_id = mark.next_id;
 }
 
 
@@ -78,13 +244,24 @@ token_c::token_c(const char *value,
 
 
 # define LIST_CAP_INIT 8
-# define LIST_CAP_INCR 8
+/* lists shorter than this are searched linearly, without building the hash index */
+# define LIST_INDEX_MIN 16
+
+/* Open addressing hash table with the positions (+1, so 0 marks an empty slot) of the elements with non NULL token_value */
+typedef struct list_index_s {
+  int       size;  /* number of slots, always a power of 2 */
+  int       used;
+  int      *pos;
+  uint32_t *hash;
+} list_index_t;
+
 
 list_c::list_c(
                int fl, int fc, const char *ffile, long int forder,
                int ll, int lc, const char *lfile, long int lorder)
   :symbol_c(fl, fc, ffile, forder, ll, lc, lfile, lorder),c(LIST_CAP_INIT) {
   n = 0;
+  index = NULL;
   elements = (element_entry_t*)malloc(LIST_CAP_INIT*sizeof(element_entry_t));
   if (NULL == elements) ERROR_MSG("out of memory");
 }
@@ -95,12 +272,60 @@ list_c::list_c(symbol_c *elem,
                int ll, int lc, const char *lfile, long int lorder)
   :symbol_c(fl, fc, ffile, forder, ll, lc, lfile, lorder),c(LIST_CAP_INIT) { 
   n = 0;
+  index = NULL;
   elements = (element_entry_t*)malloc(LIST_CAP_INIT*sizeof(element_entry_t));
   if (NULL == elements) ERROR_MSG("out of memory");
   add_element(elem); 
 }
 
 
+/************************************/    
+/* the hash index of the list       */
+/************************************/    
+static void index_add(list_index_t *index, int pos, uint32_t hash) {
+  /* NOTE: with linear probing, of all the elements with the same token_value, the one closest
+   *       to the start of the list is always the first one found, as it was added first.
+   */
+  int slot = hash & (index->size - 1);
+  while (0 != index->pos[slot]) slot = (slot + 1) & (index->size - 1);
+  index->pos [slot] = pos + 1;
+  index->hash[slot] = hash;
+  index->used++;
+}
+
+
+list_c::~list_c(void) {
+  drop_index();
+  free(elements);
+}
+
+
+void list_c::drop_index(void) {
+  if (NULL == index) return;
+  free(index->pos);
+  free(index->hash);
+  free(index);
+  index = NULL;
+}
+
+
+void list_c::build_index(void) {
+  drop_index();
+  int size = 2 * LIST_INDEX_MIN;
+  while (size < 2 * n) size *= 2;
+  index = (list_index_t *)malloc(sizeof(list_index_t));
+  if (NULL == index) ERROR_MSG("out of memory");
+  index->size = size;
+  index->used = 0;
+  index->pos  = (int      *)calloc(size, sizeof(int));
+  index->hash = (uint32_t *)malloc(size * sizeof(uint32_t));
+  if ((NULL == index->pos) || (NULL == index->hash)) ERROR_MSG("out of memory");
+  for (int i = 0; i < n; i++)
+    if (NULL != elements[i].token_value)
+      index_add(index, i, interned_hash(elements[i].token_value));
+}
+
+
 /*******************************************/    
 /* get element in position pos of the list */
 /*******************************************/    
@@ -118,13 +343,22 @@ symbol_c *list_c::find_element(symbol_c *token) {
 }
 
 symbol_c *list_c::find_element(const char *token_value) {
-  // We could use strcasecmp(), but it's best to always use the same 
-  // method of string comparison throughout matiec
-  nocasecmp_c ncc; 
-  for (int i = 0; i < n; i++) 
-    if (!ncc(elements[i].token_value, token_value))
-      return elements[i].symbol;
+  if (NULL == token_value) return NULL;
+  /* identifier_casecmp() is usually a simple pointer comparison, as the token values are interned by flex */
+  if (n < LIST_INDEX_MIN) {
+    for (int i = 0; i < n; i++) 
+      if ((NULL != elements[i].token_value) && (identifier_casecmp(elements[i].token_value, token_value) == 0))
+        return elements[i].symbol;
+    return NULL; // not found
+  }
 
+  if (NULL == index) build_index();
+  uint32_t hash = interned_hash(token_value);
+  for (int slot = hash & (index->size - 1); 0 != index->pos[slot]; slot = (slot + 1) & (index->size - 1)) {
+    int i = index->pos[slot] - 1;
+    if ((index->hash[slot] == hash) && (identifier_casecmp(elements[i].token_value, token_value) == 0))
+      return elements[i].symbol;
+  }
   return NULL; // not found
 }
 
@@ -140,13 +374,19 @@ void list_c::add_element(symbol_c *elem, symbol_c *token) {
 }
 
 void list_c::add_element(symbol_c *elem, const char *token_value) {
+  /* grow geometrically, so appending n elements takes O(n) time */
   if (c <= n)
-    if (!(elements=(element_entry_t*)realloc(elements,(c+=LIST_CAP_INCR)*sizeof(element_entry_t))))
+    if (!(elements=(element_entry_t*)realloc(elements,(c*=2)*sizeof(element_entry_t))))
       ERROR_MSG("out of memory");
   //elements[n++] = {token_value, elem};  // only available from C++11 onwards, best not use it for now.
   elements[n].symbol      = elem;
   elements[n].token_value = token_value;
   n++;
+
+  if (NULL != index) {
+    if (2 * (index->used + 1) > index->size) drop_index(); /* will be rebuilt, larger, when next needed */
+    else if (NULL != token_value) index_add(index, n-1, interned_hash(token_value));
+  }
   
   if (NULL == elem) return;
   /* Sometimes add_element() is called in stage3 or stage4 to temporarily add an AST symbol to the list.
@@ -155,6 +395,7 @@ void list_c::add_element(symbol_c *elem, const char *token_value) {
    * pointer still set to NULL.
    */
   if (NULL == elem->parent) elem->parent = this;  
+  add_subtree_kinds(elem->subtree_kinds);
 
   /* adjust the location parameters, taking into account the new element. */
   if (NULL == first_file) {
@@ -203,12 +444,13 @@ void list_c::insert_element(symbol_c *elem, const char *token_value, int pos) {
   
   /* add new element to end of list. Basically alocate required memory... */
   /* will also increment n by 1 ! */
-  add_element(elem);
+  add_element(elem, token_value);
   /* if not inserting into end position, shift all elements up one position, to open up a slot in pos for new element */
   if(pos < (n-1)){ 
-    for(int i=n-2 ; i>=pos ; --i) elements[i+1] = elements[i];
+    memmove(&elements[pos+1], &elements[pos], (n-1-pos) * sizeof(element_entry_t));
     elements[pos].symbol      = elem;
     elements[pos].token_value = token_value;
+    drop_index(); /* the positions stored in the index are no longer valid */
   }
 }
 
@@ -220,9 +462,10 @@ void list_c::remove_element(int pos) {
   if((pos<0) || (n<=pos)) ERROR;
   
   /* Shift all elements down one position, starting at the entry to delete. */
-  for (int i = pos; i < n-1; i++) elements[i] = elements[i+1];
+  memmove(&elements[pos], &elements[pos+1], (n-1-pos) * sizeof(element_entry_t));
   /* corrent the new size */
   n--;
+  drop_index();
   /* elements = (symbol_c **)realloc(elements, n * sizeof(element_entry_t)); */
   /* TODO: adjust the location parameters, taking into account the removed element. */
 }
@@ -233,6 +476,7 @@ void list_c::remove_element(int pos) {
 /**********************************/    
 void list_c::clear(void) {
   n = 0;
+  drop_index();
   /* TODO: adjust the location parameters, taking into account the removed element. */
 }
 
@@ -241,25 +485,25 @@ void list_c::clear(void) {
 class_name_c::class_name_c(									\
                            int fl, int fc, const char *ffile, long int forder,			\
                            int ll, int lc, const char *lfile, long int lorder)			\
-                        :list_c(fl, fc, ffile, forder, ll, lc, lfile, lorder) {}		\
+                        :list_c(fl, fc, ffile, forder, ll, lc, lfile, lorder) {set_kind(class_name_c##_kind);}		\
 class_name_c::class_name_c(symbol_c *elem, 							\
                            int fl, int fc, const char *ffile, long int forder,			\
                            int ll, int lc, const char *lfile, long int lorder)			\
-			:list_c(elem, fl, fc, ffile, forder, ll, lc, lfile, lorder) {}		\
+			:list_c(elem, fl, fc, ffile, forder, ll, lc, lfile, lorder) {set_kind(class_name_c##_kind);}		\
 void *class_name_c::accept(visitor_c &visitor) {return visitor.visit(this);}
 
 #define SYM_TOKEN(class_name_c, ...)								\
 class_name_c::class_name_c(const char *value, 							\
                            int fl, int fc, const char *ffile, long int forder,			\
                            int ll, int lc, const char *lfile, long int lorder)			\
-			:token_c(value, fl, fc, ffile, forder, ll, lc, lfile, lorder) {}	\
+			:token_c(value, fl, fc, ffile, forder, ll, lc, lfile, lorder) {set_kind(class_name_c##_kind);}	\
 void *class_name_c::accept(visitor_c &visitor) {return visitor.visit(this);}
 
 #define SYM_REF0(class_name_c, ...)								\
 class_name_c::class_name_c(									\
                            int fl, int fc, const char *ffile, long int forder,			\
                            int ll, int lc, const char *lfile, long int lorder)			\
-			  :symbol_c(fl, fc, ffile, forder, ll, lc, lfile, lorder) {}		\
+			  :symbol_c(fl, fc, ffile, forder, ll, lc, lfile, lorder) {set_kind(class_name_c##_kind);}		\
 void *class_name_c::accept(visitor_c &visitor) {return visitor.visit(this);}
 
 
@@ -269,7 +513,8 @@ class_name_c::class_name_c(symbol_c *ref1,							\
                            int ll, int lc, const char *lfile, long int lorder)			\
 			  :symbol_c(fl, fc, ffile, forder, ll, lc, lfile, lorder) {		\
   this->ref1 = ref1;										\
-  if  (NULL != ref1)   ref1->parent = this;							\
+  if  (NULL != ref1)   {ref1->parent = this; subtree_kinds |= ref1->subtree_kinds;}							\
+  set_kind(class_name_c##_kind);							\
 }												\
 void *class_name_c::accept(visitor_c &visitor) {return visitor.visit(this);}
 
@@ -282,8 +527,9 @@ class_name_c::class_name_c(symbol_c *ref1,							\
 			  :symbol_c(fl, fc, ffile, forder, ll, lc, lfile, lorder) {		\
   this->ref1 = ref1;										\
   this->ref2 = ref2;										\
-  if  (NULL != ref1)   ref1->parent = this;							\
-  if  (NULL != ref2)   ref2->parent = this;										\
+  if  (NULL != ref1)   {ref1->parent = this; subtree_kinds |= ref1->subtree_kinds;}							\
+  if  (NULL != ref2)   {ref2->parent = this; subtree_kinds |= ref2->subtree_kinds;}										\
+  set_kind(class_name_c##_kind);							\
 }												\
 void *class_name_c::accept(visitor_c &visitor) {return visitor.visit(this);}
 
@@ -298,9 +544,10 @@ class_name_c::class_name_c(symbol_c *ref1,							\
   this->ref1 = ref1;										\
   this->ref2 = ref2;										\
   this->ref3 = ref3;										\
-  if  (NULL != ref1)   ref1->parent = this;							\
-  if  (NULL != ref2)   ref2->parent = this;							\
-  if  (NULL != ref3)   ref3->parent = this;							\
+  if  (NULL != ref1)   {ref1->parent = this; subtree_kinds |= ref1->subtree_kinds;}							\
+  if  (NULL != ref2)   {ref2->parent = this; subtree_kinds |= ref2->subtree_kinds;}							\
+  if  (NULL != ref3)   {ref3->parent = this; subtree_kinds |= ref3->subtree_kinds;}							\
+  set_kind(class_name_c##_kind);							\
 }												\
 void *class_name_c::accept(visitor_c &visitor) {return visitor.visit(this);}
 
@@ -317,10 +564,11 @@ class_name_c::class_name_c(symbol_c *ref1,							\
   this->ref2 = ref2;										\
   this->ref3 = ref3;										\
   this->ref4 = ref4;										\
-  if  (NULL != ref1)   ref1->parent = this;							\
-  if  (NULL != ref2)   ref2->parent = this;							\
-  if  (NULL != ref3)   ref3->parent = this;							\
-  if  (NULL != ref4)   ref4->parent = this;							\
+  if  (NULL != ref1)   {ref1->parent = this; subtree_kinds |= ref1->subtree_kinds;}							\
+  if  (NULL != ref2)   {ref2->parent = this; subtree_kinds |= ref2->subtree_kinds;}							\
+  if  (NULL != ref3)   {ref3->parent = this; subtree_kinds |= ref3->subtree_kinds;}							\
+  if  (NULL != ref4)   {ref4->parent = this; subtree_kinds |= ref4->subtree_kinds;}							\
+  set_kind(class_name_c##_kind);							\
 }												\
 void *class_name_c::accept(visitor_c &visitor) {return visitor.visit(this);}
 
@@ -339,11 +587,12 @@ class_name_c::class_name_c(symbol_c *ref1,							\
   this->ref3 = ref3;										\
   this->ref4 = ref4;										\
   this->ref5 = ref5;										\
-  if  (NULL != ref1)   ref1->parent = this;							\
-  if  (NULL != ref2)   ref2->parent = this;							\
-  if  (NULL != ref3)   ref3->parent = this;							\
-  if  (NULL != ref4)   ref4->parent = this;							\
-  if  (NULL != ref5)   ref5->parent = this;							\
+  if  (NULL != ref1)   {ref1->parent = this; subtree_kinds |= ref1->subtree_kinds;}							\
+  if  (NULL != ref2)   {ref2->parent = this; subtree_kinds |= ref2->subtree_kinds;}							\
+  if  (NULL != ref3)   {ref3->parent = this; subtree_kinds |= ref3->subtree_kinds;}							\
+  if  (NULL != ref4)   {ref4->parent = this; subtree_kinds |= ref4->subtree_kinds;}							\
+  if  (NULL != ref5)   {ref5->parent = this; subtree_kinds |= ref5->subtree_kinds;}							\
+  set_kind(class_name_c##_kind);							\
 }												\
 void *class_name_c::accept(visitor_c &visitor) {return visitor.visit(this);}
 
@@ -365,12 +614,13 @@ class_name_c::class_name_c(symbol_c *ref1,							\
   this->ref4 = ref4;										\
   this->ref5 = ref5;										\
   this->ref6 = ref6;										\
-  if  (NULL != ref1)   ref1->parent = this;							\
-  if  (NULL != ref2)   ref2->parent = this;							\
-  if  (NULL != ref3)   ref3->parent = this;							\
-  if  (NULL != ref4)   ref4->parent = this;							\
-  if  (NULL != ref5)   ref5->parent = this;							\
-  if  (NULL != ref6)   ref6->parent = this;							\
+  if  (NULL != ref1)   {ref1->parent = this; subtree_kinds |= ref1->subtree_kinds;}							\
+  if  (NULL != ref2)   {ref2->parent = this; subtree_kinds |= ref2->subtree_kinds;}							\
+  if  (NULL != ref3)   {ref3->parent = this; subtree_kinds |= ref3->subtree_kinds;}							\
+  if  (NULL != ref4)   {ref4->parent = this; subtree_kinds |= ref4->subtree_kinds;}							\
+  if  (NULL != ref5)   {ref5->parent = this; subtree_kinds |= ref5->subtree_kinds;}							\
+  if  (NULL != ref6)   {ref6->parent = this; subtree_kinds |= ref6->subtree_kinds;}							\
+  set_kind(class_name_c##_kind);							\
 }												\
 void *class_name_c::accept(visitor_c &visitor) {return visitor.visit(this);}
 
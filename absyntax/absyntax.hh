@@ -111,8 +111,11 @@ class const_value_c {
                    cs_overflow     /* result produced overflow or underflow --> const_value is not valid! */
                  } const_status_t;
  
-    template<typename value_type> class const_value__ {
-      const_status_t status;  
+    /* NOTE: packed, with the status in a single byte, as every symbol_c has a const_value_c
+     *       (29 bytes, instead of the 56 bytes of the aligned version).
+     */
+    template<typename value_type> class __attribute__((packed)) const_value__ {
+      uint8_t        status;  /* const_status_t */
       value_type     value;
       
       public:
@@ -157,6 +160,56 @@ class const_value_c {
 // A forward declaration
 class token_c;
 
+
+/* The name of the source file of a symbol, stored as a 32 bit index into a table of all the names,
+ * instead of a pointer. It converts to and from the (const char *) name, which must never be freed
+ * (as is the case for the names kept by stage 1_2).
+ */
+class source_file_c {
+  private:
+    uint32_t index;  /* 0 for NULL */
+    static uint32_t    find(const char *name);
+    static const char *name(uint32_t index);
+
+  public:
+    source_file_c(const char *name = NULL) {index = (NULL == name)? 0 : find(name);}
+    operator const char *(void) const {return (0 == index)? NULL : name(index);}
+    const char *c_str(void) const {return *this;}
+};
+
+
+
+/* Each class declared in absyntax.def has a node kind (stored in symbol_c::kind), so the
+ * kind of a symbol may be checked without a virtual call, a dynamic_cast, or typeid.
+ */
+#define SYM_LIST(class_name_c, ...)                                      class_name_c##_kind,
+#define SYM_TOKEN(class_name_c, ...)                                     class_name_c##_kind,
+#define SYM_REF0(class_name_c, ...)                                      class_name_c##_kind,
+#define SYM_REF1(class_name_c, ref1, ...)                                class_name_c##_kind,
+#define SYM_REF2(class_name_c, ref1, ref2, ...)                          class_name_c##_kind,
+#define SYM_REF3(class_name_c, ref1, ref2, ref3, ...)                    class_name_c##_kind,
+#define SYM_REF4(class_name_c, ref1, ref2, ref3, ref4, ...)              class_name_c##_kind,
+#define SYM_REF5(class_name_c, ref1, ref2, ref3, ref4, ref5, ...)        class_name_c##_kind,
+#define SYM_REF6(class_name_c, ref1, ref2, ref3, ref4, ref5, ref6, ...)  class_name_c##_kind,
+
+typedef enum {
+  symbol_c_kind = 0, /* symbol_c, token_c and list_c themselves */
+  #include "absyntax.def"
+  last_symbol_kind
+} symbol_kind_t;
+
+#undef SYM_LIST
+#undef SYM_TOKEN
+#undef SYM_REF0
+#undef SYM_REF1
+#undef SYM_REF2
+#undef SYM_REF3
+#undef SYM_REF4
+#undef SYM_REF5
+#undef SYM_REF6
+
+
+
 /* The base class of all symbols */
 class symbol_c {
 
@@ -182,14 +235,33 @@ class symbol_c {
     token_c  *token;
     
     /* Line number for the purposes of error checking.  */
+    /* NOTE: 32 bits each, as every symbol has them */
     int first_line;
     int first_column;
-    const char *first_file;  /* filename referenced by first line/column */
-    long int first_order;    /* relative order in which it is read by lexcial analyser */
+    source_file_c first_file;  /* filename referenced by first line/column */
+    int32_t first_order;       /* relative order in which it is read by lexcial analyser */
     int last_line;
     int last_column;
-    const char *last_file;  /* filename referenced by last line/column */
-    long int last_order;    /* relative order in which it is read by lexcial analyser */
+    source_file_c last_file;   /* filename referenced by last line/column */
+    int32_t last_order;        /* relative order in which it is read by lexcial analyser */
+
+    /* The kind of this symbol (see symbol_kind_t). Set by the constructor. */
+    symbol_kind_t kind;
+    /* A summary of the kinds of all the symbols in the subtree rooted at this symbol (including itself),
+     * with the bit (kind % 64) set for each kind. It is kept up to date as the AST is built, and lets
+     * a visitor skip whole subtrees that cannot contain the symbols it is interested in.
+     * NOTE: different kinds share the same bit, so this can only tell that a kind of symbol is NOT in the subtree!
+     */
+    uint64_t subtree_kinds;
+    static uint64_t kind_bit(symbol_kind_t kind) {return ((uint64_t)1) << (kind % 64);}
+    /* returns false if the subtree is sure not to contain any symbol of this kind */
+    bool may_contain(symbol_kind_t kind) {return (0 != (subtree_kinds & kind_bit(kind)));}
+    /* add kinds to the summary of this symbol, and of all its ancestors */
+    void add_subtree_kinds(uint64_t kinds);
+  protected:
+    /* called by the constructor of each class declared in absyntax.def */
+    void set_kind(symbol_kind_t kind_) {kind = kind_; subtree_kinds |= kind_bit(kind_);}
+  public:
 
 
     /*
@@ -220,15 +292,39 @@ class symbol_c {
      */
     typedef std::multimap<std::string, symbol_c *, nocasecmp_c> enumvalue_symtable_t;
     
+    /*** Call bindings ***/
+    /* The value passed by a function or FB call to each parameter of the called POU, in the order the
+     * parameters are returned by function_param_iterator_c (NULL for those not passed).
+     * Stored by stage 3 (narrow_candidate_datatypes_c) in the calls, see function_call_param_iterator_c::bind().
+     */
+    class call_binding_t {
+      public:
+        bool bound;
+        std::vector <symbol_c *> param_values;
+        call_binding_t(void) {bound = false;}
+    };
+    
+    /*** Cached datatype queries ***/
+    /* The results of search_base_type_c and get_datatype_info_c for this symbol, stored here the first time they are
+     * computed, so that later queries are simple field reads. These are only valid while cached_type_generation
+     * is equal to search_base_type_c::cache_generation (which changes whenever a new AST is handled).
+     */
+    unsigned int cached_type_generation;
+    unsigned int cached_type_category;   /* flags from get_datatype_info_c. 0 if not yet determined */
+    symbol_c    *cached_basetype_decl;
+    symbol_c    *cached_equivtype_decl;
+    symbol_c    *cached_basetype_id;
+    
     /*
      * Annotations produced during stage 4
      */
     /* Since we support several distinct stage_4 implementations, having explicit entries for each
      * possible use would quickly get out of hand.
-     * We therefore simply add a map, that each stage 4 may use for all its needs.
+     * Each stage 4 therefore keeps its annotations in its own annotation_table_c (see below), indexed
+     * by this id. It is unique to each symbol, and assigned (in sequence) when the symbol is created.
      */
-    typedef std::map<std::string, symbol_c *> anotations_map_t;
-    anotations_map_t anotations_map;
+    uint32_t id;
+    static uint32_t next_id;
     
 
   public:
@@ -239,9 +335,54 @@ class symbol_c {
 
     /* default destructor */
     /* must be virtual so compiler does not complain... */ 
-    virtual ~symbol_c(void) {return;};
+    virtual ~symbol_c(void);
 
     virtual void *accept(visitor_c &visitor) {return NULL;};
+
+    /* All symbols are allocated from a common arena (a few large memory blocks), instead of
+     * each one being allocated individually from the heap. The AST will take up less memory
+     * and have better locality, which speeds up all the visitors that iterate over it.
+     * NOTE: calling delete on a symbol will run its destructor, but its memory is only 
+     *       returned when the arena is released (see release_arena()).
+     */
+    static void *operator new   (size_t size);
+    static void  operator delete(void *ptr);
+    /* A position in the arena, i.e. the symbols created so far */
+    typedef struct {
+      unsigned long serial;   /* of the block being filled in */
+      size_t        used;     /* of that block */
+      uint32_t      next_id;  /* the id of the next symbol */
+    } arena_mark_t;
+    static arena_mark_t arena_mark(void);
+    /* Release the memory of all the symbols created since the mark was taken (e.g. the AST of a
+     * file compiled with the -B or -S command line options), so that it is reused by the next ones.
+     * Any of these symbols still in use will be left dangling, including any pointer to them kept
+     * in the caches of the visitors (see absyntax_utils_reset()). Their ids are reused too, so the
+     * annotation_table_c of these symbols must be cleared.
+     * The destructors of these symbols (not yet deleted) are called before their memory is released.
+     */
+    static void release_arena(const arena_mark_t &mark);
+};
+
+
+/* A typed annotation of the symbols, stored in a table indexed by the symbol's id instead of in
+ * the symbols themselves, so that only the visitors that use an annotation pay for it.
+ * The symbols that were never annotated have the default value of value_t (e.g. NULL for pointers).
+ */
+template <typename value_t> class annotation_table_c {
+  private:
+    std::vector<value_t> values;
+
+  public:
+    value_t get(const symbol_c *symbol) const {
+      return (symbol->id < values.size())? values[symbol->id] : value_t();
+    }
+    void set(const symbol_c *symbol, value_t value) {
+      if (symbol->id >= values.size()) values.resize(symbol->id + 1);
+      values[symbol->id] = value;
+    }
+    /* remove all annotations */
+    void clear(void) {std::vector<value_t>().swap(values);}
 };
 
 
@@ -279,6 +420,13 @@ class list_c: public symbol_c {
       symbol_c   *symbol;
     } element_entry_t;
     element_entry_t *elements;
+    /* A hash index of the elements' token_value, used to speed up find_element() on long lists.
+     * It is only built when first needed, and thrown away whenever elements are inserted or removed
+     * (appending elements to the end of the list keeps it up to date).
+     */
+    struct list_index_s *index;
+    void build_index(void);
+    void drop_index (void);
     
 
   public:
@@ -290,6 +438,8 @@ class list_c: public symbol_c {
            int fl = 0, int fc = 0, const char *ffile = NULL /* filename */, long int forder=0, /* order in which it is read by lexcial analyser */
            int ll = 0, int lc = 0, const char *lfile = NULL /* filename */, long int lorder=0  /* order in which it is read by lexcial analyser */
           );
+     /* frees the table of elements, but does not delete the elements in the list! */
+    virtual ~list_c(void);
      /* get element in position pos of the list */
     virtual symbol_c *get_element(int pos);
      /* find element associated to token value */
@@ -0,0 +1,194 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+/*
+ * A global pool of interned strings.
+ *
+ * Each string is stored right after a small header (intern_entry_t) in large memory blocks.
+ * The entries are found through an open addressing hash table, indexed by the case insensitive
+ * hash of the string.
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <vector>
+
+#include "intern_pool.hh"
+#include "../main.hh" // required for ERROR() and ERROR_MSG() macros.
+
+
+typedef struct {
+  const char *folded;  /* the interned case folded form of this string */
+  uint32_t    hash;    /* nocase_hash() of this string */
+  uint32_t    len;
+} intern_entry_t;
+
+#define POOL_BLOCK_SIZE  (1024*1024)
+#define POOL_ALIGNMENT   (sizeof(void *))
+#define ENTRY_SIZE(len)  ((sizeof(intern_entry_t) + (len) + 1 + POOL_ALIGNMENT - 1) & ~(POOL_ALIGNMENT - 1))
+#define ENTRY_STR(entry) ((char *)(entry) + sizeof(intern_entry_t))
+#define STR_ENTRY(str)   ((intern_entry_t *)((char *)(str) - sizeof(intern_entry_t)))
+
+/* The memory blocks holding the entries. The last block is the one currently being filled in. */
+static std::vector<char *> blocks;
+static std::vector<size_t> block_sizes;
+static size_t              last_block_used = 0;
+
+/* The hash table. Its size is always a power of 2, and is kept at most half full. */
+static intern_entry_t **table      = NULL;
+static size_t           table_size = 0;
+static size_t           table_used = 0;
+
+
+
+uint32_t nocase_hash(const char *str, size_t len) {
+  /* FNV-1a */
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < len; i++)
+    hash = (hash ^ (unsigned char)toupper((unsigned char)str[i])) * 16777619u;
+  return hash;
+}
+
+
+static intern_entry_t *new_entry(const char *str, size_t len, uint32_t hash) {
+  size_t size = ENTRY_SIZE(len);
+  if (blocks.empty() || (block_sizes.back() - last_block_used < size)) {
+    size_t block_size = (size > POOL_BLOCK_SIZE)? size : POOL_BLOCK_SIZE;
+    char *block = (char *)malloc(block_size);
+    if (NULL == block) ERROR_MSG("out of memory");
+    blocks.push_back(block);
+    block_sizes.push_back(block_size);
+    last_block_used = 0;
+  }
+  intern_entry_t *entry = (intern_entry_t *)(blocks.back() + last_block_used);
+  last_block_used += size;
+
+  entry->folded = NULL;
+  entry->hash   = hash;
+  entry->len    = len;
+  memcpy(ENTRY_STR(entry), str, len);
+  ENTRY_STR(entry)[len] = '\0';
+  return entry;
+}
+
+
+static void grow_table(void) {
+  size_t           new_size  = (table_size == 0)? 4096 : 2 * table_size;
+  intern_entry_t **new_table = (intern_entry_t **)calloc(new_size, sizeof(intern_entry_t *));
+  if (NULL == new_table) ERROR_MSG("out of memory");
+  for (size_t i = 0; i < table_size; i++) {
+    if (NULL == table[i]) continue;
+    size_t pos = table[i]->hash & (new_size - 1);
+    while (NULL != new_table[pos]) pos = (pos + 1) & (new_size - 1);
+    new_table[pos] = table[i];
+  }
+  free(table);
+  table      = new_table;
+  table_size = new_size;
+}
+
+
+/* find the entry of a string, or create a new one if not yet in the pool */
+static intern_entry_t *find_entry(const char *str, size_t len, uint32_t hash) {
+  if (2 * (table_used + 1) > table_size) grow_table();
+
+  size_t pos = hash & (table_size - 1);
+  for (; NULL != table[pos]; pos = (pos + 1) & (table_size - 1)) {
+    intern_entry_t *entry = table[pos];
+    if ((entry->hash == hash) && (entry->len == len) && (memcmp(ENTRY_STR(entry), str, len) == 0))
+      return entry;
+  }
+  table_used++;
+  return table[pos] = new_entry(str, len, hash);
+}
+
+
+const char *intern_string(const char *str) {
+  if (NULL == str) return NULL;
+  return intern_string(str, strlen(str));
+}
+
+
+const char *intern_string(const char *str, size_t len) {
+  if (NULL == str) return NULL;
+  uint32_t        hash  = nocase_hash(str, len);
+  intern_entry_t *entry = find_entry(str, len, hash);
+
+  if (NULL == entry->folded) {
+    /* new entry: determine its case folded form */
+    size_t i;
+    for (i = 0; (i < len) && (toupper((unsigned char)str[i]) == str[i]); i++);
+    if (i == len) {
+      entry->folded = ENTRY_STR(entry); /* string is already in upper case */
+    } else {
+      std::vector<char> folded(len);
+      for (i = 0; i < len; i++) folded[i] = toupper((unsigned char)str[i]);
+      intern_entry_t *folded_entry = find_entry(&folded[0], len, hash);
+      folded_entry->folded = ENTRY_STR(folded_entry);
+      entry->folded        = ENTRY_STR(folded_entry);
+    }
+  }
+  return ENTRY_STR(entry);
+}
+
+
+bool is_interned(const char *str) {
+  if (NULL == str) return false;
+  /* most strings being checked will have been interned recently, so search the latest blocks first */
+  for (size_t i = blocks.size(); i-- > 0; )
+    if ((str >= blocks[i]) && (str < blocks[i] + block_sizes[i]))
+      return true;
+  return false;
+}
+
+
+const char *interned_folded(const char *str) {
+  if (!is_interned(str)) return NULL;
+  return STR_ENTRY(str)->folded;
+}
+
+
+uint32_t interned_hash(const char *str) {
+  if (!is_interned(str)) return nocase_hash(str, strlen(str));
+  return STR_ENTRY(str)->hash;
+}
+
+
+int identifier_casecmp(const char *str1, const char *str2) {
+  if (str1 == str2) return 0;
+  if (is_interned(str1) && is_interned(str2))
+    return (STR_ENTRY(str1)->folded == STR_ENTRY(str2)->folded)? 0 : 1;
+  return strcasecmp(str1, str2);
+}
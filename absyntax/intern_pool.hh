@@ -0,0 +1,77 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+/*
+ * A global pool of interned strings.
+ *
+ * The lexical analyser stores the value of every identifier, direct variable and literal it
+ * finds in this pool, so identical strings share the same memory. Along with each string the
+ * pool also stores its case folded (upper case) form, itself an interned string, and the hash
+ * of that case folded form.
+ *
+ * Since IEC 61131-3 identifiers are case insensitive, two interned strings are the same
+ * identifier if and only if they have the same folded form, i.e. comparing interned identifiers
+ * is a simple pointer comparison.
+ *
+ * Interned strings must never be modified or freed!
+ */
+
+
+#ifndef _INTERN_POOL_HH
+#define _INTERN_POOL_HH
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+/* Return the interned copy of str (or of its first len characters) */
+const char *intern_string(const char *str);
+const char *intern_string(const char *str, size_t len);
+
+/* Returns true if str points to an interned string */
+bool        is_interned(const char *str);
+
+/* Return the case folded form of an interned string (NULL if str is not an interned string) */
+const char *interned_folded(const char *str);
+
+/* Return the case insensitive hash of an interned string (any string may be passed to nocase_hash()) */
+uint32_t    interned_hash(const char *str);
+uint32_t    nocase_hash(const char *str, size_t len);
+
+/* Case insensitive comparison of two identifiers. Returns 0 if equal, non zero otherwise.
+ * When both are interned (the usual case for identifiers in the AST), this is done by comparing pointers.
+ * NOTE: unlike strcasecmp(), the sign of the result is meaningless, so do not use this for sorting!
+ */
+int         identifier_casecmp(const char *str1, const char *str2);
+
+
+#endif /* _INTERN_POOL_HH */
@@ -163,6 +163,7 @@ null_visitor_c::~null_visitor_c(void) {return;}
 /* iterator_visitor_c */
 /**********************/
 
+iterator_visitor_c::iterator_visitor_c(void) {relevant_kinds = ~(uint64_t)0;}
 iterator_visitor_c::~iterator_visitor_c(void) {return;}
 
 
@@ -175,7 +176,7 @@ void *iterator_visitor_c::visit_list(list_c *list) {
 
 
 #define SYM_LIST(class_name_c, ...)	\
-  void *iterator_visitor_c::visit(class_name_c *symbol) {return visit_list(symbol);}
+  void *iterator_visitor_c::visit(class_name_c *symbol) {return is_relevant(symbol)? visit_list(symbol) : NULL;}
 
 #define SYM_TOKEN(class_name_c, ...)	\
   void *iterator_visitor_c::visit(class_name_c *symbol) {return NULL;}
@@ -185,12 +186,14 @@ void *iterator_visitor_c::visit_list(list_c *list) {
 
 #define SYM_REF1(class_name_c, ref1, ...)			\
 void *iterator_visitor_c::visit(class_name_c *symbol) {	\
+  if (!is_relevant(symbol)) return NULL;			\
   if (symbol->ref1!=NULL) symbol->ref1->accept(*this);	\
   return NULL;						\
 }
 
 #define SYM_REF2(class_name_c, ref1, ref2, ...)		\
 void *iterator_visitor_c::visit(class_name_c *symbol) {	\
+  if (!is_relevant(symbol)) return NULL;			\
   if (symbol->ref1!=NULL) symbol->ref1->accept(*this);	\
   if (symbol->ref2!=NULL) symbol->ref2->accept(*this);	\
   return NULL;						\
@@ -198,6 +201,7 @@ void *iterator_visitor_c::visit(class_name_c *symbol) {	\
 
 #define SYM_REF3(class_name_c, ref1, ref2, ref3, ...)			\
 void *iterator_visitor_c::visit(class_name_c *symbol) {			\
+  if (!is_relevant(symbol)) return NULL;			\
   if (symbol->ref1) symbol->ref1->accept(*this);			\
   if (symbol->ref2) symbol->ref2->accept(*this);			\
   if (symbol->ref3) symbol->ref3->accept(*this);			\
@@ -206,6 +210,7 @@ void *iterator_visitor_c::visit(class_name_c *symbol) {			\
 
 #define SYM_REF4(class_name_c, ref1, ref2, ref3, ref4, ...)		\
 void *iterator_visitor_c::visit(class_name_c *symbol) {			\
+  if (!is_relevant(symbol)) return NULL;			\
   if (symbol->ref1) symbol->ref1->accept(*this);			\
   if (symbol->ref2) symbol->ref2->accept(*this);			\
   if (symbol->ref3) symbol->ref3->accept(*this);			\
@@ -215,6 +220,7 @@ void *iterator_visitor_c::visit(class_name_c *symbol) {			\
 
 #define SYM_REF5(class_name_c, ref1, ref2, ref3, ref4, ref5, ...)	\
 void *iterator_visitor_c::visit(class_name_c *symbol) {			\
+  if (!is_relevant(symbol)) return NULL;			\
   if (symbol->ref1) symbol->ref1->accept(*this);			\
   if (symbol->ref2) symbol->ref2->accept(*this);			\
   if (symbol->ref3) symbol->ref3->accept(*this);			\
@@ -225,6 +231,7 @@ void *iterator_visitor_c::visit(class_name_c *symbol) {			\
 
 #define SYM_REF6(class_name_c, ref1, ref2, ref3, ref4, ref5, ref6, ...)	\
 void *iterator_visitor_c::visit(class_name_c *symbol) {			\
+  if (!is_relevant(symbol)) return NULL;			\
   if (symbol->ref1) symbol->ref1->accept(*this);			\
   if (symbol->ref2) symbol->ref2->accept(*this);			\
   if (symbol->ref3) symbol->ref3->accept(*this);			\
@@ -152,9 +152,18 @@ class iterator_visitor_c: public visitor_c {
   protected:
   void *visit_list(list_c *list);
 
+  /* The kinds of symbols (see symbol_c::kind_bit()) the iterator is interested in. Subtrees that do not
+   * contain any of these (see symbol_c::subtree_kinds) are not visited at all.
+   * By default this includes all kinds. A class that changes it must include the kind of every symbol
+   * for which it implements a visit() method!
+   */
+  uint64_t relevant_kinds;
+  bool is_relevant(symbol_c *symbol) {return (0 != (symbol->subtree_kinds & relevant_kinds));}
+
   public:
   #include "absyntax.def"
 
+  iterator_visitor_c(void);
   virtual ~iterator_visitor_c(void);
 };
 
@@ -57,6 +57,12 @@
 #include "../util/symtable.hh"
 #include "../util/dsymtable.hh"
 #include "../absyntax/visitor.hh"
+#include "search_base_type.hh"
+#include "search_var_instance_decl.hh"
+#include "function_param_iterator.hh"
+#include "search_il_label.hh"
+#include "type_initial_value.hh"
+#include "../absyntax/intern_pool.hh"
 #include "../main.hh" // required for ERROR() and ERROR_MSG() macros.
 
 
@@ -87,7 +93,8 @@ int compare_identifiers(symbol_c *ident1, symbol_c *ident2) {
     /* invalid identifiers... */
     return -1;
 
-  if (strcasecmp(name1->value, name2->value) == 0)
+  /* NOTE: the identifiers in the AST are interned by flex, so this is usually just a pointer comparison */
+  if (identifier_casecmp(name1->value, name2->value) == 0)
     return 0;
 
   /* identifiers do not match! */
@@ -277,9 +284,25 @@ class populate_symtables_c: public iterator_visitor_c {
 
 
 
+void absyntax_utils_reset(void) {
+  function_symtable.reset();
+  function_block_type_symtable.clear();
+  program_type_symtable.clear();
+  type_symtable.clear();
+  search_var_instance_decl_c::clear_index();
+  search_il_label_c::clear_index();
+  function_param_iterator_c::clear_tables();
+  search_base_type_c::clear_cache();
+  type_initial_value_c::reset();
+}
+
+
 void absyntax_utils_init(symbol_c *tree_root) {
   populate_symtables_c populate_symbols;
 
+  /* throw away the entries of any AST previously handled (i.e. when compiling several files in one run) */
+  absyntax_utils_reset();
+
   tree_root->accept(populate_symbols);
 }
 
@@ -99,8 +99,13 @@ extern  type_symtable_t type_symtable;
 #include "get_sizeof_datatype.hh"
 #include "search_il_label.hh"
 #include "get_var_name.hh"
+#include "for_variable_changed.hh"
 #include "get_datatype_info.hh"
 #include "debug_ast.hh"
+#include "serialize_ast.hh"
+#include "ast_image.hh"
+#include "xref_index.hh"
+#include "time_report.hh"
 
 /***********************************************************************/
 /***********************************************************************/
@@ -113,5 +118,10 @@ extern  type_symtable_t type_symtable;
 
 void absyntax_utils_init(symbol_c *tree_root);
 
+/* throw away the symbol tables filled in by absyntax_utils_init(), and the caches of the visitors above,
+ * e.g. before releasing the symbols they point to (see symbol_c::release_arena())
+ */
+void absyntax_utils_reset(void);
+
 
 #endif /* _SEARCH_UTILS_HH */
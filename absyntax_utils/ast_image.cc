@@ -0,0 +1,460 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+
+/*
+ * Write and read a binary image of the annotated AST (see ast_image.hh for the layout of the image).
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <map>
+#include <string>
+#include <vector>
+#include "ast_image.hh"
+#include "serialize_ast.hh"
+#include "../absyntax/visitor.hh"
+#include "../main.hh" // required for ERROR() and ERROR_MSG() macros.
+
+#include "../config/config.h"
+#if defined(HAVE_MMAP) && defined(HAVE_SYS_MMAN_H)
+  #define MMAP_AST_IMAGE
+  #include <sys/mman.h>
+#endif
+
+
+
+/* The name, the names of the references, and the flags of each class declared in absyntax.def, indexed by symbol_kind_t */
+#define SYM_LIST(class_name_c, ...)                                      {#class_name_c, "", AST_IMAGE_LIST},
+#define SYM_TOKEN(class_name_c, ...)                                     {#class_name_c, "", AST_IMAGE_TOKEN},
+#define SYM_REF0(class_name_c, ...)                                      {#class_name_c, "", 0},
+#define SYM_REF1(class_name_c, ref1, ...)                                {#class_name_c, #ref1, 0},
+#define SYM_REF2(class_name_c, ref1, ref2, ...)                          {#class_name_c, #ref1 "," #ref2, 0},
+#define SYM_REF3(class_name_c, ref1, ref2, ref3, ...)                    {#class_name_c, #ref1 "," #ref2 "," #ref3, 0},
+#define SYM_REF4(class_name_c, ref1, ref2, ref3, ref4, ...)              {#class_name_c, #ref1 "," #ref2 "," #ref3 "," #ref4, 0},
+#define SYM_REF5(class_name_c, ref1, ref2, ref3, ref4, ref5, ...)        {#class_name_c, #ref1 "," #ref2 "," #ref3 "," #ref4 "," #ref5, 0},
+#define SYM_REF6(class_name_c, ref1, ref2, ref3, ref4, ref5, ref6, ...)  {#class_name_c, #ref1 "," #ref2 "," #ref3 "," #ref4 "," #ref5 "," #ref6, 0},
+
+static const struct {
+  const char *name;
+  const char *ref_names;
+  uint32_t    flags;
+} image_classes[] = {
+  {"symbol_c", "", 0},  /* symbol_c_kind */
+  #include "../absyntax/absyntax.def"
+};
+
+#undef SYM_LIST
+#undef SYM_TOKEN
+#undef SYM_REF0
+#undef SYM_REF1
+#undef SYM_REF2
+#undef SYM_REF3
+#undef SYM_REF4
+#undef SYM_REF5
+#undef SYM_REF6
+
+
+
+
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+
+/* The visitor that gets the references (or the elements, or the value) of each class of symbol. */
+#define SYM_LIST(class_name_c, ...)							\
+    void *visit(class_name_c *symbol) {							\
+      for (int i = 0; i < symbol->n; i++) refs.push_back(symbol->get_element(i));	\
+      return NULL;									\
+    }
+
+#define SYM_TOKEN(class_name_c, ...)							\
+    void *visit(class_name_c *symbol) {value = symbol->value; return NULL;}
+
+#define SYM_REF0(class_name_c, ...)							\
+    void *visit(class_name_c *symbol) {return NULL;}
+
+#define SYM_REF1(class_name_c, ref1, ...)						\
+    void *visit(class_name_c *symbol) {							\
+      refs.push_back(symbol->ref1);							\
+      return NULL;									\
+    }
+
+#define SYM_REF2(class_name_c, ref1, ref2, ...)						\
+    void *visit(class_name_c *symbol) {							\
+      refs.push_back(symbol->ref1);							\
+      refs.push_back(symbol->ref2);							\
+      return NULL;									\
+    }
+
+#define SYM_REF3(class_name_c, ref1, ref2, ref3, ...)					\
+    void *visit(class_name_c *symbol) {							\
+      refs.push_back(symbol->ref1);							\
+      refs.push_back(symbol->ref2);							\
+      refs.push_back(symbol->ref3);							\
+      return NULL;									\
+    }
+
+#define SYM_REF4(class_name_c, ref1, ref2, ref3, ref4, ...)				\
+    void *visit(class_name_c *symbol) {							\
+      refs.push_back(symbol->ref1);							\
+      refs.push_back(symbol->ref2);							\
+      refs.push_back(symbol->ref3);							\
+      refs.push_back(symbol->ref4);							\
+      return NULL;									\
+    }
+
+#define SYM_REF5(class_name_c, ref1, ref2, ref3, ref4, ref5, ...)			\
+    void *visit(class_name_c *symbol) {							\
+      refs.push_back(symbol->ref1);							\
+      refs.push_back(symbol->ref2);							\
+      refs.push_back(symbol->ref3);							\
+      refs.push_back(symbol->ref4);							\
+      refs.push_back(symbol->ref5);							\
+      return NULL;									\
+    }
+
+#define SYM_REF6(class_name_c, ref1, ref2, ref3, ref4, ref5, ref6, ...)			\
+    void *visit(class_name_c *symbol) {							\
+      refs.push_back(symbol->ref1);							\
+      refs.push_back(symbol->ref2);							\
+      refs.push_back(symbol->ref3);							\
+      refs.push_back(symbol->ref4);							\
+      refs.push_back(symbol->ref5);							\
+      refs.push_back(symbol->ref6);							\
+      return NULL;									\
+    }
+
+
+class ast_image_refs_c: public visitor_c {
+  public:
+    std::vector<symbol_c *> refs;
+    const char             *value;
+
+    void get(symbol_c *symbol) {
+      refs.clear();
+      value = NULL;
+      symbol->accept(*this);
+    }
+
+    virtual ~ast_image_refs_c(void) {}
+
+  #include "../absyntax/absyntax.def"
+};
+
+#undef SYM_LIST
+#undef SYM_TOKEN
+#undef SYM_REF0
+#undef SYM_REF1
+#undef SYM_REF2
+#undef SYM_REF3
+#undef SYM_REF4
+#undef SYM_REF5
+#undef SYM_REF6
+
+
+
+
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+
+class ast_image_writer_c {
+  private:
+    std::map<symbol_c *, uint32_t>   node_ids;
+    std::vector<symbol_c *>          symbols;   /* in the order of their node index */
+    std::vector<ast_image_node_t>    nodes;
+    std::vector<uint32_t>            refs;
+    std::vector<ast_image_class_t>   classes;
+    std::map<std::string, uint32_t>  string_ids;
+    std::vector<uint32_t>            string_offsets;
+    std::string                      string_data;
+    const ast_image_annotations_t   &annotations;
+
+    uint32_t node_id(symbol_c *symbol) {
+      if (NULL == symbol) return 0;
+      std::map<symbol_c *, uint32_t>::iterator i = node_ids.find(symbol);
+      if (i != node_ids.end()) return i->second;
+      uint32_t id = symbols.size();
+      node_ids[symbol] = id;
+      symbols.push_back(symbol);
+      return id;
+    }
+
+    uint32_t string_id(const char *str) {
+      if (NULL == str) return 0;
+      std::map<std::string, uint32_t>::iterator i = string_ids.find(str);
+      if (i != string_ids.end()) return i->second;
+      uint32_t id = string_offsets.size();
+      string_ids[str] = id;
+      string_offsets.push_back(string_data.size());
+      string_data.append(str, strlen(str) + 1);
+      return id;
+    }
+
+    static uint8_t status(bool valid, bool overflow, bool nonconst) {
+      if (valid)    return ast_image_cs_const;
+      if (overflow) return ast_image_cs_overflow;
+      if (nonconst) return ast_image_cs_non_const;
+      return ast_image_cs_undefined;
+    }
+
+    void add_node(symbol_c *symbol, ast_image_refs_c &get_refs) {
+      ast_image_node_t node;
+      memset(&node, 0, sizeof(node));
+      get_refs.get(symbol);
+      node.class_id     = symbol->kind;
+      node.value        = string_id(get_refs.value);
+      node.refs         = refs.size();
+      node.ref_count    = get_refs.refs.size();
+      for (unsigned int i = 0; i < get_refs.refs.size(); i++) refs.push_back(node_id(get_refs.refs[i]));
+      node.token        = node_id(symbol->token);
+      node.parent       = node_id(symbol->parent);
+      node.datatype     = node_id(symbol->datatype);
+      node.scope        = node_id(symbol->scope);
+      node.first_file   = string_id(symbol->first_file);
+      node.first_line   = symbol->first_line;
+      node.first_column = symbol->first_column;
+      node.last_file    = string_id(symbol->last_file);
+      node.last_line    = symbol->last_line;
+      node.last_column  = symbol->last_column;
+      node.first_order  = symbol->first_order;
+      node.last_order   = symbol->last_order;
+
+      const_value_c &cv = symbol->const_value;
+      node.int64_status  = status(cv._int64 .is_valid(), cv._int64 .is_overflow(), cv._int64 .is_nonconst());
+      node.uint64_status = status(cv._uint64.is_valid(), cv._uint64.is_overflow(), cv._uint64.is_nonconst());
+      node.real64_status = status(cv._real64.is_valid(), cv._real64.is_overflow(), cv._real64.is_nonconst());
+      node.bool_status   = status(cv._bool  .is_valid(), cv._bool  .is_overflow(), cv._bool  .is_nonconst());
+      node.int64_value   = cv._int64 .get();
+      node.uint64_value  = cv._uint64.get();
+      node.real64_value  = cv._real64.get();
+      node.bool_value    = cv._bool  .get();
+      node.dead_store    = annotations.is_dead_store(symbol);
+      node.idempotent_fb = annotations.is_idempotent_fb(symbol);
+      nodes.push_back(node);
+    }
+
+  public:
+    ast_image_writer_c(symbol_c *tree_root, const ast_image_annotations_t &annotations_): annotations(annotations_) {
+      string_offsets.push_back(0);  /* the NULL string (index 0)... */
+      string_data.push_back('\0');
+      symbols.push_back(NULL);      /* ... and the dummy node */
+      ast_image_node_t dummy;
+      memset(&dummy, 0, sizeof(dummy));
+      nodes.push_back(dummy);
+
+      node_id(tree_root);
+      ast_image_refs_c get_refs;
+      /* NOTE: add_node() adds the symbols it references to the end of the list */
+      for (size_t i = 1; i < symbols.size(); i++) add_node(symbols[i], get_refs);
+
+      for (size_t i = 0; i < sizeof(image_classes) / sizeof(image_classes[0]); i++) {
+        ast_image_class_t image_class;
+        image_class.name      = string_id(image_classes[i].name);
+        image_class.ref_names = string_id(image_classes[i].ref_names);
+        image_class.flags     = image_classes[i].flags;
+        image_class.unused    = 0;
+        classes.push_back(image_class);
+      }
+    }
+
+    int write(FILE *out) {
+      ast_image_header_t header;
+      memset(&header, 0, sizeof(header));
+      memcpy(header.magic, AST_IMAGE_MAGIC, sizeof(header.magic));
+      header.version            = AST_IMAGE_VERSION;
+      header.byte_order         = AST_IMAGE_BYTE_ORDER;
+      header.schema_signature   = serialize_ast_c::schema_signature();
+      header.root               = (nodes.size() > 1)? 1 : 0;
+      header.node_count         = nodes.size();
+      header.ref_count          = refs.size();
+      header.class_count        = classes.size();
+      header.string_count       = string_offsets.size();
+      header.nodes_offset       = align(sizeof(header));
+      header.refs_offset        = align(header.nodes_offset   + nodes.size()          * sizeof(ast_image_node_t));
+      header.classes_offset     = align(header.refs_offset    + refs.size()           * sizeof(uint32_t));
+      header.strings_offset     = align(header.classes_offset + classes.size()        * sizeof(ast_image_class_t));
+      header.string_data_offset = align(header.strings_offset + string_offsets.size() * sizeof(uint32_t));
+      header.string_data_size   = string_data.size();
+
+      uint64_t pos = 0;
+      bool ok =    write_table(out, pos, 0,                         &header,           sizeof(header))
+                && write_table(out, pos, header.nodes_offset,       &nodes[0],         nodes.size()          * sizeof(ast_image_node_t))
+                && write_table(out, pos, header.refs_offset,        refs.data(),       refs.size()           * sizeof(uint32_t))
+                && write_table(out, pos, header.classes_offset,     &classes[0],       classes.size()        * sizeof(ast_image_class_t))
+                && write_table(out, pos, header.strings_offset,     &string_offsets[0], string_offsets.size() * sizeof(uint32_t))
+                && write_table(out, pos, header.string_data_offset, string_data.data(), string_data.size());
+      return (ok && (fflush(out) == 0))? 0 : -1;
+    }
+
+  private:
+    static uint64_t align(uint64_t offset) {return (offset + 7) & ~(uint64_t)7;}
+
+    static bool write_table(FILE *out, uint64_t &pos, uint64_t offset, const void *data, size_t len) {
+      for (; pos < offset; pos++)
+        if (putc(0, out) == EOF) return false;
+      if ((len > 0) && (fwrite(data, 1, len, out) != len)) return false;
+      pos += len;
+      return true;
+    }
+};
+
+
+int save_ast_image(symbol_c *tree_root, const ast_image_annotations_t &annotations, FILE *out) {
+  ast_image_writer_c writer(tree_root, annotations);
+  return writer.write(out);
+}
+
+
+int save_ast_image(symbol_c *tree_root, const ast_image_annotations_t &annotations, const char *filename) {
+  std::string tmp_filename = std::string(filename) + ".tmp";
+  FILE *out = fopen(tmp_filename.c_str(), "wb");
+  if (NULL == out) {
+    perror(("Error creating " + tmp_filename).c_str());
+    return -1;
+  }
+
+  bool failed = (save_ast_image(tree_root, annotations, out) < 0);
+  if (fclose(out) != 0) failed = true;
+  if (failed || (rename(tmp_filename.c_str(), filename) != 0)) {
+    perror((std::string("Error writing ") + filename).c_str());
+    remove(tmp_filename.c_str());
+    return -1;
+  }
+  return 0;
+}
+
+
+
+
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+
+ast_image_c:: ast_image_c(void) {data = NULL; size = 0; mapped = false; hdr = NULL;}
+ast_image_c::~ast_image_c(void) {close();}
+
+
+void ast_image_c::close(void) {
+#ifdef MMAP_AST_IMAGE
+  if (mapped) munmap(data, size);
+#endif
+  if (!mapped) free(data);
+  data   = NULL;
+  size   = 0;
+  mapped = false;
+  hdr    = NULL;
+}
+
+
+/* returns true if the table lies within the image */
+static bool table_fits(uint64_t offset, uint64_t count, uint64_t element_size, size_t size) {
+  if ((offset % 8 != 0) || (offset > size)) return false;
+  return (count <= (size - offset) / element_size);
+}
+
+
+int ast_image_c::open(const char *filename) {
+  close();
+  FILE *in = fopen(filename, "rb");
+  if (NULL == in) return -1;
+  struct stat st;
+  if ((fstat(fileno(in), &st) != 0) || (st.st_size < (off_t)sizeof(ast_image_header_t))) {fclose(in); return -1;}
+  size = st.st_size;
+
+#ifdef MMAP_AST_IMAGE
+  void *map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fileno(in), 0);
+  if (MAP_FAILED != map) {data = (char *)map; mapped = true;}
+#endif
+  if (!mapped) {
+    data = (char *)malloc(size);
+    if ((NULL == data) || (fread(data, 1, size, in) != size)) {fclose(in); close(); return -1;}
+  }
+  fclose(in);
+
+  const ast_image_header_t *h = (const ast_image_header_t *)data;
+  if (   (memcmp(h->magic, AST_IMAGE_MAGIC, sizeof(h->magic)) != 0)
+      || (h->version          != AST_IMAGE_VERSION)
+      || (h->byte_order       != AST_IMAGE_BYTE_ORDER)
+      || (h->schema_signature != serialize_ast_c::schema_signature())
+      || (h->root             >= h->node_count)
+      || !table_fits(h->nodes_offset,       h->node_count,       sizeof(ast_image_node_t),  size)
+      || !table_fits(h->refs_offset,        h->ref_count,        sizeof(uint32_t),          size)
+      || !table_fits(h->classes_offset,     h->class_count,      sizeof(ast_image_class_t), size)
+      || !table_fits(h->strings_offset,     h->string_count,     sizeof(uint32_t),          size)
+      || !table_fits(h->string_data_offset, h->string_data_size, 1,                         size)
+      || (h->string_data_size == 0) || (data[h->string_data_offset + h->string_data_size - 1] != '\0')) {
+    close();
+    return -1;
+  }
+  hdr = h;
+  return 0;
+}
+
+
+const ast_image_node_t *ast_image_c::node(uint32_t index) {
+  if ((NULL == hdr) || (0 == index) || (index >= hdr->node_count)) return NULL;
+  return ((const ast_image_node_t *)(data + hdr->nodes_offset)) + index;
+}
+
+
+uint32_t ast_image_c::index(const ast_image_node_t *node) {
+  if ((NULL == hdr) || (NULL == node)) return 0;
+  return node - (const ast_image_node_t *)(data + hdr->nodes_offset);
+}
+
+
+const ast_image_node_t *ast_image_c::ref(const ast_image_node_t *node, uint32_t i) {
+  if ((NULL == hdr) || (NULL == node) || (i >= node->ref_count)) return NULL;
+  if ((node->refs >= hdr->ref_count) || (i >= hdr->ref_count - node->refs)) return NULL;
+  return this->node(((const uint32_t *)(data + hdr->refs_offset))[node->refs + i]);
+}
+
+
+const ast_image_class_t *ast_image_c::get_class(const ast_image_node_t *node) {
+  if ((NULL == hdr) || (NULL == node) || (node->class_id >= hdr->class_count)) return NULL;
+  return ((const ast_image_class_t *)(data + hdr->classes_offset)) + node->class_id;
+}
+
+
+const char *ast_image_c::string(uint32_t index) {
+  if ((NULL == hdr) || (0 == index) || (index >= hdr->string_count)) return NULL;
+  uint32_t offset = ((const uint32_t *)(data + hdr->strings_offset))[index];
+  if (offset >= hdr->string_data_size) return NULL;
+  return data + hdr->string_data_offset + offset;
+}
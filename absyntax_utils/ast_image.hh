@@ -0,0 +1,187 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+/*
+ * A binary image of the AST annotated by stage 3 (iec2c -w), for use by other tools (static
+ * analysers, documentation generators, ...) that would otherwise have to parse the source code
+ * (or the output of iec2iec) themselves.
+ *
+ * Unlike the stream written by serialize_ast_c, the image has a fixed layout: the nodes are
+ * records of a fixed size, that refer to other nodes and to the strings by their index, so a tool may
+ * map the file into memory and only look at the nodes it is interested in, without first decoding
+ * (or even reading) the whole file. All the integers are in the byte order of the machine running
+ * iec2c (see ast_image_header_t.byte_order).
+ *
+ * Image file layout (each table is aligned on 8 bytes):
+ *   - the header (ast_image_header_t)
+ *   - the nodes (ast_image_node_t), indexed from 0. Node 0 is a dummy, so index 0 is a NULL reference
+ *   - the references (uint32_t node indexes) of all the nodes: the elements of the lists, or the
+ *     ref1, ref2, ... of the other symbols, in the order they are declared in absyntax.def
+ *   - the classes (ast_image_class_t), indexed by ast_image_node_t.class_id (i.e. by symbol_kind_t)
+ *   - the strings: a table of the offsets (uint32_t) of each string into the string data, followed by
+ *     the string data itself (NUL terminated strings). String 0 is a NULL string.
+ *
+ * The nodes are all the symbols reached from the root of the AST through their references, and through
+ * their token, parent, datatype and scope annotations, numbered breadth first (the root is node 1).
+ * Shared symbols (e.g. the elementary datatypes) appear only once.
+ */
+
+
+#ifndef _AST_IMAGE_HH
+#define _AST_IMAGE_HH
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+
+
+#define AST_IMAGE_MAGIC      "IEC_AST"     /* 8 bytes, including the NUL */
+#define AST_IMAGE_VERSION    1
+#define AST_IMAGE_BYTE_ORDER 0x01020304
+
+#define AST_IMAGE_FILENAME   "AST.img"     /* the name of the image written by iec2c -w */
+
+
+typedef struct {
+  char     magic[8];
+  uint32_t version;           /* AST_IMAGE_VERSION */
+  uint32_t byte_order;        /* AST_IMAGE_BYTE_ORDER, as written by the machine that generated the image */
+  uint32_t schema_signature;  /* serialize_ast_c::schema_signature(), changes with absyntax.def */
+  uint32_t root;              /* the node of the root of the AST */
+  uint32_t node_count;        /* including the dummy node 0 */
+  uint32_t ref_count;
+  uint32_t class_count;
+  uint32_t string_count;      /* including the NULL string 0 */
+  uint64_t nodes_offset;      /* the offsets of each table, from the start of the file */
+  uint64_t refs_offset;
+  uint64_t classes_offset;
+  uint64_t strings_offset;
+  uint64_t string_data_offset;
+  uint64_t string_data_size;
+} ast_image_header_t;
+
+
+/* The status of each const_value (the const_status_t of const_value_c) */
+typedef enum {
+  ast_image_cs_undefined = 0,
+  ast_image_cs_non_const = 1,
+  ast_image_cs_const     = 2,
+  ast_image_cs_overflow  = 3
+} ast_image_const_status_t;
+
+
+typedef struct {
+  uint32_t class_id;          /* index into the classes */
+  uint32_t value;             /* the value of a token (a string), 0 for the other symbols */
+  uint32_t refs;              /* index of the first reference of the node */
+  uint32_t ref_count;         /* the number of elements of a list, or of ref1, ref2, ... */
+  uint32_t token;             /* the annotations (nodes)... */
+  uint32_t parent;
+  uint32_t datatype;
+  uint32_t scope;
+  uint32_t first_file;        /* the location (strings, and lines and columns) */
+  int32_t  first_line;
+  int32_t  first_column;
+  uint32_t last_file;
+  int32_t  last_line;
+  int32_t  last_column;
+  int64_t  first_order;
+  int64_t  last_order;
+  uint8_t  int64_status;      /* the const_value (ast_image_const_status_t, and the values) */
+  uint8_t  uint64_status;
+  uint8_t  real64_status;
+  uint8_t  bool_status;
+  uint8_t  bool_value;
+  uint8_t  dead_store;
+  uint8_t  idempotent_fb;
+  uint8_t  unused[1];
+  int64_t  int64_value;
+  uint64_t uint64_value;
+  double   real64_value;
+} ast_image_node_t;
+
+
+typedef struct {
+  uint32_t name;              /* the name of the class (a string), e.g. "function_declaration_c" */
+  uint32_t ref_names;         /* the names of ref1, ref2, ..., separated by commas (a string) */
+  uint32_t flags;             /* AST_IMAGE_LIST, AST_IMAGE_TOKEN */
+  uint32_t unused;
+} ast_image_class_t;
+
+#define AST_IMAGE_LIST  1
+#define AST_IMAGE_TOKEN 2
+
+
+
+class symbol_c; // forward declaration
+
+/* The annotations that the stage 3 analyses keep in their own tables (instead of in the symbols), to be stored in the image */
+typedef struct {
+  bool (*is_dead_store)(symbol_c *symbol);    /* see dead_store_analysis_c */
+  bool (*is_idempotent_fb)(symbol_c *symbol); /* see idempotent_fb_analysis_c */
+} ast_image_annotations_t;
+
+/* Write the image of the AST (written to filename.tmp, that is renamed once complete). Return < 0 on error. */
+int save_ast_image(symbol_c *tree_root, const ast_image_annotations_t &annotations, const char *filename);
+int save_ast_image(symbol_c *tree_root, const ast_image_annotations_t &annotations, FILE *out);
+
+
+/* Read access to an image, mapped into memory (or, where mmap() is not available, read into memory).
+ * Only the header and the size of the tables are checked when the image is opened. Each access
+ * checks the index it is given, and returns NULL (or 0) if it is out of range.
+ */
+class ast_image_c {
+  public:
+    ast_image_c(void);
+    ~ast_image_c(void);
+
+    /* Returns < 0 if the file could not be read, or is not an image with the current version and schema */
+    int  open(const char *filename);
+    void close(void);
+
+    const ast_image_header_t *header(void) {return hdr;}
+    const ast_image_node_t   *root  (void) {return node((NULL == hdr)? 0 : hdr->root);}
+    const ast_image_node_t   *node  (uint32_t index);  /* NULL for index 0 */
+    const ast_image_node_t   *ref   (const ast_image_node_t *node, uint32_t i);  /* the i'th reference of the node */
+    const ast_image_class_t  *get_class(const ast_image_node_t *node);
+    const char               *string(uint32_t index);  /* NULL for index 0 */
+    uint32_t                  index (const ast_image_node_t *node);
+
+  private:
+    char                     *data;
+    size_t                    size;
+    bool                      mapped;
+    const ast_image_header_t *hdr;
+};
+
+
+#endif /* _AST_IMAGE_HH */
@@ -120,7 +120,7 @@ void print_symbol_c::fcall(symbol_c* symbol) {
 
 
 void print_symbol_c::dump_symbol(symbol_c* symbol) {
-  fprintf(stderr, "(%s->%03d:%03d..%03d:%03d) \t%s", symbol->first_file, symbol->first_line, symbol->first_column, symbol->last_line, symbol->last_column, symbol->absyntax_cname());
+  fprintf(stderr, "(%s->%03d:%03d..%03d:%03d) \t%s", symbol->first_file.c_str(), symbol->first_line, symbol->first_column, symbol->last_line, symbol->last_column, symbol->absyntax_cname());
 
   if ((NULL != symbol->token) && (NULL != symbol->token->value))
     fprintf(stderr, "(%s)", symbol->token->value);
@@ -0,0 +1,66 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+/*
+ *  A small helper visitor class, that determines whether the body of a FOR loop
+ *  may change the value of its control variable.
+ */
+
+
+
+#include "absyntax_utils.hh"
+
+
+
+bool for_variable_changed_c::is_variable(symbol_c *symbol) {
+  symbolic_variable_c *variable = dynamic_cast<symbolic_variable_c *>(symbol);
+  return (NULL != variable) && (0 == compare_identifiers(variable->var_name, var_name));
+}
+
+
+bool for_variable_changed_c::get(for_statement_c *symbol, symbol_c *var_name) {
+  for_variable_changed_c for_variable_changed;
+  for_variable_changed.var_name    = var_name;
+  for_variable_changed.param_depth = 0;
+  for_variable_changed.changed     = false;
+  if (NULL != symbol->statement_list) symbol->statement_list->accept(for_variable_changed);
+  return for_variable_changed.changed;
+}
+
+
+void *for_variable_changed_c::visit(symbolic_variable_c    *symbol) {if ((param_depth > 0) && is_variable(symbol)) changed = true; return NULL;}
+void *for_variable_changed_c::visit(assignment_statement_c *symbol) {if (is_variable(symbol->l_exp))            changed = true; return iterator_visitor_c::visit(symbol);}
+void *for_variable_changed_c::visit(for_statement_c        *symbol) {if (is_variable(symbol->control_variable)) changed = true; return iterator_visitor_c::visit(symbol);}
+void *for_variable_changed_c::visit(function_invocation_c  *symbol) {param_depth++; iterator_visitor_c::visit(symbol); param_depth--; return NULL;}
+void *for_variable_changed_c::visit(fb_invocation_c        *symbol) {param_depth++; iterator_visitor_c::visit(symbol); param_depth--; return NULL;}
+void *for_variable_changed_c::visit(ref_expression_c       *symbol) {param_depth++; iterator_visitor_c::visit(symbol); param_depth--; return NULL;}
+
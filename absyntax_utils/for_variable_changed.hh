@@ -0,0 +1,66 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+/*
+ *  A small helper visitor class, that determines whether the body of a FOR loop
+ *  may change the value of its control variable.
+ *
+ *  Besides being assigned (or being the control variable of a nested FOR loop), the
+ *  control variable is assumed to be changed whenever it is passed to a function or FB,
+ *  or its address is taken with REF().
+ *
+ *  Used by array_range_check_c (the value ranges of the control variables), and by
+ *  stage 4 (array_bounds_check__).
+ */
+
+
+
+class for_variable_changed_c: public iterator_visitor_c {
+  private:
+    symbol_c *var_name;
+    int       param_depth;  /* > 0 inside the parameters of a function or FB call, or the operand of REF() */
+    bool      changed;
+
+    bool is_variable(symbol_c *symbol);
+
+  public:
+    static bool get(for_statement_c *symbol, symbol_c *var_name);
+
+  private:
+    void *visit(symbolic_variable_c    *symbol);
+    void *visit(assignment_statement_c *symbol);
+    void *visit(for_statement_c        *symbol);
+    void *visit(function_invocation_c  *symbol);
+    void *visit(fb_invocation_c        *symbol);
+    void *visit(ref_expression_c       *symbol);
+}; // for_variable_changed_c
+
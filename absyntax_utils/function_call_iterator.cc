@@ -68,6 +68,10 @@ function_call_iterator_c::function_call_iterator_c(symbol_c *symbol) {
   next_fcall = fcall_count = 0;
   current_finvocation = NULL;
   current_fcall_name = NULL;
+  /* do not bother visiting code that does not call any function */
+  relevant_kinds =   symbol_c::kind_bit(function_invocation_c_kind)
+                   | symbol_c::kind_bit(il_function_call_c_kind)
+                   | symbol_c::kind_bit(il_formal_funct_call_c_kind);
 }
 
 /* Skip to the next function call. After object creation,
@@ -47,7 +47,9 @@
 
 
 #include "function_call_param_iterator.hh"
+#include "function_param_iterator.hh"
 #include <strings.h>
+#include <stdio.h>
 #include "../main.hh" // required for ERROR() and ERROR_MSG() macros.
 
 
@@ -151,6 +153,7 @@ void function_call_param_iterator_c::reset(void) {
   iterate_nf_next_param = 0;
   iterate_f_next_param  = 0;
   param_count = 0;
+  next_bound_param = 0;
 }
 
 /* initialise the iterator object.
@@ -168,6 +171,11 @@ function_call_param_iterator_c::function_call_param_iterator_c(symbol_c *f_call)
    */
   this->f_call = f_call;
   search_param_name = NULL;
+  binding = NULL;
+  if (NULL != dynamic_cast<function_invocation_c  *>(f_call)) binding = &dynamic_cast<function_invocation_c  *>(f_call)->call_binding;
+  if (NULL != dynamic_cast<fb_invocation_c        *>(f_call)) binding = &dynamic_cast<fb_invocation_c        *>(f_call)->call_binding;
+  if (NULL != dynamic_cast<il_formal_funct_call_c *>(f_call)) binding = &dynamic_cast<il_formal_funct_call_c *>(f_call)->call_binding;
+  if (NULL != dynamic_cast<il_fb_call_c           *>(f_call)) binding = &dynamic_cast<il_fb_call_c           *>(f_call)->call_binding;
   reset();
 }
 
@@ -229,6 +237,59 @@ symbol_c *function_call_param_iterator_c::search_f(const char *param_name) {
 }
 
 
+/* Returns the value being passed to the parameter named <param_name>, the next parameter of the called POU... */
+symbol_c *function_call_param_iterator_c::next_param_value(const char *param_name, bool en_eno_param_implicit) {
+  if (is_bound()) {
+    if (next_bound_param >= (int)binding->param_values.size()) return NULL;
+    return binding->param_values[next_bound_param++];
+  }
+
+  /* Get the value from a foo(<param_name> = <param_value>) style call */
+  symbol_c *param_value = search_f(param_name);
+
+  /* Get the value from a foo(<param_value>) style call */
+  /* When using the informal invocation style, user can not pass values to EN or ENO parameters if these
+   * were implicitly defined!
+   */
+  if ((param_value == NULL) && !en_eno_param_implicit)
+    param_value = next_nf();
+  return param_value;
+}
+
+
+bool function_call_param_iterator_c::is_bound(void) {
+  return (NULL != binding) && binding->bound;
+}
+
+
+/* Store in the call the value passed to each parameter of the called POU... */
+void function_call_param_iterator_c::bind(symbol_c *f_call, symbol_c *pou_decl) {
+  if ((NULL == f_call) || (NULL == pou_decl)) return;
+  function_call_param_iterator_c fcp_iterator(f_call);
+  if ((NULL == fcp_iterator.binding) || fcp_iterator.binding->bound) return;
+
+  function_param_iterator_c fp_iterator(pou_decl);
+  identifier_c *param_name;
+  std::vector <symbol_c *> param_values;
+  while ((param_name = fp_iterator.next()) != NULL) {
+    std::string name = param_name->value;
+    if (fp_iterator.is_extensible_param()) {
+      /* the values are passed to IN1, IN2, IN3, ... */
+      char index[32];
+      snprintf(index, sizeof(index), "%d", fp_iterator.extensible_param_index());
+      name += index;
+    }
+    symbol_c *param_value = fcp_iterator.next_param_value(name.c_str(), fp_iterator.is_en_eno_param_implicit());
+    /* the last value passed to the extensible parameter */
+    if ((NULL == param_value) && fp_iterator.is_extensible_param()) break;
+    param_values.push_back(param_value);
+  }
+
+  fcp_iterator.binding->param_values.swap(param_values);
+  fcp_iterator.binding->bound = true;
+}
+
+
 /* Returns the value being passed to the current parameter. */
 symbol_c *function_call_param_iterator_c::get_current_value(void) {
   return current_value;
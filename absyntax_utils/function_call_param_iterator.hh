@@ -89,6 +89,24 @@ class function_call_param_iterator_c : public null_visitor_c {
     symbol_c *search_f(symbol_c *param_name);
     symbol_c *search_f(const char *param_name);
 
+    /* Returns the value being passed to the parameter named <param_name>, the next parameter
+     * of the called POU (as returned by function_param_iterator_c::next()).
+     * If stage 3 has stored the bindings of the call (see bind()), they are simply read in order.
+     * Otherwise the value is first searched among the formal parameters, and then taken from the
+     * next non-formal parameter (unless the parameter is an implicitly declared EN/ENO, to which
+     * values can not be passed with the informal invocation style).
+     */
+    symbol_c *next_param_value(const char *param_name, bool en_eno_param_implicit);
+
+    /* TRUE if the values passed to the parameters were stored in the call by bind() */
+    bool is_bound(void);
+
+    /* Store in the call (function_invocation_c, fb_invocation_c, il_formal_funct_call_c or il_fb_call_c)
+     * the value passed to each parameter of the called POU <pou_decl>, so stage 4 does not need to
+     * search for them again.
+     */
+    static void bind(symbol_c *f_call, symbol_c *pou_decl);
+
     /* Returns the value being passed to the current parameter. */
     symbol_c *get_current_value(void);
     
@@ -111,6 +129,9 @@ class function_call_param_iterator_c : public null_visitor_c {
     identifier_c *search_param_name;
     symbol_c *current_value;
     assign_direction_t current_assign_direction;
+    /* the bindings stored in the call (NULL if the call can not store them), and the next one to return */
+    symbol_c::call_binding_t *binding;
+    int next_bound_param;
 
     /* Which operation of the class was called:
      *  - iterate to the next non-formal parameter. 
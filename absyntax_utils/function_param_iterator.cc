@@ -55,6 +55,7 @@
 #include <limits> // required for std::numeric_limits< XXX >::max()
 #include <errno.h> // required for errno
 #include "../main.hh" // required for ERROR() and ERROR_MSG() macros.
+#include "../absyntax/intern_pool.hh"
 
 //#define DEBUG
 #ifdef DEBUG
@@ -163,96 +164,85 @@ int function_param_iterator_c::cmp_extparam_names(const char* s1, const char* s2
 
 
 
-void* function_param_iterator_c::handle_param_list(list_c *list) {
-  switch (current_operation) {
-    case iterate_op:
-      if (next_param <= param_count + list->n)
-        return list->get_element(next_param - param_count - 1);
-
-      /* the desired param is not on this list... */
-      param_count += list->n;
-      break;
-
-    case search_op:
-      for(int i = 0; i < list->n; i++) {
-        symbol_c *sym = list->get_element(i);
-        extensible_input_parameter_c *extensible_parameter = dynamic_cast<extensible_input_parameter_c *>(sym);
-        if (extensible_parameter != NULL) {
-          sym = extensible_parameter->var_name;
-          current_param_is_extensible = true;
-          _first_extensible_param_index = extract_first_index_value(extensible_parameter->first_index);
-        }
-        identifier_c *variable_name = dynamic_cast<identifier_c *>(sym);
-        if (variable_name == NULL) ERROR;
-        
-        if (!current_param_is_extensible)
-          if (strcasecmp(search_param_name->value, variable_name->value) == 0)
-            /* FOUND! This is the same parameter!! */
-            return (void *)variable_name;
-  
-        if (current_param_is_extensible) {
-          current_extensible_param_index = cmp_extparam_names(variable_name->value, search_param_name->value);
-          if (current_extensible_param_index >= 0)
-            /* FOUND! This is a compatible extensible parameter!! */
-            return (void *)variable_name;
-        }  
-      }
-      break;
-  } /* switch */
+/* The key used to store a parameter name in the table. */
+static const char *param_key(const char *param_name) {
+  /* NOTE: identifiers created after parsing (e.g. by stage 4) may not have been interned by flex */
+  return interned_folded(intern_string(param_name));
+}
 
-  /* Not found! */
-  return NULL;
+
+std::map<symbol_c *, function_param_iterator_c::param_table_t *> function_param_iterator_c::param_tables;
+
+
+void function_param_iterator_c::clear_tables(void) {
+  std::map<symbol_c *, param_table_t *>::iterator i;
+  for (i = param_tables.begin(); i != param_tables.end(); i++)
+    delete i->second;
+  param_tables.clear();
 }
 
+
+/* Add a parameter to the table being built, with the current_param_XXX values set by the visit() methods */
 void* function_param_iterator_c::handle_single_param(symbol_c *var_name) {
-  switch (current_operation) {
-    case iterate_op:
-      param_count++;
-      if (next_param == param_count)
-        return var_name;
-      break;
-
-    case search_op:
-      extensible_input_parameter_c *extensible_parameter = dynamic_cast<extensible_input_parameter_c *>(var_name);
-      if (extensible_parameter != NULL) {
-        var_name = extensible_parameter->var_name;
-        current_param_is_extensible = true;
-        _first_extensible_param_index = extract_first_index_value(extensible_parameter->first_index);
-      }
-      identifier_c *variable_name = dynamic_cast<identifier_c *>(var_name);
-      if (variable_name == NULL) ERROR;
-      
-      if (!current_param_is_extensible)
-        if (strcasecmp(search_param_name->value, variable_name->value) == 0)
-          /* FOUND! This is the same parameter!! */
-          return (void *)variable_name;
-
-      if (current_param_is_extensible) {
-        current_extensible_param_index = cmp_extparam_names(variable_name->value, search_param_name->value);
-        if (current_extensible_param_index >= 0)
-          /* FOUND! This is a compatible extensible parameter!! */
-          return (void *)variable_name;
-      }  
-      break;
-  } /* switch */
+  param_t param;
+  param.extensible             = false;
+  param.first_extensible_index = -1;
+  extensible_input_parameter_c *extensible_parameter = dynamic_cast<extensible_input_parameter_c *>(var_name);
+  if (extensible_parameter != NULL) {
+    var_name = extensible_parameter->var_name;
+    param.extensible             = true;
+    param.first_extensible_index = extract_first_index_value(extensible_parameter->first_index);
+  }
+  param.name = dynamic_cast<identifier_c *>(var_name);
+  if (param.name == NULL) ERROR;
+  param.type            = current_param_type;
+  param.default_value   = current_param_default_value;
+  param.direction       = current_param_direction;
+  param.en_eno_implicit = en_eno_param_implicit;
+  en_eno_param_implicit = false;
 
-  /* Not found! */
+  int pos = building_table->params.size();
+  building_table->params.push_back(param);
+  if (param.extensible)
+    building_table->extensible.push_back(pos);
+  else {
+    const char *key = param_key(param.name->value);
+    if (building_table->index.find(key) == building_table->index.end())
+      building_table->index[key] = pos;
+  }
+
+  /* carry on, so the whole POU declaration gets visited */
+  return NULL;
+}
+
+void* function_param_iterator_c::handle_param_list(list_c *list) {
+  for(int i = 0; i < list->n; i++)
+    handle_single_param(list->get_element(i));
   return NULL;
 }
 
 void* function_param_iterator_c::iterate_list(list_c *list) {
-  void *res;
-  for (int i = 0; i < list->n; i++) {
-    res = list->get_element(i)->accept(*this);
-    if (res != NULL)
-        return res;
-  }
+  for (int i = 0; i < list->n; i++)
+    list->get_element(i)->accept(*this);
   return NULL;
 }
 
+/* make param the currently referenced parameter */
+void function_param_iterator_c::set_current(const param_t &param) {
+  current_param_name          = param.name;
+  current_param_type          = param.type;
+  current_param_default_value = param.default_value;
+  current_param_direction     = param.direction;
+  en_eno_param_implicit       = param.en_eno_implicit;
+  current_param_is_extensible = param.extensible;
+  if (param.extensible)
+    _first_extensible_param_index = param.first_extensible_index;
+  last_returned_parameter     = param.name;
+}
+
 /* start off at the first parameter once again... */
 void function_param_iterator_c::reset(void) {
-  next_param = param_count = 0;
+  next_param = 0;
   _first_extensible_param_index = -1;
   current_param_is_extensible = false;
   current_param_name = NULL;
@@ -280,6 +270,21 @@ function_param_iterator_c::function_param_iterator_c(symbol_c *pou_decl) {
 
   /* OK. Now initialise this object... */
   this->f_decl = pou_decl;
+  building_table = NULL;
+  std::map<symbol_c *, param_table_t *>::iterator i = param_tables.find(pou_decl);
+  if (i != param_tables.end())
+    table = i->second;
+  else {
+    table = new param_table_t;
+    building_table = table;
+    en_eno_param_implicit = false;
+    current_param_type = NULL;
+    current_param_default_value = NULL;
+    current_param_direction = direction_in;
+    pou_decl->accept(*this);
+    building_table = NULL;
+    param_tables[pou_decl] = table;
+  }
   reset();
 }
 
@@ -293,56 +298,54 @@ function_param_iterator_c::function_param_iterator_c(symbol_c *pou_decl) {
  * Returns the parameter's name!
  */
 identifier_c *function_param_iterator_c::next(void) {
-  void *res;
-  identifier_c *identifier;
- 
   if (current_param_is_extensible) {
     current_extensible_param_index++;
     return current_param_name;
   }
   
   last_returned_parameter = NULL; 
-  param_count = 0;
   en_eno_param_implicit = false;
-  next_param++;
-  current_operation = function_param_iterator_c::iterate_op;
-  res = f_decl->accept(*this);
-  if (res == NULL) 
+  if (next_param >= (int)table->params.size()) 
     return NULL;
 
-  symbol_c *sym = (symbol_c *)res;
-  extensible_input_parameter_c *extensible_parameter = dynamic_cast<extensible_input_parameter_c *>(sym);
-  if (extensible_parameter != NULL) {
-    sym = extensible_parameter->var_name;
-    current_param_is_extensible = true;
-    _first_extensible_param_index = extract_first_index_value(extensible_parameter->first_index);
-    current_extensible_param_index = _first_extensible_param_index;
-  }
-  identifier = dynamic_cast<identifier_c *>(sym);
-  if (identifier == NULL)
-    ERROR;
-  current_param_name = identifier;
-  last_returned_parameter = current_param_name; 
+  set_current(table->params[next_param++]);
+  current_extensible_param_index = _first_extensible_param_index;
   return current_param_name;
 }
 
 /* Search for the value passed to the parameter named <param_name>...  */
 identifier_c *function_param_iterator_c::search(symbol_c *param_name) {
   if (NULL == param_name) ERROR;
-  search_param_name = dynamic_cast<identifier_c *>(param_name);
+  identifier_c *search_param_name = dynamic_cast<identifier_c *>(param_name);
   if (NULL == search_param_name) ERROR;
-  en_eno_param_implicit = false;
-  current_param_is_extensible = false;
-  current_operation = function_param_iterator_c::search_op;
-  void *res = f_decl->accept(*this);
-  identifier_c *res_param_name = dynamic_cast<identifier_c *>((symbol_c *)res);
-  last_returned_parameter = res_param_name; 
-  return res_param_name;
+  return search(search_param_name->value);
 }
 
 identifier_c *function_param_iterator_c::search(const char *param_name) {
-  identifier_c   param_name_id(param_name);
-  return search(&param_name_id);
+  en_eno_param_implicit = false;
+  current_param_is_extensible = false;
+  last_returned_parameter = NULL; 
+
+  std::map<const char *, int>::iterator i = table->index.find(param_key(param_name));
+  if (i != table->index.end()) {
+    /* FOUND! This is the same parameter!! */
+    set_current(table->params[i->second]);
+    return current_param_name;
+  }
+
+  for (unsigned int e = 0; e < table->extensible.size(); e++) {
+    const param_t &param = table->params[table->extensible[e]];
+    int index = cmp_extparam_names(param.name->value, param_name);
+    if (index >= 0) {
+      /* FOUND! This is a compatible extensible parameter!! */
+      set_current(param);
+      current_extensible_param_index = index;
+      return current_param_name;
+    }
+  }
+
+  /* Not found! */
+  return NULL;
 }
 
 
@@ -430,12 +433,9 @@ void *function_param_iterator_c::visit(en_param_declaration_c *symbol) {
   current_param_default_value = spec_init_sperator_c::get_init(symbol->type_decl);
   current_param_type = spec_init_sperator_c::get_spec(symbol->type_decl);
   
-  void *res = handle_single_param(symbol->name);
-  
-    /* If we have found the parameter we will be returning, we set the en_eno_param_implicit to TRUE if implicitly defined */
-  if (res != NULL) symbol->method->accept(*this);
-  
-  return res;
+  /* sets en_eno_param_implicit to TRUE if implicitly defined */
+  symbol->method->accept(*this);
+  return handle_single_param(symbol->name);
 }
 
 /* var1_list ':' array_spec_init */
@@ -496,12 +496,9 @@ void *function_param_iterator_c::visit(eno_param_declaration_c *symbol) {
   current_param_default_value = NULL;
   current_param_type = symbol->type;
 
-  void *res = handle_single_param(symbol->name);
-  
-    /* If we have found the parameter we will be returning, we set the en_eno_param_implicit to TRUE if implicitly defined */
-  if (res != NULL) symbol->method->accept(*this);
-  
-  return res;
+  /* sets en_eno_param_implicit to TRUE if implicitly defined */
+  symbol->method->accept(*this);
+  return handle_single_param(symbol->name);
 }
 
 void *function_param_iterator_c::visit(input_output_declarations_c *symbol) {
@@ -47,6 +47,8 @@
  */
 
 
+#include <map>
+#include <vector>
 #include "../absyntax/visitor.hh"
 
 
@@ -81,9 +83,7 @@ class function_param_iterator_c : public null_visitor_c {
     * or function_declaration_c currently being analysed.
     */
     symbol_c *f_decl;
-    int next_param, param_count;
-    /* used when called to search() for a parameter by name */
-    identifier_c *search_param_name;
+    int next_param;
     /* used when called to iterate() for a parameter */
     identifier_c *current_param_name;
     symbol_c *current_param_type;
@@ -100,23 +100,47 @@ class function_param_iterator_c : public null_visitor_c {
     int  current_extensible_param_index;
     int  _first_extensible_param_index;
 
-    /* Which operation of the class was called...
-     * Search a parameter, or iterate to the next parameter.
-     */
-    typedef enum {iterate_op, search_op} operation_t;
-    operation_t current_operation;
-    
     /* the last parameter/value returned by search() or next() */
     symbol_c *last_returned_parameter; 
     
+    /* The parameters of a POU are stored in a table the first time an iterator is created for that POU,
+     * and the table is shared by all the iterators of the same POU. next() and search() therefore no
+     * longer walk through all the variable declarations of the POU (i.e. once for every parameter
+     * of every call).
+     *
+     * The table is built by visiting the POU declaration with this same class (the visit() methods
+     * below), which adds each parameter it finds to building_table.
+     */
+    typedef struct {
+      identifier_c      *name;
+      symbol_c          *type;
+      symbol_c          *default_value;
+      param_direction_t  direction;
+      bool               en_eno_implicit;
+      bool               extensible;
+      int                first_extensible_index;  /* only for extensible parameters */
+    } param_t;
+    typedef struct {
+      std::vector<param_t>        params;      /* in the order they are declared */
+      std::map<const char *, int> index;       /* key: the case folded (interned) parameter name. Does not include the extensible parameters! */
+      std::vector<int>            extensible;  /* the extensible parameters */
+    } param_table_t;
+    static std::map<symbol_c *, param_table_t *> param_tables;
+    param_table_t *table;           /* the table of f_decl */
+    param_table_t *building_table;  /* table currently being built */
+
   private:
     int   cmp_extparam_names(const char* s1, const char* s2);
     void* handle_param_list(list_c *list);
     void* handle_single_param(symbol_c *var_name);
+    void  set_current(const param_t &param);
 
     void* iterate_list(list_c *list);
 
   public:
+    /* Forget the parameter table of every POU. Must be called before working on a new AST. */
+    static void clear_tables(void);
+
     /* start off at the first parameter once again... */
     void reset(void);
 
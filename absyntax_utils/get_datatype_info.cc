@@ -63,6 +63,77 @@
 /**********************************************************/
 
 
+/****************************************************************************************************/
+/****************************************************************************************************/
+/* Return the id of an elementary datatype (see get_datatype_info_c::elementary_type_id())          */
+/****************************************************************************************************/
+/****************************************************************************************************/
+/* NOTE: this class has no state, so the same singleton may be used by any number of callers. */
+class get_elementary_type_id_c: null_visitor_c {
+  private:
+    static get_elementary_type_id_c *singleton;
+    
+  public:
+    static int get_id(symbol_c *symbol) {
+      if (NULL == singleton) singleton = new  get_elementary_type_id_c();
+      if (NULL == singleton) ERROR;
+      return (int)(intptr_t)symbol->accept(*singleton);
+    }
+    
+  protected:
+    /***********************************/
+    /* B 1.3.1 - Elementary Data Types */
+    /***********************************/
+    void *visit(time_type_name_c        *symbol) {return (void *) 1;};
+    void *visit(bool_type_name_c        *symbol) {return (void *) 2;};
+    void *visit(sint_type_name_c        *symbol) {return (void *) 3;};
+    void *visit(int_type_name_c         *symbol) {return (void *) 4;};
+    void *visit(dint_type_name_c        *symbol) {return (void *) 5;};
+    void *visit(lint_type_name_c        *symbol) {return (void *) 6;};
+    void *visit(usint_type_name_c       *symbol) {return (void *) 7;};
+    void *visit(uint_type_name_c        *symbol) {return (void *) 8;};
+    void *visit(udint_type_name_c       *symbol) {return (void *) 9;};
+    void *visit(ulint_type_name_c       *symbol) {return (void *)10;};
+    void *visit(real_type_name_c        *symbol) {return (void *)11;};
+    void *visit(lreal_type_name_c       *symbol) {return (void *)12;};
+    void *visit(date_type_name_c        *symbol) {return (void *)13;};
+    void *visit(tod_type_name_c         *symbol) {return (void *)14;};
+    void *visit(dt_type_name_c          *symbol) {return (void *)15;};
+    void *visit(byte_type_name_c        *symbol) {return (void *)16;};
+    void *visit(word_type_name_c        *symbol) {return (void *)17;};
+    void *visit(lword_type_name_c       *symbol) {return (void *)18;};
+    void *visit(dword_type_name_c       *symbol) {return (void *)19;};
+    void *visit(string_type_name_c      *symbol) {return (void *)20;};
+    void *visit(wstring_type_name_c     *symbol) {return (void *)21;};
+
+    void *visit(safetime_type_name_c    *symbol) {return (void *)22;};
+    void *visit(safebool_type_name_c    *symbol) {return (void *)23;};
+    void *visit(safesint_type_name_c    *symbol) {return (void *)24;};
+    void *visit(safeint_type_name_c     *symbol) {return (void *)25;};
+    void *visit(safedint_type_name_c    *symbol) {return (void *)26;};
+    void *visit(safelint_type_name_c    *symbol) {return (void *)27;};
+    void *visit(safeusint_type_name_c   *symbol) {return (void *)28;};
+    void *visit(safeuint_type_name_c    *symbol) {return (void *)29;};
+    void *visit(safeudint_type_name_c   *symbol) {return (void *)30;};
+    void *visit(safeulint_type_name_c   *symbol) {return (void *)31;};
+    void *visit(safereal_type_name_c    *symbol) {return (void *)32;};
+    void *visit(safelreal_type_name_c   *symbol) {return (void *)33;};
+    void *visit(safedate_type_name_c    *symbol) {return (void *)34;};
+    void *visit(safetod_type_name_c     *symbol) {return (void *)35;};
+    void *visit(safedt_type_name_c      *symbol) {return (void *)36;};
+    void *visit(safebyte_type_name_c    *symbol) {return (void *)37;};
+    void *visit(safeword_type_name_c    *symbol) {return (void *)38;};
+    void *visit(safelword_type_name_c   *symbol) {return (void *)39;};
+    void *visit(safedword_type_name_c   *symbol) {return (void *)40;};
+    void *visit(safestring_type_name_c  *symbol) {return (void *)41;};
+    void *visit(safewstring_type_name_c *symbol) {return (void *)42;};
+};
+
+get_elementary_type_id_c *get_elementary_type_id_c::singleton = NULL;
+
+
+
+
 /****************************************************************************************************/
 /****************************************************************************************************/
 /* Return the identifier (name) of a datatype, typically declared in a TYPE .. END_TYPE declaration */
@@ -146,8 +217,8 @@ class get_datatype_id_c: null_visitor_c {
     void *visit(string_type_declaration_c     *symbol)  {return symbol->string_type_name;}
     /* ref_type_decl: identifier ':' ref_spec_init */
     void *visit(ref_type_decl_c               *symbol)  {return symbol->ref_type_name;}
-    /* NOTE: DO NOT place any code here that references symbol->anotations_map["generate_c_annotaton__implicit_type_id"] !!
-     *       All anotations in the symbol->anotations_map[] are considered a stage4 construct. In the above example,
+    /* NOTE: DO NOT place any code here that references the generate_c implicit_type_id annotation !!
+     *       All annotation_table_c annotations are considered a stage4 construct. In the above example,
      *       That anotation is specific to the generate_c stage4 code, and must therefore NOT be referenced
      *       in the absyntax_utils code, as this last code should be independent of the stage4 version!
      */ 
@@ -286,8 +357,8 @@ class get_datatype_id_str_c: public null_visitor_c {
     void *visit(string_type_declaration_c     *symbol)  {return symbol->string_type_name->accept(*this);}
     /* ref_type_decl: identifier ':' ref_spec_init */
     void *visit(ref_type_decl_c               *symbol)  {return symbol->ref_type_name->accept(*this);}
-    /* NOTE: DO NOT place any code here that references symbol->anotations_map["generate_c_annotaton__implicit_type_id"] !!
-     *       All anotations in the symbol->anotations_map[] are considered a stage4 construct. In the above example,
+    /* NOTE: DO NOT place any code here that references the generate_c implicit_type_id annotation !!
+     *       All annotation_table_c annotations are considered a stage4 construct. In the above example,
      *       That anotation is specific to the generate_c stage4 code, and must therefore NOT be referenced
      *       in the absyntax_utils code, as this last code should be independent of the stage4 version!
      */ 
@@ -580,6 +651,19 @@ symbol_c *get_datatype_info_c::get_array_storedtype_id(symbol_c *type_symbol) {
  *       REF_TO datatypes, so in both the relaxed and strict datatype models matiec currently uses a 
  *       relaxed datatype equivalince for REF_TO datatypes.
  */
+int get_datatype_info_c::elementary_type_id(symbol_c *type_symbol) {
+  if (type_symbol == NULL)                                     {return 0;}
+  return get_elementary_type_id_c::get_id(type_symbol);
+}
+
+
+uint64_t get_datatype_info_c::elementary_type_mask(symbol_c *type_symbol) {
+  int id = elementary_type_id(type_symbol);
+  return (0 == id)? 0 : ((uint64_t)1 << (id - 1));
+}
+
+
+
 bool get_datatype_info_c::is_type_equal(symbol_c *first_type, symbol_c *second_type) {
   if (!is_type_valid( first_type))                                   {return false;}
   if (!is_type_valid(second_type))                                   {return false;}
@@ -590,10 +674,9 @@ bool get_datatype_info_c::is_type_equal(symbol_c *first_type, symbol_c *second_t
       (is_ANY_generic_type(second_type)))                            {return true;}
       
   /* ANY_ELEMENTARY */
-  if ((is_ANY_ELEMENTARY_compatible(first_type)) &&
-      (typeid(*first_type) == typeid(*second_type)))                 {return true;}
-  if (   is_ANY_ELEMENTARY_compatible(first_type) 
-      || is_ANY_ELEMENTARY_compatible(second_type))                  {return false;}  
+  int first_id  = elementary_type_id( first_type);
+  int second_id = elementary_type_id(second_type);
+  if ((0 != first_id) || (0 != second_id))                           {return (first_id == second_id);}
   
   /* ANY_DERIVED  */
   // from now on, we are sure both datatypes are derived...
@@ -772,47 +855,127 @@ symbol_c *get_datatype_info_c::get_ref_to(symbol_c *type_symbol) {
 
 
 
+/* The integer value of a constant (e.g. a subrange limit), when it fits in an int64_t */
+static bool get_int64_cvalue(symbol_c *symbol, int64_t &value) {
+  if (NULL == symbol) return false;
+  if (symbol->const_value._int64.is_valid())  {value = symbol->const_value._int64.get(); return true;}
+  if (symbol->const_value._uint64.is_valid() && (symbol->const_value._uint64.get() <= (uint64_t)INT64_MAX))
+                                              {value = (int64_t)symbol->const_value._uint64.get(); return true;}
+  return false;
+}
+
 
+bool get_datatype_info_c::get_int64_value(symbol_c *expression, int64_t &value) {
+  return get_int64_cvalue(expression, value);
+}
 
 
-bool get_datatype_info_c::is_ref_to(symbol_c *type_symbol) {
-  symbol_c *type_decl = search_base_type_c::get_basetype_decl(type_symbol);
-  if (NULL == type_decl)                                                       {return false;}
-  
-  if (typeid(*type_decl) == typeid(ref_type_decl_c))                           {return true;}   /* identifier ':' ref_spec_init */
-  if (typeid(*type_decl) == typeid(ref_spec_init_c))                           {return true;}   /* ref_spec [ ASSIGN ref_initialization ]; */
-  if (typeid(*type_decl) == typeid(ref_spec_c))                                {return true;}   /* REF_TO (non_generic_type_name | function_block_type_name) */
+bool get_datatype_info_c::get_int_range(symbol_c *type_symbol, int64_t &lower, int64_t &upper) {
+  if (NULL == type_symbol) return false;
+  subrange_type_declaration_c *type1 = dynamic_cast<subrange_type_declaration_c *>(type_symbol);
+  if (NULL != type1) type_symbol = type1->subrange_spec_init;
+  subrange_spec_init_c        *type2 = dynamic_cast<subrange_spec_init_c        *>(type_symbol);
+  if (NULL != type2) type_symbol = type2->subrange_specification;
+  subrange_specification_c    *type3 = dynamic_cast<subrange_specification_c    *>(type_symbol);
+  if (NULL != type3) {
+    subrange_c *subrange = dynamic_cast<subrange_c *>(type3->subrange);
+    if (NULL == subrange) return get_int_range(type3->integer_type_name, lower, upper);
+    return get_int64_cvalue(subrange->lower_limit, lower) && get_int64_cvalue(subrange->upper_limit, upper);
+  }
+
+  const std::type_info &type = typeid(*type_symbol);
+  if ((type == typeid(sint_type_name_c))  || (type == typeid(safesint_type_name_c)))  {lower = INT8_MIN;  upper = INT8_MAX;   return true;}
+  if ((type == typeid(int_type_name_c))   || (type == typeid(safeint_type_name_c)))   {lower = INT16_MIN; upper = INT16_MAX;  return true;}
+  if ((type == typeid(dint_type_name_c))  || (type == typeid(safedint_type_name_c)))  {lower = INT32_MIN; upper = INT32_MAX;  return true;}
+  if ((type == typeid(lint_type_name_c))  || (type == typeid(safelint_type_name_c)))  {lower = INT64_MIN; upper = INT64_MAX;  return true;}
+  if ((type == typeid(usint_type_name_c)) || (type == typeid(safeusint_type_name_c))) {lower = 0;         upper = UINT8_MAX;  return true;}
+  if ((type == typeid(uint_type_name_c))  || (type == typeid(safeuint_type_name_c)))  {lower = 0;         upper = UINT16_MAX; return true;}
+  if ((type == typeid(udint_type_name_c)) || (type == typeid(safeudint_type_name_c))) {lower = 0;         upper = UINT32_MAX; return true;}
   return false;
 }
 
 
 
 
+
+
+/* Determine the category of the base type (and equivalent type) of type_symbol. */
+unsigned int get_datatype_info_c::get_type_category(symbol_c *type_symbol) {
+  if (NULL == type_symbol)                                           {return 0;}
+  /* NOTE: resolving the base type will reset the cached category if it is no longer valid, so do this first! */
+  symbol_c *type_decl  = search_base_type_c::get_basetype_decl (type_symbol);
+  symbol_c *equiv_decl = search_base_type_c::get_equivtype_decl(type_symbol); /* NOTE: subranges use the equivalent type! */
+  if (0 != type_symbol->cached_type_category)                        {return type_symbol->cached_type_category;}
+
+  unsigned int category = cat_determined;
+  if (NULL != type_decl) {
+    const std::type_info &type = typeid(*type_decl);
+    if (type == typeid(ref_type_decl_c))                             {category |= cat_ref_to;}           /* identifier ':' ref_spec_init */
+    if (type == typeid(ref_spec_init_c))                             {category |= cat_ref_to;}           /* ref_spec [ ASSIGN ref_initialization ]; */
+    if (type == typeid(ref_spec_c))                                  {category |= cat_ref_to;}           /* REF_TO (non_generic_type_name | function_block_type_name) */
+
+    if (type == typeid(initial_step_c))                              {category |= cat_sfc_initstep | cat_sfc_step;} /* INITIAL_STEP step_name ':' action_association_list END_STEP */  /* A pseudo data type! */
+    if (type == typeid(        step_c))                              {category |= cat_sfc_step;}         /*         STEP step_name ':' action_association_list END_STEP */  /* A pseudo data type! */
+
+    if (type == typeid(function_block_declaration_c))                {category |= cat_function_block;}   /*  FUNCTION_BLOCK derived_function_block_name io_OR_other_var_declarations function_block_body END_FUNCTION_BLOCK */
+
+    if (type == typeid(enumerated_type_declaration_c))               {category |= cat_enumerated;}       /*  enumerated_type_name ':' enumerated_spec_init */
+    if (type == typeid(enumerated_spec_init_c))                      {category |= cat_enumerated;}       /* enumerated_specification ASSIGN enumerated_value */
+    if (type == typeid(enumerated_value_list_c))                     {category |= cat_enumerated;}       /* enumerated_value_list ',' enumerated_value */        /* once we change the way we handle enums, this will probably become an ERROR! */
+    if (type == typeid(enumerated_value_c))                          {category |= cat_enumerated_error;} /* enumerated_type_name '#' identifier */
+
+    if (type == typeid(array_type_declaration_c))                    {category |= cat_array;}            /*  identifier ':' array_spec_init */
+    if (type == typeid(array_spec_init_c))                           {category |= cat_array;}            /* array_specification [ASSIGN array_initialization} */
+    if (type == typeid(array_specification_c))                       {category |= cat_array;}            /* ARRAY '[' array_subrange_list ']' OF non_generic_type_name */
+    if (type == typeid(array_subrange_list_c))                       {category |= cat_array_error;}      /* array_subrange_list ',' subrange */
+    if (type == typeid(array_initial_elements_list_c))               {category |= cat_array_error;}      /* array_initialization:  '[' array_initial_elements_list ']' */  /* array_initial_elements_list ',' array_initial_elements */
+    if (type == typeid(array_initial_elements_c))                    {category |= cat_array_error;}      /* integer '(' [array_initial_element] ')' */
+
+    if (type == typeid(structure_type_declaration_c))                {category |= cat_structure;}        /*  structure_type_name ':' structure_specification */
+    if (type == typeid(initialized_structure_c))                     {category |= cat_structure;}        /* structure_type_name ASSIGN structure_initialization */
+    if (type == typeid(structure_element_declaration_list_c))        {category |= cat_structure;}        /* structure_declaration:  STRUCT structure_element_declaration_list END_STRUCT */ /* structure_element_declaration_list structure_element_declaration ';' */
+    if (type == typeid(structure_element_declaration_c))             {category |= cat_structure_error;}  /*  structure_element_name ':' *_spec_init */
+    if (type == typeid(structure_element_initialization_list_c))     {category |= cat_structure_error;}  /* structure_initialization: '(' structure_element_initialization_list ')' */  /* structure_element_initialization_list ',' structure_element_initialization */
+    if (type == typeid(structure_element_initialization_c))          {category |= cat_structure_error;}  /*  structure_element_name ASSIGN value */
+
+    if (type == typeid(generic_type_any_c))                          {category |= cat_ANY_generic;}      /*  The ANY keyword! */
+  }
+  if (NULL != equiv_decl) {
+    const std::type_info &type = typeid(*equiv_decl);
+    if (type == typeid(subrange_type_declaration_c))                 {category |= cat_subrange;}         /*  subrange_type_name ':' subrange_spec_init */
+    if (type == typeid(subrange_spec_init_c))                        {category |= cat_subrange;}         /* subrange_specification ASSIGN signed_integer */
+    if (type == typeid(subrange_specification_c))                    {category |= cat_subrange;}         /*  integer_type_name '(' subrange')' */
+    if (type == typeid(subrange_c))                                  {category |= cat_subrange_error;}   /*  signed_integer DOTDOT signed_integer */
+  }
+
+  type_symbol->cached_type_category = category;
+  return category;
+}
+
+
+
+bool get_datatype_info_c::is_ref_to(symbol_c *type_symbol) {
+  return (0 != (get_type_category(type_symbol) & cat_ref_to));
+}
+
+
+
+
 bool get_datatype_info_c::is_sfc_initstep(symbol_c *type_symbol) {
-  symbol_c *type_decl = search_base_type_c::get_basetype_decl(type_symbol); 
-  if (NULL == type_decl)                                             {return false;}
-  if (typeid(*type_decl) == typeid(initial_step_c))                  {return true;}   /* INITIAL_STEP step_name ':' action_association_list END_STEP */  /* A pseudo data type! */
-  return false;
+  return (0 != (get_type_category(type_symbol) & cat_sfc_initstep));
 }
 
 
 
 bool get_datatype_info_c::is_sfc_step(symbol_c *type_symbol) {
-  symbol_c *type_decl = search_base_type_c::get_basetype_decl(type_symbol); 
-  if (NULL == type_decl)                                             {return false;}
-  if (typeid(*type_decl) == typeid(initial_step_c))                  {return true;}   /* INITIAL_STEP step_name ':' action_association_list END_STEP */  /* A pseudo data type! */
-  if (typeid(*type_decl) == typeid(        step_c))                  {return true;}   /*         STEP step_name ':' action_association_list END_STEP */  /* A pseudo data type! */
-  return false;
+  return (0 != (get_type_category(type_symbol) & cat_sfc_step));
 }
 
 
 
 
 bool get_datatype_info_c::is_function_block(symbol_c *type_symbol) {
-  symbol_c *type_decl = search_base_type_c::get_basetype_decl(type_symbol); 
-  if (NULL == type_decl)                                             {return false;}
-  if (typeid(*type_decl) == typeid(function_block_declaration_c))    {return true;}   /*  FUNCTION_BLOCK derived_function_block_name io_OR_other_var_declarations function_block_body END_FUNCTION_BLOCK */
-  return false;
+  return (0 != (get_type_category(type_symbol) & cat_function_block));
 }
 
 
@@ -820,15 +983,9 @@ bool get_datatype_info_c::is_function_block(symbol_c *type_symbol) {
 
 
 bool get_datatype_info_c::is_subrange(symbol_c *type_symbol) {
-  symbol_c *type_decl = search_base_type_c::get_equivtype_decl(type_symbol); /* NOTE: do NOT call search_base_type_c !! */
-  if (NULL == type_decl)                                             {return false;}
-  
-  if (typeid(*type_decl) == typeid(subrange_type_declaration_c))     {return true;}   /*  subrange_type_name ':' subrange_spec_init */
-  if (typeid(*type_decl) == typeid(subrange_spec_init_c))            {return true;}   /* subrange_specification ASSIGN signed_integer */
-  if (typeid(*type_decl) == typeid(subrange_specification_c))        {return true;}   /*  integer_type_name '(' subrange')' */
-    
-  if (typeid(*type_decl) == typeid(subrange_c))                      {ERROR;}         /*  signed_integer DOTDOT signed_integer */
-  return false;
+  unsigned int category = get_type_category(type_symbol);
+  if (0 != (category & cat_subrange_error))                          {ERROR;}
+  return (0 != (category & cat_subrange));
 }
 
 
@@ -836,15 +993,9 @@ bool get_datatype_info_c::is_subrange(symbol_c *type_symbol) {
 
 
 bool get_datatype_info_c::is_enumerated(symbol_c *type_symbol) {
-  symbol_c *type_decl = search_base_type_c::get_basetype_decl(type_symbol);
-  if (NULL == type_decl)                                             {return false;}
-  
-  if (typeid(*type_decl) == typeid(enumerated_type_declaration_c))   {return true;}   /*  enumerated_type_name ':' enumerated_spec_init */
-  if (typeid(*type_decl) == typeid(enumerated_spec_init_c))          {return true;}   /* enumerated_specification ASSIGN enumerated_value */
-  if (typeid(*type_decl) == typeid(enumerated_value_list_c))         {return true;}   /* enumerated_value_list ',' enumerated_value */        /* once we change the way we handle enums, this will probably become an ERROR! */
-  
-  if (typeid(*type_decl) == typeid(enumerated_value_c))              {ERROR;}         /* enumerated_type_name '#' identifier */
-  return false;
+  unsigned int category = get_type_category(type_symbol);
+  if (0 != (category & cat_enumerated_error))                        {ERROR;}
+  return (0 != (category & cat_enumerated));
 }
 
 
@@ -852,17 +1003,9 @@ bool get_datatype_info_c::is_enumerated(symbol_c *type_symbol) {
 
 
 bool get_datatype_info_c::is_array(symbol_c *type_symbol) {
-  symbol_c *type_decl = search_base_type_c::get_basetype_decl(type_symbol);
-  if (NULL == type_decl)                                             {return false;}
-  
-  if (typeid(*type_decl) == typeid(array_type_declaration_c))        {return true;}   /*  identifier ':' array_spec_init */
-  if (typeid(*type_decl) == typeid(array_spec_init_c))               {return true;}   /* array_specification [ASSIGN array_initialization} */
-  if (typeid(*type_decl) == typeid(array_specification_c))           {return true;}   /* ARRAY '[' array_subrange_list ']' OF non_generic_type_name */
-  
-  if (typeid(*type_decl) == typeid(array_subrange_list_c))           {ERROR;}         /* array_subrange_list ',' subrange */
-  if (typeid(*type_decl) == typeid(array_initial_elements_list_c))   {ERROR;}         /* array_initialization:  '[' array_initial_elements_list ']' */  /* array_initial_elements_list ',' array_initial_elements */
-  if (typeid(*type_decl) == typeid(array_initial_elements_c))        {ERROR;}         /* integer '(' [array_initial_element] ')' */
-  return false;
+  unsigned int category = get_type_category(type_symbol);
+  if (0 != (category & cat_array_error))                             {ERROR;}
+  return (0 != (category & cat_array));
 }
 
 
@@ -870,27 +1013,16 @@ bool get_datatype_info_c::is_array(symbol_c *type_symbol) {
 
 
 bool get_datatype_info_c::is_structure(symbol_c *type_symbol) {
-  symbol_c *type_decl = search_base_type_c::get_basetype_decl(type_symbol);
-  if (NULL == type_decl)                                                       {return false;}
-  
-  if (typeid(*type_decl) == typeid(structure_type_declaration_c))              {return true;}   /*  structure_type_name ':' structure_specification */
-  if (typeid(*type_decl) == typeid(initialized_structure_c))                   {return true;}   /* structure_type_name ASSIGN structure_initialization */
-  if (typeid(*type_decl) == typeid(structure_element_declaration_list_c))      {return true;}   /* structure_declaration:  STRUCT structure_element_declaration_list END_STRUCT */ /* structure_element_declaration_list structure_element_declaration ';' */
-  
-  if (typeid(*type_decl) == typeid(structure_element_declaration_c))           {ERROR;}         /*  structure_element_name ':' *_spec_init */
-  if (typeid(*type_decl) == typeid(structure_element_initialization_list_c))   {ERROR;}         /* structure_initialization: '(' structure_element_initialization_list ')' */  /* structure_element_initialization_list ',' structure_element_initialization */
-  if (typeid(*type_decl) == typeid(structure_element_initialization_c))        {ERROR;}         /*  structure_element_name ASSIGN value */
-  return false;
+  unsigned int category = get_type_category(type_symbol);
+  if (0 != (category & cat_structure_error))                         {ERROR;}
+  return (0 != (category & cat_structure));
 }
 
 
 
 
 bool get_datatype_info_c::is_ANY_generic_type(symbol_c *type_symbol) {
-  symbol_c *type_decl = search_base_type_c::get_basetype_decl(type_symbol);
-  if (NULL == type_decl)                                             {return false;}  
-  if (typeid(*type_decl) == typeid(generic_type_any_c))              {return true;}   /*  The ANY keyword! */
-  return false;
+  return (0 != (get_type_category(type_symbol) & cat_ANY_generic));
 }
 
 
@@ -916,9 +1048,7 @@ bool get_datatype_info_c::is_ANY_SAFEELEMENTARY(symbol_c *type_symbol) {
 
 bool get_datatype_info_c::is_ANY_ELEMENTARY_compatible(symbol_c *type_symbol) {
   if (type_symbol == NULL)                                     {return false;}
-  if (is_ANY_ELEMENTARY    (type_symbol))                      {return true;}
-  if (is_ANY_SAFEELEMENTARY(type_symbol))                      {return true;}
-  return false;
+  return (0 != elementary_type_id(type_symbol));
 }
 
 
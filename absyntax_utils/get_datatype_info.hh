@@ -58,6 +58,28 @@ class get_datatype_info_c {
     // A helper method to get_datatype_info_c::is_type_equal()
     // Assuming the relaxed datatype model, return whether the two array datatypes are equal/equivalent
     static bool is_arraytype_equal_relaxed(symbol_c *first_type, symbol_c *second_type);
+
+    /* The category of the base (or equivalent) type of a datatype, as used by the is_ref_to(), is_array(), ... methods. 
+     * It is determined only once for each symbol, and then cached in symbol_c::cached_type_category.
+     * The *_error flags mark base types that must never be passed to the corresponding is_*() method.
+     */
+    typedef enum {
+      cat_determined       = 1 <<  0,  /* never 0, so we know the category has already been determined */
+      cat_ref_to           = 1 <<  1,
+      cat_sfc_initstep     = 1 <<  2,
+      cat_sfc_step         = 1 <<  3,
+      cat_function_block   = 1 <<  4,
+      cat_subrange         = 1 <<  5,
+      cat_subrange_error   = 1 <<  6,
+      cat_enumerated       = 1 <<  7,
+      cat_enumerated_error = 1 <<  8,
+      cat_array            = 1 <<  9,
+      cat_array_error      = 1 << 10,
+      cat_structure        = 1 << 11,
+      cat_structure_error  = 1 << 12,
+      cat_ANY_generic      = 1 << 13
+    } type_category_t;
+    static unsigned int get_type_category(symbol_c *type_symbol);
   
   public:
     static symbol_c   *get_id    (symbol_c *datatype); /* get the identifier (name) of the datatype); returns NULL if anonymous datatype! Does not work for elementary datatypes!*/
@@ -66,6 +88,12 @@ class get_datatype_info_c {
     static symbol_c *get_struct_field_type_id      (symbol_c *struct_datatype, symbol_c *struct_fieldname); // returns datatype of a field in a structure
     static symbol_c *get_array_storedtype_id       (symbol_c *type_symbol);    // returns the datatype of the variables stored in the array
     static symbol_c *get_ref_to                    (symbol_c *type_symbol);    // Defined in IEC 61131-3 v3 (returns the type that is being referenced/pointed to)        
+    /* The range of the values of an integer datatype (elementary or subrange). Returns false for the other datatypes,
+     * and for ULINT (whose values do not all fit in an int64_t).
+     */
+    static bool get_int_range                      (symbol_c *type_symbol, int64_t &lower, int64_t &upper);
+    /* The constant value of an integer expression (see constant_folding_c), when it fits in an int64_t */
+    static bool get_int64_value                    (symbol_c *expression,  int64_t &value);
     
     /* Returns true if both datatypes are equivalent (not necessarily equal!).
      * Two datatype models are supported: relaxed and strict (chosen from a command line option).
@@ -83,6 +111,15 @@ class get_datatype_info_c {
     static bool is_type_equal(symbol_c *first_type, symbol_c *second_type);
     static bool is_type_valid(symbol_c *type);
 
+    /* Each elementary datatype (INT, SAFEINT, BOOL, STRING, ...) has a small integer id, between 1 and elementary_type_count.
+     * Two elementary datatypes are equal if and only if they have the same id, so a set of elementary datatypes may
+     * be stored in a bitmask (see elementary_type_mask()).
+     * Returns 0 if type_symbol is not an elementary datatype.
+     */
+    static const int elementary_type_count = 42;
+    static int       elementary_type_id    (symbol_c *type_symbol);
+    static uint64_t  elementary_type_mask  (symbol_c *type_symbol);  /* 1 << (id-1), or 0 if not an elementary datatype */
+
     static bool is_ref_to                          (symbol_c *type_symbol);    // Defined in IEC 61131-3 v3
     static bool is_sfc_initstep                    (symbol_c *type_symbol);
     static bool is_sfc_step                        (symbol_c *type_symbol);
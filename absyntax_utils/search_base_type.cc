@@ -62,38 +62,51 @@ void search_base_type_c::create_singleton(void) {
   if (NULL == search_base_type_singleton)   ERROR;
 }
 
+/* Start at 1, so the symbols (whose cached_type_generation is initialised to 0) start off with nothing cached. */
+unsigned int search_base_type_c::cache_generation = 1;
+
 /* static method! */
-symbol_c *search_base_type_c::get_equivtype_decl(symbol_c *symbol) {
+void search_base_type_c::clear_cache(void) {
+  cache_generation++;
+}
+
+/* static method! */
+/* A single search determines the base type, the equivalent type, and the base type identifier. 
+ * Store all three in the symbol, unless they are already there.
+ */
+void search_base_type_c::resolve(symbol_c *symbol) {
+  if (symbol->cached_type_generation == cache_generation) return;
   create_singleton();
-  if (NULL == symbol)    return NULL; 
   search_base_type_singleton->current_basetype_name = NULL;
   search_base_type_singleton->current_basetype  = NULL; 
   search_base_type_singleton->current_equivtype = NULL; 
   symbol_c *basetype = (symbol_c *)symbol->accept(*search_base_type_singleton);
-  if (NULL != search_base_type_singleton->current_equivtype)
-    return search_base_type_singleton->current_equivtype;
-  return basetype;
+  symbol->cached_basetype_decl  = basetype;
+  symbol->cached_equivtype_decl = (NULL != search_base_type_singleton->current_equivtype)? search_base_type_singleton->current_equivtype : basetype;
+  symbol->cached_basetype_id    = search_base_type_singleton->current_basetype_name;
+  symbol->cached_type_category  = 0;
+  symbol->cached_type_generation = cache_generation;
+}
+
+/* static method! */
+symbol_c *search_base_type_c::get_equivtype_decl(symbol_c *symbol) {
+  if (NULL == symbol)    return NULL; 
+  resolve(symbol);
+  return symbol->cached_equivtype_decl;
 }
 
 /* static method! */
 symbol_c *search_base_type_c::get_basetype_decl(symbol_c *symbol) {
-  create_singleton();
   if (NULL == symbol)    return NULL; 
-  search_base_type_singleton->current_basetype_name = NULL;
-  search_base_type_singleton->current_basetype  = NULL; 
-  search_base_type_singleton->current_equivtype = NULL; 
-  return (symbol_c *)symbol->accept(*search_base_type_singleton);
+  resolve(symbol);
+  return symbol->cached_basetype_decl;
 }
 
 /* static method! */
 symbol_c *search_base_type_c::get_basetype_id  (symbol_c *symbol) {
-  create_singleton();
   if (NULL == symbol)    return NULL; 
-  search_base_type_singleton->current_basetype_name = NULL;
-  search_base_type_singleton->current_basetype  = NULL; 
-  search_base_type_singleton->current_equivtype = NULL; 
-  symbol->accept(*search_base_type_singleton);
-  return (symbol_c *)search_base_type_singleton->current_basetype_name;
+  resolve(symbol);
+  return symbol->cached_basetype_id;
 }
 
 
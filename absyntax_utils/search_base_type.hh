@@ -74,6 +74,7 @@ class search_base_type_c: public null_visitor_c {
     
   private:  
     static void create_singleton(void);
+    static void resolve(symbol_c *symbol);
     void *handle_datatype_identifier(token_c *type_name);
 
   public:
@@ -82,6 +83,12 @@ class search_base_type_c: public null_visitor_c {
     static symbol_c *get_basetype_decl (symbol_c *symbol);  /* get the Base       Type declaration */
     static symbol_c *get_basetype_id   (symbol_c *symbol);  /* get the Base       Type identifier  */
 
+    /* The results are cached in the symbol itself (see symbol_c::cached_type_generation).
+     * clear_cache() invalidates all of them, and must be called before working on a new AST.
+     */
+    static unsigned int cache_generation;
+    static void clear_cache(void);
+
   public:
   /*************************/
   /* B.1 - Common elements */
@@ -51,25 +51,41 @@
 /* set to 1 to see debug info during execution */
 static int debug = 0;
 
+std::map<symbol_c *, search_il_label_c::label_index_t *> search_il_label_c::label_indexes;
+
 search_il_label_c::search_il_label_c(symbol_c *search_scope) {
   this->search_scope = search_scope;
-  this->search_label = NULL;
+  this->label_index  = NULL;
 }
 
 search_il_label_c::~search_il_label_c(void) {
 }
 
 
+void search_il_label_c::clear_index(void) {
+  std::map<symbol_c *, label_index_t *>::iterator iter;
+  for (iter = label_indexes.begin(); iter != label_indexes.end(); iter++)
+    delete iter->second;
+  label_indexes.clear();
+}
+
+
 il_instruction_c *search_il_label_c::find_label(const char *label) {
-  return find_label(new identifier_c(label));
+  identifier_c tmp_identifier(label);
+  return find_label(&tmp_identifier);
 }
 
 
 il_instruction_c *search_il_label_c::find_label(symbol_c *label) {
-  search_label = label;
-  il_instruction_c *res = (il_instruction_c *)search_scope->accept(*this);
-  search_label = NULL;
-  return res;
+  identifier_c *label_name = dynamic_cast<identifier_c *>(label);
+  if (NULL == label_name) return NULL;
+  /* get the index of the instruction list (visit(instruction_list_c *) sets label_index) */
+  if (NULL == label_index) search_scope->accept(*this);
+  if (NULL == label_index) return NULL;  /* not an IL POU */
+
+  label_index_t::iterator iter = label_index->find(label_name->value);
+  if (iter == label_index->end()) return NULL;
+  return iter->second;
 }
 
 
@@ -80,18 +96,23 @@ il_instruction_c *search_il_label_c::find_label(symbol_c *label) {
 /* B 2.1 Instructions and Operands */
 /***********************************/
 
-/* | label ':' [il_incomplete_instruction] eol_list */
-// SYM_REF2(il_instruction_c, label, il_instruction)
-// void *visit(instruction_list_c *symbol);
-void *search_il_label_c::visit(il_instruction_c *symbol) {
-// printf("search_il_label_c::visit(il_instruction_c *symbol): searching for %s\n", ((identifier_c *)search_label)->value);
-	if (NULL != symbol->label)
-		if (compare_identifiers(search_label, symbol->label) == 0)
-			return symbol;
-
-	return NULL;
+/*| instruction_list il_instruction */
+// SYM_LIST(instruction_list_c)
+void *search_il_label_c::visit(instruction_list_c *symbol) {
+  std::map<symbol_c *, label_index_t *>::iterator iter = label_indexes.find(symbol);
+  if (iter != label_indexes.end()) {label_index = iter->second; return NULL;}
+
+  label_index = new label_index_t();
+  label_indexes[symbol] = label_index;
+  for (int i = 0; i < symbol->n; i++) {
+    il_instruction_c *il_instruction = dynamic_cast<il_instruction_c *>(symbol->get_element(i));
+    if ((NULL == il_instruction) || (NULL == il_instruction->label)) continue;
+    identifier_c *label = dynamic_cast<identifier_c *>(il_instruction->label);
+    if (NULL == label) continue;
+    /* insert() keeps the first instruction with a repeated label, as the search did */
+    label_index->insert(std::pair<std::string, il_instruction_c *>(label->value, il_instruction));
+    if (debug) printf("search_il_label_c: label %s\n", label->value);
+  }
+  return NULL;
 }
 
-
-
-
@@ -41,19 +41,27 @@
  *     - instruction_list_c
  *
  * which is where all calls to search for a specific label will look for said label.
+ *
+ *  The labels of each instruction_list_c are indexed the first time a label is searched in it,
+ *  and the index is then shared by all the search_il_label_c objects searching the same list.
  */
 
 
 
-#include "../absyntax_utils/absyntax_utils.hh"
+#include <map>
+#include <string>
+#include "../absyntax/visitor.hh"
 
 
 class search_il_label_c: public search_visitor_c {
 
   private:
-    search_varfb_instance_type_c *search_varfb_instance_type;
-    symbol_c *search_scope;
-    symbol_c *search_label;
+    /* label -> the il_instruction_c with that label (the first one, if repeated) */
+    typedef std::map<std::string, il_instruction_c *, nocasecmp_c> label_index_t;
+    static std::map<symbol_c *, label_index_t *> label_indexes;  /* key: the instruction_list_c */
+
+    symbol_c      *search_scope;
+    label_index_t *label_index;   /* of the instruction_list_c in the search_scope (NULL until first used) */
 
   public:
     search_il_label_c(symbol_c *search_scope);
@@ -62,6 +70,9 @@ class search_il_label_c: public search_visitor_c {
     il_instruction_c *find_label(const char *label);
     il_instruction_c *find_label(symbol_c   *label);
 
+    /* Forget the index of every instruction list. Must be called before working on a new AST. */
+    static void clear_index(void);
+
     
     /****************************************/
     /* B.2 - Language IL (Instruction List) */
@@ -69,8 +80,8 @@ class search_il_label_c: public search_visitor_c {
     /***********************************/
     /* B 2.1 Instructions and Operands */
     /***********************************/
-//     void *visit(instruction_list_c *symbol);
-    void *visit(il_instruction_c *symbol);
+    void *visit(instruction_list_c *symbol);
+//     void *visit(il_instruction_c *symbol);
 //     void *visit(il_simple_operation_c *symbol);
 //     void *visit(il_function_call_c *symbol);
 //     void *visit(il_expression_c *symbol);
@@ -88,25 +88,120 @@
 
 
 #include "absyntax_utils.hh"
+#include "../absyntax/intern_pool.hh"
 
 
 
 
 
+std::map<symbol_c *, search_var_instance_decl_c::scope_index_t *> search_var_instance_decl_c::scope_indexes;
+
+
+void search_var_instance_decl_c::clear_index(void) {
+  std::map<symbol_c *, scope_index_t *>::iterator i;
+  for (i = scope_indexes.begin(); i != scope_indexes.end(); i++)
+    delete i->second;
+  scope_indexes.clear();
+}
+
+
 search_var_instance_decl_c::search_var_instance_decl_c(symbol_c *search_scope) {
   this->current_vartype = none_vt;
   this->search_scope = search_scope;
   this->search_name = NULL;
   this->current_type_decl = NULL;
   this->current_option = none_opt;
+  this->building_index = NULL;
 }
 
-symbol_c *search_var_instance_decl_c::get_decl(symbol_c *variable) {
+
+/* The key used to store a variable name in the index. Returns NULL if the name is not an identifier. */
+static const char *index_key(symbol_c *variable_name) {
+  token_c *token = dynamic_cast<token_c *>(variable_name);
+  if ((NULL == token) || (NULL == token->value)) return NULL;
+  /* NOTE: identifiers created after parsing (e.g. by stage 4) may not have been interned by flex */
+  return interned_folded(intern_string(token->value));
+}
+
+
+/* Called for every variable name found in the scope, along with the declaration the search would return
+ * if that is the variable being searched for.
+ * When searching, returns true if it is the variable being searched for.
+ * When building the index, adds the variable to the index and returns false, so the whole scope gets visited.
+ */
+bool search_var_instance_decl_c::found(symbol_c *variable_name, symbol_c *decl) {
+  if (NULL == building_index)
+    return (compare_identifiers(variable_name, search_name) == 0);
+
+  /* The search continues when the declaration it found is NULL, and returns the first match, so... */
+  const char *key = index_key(variable_name);
+  if ((NULL != key) && (NULL != decl) && (building_index->find(key) == building_index->end())) {
+    index_entry_t entry = {decl, current_vartype, current_option};
+    (*building_index)[key] = entry;
+  }
+  return false;
+}
+
+
+/* Only the scopes that live in the AST for as long as the AST itself are indexed. Any other
+ * scope (e.g. a temporary list of variable declarations) is searched every time.
+ */
+static bool is_indexed_scope(symbol_c *scope) {
+  return (   (NULL != dynamic_cast<function_declaration_c       *>(scope))
+          || (NULL != dynamic_cast<function_block_declaration_c *>(scope))
+          || (NULL != dynamic_cast<program_declaration_c        *>(scope))
+          || (NULL != dynamic_cast<configuration_declaration_c  *>(scope))
+          || (NULL != dynamic_cast<resource_declaration_c       *>(scope)));
+}
+
+
+/* Returns the index entry of the variable, or NULL if it is not declared in the scope. */
+const search_var_instance_decl_c::index_entry_t *search_var_instance_decl_c::index_lookup(symbol_c *variable_name) {
+  scope_index_t *index = NULL;
+  std::map<symbol_c *, scope_index_t *>::iterator i = scope_indexes.find(search_scope);
+  if (i != scope_indexes.end())
+    index = i->second;
+  else {
+    index = new scope_index_t;
+    building_index = index;
+    search_scope->accept(*this);
+    building_index = NULL;
+    scope_indexes[search_scope] = index;
+  }
+
+  const char *key = index_key(variable_name);
+  if (NULL == key) return NULL;
+  scope_index_t::iterator entry = index->find(key);
+  if (entry == index->end()) return NULL;
+  return &(entry->second);
+}
+
+
+/* Search for the variable, leaving the result in current_vartype and current_option (and in *decl) */
+void search_var_instance_decl_c::search(symbol_c *variable, symbol_c **decl) {
   this->current_vartype = none_vt;
   this->current_option  = none_opt;
   this->search_name = get_var_name_c::get_name(variable);
+  *decl = NULL;
+
+  if (!is_indexed_scope(search_scope)) {
+    *decl = (symbol_c *)search_scope->accept(*this);
+    return;
+  }
+
+  const index_entry_t *entry = index_lookup(search_name);
+  if (NULL == entry) return;
+  *decl           = entry->decl;
+  current_vartype = entry->vartype;
+  current_option  = entry->option;
+}
+
+
+symbol_c *search_var_instance_decl_c::get_decl(symbol_c *variable) {
+  symbol_c *decl;
   if (NULL == search_scope) return NULL; // NOTE: This is not an ERROR! declaration_check_c, for e.g., relies on this returning NULL!
-  return (symbol_c *)search_scope->accept(*this);
+  search(variable, &decl);
+  return decl;
 }
 
 symbol_c *search_var_instance_decl_c::get_basetype_decl(symbol_c *variable) {
@@ -114,20 +209,16 @@ symbol_c *search_var_instance_decl_c::get_basetype_decl(symbol_c *variable) {
 }
 
 search_var_instance_decl_c::vt_t search_var_instance_decl_c::get_vartype(symbol_c *variable) {
-  this->current_vartype = none_vt;
-  this->current_option  = none_opt;
-  this->search_name = get_var_name_c::get_name(variable);
+  symbol_c *decl;
   if (NULL == search_scope) ERROR;
-  search_scope->accept(*this);
+  search(variable, &decl);
   return this->current_vartype;
 }
 
 search_var_instance_decl_c::opt_t search_var_instance_decl_c::get_option(symbol_c *variable) {
-  this->current_vartype = none_vt;
-  this->current_option  = none_opt;
-  this->search_name = get_var_name_c::get_name(variable);
+  symbol_c *decl;
   if (NULL == search_scope) ERROR;
-  search_scope->accept(*this);
+  search(variable, &decl);
   return this->current_option;
 }
 
@@ -209,14 +300,14 @@ void *search_var_instance_decl_c::visit(input_output_declarations_c *symbol) {
 
 /* ENO : BOOL */
 void *search_var_instance_decl_c::visit(eno_param_declaration_c *symbol) {
-  if (compare_identifiers(symbol->name, search_name) == 0)
+  if (found(symbol->name, symbol->type))
     return symbol->type;
   return NULL;
 }
 
 /* EN : BOOL */
 void *search_var_instance_decl_c::visit(en_param_declaration_c *symbol) {
-  if (compare_identifiers(symbol->name, search_name) == 0)
+  if (found(symbol->name, symbol->type_decl))
     return symbol->type_decl;
   return NULL;
 }
@@ -313,7 +404,7 @@ void *search_var_instance_decl_c::visit(var1_init_decl_c *symbol) {
 void *search_var_instance_decl_c::visit(var1_list_c *symbol) {
   list_c *list = symbol;
   for(int i = 0; i < list->n; i++) {
-    if (compare_identifiers(list->get_element(i), search_name) == 0)
+    if (found(list->get_element(i), current_type_decl))
    /* by now, current_type_decl should be != NULL */
       return current_type_decl;
   }
@@ -335,7 +426,7 @@ void *search_var_instance_decl_c::visit(fb_name_decl_c *symbol) {
 void *search_var_instance_decl_c::visit(fb_name_list_c *symbol) {
   list_c *list = symbol;
   for(int i = 0; i < list->n; i++) {
-    if (compare_identifiers(list->get_element(i), search_name) == 0)
+    if (found(list->get_element(i), current_type_decl))
     /* by now, current_fb_declaration should be != NULL */
       return current_type_decl;
   }
@@ -378,7 +469,7 @@ void *search_var_instance_decl_c::visit(structured_var_declaration_c *symbol) {
 /*  global_var_name ':' (simple_specification|subrange_specification|enumerated_specification|array_specification|prev_declared_structure_type_name|function_block_type_name */
 // SYM_REF2(external_declaration_c, global_var_name, specification)
 void *search_var_instance_decl_c::visit(external_declaration_c *symbol) {
-  if (compare_identifiers(symbol->global_var_name, search_name) == 0)
+  if (found(symbol->global_var_name, symbol->specification))
       return symbol->specification;
   return NULL;
 }
@@ -398,7 +489,7 @@ void *search_var_instance_decl_c::visit(global_var_decl_c *symbol) {
 /*| global_var_name location */
 //SYM_REF2(global_var_spec_c, global_var_name, location)
 void *search_var_instance_decl_c::visit(global_var_spec_c *symbol) {
-  if (symbol->global_var_name != NULL && compare_identifiers(symbol->global_var_name, search_name) == 0)
+  if (symbol->global_var_name != NULL && found(symbol->global_var_name, current_type_decl))
       return current_type_decl;
   else
     return symbol->location->accept(*this);
@@ -409,7 +500,7 @@ void *search_var_instance_decl_c::visit(global_var_spec_c *symbol) {
 void *search_var_instance_decl_c::visit(global_var_list_c *symbol) {
   list_c *list = symbol;
   for(int i = 0; i < list->n; i++) {
-    if (compare_identifiers(list->get_element(i), search_name) == 0)
+    if (found(list->get_element(i), current_type_decl))
       /* by now, current_type_decl should be != NULL */
       return current_type_decl;
   }
@@ -420,7 +511,7 @@ void *search_var_instance_decl_c::visit(global_var_list_c *symbol) {
 /* variable_name -> may be NULL ! */
 //SYM_REF4(located_var_decl_c, variable_name, location, located_var_spec_init, unused)
 void *search_var_instance_decl_c::visit(located_var_decl_c *symbol) {
-  if (symbol->variable_name != NULL && compare_identifiers(symbol->variable_name, search_name) == 0)
+  if (symbol->variable_name != NULL && found(symbol->variable_name, symbol->located_var_spec_init))
     return symbol->located_var_spec_init;
   else {
     current_type_decl = symbol->located_var_spec_init;
@@ -436,7 +527,7 @@ void *search_var_instance_decl_c::visit(located_var_decl_c *symbol) {
 /*  AT direct_variable */
 // SYM_REF2(location_c, direct_variable, unused)
 void *search_var_instance_decl_c::visit(location_c *symbol) {
-  if (compare_identifiers(symbol->direct_variable, search_name) == 0)
+  if (found(symbol->direct_variable, current_type_decl))
     return current_type_decl;
   else
     return NULL;
@@ -492,7 +583,7 @@ void *search_var_instance_decl_c::visit(function_declaration_c *symbol) {
   /* functions have a variable named after themselves, to store
    * the variable that will be returned!!
    */
-  if (compare_identifiers(symbol->derived_function_name, search_name) == 0)
+  if (found(symbol->derived_function_name, symbol->type_name))
       return symbol->type_name;
 
   /* no need to search through all the body, so we only
@@ -549,7 +640,7 @@ void *search_var_instance_decl_c::visit(program_declaration_c *symbol) {
 /* INITIAL_STEP step_name ':' action_association_list END_STEP */
 // SYM_REF2(initial_step_c, step_name, action_association_list)
 void *search_var_instance_decl_c::visit(initial_step_c *symbol) {
-  if (compare_identifiers(symbol->step_name, search_name) == 0)
+  if (found(symbol->step_name, symbol))
       return symbol;
   return NULL;
 }
@@ -557,7 +648,7 @@ void *search_var_instance_decl_c::visit(initial_step_c *symbol) {
 /* STEP step_name ':' action_association_list END_STEP */
 // SYM_REF2(step_c, step_name, action_association_list)
 void *search_var_instance_decl_c::visit(step_c *symbol) {
-  if (compare_identifiers(symbol->step_name, search_name) == 0)
+  if (found(symbol->step_name, symbol))
       return symbol;
   return NULL;
 }
@@ -88,6 +88,8 @@
  */
 
 
+#include <map>
+
 class search_var_instance_decl_c: public search_visitor_c {
 
   public:
@@ -135,6 +137,9 @@ class search_var_instance_decl_c: public search_visitor_c {
     vt_t      get_vartype       (symbol_c *variable_instance_name);
     opt_t     get_option        (symbol_c *variable_instance_name);
 
+    /* Forget the index of every scope (see below). Must be called before working on a new AST. */
+    static void clear_index(void);
+
   private:
     symbol_c *search_scope;
     symbol_c *search_name;
@@ -144,6 +149,27 @@ class search_var_instance_decl_c: public search_visitor_c {
     vt_t  current_vartype;
     opt_t current_option;
 
+    /* The variables declared in a POU, configuration or resource are indexed the first time that scope is searched,
+     * and the index is shared by all the instances of this class that search the same scope. This avoids walking
+     * through all the variable declarations of the POU on every search (i.e. quadratic time for POUs with many variables).
+     *
+     * The index is built by visiting the scope with this same class, but with found() recording every variable name
+     * it is asked to compare, instead of comparing it with search_name. The index therefore returns exactly what
+     * the search would have returned.
+     */
+    typedef struct {
+      symbol_c *decl;
+      vt_t      vartype;
+      opt_t     option;
+    } index_entry_t;
+    typedef std::map<const char *, index_entry_t> scope_index_t;   /* key: the case folded (interned) variable name */
+    static std::map<symbol_c *, scope_index_t *> scope_indexes;
+    scope_index_t *building_index;  /* index currently being built, NULL when searching */
+
+    bool                 found       (symbol_c *variable_name, symbol_c *decl);
+    const index_entry_t *index_lookup(symbol_c *variable_name);
+    void                 search      (symbol_c *variable_instance_name, symbol_c **decl);
+
     
   private:
     /***************************/
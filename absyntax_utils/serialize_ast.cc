@@ -0,0 +1,549 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+/*
+ * Write and read back an Abstract Syntax Tree to/from a compact binary stream.
+ *
+ * Stream format
+ * -------------
+ * All integers are written as variable length unsigned integers (7 bits per byte, least
+ * significant group first, msb set on all bytes except the last). Signed integers are
+ * first zig-zag encoded, so small negative numbers also take up little space.
+ *
+ * A string is written as its index into the table of strings already written.
+ * The first time a string is written, its index will be equal to the number of strings
+ * previously written, and the index is immediately followed by the string's length and
+ * characters. A NULL string is written as index 0, so all real indexes are offset by one.
+ *
+ * A symbol is written as:
+ *   null_symbol_id                                                   --> a NULL pointer
+ *   shared_symbol_id <symbol index>                                  --> a symbol already written
+ *   <class id> <location> <contents>                                 --> a new symbol
+ * where <contents> is
+ *   <value string>                                                   --> for tokens
+ *   <element count> <element symbol>* <token symbol>                 --> for lists
+ *   <ref1 symbol> ... <refN symbol>   <token symbol>                 --> for all other symbols
+ *
+ * Symbol indexes are assigned in post-order, i.e. when the symbol has been completely
+ * written (or read) with the exception of the reference to its token (which is
+ * written/read after the index has been assigned).
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include "serialize_ast.hh"
+#include "../absyntax/visitor.hh"
+#include "../main.hh" // required for ERROR() and ERROR_MSG() macros.
+
+
+
+/* An entry for each class declared in absyntax.def */
+#define SYM_LIST(class_name_c, ...)                                      class_name_c##_id,
+#define SYM_TOKEN(class_name_c, ...)                                     class_name_c##_id,
+#define SYM_REF0(class_name_c, ...)                                      class_name_c##_id,
+#define SYM_REF1(class_name_c, ref1, ...)                                class_name_c##_id,
+#define SYM_REF2(class_name_c, ref1, ref2, ...)                          class_name_c##_id,
+#define SYM_REF3(class_name_c, ref1, ref2, ref3, ...)                    class_name_c##_id,
+#define SYM_REF4(class_name_c, ref1, ref2, ref3, ref4, ...)              class_name_c##_id,
+#define SYM_REF5(class_name_c, ref1, ref2, ref3, ref4, ref5, ...)        class_name_c##_id,
+#define SYM_REF6(class_name_c, ref1, ref2, ref3, ref4, ref5, ref6, ...)  class_name_c##_id,
+
+typedef enum {
+  null_symbol_id = 0,
+  shared_symbol_id,
+  #include "../absyntax/absyntax.def"
+  last_symbol_id
+} symbol_class_id_t;
+
+#undef SYM_LIST
+#undef SYM_TOKEN
+#undef SYM_REF0
+#undef SYM_REF1
+#undef SYM_REF2
+#undef SYM_REF3
+#undef SYM_REF4
+#undef SYM_REF5
+#undef SYM_REF6
+
+
+/* The name of each class declared in absyntax.def, in the same order as the above enum. Used to calculate the schema signature. */
+#define SYM_LIST(class_name_c, ...)                                      #class_name_c,
+#define SYM_TOKEN(class_name_c, ...)                                     #class_name_c,
+#define SYM_REF0(class_name_c, ...)                                      #class_name_c,
+#define SYM_REF1(class_name_c, ref1, ...)                                #class_name_c ":" #ref1,
+#define SYM_REF2(class_name_c, ref1, ref2, ...)                          #class_name_c ":" #ref1 #ref2,
+#define SYM_REF3(class_name_c, ref1, ref2, ref3, ...)                    #class_name_c ":" #ref1 #ref2 #ref3,
+#define SYM_REF4(class_name_c, ref1, ref2, ref3, ref4, ...)              #class_name_c ":" #ref1 #ref2 #ref3 #ref4,
+#define SYM_REF5(class_name_c, ref1, ref2, ref3, ref4, ref5, ...)        #class_name_c ":" #ref1 #ref2 #ref3 #ref4 #ref5,
+#define SYM_REF6(class_name_c, ref1, ref2, ref3, ref4, ref5, ref6, ...)  #class_name_c ":" #ref1 #ref2 #ref3 #ref4 #ref5 #ref6,
+
+static const char *symbol_class_names[] = {
+  #include "../absyntax/absyntax.def"
+  NULL /* end of array marker! Do not remove! */
+};
+
+#undef SYM_LIST
+#undef SYM_TOKEN
+#undef SYM_REF0
+#undef SYM_REF1
+#undef SYM_REF2
+#undef SYM_REF3
+#undef SYM_REF4
+#undef SYM_REF5
+#undef SYM_REF6
+
+
+
+
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+
+/* The visitor that writes out each class of symbol. */
+#define SYM_LIST(class_name_c, ...)							\
+    void *visit(class_name_c *symbol) {							\
+      s.write_header(class_name_c##_id, symbol);					\
+      s.write_uint(symbol->n);								\
+      for (int i = 0; i < symbol->n; i++) s.write_symbol(symbol->get_element(i));	\
+      return write_footer(symbol);							\
+    }
+
+#define SYM_TOKEN(class_name_c, ...)							\
+    void *visit(class_name_c *symbol) {							\
+      s.write_header(class_name_c##_id, symbol);					\
+      s.write_string(symbol->value);							\
+      s.register_symbol(symbol);							\
+      return NULL;									\
+    }
+
+#define SYM_REF0(class_name_c, ...)							\
+    void *visit(class_name_c *symbol) {							\
+      s.write_header(class_name_c##_id, symbol);					\
+      return write_footer(symbol);							\
+    }
+
+#define SYM_REF1(class_name_c, ref1, ...)						\
+    void *visit(class_name_c *symbol) {							\
+      s.write_header(class_name_c##_id, symbol);					\
+      s.write_symbol(symbol->ref1);							\
+      return write_footer(symbol);							\
+    }
+
+#define SYM_REF2(class_name_c, ref1, ref2, ...)						\
+    void *visit(class_name_c *symbol) {							\
+      s.write_header(class_name_c##_id, symbol);					\
+      s.write_symbol(symbol->ref1);							\
+      s.write_symbol(symbol->ref2);							\
+      return write_footer(symbol);							\
+    }
+
+#define SYM_REF3(class_name_c, ref1, ref2, ref3, ...)					\
+    void *visit(class_name_c *symbol) {							\
+      s.write_header(class_name_c##_id, symbol);					\
+      s.write_symbol(symbol->ref1);							\
+      s.write_symbol(symbol->ref2);							\
+      s.write_symbol(symbol->ref3);							\
+      return write_footer(symbol);							\
+    }
+
+#define SYM_REF4(class_name_c, ref1, ref2, ref3, ref4, ...)				\
+    void *visit(class_name_c *symbol) {							\
+      s.write_header(class_name_c##_id, symbol);					\
+      s.write_symbol(symbol->ref1);							\
+      s.write_symbol(symbol->ref2);							\
+      s.write_symbol(symbol->ref3);							\
+      s.write_symbol(symbol->ref4);							\
+      return write_footer(symbol);							\
+    }
+
+#define SYM_REF5(class_name_c, ref1, ref2, ref3, ref4, ref5, ...)			\
+    void *visit(class_name_c *symbol) {							\
+      s.write_header(class_name_c##_id, symbol);					\
+      s.write_symbol(symbol->ref1);							\
+      s.write_symbol(symbol->ref2);							\
+      s.write_symbol(symbol->ref3);							\
+      s.write_symbol(symbol->ref4);							\
+      s.write_symbol(symbol->ref5);							\
+      return write_footer(symbol);							\
+    }
+
+#define SYM_REF6(class_name_c, ref1, ref2, ref3, ref4, ref5, ref6, ...)			\
+    void *visit(class_name_c *symbol) {							\
+      s.write_header(class_name_c##_id, symbol);					\
+      s.write_symbol(symbol->ref1);							\
+      s.write_symbol(symbol->ref2);							\
+      s.write_symbol(symbol->ref3);							\
+      s.write_symbol(symbol->ref4);							\
+      s.write_symbol(symbol->ref5);							\
+      s.write_symbol(symbol->ref6);							\
+      return write_footer(symbol);							\
+    }
+
+
+class serialize_ast_visitor_c: public visitor_c {
+  private:
+    serialize_ast_c &s;
+
+    /* assign the index of the (non token) symbol, and then write the reference to its token */
+    void *write_footer(symbol_c *symbol) {
+      s.register_symbol(symbol);
+      s.write_symbol(symbol->token);
+      return NULL;
+    }
+
+  public:
+    serialize_ast_visitor_c(serialize_ast_c &s_): s(s_) {}
+    virtual ~serialize_ast_visitor_c(void) {}
+
+  #include "../absyntax/absyntax.def"
+};
+
+#undef SYM_LIST
+#undef SYM_TOKEN
+#undef SYM_REF0
+#undef SYM_REF1
+#undef SYM_REF2
+#undef SYM_REF3
+#undef SYM_REF4
+#undef SYM_REF5
+#undef SYM_REF6
+
+
+
+serialize_ast_c::serialize_ast_c(FILE *out) {
+  this->out     = out;
+  this->error   = (NULL == out);
+  this->visitor = new serialize_ast_visitor_c(*this);
+}
+
+
+serialize_ast_c::~serialize_ast_c(void) {
+  delete visitor;
+}
+
+
+bool serialize_ast_c::failed(void) {return error;}
+
+
+void serialize_ast_c::write_uint(uint64_t value) {
+  if (error) return;
+  do {
+    int byte = value & 0x7F;
+    value >>= 7;
+    if (value != 0) byte |= 0x80;
+    if (putc(byte, out) == EOF) {error = true; return;}
+  } while (value != 0);
+}
+
+
+void serialize_ast_c::write_int(int64_t value) {
+  write_uint((((uint64_t)value) << 1) ^ (uint64_t)(value >> 63));  /* zig-zag encoding */
+}
+
+
+void serialize_ast_c::write_string(const char *str) {
+  if (NULL == str) {write_uint(0); return;}
+
+  std::map<std::string, uint64_t>::iterator i = string_ids.find(str);
+  if (i != string_ids.end()) {write_uint(i->second + 1); return;}
+
+  uint64_t id  = string_ids.size();
+  size_t   len = strlen(str);
+  string_ids[str] = id;
+  write_uint(id + 1);
+  write_uint(len);
+  if (!error && (fwrite(str, 1, len, out) != len)) error = true;
+}
+
+
+void serialize_ast_c::write_header(int class_id, symbol_c *symbol) {
+  write_uint  (class_id);
+  write_int   (symbol->first_line);
+  write_int   (symbol->first_column);
+  write_string(symbol->first_file);
+  write_int   (symbol->first_order);
+  write_int   (symbol->last_line);
+  write_int   (symbol->last_column);
+  write_string(symbol->last_file);
+  write_int   (symbol->last_order);
+}
+
+
+void serialize_ast_c::register_symbol(symbol_c *symbol) {
+  uint64_t id = symbol_ids.size();
+  symbol_ids[symbol] = id;
+}
+
+
+void serialize_ast_c::write_symbol(symbol_c *symbol) {
+  if (NULL == symbol) {write_uint(null_symbol_id); return;}
+
+  std::map<const symbol_c *, uint64_t>::iterator i = symbol_ids.find(symbol);
+  if (i != symbol_ids.end()) {
+    write_uint(shared_symbol_id);
+    write_uint(i->second);
+    return;
+  }
+  symbol->accept(*visitor);
+}
+
+
+/* A FNV-1a hash of the names of all classes declared in absyntax.def (and of their references). */
+uint32_t serialize_ast_c::schema_signature(void) {
+  uint32_t hash = 2166136261u;
+  for (int i = 0; symbol_class_names[i] != NULL; i++)
+    for (const char *c = symbol_class_names[i]; ; c++) {
+      hash = (hash ^ (unsigned char)*c) * 16777619u;
+      if (*c == '\0') break;
+    }
+  return hash;
+}
+
+
+
+
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+
+deserialize_ast_c::deserialize_ast_c(FILE *in) {
+  buffer = NULL;
+  size   = 0;
+  pos    = 0;
+  error  = (NULL == in);
+
+  /* read the whole stream into memory... */
+  size_t capacity = 0, res;
+  while (!error) {
+    if (size == capacity) {
+      capacity = (capacity == 0)? 64*1024 : 2*capacity;
+      char *new_buffer = (char *)realloc(buffer, capacity);
+      if (NULL == new_buffer) {error = true; break;}
+      buffer = new_buffer;
+    }
+    res = fread(buffer + size, 1, capacity - size, in);
+    size += res;
+    if (res == 0) {
+      if (ferror(in)) error = true;
+      break;
+    }
+  }
+}
+
+
+deserialize_ast_c::~deserialize_ast_c(void) {
+  /* NOTE: the strings handed out by read_string() were copied, so we may free the buffer. */
+  free(buffer);
+}
+
+
+bool deserialize_ast_c::failed(void) {return error;}
+
+
+uint64_t deserialize_ast_c::read_uint(void) {
+  uint64_t value = 0;
+  for (int shift = 0; !error; shift += 7) {
+    if ((pos >= size) || (shift > 63)) {error = true; break;}
+    int byte = (unsigned char)buffer[pos++];
+    value |= ((uint64_t)(byte & 0x7F)) << shift;
+    if ((byte & 0x80) == 0) return value;
+  }
+  return 0;
+}
+
+
+int64_t deserialize_ast_c::read_int(void) {
+  uint64_t value = read_uint();
+  return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);  /* zig-zag decoding */
+}
+
+
+const char *deserialize_ast_c::read_string(void) {
+  uint64_t id = read_uint();
+  if (error || (id == 0)) return NULL;
+  id--;
+
+  if (id <  strings.size()) return strings[id];
+  if (id != strings.size()) {error = true; return NULL;}
+
+  uint64_t len = read_uint();
+  if (error || (len > size - pos)) {error = true; return NULL;}
+  char *str = (char *)malloc(len + 1);
+  if (NULL == str) ERROR_MSG("out of memory");
+  memcpy(str, buffer + pos, len);
+  str[len] = '\0';
+  pos += len;
+  strings.push_back(str);
+  return str;
+}
+
+
+
+#define SYM_LIST(class_name_c, ...)							\
+    case class_name_c##_id: {								\
+      list_c *list = new class_name_c();						\
+      uint64_t n = read_uint();								\
+      for (uint64_t i = 0; (i < n) && !error; i++) list->add_element(read_symbol());	\
+      symbol = list;									\
+      break;										\
+    }
+
+#define SYM_TOKEN(class_name_c, ...)							\
+    case class_name_c##_id: {								\
+      const char *value = read_string();						\
+      symbol = new class_name_c(value);							\
+      break;										\
+    }
+
+#define SYM_REF0(class_name_c, ...)							\
+    case class_name_c##_id: {								\
+      symbol = new class_name_c();							\
+      break;										\
+    }
+
+#define SYM_REF1(class_name_c, ref1, ...)						\
+    case class_name_c##_id: {								\
+      symbol_c *r1 = read_symbol();							\
+      symbol = new class_name_c(r1);							\
+      break;										\
+    }
+
+#define SYM_REF2(class_name_c, ref1, ref2, ...)						\
+    case class_name_c##_id: {								\
+      symbol_c *r1 = read_symbol();							\
+      symbol_c *r2 = read_symbol();							\
+      symbol = new class_name_c(r1, r2);						\
+      break;										\
+    }
+
+#define SYM_REF3(class_name_c, ref1, ref2, ref3, ...)					\
+    case class_name_c##_id: {								\
+      symbol_c *r1 = read_symbol();							\
+      symbol_c *r2 = read_symbol();							\
+      symbol_c *r3 = read_symbol();							\
+      symbol = new class_name_c(r1, r2, r3);						\
+      break;										\
+    }
+
+#define SYM_REF4(class_name_c, ref1, ref2, ref3, ref4, ...)				\
+    case class_name_c##_id: {								\
+      symbol_c *r1 = read_symbol();							\
+      symbol_c *r2 = read_symbol();							\
+      symbol_c *r3 = read_symbol();							\
+      symbol_c *r4 = read_symbol();							\
+      symbol = new class_name_c(r1, r2, r3, r4);					\
+      break;										\
+    }
+
+#define SYM_REF5(class_name_c, ref1, ref2, ref3, ref4, ref5, ...)			\
+    case class_name_c##_id: {								\
+      symbol_c *r1 = read_symbol();							\
+      symbol_c *r2 = read_symbol();							\
+      symbol_c *r3 = read_symbol();							\
+      symbol_c *r4 = read_symbol();							\
+      symbol_c *r5 = read_symbol();							\
+      symbol = new class_name_c(r1, r2, r3, r4, r5);					\
+      break;										\
+    }
+
+#define SYM_REF6(class_name_c, ref1, ref2, ref3, ref4, ref5, ref6, ...)			\
+    case class_name_c##_id: {								\
+      symbol_c *r1 = read_symbol();							\
+      symbol_c *r2 = read_symbol();							\
+      symbol_c *r3 = read_symbol();							\
+      symbol_c *r4 = read_symbol();							\
+      symbol_c *r5 = read_symbol();							\
+      symbol_c *r6 = read_symbol();							\
+      symbol = new class_name_c(r1, r2, r3, r4, r5, r6);				\
+      break;										\
+    }
+
+
+symbol_c *deserialize_ast_c::read_symbol(void) {
+  uint64_t class_id = read_uint();
+  if (error || (class_id == null_symbol_id)) return NULL;
+
+  if (class_id == shared_symbol_id) {
+    uint64_t id = read_uint();
+    if (error || (id >= symbols.size())) {error = true; return NULL;}
+    return symbols[id];
+  }
+
+  if (class_id >= last_symbol_id) {error = true; return NULL;}
+
+  /* location of the new symbol... */
+  int         fl     = read_int();
+  int         fc     = read_int();
+  const char *ffile  = read_string();
+  long int    forder = read_int();
+  int         ll     = read_int();
+  int         lc     = read_int();
+  const char *lfile  = read_string();
+  long int    lorder = read_int();
+  if (error) return NULL;
+
+  symbol_c *symbol = NULL;
+  switch (class_id) {
+    #include "../absyntax/absyntax.def"
+    default: error = true; return NULL;
+  }
+  if (error) return NULL;
+
+  /* NOTE: we set the location only after creating the symbol, as list_c::add_element() changes the location of the list */
+  symbol->first_line   = fl;
+  symbol->first_column = fc;
+  symbol->first_file   = ffile;
+  symbol->first_order  = forder;
+  symbol->last_line    = ll;
+  symbol->last_column  = lc;
+  symbol->last_file    = lfile;
+  symbol->last_order   = lorder;
+  symbols.push_back(symbol);
+
+  /* read the reference to the token, for all symbols that are not themselves a token... */
+  if (dynamic_cast<token_c *>(symbol) == NULL)
+    symbol->token = dynamic_cast<token_c *>(read_symbol());
+  return symbol;
+}
+
+#undef SYM_LIST
+#undef SYM_TOKEN
+#undef SYM_REF0
+#undef SYM_REF1
+#undef SYM_REF2
+#undef SYM_REF3
+#undef SYM_REF4
+#undef SYM_REF5
+#undef SYM_REF6
@@ -0,0 +1,125 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+/*
+ * Write (serialize_ast_c) and read back (deserialize_ast_c) an Abstract Syntax Tree
+ * to/from a compact binary stream.
+ *
+ * Only the annotations produced during stage 1_2 are stored, i.e.:
+ *   - the class of each symbol (one entry per class declared in absyntax.def)
+ *   - the location (line, column, file and order) of each symbol
+ *   - the value of each token_c
+ *   - the elements of each list_c (and their token_value)
+ *   - the references (ref1, ref2, ...) of each symbol
+ *   - the symbol_c->token reference
+ * Annotations produced by stage 3 and stage 4 (datatype, candidate_datatypes, const_value,
+ * annotation_table_c, ...) are NOT stored, so this should only be used on an AST that has
+ * just been produced by stage 1_2.
+ *
+ * Symbols referenced more than once (i.e. shared sub-trees) are only written once, and
+ * will also be shared once the AST is read back. The same is true for the strings used
+ * for token values and file names.
+ *
+ * Several ASTs (and any other strings or integers) may be written to the same stream, as
+ * long as they are later read back in exactly the same order!
+ *
+ * The stream format depends on the classes declared in absyntax.def. The value returned
+ * by serialize_ast_c::schema_signature() changes whenever that file changes, so it may be
+ * stored along with the serialized AST to detect stale streams.
+ */
+
+
+#ifndef _SERIALIZE_AST_HH
+#define _SERIALIZE_AST_HH
+
+#include <stdio.h>
+#include <map>
+#include <vector>
+#include <string>
+#include "../absyntax/absyntax.hh"
+
+
+class serialize_ast_visitor_c; // forward declaration
+
+class serialize_ast_c {
+  public:
+    serialize_ast_c(FILE *out);
+    ~serialize_ast_c(void);
+
+    void write_symbol(symbol_c *symbol);  /* symbol may be NULL */
+    void write_string(const char *str);   /* str may be NULL    */
+    void write_int   (int64_t value);
+
+    /* returns true if any error occured while writing to the stream */
+    bool failed(void);
+
+    static uint32_t schema_signature(void);
+
+  private:
+    friend class serialize_ast_visitor_c;
+    void write_uint  (uint64_t value);
+    void write_header(int class_id, symbol_c *symbol);
+    void register_symbol(symbol_c *symbol);
+
+    FILE *out;
+    bool  error;
+    serialize_ast_visitor_c            *visitor;
+    std::map<const symbol_c *, uint64_t> symbol_ids;
+    std::map<std::string,        uint64_t> string_ids;
+};
+
+
+class deserialize_ast_c {
+  public:
+    /* The whole stream is read into memory by the constructor. */
+    deserialize_ast_c(FILE *in);
+    ~deserialize_ast_c(void);
+
+    symbol_c   *read_symbol(void);  /* may return NULL, if a NULL symbol was written */
+    const char *read_string(void);  /* may return NULL, if a NULL string was written */
+    int64_t     read_int   (void);
+
+    /* returns true if the stream is truncated or corrupt. Anything read after an error must be discarded! */
+    bool failed(void);
+
+  private:
+    uint64_t read_uint(void);
+
+    char  *buffer;
+    size_t size, pos;
+    bool   error;
+    std::vector<symbol_c   *> symbols;
+    std::vector<const char *> strings;
+};
+
+
+#endif /* _SERIALIZE_AST_HH */
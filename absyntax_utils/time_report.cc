@@ -0,0 +1,126 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+
+/*
+ * Per phase timing and memory report (-t command line option).
+ */
+
+
+#include <stdio.h>
+#include <time.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <map>
+#include <vector>
+#include <string>
+#include <algorithm>
+
+#include "time_report.hh"
+#include "../absyntax/visitor.hh"
+#include "../main.hh"
+
+
+
+int time_report_c::depth = 0;
+
+
+static double wall_time(void) {   /* in seconds */
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+static double cpu_time(void) {    /* in seconds */
+  return (double)clock() / CLOCKS_PER_SEC;
+}
+
+static long peak_rss(void) {      /* in kB */
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) return -1;
+  return usage.ru_maxrss;  /* NOTE: on Linux this is already in kB */
+}
+
+
+
+time_report_c::time_report_c(const char *name) {
+  this->name    = name;
+  this->enabled = runtime_options.time_report;
+  if (!enabled) return;
+  wall_start = wall_time();
+  cpu_start  = cpu_time();
+  depth++;
+}
+
+
+time_report_c::~time_report_c(void) {
+  if (!enabled) return;
+  double wall = wall_time() - wall_start;
+  double cpu  = cpu_time()  - cpu_start;
+  depth--;
+  fprintf(stderr, "time report: %*s%-*s wall %9.3f ms   cpu %9.3f ms   peak rss %8ld kB\n",
+          2*depth, "", 36 - 2*depth, name, wall * 1000, cpu * 1000, peak_rss());
+}
+
+
+
+
+/* Count the AST nodes, grouped by their class */
+class count_ast_nodes_c: public fcall_iterator_visitor_c {
+  public:
+    std::map<std::string, unsigned long> count;
+    unsigned long total;
+
+    count_ast_nodes_c(void) {total = 0;}
+    void prefix_fcall(symbol_c *symbol) {count[symbol->absyntax_cname()]++; total++;}
+};
+
+
+static bool more_nodes(const std::pair<std::string, unsigned long> &a, const std::pair<std::string, unsigned long> &b) {
+  if (a.second != b.second) return a.second > b.second;
+  return a.first < b.first;
+}
+
+
+void time_report_c::print_ast_nodes(symbol_c *root_symbol) {
+  if (!runtime_options.time_report || (NULL == root_symbol)) return;
+
+  count_ast_nodes_c counter;
+  root_symbol->accept(counter);
+
+  std::vector<std::pair<std::string, unsigned long> > sorted(counter.count.begin(), counter.count.end());
+  std::sort(sorted.begin(), sorted.end(), more_nodes);
+
+  fprintf(stderr, "time report: %lu AST nodes\n", counter.total);
+  for (unsigned int i = 0; i < sorted.size(); i++)
+    fprintf(stderr, "time report:   %-48s %10lu\n", sorted[i].first.c_str(), sorted[i].second);
+}
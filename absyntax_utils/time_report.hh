@@ -0,0 +1,68 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+
+/*
+ * Per phase timing and memory report (-t command line option).
+ *
+ * Each phase of the compiler to be reported on is timed by declaring a time_report_c object
+ * in the scope containing the code of that phase. When the object goes out of scope the wall
+ * clock time, the CPU time, and the peak memory use (RSS) of the process are printed to stderr.
+ * Phases may be nested, in which case they are printed indented.
+ *
+ * When the -t command line option is not given, none of this does anything.
+ */
+
+
+#ifndef _TIME_REPORT_HH
+#define _TIME_REPORT_HH
+
+#include "../absyntax/absyntax.hh"
+
+
+class time_report_c {
+  private:
+    const char *name;
+    bool        enabled;
+    double      wall_start, cpu_start;
+    static int  depth;
+
+  public:
+    time_report_c(const char *name);
+    ~time_report_c(void);
+
+    /* print the number of AST nodes, of each class, found in the AST from this point downwards */
+    static void print_ast_nodes(symbol_c *root_symbol);
+};
+
+
+#endif /* _TIME_REPORT_HH */
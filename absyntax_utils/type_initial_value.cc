@@ -95,6 +95,24 @@ type_initial_value_c *type_initial_value_c::instance(void) {
   return _instance;
 }
 
+void type_initial_value_c::reset(void) {
+  delete _instance;
+  /* the constants are symbols, whose memory is only returned by symbol_c::release_arena() */
+  _instance    = NULL;
+  null_literal = NULL;
+  real_0       = NULL;
+  integer_0    = integer_1 = NULL;
+  bool_0       = NULL;
+  date_literal_0    = NULL;
+  daytime_literal_0 = NULL;
+  time_0       = NULL;
+  date_0       = NULL;
+  tod_0        = NULL;
+  dt_0         = NULL;
+  string_0     = NULL;
+  wstring_0    = NULL;
+}
+
 type_initial_value_c::type_initial_value_c(void) {}
 
 
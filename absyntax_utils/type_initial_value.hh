@@ -61,6 +61,8 @@ class type_initial_value_c : public null_visitor_c {
 
   public:
     static symbol_c *get(symbol_c *type);
+    /* forget the constants below, e.g. before the symbols are released (see symbol_c::release_arena()) */
+    static void reset(void);
 
   private:
     /* constants for the default values of elementary data types... */
@@ -0,0 +1,730 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+
+/*
+ * Write and read the cross-reference index of the source code (see xref_index.hh for the layout of the index).
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+#include "absyntax_utils.hh"
+#include "../main.hh" // required for ERROR() and ERROR_MSG() macros.
+
+#include "../config/config.h"
+#if defined(HAVE_MMAP) && defined(HAVE_SYS_MMAN_H)
+  #define MMAP_XREF_INDEX
+  #include <sys/mman.h>
+#endif
+
+
+
+/* compare two names (or scopes) the way the symbols are sorted in the index, the NULL scope first */
+static int xref_cmp(const char *s1, const char *s2) {
+  if (NULL == s1) return (NULL == s2)? 0 : -1;
+  if (NULL == s2) return 1;
+  return strcasecmp(s1, s2);
+}
+
+
+
+
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+
+/* Collect the symbols, and their sites, of the AST annotated by stage 3 */
+class xref_collector_c: public iterator_visitor_c {
+
+  public:
+    typedef struct {
+      uint32_t    kind;
+      const char *file;
+      int         line;
+      int         column;
+      const char *pou;
+    } site_t;
+
+    typedef struct {
+      const char         *name;
+      const char         *scope;
+      uint32_t            kind;
+      std::vector<site_t> sites;
+    } entry_t;
+
+    std::vector<entry_t> entries;
+
+  private:
+    std::map<std::string, size_t> entry_ids;  /* indexed by the kind, and the upper case name and scope */
+    search_var_instance_decl_c   *search_var_instance_decl;  /* NULL outside the POUs */
+    const char                   *current_pou;       /* the POU, resource or configuration being visited */
+    bool                          global_decls;      /* visiting the VAR_GLOBAL declarations */
+    symbol_c                     *instance_type;     /* the FB type of the variables being declared (NULL if not a FB) */
+    symbol_c                     *called_decl;       /* the POU called by the formal parameters being visited */
+
+    static std::string upper(const char *str) {
+      std::string res;
+      if (NULL != str)
+        for (const char *c = str; *c != '\0'; c++) res += toupper((unsigned char)*c);
+      return res;
+    }
+
+    /* add a site of the named symbol, at the location of the given symbol */
+    void add_site(const char *name, symbol_c *location, uint32_t symbol_kind, const char *scope, uint32_t site_kind) {
+      if ((NULL == name) || (NULL == location)) return;
+      std::string key = std::string(1, (char)('0' + symbol_kind)) + upper(name) + '\0' + upper(scope);
+      std::map<std::string, size_t>::iterator i = entry_ids.find(key);
+      if (i == entry_ids.end()) {
+        entry_t entry;
+        entry.name  = name;
+        entry.scope = scope;
+        entry.kind  = symbol_kind;
+        i = entry_ids.insert(std::make_pair(key, entries.size())).first;
+        entries.push_back(entry);
+      }
+      site_t site;
+      site.kind   = site_kind;
+      site.file   = location->first_file;
+      site.line   = location->first_line;
+      site.column = location->first_column;
+      site.pou    = current_pou;
+      entries[i->second].sites.push_back(site);
+    }
+
+    /* add a site of the symbol, at the location of its name */
+    void add_site(token_c *name, uint32_t symbol_kind, const char *scope, uint32_t site_kind) {
+      if (NULL != name) add_site(name->value, name, symbol_kind, scope, site_kind);
+    }
+
+    /* add a site of the declared FUNCTION, FUNCTION_BLOCK or PROGRAM, at the location of the given symbol */
+    void add_pou_site(symbol_c *pou_decl, symbol_c *location, uint32_t site_kind) {
+      function_declaration_c       *function       = dynamic_cast<function_declaration_c       *>(pou_decl);
+      function_block_declaration_c *function_block = dynamic_cast<function_block_declaration_c *>(pou_decl);
+      program_declaration_c        *program        = dynamic_cast<program_declaration_c        *>(pou_decl);
+      token_c *name = NULL;
+      uint32_t kind = xref_index_function;
+      if (NULL != function)       {name = dynamic_cast<token_c *>(function      ->derived_function_name); kind = xref_index_function;}
+      if (NULL != function_block) {name = dynamic_cast<token_c *>(function_block->fblock_name);           kind = xref_index_function_block;}
+      if (NULL != program)        {name = dynamic_cast<token_c *>(program       ->program_type_name);     kind = xref_index_program;}
+      if (NULL != name) add_site(name->value, location, kind, NULL, site_kind);
+    }
+
+    /* a site of a variable (a symbolic_variable_c, or the identifier_c naming a variable) */
+    void variable_site(symbol_c *variable, uint32_t site_kind) {
+      token_c *name = get_var_name_c::get_name(variable);
+      if (NULL == search_var_instance_decl) {add_site(name, xref_index_global, NULL, site_kind); return;}
+      switch (search_var_instance_decl->get_vartype(variable)) {
+        case search_var_instance_decl_c::external_vt:
+        case search_var_instance_decl_c::global_vt:
+          add_site(name, xref_index_global, NULL, site_kind);
+          return;
+        case search_var_instance_decl_c::none_vt:
+          return;
+        default:
+          add_site(name, xref_index_variable, current_pou, site_kind);
+          return;
+      }
+    }
+
+    /* the variable is accessed (as opposed to only read) */
+    void access(symbol_c *variable, uint32_t site_kind) {
+      if (NULL == variable) return;
+      array_variable_c       *array_variable       = dynamic_cast<array_variable_c       *>(variable);
+      structured_variable_c  *structured_variable  = dynamic_cast<structured_variable_c  *>(variable);
+      direct_variable_c      *direct_variable      = dynamic_cast<direct_variable_c      *>(variable);
+      global_var_reference_c *global_var_reference = dynamic_cast<global_var_reference_c *>(variable);
+
+      if (NULL != array_variable) {
+        /* the subscripts are read */
+        array_variable->subscript_list->accept(*this);
+        access(array_variable->subscripted_variable, site_kind);
+        return;
+      }
+      if (NULL != structured_variable) {access(structured_variable->record_variable, site_kind); return;}
+      if (NULL != direct_variable) {add_site(direct_variable, xref_index_located, NULL, site_kind); return;}
+      if (NULL != global_var_reference) {add_site(dynamic_cast<token_c *>(global_var_reference->global_var_name), xref_index_global, NULL, site_kind); return;}
+      if (   (NULL != dynamic_cast<symbolic_variable_c *>(variable))
+          || (NULL != dynamic_cast<identifier_c        *>(variable))) {variable_site(variable, site_kind); return;}
+      variable->accept(*this);  /* e.g. a dereferenced pointer, or an expression */
+    }
+
+    /* the value passed to a parameter of the called POU */
+    void pass(symbol_c *value, symbol_c *pou_decl, function_param_iterator_c::param_direction_t direction) {
+      if (NULL == value) return;
+      if (NULL == pou_decl) {value->accept(*this); return;}
+      switch (direction) {
+        case function_param_iterator_c::direction_out:   access(value, xref_index_write);     return;
+        case function_param_iterator_c::direction_inout: access(value, xref_index_readwrite); return;
+        default:                                         value->accept(*this);                return;
+      }
+    }
+
+    /* the direction of the named parameter of the called POU */
+    static function_param_iterator_c::param_direction_t direction(symbol_c *pou_decl, symbol_c *param_name) {
+      if ((NULL == pou_decl) || (NULL == param_name)) return function_param_iterator_c::direction_in;
+      function_param_iterator_c fp_iterator(pou_decl);
+      if (NULL == fp_iterator.search(param_name)) return function_param_iterator_c::direction_in;
+      return fp_iterator.param_direction();
+    }
+
+    /* the values of a non formal call, passed in the order of the parameters, after the first <skip> parameters */
+    void pass_nonformal(symbol_c *param_list, symbol_c *pou_decl, int skip) {
+      list_c *list = dynamic_cast<list_c *>(param_list);
+      if (NULL == list) {if (NULL != param_list) param_list->accept(*this); return;}
+      if (NULL == pou_decl) {list->accept(*this); return;}
+
+      function_param_iterator_c fp_iterator(pou_decl);
+      function_param_iterator_c::param_direction_t param_direction = function_param_iterator_c::direction_in;
+      bool more = true;  /* the extensible parameters (of the standard functions) are all inputs */
+      for (int i = -skip; i < list->n; i++) {
+        if (more) {
+          identifier_c *param_name;
+          /* no value may be passed to an implicit EN or ENO in a non formal call */
+          do param_name = fp_iterator.next(); while ((NULL != param_name) && fp_iterator.is_en_eno_param_implicit());
+          more = (NULL != param_name) && !fp_iterator.is_extensible_param();
+          param_direction = more? fp_iterator.param_direction() : function_param_iterator_c::direction_in;
+        }
+        if (i >= 0) pass(list->get_element(i), pou_decl, param_direction);
+      }
+    }
+
+    void visit_formal(symbol_c *param_list, symbol_c *pou_decl) {
+      if (NULL == param_list) return;
+      symbol_c *prev_called_decl = called_decl;
+      called_decl = pou_decl;
+      param_list->accept(*this);
+      called_decl = prev_called_decl;
+    }
+
+    /* the declaration of a variable, or of a FB or PROGRAM instance */
+    void declare(symbol_c *symbol, uint32_t symbol_kind) {
+      token_c *name = dynamic_cast<token_c *>(symbol);
+      add_site(name, symbol_kind, (xref_index_variable == symbol_kind)? current_pou : NULL, xref_index_declaration);
+      token_c *type_name = dynamic_cast<token_c *>(instance_type);
+      if ((NULL != name) && (NULL != type_name))
+        add_site(type_name->value, name, xref_index_function_block, NULL, xref_index_instance);
+    }
+
+    void declare_list(list_c *list) {
+      for (int i = 0; i < list->n; i++)
+        declare(list->get_element(i), global_decls? xref_index_global : xref_index_variable);
+    }
+
+    void visit_pou(symbol_c *pou_decl, symbol_c *name, symbol_c *var_declarations, symbol_c *body) {
+      token_c *pou_name = dynamic_cast<token_c *>(name);
+      add_pou_site(pou_decl, pou_name, xref_index_declaration);
+      current_pou = (NULL == pou_name)? NULL : pou_name->value;
+      search_var_instance_decl = new search_var_instance_decl_c(pou_decl);
+      if (NULL != var_declarations) var_declarations->accept(*this);
+      if (NULL != body)             body->accept(*this);
+      delete search_var_instance_decl;
+      search_var_instance_decl = NULL;
+      current_pou = NULL;
+    }
+
+  public:
+    xref_collector_c(symbol_c *tree_root) {
+      search_var_instance_decl = NULL;
+      current_pou   = NULL;
+      global_decls  = false;
+      instance_type = NULL;
+      called_decl   = NULL;
+      if (NULL != tree_root) tree_root->accept(*this);
+    }
+
+    virtual ~xref_collector_c(void) {delete search_var_instance_decl;}
+
+    /**********************/
+    /* B 1.3 - Data types */
+    /**********************/
+    void *visit(data_type_declaration_c *symbol) {return NULL;}
+
+    /*********************/
+    /* B 1.4 - Variables */
+    /*********************/
+    /* any variable that is read */
+    void *visit(symbolic_variable_c *symbol) {variable_site(symbol, xref_index_read); return NULL;}
+    void *visit(direct_variable_c   *symbol) {add_site(symbol, xref_index_located, NULL, xref_index_read); return NULL;}
+
+    /******************************************/
+    /* B 1.4.3 - Declaration & Initialisation */
+    /******************************************/
+    void *visit(var1_list_c       *symbol) {declare_list(symbol); return NULL;}
+    void *visit(global_var_list_c *symbol) {declare_list(symbol); return NULL;}
+
+    void *visit(fb_name_decl_c *symbol) {
+      fb_spec_init_c *fb_spec_init = dynamic_cast<fb_spec_init_c *>(symbol->fb_spec_init);
+      instance_type = (NULL == fb_spec_init)? NULL : fb_spec_init->function_block_type_name;
+      symbol->fb_name_list->accept(*this);
+      instance_type = NULL;
+      return NULL;
+    }
+    void *visit(fb_name_list_c *symbol) {declare_list(symbol); return NULL;}
+
+    void *visit(located_var_decl_c *symbol) {
+      if (NULL != symbol->variable_name) declare(symbol->variable_name, xref_index_variable);
+      location_c *location = dynamic_cast<location_c *>(symbol->location);
+      if (NULL != location) add_site(dynamic_cast<token_c *>(location->direct_variable), xref_index_located, NULL, xref_index_declaration);
+      return NULL;
+    }
+
+    void *visit(external_declaration_c *symbol) {
+      add_site(dynamic_cast<token_c *>(symbol->global_var_name), xref_index_global, NULL, xref_index_external);
+      return NULL;
+    }
+
+    void *visit(global_var_declarations_c *symbol) {
+      global_decls = true;
+      symbol->global_var_decl_list->accept(*this);
+      global_decls = false;
+      return NULL;
+    }
+
+    void *visit(global_var_decl_c *symbol) {
+      fb_spec_init_c *fb_spec_init = dynamic_cast<fb_spec_init_c *>(symbol->type_specification);
+      instance_type = (NULL == fb_spec_init)? NULL : fb_spec_init->function_block_type_name;
+      symbol->global_var_spec->accept(*this);
+      instance_type = NULL;
+      return NULL;
+    }
+
+    void *visit(global_var_spec_c *symbol) {
+      if (NULL != symbol->global_var_name) declare(symbol->global_var_name, xref_index_global);
+      location_c *location = dynamic_cast<location_c *>(symbol->location);
+      if (NULL != location) add_site(dynamic_cast<token_c *>(location->direct_variable), xref_index_located, NULL, xref_index_declaration);
+      return NULL;
+    }
+
+    /**************************************/
+    /* B.1.5 - Program organization units */
+    /**************************************/
+    void *visit(function_declaration_c       *symbol) {visit_pou(symbol, symbol->derived_function_name, symbol->var_declarations_list, symbol->function_body);       return NULL;}
+    void *visit(function_block_declaration_c *symbol) {visit_pou(symbol, symbol->fblock_name,           symbol->var_declarations,      symbol->fblock_body);         return NULL;}
+    void *visit(program_declaration_c        *symbol) {visit_pou(symbol, symbol->program_type_name,     symbol->var_declarations,      symbol->function_block_body); return NULL;}
+
+    /********************************/
+    /* B 1.7 Configuration elements */
+    /********************************/
+    void *visit(configuration_declaration_c *symbol) {
+      token_c *name = dynamic_cast<token_c *>(symbol->configuration_name);
+      current_pou = (NULL == name)? NULL : name->value;
+      if (NULL != symbol->global_var_declarations) symbol->global_var_declarations->accept(*this);
+      if (NULL != symbol->resource_declarations)   symbol->resource_declarations  ->accept(*this);
+      current_pou = NULL;
+      return NULL;
+    }
+
+    void *visit(resource_declaration_c *symbol) {
+      const char *configuration = current_pou;
+      token_c *name = dynamic_cast<token_c *>(symbol->resource_name);
+      current_pou = (NULL == name)? NULL : name->value;
+      if (NULL != symbol->global_var_declarations) symbol->global_var_declarations->accept(*this);
+      if (NULL != symbol->resource_declaration)    symbol->resource_declaration   ->accept(*this);
+      current_pou = configuration;
+      return NULL;
+    }
+
+    void *visit(task_configuration_c *symbol) {return NULL;}
+
+    void *visit(program_configuration_c *symbol) {
+      add_site(dynamic_cast<token_c *>(symbol->program_name), xref_index_program_instance, current_pou, xref_index_declaration);
+      token_c *type_name = dynamic_cast<token_c *>(symbol->program_type_name);
+      if (NULL != type_name) add_site(type_name->value, symbol->program_name, xref_index_program, NULL, xref_index_instance);
+      if (NULL != symbol->prog_conf_elements) symbol->prog_conf_elements->accept(*this);
+      return NULL;
+    }
+
+    /* the symbolic_variable is a parameter of the PROGRAM */
+    void *visit(prog_cnxn_assign_c *symbol) {
+      if (NULL != symbol->prog_data_source) symbol->prog_data_source->accept(*this);
+      return NULL;
+    }
+    void *visit(prog_cnxn_sendto_c *symbol) {access(symbol->data_sink, xref_index_write); return NULL;}
+
+    void *visit(global_var_reference_c *symbol) {access(symbol, xref_index_read); return NULL;}
+
+    /****************************************/
+    /* B.2 - Language IL (Instruction List) */
+    /****************************************/
+    void *visit(il_simple_operation_c *symbol) {
+      symbol_c *fb_decl = NULL;
+      if ((NULL != search_var_instance_decl) && (NULL != dynamic_cast<symbolic_variable_c *>(symbol->il_operand)))
+        fb_decl = dynamic_cast<function_block_declaration_c *>(search_var_instance_decl->get_basetype_decl(symbol->il_operand));
+      if (NULL != fb_decl) {
+        /* S, R, S1, R1, CLK, CU, CD, PV, IN, PT <fb_instance> call the FB */
+        access(symbol->il_operand, xref_index_call);
+        add_pou_site(fb_decl, symbol->il_operand, xref_index_call);
+        return NULL;
+      }
+      if (   (NULL != dynamic_cast<ST_operator_c  *>(symbol->il_simple_operator))
+          || (NULL != dynamic_cast<STN_operator_c *>(symbol->il_simple_operator))
+          || (NULL != dynamic_cast<S_operator_c   *>(symbol->il_simple_operator))
+          || (NULL != dynamic_cast<R_operator_c   *>(symbol->il_simple_operator)))
+        access(symbol->il_operand, xref_index_write);
+      else if (NULL != symbol->il_operand)
+        symbol->il_operand->accept(*this);
+      return NULL;
+    }
+
+    void *visit(il_function_call_c *symbol) {
+      add_pou_site(symbol->called_function_declaration, symbol->function_name, xref_index_call);
+      /* the first parameter is the current result */
+      pass_nonformal(symbol->il_operand_list, symbol->called_function_declaration, 1);
+      return NULL;
+    }
+
+    void *visit(il_fb_call_c *symbol) {
+      access(symbol->fb_name, xref_index_call);
+      add_pou_site(symbol->called_fb_declaration, symbol->fb_name, xref_index_call);
+      if (NULL != symbol->il_operand_list) symbol->il_operand_list->accept(*this);
+      visit_formal(symbol->il_param_list, symbol->called_fb_declaration);
+      return NULL;
+    }
+
+    void *visit(il_formal_funct_call_c *symbol) {
+      add_pou_site(symbol->called_function_declaration, symbol->function_name, xref_index_call);
+      visit_formal(symbol->il_param_list, symbol->called_function_declaration);
+      return NULL;
+    }
+
+    void *visit(il_param_assignment_c *symbol) {
+      il_assign_operator_c *assign = dynamic_cast<il_assign_operator_c *>(symbol->il_assign_operator);
+      pass(symbol->il_operand, called_decl, direction(called_decl, (NULL == assign)? NULL : assign->variable_name));
+      if (NULL != symbol->simple_instr_list) symbol->simple_instr_list->accept(*this);
+      return NULL;
+    }
+
+    void *visit(il_param_out_assignment_c *symbol) {access(symbol->variable, xref_index_write); return NULL;}
+
+    /***************************************/
+    /* B.3 - Language ST (Structured Text) */
+    /***************************************/
+    void *visit(function_invocation_c *symbol) {
+      add_pou_site(symbol->called_function_declaration, symbol->function_name, xref_index_call);
+      visit_formal(symbol->formal_param_list, symbol->called_function_declaration);
+      pass_nonformal(symbol->nonformal_param_list, symbol->called_function_declaration, 0);
+      return NULL;
+    }
+
+    /********************/
+    /* B 3.2 Statements */
+    /********************/
+    void *visit(assignment_statement_c *symbol) {
+      access(symbol->l_exp, xref_index_write);
+      symbol->r_exp->accept(*this);
+      return NULL;
+    }
+
+    void *visit(fb_invocation_c *symbol) {
+      access(symbol->fb_name, xref_index_call);
+      add_pou_site(symbol->called_fb_declaration, symbol->fb_name, xref_index_call);
+      visit_formal(symbol->formal_param_list, symbol->called_fb_declaration);
+      pass_nonformal(symbol->nonformal_param_list, symbol->called_fb_declaration, 0);
+      return NULL;
+    }
+
+    /* variable_name ':=' expression */
+    void *visit(input_variable_param_assignment_c *symbol) {
+      pass(symbol->expression, called_decl, direction(called_decl, symbol->variable_name));
+      return NULL;
+    }
+
+    /* [NOT] variable_name '=>' variable */
+    void *visit(output_variable_param_assignment_c *symbol) {access(symbol->variable, xref_index_write); return NULL;}
+
+    void *visit(for_statement_c *symbol) {
+      access(symbol->control_variable, xref_index_write);
+      symbol->beg_expression->accept(*this);
+      symbol->end_expression->accept(*this);
+      if (NULL != symbol->by_expression) symbol->by_expression->accept(*this);
+      if (NULL != symbol->statement_list) symbol->statement_list->accept(*this);
+      return NULL;
+    }
+}; /* class xref_collector_c */
+
+
+
+
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+
+class xref_index_writer_c {
+  private:
+    std::vector<xref_index_symbol_t> symbols;
+    std::vector<xref_index_site_t>   sites;
+    std::map<std::string, uint32_t>  string_ids;
+    std::vector<uint32_t>            string_offsets;
+    std::string                      string_data;
+
+    uint32_t string_id(const char *str) {
+      if (NULL == str) return 0;
+      std::map<std::string, uint32_t>::iterator i = string_ids.find(str);
+      if (i != string_ids.end()) return i->second;
+      uint32_t id = string_offsets.size();
+      string_ids[str] = id;
+      string_offsets.push_back(string_data.size());
+      string_data.append(str, strlen(str) + 1);
+      return id;
+    }
+
+    /* the order of the symbols in the index */
+    struct entry_less_c {
+      const std::vector<xref_collector_c::entry_t> &entries;
+      entry_less_c(const std::vector<xref_collector_c::entry_t> &entries_): entries(entries_) {}
+      bool operator()(size_t a, size_t b) const {
+        int cmp = xref_cmp(entries[a].name, entries[b].name);
+        if (0 == cmp) cmp = xref_cmp(entries[a].scope, entries[b].scope);
+        if (0 == cmp) return entries[a].kind < entries[b].kind;
+        return cmp < 0;
+      }
+    };
+
+  public:
+    xref_index_writer_c(symbol_c *tree_root) {
+      string_offsets.push_back(0);  /* the NULL string (index 0) */
+      string_data.push_back('\0');
+
+      xref_collector_c collector(tree_root);
+      std::vector<size_t> order(collector.entries.size());
+      for (size_t i = 0; i < order.size(); i++) order[i] = i;
+      std::sort(order.begin(), order.end(), entry_less_c(collector.entries));
+
+      for (size_t i = 0; i < order.size(); i++) {
+        const xref_collector_c::entry_t &entry = collector.entries[order[i]];
+        xref_index_symbol_t symbol;
+        symbol.name       = string_id(entry.name);
+        symbol.scope      = string_id(entry.scope);
+        symbol.kind       = entry.kind;
+        symbol.first_site = sites.size();
+        symbol.site_count = entry.sites.size();
+        symbol.unused     = 0;
+        symbols.push_back(symbol);
+        for (size_t j = 0; j < entry.sites.size(); j++) {
+          xref_index_site_t site;
+          site.symbol = i;
+          site.kind   = entry.sites[j].kind;
+          site.file   = string_id(entry.sites[j].file);
+          site.line   = entry.sites[j].line;
+          site.column = entry.sites[j].column;
+          site.pou    = string_id(entry.sites[j].pou);
+          sites.push_back(site);
+        }
+      }
+    }
+
+    int write(FILE *out) {
+      xref_index_header_t header;
+      memset(&header, 0, sizeof(header));
+      memcpy(header.magic, XREF_INDEX_MAGIC, sizeof(header.magic));
+      header.version            = XREF_INDEX_VERSION;
+      header.byte_order         = XREF_INDEX_BYTE_ORDER;
+      header.symbol_count       = symbols.size();
+      header.site_count         = sites.size();
+      header.string_count       = string_offsets.size();
+      header.symbols_offset     = align(sizeof(header));
+      header.sites_offset       = align(header.symbols_offset + symbols.size()        * sizeof(xref_index_symbol_t));
+      header.strings_offset     = align(header.sites_offset   + sites.size()          * sizeof(xref_index_site_t));
+      header.string_data_offset = align(header.strings_offset + string_offsets.size() * sizeof(uint32_t));
+      header.string_data_size   = string_data.size();
+
+      uint64_t pos = 0;
+      bool ok =    write_table(out, pos, 0,                         &header,            sizeof(header))
+                && write_table(out, pos, header.symbols_offset,     symbols.data(),     symbols.size()        * sizeof(xref_index_symbol_t))
+                && write_table(out, pos, header.sites_offset,       sites.data(),       sites.size()          * sizeof(xref_index_site_t))
+                && write_table(out, pos, header.strings_offset,     &string_offsets[0], string_offsets.size() * sizeof(uint32_t))
+                && write_table(out, pos, header.string_data_offset, string_data.data(), string_data.size());
+      return (ok && (fflush(out) == 0))? 0 : -1;
+    }
+
+  private:
+    static uint64_t align(uint64_t offset) {return (offset + 7) & ~(uint64_t)7;}
+
+    static bool write_table(FILE *out, uint64_t &pos, uint64_t offset, const void *data, size_t len) {
+      for (; pos < offset; pos++)
+        if (putc(0, out) == EOF) return false;
+      if ((len > 0) && (fwrite(data, 1, len, out) != len)) return false;
+      pos += len;
+      return true;
+    }
+};
+
+
+int save_xref_index(symbol_c *tree_root, FILE *out) {
+  xref_index_writer_c writer(tree_root);
+  return writer.write(out);
+}
+
+
+int save_xref_index(symbol_c *tree_root, const char *filename) {
+  std::string tmp_filename = std::string(filename) + ".tmp";
+  FILE *out = fopen(tmp_filename.c_str(), "wb");
+  if (NULL == out) {
+    perror(("Error creating " + tmp_filename).c_str());
+    return -1;
+  }
+
+  bool failed = (save_xref_index(tree_root, out) < 0);
+  if (fclose(out) != 0) failed = true;
+  if (failed || (rename(tmp_filename.c_str(), filename) != 0)) {
+    perror((std::string("Error writing ") + filename).c_str());
+    remove(tmp_filename.c_str());
+    return -1;
+  }
+  return 0;
+}
+
+
+
+
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+
+xref_index_c:: xref_index_c(void) {data = NULL; size = 0; mapped = false; hdr = NULL;}
+xref_index_c::~xref_index_c(void) {close();}
+
+
+void xref_index_c::close(void) {
+#ifdef MMAP_XREF_INDEX
+  if (mapped) munmap(data, size);
+#endif
+  if (!mapped) free(data);
+  data   = NULL;
+  size   = 0;
+  mapped = false;
+  hdr    = NULL;
+}
+
+
+/* returns true if the table lies within the index */
+static bool table_fits(uint64_t offset, uint64_t count, uint64_t element_size, size_t size) {
+  if ((offset % 8 != 0) || (offset > size)) return false;
+  return (count <= (size - offset) / element_size);
+}
+
+
+int xref_index_c::open(const char *filename) {
+  close();
+  FILE *in = fopen(filename, "rb");
+  if (NULL == in) return -1;
+  struct stat st;
+  if ((fstat(fileno(in), &st) != 0) || (st.st_size < (off_t)sizeof(xref_index_header_t))) {fclose(in); return -1;}
+  size = st.st_size;
+
+#ifdef MMAP_XREF_INDEX
+  void *map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fileno(in), 0);
+  if (MAP_FAILED != map) {data = (char *)map; mapped = true;}
+#endif
+  if (!mapped) {
+    data = (char *)malloc(size);
+    if ((NULL == data) || (fread(data, 1, size, in) != size)) {fclose(in); close(); return -1;}
+  }
+  fclose(in);
+
+  const xref_index_header_t *h = (const xref_index_header_t *)data;
+  if (   (memcmp(h->magic, XREF_INDEX_MAGIC, sizeof(h->magic)) != 0)
+      || (h->version    != XREF_INDEX_VERSION)
+      || (h->byte_order != XREF_INDEX_BYTE_ORDER)
+      || !table_fits(h->symbols_offset,     h->symbol_count,     sizeof(xref_index_symbol_t), size)
+      || !table_fits(h->sites_offset,       h->site_count,       sizeof(xref_index_site_t),   size)
+      || !table_fits(h->strings_offset,     h->string_count,     sizeof(uint32_t),            size)
+      || !table_fits(h->string_data_offset, h->string_data_size, 1,                           size)
+      || (h->string_data_size == 0) || (data[h->string_data_offset + h->string_data_size - 1] != '\0')) {
+    close();
+    return -1;
+  }
+  hdr = h;
+  return 0;
+}
+
+
+const xref_index_symbol_t *xref_index_c::symbol(uint32_t index) {
+  if ((NULL == hdr) || (index >= hdr->symbol_count)) return NULL;
+  return ((const xref_index_symbol_t *)(data + hdr->symbols_offset)) + index;
+}
+
+
+uint32_t xref_index_c::index(const xref_index_symbol_t *symbol) {
+  if ((NULL == hdr) || (NULL == symbol)) return 0;
+  return symbol - (const xref_index_symbol_t *)(data + hdr->symbols_offset);
+}
+
+
+const xref_index_site_t *xref_index_c::site(uint32_t index) {
+  if ((NULL == hdr) || (index >= hdr->site_count)) return NULL;
+  return ((const xref_index_site_t *)(data + hdr->sites_offset)) + index;
+}
+
+
+const xref_index_site_t *xref_index_c::site(const xref_index_symbol_t *symbol, uint32_t i) {
+  if ((NULL == hdr) || (NULL == symbol) || (i >= symbol->site_count)) return NULL;
+  if ((symbol->first_site >= hdr->site_count) || (i >= hdr->site_count - symbol->first_site)) return NULL;
+  return site(symbol->first_site + i);
+}
+
+
+const char *xref_index_c::string(uint32_t index) {
+  if ((NULL == hdr) || (0 == index) || (index >= hdr->string_count)) return NULL;
+  uint32_t offset = ((const uint32_t *)(data + hdr->strings_offset))[index];
+  if (offset >= hdr->string_data_size) return NULL;
+  return data + hdr->string_data_offset + offset;
+}
+
+
+const xref_index_symbol_t *xref_index_c::find(const char *name, const char *scope) {
+  if ((NULL == hdr) || (NULL == name)) return NULL;
+  /* the first symbol not before (name, scope) */
+  uint32_t first = 0, last = hdr->symbol_count;
+  while (first < last) {
+    uint32_t middle = first + (last - first) / 2;
+    const xref_index_symbol_t *sym = symbol(middle);
+    int cmp = xref_cmp(string(sym->name), name);
+    if (0 == cmp) cmp = xref_cmp(string(sym->scope), scope);
+    if (cmp < 0) first = middle + 1; else last = middle;
+  }
+  const xref_index_symbol_t *sym = symbol(first);
+  if (NULL == sym) return NULL;
+  if ((xref_cmp(string(sym->name), name) != 0) || (xref_cmp(string(sym->scope), scope) != 0)) return NULL;
+  return sym;
+}
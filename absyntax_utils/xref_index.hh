@@ -0,0 +1,181 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+/*
+ * A binary cross-reference index of the source code (iec2c -x), for use by other tools (editors,
+ * IDEs, documentation generators, ...): for each symbol (FUNCTION, FUNCTION_BLOCK or PROGRAM, variable,
+ * global variable, located variable, or PROGRAM instance), the places in the source code where it is
+ * declared, read, written, or called. It is built from the AST annotated by stage 3, so the variables
+ * are matched to their declaration, and the calls to the called POU.
+ *
+ * Like the AST image (see ast_image.hh), the index has a fixed layout, and may be mapped into memory:
+ * a tool looks up a symbol with a binary search of the symbols, and then reads its sites, that are
+ * stored one after the other. All the integers are in the byte order of the machine running iec2c
+ * (see xref_index_header_t.byte_order).
+ *
+ * Index file layout (each table is aligned on 8 bytes):
+ *   - the header (xref_index_header_t)
+ *   - the symbols (xref_index_symbol_t), sorted by name, then by scope (both compared with strcasecmp(),
+ *     the NULL scope first), then by kind
+ *   - the sites (xref_index_site_t), those of each symbol one after the other, in the order of the source code
+ *   - the strings: a table of the offsets (uint32_t) of each string into the string data, followed by
+ *     the string data itself (NUL terminated strings). String 0 is a NULL string.
+ *
+ * The variables are in the scope of the POU declaring them (the scope is the name of the POU), and the PROGRAM
+ * instances in the scope of their resource (or configuration). The POUs, and the global and located variables,
+ * are in the NULL scope.
+ *
+ * NOTE: A VAR_EXTERNAL refers to the global variable of the same name, but a POU may be used by several
+ *       resources (and configurations), so the global variables of all the resources and configurations
+ *       are in the same (NULL) scope.
+ * NOTE: An access to an element of an ARRAY, or to a field of a STRUCT or of a FB instance, is an access
+ *       to the whole variable. An access through a REF_TO (^) is not an access to any symbol.
+ */
+
+
+#ifndef _XREF_INDEX_HH
+#define _XREF_INDEX_HH
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+
+
+#define XREF_INDEX_MAGIC      "IEC_XRF"     /* 8 bytes, including the NUL */
+#define XREF_INDEX_VERSION    1
+#define XREF_INDEX_BYTE_ORDER 0x01020304
+
+#define XREF_INDEX_FILENAME   "XREF.idx"    /* the name of the index written by iec2c -x */
+
+
+typedef struct {
+  char     magic[8];
+  uint32_t version;            /* XREF_INDEX_VERSION */
+  uint32_t byte_order;         /* XREF_INDEX_BYTE_ORDER, as written by the machine that generated the index */
+  uint32_t symbol_count;
+  uint32_t site_count;
+  uint32_t string_count;       /* including the NULL string 0 */
+  uint32_t unused;
+  uint64_t symbols_offset;     /* the offsets of each table, from the start of the file */
+  uint64_t sites_offset;
+  uint64_t strings_offset;
+  uint64_t string_data_offset;
+  uint64_t string_data_size;
+} xref_index_header_t;
+
+
+/* The kind of each symbol */
+typedef enum {
+  xref_index_function         = 0,
+  xref_index_function_block   = 1,
+  xref_index_program          = 2,
+  xref_index_variable         = 3,  /* declared by a POU (including the FB instances) */
+  xref_index_global           = 4,  /* VAR_GLOBAL */
+  xref_index_located          = 5,  /* a directly represented variable, e.g. %IX0.3 */
+  xref_index_program_instance = 6   /* PROGRAM <name> WITH ... : <program_type> */
+} xref_index_symbol_kind_t;
+
+
+/* The kind of each site */
+typedef enum {
+  xref_index_declaration = 0,
+  xref_index_read        = 1,
+  xref_index_write       = 2,
+  xref_index_readwrite   = 3,  /* passed to a VAR_IN_OUT */
+  xref_index_call        = 4,  /* of a FUNCTION, of a FUNCTION_BLOCK, or of a FB instance */
+  xref_index_instance    = 5,  /* the declaration of an instance of the FUNCTION_BLOCK or PROGRAM */
+  xref_index_external    = 6   /* the VAR_EXTERNAL declaration of a global variable */
+} xref_index_site_kind_t;
+
+
+typedef struct {
+  uint32_t name;               /* the name of the symbol (a string), as first declared (or used) */
+  uint32_t scope;              /* the name of the POU, resource or configuration (a string), 0 for the NULL scope */
+  uint32_t kind;               /* xref_index_symbol_kind_t */
+  uint32_t first_site;         /* index of the first site of the symbol */
+  uint32_t site_count;
+  uint32_t unused;
+} xref_index_symbol_t;
+
+
+typedef struct {
+  uint32_t symbol;             /* index of the symbol */
+  uint32_t kind;               /* xref_index_site_kind_t */
+  uint32_t file;               /* the location (a string, and the line and column) */
+  int32_t  line;
+  int32_t  column;
+  uint32_t pou;                /* the name of the POU, resource or configuration containing the site (a string) */
+} xref_index_site_t;
+
+
+
+class symbol_c; // forward declaration
+
+/* Write the cross-reference index of the AST (written to filename.tmp, that is renamed once complete). Return < 0 on error. */
+int save_xref_index(symbol_c *tree_root, const char *filename);
+int save_xref_index(symbol_c *tree_root, FILE *out);
+
+
+/* Read access to an index, mapped into memory (or, where mmap() is not available, read into memory).
+ * Only the header and the size of the tables are checked when the index is opened. Each access
+ * checks the index it is given, and returns NULL (or 0) if it is out of range.
+ */
+class xref_index_c {
+  public:
+    xref_index_c(void);
+    ~xref_index_c(void);
+
+    /* Returns < 0 if the file could not be read, or is not an index with the current version */
+    int  open(const char *filename);
+    void close(void);
+
+    const xref_index_header_t *header(void) {return hdr;}
+    const xref_index_symbol_t *symbol(uint32_t index);
+    const xref_index_site_t   *site  (uint32_t index);
+    const xref_index_site_t   *site  (const xref_index_symbol_t *symbol, uint32_t i);  /* the i'th site of the symbol */
+    const char                *string(uint32_t index);  /* NULL for index 0 */
+    uint32_t                   index (const xref_index_symbol_t *symbol);
+
+    /* The first symbol with the name in the scope (NULL for the NULL scope), or NULL if there is none.
+     * The symbols of the other kinds with the same name and scope (if any) follow it.
+     */
+    const xref_index_symbol_t *find(const char *name, const char *scope = NULL);
+
+  private:
+    char                      *data;
+    size_t                     size;
+    bool                       mapped;
+    const xref_index_header_t *hdr;
+};
+
+
+#endif /* _XREF_INDEX_HH */
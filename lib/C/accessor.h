@@ -3,23 +3,102 @@
 
 #define __INITIAL_VALUE(...) __VA_ARGS__
 
+/* When DISABLE_VARIABLE_FORCING is defined (iec2c -O f), the generated code does not support
+ * forcing variables: variables are read and written directly, without checking the force flags.
+ */
+
+/* When USE_RETAIN_SEGMENT is defined (iec2c -O n), the global variables (other than the located ones,
+ * which only point to the memory of the runtime) are placed in the retain segment, and each has an
+ * entry in its layout (see iec_retain.h).
+ */
+#ifdef USE_RETAIN_SEGMENT
+#include "iec_retain.h"
+#else
+#define __RETAIN_SEGMENT
+#define __RETAIN_LAYOUT(name)
+#endif
+
+/* When USE_RETAIN_DIRTY is also defined (iec2c -O z), writing a RETAIN variable marks its page of
+ * the retain segment as dirty. Taking the address of a variable (to pass it to a VAR_IN_OUT or an
+ * output of a function) marks it too, whether or not it is then written.
+ */
+#ifdef USE_RETAIN_DIRTY
+#define __RETAIN_DIRTY(var, flags)\
+	if ((flags) & __IEC_RETAIN_FLAG) __retain_mark_dirty(&(var), sizeof(var));
+#define __RETAIN_DIRTY_REF(var)\
+	(__retain_mark_dirty(&(var), sizeof(var)), &(var))
+#else
+#define __RETAIN_DIRTY(var, flags)
+#define __RETAIN_DIRTY_REF(var)\
+	(&(var))
+#endif
+
+/* When USE_ONLINE_CHANGE is defined (iec2c -O L), the global variables (other than the located ones)
+ * and the PROGRAM instances each have an entry in the table of the state of the PLC, and the FBs and
+ * PROGRAMs have a descriptor of the layout of their instances (see iec_online_change.h).
+ */
+#ifdef USE_ONLINE_CHANGE
+#include "iec_online_change.h"
+#else
+#define __LAYOUT_GLOBAL(type, name)
+#define __LAYOUT_GLOBAL_FB(type, name)
+#endif
+
+/* When USE_TASK_DATA is defined (iec2c -O A), the global variables written by a single task, and the
+ * PROGRAM instances, are placed in a section per task, declared with __DECLARE_GLOBAL_AT() and
+ * __DECLARE_GLOBAL_FB_AT() (see iec_task_data.h).
+ */
+#ifdef USE_TASK_DATA
+#include "iec_task_data.h"
+#else
+#define __TASK_DATA(owner)
+#define __TASK_DATA_ALIGN(domain, owner)
+#define __SHARED_DATA
+#endif
+
+/* When USE_GLOBAL_SNAPSHOTS is defined (iec2c -O G), each resource works on its own copy of the global
+ * variables of the configuration, declared with __DECLARE_GLOBAL_SNAPSHOT(), and exchanged with the
+ * globals at the cycle boundary (see iec_global_snapshot.h).
+ */
+#ifdef USE_GLOBAL_SNAPSHOTS
+#include "iec_global_snapshot.h"
+#endif
+
 // variable declaration macros
+/* __GLOBAL_FLAGS_<name> points to the flags of the global variable, so __SET_EXTERNAL may test
+ * inline whether the global is forced. __IS_GLOBAL_<name>_FORCED() is kept for any other code using it.
+ */
+#ifdef DISABLE_VARIABLE_FORCING
+#define __DECLARE_GLOBAL_IS_FORCED(domain, name)
+#else
+#define __DECLARE_GLOBAL_IS_FORCED(domain, name)\
+	IEC_BYTE *__GLOBAL_FLAGS_##name = &(domain##__##name.flags);\
+	IEC_BYTE __IS_GLOBAL_##name##_FORCED(void) {\
+		return (*GLOBAL__##name).flags & __IEC_FORCE_FLAG;\
+	}
+#endif
 #define __DECLARE_VAR(type, name)\
 	__IEC_##type##_t name;
 #define __DECLARE_GLOBAL(type, domain, name)\
-	__IEC_##type##_t domain##__##name;\
+	__DECLARE_GLOBAL_AT(__RETAIN_SEGMENT, type, domain, name)
+#define __DECLARE_GLOBAL_AT(placement, type, domain, name)\
+	placement __IEC_##type##_t domain##__##name;\
+	__RETAIN_LAYOUT(domain##__##name)\
+	__LAYOUT_GLOBAL(type, domain##__##name)\
 	static __IEC_##type##_t *GLOBAL__##name = &(domain##__##name);\
 	void __INIT_GLOBAL_##name(type value) {\
 		(*GLOBAL__##name).value = value;\
 	}\
-	IEC_BYTE __IS_GLOBAL_##name##_FORCED(void) {\
-		return (*GLOBAL__##name).flags & __IEC_FORCE_FLAG;\
-	}\
+	__DECLARE_GLOBAL_IS_FORCED(domain, name)\
 	type* __GET_GLOBAL_##name(void) {\
 		return &((*GLOBAL__##name).value);\
 	}
 #define __DECLARE_GLOBAL_FB(type, domain, name)\
-	type domain##__##name;\
+	__DECLARE_GLOBAL_FB_AT(__RETAIN_SEGMENT, type, domain, name)
+#define __DECLARE_GLOBAL_FB_AT(placement, type, domain, name)\
+	placement type domain##__##name;\
+	__RETAIN_LAYOUT(domain##__##name)\
+	__LAYOUT_GLOBAL_FB(type, domain##__##name)\
 	static type *GLOBAL__##name = &(domain##__##name);\
 	type* __GET_GLOBAL_##name(void) {\
 		return &(*GLOBAL__##name);\
@@ -33,9 +112,7 @@
 	void __INIT_GLOBAL_##name(type value) {\
 		*((*GLOBAL__##name).value) = value;\
 	}\
-	IEC_BYTE __IS_GLOBAL_##name##_FORCED(void) {\
-		return (*GLOBAL__##name).flags & __IEC_FORCE_FLAG;\
-	}\
+	__DECLARE_GLOBAL_IS_FORCED(resource, name)\
 	type* __GET_GLOBAL_##name(void) {\
 		return (*GLOBAL__##name).value;\
 	}
@@ -86,26 +163,42 @@
 // variable getting macros
 #define __GET_VAR(name, ...)\
 	name.value __VA_ARGS__
+#ifdef DISABLE_VARIABLE_FORCING
+#define __GET_EXTERNAL(name, ...)\
+	((*(name.value)) __VA_ARGS__)
+#define __GET_LOCATED(name, ...)\
+	((*(name.value)) __VA_ARGS__)
+#else
 #define __GET_EXTERNAL(name, ...)\
 	((name.flags & __IEC_FORCE_FLAG) ? name.fvalue __VA_ARGS__ : (*(name.value)) __VA_ARGS__)
-#define __GET_EXTERNAL_FB(name, ...)\
-	__GET_VAR(((*name) __VA_ARGS__))
 #define __GET_LOCATED(name, ...)\
 	((name.flags & __IEC_FORCE_FLAG) ? name.fvalue __VA_ARGS__ : (*(name.value)) __VA_ARGS__)
+#endif
+#define __GET_EXTERNAL_FB(name, ...)\
+	__GET_VAR(((*name) __VA_ARGS__))
 
+#ifdef DISABLE_VARIABLE_FORCING
 #define __GET_VAR_BY_REF(name, ...)\
-	((name.flags & __IEC_FORCE_FLAG) ? &(name.fvalue __VA_ARGS__) : &(name.value __VA_ARGS__))
+	__RETAIN_DIRTY_REF(name.value __VA_ARGS__)
 #define __GET_EXTERNAL_BY_REF(name, ...)\
+	__RETAIN_DIRTY_REF((*(name.value)) __VA_ARGS__)
+#define __GET_LOCATED_BY_REF(name, ...)\
+	(&((*(name.value)) __VA_ARGS__))
+#else
+#define __GET_VAR_BY_REF(name, ...)\
+	((name.flags & __IEC_FORCE_FLAG) ? &(name.fvalue __VA_ARGS__) : __RETAIN_DIRTY_REF(name.value __VA_ARGS__))
+#define __GET_EXTERNAL_BY_REF(name, ...)\
+	((name.flags & __IEC_FORCE_FLAG) ? &(name.fvalue __VA_ARGS__) : __RETAIN_DIRTY_REF((*(name.value)) __VA_ARGS__))
+#define __GET_LOCATED_BY_REF(name, ...)\
 	((name.flags & __IEC_FORCE_FLAG) ? &(name.fvalue __VA_ARGS__) : &((*(name.value)) __VA_ARGS__))
+#endif
 #define __GET_EXTERNAL_FB_BY_REF(name, ...)\
 	__GET_EXTERNAL_BY_REF(((*name) __VA_ARGS__))
-#define __GET_LOCATED_BY_REF(name, ...)\
-	((name.flags & __IEC_FORCE_FLAG) ? &(name.fvalue __VA_ARGS__) : &((*(name.value)) __VA_ARGS__))
 
 #define __GET_VAR_REF(name, ...)\
-	(&(name.value __VA_ARGS__))
+	__RETAIN_DIRTY_REF(name.value __VA_ARGS__)
 #define __GET_EXTERNAL_REF(name, ...)\
-	(&((*(name.value)) __VA_ARGS__))
+	__RETAIN_DIRTY_REF((*(name.value)) __VA_ARGS__)
 #define __GET_EXTERNAL_FB_REF(name, ...)\
 	(&(__GET_VAR(((*name) __VA_ARGS__))))
 #define __GET_LOCATED_REF(name, ...)\
@@ -122,15 +215,32 @@
 
 
 // variable setting macros
+/* NOTE: without forcing, the flags of the global are not visible to __SET_EXTERNAL, so writing
+ *       an external variable always marks the page (if the global is in the retain segment).
+ */
+#ifdef DISABLE_VARIABLE_FORCING
+#ifdef USE_RETAIN_DIRTY
+#define __SET_VAR(prefix, name, suffix, new_value)\
+	{prefix name.value suffix = new_value; __RETAIN_DIRTY(prefix name.value suffix, prefix name.flags)}
+#else
 #define __SET_VAR(prefix, name, suffix, new_value)\
-	if (!(prefix name.flags & __IEC_FORCE_FLAG)) prefix name.value suffix = new_value
+	prefix name.value suffix = new_value
+#endif
 #define __SET_EXTERNAL(prefix, name, suffix, new_value)\
-	{extern IEC_BYTE __IS_GLOBAL_##name##_FORCED(void);\
-    if (!(prefix name.flags & __IEC_FORCE_FLAG || __IS_GLOBAL_##name##_FORCED()))\
-		(*(prefix name.value)) suffix = new_value;}
-#define __SET_EXTERNAL_FB(prefix, name, suffix, new_value)\
-	__SET_VAR((*(prefix name)), suffix, new_value)
+	{(*(prefix name.value)) suffix = new_value; __RETAIN_DIRTY((*(prefix name.value)) suffix, __IEC_RETAIN_FLAG)}
+#define __SET_LOCATED(prefix, name, suffix, new_value)\
+	*(prefix name.value) suffix = new_value
+#else
+#define __SET_VAR(prefix, name, suffix, new_value)\
+	if (!(prefix name.flags & __IEC_FORCE_FLAG)) {prefix name.value suffix = new_value; __RETAIN_DIRTY(prefix name.value suffix, prefix name.flags)}
+#define __SET_EXTERNAL(prefix, name, suffix, new_value)\
+	{extern IEC_BYTE *__GLOBAL_FLAGS_##name;\
+    if (!((prefix name.flags | *__GLOBAL_FLAGS_##name) & __IEC_FORCE_FLAG))\
+		{(*(prefix name.value)) suffix = new_value; __RETAIN_DIRTY((*(prefix name.value)) suffix, *__GLOBAL_FLAGS_##name)}}
 #define __SET_LOCATED(prefix, name, suffix, new_value)\
 	if (!(prefix name.flags & __IEC_FORCE_FLAG)) *(prefix name.value) suffix = new_value
+#endif
+#define __SET_EXTERNAL_FB(prefix, name, suffix, new_value)\
+	__SET_VAR((*(prefix name)), suffix, new_value)
 
 #endif //__ACCESSOR_H
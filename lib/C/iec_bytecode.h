@@ -0,0 +1,511 @@
+/*
+ * copyright 2008 Edouard TISSERANT
+ * copyright 2011 Mario de Sousa (msousa@fe.up.pt)
+ *
+ * Offered to the public under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/****
+ * The interpreter of the bytecode generated by iec2bc (PLC.iecb)
+ *
+ * The image is loaded with __bc_image_open(), that maps the file in memory (read-only, so the
+ * image of a program may be shared by all the processes that run it), and checks it: the
+ * operands of all the instructions are checked once when loading, and not while running.
+ * __bc_image_set() does the same for an image already in memory.
+ *
+ * Each __bc_vm_t is a running copy of the configuration of an image, i.e. its own global
+ * variables and PROGRAM instances, so any number of them may be run side by side (but each
+ * by a single thread at a time):
+ *
+ *     __bc_image_t image;
+ *     __bc_vm_t vm;
+ *     if (__bc_image_open(&image, "PLC.iecb") || __bc_vm_new(&vm, &image, 0)) ...;
+ *     __bc_config_init(&vm);
+ *     for (tick = 0; ...; tick++) __bc_config_run(&vm, tick);
+ *
+ * The global variables, and the variables of the PROGRAM instances, are found by name (e.g.
+ * "RES1.INST0.COUNT") with __bc_symbol(), and read or written with __bc_cell().
+ *
+ * The image is made of (all in the byte order of the compiler's host):
+ *     __bc_header_t
+ *     __bc_cell_t    constants[const_count]
+ *     __bc_instr_t   code[code_size]          (see iec_bytecode_ops.h)
+ *     __bc_pou_t     pous[pou_count]
+ *     __bc_program_t programs[program_count]  (the PROGRAM instances of the resources)
+ *     __bc_symbol_t  symbols[symbol_count]
+ *     char           names[names_size]
+ *
+ * The interpreter uses threaded dispatch (computed gotos) with gcc and clang, and a switch
+ * otherwise (or if __BC_SWITCH_DISPATCH is defined).
+ *
+ * This file does not depend on iec_std_lib.h. Link with -lm.
+ */
+
+#ifndef _IEC_BYTECODE_H
+#define _IEC_BYTECODE_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <math.h>
+
+#ifndef __BC_NO_MMAP
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#define __BC_MAGIC       "IECB"
+#define __BC_VERSION     1
+#define __BC_BYTE_ORDER  0x01020304
+
+/* the default number of cells of the stack of the FUNCTION frames */
+#ifndef __BC_STACK_CELLS
+#define __BC_STACK_CELLS 4096
+#endif
+/* the deepest nesting of FB and FUNCTION calls */
+#ifndef __BC_MAX_DEPTH
+#define __BC_MAX_DEPTH   256
+#endif
+
+enum {
+  __BC_OK = 0,
+  __BC_ERROR_FILE,      /* the image could not be read */
+  __BC_ERROR_FORMAT,    /* not an image, or truncated */
+  __BC_ERROR_VERSION,   /* generated by another version of iec2bc, or on a host with another byte order */
+  __BC_ERROR_CODE,      /* an instruction, or a table, refers to something outside the image */
+  __BC_ERROR_MEMORY,
+  __BC_ERROR_STACK,     /* the stack of the FUNCTION frames is full */
+  __BC_ERROR_DEPTH      /* too many nested calls */
+};
+
+enum {
+#define __BC_OP(name, a, b, c) __BC_OP_##name,
+#include "iec_bytecode_ops.h"
+#undef __BC_OP
+  __BC_OP_COUNT
+};
+
+enum {
+#define __BC_MATH(name, function) __BC_MATH_##name,
+#include "iec_bytecode_ops.h"
+#undef __BC_MATH
+  __BC_MATH_COUNT
+};
+
+enum {
+#define __BC_TYPE(name) __BC_TYPE_##name,
+#include "iec_bytecode_ops.h"
+#undef __BC_TYPE
+  __BC_TYPE_COUNT
+};
+
+enum {__BC_FUNCTION = 0, __BC_FUNCTION_BLOCK, __BC_PROGRAM};
+
+typedef union {
+  int64_t  i;   /* the signed integers and BOOL */
+  uint64_t u;   /* the unsigned integers and bit strings */
+  double   r;   /* REAL and LREAL */
+} __bc_cell_t;
+
+typedef struct {
+  uint16_t op, a, b, c;
+} __bc_instr_t;
+
+typedef struct {
+  char     magic[4];
+  uint32_t version;
+  uint32_t byte_order;
+  uint32_t const_count;
+  uint32_t code_size;        /* in instructions */
+  uint32_t pou_count;
+  uint32_t program_count;
+  uint32_t symbol_count;
+  uint32_t global_cells;     /* the global variables and the PROGRAM instances */
+  uint32_t init;             /* the code initialising the globals (run with the globals as its frame) */
+  uint32_t init_size;
+  uint32_t names_size;
+  uint64_t common_ticktime;  /* in ns */
+} __bc_header_t;
+
+typedef struct {
+  uint32_t name;             /* offset in the names */
+  uint32_t kind;             /* __BC_FUNCTION, __BC_FUNCTION_BLOCK or __BC_PROGRAM */
+  uint32_t cells;            /* the size of the instance (FB and PROGRAM) or of the frame (FUNCTION) */
+  uint32_t params;           /* FUNCTION: the number of parameters, in the cells 1.. of the frame (cell 0 is the result) */
+  uint32_t body, body_size;  /* the code */
+  uint32_t init, init_size;  /* FB and PROGRAM: the code initialising an instance */
+} __bc_pou_t;
+
+typedef struct {
+  uint32_t name;             /* <resource>.<instance> */
+  uint32_t pou;
+  uint32_t instance;         /* the first cell of the instance, in the globals */
+  uint32_t period;           /* run every <period> ticks (0 -> every tick) */
+} __bc_program_t;
+
+typedef struct {
+  uint32_t name;             /* <global> or <resource>.<instance>.<variable> */
+  uint32_t cell;             /* in the globals */
+  uint32_t type;             /* __BC_TYPE_* */
+} __bc_symbol_t;
+
+typedef struct {
+  const __bc_header_t  *header;
+  const __bc_cell_t    *consts;
+  const __bc_instr_t   *code;
+  const __bc_pou_t     *pous;
+  const __bc_program_t *programs;
+  const __bc_symbol_t  *symbols;
+  const char           *names;
+  void                 *map;       /* set by __bc_image_open() */
+  size_t                map_size;
+} __bc_image_t;
+
+typedef struct {
+  const __bc_image_t *image;
+  __bc_cell_t *globals;
+  __bc_cell_t *stack, *sp, *stack_end;
+  unsigned depth;
+  int error;                 /* the error that stopped the last __bc_config_init()/__bc_config_run() */
+} __bc_vm_t;
+
+
+/*****************/
+/* Loading       */
+/*****************/
+
+/* Check the instructions [start, start + size) of a POU, whose frame has frame_cells cells (or of the globals init code) */
+static inline int __bc_verify_code(const __bc_image_t *image, uint32_t start, uint32_t size, uint32_t frame_cells, int is_globals) {
+  enum {__BC_KIND__, __BC_KIND_R, __BC_KIND_K, __BC_KIND_G, __BC_KIND_P, __BC_KIND_J, __BC_KIND_M};
+  static const unsigned char kinds[][3] = {
+#define __BC_OP(name, a, b, c) {__BC_KIND_##a, __BC_KIND_##b, __BC_KIND_##c},
+#include "iec_bytecode_ops.h"
+#undef __BC_OP
+  };
+  const __bc_header_t *header = image->header;
+  uint32_t pc;
+
+  if ((start > header->code_size) || (size > header->code_size - start) || (0 == size)) return __BC_ERROR_CODE;
+  /* the code may not run past its end */
+  if ((image->code[start + size - 1].op != __BC_OP_RET) && (image->code[start + size - 1].op != __BC_OP_JMP)) return __BC_ERROR_CODE;
+
+  for (pc = start; pc < start + size; pc++) {
+    const __bc_instr_t *ip = &image->code[pc];
+    const uint16_t operands[3] = {ip->a, ip->b, ip->c};
+    const __bc_pou_t *pou;
+    int i;
+
+    if (ip->op >= __BC_OP_COUNT) return __BC_ERROR_CODE;
+    for (i = 0; i < 3; i++)
+      switch (kinds[ip->op][i]) {
+        case __BC_KIND_R: if (operands[i] >= frame_cells)          return __BC_ERROR_CODE; break;
+        case __BC_KIND_K: if (operands[i] >= header->const_count)  return __BC_ERROR_CODE; break;
+        case __BC_KIND_G: if (operands[i] >= header->global_cells) return __BC_ERROR_CODE; break;
+        case __BC_KIND_P: if (operands[i] >= header->pou_count)    return __BC_ERROR_CODE; break;
+        case __BC_KIND_M: if (operands[i] >= __BC_MATH_COUNT)      return __BC_ERROR_CODE; break;
+        case __BC_KIND_J: {
+          uint32_t target = operands[i] | ((uint32_t)operands[i + 1] << 16);
+          if ((target < start) || (target >= start + size)) return __BC_ERROR_CODE;
+          i++;
+          break;
+        }
+        default: break;
+      }
+
+    pou = &image->pous[(ip->b < header->pou_count)? ip->b : 0];
+    switch (ip->op) {
+      case __BC_OP_CALL:
+        if ((pou->kind != __BC_FUNCTION) || ((uint32_t)ip->a + pou->params >= frame_cells)) return __BC_ERROR_CODE;
+        break;
+      case __BC_OP_CALLFB:
+      case __BC_OP_INITFB:
+        /* a nested instance is smaller than the instance that contains it, so the nesting ends */
+        if ((pou->kind == __BC_FUNCTION) || ((pou->cells >= frame_cells) && !is_globals) || ((uint32_t)ip->a + pou->cells > frame_cells)) return __BC_ERROR_CODE;
+        break;
+      case __BC_OP_CALLFBG:
+        if ((pou->kind == __BC_FUNCTION) || ((uint32_t)ip->a + pou->cells > header->global_cells)) return __BC_ERROR_CODE;
+        break;
+      default:
+        break;
+    }
+  }
+  return __BC_OK;
+}
+
+/* Use (and check) an image in memory, that must remain valid as long as the image is used */
+static inline int __bc_image_set(__bc_image_t *image, const void *data, size_t size) {
+  const __bc_header_t *header = (const __bc_header_t *)data;
+  const char *next = (const char *)data + sizeof(__bc_header_t);
+  uint32_t i;
+  int error;
+
+  if ((size < sizeof(__bc_header_t)) || (memcmp(header->magic, __BC_MAGIC, 4) != 0)) return __BC_ERROR_FORMAT;
+  if ((header->version != __BC_VERSION) || (header->byte_order != __BC_BYTE_ORDER)) return __BC_ERROR_VERSION;
+  if (size - sizeof(__bc_header_t) <   (uint64_t)header->const_count   * sizeof(__bc_cell_t)
+                                     + (uint64_t)header->code_size     * sizeof(__bc_instr_t)
+                                     + (uint64_t)header->pou_count     * sizeof(__bc_pou_t)
+                                     + (uint64_t)header->program_count * sizeof(__bc_program_t)
+                                     + (uint64_t)header->symbol_count  * sizeof(__bc_symbol_t)
+                                     + (uint64_t)header->names_size)
+    return __BC_ERROR_FORMAT;
+
+  image->header   = header;
+  image->consts   = (const __bc_cell_t    *)next;  next += header->const_count   * sizeof(__bc_cell_t);
+  image->code     = (const __bc_instr_t   *)next;  next += header->code_size     * sizeof(__bc_instr_t);
+  image->pous     = (const __bc_pou_t     *)next;  next += header->pou_count     * sizeof(__bc_pou_t);
+  image->programs = (const __bc_program_t *)next;  next += header->program_count * sizeof(__bc_program_t);
+  image->symbols  = (const __bc_symbol_t  *)next;  next += header->symbol_count  * sizeof(__bc_symbol_t);
+  image->names    = next;
+  image->map      = NULL;
+  image->map_size = 0;
+
+  /* the names are NUL terminated strings */
+  if ((0 == header->names_size) || ('\0' != image->names[header->names_size - 1])) return __BC_ERROR_FORMAT;
+
+  for (i = 0; i < header->pou_count; i++) {
+    const __bc_pou_t *pou = &image->pous[i];
+    if ((pou->name >= header->names_size) || (pou->kind > __BC_PROGRAM)) return __BC_ERROR_CODE;
+    if ((pou->kind == __BC_FUNCTION) && (pou->params >= pou->cells)) return __BC_ERROR_CODE;
+    if ((error = __bc_verify_code(image, pou->body, pou->body_size, pou->cells, 0)) != __BC_OK) return error;
+    if ((pou->kind != __BC_FUNCTION) && ((error = __bc_verify_code(image, pou->init, pou->init_size, pou->cells, 0)) != __BC_OK)) return error;
+  }
+  for (i = 0; i < header->program_count; i++) {
+    const __bc_program_t *program = &image->programs[i];
+    if ((program->name >= header->names_size) || (program->pou >= header->pou_count)) return __BC_ERROR_CODE;
+    if ((image->pous[program->pou].kind != __BC_PROGRAM) || ((uint64_t)program->instance + image->pous[program->pou].cells > header->global_cells)) return __BC_ERROR_CODE;
+  }
+  for (i = 0; i < header->symbol_count; i++) {
+    const __bc_symbol_t *symbol = &image->symbols[i];
+    if ((symbol->name >= header->names_size) || (symbol->cell >= header->global_cells) || (symbol->type >= __BC_TYPE_COUNT)) return __BC_ERROR_CODE;
+  }
+  return __bc_verify_code(image, header->init, header->init_size, header->global_cells, 1);
+}
+
+#ifndef __BC_NO_MMAP
+/* Map (and check) the image in a file */
+static inline int __bc_image_open(__bc_image_t *image, const char *filename) {
+  struct stat st;
+  void *map;
+  int error;
+  int fd = open(filename, O_RDONLY);
+
+  if (fd < 0) return __BC_ERROR_FILE;
+  if ((fstat(fd, &st) != 0) || (st.st_size < (off_t)sizeof(__bc_header_t))) {close(fd); return __BC_ERROR_FORMAT;}
+  map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (MAP_FAILED == map) return __BC_ERROR_FILE;
+  if ((error = __bc_image_set(image, map, st.st_size)) != __BC_OK) {munmap(map, st.st_size); return error;}
+  image->map      = map;
+  image->map_size = st.st_size;
+  return __BC_OK;
+}
+
+static inline void __bc_image_close(__bc_image_t *image) {
+  if (NULL != image->map) munmap(image->map, image->map_size);
+  image->map = NULL;
+}
+#endif
+
+static inline const char *__bc_name(const __bc_image_t *image, uint32_t name) {return image->names + name;}
+
+/* A global variable, or a variable of a PROGRAM instance ("<resource>.<instance>.<variable>"), by name (not case sensitive) */
+static inline const __bc_symbol_t *__bc_symbol(const __bc_image_t *image, const char *name) {
+  uint32_t i;
+  for (i = 0; i < image->header->symbol_count; i++)
+    if (strcasecmp(__bc_name(image, image->symbols[i].name), name) == 0) return &image->symbols[i];
+  return NULL;
+}
+
+
+/*****************/
+/* Running       */
+/*****************/
+
+static inline void __bc_exec(__bc_vm_t *vm, uint32_t pc, __bc_cell_t *frame) {
+  static double (*const math[])(double) = {
+#define __BC_MATH(name, function) function,
+#include "iec_bytecode_ops.h"
+#undef __BC_MATH
+  };
+  const __bc_instr_t *code = vm->image->code;
+  const __bc_instr_t *ip   = code + pc;
+  const __bc_cell_t  *k    = vm->image->consts;
+  __bc_cell_t        *g    = vm->globals;
+
+#define A frame[ip->a]
+#define B frame[ip->b]
+#define C frame[ip->c]
+#define TARGET(low, high) ((uint32_t)(low) | ((uint32_t)(high) << 16))
+#define LEAVE {vm->depth--; return;}
+
+#if defined(__GNUC__) && !defined(__BC_SWITCH_DISPATCH)
+  static const void *const labels[] = {
+#define __BC_OP(name, a, b, c) &&__bc_##name,
+#include "iec_bytecode_ops.h"
+#undef __BC_OP
+  };
+#define CASE(name) __bc_##name:
+#define DISPATCH   goto *labels[ip->op];
+#define NEXT       {ip++; DISPATCH}
+#define BEGIN      DISPATCH
+#define END
+#else
+#define CASE(name) case __BC_OP_##name:
+#define DISPATCH   continue;
+#define NEXT       {ip++; continue;}
+#define BEGIN      for (;;) switch (ip->op) {
+#define END        default: LEAVE }
+#endif
+
+  if (++vm->depth > __BC_MAX_DEPTH) {vm->error = __BC_ERROR_DEPTH; LEAVE}
+
+  BEGIN
+  CASE(NOP)     NEXT
+  CASE(MOV)     A = B;                                                   NEXT
+  CASE(LDK)     A = k[ip->b];                                            NEXT
+  CASE(LDG)     A = g[ip->b];                                            NEXT
+  CASE(STG)     g[ip->a] = B;                                            NEXT
+  /* unsigned arithmetic, which wraps around instead of overflowing */
+  CASE(ADD_I)   A.u = B.u + C.u;                                         NEXT
+  CASE(SUB_I)   A.u = B.u - C.u;                                         NEXT
+  CASE(MUL_I)   A.u = B.u * C.u;                                         NEXT
+  CASE(DIV_I)   A.i = (0  == C.i)? 0 : (-1 == C.i)? (int64_t)(0 - B.u) : B.i / C.i; NEXT
+  CASE(DIV_U)   A.u = (0  == C.u)? 0 : B.u / C.u;                        NEXT
+  CASE(MOD_I)   A.i = ((0 == C.i) || (-1 == C.i))? 0 : B.i % C.i;        NEXT
+  CASE(MOD_U)   A.u = (0  == C.u)? 0 : B.u % C.u;                        NEXT
+  CASE(NEG_I)   A.u = 0 - B.u;                                           NEXT
+  CASE(ABS_I)   A.u = (B.i < 0)? 0 - B.u : B.u;                          NEXT
+  CASE(MIN_I)   A = (B.i < C.i)? B : C;                                  NEXT
+  CASE(MAX_I)   A = (B.i > C.i)? B : C;                                  NEXT
+  CASE(MIN_U)   A = (B.u < C.u)? B : C;                                  NEXT
+  CASE(MAX_U)   A = (B.u > C.u)? B : C;                                  NEXT
+  CASE(AND)     A.u = B.u & C.u;                                         NEXT
+  CASE(OR)      A.u = B.u | C.u;                                         NEXT
+  CASE(XOR)     A.u = B.u ^ C.u;                                         NEXT
+  CASE(NOT)     A.u = ~B.u;                                              NEXT
+  CASE(NOT_B)   A.u = B.u ^ 1;                                           NEXT
+  CASE(ADD_R)   A.r = B.r + C.r;                                         NEXT
+  CASE(SUB_R)   A.r = B.r - C.r;                                         NEXT
+  CASE(MUL_R)   A.r = B.r * C.r;                                         NEXT
+  CASE(DIV_R)   A.r = B.r / C.r;                                         NEXT
+  CASE(NEG_R)   A.r = -B.r;                                              NEXT
+  CASE(MIN_R)   A = (B.r < C.r)? B : C;                                  NEXT
+  CASE(MAX_R)   A = (B.r > C.r)? B : C;                                  NEXT
+  CASE(POW)     A.r = pow(B.r, C.r);                                     NEXT
+  CASE(MATH)    A.r = math[ip->c](B.r);                                  NEXT
+  CASE(EQ_I)    A.i = (B.i == C.i);                                      NEXT
+  CASE(NE_I)    A.i = (B.i != C.i);                                      NEXT
+  CASE(LT_I)    A.i = (B.i <  C.i);                                      NEXT
+  CASE(LE_I)    A.i = (B.i <= C.i);                                      NEXT
+  CASE(LT_U)    A.i = (B.u <  C.u);                                      NEXT
+  CASE(LE_U)    A.i = (B.u <= C.u);                                      NEXT
+  CASE(EQ_R)    A.i = (B.r == C.r);                                      NEXT
+  CASE(NE_R)    A.i = (B.r != C.r);                                      NEXT
+  CASE(LT_R)    A.i = (B.r <  C.r);                                      NEXT
+  CASE(LE_R)    A.i = (B.r <= C.r);                                      NEXT
+  CASE(SX8)     A.i = (int8_t)  B.i;                                     NEXT
+  CASE(SX16)    A.i = (int16_t) B.i;                                     NEXT
+  CASE(SX32)    A.i = (int32_t) B.i;                                     NEXT
+  CASE(ZX8)     A.u = (uint8_t) B.u;                                     NEXT
+  CASE(ZX16)    A.u = (uint16_t)B.u;                                     NEXT
+  CASE(ZX32)    A.u = (uint32_t)B.u;                                     NEXT
+  CASE(F32)     A.r = (float)B.r;                                        NEXT
+  CASE(I2B)     A.i = (0 != B.i);                                        NEXT
+  CASE(R2B)     A.i = (0 != B.r);                                        NEXT
+  CASE(I2R)     A.r = (double)B.i;                                       NEXT
+  CASE(U2R)     A.r = (double)B.u;                                       NEXT
+  CASE(R2I)     A.i = (int64_t)((B.r >= 0)? floor(B.r + 0.5) : ceil(B.r - 0.5)); NEXT
+  CASE(R2U)     A.u = (B.r > 0)? (uint64_t)floor(B.r + 0.5) : 0;         NEXT
+  CASE(TRUNC)   A.i = (int64_t)B.r;                                      NEXT
+  CASE(JMP)     ip = code + TARGET(ip->a, ip->b);                        DISPATCH
+  CASE(JZ)      if (0 == A.i) {ip = code + TARGET(ip->b, ip->c); DISPATCH} NEXT
+  CASE(JNZ)     if (0 != A.i) {ip = code + TARGET(ip->b, ip->c); DISPATCH} NEXT
+  CASE(CALL)    {
+                  const __bc_pou_t *function = &vm->image->pous[ip->b];
+                  __bc_cell_t *callee = vm->sp;
+                  if ((size_t)(vm->stack_end - callee) < function->cells) {vm->error = __BC_ERROR_STACK; LEAVE}
+                  vm->sp += function->cells;
+                  memcpy(callee + 1, &frame[ip->a + 1], function->params * sizeof(__bc_cell_t));
+                  __bc_exec(vm, function->body, callee);
+                  memcpy(&frame[ip->a], callee, (function->params + 1) * sizeof(__bc_cell_t));
+                  vm->sp = callee;
+                  if (vm->error) LEAVE
+                }
+                NEXT
+  CASE(CALLFB)  __bc_exec(vm, vm->image->pous[ip->b].body, &frame[ip->a]); if (vm->error) LEAVE NEXT
+  CASE(CALLFBG) __bc_exec(vm, vm->image->pous[ip->b].body, &g[ip->a]);     if (vm->error) LEAVE NEXT
+  CASE(INITFB)  __bc_exec(vm, vm->image->pous[ip->b].init, &frame[ip->a]); if (vm->error) LEAVE NEXT
+  CASE(RET)     LEAVE
+  END
+
+#undef A
+#undef B
+#undef C
+#undef TARGET
+#undef LEAVE
+#undef CASE
+#undef DISPATCH
+#undef NEXT
+#undef BEGIN
+#undef END
+}
+
+/* A new copy of the configuration of the image (stack_cells: the size of the stack of the FUNCTION frames, 0 for the default) */
+static inline int __bc_vm_new(__bc_vm_t *vm, const __bc_image_t *image, size_t stack_cells) {
+  if (0 == stack_cells) stack_cells = __BC_STACK_CELLS;
+  vm->image   = image;
+  vm->globals = (__bc_cell_t *)calloc(image->header->global_cells + 1, sizeof(__bc_cell_t));
+  vm->stack   = (__bc_cell_t *)calloc(stack_cells, sizeof(__bc_cell_t));
+  vm->sp        = vm->stack;
+  vm->stack_end = vm->stack + stack_cells;
+  vm->depth   = 0;
+  vm->error   = __BC_OK;
+  if ((NULL == vm->globals) || (NULL == vm->stack)) {free(vm->globals); free(vm->stack); return __BC_ERROR_MEMORY;}
+  return __BC_OK;
+}
+
+static inline void __bc_vm_free(__bc_vm_t *vm) {
+  free(vm->globals);
+  free(vm->stack);
+  vm->globals = vm->stack = NULL;
+}
+
+static inline __bc_cell_t *__bc_cell(__bc_vm_t *vm, const __bc_symbol_t *symbol) {return &vm->globals[symbol->cell];}
+
+/* Initialise the global variables and the PROGRAM instances */
+static inline int __bc_config_init(__bc_vm_t *vm) {
+  vm->error = __BC_OK;
+  vm->sp    = vm->stack;
+  vm->depth = 0;
+  __bc_exec(vm, vm->image->header->init, vm->globals);
+  return vm->error;
+}
+
+/* Run the PROGRAM instances due on this tick */
+static inline int __bc_config_run(__bc_vm_t *vm, unsigned long long tick) {
+  uint32_t i;
+  vm->error = __BC_OK;
+  vm->sp    = vm->stack;
+  vm->depth = 0;
+  for (i = 0; (i < vm->image->header->program_count) && (__BC_OK == vm->error); i++) {
+    const __bc_program_t *program = &vm->image->programs[i];
+    if ((program->period <= 1) || (0 == tick % program->period))
+      __bc_exec(vm, vm->image->pous[program->pou].body, &vm->globals[program->instance]);
+  }
+  return vm->error;
+}
+
+#endif /* _IEC_BYTECODE_H */
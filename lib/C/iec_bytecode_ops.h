@@ -0,0 +1,141 @@
+/*
+ * copyright 2008 Edouard TISSERANT
+ * copyright 2011 Mario de Sousa (msousa@fe.up.pt)
+ *
+ * Offered to the public under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/****
+ * The instructions of the bytecode generated by iec2bc (see iec_bytecode.h).
+ *
+ * This file is included both by the compiler (stage4/generate_bytecode) and by the interpreter,
+ * after defining __BC_OP(name, a, b, c), __BC_MATH(name, function) and/or __BC_TYPE(name),
+ * so both always agree on the numbering. It has no include guard on purpose.
+ *
+ * Every instruction is 4 16 bit words: the opcode and the operands a, b, c. The kind of each
+ * operand is:
+ *    R : a cell of the frame (the instance of the FB or PROGRAM, or the frame of the FUNCTION)
+ *    K : a constant
+ *    G : a cell of the globals (the global variables and the PROGRAM instances)
+ *    P : a POU
+ *    J : the address of an instruction, in two operands (low 16 bits first)
+ *    M : a __BC_MATH function
+ *    _ : unused
+ *
+ * The integers are kept in the cells as 64 bit values, sign or zero extended from their type.
+ * The operations on the integers are done on 64 bits, followed by the SX* or ZX* instruction of
+ * the type, to wrap the result as the type would. The same holds for REAL (kept as a double,
+ * rounded to float after each operation by F32). BOOL is 0 or 1.
+ */
+
+#ifdef __BC_OP
+/* moves */
+__BC_OP(NOP,     _, _, _)
+__BC_OP(MOV,     R, R, _)   /* a = b */
+__BC_OP(LDK,     R, K, _)   /* a = constant b */
+__BC_OP(LDG,     R, G, _)   /* a = global b */
+__BC_OP(STG,     G, R, _)   /* global a = b */
+/* integers */
+__BC_OP(ADD_I,   R, R, R)   /* a = b + c */
+__BC_OP(SUB_I,   R, R, R)
+__BC_OP(MUL_I,   R, R, R)
+__BC_OP(DIV_I,   R, R, R)   /* signed, 0 if c is 0 */
+__BC_OP(DIV_U,   R, R, R)   /* unsigned, 0 if c is 0 */
+__BC_OP(MOD_I,   R, R, R)   /* signed, 0 if c is 0 */
+__BC_OP(MOD_U,   R, R, R)   /* unsigned, 0 if c is 0 */
+__BC_OP(NEG_I,   R, R, _)   /* a = -b */
+__BC_OP(ABS_I,   R, R, _)
+__BC_OP(MIN_I,   R, R, R)
+__BC_OP(MAX_I,   R, R, R)
+__BC_OP(MIN_U,   R, R, R)
+__BC_OP(MAX_U,   R, R, R)
+__BC_OP(AND,     R, R, R)   /* a = b & c (BOOL and bit strings) */
+__BC_OP(OR,      R, R, R)
+__BC_OP(XOR,     R, R, R)
+__BC_OP(NOT,     R, R, _)   /* a = ~b (bit strings) */
+__BC_OP(NOT_B,   R, R, _)   /* a = !b (BOOL) */
+/* reals */
+__BC_OP(ADD_R,   R, R, R)
+__BC_OP(SUB_R,   R, R, R)
+__BC_OP(MUL_R,   R, R, R)
+__BC_OP(DIV_R,   R, R, R)
+__BC_OP(NEG_R,   R, R, _)
+__BC_OP(MIN_R,   R, R, R)
+__BC_OP(MAX_R,   R, R, R)
+__BC_OP(POW,     R, R, R)   /* a = pow(b, c) */
+__BC_OP(MATH,    R, R, M)   /* a = function c of b */
+/* comparisons, a = 0 or 1 (b > c is c < b) */
+__BC_OP(EQ_I,    R, R, R)
+__BC_OP(NE_I,    R, R, R)
+__BC_OP(LT_I,    R, R, R)
+__BC_OP(LE_I,    R, R, R)
+__BC_OP(LT_U,    R, R, R)
+__BC_OP(LE_U,    R, R, R)
+__BC_OP(EQ_R,    R, R, R)
+__BC_OP(NE_R,    R, R, R)
+__BC_OP(LT_R,    R, R, R)
+__BC_OP(LE_R,    R, R, R)
+/* conversions and wrapping, a = b as the type */
+__BC_OP(SX8,     R, R, _)
+__BC_OP(SX16,    R, R, _)
+__BC_OP(SX32,    R, R, _)
+__BC_OP(ZX8,     R, R, _)
+__BC_OP(ZX16,    R, R, _)
+__BC_OP(ZX32,    R, R, _)
+__BC_OP(F32,     R, R, _)   /* rounded to float */
+__BC_OP(I2B,     R, R, _)   /* a = (b != 0) */
+__BC_OP(R2B,     R, R, _)
+__BC_OP(I2R,     R, R, _)
+__BC_OP(U2R,     R, R, _)
+__BC_OP(R2I,     R, R, _)   /* rounded to the nearest integer, halfway cases away from 0 */
+__BC_OP(R2U,     R, R, _)   /* same, the negative values to 0 */
+__BC_OP(TRUNC,   R, R, _)
+/* control */
+__BC_OP(JMP,     J, J, _)
+__BC_OP(JZ,      R, J, J)   /* if (a == 0) jump */
+__BC_OP(JNZ,     R, J, J)
+__BC_OP(CALL,    R, P, _)   /* call FUNCTION b, with its result and parameters in a, a+1, ... (copied in and out) */
+__BC_OP(CALLFB,  R, P, _)   /* call the body of the FB (or PROGRAM) b, whose instance starts at cell a */
+__BC_OP(CALLFBG, G, P, _)   /* same, for an instance in the globals */
+__BC_OP(INITFB,  R, P, _)   /* initialise the instance of the FB b, that starts at cell a */
+__BC_OP(RET,     _, _, _)
+#endif
+
+#ifdef __BC_MATH
+__BC_MATH(SQRT,  sqrt)
+__BC_MATH(LN,    log)
+__BC_MATH(LOG,   log10)
+__BC_MATH(EXP,   exp)
+__BC_MATH(SIN,   sin)
+__BC_MATH(COS,   cos)
+__BC_MATH(TAN,   tan)
+__BC_MATH(ASIN,  asin)
+__BC_MATH(ACOS,  acos)
+__BC_MATH(ATAN,  atan)
+__BC_MATH(ABS,   fabs)
+#endif
+
+#ifdef __BC_TYPE
+/* the types of the variables in the symbol table of the image */
+__BC_TYPE(BOOL)
+__BC_TYPE(SINT)
+__BC_TYPE(INT)
+__BC_TYPE(DINT)
+__BC_TYPE(LINT)
+__BC_TYPE(USINT)
+__BC_TYPE(UINT)
+__BC_TYPE(UDINT)
+__BC_TYPE(ULINT)
+__BC_TYPE(REAL)
+__BC_TYPE(LREAL)
+#endif
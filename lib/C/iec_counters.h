@@ -0,0 +1,75 @@
+/*
+ * copyright 2008 Edouard TISSERANT
+ * copyright 2011 Mario de Sousa (msousa@fe.up.pt)
+ *
+ * Offered to the public under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/****
+ * The execution counters of the statements (USE_STMT_COUNTERS, iec2c -O C)
+ *
+ * Every ST statement and IL instruction increments a counter (__stmt_counter_t) with the
+ * source file and line of the statement. The counters are placed by the C compiler in the
+ * 'iec_counters' section, which the linker lays out as an array (returned by __stmt_counters()).
+ *
+ * __stmt_counters_dump() writes all the counters as text, one per line:
+ *     <file>:<line> <count>
+ * The same line may appear more than once (several statements on the same line, or a FUNCTION
+ * defined static inline in its header, that has its own counters in every translation unit),
+ * and its counts must then be added together. The statements that never ran have a count of 0,
+ * so the dump also gives the coverage of the source.
+ *
+ * NOTE: The counters of the FUNCTION_BLOCKs and PROGRAMs count the executions of all their instances.
+ * NOTE: Not atomic. The resources must not be run in parallel (e.g. on separate threads) when counting.
+ * NOTE: The __start_<section> and __stop_<section> symbols are defined by the GNU linker (and
+ *       compatible ones). Other targets must define them in their linker script.
+ *
+ * This file is included by iec_std_lib.h, do not include it directly.
+ */
+
+#ifndef _IEC_COUNTERS_H
+#define _IEC_COUNTERS_H
+
+typedef struct {
+  const char *file;
+  unsigned long line;
+  unsigned long long count;
+} __stmt_counter_t;
+
+/* NOTE: the explicit alignment keeps the C compiler from leaving holes between the counters */
+#define __STMT_COUNT(file, line) {\
+	static __stmt_counter_t __stmt_counter __attribute__((section("iec_counters"), aligned(sizeof(void *)))) = {file, line, 0};\
+	__stmt_counter.count++;}
+
+extern __stmt_counter_t __start_iec_counters[] __attribute__((weak));
+extern __stmt_counter_t __stop_iec_counters[]  __attribute__((weak));
+
+/* All the counters, in no particular order */
+static inline __stmt_counter_t *__stmt_counters(unsigned long *count) {
+  *count = __stop_iec_counters - __start_iec_counters;
+  return __start_iec_counters;
+}
+
+static inline void __stmt_counters_reset(void) {
+  __stmt_counter_t *counter;
+  for (counter = __start_iec_counters; counter < __stop_iec_counters; counter++)
+    counter->count = 0;
+}
+
+static inline void __stmt_counters_dump(FILE *file) {
+  __stmt_counter_t *counter;
+  for (counter = __start_iec_counters; counter < __stop_iec_counters; counter++)
+    fprintf(file, "%s:%lu %llu\n", counter->file, counter->line, counter->count);
+}
+
+#endif /* _IEC_COUNTERS_H */
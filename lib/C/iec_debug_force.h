@@ -0,0 +1,182 @@
+/*
+ * copyright 2008 Edouard TISSERANT
+ * copyright 2011 Mario de Sousa (msousa@fe.up.pt)
+ *
+ * Offered to the public under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/****
+ * Forcing and setting the debug variables between two cycles (iec2c -O y)
+ *
+ * Instead of writing the value and the flags of a variable while the cycle is running, the debugger
+ * (and any other client of the runtime) posts its requests (force, release or set the variable with the
+ * given index in __debug_vars[], see iec_debug_table.h) to a queue. At the start of each cycle,
+ * config_run__() calls __debug_force_cycle(), which applies all the requests posted since the previous cycle.
+ * The values and the force flags of the variables therefore never change while the cycle is running.
+ *
+ * The queue is a bounded lock-free queue with multiple producers (the clients, that may post requests from
+ * any number of threads) and a single consumer (the cycle). Each slot of the queue has a sequence number that
+ * tells who may use it: a producer first reserves a slot by incrementing the enqueue position (with a
+ * compare and swap), and then publishes the request by updating the slot's sequence number.
+ *
+ * The size of the queue may be changed by defining __DEBUG_FORCE_QUEUE_SIZE (a power of 2) when compiling VARIABLES.c.
+ *
+ * NOTE: This uses the __atomic builtins of gcc (and clang).
+ * NOTE: When the code is generated without support for forcing variables (iec2c -O f), only the
+ *       __DEBUG_FORCE_SET requests are accepted.
+ */
+
+#ifndef _IEC_DEBUG_FORCE_H
+#define _IEC_DEBUG_FORCE_H
+
+#include <string.h>
+#include "iec_debug_table.h"
+
+#ifndef __DEBUG_FORCE_QUEUE_SIZE
+#define __DEBUG_FORCE_QUEUE_SIZE 64
+#endif
+
+/* the requests */
+#define __DEBUG_FORCE_SET      0  /* write the value (has no effect while the variable is forced) */
+#define __DEBUG_FORCE_FORCE    1  /* force the variable to the value */
+#define __DEBUG_FORCE_RELEASE  2  /* stop forcing the variable (the value is kept until the code changes it) */
+
+typedef struct {
+  unsigned long  sequence;  /* minus the position of the slot in the queue, so a zeroed queue is ready to use */
+  unsigned char  request;
+  long           index;     /* in __debug_vars[] */
+  union {                   /* the value (as many bytes as __debug_vars[index].size) */
+    IEC_LREAL    lreal;
+    IEC_LINT     lint;
+    IEC_TIME     time;
+    IEC_STRING   string;
+  } value;
+} __debug_force_slot_t;
+
+typedef struct {
+  unsigned long         enqueue_pos;  /* the next slot to be reserved by a producer */
+  unsigned long         dequeue_pos;  /* the next slot to be read by the consumer */
+  __debug_force_slot_t  slot[__DEBUG_FORCE_QUEUE_SIZE];
+} __debug_force_t;
+
+/* defined in VARIABLES.c */
+extern __debug_force_t __debug_force;
+
+
+/* Producer: post a request for the variable __debug_vars[index]. value points to the new value (ignored for __DEBUG_FORCE_RELEASE).
+ * Returns -1 if the queue is full (try again later), or if the request is not valid for the variable.
+ */
+static inline int __debug_force_post(unsigned char request, long index, const void *value) {
+  __debug_force_slot_t *slot;
+  unsigned long pos;
+
+  if ((index < 0) || ((unsigned long)index >= __debug_vars_count)) return -1;
+  if ((NULL == __debug_vars[index].ptr) || (__DEBUG_TYPE_FB == __debug_vars[index].type)) return -1;
+  if (__debug_vars[index].size > sizeof(slot->value)) return -1;
+  if (request > __DEBUG_FORCE_RELEASE) return -1;
+#ifdef DISABLE_VARIABLE_FORCING
+  if (request != __DEBUG_FORCE_SET) return -1;
+#endif
+
+  /* reserve a slot */
+  pos = __atomic_load_n(&__debug_force.enqueue_pos, __ATOMIC_RELAXED);
+  for (;;) {
+    long diff;
+    slot = &__debug_force.slot[pos & (__DEBUG_FORCE_QUEUE_SIZE - 1)];
+    diff = (long)(__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) + (pos & (__DEBUG_FORCE_QUEUE_SIZE - 1)) - pos);
+    if (diff < 0) return -1; /* the queue is full */
+    if (diff == 0) {
+      if (__atomic_compare_exchange_n(&__debug_force.enqueue_pos, &pos, pos + 1, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) break;
+      /* another producer got this slot. pos now has the current enqueue position. */
+    } else
+      pos = __atomic_load_n(&__debug_force.enqueue_pos, __ATOMIC_RELAXED);
+  }
+
+  /* fill it in, and publish it */
+  slot->request = request;
+  slot->index   = index;
+  if (request != __DEBUG_FORCE_RELEASE) memcpy(&slot->value, value, __debug_vars[index].size);
+  __atomic_store_n(&slot->sequence, pos + 1 - (pos & (__DEBUG_FORCE_QUEUE_SIZE - 1)), __ATOMIC_RELEASE);
+  return 0;
+}
+
+
+/* The flags and (when the variable is a __IEC_<type>_p) the forced value of the variable.
+ * The layout of the __IEC_<type>_t and __IEC_<type>_p structs depends on the type of their value.
+ */
+typedef enum {__DEBUG_FORCE_ENUM_VALUE} __debug_force_enum_t;
+__DECLARE_COMPLEX_STRUCT(__debug_force_enum_t)
+
+#ifdef DISABLE_VARIABLE_FORCING
+#define __DEBUG_FORCE_FVALUE(type) NULL
+#else
+#define __DEBUG_FORCE_FVALUE(type) (void *)&(((__IEC_##type##_p *)var->ptr)->fvalue)
+#endif
+#define __DEBUG_FORCE_FIELDS(type)\
+    if (var->flags & __DEBUG_VAR_POINTER) {*flags = &(((__IEC_##type##_p *)var->ptr)->flags); *fvalue = __DEBUG_FORCE_FVALUE(type);}\
+    else                                  {*flags = &(((__IEC_##type##_t *)var->ptr)->flags); *fvalue = NULL;}
+#define __DEBUG_FORCE_FIELDS_CASE(type)\
+  case __DEBUG_TYPE_##type: __DEBUG_FORCE_FIELDS(type) break;
+
+static inline void __debug_force_fields(const __debug_var_t *var, IEC_BYTE **flags, void **fvalue) {
+  switch (var->type) {
+    __ANY_ELEMENTARY(__DEBUG_FORCE_FIELDS_CASE)
+    /* the enumerated types are stored in a USINT, UINT or UDINT (see __DECLARE_COMPACT_ENUMERATED_TYPE) */
+    case __DEBUG_TYPE_ENUM:
+      if      (var->size == sizeof(IEC_USINT)) {__DEBUG_FORCE_FIELDS(USINT)}
+      else if (var->size == sizeof(IEC_UINT))  {__DEBUG_FORCE_FIELDS(UINT)}
+      else                                     {__DEBUG_FORCE_FIELDS(__debug_force_enum_t)}
+      break;
+    default: *flags = NULL; *fvalue = NULL; break;
+  }
+}
+#undef __DEBUG_FORCE_FIELDS_CASE
+#undef __DEBUG_FORCE_FIELDS
+#undef __DEBUG_FORCE_FVALUE
+
+
+/* Consumer: called at the start of each cycle */
+static inline void __debug_force_cycle(void) {
+  for (;;) {
+    unsigned long         pos  = __debug_force.dequeue_pos;
+    __debug_force_slot_t *slot = &__debug_force.slot[pos & (__DEBUG_FORCE_QUEUE_SIZE - 1)];
+    const __debug_var_t  *var;
+    IEC_BYTE             *flags;
+    void                 *fvalue, *value;
+
+    if (__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) + (pos & (__DEBUG_FORCE_QUEUE_SIZE - 1)) != pos + 1) return; /* no more requests */
+
+    var   = &__debug_vars[slot->index];
+    value = (var->flags & __DEBUG_VAR_POINTER)? *(void **)var->ptr : var->ptr;
+    __debug_force_fields(var, &flags, &fvalue);
+    switch (slot->request) {
+      case __DEBUG_FORCE_FORCE:
+        if (NULL != fvalue) memcpy(fvalue, &slot->value, var->size);
+        memcpy(value, &slot->value, var->size);
+        if (NULL != flags) *flags |= __IEC_FORCE_FLAG;
+        break;
+      case __DEBUG_FORCE_RELEASE:
+        if (NULL != flags) *flags &= ~__IEC_FORCE_FLAG;
+        break;
+      default: /* __DEBUG_FORCE_SET */
+        if ((NULL == flags) || !(*flags & __IEC_FORCE_FLAG)) memcpy(value, &slot->value, var->size);
+        break;
+    }
+
+    /* free the slot, for the producer that will be posting to it once the queue wraps around */
+    __debug_force.dequeue_pos = pos + 1;
+    __atomic_store_n(&slot->sequence, pos + __DEBUG_FORCE_QUEUE_SIZE - (pos & (__DEBUG_FORCE_QUEUE_SIZE - 1)), __ATOMIC_RELEASE);
+  }
+}
+
+#endif /* _IEC_DEBUG_FORCE_H */
@@ -0,0 +1,90 @@
+/*
+ * copyright 2008 Edouard TISSERANT
+ * copyright 2011 Mario de Sousa (msousa@fe.up.pt)
+ *
+ * Offered to the public under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/****
+ * The table of the variables seen by the debugger, generated by iec2c -O y in VARIABLES.c
+ *
+ * __debug_vars[] has one entry for each variable listed in the "Variables" section of VARIABLES.csv,
+ * with the same index. Each entry points to the variable (a __IEC_<type>_t, or a __IEC_<type>_p when
+ * __DEBUG_VAR_POINTER is set), so the runtime may access the variables without having to parse
+ * VARIABLES.csv, nor generate any code of its own.
+ *
+ * The arrays and structures do not have an entry (as in VARIABLES.csv). The variables whose address is
+ * not known (e.g. located variables declared without a name) have an entry with a NULL ptr.
+ *
+ * __debug_find_variable() returns the index of a variable given its path in VARIABLES.csv
+ * (e.g. "CONFIG0.RES0.INSTANCE0.COUNTER"), or -1 if there is no such variable. The paths are found
+ * in a hash table, of at least twice the number of variables, generated by iec2c.
+ *
+ * NOTE: iec2c computes the same hash as __debug_hash() when generating the hash table.
+ *       Any change to one of them must also be done to the other (in stage4/generate_c/generate_var_list.cc)!
+ */
+
+#ifndef _IEC_DEBUG_TABLE_H
+#define _IEC_DEBUG_TABLE_H
+
+#include "iec_types_all.h"
+
+#define __DECLARE_DEBUG_TYPE_ID(type) __DEBUG_TYPE_##type,
+typedef enum {
+  __ANY_ELEMENTARY(__DECLARE_DEBUG_TYPE_ID)
+  __DEBUG_TYPE_ENUM,   /* an enumerated datatype */
+  __DEBUG_TYPE_FB      /* an FB or PROGRAM instance (ptr points to the instance itself) */
+} __debug_type_t;
+#undef __DECLARE_DEBUG_TYPE_ID
+
+/* flags of __debug_var_t */
+#define __DEBUG_VAR_POINTER 0x01  /* ptr points to a __IEC_<type>_p (or to a pointer to the FB instance) */
+
+typedef struct {
+  void          *ptr;    /* the variable */
+  unsigned char  type;   /* __debug_type_t */
+  unsigned char  flags;
+  unsigned long  size;   /* the size of the value (or of the FB instance) */
+} __debug_var_t;
+
+/* defined in VARIABLES.c */
+extern const __debug_var_t      __debug_vars[];
+extern const char *const        __debug_var_paths[];
+extern const unsigned long      __debug_vars_count;
+extern const long               __debug_var_hash[];    /* index of the variable, or -1 for an empty slot */
+extern const unsigned long      __debug_var_hash_mask; /* the number of slots, minus 1 (a power of 2 minus 1) */
+
+
+static inline char __debug_upper(char c) {
+  return ((c >= 'a') && (c <= 'z'))? c - 'a' + 'A' : c;
+}
+
+/* FNV-1a hash of the path, case insensitive */
+static inline unsigned long __debug_hash(const char *path) {
+  unsigned long hash = 2166136261UL;
+  for (; *path != '\0'; path++)
+    hash = ((hash ^ (unsigned char)__debug_upper(*path)) * 16777619UL) & 0xFFFFFFFFUL;
+  return hash;
+}
+
+static inline long __debug_find_variable(const char *path) {
+  unsigned long slot = __debug_hash(path) & __debug_var_hash_mask;
+  for (; __debug_var_hash[slot] >= 0; slot = (slot + 1) & __debug_var_hash_mask) {
+    const char *p1 = path, *p2 = __debug_var_paths[__debug_var_hash[slot]];
+    while ((*p1 != '\0') && (__debug_upper(*p1) == __debug_upper(*p2))) {p1++; p2++;}
+    if (__debug_upper(*p1) == __debug_upper(*p2)) return __debug_var_hash[slot];
+  }
+  return -1;
+}
+
+#endif /* _IEC_DEBUG_TABLE_H */
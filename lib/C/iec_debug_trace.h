@@ -0,0 +1,205 @@
+/*
+ * copyright 2008 Edouard TISSERANT
+ * copyright 2011 Mario de Sousa (msousa@fe.up.pt)
+ *
+ * Offered to the public under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/****
+ * Tracing of the debug variables at the end of each cycle (iec2c -O y)
+ *
+ * A monitoring client (the consumer, e.g. a thread of the runtime serving the debugger) chooses the
+ * variables to trace by their index in __debug_vars[] (see iec_debug_table.h). At the end of each
+ * cycle, config_run__() calls __debug_trace_cycle() (the producer), which appends to a ring buffer a
+ * record with the values of the traced variables that changed since the previous cycle. The client
+ * reads the records from the ring buffer whenever it wishes, without ever stopping the cycle.
+ *
+ * The ring buffer has a single producer and a single consumer, so it needs no locks: the producer only
+ * writes the head and the consumer only writes the tail, each with release semantics, and only after
+ * the data they refer to was written (or read).
+ *
+ * Each record is:
+ *   __debug_trace_record_t                  the header
+ *   count times:
+ *     unsigned short                        the position of the variable in the list given to __debug_trace_set()
+ *     the value (__debug_vars[index].size bytes)
+ * with no padding. A record with __DEBUG_TRACE_FULL contains all the traced variables. This is the case for
+ * the first record after a new list is used, and after records were lost because the ring buffer was full.
+ *
+ * The sizes may be changed by defining __DEBUG_TRACE_SIZE (a power of 2), __DEBUG_TRACE_MAX_VARS and
+ * __DEBUG_TRACE_VALUES_SIZE (the total size of the values of the traced variables) when compiling VARIABLES.c.
+ *
+ * NOTE: This uses the __atomic builtins of gcc (and clang).
+ */
+
+#ifndef _IEC_DEBUG_TRACE_H
+#define _IEC_DEBUG_TRACE_H
+
+#include <string.h>
+#include "iec_debug_table.h"
+
+#ifndef __DEBUG_TRACE_SIZE
+#define __DEBUG_TRACE_SIZE         (64 * 1024)
+#endif
+#ifndef __DEBUG_TRACE_MAX_VARS
+#define __DEBUG_TRACE_MAX_VARS     1024
+#endif
+#ifndef __DEBUG_TRACE_VALUES_SIZE
+#define __DEBUG_TRACE_VALUES_SIZE  (16 * 1024)
+#endif
+
+/* flags of __debug_trace_record_t */
+#define __DEBUG_TRACE_FULL      0x01  /* the record contains all the traced variables */
+#define __DEBUG_TRACE_NEW_LIST  0x02  /* the first record with the list last given to __debug_trace_set() */
+#define __DEBUG_TRACE_LOST      0x04  /* records were lost before this one */
+
+typedef struct {
+  unsigned long  size;    /* of the whole record, including this header */
+  unsigned long  tick;    /* as passed to config_run__() */
+  unsigned short flags;
+  unsigned short count;   /* the number of values in the record */
+} __debug_trace_record_t;
+
+typedef struct {
+  /* the ring buffer */
+  unsigned long  head;    /* only written by the producer */
+  unsigned long  tail;    /* only written by the consumer */
+  unsigned char  data[__DEBUG_TRACE_SIZE];
+  /* the list of the traced variables, only used by the producer */
+  unsigned short count;
+  long           index [__DEBUG_TRACE_MAX_VARS];
+  unsigned long  offset[__DEBUG_TRACE_MAX_VARS];  /* of the previous value in values[] */
+  unsigned char  values[__DEBUG_TRACE_VALUES_SIZE];
+  unsigned short flags;   /* of the next record */
+  /* the new list, written by the consumer while pending is 0, and read by the producer while pending is 1 */
+  int            pending;
+  unsigned short new_count;
+  long           new_index[__DEBUG_TRACE_MAX_VARS];
+} __debug_trace_t;
+
+/* defined in VARIABLES.c */
+extern __debug_trace_t __debug_trace;
+
+
+/* the variable's value, given its entry in __debug_vars[] */
+static inline void *__debug_trace_value(const __debug_var_t *var) {
+  return (var->flags & __DEBUG_VAR_POINTER)? *(void **)var->ptr : var->ptr;
+}
+
+static inline void __debug_trace_write(unsigned long pos, const void *src, unsigned long size) {
+  const unsigned char *bytes = (const unsigned char *)src;
+  for (; size > 0; size--, pos++, bytes++)
+    __debug_trace.data[pos & (__DEBUG_TRACE_SIZE - 1)] = *bytes;
+}
+
+static inline void __debug_trace_read_bytes(unsigned long pos, void *dst, unsigned long size) {
+  unsigned char *bytes = (unsigned char *)dst;
+  for (; size > 0; size--, pos++, bytes++)
+    *bytes = __debug_trace.data[pos & (__DEBUG_TRACE_SIZE - 1)];
+}
+
+
+/* Consumer: trace the variables index[0..count-1] (indexes in __debug_vars[]), instead of the ones currently traced.
+ * The new list is used from the end of the next cycle on.
+ * Returns -1 if the previous list has not yet been used (try again later), or if the variables are not supported or too many.
+ */
+static inline int __debug_trace_set(const long *index, unsigned int count) {
+  unsigned long size = 0;
+  unsigned int i;
+  if (__atomic_load_n(&__debug_trace.pending, __ATOMIC_ACQUIRE)) return -1;
+  if (count > __DEBUG_TRACE_MAX_VARS) return -1;
+  for (i = 0; i < count; i++) {
+    if ((index[i] < 0) || ((unsigned long)index[i] >= __debug_vars_count)) return -1;
+    if ((NULL == __debug_vars[index[i]].ptr) || (__DEBUG_TYPE_FB == __debug_vars[index[i]].type)) return -1;
+    size += __debug_vars[index[i]].size;
+  }
+  if (size > __DEBUG_TRACE_VALUES_SIZE) return -1;
+  memcpy(__debug_trace.new_index, index, count * sizeof(long));
+  __debug_trace.new_count = count;
+  __atomic_store_n(&__debug_trace.pending, 1, __ATOMIC_RELEASE);
+  return 0;
+}
+
+/* Consumer: copy the complete records in the ring buffer (that fit in size bytes) to buffer.
+ * Returns the number of bytes copied.
+ */
+static inline unsigned long __debug_trace_read(void *buffer, unsigned long size) {
+  unsigned long tail = __debug_trace.tail;
+  unsigned long head = __atomic_load_n(&__debug_trace.head, __ATOMIC_ACQUIRE);
+  unsigned long copied = 0;
+  while (tail != head) {
+    __debug_trace_record_t record;
+    __debug_trace_read_bytes(tail, &record, sizeof(record));
+    if (record.size > size - copied) break;
+    __debug_trace_read_bytes(tail, (unsigned char *)buffer + copied, record.size);
+    copied += record.size;
+    tail   += record.size;
+  }
+  __atomic_store_n(&__debug_trace.tail, tail, __ATOMIC_RELEASE);
+  return copied;
+}
+
+
+/* Producer: called at the end of each cycle */
+static inline void __debug_trace_cycle(unsigned long tick) {
+  __debug_trace_record_t record;
+  unsigned long head, free, pos;
+  unsigned short i;
+
+  /* use the new list */
+  if (__atomic_load_n(&__debug_trace.pending, __ATOMIC_ACQUIRE)) {
+    unsigned long offset = 0;
+    __debug_trace.count = __debug_trace.new_count;
+    for (i = 0; i < __debug_trace.count; i++) {
+      __debug_trace.index [i] = __debug_trace.new_index[i];
+      __debug_trace.offset[i] = offset;
+      offset += __debug_vars[__debug_trace.index[i]].size;
+    }
+    __debug_trace.flags |= __DEBUG_TRACE_FULL | __DEBUG_TRACE_NEW_LIST;
+    __atomic_store_n(&__debug_trace.pending, 0, __ATOMIC_RELEASE);
+  }
+  if (0 == __debug_trace.count) return;
+
+  head = __debug_trace.head;
+  free = __DEBUG_TRACE_SIZE - (head - __atomic_load_n(&__debug_trace.tail, __ATOMIC_ACQUIRE));
+
+  /* write the values after the (not yet known) header */
+  record.tick  = tick;
+  record.flags = __debug_trace.flags;
+  record.count = 0;
+  pos = sizeof(record);
+  for (i = 0; i < __debug_trace.count; i++) {
+    const __debug_var_t *var   = &__debug_vars[__debug_trace.index[i]];
+    unsigned char       *prev  = &__debug_trace.values[__debug_trace.offset[i]];
+    void                *value = __debug_trace_value(var);
+    if (!(record.flags & __DEBUG_TRACE_FULL) && (memcmp(prev, value, var->size) == 0)) continue;
+    if (pos + sizeof(i) + var->size > free) {
+      /* the ring buffer is full => drop this record. The next one must contain all the variables. */
+      __debug_trace.flags |= __DEBUG_TRACE_FULL | __DEBUG_TRACE_LOST;
+      return;
+    }
+    memcpy(prev, value, var->size);
+    __debug_trace_write(head + pos, &i, sizeof(i));
+    __debug_trace_write(head + pos + sizeof(i), value, var->size);
+    pos += sizeof(i) + var->size;
+    record.count++;
+  }
+  if (0 == record.count) return; /* nothing changed */
+
+  record.size = pos;
+  __debug_trace_write(head, &record, sizeof(record));
+  __debug_trace.flags = 0;
+  __atomic_store_n(&__debug_trace.head, head + pos, __ATOMIC_RELEASE);
+}
+
+#endif /* _IEC_DEBUG_TRACE_H */
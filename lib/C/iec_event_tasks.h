@@ -0,0 +1,58 @@
+/*
+ * copyright 2008 Edouard TISSERANT
+ * copyright 2011 Mario de Sousa (msousa@fe.up.pt)
+ *
+ * Offered to the public under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/****
+ * The events posted to the SINGLE tasks (iec2c -O E)
+ *
+ * Each task with a SINGLE input gets an entry point, <resource>__<task>_trigger__() (also in the
+ * trigger of its entry in <resource>_tasks__[]), that an interrupt handler or the callback of a
+ * driver may call at any time to post an event to the task. The events are counted, so none is lost.
+ *
+ * The runtime then calls <resource>_run_events__(), which runs the tasks once for each event posted
+ * to them, the highest priority first, and returns the number of tasks it ran. It may do so as soon
+ * as an event was posted (e.g. from a thread woken up by the interrupt handler), so the reaction time
+ * no longer depends on the tick, but never while <resource>_run__() (or another task of the resource)
+ * is running. The events that are still pending on the next tick run the task from <resource>_run__(),
+ * as does the rising edge of the SINGLE input.
+ *
+ * NOTE: This uses the __atomic builtins of gcc (and clang).
+ */
+
+#ifndef _IEC_EVENT_TASKS_H
+#define _IEC_EVENT_TASKS_H
+
+typedef unsigned long __event_task_t;  /* the number of events pending */
+
+/* post an event (may be called from any thread, or from an interrupt handler) */
+static inline void __event_task_post(__event_task_t *events) {
+  __atomic_fetch_add(events, 1, __ATOMIC_RELEASE);
+}
+
+/* take one of the pending events. Returns 0 if there is none. */
+static inline int __event_task_take(__event_task_t *events) {
+  __event_task_t pending = __atomic_load_n(events, __ATOMIC_ACQUIRE);
+  while (pending > 0)
+    if (__atomic_compare_exchange_n(events, &pending, pending - 1, 0, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE)) return 1;
+  return 0;
+}
+
+/* take all the pending events. Returns 0 if there was none. */
+static inline int __event_task_take_all(__event_task_t *events) {
+  return __atomic_exchange_n(events, 0, __ATOMIC_ACQUIRE) > 0;
+}
+
+#endif /* _IEC_EVENT_TASKS_H */
@@ -0,0 +1,96 @@
+/*
+ * copyright 2008 Edouard TISSERANT
+ * copyright 2011 Mario de Sousa (msousa@fe.up.pt)
+ *
+ * Offered to the public under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/****
+ * A copy of the global variables of the configuration per resource (USE_GLOBAL_SNAPSHOTS, iec2c -O G)
+ *
+ * The resources of a configuration share its global variables. With USE_GLOBAL_SNAPSHOTS each
+ * resource instead reads and writes its own copy of every global variable of the configuration,
+ * so the resources may run concurrently (e.g. each on its own thread or core, calling the functions
+ * of config_resource_run__[]) with no lock in their scan. The VAR_EXTERNALs of the PROGRAM and FB
+ * instances of a resource point to the copy of that resource: __GET_GLOBAL_<name>() returns it
+ * while <resource>_init__() runs (config_init__() sets __snapshot_resource__ to the index of the
+ * resource), and returns the global itself otherwise.
+ *
+ * The copies are exchanged with the global at the cycle boundary, by config_exchange__(), called by
+ * config_run__() once all the resources have run, or by the runtime once all its threads are done
+ * with the cycle (and before any of them starts the next one). For each global, the value written
+ * by a resource during the cycle (i.e. its copy differs from the value the copy had at the start of
+ * the cycle) becomes the value of the global, the resources declared last taking precedence when
+ * several of them wrote it. The copies of all the resources then get the value of the global, so
+ * every resource sees the values written during a cycle from the next cycle on.
+ *
+ * Each global has __GLOBAL_SNAPSHOT_RESOURCES pairs of copies, <domain>__<name>__snapshot[r][0] being
+ * the copy resource r works on, and <domain>__<name>__snapshot[r][1] its value at the start of the cycle.
+ *
+ * NOTE: The forcing flags remain those of the global, so a forced global is not written by the
+ *       resources, and its forced value reaches their copies at the next exchange. Likewise a global
+ *       written from outside the program (by the debugger, by restoring the retained values, ...)
+ *       is seen by the resources from the next call to config_exchange__() on.
+ * NOTE: The located globals, whose memory belongs to the runtime, and the global FB instances,
+ *       which have a single state, are not copied and remain shared by the resources.
+ *
+ * This file is included by accessor.h, do not include it directly.
+ */
+
+#ifndef _IEC_GLOBAL_SNAPSHOT_H
+#define _IEC_GLOBAL_SNAPSHOT_H
+
+#include <string.h>
+
+/* __GLOBAL_SNAPSHOT_RESOURCES (the number of resources) and __snapshot_resource__ (the resource being
+ * initialised, -1 if none) are defined in the code generated for the configuration.
+ */
+#define __DECLARE_GLOBAL_SNAPSHOT(type, domain, name)\
+	__RETAIN_SEGMENT __IEC_##type##_t domain##__##name;\
+	__RETAIN_LAYOUT(domain##__##name)\
+	__LAYOUT_GLOBAL(type, domain##__##name)\
+	static __IEC_##type##_t domain##__##name##__snapshot[__GLOBAL_SNAPSHOT_RESOURCES][2];\
+	static __IEC_##type##_t *GLOBAL__##name = &(domain##__##name);\
+	void __INIT_GLOBAL_##name(type value) {\
+		(*GLOBAL__##name).value = value;\
+	}\
+	__DECLARE_GLOBAL_IS_FORCED(domain, name)\
+	type* __GET_GLOBAL_##name(void) {\
+		if (__snapshot_resource__ < 0) return &((*GLOBAL__##name).value);\
+		return &(domain##__##name##__snapshot[__snapshot_resource__][0].value);\
+	}\
+	static void __INIT_GLOBAL_SNAPSHOT_##name(void) {\
+		int r;\
+		for (r = 0; r < __GLOBAL_SNAPSHOT_RESOURCES; r++) {\
+			memcpy(&(domain##__##name##__snapshot[r][0]), GLOBAL__##name, sizeof(*GLOBAL__##name));\
+			memcpy(&(domain##__##name##__snapshot[r][1]), GLOBAL__##name, sizeof(*GLOBAL__##name));\
+		}\
+	}\
+	static void __EXCHANGE_GLOBAL_##name(void) {\
+		int r;\
+		for (r = 0; r < __GLOBAL_SNAPSHOT_RESOURCES; r++)\
+			if (memcmp(&(domain##__##name##__snapshot[r][0].value), &(domain##__##name##__snapshot[r][1].value), sizeof(type)) != 0) {\
+				memcpy(&((*GLOBAL__##name).value), &(domain##__##name##__snapshot[r][0].value), sizeof(type));\
+				__RETAIN_DIRTY((*GLOBAL__##name).value, (*GLOBAL__##name).flags)\
+			}\
+		__INIT_GLOBAL_SNAPSHOT_##name();\
+	}
+
+/* The copies of all the resources get the value of the global (called by config_init__()) */
+#define __INIT_GLOBAL_SNAPSHOT(name)\
+	__INIT_GLOBAL_SNAPSHOT_##name();
+/* The values written by the resources become the value of the global, which the copies then get */
+#define __EXCHANGE_GLOBAL(name)\
+	__EXCHANGE_GLOBAL_##name();
+
+#endif /* _IEC_GLOBAL_SNAPSHOT_H */
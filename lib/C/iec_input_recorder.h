@@ -0,0 +1,289 @@
+/*
+ * copyright 2008 Edouard TISSERANT
+ * copyright 2011 Mario de Sousa (msousa@fe.up.pt)
+ *
+ * Offered to the public under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/****
+ * The recorder of the inputs of each cycle, and their replay (iec2c -O B)
+ *
+ * At the start of each cycle, config_run__() calls __input_recorder_cycle() (the producer), which
+ * appends to a ring buffer a record with the tick, the __CURRENT_TIME, and the values of the %I located
+ * variables that changed since the previous cycle. The generated RECORDER.c has the table of these
+ * variables. A thread of the runtime (the consumer) starts the recording with __input_recorder_start(),
+ * and then writes the records it reads with __input_recorder_read() to a log file, after the header
+ * filled in by __input_recorder_log_header(), e.g.:
+ *   __input_log_header_t header;
+ *   __input_recorder_log_header(&header);
+ *   fwrite(&header, sizeof(header), 1, log);
+ *   __input_recorder_start();
+ *   while (running) {
+ *     unsigned long size = __input_recorder_read(buffer, sizeof(buffer));
+ *     fwrite(buffer, 1, size, log);
+ *     ... sleep a while ...
+ *   }
+ *
+ * The ring buffer has a single producer and a single consumer, like the one of iec_debug_trace.h: the
+ * producer only writes the head and the consumer only writes the tail, each with release semantics.
+ *
+ * Each record is:
+ *   __input_record_t                        the header
+ *   count times:
+ *     uint16_t                              the index of the variable in __input_vars[]
+ *     the value (__input_vars[index].size bytes)
+ * with no padding. A record with __INPUT_RECORD_FULL contains all the inputs. This is the case for the
+ * first record after the recording started, and after records were lost because the ring buffer was full.
+ *
+ * The same program (compiled from the same RECORDER.c, i.e. with the same inputs) replays the log with
+ * __input_replay_open() and __input_replay_next(), which writes the inputs of each record, in order, and
+ * gives the tick and the time to pass to config_run__() (see tests/replay_main.c). The replay does not
+ * depend on the real time, so the cycles may run back to back, and take the same paths as on site.
+ *
+ * The size of the ring buffer may be changed by defining __INPUT_RECORDER_SIZE (a power of 2) when
+ * compiling RECORDER.c.
+ *
+ * NOTE: Only the inputs are recorded: the variables forced from the debugger (other than the located
+ *       inputs themselves, which are recorded once forced), and the state (RETAIN variables) the program
+ *       starts from, are not. The replay starts from the initial values of config_init__().
+ * NOTE: This uses the __atomic builtins of gcc (and clang).
+ */
+
+#ifndef _IEC_INPUT_RECORDER_H
+#define _IEC_INPUT_RECORDER_H
+
+#include <stdint.h>
+#include <string.h>
+
+#ifndef __INPUT_RECORDER_SIZE
+#define __INPUT_RECORDER_SIZE   (256 * 1024)
+#endif
+
+#define __INPUT_LOG_MAGIC    0x52434549UL  /* "IECR" */
+#define __INPUT_LOG_VERSION  1             /* of the layout of the log */
+
+/* flags of __input_record_t */
+#define __INPUT_RECORD_FULL  0x01  /* the record contains all the inputs */
+#define __INPUT_RECORD_LOST  0x02  /* records were lost before this one */
+
+/* the header of the log file */
+typedef struct {
+  uint32_t magic;          /* __INPUT_LOG_MAGIC */
+  uint32_t version;        /* __INPUT_LOG_VERSION */
+  uint32_t layout;         /* hash of the locations and types of the inputs */
+  uint32_t count;          /* of the inputs */
+  uint32_t values_size;    /* of the values of all the inputs */
+  uint32_t reserved;
+} __input_log_header_t;
+
+typedef struct {
+  uint32_t size;           /* of the whole record, including this header */
+  uint16_t flags;
+  uint16_t count;          /* the number of values in the record */
+  uint64_t tick;           /* as passed to config_run__() */
+  int64_t  time;           /* __CURRENT_TIME, in ns */
+} __input_record_t;
+
+/* the %I located variables, in the generated RECORDER.c */
+typedef struct {
+  const char    *location; /* e.g. "%IX0.0" */
+  void         **ptr;      /* the pointer to the variable (e.g. &__IX0_0) */
+  unsigned long  offset;   /* of the previous value in __input_recorder_values[] */
+  unsigned long  size;
+} __input_var_t;
+
+typedef struct {
+  unsigned long  head;     /* only written by the producer */
+  unsigned long  tail;     /* only written by the consumer */
+  unsigned char  data[__INPUT_RECORDER_SIZE];
+  int            recording;  /* only written by the consumer */
+  int            started;    /* only used by the producer */
+  uint16_t       flags;      /* of the next record, only used by the producer */
+} __input_recorder_t;
+
+/* defined in RECORDER.c */
+extern const __input_var_t  __input_vars[];
+extern const unsigned long  __input_vars_count;
+extern const unsigned long  __input_values_size;
+extern const unsigned long  __input_layout;
+extern unsigned char *const  __input_recorder_values;  /* the values of the previous record */
+extern __input_recorder_t   __input_recorder;
+
+
+static inline int64_t __input_time_ns(TIME time) {
+  return (int64_t)__timespec_sec(time) * 1000000000LL + __timespec_nsec(time);
+}
+
+static inline void __input_recorder_write(unsigned long pos, const void *src, unsigned long size) {
+  const unsigned char *bytes = (const unsigned char *)src;
+  for (; size > 0; size--, pos++, bytes++)
+    __input_recorder.data[pos & (__INPUT_RECORDER_SIZE - 1)] = *bytes;
+}
+
+static inline void __input_recorder_read_bytes(unsigned long pos, void *dst, unsigned long size) {
+  unsigned char *bytes = (unsigned char *)dst;
+  for (; size > 0; size--, pos++, bytes++)
+    *bytes = __input_recorder.data[pos & (__INPUT_RECORDER_SIZE - 1)];
+}
+
+
+/* Consumer: the header to write at the start of the log */
+static inline void __input_recorder_log_header(__input_log_header_t *header) {
+  header->magic       = __INPUT_LOG_MAGIC;
+  header->version     = __INPUT_LOG_VERSION;
+  header->layout      = __input_layout;
+  header->count       = __input_vars_count;
+  header->values_size = __input_values_size;
+  header->reserved    = 0;
+}
+
+/* Consumer: record the inputs from the next cycle on (the first record then contains all the inputs) */
+static inline void __input_recorder_start(void) {
+  __atomic_store_n(&__input_recorder.recording, 1, __ATOMIC_RELEASE);
+}
+
+/* Consumer: stop recording from the next cycle on (the records already in the ring buffer may still be read) */
+static inline void __input_recorder_stop(void) {
+  __atomic_store_n(&__input_recorder.recording, 0, __ATOMIC_RELEASE);
+}
+
+/* Consumer: copy the complete records in the ring buffer (that fit in size bytes) to buffer.
+ * Returns the number of bytes copied.
+ */
+static inline unsigned long __input_recorder_read(void *buffer, unsigned long size) {
+  unsigned long tail = __input_recorder.tail;
+  unsigned long head = __atomic_load_n(&__input_recorder.head, __ATOMIC_ACQUIRE);
+  unsigned long copied = 0;
+  while (tail != head) {
+    __input_record_t record;
+    __input_recorder_read_bytes(tail, &record, sizeof(record));
+    if (record.size > size - copied) break;
+    __input_recorder_read_bytes(tail, (unsigned char *)buffer + copied, record.size);
+    copied += record.size;
+    tail   += record.size;
+  }
+  __atomic_store_n(&__input_recorder.tail, tail, __ATOMIC_RELEASE);
+  return copied;
+}
+
+
+/* Producer: called by config_run__() at the start of each cycle */
+static inline void __input_recorder_cycle(unsigned long tick) {
+  __input_record_t record;
+  unsigned long head, free, pos;
+  uint16_t i;
+
+  if (!__atomic_load_n(&__input_recorder.recording, __ATOMIC_ACQUIRE)) {
+    __input_recorder.started = 0;
+    return;
+  }
+  if (!__input_recorder.started) {
+    __input_recorder.flags  |= __INPUT_RECORD_FULL;
+    __input_recorder.started = 1;
+  }
+
+  head = __input_recorder.head;
+  free = __INPUT_RECORDER_SIZE - (head - __atomic_load_n(&__input_recorder.tail, __ATOMIC_ACQUIRE));
+
+  /* write the values after the (not yet known) header */
+  record.tick  = tick;
+  record.time  = __input_time_ns(__CURRENT_TIME);
+  record.flags = __input_recorder.flags;
+  record.count = 0;
+  pos = sizeof(record);
+  if (pos > free) {
+    __input_recorder.flags |= __INPUT_RECORD_FULL | __INPUT_RECORD_LOST;
+    return;
+  }
+  for (i = 0; i < __input_vars_count; i++) {
+    const __input_var_t *var   = &__input_vars[i];
+    unsigned char       *prev  = &__input_recorder_values[var->offset];
+    void                *value = *var->ptr;
+    if (!(record.flags & __INPUT_RECORD_FULL) && (memcmp(prev, value, var->size) == 0)) continue;
+    if (pos + sizeof(i) + var->size > free) {
+      /* the ring buffer is full => drop this record. The next one must contain all the inputs. */
+      __input_recorder.flags |= __INPUT_RECORD_FULL | __INPUT_RECORD_LOST;
+      return;
+    }
+    memcpy(prev, value, var->size);
+    __input_recorder_write(head + pos, &i, sizeof(i));
+    __input_recorder_write(head + pos + sizeof(i), value, var->size);
+    pos += sizeof(i) + var->size;
+    record.count++;
+  }
+
+  /* a record is written even when no input changed, as the tick and the time did */
+  record.size = pos;
+  __input_recorder_write(head, &record, sizeof(record));
+  __input_recorder.flags = 0;
+  __atomic_store_n(&__input_recorder.head, head + pos, __ATOMIC_RELEASE);
+}
+
+
+/* Replay: the position in a log, read into memory */
+typedef struct {
+  const unsigned char *log;
+  unsigned long        size;
+  unsigned long        pos;
+} __input_replay_t;
+
+/* Replay: start reading the log.
+ * Returns -1 if it is not a log of the inputs of this program (i.e. of the RECORDER.c it is compiled with).
+ */
+static inline int __input_replay_open(__input_replay_t *replay, const void *log, unsigned long size) {
+  __input_log_header_t header;
+  if (size < sizeof(header)) return -1;
+  memcpy(&header, log, sizeof(header));
+  if ((__INPUT_LOG_MAGIC != header.magic) || (__INPUT_LOG_VERSION != header.version) ||
+      (__input_layout != header.layout) || (__input_vars_count != header.count))
+    return -1;
+  replay->log  = (const unsigned char *)log;
+  replay->size = size;
+  replay->pos  = sizeof(header);
+  return 0;
+}
+
+/* Replay: write the inputs of the next record, and get its tick and time (and its flags, if flags is not NULL).
+ * Returns 1, or 0 at the end of the log (including a last record cut short), or -1 if the record is not valid.
+ */
+static inline int __input_replay_next(__input_replay_t *replay, unsigned long *tick, TIME *time, unsigned int *flags) {
+  __input_record_t record;
+  unsigned long pos, end;
+  uint16_t i, index;
+
+  if (replay->size - replay->pos < sizeof(record)) return 0;
+  memcpy(&record, replay->log + replay->pos, sizeof(record));
+  if (record.size < sizeof(record)) return -1;
+  if (replay->size - replay->pos < record.size) return 0;
+  pos = replay->pos + sizeof(record);
+  end = replay->pos + record.size;
+
+  for (i = 0; i < record.count; i++) {
+    const __input_var_t *var;
+    if (end - pos < sizeof(index)) return -1;
+    memcpy(&index, replay->log + pos, sizeof(index));
+    if (index >= __input_vars_count) return -1;
+    var = &__input_vars[index];
+    if (end - pos - sizeof(index) < var->size) return -1;
+    memcpy(*var->ptr, replay->log + pos + sizeof(index), var->size);
+    pos += sizeof(index) + var->size;
+  }
+
+  replay->pos = end;
+  *tick = record.tick;
+  *time = __timespec(record.time / 1000000000LL, record.time % 1000000000LL);
+  if (NULL != flags) *flags = record.flags;
+  return 1;
+}
+
+#endif /* _IEC_INPUT_RECORDER_H */
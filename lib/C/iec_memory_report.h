@@ -0,0 +1,266 @@
+/*
+ * copyright 2008 Edouard TISSERANT
+ * copyright 2011 Mario de Sousa (msousa@fe.up.pt)
+ *
+ * Offered to the public under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/****
+ * The memory report (iec2c -O M)
+ *
+ * The MEMORY_REPORT.c generated by iec2c has a table of the FUNCTION_BLOCK and PROGRAM types, with
+ * the offset and size of each variable of their instances, a table of the global variables, and a
+ * table of the PROGRAM instances, along with their resource and task. All the sizes and offsets are
+ * given by sizeof() and offsetof(), so they are those of the C compiler (and target ABI) that
+ * compiles MEMORY_REPORT.c.
+ *
+ * __memory_report() writes the report in JSON, with for every type, global variable and instance:
+ *    size    : sizeof() the variable or instance
+ *    flags   : the bytes taken by the flags of the variables (forcing, retain), and by the pointers
+ *              to their forced values (VAR_EXTERNAL and located variables), including padding
+ *    retain  : the bytes of the values of the RETAIN variables
+ *    located : the bytes of the memory of the runtime the located variables point to (the I/O)
+ *    other   : (types only) the bytes not in any variable, i.e. the padding between them and the
+ *              internal variables of the SFCs
+ * The flags, retain and located bytes of a type include those of the instances of the other
+ * FUNCTION_BLOCKs it contains (but not of those of the standard FBs, which are not described).
+ * The report ends with the totals of each task, each resource, and of the whole configuration.
+ *
+ * To get the report on the build host, compile MEMORY_REPORT.c with MEMORY_REPORT_MAIN defined,
+ * which adds a main() writing it to stdout. For another target, compile it with the cross compiler,
+ * and call __memory_report() from the runtime.
+ *
+ * This file is included by MEMORY_REPORT.c, do not include it directly.
+ */
+
+#ifndef _IEC_MEMORY_REPORT_H
+#define _IEC_MEMORY_REPORT_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+
+#define __MEMORY_VALUE     0
+#define __MEMORY_FB        1
+#define __MEMORY_EXTERNAL  2
+#define __MEMORY_LOCATED   3
+
+typedef struct {
+  const char *name;
+  const char *type;
+  const char *resource;   /* the resource of a global variable, NULL for the configuration (and for the variables of the POUs) */
+  unsigned int kind;      /* __MEMORY_VALUE, __MEMORY_FB, __MEMORY_EXTERNAL or __MEMORY_LOCATED */
+  unsigned long offset;   /* in the instance (variables of the POUs only) */
+  unsigned long size;
+  unsigned long flags;
+  int retain;
+  unsigned long located;
+} __memory_var_t;
+
+typedef struct {
+  const char *name;
+  const char *kind;       /* "FUNCTION_BLOCK" or "PROGRAM" */
+  unsigned long size;
+  unsigned long count;
+  const __memory_var_t *vars;
+} __memory_type_t;
+
+typedef struct {
+  const char *name;       /* the name of the instance in the generated C code (e.g. RESOURCE1__INSTANCE0) */
+  const char *type;
+  const char *resource;
+  const char *task;       /* NULL for the programs not associated to any task */
+  unsigned long size;
+  int retain;
+} __memory_instance_t;
+
+/* The variables of the FUNCTION_BLOCKs and PROGRAMs */
+#define __MEMORY_MEMBER(pou, name)  (((pou *)0)->name)
+#define __MEMORY_VAR(pou, name, type, kind, retain)\
+	{#name, #type, NULL, kind, offsetof(pou, name), sizeof(__MEMORY_MEMBER(pou, name)),\
+	 sizeof(__MEMORY_MEMBER(pou, name)) - sizeof(__MEMORY_MEMBER(pou, name).value), retain, 0}
+#define __MEMORY_FB_VAR(pou, name, type, kind, retain)\
+	{#name, #type, NULL, kind, offsetof(pou, name), sizeof(__MEMORY_MEMBER(pou, name)), 0, retain, 0}
+#define __MEMORY_LOCATED_VAR(pou, name, type)\
+	{#name, #type, NULL, __MEMORY_LOCATED, offsetof(pou, name), sizeof(__MEMORY_MEMBER(pou, name)),\
+	 sizeof(__MEMORY_MEMBER(pou, name)) - sizeof(__MEMORY_MEMBER(pou, name).value), 0, sizeof(type)}
+
+/* The global variables, declared with the macros of accessor.h */
+#define __MEMORY_GLOBAL(resource, domain, name, type, retain)\
+	{#domain "__" #name, #type, resource, __MEMORY_VALUE, 0, sizeof(__IEC_##type##_t), sizeof(__IEC_##type##_t) - sizeof(type), retain, 0}
+#define __MEMORY_GLOBAL_FB(resource, domain, name, type, retain)\
+	{#domain "__" #name, #type, resource, __MEMORY_FB, 0, sizeof(type), 0, retain, 0}
+#define __MEMORY_GLOBAL_LOCATED(resource, domain, name, type)\
+	{#domain "__" #name, #type, resource, __MEMORY_LOCATED, 0, sizeof(__IEC_##type##_p), sizeof(__IEC_##type##_p) - sizeof(type *), 0, sizeof(type)}
+/* a located global variable without a name is only the memory of the runtime */
+#define __MEMORY_GLOBAL_LOCATION(resource, location, type)\
+	{#location, #type, resource, __MEMORY_LOCATED, 0, 0, 0, 0, sizeof(type)}
+
+#define __MEMORY_INSTANCE(resource, name, type, task, retain)\
+	{#resource "__" #name, #type, #resource, task, sizeof(type), retain}
+
+
+typedef struct {
+  unsigned long size;
+  unsigned long flags;
+  unsigned long retain;
+  unsigned long located;
+} __memory_totals_t;
+
+static inline const __memory_type_t *__memory_find_type(const __memory_type_t *types, const char *name) {
+  for (; NULL != types->name; types++)
+    if (0 == strcmp(types->name, name)) return types;
+  return NULL;
+}
+
+/* Add the flags, retain and located bytes of an instance of the type (the size is not added) */
+static inline void __memory_add_type(const __memory_type_t *types, const __memory_type_t *type, int retain, __memory_totals_t *totals) {
+  unsigned long i;
+  for (i = 0; i < type->count; i++) {
+    const __memory_var_t *var = &type->vars[i];
+    const __memory_type_t *fb = (__MEMORY_FB == var->kind)? __memory_find_type(types, var->type) : NULL;
+    totals->flags   += var->flags;
+    totals->located += var->located;
+    if (NULL != fb) __memory_add_type(types, fb, retain || var->retain, totals);
+    else if ((retain || var->retain) && ((__MEMORY_VALUE == var->kind) || (__MEMORY_FB == var->kind))) totals->retain += var->size - var->flags;
+  }
+}
+
+static inline void __memory_add_var(const __memory_type_t *types, const __memory_var_t *var, __memory_totals_t *totals) {
+  const __memory_type_t *fb = (__MEMORY_FB == var->kind)? __memory_find_type(types, var->type) : NULL;
+  totals->size    += var->size;
+  totals->flags   += var->flags;
+  totals->located += var->located;
+  if (NULL != fb) __memory_add_type(types, fb, var->retain, totals);
+  else if (var->retain && ((__MEMORY_VALUE == var->kind) || (__MEMORY_FB == var->kind))) totals->retain += var->size - var->flags;
+}
+
+static inline void __memory_add_instance(const __memory_type_t *types, const __memory_instance_t *instance, __memory_totals_t *totals) {
+  const __memory_type_t *type = __memory_find_type(types, instance->type);
+  totals->size += instance->size;
+  if (NULL != type) __memory_add_type(types, type, instance->retain, totals);
+}
+
+static inline void __memory_print_totals(FILE *file, const __memory_totals_t *totals) {
+  fprintf(file, "\"size\": %lu, \"flags\": %lu, \"retain\": %lu, \"located\": %lu",
+          totals->size, totals->flags, totals->retain, totals->located);
+}
+
+static inline void __memory_print_string(FILE *file, const char *str) {
+  if (NULL == str) fprintf(file, "null");
+  else             fprintf(file, "\"%s\"", str);
+}
+
+static inline int __memory_same_string(const char *str1, const char *str2) {
+  if ((NULL == str1) || (NULL == str2)) return str1 == str2;
+  return 0 == strcmp(str1, str2);
+}
+
+static inline void __memory_print_var(FILE *file, const __memory_type_t *types, const __memory_var_t *var, int in_pou) {
+  static const char *kinds[] = {"value", "fb", "external", "located"};
+  __memory_totals_t totals = {0, 0, 0, 0};
+  __memory_add_var(types, var, &totals);
+  fprintf(file, "{\"name\": \"%s\", \"type\": \"%s\", \"kind\": \"%s\", ", var->name, var->type, kinds[var->kind]);
+  if (in_pou) fprintf(file, "\"offset\": %lu, ", var->offset);
+  else       {fprintf(file, "\"resource\": "); __memory_print_string(file, var->resource); fprintf(file, ", ");}
+  __memory_print_totals(file, &totals);
+  fprintf(file, "}");
+}
+
+/* Write the report, in JSON, given the (NULL terminated) tables of MEMORY_REPORT.c */
+static inline void __memory_report_json(FILE *file, const __memory_type_t *types, const __memory_var_t *globals, const __memory_instance_t *instances) {
+  __memory_totals_t total = {0, 0, 0, 0};
+  const __memory_type_t *type;
+  const __memory_var_t *var;
+  const __memory_instance_t *instance, *other;
+  unsigned long i;
+
+  fprintf(file, "{\n  \"types\": [");
+  for (type = types; NULL != type->name; type++) {
+    __memory_totals_t totals = {0, 0, 0, 0};
+    unsigned long vars_size = 0;
+    totals.size = type->size;
+    __memory_add_type(types, type, 0, &totals);
+    for (i = 0; i < type->count; i++) vars_size += type->vars[i].size;
+    fprintf(file, "%s\n    {\"name\": \"%s\", \"kind\": \"%s\", ", (type == types)? "" : ",", type->name, type->kind);
+    __memory_print_totals(file, &totals);
+    fprintf(file, ", \"other\": %lu, \"variables\": [", type->size - vars_size);
+    for (i = 0; i < type->count; i++) {
+      fprintf(file, "%s\n      ", (0 == i)? "" : ",");
+      __memory_print_var(file, types, &type->vars[i], 1);
+    }
+    fprintf(file, "]}");
+  }
+
+  fprintf(file, "],\n  \"globals\": [");
+  for (var = globals; NULL != var->name; var++) {
+    fprintf(file, "%s\n    ", (var == globals)? "" : ",");
+    __memory_print_var(file, types, var, 0);
+    __memory_add_var(types, var, &total);
+  }
+
+  fprintf(file, "],\n  \"instances\": [");
+  for (instance = instances; NULL != instance->name; instance++) {
+    __memory_totals_t totals = {0, 0, 0, 0};
+    __memory_add_instance(types, instance, &totals);
+    __memory_add_instance(types, instance, &total);
+    fprintf(file, "%s\n    {\"name\": \"%s\", \"type\": \"%s\", \"resource\": \"%s\", \"task\": ",
+            (instance == instances)? "" : ",", instance->name, instance->type, instance->resource);
+    __memory_print_string(file, instance->task);
+    fprintf(file, ", ");
+    __memory_print_totals(file, &totals);
+    fprintf(file, "}");
+  }
+
+  /* the programs of each task, in the order the tasks first appear */
+  fprintf(file, "],\n  \"tasks\": [");
+  for (instance = instances; NULL != instance->name; instance++) {
+    __memory_totals_t totals = {0, 0, 0, 0};
+    unsigned long count = 0;
+    for (other = instances; other < instance; other++)
+      if (__memory_same_string(other->resource, instance->resource) && __memory_same_string(other->task, instance->task)) break;
+    if (other < instance) continue;
+    for (other = instance; NULL != other->name; other++)
+      if (__memory_same_string(other->resource, instance->resource) && __memory_same_string(other->task, instance->task)) {
+        __memory_add_instance(types, other, &totals);
+        count++;
+      }
+    fprintf(file, "%s\n    {\"resource\": \"%s\", \"name\": ", (instance == instances)? "" : ",", instance->resource);
+    __memory_print_string(file, instance->task);
+    fprintf(file, ", \"instances\": %lu, ", count);
+    __memory_print_totals(file, &totals);
+    fprintf(file, "}");
+  }
+
+  /* the global variables and programs of each resource */
+  fprintf(file, "],\n  \"resources\": [");
+  for (instance = instances, i = 0; NULL != instance->name; instance++) {
+    __memory_totals_t totals = {0, 0, 0, 0};
+    for (other = instances; other < instance; other++)
+      if (__memory_same_string(other->resource, instance->resource)) break;
+    if (other < instance) continue;
+    for (var = globals; NULL != var->name; var++)
+      if (__memory_same_string(var->resource, instance->resource)) __memory_add_var(types, var, &totals);
+    for (other = instance; NULL != other->name; other++)
+      if (__memory_same_string(other->resource, instance->resource)) __memory_add_instance(types, other, &totals);
+    fprintf(file, "%s\n    {\"name\": \"%s\", ", (0 == i++)? "" : ",", instance->resource);
+    __memory_print_totals(file, &totals);
+    fprintf(file, "}");
+  }
+
+  fprintf(file, "],\n  \"total\": {");
+  __memory_print_totals(file, &total);
+  fprintf(file, "}\n}\n");
+}
+
+#endif /* _IEC_MEMORY_REPORT_H */
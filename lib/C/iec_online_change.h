@@ -0,0 +1,191 @@
+/*
+ * copyright 2008 Edouard TISSERANT
+ * copyright 2011 Mario de Sousa (msousa@fe.up.pt)
+ *
+ * Offered to the public under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/****
+ * The online change (USE_ONLINE_CHANGE, iec2c -O L)
+ *
+ * Every FUNCTION_BLOCK and PROGRAM has a descriptor of the layout of its instances, <pou>_layout__
+ * (__layout_t), with an entry (__layout_field_t) for each of its variables: its name, type, offset,
+ * size, and kind:
+ *    __LAYOUT_VALUE   : a variable holding its value (elementary, ARRAY, STRUCT, ...)
+ *    __LAYOUT_FB      : an FB instance, described by the layout of its FB (NULL for the standard FBs)
+ *    __LAYOUT_POINTER : a VAR_EXTERNAL or a located variable, i.e. a pointer set by the initialisation
+ * The version of a layout is a hash of the name, type and kind of all its variables (computed by iec2c),
+ * so it changes whenever the variables of the POU are changed.
+ *
+ * The global variables and the PROGRAM instances (what makes up the state of the PLC) each have an entry
+ * (__layout_instance_t) in the 'iec_layout' section, which the linker lays out as an array, returned by
+ * the config_layout__() generated with the configuration.
+ *
+ * To replace the running program by a new version of it (e.g. a shared object loaded with dlopen())
+ * between two cycles, the runtime:
+ *    1. calls config_init__() of the new version, so all its variables have their initial values;
+ *    2. calls __online_change() with the tables returned by config_layout__() of both versions, which
+ *       copies the state of the old version into the new one, variable by variable;
+ *    3. from the next cycle on, calls config_run__() of the new version (and may then unload the old one).
+ * A variable only gets the value it had in the old version if it still exists (a global variable or
+ * PROGRAM instance with the same name, a variable of the instance with the same name) with the same
+ * type, kind and size, and the same declaration of its type. The others keep their initial value.
+ * The pointers (VAR_EXTERNAL and located variables) are never copied: they keep pointing to the
+ * variables of the new version, as set by its config_init__().
+ *
+ * NOTE: The internal variables of the SFCs are not migrated, so the SFCs start again from their
+ *       initial step.
+ * NOTE: The instances of the standard FBs are copied as a whole, except with USE_TIMER_WHEEL
+ *       (iec2c -O w), where the timers hold pointers to the wheel: they are then restarted.
+ * NOTE: The global variables are only checked by their name, type and size (as in iec_retain.h).
+ * NOTE: The __start_<section> and __stop_<section> symbols are defined by the GNU linker (and
+ *       compatible ones). Other targets must define them in their linker script.
+ *
+ * This file is included by accessor.h. The runtime may include it too, for __online_change().
+ */
+
+#ifndef _IEC_ONLINE_CHANGE_H
+#define _IEC_ONLINE_CHANGE_H
+
+#include <stddef.h>
+#include <string.h>
+
+#define __LAYOUT_VALUE    0
+#define __LAYOUT_FB       1
+#define __LAYOUT_POINTER  2
+
+typedef struct __layout_s __layout_t;
+
+typedef struct {
+  const char *name;             /* the name of the variable */
+  const char *type;             /* the name of its type in the generated C code */
+  unsigned long long type_hash; /* a hash of the declaration of its type, 0 for the elementary types and the FBs */
+  unsigned long offset;
+  unsigned long size;
+  unsigned int kind;            /* __LAYOUT_VALUE, __LAYOUT_FB or __LAYOUT_POINTER */
+  const __layout_t *layout;     /* the layout of the FB (__LAYOUT_FB only, NULL for the standard FBs) */
+} __layout_field_t;
+
+struct __layout_s {
+  const char *name;             /* the name of the FUNCTION_BLOCK or PROGRAM */
+  unsigned long long version;
+  unsigned long size;           /* sizeof() the instances */
+  unsigned long count;
+  const __layout_field_t *fields;
+};
+
+/* A global variable or a PROGRAM instance */
+typedef struct {
+  const char *name;             /* the name of the variable in the generated C code (e.g. RESOURCE1__INSTANCE0) */
+  const char *type;
+  void *ptr;
+  unsigned long size;
+  unsigned int kind;            /* __LAYOUT_VALUE or __LAYOUT_FB */
+  const __layout_t *layout;     /* the layout of the PROGRAM or FB, NULL for the other variables */
+} __layout_instance_t;
+
+#define __LAYOUT_FIELD(pou, name, type, kind, type_hash, layout)\
+	{#name, type, type_hash, offsetof(pou, name), sizeof(((pou *)0)->name), kind, layout}
+
+/* NOTE: the explicit alignment stops the C compiler from aligning the entries on a larger boundary
+ *       than their size, which would leave holes in the array the linker builds with them.
+ */
+#define __LAYOUT_ENTRY(name, type, kind, layout)\
+	static const __layout_instance_t __layout_instance__##name\
+		__attribute__((section("iec_layout"), used, aligned(sizeof(void *)))) =\
+		{#name, #type, &(name), sizeof(name), kind, layout};
+#define __LAYOUT_INSTANCE(type, name)\
+	__LAYOUT_ENTRY(name, type, __LAYOUT_FB, &type##_layout__)
+#define __LAYOUT_GLOBAL(type, name)\
+	__LAYOUT_ENTRY(name, type, __LAYOUT_VALUE, NULL)
+/* the layout is a weak reference, which is NULL for the standard FBs (so the layouts are never static, even with iec2c -O g) */
+#define __LAYOUT_GLOBAL_FB(type, name)\
+	extern const __layout_t type##_layout__ __attribute__((weak));\
+	__LAYOUT_ENTRY(name, type, __LAYOUT_FB, &type##_layout__)
+
+/* weak, so a program without any entry still links */
+extern const __layout_instance_t __start_iec_layout[] __attribute__((weak));
+extern const __layout_instance_t __stop_iec_layout[]  __attribute__((weak));
+
+/* The entries of the global variables and PROGRAM instances, in no particular order */
+static inline const __layout_instance_t *__layout_instances(unsigned long *count) {
+  *count = __stop_iec_layout - __start_iec_layout;
+  return __start_iec_layout;
+}
+
+
+/* Copy, if possible, the value of a variable (or FB instance) of the old version into the new one.
+ * Returns the number of variables that kept their initial value.
+ */
+static inline unsigned long __layout_migrate(const __layout_t *old_layout, const void *old_data,
+                                             const __layout_t *new_layout, void *new_data);
+
+static inline unsigned long __layout_migrate_value(const char *old_type, unsigned int old_kind, const __layout_t *old_layout, unsigned long old_size, const void *old_data,
+                                                   const char *new_type, unsigned int new_kind, const __layout_t *new_layout, unsigned long new_size, void *new_data) {
+  if ((old_kind != new_kind) || (0 != strcmp(old_type, new_type))) return 1;
+  if (__LAYOUT_POINTER == new_kind) return 0;  /* nothing to do */
+  if (__LAYOUT_FB == new_kind) {
+    if ((NULL != old_layout) && (NULL != new_layout))
+      return __layout_migrate(old_layout, old_data, new_layout, new_data);
+    if ((NULL != old_layout) || (NULL != new_layout)) return 1;
+#ifdef USE_TIMER_WHEEL
+    return 1;  /* a standard FB, maybe linked in the timer wheel */
+#endif
+  }
+  if (old_size != new_size) return 1;
+  memcpy(new_data, old_data, new_size);
+  return 0;
+}
+
+static inline unsigned long __layout_migrate(const __layout_t *old_layout, const void *old_data,
+                                             const __layout_t *new_layout, void *new_data) {
+  unsigned long i, j, lost = 0;
+  /* the same variables, in the same order? */
+  int same = (old_layout->version == new_layout->version) && (old_layout->count == new_layout->count);
+
+  for (i = 0; i < new_layout->count; i++) {
+    const __layout_field_t *new_field = &new_layout->fields[i], *old_field = NULL;
+    if (__LAYOUT_POINTER == new_field->kind) continue;
+    if (same) old_field = &old_layout->fields[i];
+    else
+      for (j = 0; j < old_layout->count; j++)
+        if (0 == strcmp(old_layout->fields[j].name, new_field->name)) {old_field = &old_layout->fields[j]; break;}
+    if ((NULL == old_field) || (old_field->type_hash != new_field->type_hash)) {lost++; continue;}
+    lost += __layout_migrate_value(old_field->type, old_field->kind, old_field->layout, old_field->size, (const char *)old_data + old_field->offset,
+                                   new_field->type, new_field->kind, new_field->layout, new_field->size, (char *)new_data + new_field->offset);
+  }
+  return lost;
+}
+
+
+/* Copy the state of the old version of the program (the global variables and PROGRAM instances listed
+ * by its config_layout__()) into the new one, which must have been initialised already.
+ * Returns the number of variables that kept their initial value, 0 if the whole state was migrated.
+ * NOTE: must be called between two cycles, with none of the resources running.
+ */
+static inline unsigned long __online_change(const __layout_instance_t *old_instances, unsigned long old_count,
+                                            const __layout_instance_t *new_instances, unsigned long new_count) {
+  unsigned long i, j, lost = 0;
+
+  for (i = 0; i < new_count; i++) {
+    const __layout_instance_t *new_instance = &new_instances[i], *old_instance = NULL;
+    for (j = 0; j < old_count; j++)
+      if (0 == strcmp(old_instances[j].name, new_instance->name)) {old_instance = &old_instances[j]; break;}
+    if (NULL == old_instance) {lost++; continue;}
+    lost += __layout_migrate_value(old_instance->type, old_instance->kind, old_instance->layout, old_instance->size, old_instance->ptr,
+                                   new_instance->type, new_instance->kind, new_instance->layout, new_instance->size, new_instance->ptr);
+  }
+  return lost;
+}
+
+#endif /* _IEC_ONLINE_CHANGE_H */
@@ -0,0 +1,167 @@
+/*
+ * copyright 2008 Edouard TISSERANT
+ * copyright 2011 Mario de Sousa (msousa@fe.up.pt)
+ *
+ * Offered to the public under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/****
+ * The parallel networks of the PROGRAMs (USE_PARALLEL_NETWORKS, iec2c -O N)
+ *
+ * The body of a PROGRAM written in ST is split by the compiler into networks, i.e. groups of statements
+ * that access no variable written by another network (see stage3/independent_networks_analysis.hh).
+ * With iec2c -O N, each network of a PROGRAM with more than one is placed in its own function, and the
+ * PROGRAM body runs these functions with __parallel_run(), which hands them to the workers of the pool
+ * of the current resource, and returns once all of them ran. The statements of each network still run
+ * in their original order, on a single thread.
+ *
+ * Each resource has its own pool, <resource>_parallel_pool__, with __PARALLEL_WORKERS threads, started
+ * by <resource>_init__(). The entry points of the resource (<resource>_init__(), <resource>_run__() and
+ * the task run functions) make their pool the current pool of the calling thread, __current_parallel_pool.
+ * The thread calling __parallel_run() also runs networks, so a pool of n workers runs up to n + 1 networks
+ * concurrently. When the pool is already in use (e.g. by the task of the resource running on another
+ * thread), or there is no current pool, the networks simply run one after the other.
+ *
+ * With USE_RESOURCE_CONTEXT the workers run the networks in the context of the resource that called
+ * __parallel_run(), so they read the same current time and debug flag.
+ *
+ * NOTE: This uses POSIX threads (link the runtime with -lpthread), and the __atomic builtins of gcc
+ *       (and clang). The workers never stop, nor are their priority and CPU affinity changed (a runtime
+ *       may do so from the threads[] of the pool, after <resource>_init__()).
+ *
+ * This file is included by iec_std_lib.h, do not include it directly.
+ */
+
+#ifndef _IEC_PARALLEL_H
+#define _IEC_PARALLEL_H
+
+#include <pthread.h>
+
+#ifndef __PARALLEL_WORKERS
+#define __PARALLEL_WORKERS 3
+#endif
+
+typedef void (*__parallel_network_t)(void *data);
+
+typedef struct {
+  pthread_t             threads[__PARALLEL_WORKERS];
+  int                   started;
+  pthread_mutex_t       lock;
+  pthread_mutex_t       in_use;      /* taken by the thread running networks in the pool */
+  pthread_cond_t        start;       /* a new generation of networks was handed to the workers */
+  pthread_cond_t        done;        /* the networks of the generation all ran, or a worker left it */
+  unsigned long         generation;
+  __parallel_network_t *networks;
+  void                 *data;
+  int                   count;
+  int                   next;        /* the next network to run */
+  int                   pending;     /* the networks not yet run */
+  int                   busy;        /* the workers taking networks of the current generation */
+#ifdef USE_RESOURCE_CONTEXT
+  __resource_context_t *context;
+#endif
+} __parallel_pool_t;
+
+/* defined in the code generated for the configuration, set by the resources' entry points */
+extern __thread __parallel_pool_t *__current_parallel_pool;
+
+/* run the networks of the current generation, until none is left */
+static inline void __parallel_take(__parallel_pool_t *pool, __parallel_network_t *networks, void *data, int count) {
+  int i;
+  while ((i = __atomic_fetch_add(&pool->next, 1, __ATOMIC_ACQUIRE)) < count) {
+    networks[i](data);
+    if (__atomic_sub_fetch(&pool->pending, 1, __ATOMIC_ACQ_REL) == 0) {
+      pthread_mutex_lock(&pool->lock);
+      pthread_cond_broadcast(&pool->done);
+      pthread_mutex_unlock(&pool->lock);
+    }
+  }
+}
+
+static void *__parallel_worker(void *arg) {
+  __parallel_pool_t    *pool = (__parallel_pool_t *)arg;
+  unsigned long         generation = 0;
+  __parallel_network_t *networks;
+  void                 *data;
+  int                   count;
+
+  pthread_mutex_lock(&pool->lock);
+  for (;;) {
+    while (pool->generation == generation) pthread_cond_wait(&pool->start, &pool->lock);
+    generation = pool->generation;
+    networks   = pool->networks;
+    data       = pool->data;
+    count      = pool->count;
+#ifdef USE_RESOURCE_CONTEXT
+    __current_resource_context = pool->context;
+#endif
+    pool->busy++;
+    pthread_mutex_unlock(&pool->lock);
+
+    __parallel_take(pool, networks, data, count);
+
+    pthread_mutex_lock(&pool->lock);
+    /* the next generation may only start once no worker may still take a network of this one */
+    if (--pool->busy == 0) pthread_cond_broadcast(&pool->done);
+  }
+  return NULL;
+}
+
+/* start the workers of the pool (called by <resource>_init__(), only the first call starts them) */
+static inline void __parallel_pool_start(__parallel_pool_t *pool) {
+  int i;
+  if (pool->started) return;
+  pthread_mutex_init(&pool->lock, NULL);
+  pthread_mutex_init(&pool->in_use, NULL);
+  pthread_cond_init(&pool->start, NULL);
+  pthread_cond_init(&pool->done, NULL);
+  pool->generation = 0;
+  pool->busy = 0;
+  pool->started = 0;
+  for (i = 0; i < __PARALLEL_WORKERS; i++)
+    if (pthread_create(&pool->threads[i], NULL, __parallel_worker, pool) == 0) pool->started++;
+}
+
+/* run the count networks, each with the given data, and return once all of them ran */
+static inline void __parallel_run(__parallel_network_t *networks, void *data, int count) {
+  __parallel_pool_t *pool = __current_parallel_pool;
+  int i;
+
+  if ((NULL == pool) || (0 == pool->started) || (count < 2) || (pthread_mutex_trylock(&pool->in_use) != 0)) {
+    for (i = 0; i < count; i++) networks[i](data);
+    return;
+  }
+
+  pthread_mutex_lock(&pool->lock);
+  while (pool->busy > 0) pthread_cond_wait(&pool->done, &pool->lock);
+  pool->networks = networks;
+  pool->data     = data;
+  pool->count    = count;
+  pool->next     = 0;
+  pool->pending  = count;
+#ifdef USE_RESOURCE_CONTEXT
+  pool->context  = __current_resource_context;
+#endif
+  pool->generation++;
+  pthread_cond_broadcast(&pool->start);
+  pthread_mutex_unlock(&pool->lock);
+
+  __parallel_take(pool, networks, data, count);
+
+  pthread_mutex_lock(&pool->lock);
+  while (__atomic_load_n(&pool->pending, __ATOMIC_ACQUIRE) > 0) pthread_cond_wait(&pool->done, &pool->lock);
+  pthread_mutex_unlock(&pool->lock);
+  pthread_mutex_unlock(&pool->in_use);
+}
+
+#endif /* _IEC_PARALLEL_H */
@@ -0,0 +1,62 @@
+/*
+ * copyright 2008 Edouard TISSERANT
+ * copyright 2011 Mario de Sousa (msousa@fe.up.pt)
+ *
+ * Offered to the public under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/****
+ * The process images of the located variables (iec2c -O q)
+ *
+ * The located variables of each area (%I, %Q and %M) are the members of a single struct, the
+ * process image of the area, defined in the generated PROCESS_IMAGE.c. The I/O driver may then
+ * copy all the inputs to __PROCESS_IMAGE_I before a cycle, and all the outputs from
+ * __PROCESS_IMAGE_Q after it, with a single memcpy() (or DMA transfer) per area.
+ *
+ * The table of each image gives the location, offset and size of each of its variables, so the
+ * driver can map them to the I/O of the fieldbus.
+ *
+ * NOTE: PROCESS_IMAGE.c also defines the pointers to the located variables (e.g. __IX0_0) used by
+ *       the generated code, so the runtime must not define them too (i.e. its __LOCATED_VAR()
+ *       macro, used with LOCATED_VARIABLES.h, must not define any variable).
+ */
+
+#ifndef _IEC_PROCESS_IMAGE_H
+#define _IEC_PROCESS_IMAGE_H
+
+typedef struct {
+  const char *location;  /* e.g. "%IX0.0" */
+  unsigned long offset;  /* in the process image */
+  unsigned long size;
+} __process_image_var_t;
+
+typedef struct {
+  char area;             /* 'I', 'Q' or 'M' */
+  void *image;
+  unsigned long size;
+  const __process_image_var_t *vars;
+  unsigned long count;
+} __process_image_t;
+
+/* defined in the generated PROCESS_IMAGE.c. Only the areas with located variables have a process image. */
+extern const __process_image_t __process_images[];
+extern const unsigned long __process_images_count;
+
+static inline const __process_image_t *__process_image(char area) {
+  unsigned long i;
+  for (i = 0; i < __process_images_count; i++)
+    if (__process_images[i].area == area) return &__process_images[i];
+  return (const __process_image_t *)0;
+}
+
+#endif /* _IEC_PROCESS_IMAGE_H */
@@ -0,0 +1,92 @@
+/*
+ * copyright 2008 Edouard TISSERANT
+ * copyright 2011 Mario de Sousa (msousa@fe.up.pt)
+ *
+ * Offered to the public under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/****
+ * The execution time profile of the POUs (USE_POU_PROFILE, iec2c -O o)
+ *
+ * The body of every FUNCTION, FUNCTION_BLOCK and PROGRAM reads a timestamp when it starts and
+ * when it ends, and adds the time it took to the counters of its POU type (__profile_pou_t).
+ * The 'total' time includes the time spent in the POUs it called, the 'self' time does not.
+ *
+ * The timestamps are read with __profile_now(), which the runtime must define, e.g. returning
+ * the cycle counter of the CPU, or the time in ns given by clock_gettime(CLOCK_MONOTONIC).
+ * The counters are in the unit of __profile_now().
+ *
+ * The counters of all the POU types are placed by the C compiler in the 'iec_profile' section,
+ * which the linker lays out as an array (returned by __profile_table()).
+ *
+ * NOTE: The FUNCTIONs defined as static inline in their header (iec2c -O i=n) are not profiled.
+ * NOTE: Not atomic. The resources must not be run in parallel (e.g. on separate threads) when profiling.
+ * NOTE: The __start_<section> and __stop_<section> symbols are defined by the GNU linker (and
+ *       compatible ones). Other targets must define them in their linker script.
+ *
+ * This file is included by iec_std_lib.h, do not include it directly.
+ */
+
+#ifndef _IEC_PROFILE_H
+#define _IEC_PROFILE_H
+
+typedef struct {
+  const char *name;         /* the name of the POU type */
+  unsigned long long calls;
+  unsigned long long total; /* including the POUs it called */
+  unsigned long long self;  /* excluding the POUs it called */
+  unsigned long long max;   /* the longest call (total) */
+} __profile_pou_t;
+
+/* defined by the runtime */
+extern unsigned long long __profile_now(void);
+
+/* the total time of the POUs called by the POU currently running, defined in the code generated for the configuration */
+extern unsigned long long __profile_children;
+
+/* NOTE: the explicit alignment keeps the C compiler from leaving holes between the counters */
+#define __PROFILE_DECLARE(pou)\
+	__profile_pou_t __PROFILE_##pou __attribute__((section("iec_profile"), aligned(sizeof(void *)))) = {#pou, 0, 0, 0, 0};
+#define __PROFILE_BEGIN\
+	unsigned long long __profile_parent = __profile_children, __profile_start;\
+	__profile_children = 0;\
+	__profile_start = __profile_now();
+#define __PROFILE_END(pou)\
+	__profile_end(&__PROFILE_##pou, __profile_start, __profile_parent);
+
+static inline void __profile_end(__profile_pou_t *pou, unsigned long long start, unsigned long long parent) {
+  unsigned long long elapsed = __profile_now() - start;
+  pou->calls++;
+  pou->total += elapsed;
+  pou->self  += elapsed - __profile_children;
+  if (elapsed > pou->max) pou->max = elapsed;
+  __profile_children = parent + elapsed;
+}
+
+
+extern __profile_pou_t __start_iec_profile[] __attribute__((weak));
+extern __profile_pou_t __stop_iec_profile[]  __attribute__((weak));
+
+/* The counters of all the POU types, in no particular order */
+static inline __profile_pou_t *__profile_table(unsigned long *count) {
+  *count = __stop_iec_profile - __start_iec_profile;
+  return __start_iec_profile;
+}
+
+static inline void __profile_reset(void) {
+  __profile_pou_t *pou;
+  for (pou = __start_iec_profile; pou < __stop_iec_profile; pou++)
+    pou->calls = pou->total = pou->self = pou->max = 0;
+}
+
+#endif /* _IEC_PROFILE_H */
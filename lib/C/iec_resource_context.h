@@ -0,0 +1,56 @@
+/*
+ * copyright 2008 Edouard TISSERANT
+ * copyright 2011 Mario de Sousa (msousa@fe.up.pt)
+ *
+ * Offered to the public under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/****
+ * The execution context of each resource (iec2c -O R, USE_RESOURCE_CONTEXT)
+ *
+ * By default the generated code, and the standard timers, read the current time and the debug flag
+ * from the process wide __CURRENT_TIME and __DEBUG, set by the runtime. With USE_RESOURCE_CONTEXT
+ * these are instead read from the context of the resource being run, so several resources may run
+ * concurrently (e.g. each on its own thread or core) on different clocks.
+ *
+ * Each resource gets its context, <resource>_context__, and the configuration gets config_context__
+ * (used while config_init__() runs, i.e. by the global FB instances of the configuration). The runtime
+ * sets the current_time (and debug) of a context before calling the resource's functions. The entry
+ * points of the resource (<resource>_init__(), <resource>_run__() and the task run functions) make
+ * their context the current context of the calling thread, __current_resource_context, so the code
+ * of the POUs they call reads the values of that resource.
+ *
+ * With USE_TICK_TIMERS the count of ticks of the timers (__CURRENT_TICK) is also kept by each resource.
+ *
+ * NOTE: This uses the __thread storage class of gcc (and clang).
+ *       The runtime must be compiled with the same USE_RESOURCE_CONTEXT, and no longer defines
+ *       __CURRENT_TIME nor __DEBUG.
+ */
+
+#ifndef _IEC_RESOURCE_CONTEXT_H
+#define _IEC_RESOURCE_CONTEXT_H
+
+typedef struct {
+  TIME               current_time;  /* set by the runtime */
+  BOOL               debug;         /* set by the runtime */
+  unsigned long long current_tick;  /* only with USE_TICK_TIMERS, maintained by <resource>_run__() */
+} __resource_context_t;
+
+/* defined in the code generated for the configuration */
+extern __thread __resource_context_t *__current_resource_context;
+
+#define __CURRENT_TIME (__current_resource_context->current_time)
+#define __DEBUG        (__current_resource_context->debug)
+#define __CURRENT_TICK (__current_resource_context->current_tick)
+
+#endif /* _IEC_RESOURCE_CONTEXT_H */
@@ -0,0 +1,195 @@
+/*
+ * copyright 2008 Edouard TISSERANT
+ * copyright 2011 Mario de Sousa (msousa@fe.up.pt)
+ *
+ * Offered to the public under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/****
+ * The retain segment (USE_RETAIN_SEGMENT, iec2c -O n)
+ *
+ * The global variables of the configuration and of its resources, and the PROGRAM instances
+ * (i.e. what is saved by the functions generated with iec2c -O b) are placed by the C compiler
+ * in the 'iec_retain' section, which the linker lays out contiguously. The PLC state may then be
+ * saved with a single memcpy() (or DMA transfer) of __retain_segment_size() bytes starting at
+ * __retain_segment(), which is what the generated config_backup__() does.
+ *
+ * Every variable in the segment also has an entry (__retain_var_t) in the 'iec_retain_layout'
+ * section, with its (C) name and size, so the runtime can store a description of the layout
+ * next to the saved segment. __retain_layout_version() is a hash of the names, offsets and sizes
+ * of all the variables: when it differs from the one of the saved segment, the program was changed,
+ * and the segment may no longer be restored by a single memcpy(). The runtime may then restore the
+ * variables one at a time, with __retain_restore_var(), using the description it stored.
+ *
+ * With USE_RETAIN_DIRTY (iec2c -O z), the writes to the RETAIN variables also mark the pages
+ * (of __RETAIN_PAGE_SIZE bytes) of the segment they change in a bitmap, and the generated
+ * config_backup_dirty__() only passes the dirty pages to the runtime, so it may save the RETAIN
+ * variables to an NVRAM/flash after every cycle, without writing the whole segment. At startup
+ * all the pages are dirty.
+ *
+ * NOTE: The __start_<section> and __stop_<section> symbols are defined by the GNU linker (and
+ *       compatible ones). Other targets must define them in their linker script.
+ * NOTE: Located variables (%I, %Q, %M) are not in the segment: their memory belongs to the runtime,
+ *       which must save it itself if needed.
+ *
+ * This file is included by accessor.h, do not include it directly.
+ */
+
+#ifndef _IEC_RETAIN_H
+#define _IEC_RETAIN_H
+
+#include <string.h>
+
+typedef struct {
+  const char *name;     /* the name of the variable in the generated C code (e.g. RESOURCE1__INSTANCE0) */
+  void *ptr;
+  unsigned long size;
+} __retain_var_t;
+
+/* What config_backup__() saves in front of the segment */
+typedef struct {
+  unsigned long version;  /* __retain_layout_version() */
+  unsigned long size;     /* __retain_segment_size()   */
+} __retain_header_t;
+
+#define __RETAIN_SEGMENT __attribute__((section("iec_retain")))
+/* NOTE: the explicit alignment stops the C compiler from aligning the entries on a larger boundary
+ *       than their size, which would leave holes in the array the linker builds with them.
+ */
+#define __RETAIN_LAYOUT(name)\
+	static const __retain_var_t __retain_layout__##name\
+		__attribute__((section("iec_retain_layout"), used, aligned(sizeof(void *)))) =\
+		{#name, &(name), sizeof(name)};
+
+/* weak, so a program without any variable in the segment still links (with an empty segment) */
+extern char __start_iec_retain[] __attribute__((weak));
+extern char __stop_iec_retain[]  __attribute__((weak));
+extern const __retain_var_t __start_iec_retain_layout[] __attribute__((weak));
+extern const __retain_var_t __stop_iec_retain_layout[]  __attribute__((weak));
+
+
+static inline void *__retain_segment(void) {
+  return __start_iec_retain;
+}
+
+static inline unsigned long __retain_segment_size(void) {
+  return __stop_iec_retain - __start_iec_retain;
+}
+
+/* The entries of the layout, in no particular order */
+static inline const __retain_var_t *__retain_layout(unsigned long *count) {
+  *count = __stop_iec_retain_layout - __start_iec_retain_layout;
+  return __start_iec_retain_layout;
+}
+
+static inline unsigned long __retain_offset(const __retain_var_t *var) {
+  return (char *)var->ptr - __start_iec_retain;
+}
+
+/* FNV-1a hash of the name, offset and size of every variable, combined so the order of the entries does not matter */
+static inline unsigned long __retain_layout_version(void) {
+  static unsigned long version = 0;
+  const __retain_var_t *var;
+
+  if (0 != version) return version;
+  version = __retain_segment_size();
+  for (var = __start_iec_retain_layout; var < __stop_iec_retain_layout; var++) {
+    unsigned long hash = 2166136261UL, values[2];
+    const unsigned char *c;
+    unsigned int i;
+    values[0] = __retain_offset(var);
+    values[1] = var->size;
+    for (c = (const unsigned char *)var->name; *c != '\0'; c++) hash = (hash ^ *c) * 16777619UL;
+    for (c = (const unsigned char *)values, i = 0; i < sizeof(values); i++) hash = (hash ^ c[i]) * 16777619UL;
+    version += hash;
+  }
+  if (0 == version) version = 1;
+  return version;
+}
+
+/* Restore one variable saved by a (possibly different) version of the program.
+ * Returns 1 if the variable still exists with the same size, 0 otherwise (it then keeps its initial value).
+ */
+static inline int __retain_restore_var(const char *name, const void *value, unsigned long size) {
+  const __retain_var_t *var;
+  for (var = __start_iec_retain_layout; var < __stop_iec_retain_layout; var++)
+    if (0 == strcmp(var->name, name)) {
+      if (var->size != size) return 0;
+      memcpy(var->ptr, value, size);
+      return 1;
+    }
+  return 0;
+}
+
+
+
+#ifdef USE_RETAIN_DIRTY
+
+#ifndef __RETAIN_PAGE_BITS
+#define __RETAIN_PAGE_BITS  8
+#endif
+#define __RETAIN_PAGE_SIZE  (1UL << __RETAIN_PAGE_BITS)
+/* the pages beyond __RETAIN_MAX_PAGES are not tracked: writing one of them makes all the pages dirty */
+#ifndef __RETAIN_MAX_PAGES
+#define __RETAIN_MAX_PAGES  4096
+#endif
+
+typedef struct {
+  unsigned char all;  /* all the pages are dirty */
+  unsigned char page[(__RETAIN_MAX_PAGES + 7) / 8];
+} __retain_dirty_t;
+
+/* defined in the code generated for the configuration */
+extern __retain_dirty_t __retain_dirty;
+
+/* NOTE: not atomic. The resources must not be run in parallel (e.g. on separate threads) when tracking the dirty pages. */
+static inline void __retain_mark_dirty(const void *ptr, unsigned long size) {
+  unsigned long first = (const char *)ptr - __start_iec_retain, last;
+
+  /* also true when ptr is before the segment */
+  if (first >= __retain_segment_size()) return;
+  last  = (first + size - 1) >> __RETAIN_PAGE_BITS;
+  first = first >> __RETAIN_PAGE_BITS;
+  if (last >= __RETAIN_MAX_PAGES) {__retain_dirty.all = 1; return;}
+  for (; first <= last; first++)
+    __retain_dirty.page[first >> 3] |= 1 << (first & 7);
+}
+
+/* Call write() for every run of consecutive dirty pages, with its offset in the segment, and clear them */
+static inline void __retain_flush_dirty(void (*write)(unsigned long offset, const void *data, unsigned long size)) {
+  unsigned long size  = __retain_segment_size();
+  unsigned long pages = (size + __RETAIN_PAGE_SIZE - 1) >> __RETAIN_PAGE_BITS;
+  unsigned long page, first;
+
+  if (__retain_dirty.all) {
+    if (size > 0) write(0, __retain_segment(), size);
+    memset(&__retain_dirty, 0, sizeof(__retain_dirty));
+    return;
+  }
+  if (pages > __RETAIN_MAX_PAGES) pages = __RETAIN_MAX_PAGES;
+  for (page = 0; page < pages; ) {
+    /* skip 8 clean pages at once */
+    if (((page & 7) == 0) && (0 == __retain_dirty.page[page >> 3])) {page += 8; continue;}
+    if (!(__retain_dirty.page[page >> 3] & (1 << (page & 7)))) {page++; continue;}
+    for (first = page; (page < pages) && (__retain_dirty.page[page >> 3] & (1 << (page & 7))); page++)
+      __retain_dirty.page[page >> 3] &= ~(1 << (page & 7));
+    if ((page << __RETAIN_PAGE_BITS) > size)
+      write(first << __RETAIN_PAGE_BITS, __start_iec_retain + (first << __RETAIN_PAGE_BITS), size - (first << __RETAIN_PAGE_BITS));
+    else
+      write(first << __RETAIN_PAGE_BITS, __start_iec_retain + (first << __RETAIN_PAGE_BITS), (page - first) << __RETAIN_PAGE_BITS);
+  }
+}
+
+#endif /* USE_RETAIN_DIRTY */
+
+#endif /* _IEC_RETAIN_H */
@@ -0,0 +1,229 @@
+/*
+ * copyright 2008 Edouard TISSERANT
+ * copyright 2011 Mario de Sousa (msousa@fe.up.pt)
+ *
+ * Offered to the public under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/****
+ * The shared image of the variables read by other processes (iec2c -O S=file)
+ *
+ * The variables listed in the file given to iec2c (one path of VARIABLES.csv per line, e.g.
+ * "CONFIG0.RES0.INSTANCE0.COUNTER") are copied, at the end of each cycle, to a segment of memory
+ * that other processes (an OPC UA server, a historian, ...) may map, to read the values in place,
+ * with no calls into the PLC. The generated SHARED_IMAGE.c has the table of these variables.
+ *
+ * The runtime either calls __shared_image_open() (POSIX shared memory, named e.g. "/plc"), or
+ * gives __shared_image_init() a segment of its own of at least __shared_image_size() bytes.
+ * Until then, __shared_image_cycle() (called by config_run__()) does nothing.
+ *
+ * The layout of the segment does not depend on the C compiler of the PLC, so the readers only
+ * need this file (all the offsets are from the start of the segment, all the integers native):
+ *   __shared_image_header_t                 the header
+ *   count times __shared_image_entry_t      the variables, in the order of the file given to iec2c
+ *   the paths of the variables              NUL terminated
+ *   the values                              each aligned to 8 bytes
+ *
+ * The values are written under a seqlock: header.seq is odd while config_run__() writes them, and
+ * is incremented once more when they are all written. A reader gets a consistent snapshot of all
+ * the variables with:
+ *   do {
+ *     seq = __shared_image_read_begin(image);
+ *     ... read the values, in place ...
+ *   } while (__shared_image_read_retry(image, seq));
+ *
+ * header.layout is a hash of the paths and types of the variables, that changes when the program
+ * shares other variables (or changes their type).
+ *
+ * NOTE: This uses the __atomic builtins of gcc (and clang).
+ */
+
+#ifndef _IEC_SHARED_IMAGE_H
+#define _IEC_SHARED_IMAGE_H
+
+#include <stdint.h>
+#include <string.h>
+#include "iec_debug_table.h"
+
+#define __SHARED_IMAGE_MAGIC    0x53434549UL  /* "IECS" */
+#define __SHARED_IMAGE_VERSION  1             /* of this layout of the segment */
+
+typedef struct {
+  uint32_t magic;          /* __SHARED_IMAGE_MAGIC */
+  uint32_t version;        /* __SHARED_IMAGE_VERSION */
+  uint32_t layout;         /* hash of the paths and types of the variables */
+  uint32_t count;          /* of the variables */
+  uint32_t size;           /* of the whole segment */
+  uint32_t seq;            /* the seqlock, odd while the values are written */
+  uint64_t tick;           /* as passed to config_run__(), for the last values written */
+} __shared_image_header_t;
+
+typedef struct {
+  uint32_t path;           /* offset of the path */
+  uint32_t value;          /* offset of the value */
+  uint32_t size;           /* of the value */
+  uint16_t type;           /* __debug_type_t */
+  uint16_t reserved;
+} __shared_image_entry_t;
+
+/* the variables of the program, in the generated SHARED_IMAGE.c */
+typedef struct {
+  const char    *path;
+  void          *ptr;      /* the variable (as the ptr of __debug_var_t) */
+  unsigned char  type;     /* __debug_type_t */
+  unsigned char  flags;    /* __DEBUG_VAR_POINTER */
+  unsigned long  size;
+} __shared_var_t;
+
+/* defined in SHARED_IMAGE.c */
+extern const __shared_var_t      __shared_vars[];
+extern const unsigned long       __shared_vars_count;
+extern const unsigned long       __shared_image_layout;
+extern __shared_image_header_t  *__shared_image;   /* NULL until __shared_image_init() */
+
+#define __SHARED_IMAGE_ALIGN(offset) (((offset) + 7) & ~(unsigned long)7)
+
+
+/* PLC: the size of the segment */
+static inline unsigned long __shared_image_size(void) {
+  unsigned long size = sizeof(__shared_image_header_t) + __shared_vars_count * sizeof(__shared_image_entry_t);
+  unsigned long i;
+  for (i = 0; i < __shared_vars_count; i++) size += strlen(__shared_vars[i].path) + 1;
+  size = __SHARED_IMAGE_ALIGN(size);
+  for (i = 0; i < __shared_vars_count; i++) size += __SHARED_IMAGE_ALIGN(__shared_vars[i].size);
+  return size;
+}
+
+/* PLC: lay out the segment (any previous contents are lost), and copy the values to it from the next cycle on.
+ * Returns -1 if the segment is too small.
+ */
+static inline int __shared_image_init(void *segment, unsigned long size) {
+  __shared_image_header_t *header  = (__shared_image_header_t *)segment;
+  __shared_image_entry_t  *entries = (__shared_image_entry_t *)(header + 1);
+  unsigned long path  = sizeof(__shared_image_header_t) + __shared_vars_count * sizeof(__shared_image_entry_t);
+  unsigned long value, i;
+  if (size < __shared_image_size()) return -1;
+  for (i = 0; i < __shared_vars_count; i++) path += strlen(__shared_vars[i].path) + 1;
+  value = __SHARED_IMAGE_ALIGN(path);
+  path  = sizeof(__shared_image_header_t) + __shared_vars_count * sizeof(__shared_image_entry_t);
+
+  memset(segment, 0, size);
+  for (i = 0; i < __shared_vars_count; i++) {
+    const __shared_var_t *var = &__shared_vars[i];
+    entries[i].path  = path;
+    entries[i].value = value;
+    entries[i].size  = var->size;
+    entries[i].type  = var->type;
+    strcpy((char *)segment + path, var->path);
+    path  += strlen(var->path) + 1;
+    value += __SHARED_IMAGE_ALIGN(var->size);
+  }
+  header->magic   = __SHARED_IMAGE_MAGIC;
+  header->version = __SHARED_IMAGE_VERSION;
+  header->layout  = __shared_image_layout;
+  header->count   = __shared_vars_count;
+  header->size    = size;
+  __atomic_store_n(&__shared_image, header, __ATOMIC_RELEASE);
+  return 0;
+}
+
+/* PLC: called by config_run__() at the end of each cycle */
+static inline void __shared_image_cycle(unsigned long tick) {
+  __shared_image_header_t *header = __atomic_load_n(&__shared_image, __ATOMIC_ACQUIRE);
+  __shared_image_entry_t  *entries;
+  unsigned long i;
+  if (NULL == header) return;
+  entries = (__shared_image_entry_t *)(header + 1);
+
+  __atomic_store_n(&header->seq, header->seq + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  for (i = 0; i < __shared_vars_count; i++) {
+    const __shared_var_t *var = &__shared_vars[i];
+    void *src = (var->flags & __DEBUG_VAR_POINTER)? *(void **)var->ptr : var->ptr;
+    memcpy((char *)header + entries[i].value, src, var->size);
+  }
+  header->tick = tick;
+  __atomic_store_n(&header->seq, header->seq + 1, __ATOMIC_RELEASE);
+}
+
+
+/* Reader: wait until the values are not being written, and return the seqlock to give to __shared_image_read_retry() */
+static inline uint32_t __shared_image_read_begin(const __shared_image_header_t *image) {
+  uint32_t seq;
+  while ((seq = __atomic_load_n(&image->seq, __ATOMIC_ACQUIRE)) & 1);
+  return seq;
+}
+
+/* Reader: returns 1 if the values were written since __shared_image_read_begin(), i.e. those read must be read again */
+static inline int __shared_image_read_retry(const __shared_image_header_t *image, uint32_t seq) {
+  __atomic_thread_fence(__ATOMIC_ACQUIRE);
+  return __atomic_load_n(&image->seq, __ATOMIC_RELAXED) != seq;
+}
+
+/* Reader: the index of a variable given its path (case insensitive), or -1 if it is not in the image */
+static inline long __shared_image_find(const __shared_image_header_t *image, const char *path) {
+  const __shared_image_entry_t *entries = (const __shared_image_entry_t *)(image + 1);
+  unsigned long i;
+  for (i = 0; i < image->count; i++) {
+    const char *p1 = path, *p2 = (const char *)image + entries[i].path;
+    while ((*p1 != '\0') && (__debug_upper(*p1) == __debug_upper(*p2))) {p1++; p2++;}
+    if (__debug_upper(*p1) == __debug_upper(*p2)) return i;
+  }
+  return -1;
+}
+
+/* Reader: the value of the variable i (to be read between __shared_image_read_begin() and __shared_image_read_retry()) */
+static inline const void *__shared_image_value(const __shared_image_header_t *image, unsigned long i) {
+  const __shared_image_entry_t *entries = (const __shared_image_entry_t *)(image + 1);
+  return (const char *)image + entries[i].value;
+}
+
+
+#ifdef __unix__
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+/* PLC: create (or replace) the POSIX shared memory object of the given name (e.g. "/plc"), and lay out the image in it.
+ * Returns -1 if the shared memory could not be created.
+ */
+static inline int __shared_image_open(const char *name) {
+  unsigned long size = __shared_image_size();
+  void *segment;
+  int fd = shm_open(name, O_CREAT | O_RDWR, 0644);
+  if (fd < 0) return -1;
+  if (ftruncate(fd, size) < 0) {close(fd); return -1;}
+  segment = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (MAP_FAILED == segment) return -1;
+  return __shared_image_init(segment, size);
+}
+
+/* Reader: map the image created by __shared_image_open(), read only. Returns NULL if there is none (yet). */
+static inline const __shared_image_header_t *__shared_image_attach(const char *name) {
+  __shared_image_header_t header;
+  void *segment;
+  int fd = shm_open(name, O_RDONLY, 0);
+  if (fd < 0) return NULL;
+  if ((read(fd, &header, sizeof(header)) != sizeof(header)) ||
+      (__SHARED_IMAGE_MAGIC != header.magic) || (__SHARED_IMAGE_VERSION != header.version)) {
+    close(fd);
+    return NULL;
+  }
+  segment = mmap(NULL, header.size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  return (MAP_FAILED == segment)? NULL : (const __shared_image_header_t *)segment;
+}
+#endif /* __unix__ */
+
+#endif /* _IEC_SHARED_IMAGE_H */
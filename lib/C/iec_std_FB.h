@@ -8,10 +8,12 @@
  *        the *.txt files in the 'lib' directory.
  *       The only 'manual' change was:
  *          - to merge the generated .h and .c files into this single file
- *          - to remove the forward declarations of the functions
- *          - to change the function prototypes to become 'static'.
- *             e.g.:   static void R_TRIG_init__(...)
- *                     ^^^^^^
+ *          - to move the forward declarations of the functions before the code, only used
+ *            with USE_STD_LIB_OBJECT (see iec_std_lib.h)
+ *          - to change the function prototypes to become '__STD_FB' (i.e. 'static', unless
+ *            the FBs are compiled into the standard library object).
+ *             e.g.:   __STD_FB void R_TRIG_init__(...)
+ *                     ^^^^^^^^
  * 
  * NOTE: If the structure of the C code generated by iec2c (matiec) should change, then this C 'library'
  *       file will need to be recompiled. 
@@ -383,6 +385,9 @@ typedef struct {
   __DECLARE_VAR(BOOL,PREV_IN)
   __DECLARE_VAR(TIME,CURRENT_TIME)
   __DECLARE_VAR(TIME,START_TIME)
+#ifdef USE_TICK_TIMERS
+  __tick_timer_t __timer; /* used instead of CURRENT_TIME and START_TIME (see iec_std_lib.h) */
+#endif
 
 } TP;
 
@@ -402,6 +407,9 @@ typedef struct {
   __DECLARE_VAR(BOOL,PREV_IN)
   __DECLARE_VAR(TIME,CURRENT_TIME)
   __DECLARE_VAR(TIME,START_TIME)
+#ifdef USE_TICK_TIMERS
+  __tick_timer_t __timer; /* used instead of CURRENT_TIME and START_TIME (see iec_std_lib.h) */
+#endif
 
 } TON;
 
@@ -421,6 +429,9 @@ typedef struct {
   __DECLARE_VAR(BOOL,PREV_IN)
   __DECLARE_VAR(TIME,CURRENT_TIME)
   __DECLARE_VAR(TIME,START_TIME)
+#ifdef USE_TICK_TIMERS
+  __tick_timer_t __timer; /* used instead of CURRENT_TIME and START_TIME (see iec_std_lib.h) */
+#endif
 
 } TOF;
 
@@ -560,7 +571,98 @@ typedef struct {
 
 
 
-static void R_TRIG_init__(R_TRIG *data__, BOOL retain) {
+#ifdef __STD_LIB_PROTOTYPES_ONLY
+// The code of the FBs is in the standard library object (see USE_STD_LIB_OBJECT in iec_std_lib.h)
+__STD_FB void R_TRIG_init__(R_TRIG *data__, BOOL retain);
+__STD_FB void R_TRIG_body_noeneno__(R_TRIG *data__);
+__STD_FB void R_TRIG_body__(R_TRIG *data__);
+__STD_FB void F_TRIG_init__(F_TRIG *data__, BOOL retain);
+__STD_FB void F_TRIG_body_noeneno__(F_TRIG *data__);
+__STD_FB void F_TRIG_body__(F_TRIG *data__);
+__STD_FB void SR_init__(SR *data__, BOOL retain);
+__STD_FB void SR_body_noeneno__(SR *data__);
+__STD_FB void SR_body__(SR *data__);
+__STD_FB void RS_init__(RS *data__, BOOL retain);
+__STD_FB void RS_body_noeneno__(RS *data__);
+__STD_FB void RS_body__(RS *data__);
+__STD_FB void CTU_init__(CTU *data__, BOOL retain);
+__STD_FB void CTU_body_noeneno__(CTU *data__);
+__STD_FB void CTU_body__(CTU *data__);
+__STD_FB void CTU_DINT_init__(CTU_DINT *data__, BOOL retain);
+__STD_FB void CTU_DINT_body_noeneno__(CTU_DINT *data__);
+__STD_FB void CTU_DINT_body__(CTU_DINT *data__);
+__STD_FB void CTU_LINT_init__(CTU_LINT *data__, BOOL retain);
+__STD_FB void CTU_LINT_body_noeneno__(CTU_LINT *data__);
+__STD_FB void CTU_LINT_body__(CTU_LINT *data__);
+__STD_FB void CTU_UDINT_init__(CTU_UDINT *data__, BOOL retain);
+__STD_FB void CTU_UDINT_body_noeneno__(CTU_UDINT *data__);
+__STD_FB void CTU_UDINT_body__(CTU_UDINT *data__);
+__STD_FB void CTU_ULINT_init__(CTU_ULINT *data__, BOOL retain);
+__STD_FB void CTU_ULINT_body_noeneno__(CTU_ULINT *data__);
+__STD_FB void CTU_ULINT_body__(CTU_ULINT *data__);
+__STD_FB void CTD_init__(CTD *data__, BOOL retain);
+__STD_FB void CTD_body_noeneno__(CTD *data__);
+__STD_FB void CTD_body__(CTD *data__);
+__STD_FB void CTD_DINT_init__(CTD_DINT *data__, BOOL retain);
+__STD_FB void CTD_DINT_body_noeneno__(CTD_DINT *data__);
+__STD_FB void CTD_DINT_body__(CTD_DINT *data__);
+__STD_FB void CTD_LINT_init__(CTD_LINT *data__, BOOL retain);
+__STD_FB void CTD_LINT_body_noeneno__(CTD_LINT *data__);
+__STD_FB void CTD_LINT_body__(CTD_LINT *data__);
+__STD_FB void CTD_UDINT_init__(CTD_UDINT *data__, BOOL retain);
+__STD_FB void CTD_UDINT_body_noeneno__(CTD_UDINT *data__);
+__STD_FB void CTD_UDINT_body__(CTD_UDINT *data__);
+__STD_FB void CTD_ULINT_init__(CTD_ULINT *data__, BOOL retain);
+__STD_FB void CTD_ULINT_body_noeneno__(CTD_ULINT *data__);
+__STD_FB void CTD_ULINT_body__(CTD_ULINT *data__);
+__STD_FB void CTUD_init__(CTUD *data__, BOOL retain);
+__STD_FB void CTUD_body_noeneno__(CTUD *data__);
+__STD_FB void CTUD_body__(CTUD *data__);
+__STD_FB void CTUD_DINT_init__(CTUD_DINT *data__, BOOL retain);
+__STD_FB void CTUD_DINT_body_noeneno__(CTUD_DINT *data__);
+__STD_FB void CTUD_DINT_body__(CTUD_DINT *data__);
+__STD_FB void CTUD_LINT_init__(CTUD_LINT *data__, BOOL retain);
+__STD_FB void CTUD_LINT_body_noeneno__(CTUD_LINT *data__);
+__STD_FB void CTUD_LINT_body__(CTUD_LINT *data__);
+__STD_FB void CTUD_UDINT_init__(CTUD_UDINT *data__, BOOL retain);
+__STD_FB void CTUD_UDINT_body_noeneno__(CTUD_UDINT *data__);
+__STD_FB void CTUD_UDINT_body__(CTUD_UDINT *data__);
+__STD_FB void CTUD_ULINT_init__(CTUD_ULINT *data__, BOOL retain);
+__STD_FB void CTUD_ULINT_body_noeneno__(CTUD_ULINT *data__);
+__STD_FB void CTUD_ULINT_body__(CTUD_ULINT *data__);
+__STD_FB void TP_init__(TP *data__, BOOL retain);
+__STD_FB void TP_body_noeneno__(TP *data__);
+__STD_FB void TP_body__(TP *data__);
+__STD_FB void TON_init__(TON *data__, BOOL retain);
+__STD_FB void TON_body_noeneno__(TON *data__);
+__STD_FB void TON_body__(TON *data__);
+__STD_FB void TOF_init__(TOF *data__, BOOL retain);
+__STD_FB void TOF_body_noeneno__(TOF *data__);
+__STD_FB void TOF_body__(TOF *data__);
+__STD_FB void DERIVATIVE_init__(DERIVATIVE *data__, BOOL retain);
+__STD_FB void DERIVATIVE_body_noeneno__(DERIVATIVE *data__);
+__STD_FB void DERIVATIVE_body__(DERIVATIVE *data__);
+__STD_FB void HYSTERESIS_init__(HYSTERESIS *data__, BOOL retain);
+__STD_FB void HYSTERESIS_body_noeneno__(HYSTERESIS *data__);
+__STD_FB void HYSTERESIS_body__(HYSTERESIS *data__);
+__STD_FB void INTEGRAL_init__(INTEGRAL *data__, BOOL retain);
+__STD_FB void INTEGRAL_body_noeneno__(INTEGRAL *data__);
+__STD_FB void INTEGRAL_body__(INTEGRAL *data__);
+__STD_FB void PID_init__(PID *data__, BOOL retain);
+__STD_FB void PID_body_noeneno__(PID *data__);
+__STD_FB void PID_body__(PID *data__);
+__STD_FB void RAMP_init__(RAMP *data__, BOOL retain);
+__STD_FB void RAMP_body_noeneno__(RAMP *data__);
+__STD_FB void RAMP_body__(RAMP *data__);
+__STD_FB void RTC_init__(RTC *data__, BOOL retain);
+__STD_FB void RTC_body_noeneno__(RTC *data__);
+__STD_FB void RTC_body__(RTC *data__);
+__STD_FB void SEMA_init__(SEMA *data__, BOOL retain);
+__STD_FB void SEMA_body_noeneno__(SEMA *data__);
+__STD_FB void SEMA_body__(SEMA *data__);
+#else
+
+__STD_FB void R_TRIG_init__(R_TRIG *data__, BOOL retain) {
   __INIT_VAR(data__->EN,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->ENO,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->CLK,__BOOL_LITERAL(FALSE),retain)
@@ -569,15 +671,7 @@ static void R_TRIG_init__(R_TRIG *data__, BOOL retain) {
 }
 
 // Code part
-static void R_TRIG_body__(R_TRIG *data__) {
-  // Control execution
-  if (!__GET_VAR(data__->EN)) {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
-    return;
-  }
-  else {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
-  }
+__STD_FB void R_TRIG_body_noeneno__(R_TRIG *data__) {
   // Initialise TEMP variables
 
   __SET_VAR(data__->,Q,,(__GET_VAR(data__->CLK,) && !(__GET_VAR(data__->M,))));
@@ -587,13 +681,25 @@ static void R_TRIG_body__(R_TRIG *data__) {
 
 __end:
   return;
+} // R_TRIG_body_noeneno__() 
+
+__STD_FB void R_TRIG_body__(R_TRIG *data__) {
+  // Control execution
+  if (!__GET_VAR(data__->EN)) {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
+    return;
+  }
+  else {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
+  }
+  R_TRIG_body_noeneno__(data__);
 } // R_TRIG_body__() 
 
 
 
 
 
-static void F_TRIG_init__(F_TRIG *data__, BOOL retain) {
+__STD_FB void F_TRIG_init__(F_TRIG *data__, BOOL retain) {
   __INIT_VAR(data__->EN,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->ENO,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->CLK,__BOOL_LITERAL(FALSE),retain)
@@ -602,15 +708,7 @@ static void F_TRIG_init__(F_TRIG *data__, BOOL retain) {
 }
 
 // Code part
-static void F_TRIG_body__(F_TRIG *data__) {
-  // Control execution
-  if (!__GET_VAR(data__->EN)) {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
-    return;
-  }
-  else {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
-  }
+__STD_FB void F_TRIG_body_noeneno__(F_TRIG *data__) {
   // Initialise TEMP variables
 
   __SET_VAR(data__->,Q,,(!(__GET_VAR(data__->CLK,)) && !(__GET_VAR(data__->M,))));
@@ -620,13 +718,25 @@ static void F_TRIG_body__(F_TRIG *data__) {
 
 __end:
   return;
+} // F_TRIG_body_noeneno__() 
+
+__STD_FB void F_TRIG_body__(F_TRIG *data__) {
+  // Control execution
+  if (!__GET_VAR(data__->EN)) {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
+    return;
+  }
+  else {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
+  }
+  F_TRIG_body_noeneno__(data__);
 } // F_TRIG_body__() 
 
 
 
 
 
-static void SR_init__(SR *data__, BOOL retain) {
+__STD_FB void SR_init__(SR *data__, BOOL retain) {
   __INIT_VAR(data__->EN,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->ENO,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->S1,__BOOL_LITERAL(FALSE),retain)
@@ -635,15 +745,7 @@ static void SR_init__(SR *data__, BOOL retain) {
 }
 
 // Code part
-static void SR_body__(SR *data__) {
-  // Control execution
-  if (!__GET_VAR(data__->EN)) {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
-    return;
-  }
-  else {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
-  }
+__STD_FB void SR_body_noeneno__(SR *data__) {
   // Initialise TEMP variables
 
   __SET_VAR(data__->,Q1,,(__GET_VAR(data__->S1,) || (!(__GET_VAR(data__->R,)) && __GET_VAR(data__->Q1,))));
@@ -652,13 +754,25 @@ static void SR_body__(SR *data__) {
 
 __end:
   return;
+} // SR_body_noeneno__() 
+
+__STD_FB void SR_body__(SR *data__) {
+  // Control execution
+  if (!__GET_VAR(data__->EN)) {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
+    return;
+  }
+  else {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
+  }
+  SR_body_noeneno__(data__);
 } // SR_body__() 
 
 
 
 
 
-static void RS_init__(RS *data__, BOOL retain) {
+__STD_FB void RS_init__(RS *data__, BOOL retain) {
   __INIT_VAR(data__->EN,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->ENO,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->S,__BOOL_LITERAL(FALSE),retain)
@@ -667,15 +781,7 @@ static void RS_init__(RS *data__, BOOL retain) {
 }
 
 // Code part
-static void RS_body__(RS *data__) {
-  // Control execution
-  if (!__GET_VAR(data__->EN)) {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
-    return;
-  }
-  else {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
-  }
+__STD_FB void RS_body_noeneno__(RS *data__) {
   // Initialise TEMP variables
 
   __SET_VAR(data__->,Q1,,(!(__GET_VAR(data__->R1,)) && (__GET_VAR(data__->S,) || __GET_VAR(data__->Q1,))));
@@ -684,13 +790,25 @@ static void RS_body__(RS *data__) {
 
 __end:
   return;
+} // RS_body_noeneno__() 
+
+__STD_FB void RS_body__(RS *data__) {
+  // Control execution
+  if (!__GET_VAR(data__->EN)) {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
+    return;
+  }
+  else {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
+  }
+  RS_body_noeneno__(data__);
 } // RS_body__() 
 
 
 
 
 
-static void CTU_init__(CTU *data__, BOOL retain) {
+__STD_FB void CTU_init__(CTU *data__, BOOL retain) {
   __INIT_VAR(data__->EN,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->ENO,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->CU,__BOOL_LITERAL(FALSE),retain)
@@ -702,15 +820,7 @@ static void CTU_init__(CTU *data__, BOOL retain) {
 }
 
 // Code part
-static void CTU_body__(CTU *data__) {
-  // Control execution
-  if (!__GET_VAR(data__->EN)) {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
-    return;
-  }
-  else {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
-  }
+__STD_FB void CTU_body_noeneno__(CTU *data__) {
   // Initialise TEMP variables
 
   __SET_VAR(data__->CU_T.,CLK,,__GET_VAR(data__->CU,));
@@ -726,13 +836,25 @@ static void CTU_body__(CTU *data__) {
 
 __end:
   return;
+} // CTU_body_noeneno__() 
+
+__STD_FB void CTU_body__(CTU *data__) {
+  // Control execution
+  if (!__GET_VAR(data__->EN)) {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
+    return;
+  }
+  else {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
+  }
+  CTU_body_noeneno__(data__);
 } // CTU_body__() 
 
 
 
 
 
-static void CTU_DINT_init__(CTU_DINT *data__, BOOL retain) {
+__STD_FB void CTU_DINT_init__(CTU_DINT *data__, BOOL retain) {
   __INIT_VAR(data__->EN,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->ENO,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->CU,__BOOL_LITERAL(FALSE),retain)
@@ -744,15 +866,7 @@ static void CTU_DINT_init__(CTU_DINT *data__, BOOL retain) {
 }
 
 // Code part
-static void CTU_DINT_body__(CTU_DINT *data__) {
-  // Control execution
-  if (!__GET_VAR(data__->EN)) {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
-    return;
-  }
-  else {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
-  }
+__STD_FB void CTU_DINT_body_noeneno__(CTU_DINT *data__) {
   // Initialise TEMP variables
 
   __SET_VAR(data__->CU_T.,CLK,,__GET_VAR(data__->CU,));
@@ -768,13 +882,25 @@ static void CTU_DINT_body__(CTU_DINT *data__) {
 
 __end:
   return;
+} // CTU_DINT_body_noeneno__() 
+
+__STD_FB void CTU_DINT_body__(CTU_DINT *data__) {
+  // Control execution
+  if (!__GET_VAR(data__->EN)) {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
+    return;
+  }
+  else {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
+  }
+  CTU_DINT_body_noeneno__(data__);
 } // CTU_DINT_body__() 
 
 
 
 
 
-static void CTU_LINT_init__(CTU_LINT *data__, BOOL retain) {
+__STD_FB void CTU_LINT_init__(CTU_LINT *data__, BOOL retain) {
   __INIT_VAR(data__->EN,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->ENO,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->CU,__BOOL_LITERAL(FALSE),retain)
@@ -786,15 +912,7 @@ static void CTU_LINT_init__(CTU_LINT *data__, BOOL retain) {
 }
 
 // Code part
-static void CTU_LINT_body__(CTU_LINT *data__) {
-  // Control execution
-  if (!__GET_VAR(data__->EN)) {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
-    return;
-  }
-  else {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
-  }
+__STD_FB void CTU_LINT_body_noeneno__(CTU_LINT *data__) {
   // Initialise TEMP variables
 
   __SET_VAR(data__->CU_T.,CLK,,__GET_VAR(data__->CU,));
@@ -810,13 +928,25 @@ static void CTU_LINT_body__(CTU_LINT *data__) {
 
 __end:
   return;
+} // CTU_LINT_body_noeneno__() 
+
+__STD_FB void CTU_LINT_body__(CTU_LINT *data__) {
+  // Control execution
+  if (!__GET_VAR(data__->EN)) {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
+    return;
+  }
+  else {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
+  }
+  CTU_LINT_body_noeneno__(data__);
 } // CTU_LINT_body__() 
 
 
 
 
 
-static void CTU_UDINT_init__(CTU_UDINT *data__, BOOL retain) {
+__STD_FB void CTU_UDINT_init__(CTU_UDINT *data__, BOOL retain) {
   __INIT_VAR(data__->EN,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->ENO,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->CU,__BOOL_LITERAL(FALSE),retain)
@@ -828,15 +958,7 @@ static void CTU_UDINT_init__(CTU_UDINT *data__, BOOL retain) {
 }
 
 // Code part
-static void CTU_UDINT_body__(CTU_UDINT *data__) {
-  // Control execution
-  if (!__GET_VAR(data__->EN)) {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
-    return;
-  }
-  else {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
-  }
+__STD_FB void CTU_UDINT_body_noeneno__(CTU_UDINT *data__) {
   // Initialise TEMP variables
 
   __SET_VAR(data__->CU_T.,CLK,,__GET_VAR(data__->CU,));
@@ -852,13 +974,25 @@ static void CTU_UDINT_body__(CTU_UDINT *data__) {
 
 __end:
   return;
+} // CTU_UDINT_body_noeneno__() 
+
+__STD_FB void CTU_UDINT_body__(CTU_UDINT *data__) {
+  // Control execution
+  if (!__GET_VAR(data__->EN)) {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
+    return;
+  }
+  else {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
+  }
+  CTU_UDINT_body_noeneno__(data__);
 } // CTU_UDINT_body__() 
 
 
 
 
 
-static void CTU_ULINT_init__(CTU_ULINT *data__, BOOL retain) {
+__STD_FB void CTU_ULINT_init__(CTU_ULINT *data__, BOOL retain) {
   __INIT_VAR(data__->EN,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->ENO,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->CU,__BOOL_LITERAL(FALSE),retain)
@@ -870,15 +1004,7 @@ static void CTU_ULINT_init__(CTU_ULINT *data__, BOOL retain) {
 }
 
 // Code part
-static void CTU_ULINT_body__(CTU_ULINT *data__) {
-  // Control execution
-  if (!__GET_VAR(data__->EN)) {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
-    return;
-  }
-  else {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
-  }
+__STD_FB void CTU_ULINT_body_noeneno__(CTU_ULINT *data__) {
   // Initialise TEMP variables
 
   __SET_VAR(data__->CU_T.,CLK,,__GET_VAR(data__->CU,));
@@ -894,13 +1020,25 @@ static void CTU_ULINT_body__(CTU_ULINT *data__) {
 
 __end:
   return;
+} // CTU_ULINT_body_noeneno__() 
+
+__STD_FB void CTU_ULINT_body__(CTU_ULINT *data__) {
+  // Control execution
+  if (!__GET_VAR(data__->EN)) {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
+    return;
+  }
+  else {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
+  }
+  CTU_ULINT_body_noeneno__(data__);
 } // CTU_ULINT_body__() 
 
 
 
 
 
-static void CTD_init__(CTD *data__, BOOL retain) {
+__STD_FB void CTD_init__(CTD *data__, BOOL retain) {
   __INIT_VAR(data__->EN,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->ENO,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->CD,__BOOL_LITERAL(FALSE),retain)
@@ -912,15 +1050,7 @@ static void CTD_init__(CTD *data__, BOOL retain) {
 }
 
 // Code part
-static void CTD_body__(CTD *data__) {
-  // Control execution
-  if (!__GET_VAR(data__->EN)) {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
-    return;
-  }
-  else {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
-  }
+__STD_FB void CTD_body_noeneno__(CTD *data__) {
   // Initialise TEMP variables
 
   __SET_VAR(data__->CD_T.,CLK,,__GET_VAR(data__->CD,));
@@ -936,13 +1066,25 @@ static void CTD_body__(CTD *data__) {
 
 __end:
   return;
+} // CTD_body_noeneno__() 
+
+__STD_FB void CTD_body__(CTD *data__) {
+  // Control execution
+  if (!__GET_VAR(data__->EN)) {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
+    return;
+  }
+  else {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
+  }
+  CTD_body_noeneno__(data__);
 } // CTD_body__() 
 
 
 
 
 
-static void CTD_DINT_init__(CTD_DINT *data__, BOOL retain) {
+__STD_FB void CTD_DINT_init__(CTD_DINT *data__, BOOL retain) {
   __INIT_VAR(data__->EN,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->ENO,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->CD,__BOOL_LITERAL(FALSE),retain)
@@ -954,15 +1096,7 @@ static void CTD_DINT_init__(CTD_DINT *data__, BOOL retain) {
 }
 
 // Code part
-static void CTD_DINT_body__(CTD_DINT *data__) {
-  // Control execution
-  if (!__GET_VAR(data__->EN)) {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
-    return;
-  }
-  else {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
-  }
+__STD_FB void CTD_DINT_body_noeneno__(CTD_DINT *data__) {
   // Initialise TEMP variables
 
   __SET_VAR(data__->CD_T.,CLK,,__GET_VAR(data__->CD,));
@@ -978,13 +1112,25 @@ static void CTD_DINT_body__(CTD_DINT *data__) {
 
 __end:
   return;
+} // CTD_DINT_body_noeneno__() 
+
+__STD_FB void CTD_DINT_body__(CTD_DINT *data__) {
+  // Control execution
+  if (!__GET_VAR(data__->EN)) {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
+    return;
+  }
+  else {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
+  }
+  CTD_DINT_body_noeneno__(data__);
 } // CTD_DINT_body__() 
 
 
 
 
 
-static void CTD_LINT_init__(CTD_LINT *data__, BOOL retain) {
+__STD_FB void CTD_LINT_init__(CTD_LINT *data__, BOOL retain) {
   __INIT_VAR(data__->EN,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->ENO,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->CD,__BOOL_LITERAL(FALSE),retain)
@@ -996,15 +1142,7 @@ static void CTD_LINT_init__(CTD_LINT *data__, BOOL retain) {
 }
 
 // Code part
-static void CTD_LINT_body__(CTD_LINT *data__) {
-  // Control execution
-  if (!__GET_VAR(data__->EN)) {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
-    return;
-  }
-  else {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
-  }
+__STD_FB void CTD_LINT_body_noeneno__(CTD_LINT *data__) {
   // Initialise TEMP variables
 
   __SET_VAR(data__->CD_T.,CLK,,__GET_VAR(data__->CD,));
@@ -1020,13 +1158,25 @@ static void CTD_LINT_body__(CTD_LINT *data__) {
 
 __end:
   return;
+} // CTD_LINT_body_noeneno__() 
+
+__STD_FB void CTD_LINT_body__(CTD_LINT *data__) {
+  // Control execution
+  if (!__GET_VAR(data__->EN)) {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
+    return;
+  }
+  else {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
+  }
+  CTD_LINT_body_noeneno__(data__);
 } // CTD_LINT_body__() 
 
 
 
 
 
-static void CTD_UDINT_init__(CTD_UDINT *data__, BOOL retain) {
+__STD_FB void CTD_UDINT_init__(CTD_UDINT *data__, BOOL retain) {
   __INIT_VAR(data__->EN,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->ENO,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->CD,__BOOL_LITERAL(FALSE),retain)
@@ -1038,15 +1188,7 @@ static void CTD_UDINT_init__(CTD_UDINT *data__, BOOL retain) {
 }
 
 // Code part
-static void CTD_UDINT_body__(CTD_UDINT *data__) {
-  // Control execution
-  if (!__GET_VAR(data__->EN)) {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
-    return;
-  }
-  else {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
-  }
+__STD_FB void CTD_UDINT_body_noeneno__(CTD_UDINT *data__) {
   // Initialise TEMP variables
 
   __SET_VAR(data__->CD_T.,CLK,,__GET_VAR(data__->CD,));
@@ -1062,13 +1204,25 @@ static void CTD_UDINT_body__(CTD_UDINT *data__) {
 
 __end:
   return;
+} // CTD_UDINT_body_noeneno__() 
+
+__STD_FB void CTD_UDINT_body__(CTD_UDINT *data__) {
+  // Control execution
+  if (!__GET_VAR(data__->EN)) {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
+    return;
+  }
+  else {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
+  }
+  CTD_UDINT_body_noeneno__(data__);
 } // CTD_UDINT_body__() 
 
 
 
 
 
-static void CTD_ULINT_init__(CTD_ULINT *data__, BOOL retain) {
+__STD_FB void CTD_ULINT_init__(CTD_ULINT *data__, BOOL retain) {
   __INIT_VAR(data__->EN,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->ENO,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->CD,__BOOL_LITERAL(FALSE),retain)
@@ -1080,15 +1234,7 @@ static void CTD_ULINT_init__(CTD_ULINT *data__, BOOL retain) {
 }
 
 // Code part
-static void CTD_ULINT_body__(CTD_ULINT *data__) {
-  // Control execution
-  if (!__GET_VAR(data__->EN)) {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
-    return;
-  }
-  else {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
-  }
+__STD_FB void CTD_ULINT_body_noeneno__(CTD_ULINT *data__) {
   // Initialise TEMP variables
 
   __SET_VAR(data__->CD_T.,CLK,,__GET_VAR(data__->CD,));
@@ -1104,13 +1250,25 @@ static void CTD_ULINT_body__(CTD_ULINT *data__) {
 
 __end:
   return;
+} // CTD_ULINT_body_noeneno__() 
+
+__STD_FB void CTD_ULINT_body__(CTD_ULINT *data__) {
+  // Control execution
+  if (!__GET_VAR(data__->EN)) {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
+    return;
+  }
+  else {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
+  }
+  CTD_ULINT_body_noeneno__(data__);
 } // CTD_ULINT_body__() 
 
 
 
 
 
-static void CTUD_init__(CTUD *data__, BOOL retain) {
+__STD_FB void CTUD_init__(CTUD *data__, BOOL retain) {
   __INIT_VAR(data__->EN,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->ENO,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->CU,__BOOL_LITERAL(FALSE),retain)
@@ -1126,15 +1284,7 @@ static void CTUD_init__(CTUD *data__, BOOL retain) {
 }
 
 // Code part
-static void CTUD_body__(CTUD *data__) {
-  // Control execution
-  if (!__GET_VAR(data__->EN)) {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
-    return;
-  }
-  else {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
-  }
+__STD_FB void CTUD_body_noeneno__(CTUD *data__) {
   // Initialise TEMP variables
 
   __SET_VAR(data__->CD_T.,CLK,,__GET_VAR(data__->CD,));
@@ -1161,13 +1311,25 @@ static void CTUD_body__(CTUD *data__) {
 
 __end:
   return;
+} // CTUD_body_noeneno__() 
+
+__STD_FB void CTUD_body__(CTUD *data__) {
+  // Control execution
+  if (!__GET_VAR(data__->EN)) {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
+    return;
+  }
+  else {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
+  }
+  CTUD_body_noeneno__(data__);
 } // CTUD_body__() 
 
 
 
 
 
-static void CTUD_DINT_init__(CTUD_DINT *data__, BOOL retain) {
+__STD_FB void CTUD_DINT_init__(CTUD_DINT *data__, BOOL retain) {
   __INIT_VAR(data__->EN,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->ENO,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->CU,__BOOL_LITERAL(FALSE),retain)
@@ -1183,15 +1345,7 @@ static void CTUD_DINT_init__(CTUD_DINT *data__, BOOL retain) {
 }
 
 // Code part
-static void CTUD_DINT_body__(CTUD_DINT *data__) {
-  // Control execution
-  if (!__GET_VAR(data__->EN)) {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
-    return;
-  }
-  else {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
-  }
+__STD_FB void CTUD_DINT_body_noeneno__(CTUD_DINT *data__) {
   // Initialise TEMP variables
 
   __SET_VAR(data__->CD_T.,CLK,,__GET_VAR(data__->CD,));
@@ -1218,13 +1372,25 @@ static void CTUD_DINT_body__(CTUD_DINT *data__) {
 
 __end:
   return;
+} // CTUD_DINT_body_noeneno__() 
+
+__STD_FB void CTUD_DINT_body__(CTUD_DINT *data__) {
+  // Control execution
+  if (!__GET_VAR(data__->EN)) {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
+    return;
+  }
+  else {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
+  }
+  CTUD_DINT_body_noeneno__(data__);
 } // CTUD_DINT_body__() 
 
 
 
 
 
-static void CTUD_LINT_init__(CTUD_LINT *data__, BOOL retain) {
+__STD_FB void CTUD_LINT_init__(CTUD_LINT *data__, BOOL retain) {
   __INIT_VAR(data__->EN,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->ENO,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->CU,__BOOL_LITERAL(FALSE),retain)
@@ -1240,15 +1406,7 @@ static void CTUD_LINT_init__(CTUD_LINT *data__, BOOL retain) {
 }
 
 // Code part
-static void CTUD_LINT_body__(CTUD_LINT *data__) {
-  // Control execution
-  if (!__GET_VAR(data__->EN)) {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
-    return;
-  }
-  else {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
-  }
+__STD_FB void CTUD_LINT_body_noeneno__(CTUD_LINT *data__) {
   // Initialise TEMP variables
 
   __SET_VAR(data__->CD_T.,CLK,,__GET_VAR(data__->CD,));
@@ -1275,13 +1433,25 @@ static void CTUD_LINT_body__(CTUD_LINT *data__) {
 
 __end:
   return;
+} // CTUD_LINT_body_noeneno__() 
+
+__STD_FB void CTUD_LINT_body__(CTUD_LINT *data__) {
+  // Control execution
+  if (!__GET_VAR(data__->EN)) {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
+    return;
+  }
+  else {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
+  }
+  CTUD_LINT_body_noeneno__(data__);
 } // CTUD_LINT_body__() 
 
 
 
 
 
-static void CTUD_UDINT_init__(CTUD_UDINT *data__, BOOL retain) {
+__STD_FB void CTUD_UDINT_init__(CTUD_UDINT *data__, BOOL retain) {
   __INIT_VAR(data__->EN,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->ENO,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->CU,__BOOL_LITERAL(FALSE),retain)
@@ -1297,15 +1467,7 @@ static void CTUD_UDINT_init__(CTUD_UDINT *data__, BOOL retain) {
 }
 
 // Code part
-static void CTUD_UDINT_body__(CTUD_UDINT *data__) {
-  // Control execution
-  if (!__GET_VAR(data__->EN)) {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
-    return;
-  }
-  else {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
-  }
+__STD_FB void CTUD_UDINT_body_noeneno__(CTUD_UDINT *data__) {
   // Initialise TEMP variables
 
   __SET_VAR(data__->CD_T.,CLK,,__GET_VAR(data__->CD,));
@@ -1332,13 +1494,25 @@ static void CTUD_UDINT_body__(CTUD_UDINT *data__) {
 
 __end:
   return;
+} // CTUD_UDINT_body_noeneno__() 
+
+__STD_FB void CTUD_UDINT_body__(CTUD_UDINT *data__) {
+  // Control execution
+  if (!__GET_VAR(data__->EN)) {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
+    return;
+  }
+  else {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
+  }
+  CTUD_UDINT_body_noeneno__(data__);
 } // CTUD_UDINT_body__() 
 
 
 
 
 
-static void CTUD_ULINT_init__(CTUD_ULINT *data__, BOOL retain) {
+__STD_FB void CTUD_ULINT_init__(CTUD_ULINT *data__, BOOL retain) {
   __INIT_VAR(data__->EN,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->ENO,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->CU,__BOOL_LITERAL(FALSE),retain)
@@ -1354,15 +1528,7 @@ static void CTUD_ULINT_init__(CTUD_ULINT *data__, BOOL retain) {
 }
 
 // Code part
-static void CTUD_ULINT_body__(CTUD_ULINT *data__) {
-  // Control execution
-  if (!__GET_VAR(data__->EN)) {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
-    return;
-  }
-  else {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
-  }
+__STD_FB void CTUD_ULINT_body_noeneno__(CTUD_ULINT *data__) {
   // Initialise TEMP variables
 
   __SET_VAR(data__->CD_T.,CLK,,__GET_VAR(data__->CD,));
@@ -1389,13 +1555,41 @@ static void CTUD_ULINT_body__(CTUD_ULINT *data__) {
 
 __end:
   return;
+} // CTUD_ULINT_body_noeneno__() 
+
+__STD_FB void CTUD_ULINT_body__(CTUD_ULINT *data__) {
+  // Control execution
+  if (!__GET_VAR(data__->EN)) {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
+    return;
+  }
+  else {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
+  }
+  CTUD_ULINT_body_noeneno__(data__);
 } // CTUD_ULINT_body__() 
 
 
 
 
 
-static void TP_init__(TP *data__, BOOL retain) {
+#ifdef USE_TIMER_WHEEL
+/* Called by the timer wheel on the tick the timer expires, to do what the FB would do if it were called right then */
+static void TP_expired__(__tick_timer_t *timer) {
+  TP *data__ = (TP *)((char *)timer - offsetof(TP, __timer));
+  if (!__GET_VAR(data__->EN)) return; /* the FB would not be executed either */
+  if ((__GET_VAR(data__->STATE,) != 1) || !__TIMER_EXPIRED(data__)) return;
+  __SET_VAR(data__->,STATE,,2);
+  __SET_VAR(data__->,Q,,__BOOL_LITERAL(FALSE));
+  __SET_VAR(data__->,ET,,__GET_VAR(data__->PT,));
+  if (!(__GET_VAR(data__->IN,))) {
+    __SET_VAR(data__->,ET,,__time_to_timespec(1, 0, 0, 0, 0, 0));
+    __SET_VAR(data__->,STATE,,0);
+  }
+}
+#endif
+
+__STD_FB void TP_init__(TP *data__, BOOL retain) {
   __INIT_VAR(data__->EN,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->ENO,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->IN,__BOOL_LITERAL(FALSE),retain)
@@ -1406,37 +1600,30 @@ static void TP_init__(TP *data__, BOOL retain) {
   __INIT_VAR(data__->PREV_IN,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->CURRENT_TIME,__time_to_timespec(1, 0, 0, 0, 0, 0),retain)
   __INIT_VAR(data__->START_TIME,__time_to_timespec(1, 0, 0, 0, 0, 0),retain)
+  __TIMER_INIT(data__, TP_expired__);
 }
 
 // Code part
-static void TP_body__(TP *data__) {
-  // Control execution
-  if (!__GET_VAR(data__->EN)) {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
-    return;
-  }
-  else {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
-  }
+__STD_FB void TP_body_noeneno__(TP *data__) {
   // Initialise TEMP variables
 
   #define GetFbVar(var,...) __GET_VAR(data__->var,__VA_ARGS__)
   #define SetFbVar(var,val,...) __SET_VAR(data__->,var,__VA_ARGS__,val)
-__SET_VAR(data__->,CURRENT_TIME,,__CURRENT_TIME)
+__TIMER_UPDATE(data__)
   #undef GetFbVar
   #undef SetFbVar
 ;
   if ((((__GET_VAR(data__->STATE,) == 0) && !(__GET_VAR(data__->PREV_IN,))) && __GET_VAR(data__->IN,))) {
     __SET_VAR(data__->,STATE,,1);
     __SET_VAR(data__->,Q,,__BOOL_LITERAL(TRUE));
-    __SET_VAR(data__->,START_TIME,,__GET_VAR(data__->CURRENT_TIME,));
+    __TIMER_START(data__);
   } else if ((__GET_VAR(data__->STATE,) == 1)) {
-    if (LE_TIME(__BOOL_LITERAL(TRUE), NULL, 2, __time_add(__GET_VAR(data__->START_TIME,), __GET_VAR(data__->PT,)), __GET_VAR(data__->CURRENT_TIME,))) {
+    if (__TIMER_EXPIRED(data__)) {
       __SET_VAR(data__->,STATE,,2);
       __SET_VAR(data__->,Q,,__BOOL_LITERAL(FALSE));
       __SET_VAR(data__->,ET,,__GET_VAR(data__->PT,));
     } else {
-      __SET_VAR(data__->,ET,,__time_sub(__GET_VAR(data__->CURRENT_TIME,), __GET_VAR(data__->START_TIME,)));
+      __SET_VAR(data__->,ET,,__TIMER_ELAPSED(data__));
     };
   };
   if (((__GET_VAR(data__->STATE,) == 2) && !(__GET_VAR(data__->IN,)))) {
@@ -1449,13 +1636,37 @@ __SET_VAR(data__->,CURRENT_TIME,,__CURRENT_TIME)
 
 __end:
   return;
+} // TP_body_noeneno__() 
+
+__STD_FB void TP_body__(TP *data__) {
+  // Control execution
+  if (!__GET_VAR(data__->EN)) {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
+    return;
+  }
+  else {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
+  }
+  TP_body_noeneno__(data__);
 } // TP_body__() 
 
 
 
 
 
-static void TON_init__(TON *data__, BOOL retain) {
+#ifdef USE_TIMER_WHEEL
+/* Called by the timer wheel on the tick the timer expires, to do what the FB would do if it were called right then */
+static void TON_expired__(__tick_timer_t *timer) {
+  TON *data__ = (TON *)((char *)timer - offsetof(TON, __timer));
+  if (!__GET_VAR(data__->EN)) return; /* the FB would not be executed either */
+  if ((__GET_VAR(data__->STATE,) != 1) || !__GET_VAR(data__->IN,) || !__TIMER_EXPIRED(data__)) return;
+  __SET_VAR(data__->,STATE,,2);
+  __SET_VAR(data__->,Q,,__BOOL_LITERAL(TRUE));
+  __SET_VAR(data__->,ET,,__GET_VAR(data__->PT,));
+}
+#endif
+
+__STD_FB void TON_init__(TON *data__, BOOL retain) {
   __INIT_VAR(data__->EN,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->ENO,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->IN,__BOOL_LITERAL(FALSE),retain)
@@ -1466,42 +1677,35 @@ static void TON_init__(TON *data__, BOOL retain) {
   __INIT_VAR(data__->PREV_IN,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->CURRENT_TIME,__time_to_timespec(1, 0, 0, 0, 0, 0),retain)
   __INIT_VAR(data__->START_TIME,__time_to_timespec(1, 0, 0, 0, 0, 0),retain)
+  __TIMER_INIT(data__, TON_expired__);
 }
 
 // Code part
-static void TON_body__(TON *data__) {
-  // Control execution
-  if (!__GET_VAR(data__->EN)) {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
-    return;
-  }
-  else {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
-  }
+__STD_FB void TON_body_noeneno__(TON *data__) {
   // Initialise TEMP variables
 
   #define GetFbVar(var,...) __GET_VAR(data__->var,__VA_ARGS__)
   #define SetFbVar(var,val,...) __SET_VAR(data__->,var,__VA_ARGS__,val)
-__SET_VAR(data__->,CURRENT_TIME,,__CURRENT_TIME)
+__TIMER_UPDATE(data__)
   #undef GetFbVar
   #undef SetFbVar
 ;
   if ((((__GET_VAR(data__->STATE,) == 0) && !(__GET_VAR(data__->PREV_IN,))) && __GET_VAR(data__->IN,))) {
     __SET_VAR(data__->,STATE,,1);
     __SET_VAR(data__->,Q,,__BOOL_LITERAL(FALSE));
-    __SET_VAR(data__->,START_TIME,,__GET_VAR(data__->CURRENT_TIME,));
+    __TIMER_START(data__);
   } else {
     if (!(__GET_VAR(data__->IN,))) {
       __SET_VAR(data__->,ET,,__time_to_timespec(1, 0, 0, 0, 0, 0));
       __SET_VAR(data__->,Q,,__BOOL_LITERAL(FALSE));
       __SET_VAR(data__->,STATE,,0);
     } else if ((__GET_VAR(data__->STATE,) == 1)) {
-      if (LE_TIME(__BOOL_LITERAL(TRUE), NULL, 2, __time_add(__GET_VAR(data__->START_TIME,), __GET_VAR(data__->PT,)), __GET_VAR(data__->CURRENT_TIME,))) {
+      if (__TIMER_EXPIRED(data__)) {
         __SET_VAR(data__->,STATE,,2);
         __SET_VAR(data__->,Q,,__BOOL_LITERAL(TRUE));
         __SET_VAR(data__->,ET,,__GET_VAR(data__->PT,));
       } else {
-        __SET_VAR(data__->,ET,,__time_sub(__GET_VAR(data__->CURRENT_TIME,), __GET_VAR(data__->START_TIME,)));
+        __SET_VAR(data__->,ET,,__TIMER_ELAPSED(data__));
       };
     };
   };
@@ -1511,13 +1715,37 @@ __SET_VAR(data__->,CURRENT_TIME,,__CURRENT_TIME)
 
 __end:
   return;
+} // TON_body_noeneno__() 
+
+__STD_FB void TON_body__(TON *data__) {
+  // Control execution
+  if (!__GET_VAR(data__->EN)) {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
+    return;
+  }
+  else {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
+  }
+  TON_body_noeneno__(data__);
 } // TON_body__() 
 
 
 
 
 
-static void TOF_init__(TOF *data__, BOOL retain) {
+#ifdef USE_TIMER_WHEEL
+/* Called by the timer wheel on the tick the timer expires, to do what the FB would do if it were called right then */
+static void TOF_expired__(__tick_timer_t *timer) {
+  TOF *data__ = (TOF *)((char *)timer - offsetof(TOF, __timer));
+  if (!__GET_VAR(data__->EN)) return; /* the FB would not be executed either */
+  if ((__GET_VAR(data__->STATE,) != 1) || __GET_VAR(data__->IN,) || !__TIMER_EXPIRED(data__)) return;
+  __SET_VAR(data__->,STATE,,2);
+  __SET_VAR(data__->,ET,,__GET_VAR(data__->PT,));
+  __SET_VAR(data__->,Q,,__BOOL_LITERAL(FALSE));
+}
+#endif
+
+__STD_FB void TOF_init__(TOF *data__, BOOL retain) {
   __INIT_VAR(data__->EN,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->ENO,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->IN,__BOOL_LITERAL(FALSE),retain)
@@ -1528,39 +1756,32 @@ static void TOF_init__(TOF *data__, BOOL retain) {
   __INIT_VAR(data__->PREV_IN,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->CURRENT_TIME,__time_to_timespec(1, 0, 0, 0, 0, 0),retain)
   __INIT_VAR(data__->START_TIME,__time_to_timespec(1, 0, 0, 0, 0, 0),retain)
+  __TIMER_INIT(data__, TOF_expired__);
 }
 
 // Code part
-static void TOF_body__(TOF *data__) {
-  // Control execution
-  if (!__GET_VAR(data__->EN)) {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
-    return;
-  }
-  else {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
-  }
+__STD_FB void TOF_body_noeneno__(TOF *data__) {
   // Initialise TEMP variables
 
   #define GetFbVar(var,...) __GET_VAR(data__->var,__VA_ARGS__)
   #define SetFbVar(var,val,...) __SET_VAR(data__->,var,__VA_ARGS__,val)
-__SET_VAR(data__->,CURRENT_TIME,,__CURRENT_TIME)
+__TIMER_UPDATE(data__)
   #undef GetFbVar
   #undef SetFbVar
 ;
   if ((((__GET_VAR(data__->STATE,) == 0) && __GET_VAR(data__->PREV_IN,)) && !(__GET_VAR(data__->IN,)))) {
     __SET_VAR(data__->,STATE,,1);
-    __SET_VAR(data__->,START_TIME,,__GET_VAR(data__->CURRENT_TIME,));
+    __TIMER_START(data__);
   } else {
     if (__GET_VAR(data__->IN,)) {
       __SET_VAR(data__->,ET,,__time_to_timespec(1, 0, 0, 0, 0, 0));
       __SET_VAR(data__->,STATE,,0);
     } else if ((__GET_VAR(data__->STATE,) == 1)) {
-      if (LE_TIME(__BOOL_LITERAL(TRUE), NULL, 2, __time_add(__GET_VAR(data__->START_TIME,), __GET_VAR(data__->PT,)), __GET_VAR(data__->CURRENT_TIME,))) {
+      if (__TIMER_EXPIRED(data__)) {
         __SET_VAR(data__->,STATE,,2);
         __SET_VAR(data__->,ET,,__GET_VAR(data__->PT,));
       } else {
-        __SET_VAR(data__->,ET,,__time_sub(__GET_VAR(data__->CURRENT_TIME,), __GET_VAR(data__->START_TIME,)));
+        __SET_VAR(data__->,ET,,__TIMER_ELAPSED(data__));
       };
     };
   };
@@ -1571,13 +1792,25 @@ __SET_VAR(data__->,CURRENT_TIME,,__CURRENT_TIME)
 
 __end:
   return;
+} // TOF_body_noeneno__() 
+
+__STD_FB void TOF_body__(TOF *data__) {
+  // Control execution
+  if (!__GET_VAR(data__->EN)) {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
+    return;
+  }
+  else {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
+  }
+  TOF_body_noeneno__(data__);
 } // TOF_body__() 
 
 
 
 
 
-static void DERIVATIVE_init__(DERIVATIVE *data__, BOOL retain) {
+__STD_FB void DERIVATIVE_init__(DERIVATIVE *data__, BOOL retain) {
   __INIT_VAR(data__->EN,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->ENO,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->RUN,__BOOL_LITERAL(FALSE),retain)
@@ -1590,15 +1823,7 @@ static void DERIVATIVE_init__(DERIVATIVE *data__, BOOL retain) {
 }
 
 // Code part
-static void DERIVATIVE_body__(DERIVATIVE *data__) {
-  // Control execution
-  if (!__GET_VAR(data__->EN)) {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
-    return;
-  }
-  else {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
-  }
+__STD_FB void DERIVATIVE_body_noeneno__(DERIVATIVE *data__) {
   // Initialise TEMP variables
 
   if (__GET_VAR(data__->RUN,)) {
@@ -1619,13 +1844,25 @@ static void DERIVATIVE_body__(DERIVATIVE *data__) {
 
 __end:
   return;
+} // DERIVATIVE_body_noeneno__() 
+
+__STD_FB void DERIVATIVE_body__(DERIVATIVE *data__) {
+  // Control execution
+  if (!__GET_VAR(data__->EN)) {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
+    return;
+  }
+  else {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
+  }
+  DERIVATIVE_body_noeneno__(data__);
 } // DERIVATIVE_body__() 
 
 
 
 
 
-static void HYSTERESIS_init__(HYSTERESIS *data__, BOOL retain) {
+__STD_FB void HYSTERESIS_init__(HYSTERESIS *data__, BOOL retain) {
   __INIT_VAR(data__->EN,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->ENO,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->XIN1,0,retain)
@@ -1635,15 +1872,7 @@ static void HYSTERESIS_init__(HYSTERESIS *data__, BOOL retain) {
 }
 
 // Code part
-static void HYSTERESIS_body__(HYSTERESIS *data__) {
-  // Control execution
-  if (!__GET_VAR(data__->EN)) {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
-    return;
-  }
-  else {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
-  }
+__STD_FB void HYSTERESIS_body_noeneno__(HYSTERESIS *data__) {
   // Initialise TEMP variables
 
   if (__GET_VAR(data__->Q,)) {
@@ -1658,13 +1887,25 @@ static void HYSTERESIS_body__(HYSTERESIS *data__) {
 
 __end:
   return;
+} // HYSTERESIS_body_noeneno__() 
+
+__STD_FB void HYSTERESIS_body__(HYSTERESIS *data__) {
+  // Control execution
+  if (!__GET_VAR(data__->EN)) {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
+    return;
+  }
+  else {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
+  }
+  HYSTERESIS_body_noeneno__(data__);
 } // HYSTERESIS_body__() 
 
 
 
 
 
-static void INTEGRAL_init__(INTEGRAL *data__, BOOL retain) {
+__STD_FB void INTEGRAL_init__(INTEGRAL *data__, BOOL retain) {
   __INIT_VAR(data__->EN,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->ENO,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->RUN,__BOOL_LITERAL(FALSE),retain)
@@ -1677,15 +1918,7 @@ static void INTEGRAL_init__(INTEGRAL *data__, BOOL retain) {
 }
 
 // Code part
-static void INTEGRAL_body__(INTEGRAL *data__) {
-  // Control execution
-  if (!__GET_VAR(data__->EN)) {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
-    return;
-  }
-  else {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
-  }
+__STD_FB void INTEGRAL_body_noeneno__(INTEGRAL *data__) {
   // Initialise TEMP variables
 
   __SET_VAR(data__->,Q,,!(__GET_VAR(data__->R1,)));
@@ -1701,13 +1934,25 @@ static void INTEGRAL_body__(INTEGRAL *data__) {
 
 __end:
   return;
+} // INTEGRAL_body_noeneno__() 
+
+__STD_FB void INTEGRAL_body__(INTEGRAL *data__) {
+  // Control execution
+  if (!__GET_VAR(data__->EN)) {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
+    return;
+  }
+  else {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
+  }
+  INTEGRAL_body_noeneno__(data__);
 } // INTEGRAL_body__() 
 
 
 
 
 
-static void PID_init__(PID *data__, BOOL retain) {
+__STD_FB void PID_init__(PID *data__, BOOL retain) {
   __INIT_VAR(data__->EN,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->ENO,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->AUTO,__BOOL_LITERAL(FALSE),retain)
@@ -1725,15 +1970,7 @@ static void PID_init__(PID *data__, BOOL retain) {
 }
 
 // Code part
-static void PID_body__(PID *data__) {
-  // Control execution
-  if (!__GET_VAR(data__->EN)) {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
-    return;
-  }
-  else {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
-  }
+__STD_FB void PID_body_noeneno__(PID *data__) {
   // Initialise TEMP variables
 
   __SET_VAR(data__->,ERROR,,(__GET_VAR(data__->PV,) - __GET_VAR(data__->SP,)));
@@ -1753,13 +1990,25 @@ static void PID_body__(PID *data__) {
 
 __end:
   return;
+} // PID_body_noeneno__() 
+
+__STD_FB void PID_body__(PID *data__) {
+  // Control execution
+  if (!__GET_VAR(data__->EN)) {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
+    return;
+  }
+  else {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
+  }
+  PID_body_noeneno__(data__);
 } // PID_body__() 
 
 
 
 
 
-static void RAMP_init__(RAMP *data__, BOOL retain) {
+__STD_FB void RAMP_init__(RAMP *data__, BOOL retain) {
   __INIT_VAR(data__->EN,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->ENO,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->RUN,__BOOL_LITERAL(FALSE),retain)
@@ -1774,15 +2023,7 @@ static void RAMP_init__(RAMP *data__, BOOL retain) {
 }
 
 // Code part
-static void RAMP_body__(RAMP *data__) {
-  // Control execution
-  if (!__GET_VAR(data__->EN)) {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
-    return;
-  }
-  else {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
-  }
+__STD_FB void RAMP_body_noeneno__(RAMP *data__) {
   // Initialise TEMP variables
 
   __SET_VAR(data__->,BUSY,,__GET_VAR(data__->RUN,));
@@ -1808,13 +2049,25 @@ static void RAMP_body__(RAMP *data__) {
 
 __end:
   return;
+} // RAMP_body_noeneno__() 
+
+__STD_FB void RAMP_body__(RAMP *data__) {
+  // Control execution
+  if (!__GET_VAR(data__->EN)) {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
+    return;
+  }
+  else {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
+  }
+  RAMP_body_noeneno__(data__);
 } // RAMP_body__() 
 
 
 
 
 
-static void RTC_init__(RTC *data__, BOOL retain) {
+__STD_FB void RTC_init__(RTC *data__, BOOL retain) {
   __INIT_VAR(data__->EN,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->ENO,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->IN,__BOOL_LITERAL(FALSE),retain)
@@ -1827,15 +2080,7 @@ static void RTC_init__(RTC *data__, BOOL retain) {
 }
 
 // Code part
-static void RTC_body__(RTC *data__) {
-  // Control execution
-  if (!__GET_VAR(data__->EN)) {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
-    return;
-  }
-  else {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
-  }
+__STD_FB void RTC_body_noeneno__(RTC *data__) {
   // Initialise TEMP variables
 
   #define GetFbVar(var,...) __GET_VAR(data__->var,__VA_ARGS__)
@@ -1859,13 +2104,25 @@ __SET_VAR(data__->,CURRENT_TIME,,__CURRENT_TIME)
 
 __end:
   return;
+} // RTC_body_noeneno__() 
+
+__STD_FB void RTC_body__(RTC *data__) {
+  // Control execution
+  if (!__GET_VAR(data__->EN)) {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
+    return;
+  }
+  else {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
+  }
+  RTC_body_noeneno__(data__);
 } // RTC_body__() 
 
 
 
 
 
-static void SEMA_init__(SEMA *data__, BOOL retain) {
+__STD_FB void SEMA_init__(SEMA *data__, BOOL retain) {
   __INIT_VAR(data__->EN,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->ENO,__BOOL_LITERAL(TRUE),retain)
   __INIT_VAR(data__->CLAIM,__BOOL_LITERAL(FALSE),retain)
@@ -1875,15 +2132,7 @@ static void SEMA_init__(SEMA *data__, BOOL retain) {
 }
 
 // Code part
-static void SEMA_body__(SEMA *data__) {
-  // Control execution
-  if (!__GET_VAR(data__->EN)) {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
-    return;
-  }
-  else {
-    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
-  }
+__STD_FB void SEMA_body_noeneno__(SEMA *data__) {
   // Initialise TEMP variables
 
   __SET_VAR(data__->,Q_INTERNAL,,(__GET_VAR(data__->CLAIM,) || (__GET_VAR(data__->Q_INTERNAL,) && !(__GET_VAR(data__->RELEASE,)))));
@@ -1893,6 +2142,18 @@ static void SEMA_body__(SEMA *data__) {
 
 __end:
   return;
+} // SEMA_body_noeneno__() 
+
+__STD_FB void SEMA_body__(SEMA *data__) {
+  // Control execution
+  if (!__GET_VAR(data__->EN)) {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(FALSE));
+    return;
+  }
+  else {
+    __SET_VAR(data__->,ENO,,__BOOL_LITERAL(TRUE));
+  }
+  SEMA_body_noeneno__(data__);
 } // SEMA_body__() 
 
 
@@ -1902,4 +2163,6 @@ __end:
 
 
 
+#endif /* __STD_LIB_PROTOTYPES_ONLY */
+
 #endif //_IEC_STD_FB_H
@@ -8,10 +8,12 @@
  *        the *.txt files in the 'lib' directory.
  *       The only 'manual' change was:
  *          - to merge the generated .h and .c files into this single file
- *          - to remove the forward declarations of the functions
- *          - to change the function prototypes to become 'static'.
- *             e.g.:   static void R_TRIG_init__(...)
- *                     ^^^^^^
+ *          - to move the forward declarations of the functions before the code, only used
+ *            with USE_STD_LIB_OBJECT (see iec_std_lib.h)
+ *          - to change the function prototypes to become '__STD_FB' (i.e. 'static', unless
+ *            the FBs are compiled into the standard library object).
+ *             e.g.:   __STD_FB void R_TRIG_init__(...)
+ *                     ^^^^^^^^
  * 
  * NOTE: If the structure of the C code generated by iec2c (matiec) should change, then this C 'library'
  *       file will need to be recompiled. 
@@ -342,6 +344,9 @@ typedef struct {
   __DECLARE_VAR(BOOL,PREV_IN)
   __DECLARE_VAR(TIME,CURRENT_TIME)
   __DECLARE_VAR(TIME,START_TIME)
+#ifdef USE_TICK_TIMERS
+  __tick_timer_t __timer; /* used instead of CURRENT_TIME and START_TIME (see iec_std_lib.h) */
+#endif
 
 } TP;
 
@@ -359,6 +364,9 @@ typedef struct {
   __DECLARE_VAR(BOOL,PREV_IN)
   __DECLARE_VAR(TIME,CURRENT_TIME)
   __DECLARE_VAR(TIME,START_TIME)
+#ifdef USE_TICK_TIMERS
+  __tick_timer_t __timer; /* used instead of CURRENT_TIME and START_TIME (see iec_std_lib.h) */
+#endif
 
 } TON;
 
@@ -376,6 +384,9 @@ typedef struct {
   __DECLARE_VAR(BOOL,PREV_IN)
   __DECLARE_VAR(TIME,CURRENT_TIME)
   __DECLARE_VAR(TIME,START_TIME)
+#ifdef USE_TICK_TIMERS
+  __tick_timer_t __timer; /* used instead of CURRENT_TIME and START_TIME (see iec_std_lib.h) */
+#endif
 
 } TOF;
 
@@ -495,14 +506,76 @@ typedef struct {
 
 
 
-static void R_TRIG_init__(R_TRIG *data__, BOOL retain) {
+#ifdef __STD_LIB_PROTOTYPES_ONLY
+// The code of the FBs is in the standard library object (see USE_STD_LIB_OBJECT in iec_std_lib.h)
+__STD_FB void R_TRIG_init__(R_TRIG *data__, BOOL retain);
+__STD_FB void R_TRIG_body__(R_TRIG *data__);
+__STD_FB void F_TRIG_init__(F_TRIG *data__, BOOL retain);
+__STD_FB void F_TRIG_body__(F_TRIG *data__);
+__STD_FB void SR_init__(SR *data__, BOOL retain);
+__STD_FB void SR_body__(SR *data__);
+__STD_FB void RS_init__(RS *data__, BOOL retain);
+__STD_FB void RS_body__(RS *data__);
+__STD_FB void CTU_init__(CTU *data__, BOOL retain);
+__STD_FB void CTU_body__(CTU *data__);
+__STD_FB void CTU_DINT_init__(CTU_DINT *data__, BOOL retain);
+__STD_FB void CTU_DINT_body__(CTU_DINT *data__);
+__STD_FB void CTU_LINT_init__(CTU_LINT *data__, BOOL retain);
+__STD_FB void CTU_LINT_body__(CTU_LINT *data__);
+__STD_FB void CTU_UDINT_init__(CTU_UDINT *data__, BOOL retain);
+__STD_FB void CTU_UDINT_body__(CTU_UDINT *data__);
+__STD_FB void CTU_ULINT_init__(CTU_ULINT *data__, BOOL retain);
+__STD_FB void CTU_ULINT_body__(CTU_ULINT *data__);
+__STD_FB void CTD_init__(CTD *data__, BOOL retain);
+__STD_FB void CTD_body__(CTD *data__);
+__STD_FB void CTD_DINT_init__(CTD_DINT *data__, BOOL retain);
+__STD_FB void CTD_DINT_body__(CTD_DINT *data__);
+__STD_FB void CTD_LINT_init__(CTD_LINT *data__, BOOL retain);
+__STD_FB void CTD_LINT_body__(CTD_LINT *data__);
+__STD_FB void CTD_UDINT_init__(CTD_UDINT *data__, BOOL retain);
+__STD_FB void CTD_UDINT_body__(CTD_UDINT *data__);
+__STD_FB void CTD_ULINT_init__(CTD_ULINT *data__, BOOL retain);
+__STD_FB void CTD_ULINT_body__(CTD_ULINT *data__);
+__STD_FB void CTUD_init__(CTUD *data__, BOOL retain);
+__STD_FB void CTUD_body__(CTUD *data__);
+__STD_FB void CTUD_DINT_init__(CTUD_DINT *data__, BOOL retain);
+__STD_FB void CTUD_DINT_body__(CTUD_DINT *data__);
+__STD_FB void CTUD_LINT_init__(CTUD_LINT *data__, BOOL retain);
+__STD_FB void CTUD_LINT_body__(CTUD_LINT *data__);
+__STD_FB void CTUD_UDINT_init__(CTUD_UDINT *data__, BOOL retain);
+__STD_FB void CTUD_UDINT_body__(CTUD_UDINT *data__);
+__STD_FB void CTUD_ULINT_init__(CTUD_ULINT *data__, BOOL retain);
+__STD_FB void CTUD_ULINT_body__(CTUD_ULINT *data__);
+__STD_FB void TP_init__(TP *data__, BOOL retain);
+__STD_FB void TP_body__(TP *data__);
+__STD_FB void TON_init__(TON *data__, BOOL retain);
+__STD_FB void TON_body__(TON *data__);
+__STD_FB void TOF_init__(TOF *data__, BOOL retain);
+__STD_FB void TOF_body__(TOF *data__);
+__STD_FB void DERIVATIVE_init__(DERIVATIVE *data__, BOOL retain);
+__STD_FB void DERIVATIVE_body__(DERIVATIVE *data__);
+__STD_FB void HYSTERESIS_init__(HYSTERESIS *data__, BOOL retain);
+__STD_FB void HYSTERESIS_body__(HYSTERESIS *data__);
+__STD_FB void INTEGRAL_init__(INTEGRAL *data__, BOOL retain);
+__STD_FB void INTEGRAL_body__(INTEGRAL *data__);
+__STD_FB void PID_init__(PID *data__, BOOL retain);
+__STD_FB void PID_body__(PID *data__);
+__STD_FB void RAMP_init__(RAMP *data__, BOOL retain);
+__STD_FB void RAMP_body__(RAMP *data__);
+__STD_FB void RTC_init__(RTC *data__, BOOL retain);
+__STD_FB void RTC_body__(RTC *data__);
+__STD_FB void SEMA_init__(SEMA *data__, BOOL retain);
+__STD_FB void SEMA_body__(SEMA *data__);
+#else
+
+__STD_FB void R_TRIG_init__(R_TRIG *data__, BOOL retain) {
   __INIT_VAR(data__->CLK,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->Q,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->M,__BOOL_LITERAL(FALSE),1)
 }
 
 // Code part
-static void R_TRIG_body__(R_TRIG *data__) {
+__STD_FB void R_TRIG_body__(R_TRIG *data__) {
 // Initialise TEMP variables
 
 __SET_VAR(data__->,Q,,(__GET_VAR(data__->CLK,) && !(__GET_VAR(data__->M,))));
@@ -518,14 +591,14 @@ __end:
 
 
 
-static void F_TRIG_init__(F_TRIG *data__, BOOL retain) {
+__STD_FB void F_TRIG_init__(F_TRIG *data__, BOOL retain) {
   __INIT_VAR(data__->CLK,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->Q,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->M,__BOOL_LITERAL(FALSE),1)
 }
 
 // Code part
-static void F_TRIG_body__(F_TRIG *data__) {
+__STD_FB void F_TRIG_body__(F_TRIG *data__) {
 // Initialise TEMP variables
 
 __SET_VAR(data__->,Q,,(!(__GET_VAR(data__->CLK,)) && !(__GET_VAR(data__->M,))));
@@ -541,14 +614,14 @@ __end:
 
 
 
-static void SR_init__(SR *data__, BOOL retain) {
+__STD_FB void SR_init__(SR *data__, BOOL retain) {
   __INIT_VAR(data__->S1,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->R,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->Q1,__BOOL_LITERAL(FALSE),retain)
 }
 
 // Code part
-static void SR_body__(SR *data__) {
+__STD_FB void SR_body__(SR *data__) {
 // Initialise TEMP variables
 
 __SET_VAR(data__->,Q1,,(__GET_VAR(data__->S1,) || (!(__GET_VAR(data__->R,)) && __GET_VAR(data__->Q1,))));
@@ -563,14 +636,14 @@ __end:
 
 
 
-static void RS_init__(RS *data__, BOOL retain) {
+__STD_FB void RS_init__(RS *data__, BOOL retain) {
   __INIT_VAR(data__->S,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->R1,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->Q1,__BOOL_LITERAL(FALSE),retain)
 }
 
 // Code part
-static void RS_body__(RS *data__) {
+__STD_FB void RS_body__(RS *data__) {
 // Initialise TEMP variables
 
 __SET_VAR(data__->,Q1,,(!(__GET_VAR(data__->R1,)) && (__GET_VAR(data__->S,) || __GET_VAR(data__->Q1,))));
@@ -585,7 +658,7 @@ __end:
 
 
 
-static void CTU_init__(CTU *data__, BOOL retain) {
+__STD_FB void CTU_init__(CTU *data__, BOOL retain) {
   __INIT_VAR(data__->CU,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->R,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->PV,0,retain)
@@ -595,7 +668,7 @@ static void CTU_init__(CTU *data__, BOOL retain) {
 }
 
 // Code part
-static void CTU_body__(CTU *data__) {
+__STD_FB void CTU_body__(CTU *data__) {
 // Initialise TEMP variables
 
 __SET_VAR(data__->CU_T.,CLK,,__GET_VAR(data__->CU,));
@@ -617,7 +690,7 @@ __end:
 
 
 
-static void CTU_DINT_init__(CTU_DINT *data__, BOOL retain) {
+__STD_FB void CTU_DINT_init__(CTU_DINT *data__, BOOL retain) {
   __INIT_VAR(data__->CU,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->R,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->PV,0,retain)
@@ -627,7 +700,7 @@ static void CTU_DINT_init__(CTU_DINT *data__, BOOL retain) {
 }
 
 // Code part
-static void CTU_DINT_body__(CTU_DINT *data__) {
+__STD_FB void CTU_DINT_body__(CTU_DINT *data__) {
 // Initialise TEMP variables
 
 __SET_VAR(data__->CU_T.,CLK,,__GET_VAR(data__->CU,));
@@ -649,7 +722,7 @@ __end:
 
 
 
-static void CTU_LINT_init__(CTU_LINT *data__, BOOL retain) {
+__STD_FB void CTU_LINT_init__(CTU_LINT *data__, BOOL retain) {
   __INIT_VAR(data__->CU,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->R,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->PV,0,retain)
@@ -659,7 +732,7 @@ static void CTU_LINT_init__(CTU_LINT *data__, BOOL retain) {
 }
 
 // Code part
-static void CTU_LINT_body__(CTU_LINT *data__) {
+__STD_FB void CTU_LINT_body__(CTU_LINT *data__) {
 // Initialise TEMP variables
 
 __SET_VAR(data__->CU_T.,CLK,,__GET_VAR(data__->CU,));
@@ -681,7 +754,7 @@ __end:
 
 
 
-static void CTU_UDINT_init__(CTU_UDINT *data__, BOOL retain) {
+__STD_FB void CTU_UDINT_init__(CTU_UDINT *data__, BOOL retain) {
   __INIT_VAR(data__->CU,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->R,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->PV,0,retain)
@@ -691,7 +764,7 @@ static void CTU_UDINT_init__(CTU_UDINT *data__, BOOL retain) {
 }
 
 // Code part
-static void CTU_UDINT_body__(CTU_UDINT *data__) {
+__STD_FB void CTU_UDINT_body__(CTU_UDINT *data__) {
 // Initialise TEMP variables
 
 __SET_VAR(data__->CU_T.,CLK,,__GET_VAR(data__->CU,));
@@ -713,7 +786,7 @@ __end:
 
 
 
-static void CTU_ULINT_init__(CTU_ULINT *data__, BOOL retain) {
+__STD_FB void CTU_ULINT_init__(CTU_ULINT *data__, BOOL retain) {
   __INIT_VAR(data__->CU,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->R,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->PV,0,retain)
@@ -723,7 +796,7 @@ static void CTU_ULINT_init__(CTU_ULINT *data__, BOOL retain) {
 }
 
 // Code part
-static void CTU_ULINT_body__(CTU_ULINT *data__) {
+__STD_FB void CTU_ULINT_body__(CTU_ULINT *data__) {
 // Initialise TEMP variables
 
 __SET_VAR(data__->CU_T.,CLK,,__GET_VAR(data__->CU,));
@@ -745,7 +818,7 @@ __end:
 
 
 
-static void CTD_init__(CTD *data__, BOOL retain) {
+__STD_FB void CTD_init__(CTD *data__, BOOL retain) {
   __INIT_VAR(data__->CD,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->LD,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->PV,0,retain)
@@ -755,7 +828,7 @@ static void CTD_init__(CTD *data__, BOOL retain) {
 }
 
 // Code part
-static void CTD_body__(CTD *data__) {
+__STD_FB void CTD_body__(CTD *data__) {
 // Initialise TEMP variables
 
 __SET_VAR(data__->CD_T.,CLK,,__GET_VAR(data__->CD,));
@@ -777,7 +850,7 @@ __end:
 
 
 
-static void CTD_DINT_init__(CTD_DINT *data__, BOOL retain) {
+__STD_FB void CTD_DINT_init__(CTD_DINT *data__, BOOL retain) {
   __INIT_VAR(data__->CD,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->LD,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->PV,0,retain)
@@ -787,7 +860,7 @@ static void CTD_DINT_init__(CTD_DINT *data__, BOOL retain) {
 }
 
 // Code part
-static void CTD_DINT_body__(CTD_DINT *data__) {
+__STD_FB void CTD_DINT_body__(CTD_DINT *data__) {
 // Initialise TEMP variables
 
 __SET_VAR(data__->CD_T.,CLK,,__GET_VAR(data__->CD,));
@@ -809,7 +882,7 @@ __end:
 
 
 
-static void CTD_LINT_init__(CTD_LINT *data__, BOOL retain) {
+__STD_FB void CTD_LINT_init__(CTD_LINT *data__, BOOL retain) {
   __INIT_VAR(data__->CD,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->LD,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->PV,0,retain)
@@ -819,7 +892,7 @@ static void CTD_LINT_init__(CTD_LINT *data__, BOOL retain) {
 }
 
 // Code part
-static void CTD_LINT_body__(CTD_LINT *data__) {
+__STD_FB void CTD_LINT_body__(CTD_LINT *data__) {
 // Initialise TEMP variables
 
 __SET_VAR(data__->CD_T.,CLK,,__GET_VAR(data__->CD,));
@@ -841,7 +914,7 @@ __end:
 
 
 
-static void CTD_UDINT_init__(CTD_UDINT *data__, BOOL retain) {
+__STD_FB void CTD_UDINT_init__(CTD_UDINT *data__, BOOL retain) {
   __INIT_VAR(data__->CD,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->LD,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->PV,0,retain)
@@ -851,7 +924,7 @@ static void CTD_UDINT_init__(CTD_UDINT *data__, BOOL retain) {
 }
 
 // Code part
-static void CTD_UDINT_body__(CTD_UDINT *data__) {
+__STD_FB void CTD_UDINT_body__(CTD_UDINT *data__) {
 // Initialise TEMP variables
 
 __SET_VAR(data__->CD_T.,CLK,,__GET_VAR(data__->CD,));
@@ -873,7 +946,7 @@ __end:
 
 
 
-static void CTD_ULINT_init__(CTD_ULINT *data__, BOOL retain) {
+__STD_FB void CTD_ULINT_init__(CTD_ULINT *data__, BOOL retain) {
   __INIT_VAR(data__->CD,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->LD,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->PV,0,retain)
@@ -883,7 +956,7 @@ static void CTD_ULINT_init__(CTD_ULINT *data__, BOOL retain) {
 }
 
 // Code part
-static void CTD_ULINT_body__(CTD_ULINT *data__) {
+__STD_FB void CTD_ULINT_body__(CTD_ULINT *data__) {
 // Initialise TEMP variables
 
 __SET_VAR(data__->CD_T.,CLK,,__GET_VAR(data__->CD,));
@@ -905,7 +978,7 @@ __end:
 
 
 
-static void CTUD_init__(CTUD *data__, BOOL retain) {
+__STD_FB void CTUD_init__(CTUD *data__, BOOL retain) {
   __INIT_VAR(data__->CU,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->CD,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->R,__BOOL_LITERAL(FALSE),retain)
@@ -919,7 +992,7 @@ static void CTUD_init__(CTUD *data__, BOOL retain) {
 }
 
 // Code part
-static void CTUD_body__(CTUD *data__) {
+__STD_FB void CTUD_body__(CTUD *data__) {
 // Initialise TEMP variables
 
 __SET_VAR(data__->CD_T.,CLK,,__GET_VAR(data__->CD,));
@@ -952,7 +1025,7 @@ __end:
 
 
 
-static void CTUD_DINT_init__(CTUD_DINT *data__, BOOL retain) {
+__STD_FB void CTUD_DINT_init__(CTUD_DINT *data__, BOOL retain) {
   __INIT_VAR(data__->CU,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->CD,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->R,__BOOL_LITERAL(FALSE),retain)
@@ -966,7 +1039,7 @@ static void CTUD_DINT_init__(CTUD_DINT *data__, BOOL retain) {
 }
 
 // Code part
-static void CTUD_DINT_body__(CTUD_DINT *data__) {
+__STD_FB void CTUD_DINT_body__(CTUD_DINT *data__) {
 // Initialise TEMP variables
 
 __SET_VAR(data__->CD_T.,CLK,,__GET_VAR(data__->CD,));
@@ -999,7 +1072,7 @@ __end:
 
 
 
-static void CTUD_LINT_init__(CTUD_LINT *data__, BOOL retain) {
+__STD_FB void CTUD_LINT_init__(CTUD_LINT *data__, BOOL retain) {
   __INIT_VAR(data__->CU,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->CD,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->R,__BOOL_LITERAL(FALSE),retain)
@@ -1013,7 +1086,7 @@ static void CTUD_LINT_init__(CTUD_LINT *data__, BOOL retain) {
 }
 
 // Code part
-static void CTUD_LINT_body__(CTUD_LINT *data__) {
+__STD_FB void CTUD_LINT_body__(CTUD_LINT *data__) {
 // Initialise TEMP variables
 
 __SET_VAR(data__->CD_T.,CLK,,__GET_VAR(data__->CD,));
@@ -1046,7 +1119,7 @@ __end:
 
 
 
-static void CTUD_UDINT_init__(CTUD_UDINT *data__, BOOL retain) {
+__STD_FB void CTUD_UDINT_init__(CTUD_UDINT *data__, BOOL retain) {
   __INIT_VAR(data__->CU,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->CD,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->R,__BOOL_LITERAL(FALSE),retain)
@@ -1060,7 +1133,7 @@ static void CTUD_UDINT_init__(CTUD_UDINT *data__, BOOL retain) {
 }
 
 // Code part
-static void CTUD_UDINT_body__(CTUD_UDINT *data__) {
+__STD_FB void CTUD_UDINT_body__(CTUD_UDINT *data__) {
 // Initialise TEMP variables
 
 __SET_VAR(data__->CD_T.,CLK,,__GET_VAR(data__->CD,));
@@ -1093,7 +1166,7 @@ __end:
 
 
 
-static void CTUD_ULINT_init__(CTUD_ULINT *data__, BOOL retain) {
+__STD_FB void CTUD_ULINT_init__(CTUD_ULINT *data__, BOOL retain) {
   __INIT_VAR(data__->CU,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->CD,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->R,__BOOL_LITERAL(FALSE),retain)
@@ -1107,7 +1180,7 @@ static void CTUD_ULINT_init__(CTUD_ULINT *data__, BOOL retain) {
 }
 
 // Code part
-static void CTUD_ULINT_body__(CTUD_ULINT *data__) {
+__STD_FB void CTUD_ULINT_body__(CTUD_ULINT *data__) {
 // Initialise TEMP variables
 
 __SET_VAR(data__->CD_T.,CLK,,__GET_VAR(data__->CD,));
@@ -1140,7 +1213,22 @@ __end:
 
 
 
-static void TP_init__(TP *data__, BOOL retain) {
+#ifdef USE_TIMER_WHEEL
+/* Called by the timer wheel on the tick the timer expires, to do what the FB would do if it were called right then */
+static void TP_expired__(__tick_timer_t *timer) {
+  TP *data__ = (TP *)((char *)timer - offsetof(TP, __timer));
+  if ((__GET_VAR(data__->STATE,) != 1) || !__TIMER_EXPIRED(data__)) return;
+  __SET_VAR(data__->,STATE,,2);
+  __SET_VAR(data__->,Q,,__BOOL_LITERAL(FALSE));
+  __SET_VAR(data__->,ET,,__GET_VAR(data__->PT,));
+  if (!(__GET_VAR(data__->IN,))) {
+    __SET_VAR(data__->,ET,,__time_to_timespec(1, 0, 0, 0, 0, 0));
+    __SET_VAR(data__->,STATE,,0);
+  }
+}
+#endif
+
+__STD_FB void TP_init__(TP *data__, BOOL retain) {
   __INIT_VAR(data__->IN,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->PT,__time_to_timespec(1, 0, 0, 0, 0, 0),retain)
   __INIT_VAR(data__->Q,__BOOL_LITERAL(FALSE),retain)
@@ -1149,29 +1237,30 @@ static void TP_init__(TP *data__, BOOL retain) {
   __INIT_VAR(data__->PREV_IN,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->CURRENT_TIME,__time_to_timespec(1, 0, 0, 0, 0, 0),retain)
   __INIT_VAR(data__->START_TIME,__time_to_timespec(1, 0, 0, 0, 0, 0),retain)
+  __TIMER_INIT(data__, TP_expired__);
 }
 
 // Code part
-static void TP_body__(TP *data__) {
+__STD_FB void TP_body__(TP *data__) {
 // Initialise TEMP variables
 
 #define GetFbVar(var,...) __GET_VAR(data__->var,__VA_ARGS__)
 #define SetFbVar(var,val,...) __SET_VAR(data__->,var,__VA_ARGS__,val)
-__SET_VAR(data__->,CURRENT_TIME,,__CURRENT_TIME)
+__TIMER_UPDATE(data__)
 #undef GetFbVar
 #undef SetFbVar
 ;
 if ((((__GET_VAR(data__->STATE,) == 0) && !(__GET_VAR(data__->PREV_IN,))) && __GET_VAR(data__->IN,))) {
   __SET_VAR(data__->,STATE,,1);
   __SET_VAR(data__->,Q,,__BOOL_LITERAL(TRUE));
-  __SET_VAR(data__->,START_TIME,,__GET_VAR(data__->CURRENT_TIME,));
+  __TIMER_START(data__);
 } else if ((__GET_VAR(data__->STATE,) == 1)) {
-  if (LE_TIME(2, __time_add(__GET_VAR(data__->START_TIME,), __GET_VAR(data__->PT,)), __GET_VAR(data__->CURRENT_TIME,))) {
+  if (__TIMER_EXPIRED(data__)) {
     __SET_VAR(data__->,STATE,,2);
     __SET_VAR(data__->,Q,,__BOOL_LITERAL(FALSE));
     __SET_VAR(data__->,ET,,__GET_VAR(data__->PT,));
   } else {
-    __SET_VAR(data__->,ET,,__time_sub(__GET_VAR(data__->CURRENT_TIME,), __GET_VAR(data__->START_TIME,)));
+    __SET_VAR(data__->,ET,,__TIMER_ELAPSED(data__));
   };
 };
 if (((__GET_VAR(data__->STATE,) == 2) && !(__GET_VAR(data__->IN,)))) {
@@ -1190,7 +1279,18 @@ __end:
 
 
 
-static void TON_init__(TON *data__, BOOL retain) {
+#ifdef USE_TIMER_WHEEL
+/* Called by the timer wheel on the tick the timer expires, to do what the FB would do if it were called right then */
+static void TON_expired__(__tick_timer_t *timer) {
+  TON *data__ = (TON *)((char *)timer - offsetof(TON, __timer));
+  if ((__GET_VAR(data__->STATE,) != 1) || !__GET_VAR(data__->IN,) || !__TIMER_EXPIRED(data__)) return;
+  __SET_VAR(data__->,STATE,,2);
+  __SET_VAR(data__->,Q,,__BOOL_LITERAL(TRUE));
+  __SET_VAR(data__->,ET,,__GET_VAR(data__->PT,));
+}
+#endif
+
+__STD_FB void TON_init__(TON *data__, BOOL retain) {
   __INIT_VAR(data__->IN,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->PT,__time_to_timespec(1, 0, 0, 0, 0, 0),retain)
   __INIT_VAR(data__->Q,__BOOL_LITERAL(FALSE),retain)
@@ -1199,34 +1299,35 @@ static void TON_init__(TON *data__, BOOL retain) {
   __INIT_VAR(data__->PREV_IN,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->CURRENT_TIME,__time_to_timespec(1, 0, 0, 0, 0, 0),retain)
   __INIT_VAR(data__->START_TIME,__time_to_timespec(1, 0, 0, 0, 0, 0),retain)
+  __TIMER_INIT(data__, TON_expired__);
 }
 
 // Code part
-static void TON_body__(TON *data__) {
+__STD_FB void TON_body__(TON *data__) {
 // Initialise TEMP variables
 
 #define GetFbVar(var,...) __GET_VAR(data__->var,__VA_ARGS__)
 #define SetFbVar(var,val,...) __SET_VAR(data__->,var,__VA_ARGS__,val)
-__SET_VAR(data__->,CURRENT_TIME,,__CURRENT_TIME)
+__TIMER_UPDATE(data__)
 #undef GetFbVar
 #undef SetFbVar
 ;
 if ((((__GET_VAR(data__->STATE,) == 0) && !(__GET_VAR(data__->PREV_IN,))) && __GET_VAR(data__->IN,))) {
   __SET_VAR(data__->,STATE,,1);
   __SET_VAR(data__->,Q,,__BOOL_LITERAL(FALSE));
-  __SET_VAR(data__->,START_TIME,,__GET_VAR(data__->CURRENT_TIME,));
+  __TIMER_START(data__);
 } else {
   if (!(__GET_VAR(data__->IN,))) {
     __SET_VAR(data__->,ET,,__time_to_timespec(1, 0, 0, 0, 0, 0));
     __SET_VAR(data__->,Q,,__BOOL_LITERAL(FALSE));
     __SET_VAR(data__->,STATE,,0);
   } else if ((__GET_VAR(data__->STATE,) == 1)) {
-    if (LE_TIME(2, __time_add(__GET_VAR(data__->START_TIME,), __GET_VAR(data__->PT,)), __GET_VAR(data__->CURRENT_TIME,))) {
+    if (__TIMER_EXPIRED(data__)) {
       __SET_VAR(data__->,STATE,,2);
       __SET_VAR(data__->,Q,,__BOOL_LITERAL(TRUE));
       __SET_VAR(data__->,ET,,__GET_VAR(data__->PT,));
     } else {
-      __SET_VAR(data__->,ET,,__time_sub(__GET_VAR(data__->CURRENT_TIME,), __GET_VAR(data__->START_TIME,)));
+      __SET_VAR(data__->,ET,,__TIMER_ELAPSED(data__));
     };
   };
 };
@@ -1242,7 +1343,18 @@ __end:
 
 
 
-static void TOF_init__(TOF *data__, BOOL retain) {
+#ifdef USE_TIMER_WHEEL
+/* Called by the timer wheel on the tick the timer expires, to do what the FB would do if it were called right then */
+static void TOF_expired__(__tick_timer_t *timer) {
+  TOF *data__ = (TOF *)((char *)timer - offsetof(TOF, __timer));
+  if ((__GET_VAR(data__->STATE,) != 1) || __GET_VAR(data__->IN,) || !__TIMER_EXPIRED(data__)) return;
+  __SET_VAR(data__->,STATE,,2);
+  __SET_VAR(data__->,ET,,__GET_VAR(data__->PT,));
+  __SET_VAR(data__->,Q,,__BOOL_LITERAL(FALSE));
+}
+#endif
+
+__STD_FB void TOF_init__(TOF *data__, BOOL retain) {
   __INIT_VAR(data__->IN,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->PT,__time_to_timespec(1, 0, 0, 0, 0, 0),retain)
   __INIT_VAR(data__->Q,__BOOL_LITERAL(FALSE),retain)
@@ -1251,31 +1363,32 @@ static void TOF_init__(TOF *data__, BOOL retain) {
   __INIT_VAR(data__->PREV_IN,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->CURRENT_TIME,__time_to_timespec(1, 0, 0, 0, 0, 0),retain)
   __INIT_VAR(data__->START_TIME,__time_to_timespec(1, 0, 0, 0, 0, 0),retain)
+  __TIMER_INIT(data__, TOF_expired__);
 }
 
 // Code part
-static void TOF_body__(TOF *data__) {
+__STD_FB void TOF_body__(TOF *data__) {
 // Initialise TEMP variables
 
 #define GetFbVar(var,...) __GET_VAR(data__->var,__VA_ARGS__)
 #define SetFbVar(var,val,...) __SET_VAR(data__->,var,__VA_ARGS__,val)
-__SET_VAR(data__->,CURRENT_TIME,,__CURRENT_TIME)
+__TIMER_UPDATE(data__)
 #undef GetFbVar
 #undef SetFbVar
 ;
 if ((((__GET_VAR(data__->STATE,) == 0) && __GET_VAR(data__->PREV_IN,)) && !(__GET_VAR(data__->IN,)))) {
   __SET_VAR(data__->,STATE,,1);
-  __SET_VAR(data__->,START_TIME,,__GET_VAR(data__->CURRENT_TIME,));
+  __TIMER_START(data__);
 } else {
   if (__GET_VAR(data__->IN,)) {
     __SET_VAR(data__->,ET,,__time_to_timespec(1, 0, 0, 0, 0, 0));
     __SET_VAR(data__->,STATE,,0);
   } else if ((__GET_VAR(data__->STATE,) == 1)) {
-    if (LE_TIME(2, __time_add(__GET_VAR(data__->START_TIME,), __GET_VAR(data__->PT,)), __GET_VAR(data__->CURRENT_TIME,))) {
+    if (__TIMER_EXPIRED(data__)) {
       __SET_VAR(data__->,STATE,,2);
       __SET_VAR(data__->,ET,,__GET_VAR(data__->PT,));
     } else {
-      __SET_VAR(data__->,ET,,__time_sub(__GET_VAR(data__->CURRENT_TIME,), __GET_VAR(data__->START_TIME,)));
+      __SET_VAR(data__->,ET,,__TIMER_ELAPSED(data__));
     };
   };
 };
@@ -1292,7 +1405,7 @@ __end:
 
 
 
-static void DERIVATIVE_init__(DERIVATIVE *data__, BOOL retain) {
+__STD_FB void DERIVATIVE_init__(DERIVATIVE *data__, BOOL retain) {
   __INIT_VAR(data__->RUN,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->XIN,0,retain)
   __INIT_VAR(data__->CYCLE,__time_to_timespec(1, 0, 0, 0, 0, 0),retain)
@@ -1303,7 +1416,7 @@ static void DERIVATIVE_init__(DERIVATIVE *data__, BOOL retain) {
 }
 
 // Code part
-static void DERIVATIVE_body__(DERIVATIVE *data__) {
+__STD_FB void DERIVATIVE_body__(DERIVATIVE *data__) {
 // Initialise TEMP variables
 
 if (__GET_VAR(data__->RUN,)) {
@@ -1328,7 +1441,7 @@ __end:
 
 
 
-static void HYSTERESIS_init__(HYSTERESIS *data__, BOOL retain) {
+__STD_FB void HYSTERESIS_init__(HYSTERESIS *data__, BOOL retain) {
   __INIT_VAR(data__->XIN1,0,retain)
   __INIT_VAR(data__->XIN2,0,retain)
   __INIT_VAR(data__->EPS,0,retain)
@@ -1336,7 +1449,7 @@ static void HYSTERESIS_init__(HYSTERESIS *data__, BOOL retain) {
 }
 
 // Code part
-static void HYSTERESIS_body__(HYSTERESIS *data__) {
+__STD_FB void HYSTERESIS_body__(HYSTERESIS *data__) {
 // Initialise TEMP variables
 
 if (__GET_VAR(data__->Q,)) {
@@ -1357,7 +1470,7 @@ __end:
 
 
 
-static void INTEGRAL_init__(INTEGRAL *data__, BOOL retain) {
+__STD_FB void INTEGRAL_init__(INTEGRAL *data__, BOOL retain) {
   __INIT_VAR(data__->RUN,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->R1,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->XIN,0,retain)
@@ -1368,7 +1481,7 @@ static void INTEGRAL_init__(INTEGRAL *data__, BOOL retain) {
 }
 
 // Code part
-static void INTEGRAL_body__(INTEGRAL *data__) {
+__STD_FB void INTEGRAL_body__(INTEGRAL *data__) {
 // Initialise TEMP variables
 
 __SET_VAR(data__->,Q,,!(__GET_VAR(data__->R1,)));
@@ -1388,7 +1501,7 @@ __end:
 
 
 
-static void PID_init__(PID *data__, BOOL retain) {
+__STD_FB void PID_init__(PID *data__, BOOL retain) {
   __INIT_VAR(data__->AUTO,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->PV,0,retain)
   __INIT_VAR(data__->SP,0,retain)
@@ -1404,7 +1517,7 @@ static void PID_init__(PID *data__, BOOL retain) {
 }
 
 // Code part
-static void PID_body__(PID *data__) {
+__STD_FB void PID_body__(PID *data__) {
 // Initialise TEMP variables
 
 __SET_VAR(data__->,ERROR,,(__GET_VAR(data__->PV,) - __GET_VAR(data__->SP,)));
@@ -1430,7 +1543,7 @@ __end:
 
 
 
-static void RAMP_init__(RAMP *data__, BOOL retain) {
+__STD_FB void RAMP_init__(RAMP *data__, BOOL retain) {
   __INIT_VAR(data__->RUN,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->X0,0,retain)
   __INIT_VAR(data__->X1,0,retain)
@@ -1443,7 +1556,7 @@ static void RAMP_init__(RAMP *data__, BOOL retain) {
 }
 
 // Code part
-static void RAMP_body__(RAMP *data__) {
+__STD_FB void RAMP_body__(RAMP *data__) {
 // Initialise TEMP variables
 
 __SET_VAR(data__->,BUSY,,__GET_VAR(data__->RUN,));
@@ -1471,7 +1584,7 @@ __end:
 
 
 
-static void RTC_init__(RTC *data__, BOOL retain) {
+__STD_FB void RTC_init__(RTC *data__, BOOL retain) {
   __INIT_VAR(data__->IN,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->PDT,__dt_to_timespec(0, 0, 0, 1, 1, 1970),retain)
   __INIT_VAR(data__->Q,__BOOL_LITERAL(FALSE),retain)
@@ -1482,7 +1595,7 @@ static void RTC_init__(RTC *data__, BOOL retain) {
 }
 
 // Code part
-static void RTC_body__(RTC *data__) {
+__STD_FB void RTC_body__(RTC *data__) {
 // Initialise TEMP variables
 
 #define GetFbVar(var,...) __GET_VAR(data__->var,__VA_ARGS__)
@@ -1512,7 +1625,7 @@ __end:
 
 
 
-static void SEMA_init__(SEMA *data__, BOOL retain) {
+__STD_FB void SEMA_init__(SEMA *data__, BOOL retain) {
   __INIT_VAR(data__->CLAIM,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->RELEASE,__BOOL_LITERAL(FALSE),retain)
   __INIT_VAR(data__->BUSY,__BOOL_LITERAL(FALSE),retain)
@@ -1520,7 +1633,7 @@ static void SEMA_init__(SEMA *data__, BOOL retain) {
 }
 
 // Code part
-static void SEMA_body__(SEMA *data__) {
+__STD_FB void SEMA_body__(SEMA *data__) {
 // Initialise TEMP variables
 
 __SET_VAR(data__->,Q_INTERNAL,,(__GET_VAR(data__->CLAIM,) || (__GET_VAR(data__->Q_INTERNAL,) && !(__GET_VAR(data__->RELEASE,)))));
@@ -1545,4 +1658,6 @@ __end:
 
 
 
+#endif /* __STD_LIB_PROTOTYPES_ONLY */
+
 #endif //_IEC_STD_FB_H
\ No newline at end of file
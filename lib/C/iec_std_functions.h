@@ -125,26 +125,26 @@
 /*****************************************/  
 
 #define __convert_type(from_TYPENAME,to_TYPENAME, oper) \
-static inline to_TYPENAME from_TYPENAME##_TO_##to_TYPENAME(EN_ENO_PARAMS from_TYPENAME op){\
+__STD_USED_FUNC(from_TYPENAME##_TO_##to_TYPENAME) to_TYPENAME from_TYPENAME##_TO_##to_TYPENAME(EN_ENO_PARAMS from_TYPENAME op) __STD_USED_BODY(from_TYPENAME##_TO_##to_TYPENAME, {\
   TEST_EN(to_TYPENAME)\
   return (to_TYPENAME)oper(op);\
-}
+})
 
 /******** [ANY_NUM | ANY_NBIT]_TO_BOOL   ************/
 #define __convert_num_to_bool(TYPENAME) \
-static inline BOOL TYPENAME##_TO_BOOL(EN_ENO_PARAMS TYPENAME op){\
+__STD_USED_FUNC(TYPENAME##_TO_BOOL) BOOL TYPENAME##_TO_BOOL(EN_ENO_PARAMS TYPENAME op) __STD_USED_BODY(TYPENAME##_TO_BOOL, {\
   TEST_EN(BOOL)\
   return op == 0 ? 0 : 1;\
-}
+})
 __ANY_NUM(__convert_num_to_bool)
 __ANY_NBIT(__convert_num_to_bool)
 
 /******** [TIME | ANY_DATE]_TO_BOOL   ************/
 #define __convert_time_to_bool(TYPENAME) \
-static inline BOOL TYPENAME##_TO_BOOL(EN_ENO_PARAMS TYPENAME op){\
+__STD_USED_FUNC(TYPENAME##_TO_BOOL) BOOL TYPENAME##_TO_BOOL(EN_ENO_PARAMS TYPENAME op) __STD_USED_BODY(TYPENAME##_TO_BOOL, {\
   TEST_EN(BOOL)\
-  return op.tv_sec == 0 && op.tv_nsec == 0 ? 0 : 1;\
-}
+  return __timespec_sec(op) == 0 && __timespec_nsec(op) == 0 ? 0 : 1;\
+})
 __convert_time_to_bool(TIME)
 __ANY_DATE(__convert_time_to_bool)
 
@@ -223,14 +223,14 @@ __ANY_DATE(__to_anyreal_)
 /******** [ANY_DATE]_TO_[ANY_DATE | TIME]   ************/ 
 /* Not supported: DT_TO_TIME */
 __convert_type(DT, DATE,  __date_and_time_to_date)
-static inline DATE DATE_AND_TIME_TO_DATE(EN_ENO_PARAMS DT op){
+__STD_USED_FUNC(DATE_AND_TIME_TO_DATE) DATE DATE_AND_TIME_TO_DATE(EN_ENO_PARAMS DT op) __STD_USED_BODY(DATE_AND_TIME_TO_DATE, {
 	return DT_TO_DATE(EN_ENO op);
-}
+})
 __convert_type(DT, DT,    __move_DT)
 __convert_type(DT, TOD,   __date_and_time_to_time_of_day)
-static inline DATE DATE_AND_TIME_TO_TIME_OF_DAY(EN_ENO_PARAMS DT op){
+__STD_USED_FUNC(DATE_AND_TIME_TO_TIME_OF_DAY) DATE DATE_AND_TIME_TO_TIME_OF_DAY(EN_ENO_PARAMS DT op) __STD_USED_BODY(DATE_AND_TIME_TO_TIME_OF_DAY, {
 	return DT_TO_TOD(EN_ENO op);
-}
+})
 /* Not supported: DATE_TO_TIME */
 __convert_type(DATE, DATE, __move_DATE)
 /* Not supported: DATE_TO_DT */
@@ -308,36 +308,36 @@ __convert_type(STRING, TIME, __string_to_time)
 
 /********   TRUNC   ************/ 
 #define __iec_(to_TYPENAME,from_TYPENAME) \
-static inline to_TYPENAME TRUNC__##to_TYPENAME##__##from_TYPENAME(EN_ENO_PARAMS from_TYPENAME op){\
+__STD_USED_FUNC(TRUNC__##to_TYPENAME##__##from_TYPENAME) to_TYPENAME TRUNC__##to_TYPENAME##__##from_TYPENAME(EN_ENO_PARAMS from_TYPENAME op) __STD_USED_BODY(TRUNC__##to_TYPENAME##__##from_TYPENAME, {\
   TEST_EN(to_TYPENAME)\
   return (to_TYPENAME)__move_##to_TYPENAME(op);\
-}
+})
 __ANY_REAL(__to_anyint_)
 #undef __iec_
 
 
 /********   _TO_BCD   ************/
 #define __iec_(to_TYPENAME,from_TYPENAME) \
-static inline to_TYPENAME from_TYPENAME##_TO_BCD_##to_TYPENAME(EN_ENO_PARAMS from_TYPENAME op){\
+__STD_FUNC to_TYPENAME from_TYPENAME##_TO_BCD_##to_TYPENAME(EN_ENO_PARAMS from_TYPENAME op) __STD_BODY({\
   TEST_EN(to_TYPENAME)\
   return (to_TYPENAME)__uint_to_bcd(op);\
-}\
-static inline to_TYPENAME from_TYPENAME##_TO_BCD__##to_TYPENAME##__##from_TYPENAME(EN_ENO_PARAMS from_TYPENAME op){\
+})\
+__STD_USED_FUNC(from_TYPENAME##_TO_BCD__##to_TYPENAME##__##from_TYPENAME) to_TYPENAME from_TYPENAME##_TO_BCD__##to_TYPENAME##__##from_TYPENAME(EN_ENO_PARAMS from_TYPENAME op) __STD_USED_BODY(from_TYPENAME##_TO_BCD__##to_TYPENAME##__##from_TYPENAME, {\
   return from_TYPENAME##_TO_BCD_##to_TYPENAME(EN_ENO op);\
-}
+})
 __ANY_UINT(__to_anynbit_)
 #undef __iec_
 
 
 /********   BCD_TO_   ************/
 #define __iec_(to_TYPENAME,from_TYPENAME) \
-static inline to_TYPENAME from_TYPENAME##_BCD_TO_##to_TYPENAME(EN_ENO_PARAMS from_TYPENAME op){\
+__STD_FUNC to_TYPENAME from_TYPENAME##_BCD_TO_##to_TYPENAME(EN_ENO_PARAMS from_TYPENAME op) __STD_BODY({\
   TEST_EN_COND(to_TYPENAME, __test_bcd(op))\
   return (to_TYPENAME)__bcd_to_uint(op);\
-}\
-static inline to_TYPENAME BCD_TO_##to_TYPENAME##__##to_TYPENAME##__##from_TYPENAME(EN_ENO_PARAMS from_TYPENAME op){\
+})\
+__STD_USED_FUNC(BCD_TO_##to_TYPENAME##__##to_TYPENAME##__##from_TYPENAME) to_TYPENAME BCD_TO_##to_TYPENAME##__##to_TYPENAME##__##from_TYPENAME(EN_ENO_PARAMS from_TYPENAME op) __STD_USED_BODY(BCD_TO_##to_TYPENAME##__##to_TYPENAME##__##from_TYPENAME, {\
   return from_TYPENAME##_BCD_TO_##to_TYPENAME(EN_ENO op);\
-}
+})
 __ANY_NBIT(__to_anyuint_)
 #undef __iec_
 
@@ -374,14 +374,14 @@ __ANY_NBIT(__to_anyuint_)
 
 #define __numeric(fname,TYPENAME, FUNC) \
 /* explicitly typed function */\
-static inline TYPENAME fname##TYPENAME(EN_ENO_PARAMS TYPENAME op){\
+__STD_FUNC TYPENAME fname##TYPENAME(EN_ENO_PARAMS TYPENAME op) __STD_BODY({\
   TEST_EN(TYPENAME)\
-  return FUNC(op);\
-}\
+  return __MATH_##TYPENAME(FUNC)(op);\
+})\
 /* overloaded function */\
-static inline TYPENAME fname##_##TYPENAME##__##TYPENAME(EN_ENO_PARAMS TYPENAME op) {\
+__STD_USED_FUNC(fname##_##TYPENAME##__##TYPENAME) TYPENAME fname##_##TYPENAME##__##TYPENAME(EN_ENO_PARAMS TYPENAME op)  __STD_USED_BODY(fname##_##TYPENAME##__##TYPENAME, {\
   return fname##TYPENAME(EN_ENO op);\
-}
+})
 
 /******************************************************************/
 /***   Table 23 - Standard functions of one numeric variable    ***/
@@ -392,27 +392,27 @@ static inline TYPENAME fname##_##TYPENAME##__##TYPENAME(EN_ENO_PARAMS TYPENAME o
   /**************/
 #define __abs_signed(TYPENAME) \
 /* explicitly typed function */\
-static inline TYPENAME ABS_##TYPENAME(EN_ENO_PARAMS TYPENAME op){\
+__STD_FUNC TYPENAME ABS_##TYPENAME(EN_ENO_PARAMS TYPENAME op) __STD_BODY({\
   TEST_EN(TYPENAME)\
   if (op < 0)\
     return -op;\
   return op;\
-}\
+})\
 /* overloaded function */\
-static inline TYPENAME ABS__##TYPENAME##__##TYPENAME(EN_ENO_PARAMS TYPENAME op) {\
+__STD_USED_FUNC(ABS__##TYPENAME##__##TYPENAME) TYPENAME ABS__##TYPENAME##__##TYPENAME(EN_ENO_PARAMS TYPENAME op)  __STD_USED_BODY(ABS__##TYPENAME##__##TYPENAME, {\
   return ABS_##TYPENAME(EN_ENO op);\
-}
+})
 
 #define __abs_unsigned(TYPENAME) \
 /* explicitly typed function */\
-static inline TYPENAME ABS_##TYPENAME(EN_ENO_PARAMS TYPENAME op){\
+__STD_FUNC TYPENAME ABS_##TYPENAME(EN_ENO_PARAMS TYPENAME op) __STD_BODY({\
   TEST_EN(TYPENAME)\
   return op;\
-}\
+})\
 /* overloaded function */\
-static inline TYPENAME ABS__##TYPENAME##__##TYPENAME(EN_ENO_PARAMS TYPENAME op) {\
+__STD_USED_FUNC(ABS__##TYPENAME##__##TYPENAME) TYPENAME ABS__##TYPENAME##__##TYPENAME(EN_ENO_PARAMS TYPENAME op)  __STD_USED_BODY(ABS__##TYPENAME##__##TYPENAME, {\
   return ABS_##TYPENAME(EN_ENO op);\
-}
+})
 
 __ANY_REAL(__abs_signed)
 __ANY_SINT(__abs_signed)
@@ -491,8 +491,43 @@ __ANY_REAL(__atan)
 /***   Table 24 - Standard arithmetic functions    ***/
 /*****************************************************/
 
+/* Fixed arity versions of the extensible standard functions.
+ *
+ * Most calls to the extensible functions (ADD, MUL, AND, OR, XOR, MAX, MIN, GT, GE, EQ, LE, LT)
+ * pass only 2, 3 or 4 operands. For these calls stage4 calls fname__N2(), fname__N3() or fname__N4()
+ * instead of the fname() defined with a va_list, which the C compiler is unable to inline.
+ * They take the same parameters as the extensible version, including param_count (which is ignored),
+ * so stage4 only needs to change the name of the function being called.
+ *
+ * STEP is the code the extensible version runs for each one of the remaining operands (tmp),
+ * and RESULT the value returned once all the operands have been handled.
+ */
+#define __fixed_arity(fname, RET_TYPENAME, TYPENAME, STEP, RESULT)\
+__STD_USED_FUNC(fname##__N2) RET_TYPENAME fname##__N2(EN_ENO_PARAMS UINT param_count, TYPENAME op1, TYPENAME op2) __STD_USED_BODY(fname##__N2, {\
+  TYPENAME tmp;\
+  TEST_EN(RET_TYPENAME)\
+  tmp = op2; STEP\
+  return RESULT;\
+})\
+__STD_USED_FUNC(fname##__N3) RET_TYPENAME fname##__N3(EN_ENO_PARAMS UINT param_count, TYPENAME op1, TYPENAME op2, TYPENAME op3) __STD_USED_BODY(fname##__N3, {\
+  TYPENAME tmp;\
+  TEST_EN(RET_TYPENAME)\
+  tmp = op2; STEP\
+  tmp = op3; STEP\
+  return RESULT;\
+})\
+__STD_USED_FUNC(fname##__N4) RET_TYPENAME fname##__N4(EN_ENO_PARAMS UINT param_count, TYPENAME op1, TYPENAME op2, TYPENAME op3, TYPENAME op4) __STD_USED_BODY(fname##__N4, {\
+  TYPENAME tmp;\
+  TEST_EN(RET_TYPENAME)\
+  tmp = op2; STEP\
+  tmp = op3; STEP\
+  tmp = op4; STEP\
+  return RESULT;\
+})
+
+
 #define __arith_expand(fname,TYPENAME, OP)\
-static inline TYPENAME fname(EN_ENO_PARAMS UINT param_count, TYPENAME op1, ...){\
+__STD_USED_FUNC(fname) TYPENAME fname(EN_ENO_PARAMS UINT param_count, TYPENAME op1, ...) __STD_USED_BODY(fname, {\
   va_list ap;\
   UINT i;\
   TEST_EN(TYPENAME)\
@@ -505,18 +540,19 @@ static inline TYPENAME fname(EN_ENO_PARAMS UINT param_count, TYPENAME op1, ...){
   \
   va_end (ap);                  /* Clean up.  */\
   return op1;\
-}
+})\
+__fixed_arity(fname, TYPENAME, TYPENAME, op1 = op1 OP tmp;, op1)
 
 #define __arith_static(fname,TYPENAME, OP)\
 /* explicitly typed function */\
-static inline TYPENAME fname##TYPENAME(EN_ENO_PARAMS TYPENAME op1, TYPENAME op2){\
+__STD_FUNC TYPENAME fname##TYPENAME(EN_ENO_PARAMS TYPENAME op1, TYPENAME op2) __STD_BODY({\
   TEST_EN(TYPENAME)\
   return op1 OP op2;\
-}\
+})\
 /* overloaded function */\
-static inline TYPENAME fname##_##TYPENAME##__##TYPENAME##__##TYPENAME(EN_ENO_PARAMS TYPENAME op1, TYPENAME op2){\
+__STD_USED_FUNC(fname##_##TYPENAME##__##TYPENAME##__##TYPENAME) TYPENAME fname##_##TYPENAME##__##TYPENAME##__##TYPENAME(EN_ENO_PARAMS TYPENAME op1, TYPENAME op2) __STD_USED_BODY(fname##_##TYPENAME##__##TYPENAME##__##TYPENAME, {\
   return fname##TYPENAME(EN_ENO op1, op2);\
-}
+})
 
   /**************/
   /*     ADD    */
@@ -548,14 +584,14 @@ __ANY_NUM(__sub)
   /**************/
 #define __div(TYPENAME)\
 /* The explicitly typed standard functions */\
-static inline TYPENAME DIV_##TYPENAME(EN_ENO_PARAMS TYPENAME op1, TYPENAME op2){\
+__STD_FUNC TYPENAME DIV_##TYPENAME(EN_ENO_PARAMS TYPENAME op1, TYPENAME op2) __STD_BODY({\
   TEST_EN_COND(TYPENAME, op2 == 0)\
   return op1 / op2;\
-}\
+})\
 /* The overloaded standard functions */\
-static inline TYPENAME DIV__##TYPENAME##__##TYPENAME##__##TYPENAME(EN_ENO_PARAMS TYPENAME op1, TYPENAME op2){\
+__STD_USED_FUNC(DIV__##TYPENAME##__##TYPENAME##__##TYPENAME) TYPENAME DIV__##TYPENAME##__##TYPENAME##__##TYPENAME(EN_ENO_PARAMS TYPENAME op1, TYPENAME op2) __STD_USED_BODY(DIV__##TYPENAME##__##TYPENAME##__##TYPENAME, {\
   return DIV_##TYPENAME(EN_ENO op1, op2);\
-}
+})
 __ANY_NUM(__div)
 
 
@@ -564,30 +600,43 @@ __ANY_NUM(__div)
   /**************/
 #define __mod(TYPENAME)\
 /* The explicitly typed standard functions */\
-static inline TYPENAME MOD_##TYPENAME(EN_ENO_PARAMS TYPENAME op1, TYPENAME op2){\
+__STD_FUNC TYPENAME MOD_##TYPENAME(EN_ENO_PARAMS TYPENAME op1, TYPENAME op2) __STD_BODY({\
   TEST_EN(TYPENAME)\
   if (op2 == 0) return 0;\
   return op1 % op2;\
-}\
+})\
 /* The overloaded standard functions */\
-static inline TYPENAME MOD__##TYPENAME##__##TYPENAME##__##TYPENAME(EN_ENO_PARAMS TYPENAME op1, TYPENAME op2){\
+__STD_USED_FUNC(MOD__##TYPENAME##__##TYPENAME##__##TYPENAME) TYPENAME MOD__##TYPENAME##__##TYPENAME##__##TYPENAME(EN_ENO_PARAMS TYPENAME op1, TYPENAME op2) __STD_USED_BODY(MOD__##TYPENAME##__##TYPENAME##__##TYPENAME, {\
   return MOD_##TYPENAME(EN_ENO op1, op2);\
-}
+})
 __ANY_INT(__mod)
 
   /**************/
   /*    EXPT    */
   /**************/
 /* overloaded function */
-#define __iec_(in1_TYPENAME,in2_TYPENAME) \
-static inline in1_TYPENAME EXPT__##in1_TYPENAME##__##in1_TYPENAME##__##in2_TYPENAME\
-  (EN_ENO_PARAMS in1_TYPENAME IN1, in2_TYPENAME IN2){\
+/* NOTE: The integer exponents are handled by __expt_int()/__expt_uint() (see iec_std_lib.h),
+ *       by squaring, instead of pow().
+ */
+#define __iec_(in1_TYPENAME,in2_TYPENAME,EXPT_FUNC) \
+__STD_FUNC in1_TYPENAME EXPT__##in1_TYPENAME##__##in1_TYPENAME##__##in2_TYPENAME\
+  (EN_ENO_PARAMS in1_TYPENAME IN1, in2_TYPENAME IN2) __STD_BODY({\
   TEST_EN(in1_TYPENAME)\
-  return __expt(IN1, IN2);\
-}
-#define __in1_anyreal_(in2_TYPENAME)   __ANY_REAL_1(__iec_,in2_TYPENAME)
-__ANY_NUM(__in1_anyreal_)
-#undef __iec_
+  return EXPT_FUNC(IN1, IN2);\
+})
+#define __iec_real_(in1_TYPENAME,in2_TYPENAME) __iec_(in1_TYPENAME,in2_TYPENAME,__MATH_##in1_TYPENAME(pow))
+#define __iec_sint_(in1_TYPENAME,in2_TYPENAME) __iec_(in1_TYPENAME,in2_TYPENAME,__expt_int)
+#define __iec_uint_(in1_TYPENAME,in2_TYPENAME) __iec_(in1_TYPENAME,in2_TYPENAME,__expt_uint)
+#define __in1_anyreal_real_(in2_TYPENAME)   __ANY_REAL_1(__iec_real_,in2_TYPENAME)
+#define __in1_anyreal_sint_(in2_TYPENAME)   __ANY_REAL_1(__iec_sint_,in2_TYPENAME)
+#define __in1_anyreal_uint_(in2_TYPENAME)   __ANY_REAL_1(__iec_uint_,in2_TYPENAME)
+__ANY_REAL(__in1_anyreal_real_)
+__ANY_SINT(__in1_anyreal_sint_)
+__ANY_UINT(__in1_anyreal_uint_)
+#undef __iec_
+#undef __iec_real_
+#undef __iec_sint_
+#undef __iec_uint_
 
   
 
@@ -596,19 +645,19 @@ __ANY_NUM(__in1_anyreal_)
   /***************/
 /* The explicitly typed standard functions */
 #define __iec_(TYPENAME)\
-static inline TYPENAME MOVE_##TYPENAME(EN_ENO_PARAMS TYPENAME op1){\
+__STD_USED_FUNC(MOVE_##TYPENAME) TYPENAME MOVE_##TYPENAME(EN_ENO_PARAMS TYPENAME op1) __STD_USED_BODY(MOVE_##TYPENAME, {\
   TEST_EN(TYPENAME)\
   return op1;\
-}
+})
 __ANY(__iec_)
 #undef __iec_
 
 /* Overloaded function */
 #define __iec_(TYPENAME)\
-static inline TYPENAME MOVE__##TYPENAME##__##TYPENAME(EN_ENO_PARAMS TYPENAME op1){\
+__STD_USED_FUNC(MOVE__##TYPENAME##__##TYPENAME) TYPENAME MOVE__##TYPENAME##__##TYPENAME(EN_ENO_PARAMS TYPENAME op1) __STD_USED_BODY(MOVE__##TYPENAME##__##TYPENAME, {\
   TEST_EN(TYPENAME)\
   return op1;\
-}
+})
 __ANY(__iec_)
 #undef __iec_
 
@@ -633,20 +682,20 @@ __ANY(__iec_)
 #define __in1_anynbit_(in2_TYPENAME)   __ANY_NBIT_1(__iec_,in2_TYPENAME)
 
 #define __shift_(fname, in1_TYPENAME, in2_TYPENAME, OP)\
-static inline in1_TYPENAME fname(EN_ENO_PARAMS in1_TYPENAME IN, in2_TYPENAME N) {\
+__STD_USED_FUNC(fname) in1_TYPENAME fname(EN_ENO_PARAMS in1_TYPENAME IN, in2_TYPENAME N)  __STD_USED_BODY(fname, {\
   TEST_EN(in1_TYPENAME)\
   return IN OP N;\
-}
+})
 
   /**************/
   /*     SHL    */
   /**************/
 #define __iec_(TYPENAME) \
 /* Overloaded function */\
-static inline BOOL SHL__BOOL__##TYPENAME(EN_ENO_PARAMS BOOL IN, TYPENAME N) { \
+__STD_USED_FUNC(SHL__BOOL__##TYPENAME) BOOL SHL__BOOL__##TYPENAME(EN_ENO_PARAMS BOOL IN, TYPENAME N)  __STD_USED_BODY(SHL__BOOL__##TYPENAME, { \
   TEST_EN(BOOL);\
   return (N==0)? IN : __INIT_BOOL;  /* shifting by N>1 will always introduce a 0 */\
-}
+})
 __ANY_INT(__iec_)
 #undef __iec_
 
@@ -662,10 +711,10 @@ __ANY_INT(__in1_anynbit_)
   /**************/
 #define __iec_(TYPENAME) \
 /* Overloaded function */\
-static inline BOOL SHR__BOOL__##TYPENAME(EN_ENO_PARAMS BOOL IN, TYPENAME N) { \
+__STD_USED_FUNC(SHR__BOOL__##TYPENAME) BOOL SHR__BOOL__##TYPENAME(EN_ENO_PARAMS BOOL IN, TYPENAME N)  __STD_USED_BODY(SHR__BOOL__##TYPENAME, { \
   TEST_EN(BOOL);\
   return (N==0)? IN : __INIT_BOOL;  /* shifting by N>1 will always introduce a 0 */\
-}
+})
 __ANY_INT(__iec_)
 #undef __iec_
 
@@ -681,20 +730,20 @@ __ANY_INT(__in1_anynbit_)
   /**************/
 #define __iec_(TYPENAME) \
 /* Overloaded function */\
-static inline BOOL ROR__BOOL__##TYPENAME(EN_ENO_PARAMS BOOL IN, TYPENAME N) { \
+__STD_USED_FUNC(ROR__BOOL__##TYPENAME) BOOL ROR__BOOL__##TYPENAME(EN_ENO_PARAMS BOOL IN, TYPENAME N)  __STD_USED_BODY(ROR__BOOL__##TYPENAME, { \
   TEST_EN(BOOL);\
   return IN; /* rotating a single bit by any value N will not change that bit! */\
-}
+})
 __ANY_INT(__iec_)
 #undef __iec_
 
 
 #define __iec_(in1_TYPENAME,in2_TYPENAME) \
-static inline in1_TYPENAME ROR__##in1_TYPENAME##__##in1_TYPENAME##__##in2_TYPENAME(EN_ENO_PARAMS in1_TYPENAME IN, in2_TYPENAME N){\
+__STD_USED_FUNC(ROR__##in1_TYPENAME##__##in1_TYPENAME##__##in2_TYPENAME) in1_TYPENAME ROR__##in1_TYPENAME##__##in1_TYPENAME##__##in2_TYPENAME(EN_ENO_PARAMS in1_TYPENAME IN, in2_TYPENAME N) __STD_USED_BODY(ROR__##in1_TYPENAME##__##in1_TYPENAME##__##in2_TYPENAME, {\
   TEST_EN(in1_TYPENAME)\
   N %= 8*sizeof(in1_TYPENAME);\
   return (IN >> N) | (IN << (8*sizeof(in1_TYPENAME)-N));\
-}
+})
 __ANY_INT(__in1_anynbit_)
 #undef __iec_
 
@@ -704,20 +753,20 @@ __ANY_INT(__in1_anynbit_)
   /**************/
 #define __iec_(TYPENAME) \
 /* Overloaded function */\
-static inline BOOL ROL__BOOL__##TYPENAME(EN_ENO_PARAMS BOOL IN, TYPENAME N) { \
+__STD_USED_FUNC(ROL__BOOL__##TYPENAME) BOOL ROL__BOOL__##TYPENAME(EN_ENO_PARAMS BOOL IN, TYPENAME N)  __STD_USED_BODY(ROL__BOOL__##TYPENAME, { \
   TEST_EN(BOOL);\
   return IN; /* rotating a single bit by any value N will not change that bit! */\
-}
+})
 __ANY_INT(__iec_)
 #undef __iec_
 
 
 #define __iec_(in1_TYPENAME,in2_TYPENAME) \
-static inline in1_TYPENAME ROL__##in1_TYPENAME##__##in1_TYPENAME##__##in2_TYPENAME(EN_ENO_PARAMS in1_TYPENAME IN, in2_TYPENAME N){\
+__STD_USED_FUNC(ROL__##in1_TYPENAME##__##in1_TYPENAME##__##in2_TYPENAME) in1_TYPENAME ROL__##in1_TYPENAME##__##in1_TYPENAME##__##in2_TYPENAME(EN_ENO_PARAMS in1_TYPENAME IN, in2_TYPENAME N) __STD_USED_BODY(ROL__##in1_TYPENAME##__##in1_TYPENAME##__##in2_TYPENAME, {\
   TEST_EN(in1_TYPENAME)\
   N %= 8*sizeof(in1_TYPENAME);\
   return (IN << N) | (IN >> (8*sizeof(in1_TYPENAME)-N));\
-}
+})
 __ANY_INT(__in1_anynbit_)
 #undef __iec_
 
@@ -755,7 +804,7 @@ __ANY_NBIT(__iec_)
   /*     XOR    */
   /**************/
 #define __xorbool_expand(fname) \
-static inline BOOL fname(EN_ENO_PARAMS UINT param_count, BOOL op1, ...){ \
+__STD_USED_FUNC(fname) BOOL fname(EN_ENO_PARAMS UINT param_count, BOOL op1, ...) __STD_USED_BODY(fname, { \
   va_list ap; \
   UINT i; \
   TEST_EN(BOOL) \
@@ -769,7 +818,8 @@ static inline BOOL fname(EN_ENO_PARAMS UINT param_count, BOOL op1, ...){ \
 \
   va_end (ap);                  /* Clean up.  */ \
   return op1; \
-}
+}) \
+__fixed_arity(fname, BOOL, BOOL, op1 = (op1 && !tmp) || (!op1 && tmp);, op1)
 
 __xorbool_expand(XOR_BOOL) /* The explicitly typed standard functions */
 __xorbool_expand(XOR__BOOL__BOOL) /* Overloaded function */
@@ -785,32 +835,32 @@ __ANY_NBIT(__iec_)
   /*     NOT    */
   /**************/
 /* The explicitly typed standard functions */
-static inline BOOL NOT_BOOL(EN_ENO_PARAMS BOOL op1){
+__STD_USED_FUNC(NOT_BOOL) BOOL NOT_BOOL(EN_ENO_PARAMS BOOL op1) __STD_USED_BODY(NOT_BOOL, {
   TEST_EN(BOOL)
   return !op1;
-}
+})
 
 /* Overloaded function */
-static inline BOOL NOT__BOOL__BOOL(EN_ENO_PARAMS BOOL op1){
+__STD_USED_FUNC(NOT__BOOL__BOOL) BOOL NOT__BOOL__BOOL(EN_ENO_PARAMS BOOL op1) __STD_USED_BODY(NOT__BOOL__BOOL, {
   TEST_EN(BOOL)
   return !op1;
-}
+})
 
 /* The explicitly typed standard functions */
 #define __iec_(TYPENAME)\
-static inline TYPENAME NOT_##TYPENAME(EN_ENO_PARAMS TYPENAME op1){\
+__STD_USED_FUNC(NOT_##TYPENAME) TYPENAME NOT_##TYPENAME(EN_ENO_PARAMS TYPENAME op1) __STD_USED_BODY(NOT_##TYPENAME, {\
   TEST_EN(TYPENAME)\
   return ~op1;\
-}
+})
 __ANY_NBIT(__iec_)
 #undef __iec_
 
 /* Overloaded function */
 #define __iec_(TYPENAME)\
-static inline TYPENAME NOT__##TYPENAME##__##TYPENAME(EN_ENO_PARAMS TYPENAME op1){\
+__STD_USED_FUNC(NOT__##TYPENAME##__##TYPENAME) TYPENAME NOT__##TYPENAME##__##TYPENAME(EN_ENO_PARAMS TYPENAME op1) __STD_USED_BODY(NOT__##TYPENAME##__##TYPENAME, {\
   TEST_EN(TYPENAME)\
   return ~op1;\
-}
+})
 __ANY_NBIT(__iec_)
 #undef __iec_
 
@@ -836,19 +886,19 @@ __ANY_NBIT(__iec_)
 
 /* The explicitly typed standard functions */
 #define __iec_(TYPENAME)\
-static inline TYPENAME SEL_##TYPENAME(EN_ENO_PARAMS BOOL G, TYPENAME op0, TYPENAME op1){\
+__STD_USED_FUNC(SEL_##TYPENAME) TYPENAME SEL_##TYPENAME(EN_ENO_PARAMS BOOL G, TYPENAME op0, TYPENAME op1) __STD_USED_BODY(SEL_##TYPENAME, {\
   TEST_EN(TYPENAME)\
   return G ? op1 : op0;\
-}
+})
 __ANY(__iec_)
 #undef __iec_
 
 /* Overloaded function */
 #define __iec_(TYPENAME)\
-static inline TYPENAME SEL__##TYPENAME##__BOOL__##TYPENAME##__##TYPENAME(EN_ENO_PARAMS BOOL G, TYPENAME op0, TYPENAME op1){\
+__STD_USED_FUNC(SEL__##TYPENAME##__BOOL__##TYPENAME##__##TYPENAME) TYPENAME SEL__##TYPENAME##__BOOL__##TYPENAME##__##TYPENAME(EN_ENO_PARAMS BOOL G, TYPENAME op0, TYPENAME op1) __STD_USED_BODY(SEL__##TYPENAME##__BOOL__##TYPENAME##__##TYPENAME, {\
   TEST_EN(TYPENAME)\
   return G ? op1 : op0;\
-}
+})
 __ANY(__iec_)
 #undef __iec_
 
@@ -858,7 +908,7 @@ __ANY(__iec_)
     /**************/
 
 #define __extrem_(fname,TYPENAME, COND) \
-static inline TYPENAME fname(EN_ENO_PARAMS UINT param_count, TYPENAME op1, ...){\
+__STD_USED_FUNC(fname) TYPENAME fname(EN_ENO_PARAMS UINT param_count, TYPENAME op1, ...) __STD_USED_BODY(fname, {\
   va_list ap;\
   UINT i;\
   TEST_EN(TYPENAME)\
@@ -872,7 +922,8 @@ static inline TYPENAME fname(EN_ENO_PARAMS UINT param_count, TYPENAME op1, ...){
   \
   va_end (ap);                  /* Clean up.  */\
   return op1;\
-}
+})\
+__fixed_arity(fname, TYPENAME, TYPENAME, op1 = COND ? tmp : op1;, op1)
 
 /* Max for numerical data types */	
 #define __iec_(TYPENAME) \
@@ -890,10 +941,10 @@ __ANY_DATE(__iec_)
 __iec_(TIME)
 #undef __iec_
 
-static inline int __str_cmp(uint8_t* str1, __strlen_t len1, uint8_t* str2, __strlen_t len2) { 
+__STD_FUNC int __str_cmp(uint8_t* str1, __strlen_t len1, uint8_t* str2, __strlen_t len2)  __STD_BODY({ 
     int cmp = memcmp(str1, str2, len1 < len2 ? len1 : len2);
     return cmp ? cmp : (len1 > len2 ? 1 : (len1 < len2 ? - 1 : 0));
-}
+})
 #define __STR_CMP(str1, str2) __str_cmp(str1.body, str1.len, str2.body, str2.len)
 
 /* Max for string data types */	
@@ -930,15 +981,15 @@ __extrem_(MIN__STRING__STRING, STRING, __STR_CMP(op1,tmp) > 0) /* Overloaded fun
 /* Limit for numerical data types */
 #define __iec_(TYPENAME)\
 /* The explicitly typed standard functions */\
-static inline TYPENAME LIMIT_##TYPENAME(EN_ENO_PARAMS TYPENAME MN, TYPENAME IN, TYPENAME MX){\
+__STD_USED_FUNC(LIMIT_##TYPENAME) TYPENAME LIMIT_##TYPENAME(EN_ENO_PARAMS TYPENAME MN, TYPENAME IN, TYPENAME MX) __STD_USED_BODY(LIMIT_##TYPENAME, {\
   TEST_EN(TYPENAME)\
   return IN > MN ? IN < MX ? IN : MX : MN;\
-}\
+})\
 /* Overloaded function */\
-static inline TYPENAME LIMIT__##TYPENAME##__##TYPENAME##__##TYPENAME##__##TYPENAME(EN_ENO_PARAMS TYPENAME MN, TYPENAME IN, TYPENAME MX){\
+__STD_USED_FUNC(LIMIT__##TYPENAME##__##TYPENAME##__##TYPENAME##__##TYPENAME) TYPENAME LIMIT__##TYPENAME##__##TYPENAME##__##TYPENAME##__##TYPENAME(EN_ENO_PARAMS TYPENAME MN, TYPENAME IN, TYPENAME MX) __STD_USED_BODY(LIMIT__##TYPENAME##__##TYPENAME##__##TYPENAME##__##TYPENAME, {\
   TEST_EN(TYPENAME)\
   return IN > MN ? IN < MX ? IN : MX : MN;\
-}
+})
 __ANY_NBIT(__iec_)
 __ANY_NUM(__iec_)
 #undef __iec_
@@ -947,19 +998,19 @@ __ANY_NUM(__iec_)
 /* Limit for time data types */	
 #define __iec_(TYPENAME)\
 /* The explicitly typed standard functions */\
-static inline TYPENAME LIMIT_##TYPENAME(EN_ENO_PARAMS TYPENAME MN, TYPENAME IN, TYPENAME MX){\
+__STD_USED_FUNC(LIMIT_##TYPENAME) TYPENAME LIMIT_##TYPENAME(EN_ENO_PARAMS TYPENAME MN, TYPENAME IN, TYPENAME MX) __STD_USED_BODY(LIMIT_##TYPENAME, {\
     TEST_EN(TYPENAME)\
     return __time_cmp(IN, MN) > 0 ? /* IN>MN ?*/\
            __time_cmp(IN, MX) < 0 ? /* IN<MX ?*/\
            IN : MX : MN;\
-}\
+})\
 /* Overloaded function */\
-static inline TYPENAME LIMIT__##TYPENAME##__##TYPENAME##__##TYPENAME##__##TYPENAME(EN_ENO_PARAMS TYPENAME MN, TYPENAME IN, TYPENAME MX){\
+__STD_USED_FUNC(LIMIT__##TYPENAME##__##TYPENAME##__##TYPENAME##__##TYPENAME) TYPENAME LIMIT__##TYPENAME##__##TYPENAME##__##TYPENAME##__##TYPENAME(EN_ENO_PARAMS TYPENAME MN, TYPENAME IN, TYPENAME MX) __STD_USED_BODY(LIMIT__##TYPENAME##__##TYPENAME##__##TYPENAME##__##TYPENAME, {\
     TEST_EN(TYPENAME)\
     return __time_cmp(IN, MN) > 0 ? /* IN>MN ?*/\
            __time_cmp(IN, MX) < 0 ? /* IN<MX ?*/\
            IN : MX : MN;\
-}
+})
 
 __ANY_DATE(__iec_)
 __iec_(TIME)
@@ -967,16 +1018,16 @@ __iec_(TIME)
 
 /* Limit for string data types */	
 /* The explicitly typed standard functions */
-static inline STRING LIMIT_STRING(EN_ENO_PARAMS STRING MN, STRING IN, STRING MX){
+__STD_USED_FUNC(LIMIT_STRING) STRING LIMIT_STRING(EN_ENO_PARAMS STRING MN, STRING IN, STRING MX) __STD_USED_BODY(LIMIT_STRING, {
     TEST_EN(STRING)
     return __STR_CMP(IN, MN) > 0 ? __STR_CMP(IN, MX) < 0 ? IN : MX : MN;
-}
+})
 
 /* Overloaded function */
-static inline STRING LIMIT__STRING__STRING__STRING__STRING(EN_ENO_PARAMS STRING MN, STRING IN, STRING MX){
+__STD_USED_FUNC(LIMIT__STRING__STRING__STRING__STRING) STRING LIMIT__STRING__STRING__STRING__STRING(EN_ENO_PARAMS STRING MN, STRING IN, STRING MX) __STD_USED_BODY(LIMIT__STRING__STRING__STRING__STRING, {
     TEST_EN(STRING)
     return __STR_CMP(IN, MN) > 0 ? __STR_CMP(IN, MX) < 0 ? IN : MX : MN;
-}
+})
 
 
     /**************/
@@ -988,7 +1039,7 @@ static inline STRING LIMIT__STRING__STRING__STRING__STRING(EN_ENO_PARAMS STRING
 /* The explicitly typed standard functions */
 #define __in1_anyint_(in2_TYPENAME)   __ANY_INT_1(__iec_,in2_TYPENAME)
 #define __iec_(in1_TYPENAME,in2_TYPENAME) \
-static inline in2_TYPENAME MUX__##in2_TYPENAME##__##in1_TYPENAME##__##in2_TYPENAME(EN_ENO_PARAMS in1_TYPENAME K, UINT param_count, ...){\
+__STD_USED_FUNC(MUX__##in2_TYPENAME##__##in1_TYPENAME##__##in2_TYPENAME) in2_TYPENAME MUX__##in2_TYPENAME##__##in1_TYPENAME##__##in2_TYPENAME(EN_ENO_PARAMS in1_TYPENAME K, UINT param_count, ...) __STD_USED_BODY(MUX__##in2_TYPENAME##__##in1_TYPENAME##__##in2_TYPENAME, {\
   va_list ap;\
   UINT i;\
   in2_TYPENAME tmp;\
@@ -1009,7 +1060,7 @@ static inline in2_TYPENAME MUX__##in2_TYPENAME##__##in1_TYPENAME##__##in2_TYPENA
   \
   va_end (ap);                  /* Clean up.  */\
   return tmp;\
-}
+})
 
 __ANY(__in1_anyint_)
 #undef __iec_
@@ -1021,7 +1072,7 @@ __ANY(__in1_anyint_)
 /******************************************/
 
 #define __compare_(fname,TYPENAME, COND) \
-static inline BOOL fname(EN_ENO_PARAMS UINT param_count, TYPENAME op1, ...){\
+__STD_USED_FUNC(fname) BOOL fname(EN_ENO_PARAMS UINT param_count, TYPENAME op1, ...) __STD_USED_BODY(fname, {\
   va_list ap;\
   UINT i;\
   TEST_EN(BOOL)\
@@ -1043,7 +1094,8 @@ static inline BOOL fname(EN_ENO_PARAMS UINT param_count, TYPENAME op1, ...){\
   \
   va_end (ap);                  /* Clean up.  */\
   return 1;\
-}
+})\
+__fixed_arity(fname, BOOL, TYPENAME, if (!(COND)) return 0; op1 = tmp;, 1)
 
 #define __compare_num(fname, TYPENAME, TEST) __compare_(fname, TYPENAME, op1 TEST tmp )
 #define __compare_time(fname, TYPENAME, TEST) __compare_(fname, TYPENAME, __time_cmp(op1, tmp) TEST 0)
@@ -1174,22 +1226,22 @@ __compare_string(LE__BOOL__STRING, <= ) /* Overloaded function */
     /*     NE     */
     /**************/
 #define __ne_num(fname, TYPENAME) \
-static inline BOOL fname(EN_ENO_PARAMS TYPENAME op1, TYPENAME op2){\
+__STD_USED_FUNC(fname) BOOL fname(EN_ENO_PARAMS TYPENAME op1, TYPENAME op2) __STD_USED_BODY(fname, {\
   TEST_EN(BOOL)\
   return op1 != op2 ? 1 : 0;\
-}
+})
 
 #define __ne_time(fname, TYPENAME) \
-static inline BOOL fname(EN_ENO_PARAMS TYPENAME op1, TYPENAME op2){\
+__STD_USED_FUNC(fname) BOOL fname(EN_ENO_PARAMS TYPENAME op1, TYPENAME op2) __STD_USED_BODY(fname, {\
   TEST_EN(BOOL)\
   return __time_cmp(op1, op2) != 0 ? 1 : 0;\
-}
+})
 
 #define __ne_string(fname, TYPENAME) \
-static inline BOOL fname(EN_ENO_PARAMS TYPENAME op1, TYPENAME op2){\
+__STD_USED_FUNC(fname) BOOL fname(EN_ENO_PARAMS TYPENAME op1, TYPENAME op2) __STD_USED_BODY(fname, {\
   TEST_EN(BOOL)\
   return __STR_CMP(op1, op2) != 0 ? 1 : 0;\
-}
+})
 
 /* Comparison for numerical data types */
 #define __iec_(TYPENAME) \
@@ -1237,14 +1289,14 @@ __ne_string(NE__BOOL__STRING__STRING, STRING) /* Overloaded function */
     /***************/
     /*     LEN     */
     /***************/
-static inline __strlen_t __len(STRING IN) {return IN.len;}
+__STD_FUNC __strlen_t __len(STRING IN)  __STD_BODY({return IN.len;})
 
 /* A function, with 1 input paramter, implementing a generic OPERATION */
 #define __genoper_1p_(fname,ret_TYPENAME, par_TYPENAME, OPERATION) \
-static inline ret_TYPENAME fname(EN_ENO_PARAMS par_TYPENAME par1){\
+__STD_USED_FUNC(fname) ret_TYPENAME fname(EN_ENO_PARAMS par_TYPENAME par1) __STD_USED_BODY(fname, {\
   TEST_EN(ret_TYPENAME)\
   return (ret_TYPENAME)OPERATION(par1);\
-}
+})
 
 #define __iec_(TYPENAME) __genoper_1p_(LEN__##TYPENAME##__STRING, TYPENAME, STRING, __len)
 __ANY_INT(__iec_)
@@ -1256,15 +1308,15 @@ __ANY_INT(__iec_)
     /****************/
 
 #define __left(TYPENAME) \
-static inline STRING LEFT__STRING__STRING__##TYPENAME(EN_ENO_PARAMS STRING IN, TYPENAME L){\
+__STD_USED_FUNC(LEFT__STRING__STRING__##TYPENAME) STRING LEFT__STRING__STRING__##TYPENAME(EN_ENO_PARAMS STRING IN, TYPENAME L) __STD_USED_BODY(LEFT__STRING__STRING__##TYPENAME, {\
     STRING res;\
     TEST_EN_COND(STRING, L < 0)\
-    res = __INIT_STRING;\
+    res.len = 0;\
     L = L < (TYPENAME)IN.len ? L : (TYPENAME)IN.len;\
     memcpy(&res.body, &IN.body, (size_t)L);\
     res.len = (__strlen_t)L;\
     return res;\
-}
+})
 __ANY_INT(__left)
 
 
@@ -1273,15 +1325,15 @@ __ANY_INT(__left)
     /*****************/
 
 #define __right(TYPENAME) \
-static inline STRING RIGHT__STRING__STRING__##TYPENAME(EN_ENO_PARAMS STRING IN, TYPENAME L){\
+__STD_USED_FUNC(RIGHT__STRING__STRING__##TYPENAME) STRING RIGHT__STRING__STRING__##TYPENAME(EN_ENO_PARAMS STRING IN, TYPENAME L) __STD_USED_BODY(RIGHT__STRING__STRING__##TYPENAME, {\
   STRING res;\
   TEST_EN_COND(STRING, L < 0)\
-  res = __INIT_STRING;\
+  res.len = 0;\
   L = L < (TYPENAME)IN.len ? L : (TYPENAME)IN.len;\
   memcpy(&res.body, &IN.body[(TYPENAME)IN.len - L], (size_t)L);\
   res.len = (__strlen_t)L;\
   return res;\
-}
+})
 __ANY_INT(__right)
 
 
@@ -1290,10 +1342,10 @@ __ANY_INT(__right)
     /***************/
 
 #define __mid(TYPENAME) \
-static inline STRING MID__STRING__STRING__##TYPENAME##__##TYPENAME(EN_ENO_PARAMS STRING IN, TYPENAME L, TYPENAME P){\
+__STD_USED_FUNC(MID__STRING__STRING__##TYPENAME##__##TYPENAME) STRING MID__STRING__STRING__##TYPENAME##__##TYPENAME(EN_ENO_PARAMS STRING IN, TYPENAME L, TYPENAME P) __STD_USED_BODY(MID__STRING__STRING__##TYPENAME##__##TYPENAME, {\
   STRING res;\
   TEST_EN_COND(STRING, L < 0 || P < 0)\
-  res = __INIT_STRING;\
+  res.len = 0;\
   if(P <= (TYPENAME)IN.len){\
 	P -= 1; /* now can be used as [index]*/\
 	L = L + P <= (TYPENAME)IN.len ? L : (TYPENAME)IN.len - P;\
@@ -1301,7 +1353,7 @@ static inline STRING MID__STRING__STRING__##TYPENAME##__##TYPENAME(EN_ENO_PARAMS
 	res.len = (__strlen_t)L;\
   }\
   return res;\
-}
+})
 __ANY_INT(__mid)
 
 
@@ -1309,61 +1361,83 @@ __ANY_INT(__mid)
     /*     CONCAT     */
     /******************/
 
-static inline STRING CONCAT(EN_ENO_PARAMS UINT param_count, ...){
+/* Append IN to the end of *res, copying only the characters in use (not the whole STRING body) */
+__STD_FUNC void __pconcat(STRING *res, const STRING *IN) __STD_BODY({
+  __strlen_t charrem = STR_MAX_LEN - res->len;
+  __strlen_t to_write = IN->len > charrem ? charrem : IN->len;
+  memcpy(&res->body[res->len], &IN->body, to_write);
+  res->len += to_write;
+})
+
+__STD_USED_FUNC(CONCAT) STRING CONCAT(EN_ENO_PARAMS UINT param_count, ...) __STD_USED_BODY(CONCAT, {
   UINT i;
   STRING res;
   va_list ap;
-  __strlen_t charcount;
   TEST_EN(STRING)
-  charcount = 0;
-  res = __INIT_STRING;
+  res.len = 0;
 
   va_start (ap, param_count);         /* Initialize the argument list.  */
 
-  for (i = 0; i < param_count && charcount < STR_MAX_LEN; i++)
+  for (i = 0; i < param_count && res.len < STR_MAX_LEN; i++)
   {
     STRING tmp = va_arg(ap, STRING);
-    __strlen_t charrem = STR_MAX_LEN - charcount;
-    __strlen_t to_write = tmp.len > charrem ? charrem : tmp.len;
-    memcpy(&res.body[charcount], &tmp.body , to_write);
-    charcount += to_write;
+    __pconcat(&res, &tmp);
   }
 
-  res.len = charcount;
-
   va_end (ap);                  /* Clean up.  */
   return res;
-}
+})
+
+/* Fixed arity versions of CONCAT (see __fixed_arity() above). Unlike the variadic CONCAT(), these
+ * may be inlined by the C compiler, so the STRING parameters need not be copied onto the stack.
+ */
+__STD_USED_FUNC(CONCAT__N2) STRING CONCAT__N2(EN_ENO_PARAMS UINT param_count, STRING op1, STRING op2) __STD_USED_BODY(CONCAT__N2, {
+  TEST_EN(STRING)
+  __pconcat(&op1, &op2);
+  return op1;
+})
+__STD_USED_FUNC(CONCAT__N3) STRING CONCAT__N3(EN_ENO_PARAMS UINT param_count, STRING op1, STRING op2, STRING op3) __STD_USED_BODY(CONCAT__N3, {
+  TEST_EN(STRING)
+  __pconcat(&op1, &op2);
+  __pconcat(&op1, &op3);
+  return op1;
+})
+__STD_USED_FUNC(CONCAT__N4) STRING CONCAT__N4(EN_ENO_PARAMS UINT param_count, STRING op1, STRING op2, STRING op3, STRING op4) __STD_USED_BODY(CONCAT__N4, {
+  TEST_EN(STRING)
+  __pconcat(&op1, &op2);
+  __pconcat(&op1, &op3);
+  __pconcat(&op1, &op4);
+  return op1;
+})
 
     /******************/
     /*     INSERT     */
     /******************/
 
-static inline STRING __insert(STRING IN1, STRING IN2, __strlen_t P){
+__STD_FUNC STRING __pinsert(const STRING *IN1, const STRING *IN2, __strlen_t P) __STD_BODY({
     STRING res;
     __strlen_t to_copy;
-    res = __INIT_STRING;
 
-    to_copy = P > IN1.len ? IN1.len : P;
-    memcpy(&res.body, &IN1.body , to_copy);
+    to_copy = P > IN1->len ? IN1->len : P;
+    memcpy(&res.body, &IN1->body , to_copy);
     P = res.len = to_copy;
 
-    to_copy = IN2.len + res.len > STR_MAX_LEN ? STR_MAX_LEN - res.len : IN2.len;
-    memcpy(&res.body[res.len], &IN2.body , to_copy);
+    to_copy = IN2->len + res.len > STR_MAX_LEN ? STR_MAX_LEN - res.len : IN2->len;
+    memcpy(&res.body[res.len], &IN2->body , to_copy);
     res.len += to_copy;
 
-    to_copy = IN1.len - P < STR_MAX_LEN - res.len ? IN1.len - P : STR_MAX_LEN - res.len ;
-    memcpy(&res.body[res.len], &IN1.body[P] , to_copy);
+    to_copy = IN1->len - P < STR_MAX_LEN - res.len ? IN1->len - P : STR_MAX_LEN - res.len ;
+    memcpy(&res.body[res.len], &IN1->body[P] , to_copy);
     res.len += to_copy;
 
     return res;
-}
+})
 
 #define __iec_(TYPENAME) \
-static inline STRING INSERT__STRING__STRING__STRING__##TYPENAME(EN_ENO_PARAMS STRING str1, STRING str2, TYPENAME P){\
+__STD_USED_FUNC(INSERT__STRING__STRING__STRING__##TYPENAME) STRING INSERT__STRING__STRING__STRING__##TYPENAME(EN_ENO_PARAMS STRING str1, STRING str2, TYPENAME P) __STD_USED_BODY(INSERT__STRING__STRING__STRING__##TYPENAME, {\
   TEST_EN_COND(STRING, P < 0)\
-  return (STRING)__insert(str1,str2,(__strlen_t)P);\
-}
+  return (STRING)__pinsert(&str1,&str2,(__strlen_t)P);\
+})
 __ANY_INT(__iec_)
 #undef __iec_
 
@@ -1372,29 +1446,28 @@ __ANY_INT(__iec_)
     /*     DELETE     */
     /******************/
 
-static inline STRING __delete(STRING IN, __strlen_t L, __strlen_t P){
+__STD_FUNC STRING __pdelete(const STRING *IN, __strlen_t L, __strlen_t P) __STD_BODY({
     STRING res;
     __strlen_t to_copy;
-    res = __INIT_STRING;
 
-    to_copy = P > IN.len ? IN.len : P-1;
-    memcpy(&res.body, &IN.body , to_copy);
+    to_copy = P > IN->len ? IN->len : P-1;
+    memcpy(&res.body, &IN->body , to_copy);
     P = res.len = to_copy;
 
-    if( IN.len > P + L ){
-        to_copy = IN.len - P - L;
-        memcpy(&res.body[res.len], &IN.body[P + L], to_copy);
+    if( IN->len > P + L ){
+        to_copy = IN->len - P - L;
+        memcpy(&res.body[res.len], &IN->body[P + L], to_copy);
         res.len += to_copy;
     }
 
     return res;
-}
+})
 
 #define __iec_(TYPENAME) \
-static inline STRING DELETE__STRING__STRING__##TYPENAME##__##TYPENAME(EN_ENO_PARAMS STRING str, TYPENAME L, TYPENAME P){\
+__STD_USED_FUNC(DELETE__STRING__STRING__##TYPENAME##__##TYPENAME) STRING DELETE__STRING__STRING__##TYPENAME##__##TYPENAME(EN_ENO_PARAMS STRING str, TYPENAME L, TYPENAME P) __STD_USED_BODY(DELETE__STRING__STRING__##TYPENAME##__##TYPENAME, {\
   TEST_EN_COND(STRING, L < 0 || P < 0)\
-  return (STRING)__delete(str,(__strlen_t)L,(__strlen_t)P);\
-}
+  return (STRING)__pdelete(&str,(__strlen_t)L,(__strlen_t)P);\
+})
 __ANY_INT(__iec_)
 #undef __iec_
 
@@ -1403,39 +1476,38 @@ __ANY_INT(__iec_)
     /*     REPLACE     */
     /*******************/
 
-static inline STRING __replace(STRING IN1, STRING IN2, __strlen_t L, __strlen_t P){
+__STD_FUNC STRING __preplace(const STRING *IN1, const STRING *IN2, __strlen_t L, __strlen_t P) __STD_BODY({
     STRING res;
     __strlen_t to_copy;
-    res = __INIT_STRING;
 
-    to_copy = P > IN1.len ? IN1.len : P-1;
-    memcpy(&res.body, &IN1.body , to_copy);
+    to_copy = P > IN1->len ? IN1->len : P-1;
+    memcpy(&res.body, &IN1->body , to_copy);
     P = res.len = to_copy;
 
-    to_copy = IN2.len < L ? IN2.len : L;
+    to_copy = IN2->len < L ? IN2->len : L;
 
     if( to_copy + res.len > STR_MAX_LEN )
        to_copy = STR_MAX_LEN - res.len;
 
-    memcpy(&res.body[res.len], &IN2.body , to_copy);
+    memcpy(&res.body[res.len], &IN2->body , to_copy);
     res.len += to_copy;
 
     P += L;
-    if( res.len <  STR_MAX_LEN && P < IN1.len)
+    if( res.len <  STR_MAX_LEN && P < IN1->len)
     {
-        to_copy = IN1.len - P;
-        memcpy(&res.body[res.len], &IN1.body[P] , to_copy);
+        to_copy = IN1->len - P;
+        memcpy(&res.body[res.len], &IN1->body[P] , to_copy);
         res.len += to_copy;
     }
 
     return res;
-}
+})
 
 #define __iec_(TYPENAME) \
-static inline STRING REPLACE__STRING__STRING__STRING__##TYPENAME##__##TYPENAME(EN_ENO_PARAMS STRING str1, STRING str2, TYPENAME L, TYPENAME P){\
+__STD_USED_FUNC(REPLACE__STRING__STRING__STRING__##TYPENAME##__##TYPENAME) STRING REPLACE__STRING__STRING__STRING__##TYPENAME##__##TYPENAME(EN_ENO_PARAMS STRING str1, STRING str2, TYPENAME L, TYPENAME P) __STD_USED_BODY(REPLACE__STRING__STRING__STRING__##TYPENAME##__##TYPENAME, {\
   TEST_EN_COND(STRING, L < 0 || P < 0)\
-  return (STRING)__replace(str1,str2,(__strlen_t)L,(__strlen_t)P);\
-}
+  return (STRING)__preplace(&str1,&str2,(__strlen_t)L,(__strlen_t)P);\
+})
 __ANY_INT(__iec_)
 #undef __iec_
 
@@ -1443,7 +1515,7 @@ __ANY_INT(__iec_)
     /*     FIND     */
     /****************/
 
-static inline __strlen_t __pfind(STRING* IN1, STRING* IN2){
+__STD_FUNC __strlen_t __pfind(STRING* IN1, STRING* IN2) __STD_BODY({
     UINT count1 = 0; /* offset of first matching char in IN1 */
     UINT count2 = 0; /* count of matching char */
     if(!(IN2->len > 0 && IN1->len >= IN2->len)) return 0;
@@ -1458,13 +1530,13 @@ static inline __strlen_t __pfind(STRING* IN1, STRING* IN2){
         }
     }
     return count2 == IN2->len ? count1 + 1 : 0;
-}
+})
 
 #define __iec_(TYPENAME) \
-static inline TYPENAME FIND__##TYPENAME##__STRING__STRING(EN_ENO_PARAMS STRING str1, STRING str2){\
+__STD_USED_FUNC(FIND__##TYPENAME##__STRING__STRING) TYPENAME FIND__##TYPENAME##__STRING__STRING(EN_ENO_PARAMS STRING str1, STRING str2) __STD_USED_BODY(FIND__##TYPENAME##__STRING__STRING, {\
   TEST_EN(TYPENAME)\
   return (TYPENAME)__pfind(&str1,&str2);\
-}
+})
 __ANY_INT(__iec_)
 #undef __iec_
 
@@ -1481,165 +1553,165 @@ __ANY_INT(__iec_)
 /**************************************/
 
 
-static inline TIME ADD_TIME(EN_ENO_PARAMS TIME IN1, TIME IN2){
+__STD_USED_FUNC(ADD_TIME) TIME ADD_TIME(EN_ENO_PARAMS TIME IN1, TIME IN2) __STD_USED_BODY(ADD_TIME, {
   TEST_EN(TIME)
   return __time_add(IN1, IN2);
-}
+})
 
 /* overloaded version of ADD(TIME, TIME) */
-static inline TIME ADD__TIME__TIME__TIME(EN_ENO_PARAMS TIME IN1, TIME IN2){
+__STD_USED_FUNC(ADD__TIME__TIME__TIME) TIME ADD__TIME__TIME__TIME(EN_ENO_PARAMS TIME IN1, TIME IN2) __STD_USED_BODY(ADD__TIME__TIME__TIME, {
   TEST_EN(TIME)
   return __time_add(IN1, IN2);
-}
+})
 
-static inline TOD ADD_TOD_TIME(EN_ENO_PARAMS TOD IN1, TIME IN2){
+__STD_USED_FUNC(ADD_TOD_TIME) TOD ADD_TOD_TIME(EN_ENO_PARAMS TOD IN1, TIME IN2) __STD_USED_BODY(ADD_TOD_TIME, {
   TEST_EN(TOD)
   return __time_add(IN1, IN2);
-}
+})
 
 /* overloaded version of ADD(TOD, TIME) */
-static inline TOD ADD__TOD__TOD__TIME(EN_ENO_PARAMS TOD IN1, TIME IN2){
+__STD_USED_FUNC(ADD__TOD__TOD__TIME) TOD ADD__TOD__TOD__TIME(EN_ENO_PARAMS TOD IN1, TIME IN2) __STD_USED_BODY(ADD__TOD__TOD__TIME, {
   TEST_EN(TIME)
   return __time_add(IN1, IN2);
-}
+})
 
-static inline DT ADD_DT_TIME(EN_ENO_PARAMS DT IN1, TIME IN2){
+__STD_USED_FUNC(ADD_DT_TIME) DT ADD_DT_TIME(EN_ENO_PARAMS DT IN1, TIME IN2) __STD_USED_BODY(ADD_DT_TIME, {
   TEST_EN(DT)
   return __time_add(IN1, IN2);
-}
+})
 
 /* overloaded version of ADD(DT, TIME) */
-static inline DT ADD__DT__DT__TIME(EN_ENO_PARAMS DT IN1, TIME IN2){
+__STD_USED_FUNC(ADD__DT__DT__TIME) DT ADD__DT__DT__TIME(EN_ENO_PARAMS DT IN1, TIME IN2) __STD_USED_BODY(ADD__DT__DT__TIME, {
   TEST_EN(TIME)
   return __time_add(IN1, IN2);
-}
+})
 
-static inline TIME SUB_TIME(EN_ENO_PARAMS TIME IN1, TIME IN2){
+__STD_USED_FUNC(SUB_TIME) TIME SUB_TIME(EN_ENO_PARAMS TIME IN1, TIME IN2) __STD_USED_BODY(SUB_TIME, {
   TEST_EN(TIME)
   return __time_sub(IN1, IN2);
-}
+})
 
 /* overloaded version of SUB(TIME, TIME) */
-static inline TIME SUB__TIME__TIME__TIME(EN_ENO_PARAMS TIME IN1, TIME IN2){
+__STD_USED_FUNC(SUB__TIME__TIME__TIME) TIME SUB__TIME__TIME__TIME(EN_ENO_PARAMS TIME IN1, TIME IN2) __STD_USED_BODY(SUB__TIME__TIME__TIME, {
   TEST_EN(TIME)
   return __time_sub(IN1, IN2);
-}
+})
 
-static inline TIME SUB_DATE_DATE(EN_ENO_PARAMS DATE IN1, DATE IN2){
+__STD_USED_FUNC(SUB_DATE_DATE) TIME SUB_DATE_DATE(EN_ENO_PARAMS DATE IN1, DATE IN2) __STD_USED_BODY(SUB_DATE_DATE, {
   TEST_EN(TIME)
   return __time_sub(IN1, IN2);
-}
+})
 
 /* overloaded version of SUB(DATE, DATE) */
-static inline TIME SUB__TIME__DATE__DATE(EN_ENO_PARAMS DATE IN1, DATE IN2){
+__STD_USED_FUNC(SUB__TIME__DATE__DATE) TIME SUB__TIME__DATE__DATE(EN_ENO_PARAMS DATE IN1, DATE IN2) __STD_USED_BODY(SUB__TIME__DATE__DATE, {
   TEST_EN(TIME)
   return __time_sub(IN1, IN2);
-}
+})
 
-static inline TOD SUB_TOD_TIME(EN_ENO_PARAMS TOD IN1, TIME IN2){
+__STD_USED_FUNC(SUB_TOD_TIME) TOD SUB_TOD_TIME(EN_ENO_PARAMS TOD IN1, TIME IN2) __STD_USED_BODY(SUB_TOD_TIME, {
   TEST_EN(TOD)
   return __time_sub(IN1, IN2);
-}
+})
 
 /* overloaded version of SUB(TOD, TIME) */
-static inline TOD SUB__TOD__TOD__TIME(EN_ENO_PARAMS TOD IN1, TIME IN2){
+__STD_USED_FUNC(SUB__TOD__TOD__TIME) TOD SUB__TOD__TOD__TIME(EN_ENO_PARAMS TOD IN1, TIME IN2) __STD_USED_BODY(SUB__TOD__TOD__TIME, {
   TEST_EN(TOD)
   return __time_sub(IN1, IN2);
-}
+})
 
-static inline TIME SUB_TOD_TOD(EN_ENO_PARAMS TOD IN1, TOD IN2){
+__STD_USED_FUNC(SUB_TOD_TOD) TIME SUB_TOD_TOD(EN_ENO_PARAMS TOD IN1, TOD IN2) __STD_USED_BODY(SUB_TOD_TOD, {
   TEST_EN(TIME)
   return __time_sub(IN1, IN2);
-}
+})
 
 /* overloaded version of SUB(TOD, TOD) */
-static inline TIME SUB__TIME__TOD__TOD(EN_ENO_PARAMS TOD IN1, TOD IN2){
+__STD_USED_FUNC(SUB__TIME__TOD__TOD) TIME SUB__TIME__TOD__TOD(EN_ENO_PARAMS TOD IN1, TOD IN2) __STD_USED_BODY(SUB__TIME__TOD__TOD, {
   TEST_EN(TIME)
   return __time_sub(IN1, IN2);
-}
+})
 
-static inline DT SUB_DT_TIME(EN_ENO_PARAMS DT IN1, TIME IN2){
+__STD_USED_FUNC(SUB_DT_TIME) DT SUB_DT_TIME(EN_ENO_PARAMS DT IN1, TIME IN2) __STD_USED_BODY(SUB_DT_TIME, {
   TEST_EN(DT)
   return __time_sub(IN1, IN2);
-}
+})
 
 /* overloaded version of SUB(DT, TIME) */
-static inline DT SUB__DT__DT__TIME(EN_ENO_PARAMS DT IN1, TIME IN2){
+__STD_USED_FUNC(SUB__DT__DT__TIME) DT SUB__DT__DT__TIME(EN_ENO_PARAMS DT IN1, TIME IN2) __STD_USED_BODY(SUB__DT__DT__TIME, {
   TEST_EN(DT)
   return __time_sub(IN1, IN2);
-}
+})
 
-static inline TIME SUB_DT_DT(EN_ENO_PARAMS DT IN1, DT IN2){
+__STD_USED_FUNC(SUB_DT_DT) TIME SUB_DT_DT(EN_ENO_PARAMS DT IN1, DT IN2) __STD_USED_BODY(SUB_DT_DT, {
   TEST_EN(TIME)
   return __time_sub(IN1, IN2);
-}
+})
 
 /* overloaded version of SUB(DT, DT) */
-static inline TIME SUB__TIME__DT__DT(EN_ENO_PARAMS DT IN1, DT IN2){
+__STD_USED_FUNC(SUB__TIME__DT__DT) TIME SUB__TIME__DT__DT(EN_ENO_PARAMS DT IN1, DT IN2) __STD_USED_BODY(SUB__TIME__DT__DT, {
   TEST_EN(TIME)
   return __time_sub(IN1, IN2);
-}
+})
 
 
 /***  MULTIME  ***/
 #define __iec_(TYPENAME)\
-static inline TIME MULTIME__TIME__TIME__##TYPENAME(EN_ENO_PARAMS TIME IN1, TYPENAME IN2){\
+__STD_USED_FUNC(MULTIME__TIME__TIME__##TYPENAME) TIME MULTIME__TIME__TIME__##TYPENAME(EN_ENO_PARAMS TIME IN1, TYPENAME IN2) __STD_USED_BODY(MULTIME__TIME__TIME__##TYPENAME, {\
   TEST_EN(TIME)\
   return __time_mul(IN1, (LREAL)IN2);\
-}
+})
 __ANY_NUM(__iec_)
 #undef __iec_
 
 /***  MULTIME_TYPENAME  ***/
 #define __iec_(TYPENAME)\
-static inline TIME MULTIME_##TYPENAME(EN_ENO_PARAMS TIME IN1, TYPENAME IN2){\
+__STD_USED_FUNC(MULTIME_##TYPENAME) TIME MULTIME_##TYPENAME(EN_ENO_PARAMS TIME IN1, TYPENAME IN2) __STD_USED_BODY(MULTIME_##TYPENAME, {\
   TEST_EN(TIME)\
   return __time_mul(IN1, (LREAL)IN2);\
-}
+})
 __ANY_NUM(__iec_)
 #undef __iec_
 
 /***  MUL  ***/
 #define __iec_(TYPENAME)\
-static inline TIME MUL__TIME__TIME__##TYPENAME(EN_ENO_PARAMS TIME IN1, TYPENAME IN2){\
+__STD_USED_FUNC(MUL__TIME__TIME__##TYPENAME) TIME MUL__TIME__TIME__##TYPENAME(EN_ENO_PARAMS TIME IN1, TYPENAME IN2) __STD_USED_BODY(MUL__TIME__TIME__##TYPENAME, {\
   TEST_EN(TIME)\
   return __time_mul(IN1, (LREAL)IN2);\
-}
+})
 __ANY_NUM(__iec_)
 #undef __iec_
 
 /***  DIVTIME  ***/
 #define __iec_(TYPENAME)\
-static inline TIME DIVTIME__TIME__TIME__##TYPENAME(EN_ENO_PARAMS TIME IN1, TYPENAME IN2){\
+__STD_USED_FUNC(DIVTIME__TIME__TIME__##TYPENAME) TIME DIVTIME__TIME__TIME__##TYPENAME(EN_ENO_PARAMS TIME IN1, TYPENAME IN2) __STD_USED_BODY(DIVTIME__TIME__TIME__##TYPENAME, {\
   TEST_EN(TIME)\
   return __time_div(IN1, (LREAL)IN2);\
-}
+})
 __ANY_NUM(__iec_)
 #undef __iec_
 
 /***  DIVTIME_TYPENAME  ***/
 #define __iec_(TYPENAME)\
-static inline TIME DIVTIME_##TYPENAME(EN_ENO_PARAMS TIME IN1, TYPENAME IN2){\
+__STD_USED_FUNC(DIVTIME_##TYPENAME) TIME DIVTIME_##TYPENAME(EN_ENO_PARAMS TIME IN1, TYPENAME IN2) __STD_USED_BODY(DIVTIME_##TYPENAME, {\
   TEST_EN(TIME)\
   return __time_div(IN1, (LREAL)IN2);\
-}
+})
 __ANY_NUM(__iec_)
 #undef __iec_
 
 /***  DIV  ***/
 #define __iec_(TYPENAME)\
-static inline TIME DIV__TIME__TIME__##TYPENAME(EN_ENO_PARAMS TIME IN1, TYPENAME IN2){\
+__STD_USED_FUNC(DIV__TIME__TIME__##TYPENAME) TIME DIV__TIME__TIME__##TYPENAME(EN_ENO_PARAMS TIME IN1, TYPENAME IN2) __STD_USED_BODY(DIV__TIME__TIME__##TYPENAME, {\
   TEST_EN(TIME)\
   return __time_div(IN1, (LREAL)IN2);\
-}
+})
 __ANY_NUM(__iec_)
 #undef __iec_
 
 /*** CONCAT_DATE_TOD ***/
-static inline DT CONCAT_DATE_TOD(EN_ENO_PARAMS DATE IN1, TOD IN2){
+__STD_USED_FUNC(CONCAT_DATE_TOD) DT CONCAT_DATE_TOD(EN_ENO_PARAMS DATE IN1, TOD IN2) __STD_USED_BODY(CONCAT_DATE_TOD, {
   TEST_EN(DT)
   return __time_add(IN1, IN2);
-}
+})
 
 
 
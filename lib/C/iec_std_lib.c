@@ -0,0 +1,33 @@
+/*
+ * copyright 2008 Edouard TISSERANT
+ * copyright 2011 Mario de Sousa (msousa@fe.up.pt)
+ *
+ * Offered to the public under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/****
+ * IEC 61131-3 standard function and function block library, as a separately compiled object.
+ *
+ * Only needed when the C code is generated with iec2c -O x (USE_STD_LIB_OBJECT). The generated
+ * code then only sees the prototypes of the standard functions and FBs, and this file must be
+ * compiled (once) and linked with it.
+ *
+ * NOTE: This file must be compiled with the same options as the generated code, e.g.:
+ *         $gcc -c -DDISABLE_EN_ENO_PARAMETERS iec_std_lib.c
+ *       when the code was generated with iec2c -e.
+ *       On small targets, compile it with -ffunction-sections (and link with --gc-sections),
+ *       so only the standard functions and FBs actually used end up in the executable.
+ */
+
+#define BUILD_STD_LIB_OBJECT
+#include "iec_std_lib.h"
@@ -55,8 +55,83 @@
  */
 #include "iec_types_all.h"
 
+/* The current time and the debug flag, set by the runtime (or, with USE_RESOURCE_CONTEXT, kept by each resource) */
+#ifdef USE_RESOURCE_CONTEXT
+#include "iec_resource_context.h"
+#else
 extern TIME __CURRENT_TIME;
 extern BOOL __DEBUG;
+#endif
+
+
+/*****************************************************************/
+/* Linkage of the standard functions and FBs                     */
+/*****************************************************************/
+/* By default all the standard functions and FBs are static, so this header may be included
+ * by every C file generated by iec2c, each getting its own copy of the ones it uses.
+ *
+ * With USE_STD_LIB_OBJECT (iec2c -O x) this header only declares their prototypes, and the C
+ * compiler no longer has to parse and compile them for every generated C file. Their code is
+ * then compiled only once, into the object compiled from iec_std_lib.c (which defines
+ * BUILD_STD_LIB_OBJECT), and must be linked with the generated code.
+ * NOTE: iec_std_lib.c must be compiled with the same options as the generated code
+ *       (DISABLE_EN_ENO_PARAMETERS, DISABLE_VARIABLE_FORCING, USE_INT64_TIME, USE_TICK_TIMERS, ...)!
+ *
+ * This header does not depend on the generated code, so it may also be precompiled (once for
+ * each combination of the above options), as it is always the first file included by the generated code.
+ *
+ * The standard functions are defined as
+ *   __STD_FUNC <type> <name>(<params>) __STD_BODY({<body>})
+ * and the standard FBs with __STD_FB (see iec_std_FB.h).
+ */
+#if   defined(BUILD_STD_LIB_OBJECT)
+  #define __STD_FUNC
+  #define __STD_FB
+  #define __STD_BODY(...) __VA_ARGS__
+#elif defined(USE_STD_LIB_OBJECT)
+  #define __STD_LIB_PROTOTYPES_ONLY
+  #define __STD_FUNC      extern
+  #define __STD_FB        extern
+  #define __STD_BODY(...) ;
+#else
+  #define __STD_FUNC      static inline
+  #define __STD_FB        static
+  #define __STD_BODY(...) __VA_ARGS__
+#endif
+
+/* With USE_STD_LIB_USED (defined in the STD_LIB_USED.h file generated by iec2c -O m), only the
+ * standard functions used by the generated code are compiled. STD_LIB_USED.h defines
+ *   #define __STD_USED_<name> ~,1
+ * for every one of them, and all the others are only declared as extern (and never called).
+ *
+ * The standard functions are then defined as
+ *   __STD_USED_FUNC(<name>) <type> <name>(<params>) __STD_USED_BODY(<name>, {<body>})
+ * except the ones called by other standard functions or FBs, which are always compiled.
+ */
+#if defined(USE_STD_LIB_USED) && !defined(BUILD_STD_LIB_OBJECT) && !defined(USE_STD_LIB_OBJECT)
+  /* __STD_IS_USED(name) expands to 1 when __STD_USED_<name> is defined as '~,1', and to 0 otherwise */
+  #define __STD_PROBE_(x, used, ...)      used
+  #define __STD_PROBE(...)                __STD_PROBE_(__VA_ARGS__, 0, ~)
+  #define __STD_IS_USED(name)             __STD_PROBE(__STD_USED_##name)
+  #define __STD_CAT_(a, b)                a##b
+  #define __STD_CAT(a, b)                 __STD_CAT_(a, b)
+
+  #define __STD_USED_FUNC(name)           __STD_CAT(__STD_USED_FUNC_, __STD_IS_USED(name))
+  #define __STD_USED_FUNC_1               __STD_FUNC
+  #define __STD_USED_FUNC_0               extern
+  #define __STD_USED_BODY(name, ...)      __STD_CAT(__STD_USED_BODY_, __STD_IS_USED(name))(__VA_ARGS__)
+  #define __STD_USED_BODY_1(...)          __VA_ARGS__
+  #define __STD_USED_BODY_0(...)          ;
+
+  /* called by the standard FBs, or by other standard functions */
+  #define __STD_USED_TIME_TO_REAL         ~,1
+  #define __STD_USED_GE_TIME              ~,1
+  #define __STD_USED_DT_TO_DATE           ~,1
+  #define __STD_USED_DT_TO_TOD            ~,1
+#else
+  #define __STD_USED_FUNC(name)           __STD_FUNC
+  #define __STD_USED_BODY(name, ...)      __STD_BODY(__VA_ARGS__)
+#endif
 
 /* TODO
 typedef struct {
@@ -106,13 +181,54 @@ typedef struct {
 #define __TOD_LITERAL(value) __literal(TOD,value)
 #define __DT_LITERAL(value) __literal(DT,value)
 #define __STRING_LITERAL(count,value) (STRING){count,value}
+/* a constant STRING, to be used instead of the literal (see string_literal_pool_c in stage4) */
+#define __DECLARE_STRING_LITERAL(name,count,value) static const STRING name = {count,value};
 #define __BYTE_LITERAL(value) __literal(BYTE,value)
 #define __WORD_LITERAL(value) __literal(WORD,value)
 #define __DWORD_LITERAL(value) __literal(DWORD,value,__32b_sufix)
 #define __LWORD_LITERAL(value) __literal(LWORD,value,__64b_sufix)
 
 
-typedef union __IL_DEFVAR_T {
+/* The hints iec2c -O P=<file> gives to the C compiler, from the execution counts of the statements */
+#ifdef __GNUC__
+#define __LIKELY(condition)   __builtin_expect(!!(condition), 1)
+#define __UNLIKELY(condition) __builtin_expect(!!(condition), 0)
+#define __EXPECTED_VALUE(expression, value) __builtin_expect((expression), (value))
+#define __HOT_POU  __attribute__((hot))
+#define __COLD_POU __attribute__((cold))
+#else
+#define __LIKELY(condition)   (condition)
+#define __UNLIKELY(condition) (condition)
+#define __EXPECTED_VALUE(expression, value) (expression)
+#define __HOT_POU
+#define __COLD_POU
+#endif
+
+/* The pointer to the instance passed to the body of the FBs and PROGRAMs with iec2c -O X: nothing else
+ * points into the instance while its body runs, so the C compiler may keep its variables in registers
+ * across the writes through the other pointers (VAR_EXTERNAL, VAR_IN_OUT, located variables).
+ */
+#if defined(__GNUC__)
+#define __RESTRICT __restrict__
+#elif defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 199901L)
+#define __RESTRICT restrict
+#else
+#define __RESTRICT
+#endif
+
+
+/* The current result of the generated IL code (__IL_DEFVAR), holding a value of the type of the last IL instruction.
+ * Each value is always read back with the type it was stored with, so with USE_IL_DEFVAR_STRUCT (iec2c -O r) it
+ * may be a struct instead of a union. The C compiler may then keep each member in a register (scalar replacement),
+ * instead of storing and reloading the union in memory around each IL instruction.
+ */
+#ifdef USE_IL_DEFVAR_STRUCT
+#define __IL_DEFVAR_AGGREGATE struct
+#else
+#define __IL_DEFVAR_AGGREGATE union
+#endif
+
+typedef __IL_DEFVAR_AGGREGATE __IL_DEFVAR_T {
     BOOL    BOOLvar;
 
     SINT    SINTvar;
@@ -163,6 +279,17 @@ static inline void __iec_error(void) {
   /*exit(1);*/
 }
 
+/* The C index of an array subscript that may be out of range (iec2c -O v).
+ * An out of range subscript is a runtime error, and accesses the first element of the dimension instead.
+ */
+static inline long long __check_subscript(long long subscript, long long lower, long long upper) {
+  if ((subscript < lower) || (subscript > upper)) {
+    __iec_error();
+    return 0;
+  }
+  return subscript - lower;
+}
+
 
 /*******************/
 /* Math Operations */
@@ -172,11 +299,46 @@ static inline double __expt(double in1, double in2) {
   return pow(in1, in2);
 }
 
+/* EXPT with an integer exponent, by squaring. Once inlined with a constant exponent
+ * (e.g. x**2, EXPT(x, 3)), the C compiler unrolls the loop into a few multiplications.
+ * The large exponents are left to pow(), which rounds better.
+ */
+#define __EXPT_INT_MAX 64
+
+static inline double __expt_int(double in1, LINT in2) {
+  double result = 1.0;
+  ULINT n = (in2 < 0)? -(ULINT)in2 : (ULINT)in2;
+  if (n > __EXPT_INT_MAX) return pow(in1, (double)in2);
+  for (; n != 0; n >>= 1, in1 *= in1)
+    if (n & 1) result *= in1;
+  return (in2 < 0)? 1.0 / result : result;
+}
+
+static inline double __expt_uint(double in1, ULINT in2) {
+  if (in2 > __EXPT_INT_MAX) return pow(in1, (double)in2);
+  return __expt_int(in1, (LINT)in2);
+}
+
+/* The functions of <math.h> used for each ANY_REAL type, e.g. __MATH_REAL(sqrt) is sqrtf().
+ * Define USE_DOUBLE_MATH_FUNCTIONS for the C libraries without the float variants of C99,
+ * to compute the REAL functions in double precision.
+ */
+#ifdef USE_DOUBLE_MATH_FUNCTIONS
+#define __MATH_REAL(FUNC)  FUNC
+#else
+#define __MATH_REAL(FUNC)  FUNC##f
+#endif
+#define __MATH_LREAL(FUNC) FUNC
+
 
 /*******************************/
 /* Time normalization function */
 /*******************************/
 
+#ifdef USE_INT64_TIME
+/* a count of nanoseconds never needs to be normalized */
+static inline void __normalize_timespec (IEC_TIMESPEC *ts) {}
+#else
 static inline void __normalize_timespec (IEC_TIMESPEC *ts) {
   if( ts->tv_nsec < -1000000000 || (( ts->tv_sec > 0 ) && ( ts->tv_nsec < 0 ))){
     ts->tv_sec--;
@@ -187,6 +349,21 @@ static inline void __normalize_timespec (IEC_TIMESPEC *ts) {
     ts->tv_nsec -= 1000000000;
   }
 }
+#endif
+
+/* Build a TIME, DATE, DT or TOD from its seconds and nanoseconds, and get them back.
+ * Used by the code that must work with both representations of IEC_TIMESPEC (see iec_types.h).
+ * NOTE: the seconds and nanoseconds of negative values are both negative (or 0).
+ */
+#ifdef USE_INT64_TIME
+#define __timespec(sec, nsec)  ((IEC_TIMESPEC)(sec) * 1000000000LL + (IEC_TIMESPEC)(nsec))
+#define __timespec_sec(ts)     ((long int)((ts) / 1000000000LL))
+#define __timespec_nsec(ts)    ((long int)((ts) % 1000000000LL))
+#else
+#define __timespec(sec, nsec)  ((IEC_TIMESPEC){(sec), (nsec)})
+#define __timespec_sec(ts)     ((ts).tv_sec)
+#define __timespec_nsec(ts)    ((ts).tv_nsec)
+#endif
 
 /**********************************************/
 /* Time conversion to/from timespec functions */
@@ -234,6 +411,14 @@ static inline IEC_TIMESPEC __time_to_timespec(int sign, double mseconds, double
  *       They are therefore commented out. This however means that any change to the definition of IEC_TIMESPEC may require this
  *       macro to be updated too!
  */
+#ifdef USE_INT64_TIME
+/* the count of nanoseconds is rounded to the nearest integer, so T#3.8s does not become 3.799999999s */
+#define __time_to_timespec(sign,mseconds,seconds,minutes,hours,days) \
+          ((IEC_TIMESPEC)(((sign>=0)?1:-1)*(((((long double)days*24 + (long double)hours)*60 + (long double)minutes)*60 + (long double)seconds)*1e9 + (long double)mseconds*1e6 + 0.5)))
+
+/* TIME literal for which stage4 already calculated the count of nanoseconds (iec2c -O t) */
+#define __ns_to_timespec(nseconds) ((IEC_TIMESPEC)(nseconds))
+#else
 #define __time_to_timespec(sign,mseconds,seconds,minutes,hours,days) \
           ((IEC_TIMESPEC){\
               /*tv_sec  =*/ ((long int)   (((sign>=0)?1:-1)*((((long double)days*24 + (long double)hours)*60 + (long double)minutes)*60 + (long double)seconds + (long double)mseconds/1e3))), \
@@ -242,6 +427,7 @@ static inline IEC_TIMESPEC __time_to_timespec(int sign, double mseconds, double
                             ((long int)   (((sign>=0)?1:-1)*((((long double)days*24 + (long double)hours)*60 + (long double)minutes)*60 + (long double)seconds + (long double)mseconds/1e3)))   \
                             )*1e9))\
         })
+#endif
 
 
 
@@ -259,6 +445,10 @@ static inline IEC_TIMESPEC __tod_to_timespec(double seconds, double minutes, dou
   return ts;
 }
 */
+#ifdef USE_INT64_TIME
+#define __tod_to_timespec(seconds,minutes,hours) \
+          ((IEC_TIMESPEC)(((((long double)hours)*60 + (long double)minutes)*60 + (long double)seconds)*1e9 + 0.5))
+#else
 #define __tod_to_timespec(seconds,minutes,hours) \
           ((IEC_TIMESPEC){\
               /*tv_sec  =*/ ((long int)   ((((long double)hours)*60 + (long double)minutes)*60 + (long double)seconds)), \
@@ -267,6 +457,7 @@ static inline IEC_TIMESPEC __tod_to_timespec(double seconds, double minutes, dou
                             ((long int)   ((((long double)hours)*60 + (long double)minutes)*60 + (long double)seconds))   \
                             )*1e9))\
         })
+#endif
 
 
 #define EPOCH_YEAR 1970
@@ -328,7 +519,6 @@ static inline tm convert_seconds_to_date_and_time(long int seconds) {
 }
 
 static inline IEC_TIMESPEC __date_to_timespec(int day, int month, int year) {
-  IEC_TIMESPEC ts;
   int a4, b4, a100, b100, a400, b400;
   int yday;
   int intervening_leap_days;
@@ -349,17 +539,18 @@ static inline IEC_TIMESPEC __date_to_timespec(int day, int month, int year) {
   b400 = b100 >> 2;
   intervening_leap_days = (a4 - b4) - (a100 - b100) + (a400 - b400);
   
-  ts.tv_sec = ((year - EPOCH_YEAR) * 365 + intervening_leap_days + yday - 1) * 24 * 60 * 60;
-  ts.tv_nsec = 0;
-
-  return ts;
+  return __timespec(((year - EPOCH_YEAR) * 365 + intervening_leap_days + yday - 1) * 24 * 60 * 60, 0);
 }
 
 static inline IEC_TIMESPEC __dt_to_timespec(double seconds, double minutes, double hours, int day, int month, int year) {
   IEC_TIMESPEC ts_date = __date_to_timespec(day, month, year);
   IEC_TIMESPEC ts = __tod_to_timespec(seconds, minutes, hours);
 
+#ifdef USE_INT64_TIME
+  ts += ts_date;
+#else
   ts.tv_sec += ts_date.tv_sec;
+#endif
 
   return ts;
 }
@@ -368,6 +559,17 @@ static inline IEC_TIMESPEC __dt_to_timespec(double seconds, double minutes, doub
 /* Time operations */
 /*******************/
 
+#ifdef USE_INT64_TIME
+
+#define __time_cmp(t1, t2) (((t1) > (t2)) - ((t1) < (t2)))
+
+static inline TIME __time_add(TIME IN1, TIME IN2){return IN1 + IN2;}
+static inline TIME __time_sub(TIME IN1, TIME IN2){return IN1 - IN2;}
+static inline TIME __time_mul(TIME IN1, LREAL IN2){return (TIME)(IN1 * IN2);}
+static inline TIME __time_div(TIME IN1, LREAL IN2){return (TIME)(IN1 / IN2);}
+
+#else
+
 #define __time_cmp(t1, t2) (t2.tv_sec == t1.tv_sec ? t1.tv_nsec - t2.tv_nsec : t1.tv_sec - t2.tv_sec)
 
 static inline TIME __time_add(TIME IN1, TIME IN2){
@@ -400,6 +602,8 @@ static inline TIME __time_div(TIME IN1, LREAL IN2){
   return res;
 }
 
+#endif /* USE_INT64_TIME */
+
 
 /***************/
 /* Convertions */
@@ -420,6 +624,130 @@ static inline LINT __real_to_sint(LREAL IN)  {return (LINT)__preal_to_sint(IN);}
 static inline LWORD __real_to_bit(LREAL IN)  {return (LWORD)__preal_to_uint(IN);}
 static inline ULINT __real_to_uint(LREAL IN) {return (ULINT)__preal_to_uint(IN);}
 
+    /**************************/
+    /*  Number <-> characters */
+    /**************************/
+/* The conversions of numbers to and from STRINGs do not use stdio, nor depend on the locale
+ * (e.g. the decimal point of atof()), except in the rare cases the fast paths below do not
+ * handle, which are left to snprintf() and strtod().
+ */
+static const LREAL __pow10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+/* Append the characters to the STRING, truncating it at STR_MAX_LEN */
+static inline void __str_append(STRING *s, const char *c, int n) {
+    if(n > STR_MAX_LEN - s->len) n = STR_MAX_LEN - s->len;
+    memcpy(&s->body[s->len], c, n);
+    s->len += n;
+}
+/* Append the value in decimal, with at least min_digits digits (as "%.<min_digits>llu") */
+static inline void __str_append_uint(STRING *s, ULINT IN, int min_digits) {
+    char buf[20];
+    int i = sizeof(buf);
+    do {buf[--i] = '0' + IN % 10; IN /= 10;} while(IN != 0 || (int)sizeof(buf) - i < min_digits);
+    __str_append(s, &buf[i], sizeof(buf) - i);
+}
+static inline void __str_append_sint(STRING *s, LINT IN, int min_digits) {
+    if(IN < 0) {
+        __str_append(s, "-", 1);
+        __str_append_uint(s, -(ULINT)IN, min_digits);
+    } else
+        __str_append_uint(s, IN, min_digits);
+}
+/* Append the value in hexadecimal, in lower case (as "%llx") */
+static inline void __str_append_hex(STRING *s, ULINT IN) {
+    char buf[16];
+    int i = sizeof(buf);
+    do {buf[--i] = "0123456789abcdef"[IN & 0xf]; IN >>= 4;} while(IN != 0);
+    __str_append(s, &buf[i], sizeof(buf) - i);
+}
+/* Append the value as "%.<precision>g" would, if it has at most precision (<= 15) significant
+ * digits and needs no exponent, i.e. 1e-4 <= |IN| < 10^precision (or is 0). This covers the values
+ * usually found in the PLC programs (with few decimals), and returns 0 for the other values.
+ *
+ * When IN*10^k is an integer m of at most precision digits, m/10^k is within an ulp of IN, so it is
+ * also what IN rounds to with precision significant digits.
+ */
+static inline int __str_append_real(STRING *s, LREAL IN, int precision) {
+    int k;
+    ULINT m = 0, div;
+    LREAL x = IN < 0 ? -IN : IN;
+
+    if(IN == 0) {
+        if(signbit(IN)) __str_append(s, "-0", 2); else __str_append(s, "0", 1);
+        return 1;
+    }
+    if(!(x >= 1e-4 && x < __pow10[precision])) return 0; /* also NaN and infinity */
+    for(k = 0; ; k++) {
+        LREAL y = x * __pow10[k];
+        if(y >= __pow10[precision]) return 0;
+        m = (ULINT)y;
+        if((LREAL)m == y) break;
+    }
+    /* the trailing zeros are not printed */
+    while(k > 0 && m % 10 == 0) {m /= 10; k--;}
+    div = (ULINT)__pow10[k];
+    if(IN < 0) __str_append(s, "-", 1);
+    __str_append_uint(s, m / div, 1);
+    if(k > 0) {
+        __str_append(s, ".", 1);
+        __str_append_uint(s, m % div, k);
+    }
+    return 1;
+}
+/* The REAL at the start of the len characters, with the syntax of atof() (i.e. strtod()).
+ * Values of at most 19 significant digits, that fit in the 53 bits of the LREAL mantissa, and
+ * a decimal exponent of at most 22 are converted exactly (one correctly rounded multiplication
+ * or division), the others by strtod().
+ */
+static inline LREAL __chars_to_real(const uint8_t *c, int len) {
+    int i = 0, digits = 0, exp10 = 0, any_digit = 0;
+    ULINT m = 0;
+    BOOL neg = 0;
+
+    while(i < len && isspace(c[i])) i++;
+    if(i < len && (c[i] == '-' || c[i] == '+')) neg = (c[i++] == '-');
+    if(i + 1 < len && c[i] == '0' && (c[i+1] == 'x' || c[i+1] == 'X')) goto slow; /* hexadecimal */
+    for(; i < len && c[i] >= '0' && c[i] <= '9'; i++, any_digit = 1) {
+        if(m == 0 && c[i] == '0') continue;
+        m = m * 10 + (c[i] - '0'); digits++;
+        if(digits > 19) goto slow;
+    }
+    if(i < len && c[i] == '.') {
+        for(i++; i < len && c[i] >= '0' && c[i] <= '9'; i++, any_digit = 1) {
+            exp10--;
+            if(m == 0 && c[i] == '0') continue;
+            m = m * 10 + (c[i] - '0'); digits++;
+            if(digits > 19) goto slow;
+        }
+    }
+    if(!any_digit) goto slow; /* inf, nan, ... */
+    if(i + 1 < len && (c[i] == 'e' || c[i] == 'E')) {
+        int j = i + 1, e = 0;
+        BOOL eneg = 0;
+        if(c[j] == '-' || c[j] == '+') eneg = (c[j++] == '-');
+        if(j < len && c[j] >= '0' && c[j] <= '9') {
+            for(; j < len && c[j] >= '0' && c[j] <= '9'; j++)
+                if(e < 10000) e = e * 10 + (c[j] - '0');
+            exp10 += eneg ? -e : e;
+        }
+    }
+    if(m == 0) return neg ? -0.0 : 0.0;
+    if(m > ((ULINT)1 << 53) || exp10 < -22 || exp10 > 22) goto slow;
+    {
+        LREAL res = exp10 < 0 ? (LREAL)m / __pow10[-exp10] : (LREAL)m * __pow10[exp10];
+        return neg ? -res : res;
+    }
+slow:
+    {
+        char buf[STR_MAX_LEN + 1];
+        if(len > STR_MAX_LEN) len = STR_MAX_LEN;
+        memcpy(buf, c, len);
+        buf[len] = '\0';
+        return strtod(buf, NULL);
+    }
+}
+
     /***************/
     /*  TO_STRING  */
     /***************/
@@ -429,30 +757,30 @@ static inline STRING __bool_to_string(BOOL IN) {
 }
 static inline STRING __bit_to_string(LWORD IN) {
     STRING res;
-    res = __INIT_STRING;
-    res.len = snprintf((char*)res.body, STR_MAX_LEN, "16#%llx",(long long unsigned int)IN);
-    if(res.len > STR_MAX_LEN) res.len = STR_MAX_LEN;
+    res.len = 0;
+    __str_append(&res, "16#", 3);
+    __str_append_hex(&res, IN);
     return res;
 }
 static inline STRING __real_to_string(LREAL IN) {
     STRING res;
-    res = __INIT_STRING;
-    res.len = snprintf((char*)res.body, STR_MAX_LEN, "%.10g", IN);
-    if(res.len > STR_MAX_LEN) res.len = STR_MAX_LEN;
+    res.len = 0;
+    if(!__str_append_real(&res, IN, 10)) {
+        res.len = snprintf((char*)res.body, STR_MAX_LEN, "%.10g", IN);
+        if(res.len > STR_MAX_LEN) res.len = STR_MAX_LEN;
+    }
     return res;
 }
 static inline STRING __sint_to_string(LINT IN) {
     STRING res;
-    res = __INIT_STRING;
-    res.len = snprintf((char*)res.body, STR_MAX_LEN, "%lld", (long long int)IN);
-    if(res.len > STR_MAX_LEN) res.len = STR_MAX_LEN;
+    res.len = 0;
+    __str_append_sint(&res, IN, 1);
     return res;
 }
 static inline STRING __uint_to_string(ULINT IN) {
     STRING res;
-    res = __INIT_STRING;
-    res.len = snprintf((char*)res.body, STR_MAX_LEN, "%llu", (long long unsigned int)IN);
-    if(res.len > STR_MAX_LEN) res.len = STR_MAX_LEN;
+    res.len = 0;
+    __str_append_uint(&res, IN, 1);
     return res;
 }
     /***************/
@@ -535,7 +863,7 @@ static inline LREAL __string_to_real(STRING IN) {
     /* search the dot */
     while(--l > 0 && IN.body[l] != '.');
     if(l != 0){
-        return atof((const char *)&IN.body);
+        return __chars_to_real(IN.body, IN.len);
     }else{
         return (LREAL)__pstring_to_sint(&IN);
     }
@@ -544,8 +872,8 @@ static inline LREAL __string_to_real(STRING IN) {
     /***************/
     /*   TO_TIME   */
     /***************/
-static inline TIME    __int_to_time(LINT IN)  {return (TIME){IN, 0};}
-static inline TIME   __real_to_time(LREAL IN) {return (TIME){IN, (IN - (LINT)IN) * 1000000000};}
+static inline TIME    __int_to_time(LINT IN)  {return __timespec(IN, 0);}
+static inline TIME   __real_to_time(LREAL IN) {return __timespec(IN, (IN - (LINT)IN) * 1000000000);}
 static inline TIME __string_to_time(STRING IN){
     __strlen_t l;
     /* TODO :
@@ -573,10 +901,10 @@ static inline TIME __string_to_time(STRING IN){
     l = IN.len;
     while(--l > 0 && IN.body[l] != '.');
     if(l != 0){
-        LREAL IN_val = atof((const char *)&IN.body);
-        return  (TIME){(long)IN_val, (long)(IN_val - (LINT)IN_val)*1000000000};
+        LREAL IN_val = __chars_to_real(IN.body, IN.len);
+        return  __timespec((long)IN_val, (long)(IN_val - (LINT)IN_val)*1000000000);
     }else{
-        return  (TIME){(long)__pstring_to_sint(&IN), 0};
+        return  __timespec((long)__pstring_to_sint(&IN), 0);
     }
 }
 
@@ -584,48 +912,61 @@ static inline TIME __string_to_time(STRING IN){
     /*  FROM_TIME  */
     /***************/
 static inline LREAL __time_to_real(TIME IN){
-    return (LREAL)IN.tv_sec + ((LREAL)IN.tv_nsec/1000000000);
+    return (LREAL)__timespec_sec(IN) + ((LREAL)__timespec_nsec(IN)/1000000000);
 }
-static inline LINT __time_to_int(TIME IN) {return IN.tv_sec;}
+static inline LINT __time_to_int(TIME IN) {return __timespec_sec(IN);}
 static inline STRING __time_to_string(TIME IN){
     STRING res;
     div_t days;
     /*t#5d14h12m18s3.5ms*/
-    res = __INIT_STRING;
-    days = div(IN.tv_sec, SECONDS_PER_DAY);
-    if(!days.rem && IN.tv_nsec == 0){
-        res.len = snprintf((char*)&res.body, STR_MAX_LEN, "T#%dd", days.quot);
-    }else{
+    res.len = 0;
+    days = div(__timespec_sec(IN), SECONDS_PER_DAY);
+    __str_append(&res, "T#", 2);
+    __str_append_sint(&res, days.quot, 1);
+    __str_append(&res, "d", 1);
+    if(days.rem || __timespec_nsec(IN) != 0){
         div_t hours = div(days.rem, SECONDS_PER_HOUR);
-        if(!hours.rem && IN.tv_nsec == 0){
-            res.len = snprintf((char*)&res.body, STR_MAX_LEN, "T#%dd%dh", days.quot, hours.quot);
-        }else{
+        __str_append_sint(&res, hours.quot, 1);
+        __str_append(&res, "h", 1);
+        if(hours.rem || __timespec_nsec(IN) != 0){
             div_t minuts = div(hours.rem, SECONDS_PER_MINUTE);
-            if(!minuts.rem && IN.tv_nsec == 0){
-                res.len = snprintf((char*)&res.body, STR_MAX_LEN, "T#%dd%dh%dm", days.quot, hours.quot, minuts.quot);
-            }else{
-                if(IN.tv_nsec == 0){
-                    res.len = snprintf((char*)&res.body, STR_MAX_LEN, "T#%dd%dh%dm%ds", days.quot, hours.quot, minuts.quot, minuts.rem);
-                }else{
-                    res.len = snprintf((char*)&res.body, STR_MAX_LEN, "T#%dd%dh%dm%ds%gms", days.quot, hours.quot, minuts.quot, minuts.rem, (LREAL)IN.tv_nsec / 1000000);
+            __str_append_sint(&res, minuts.quot, 1);
+            __str_append(&res, "m", 1);
+            if(minuts.rem || __timespec_nsec(IN) != 0){
+                __str_append_sint(&res, minuts.rem, 1);
+                __str_append(&res, "s", 1);
+                if(__timespec_nsec(IN) != 0){
+                    LREAL ms = (LREAL)__timespec_nsec(IN) / 1000000;
+                    if(!__str_append_real(&res, ms, 6)) {
+                        int n = snprintf((char*)&res.body[res.len], STR_MAX_LEN - res.len, "%g", ms);
+                        res.len = (n > STR_MAX_LEN - res.len) ? STR_MAX_LEN : res.len + n;
+                    }
+                    __str_append(&res, "ms", 2);
                 }
             }
         }
     }
-    if(res.len > STR_MAX_LEN) res.len = STR_MAX_LEN;
     return res;
 }
+/* Append the seconds, and their nanoseconds, as "%09.6f" */
+static inline void __str_append_seconds(STRING *s, int sec, long nsec) {
+    ULINT usec = (ULINT)sec * 1000000 + (nsec + 500) / 1000;
+    __str_append_uint(s, usec / 1000000, 2);
+    __str_append(s, ".", 1);
+    __str_append_uint(s, usec % 1000000, 6);
+}
 static inline STRING __date_to_string(DATE IN){
     STRING res;
     tm broken_down_time;
     /* D#1984-06-25 */
-    broken_down_time = convert_seconds_to_date_and_time(IN.tv_sec);
-    res = __INIT_STRING;
-    res.len = snprintf((char*)&res.body, STR_MAX_LEN, "D#%d-%2.2d-%2.2d",
-             broken_down_time.tm_year,
-             broken_down_time.tm_mon,
-             broken_down_time.tm_day);
-    if(res.len > STR_MAX_LEN) res.len = STR_MAX_LEN;
+    broken_down_time = convert_seconds_to_date_and_time(__timespec_sec(IN));
+    res.len = 0;
+    __str_append(&res, "D#", 2);
+    __str_append_sint(&res, broken_down_time.tm_year, 1);
+    __str_append(&res, "-", 1);
+    __str_append_sint(&res, broken_down_time.tm_mon, 2);
+    __str_append(&res, "-", 1);
+    __str_append_sint(&res, broken_down_time.tm_day, 2);
     return res;
 }
 static inline STRING __tod_to_string(TOD IN){
@@ -633,50 +974,47 @@ static inline STRING __tod_to_string(TOD IN){
     tm broken_down_time;
     time_t seconds;
     /* TOD#15:36:55.36 */
-    seconds = IN.tv_sec;
+    seconds = __timespec_sec(IN);
     if (seconds >= SECONDS_PER_DAY){
 		__iec_error();
 		return (STRING){9,"TOD#ERROR"};
 	}
     broken_down_time = convert_seconds_to_date_and_time(seconds);
-    res = __INIT_STRING;
-    if(IN.tv_nsec == 0){
-        res.len = snprintf((char*)&res.body, STR_MAX_LEN, "TOD#%2.2d:%2.2d:%2.2d",
-                 broken_down_time.tm_hour,
-                 broken_down_time.tm_min,
-                 broken_down_time.tm_sec);
+    res.len = 0;
+    __str_append(&res, "TOD#", 4);
+    __str_append_sint(&res, broken_down_time.tm_hour, 2);
+    __str_append(&res, ":", 1);
+    __str_append_sint(&res, broken_down_time.tm_min, 2);
+    __str_append(&res, ":", 1);
+    if(__timespec_nsec(IN) == 0){
+        __str_append_sint(&res, broken_down_time.tm_sec, 2);
     }else{
-        res.len = snprintf((char*)&res.body, STR_MAX_LEN, "TOD#%2.2d:%2.2d:%09.6f",
-                 broken_down_time.tm_hour,
-                 broken_down_time.tm_min,
-                 (LREAL)broken_down_time.tm_sec + (LREAL)IN.tv_nsec / 1e9);
+        __str_append_seconds(&res, broken_down_time.tm_sec, __timespec_nsec(IN));
     }
-    if(res.len > STR_MAX_LEN) res.len = STR_MAX_LEN;
     return res;
 }
 static inline STRING __dt_to_string(DT IN){
     STRING res;
     tm broken_down_time;
     /* DT#1984-06-25-15:36:55.36 */
-    broken_down_time = convert_seconds_to_date_and_time(IN.tv_sec);
-    if(IN.tv_nsec == 0){
-        res.len = snprintf((char*)&res.body, STR_MAX_LEN, "DT#%d-%2.2d-%2.2d-%2.2d:%2.2d:%2.2d",
-                 broken_down_time.tm_year,
-                 broken_down_time.tm_mon,
-                 broken_down_time.tm_day,
-                 broken_down_time.tm_hour,
-                 broken_down_time.tm_min,
-                 broken_down_time.tm_sec);
+    broken_down_time = convert_seconds_to_date_and_time(__timespec_sec(IN));
+    res.len = 0;
+    __str_append(&res, "DT#", 3);
+    __str_append_sint(&res, broken_down_time.tm_year, 1);
+    __str_append(&res, "-", 1);
+    __str_append_sint(&res, broken_down_time.tm_mon, 2);
+    __str_append(&res, "-", 1);
+    __str_append_sint(&res, broken_down_time.tm_day, 2);
+    __str_append(&res, "-", 1);
+    __str_append_sint(&res, broken_down_time.tm_hour, 2);
+    __str_append(&res, ":", 1);
+    __str_append_sint(&res, broken_down_time.tm_min, 2);
+    __str_append(&res, ":", 1);
+    if(__timespec_nsec(IN) == 0){
+        __str_append_sint(&res, broken_down_time.tm_sec, 2);
     }else{
-        res.len = snprintf((char*)&res.body, STR_MAX_LEN, "DT#%d-%2.2d-%2.2d-%2.2d:%2.2d:%09.6f",
-                 broken_down_time.tm_year,
-                 broken_down_time.tm_mon,
-                 broken_down_time.tm_day,
-                 broken_down_time.tm_hour,
-                 broken_down_time.tm_min,
-                 (LREAL)broken_down_time.tm_sec + ((LREAL)IN.tv_nsec / 1e9));
+        __str_append_seconds(&res, broken_down_time.tm_sec, __timespec_nsec(IN));
     }
-    if(res.len > STR_MAX_LEN) res.len = STR_MAX_LEN;
     return res;
 }
 
@@ -685,14 +1023,14 @@ static inline STRING __dt_to_string(DT IN){
     /**********************************************/
 
 static inline TOD __date_and_time_to_time_of_day(DT IN) {
-	return (TOD){
-		IN.tv_sec % SECONDS_PER_DAY + (IN.tv_sec < 0 ? SECONDS_PER_DAY : 0),
-		IN.tv_nsec};
+	return __timespec(
+		__timespec_sec(IN) % SECONDS_PER_DAY + (__timespec_sec(IN) < 0 ? SECONDS_PER_DAY : 0),
+		__timespec_nsec(IN));
 }
 static inline DATE __date_and_time_to_date(DT IN){
-	return (DATE){
-		IN.tv_sec - IN.tv_sec % SECONDS_PER_DAY - (IN.tv_sec < 0 ? SECONDS_PER_DAY : 0),
-		0};
+	return __timespec(
+		__timespec_sec(IN) - __timespec_sec(IN) % SECONDS_PER_DAY - (__timespec_sec(IN) < 0 ? SECONDS_PER_DAY : 0),
+		0);
 }
 
     /*****************/
@@ -748,10 +1086,127 @@ __ANY(__move_)
 
 #include "iec_std_functions.h"
 
+
+/**************/
+/*   Timers   */
+/**************/
+/* The time keeping of the TP, TON and TOF standard FBs.
+ *
+ * By default the timers compare the __CURRENT_TIME (set by the runtime) with the time they were started.
+ *
+ * With USE_TICK_TIMERS (iec2c -O k) they instead use __CURRENT_TICK, the number of ticks (of common_ticktime__ ns)
+ * maintained by the generated resource code. When started, a timer calculates the tick on which it will expire,
+ * so it then only needs to compare two integers on every call.
+ * NOTE: The timers then run on the PLC ticks, so they are as precise as the runtime is in calling the resources.
+ *
+ * With USE_TIMER_WHEEL (iec2c -O w, which implies USE_TICK_TIMERS) the running timers are also registered in a
+ * timer wheel (see iec_timer_wheel.h), that the resources advance on every tick. A timer that expires then changes
+ * its outputs (Q, ET) right away, even if the FB is not called on that tick.
+ */
+#if defined(USE_TIMER_WHEEL) && !defined(USE_TICK_TIMERS)
+#define USE_TICK_TIMERS
+#endif
+
+#ifdef USE_TICK_TIMERS
+
+#ifndef USE_RESOURCE_CONTEXT
+extern unsigned long long __CURRENT_TICK;
+#endif
+extern unsigned long long common_ticktime__;
+
+typedef struct __tick_timer_s {
+  unsigned long long start; /* the tick on which the timer was started */
+  unsigned long long end;   /* the tick on which the timer expires */
+  TIME pt;                  /* the PT used to calculate end */
+#ifdef USE_TIMER_WHEEL
+  struct __tick_timer_s  *next;   /* the next timer in the same slot of the wheel */
+  struct __tick_timer_s **pprev;  /* the pointer to this timer in the wheel, NULL when not in the wheel */
+  void (*expired)(struct __tick_timer_s *timer); /* called by the wheel on the tick the timer expires */
+#endif
+} __tick_timer_t;
+
+#ifdef USE_TIMER_WHEEL
+#include "iec_timer_wheel.h"
+#endif
+
+/* the number of ticks in a TIME, rounded up */
+static inline unsigned long long __time_to_ticks(TIME IN) {
+  long long int ns = (long long int)__timespec_sec(IN) * 1000000000LL + __timespec_nsec(IN);
+  if (ns <= 0) return 0;
+  return ((unsigned long long)ns + common_ticktime__ - 1) / common_ticktime__;
+}
+
+static inline TIME __ticks_to_time(unsigned long long ticks) {
+  unsigned long long ns = ticks * common_ticktime__;
+  return __timespec(ns / 1000000000ULL, ns % 1000000000ULL);
+}
+
+static inline void __tick_timer_start(__tick_timer_t *timer, TIME PT) {
+  timer->start = __CURRENT_TICK;
+  timer->pt    = PT;
+  timer->end   = timer->start + __time_to_ticks(PT);
+#ifdef USE_TIMER_WHEEL
+  __timer_wheel_insert(timer);
+#endif
+}
+
+static inline BOOL __tick_timer_expired(__tick_timer_t *timer, TIME PT) {
+  /* PT may be changed while the timer is running */
+  if (__time_cmp(PT, timer->pt) != 0) {
+    timer->pt  = PT;
+    timer->end = timer->start + __time_to_ticks(PT);
+#ifdef USE_TIMER_WHEEL
+    if (__CURRENT_TICK < timer->end) __timer_wheel_insert(timer);
+#endif
+  }
+  return __CURRENT_TICK >= timer->end;
+}
+
+static inline TIME __tick_timer_elapsed(__tick_timer_t *timer) {
+  return __ticks_to_time(__CURRENT_TICK - timer->start);
+}
+
+#ifdef USE_TIMER_WHEEL
+#define __TIMER_INIT(data__, expired_function) __tick_timer_init(&(data__)->__timer, expired_function)
+#else
+#define __TIMER_INIT(data__, expired_function)
+#endif
+#define __TIMER_UPDATE(data__)
+#define __TIMER_START(data__)   __tick_timer_start(&(data__)->__timer, __GET_VAR((data__)->PT,))
+#define __TIMER_EXPIRED(data__) __tick_timer_expired(&(data__)->__timer, __GET_VAR((data__)->PT,))
+#define __TIMER_ELAPSED(data__) __tick_timer_elapsed(&(data__)->__timer)
+
+#else
+
+#define __TIMER_INIT(data__, expired_function)
+#define __TIMER_UPDATE(data__)  __SET_VAR(data__->,CURRENT_TIME,,__CURRENT_TIME)
+#define __TIMER_START(data__)   __SET_VAR(data__->,START_TIME,,__GET_VAR(data__->CURRENT_TIME,))
+#define __TIMER_EXPIRED(data__) (__time_cmp(__time_add(__GET_VAR(data__->START_TIME,), __GET_VAR(data__->PT,)), __GET_VAR(data__->CURRENT_TIME,)) <= 0)
+#define __TIMER_ELAPSED(data__) __time_sub(__GET_VAR(data__->CURRENT_TIME,), __GET_VAR(data__->START_TIME,))
+
+#endif
+
+
 #ifdef  DISABLE_EN_ENO_PARAMETERS
   #include "iec_std_FB_no_ENENO.h"
 #else
   #include "iec_std_FB.h"
 #endif
 
+#ifdef USE_POU_PROFILE
+#include "iec_profile.h"
+#endif
+
+#ifdef USE_TASK_STATS
+#include "iec_task_stats.h"
+#endif
+
+#ifdef USE_STMT_COUNTERS
+#include "iec_counters.h"
+#endif
+
+#ifdef USE_PARALLEL_NETWORKS
+#include "iec_parallel.h"
+#endif
+
 #endif /* _IEC_STD_LIB_H */
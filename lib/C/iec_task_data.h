@@ -0,0 +1,56 @@
+/*
+ * copyright 2008 Edouard TISSERANT
+ * copyright 2011 Mario de Sousa (msousa@fe.up.pt)
+ *
+ * Offered to the public under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/****
+ * The data of each task in its own cache lines (USE_TASK_DATA, iec2c -O A)
+ *
+ * Each PROGRAM instance belongs to the task it runs WITH (or, with no task, to its resource), and
+ * each global variable of the configuration and of its resources to the only task writing it (in
+ * the bodies of the PROGRAMs of the task, of the FBs and FUNCTIONs these call, and through the
+ * outputs connected in the PROGRAM configuration, see generate_c_taskdata.cc). The C compiler places
+ * the data of each task, <owner>, in the 'iec_task_<owner>' section (e.g. iec_task_RES0__TASK0, or
+ * iec_task_RES0 for the PROGRAMs with no task), and each generated file declares an empty array
+ * aligned on __CACHE_LINE_SIZE in every section it uses, so each section starts on a new cache line.
+ * Two tasks running on different cores then no longer write to the same cache lines.
+ *
+ * The globals written by several tasks are each in a cache line of their own, in the 'iec_task_shared'
+ * section (iec2c warns about them). The globals no task writes stay in the default data section of
+ * the C compiler, since reading them from several cores does not make the cache lines bounce.
+ *
+ * NOTE: The last cache line of the last section laid out by the linker may still be shared with the
+ *       data that follows it. A linker script may keep the iec_task_* sections together, and pad them
+ *       (the sections are named as C identifiers, so the GNU linker also defines __start_<section>
+ *       and __stop_<section> for each of them).
+ * NOTE: The located variables (%I, %Q, %M) are not placed: their memory belongs to the runtime.
+ *
+ * This file is included by accessor.h, do not include it directly.
+ */
+
+#ifndef _IEC_TASK_DATA_H
+#define _IEC_TASK_DATA_H
+
+#ifndef __CACHE_LINE_SIZE
+#define __CACHE_LINE_SIZE 64
+#endif
+
+#define __TASK_DATA(owner) __attribute__((section("iec_task_" #owner)))
+/* the domain (the resource or configuration declaring the variables) keeps the names apart in AMALGAMATION.c */
+#define __TASK_DATA_ALIGN(domain, owner)\
+	static char __task_data_align__##domain##__##owner[0] __attribute__((section("iec_task_" #owner), used, aligned(__CACHE_LINE_SIZE)));
+#define __SHARED_DATA __attribute__((section("iec_task_shared"), aligned(__CACHE_LINE_SIZE)))
+
+#endif /* _IEC_TASK_DATA_H */
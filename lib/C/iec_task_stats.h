@@ -0,0 +1,145 @@
+/*
+ * copyright 2008 Edouard TISSERANT
+ * copyright 2011 Mario de Sousa (msousa@fe.up.pt)
+ *
+ * Offered to the public under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/****
+ * The cycle statistics of the tasks (USE_TASK_STATS, iec2c -O T)
+ *
+ * The code generated for each resource has a table of the statistics of its tasks,
+ * <resource>_task_stats__[] (in the same order as <resource>_tasks__[], and ended by an entry
+ * with a NULL name), which the runtime may read at any time. The code generated for the configuration
+ * lists these tables in config_task_stats__[] (in the same order as config_resource_run__[], and
+ * ended by NULL), so a runtime may also find them without knowing the names of the resources.
+ *
+ * Every time a task runs, its entry records:
+ *  - the execution time of its programs (last, min, max, and the total, see __task_stats_average());
+ *  - the jitter, i.e. how late the task started after its scheduled release, in a histogram
+ *    of __TASK_JITTER_BUCKETS buckets that covers one period of the task (or one tick, for the
+ *    tasks that are not periodic). The last bucket also counts the larger jitters;
+ *  - the overruns, i.e. the runs that did not end before the next release of the task, and the
+ *    releases that were missed altogether.
+ *
+ * In the resource run function, the release of a task is the tick it is due on (the time of
+ * tick 0 being taken from the earliest run). In the run functions of the tasks (used by the
+ * preemptive runtimes), the release of a periodic task is its previous release plus its period.
+ *
+ * All the times are in ns, read with __task_stats_now(), which the runtime must define, e.g.
+ * returning the time given by clock_gettime(CLOCK_MONOTONIC).
+ *
+ * NOTE: The programs that are not associated to any task have no statistics.
+ *
+ * This file is included by iec_std_lib.h, do not include it directly.
+ */
+
+#ifndef _IEC_TASK_STATS_H
+#define _IEC_TASK_STATS_H
+
+#ifndef __TASK_JITTER_BUCKETS
+#define __TASK_JITTER_BUCKETS 16
+#endif
+
+typedef struct {
+  const char *name;             /* the name of the task */
+  unsigned long long period;    /* the interval of the task, 0 for the tasks that are not periodic */
+  unsigned long long tick;      /* the common tick of the resources */
+  unsigned long long runs;
+  unsigned long long overruns;
+  unsigned long long last;      /* execution time */
+  unsigned long long min;
+  unsigned long long max;
+  unsigned long long total;
+  unsigned long long jitter_max;
+  unsigned long long jitter[__TASK_JITTER_BUCKETS];
+  /* the state of the current run */
+  unsigned long long origin;    /* the time of tick 0 */
+  unsigned long long release;
+  unsigned long long busy;      /* the time spent in the programs of the task */
+  unsigned long long start;     /* the start of the program currently running */
+} __task_stats_t;
+
+/* defined by the runtime */
+extern unsigned long long __task_stats_now(void);
+
+static inline void __task_stats_jitter(__task_stats_t *stats, unsigned long long now) {
+  unsigned long long range  = (0 != stats->period)? stats->period : stats->tick;
+  unsigned long long jitter = now - stats->release;
+  unsigned long long bucket = (0 != range)? jitter / ((range + __TASK_JITTER_BUCKETS - 1) / __TASK_JITTER_BUCKETS) : 0;
+
+  if (bucket >= __TASK_JITTER_BUCKETS) bucket = __TASK_JITTER_BUCKETS - 1;
+  stats->jitter[bucket]++;
+  if (jitter > stats->jitter_max) stats->jitter_max = jitter;
+  stats->busy = 0;
+}
+
+/* The task is due on this tick (resource run function) */
+static inline void __task_stats_begin(__task_stats_t *stats, unsigned long long tick) {
+  unsigned long long now = __task_stats_now();
+  unsigned long long release;
+
+  /* the first run, or the task started before the release we assumed (the runtime does not start on tick 0) */
+  if ((0 == stats->runs) || (now < stats->origin + tick * stats->tick))
+    stats->origin = now - tick * stats->tick;
+  release = stats->origin + tick * stats->tick;
+  /* missed releases, if the runtime skipped the ticks on which the task was due */
+  if ((0 != stats->runs) && (0 != stats->period) && (release > stats->release + stats->period))
+    stats->overruns += (release - stats->release) / stats->period - 1;
+  stats->release = release;
+  __task_stats_jitter(stats, now);
+}
+
+/* The run function of the task was called (preemptive runtimes) */
+static inline void __task_stats_begin_task(__task_stats_t *stats) {
+  unsigned long long now = __task_stats_now();
+
+  if ((0 == stats->runs) || (0 == stats->period) || (now < stats->release + stats->period)) {
+    stats->release = now;
+  } else {
+    unsigned long long missed = (now - stats->release) / stats->period - 1;
+    stats->overruns += missed;
+    stats->release  += (missed + 1) * stats->period;
+  }
+  __task_stats_jitter(stats, now);
+}
+
+#define __TASK_STATS_PROGRAM_BEGIN(stats) (stats).start = __task_stats_now();
+#define __TASK_STATS_PROGRAM_END(stats)   (stats).busy += __task_stats_now() - (stats).start;
+
+static inline void __task_stats_end(__task_stats_t *stats) {
+  unsigned long long now = __task_stats_now();
+
+  stats->last = stats->busy;
+  if ((0 == stats->runs) || (stats->busy < stats->min)) stats->min = stats->busy;
+  if (stats->busy > stats->max) stats->max = stats->busy;
+  stats->total += stats->busy;
+  stats->runs++;
+  /* the task ended after its next release */
+  if ((0 != stats->period) && (now - stats->release > stats->period))
+    stats->overruns++;
+}
+
+static inline unsigned long long __task_stats_average(const __task_stats_t *stats) {
+  return (0 != stats->runs)? stats->total / stats->runs : 0;
+}
+
+static inline void __task_stats_reset(__task_stats_t *stats) {
+  int i;
+  for (; NULL != stats->name; stats++) {
+    stats->runs = stats->overruns = stats->last = stats->min = stats->max = stats->total = stats->jitter_max = 0;
+    for (i = 0; i < __TASK_JITTER_BUCKETS; i++) stats->jitter[i] = 0;
+  }
+}
+
+#endif /* _IEC_TASK_STATS_H */
@@ -0,0 +1,141 @@
+/*
+ * copyright 2008 Edouard TISSERANT
+ * copyright 2011 Mario de Sousa (msousa@fe.up.pt)
+ *
+ * Offered to the public under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/****
+ * The timer wheel used by the TP, TON and TOF standard FBs (USE_TIMER_WHEEL, iec2c -O w)
+ *
+ * A hierarchical timing wheel, with __TIMER_WHEEL_LEVELS levels of __TIMER_WHEEL_SLOTS slots each.
+ * A running timer is placed in the slot of level 0 of the tick it expires, if it expires within
+ * the next __TIMER_WHEEL_SLOTS ticks, otherwise in a slot of a higher level that covers a range of
+ * ticks. Every time the wheel has gone round all the slots of a level, the timers in the next slot
+ * of the level above are moved down (cascaded) to the lower levels.
+ *
+ * Starting (or restarting) a timer, and advancing the wheel by one tick, therefore take a constant time,
+ * plus the time to handle the timers that expire (or are cascaded). The timers that are not running
+ * are not in the wheel at all.
+ *
+ * The wheel is advanced by the run functions of the resources, before running the tasks of the tick.
+ * NOTE: There is only one wheel, shared by all the resources of the configuration. The resources must
+ *       not be run in parallel (e.g. on separate threads) when using the wheel.
+ *
+ * This file is included by iec_std_lib.h, do not include it directly.
+ */
+
+#ifndef _IEC_TIMER_WHEEL_H
+#define _IEC_TIMER_WHEEL_H
+
+#include <stddef.h>
+
+#define __TIMER_WHEEL_BITS    6
+#define __TIMER_WHEEL_SLOTS   (1 << __TIMER_WHEEL_BITS)
+#define __TIMER_WHEEL_MASK    (__TIMER_WHEEL_SLOTS - 1)
+#define __TIMER_WHEEL_LEVELS  4
+/* the number of ticks covered by the wheel. Timers expiring later are placed in the last slot of the highest level. */
+#define __TIMER_WHEEL_RANGE   (1ULL << (__TIMER_WHEEL_BITS * __TIMER_WHEEL_LEVELS))
+
+typedef struct {
+  unsigned long long now;   /* the last tick handled by the wheel */
+  unsigned long count;      /* the number of timers in the wheel */
+  __tick_timer_t *slot[__TIMER_WHEEL_LEVELS][__TIMER_WHEEL_SLOTS];
+} __timer_wheel_t;
+
+/* defined in the code generated for the configuration */
+extern __timer_wheel_t __TIMER_WHEEL;
+
+
+static inline void __timer_wheel_remove(__tick_timer_t *timer) {
+  if (NULL == timer->pprev) return;
+  if (NULL != timer->next) timer->next->pprev = timer->pprev;
+  *timer->pprev = timer->next;
+  timer->next  = NULL;
+  timer->pprev = NULL;
+  __TIMER_WHEEL.count--;
+}
+
+/* Place the timer in the slot for its end tick, which may not be earlier than the tick 'earliest' */
+static inline void __timer_wheel_link(__tick_timer_t *timer, unsigned long long earliest) {
+  __timer_wheel_t *wheel = &__TIMER_WHEEL;
+  unsigned long long end = (timer->end < earliest)? earliest : timer->end;
+  unsigned long long delta;
+  __tick_timer_t **slot;
+  int level;
+
+  if (end - wheel->now >= __TIMER_WHEEL_RANGE) end = wheel->now + __TIMER_WHEEL_RANGE - 1;
+  delta = end - wheel->now;
+  for (level = 0; level < __TIMER_WHEEL_LEVELS - 1; level++)
+    if (delta < (1ULL << (__TIMER_WHEEL_BITS * (level + 1)))) break;
+
+  slot = &wheel->slot[level][(end >> (__TIMER_WHEEL_BITS * level)) & __TIMER_WHEEL_MASK];
+  timer->next  = *slot;
+  timer->pprev = slot;
+  if (NULL != timer->next) timer->next->pprev = &timer->next;
+  *slot = timer;
+  wheel->count++;
+}
+
+/* (Re)start the timer. It will be handled by the wheel on the next tick, at the earliest. */
+static inline void __timer_wheel_insert(__tick_timer_t *timer) {
+  __timer_wheel_remove(timer);
+  __timer_wheel_link(timer, __TIMER_WHEEL.now + 1);
+}
+
+static inline void __tick_timer_init(__tick_timer_t *timer, void (*expired)(__tick_timer_t *timer)) {
+  /* NOTE: the timers are initialised after the wheel (see __timer_wheel_init()), so must not be removed from it! */
+  timer->next    = NULL;
+  timer->pprev   = NULL;
+  timer->expired = expired;
+}
+
+/* Called by config_init__(), before the FB instances are initialised */
+static inline void __timer_wheel_init(void) {
+  memset(&__TIMER_WHEEL, 0, sizeof(__TIMER_WHEEL));
+  __TIMER_WHEEL.now = __CURRENT_TICK;
+}
+
+/* Take all the timers out of a slot, and either place them in a lower level slot, or tell them they expired */
+static inline void __timer_wheel_empty_slot(__tick_timer_t **slot) {
+  __tick_timer_t *timer = *slot;
+  *slot = NULL;
+  while (NULL != timer) {
+    __tick_timer_t *next = timer->next;
+    timer->next  = NULL;
+    timer->pprev = NULL;
+    __TIMER_WHEEL.count--;
+    if (timer->end <= __TIMER_WHEEL.now) timer->expired(timer);
+    else                                 __timer_wheel_link(timer, __TIMER_WHEEL.now);
+    timer = next;
+  }
+}
+
+/* Handle all the ticks up to (and including) tick */
+static inline void __timer_wheel_advance(unsigned long long tick) {
+  __timer_wheel_t *wheel = &__TIMER_WHEEL;
+  while (wheel->now < tick) {
+    int level;
+    /* nothing to do while the wheel is empty */
+    if (0 == wheel->count) {wheel->now = tick; return;}
+    wheel->now++;
+    /* cascade the levels that have gone round all their slots, starting with the highest one */
+    for (level = 1; level < __TIMER_WHEEL_LEVELS; level++)
+      if ((wheel->now & ((1ULL << (__TIMER_WHEEL_BITS * level)) - 1)) != 0) break;
+    for (level--; level > 0; level--)
+      __timer_wheel_empty_slot(&wheel->slot[level][(wheel->now >> (__TIMER_WHEEL_BITS * level)) & __TIMER_WHEEL_MASK]);
+    __timer_wheel_empty_slot(&wheel->slot[0][wheel->now & __TIMER_WHEEL_MASK]);
+  }
+}
+
+#endif /* _IEC_TIMER_WHEEL_H */
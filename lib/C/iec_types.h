@@ -29,6 +29,13 @@ typedef uint64_t   IEC_LWORD;
 typedef float    IEC_REAL;
 typedef double   IEC_LREAL;
 
+#ifdef USE_INT64_TIME
+/* TIME, DATE, DT and TOD are stored as a single (signed) count of nanoseconds (iec2c -O t),
+ * so comparing, adding and subtracting them is a single integer operation.
+ * NOTE: the code setting __CURRENT_TIME (i.e. the runtime) must be compiled with the same USE_INT64_TIME too!
+ */
+typedef int64_t IEC_TIMESPEC;
+#else
 /* WARNING: When editing the definition of IEC_TIMESPEC, take note that 
  *          if the order of the two elements 'tv_sec' and 'tv_nsec' is changed, then the macros 
  *          __time_to_timespec() and __tod_to_timespec() will need to be changed accordingly.
@@ -38,6 +45,7 @@ typedef struct {
     long int tv_sec;            /* Seconds.  */
     long int tv_nsec;           /* Nanoseconds.  */
 } /* __attribute__((packed)) */ IEC_TIMESPEC;  /* packed is gcc specific! */
+#endif
 
 typedef IEC_TIMESPEC IEC_TIME;
 typedef IEC_TIMESPEC IEC_DATE;
@@ -62,7 +70,11 @@ typedef IEC_TIMESPEC IEC_TOD;
 #define __INIT_UINT 0
 #define __INIT_UDINT 0
 #define __INIT_ULINT 0
+#ifdef USE_INT64_TIME
+#define __INIT_TIME 0
+#else
 #define __INIT_TIME (TIME){0,0}
+#endif
 #define __INIT_BOOL 0
 #define __INIT_BYTE 0
 #define __INIT_WORD 0
@@ -70,9 +82,15 @@ typedef IEC_TIMESPEC IEC_TOD;
 #define __INIT_LWORD 0
 #define __INIT_STRING (STRING){0,""}
 //#define __INIT_WSTRING
+#ifdef USE_INT64_TIME
+#define __INIT_DATE 0
+#define __INIT_TOD 0
+#define __INIT_DT 0
+#else
 #define __INIT_DATE (DATE){0,0}
 #define __INIT_TOD (TOD){0,0}
 #define __INIT_DT (DT){0,0}
+#endif
 
 typedef STR_LEN_TYPE __strlen_t;
 typedef struct {
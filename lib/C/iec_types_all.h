@@ -72,6 +72,15 @@
 #define __IEC_RETAIN_FLAG 0x04
 #define __IEC_OUTPUT_FLAG 0x08
 
+/* When the code is generated without support for forcing variables (iec2c -O f),
+ * the pointer variants do not need to keep the forced value.
+ */
+#ifdef DISABLE_VARIABLE_FORCING
+  #define __IEC_FORCED_VALUE(type)
+#else
+  #define __IEC_FORCED_VALUE(type) type fvalue;
+#endif
+
 #define __DECLARE_IEC_TYPE(type)\
 typedef IEC_##type type;\
 \
@@ -83,7 +92,7 @@ typedef struct {\
 typedef struct {\
   IEC_##type *value;\
   IEC_BYTE flags;\
-  IEC_##type fvalue;\
+  __IEC_FORCED_VALUE(IEC_##type)\
 } __IEC_##type##_p;
 
 
@@ -102,7 +111,7 @@ typedef struct {\
 typedef struct {\
   type *value;\
   IEC_BYTE flags;\
-  type fvalue;\
+  __IEC_FORCED_VALUE(type)\
 } __IEC_##type##_p;
 
 #define __DECLARE_ENUMERATED_TYPE(type, ...)\
@@ -111,6 +120,14 @@ typedef enum {\
 } type;\
 __DECLARE_COMPLEX_STRUCT(type)
 
+/* An enumerated type stored in the (unsigned integer) base type, the smallest that holds all its values */
+#define __DECLARE_COMPACT_ENUMERATED_TYPE(type, base, ...)\
+enum {\
+  __VA_ARGS__\
+};\
+typedef IEC_##base type;\
+__DECLARE_COMPLEX_STRUCT(type)
+
 #define __DECLARE_ARRAY_TYPE(type, base, size)\
 typedef struct {\
   base table size;\
@@ -148,6 +165,15 @@ typedef struct {
   TIME reset_remaining_time;  // time before reset will be requested
 } ACTION;
 
+/* The tasks of each resource (<resource>_tasks__[] in the generated code, terminated by an entry with a NULL name) */
+typedef struct {
+  const char *name;
+  int priority;                  // the PRIORITY of the task (0 is the highest priority)
+  unsigned long long period;     // the INTERVAL of the task, in ns (0 if the task is not periodic)
+  void (*run)(void);             // runs all the programs associated to the task
+  void (*trigger)(void);         // posts an event to the task (the SINGLE tasks, with iec2c -O E), NULL for the others
+} __IEC_TASK_t;
+
 /* Extra debug types for SFC */
 #define __ANY_SFC(DO) DO(STEP) DO(TRANSITION) DO(ACTION)
 
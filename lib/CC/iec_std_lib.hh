@@ -0,0 +1,370 @@
+/*
+ * copyright 2008 Edouard TISSERANT
+ * copyright 2011 Mario de Sousa (msousa@fe.up.pt)
+ *
+ * Offered to the public under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/****
+ * IEC 61131-3 standard function library, for the C++ code generated by iec2cc (stage4/generate_cc)
+ *
+ * The C++ counterpart of iec_std_lib.h: instead of expanding a C function for each overload of
+ * each standard function (the __ANY(DO) macros of iec_types_all.h and iec_std_functions.h), every
+ * standard function is a single (constexpr) function template, instantiated by the C++ compiler for
+ * the datatypes it is called with. The extensible functions (ADD, MUL, MIN, ...) are variadic, so
+ * their number of inputs is resolved at compile time too, and the EN/ENO handling is only generated
+ * for the calls that pass EN or ENO (call_en()).
+ *
+ * The results are the same as those of iec_std_lib.h, compiled with USE_INT64_TIME, i.e. TIME,
+ * DATE, TOD and DT are a count of ns (but each its own type, so only the valid TIME arithmetic
+ * compiles), the integer divisions by 0 return 0, and REAL -> integer conversions round the
+ * halfway cases to the even integer.
+ *
+ * The runtime must define __CURRENT_TIME (an int64_t, in ns, as the C runtime with USE_INT64_TIME),
+ * read by the standard timers TON, TOF and TP, which are implemented here rather than generated.
+ *
+ * Requires C++14.
+ */
+
+#ifndef _IEC_STD_LIB_HH
+#define _IEC_STD_LIB_HH
+
+#include <stddef.h>
+#include <stdint.h>
+#include <math.h>
+#include <type_traits>
+
+extern "C" {
+  extern int64_t __CURRENT_TIME;  /* set by the runtime, in ns */
+}
+
+namespace iec {
+
+/*****************************/
+/* The elementary data types */
+/*****************************/
+typedef bool     BOOL;
+typedef int8_t   SINT;
+typedef int16_t  INT;
+typedef int32_t  DINT;
+typedef int64_t  LINT;
+typedef uint8_t  USINT;
+typedef uint16_t UINT;
+typedef uint32_t UDINT;
+typedef uint64_t ULINT;
+typedef uint8_t  BYTE;
+typedef uint16_t WORD;
+typedef uint32_t DWORD;
+typedef uint64_t LWORD;
+typedef float    REAL;
+typedef double   LREAL;
+
+/* TIME, DATE, TOD and DT: a count of ns, since 1970-01-01 for DATE and DT, since midnight for TOD */
+enum time_kind_t {time_tk, date_tk, tod_tk, dt_tk};
+
+template<time_kind_t KIND> struct time_value_t {
+  int64_t ns;
+  constexpr time_value_t(void): ns(0) {}
+  explicit constexpr time_value_t(int64_t ns_): ns(ns_) {}
+};
+
+typedef time_value_t<time_tk> TIME;
+typedef time_value_t<date_tk> DATE;
+typedef time_value_t<tod_tk>  TOD;
+typedef time_value_t<dt_tk>   DT;
+
+static constexpr int64_t ns_per_day = 86400LL * 1000000000LL;
+
+template<typename T> struct is_time                : std::false_type {};
+template<time_kind_t K> struct is_time<time_value_t<K> > : std::true_type {};
+
+/* the comparisons, between values of the same type */
+template<time_kind_t K> constexpr bool operator==(time_value_t<K> a, time_value_t<K> b) {return a.ns == b.ns;}
+template<time_kind_t K> constexpr bool operator!=(time_value_t<K> a, time_value_t<K> b) {return a.ns != b.ns;}
+template<time_kind_t K> constexpr bool operator< (time_value_t<K> a, time_value_t<K> b) {return a.ns <  b.ns;}
+template<time_kind_t K> constexpr bool operator<=(time_value_t<K> a, time_value_t<K> b) {return a.ns <= b.ns;}
+template<time_kind_t K> constexpr bool operator> (time_value_t<K> a, time_value_t<K> b) {return a.ns >  b.ns;}
+template<time_kind_t K> constexpr bool operator>=(time_value_t<K> a, time_value_t<K> b) {return a.ns >= b.ns;}
+
+/* the arithmetic of table 30: TIME (and TOD, DT) + TIME, <any> - TIME, TOD - TOD, DATE - DATE, DT - DT */
+constexpr TIME operator-(TIME a) {return TIME(-a.ns);}
+template<time_kind_t K> constexpr typename std::enable_if<K != date_tk, time_value_t<K> >::type
+operator+(time_value_t<K> a, TIME b) {return time_value_t<K>(a.ns + b.ns);}
+template<time_kind_t K> constexpr typename std::enable_if<K != date_tk, time_value_t<K> >::type
+operator-(time_value_t<K> a, TIME b) {return time_value_t<K>(a.ns - b.ns);}
+template<time_kind_t K> constexpr typename std::enable_if<K != time_tk, TIME>::type
+operator-(time_value_t<K> a, time_value_t<K> b) {return TIME(a.ns - b.ns);}
+
+/* TIME * ANY_NUM, TIME / ANY_NUM (as __time_mul() and __time_div()) */
+template<typename N> constexpr typename std::enable_if<std::is_arithmetic<N>::value, TIME>::type
+operator*(TIME a, N b) {return std::is_floating_point<N>::value? TIME((int64_t)(a.ns * (LREAL)b)) : TIME(a.ns * (int64_t)b);}
+template<typename N> constexpr typename std::enable_if<std::is_arithmetic<N>::value, TIME>::type
+operator/(TIME a, N b) {return std::is_floating_point<N>::value? TIME((int64_t)(a.ns / (LREAL)b)) : ((0 == b)? TIME(0) : TIME(a.ns / (int64_t)b));}
+
+inline TIME current_time(void) {return TIME(__CURRENT_TIME);}
+
+
+/****************************/
+/* Type conversion (*_TO_*) */
+/****************************/
+/* REAL -> integer, rounding the halfway cases to the even integer (as __real_round()) */
+inline LINT real_round(LREAL in) {return (fmod(in, 1) == 0)? ((LINT)in / 2) * 2 : (LINT)in;}
+inline LINT real_to_int(LREAL in, bool is_signed) {
+  return (in >= 0)? real_round(in + 0.5) : (is_signed? real_round(in - 0.5) : 0);
+}
+
+template<typename TO, typename FROM, typename Enable = void> struct converter;
+
+/* between the numeric and bit string types */
+template<typename TO, typename FROM>
+struct converter<TO, FROM, typename std::enable_if<std::is_arithmetic<TO>::value && std::is_arithmetic<FROM>::value>::type> {
+  static constexpr TO convert(FROM in) {
+    return std::is_same<TO, BOOL>::value? TO(in != 0)
+         : (std::is_floating_point<FROM>::value && !std::is_floating_point<TO>::value)? TO(real_to_int(in, std::is_signed<TO>::value))
+         : TO(in);
+  }
+};
+
+/* ANY_NUM -> TIME, in s (as __int_to_time() and __real_to_time()) */
+template<typename FROM>
+struct converter<TIME, FROM, typename std::enable_if<std::is_arithmetic<FROM>::value>::type> {
+  static constexpr TIME convert(FROM in) {
+    return std::is_floating_point<FROM>::value? TIME((LINT)in * 1000000000LL + (LINT)((in - (LINT)in) * 1000000000))
+                                              : TIME((LINT)in * 1000000000LL);
+  }
+};
+
+/* TIME, DATE, TOD, DT -> ANY_NUM, in s (as __time_to_int() and __time_to_real()) */
+template<typename TO, time_kind_t K>
+struct converter<TO, time_value_t<K>, typename std::enable_if<std::is_arithmetic<TO>::value>::type> {
+  static constexpr TO convert(time_value_t<K> in) {
+    return std::is_same<TO, BOOL>::value? TO(in.ns != 0)
+         : std::is_floating_point<TO>::value? TO((LREAL)(in.ns / 1000000000LL) + (LREAL)(in.ns % 1000000000LL) / 1000000000)
+         : TO(in.ns / 1000000000LL);
+  }
+};
+
+/* DT_TO_TOD, DT_TO_DATE, and between values of the same type */
+template<time_kind_t TO_K, time_kind_t K> struct converter<time_value_t<TO_K>, time_value_t<K>, typename std::enable_if<TO_K == K>::type> {
+  static constexpr time_value_t<K> convert(time_value_t<K> in) {return in;}
+};
+template<> struct converter<TOD,  DT> {static constexpr TOD  convert(DT in) {return TOD(in.ns % ns_per_day);}};
+template<> struct converter<DATE, DT> {static constexpr DATE convert(DT in) {return DATE(in.ns - in.ns % ns_per_day);}};
+
+template<typename TO, typename FROM> constexpr TO convert(FROM in) {return converter<TO, FROM>::convert(in);}
+
+/* TRUNC: REAL -> integer, rounding towards 0 */
+template<typename TO, typename FROM> constexpr TO trunc(FROM in) {return TO(in);}
+
+/* CONCAT_DATE_TOD */
+constexpr DT CONCAT_DATE_TOD(DATE d, TOD t) {return DT(d.ns + t.ns);}
+
+
+/***********************/
+/* Numerical functions */
+/***********************/
+template<typename T> constexpr T ABS(T in) {return (in < 0)? T(-in) : in;}
+template<typename T> inline T SQRT(T in) {return T(sqrt(in));}
+template<typename T> inline T LN  (T in) {return T(log(in));}
+template<typename T> inline T LOG (T in) {return T(log10(in));}
+template<typename T> inline T EXP (T in) {return T(exp(in));}
+template<typename T> inline T SIN (T in) {return T(sin(in));}
+template<typename T> inline T COS (T in) {return T(cos(in));}
+template<typename T> inline T TAN (T in) {return T(tan(in));}
+template<typename T> inline T ASIN(T in) {return T(asin(in));}
+template<typename T> inline T ACOS(T in) {return T(acos(in));}
+template<typename T> inline T ATAN(T in) {return T(atan(in));}
+template<typename T, typename N> inline T EXPT(T in1, N in2) {return T(pow((LREAL)in1, (LREAL)in2));}
+
+
+/************************************************/
+/* Arithmetic functions (extensible: ADD, MUL)  */
+/************************************************/
+/* On the integer types, the result is wrapped to the type of the operands (not promoted to int) */
+template<typename T> constexpr T add2(T a, T b) {return T(a + b);}
+template<time_kind_t K> constexpr time_value_t<K> add2(time_value_t<K> a, TIME b) {return a + b;}
+template<typename T> constexpr T mul2(T a, T b) {return T(a * b);}
+template<typename N> constexpr TIME mul2(TIME a, N b) {return a * b;}
+
+template<typename T> constexpr T ADD(T in1) {return in1;}
+template<typename T, typename U, typename... R> constexpr T ADD(T in1, U in2, R... in) {return ADD(add2(in1, in2), in...);}
+template<typename T> constexpr T MUL(T in1) {return in1;}
+template<typename T, typename U, typename... R> constexpr T MUL(T in1, U in2, R... in) {return MUL(mul2(in1, in2), in...);}
+
+template<typename T> constexpr T sub2(T a, T b) {return T(a - b);}
+template<time_kind_t K> constexpr time_value_t<K> sub2(time_value_t<K> a, TIME b) {return a - b;}
+template<time_kind_t K> constexpr typename std::enable_if<K != time_tk, TIME>::type sub2(time_value_t<K> a, time_value_t<K> b) {return a - b;}
+template<typename T, typename U> constexpr auto SUB(T in1, U in2) -> decltype(sub2(in1, in2)) {return sub2(in1, in2);}
+
+/* the integer divisions by 0 return 0 */
+template<typename T> constexpr typename std::enable_if<std::is_floating_point<T>::value, T>::type div2(T a, T b) {return a / b;}
+template<typename T> constexpr typename std::enable_if<std::is_integral<T>::value, T>::type div2(T a, T b) {return (0 == b)? T(0) : T(a / b);}
+template<typename N> constexpr TIME div2(TIME a, N b) {return a / b;}
+template<typename T, typename U> constexpr auto DIV(T in1, U in2) -> decltype(div2(in1, in2)) {return div2(in1, in2);}
+template<typename T> constexpr T MOD(T in1, T in2) {return (0 == in2)? T(0) : T(in1 % in2);}
+
+template<typename T> constexpr T MOVE(T in) {return in;}
+
+
+/*************************************/
+/* Bit shift and bitwise functions   */
+/*************************************/
+template<typename T, typename N> constexpr T SHL(T in, N n) {return ((ULINT)n >= 8 * sizeof(T))? T(0) : T(in << n);}
+template<typename T, typename N> constexpr T SHR(T in, N n) {return ((ULINT)n >= 8 * sizeof(T))? T(0) : T(in >> n);}
+template<typename T, typename N> constexpr T ROL(T in, N n) {
+  return std::is_same<T, BOOL>::value? in : T((in << (n % (8 * sizeof(T)))) | (in >> ((8 * sizeof(T) - n % (8 * sizeof(T))) % (8 * sizeof(T)))));
+}
+template<typename T, typename N> constexpr T ROR(T in, N n) {
+  return std::is_same<T, BOOL>::value? in : T((in >> (n % (8 * sizeof(T)))) | (in << ((8 * sizeof(T) - n % (8 * sizeof(T))) % (8 * sizeof(T)))));
+}
+
+template<typename T> constexpr T and2(T a, T b) {return std::is_same<T, BOOL>::value? T(a && b) : T(a & b);}
+template<typename T> constexpr T or2 (T a, T b) {return std::is_same<T, BOOL>::value? T(a || b) : T(a | b);}
+template<typename T> constexpr T xor2(T a, T b) {return std::is_same<T, BOOL>::value? T(a != b) : T(a ^ b);}
+
+template<typename T> constexpr T AND(T in1) {return in1;}
+template<typename T, typename... R> constexpr T AND(T in1, T in2, R... in) {return AND(and2(in1, in2), in...);}
+template<typename T> constexpr T OR (T in1) {return in1;}
+template<typename T, typename... R> constexpr T OR (T in1, T in2, R... in) {return OR (or2 (in1, in2), in...);}
+template<typename T> constexpr T XOR(T in1) {return in1;}
+template<typename T, typename... R> constexpr T XOR(T in1, T in2, R... in) {return XOR(xor2(in1, in2), in...);}
+template<typename T> constexpr T NOT(T in) {return T(~in);}
+constexpr BOOL NOT(BOOL in) {return !in;}
+
+
+/***************************/
+/* Selection functions     */
+/***************************/
+template<typename T> constexpr T SEL(BOOL g, T in0, T in1) {return g? in1 : in0;}
+
+template<typename T> constexpr T MAX(T in1) {return in1;}
+template<typename T, typename... R> constexpr T MAX(T in1, T in2, R... in) {return MAX((in1 > in2)? in1 : in2, in...);}
+template<typename T> constexpr T MIN(T in1) {return in1;}
+template<typename T, typename... R> constexpr T MIN(T in1, T in2, R... in) {return MIN((in1 < in2)? in1 : in2, in...);}
+template<typename T> constexpr T LIMIT(T mn, T in, T mx) {return (in > mx)? mx : (in < mn)? mn : in;}
+
+/* MUX: K out of range returns the default initial value of the type (as the C version) */
+template<typename K, typename T> constexpr T mux_n(K k, K i, T in) {return (k == i)? in : T();}
+template<typename K, typename T, typename... R> constexpr T mux_n(K k, K i, T in, R... rest) {return (k == i)? in : mux_n(k, K(i + 1), rest...);}
+template<typename K, typename T, typename... R> constexpr T MUX(K k, T in0, R... in) {return mux_n(k, K(0), in0, T(in)...);}
+
+
+/***************************/
+/* Comparison functions    */
+/***************************/
+/* the extensible comparisons are TRUE if each pair of consecutive inputs compares TRUE */
+template<typename T> constexpr BOOL GT(T in1, T in2) {return in1 > in2;}
+template<typename T, typename... R> constexpr BOOL GT(T in1, T in2, T in3, R... in) {return (in1 > in2) && GT(in2, in3, in...);}
+template<typename T> constexpr BOOL GE(T in1, T in2) {return in1 >= in2;}
+template<typename T, typename... R> constexpr BOOL GE(T in1, T in2, T in3, R... in) {return (in1 >= in2) && GE(in2, in3, in...);}
+template<typename T> constexpr BOOL EQ(T in1, T in2) {return in1 == in2;}
+template<typename T, typename... R> constexpr BOOL EQ(T in1, T in2, T in3, R... in) {return (in1 == in2) && EQ(in2, in3, in...);}
+template<typename T> constexpr BOOL LE(T in1, T in2) {return in1 <= in2;}
+template<typename T, typename... R> constexpr BOOL LE(T in1, T in2, T in3, R... in) {return (in1 <= in2) && LE(in2, in3, in...);}
+template<typename T> constexpr BOOL LT(T in1, T in2) {return in1 < in2;}
+template<typename T, typename... R> constexpr BOOL LT(T in1, T in2, T in3, R... in) {return (in1 < in2) && LT(in2, in3, in...);}
+template<typename T> constexpr BOOL NE(T in1, T in2) {return in1 != in2;}
+
+
+/********************/
+/* EN/ENO handling  */
+/********************/
+/* The call of a standard function with EN and/or ENO: the function (f) is only evaluated when EN is TRUE,
+ * otherwise the result is the default initial value of its type. ENO may be NULL.
+ */
+template<typename F> inline auto call_en(BOOL en, BOOL *eno, F f) -> decltype(f()) {
+  if (!en) {if (NULL != eno) *eno = false; return decltype(f())();}
+  if (NULL != eno) *eno = true;
+  return f();
+}
+
+
+/*****************************************/
+/* Standard timers (as in lib/timer.txt) */
+/*****************************************/
+struct timer_t {
+  BOOL EN, ENO;
+  BOOL IN;
+  TIME PT;
+  BOOL Q;
+  TIME ET;
+  SINT STATE;  /* 0-reset, 1-counting, 2-set */
+  BOOL PREV_IN;
+  TIME CURRENT_TIME, START_TIME;
+
+  void init(BOOL /* retain */) {
+    EN = true; ENO = true; IN = false; PT = TIME(); Q = false; ET = TIME();
+    STATE = 0; PREV_IN = false; CURRENT_TIME = TIME(); START_TIME = TIME();
+  }
+};
+
+/* on-delay timer */
+struct TON: timer_t {
+  void body(void) {
+    if (!EN) {ENO = false; return;}
+    ENO = true;
+    CURRENT_TIME = current_time();
+    if ((0 == STATE) && !PREV_IN && IN) {STATE = 1; Q = false; START_TIME = CURRENT_TIME;}  /* found rising edge on IN */
+    else if (!IN) {ET = TIME(); Q = false; STATE = 0;}
+    else if (1 == STATE) {
+      if (START_TIME + PT <= CURRENT_TIME) {STATE = 2; Q = true; ET = PT;}
+      else                                 ET = CURRENT_TIME - START_TIME;
+    }
+    PREV_IN = IN;
+  }
+};
+
+/* off-delay timer */
+struct TOF: timer_t {
+  void body(void) {
+    if (!EN) {ENO = false; return;}
+    ENO = true;
+    CURRENT_TIME = current_time();
+    if ((0 == STATE) && PREV_IN && !IN) {STATE = 1; START_TIME = CURRENT_TIME;}  /* found falling edge on IN */
+    else if (IN) {ET = TIME(); STATE = 0;}
+    else if (1 == STATE) {
+      if (START_TIME + PT <= CURRENT_TIME) {STATE = 2; ET = PT;}
+      else                                 ET = CURRENT_TIME - START_TIME;
+    }
+    Q = IN || (1 == STATE);
+    PREV_IN = IN;
+  }
+};
+
+/* pulse timer */
+struct TP: timer_t {
+  void body(void) {
+    if (!EN) {ENO = false; return;}
+    ENO = true;
+    CURRENT_TIME = current_time();
+    if ((0 == STATE) && !PREV_IN && IN) {STATE = 1; Q = true; START_TIME = CURRENT_TIME;}  /* found rising edge on IN */
+    else if (1 == STATE) {
+      if (START_TIME + PT <= CURRENT_TIME) {STATE = 2; Q = false; ET = PT;}
+      else                                 ET = CURRENT_TIME - START_TIME;
+    }
+    if ((2 == STATE) && !IN) {ET = TIME(); STATE = 0;}
+    PREV_IN = IN;
+  }
+};
+
+} /* namespace iec */
+
+
+/* the generated code uses the names of the elementary data types unqualified */
+using iec::BOOL;  using iec::SINT;  using iec::INT;   using iec::DINT;  using iec::LINT;
+using iec::USINT; using iec::UINT;  using iec::UDINT; using iec::ULINT;
+using iec::BYTE;  using iec::WORD;  using iec::DWORD; using iec::LWORD;
+using iec::REAL;  using iec::LREAL;
+using iec::TIME;  using iec::DATE;  using iec::TOD;   using iec::DT;
+
+#endif /* _IEC_STD_LIB_HH */
@@ -0,0 +1,170 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2003-2011  Mario de Sousa (msousa@fe.up.pt)
+ *  Copyright (C) 2007-2011  Laurent Bessard and Edouard Tisserant
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ *
+ * Microbenchmarks of the C implementation of the standard IEC functions and FBs.
+ *
+ * Times each primitive, in ns per call, and prints one CSV line per primitive:
+ *   variant,primitive,calls,ns_per_call
+ * where variant is "eneno" or "no_eneno", i.e. whether it was compiled with the EN/ENO
+ * parameters (iec_std_FB.h) or without them (DISABLE_EN_ENO_PARAMETERS, iec_std_FB_no_ENENO.h).
+ *
+ * Build and run both variants on the target, with the same C compiler and options as the
+ * generated code, e.g.:
+ *   cc -O2 -IC bench_iec_std_lib.c -o bench_eneno -lm
+ *   cc -O2 -IC -DDISABLE_EN_ENO_PARAMETERS bench_iec_std_lib.c -o bench_no_eneno -lm
+ *   ./bench_eneno > report.csv; ./bench_no_eneno -n >> report.csv
+ *
+ * Usage: bench [-n] [calls]
+ *   -n    : do not print the CSV header line (to append to the report of the other variant)
+ *   calls : the number of calls timed for each primitive (default 1000000)
+ *
+ * The "loop" primitive is the cost of the benchmark loop itself, which is included in all others.
+ */
+
+#include "iec_std_lib.h"
+
+#include <time.h>
+
+TIME __CURRENT_TIME;
+BOOL __DEBUG;
+
+#ifdef DISABLE_EN_ENO_PARAMETERS
+#define VARIANT "no_eneno"
+#else
+#define VARIANT "eneno"
+#endif
+
+/* The values are read through volatile variables, so the C compiler may not evaluate the calls at compile time */
+static volatile DINT   v_dint  = 12345;
+static volatile LREAL  v_lreal = 3.25;
+static volatile LINT   v_lint  = -1234567890123LL;
+static volatile BOOL   v_bool;
+static volatile DINT   sink_dint;
+static volatile int    sink_int;
+static STRING          v_string1, v_string2;
+
+static unsigned long calls = 1000000;
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static void report(const char *primitive, double start, double end) {
+  printf("%s,%s,%lu,%.3f\n", VARIANT, primitive, calls, (end - start) / calls);
+}
+
+/* Time STATEMENT, run calls times (i is the number of the call) */
+#define BENCH(primitive, STATEMENT) {\
+  unsigned long i;\
+  double start = now_ns();\
+  for (i = 0; i < calls; i++) {STATEMENT;}\
+  report(primitive, start, now_ns());\
+}
+
+static STRING make_string(const char *value) {
+  STRING res;
+  res.len = strlen(value);
+  memcpy(res.body, value, res.len);
+  return res;
+}
+
+int main(int argc,char **argv)
+{
+  int arg = 1;
+  BOOL header = 1;
+#ifndef DISABLE_EN_ENO_PARAMETERS
+  BOOL  EN = 1;
+  BOOL  eno;
+  BOOL *ENO = &eno;
+#endif
+
+  if (arg < argc && strcmp(argv[arg], "-n") == 0) {header = 0; arg++;}
+  if (arg < argc) calls = strtoul(argv[arg], NULL, 10);
+  if (calls == 0) {fprintf(stderr, "usage: %s [-n] [calls]\n", argv[0]); return 1;}
+
+  v_string1 = make_string("Temperature=");
+  v_string2 = make_string("25.5 degC");
+
+  if (header) printf("variant,primitive,calls,ns_per_call\n");
+
+  BENCH("loop", sink_dint = v_dint)
+
+  /* ADD, with N operands (the extensible version, and the fixed arity ones called by iec2c -O l) */
+  BENCH("ADD_DINT(2)",     sink_dint = ADD_DINT(EN_ENO 2, v_dint, v_dint))
+  BENCH("ADD_DINT(4)",     sink_dint = ADD_DINT(EN_ENO 4, v_dint, v_dint, v_dint, v_dint))
+  BENCH("ADD_DINT(8)",     sink_dint = ADD_DINT(EN_ENO 8, v_dint, v_dint, v_dint, v_dint, v_dint, v_dint, v_dint, v_dint))
+  BENCH("ADD_DINT__N2",    sink_dint = ADD_DINT__N2(EN_ENO 2, v_dint, v_dint))
+  BENCH("ADD_DINT__N4",    sink_dint = ADD_DINT__N4(EN_ENO 4, v_dint, v_dint, v_dint, v_dint))
+
+  /* STRING functions */
+  BENCH("CONCAT(2)",       sink_int  = CONCAT(EN_ENO 2, v_string1, v_string2).len)
+  BENCH("CONCAT(4)",       sink_int  = CONCAT(EN_ENO 4, v_string1, v_string2, v_string1, v_string2).len)
+  BENCH("CONCAT__N2",      sink_int  = CONCAT__N2(EN_ENO 2, v_string1, v_string2).len)
+  BENCH("__STR_CMP",       sink_int  = __STR_CMP(v_string1, v_string2))
+
+  /* *_TO_STRING, and back */
+  BENCH("DINT_TO_STRING",  sink_int  = DINT_TO_STRING(EN_ENO v_dint).len)
+  BENCH("LINT_TO_STRING",  sink_int  = LINT_TO_STRING(EN_ENO v_lint).len)
+  BENCH("DWORD_TO_STRING", sink_int  = DWORD_TO_STRING(EN_ENO v_dint).len)
+  BENCH("LREAL_TO_STRING", sink_int  = LREAL_TO_STRING(EN_ENO v_lreal).len)
+  BENCH("TIME_TO_STRING",  sink_int  = TIME_TO_STRING(EN_ENO __timespec(v_dint, 3500000)).len)
+  BENCH("DT_TO_STRING",    sink_int  = DT_TO_STRING(EN_ENO __timespec(457000000 + v_dint, 0)).len)
+  BENCH("STRING_TO_DINT",  sink_dint = STRING_TO_DINT(EN_ENO v_string2))
+  BENCH("STRING_TO_LREAL", sink_dint = (DINT)STRING_TO_LREAL(EN_ENO v_string2))
+
+  /* timespec arithmetic */
+  BENCH("__time_add",      sink_int  = __time_cmp(__time_add(__timespec(v_dint, 999999999), __timespec(1, v_dint)), __CURRENT_TIME))
+  BENCH("__time_sub",      sink_int  = __time_cmp(__time_sub(__timespec(v_dint, 1), __timespec(1, v_dint)), __CURRENT_TIME))
+  BENCH("__time_mul",      sink_int  = __time_cmp(__time_mul(__timespec(v_dint, 500000000), v_lreal), __CURRENT_TIME))
+
+  /* standard FBs, run as in a cycle of 1 ms */
+  {
+    TON ton;
+    memset(&ton, 0, sizeof(ton));
+    TON_init__(&ton, 0);
+    __SET_VAR(ton.,PT,,__timespec(0, 10000000));
+    __CURRENT_TIME = __timespec(0, 0);
+    BENCH("TON_body__", {
+      __CURRENT_TIME = __time_add(__CURRENT_TIME, __timespec(0, 1000000));
+      __SET_VAR(ton.,IN,,(i & 0x10) != 0);
+      TON_body__(&ton);
+      v_bool = __GET_VAR(ton.Q,);
+    })
+  }
+  {
+    CTU ctu;
+    memset(&ctu, 0, sizeof(ctu));
+    CTU_init__(&ctu, 0);
+    __SET_VAR(ctu.,PV,,1000);
+    BENCH("CTU_body__", {
+      __SET_VAR(ctu.,CU,,(i & 1) != 0);
+      __SET_VAR(ctu.,R,,(i & 0xfff) == 0);
+      CTU_body__(&ctu);
+      v_bool = __GET_VAR(ctu.Q,);
+    })
+  }
+
+  return 0;
+}
@@ -70,9 +70,12 @@
 #include <stdio.h>
 #include <getopt.h>
 #include <string.h>
+#include <ctype.h>
 #include <stdlib.h>
 #include <stdarg.h>
 #include <iostream>
+#include <string>
+#include <vector>
 
 
 #include "config/config.h"
@@ -80,6 +83,8 @@
 #include "absyntax_utils/absyntax_utils.hh"
 #include "stage1_2/stage1_2.hh"
 #include "stage3/stage3.hh"
+#include "stage3/dead_store_analysis.hh"
+#include "stage3/idempotent_fb_analysis.hh"
 #include "stage4/stage4.hh"
 #include "main.hh"
 
@@ -109,7 +114,11 @@ void error_exit(const char *file_name, int line_no, const char *errmsg, ...) {
 
 
 static void printusage(const char *cmd) {
-  printf("\nsyntax: %s [<options>] [-O <output_options>] [-I <include_directory>] [-T <target_directory>] <input_file>\n", cmd);
+  printf("\nsyntax: %s [<options>] [-O <output_options>] [-I <include_directory>] [-T <target_directory>] [-A <fd>] <input_file>\n", cmd);
+  printf("        %s [<options>] [-O <output_options>] [-I <include_directory>] [-T <target_directory>] -B <batch_file>\n", cmd);
+  printf("        %s [<options>] [-O <output_options>] [-I <include_directory>] [-T <target_directory>] -S\n", cmd);
+  printf("        %s [<options>] [-O <output_options>] [-I <include_directory>] [-T <target_directory>] -G <target_directory>[:<output_options>] ... <input_file>\n", cmd);
+  printf("        %s [<options>] [-I <include_directory>] -W\n", cmd);
   printf(" -h : show this help message\n");
   printf(" -v : print version number\n");  
   printf(" -f : display full token location on error messages\n");
@@ -125,6 +134,25 @@ static void printusage(const char *cmd) {
   printf(" -b : allow functions returning VOID                 (a non-standard extension!)\n");
   printf(" -e : disable generation of implicit EN and ENO parameters.\n");
   printf(" -c : create conversion functions for enumerated data types\n");
+  printf(" -U : do not generate code for the POUs and data types not used by any configuration\n");
+  printf(" -k : only check the input file for errors, do not generate any code. With -S, only the POUs changed since the\n");
+  printf("      previous request are checked again (all of them after a change to the declarations of any POU, datatype or configuration)\n");
+  printf(" -K : trusted input (already checked by iec2c): skip the semantic checks that do not change the generated code\n");
+  printf(" -N : normalise (iec2iec only): write the code of the input file again, to the file of the same name in the target\n");
+  printf("      directory, straight after parsing it (the semantic checks are not run). Use -B to normalise many files\n");
+  printf(" -W : save a precompiled snapshot of the standard library, to speed up later runs using the same options\n");
+  printf(" -m : map the input files into memory (faster parsing of very large files)\n");
+  printf(" -L : lazy parsing: skip the FUNCTIONs and FUNCTION_BLOCKs of the {#include}d files not used by the input file\n");
+  printf(" -w : also write the AST annotated by the semantic analyser to AST.img in the target directory, for other tools (see absyntax_utils/ast_image.hh)\n");
+  printf(" -x : also write a cross-reference index (the declarations, reads, writes and calls of each symbol) to XREF.idx\n");
+  printf("      in the target directory, for other tools (see absyntax_utils/xref_index.hh)\n");
+  printf(" -t : print the time and memory used by each phase of the compiler, and the number of AST nodes\n");
+  printf(" -B : compile all the input files listed in <batch_file>, one per line, each optionally followed by its own target directory\n");
+  printf(" -G : also generate the code into <target_directory>, with the given output options instead of those of -O\n");
+  printf("      (may be given several times, the input file is only parsed and checked once for all the targets)\n");
+  printf(" -A : stream the generated files to the file descriptor <fd> ('-' for stdout), each as '<length> <path>\\n' followed by its contents,\n");
+  printf("      instead of writing them to the target directory\n");
+  printf(" -S : run as a compile server, reading from stdin the input files to compile (one per line, as with -B)\n");
   printf(" -O : options for output (code generation) stage. Available options for %s are...\n", cmd);
   runtime_options.allow_missing_var_in    = false; /* disable: allow definition and invocation of POUs with no input, output and in_out parameters! */
   stage4_print_options();
@@ -139,9 +167,269 @@ static void printusage(const char *cmd) {
 runtime_options_t runtime_options;
 
 
-int main(int argc, char **argv) {
+/* The other targets (-G command line option), generated from the same AST as the -T target */
+typedef struct {
+  const char  *builddir;
+  std::string  options;   /* the output options of this target (as given with -O) */
+} target_t;
+
+static std::vector<target_t>    other_targets;
+static std::vector<std::string> output_options;  /* the -O options, of the -T target */
+
+static int generate_other_targets(symbol_c *tree_root);
+
+
+
+/* Normalise a single input file (-N): generate the code of the elements of the input file (and not of the
+ * standard library) straight from the AST built by stage 1_2, into the file of the same name in the target
+ * directory. Returns 0 on success, or < 0 on error.
+ */
+static int normalise(const char *filename, const char *builddir, symbol_c *tree_root) {
+  list_c *elements = dynamic_cast<list_c *>(tree_root);
+  if (NULL == elements) ERROR;
+  library_c *source = new library_c;
+  for (int i = stage1_2_library_elements(); i < elements->n; i++)
+    source->add_element(elements->get_element(i));
+
+  std::string radix(filename);
+  size_t slash = radix.find_last_of("/\\");
+  if (std::string::npos != slash) radix.erase(0, slash + 1);
+  size_t dot = radix.rfind('.');
+  std::string extension = (std::string::npos == dot)? "st" : radix.substr(dot + 1);
+  if (std::string::npos != dot) radix.erase(dot);
+  return stage4(source, builddir, radix.c_str(), extension.c_str());
+}
+
+
+/* Compile a single input file. Returns 0 on success, or < 0 on error. */
+static int compile(const char *filename, const char *builddir) {
   symbol_c *tree_root, *ordered_tree_root;
+  time_report_c time_report(filename);
+
+  /* 1st Pass */
+  { time_report_c time_report("stage 1-2");
+    if (stage1_2(filename, &tree_root) < 0)
+      return -1;
+  }
+  time_report_c::print_ast_nodes(tree_root);
+
+  /* Only normalising the input file? */
+  if (runtime_options.normalise_only) {
+    time_report_c time_report("stage 4");
+    return normalise(filename, builddir, tree_root);
+  }
+
+  /* 2nd Pass */
+  { time_report_c time_report("absyntax_utils_init");
+      /* basically loads some symbol tables to speed up look ups later on */
+    absyntax_utils_init(tree_root);  
+      /* moved to bison, although it could perfectly well still be here instead of in bison code. */
+    //add_en_eno_param_decl_c::add_to(tree_root);
+  }
+
+  /* Do semantic verification of code */
+  { time_report_c time_report("stage 3");
+    if (stage3(tree_root, &ordered_tree_root, stage1_2_library_elements()) < 0)
+      return -1;
+  }
+  
+  /* Save the annotated AST, for other tools */
+  if (runtime_options.write_ast_image) {
+    std::string filename = (NULL == builddir)? AST_IMAGE_FILENAME : std::string(builddir) + "/" AST_IMAGE_FILENAME;
+    ast_image_annotations_t annotations;
+    annotations.is_dead_store    = dead_store_analysis_c::is_dead_store;
+    annotations.is_idempotent_fb = idempotent_fb_analysis_c::is_idempotent_fb;
+    if (save_ast_image(ordered_tree_root, annotations, filename.c_str()) < 0)
+      return -1;
+  }
+  if (runtime_options.write_xref_index) {
+    std::string filename = (NULL == builddir)? XREF_INDEX_FILENAME : std::string(builddir) + "/" XREF_INDEX_FILENAME;
+    if (save_xref_index(ordered_tree_root, filename.c_str()) < 0)
+      return -1;
+  }
+
+  /* Only looking for errors? */
+  if (runtime_options.check_only)
+    return 0;
+
+  /* 3rd Pass */
+  { time_report_c time_report("stage 4");
+    if (stage4(ordered_tree_root, builddir) < 0)
+      return -1;
+  }
+  if (generate_other_targets(ordered_tree_root) < 0)
+    return -1;
+
+  /* 4th Pass */
+  /* Call gcc, g++, or whatever... */
+  /* Currently implemented in the Makefile! */
+
+  return 0;
+}
+
+
+
+/* Release the ASTs built since the mark was taken (i.e. by the previous compile()), so that
+ * the memory is reused when compiling the next file in the same run (-B and -S command line options).
+ * NOTE: the standard library kept in memory (see stage1_2_cache_library()), and the POUs kept for
+ *       incremental parsing (see stage1_2_incremental_parse()), are kept serialized, outside of the
+ *       arena. Each compile() builds its own AST from them, which is released with the rest.
+ */
+static void release_ast(const symbol_c::arena_mark_t &mark) {
+  absyntax_utils_reset();
+  symbol_c::release_arena(mark);
+}
+
+
+
+/* Split a line of a batch file (or a server request) into the name of the input file and
+ * the (optional) target directory.
+ *
+ * Each line contains the name of an input file, optionally followed by the directory where
+ * the code generated for that file is to be placed (by default, the directory given with -T).
+ * Empty lines, and lines starting with '#', are ignored. Names may not contain spaces.
+ *
+ * Returns 1 if the line names an input file, 0 if the line is to be ignored, or < 0 on error.
+ */
+static int parse_batch_line(char *line, const char **filename, const char **targetdir) {
+  *filename  = strtok(line, " \t\r\n");
+  *targetdir = strtok(NULL, " \t\r\n");
+  if ((NULL == *filename) || ('#' == (*filename)[0])) return 0;
+  if (NULL != strtok(NULL, " \t\r\n"))               return -1;
+  return 1;
+}
+
+
+/* Set the output options of stage 4 to the given lists (each as given with -O). Returns < 0 on error. */
+static int set_output_options(const std::vector<std::string> &options) {
+  stage4_reset_options();
+  for (unsigned int i = 0; i < options.size(); i++) {
+    /* NOTE: stage4_parse_options() changes the string it parses */
+    std::vector<char> copy(options[i].begin(), options[i].end());
+    copy.push_back('\0');
+    if (stage4_parse_options(&copy[0]) < 0) return -1;
+  }
+  return 0;
+}
+
+
+/* Generate the code of one of the -G targets */
+static int generate_target(symbol_c *tree_root, const target_t &target) {
+  if (set_output_options(std::vector<std::string>(1, target.options)) < 0)
+    return -1;
+  time_report_c time_report("stage 4");
+  return stage4(tree_root, target.builddir);
+}
+
+
+/* Generate the code of the -G targets, from the AST already annotated by stage 3 (i.e. without parsing and
+ * checking the input file again for each target).
+ */
+static int generate_other_targets(symbol_c *tree_root) {
+  int res = 0;
+  for (unsigned int i = 0; (res >= 0) && (i < other_targets.size()); i++)
+    res = generate_target(tree_root, other_targets[i]);
+  return res;
+}
+
+
+/* Compile all the input files listed in the batch file (-B command line option).
+ * See parse_batch_line() for the format of the batch file.
+ *
+ * The standard library is only parsed once, and kept in memory for all the remaining files.
+ * The AST of each file is released once the file has been compiled.
+ * Compilation stops at the first file with errors.
+ */
+static int compile_batch(const char *batchfilename, const char *builddir) {
+  char line[4096];
+  int  line_no = 0;
+  int  res     = 0;
+  const char *filename, *targetdir;
+
+  FILE *batchfile = fopen(batchfilename, "r");
+  if (NULL == batchfile) {
+    perror(batchfilename);
+    return -1;
+  }
+
+  stage1_2_cache_library(true);
+  symbol_c::arena_mark_t mark = symbol_c::arena_mark();
+  while ((res >= 0) && (NULL != fgets(line, sizeof(line), batchfile))) {
+    line_no++;
+    if (NULL == strchr(line, '\n') && !feof(batchfile)) {
+      fprintf(stderr, "%s:%d: line too long\n", batchfilename, line_no);
+      res = -1;
+      break;
+    }
+    int line_res = parse_batch_line(line, &filename, &targetdir);
+    if (line_res == 0) continue;
+    if (line_res < 0) {
+      fprintf(stderr, "%s:%d: expected <input_file> [<target_directory>]\n", batchfilename, line_no);
+      res = -1;
+      break;
+    }
+    if (NULL == targetdir) targetdir = builddir;
+
+    res = compile(filename, targetdir);
+    release_ast(mark);
+  }
+  fclose(batchfile);
+  return res;
+}
+
+
+/* Run as a compile server (-S command line option), for IDEs that compile the same project over and over.
+ *
+ * Requests are read from stdin, one per line, in the same format as the lines of a batch file
+ * (see parse_batch_line()). The reply to each request is written to stdout: the names of the
+ * generated files (as usual, one per line), followed by a line containing either "OK" or "FAILED".
+ * Error messages are written to stderr, which is flushed before the reply is terminated.
+ * The server exits when stdin is closed.
+ *
+ * The standard library is only parsed once, and kept in memory for all the following requests.
+ * The AST built for each request is released once the reply has been written.
+ * Only the POUs of the input file that changed since the previous request for the same file are parsed again.
+ * Errors in the compiled code do not stop the server, but internal compiler errors do.
+ */
+static int compile_server(const char *builddir) {
+  char line[4096];
+  const char *filename, *targetdir;
+
+  stage1_2_cache_library(true);
+  stage1_2_incremental_parse(true);
+  symbol_c::arena_mark_t mark = symbol_c::arena_mark();
+  while (NULL != fgets(line, sizeof(line), stdin)) {
+    int res;
+    if (NULL == strchr(line, '\n') && !feof(stdin)) {
+      /* discard the remainder of the line */
+      int c;
+      do {c = getchar();} while ((c != EOF) && (c != '\n'));
+      fprintf(stderr, "request too long\n");
+      res = -1;
+    } else {
+      res = parse_batch_line(line, &filename, &targetdir);
+      if (res == 0) continue;
+      if (res < 0) fprintf(stderr, "expected <input_file> [<target_directory>]\n");
+    }
+    if (res > 0) {
+      if (NULL == targetdir) targetdir = builddir;
+      res = compile(filename, targetdir);
+      release_ast(mark);
+      std::cout.flush(); /* stage4 prints the names of the generated files to std::cout */
+    }
+    fflush(stderr);
+    fprintf(stdout, (res < 0)? "FAILED\n" : "OK\n");
+    fflush(stdout);
+  }
+  return 0;
+}
+
+
+
+int main(int argc, char **argv) {
   char * builddir = NULL;
+  char * batchfile = NULL;
+  bool   server    = false;
   int optres, errflg = 0;
   int path_len;
 
@@ -150,6 +438,7 @@ int main(int argc, char **argv) {
   runtime_options.allow_missing_var_in    = false; /* disable: allow definition and invocation of POUs with no input, output and in_out parameters! */
   runtime_options.disable_implicit_en_eno = false; /* disable: do not generate EN and ENO parameters */
   runtime_options.pre_parsing             = false; /* disable: allow use of forward references (run pre-parsing phase before the definitive parsing phase that builds the AST) */
+  runtime_options.lazy_parsing            = false; /* disable: skip the POUs of the included files not used by the input file */
   runtime_options.safe_extensions         = false; /* disable: allow use of SAFExxx datatypes */
   runtime_options.full_token_loc          = false; /* disable: error messages specify full token location */
   runtime_options.conversion_functions    = false; /* disable: create a conversion function for derived datatype */
@@ -158,14 +447,24 @@ int main(int argc, char **argv) {
   runtime_options.ref_nonstand_extensions = false; /* disable: Allow the use of non-standard extensions to REF_TO datatypes: REF_TO ANY, and REF_TO in struct elements! */
   runtime_options.nonliteral_in_array_size= false; /* disable: Allow the use of constant non-literals when specifying size of arrays (ARRAY [1..max] OF INT) */
   runtime_options.includedir              = NULL;  /* Include directory, where included files will be searched for... */
+  runtime_options.write_library_snapshot  = false; /* disable: save a snapshot of the parsed standard library */
+  runtime_options.mmap_input              = false; /* disable: map the input files into memory */
+  runtime_options.time_report             = false; /* disable: print the time and memory used by each phase of the compiler */
+  runtime_options.archive_fd              = -1;    /* disable: write the generated files to the target directory */
+  runtime_options.write_ast_image         = false; /* disable: write the annotated AST to AST.img */
+  runtime_options.write_xref_index        = false; /* disable: write the cross-reference index to XREF.idx */
 
   /* Default values for the command line options... */
   runtime_options.relaxed_datatype_model    = false; /* by default use the strict datatype equivalence model */
+  runtime_options.remove_unused_pous        = false; /* by default generate code for all the POUs and datatypes */
+  runtime_options.check_only                = false; /* by default generate code */
+  runtime_options.trusted_input             = false; /* by default run all the semantic checks */
+  runtime_options.normalise_only            = false; /* by default run stage3 before stage4 */
   
   /******************************************/
   /*   Parse command line options...        */
   /******************************************/
-  while ((optres = getopt(argc, argv, ":nehvfplsrRabicI:T:O:")) != -1) {
+  while ((optres = getopt(argc, argv, ":nehvfpLlsrRabicWmStUwxkKNI:T:O:B:A:G:")) != -1) {
     switch(optres) {
     case 'h':
       printusage(argv[0]);
@@ -175,6 +474,7 @@ int main(int argc, char **argv) {
       return 0;
     case 'l': runtime_options.relaxed_datatype_model   = true;  break;
     case 'p': runtime_options.pre_parsing              = true;  break;
+    case 'L': runtime_options.lazy_parsing             = true;  break;
     case 'f': runtime_options.full_token_loc           = true;  break;
     case 's': runtime_options.safe_extensions          = true;  break;
     case 'R': runtime_options.ref_standard_extensions  = true; /* use of REF_TO ANY implies activating support for REF extensions! */
@@ -186,6 +486,15 @@ int main(int argc, char **argv) {
     case 'c': runtime_options.conversion_functions     = true;  break;
     case 'n': runtime_options.nested_comments          = true;  break;
     case 'e': runtime_options.disable_implicit_en_eno  = true;  break;
+    case 'W': runtime_options.write_library_snapshot   = true;  break;
+    case 'm': runtime_options.mmap_input               = true;  break;
+    case 't': runtime_options.time_report              = true;  break;
+    case 'w': runtime_options.write_ast_image          = true;  break;
+    case 'x': runtime_options.write_xref_index         = true;  break;
+    case 'U': runtime_options.remove_unused_pous       = true;  break;
+    case 'k': runtime_options.check_only               = true;  break;
+    case 'K': runtime_options.trusted_input            = true;  break;
+    case 'N': runtime_options.normalise_only           = true;  break;
     case 'I':
       /* NOTE: To improve the usability under windows:
        *       We delete last char's path if it ends with "\".
@@ -202,10 +511,39 @@ int main(int argc, char **argv) {
       if (optarg[path_len] == '\\') optarg[path_len]= '\0';
       builddir = optarg;
       break;
+    case 'B':
+      batchfile = optarg;
+      break;
+    case 'S':
+      server    = true;
+      break;
+    case 'A':
+      runtime_options.archive_fd = (strcmp(optarg, "-") == 0)? 1 : atoi(optarg);
+      if ((runtime_options.archive_fd < 0) || ((0 == runtime_options.archive_fd) && (strcmp(optarg, "0") != 0))) {
+        fprintf(stderr, "Invalid file descriptor: %s\n", optarg);
+        errflg++;
+      }
+      break;
     case 'O':
+      output_options.push_back(optarg);
       if (stage4_parse_options(optarg) < 0) errflg++;
       break;
-    case ':':       /* -I, -T, or -O without operand */
+    case 'G': {
+      /* <target_directory>[:<output_options>] (the ':' of a windows drive letter, as in C:\dir, is part of the directory) */
+      bool  drive = isalpha((unsigned char)optarg[0]) && (':' == optarg[1]) && (('\\' == optarg[2]) || ('/' == optarg[2]));
+      char *colon = strchr(optarg + (drive? 2 : 0), ':');
+      target_t target;
+      target.options  = (NULL == colon)? "" : colon + 1;
+      if (NULL != colon) *colon = '\0';
+      target.builddir = optarg;
+      if (('\0' == target.builddir[0]) || (set_output_options(std::vector<std::string>(1, target.options)) < 0)) {
+        fprintf(stderr, "Invalid target: -G %s\n", optarg);
+        errflg++;
+      }
+      other_targets.push_back(target);
+      break;
+    }
+    case ':':       /* -I, -T, -O, -B, -A, or -G without operand */
       fprintf(stderr, "Option -%c requires an operand\n", optopt);
       errflg++;
       break;
@@ -220,11 +558,60 @@ int main(int argc, char **argv) {
     }
   }
 
-  if (optind == argc) {
+  if ((optind == argc) && !runtime_options.write_library_snapshot && (NULL == batchfile) && !server) {
     fprintf(stderr, "Missing input file\n");
     errflg++;
   }
 
+  if ((optind < argc) && runtime_options.write_library_snapshot) {
+    fprintf(stderr, "No input file may be given with option -W\n");
+    errflg++;
+  }
+
+  if ((optind < argc) && (NULL != batchfile)) {
+    fprintf(stderr, "No input file may be given with option -B\n");
+    errflg++;
+  }
+
+  if ((optind < argc) && server) {
+    fprintf(stderr, "No input file may be given with option -S\n");
+    errflg++;
+  }
+
+  if ((runtime_options.write_library_snapshot + (NULL != batchfile) + server) > 1) {
+    fprintf(stderr, "Options -W, -B and -S may not be used together\n");
+    errflg++;
+  }
+
+  /* the compile server prints its replies to stdout */
+  if ((1 == runtime_options.archive_fd) && server) {
+    fprintf(stderr, "Option -A may not stream to stdout with -S\n");
+    errflg++;
+  }
+
+  /* the -G targets get the same code for every file of a batch (or request), and the archive would contain
+   * the files of all the targets with the same names
+   */
+  if (!other_targets.empty() && ((NULL != batchfile) || server || (runtime_options.archive_fd >= 0))) {
+    fprintf(stderr, "Option -G may not be used with -B, -S nor -A\n");
+    errflg++;
+  }
+
+  /* the AST is handed to stage4 as parsed, without the annotations of stage3 */
+  if (runtime_options.normalise_only && stage4_requires_stage3()) {
+    fprintf(stderr, "Option -N is only available when generating IEC 61131-3 code (iec2iec)\n");
+    errflg++;
+  }
+
+  if (runtime_options.normalise_only && (runtime_options.check_only || runtime_options.write_ast_image || runtime_options.write_xref_index || !other_targets.empty())) {
+    fprintf(stderr, "Option -N may not be used with -k, -w, -x nor -G\n");
+    errflg++;
+  }
+
+  /* the -G options replaced those of -O while they were checked */
+  if (!other_targets.empty() && (set_output_options(output_options) < 0))
+    errflg++;
+
   if (optind > argc) {
     fprintf(stderr, "Too many input files\n");
     errflg++;
@@ -239,27 +626,29 @@ int main(int argc, char **argv) {
   /***************************/
   /*   Run the compiler...   */
   /***************************/
-  /* 1st Pass */
-  if (stage1_2(argv[optind], &tree_root) < 0)
-    return EXIT_FAILURE;
+  /* Only save the standard library snapshot? */
+  if (runtime_options.write_library_snapshot) {
+    if (stage1_2(NULL, NULL) < 0)
+      return EXIT_FAILURE;
+    return 0;
+  }
 
-  /* 2nd Pass */
-    /* basically loads some symbol tables to speed up look ups later on */
-  absyntax_utils_init(tree_root);  
-    /* moved to bison, although it could perfectly well still be here instead of in bison code. */
-  //add_en_eno_param_decl_c::add_to(tree_root);
+  /* Run as a compile server? */
+  if (server) {
+    if (compile_server(builddir) < 0)
+      return EXIT_FAILURE;
+    return 0;
+  }
 
-  /* Do semantic verification of code */
-  if (stage3(tree_root, &ordered_tree_root) < 0)
-    return EXIT_FAILURE;
-  
-  /* 3rd Pass */
-  if (stage4(ordered_tree_root, builddir) < 0)
-    return EXIT_FAILURE;
+  /* Compile all the files listed in the batch file? */
+  if (NULL != batchfile) {
+    if (compile_batch(batchfile, builddir) < 0)
+      return EXIT_FAILURE;
+    return 0;
+  }
 
-  /* 4th Pass */
-  /* Call gcc, g++, or whatever... */
-  /* Currently implemented in the Makefile! */
+  if (compile(argv[optind], builddir) < 0)
+    return EXIT_FAILURE;
 
   return 0;
 }
@@ -44,6 +44,7 @@ typedef struct {
 	bool allow_missing_var_in;     /* Allow definition and invocation of POUs with no input, output and in_out parameters! */
 	bool disable_implicit_en_eno;  /* Disable the generation of implicit EN and ENO parameters on functions and Function Blocks */
 	bool pre_parsing;              /* Support forward references (Run a pre-parsing phase before the defintive parsing phase that builds the AST) */
+	bool lazy_parsing;             /* Skip the FUNCTIONs and FUNCTION_BLOCKs of the included files that the input file does not use */
 	bool safe_extensions;          /* support SAFE_* datatypes defined in PLCOpen TC5 "Safety Software Technical Specification - Part 1" v1.0 */
 	bool full_token_loc;           /* error messages specify full token location */
 	bool conversion_functions;     /* Create a conversion function for derived datatype */
@@ -52,9 +53,19 @@ typedef struct {
 	bool ref_nonstand_extensions;  /* Allow the use of non-standard extensions to REF_TO datatypes: REF_TO ANY, and REF_TO in struct elements! */
 	bool nonliteral_in_array_size; /* Allow the use of constant non-literals when specifying size of arrays (ARRAY [1..max] OF INT) */
 	const char *includedir;        /* Include directory, where included files will be searched for... */
+	bool write_library_snapshot;   /* Parse the standard library and save a snapshot of the result, to be loaded (instead of re-parsing the library) by later runs */
+	bool mmap_input;               /* Map the input files into memory, and scan them in place (instead of reading them through stdio) */
+	bool time_report;              /* Print the time and memory used by each phase of the compiler, and the number of AST nodes */
+	int  archive_fd;               /* Stream the generated files to this file descriptor (see stage4out_c::archiving()), instead of writing them (-1) */
+	bool write_ast_image;          /* Write the AST annotated by stage 3 to AST.img in the target directory (see ast_image.hh) */
+	bool write_xref_index;         /* Write the cross-reference index of the source code to XREF.idx in the target directory (see xref_index.hh) */
 	
    /* options specific to stage3 */
 	bool relaxed_datatype_model;   /* Use the relaxed datatype equivalence model, instead of the default strict equivalence model */
+	bool remove_unused_pous;       /* Do not generate code for the POUs and datatypes not used by any configuration */
+	bool check_only;               /* Only check the input file for errors, do not generate any code (stage4 is not run) */
+	bool trusted_input;            /* The input has already been checked by iec2c: skip the stage 3 passes that only look for errors */
+	bool normalise_only;           /* Run stage4 straight after stage1_2 (stage3 is not run), on the code of the input file only, into a file of the same name */
 } runtime_options_t;
 
 extern runtime_options_t runtime_options;
@@ -32,123 +32,251 @@
  */
 
 #include <sstream>
+#include "../absyntax/absyntax.hh"
+#include "../absyntax/intern_pool.hh"
+#include "../main.hh"
+#include "stage1_2.hh"
+#include "iec_bison.hh"
+#include "stage1_2_priv.hh"
 #include "create_enumtype_conversion_functions.hh"
+#include "../absyntax_utils/add_en_eno_param_decl.hh"	/* required for  add_en_eno_param_decl_c */
 
 /* set to 1 to see debug info during execution */
 static const int debug = 0;
 
 
 /* 
- * The create_enumtype_conversion_functions_c class generates ST source code!
- * This code is in actual fact datatype conversion functions between user defined
- * enumerated datatypes, and some basic datatypes.
+ * The create_enumtype_conversion_functions_c class generates the datatype conversion functions
+ * between user defined enumerated datatypes, and some basic datatypes.
  *
  * These conversion functions cannot be implemented the normal way (i.e. in the standard library)
  * since they convert from/to a datatype that is defined by the user. So, we generate these conversions
  * functions on the fly! 
- * (to get an idea of what the generated code looks like, see the comments in create_enumtype_conversion_functions.cc)
+ * (to get an idea of what the generated functions look like, see the comments in create_enumtype_conversion_functions.cc)
  *
  * Currently, we support conversion between the user defined enumerated datatype and STRING,
  * SINT, INT, DINT, LINT, USINT, UINT, UDINT, ULINT (basically the ANY_INT)
  *
- * ST source code is generated when the method get_declaration() is called. since the
- * create_enumtype_conversion_functions_c inherits from the iterator visitor, this method may be 
- * passed either the root of an abstract syntax tree, or sub-tree of the AST.
- *
- * This class will iterate through that AST, and for each enumerated type declaration, will 
- * create the apropriate conversion functions.
+ * The functions are built directly as AST nodes (the same the parser would have built from their ST
+ * source code), and only for the conversions that are actually called somewhere:
+ *  - declare() is called by the parser for each data type declaration (TYPE ... END_TYPE). It declares
+ *    the names of the conversion functions of every enumerated datatype in the library_element_symtable
+ *    (so the calls to these functions get parsed as function calls), and keeps the declaration for later;
+ *  - add_to() is called once the source code has been parsed. It finds the names of all the functions
+ *    called in the AST, and inserts the conversion functions called by their name right after the
+ *    data type declaration of their enumerated datatype.
  */
 
-create_enumtype_conversion_functions_c *create_enumtype_conversion_functions_c::singleton = NULL;
+static std::vector<symbol_c *> pending_declarations;   /* the data_type_declaration_c passed to declare() */
+
+/* the basic datatypes we convert from/to, and the AST node of their name */
+static const char *conversion_types[] = {"STRING", "SINT", "INT", "DINT", "LINT", "USINT", "UINT", "UDINT", "ULINT", NULL};
+
+static symbol_c *new_type_name(int type) {
+  switch (type) {
+    case 0: return new string_type_name_c();
+    case 1: return new  sint_type_name_c();
+    case 2: return new   int_type_name_c();
+    case 3: return new  dint_type_name_c();
+    case 4: return new  lint_type_name_c();
+    case 5: return new usint_type_name_c();
+    case 6: return new  uint_type_name_c();
+    case 7: return new udint_type_name_c();
+    case 8: return new ulint_type_name_c();
+  }
+  ERROR;
+  return NULL;
+}
 
-create_enumtype_conversion_functions_c:: create_enumtype_conversion_functions_c(symbol_c *ignore) {}
-create_enumtype_conversion_functions_c::~create_enumtype_conversion_functions_c(void)             {}
 
+/* The enumerated datatype declarations (with a list of values) of a data type declaration */
+static std::vector<enumerated_type_declaration_c *> get_enumerated_types(symbol_c *data_type_declaration) {
+  std::vector<enumerated_type_declaration_c *> enumerated_types;
+  data_type_declaration_c *declaration = dynamic_cast<data_type_declaration_c *>(data_type_declaration);
+  if (NULL == declaration) return enumerated_types;
+  list_c *list = dynamic_cast<list_c *>(declaration->type_declaration_list);
+  if (NULL == list) return enumerated_types;
+  for (int i = 0; i < list->n; i++) {
+    enumerated_type_declaration_c *enumerated_type = dynamic_cast<enumerated_type_declaration_c *>(list->get_element(i));
+    if (NULL == enumerated_type) continue;
+    enumerated_spec_init_c *spec_init = dynamic_cast<enumerated_spec_init_c *>(enumerated_type->enumerated_spec_init);
+    /* an enumerated datatype declared as another enumerated datatype (TYPE enum2 : enum1; END_TYPE) gets no conversion functions */
+    if ((NULL == spec_init) || (NULL == dynamic_cast<enumerated_value_list_c *>(spec_init->enumerated_specification))) continue;
+    enumerated_types.push_back(enumerated_type);
+  }
+  return enumerated_types;
+}
 
-std::string &create_enumtype_conversion_functions_c::get_declaration(symbol_c *symbol) {
-    if (NULL == singleton)  singleton = new create_enumtype_conversion_functions_c(NULL);
-    if (NULL == singleton)  ERROR_MSG("Out of memory. Bailing out!\n");
-    
-    singleton->text = "";
-    if (NULL != symbol) 
-      symbol->accept(*singleton);
 
-    return singleton->text;
-}
+/* Copies the location of a symbol to all the nodes of a subtree (the functions we build have no source code!) */
+class set_location_c: public fcall_iterator_visitor_c {
+  private:
+    symbol_c *location;
+  public:
+    set_location_c(symbol_c *location_) {location = location_;}
+    void prefix_fcall(symbol_c *symbol) {
+      symbol->first_line   = location->first_line;
+      symbol->first_column = location->first_column;
+      symbol->first_file   = location->first_file;
+      symbol->first_order  = location->first_order;
+      symbol->last_line    = location->last_line;
+      symbol->last_column  = location->last_column;
+      symbol->last_file    = location->last_file;
+      symbol->last_order   = location->last_order;
+    }
+};
 
-/* As the name of derived datatypes and POUs are still stored as identifiers in the respective datatype and POU declaration,  */
-/* only the indintifier_c visitor should be necessary!                                                                        */
-void *create_enumtype_conversion_functions_c::visit(                 identifier_c *symbol) {currentToken = symbol->value; return NULL;}
-void *create_enumtype_conversion_functions_c::visit(         poutype_identifier_c *symbol) {ERROR; return NULL;}
-void *create_enumtype_conversion_functions_c::visit(derived_datatype_identifier_c *symbol) {ERROR; return NULL;}
 
 
-/**********************/
-/* B 1.3 - Data types */
-/**********************/
-/********************************/
-/* B 1.3.3 - Derived data types */
-/********************************/
-void *create_enumtype_conversion_functions_c::visit(enumerated_type_declaration_c *symbol) {
-    std::string enumerateName;
-    std::string functionName;
-    std::list <std::string> enumerateValues;
+create_enumtype_conversion_functions_c:: create_enumtype_conversion_functions_c(symbol_c *ignore) {add_en_eno = true;}
+create_enumtype_conversion_functions_c::~create_enumtype_conversion_functions_c(void)             {}
 
-    symbol->enumerated_type_name->accept(*this);
-    enumerateName = currentToken;
 
-    symbol->enumerated_spec_init->accept(*this);
-    enumerateValues = currentTokenList;
+void create_enumtype_conversion_functions_c::declare(parse_context_t *context, symbol_c *data_type_declaration) {
+  std::vector<enumerated_type_declaration_c *> enumerated_types = get_enumerated_types(data_type_declaration);
+  if (enumerated_types.size() == 0) return;
+
+  for (unsigned int i = 0; i < enumerated_types.size(); i++) {
+    token_c *enum_name = dynamic_cast<token_c *>(enumerated_types[i]->enumerated_type_name);
+    if (NULL == enum_name) ERROR;
+    /* NOTE: the pre-scanner (see prescan.cc) may already have declared these names */
+    for (int t = 0; conversion_types[t] != NULL; t++) {
+      std::string names[2] = {std::string(conversion_types[t]) + "_TO_" + enum_name->value,
+                              std::string(enum_name->value) + "_TO_" + conversion_types[t]};
+      for (int n = 0; n < 2; n++)
+        if (context->library_element_symtable.find(names[n].c_str()) == context->library_element_symtable.end())
+          context->library_element_symtable.insert(intern_string(names[n].c_str()), prev_declared_derived_function_name_token);
+    }
+  }
+  pending_declarations.push_back(data_type_declaration);
+}
+
 
-    printStringToEnum  (enumerateName, enumerateValues);
-    printEnumToString  (enumerateName, enumerateValues);
-    for (size_t s = 8; s <= 64; s*= 2) {
-        printIntegerToEnum (enumerateName, enumerateValues, true , s);
-        printEnumToInteger (enumerateName, enumerateValues, true , s);
-        printIntegerToEnum (enumerateName, enumerateValues, false, s);
-        printEnumToInteger (enumerateName, enumerateValues, false, s);
+void create_enumtype_conversion_functions_c::add_to(parse_context_t *context, symbol_c *tree, int first) {
+  list_c *library = dynamic_cast<list_c *>(tree);
+  if ((NULL == library) || (pending_declarations.size() == 0)) {pending_declarations.clear(); return;}
+
+  /* the names of the functions called by the library elements... */
+  create_enumtype_conversion_functions_c called(NULL);
+  called.add_en_eno = !context->options.disable_implicit_en_eno;
+  for (int i = (first < 0)? 0 : first; i < library->n; i++)
+    library->get_element(i)->accept(called);
+
+  /* ...and the conversion functions among them */
+  std::map<symbol_c *, std::vector<symbol_c *> > functions;   /* the functions to add after each data type declaration */
+  for (unsigned int d = 0; d < pending_declarations.size(); d++) {
+    std::vector<enumerated_type_declaration_c *> enumerated_types = get_enumerated_types(pending_declarations[d]);
+    for (unsigned int i = 0; i < enumerated_types.size(); i++) {
+      std::vector<symbol_c *> &new_functions = functions[pending_declarations[d]];
+      size_t first_new = new_functions.size();
+      called.createFunctions(enumerated_types[i], new_functions);
+      set_location_c set_location(enumerated_types[i]);
+      for (size_t f = first_new; f < new_functions.size(); f++)
+        new_functions[f]->accept(set_location);
     }
-    if (debug) std::cout << text << std::endl;
-    
-    return NULL;
+  }
+  pending_declarations.clear();
+  if (functions.size() == 0) return;
+
+  /* insert the new functions right after the declaration of their datatype */
+  std::vector<symbol_c *> elements;
+  for (int i = 0; i < library->n; i++) elements.push_back(library->get_element(i));
+  library->clear();
+  for (unsigned int i = 0; i < elements.size(); i++) {
+    library->add_element(elements[i]);
+    std::map<symbol_c *, std::vector<symbol_c *> >::iterator new_functions = functions.find(elements[i]);
+    if (functions.end() == new_functions) continue;
+    for (unsigned int f = 0; f < new_functions->second.size(); f++)
+      library->add_element(new_functions->second[f]);
+  }
 }
 
-void *create_enumtype_conversion_functions_c::visit(enumerated_value_list_c *symbol) {
-    list_c *list;
 
-    currentTokenList.clear();
-    list = (list_c *)symbol;
+/* the name of every function called */
+void *create_enumtype_conversion_functions_c::visit(poutype_identifier_c *symbol) {called_functions.insert(symbol->value); return NULL;}
+
+
+/* Builds the conversion functions of an enumerated datatype that are called somewhere */
+void create_enumtype_conversion_functions_c::createFunctions(enumerated_type_declaration_c *symbol, std::vector<symbol_c *> &functions) {
+    std::string enumerateName;
+    std::list <std::string> enumerateValues;
+
+    enumerateName = ((token_c *)symbol->enumerated_type_name)->value;
+    list_c *list = (list_c *)((enumerated_spec_init_c *)symbol->enumerated_spec_init)->enumerated_specification;
     for (int i = 0; i < list->n; i++) {
-        list->get_element(i)->accept(*this);
-        currentTokenList.push_back(currentToken);
+        enumerated_value_c *value = dynamic_cast<enumerated_value_c *>(list->get_element(i));
+        if ((NULL == value) || (NULL == dynamic_cast<token_c *>(value->value))) ERROR;
+        enumerateValues.push_back(((token_c *)value->value)->value);
     }
 
-    return NULL;
+    for (int t = 0; conversion_types[t] != NULL; t++) {
+        std::string typeName = conversion_types[t];
+        if (called_functions.count(typeName + "_TO_" + enumerateName) > 0) {
+            if (0 == t) functions.push_back(createStringToEnum (enumerateName, enumerateValues));
+            else        functions.push_back(createIntegerToEnum(enumerateName, enumerateValues, t));
+        }
+        if (called_functions.count(enumerateName + "_TO_" + typeName) > 0) {
+            if (0 == t) functions.push_back(createEnumToString (enumerateName, enumerateValues));
+            else        functions.push_back(createEnumToInteger(enumerateName, enumerateValues, t));
+        }
+    }
+    if (debug) std::cout << enumerateName << ": " << functions.size() << " conversion function(s) in this TYPE declaration" << std::endl;
 }
 
+
 /*
- * getIntegerName function generate a integer data name from signed and size.
+ * Helper functions to build the AST nodes, just like the parser would have built them from the ST code
  */
-std::string create_enumtype_conversion_functions_c::getIntegerName(bool isSigned, size_t size) {
-    std::string integerType = "";
-    if (! isSigned) {
-        integerType = "U";
-    }
-    switch(size) {
-    case 8 : integerType += "S"; break;
-    case 16:                     break;
-    case 32: integerType += "D"; break;
-    case 64: integerType += "L"; break;
-    default:                     break;
-    }
-    integerType +="INT";
+static symbol_c *newVariable(const char *name) {
+    identifier_c *identifier = new identifier_c(name);
+    symbol_c *variable = new symbolic_variable_c(identifier);
+    variable->token = identifier;
+    return variable;
+}
+
+static symbol_c *newEnumValue(const std::string &enumerateName, const std::string &value) {
+    return new enumerated_value_c(new derived_datatype_identifier_c(intern_string(enumerateName.c_str())), new identifier_c(intern_string(value.c_str())));
+}
+
+static symbol_c *newInteger(int count) {
+    std::stringstream out;
+    out << count;
+    return new integer_c(intern_string(out.str().c_str()));
+}
+
+static symbol_c *newString(const std::string &value) {
+    return new single_byte_character_string_c(intern_string(("'" + value + "'").c_str()));
+}
+
+/* IF IN = <in_value> THEN <fname> := <out_value>; RETURN; END_IF; */
+static symbol_c *newIfReturn(const std::string &functionName, symbol_c *in_value, symbol_c *out_value) {
+    statement_list_c *statements = new statement_list_c();
+    statements->add_element(new assignment_statement_c(newVariable(intern_string(functionName.c_str())), out_value));
+    statements->add_element(new return_statement_c());
+    return new if_statement_c(new equ_expression_c(newVariable("IN"), in_value), statements, new elseif_statement_list_c(), NULL);
+}
 
-    return integerType;
+/* FUNCTION <fname> : <return_type> VAR_INPUT IN : <in_spec>; END_VAR <body> ENO := FALSE; END_FUNCTION */
+/* (without the ENO assignment, nor the EN and ENO declarations, unless add_en_eno) */
+static symbol_c *newFunction(const std::string &functionName, symbol_c *return_type, symbol_c *in_spec, statement_list_c *body, bool add_en_eno) {
+    var1_list_c *var1_list = new var1_list_c();
+    var1_list->add_element(new identifier_c("IN"));
+    input_declaration_list_c *input_list = new input_declaration_list_c();
+    input_list->add_element(new var1_init_decl_c(var1_list, in_spec));
+    var_declarations_list_c *declarations = new var_declarations_list_c();
+    declarations->add_element(new input_declarations_c(NULL, input_list, new explicit_definition_c()));
+
+    if (add_en_eno)
+        body->add_element(new assignment_statement_c(newVariable("ENO"), new boolean_literal_c(new bool_type_name_c(), new boolean_false_c())));
+    symbol_c *function = new function_declaration_c(new identifier_c(intern_string(functionName.c_str())), return_type, declarations, body);
+    if (add_en_eno) add_en_eno_param_decl_c::add_to(function); /* add EN and ENO declarations */
+    return function;
 }
 
+
 /*
- * printStringToEnum function print conversion function from STRING to <ENUM>:
- * ST Output:
+ * createStringToEnum function builds the conversion function from STRING to <ENUM>:
+ * ST equivalent:
  *
 
  FUNCTION STRING_TO_<ENUM> : <ENUM>
@@ -169,27 +297,21 @@ std::string create_enumtype_conversion_functions_c::getIntegerName(bool isSigned
 
   Note: if you change code below remember to update this comment.
  */
-void create_enumtype_conversion_functions_c::printStringToEnum  (std::string &enumerateName, std::list<std::string> &enumerateValues) {
+symbol_c *create_enumtype_conversion_functions_c::createStringToEnum  (std::string &enumerateName, std::list<std::string> &enumerateValues) {
     std::list <std::string>::const_iterator itr;
     std::string functionName;
+    statement_list_c *body = new statement_list_c();
 
     functionName = "STRING_TO_" + enumerateName;
-    text += "FUNCTION " + functionName + " : " + enumerateName;
-    text += "\nVAR_INPUT\nIN : STRING;\nEND_VAR\n";
-    for (itr = enumerateValues.begin(); itr != enumerateValues.end(); ++itr) {
-       std::string value = *itr;
-       text += "IF IN = '" + value + "' THEN\n";
-       text += " " + functionName + " := " + enumerateName + "#" + value + ";\n";
-       text += " RETURN;\n"; 
-       text += "END_IF;\n";
-    }
-    text += "ENO := FALSE;\n";
-    text += "END_FUNCTION\n\n";
+    for (itr = enumerateValues.begin(); itr != enumerateValues.end(); ++itr)
+       body->add_element(newIfReturn(functionName, newString(*itr), newEnumValue(enumerateName, *itr)));
+    return newFunction(functionName, new derived_datatype_identifier_c(intern_string(enumerateName.c_str())), 
+                       new simple_spec_init_c(new_type_name(0), NULL), body, add_en_eno);
 }
 
 /*
- * printEnumToString function print conversion function from <ENUM> to STRING:
- * ST Output:
+ * createEnumToString function builds the conversion function from <ENUM> to STRING:
+ * ST equivalent:
  *
 
  FUNCTION <ENUM>_TO_STRING : STRING
@@ -210,39 +332,33 @@ void create_enumtype_conversion_functions_c::printStringToEnum  (std::string &en
 
   Note: if you change code below remember to update this comment.
  */
-void create_enumtype_conversion_functions_c::printEnumToString  (std::string &enumerateName, std::list<std::string> &enumerateValues) {
+symbol_c *create_enumtype_conversion_functions_c::createEnumToString  (std::string &enumerateName, std::list<std::string> &enumerateValues) {
     std::list <std::string>::const_iterator itr;
     std::string functionName;
+    statement_list_c *body = new statement_list_c();
 
     functionName = enumerateName + "_TO_STRING";
-    text += "FUNCTION " + functionName + " : STRING";
-    text += "\nVAR_INPUT\nIN : " + enumerateName + ";\nEND_VAR\n";
-    for (itr = enumerateValues.begin(); itr != enumerateValues.end(); ++itr) {
-        std::string value = *itr;
-        text += "IF IN = " + enumerateName + "#" + value + " THEN\n";
-        text += " " + functionName + " := '" + enumerateName + "#" + value + "';\n";
-        text += " RETURN;\n";
-        text += "END_IF;\n";
-    }
-    text += "ENO := FALSE;\n";
-    text += "END_FUNCTION\n\n";
+    for (itr = enumerateValues.begin(); itr != enumerateValues.end(); ++itr)
+        body->add_element(newIfReturn(functionName, newEnumValue(enumerateName, *itr), newString(enumerateName + "#" + *itr)));
+    return newFunction(functionName, new_type_name(0),
+                       new enumerated_spec_init_c(new derived_datatype_identifier_c(intern_string(enumerateName.c_str())), NULL), body, add_en_eno);
 }
 
 /*
- * printIntegerToEnum function print conversion function from <INTEGER> to <ENUM>:
- * ST Output:
+ * createIntegerToEnum function builds the conversion function from <INTEGER> to <ENUM>:
+ * ST equivalent:
  *
 
  FUNCTION <INTEGER>_TO_<ENUM> : <ENUM>
   VAR_INPUT
   IN: <INTEGER>;
   END_VAR
-  IF IN = 1 THEN
+  IF IN = 0 THEN
    <INTEGER>_TO_<ENUM> := <ENUM>#<ENUM.VALUE_1>;
    RETURN;
   END_IF;
   ...
-  IF IN = N THEN
+  IF IN = N-1 THEN
    <INTEGER>_TO_<ENUM> := <ENUM>#<ENUM.VALUE_N>;
    RETURN;
   END_IF;
@@ -251,47 +367,36 @@ void create_enumtype_conversion_functions_c::printEnumToString  (std::string &en
 
   Note: if you change code below remember to update this comment.
  */
-void create_enumtype_conversion_functions_c::printIntegerToEnum (std::string &enumerateName, std::list<std::string> &enumerateValues, bool isSigned, size_t size) {
+symbol_c *create_enumtype_conversion_functions_c::createIntegerToEnum (std::string &enumerateName, std::list<std::string> &enumerateValues, int integerType) {
     std::list <std::string>::const_iterator itr;
     std::string functionName;
-    std::string integerType;
+    statement_list_c *body = new statement_list_c();
     int count;
 
-    integerType  = getIntegerName(isSigned, size);
-    functionName = integerType + "_TO_" + enumerateName;
-    text += "FUNCTION " + functionName + " : " + enumerateName;
-    text += "\nVAR_INPUT\nIN : " + integerType + ";\nEND_VAR\n";
+    functionName = std::string(conversion_types[integerType]) + "_TO_" + enumerateName;
     count = 0;
-    for (itr = enumerateValues.begin(); itr != enumerateValues.end(); ++itr) {
-        std::string value = *itr;
-        std::stringstream out;
-        out << count;
-        text += "IF IN = " + out.str() + " THEN\n";
-        text += " " + functionName + " := " + enumerateName + "#" + value + ";\n";
-        text += " RETURN;\n";
-        text += "END_IF;\n";
-        count++;
-    }
-    text += "ENO := FALSE;\n";
-    text += "END_FUNCTION\n\n";
+    for (itr = enumerateValues.begin(); itr != enumerateValues.end(); ++itr)
+        body->add_element(newIfReturn(functionName, newInteger(count++), newEnumValue(enumerateName, *itr)));
+    return newFunction(functionName, new derived_datatype_identifier_c(intern_string(enumerateName.c_str())),
+                       new simple_spec_init_c(new_type_name(integerType), NULL), body, add_en_eno);
 }
 
 /*
- * printEnumToInteger function print conversion function from <ENUM> to <INTEGER>:
- * ST Output:
+ * createEnumToInteger function builds the conversion function from <ENUM> to <INTEGER>:
+ * ST equivalent:
  *
 
  FUNCTION <ENUM>_TO_<INTEGER> : <INTEGER>
   VAR_INPUT
-  IN: <INTEGER>;
+  IN: <ENUM>;
   END_VAR
   IF IN = <ENUM>#<ENUM.VALUE_1> THEN
-   <ENUM>_TO_<INTEGER> := 1;
+   <ENUM>_TO_<INTEGER> := 0;
    RETURN;
   END_IF;
   ...
   IF IN = <ENUM>#<ENUM.VALUE_N> THEN
-   <ENUM>_TO_<INTEGER> := N;
+   <ENUM>_TO_<INTEGER> := N-1;
    RETURN;
   END_IF;
   ENO := FALSE;
@@ -299,30 +404,16 @@ void create_enumtype_conversion_functions_c::printIntegerToEnum (std::string &en
 
   Note: if you change code below remember to update this comment.
  */
-void create_enumtype_conversion_functions_c::printEnumToInteger (std::string &enumerateName, std::list<std::string> &enumerateValues, bool isSigned, size_t size) {
+symbol_c *create_enumtype_conversion_functions_c::createEnumToInteger (std::string &enumerateName, std::list<std::string> &enumerateValues, int integerType) {
     std::list <std::string>::const_iterator itr;
     std::string functionName;
-    std::string integerType;
+    statement_list_c *body = new statement_list_c();
     int count;
 
-    integerType  = getIntegerName(isSigned, size);
-    functionName = enumerateName + "_TO_" + integerType;
-    text += "FUNCTION " + functionName + " : " + integerType;
-    text += "\nVAR_INPUT\nIN : " + enumerateName + ";\nEND_VAR\n";
+    functionName = enumerateName + "_TO_" + conversion_types[integerType];
     count = 0;
-    for (itr = enumerateValues.begin(); itr != enumerateValues.end(); ++itr) {
-        std::string value = *itr;
-        std::stringstream out;
-        out << count;
-        text += "IF IN = " + enumerateName + "#" + value + " THEN\n";
-        text += " " + functionName + " := " + out.str() + ";\n";
-        text += " RETURN;\n";
-        text += "END_IF;\n";
-        count++;
-    }
-    text += "ENO := FALSE;\n";
-    text += "END_FUNCTION\n\n";
+    for (itr = enumerateValues.begin(); itr != enumerateValues.end(); ++itr)
+        body->add_element(newIfReturn(functionName, newEnumValue(enumerateName, *itr), newInteger(count++)));
+    return newFunction(functionName, new_type_name(integerType),
+                       new enumerated_spec_init_c(new derived_datatype_identifier_c(intern_string(enumerateName.c_str())), NULL), body, add_en_eno);
 }
-
-
-
@@ -32,8 +32,8 @@
  */
 
 /*
- * create_enumtype_conversion_functions_c generates ST conversion functions source code for
- * enumerate user defined data types.
+ * create_enumtype_conversion_functions_c builds the conversion functions (as AST nodes) for
+ * enumerate user defined data types, for the conversions that are called in the source code.
  *
  */
 
@@ -42,41 +42,34 @@
 
 #include <string>
 #include <list>
+#include <set>
+#include <vector>
 
 #include "../absyntax_utils/absyntax_utils.hh"
 
+/* defined in stage1_2_priv.hh */
+typedef struct parse_context_s parse_context_t;
+
 
 class create_enumtype_conversion_functions_c: public iterator_visitor_c {
-  private:
-    static create_enumtype_conversion_functions_c *singleton;
-    
   public:
     explicit create_enumtype_conversion_functions_c(symbol_c *ignore);
     virtual ~create_enumtype_conversion_functions_c(void);
-    static std::string &get_declaration(symbol_c *symbol);
+    /* Called by the parser for every data type declaration (TYPE ... END_TYPE) */
+    static void declare(parse_context_t *context, symbol_c *data_type_declaration);
+    /* Add to the library (tree) the conversion functions called by its elements (from element first onwards) */
+    static void add_to(parse_context_t *context, symbol_c *tree, int first = 0);
 
-    void *visit(                 identifier_c *symbol);
-    void *visit(         poutype_identifier_c *symbol);
-    void *visit(derived_datatype_identifier_c *symbol);
-    
-    /**********************/
-    /* B 1.3 - Data types */
-    /**********************/
-    /********************************/
-    /* B 1.3.3 - Derived data types */
-    /********************************/
-    void *visit(enumerated_type_declaration_c *symbol);
-    void *visit(enumerated_value_list_c *symbol);
+    void *visit(poutype_identifier_c *symbol);
 
   private:
-    std::string text;
-    std::string currentToken;
-    std::list <std::string> currentTokenList;
-    std::string getIntegerName(bool isSigned, size_t size);
-    void printStringToEnum  (std::string &enumerateName, std::list <std::string> &enumerateValues);
-    void printEnumToString  (std::string &enumerateName, std::list <std::string> &enumerateValues);
-    void printIntegerToEnum (std::string &enumerateName, std::list <std::string> &enumerateValues, bool isSigned, size_t size);
-    void printEnumToInteger (std::string &enumerateName, std::list <std::string> &enumerateValues, bool isSigned, size_t size);
+    std::set<std::string, nocasecmp_c> called_functions;
+    bool add_en_eno;  /* add EN and ENO to the functions built (unless disabled by the command line options of the parse) */
+    void createFunctions(enumerated_type_declaration_c *symbol, std::vector<symbol_c *> &functions);
+    symbol_c *createStringToEnum  (std::string &enumerateName, std::list <std::string> &enumerateValues);
+    symbol_c *createEnumToString  (std::string &enumerateName, std::list <std::string> &enumerateValues);
+    symbol_c *createIntegerToEnum (std::string &enumerateName, std::list <std::string> &enumerateValues, int integerType);
+    symbol_c *createEnumToInteger (std::string &enumerateName, std::list <std::string> &enumerateValues, int integerType);
 };
 
 #endif /* _CREATE_ENUMTYPE_CONVERSION_FUNCTIONS_HH */
@@ -76,12 +76,6 @@
 #include <string.h>	/* required for strdup()  */
 
 
-/* declare the token parser generated by flex... */
-int yylex(void);
-
-/* declare the error handler defined at the end of this file */
-void yyerror (const char *error_msg);
-
 /* produce a more verbose parsing error message */
 #define YYERROR_VERBOSE
 
@@ -98,12 +92,18 @@ void yyerror (const char *error_msg);
 /* file with declaration of token constants. Generated by bison! */
 #include "iec_bison.hh"
 
-/* The interface through which bison and flex interact. */
+/* The interface through which bison and flex interact (including the declaration of yylex()). */
 #include "stage1_2_priv.hh"
 #include "create_enumtype_conversion_functions.hh"
+#include "library_snapshot.hh"
+#include "prescan.hh"
+#include "incremental_parse.hh"
 
 #include "../absyntax_utils/add_en_eno_param_decl.hh"	/* required for  add_en_eno_param_decl_c */
 
+/* declare the error handler defined at the end of this file */
+void yyerror (YYLTYPE *locp, parse_context_t *context, const char *error_msg);
+
 /* an ugly hack!!
  * We will probably not need it when we decide
  *  to cut down the abstract syntax down to size.
@@ -165,53 +165,6 @@ void yyerror (const char *error_msg);
 
 
 
-/*************************/
-/* global variables...   */
-/*************************/
-/* NOTE: For some strange reason bison ver 2.3 is including these declarations
- *       in the iec_bison.hh file, which is in turn included by flex.
- *       We cannot therefore define any variables over here, but merely declare 
- *       their existance (otherwise we get errors when linking the code, since we
- *       would get a new variable defined each time iec_bison.hh is included!).
- *       Even though the variables are declared 'extern' over here, they will in
- *       fact be defined towards the end of this same file (i.e. in the prologue)
- */
-
-
-/* NOTE: These variable are really parameters we would like the stage2__ function to pass
- *       to the yyparse() function. However, the yyparse() function is created automatically
- *       by bison, so we cannot add parameters to this function. The only other
- *       option is to use global variables! yuck!
- */
-
-/* A global flag used to tell the parser if overloaded funtions should be allowed.
- * The IEC 61131-3 standard allows overloaded funtions in the standard library,
- * but disallows them in user code...
- */
-extern bool allow_function_overloading;
-
-/* A flag to tell the compiler whether to allow the declaration
- * of extensible function (i.e. functions that may have a variable number of
- * input parameters, such as AND(word#33, word#44, word#55, word#66).
- * This is an extension to the standard syntax.
- * See comments below for details why we support this!
- */
-extern bool allow_extensible_function_parameters;
-
-/* A global flag used to tell the parser whether to allow use of DREF and '^' operators (defined in IEC 61131-3 v3) */
-extern bool allow_ref_dereferencing;
-
-/* A global flag used to tell the parser whether to allow use of REF_TO ANY datatypes (non-standard extension to IEC 61131-3 v3) */
-extern bool allow_ref_to_any;
-
-/* A global flag used to tell the parser whether to allow use of REF_TO as a struct or array element (non-standard extension) */
-extern bool allow_ref_to_in_derived_datatypes;
-
-/* A pointer to the root of the parsing tree that will be generated  by bison. */
-extern symbol_c *tree_root;
-
-
-
 /************************/
 /* forward declarations */
 /************************/
@@ -222,14 +175,18 @@ identifier_c         *il_operator_c_2_identifier_c        (symbol_c *il_operator
 /* Convert an il_operator_c into an poutype_identifier_c */
 poutype_identifier_c *il_operator_c_2_poutype_identifier_c(symbol_c *il_operator);
 
+/* The AST of a POU skipped by flex as it did not change since the previous parse (see incremental_parse.hh), or NULL */
+static symbol_c *unchanged_pou(parse_context_t *context, symbol_c *name, int token);
+
 
-/* return if current token is a syntax element */
+/* return if current token (yychar) is a syntax element */
 /* ERROR_CHECK_BEGIN */
-bool is_current_syntax_token();
+bool is_current_syntax_token(int token);
 /* ERROR_CHECK_END */
 
 /* print an error message */
-void print_err_msg(int first_line,
+void print_err_msg(parse_context_t *context,
+                   int first_line,
                    int first_column,
                    const char *first_filename,
                    long int first_order,
@@ -279,9 +236,21 @@ typedef struct YYLTYPE {
 #define YYLTYPE_IS_TRIVIAL 0
 #endif
 
+/* The state of a parse, passed to yyparse() and yylex() (defined in stage1_2_priv.hh) */
+typedef struct parse_context_s parse_context_t;
 }
 
 
+/* A pure (i.e. reentrant) parser, that keeps all the state of a parse in the context it is handed
+ * by stage1_2(), and passes it on to flex (also reentrant, see iec_flex.ll).
+ * yyparse(context) calls yylex(&yylval, &yylloc, context) and yyerror(&yylloc, context, msg).
+ */
+%define api.pure full
+%locations
+%parse-param {parse_context_t *context}
+%lex-param   {parse_context_t *context}
+
+
 
 %union {
     symbol_c 	*leaf;
@@ -1668,19 +1637,19 @@ prev_declared_program_type_name:           prev_declared_program_type_name_token
 /***************************/
 library:
   /* empty */
-	{if (tree_root == NULL)
-	  tree_root = new library_c();
-	 $$ = (list_c *)tree_root;
+	{if (context->tree_root == NULL)
+	  context->tree_root = new library_c();
+	 $$ = (list_c *)context->tree_root;
 	}
 | library library_element_declaration
-	{$$ = $1; $$->add_element($2);}
+	{$$ = $1; if (NULL != $2) $$->add_element($2); /* NULL: a POU skipped by lazy parsing (-L), or with errors */}
 | library any_pragma
 	{$$ = $1; $$->add_element($2);}
 /* ERROR_CHECK_BEGIN */
 | library error library_element_declaration
-	{$$ = $1; print_err_msg(locf(@2), locl(@2), "unknown syntax error."); yyerrok;}
+	{$$ = $1; print_err_msg(context, locf(@2), locl(@2), "unknown syntax error."); yyerrok;}
 | library error END_OF_INPUT
-	{$$ = $1; print_err_msg(locf(@2), locl(@2), "unknown syntax error."); yyerrok;}
+	{$$ = $1; print_err_msg(context, locf(@2), locl(@2), "unknown syntax error."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -1992,17 +1961,17 @@ integer_literal:
 | '-' integer	{$$ = new neg_integer_c($2, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | integer_type_name signed_integer
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "'#' missing between integer type name and value in integer literal."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "'#' missing between integer type name and value in integer literal."); context->yynerrs++;}
 | integer_type_name binary_integer
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "'#' missing between integer type name and value in integer literal."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "'#' missing between integer type name and value in integer literal."); context->yynerrs++;}
 | integer_type_name octal_integer
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "'#' missing between integer type name and value in integer literal."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "'#' missing between integer type name and value in integer literal."); context->yynerrs++;}
 | integer_type_name hex_integer
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "'#' missing between integer type name and value in integer literal."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "'#' missing between integer type name and value in integer literal."); context->yynerrs++;}
 | integer_type_name '#' error
 	{$$ = NULL; 
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no value defined for integer literal.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid value for integer literal."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no value defined for integer literal.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid value for integer literal."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -2031,11 +2000,11 @@ real_literal:
 	{$$ = new real_literal_c($1, $3, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | real_type_name signed_real
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "'#' missing between real type name and value in real literal."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "'#' missing between real type name and value in real literal."); context->yynerrs++;}
 | real_type_name '#' error
   {$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no value defined for real literal.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid value for real literal."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no value defined for real literal.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid value for real literal."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -2075,17 +2044,17 @@ bit_string_literal:
  */
 /* ERROR_CHECK_BEGIN */
 | bit_string_type_name integer
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "'#' missing between bit string type name and value in bit string literal."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "'#' missing between bit string type name and value in bit string literal."); context->yynerrs++;}
 | bit_string_type_name binary_integer
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "'#' missing between bit string type name and value in bit string literal."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "'#' missing between bit string type name and value in bit string literal."); context->yynerrs++;}
 | bit_string_type_name octal_integer
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "'#' missing between bit string type name and value in bit string literal."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "'#' missing between bit string type name and value in bit string literal."); context->yynerrs++;}
 | bit_string_type_name hex_integer
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "'#' missing between bit string type name and value in bit string literal."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "'#' missing between bit string type name and value in bit string literal."); context->yynerrs++;}
 | bit_string_type_name '#' error
 	{$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no value defined for bit string literal.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid value for bit string literal."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no value defined for bit string literal.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid value for bit string literal."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -2217,17 +2186,17 @@ duration:
 	{$$ = new duration_c(new safetime_type_name_c(locloc(@1)), new neg_time_c(locloc(@$)), $4, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | TIME interval
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "'#' missing between 'TIME' and interval in duration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "'#' missing between 'TIME' and interval in duration."); context->yynerrs++;}
 | TIME '-' interval
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "'#' missing between 'TIME' and interval in duration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "'#' missing between 'TIME' and interval in duration."); context->yynerrs++;}
 | TIME '#' erroneous_interval_token
-	{$$ = NULL; print_err_msg(locf(@3), locl(@3), "invalid value for duration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "invalid value for duration."); context->yynerrs++;}
 | T_SHARP erroneous_interval_token
-	{$$ = NULL; print_err_msg(locf(@2), locl(@2), "invalid value for duration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "invalid value for duration."); context->yynerrs++;}
 | TIME '#' '-' erroneous_interval_token
-	{$$ = NULL; print_err_msg(locf(@3), locl(@3), "invalid value for duration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "invalid value for duration."); context->yynerrs++;}
 | T_SHARP '-' erroneous_interval_token
-	{$$ = NULL; print_err_msg(locf(@2), locl(@2), "invalid value for duration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "invalid value for duration."); context->yynerrs++;}
 /* ERROR_CHECK_END */
 ;
 
@@ -2284,11 +2253,11 @@ time_of_day:
 	{$$ = new time_of_day_c(new safetod_type_name_c(locloc(@1)), $3, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | TIME_OF_DAY daytime
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "'#' missing between 'TIME_OF_DAY' and daytime in time of day."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "'#' missing between 'TIME_OF_DAY' and daytime in time of day."); context->yynerrs++;}
 | TIME_OF_DAY '#' error
 	{$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no value defined for time of day.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid value for time of day."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no value defined for time of day.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid value for time of day."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -2300,21 +2269,21 @@ daytime:
 	{$$ = new daytime_c($1, $3, $5, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | ':' day_minute ':' day_second
-  {$$ = NULL; print_err_msg(locf(@1), locl(@4), "no value defined for hours in daytime."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locf(@1), locl(@4), "no value defined for hours in daytime."); context->yynerrs++;}
 | error ':' day_minute ':' day_second
-  {$$ = NULL; print_err_msg(locf(@1), locl(@1), "invalid value defined for hours in daytime."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@1), locl(@1), "invalid value defined for hours in daytime."); yyerrok;}
 | day_hour day_minute ':' day_second
-  {$$ = NULL; print_err_msg(locl(@1), locf(@2), "':' missing between hours and minutes in daytime."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':' missing between hours and minutes in daytime."); context->yynerrs++;}
 | day_hour ':' ':' day_second
-	{$$ = NULL; print_err_msg(locl(@2), locf(@3), "no value defined for minutes in daytime."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@2), locf(@3), "no value defined for minutes in daytime."); context->yynerrs++;}
 | day_hour ':' error ':' day_second
-	{$$ = NULL; print_err_msg(locf(@3), locl(@3), "invalid value defined for minutes in daytime."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "invalid value defined for minutes in daytime."); yyerrok;}
 | day_hour ':' day_minute day_second
-  {$$ = NULL; print_err_msg(locl(@3), locf(@4), "':' missing between minutes and seconds in daytime."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@3), locf(@4), "':' missing between minutes and seconds in daytime."); context->yynerrs++;}
 | day_hour ':' day_minute ':' error
   {$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@4), locf(@5), "no value defined for seconds in daytime.");}
-	 else {print_err_msg(locf(@5), locl(@5), "invalid value for seconds in daytime."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@4), locf(@5), "no value defined for seconds in daytime.");}
+	 else {print_err_msg(context, locf(@5), locl(@5), "invalid value for seconds in daytime."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -2335,17 +2304,17 @@ date:
 	{$$ = new date_c(new safedate_type_name_c(locloc(@1)), $3, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | DATE date_literal
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "'#' missing between 'DATE' and date literal in date."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "'#' missing between 'DATE' and date literal in date."); context->yynerrs++;}
 | DATE '#' error
 	{$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no value defined for date.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid value for date."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no value defined for date.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid value for date."); yyclearin;}
 	 yyerrok;
 	}
 | D_SHARP error
   {$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@1), locf(@2), "no value defined for date.");}
-	 else {print_err_msg(locf(@2), locl(@2), "invalid value for date."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@1), locf(@2), "no value defined for date.");}
+	 else {print_err_msg(context, locf(@2), locl(@2), "invalid value for date."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -2357,19 +2326,19 @@ date_literal:
 	{$$ = new date_literal_c($1, $3, $5, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | '-' month '-' day
-  {$$ = NULL; print_err_msg(locl(@1), locf(@2), "no value defined for year in date literal."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "no value defined for year in date literal."); context->yynerrs++;}
 | year month '-' day
-  {$$ = NULL; print_err_msg(locl(@1), locf(@2), "'-' missing between year and month in date literal."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "'-' missing between year and month in date literal."); context->yynerrs++;}
 | year '-' '-' day
-	{$$ = NULL; print_err_msg(locl(@2), locf(@3), "no value defined for month in date literal."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@2), locf(@3), "no value defined for month in date literal."); context->yynerrs++;}
 | year '-' error '-' day
-	{$$ = NULL; print_err_msg(locf(@3), locl(@3), "invalid value defined for month in date literal."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "invalid value defined for month in date literal."); yyerrok;}
 | year '-' month day
-  {$$ = NULL; print_err_msg(locl(@3), locf(@4), "'-' missing between month and day in date literal."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@3), locf(@4), "'-' missing between month and day in date literal."); context->yynerrs++;}
 | year '-' month '-' error
   {$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@4), locf(@5), "no value defined for day in date literal.");}
-	 else {print_err_msg(locf(@5), locl(@5), "invalid value for day in date literal."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@4), locf(@5), "no value defined for day in date literal.");}
+	 else {print_err_msg(context, locf(@5), locl(@5), "invalid value for day in date literal."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -2388,17 +2357,17 @@ date_and_time:
 	{$$ = new date_and_time_c(new safedt_type_name_c(locloc(@1)), $3, $5, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | DATE_AND_TIME date_literal '-' daytime
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "'#' missing between 'DATE_AND_TIME' and date literal in date and time."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "'#' missing between 'DATE_AND_TIME' and date literal in date and time."); context->yynerrs++;}
 | DATE_AND_TIME '#' '-' daytime
-	{$$ = NULL; print_err_msg(locl(@2), locf(@3), "no value defined for date literal in date and time."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@2), locf(@3), "no value defined for date literal in date and time."); context->yynerrs++;}
 | DATE_AND_TIME '#' error '-' daytime
-	{$$ = NULL; print_err_msg(locf(@3), locl(@3), "invalid value for date literal in date and time."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "invalid value for date literal in date and time."); yyerrok;}
 | DATE_AND_TIME '#' date_literal daytime
-	{$$ = NULL; print_err_msg(locl(@3), locf(@4), "'-' missing between date literal and daytime in date and time."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@3), locf(@4), "'-' missing between date literal and daytime in date and time."); context->yynerrs++;}
 | DATE_AND_TIME '#' date_literal '-' error
 	{$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@4), locf(@5), "no value defined for daytime in date and time.");}
-	 else {print_err_msg(locf(@5), locl(@5), "invalid value for daytime in date and time."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@4), locf(@5), "no value defined for daytime in date and time.");}
+	 else {print_err_msg(context, locf(@5), locl(@5), "invalid value for daytime in date and time."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -2596,16 +2565,16 @@ structure_type_name: identifier;
 
 data_type_declaration:
   TYPE type_declaration_list END_TYPE
-	{$$ = new data_type_declaration_c($2, locloc(@$)); if (runtime_options.conversion_functions) include_string((create_enumtype_conversion_functions_c::get_declaration($$)).c_str());}
+	{$$ = new data_type_declaration_c($2, locloc(@$)); if (context->options.conversion_functions) create_enumtype_conversion_functions_c::declare(context, $$);}
 /* ERROR_CHECK_BEGIN */
 | TYPE END_TYPE
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "no data type declared in data type(s) declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "no data type declared in data type(s) declaration."); context->yynerrs++;}
 | TYPE error type_declaration_list END_TYPE
-	{$$ = NULL; print_err_msg(locf(@2), locl(@2), "unexpected token after 'TYPE' in data type(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "unexpected token after 'TYPE' in data type(s) declaration."); yyerrok;}
 | TYPE type_declaration_list error END_OF_INPUT
-	{$$ = NULL; print_err_msg(locf(@1), locl(@1), "unclosed data type(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@1), locl(@1), "unclosed data type(s) declaration."); yyerrok;}
 | TYPE error END_TYPE
-	{$$ = NULL; print_err_msg(locf(@2), locl(@2), "unknown error in data type(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "unknown error in data type(s) declaration."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -2617,15 +2586,15 @@ type_declaration_list:
 	{$$ = $1; $$->add_element($2);}
 /* ERROR_CHECK_BEGIN */
 | error ';'
-	{$$ = new type_declaration_list_c(locloc(@$)); print_err_msg(locf(@1), locl(@1), "invalid data type declaration."); yyerrok;}
+	{$$ = new type_declaration_list_c(locloc(@$)); print_err_msg(context, locf(@1), locl(@1), "invalid data type declaration."); yyerrok;}
 | type_declaration error
-	{$$ = new type_declaration_list_c(locloc(@$)); print_err_msg(locl(@1), locf(@2), "';' missing at end of data type declaration."); yyerrok;}
+	{$$ = new type_declaration_list_c(locloc(@$)); print_err_msg(context, locl(@1), locf(@2), "';' missing at end of data type declaration."); yyerrok;}
 | type_declaration_list type_declaration error
-	{$$ = $1; print_err_msg(locl(@2), locf(@3), "';' missing at end of data type declaration."); yyerrok;}
+	{$$ = $1; print_err_msg(context, locl(@2), locf(@3), "';' missing at end of data type declaration."); yyerrok;}
 | type_declaration_list error ';'
-	{$$ = $1; print_err_msg(locf(@2), locl(@2), "invalid data type declaration."); yyerrok;}
+	{$$ = $1; print_err_msg(context, locf(@2), locl(@2), "invalid data type declaration."); yyerrok;}
 | type_declaration_list ';'
-	{$$ = $1; print_err_msg(locf(@2), locl(@2), "unexpected ';' after data type declaration."); yynerrs++;}
+	{$$ = $1; print_err_msg(context, locf(@2), locl(@2), "unexpected ';' after data type declaration."); context->yynerrs++;}
 /* ERROR_CHECK_END */
 ;
 
@@ -2646,19 +2615,14 @@ single_element_type_declaration:
 simple_type_declaration:
 /*  simple_type_name ':' simple_spec_init */
 /* To understand why simple_spec_init was brocken up into its consituent components in the following rules, please see note in the definition of 'enumerated_type_declaration'. */
-/* PRE_PARSING or SINGLE_PHASE_PARSING */
-/*  The following rules will be run either by:
- *      - the pre_parsing phase of two phase parsing (when preparsing command line option is chosen).
- *      - the standard single phase parser (when preparsing command line option is not chosen).
- */
-  identifier ':' simple_specification           {library_element_symtable.insert($1, prev_declared_simple_type_name_token);}
-	{if (!get_preparse_state()) $$ = new simple_type_declaration_c($1, $3, locloc(@$));}
-| identifier ':' elementary_type_name           {library_element_symtable.insert($1, prev_declared_simple_type_name_token);} ASSIGN constant
-	{if (!get_preparse_state()) $$ = new simple_type_declaration_c($1, new simple_spec_init_c($3, $6, locf(@3), locl(@5)), locloc(@$));}
-| identifier ':' prev_declared_simple_type_name {library_element_symtable.insert($1, prev_declared_simple_type_name_token);} ASSIGN constant
-	{if (!get_preparse_state()) $$ = new simple_type_declaration_c($1, new simple_spec_init_c($3, $6, locf(@3), locl(@5)), locloc(@$));}
-/* POST_PARSING */
-/*  These rules will be run after the preparser phase of two phase parsing has finished (only gets to execute if preparsing command line option is chosen). */
+/* SINGLE_PHASE_PARSING: The name was not declared by the pre-scanner (i.e. -p command line option not chosen). */
+  identifier ':' simple_specification           {context->library_element_symtable.insert($1, prev_declared_simple_type_name_token);}
+	{$$ = new simple_type_declaration_c($1, $3, locloc(@$));}
+| identifier ':' elementary_type_name           {context->library_element_symtable.insert($1, prev_declared_simple_type_name_token);} ASSIGN constant
+	{$$ = new simple_type_declaration_c($1, new simple_spec_init_c($3, $6, locf(@3), locl(@5)), locloc(@$));}
+| identifier ':' prev_declared_simple_type_name {context->library_element_symtable.insert($1, prev_declared_simple_type_name_token);} ASSIGN constant
+	{$$ = new simple_type_declaration_c($1, new simple_spec_init_c($3, $6, locf(@3), locl(@5)), locloc(@$));}
+/* FORWARD_DECLARED: The name was already declared by the pre-scanner (only when the -p command line option is chosen, see prescan.hh). */
 | prev_declared_simple_type_name ':' simple_spec_init
 	{$$ = new simple_type_declaration_c(new identifier_c(((token_c *)$1)->value, locloc(@1)), $3, locloc(@$));} // change the derived_datatype_identifier_c into an identifier_c, as it will be taking the place of an identifier!
 /* These three rules can now be safely replaced by the original rule abvoe!! */
@@ -2672,13 +2636,13 @@ simple_type_declaration:
 */
 /* ERROR_CHECK_BEGIN */
 | error ':' simple_spec_init
-	{$$ = NULL; print_err_msg(locf(@1), locl(@1), "invalid name defined for data type declaration.");yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@1), locl(@1), "invalid name defined for data type declaration.");yyerrok;}
 | identifier simple_spec_init
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "':' missing between data type name and specification in simple type declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':' missing between data type name and specification in simple type declaration."); context->yynerrs++;}
 | identifier ':' error
 	{$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no specification defined in data type declaration.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid specification in data type declaration."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no specification defined in data type declaration.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid specification in data type declaration."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -2702,19 +2666,19 @@ simple_spec_init:
 	{$$ = new simple_spec_init_c($1, $3, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | elementary_type_name constant
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "':=' missing in specification with initialization."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':=' missing in specification with initialization."); context->yynerrs++;}
 | prev_declared_simple_type_name constant
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "':=' missing in specification with initialization."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':=' missing in specification with initialization."); context->yynerrs++;}
 | elementary_type_name ASSIGN error
 	{$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no initial value defined in specification with initialization.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid initial value in specification with initialization."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no initial value defined in specification with initialization.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid initial value in specification with initialization."); yyclearin;}
 	 yyerrok;
 	}
 | prev_declared_simple_type_name ASSIGN error
 	{$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no initial value defined in specification with initialization.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid initial value in specification with initialization."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no initial value defined in specification with initialization.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid initial value in specification with initialization."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -2742,22 +2706,17 @@ simple_specification:
 
 subrange_type_declaration:
 /*  subrange_type_name ':' subrange_spec_init */
-/* PRE_PARSING or SINGLE_PHASE_PARSING */
-/*  The following rules will be run either by:
- *      - the pre_parsing phase of two phase parsing (when preparsing command line option is chosen).
- *      - the standard single phase parser (when preparsing command line option is not chosen).
- */
-  identifier ':' subrange_spec_init	{library_element_symtable.insert($1, prev_declared_subrange_type_name_token);}
-	{if (!get_preparse_state()) $$ = new subrange_type_declaration_c($1, $3, locloc(@$));}  
-/* POST_PARSING */
-/*  These rules will be run after the preparser phase of two phase parsing has finished (only gets to execute if preparsing command line option is chosen). */
+/* SINGLE_PHASE_PARSING: The name was not declared by the pre-scanner (i.e. -p command line option not chosen). */
+  identifier ':' subrange_spec_init	{context->library_element_symtable.insert($1, prev_declared_subrange_type_name_token);}
+	{$$ = new subrange_type_declaration_c($1, $3, locloc(@$));}  
+/* FORWARD_DECLARED: The name was already declared by the pre-scanner (only when the -p command line option is chosen, see prescan.hh). */
 | prev_declared_subrange_type_name ':' subrange_spec_init
 	{$$ = new subrange_type_declaration_c(new identifier_c(((token_c *)$1)->value, locloc(@1)), $3, locloc(@$));} // change the derived_datatype_identifier_c into an identifier_c, as it will be taking the place of an identifier!
 /* ERROR_CHECK_BEGIN */
 | error ':' subrange_spec_init
-	{$$ = NULL; print_err_msg(locf(@1), locl(@1), "invalid name defined for subrange type declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@1), locl(@1), "invalid name defined for subrange type declaration."); yyerrok;}
 | identifier subrange_spec_init
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "':' missing between data type name and specification in subrange type declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':' missing between data type name and specification in subrange type declaration."); context->yynerrs++;}
 /* ERROR_CHECK_END */
 ;
 
@@ -2768,11 +2727,11 @@ subrange_spec_init:
 	{$$ = new subrange_spec_init_c($1, $3, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | subrange_specification signed_integer
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "':=' missing in subrange specification with initialization."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':=' missing in subrange specification with initialization."); context->yynerrs++;}
 | subrange_specification ASSIGN error
 	{$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no initial value defined in subrange specification with initialization.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid initial value in subrange specification with initialization."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no initial value defined in subrange specification with initialization.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid initial value in subrange specification with initialization."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -2785,11 +2744,11 @@ subrange_specification:
   {$$ = new subrange_specification_c($1, NULL, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | integer_type_name '(' ')'
-	{$$ = NULL; print_err_msg(locl(@2), locf(@3), "no subrange defined in subrange specification."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@2), locf(@3), "no subrange defined in subrange specification."); context->yynerrs++;}
 | integer_type_name '(' error ')'
-	{$$ = NULL; print_err_msg(locf(@3), locl(@3), "invalid subrange defined in subrange specification."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "invalid subrange defined in subrange specification."); yyerrok;}
 | integer_type_name '(' subrange error
-	{$$ = NULL; print_err_msg(locl(@3), locf(@4), "')' missing after subrange defined in subrange specification."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locl(@3), locf(@4), "')' missing after subrange defined in subrange specification."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -2800,32 +2759,32 @@ subrange_with_var:
 	{$$ = new subrange_c($1, $3, locloc(@$));}
 | any_identifier DOTDOT signed_integer
 	{$$ = new subrange_c(new symbolic_constant_c($1, locloc(@1)), $3, locloc(@$));
-	 if (!runtime_options.nonliteral_in_array_size) {
-	   print_err_msg(locf(@1), locl(@1), "Use of variables in array size limits is not allowed in IEC 61131-3 (use -a option to activate support for this non-standard feature)."); 
-	   yynerrs++;
+	 if (!context->options.nonliteral_in_array_size) {
+	   print_err_msg(context, locf(@1), locl(@1), "Use of variables in array size limits is not allowed in IEC 61131-3 (use -a option to activate support for this non-standard feature)."); 
+	   context->yynerrs++;
 	 }
 	}
 | signed_integer DOTDOT any_identifier
 	{$$ = new subrange_c($1, new symbolic_constant_c($3, locloc(@3)), locloc(@$));
-	 if (!runtime_options.nonliteral_in_array_size) {
-	   print_err_msg(locf(@3), locl(@3), "Use of variables in array size limits is not allowed in IEC 61131-3 (use -a option to activate support for this non-standard feature)."); 
-	   yynerrs++;
+	 if (!context->options.nonliteral_in_array_size) {
+	   print_err_msg(context, locf(@3), locl(@3), "Use of variables in array size limits is not allowed in IEC 61131-3 (use -a option to activate support for this non-standard feature)."); 
+	   context->yynerrs++;
 	 }
 	}
 | any_identifier DOTDOT any_identifier
 	{$$ = new subrange_c(new symbolic_constant_c($1, locloc(@1)), new symbolic_constant_c($3, locloc(@3)), locloc(@$));
-	 if (!runtime_options.nonliteral_in_array_size) {
-	   print_err_msg(locf(@$), locl(@$), "Use of variables in array size limits is not allowed in IEC 61131-3 (use -a option to activate support for this non-standard feature)."); 
-	   yynerrs++;
+	 if (!context->options.nonliteral_in_array_size) {
+	   print_err_msg(context, locf(@$), locl(@$), "Use of variables in array size limits is not allowed in IEC 61131-3 (use -a option to activate support for this non-standard feature)."); 
+	   context->yynerrs++;
 	 }
 	}
 /* ERROR_CHECK_BEGIN */
 | signed_integer signed_integer
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "'..' missing between bounds in subrange definition."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "'..' missing between bounds in subrange definition."); context->yynerrs++;}
 | signed_integer DOTDOT error
 	{$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no value defined for upper bound in subrange definition.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid value for upper bound in subrange definition."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no value defined for upper bound in subrange definition.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid value for upper bound in subrange definition."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -2837,11 +2796,11 @@ subrange:
 	{$$ = new subrange_c($1, $3, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | signed_integer signed_integer
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "'..' missing between bounds in subrange definition."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "'..' missing between bounds in subrange definition."); context->yynerrs++;}
 | signed_integer DOTDOT error
 	{$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no value defined for upper bound in subrange definition.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid value for upper bound in subrange definition."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no value defined for upper bound in subrange definition.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid value for upper bound in subrange definition."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -2863,32 +2822,27 @@ enumerated_type_declaration:
  *           identifier ':' enumerated_spec_init
  *       and include the library_element_symtable.insert(...) code in the rule actions!
  */
-/* PRE_PARSING or SINGLE_PHASE_PARSING */
-/*  The following rules will be run either by:
- *      - the pre_parsing phase of two phase parsing (when preparsing command line option is chosen).
- *      - the standard single phase parser (when preparsing command line option is not chosen).
- */
-  identifier ':' enumerated_specification {library_element_symtable.insert($1, prev_declared_enumerated_type_name_token);}
-	{if (!get_preparse_state()) $$ = new enumerated_type_declaration_c($1, new enumerated_spec_init_c($3, NULL, locloc(@3)), locloc(@$));}
-| identifier ':' enumerated_specification {library_element_symtable.insert($1, prev_declared_enumerated_type_name_token);} ASSIGN enumerated_value
-	{if (!get_preparse_state()) $$ = new enumerated_type_declaration_c($1, new enumerated_spec_init_c($3, $6, locf(@3), locl(@6)), locloc(@$));}
-/* POST_PARSING */
-/*  These rules will be run after the preparser phase of two phase parsing has finished (only gets to execute if preparsing command line option is chosen). */
+/* SINGLE_PHASE_PARSING: The name was not declared by the pre-scanner (i.e. -p command line option not chosen). */
+  identifier ':' enumerated_specification {context->library_element_symtable.insert($1, prev_declared_enumerated_type_name_token);}
+	{$$ = new enumerated_type_declaration_c($1, new enumerated_spec_init_c($3, NULL, locloc(@3)), locloc(@$));}
+| identifier ':' enumerated_specification {context->library_element_symtable.insert($1, prev_declared_enumerated_type_name_token);} ASSIGN enumerated_value
+	{$$ = new enumerated_type_declaration_c($1, new enumerated_spec_init_c($3, $6, locf(@3), locl(@6)), locloc(@$));}
+/* FORWARD_DECLARED: The name was already declared by the pre-scanner (only when the -p command line option is chosen, see prescan.hh). */
 /* Since the enumerated type name is placed in the library_element_symtable during preparsing, we can now safely use the single rule: */
 | prev_declared_enumerated_type_name ':' enumerated_spec_init 
 	{$$ = new enumerated_type_declaration_c(new identifier_c(((token_c *)$1)->value, locloc(@1)), $3, locloc(@$));} // change the derived_datatype_identifier_c into an identifier_c, as it will be taking the place of an identifier!
   /* These two rules are equivalent to the above rule */
 /*
-| prev_declared_enumerated_type_name ':' enumerated_specification {library_element_symtable.insert($1, prev_declared_enumerated_type_name_token);}
+| prev_declared_enumerated_type_name ':' enumerated_specification {context->library_element_symtable.insert($1, prev_declared_enumerated_type_name_token);}
 	{$$ = new enumerated_type_declaration_c($1, new enumerated_spec_init_c($3, NULL, locloc(@3)), locloc(@$));}
-| prev_declared_enumerated_type_name ':' enumerated_specification {library_element_symtable.insert($1, prev_declared_enumerated_type_name_token);} ASSIGN enumerated_value
+| prev_declared_enumerated_type_name ':' enumerated_specification {context->library_element_symtable.insert($1, prev_declared_enumerated_type_name_token);} ASSIGN enumerated_value
 	{$$ = new enumerated_type_declaration_c($1, new enumerated_spec_init_c($3, $6, locf(@3), locl(@6)), locloc(@$));}
 */
 /* ERROR_CHECK_BEGIN */
 | error ':' enumerated_spec_init
-	{$$ = NULL; print_err_msg(locf(@1), locl(@1), "invalid name defined for enumerated type declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@1), locl(@1), "invalid name defined for enumerated type declaration."); yyerrok;}
 | identifier enumerated_spec_init
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "':' missing between data type name and specification in enumerated type declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':' missing between data type name and specification in enumerated type declaration."); context->yynerrs++;}
 /* ERROR_CHECK_END */
 ;
 
@@ -2900,11 +2854,11 @@ enumerated_spec_init:
 	{$$ = new enumerated_spec_init_c($1, $3, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | enumerated_specification enumerated_value
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "':=' missing in enumerated specification with initialization."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':=' missing in enumerated specification with initialization."); context->yynerrs++;}
 | enumerated_specification ASSIGN error
 	{$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no value defined in enumerated specification with initialization.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid value in enumerated specification with initialization."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no value defined in enumerated specification with initialization.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid value in enumerated specification with initialization."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -2916,11 +2870,11 @@ enumerated_specification:
 | prev_declared_enumerated_type_name
 /* ERROR_CHECK_BEGIN */
 | '(' ')'
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "no enumerated value list defined in enumerated specification."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "no enumerated value list defined in enumerated specification."); context->yynerrs++;}
 | '(' error ')'
-	{$$ = NULL; print_err_msg(locf(@2), locl(@2), "invalid enumerated value list defined in enumerated specification.");yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "invalid enumerated value list defined in enumerated specification.");yyerrok;}
 | '(' enumerated_value_list error
-	{$$ = NULL; print_err_msg(locl(@2), locf(@3), "')' missing at the end of enumerated specification."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locl(@2), locf(@3), "')' missing at the end of enumerated specification."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -2932,11 +2886,11 @@ enumerated_value_list:
 	{$$ = $1; $$->add_element($3);}
 /* ERROR_CHECK_BEGIN */
 | enumerated_value_list enumerated_value
-	{$$ = $1; print_err_msg(locl(@1), locf(@2), "',' missing in enumerated value list.");}
+	{$$ = $1; print_err_msg(context, locl(@1), locf(@2), "',' missing in enumerated value list.");}
 | enumerated_value_list ',' error
 	{$$ = $1;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no value defined in enumerated value list.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid value in enumerated value list."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no value defined in enumerated value list.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid value in enumerated value list."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -2950,11 +2904,11 @@ enumerated_value:
 	{$$ = new enumerated_value_c($1, $3, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | prev_declared_enumerated_type_name any_identifier
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "'#' missing between enumerated type name and value in enumerated literal."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "'#' missing between enumerated type name and value in enumerated literal."); context->yynerrs++;}
 | prev_declared_enumerated_type_name '#' error
 	{$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no value defined for enumerated literal.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid value for enumerated literal."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no value defined for enumerated literal.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid value for enumerated literal."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -2971,20 +2925,15 @@ enumerated_value_without_identifier:
 
 array_type_declaration:
 /*  array_type_name ':' array_spec_init */
-/* PRE_PARSING or SINGLE_PHASE_PARSING */
-/*  The following rules will be run either by:
- *      - the pre_parsing phase of two phase parsing (when preparsing command line option is chosen).
- *      - the standard single phase parser (when preparsing command line option is not chosen).
- */
-  identifier ':' array_spec_init   {library_element_symtable.insert($1, prev_declared_array_type_name_token);}
-	{if (!get_preparse_state()) $$ = new array_type_declaration_c($1, $3, locloc(@$));}
-/* POST_PARSING */
-/*  These rules will be run after the preparser phase of two phase parsing has finished (only gets to execute if preparsing command line option is chosen). */
+/* SINGLE_PHASE_PARSING: The name was not declared by the pre-scanner (i.e. -p command line option not chosen). */
+  identifier ':' array_spec_init   {context->library_element_symtable.insert($1, prev_declared_array_type_name_token);}
+	{$$ = new array_type_declaration_c($1, $3, locloc(@$));}
+/* FORWARD_DECLARED: The name was already declared by the pre-scanner (only when the -p command line option is chosen, see prescan.hh). */
 | prev_declared_array_type_name ':' array_spec_init
 	{$$ = new array_type_declaration_c(new identifier_c(((token_c *)$1)->value, locloc(@1)), $3, locloc(@$));} // change the derived_datatype_identifier_c into an identifier_c, as it will be taking the place of an identifier!
 /* ERROR_CHECK_BEGIN */
 | identifier array_spec_init
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "':' missing between data type name and specification in array type declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':' missing between data type name and specification in array type declaration."); context->yynerrs++;}
 /* ERROR_CHECK_END */
 ;
 
@@ -2995,11 +2944,11 @@ array_spec_init:
 	{$$ = new array_spec_init_c($1, $3, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | array_specification array_initialization
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "':=' missing in array specification with initialization."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':=' missing in array specification with initialization."); context->yynerrs++;}
 | array_specification ASSIGN error
 	{$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no initial value defined in array specification with initialization.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid initial value in array specification with initialization."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no initial value defined in array specification with initialization.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid initial value in array specification with initialization."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -3022,30 +2971,30 @@ array_specification:
 	 *       which leads to the reduce/reduce conflict, as it is also included in ref_spec.
 	 */
 	{$$ = new array_specification_c($3, $6, locloc(@$));
-	 if (!allow_ref_to_in_derived_datatypes) {
-	   print_err_msg(locf(@$), locl(@$), "REF_TO may not be used in an ARRAY specification (use -R option to activate support for this non-standard syntax)."); 
-	   yynerrs++;
+	 if (!context->allow_ref_to_in_derived_datatypes) {
+	   print_err_msg(context, locf(@$), locl(@$), "REF_TO may not be used in an ARRAY specification (use -R option to activate support for this non-standard syntax)."); 
+	   context->yynerrs++;
 	 }
 	}
 /* ERROR_CHECK_BEGIN */
 | ARRAY array_subrange_list ']' OF non_generic_type_name
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "'[' missing before subrange list in array specification."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "'[' missing before subrange list in array specification."); context->yynerrs++;}
 | ARRAY '[' ']' OF non_generic_type_name
-	{$$ = NULL; print_err_msg(locl(@2), locf(@3), "no subrange list defined in array specification."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@2), locf(@3), "no subrange list defined in array specification."); context->yynerrs++;}
 | ARRAY '[' error ']' OF non_generic_type_name
-	{$$ = NULL; print_err_msg(locf(@3), locl(@3), "invalid subrange list defined in array specification."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "invalid subrange list defined in array specification."); yyerrok;}
 | ARRAY OF non_generic_type_name
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "no subrange list defined in array specification."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "no subrange list defined in array specification."); context->yynerrs++;}
 | ARRAY error OF non_generic_type_name
-	{$$ = NULL; print_err_msg(locf(@2), locl(@2), "invalid subrange list defined in array specification."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "invalid subrange list defined in array specification."); yyerrok;}
 | ARRAY '[' array_subrange_list OF non_generic_type_name
-	{$$ = NULL; print_err_msg(locl(@3), locf(@4), "']' missing after subrange list in array specification."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@3), locf(@4), "']' missing after subrange list in array specification."); context->yynerrs++;}
 | ARRAY '[' array_subrange_list ']' non_generic_type_name
-	{$$ = NULL; print_err_msg(locl(@4), locf(@5), "'OF' missing between subrange list and item type name in array specification."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@4), locf(@5), "'OF' missing between subrange list and item type name in array specification."); context->yynerrs++;}
 | ARRAY '[' array_subrange_list ']' OF error
 	{$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no item data type defined in array specification.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid item data type in array specification."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no item data type defined in array specification.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid item data type in array specification."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -3060,11 +3009,11 @@ array_subrange_list:
 	{$$ = $1; $$->add_element($3);}
 /* ERROR_CHECK_BEGIN */
 | array_subrange_list subrange
-	{$$ = $1; print_err_msg(locl(@1), locf(@2), "',' missing in subrange list."); yynerrs++;}
+	{$$ = $1; print_err_msg(context, locl(@1), locf(@2), "',' missing in subrange list."); context->yynerrs++;}
 | array_subrange_list ',' error
 	{$$ = $1;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no subrange defined in subrange list.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid subrange in subrange list."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no subrange defined in subrange list.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid subrange in subrange list."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -3076,11 +3025,11 @@ array_initialization:
 	{$$ = $2;}
 /* ERROR_CHECK_BEGIN */
 | '[' ']'
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "no initial values list defined in array initialization."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "no initial values list defined in array initialization."); context->yynerrs++;}
 | '[' error ']'
-	{$$ = NULL; print_err_msg(locf(@2), locl(@2), "invalid initial values list defined in array initialization."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "invalid initial values list defined in array initialization."); yyerrok;}
 | '[' array_initial_elements_list error
-	{$$ = NULL; print_err_msg(locl(@2), locf(@3), "']' missing at the end of array initialization."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locl(@2), locf(@3), "']' missing at the end of array initialization."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -3098,8 +3047,8 @@ array_initial_elements_list:
 /*
 | array_initial_elements_list ',' error
 	{$$ = $1;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no array initial value in array initial values list.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid array initial value in array initial values list."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no array initial value in array initial values list.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid array initial value in array initial values list."); yyclearin;}
 	 yyerrok;
 	}
 */
@@ -3115,9 +3064,9 @@ array_initial_elements:
 	{$$ = new array_initial_elements_c($1, $3, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | integer '(' error ')'
-	{$$ = NULL; print_err_msg(locf(@3), locl(@3), "invalid array initial value in array initial values list."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "invalid array initial value in array initial values list."); yyerrok;}
 | integer '(' array_initial_element error
-	{$$ = NULL; print_err_msg(locl(@3), locf(@4), "')' missing at the end of array initial value in array initial values list."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locl(@3), locf(@4), "')' missing at the end of array initial value in array initial values list."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -3133,20 +3082,15 @@ array_initial_element:
 
 structure_type_declaration:
 /*  structure_type_name ':' structure_specification */
-/* PRE_PARSING or SINGLE_PHASE_PARSING */
-/*  The following rules will be run either by:
- *      - the pre_parsing phase of two phase parsing (when preparsing command line option is chosen).
- *      - the standard single phase parser (when preparsing command line option is not chosen).
- */
-  identifier ':' structure_specification  {library_element_symtable.insert($1, prev_declared_structure_type_name_token);}
-	{if (!get_preparse_state()) $$ = new structure_type_declaration_c($1, $3, locloc(@$));}
-/* POST_PARSING */
-/*  These rules will be run after the preparser phase of two phase parsing has finished (only gets to execute if preparsing command line option is chosen). */
+/* SINGLE_PHASE_PARSING: The name was not declared by the pre-scanner (i.e. -p command line option not chosen). */
+  identifier ':' structure_specification  {context->library_element_symtable.insert($1, prev_declared_structure_type_name_token);}
+	{$$ = new structure_type_declaration_c($1, $3, locloc(@$));}
+/* FORWARD_DECLARED: The name was already declared by the pre-scanner (only when the -p command line option is chosen, see prescan.hh). */
 | prev_declared_structure_type_name ':' structure_specification
 	{$$ = new structure_type_declaration_c(new identifier_c(((token_c *)$1)->value, locloc(@1)), $3, locloc(@$));} // change the derived_datatype_identifier_c into an identifier_c, as it will be taking the place of an identifier!
 /* ERROR_CHECK_BEGIN */
 | identifier structure_specification
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "':' missing between data type name and specification in structure type declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':' missing between data type name and specification in structure type declaration."); context->yynerrs++;}
 /* ERROR_CHECK_END */
 ;
 
@@ -3164,11 +3108,11 @@ initialized_structure:
 	{$$ = new initialized_structure_c($1, $3, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | prev_declared_structure_type_name structure_initialization
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "':=' missing in structure specification with initialization."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':=' missing in structure specification with initialization."); context->yynerrs++;}
 | prev_declared_structure_type_name ASSIGN error
 	{$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no value defined in structure specification with initialization.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid value in structure specification with initialization."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no value defined in structure specification with initialization.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid value in structure specification with initialization."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -3180,13 +3124,13 @@ structure_declaration:
 	{$$ = $2;}
 /* ERROR_CHECK_BEGIN */
 | STRUCT END_STRUCT
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "no structure element declared in structure type declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "no structure element declared in structure type declaration."); context->yynerrs++;}
 | STRUCT error structure_element_declaration_list END_STRUCT
-	{$$ = NULL; print_err_msg(locf(@2), locl(@2), "unexpected token after 'STRUCT' in structure type declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "unexpected token after 'STRUCT' in structure type declaration."); yyerrok;}
 | STRUCT structure_element_declaration_list error END_OF_INPUT
-	{$$ = NULL; print_err_msg(locf(@1), locl(@1), "unclosed structure type declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@1), locl(@1), "unclosed structure type declaration."); yyerrok;}
 | STRUCT error END_STRUCT
-	{$$ = NULL; print_err_msg(locf(@2), locl(@2), "unknown error in structure type declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "unknown error in structure type declaration."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -3198,15 +3142,15 @@ structure_element_declaration_list:
 	{$$ = $1; $$->add_element($2);}
 /* ERROR_CHECK_BEGIN */
 | error ';'
-	{$$ = new structure_element_declaration_list_c(locloc(@$)); print_err_msg(locf(@1), locl(@1), "invalid structure element declaration."); yyerrok;}
+	{$$ = new structure_element_declaration_list_c(locloc(@$)); print_err_msg(context, locf(@1), locl(@1), "invalid structure element declaration."); yyerrok;}
 | structure_element_declaration error
-	{$$ = new structure_element_declaration_list_c(locloc(@$)); print_err_msg(locl(@1), locf(@2), "';' missing at end of structure element declaration."); yyerrok;}
+	{$$ = new structure_element_declaration_list_c(locloc(@$)); print_err_msg(context, locl(@1), locf(@2), "';' missing at end of structure element declaration."); yyerrok;}
 | structure_element_declaration_list structure_element_declaration error
-	{$$ = $1; print_err_msg(locl(@2), locf(@3), "';' missing at end of structure element declaration."); yyerrok;}
+	{$$ = $1; print_err_msg(context, locl(@2), locf(@3), "';' missing at end of structure element declaration."); yyerrok;}
 | structure_element_declaration_list error ';'
-	{$$ = $1; print_err_msg(locf(@2), locl(@2), "invalid structure element declaration."); yyerrok;}
+	{$$ = $1; print_err_msg(context, locf(@2), locl(@2), "invalid structure element declaration."); yyerrok;}
 | structure_element_declaration_list ';'
-	{$$ = $1; print_err_msg(locf(@2), locl(@2), "unexpected ';' after structure element declaration."); yynerrs++;}
+	{$$ = $1; print_err_msg(context, locf(@2), locl(@2), "unexpected ';' after structure element declaration."); context->yynerrs++;}
 /* ERROR_CHECK_END */
 ;
 
@@ -3224,26 +3168,26 @@ structure_element_declaration:
 	{$$ = new structure_element_declaration_c($1, $3, locloc(@$)); $$->token = $1->token;}
 | structure_element_name ':' ref_spec_init                              /* non standard extension: Allow use of struct elements storing REF_TO datatypes (either using REF_TO or a previosuly declared ref type) */
 	{ $$ = new structure_element_declaration_c($1, $3, locloc(@$));
-	  if (!allow_ref_to_in_derived_datatypes) {
-	    print_err_msg(locf(@$), locl(@$), "REF_TO and reference datatypes may not be used in a STRUCT element (use -R option to activate support for this non-standard syntax)."); 
-	    yynerrs++;
+	  if (!context->allow_ref_to_in_derived_datatypes) {
+	    print_err_msg(context, locf(@$), locl(@$), "REF_TO and reference datatypes may not be used in a STRUCT element (use -R option to activate support for this non-standard syntax)."); 
+	    context->yynerrs++;
 	  }
 	}
 /* ERROR_CHECK_BEGIN */
 | structure_element_name simple_spec_init
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "':' missing between structure element name and simple specification."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':' missing between structure element name and simple specification."); context->yynerrs++;}
 | structure_element_name subrange_spec_init
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "':' missing between structure element name and subrange specification."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':' missing between structure element name and subrange specification."); context->yynerrs++;}
 | structure_element_name enumerated_spec_init
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "':' missing between structure element name and enumerated specification."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':' missing between structure element name and enumerated specification."); context->yynerrs++;}
 | structure_element_name array_spec_init
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "':' missing between structure element name and array specification."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':' missing between structure element name and array specification."); context->yynerrs++;}
 | structure_element_name initialized_structure
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "':' missing between structure element name and structure specification."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':' missing between structure element name and structure specification."); context->yynerrs++;}
 | structure_element_name ':' error
 	{$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no specification defined in structure element declaration.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid specification in structure element declaration."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no specification defined in structure element declaration.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid specification in structure element declaration."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -3258,9 +3202,9 @@ structure_initialization:
 	{$$ = $2;}
 /* ERROR_CHECK_BEGIN */
 | '(' error ')'
-	{$$ = NULL; print_err_msg(locf(@2), locl(@2), "invalid structure element initialization list in structure initialization."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "invalid structure element initialization list in structure initialization."); yyerrok;}
 | '(' structure_element_initialization_list error
-	{$$ = NULL; print_err_msg(locl(@2), locf(@3), "expecting ')' at the end of structure element initialization list in structure initialization."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locl(@2), locf(@3), "expecting ')' at the end of structure element initialization list in structure initialization."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -3276,11 +3220,11 @@ structure_element_initialization_list:
  */
 /*
 | structure_element_initialization_list structure_element_initialization
-	{$$ = $1; print_err_msg(locl(@1), locf(@2), "',' missing in structure element initialization list in structure initialization."); yynerrs++;}
+	{$$ = $1; print_err_msg(context, locl(@1), locf(@2), "',' missing in structure element initialization list in structure initialization."); context->yynerrs++;}
 | structure_element_initialization_list ',' error
 	{$$ = $1;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no structure element initialization defined in structure initialization.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid structure element initialization in structure initialization."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no structure element initialization defined in structure initialization.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid structure element initialization in structure initialization."); yyclearin;}
 	 yyerrok;
 	}
 */
@@ -3299,17 +3243,17 @@ structure_element_initialization:
 	{$$ = new structure_element_initialization_c($1, $3, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | structure_element_name constant
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "':=' missing in structure element initialization."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':=' missing in structure element initialization."); context->yynerrs++;}
 | structure_element_name enumerated_value
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "':=' missing in enumerated structure element initialization."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':=' missing in enumerated structure element initialization."); context->yynerrs++;}
 | structure_element_name array_initialization
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "':=' missing in array structure element initialization."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':=' missing in array structure element initialization."); context->yynerrs++;}
 | structure_element_name structure_initialization
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "':=' missing in structured structure element initialization."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':=' missing in structured structure element initialization."); context->yynerrs++;}
 | structure_element_name ASSIGN error
 	{$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no initial value defined in structured structure element initialization.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid initial value in structured structure element initialization."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no initial value defined in structured structure element initialization.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid initial value in structured structure element initialization."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -3325,15 +3269,10 @@ string_type_name: identifier;
 
 string_type_declaration:
 /*  string_type_name ':' elementary_string_type_name string_type_declaration_size string_type_declaration_init */
-/* PRE_PARSING or SINGLE_PHASE_PARSING */
-/*  The following rules will be run either by:
- *      - the pre_parsing phase of two phase parsing (when preparsing command line option is chosen).
- *      - the standard single phase parser (when preparsing command line option is not chosen).
- */
-  identifier ':' elementary_string_type_name string_type_declaration_size string_type_declaration_init	{library_element_symtable.insert($1, prev_declared_string_type_name_token);}
-	{if (!get_preparse_state()) $$ = new string_type_declaration_c($1, $3, $4, $5, locloc(@$));}
-/* POST_PARSING */
-/*  These rules will be run after the preparser phase of two phase parsing has finished (only gets to execute if preparsing command line option is chosen). */
+/* SINGLE_PHASE_PARSING: The name was not declared by the pre-scanner (i.e. -p command line option not chosen). */
+  identifier ':' elementary_string_type_name string_type_declaration_size string_type_declaration_init	{context->library_element_symtable.insert($1, prev_declared_string_type_name_token);}
+	{$$ = new string_type_declaration_c($1, $3, $4, $5, locloc(@$));}
+/* FORWARD_DECLARED: The name was already declared by the pre-scanner (only when the -p command line option is chosen, see prescan.hh). */
 | prev_declared_string_type_name ':' elementary_string_type_name string_type_declaration_size string_type_declaration_init
 	{$$ = new string_type_declaration_c(new identifier_c(((token_c *)$1)->value, locloc(@1)), $3, $4, $5, locloc(@$));} // change the derived_datatype_identifier_c into an identifier_c, as it will be taking the place of an identifier!
 ;
@@ -3398,9 +3337,9 @@ ref_spec_non_recursive: /* helper symbol, used to remove a reduce/reduce conflic
 	{$$ = new ref_spec_c($2, locloc(@$));}
 | REF_TO ANY
 	{$$ = new ref_spec_c(new generic_type_any_c(locloc(@2)), locloc(@$));
-	 if (!allow_ref_to_any) {
-	   print_err_msg(locf(@$), locl(@$), "REF_TO ANY datatypes are not allowed (use -R option to activate support for this non-standard syntax)."); 
-	   yynerrs++;
+	 if (!context->allow_ref_to_any) {
+	   print_err_msg(context, locf(@$), locl(@$), "REF_TO ANY datatypes are not allowed (use -R option to activate support for this non-standard syntax)."); 
+	   context->yynerrs++;
 	 }
 	}
 ;
@@ -3460,15 +3399,10 @@ ref_spec_init: /* defined in IEC 61131-3 v3 */
 ;
 
 ref_type_decl:  /* defined in IEC 61131-3 v3 */
-/* PRE_PARSING or SINGLE_PHASE_PARSING */
-/*  The following rules will be run either by:
- *      - the pre_parsing phase of two phase parsing (when preparsing command line option is chosen).
- *      - the standard single phase parser (when preparsing command line option is not chosen).
- */
-  identifier ':' ref_spec_init  {library_element_symtable.insert($1, prev_declared_ref_type_name_token);}
-	{if (!get_preparse_state()) $$ = new ref_type_decl_c($1, $3, locloc(@$));}
-/* POST_PARSING */
-/*  These rules will be run after the preparser phase of two phase parsing has finished (only gets to execute if preparsing command line option is chosen). */
+/* SINGLE_PHASE_PARSING: The name was not declared by the pre-scanner (i.e. -p command line option not chosen). */
+  identifier ':' ref_spec_init  {context->library_element_symtable.insert($1, prev_declared_ref_type_name_token);}
+	{$$ = new ref_type_decl_c($1, $3, locloc(@$));}
+/* FORWARD_DECLARED: The name was already declared by the pre-scanner (only when the -p command line option is chosen, see prescan.hh). */
 | prev_declared_ref_type_name ':' ref_spec_init
 	{$$ = new ref_type_decl_c(new identifier_c(((token_c *)$1)->value, locloc(@1)), $3, locloc(@$));}  // change the derived_datatype_identifier_c into an identifier_c, as it will be taking the place of an identifier!
 ;
@@ -3557,9 +3491,9 @@ symbolic_variable:
 | symbolic_variable '^'     
 	/* Dereferencing operator defined in IEC 61131-3 v3. However, implemented here differently then how it is defined in the standard! See following note for explanation! */
 	{$$ = new deref_operator_c($1, locloc(@$));
-	 if (!allow_ref_dereferencing) {
-	   print_err_msg(locf(@$), locl(@$), "Derefencing REF_TO datatypes with '^' is not allowed (use -r option to activate support for this IEC 61131-3 v3 feature)."); 
-	   yynerrs++;
+	 if (!context->allow_ref_dereferencing) {
+	   print_err_msg(context, locf(@$), locl(@$), "Derefencing REF_TO datatypes with '^' is not allowed (use -r option to activate support for this IEC 61131-3 v3 feature)."); 
+	   context->yynerrs++;
 	 }
 }
 ;
@@ -3714,29 +3648,29 @@ input_declarations:
 	{$$ = new input_declarations_c(new non_retain_option_c(locloc(@2)), $3, new explicit_definition_c(), locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | VAR_INPUT END_VAR
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "no variable declared in input variable(s) declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "no variable declared in input variable(s) declaration."); context->yynerrs++;}
 | VAR_INPUT RETAIN END_VAR
-	{$$ = NULL; print_err_msg(locl(@2), locf(@3), "no variable declared in retentive input variable(s) declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@2), locf(@3), "no variable declared in retentive input variable(s) declaration."); context->yynerrs++;}
 | VAR_INPUT NON_RETAIN END_VAR
-	{$$ = NULL; print_err_msg(locl(@2), locf(@3), "no variable declared in non-retentive input variable(s) declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@2), locf(@3), "no variable declared in non-retentive input variable(s) declaration."); context->yynerrs++;}
 | VAR_INPUT error input_declaration_list END_VAR
-	{$$ = NULL; print_err_msg(locf(@2), locl(@2), "unexpected token after 'VAR_INPUT' in input variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "unexpected token after 'VAR_INPUT' in input variable(s) declaration."); yyerrok;}
 | VAR_INPUT RETAIN error input_declaration_list END_VAR
-	{$$ = NULL; print_err_msg(locf(@3), locl(@3), "unexpected token after 'RETAIN' in retentive input variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "unexpected token after 'RETAIN' in retentive input variable(s) declaration."); yyerrok;}
 | VAR_INPUT NON_RETAIN error input_declaration_list END_VAR
-	{$$ = NULL; print_err_msg(locf(@3), locl(@3), "unexpected token after 'NON_RETAIN' in non-retentive input variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "unexpected token after 'NON_RETAIN' in non-retentive input variable(s) declaration."); yyerrok;}
 | VAR_INPUT input_declaration_list error END_OF_INPUT
-	{$$ = NULL; print_err_msg(locf(@1), locl(@1), "unclosed input variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@1), locl(@1), "unclosed input variable(s) declaration."); yyerrok;}
 | VAR_INPUT RETAIN input_declaration_list error END_OF_INPUT
-	{$$ = NULL; print_err_msg(locf(@1), locl(@2), "unclosed retentive input variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@1), locl(@2), "unclosed retentive input variable(s) declaration."); yyerrok;}
 | VAR_INPUT NON_RETAIN input_declaration_list error END_OF_INPUT
-	{$$ = NULL; print_err_msg(locf(@1), locl(@2), "unclosed non-retentive input variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@1), locl(@2), "unclosed non-retentive input variable(s) declaration."); yyerrok;}
 | VAR_INPUT error END_VAR
-	{$$ = NULL; print_err_msg(locf(@2), locl(@2), "unknown error in input variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "unknown error in input variable(s) declaration."); yyerrok;}
 | VAR_INPUT RETAIN error END_VAR
-	{$$ = NULL; print_err_msg(locf(@3), locl(@3), "unknown error in retentive input variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "unknown error in retentive input variable(s) declaration."); yyerrok;}
 | VAR_INPUT NON_RETAIN error END_VAR
-	{$$ = NULL; print_err_msg(locf(@3), locl(@3), "unknown error in non-retentive input variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "unknown error in non-retentive input variable(s) declaration."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -3748,15 +3682,15 @@ input_declaration_list:
 	{$$ = $1; $$->add_element($2);}
 /* ERROR_CHECK_BEGIN */
 | error ';'
-	{$$ = new input_declaration_list_c(locloc(@$)); print_err_msg(locf(@1), locl(@1), "invalid input variable(s) declaration."); yyerrok;}
+	{$$ = new input_declaration_list_c(locloc(@$)); print_err_msg(context, locf(@1), locl(@1), "invalid input variable(s) declaration."); yyerrok;}
 | input_declaration error
-	{$$ = new input_declaration_list_c(locloc(@$)); print_err_msg(locl(@1), locf(@2), "';' missing at end of input variable(s) declaration."); yyerrok;}
+	{$$ = new input_declaration_list_c(locloc(@$)); print_err_msg(context, locl(@1), locf(@2), "';' missing at end of input variable(s) declaration."); yyerrok;}
 | input_declaration_list input_declaration error
-	{$$ = $1; print_err_msg(locl(@2), locf(@3), "';' missing at end of input variable(s) declaration."); yyerrok;}
+	{$$ = $1; print_err_msg(context, locl(@2), locf(@3), "';' missing at end of input variable(s) declaration."); yyerrok;}
 | input_declaration_list error ';'
-	{$$ = $1; print_err_msg(locf(@2), locl(@2), "invalid input variable(s) declaration."); yyerrok;}
+	{$$ = $1; print_err_msg(context, locf(@2), locl(@2), "invalid input variable(s) declaration."); yyerrok;}
 | input_declaration_list ';'
-	{$$ = $1; print_err_msg(locf(@2), locl(@2), "unexpected ';' after input variable(s) declaration."); yynerrs++;}
+	{$$ = $1; print_err_msg(context, locf(@2), locl(@2), "unexpected ';' after input variable(s) declaration."); context->yynerrs++;}
 /* ERROR_CHECK_END */
 ;
 
@@ -3780,17 +3714,17 @@ edge_declaration:
 	{$$ = new edge_declaration_c(new falling_edge_option_c(locloc(@3)), $1, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | var1_list BOOL R_EDGE
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "':' missing between variable list and specification in edge declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':' missing between variable list and specification in edge declaration."); context->yynerrs++;}
 | var1_list BOOL F_EDGE
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "':' missing between variable list and specification in edge declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':' missing between variable list and specification in edge declaration."); context->yynerrs++;}
 | var1_list ':' BOOL R_EDGE F_EDGE
-	{$$ = NULL; print_err_msg(locl(@5), locf(@5), "'R_EDGE' and 'F_EDGE' can't be present at the same time in edge declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@5), locf(@5), "'R_EDGE' and 'F_EDGE' can't be present at the same time in edge declaration."); context->yynerrs++;}
 | var1_list ':' BOOL F_EDGE R_EDGE
-	{$$ = NULL; print_err_msg(locl(@5), locf(@5), "'R_EDGE' and 'F_EDGE' can't be present at the same time in edge declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@5), locf(@5), "'R_EDGE' and 'F_EDGE' can't be present at the same time in edge declaration."); context->yynerrs++;}
 | var1_list ':' R_EDGE
-	{$$ = NULL; print_err_msg(locl(@2), locf(@3), "'BOOL' missing in edge declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@2), locf(@3), "'BOOL' missing in edge declaration."); context->yynerrs++;}
 | var1_list ':' F_EDGE
-	{$$ = NULL; print_err_msg(locl(@2), locf(@3), "'BOOL' missing in edge declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@2), locf(@3), "'BOOL' missing in edge declaration."); context->yynerrs++;}
 /* ERROR_CHECK_END */
 ;
 
@@ -3810,17 +3744,17 @@ en_param_declaration:
   {$$ = new en_param_declaration_c($1, new simple_spec_init_c(new bool_type_name_c(locloc(@3)), $5, locf(@3), locl(@5)), new explicit_definition_c(), locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | en_identifier BOOL ASSIGN boolean_literal
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "':' missing between variable list and specification in EN declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':' missing between variable list and specification in EN declaration."); context->yynerrs++;}
 | en_identifier BOOL ASSIGN integer
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "':' missing between variable list and specification in EN declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':' missing between variable list and specification in EN declaration."); context->yynerrs++;}
 | en_identifier ':' ASSIGN boolean_literal
-  {$$ = NULL; print_err_msg(locl(@2), locf(@3), "'BOOL' missing in EN declaration."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@2), locf(@3), "'BOOL' missing in EN declaration."); context->yynerrs++;}
 | en_identifier ':' ASSIGN integer
-	{$$ = NULL; print_err_msg(locl(@2), locf(@3), "'BOOL' missing in EN declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@2), locf(@3), "'BOOL' missing in EN declaration."); context->yynerrs++;}
 | en_identifier ':' BOOL ASSIGN error
 	{$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no specification defined in EN declaration.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid specification in EN declaration."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no specification defined in EN declaration.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid specification in EN declaration."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -3848,15 +3782,15 @@ var1_init_decl:
 	{$$ = new var1_init_decl_c($1, $3, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | var1_list simple_spec_init
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "':' missing between variable list and simple specification."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':' missing between variable list and simple specification."); context->yynerrs++;}
 | var1_list subrange_spec_init
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "':' missing between variable list and subrange specification."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':' missing between variable list and subrange specification."); context->yynerrs++;}
 | var1_list enumerated_spec_init
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "':' missing between variable list and enumerated specification."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':' missing between variable list and enumerated specification."); context->yynerrs++;}
 | var1_list ':' error
 	{$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no specification defined in variable declaration.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid specification in variable declaration."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no specification defined in variable declaration.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid specification in variable declaration."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -3889,29 +3823,29 @@ var1_init_decl:
 var1_list:
   variable_name
 	{$$ = new var1_list_c(locloc(@$)); $$->add_element($1);
-	 variable_name_symtable.insert($1, prev_declared_variable_name_token);
+	 context->variable_name_symtable.insert($1, prev_declared_variable_name_token);
 	}
 | variable_name integer DOTDOT
 	{$$ = new var1_list_c(locloc(@$)); $$->add_element(new extensible_input_parameter_c($1, $2, locloc(@$)));
-	 variable_name_symtable.insert($1, prev_declared_variable_name_token);
-	 if (!allow_extensible_function_parameters) print_err_msg(locf(@1), locl(@2), "invalid syntax in variable name declaration.");
+	 context->variable_name_symtable.insert($1, prev_declared_variable_name_token);
+	 if (!context->allow_extensible_function_parameters) print_err_msg(context, locf(@1), locl(@2), "invalid syntax in variable name declaration.");
 	}
  | var1_list ',' variable_name
 	{$$ = $1; $$->add_element($3);
-	 variable_name_symtable.insert($3, prev_declared_variable_name_token);
+	 context->variable_name_symtable.insert($3, prev_declared_variable_name_token);
 	}
  | var1_list ',' variable_name integer DOTDOT
 	{$$ = $1; $$->add_element(new extensible_input_parameter_c($3, $4, locloc(@$)));
-	 variable_name_symtable.insert($3, prev_declared_variable_name_token);
-	 if (!allow_extensible_function_parameters) print_err_msg(locf(@1), locl(@2), "invalid syntax in variable name declaration.");
+	 context->variable_name_symtable.insert($3, prev_declared_variable_name_token);
+	 if (!context->allow_extensible_function_parameters) print_err_msg(context, locf(@1), locl(@2), "invalid syntax in variable name declaration.");
 	}
 /* ERROR_CHECK_BEGIN */
 | var1_list variable_name
-	{$$ = $1; print_err_msg(locl(@1), locf(@2), "',' missing in variable list."); yynerrs++;}
+	{$$ = $1; print_err_msg(context, locl(@1), locf(@2), "',' missing in variable list."); context->yynerrs++;}
 | var1_list ',' error
 	{$$ = $1;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no variable name defined in variable declaration.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid variable name in variable declaration."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no variable name defined in variable declaration.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid variable name in variable declaration."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -3924,7 +3858,7 @@ array_var_init_decl:
 	{$$ = new array_var_init_decl_c($1, $3, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | var1_list array_spec_init
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "':' missing between variable list and array specification."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':' missing between variable list and array specification."); context->yynerrs++;}
 /* ERROR_CHECK_END */
 ;
 
@@ -3934,7 +3868,7 @@ structured_var_init_decl:
 	{$$ = new structured_var_init_decl_c($1, $3, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | var1_list initialized_structure
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "':' missing between variable list and structured specification."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':' missing between variable list and structured specification."); context->yynerrs++;}
 /* ERROR_CHECK_END */
 ;
 
@@ -3953,13 +3887,13 @@ fb_name_decl:
 	{$$ = new fb_name_decl_c($1, new fb_spec_init_c($2, $4, locf(@2), locl(@4)), locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | fb_name_list_with_colon ASSIGN structure_initialization
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "no function block type name defined in function block declaration with initialization."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "no function block type name defined in function block declaration with initialization."); context->yynerrs++;}
 | fb_name_list_with_colon function_block_type_name structure_initialization
-	{$$ = NULL; print_err_msg(locl(@2), locf(@3), "':=' missing in function block declaration with initialization."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@2), locf(@3), "':=' missing in function block declaration with initialization."); context->yynerrs++;}
 | fb_name_list_with_colon function_block_type_name ASSIGN error
 	{$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@3), locf(@4), "no initialization defined in function block declaration.");}
-	 else {print_err_msg(locf(@4), locl(@4), "invalid initialization in function block declaration."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@3), locf(@4), "no initialization defined in function block declaration.");}
+	 else {print_err_msg(context, locf(@4), locl(@4), "invalid initialization in function block declaration."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -3982,12 +3916,12 @@ fb_name_list:
  (*  fb_name *)
   identifier
 	{$$ = new fb_name_list_c($1);
-	 variable_name_symtable.insert($1, prev_declared_fb_name_token);
+	 context->variable_name_symtable.insert($1, prev_declared_fb_name_token);
 	}
 (* | fb_name_list ',' fb_name *)
 | fb_name_list ',' identifier
 	{$$ = $1; $$->add_element($3);
-	 variable_name_symtable.insert($3, prev_declared_fb_name_token);
+	 context->variable_name_symtable.insert($3, prev_declared_fb_name_token);
 	}
 ;
 */
@@ -4004,7 +3938,7 @@ fb_name_list_with_colon:
 	  * the variable name symbol table from prev_declared_variable_name_token
 	  * to prev_declared_fb_name_token
 	  */
-	 FOR_EACH_ELEMENT(elem, $$, {variable_name_symtable.set(elem, prev_declared_fb_name_token);});
+	 FOR_EACH_ELEMENT(elem, $$, {context->variable_name_symtable.set(elem, prev_declared_fb_name_token);});
 	}
 ;
 
@@ -4027,29 +3961,29 @@ output_declarations:
 	{$$ = new output_declarations_c(new non_retain_option_c(locloc(@2)), $3, new explicit_definition_c(), locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | VAR_OUTPUT END_VAR
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "no variable declared in output variable(s) declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "no variable declared in output variable(s) declaration."); context->yynerrs++;}
 | VAR_OUTPUT RETAIN END_VAR
-	{$$ = NULL; print_err_msg(locl(@2), locf(@3), "no variable declared in retentive output variable(s) declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@2), locf(@3), "no variable declared in retentive output variable(s) declaration."); context->yynerrs++;}
 | VAR_OUTPUT NON_RETAIN END_VAR
-	{$$ = NULL; print_err_msg(locl(@2), locf(@3), "no variable declared in non-retentive output variable(s) declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@2), locf(@3), "no variable declared in non-retentive output variable(s) declaration."); context->yynerrs++;}
 | VAR_OUTPUT error var_output_init_decl_list END_VAR
-	{$$ = NULL; print_err_msg(locf(@2), locl(@2), "unexpected token after 'VAR_OUPUT' in output variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "unexpected token after 'VAR_OUPUT' in output variable(s) declaration."); yyerrok;}
 | VAR_OUTPUT RETAIN error var_output_init_decl_list END_VAR
-	{$$ = NULL; print_err_msg(locf(@3), locl(@3), "unexpected token after 'RETAIN' in retentive output variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "unexpected token after 'RETAIN' in retentive output variable(s) declaration."); yyerrok;}
 | VAR_OUTPUT NON_RETAIN error var_output_init_decl_list END_VAR
-	{$$ = NULL; print_err_msg(locf(@3), locl(@3), "unexpected token after 'NON_RETAIN' in non-retentive output variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "unexpected token after 'NON_RETAIN' in non-retentive output variable(s) declaration."); yyerrok;}
 | VAR_OUTPUT var_output_init_decl_list error END_OF_INPUT
-	{$$ = NULL; print_err_msg(locf(@1), locl(@1), "unclosed output variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@1), locl(@1), "unclosed output variable(s) declaration."); yyerrok;}
 | VAR_OUTPUT RETAIN var_output_init_decl_list error END_OF_INPUT
-	{$$ = NULL; print_err_msg(locf(@1), locl(@2), "unclosed retentive output variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@1), locl(@2), "unclosed retentive output variable(s) declaration."); yyerrok;}
 | VAR_OUTPUT NON_RETAIN var_output_init_decl_list error END_OF_INPUT
-	{$$ = NULL; print_err_msg(locf(@1), locl(@2), "unclosed non-retentive output variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@1), locl(@2), "unclosed non-retentive output variable(s) declaration."); yyerrok;}
 | VAR_OUTPUT error END_VAR
-	{$$ = NULL; print_err_msg(locf(@2), locl(@2), "unknown error in output variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "unknown error in output variable(s) declaration."); yyerrok;}
 | VAR_OUTPUT RETAIN error END_VAR
-	{$$ = NULL; print_err_msg(locf(@3), locl(@3), "unknown error in retentive output variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "unknown error in retentive output variable(s) declaration."); yyerrok;}
 | VAR_OUTPUT NON_RETAIN error END_VAR
-	{$$ = NULL; print_err_msg(locf(@3), locl(@3), "unknown error in non-retentive output variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "unknown error in non-retentive output variable(s) declaration."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -4073,9 +4007,9 @@ var_output_init_decl_list:
 	{$$ = $1; $$->add_element($2);}
 /* ERROR_CHECK_BEGIN */
 | var_output_init_decl_list var_output_init_decl error
-	{$$ = $1; print_err_msg(locl(@2), locf(@3), "';' missing at end of variable(s) declaration."); yyerrok;}
+	{$$ = $1; print_err_msg(context, locl(@2), locf(@3), "';' missing at end of variable(s) declaration."); yyerrok;}
 | var_output_init_decl_list error ';'
-	{$$ = $1; print_err_msg(locf(@2), locl(@2), "invalid variable(s) declaration."); yyerrok;}
+	{$$ = $1; print_err_msg(context, locf(@2), locl(@2), "invalid variable(s) declaration."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -4096,11 +4030,11 @@ eno_param_declaration:
   {$$ = new eno_param_declaration_c($1, new bool_type_name_c(locloc(@$)), new explicit_definition_c(), locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | eno_identifier BOOL
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "':' missing between variable list and specification in ENO declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':' missing between variable list and specification in ENO declaration."); context->yynerrs++;}
 | eno_identifier ':' error
 	{$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no specification defined in ENO declaration.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid specification in ENO declaration."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no specification defined in ENO declaration.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid specification in ENO declaration."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -4112,13 +4046,13 @@ input_output_declarations:
 	{$$ = new input_output_declarations_c($2, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | VAR_IN_OUT END_VAR
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "no variable declared in in_out variable(s) declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "no variable declared in in_out variable(s) declaration."); context->yynerrs++;}
 | VAR_IN_OUT error var_declaration_list END_VAR
-	{$$ = NULL; print_err_msg(locf(@2), locl(@2), "unexpected token after 'VAR_IN_OUT' in in_out variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "unexpected token after 'VAR_IN_OUT' in in_out variable(s) declaration."); yyerrok;}
 | VAR_IN_OUT var_declaration_list error END_OF_INPUT
-	{$$ = NULL; print_err_msg(locf(@1), locl(@1), "unclosed in_out variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@1), locl(@1), "unclosed in_out variable(s) declaration."); yyerrok;}
 | VAR_IN_OUT error END_VAR
-	{$$ = NULL; print_err_msg(locf(@2), locl(@2), "unknown error in in_out variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "unknown error in in_out variable(s) declaration."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -4132,15 +4066,15 @@ var_declaration_list:
 	{$$ = $1; $$->add_element($2);}
 /* ERROR_CHECK_BEGIN */
 | error ';'
-	{$$ = new var_declaration_list_c(locloc(@$)); print_err_msg(locf(@1), locl(@1), "invalid variable(s) declaration."); yyerrok;}
+	{$$ = new var_declaration_list_c(locloc(@$)); print_err_msg(context, locf(@1), locl(@1), "invalid variable(s) declaration."); yyerrok;}
 | var_declaration error
-	{$$ = new var_declaration_list_c(locloc(@$)); print_err_msg(locl(@1), locf(@2), "';' missing at end of variable(s) declaration."); yyerrok;}
+	{$$ = new var_declaration_list_c(locloc(@$)); print_err_msg(context, locl(@1), locf(@2), "';' missing at end of variable(s) declaration."); yyerrok;}
 | var_declaration_list var_declaration error
-	{$$ = $1; print_err_msg(locl(@2), locf(@3), "';' missing at end of variable(s) declaration."); yyerrok;}
+	{$$ = $1; print_err_msg(context, locl(@2), locf(@3), "';' missing at end of variable(s) declaration."); yyerrok;}
 | var_declaration_list error ';'
-	{$$ = $1; print_err_msg(locf(@2), locl(@2), "invalid variable(s) declaration."); yyerrok;}
+	{$$ = $1; print_err_msg(context, locf(@2), locl(@2), "invalid variable(s) declaration."); yyerrok;}
 | var_declaration_list ';'
-	{$$ = $1; print_err_msg(locf(@2), locl(@2), "unexpected ';' after variable(s) declaration."); yynerrs++;}
+	{$$ = $1; print_err_msg(context, locf(@2), locl(@2), "unexpected ';' after variable(s) declaration."); context->yynerrs++;}
 /* ERROR_CHECK_END */
 ;
 
@@ -4169,11 +4103,11 @@ var1_declaration:
 	{$$ = new var1_init_decl_c($1, $3, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | var1_list simple_specification
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "':' missing between variable list and simple specification."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':' missing between variable list and simple specification."); context->yynerrs++;}
 | var1_list subrange_specification
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "':' missing between variable list and subrange specification."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':' missing between variable list and subrange specification."); context->yynerrs++;}
 | var1_list enumerated_specification
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "':' missing between variable list and enumerated specification."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':' missing between variable list and enumerated specification."); context->yynerrs++;}
 /* ERROR_CHECK_END */
 ;
 
@@ -4184,7 +4118,7 @@ array_var_declaration:
 	{$$ = new array_var_declaration_c($1, $3, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | var1_list array_specification
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "':' missing between variable list and array specification."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':' missing between variable list and array specification."); context->yynerrs++;}
 /* ERROR_CHECK_END */
 ;
 
@@ -4193,7 +4127,7 @@ structured_var_declaration:
 	{$$ = new structured_var_declaration_c($1, $3, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | var1_list prev_declared_structure_type_name
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "':' missing between variable list and structured specification."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':' missing between variable list and structured specification."); context->yynerrs++;}
 /* ERROR_CHECK_END */
 ;
 
@@ -4205,21 +4139,21 @@ var_declarations:
 	{$$ = new var_declarations_c(new constant_option_c(locloc(@2)), $3, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | VAR END_VAR
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "no variable declared in variable(s) declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "no variable declared in variable(s) declaration."); context->yynerrs++;}
 | VAR CONSTANT END_VAR
-	{$$ = NULL; print_err_msg(locl(@2), locf(@3), "no variable declared in constant variable(s) declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@2), locf(@3), "no variable declared in constant variable(s) declaration."); context->yynerrs++;}
 | VAR error var_init_decl_list END_VAR
-	{$$ = NULL; print_err_msg(locl(@1), locf(@3), "unexpected token after 'VAR' in variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@3), "unexpected token after 'VAR' in variable(s) declaration."); yyerrok;}
 | VAR CONSTANT error var_init_decl_list END_VAR
-	{$$ = NULL; print_err_msg(locf(@3), locl(@3), "unexpected token after 'CONSTANT' in constant variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "unexpected token after 'CONSTANT' in constant variable(s) declaration."); yyerrok;}
 | VAR var_init_decl_list error END_OF_INPUT
-	{$$ = NULL; print_err_msg(locf(@1), locl(@1), "unclosed variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@1), locl(@1), "unclosed variable(s) declaration."); yyerrok;}
 | VAR CONSTANT var_init_decl_list error END_OF_INPUT
-	{$$ = NULL; print_err_msg(locf(@1), locl(@2), "unclosed constant variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@1), locl(@2), "unclosed constant variable(s) declaration."); yyerrok;}
 | VAR error END_VAR
-	{$$ = NULL; print_err_msg(locf(@2), locl(@2), "unknown error in variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "unknown error in variable(s) declaration."); yyerrok;}
 | VAR CONSTANT error END_VAR
-	{$$ = NULL; print_err_msg(locf(@3), locl(@3), "unknown error in constant variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "unknown error in constant variable(s) declaration."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -4229,13 +4163,13 @@ retentive_var_declarations:
 	{$$ = new retentive_var_declarations_c($3, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | VAR RETAIN END_VAR
-	{$$ = NULL; print_err_msg(locl(@2), locf(@3), "no variable declared in retentive variable(s) declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@2), locf(@3), "no variable declared in retentive variable(s) declaration."); context->yynerrs++;}
 | VAR RETAIN error var_init_decl_list END_VAR
-	{$$ = NULL; print_err_msg(locf(@3), locl(@3), "unexpected token after 'RETAIN' in retentive variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "unexpected token after 'RETAIN' in retentive variable(s) declaration."); yyerrok;}
 | VAR RETAIN var_init_decl_list error END_OF_INPUT
-	{$$ = NULL; print_err_msg(locf(@1), locl(@2), "unclosed retentive variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@1), locl(@2), "unclosed retentive variable(s) declaration."); yyerrok;}
 | VAR RETAIN error END_VAR
-	{$$ = NULL; print_err_msg(locf(@3), locl(@3), "unknown error in retentive variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "unknown error in retentive variable(s) declaration."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -4251,25 +4185,25 @@ located_var_declarations:
 	{$$ = new located_var_declarations_c(new non_retain_option_c(locloc(@2)), $3, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | VAR NON_RETAIN END_VAR
-	{$$ = NULL; print_err_msg(locl(@2), locf(@3), "no variable declared in non-retentive located variable(s) declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@2), locf(@3), "no variable declared in non-retentive located variable(s) declaration."); context->yynerrs++;}
 | VAR error located_var_decl_list END_VAR
-	{$$ = NULL; print_err_msg(locf(@2), locl(@2), "unexpected token after 'VAR' in located variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "unexpected token after 'VAR' in located variable(s) declaration."); yyerrok;}
 | VAR CONSTANT error located_var_decl_list END_VAR
-	{$$ = NULL; print_err_msg(locf(@3), locl(@3), "unexpected token after 'CONSTANT' in constant located variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "unexpected token after 'CONSTANT' in constant located variable(s) declaration."); yyerrok;}
 | VAR RETAIN error located_var_decl_list END_VAR
-	{$$ = NULL; print_err_msg(locf(@3), locl(@3), "unexpected token after 'RETAIN' in retentive located variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "unexpected token after 'RETAIN' in retentive located variable(s) declaration."); yyerrok;}
 | VAR NON_RETAIN error located_var_decl_list END_VAR
-	{$$ = NULL; print_err_msg(locf(@3), locl(@3), "unexpected token after 'NON_RETAIN' in non-retentive located variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "unexpected token after 'NON_RETAIN' in non-retentive located variable(s) declaration."); yyerrok;}
 | VAR located_var_decl_list error END_OF_INPUT
-	{$$ = NULL; print_err_msg(locf(@1), locl(@1), "unclosed located variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@1), locl(@1), "unclosed located variable(s) declaration."); yyerrok;}
 | VAR CONSTANT located_var_decl_list error END_OF_INPUT
-	{$$ = NULL; print_err_msg(locf(@1), locl(@2), "unclosed constant located variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@1), locl(@2), "unclosed constant located variable(s) declaration."); yyerrok;}
 | VAR RETAIN located_var_decl_list error END_OF_INPUT
-	{$$ = NULL; print_err_msg(locf(@1), locl(@2), "unclosed retentive located variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@1), locl(@2), "unclosed retentive located variable(s) declaration."); yyerrok;}
 | VAR NON_RETAIN located_var_decl_list error END_OF_INPUT
-	{$$ = NULL; print_err_msg(locf(@1), locl(@2), "unclosed non-retentive located variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@1), locl(@2), "unclosed non-retentive located variable(s) declaration."); yyerrok;}
 | VAR NON_RETAIN error END_VAR
-	{$$ = NULL; print_err_msg(locf(@3), locl(@3), "unknown error in non retentive variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "unknown error in non retentive variable(s) declaration."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -4282,15 +4216,15 @@ located_var_decl_list:
 	{$$ = $1; $$->add_element($2);}
 /* ERROR_CHECK_BEGIN */
 | error ';'
-	{$$ = new located_var_decl_list_c(locloc(@$)); print_err_msg(locf(@1), locl(@1), "invalid located variable declaration."); yyerrok;}
+	{$$ = new located_var_decl_list_c(locloc(@$)); print_err_msg(context, locf(@1), locl(@1), "invalid located variable declaration."); yyerrok;}
 | located_var_decl error
-	{$$ = new located_var_decl_list_c(locloc(@$)); print_err_msg(locl(@1), locf(@2), "';' missing at end of located variable declaration."); yyerrok;}
+	{$$ = new located_var_decl_list_c(locloc(@$)); print_err_msg(context, locl(@1), locf(@2), "';' missing at end of located variable declaration."); yyerrok;}
 | located_var_decl_list located_var_decl error
-	{$$ = $1; print_err_msg(locl(@2), locf(@3), "';' missing at end of located variable declaration."); yyerrok;}
+	{$$ = $1; print_err_msg(context, locl(@2), locf(@3), "';' missing at end of located variable declaration."); yyerrok;}
 | located_var_decl_list error ';'
-	{$$ = $1; print_err_msg(locf(@2), locl(@2), "invalid located variable declaration."); yyerrok;}
+	{$$ = $1; print_err_msg(context, locf(@2), locl(@2), "invalid located variable declaration."); yyerrok;}
 | located_var_decl_list ';'
-	{$$ = $1; print_err_msg(locf(@2), locl(@2), "unexpected ';' after located variable declaration."); yynerrs++;}
+	{$$ = $1; print_err_msg(context, locf(@2), locl(@2), "unexpected ';' after located variable declaration."); context->yynerrs++;}
 /* ERROR_CHECK_END */
 ;
 
@@ -4298,25 +4232,25 @@ located_var_decl_list:
 located_var_decl:
   variable_name location ':' located_var_spec_init
 	{$$ = new located_var_decl_c($1, $2, $4, locloc(@$));
-	 variable_name_symtable.insert($1, prev_declared_variable_name_token);
+	 context->variable_name_symtable.insert($1, prev_declared_variable_name_token);
 	}
 | location ':' located_var_spec_init
 	{$$ = new located_var_decl_c(NULL, $1, $3, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | variable_name location located_var_spec_init
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "':' missing between located variable location and specification."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':' missing between located variable location and specification."); context->yynerrs++;}
 | location located_var_spec_init
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "':' missing between located variable location and specification."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':' missing between located variable location and specification."); context->yynerrs++;}
 | variable_name location ':' error
 	{$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no specification defined in located variable declaration.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid specification in located variable declaration."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no specification defined in located variable declaration.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid specification in located variable declaration."); yyclearin;}
 	 yyerrok;
 	}
 | location ':' error
 	{$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no specification defined in located variable declaration.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid specification in located variable declaration."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no specification defined in located variable declaration.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid specification in located variable declaration."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -4332,21 +4266,21 @@ external_var_declarations:
 	{$$ = new external_var_declarations_c(new constant_option_c(locloc(@2)), $3, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | VAR_EXTERNAL END_VAR
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "no variable declared in external variable(s) declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "no variable declared in external variable(s) declaration."); context->yynerrs++;}
 | VAR_EXTERNAL CONSTANT END_VAR
-	{$$ = NULL; print_err_msg(locl(@2), locf(@3), "no variable declared in constant external variable(s) declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@2), locf(@3), "no variable declared in constant external variable(s) declaration."); context->yynerrs++;}
 | VAR_EXTERNAL error external_declaration_list END_VAR
-	{$$ = NULL; print_err_msg(locf(@2), locl(@2), "unexpected token after 'VAR_EXTERNAL' in external variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "unexpected token after 'VAR_EXTERNAL' in external variable(s) declaration."); yyerrok;}
 | VAR_EXTERNAL CONSTANT error external_declaration_list END_VAR
-	{$$ = NULL; print_err_msg(locf(@3), locl(@3), "unexpected token after 'CONSTANT' in constant external variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "unexpected token after 'CONSTANT' in constant external variable(s) declaration."); yyerrok;}
 | VAR_EXTERNAL external_declaration_list error END_OF_INPUT
-	{$$ = NULL; print_err_msg(locf(@1), locl(@1), "unclosed external variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@1), locl(@1), "unclosed external variable(s) declaration."); yyerrok;}
 | VAR_EXTERNAL CONSTANT external_declaration_list error END_OF_INPUT
-	{$$ = NULL; print_err_msg(locf(@1), locl(@2), "unclosed constant external variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@1), locl(@2), "unclosed constant external variable(s) declaration."); yyerrok;}
 | VAR_EXTERNAL error END_VAR
-	{$$ = NULL; print_err_msg(locf(@2), locl(@2), "unknown error in external variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "unknown error in external variable(s) declaration."); yyerrok;}
 | VAR_EXTERNAL CONSTANT error END_VAR
-	{$$ = NULL; print_err_msg(locf(@3), locl(@3), "unknown error in constant external variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "unknown error in constant external variable(s) declaration."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -4358,15 +4292,15 @@ external_declaration_list:
 	{$$ = $1; $$->add_element($2);}
 /* ERROR_CHECK_BEGIN */
 | error ';'
-	{$$ = new external_declaration_list_c(locloc(@$)); print_err_msg(locf(@1), locl(@1), "invalid external variable declaration."); yyerrok;}
+	{$$ = new external_declaration_list_c(locloc(@$)); print_err_msg(context, locf(@1), locl(@1), "invalid external variable declaration."); yyerrok;}
 | external_declaration error
-	{$$ = new external_declaration_list_c(locloc(@$)); print_err_msg(locl(@1), locf(@2), "';' missing at end of external variable declaration."); yyerrok;}
+	{$$ = new external_declaration_list_c(locloc(@$)); print_err_msg(context, locl(@1), locf(@2), "';' missing at end of external variable declaration."); yyerrok;}
 | external_declaration_list external_declaration error
-	{$$ = $1; print_err_msg(locl(@2), locf(@3), "';' missing at end of external variable declaration."); yyerrok;}
+	{$$ = $1; print_err_msg(context, locl(@2), locf(@3), "';' missing at end of external variable declaration."); yyerrok;}
 | external_declaration_list error ';'
-	{$$ = $1; print_err_msg(locf(@2), locl(@2), "invalid external variable declaration."); yyerrok;}
+	{$$ = $1; print_err_msg(context, locf(@2), locl(@2), "invalid external variable declaration."); yyerrok;}
 | external_declaration_list ';'
-	{$$ = $1; print_err_msg(locf(@2), locl(@2), "unexpected ';' after external variable declaration."); yynerrs++;}
+	{$$ = $1; print_err_msg(context, locf(@2), locl(@2), "unexpected ';' after external variable declaration."); context->yynerrs++;}
 /* ERROR_CHECK_END */
 ;
 
@@ -4386,49 +4320,49 @@ external_declaration_list:
 external_declaration:
   global_var_name ':' simple_specification
 	{$$ = new external_declaration_c($1, $3, locloc(@$));
-	 variable_name_symtable.insert($1, prev_declared_variable_name_token);
+	 context->variable_name_symtable.insert($1, prev_declared_variable_name_token);
 	}
 | global_var_name ':' subrange_specification
 	{$$ = new external_declaration_c($1, $3, locloc(@$));
-	 variable_name_symtable.insert($1, prev_declared_variable_name_token);
+	 context->variable_name_symtable.insert($1, prev_declared_variable_name_token);
 	}
 | global_var_name ':' enumerated_specification
 	{$$ = new external_declaration_c($1, $3, locloc(@$));
-	 variable_name_symtable.insert($1, prev_declared_variable_name_token);
+	 context->variable_name_symtable.insert($1, prev_declared_variable_name_token);
 	}
 | global_var_name ':' array_specification
 	{$$ = new external_declaration_c($1, $3, locloc(@$));
-	 variable_name_symtable.insert($1, prev_declared_variable_name_token);
+	 context->variable_name_symtable.insert($1, prev_declared_variable_name_token);
 	}
 | global_var_name ':' prev_declared_structure_type_name
 	{$$ = new external_declaration_c($1, $3, locloc(@$));
-	 variable_name_symtable.insert($1, prev_declared_variable_name_token);
+	 context->variable_name_symtable.insert($1, prev_declared_variable_name_token);
 	}
 | global_var_name ':' function_block_type_name
 	{$$ = new external_declaration_c($1, new fb_spec_init_c($3, NULL, locloc(@3)), locloc(@$));
-	 variable_name_symtable.insert($1, prev_declared_fb_name_token);
+	 context->variable_name_symtable.insert($1, prev_declared_fb_name_token);
 	}
 | global_var_name ':' ref_spec /* defined in IEC 61131-3 v3   (REF_TO ...)*/
 	{$$ = new external_declaration_c($1, $3, locloc(@$));
-	 variable_name_symtable.insert($1, prev_declared_fb_name_token);
+	 context->variable_name_symtable.insert($1, prev_declared_fb_name_token);
 	}
 /* ERROR_CHECK_BEGIN */
 | global_var_name simple_specification
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "':' missing between external variable name and simple specification."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':' missing between external variable name and simple specification."); context->yynerrs++;}
 | global_var_name subrange_specification
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "':' missing between external variable name and subrange specification."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':' missing between external variable name and subrange specification."); context->yynerrs++;}
 | global_var_name enumerated_specification
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "':' missing between external variable name and enumerated specification."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':' missing between external variable name and enumerated specification."); context->yynerrs++;}
 | global_var_name array_specification
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "':' missing between external variable name and array specification."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':' missing between external variable name and array specification."); context->yynerrs++;}
 | global_var_name prev_declared_structure_type_name
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "':' missing between external variable name and structured specification."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':' missing between external variable name and structured specification."); context->yynerrs++;}
 | global_var_name function_block_type_name
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "':' missing between external variable name and function block type specification."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':' missing between external variable name and function block type specification."); context->yynerrs++;}
 | global_var_name ':' error
 	{$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no specification defined in external variable declaration.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid specification in external variable declaration."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no specification defined in external variable declaration.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid specification in external variable declaration."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -4447,29 +4381,29 @@ global_var_declarations:
 	{$$ = new global_var_declarations_c(new retain_option_c(locloc(@2)), $3, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | VAR_GLOBAL END_VAR
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "no variable declared in global variable(s) declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "no variable declared in global variable(s) declaration."); context->yynerrs++;}
 | VAR_GLOBAL CONSTANT END_VAR
-	{$$ = NULL; print_err_msg(locl(@2), locf(@3), "no variable declared in constant global variable(s) declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@2), locf(@3), "no variable declared in constant global variable(s) declaration."); context->yynerrs++;}
 | VAR_GLOBAL RETAIN END_VAR
-	{$$ = NULL; print_err_msg(locl(@2), locf(@3), "no variable declared in retentive global variable(s) declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@2), locf(@3), "no variable declared in retentive global variable(s) declaration."); context->yynerrs++;}
 | VAR_GLOBAL error global_var_decl_list END_VAR
-	{$$ = NULL; print_err_msg(locf(@2), locl(@2), "unexpected token after 'VAR_GLOBAL' in global variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "unexpected token after 'VAR_GLOBAL' in global variable(s) declaration."); yyerrok;}
 | VAR_GLOBAL CONSTANT error global_var_decl_list END_VAR
-	{$$ = NULL; print_err_msg(locf(@3), locl(@3), "unexpected token after 'CONSTANT' in constant global variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "unexpected token after 'CONSTANT' in constant global variable(s) declaration."); yyerrok;}
 | VAR_GLOBAL RETAIN error global_var_decl_list END_VAR
-	{$$ = NULL; print_err_msg(locf(@3), locl(@3), "unexpected token after 'RETAIN' in retentive global variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "unexpected token after 'RETAIN' in retentive global variable(s) declaration."); yyerrok;}
 | VAR_GLOBAL global_var_decl_list error END_OF_INPUT
-  {$$ = NULL; print_err_msg(locf(@1), locl(@1), "unclosed global variable(s) declaration."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@1), locl(@1), "unclosed global variable(s) declaration."); yyerrok;}
 | VAR_GLOBAL CONSTANT global_var_decl_list error END_OF_INPUT
-  {$$ = NULL; print_err_msg(locf(@1), locl(@2), "unclosed constant global variable(s) declaration."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@1), locl(@2), "unclosed constant global variable(s) declaration."); yyerrok;}
 | VAR_GLOBAL RETAIN global_var_decl_list error END_OF_INPUT
-  {$$ = NULL; print_err_msg(locf(@1), locl(@2), "unclosed retentive global variable(s) declaration."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@1), locl(@2), "unclosed retentive global variable(s) declaration."); yyerrok;}
 | VAR_GLOBAL error END_VAR
-	{$$ = NULL; print_err_msg(locf(@2), locl(@2), "unknown error in global variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "unknown error in global variable(s) declaration."); yyerrok;}
 | VAR_GLOBAL CONSTANT error END_VAR
-	{$$ = NULL; print_err_msg(locf(@3), locl(@3), "unknown error in constant global variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "unknown error in constant global variable(s) declaration."); yyerrok;}
 | VAR_GLOBAL RETAIN error END_VAR
-	{$$ = NULL; print_err_msg(locf(@3), locl(@3), "unknown error in constant global variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "unknown error in constant global variable(s) declaration."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -4482,15 +4416,15 @@ global_var_decl_list:
 	{$$ = $1; $$->add_element($2);}
 /* ERROR_CHECK_BEGIN */
 | error ';'
-	{$$ = new global_var_decl_list_c(locloc(@$)); print_err_msg(locf(@1), locl(@1), "invalid global variable(s) declaration."); yyerrok;}
+	{$$ = new global_var_decl_list_c(locloc(@$)); print_err_msg(context, locf(@1), locl(@1), "invalid global variable(s) declaration."); yyerrok;}
 | global_var_decl error
-	{$$ = new global_var_decl_list_c(locloc(@$)); print_err_msg(locl(@1), locf(@2), "';' missing at end of global variable(s) declaration."); yyerrok;}
+	{$$ = new global_var_decl_list_c(locloc(@$)); print_err_msg(context, locl(@1), locf(@2), "';' missing at end of global variable(s) declaration."); yyerrok;}
 | global_var_decl_list global_var_decl error
-	{$$ = $1; print_err_msg(locl(@1), locf(@2), "';' missing at end of global variable(s) declaration."); yyerrok;}
+	{$$ = $1; print_err_msg(context, locl(@1), locf(@2), "';' missing at end of global variable(s) declaration."); yyerrok;}
 | global_var_decl_list error ';'
-	{$$ = $1; print_err_msg(locf(@2), locl(@2), "invalid global variable(s) declaration."); yyerrok;}
+	{$$ = $1; print_err_msg(context, locf(@2), locl(@2), "invalid global variable(s) declaration."); yyerrok;}
 | global_var_decl_list ';'
-	{$$ = $1; print_err_msg(locf(@2), locl(@2), "unexpected ';' after global variable(s) declaration."); yynerrs++;}
+	{$$ = $1; print_err_msg(context, locf(@2), locl(@2), "unexpected ';' after global variable(s) declaration."); context->yynerrs++;}
 /* ERROR_CHECK_END */
 ;
 
@@ -4506,15 +4440,15 @@ global_var_decl:
 	{$$ = new global_var_decl_c($1, new fb_spec_init_c($3, NULL, locloc(@3)), locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | global_var_list located_var_spec_init
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "':' missing between global variable list and type specification."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':' missing between global variable list and type specification."); context->yynerrs++;}
 | global_var_name location located_var_spec_init
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "':' missing between global variable specification and type specification."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':' missing between global variable specification and type specification."); context->yynerrs++;}
 | global_var_spec function_block_type_name
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "':' missing between global variable specification and function block type specification."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':' missing between global variable specification and function block type specification."); context->yynerrs++;}
 | global_var_spec ':' error
 	{$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no specification defined in global variable declaration.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid specification in global variable declaration."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no specification defined in global variable declaration.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid specification in global variable declaration."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -4527,7 +4461,7 @@ global_var_spec:
 	{$$ = new global_var_spec_c(NULL, $1, locloc(@$));}
 | global_var_name location
 	{$$ = new global_var_spec_c($1, $2, locloc(@$));
-	 variable_name_symtable.insert($1, prev_declared_global_var_name_token);
+	 context->variable_name_symtable.insert($1, prev_declared_global_var_name_token);
 	}
 ;
 
@@ -4547,13 +4481,13 @@ located_var_spec_init:
 location:
   AT direct_variable_token
 	{$$ = new location_c(new direct_variable_c($2, locloc(@$)), locloc(@$));
-	 direct_variable_symtable.insert($2, prev_declared_direct_variable_token);
+	 context->direct_variable_symtable.insert($2, prev_declared_direct_variable_token);
 	}
 /* ERROR_CHECK_BEGIN */
 | AT error
 	{$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@1), locf(@2), "no location defined in location declaration.");}
-	 else {print_err_msg(locf(@2), locl(@2), "invalid location in global location declaration."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@1), locf(@2), "no location defined in location declaration.");}
+	 else {print_err_msg(context, locf(@2), locl(@2), "invalid location in global location declaration."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -4564,19 +4498,19 @@ location:
 global_var_list:
   global_var_name
 	{$$ = new global_var_list_c(locloc(@$)); $$->add_element($1);
-	 variable_name_symtable.insert($1, prev_declared_global_var_name_token);
+	 context->variable_name_symtable.insert($1, prev_declared_global_var_name_token);
 	}
 | global_var_list ',' global_var_name
 	{$$ = $1; $$->add_element($3);
-	 variable_name_symtable.insert($3, prev_declared_global_var_name_token);
+	 context->variable_name_symtable.insert($3, prev_declared_global_var_name_token);
 	}
 /* ERROR_CHECK_BEGIN */
 | global_var_list global_var_name
-	{$$ = new global_var_list_c(locloc(@$)); print_err_msg(locl(@1), locf(@2), "',' missing in global variable list."); yynerrs++;}
+	{$$ = new global_var_list_c(locloc(@$)); print_err_msg(context, locl(@1), locf(@2), "',' missing in global variable list."); context->yynerrs++;}
 | global_var_list ',' error
 	{$$ = $1;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no variable name defined in global variable declaration.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid variable name in global variable declaration."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no variable name defined in global variable declaration.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid variable name in global variable declaration."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -4594,7 +4528,7 @@ single_byte_string_var_declaration:
 	{$$ = new single_byte_string_var_declaration_c($1, $3, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | var1_list single_byte_string_spec
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "':' missing between variable list and string type specification."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':' missing between variable list and string type specification."); context->yynerrs++;}
 /* ERROR_CHECK_END */
 ;
 
@@ -4644,21 +4578,21 @@ single_byte_string_spec:
 	{$$ = new single_byte_string_spec_c(new single_byte_limited_len_string_spec_c(new string_type_name_c(locloc(@1)), $3, locloc(@$)), $6, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | STRING '[' error ']'
-	{$$ = NULL; print_err_msg(locf(@3), locl(@3), "invalid length value for limited string type specification."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "invalid length value for limited string type specification."); yyerrok;}
 | STRING '[' error ']' ASSIGN single_byte_character_string
-	{$$ = NULL; print_err_msg(locf(@3), locl(@3), "invalid length value for limited string type specification."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "invalid length value for limited string type specification."); yyerrok;}
 | STRING '[' ']'
-	{$$ = NULL; print_err_msg(locl(@2), locf(@3), "missing length value for limited string type specification."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@2), locf(@3), "missing length value for limited string type specification."); context->yynerrs++;}
 | STRING '[' ']' ASSIGN single_byte_character_string
-	{$$ = NULL; print_err_msg(locl(@2), locf(@3), "missing length value for limited string type specification."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@2), locf(@3), "missing length value for limited string type specification."); context->yynerrs++;}
 | STRING '[' integer error
-	{$$ = NULL; print_err_msg(locl(@3), locf(@4), "expecting ']' after length definition for limited string type specification."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locl(@3), locf(@4), "expecting ']' after length definition for limited string type specification."); yyerrok;}
 | STRING '[' integer ']' single_byte_character_string
-	{$$ = NULL; print_err_msg(locl(@4), locf(@5), "':=' missing before limited string type initialization."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@4), locf(@5), "':=' missing before limited string type initialization."); context->yynerrs++;}
 | STRING '[' integer ']' ASSIGN error
 	{$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@5), locf(@6), "no initial value defined in limited string type initialization.");}
-	 else {print_err_msg(locf(@6), locl(@6), "invalid initial value in limited string type initialization."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@5), locf(@6), "no initial value defined in limited string type initialization.");}
+	 else {print_err_msg(context, locf(@6), locl(@6), "invalid initial value in limited string type initialization."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -4670,7 +4604,7 @@ double_byte_string_var_declaration:
 	{$$ = new double_byte_string_var_declaration_c($1, $3, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | var1_list double_byte_string_spec
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "':' missing between variable list and double byte string type specification."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':' missing between variable list and double byte string type specification."); context->yynerrs++;}
 /* ERROR_CHECK_END */
 ;
 
@@ -4689,21 +4623,21 @@ double_byte_string_spec:
 	{$$ = new double_byte_string_spec_c(new double_byte_limited_len_string_spec_c(new wstring_type_name_c(locloc(@1)), $3, locloc(@$)), $6, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | WSTRING '[' error ']'
-	{$$ = NULL; print_err_msg(locf(@3), locl(@3), "invalid length value for limited double byte string type specification."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "invalid length value for limited double byte string type specification."); yyerrok;}
 | WSTRING '[' error ']' ASSIGN single_byte_character_string
-	{$$ = NULL; print_err_msg(locf(@3), locl(@3), "invalid length value for limited double byte string type specification."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "invalid length value for limited double byte string type specification."); yyerrok;}
 | WSTRING '[' ']'
-	{$$ = NULL; print_err_msg(locl(@2), locf(@3), "missing length value for limited double byte string type specification."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@2), locf(@3), "missing length value for limited double byte string type specification."); context->yynerrs++;}
 | WSTRING '[' ']' ASSIGN single_byte_character_string
-	{$$ = NULL; print_err_msg(locl(@2), locf(@3), "missing length value for limited double byte string type specification."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@2), locf(@3), "missing length value for limited double byte string type specification."); context->yynerrs++;}
 | WSTRING '[' integer error
-	{$$ = NULL; print_err_msg(locl(@3), locf(@4), "expecting ']' after length definition for limited double byte string type specification."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locl(@3), locf(@4), "expecting ']' after length definition for limited double byte string type specification."); yyerrok;}
 | WSTRING '[' integer ']' single_byte_character_string
-	{$$ = NULL; print_err_msg(locl(@4), locf(@5), "':=' missing before limited double byte string type initialization."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@4), locf(@5), "':=' missing before limited double byte string type initialization."); context->yynerrs++;}
 | WSTRING '[' integer ']' ASSIGN error
 	{$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@5), locf(@6), "no initial value defined double byte in limited string type initialization.");}
-	 else {print_err_msg(locf(@6), locl(@6), "invalid initial value in limited double byte string type initialization."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@5), locf(@6), "no initial value defined double byte in limited string type initialization.");}
+	 else {print_err_msg(context, locf(@6), locl(@6), "invalid initial value in limited double byte string type initialization."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -4720,17 +4654,17 @@ incompl_located_var_declarations:
 	{$$ = new incompl_located_var_declarations_c(new non_retain_option_c(locloc(@2)), $3, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | VAR incompl_located_var_decl_list error END_OF_INPUT
-  {$$ = NULL; print_err_msg(locf(@1), locl(@1), "unclosed incomplete located variable(s) declaration."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@1), locl(@1), "unclosed incomplete located variable(s) declaration."); yyerrok;}
 | VAR RETAIN incompl_located_var_decl_list error END_OF_INPUT
-  {$$ = NULL; print_err_msg(locf(@1), locl(@2), "unclosed incomplete retentive located variable(s) declaration."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@1), locl(@2), "unclosed incomplete retentive located variable(s) declaration."); yyerrok;}
 | VAR NON_RETAIN incompl_located_var_decl_list error END_OF_INPUT
-  {$$ = NULL; print_err_msg(locf(@1), locl(@2), "unclosed incomplete non-retentive located variable(s) declaration."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@1), locl(@2), "unclosed incomplete non-retentive located variable(s) declaration."); yyerrok;}
 | VAR error incompl_located_var_decl_list END_VAR
-	{$$ = NULL; print_err_msg(locf(@2), locl(@2), "unexpected token after 'VAR' in incomplete located variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "unexpected token after 'VAR' in incomplete located variable(s) declaration."); yyerrok;}
 | VAR RETAIN error incompl_located_var_decl_list END_VAR
-	{$$ = NULL; print_err_msg(locf(@3), locl(@3), "unexpected token after 'RETAIN' in retentive located variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "unexpected token after 'RETAIN' in retentive located variable(s) declaration."); yyerrok;}
 | VAR NON_RETAIN error incompl_located_var_decl_list END_VAR
-	{$$ = NULL; print_err_msg(locf(@3), locl(@3), "unexpected token after 'NON_RETAIN' in non-retentive located variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "unexpected token after 'NON_RETAIN' in non-retentive located variable(s) declaration."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -4742,13 +4676,13 @@ incompl_located_var_decl_list:
 	{$$ = $1; $$->add_element($2);}
 /* ERROR_CHECK_BEGIN */
 | incompl_located_var_decl error
-	{$$ = new incompl_located_var_decl_list_c(locloc(@$)); print_err_msg(locl(@1), locf(@2), "';' missing at end of incomplete located variable declaration."); yyerrok;}
+	{$$ = new incompl_located_var_decl_list_c(locloc(@$)); print_err_msg(context, locl(@1), locf(@2), "';' missing at end of incomplete located variable declaration."); yyerrok;}
 | incompl_located_var_decl_list incompl_located_var_decl error
-	{$$ = $1; print_err_msg(locl(@2), locf(@3), "';' missing at end of incomplete located variable declaration."); yyerrok;}
+	{$$ = $1; print_err_msg(context, locl(@2), locf(@3), "';' missing at end of incomplete located variable declaration."); yyerrok;}
 | incompl_located_var_decl_list error ';'
-	{$$ = $1; print_err_msg(locf(@2), locl(@2), "invalid incomplete located variable declaration."); yyerrok;}
+	{$$ = $1; print_err_msg(context, locf(@2), locl(@2), "invalid incomplete located variable declaration."); yyerrok;}
 | incompl_located_var_decl_list ';'
-	{$$ = $1; print_err_msg(locf(@2), locl(@2), "unexpected ';' after incomplete located variable declaration."); yynerrs++;}
+	{$$ = $1; print_err_msg(context, locf(@2), locl(@2), "unexpected ';' after incomplete located variable declaration."); context->yynerrs++;}
 /* ERROR_CHECK_END */
 ;
 
@@ -4758,12 +4692,12 @@ incompl_located_var_decl:
 	{$$ = new incompl_located_var_decl_c($1, $2, $4, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | variable_name incompl_location var_spec
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "':' missing between incomplete located variable and type specification."); yynerrs++;
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':' missing between incomplete located variable and type specification."); context->yynerrs++;
 	}
 | variable_name incompl_location ':' error
 	{$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no specification defined in incomplete located variable declaration.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid specification in incomplete located variable declaration."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no specification defined in incomplete located variable declaration.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid specification in incomplete located variable declaration."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -4815,9 +4749,9 @@ var_init_decl_list:
 	{$$ = $1; $$->add_element($2);}
 /* ERROR_CHECK_BEGIN */
 | var_init_decl_list var_init_decl error
-	{$$ = $1; print_err_msg(locl(@2), locf(@3), "';' missing at end of variable(s) declaration."); yyerrok;}
+	{$$ = $1; print_err_msg(context, locl(@2), locf(@3), "';' missing at end of variable(s) declaration."); yyerrok;}
 | var_init_decl_list error ';'
-	{$$ = $1; print_err_msg(locf(@2), locl(@2), "invalid variable(s) declaration."); yyerrok;}
+	{$$ = $1; print_err_msg(context, locf(@2), locl(@2), "invalid variable(s) declaration."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -4985,93 +4919,92 @@ standard_function_name_expression_clashes:
 
 
 derived_function_name:
-  identifier  /* will never occur during normal parsing, only needed for preparsing to change it to a prev_declared_derived_function_name! */
+  identifier  /* only used by the SKIPPED_POU rule of function_declaration (the others use function_name_declaration) */
 | prev_declared_derived_function_name
-	{$$ = new identifier_c(((token_c *)$1)->value, locloc(@$)); // transform the poutype_identifier_c into an identifier_c
-	 if (get_preparse_state() && !allow_function_overloading) {print_err_msg(locloc(@$), "Function overloading not allowed. Invalid identifier.\n"); yynerrs++;}
-	}
+	{$$ = new identifier_c(((token_c *)$1)->value, locloc(@$));} // transform the poutype_identifier_c into an identifier_c
 | AND
 	{$$ = new identifier_c("AND", locloc(@$));
-	 if (!allow_function_overloading) {print_err_msg(locloc(@$), "Function overloading not allowed. Invalid identifier.\n"); yynerrs++;}
+	 if (!context->allow_function_overloading) {print_err_msg(context, locloc(@$), "Function overloading not allowed. Invalid identifier.\n"); context->yynerrs++;}
 	}
 | OR
 	{$$ = new identifier_c("OR", locloc(@$));
-	 if (!allow_function_overloading) {print_err_msg(locloc(@$), "Function overloading not allowed. Invalid identifier.\n"); yynerrs++;}
+	 if (!context->allow_function_overloading) {print_err_msg(context, locloc(@$), "Function overloading not allowed. Invalid identifier.\n"); context->yynerrs++;}
 	}
 | XOR
 	{$$ = new identifier_c("XOR", locloc(@$));
-	 if (!allow_function_overloading) {print_err_msg(locloc(@$), "Function overloading not allowed. Invalid identifier.\n"); yynerrs++;}
+	 if (!context->allow_function_overloading) {print_err_msg(context, locloc(@$), "Function overloading not allowed. Invalid identifier.\n"); context->yynerrs++;}
 	}
 | NOT
 	{$$ = new identifier_c("NOT", locloc(@$));
-	 if (!allow_function_overloading) {print_err_msg(locloc(@$), "Function overloading not allowed. Invalid identifier.\n"); yynerrs++;}
+	 if (!context->allow_function_overloading) {print_err_msg(context, locloc(@$), "Function overloading not allowed. Invalid identifier.\n"); context->yynerrs++;}
 	}
 | MOD
 	{$$ = new identifier_c("MOD", locloc(@$));
-	 if (!allow_function_overloading) {print_err_msg(locloc(@$), "Function overloading not allowed. Invalid identifier.\n"); yynerrs++;}
+	 if (!context->allow_function_overloading) {print_err_msg(context, locloc(@$), "Function overloading not allowed. Invalid identifier.\n"); context->yynerrs++;}
 	}
 ;
 
 
 function_declaration:
 /*  FUNCTION derived_function_name ':' elementary_type_name io_OR_function_var_declarations_list function_body END_FUNCTION */
-/* PRE_PARSING: The rules expected to be applied by the preparser. */
-  FUNCTION derived_function_name END_FUNCTION   /* rule that is only expected to be used during preparse state => MUST print an error if used outside preparse() state!! */
+/* SKIPPED_POU: flex skipped the declarations and body of the POU (lazy or incremental parsing, see skip_pou_state() in flex). */
+  FUNCTION derived_function_name END_FUNCTION   /* also matches a FUNCTION with no declarations and no body => MUST print an error if not skipped by flex!! */
 	{$$ = NULL; 
-	 if (get_preparse_state())    {library_element_symtable.insert($2, prev_declared_derived_function_name_token);}
-	 else                         {print_err_msg(locl(@1), locf(@3), "FUNCTION with no variable declarations and no body."); yynerrs++;}
+	 if (lazy_pou_unused(((identifier_c *)$2)->value)) {/* skipped by flex, as not used by the input file (-L) */}
+	 else if (NULL != ($$ = unchanged_pou(context, $2, prev_declared_derived_function_name_token))) {/* skipped by flex, as not changed */}
+	 else                         {print_err_msg(context, locl(@1), locf(@3), "FUNCTION with no variable declarations and no body."); context->yynerrs++;}
 	 }
-/* POST_PARSING and STANDARD_PARSING: The rules expected to be applied after the preparser has finished. */
+/* FORWARD_DECLARED (-p, see prescan.hh) and STANDARD_PARSING */
 | function_name_declaration ':' elementary_type_name io_OR_function_var_declarations_list function_body END_FUNCTION
 	{$$ = new function_declaration_c($1, $3, $4, $5, locloc(@$));
-	 if (!runtime_options.disable_implicit_en_eno) add_en_eno_param_decl_c::add_to($$); /* add EN and ENO declarations, if not already there */
-	 variable_name_symtable.pop();
-	 direct_variable_symtable.pop();
-	 library_element_symtable.insert($1, prev_declared_derived_function_name_token);
+	 if (!context->options.disable_implicit_en_eno) add_en_eno_param_decl_c::add_to($$); /* add EN and ENO declarations, if not already there */
+	 context->variable_name_symtable.pop();
+	 context->direct_variable_symtable.pop();
+	 context->library_element_symtable.insert($1, prev_declared_derived_function_name_token);
 	}
 /* | FUNCTION derived_function_name ':' derived_type_name io_OR_function_var_declarations_list function_body END_FUNCTION */
 | function_name_declaration ':' derived_type_name io_OR_function_var_declarations_list function_body END_FUNCTION
 	{$$ = new function_declaration_c($1, $3, $4, $5, locloc(@$));
-	 if (!runtime_options.disable_implicit_en_eno) add_en_eno_param_decl_c::add_to($$); /* add EN and ENO declarations, if not already there */
-	 variable_name_symtable.pop();
-	 direct_variable_symtable.pop();
-	 library_element_symtable.insert($1, prev_declared_derived_function_name_token);
+	 if (!context->options.disable_implicit_en_eno) add_en_eno_param_decl_c::add_to($$); /* add EN and ENO declarations, if not already there */
+	 context->variable_name_symtable.pop();
+	 context->direct_variable_symtable.pop();
+	 context->library_element_symtable.insert($1, prev_declared_derived_function_name_token);
 	}
 /* | FUNCTION derived_function_name ':' VOID io_OR_function_var_declarations_list function_body END_FUNCTION */
 | function_name_declaration ':' VOID io_OR_function_var_declarations_list function_body END_FUNCTION
 	{$$ = new function_declaration_c($1, new void_type_name_c(locloc(@3)), $4, $5, locloc(@$));
-	 if (!runtime_options.disable_implicit_en_eno) add_en_eno_param_decl_c::add_to($$); /* add EN and ENO declarations, if not already there */
-	 variable_name_symtable.pop();
-	 direct_variable_symtable.pop();
-	 library_element_symtable.insert($1, prev_declared_derived_function_name_token);
+	 if (!context->options.disable_implicit_en_eno) add_en_eno_param_decl_c::add_to($$); /* add EN and ENO declarations, if not already there */
+	 context->variable_name_symtable.pop();
+	 context->direct_variable_symtable.pop();
+	 context->library_element_symtable.insert($1, prev_declared_derived_function_name_token);
 	}
 /* ERROR_CHECK_BEGIN */
 | function_name_declaration elementary_type_name io_OR_function_var_declarations_list function_body END_FUNCTION
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "':' missing after function name in function declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':' missing after function name in function declaration."); context->yynerrs++;}
 | function_name_declaration derived_type_name io_OR_function_var_declarations_list function_body END_FUNCTION
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "':' missing after function name in function declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':' missing after function name in function declaration."); context->yynerrs++;}
 | function_name_declaration ':' io_OR_function_var_declarations_list function_body END_FUNCTION
-	{$$ = NULL; print_err_msg(locl(@2), locf(@3), "no return type defined in function declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@2), locf(@3), "no return type defined in function declaration."); context->yynerrs++;}
 | function_name_declaration ':' error io_OR_function_var_declarations_list function_body END_FUNCTION
-	{$$ = NULL; print_err_msg(locf(@3), locl(@3), "invalid return type defined in function declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "invalid return type defined in function declaration."); yyerrok;}
 | function_name_declaration ':' elementary_type_name function_body END_FUNCTION
-	{$$ = NULL; print_err_msg(locl(@3), locf(@4), "no variable(s) declared in function declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@3), locf(@4), "no variable(s) declared in function declaration."); context->yynerrs++;}
 | function_name_declaration ':' derived_type_name function_body END_FUNCTION
-	{$$ = NULL; print_err_msg(locl(@3), locf(@4), "no variable(s) declared in function declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@3), locf(@4), "no variable(s) declared in function declaration."); context->yynerrs++;}
 | function_name_declaration ':' elementary_type_name io_OR_function_var_declarations_list END_FUNCTION
-	{$$ = NULL; print_err_msg(locl(@4), locf(@5), "no body defined in function declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@4), locf(@5), "no body defined in function declaration."); context->yynerrs++;}
 | function_name_declaration ':' derived_type_name io_OR_function_var_declarations_list END_FUNCTION
-	{$$ = NULL; print_err_msg(locl(@4), locf(@5), "no body defined in function declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@4), locf(@5), "no body defined in function declaration."); context->yynerrs++;}
 | function_name_declaration ':' elementary_type_name END_FUNCTION
-	{$$ = NULL; print_err_msg(locl(@3), locf(@4), "no variable(s) declared and body defined in function declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@3), locf(@4), "no variable(s) declared and body defined in function declaration."); context->yynerrs++;}
 | function_name_declaration ':' derived_type_name END_FUNCTION
-	{$$ = NULL; print_err_msg(locl(@3), locf(@4), "no variable(s) declared and body defined in function declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@3), locf(@4), "no variable(s) declared and body defined in function declaration."); context->yynerrs++;}
 | function_name_declaration ':' elementary_type_name io_OR_function_var_declarations_list function_body END_OF_INPUT
-	{$$ = NULL; print_err_msg(locf(@1), locf(@3), "unclosed function declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locf(@1), locf(@3), "unclosed function declaration."); context->yynerrs++;}
 | function_name_declaration ':' derived_type_name io_OR_function_var_declarations_list function_body END_OF_INPUT
-	{$$ = NULL; print_err_msg(locf(@1), locl(@3), "unclosed function declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locf(@1), locl(@3), "unclosed function declaration."); context->yynerrs++;}
 | function_name_declaration error END_FUNCTION
-	{$$ = NULL; print_err_msg(locf(@2), locl(@2), "unknown error in function declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "unknown error in function declaration."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -5118,13 +5051,13 @@ function_name_declaration:
 	  * is cleared once the end of the function
 	  * is parsed.
 	  */
-	 variable_name_symtable.insert($2, prev_declared_variable_name_token);
+	 context->variable_name_symtable.insert($2, prev_declared_variable_name_token);
 	}
 /* ERROR_CHECK_BEGIN */
 | FUNCTION error 
 	{$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@1), locf(@2), "no function name defined in function declaration.");}
-	 else {print_err_msg(locf(@2), locl(@2), "invalid function name in function declaration."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@1), locf(@2), "no function name defined in function declaration.");}
+	 else {print_err_msg(context, locf(@2), locl(@2), "invalid function name in function declaration."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -5144,23 +5077,23 @@ io_OR_function_var_declarations_list:
 	{$$ = $1; $$->add_element($2);}
 /* ERROR_CHECK_BEGIN */
 | io_OR_function_var_declarations_list retentive_var_declarations
-	{$$ = $1; print_err_msg(locf(@2), locl(@2), "unexpected retentive variable(s) declaration in function declaration."); yynerrs++;}
+	{$$ = $1; print_err_msg(context, locf(@2), locl(@2), "unexpected retentive variable(s) declaration in function declaration."); context->yynerrs++;}
 | io_OR_function_var_declarations_list located_var_declarations
-	{$$ = $1; print_err_msg(locf(@2), locl(@2), "unexpected located variable(s) declaration in function declaration."); yynerrs++;}
+	{$$ = $1; print_err_msg(context, locf(@2), locl(@2), "unexpected located variable(s) declaration in function declaration."); context->yynerrs++;}
 | io_OR_function_var_declarations_list external_var_declarations
-	{$$ = $1; print_err_msg(locf(@2), locl(@2), "unexpected external variable(s) declaration in function declaration."); yynerrs++;}
+	{$$ = $1; print_err_msg(context, locf(@2), locl(@2), "unexpected external variable(s) declaration in function declaration."); context->yynerrs++;}
 | io_OR_function_var_declarations_list global_var_declarations
-	{$$ = $1; print_err_msg(locf(@2), locl(@2), "unexpected global variable(s) declaration in function declaration."); yynerrs++;}
+	{$$ = $1; print_err_msg(context, locf(@2), locl(@2), "unexpected global variable(s) declaration in function declaration."); context->yynerrs++;}
 | io_OR_function_var_declarations_list incompl_located_var_declarations
-	{$$ = $1; print_err_msg(locf(@2), locl(@2), "unexpected incomplete located variable(s) declaration in function declaration."); yynerrs++;}
+	{$$ = $1; print_err_msg(context, locf(@2), locl(@2), "unexpected incomplete located variable(s) declaration in function declaration."); context->yynerrs++;}
 | io_OR_function_var_declarations_list temp_var_decls
-	{$$ = $1; print_err_msg(locf(@2), locl(@2), "unexpected temporary located variable(s) declaration in function declaration."); yynerrs++;}
+	{$$ = $1; print_err_msg(context, locf(@2), locl(@2), "unexpected temporary located variable(s) declaration in function declaration."); context->yynerrs++;}
 | io_OR_function_var_declarations_list non_retentive_var_decls
-	{$$ = $1; print_err_msg(locf(@2), locl(@2), "unexpected non-retentive variable(s) declaration in function declaration."); yynerrs++;}
+	{$$ = $1; print_err_msg(context, locf(@2), locl(@2), "unexpected non-retentive variable(s) declaration in function declaration."); context->yynerrs++;}
 /*| io_OR_function_var_declarations_list access_declarations
-	{$$ = $1; print_err_msg(locf(@2), locl(@2), "unexpected access variable(s) declaration in function declaration."); yynerrs++;}*/
+	{$$ = $1; print_err_msg(context, locf(@2), locl(@2), "unexpected access variable(s) declaration in function declaration."); context->yynerrs++;}*/
 | io_OR_function_var_declarations_list instance_specific_initializations
-	{$$ = $1; print_err_msg(locf(@2), locl(@2), "unexpected instance specific initialization(s) in function declaration."); yynerrs++;}
+	{$$ = $1; print_err_msg(context, locf(@2), locl(@2), "unexpected instance specific initialization(s) in function declaration."); context->yynerrs++;}
 /* ERROR_CHECK_END */
 ;
 
@@ -5179,13 +5112,13 @@ function_var_decls:
 	{$$ = new function_var_decls_c(NULL, $2, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | VAR error var2_init_decl_list END_VAR
-	{$$ = NULL; print_err_msg(locf(@2), locl(@2), "unexpected token after 'VAR' in function variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "unexpected token after 'VAR' in function variable(s) declaration."); yyerrok;}
 | VAR CONSTANT error var2_init_decl_list END_VAR
-	{$$ = NULL; print_err_msg(locf(@3), locl(@3), "unexpected token after 'CONSTANT' in constant function variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "unexpected token after 'CONSTANT' in constant function variable(s) declaration."); yyerrok;}
 | VAR var2_init_decl_list error END_OF_INPUT
-	{$$ = NULL; print_err_msg(locf(@1), locl(@1), "unclosed function variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@1), locl(@1), "unclosed function variable(s) declaration."); yyerrok;}
 | VAR CONSTANT var2_init_decl_list error END_OF_INPUT
-	{$$ = NULL; print_err_msg(locf(@1), locl(@2), "unclosed constant function variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@1), locl(@2), "unclosed constant function variable(s) declaration."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -5197,13 +5130,13 @@ var2_init_decl_list:
 	{$$ = $1; $$->add_element($2);}
 /* ERROR_CHECK_BEGIN */
 | var2_init_decl error
-	{$$ = new var2_init_decl_list_c(locloc(@$)); print_err_msg(locl(@1), locf(@2), "';' missing at end of function variable(s) declaration."); yyerrok;}
+	{$$ = new var2_init_decl_list_c(locloc(@$)); print_err_msg(context, locl(@1), locf(@2), "';' missing at end of function variable(s) declaration."); yyerrok;}
 | var2_init_decl_list var2_init_decl error
-	{$$ = $1; print_err_msg(locl(@2), locf(@3), "';' missing at end of function variable(s) declaration."); yyerrok;}
+	{$$ = $1; print_err_msg(context, locl(@2), locf(@3), "';' missing at end of function variable(s) declaration."); yyerrok;}
 | var2_init_decl_list error ';'
-	{$$ = $1; print_err_msg(locf(@2), locl(@2), "invalid function variable(s) declaration."); yyerrok;}
+	{$$ = $1; print_err_msg(context, locf(@2), locl(@2), "invalid function variable(s) declaration."); yyerrok;}
 | var2_init_decl_list ';'
-	{$$ = $1; print_err_msg(locf(@2), locl(@2), "unexpected ';' after function variable(s) declaration."); yynerrs++;}
+	{$$ = $1; print_err_msg(context, locf(@2), locl(@2), "unexpected ';' after function variable(s) declaration."); context->yynerrs++;}
 /* ERROR_CHECK_END */
 ;
 
@@ -5242,50 +5175,51 @@ derived_function_block_name: identifier;
 
 
 function_block_declaration:
-/* PRE_PARSING: The rules expected to be applied by the preparser. Will only run if pre-parsing command line option is ON. */
-  FUNCTION_BLOCK derived_function_block_name END_FUNCTION_BLOCK   /* rule that is only expected to be used during preparse state => MUST print an error if used outside preparse() state!! */
+/* SKIPPED_POU: flex skipped the declarations and body of the POU (lazy or incremental parsing, see skip_pou_state() in flex). */
+  FUNCTION_BLOCK derived_function_block_name END_FUNCTION_BLOCK   /* also matches a FUNCTION_BLOCK with no declarations and no body => MUST print an error if not skipped by flex!! */
 	{$$ = NULL; 
-	 if (get_preparse_state())    {library_element_symtable.insert($2, prev_declared_derived_function_block_name_token);}
-	 else                         {print_err_msg(locl(@1), locf(@3), "FUNCTION_BLOCK with no variable declarations and no body."); yynerrs++;}
+	 if (lazy_pou_unused(((identifier_c *)$2)->value)) {/* skipped by flex, as not used by the input file (-L) */}
+	 else if (NULL != ($$ = unchanged_pou(context, $2, prev_declared_derived_function_block_name_token))) {/* skipped by flex, as not changed */}
+	 else                         {print_err_msg(context, locl(@1), locf(@3), "FUNCTION_BLOCK with no variable declarations and no body."); context->yynerrs++;}
 	 }
-/* POST_PARSING: The rules expected to be applied after the preparser runs. Will only run if pre-parsing command line option is ON. */
+/* FORWARD_DECLARED: The name was already declared by the pre-scanner. Will only run if pre-parsing command line option is ON (see prescan.hh). */
 | FUNCTION_BLOCK prev_declared_derived_function_block_name io_OR_other_var_declarations_list function_block_body END_FUNCTION_BLOCK
 	{$$ = new function_block_declaration_c($2, $3, $4, locloc(@$));
-	 if (!runtime_options.disable_implicit_en_eno) add_en_eno_param_decl_c::add_to($$); /* add EN and ENO declarations, if not already there */
+	 if (!context->options.disable_implicit_en_eno) add_en_eno_param_decl_c::add_to($$); /* add EN and ENO declarations, if not already there */
 	 /* Clear the variable_name_symtable. Since we have finished parsing the function block,
 	  * the variable names are now out of scope, so are no longer valid!
 	  */
-	 variable_name_symtable.pop();
-	 direct_variable_symtable.pop();
+	 context->variable_name_symtable.pop();
+	 context->direct_variable_symtable.pop();
 	}
 /* STANDARD_PARSING: The rules expected to be applied in single-phase parsing. Will only run if pre-parsing command line option is OFF. */
 | FUNCTION_BLOCK derived_function_block_name io_OR_other_var_declarations_list function_block_body END_FUNCTION_BLOCK
 	{$$ = new function_block_declaration_c($2, $3, $4, locloc(@$));
-	 library_element_symtable.insert($2, prev_declared_derived_function_block_name_token);
-	 if (!runtime_options.disable_implicit_en_eno) add_en_eno_param_decl_c::add_to($$); /* add EN and ENO declarations, if not already there */
+	 context->library_element_symtable.insert($2, prev_declared_derived_function_block_name_token);
+	 if (!context->options.disable_implicit_en_eno) add_en_eno_param_decl_c::add_to($$); /* add EN and ENO declarations, if not already there */
 	 /* Clear the variable_name_symtable. Since we have finished parsing the function block,
 	  * the variable names are now out of scope, so are no longer valid!
 	  */
-	 variable_name_symtable.pop();
-	 direct_variable_symtable.pop();
+	 context->variable_name_symtable.pop();
+	 context->direct_variable_symtable.pop();
 	}
 /* ERROR_CHECK_BEGIN */
 | FUNCTION_BLOCK io_OR_other_var_declarations_list function_block_body END_FUNCTION_BLOCK
-  {$$ = NULL; print_err_msg(locl(@1), locf(@2), "no function block name defined in function block declaration."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "no function block name defined in function block declaration."); context->yynerrs++;}
 | FUNCTION_BLOCK error io_OR_other_var_declarations_list function_block_body END_FUNCTION_BLOCK
-	{$$ = NULL; print_err_msg(locf(@2), locl(@2), "invalid function block name in function block declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "invalid function block name in function block declaration."); yyerrok;}
 | FUNCTION_BLOCK derived_function_block_name function_block_body END_FUNCTION_BLOCK
-	{$$ = NULL; print_err_msg(locl(@2), locf(@3), "no variable(s) declared in function declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@2), locf(@3), "no variable(s) declared in function declaration."); context->yynerrs++;}
 | FUNCTION_BLOCK derived_function_block_name io_OR_other_var_declarations_list END_FUNCTION_BLOCK
-	{$$ = NULL; print_err_msg(locl(@3), locf(@4), "no body defined in function block declaration."); yynerrs++;}
-/*  Rule already covered by the rule to handle the preparse state!
+	{$$ = NULL; print_err_msg(context, locl(@3), locf(@4), "no body defined in function block declaration."); context->yynerrs++;}
+/*  Rule already covered by the SKIPPED_POU rule (which prints the error when flex did not skip the POU)!
 | FUNCTION_BLOCK derived_function_block_name END_FUNCTION_BLOCK
-	{$$ = NULL; print_err_msg(locl(@2), locf(@3), "no variable(s) declared and body defined in function block declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@2), locf(@3), "no variable(s) declared and body defined in function block declaration."); context->yynerrs++;}
 */
 | FUNCTION_BLOCK derived_function_block_name io_OR_other_var_declarations_list function_block_body END_OF_INPUT
-	{$$ = NULL; print_err_msg(locf(@1), locl(@2), "expecting END_FUNCTION_BLOCK before end of file."); yynerrs++;}	
+	{$$ = NULL; print_err_msg(context, locf(@1), locl(@2), "expecting END_FUNCTION_BLOCK before end of file."); context->yynerrs++;}	
 | FUNCTION_BLOCK error END_FUNCTION_BLOCK
-	{$$ = NULL; print_err_msg(locf(@2), locl(@2), "unknown error in function block declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "unknown error in function block declaration."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -5307,13 +5241,13 @@ io_OR_other_var_declarations_list:
 	{$$ = $1; $$->add_element($2);}
 /* ERROR_CHECK_BEGIN */
 | io_OR_other_var_declarations_list located_var_declarations
-	{$$ = $1; print_err_msg(locf(@2), locl(@2), "unexpected located variable(s) declaration in function block declaration."); yynerrs++;}
+	{$$ = $1; print_err_msg(context, locf(@2), locl(@2), "unexpected located variable(s) declaration in function block declaration."); context->yynerrs++;}
 | io_OR_other_var_declarations_list global_var_declarations
-	{$$ = $1; print_err_msg(locf(@2), locl(@2), "unexpected global variable(s) declaration in function block declaration."); yynerrs++;}
+	{$$ = $1; print_err_msg(context, locf(@2), locl(@2), "unexpected global variable(s) declaration in function block declaration."); context->yynerrs++;}
 /*| io_OR_other_var_declarations_list access_declarations
-	{$$ = $1; print_err_msg(locf(@2), locl(@2), "unexpected access variable(s) declaration in function block declaration."); yynerrs++;}*/
+	{$$ = $1; print_err_msg(context, locf(@2), locl(@2), "unexpected access variable(s) declaration in function block declaration."); context->yynerrs++;}*/
 | io_OR_other_var_declarations_list instance_specific_initializations
-	{$$ = $1; print_err_msg(locf(@2), locl(@2), "unexpected instance specific initialization(s) in function block declaration."); yynerrs++;}
+	{$$ = $1; print_err_msg(context, locf(@2), locl(@2), "unexpected instance specific initialization(s) in function block declaration."); context->yynerrs++;}
 /* ERROR_CHECK_END */
 ;
 
@@ -5348,11 +5282,11 @@ temp_var_decls:
 	{$$ = new temp_var_decls_c($2, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | VAR_TEMP END_VAR
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "no variable declared in temporary variable(s) declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "no variable declared in temporary variable(s) declaration."); context->yynerrs++;}
 | VAR_TEMP temp_var_decls_list error END_OF_INPUT
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "unclosed temporary variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "unclosed temporary variable(s) declaration."); yyerrok;}
 | VAR_TEMP error temp_var_decls_list END_VAR
-	{$$ = NULL; print_err_msg(locf(@2), locl(@2), "unexpected token after 'VAR_TEMP' in function variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "unexpected token after 'VAR_TEMP' in function variable(s) declaration."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -5365,15 +5299,15 @@ temp_var_decls_list:
 	{$$ = $1; $$->add_element($2);}
 /* ERROR_CHECK_BEGIN */
 | error ';'
-	{$$ = new temp_var_decls_list_c(locloc(@$)); print_err_msg(locf(@1), locl(@1), "invalid temporary variable(s) declaration."); yyerrok;}
+	{$$ = new temp_var_decls_list_c(locloc(@$)); print_err_msg(context, locf(@1), locl(@1), "invalid temporary variable(s) declaration."); yyerrok;}
 | temp_var_decl error
-	{$$ = new temp_var_decls_list_c(locloc(@$)); print_err_msg(locl(@1), locf(@2), "';' missing at end of temporary variable(s) declaration."); yyerrok;}
+	{$$ = new temp_var_decls_list_c(locloc(@$)); print_err_msg(context, locl(@1), locf(@2), "';' missing at end of temporary variable(s) declaration."); yyerrok;}
 | temp_var_decls_list temp_var_decl error
-	{$$ = $1; print_err_msg(locl(@2), locf(@3), "';' missing at end of temporary variable(s) declaration."); yyerrok;}
+	{$$ = $1; print_err_msg(context, locl(@2), locf(@3), "';' missing at end of temporary variable(s) declaration."); yyerrok;}
 | temp_var_decls_list error ';'
-	{$$ = $1; print_err_msg(locf(@2), locl(@2), "invalid temporary variable(s) declaration."); yyerrok;}
+	{$$ = $1; print_err_msg(context, locf(@2), locl(@2), "invalid temporary variable(s) declaration."); yyerrok;}
 | temp_var_decls_list ';'
-	{$$ = $1; print_err_msg(locf(@2), locl(@2), "unexpected ';' after temporary variable(s) declaration."); yynerrs++;}
+	{$$ = $1; print_err_msg(context, locf(@2), locl(@2), "unexpected ';' after temporary variable(s) declaration."); context->yynerrs++;}
 /* ERROR_CHECK_END */
 ;
 
@@ -5383,9 +5317,9 @@ non_retentive_var_decls:
 	{$$ = new non_retentive_var_decls_c($3, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | VAR NON_RETAIN var_init_decl_list error END_OF_INPUT
-	{$$ = NULL; print_err_msg(locf(@3), locl(@3), "unclosed non-retentive temporary variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "unclosed non-retentive temporary variable(s) declaration."); yyerrok;}
 | VAR NON_RETAIN error var_init_decl_list END_VAR
-	{$$ = NULL; print_err_msg(locf(@3), locl(@3), "unexpected token after 'NON_RETAIN' in non-retentive temporary variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "unexpected token after 'NON_RETAIN' in non-retentive temporary variable(s) declaration."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -5424,47 +5358,47 @@ program_type_name: identifier;
 
 
 program_declaration:
-/* PRE_PARSING: The rules expected to be applied by the preparser. Will only run if pre-parsing command line option is ON. */
-  PROGRAM program_type_name END_PROGRAM   /* rule that is only expected to be used during preparse state => MUST print an error if used outside preparse() state!! */
+/* SKIPPED_POU: flex skipped the declarations and body of the POU (incremental parsing, see skip_pou_state() in flex). */
+  PROGRAM program_type_name END_PROGRAM   /* also matches a PROGRAM with no declarations and no body => MUST print an error if not skipped by flex!! */
 	{$$ = NULL; 
-	 if (get_preparse_state())    {library_element_symtable.insert($2, prev_declared_program_type_name_token);}
-	 else                         {print_err_msg(locl(@1), locf(@3), "PROGRAM with no variable declarations and no body."); yynerrs++;}
+	 if (NULL != ($$ = unchanged_pou(context, $2, prev_declared_program_type_name_token))) {/* skipped by flex, as not changed */}
+	 else                         {print_err_msg(context, locl(@1), locf(@3), "PROGRAM with no variable declarations and no body."); context->yynerrs++;}
 	 }
-/* POST_PARSING: The rules expected to be applied after the preparser runs. Will only run if pre-parsing command line option is ON. */
+/* FORWARD_DECLARED: The name was already declared by the pre-scanner. Will only run if pre-parsing command line option is ON (see prescan.hh). */
 | PROGRAM prev_declared_program_type_name program_var_declarations_list function_block_body END_PROGRAM
 	{$$ = new program_declaration_c($2, $3, $4, locloc(@$));
 	 /* Clear the variable_name_symtable. Since we have finished parsing the program declaration,
 	  * the variable names are now out of scope, so are no longer valid!
 	  */
-	 variable_name_symtable.pop();
-	 direct_variable_symtable.pop();
+	 context->variable_name_symtable.pop();
+	 context->direct_variable_symtable.pop();
 	}
 /* STANDARD_PARSING: The rules expected to be applied in single-phase parsing. Will only run if pre-parsing command line option is OFF. */
-| PROGRAM program_type_name {library_element_symtable.insert($2, prev_declared_program_type_name_token);} program_var_declarations_list function_block_body END_PROGRAM
+| PROGRAM program_type_name {context->library_element_symtable.insert($2, prev_declared_program_type_name_token);} program_var_declarations_list function_block_body END_PROGRAM
 	{$$ = new program_declaration_c($2, $4, $5, locloc(@$));
 	 /* Clear the variable_name_symtable. Since we have finished parsing the program declaration,
 	  * the variable names are now out of scope, so are no longer valid!
 	  */
-	 variable_name_symtable.pop();
-	 direct_variable_symtable.pop();
+	 context->variable_name_symtable.pop();
+	 context->direct_variable_symtable.pop();
 	}
 /* ERROR_CHECK_BEGIN */
 | PROGRAM program_var_declarations_list function_block_body END_PROGRAM
-  {$$ = NULL; print_err_msg(locl(@1), locf(@2), "no program name defined in program declaration.");}
+  {$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "no program name defined in program declaration.");}
 | PROGRAM error program_var_declarations_list function_block_body END_PROGRAM
-	{$$ = NULL; print_err_msg(locf(@2), locl(@2), "invalid program name in program declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "invalid program name in program declaration."); yyerrok;}
 | PROGRAM prev_declared_program_type_name function_block_body END_PROGRAM
-	{$$ = NULL; print_err_msg(locl(@2), locf(@3), "no variable(s) declared in program declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@2), locf(@3), "no variable(s) declared in program declaration."); context->yynerrs++;}
 | PROGRAM prev_declared_program_type_name program_var_declarations_list END_PROGRAM
-	{$$ = NULL; print_err_msg(locl(@3), locf(@4), "no body defined in program declaration."); yynerrs++;}
-/*  Rule already covered by the rule to handle the preparse state!
+	{$$ = NULL; print_err_msg(context, locl(@3), locf(@4), "no body defined in program declaration."); context->yynerrs++;}
+/*  Rule already covered by the SKIPPED_POU rule (which prints the error when flex did not skip the POU)!
 | PROGRAM prev_declared_program_type_name END_PROGRAM 
-	{$$ = NULL; print_err_msg(locl(@2), locf(@3), "no variable(s) declared and body defined in program declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@2), locf(@3), "no variable(s) declared and body defined in program declaration."); context->yynerrs++;}
 */
 | PROGRAM prev_declared_program_type_name program_var_declarations_list function_block_body END_OF_INPUT
-	{$$ = NULL; print_err_msg(locf(@1), locl(@2), "unclosed program declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locf(@1), locl(@2), "unclosed program declaration."); context->yynerrs++;}
 | PROGRAM error END_PROGRAM
-	{$$ = NULL; print_err_msg(locf(@2), locl(@2), "unknown error in program declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "unknown error in program declaration."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -5492,11 +5426,11 @@ program_var_declarations_list:
 */
 /* ERROR_CHECK_BEGIN */
 | program_var_declarations_list global_var_declarations
-	{$$ = $1; print_err_msg(locf(@2), locl(@2), "unexpected global variable(s) declaration in function block declaration."); yynerrs++;}
+	{$$ = $1; print_err_msg(context, locf(@2), locl(@2), "unexpected global variable(s) declaration in function block declaration."); context->yynerrs++;}
 /*| program_var_declarations_list access_declarations
-	{$$ = $1; print_err_msg(locf(@2), locl(@2), "unexpected access variable(s) declaration in function block declaration."); yynerrs++;}*/
+	{$$ = $1; print_err_msg(context, locf(@2), locl(@2), "unexpected access variable(s) declaration in function block declaration."); context->yynerrs++;}*/
 | program_var_declarations_list instance_specific_initializations
-	{$$ = $1; print_err_msg(locf(@2), locl(@2), "unexpected instance specific initialization(s) in function block declaration."); yynerrs++;
+	{$$ = $1; print_err_msg(context, locf(@2), locl(@2), "unexpected instance specific initialization(s) in function block declaration."); context->yynerrs++;
 	}
 /* ERROR_CHECK_END */
 ;
@@ -5548,7 +5482,7 @@ sfc_network:
 	{$$ = $1; $$->add_element($2);}
 /* ERROR_CHECK_BEGIN */
 | sfc_network error 
-	{$$ = $1; print_err_msg(locl(@1), locf(@2), "unexpected token after SFC network in sequencial function chart."); yyerrok;}
+	{$$ = $1; print_err_msg(context, locl(@1), locf(@2), "unexpected token after SFC network in sequencial function chart."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -5556,21 +5490,21 @@ initial_step:
   INITIAL_STEP step_name ':' action_association_list END_STEP
 //  INITIAL_STEP identifier ':' action_association_list END_STEP
 	{$$ = new initial_step_c($2, $4, locloc(@$));
-	 variable_name_symtable.insert($2, prev_declared_variable_name_token); // A step name may later be used as a structured variable!!
+	 context->variable_name_symtable.insert($2, prev_declared_variable_name_token); // A step name may later be used as a structured variable!!
 	}
 /* ERROR_CHECK_BEGIN */
 | INITIAL_STEP ':' action_association_list END_STEP
-  {$$ = NULL; print_err_msg(locf(@1), locl(@2), "no step name defined in initial step declaration."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locf(@1), locl(@2), "no step name defined in initial step declaration."); context->yynerrs++;}
 | INITIAL_STEP error ':' action_association_list END_STEP
-	{$$ = NULL; print_err_msg(locf(@2), locl(@2), "invalid step name defined in initial step declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "invalid step name defined in initial step declaration."); yyerrok;}
 | INITIAL_STEP step_name action_association_list END_STEP
-	{$$ = NULL; print_err_msg(locl(@2), locf(@3), "':' missing after step name in initial step declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@2), locf(@3), "':' missing after step name in initial step declaration."); context->yynerrs++;}
 | INITIAL_STEP step_name ':' error END_STEP
-	{$$ = NULL; print_err_msg(locf(@4), locl(@4), "invalid action association list in initial step declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@4), locl(@4), "invalid action association list in initial step declaration."); yyerrok;}
 | INITIAL_STEP step_name ':' action_association_list END_OF_INPUT
-	{$$ = NULL; print_err_msg(locf(@1), locl(@3), "unclosed initial step declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locf(@1), locl(@3), "unclosed initial step declaration."); context->yynerrs++;}
 | INITIAL_STEP error END_STEP
-	{$$ = NULL; print_err_msg(locf(@2), locl(@2), "unknown error in initial step declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "unknown error in initial step declaration."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -5578,21 +5512,21 @@ step:
   STEP step_name ':' action_association_list END_STEP
 //  STEP identifier ':' action_association_list END_STEP
 	{$$ = new step_c($2, $4, locloc(@$));
-	 variable_name_symtable.insert($2, prev_declared_variable_name_token); // A step name may later be used as a structured variable!!
+	 context->variable_name_symtable.insert($2, prev_declared_variable_name_token); // A step name may later be used as a structured variable!!
 	}
 /* ERROR_CHECK_BEGIN */
 | STEP ':' action_association_list END_STEP
-  {$$ = NULL; print_err_msg(locl(@1), locf(@2), "no step name defined in step declaration."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "no step name defined in step declaration."); context->yynerrs++;}
 | STEP error ':' action_association_list END_STEP
-	{$$ = NULL; print_err_msg(locf(@2), locl(@2), "invalid step name defined in step declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "invalid step name defined in step declaration."); yyerrok;}
 | STEP step_name action_association_list END_STEP
-	{$$ = NULL; print_err_msg(locl(@2), locf(@3), "':' missing after step name in step declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@2), locf(@3), "':' missing after step name in step declaration."); context->yynerrs++;}
 | STEP step_name ':' error END_STEP
-	{$$ = NULL; print_err_msg(locf(@4), locl(@4), "invalid action association list in step declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@4), locl(@4), "invalid action association list in step declaration."); yyerrok;}
 | STEP step_name ':' action_association_list END_OF_INPUT
-	{$$ = NULL; print_err_msg(locf(@1), locl(@3), "invalid action association list in step declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locf(@1), locl(@3), "invalid action association list in step declaration."); context->yynerrs++;}
 | STEP error END_STEP
-	{$$ = NULL; print_err_msg(locf(@2), locl(@2), "unknown error in step declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "unknown error in step declaration."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -5607,9 +5541,9 @@ action_association_list:
 	{$$ = $1; $$->add_element($2);}
 /* ERROR_CHECK_BEGIN */
 | action_association_list action_association error
-	{$$ = $1; print_err_msg(locl(@2), locf(@3), "';' missing at end of action association declaration."); yyerrok;}
+	{$$ = $1; print_err_msg(context, locl(@2), locf(@3), "';' missing at end of action association declaration."); yyerrok;}
 | action_association_list ';'
-	{$$ = $1; print_err_msg(locf(@2), locl(@2), "unexpected ';' after action association declaration."); yynerrs++;}
+	{$$ = $1; print_err_msg(context, locf(@2), locl(@2), "unexpected ';' after action association declaration."); context->yynerrs++;}
 /* ERROR_CHECK_END */
 ;
 
@@ -5618,11 +5552,11 @@ action_association_list:
 step_name: any_identifier;
 
 action_association:
-  action_name '(' {cmd_goto_sfc_qualifier_state();} action_qualifier {cmd_pop_state();} indicator_name_list ')'
+  action_name '(' {cmd_goto_sfc_qualifier_state(context);} action_qualifier {cmd_pop_state(context);} indicator_name_list ')'
 	{$$ = new action_association_c($1, $4, $6, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 /*| action_name '(' error ')'
-  {$$ = NULL; print_err_msg(locf(@3), locl(@3), "invalid qualifier defined in action association."); yyerrok;}*/
+  {$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "invalid qualifier defined in action association."); yyerrok;}*/
 /* ERROR_CHECK_END */
 ;
 
@@ -5634,11 +5568,11 @@ indicator_name_list:
 	{$$ = $1; $$->add_element($3);}
 /* ERROR_CHECK_BEGIN */
 | indicator_name_list indicator_name
-	{$$ = $1; print_err_msg(locl(@1), locf(@2), "',' missing at end of action association declaration."); yynerrs++;}
+	{$$ = $1; print_err_msg(context, locl(@1), locf(@2), "',' missing at end of action association declaration."); context->yynerrs++;}
 | indicator_name_list ',' error
 	{$$ = $1;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no indicator defined in indicator list.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid indicator in indicator list."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no indicator defined in indicator list.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid indicator in indicator list."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -5656,11 +5590,11 @@ action_qualifier:
 	{$$ = new action_qualifier_c($1, $3, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | timed_qualifier action_time
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "',' missing between timed qualifier and action time in action qualifier."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "',' missing between timed qualifier and action time in action qualifier."); context->yynerrs++;}
 | timed_qualifier ',' error
 	{$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no action time defined in action qualifier.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid action time in action qualifier."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no action time defined in action qualifier.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid action time in action qualifier."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -5750,9 +5684,9 @@ steps:
 	{$$ = new steps_c(NULL, $2, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | '(' step_name_list error
-	{$$ = NULL; print_err_msg(locl(@2), locf(@3), "expecting ')' at the end of step list in transition declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locl(@2), locf(@3), "expecting ')' at the end of step list in transition declaration."); yyerrok;}
 | '(' error ')'
-	{$$ = NULL; print_err_msg(locf(@2), locl(@2), "invalid step list in transition declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "invalid step list in transition declaration."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -5763,11 +5697,11 @@ step_name_list:
 	{$$ = $1; $$->add_element($3);}
 /* ERROR_CHECK_BEGIN */
 | step_name_list step_name
-	{$$ = $1; print_err_msg(locl(@1), locf(@2), "',' missing in step list."); yynerrs++;}
+	{$$ = $1; print_err_msg(context, locl(@1), locf(@2), "',' missing in step list."); context->yynerrs++;}
 | step_name_list ',' error
 	{$$ = $1;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no step name defined in step list.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid step name in step list."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no step name defined in step list.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid step name in step list."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -5781,65 +5715,65 @@ step_name_list:
 transition:
   TRANSITION transition_priority
     FROM steps TO steps 
-    {cmd_goto_body_state();} transition_condition 
+    {cmd_goto_body_state(context);} transition_condition 
   END_TRANSITION 
 	{$$ = new transition_c(NULL, $2, $4, $6, $8, locloc(@$));}
 //| TRANSITION identifier FROM steps TO steps ... 
 | TRANSITION transition_name transition_priority
     FROM steps TO steps 
-    {cmd_goto_body_state();} transition_condition 
+    {cmd_goto_body_state(context);} transition_condition 
   END_TRANSITION 
 	{$$ = new transition_c($2, $3, $5, $7, $9, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
-| TRANSITION error transition_priority FROM steps TO steps {cmd_goto_body_state();} transition_condition END_TRANSITION
-	{$$ = NULL; print_err_msg(locf(@2), locl(@2), "invalid transition name defined in transition declaration."); yyerrok;}
-| TRANSITION transition_name error FROM steps TO steps {cmd_goto_body_state();} transition_condition END_TRANSITION
-	{$$ = NULL; print_err_msg(locf(@3), locl(@3), "invalid transition priority defined in transition declaration."); yyerrok;}
-| TRANSITION transition_priority FROM TO steps {cmd_goto_body_state();} transition_condition END_TRANSITION
-	{$$ = NULL; print_err_msg(locl(@3), locf(@4), "no origin step(s) defined in transition declaration."); yynerrs++;}
-| TRANSITION transition_name transition_priority FROM TO steps {cmd_goto_body_state();} transition_condition END_TRANSITION
-	{$$ = NULL; print_err_msg(locl(@4), locf(@5), "no origin step(s) defined in transition declaration."); yynerrs++;}
-| TRANSITION transition_priority FROM error TO steps {cmd_goto_body_state();} transition_condition END_TRANSITION
-	{$$ = NULL; print_err_msg(locf(@4), locl(@4), "invalid origin step(s) defined in transition declaration."); yyerrok;}
-| TRANSITION transition_name transition_priority FROM error TO steps {cmd_goto_body_state();} transition_condition END_TRANSITION
-	{$$ = NULL; print_err_msg(locf(@5), locl(@5), "invalid origin step(s) defined in transition declaration."); yyerrok;}
-| TRANSITION transition_priority FROM steps steps {cmd_goto_body_state();} transition_condition END_TRANSITION
-	{$$ = NULL; print_err_msg(locl(@4), locf(@5), "'TO' missing between origin step(s) and destination step(s) in transition declaration."); yynerrs++;}
-| TRANSITION transition_name transition_priority FROM steps steps {cmd_goto_body_state();} transition_condition END_TRANSITION
-	{$$ = NULL; print_err_msg(locl(@5), locf(@6), "'TO' missing between origin step(s) and destination step(s) in transition declaration."); yynerrs++;}
-| TRANSITION transition_priority FROM steps TO {cmd_goto_body_state();} transition_condition END_TRANSITION
-	{$$ = NULL; print_err_msg(locl(@5), locf(@7), "no destination step(s) defined in transition declaration."); yynerrs++;}
-| TRANSITION transition_name transition_priority FROM steps TO {cmd_goto_body_state();} transition_condition END_TRANSITION
-	{$$ = NULL; print_err_msg(locl(@6), locf(@8), "no destination step(s) defined in transition declaration."); yynerrs++;}
-| TRANSITION transition_priority FROM steps TO error {cmd_goto_body_state();} transition_condition END_TRANSITION
-	{$$ = NULL; print_err_msg(locf(@6), locl(@6), "invalid destination step(s) defined in transition declaration."); yyerrok;}
-| TRANSITION transition_name transition_priority FROM steps TO error {cmd_goto_body_state();} transition_condition END_TRANSITION
-	{$$ = NULL; print_err_msg(locf(@7), locl(@7), "invalid destination step(s) defined in transition declaration."); yyerrok;}
-| TRANSITION transition_priority {cmd_goto_body_state();} transition_condition END_TRANSITION
-	{$$ = NULL; print_err_msg(locl(@2), locf(@4), "no origin and destination step(s) defined in transition declaration."); yynerrs++;}
-| TRANSITION transition_name transition_priority {cmd_goto_body_state();} transition_condition END_TRANSITION
-	{$$ = NULL; print_err_msg(locl(@3), locf(@5), "no origin and destination step(s) defined in transition declaration."); yynerrs++;}
-/*| TRANSITION transition_priority FROM steps TO steps {cmd_goto_body_state();} transition_condition error END_OF_INPUT
-  {$$ = NULL; print_err_msg(locf(@1), locl(@6), "unclosed transition declaration."); yyerrok;}
-| TRANSITION transition_name transition_priority FROM steps TO steps {cmd_goto_body_state();} transition_condition error END_OF_INPUT
-  {$$ = NULL; print_err_msg(locf(@1), locl(@7), "unclosed transition declaration."); yyerrok;}*/
+| TRANSITION error transition_priority FROM steps TO steps {cmd_goto_body_state(context);} transition_condition END_TRANSITION
+	{$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "invalid transition name defined in transition declaration."); yyerrok;}
+| TRANSITION transition_name error FROM steps TO steps {cmd_goto_body_state(context);} transition_condition END_TRANSITION
+	{$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "invalid transition priority defined in transition declaration."); yyerrok;}
+| TRANSITION transition_priority FROM TO steps {cmd_goto_body_state(context);} transition_condition END_TRANSITION
+	{$$ = NULL; print_err_msg(context, locl(@3), locf(@4), "no origin step(s) defined in transition declaration."); context->yynerrs++;}
+| TRANSITION transition_name transition_priority FROM TO steps {cmd_goto_body_state(context);} transition_condition END_TRANSITION
+	{$$ = NULL; print_err_msg(context, locl(@4), locf(@5), "no origin step(s) defined in transition declaration."); context->yynerrs++;}
+| TRANSITION transition_priority FROM error TO steps {cmd_goto_body_state(context);} transition_condition END_TRANSITION
+	{$$ = NULL; print_err_msg(context, locf(@4), locl(@4), "invalid origin step(s) defined in transition declaration."); yyerrok;}
+| TRANSITION transition_name transition_priority FROM error TO steps {cmd_goto_body_state(context);} transition_condition END_TRANSITION
+	{$$ = NULL; print_err_msg(context, locf(@5), locl(@5), "invalid origin step(s) defined in transition declaration."); yyerrok;}
+| TRANSITION transition_priority FROM steps steps {cmd_goto_body_state(context);} transition_condition END_TRANSITION
+	{$$ = NULL; print_err_msg(context, locl(@4), locf(@5), "'TO' missing between origin step(s) and destination step(s) in transition declaration."); context->yynerrs++;}
+| TRANSITION transition_name transition_priority FROM steps steps {cmd_goto_body_state(context);} transition_condition END_TRANSITION
+	{$$ = NULL; print_err_msg(context, locl(@5), locf(@6), "'TO' missing between origin step(s) and destination step(s) in transition declaration."); context->yynerrs++;}
+| TRANSITION transition_priority FROM steps TO {cmd_goto_body_state(context);} transition_condition END_TRANSITION
+	{$$ = NULL; print_err_msg(context, locl(@5), locf(@7), "no destination step(s) defined in transition declaration."); context->yynerrs++;}
+| TRANSITION transition_name transition_priority FROM steps TO {cmd_goto_body_state(context);} transition_condition END_TRANSITION
+	{$$ = NULL; print_err_msg(context, locl(@6), locf(@8), "no destination step(s) defined in transition declaration."); context->yynerrs++;}
+| TRANSITION transition_priority FROM steps TO error {cmd_goto_body_state(context);} transition_condition END_TRANSITION
+	{$$ = NULL; print_err_msg(context, locf(@6), locl(@6), "invalid destination step(s) defined in transition declaration."); yyerrok;}
+| TRANSITION transition_name transition_priority FROM steps TO error {cmd_goto_body_state(context);} transition_condition END_TRANSITION
+	{$$ = NULL; print_err_msg(context, locf(@7), locl(@7), "invalid destination step(s) defined in transition declaration."); yyerrok;}
+| TRANSITION transition_priority {cmd_goto_body_state(context);} transition_condition END_TRANSITION
+	{$$ = NULL; print_err_msg(context, locl(@2), locf(@4), "no origin and destination step(s) defined in transition declaration."); context->yynerrs++;}
+| TRANSITION transition_name transition_priority {cmd_goto_body_state(context);} transition_condition END_TRANSITION
+	{$$ = NULL; print_err_msg(context, locl(@3), locf(@5), "no origin and destination step(s) defined in transition declaration."); context->yynerrs++;}
+/*| TRANSITION transition_priority FROM steps TO steps {cmd_goto_body_state(context);} transition_condition error END_OF_INPUT
+  {$$ = NULL; print_err_msg(context, locf(@1), locl(@6), "unclosed transition declaration."); yyerrok;}
+| TRANSITION transition_name transition_priority FROM steps TO steps {cmd_goto_body_state(context);} transition_condition error END_OF_INPUT
+  {$$ = NULL; print_err_msg(context, locf(@1), locl(@7), "unclosed transition declaration."); yyerrok;}*/
 | TRANSITION error END_TRANSITION
-	{$$ = NULL; print_err_msg(locf(@2), locl(@2), "unknown error in transition declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "unknown error in transition declaration."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
 transition_priority:
   /* empty */
   {$$ = NULL;}
-| '(' {cmd_goto_sfc_priority_state();} PRIORITY {cmd_pop_state();} ASSIGN integer ')'
+| '(' {cmd_goto_sfc_priority_state(context);} PRIORITY {cmd_pop_state(context);} ASSIGN integer ')'
 	{$$ = $6;}
 /* ERROR_CHECK_BEGIN */
 /* The following error checking rules have been intentionally commented out. */
 /*
 | '(' ASSIGN integer ')'
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "'PRIORITY' missing between '(' and ':=' in transition declaration with priority."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "'PRIORITY' missing between '(' and ':=' in transition declaration with priority."); context->yynerrs++;}
 | '(' error ASSIGN integer ')'
-	{$$ = NULL; print_err_msg(locf(@2), locl(@2), "expecting 'PRIORITY' between '(' and ':=' in transition declaration with priority."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "expecting 'PRIORITY' between '(' and ':=' in transition declaration with priority."); yyerrok;}
 */
 /* ERROR_CHECK_END */
 ;
@@ -5852,19 +5786,19 @@ transition_condition:
 	{$$ = new transition_condition_c(NULL, $2, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | start_IL_body_token eol_list simple_instr_list
-	{$$ = NULL; print_err_msg(locl(@2), locf(@3), "':' missing before IL condition in transition declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@2), locf(@3), "':' missing before IL condition in transition declaration."); context->yynerrs++;}
 | start_IL_body_token ':' eol_list error
 	{$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@3), locf(@4), "no instructions defined in IL condition of transition declaration.");}
-	 else {print_err_msg(locf(@4), locl(@4), "invalid instructions in IL condition of transition declaration."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@3), locf(@4), "no instructions defined in IL condition of transition declaration.");}
+	 else {print_err_msg(context, locf(@4), locl(@4), "invalid instructions in IL condition of transition declaration."); yyclearin;}
 	 yyerrok;
 	}
 | ASSIGN ';'
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "no expression defined in ST condition of transition declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "no expression defined in ST condition of transition declaration."); context->yynerrs++;}
 | ASSIGN error ';'
-	{$$ = NULL; print_err_msg(locf(@2), locl(@2), "invalid expression defined in ST condition of transition declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "invalid expression defined in ST condition of transition declaration."); yyerrok;}
 | ASSIGN expression error
-	{$$ = NULL; print_err_msg(locl(@2), locf(@3), "expecting ';' after expression defined in ST condition of transition declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locl(@2), locf(@3), "expecting ';' after expression defined in ST condition of transition declaration."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -5872,19 +5806,19 @@ transition_condition:
 
 action:
 //  ACTION identifier ':' ... 
-  ACTION action_name {cmd_goto_body_state();} action_body END_ACTION
+  ACTION action_name {cmd_goto_body_state(context);} action_body END_ACTION
 	{$$ = new action_c($2, $4, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
-| ACTION {cmd_goto_body_state();} action_body END_ACTION
-  {$$ = NULL; print_err_msg(locl(@1), locf(@3), "no action name defined in action declaration."); yynerrs++;}
-| ACTION error {cmd_goto_body_state();} action_body END_ACTION
-	{$$ = NULL; print_err_msg(locf(@2), locl(@2), "invalid action name defined in action declaration."); yyerrok;}
-| ACTION action_name {cmd_goto_body_state();} function_block_body END_ACTION
-	{$$ = NULL; print_err_msg(locl(@2), locf(@4), "':' missing after action name in action declaration."); yynerrs++;}
-/*| ACTION action_name {cmd_goto_body_state();} action_body END_OF_INPUT
-	{$$ = NULL; print_err_msg(locf(@1), locl(@2), "unclosed action declaration."); yyerrok;}*/
+| ACTION {cmd_goto_body_state(context);} action_body END_ACTION
+  {$$ = NULL; print_err_msg(context, locl(@1), locf(@3), "no action name defined in action declaration."); context->yynerrs++;}
+| ACTION error {cmd_goto_body_state(context);} action_body END_ACTION
+	{$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "invalid action name defined in action declaration."); yyerrok;}
+| ACTION action_name {cmd_goto_body_state(context);} function_block_body END_ACTION
+	{$$ = NULL; print_err_msg(context, locl(@2), locf(@4), "':' missing after action name in action declaration."); context->yynerrs++;}
+/*| ACTION action_name {cmd_goto_body_state(context);} action_body END_OF_INPUT
+	{$$ = NULL; print_err_msg(context, locf(@1), locl(@2), "unclosed action declaration."); yyerrok;}*/
 | ACTION error END_ACTION
-	{$$ = NULL; print_err_msg(locf(@2), locl(@2), "unknown error in action declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "unknown error in action declaration."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -5894,8 +5828,8 @@ action_body:
 /* ERROR_CHECK_BEGIN */
 | ':' error
 	{$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@1), locf(@2), "no body defined in action declaration.");}
-	 else {print_err_msg(locf(@2), locl(@2), "invalid body defined in action declaration."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@1), locf(@2), "no body defined in action declaration.");}
+	 else {print_err_msg(context, locf(@2), locl(@2), "invalid body defined in action declaration."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -5968,24 +5902,18 @@ configuration_name: identifier;
 resource_type_name: any_identifier;
 
 configuration_declaration:
-/* PRE_PARSING: The rules expected to be applied by the preparser. Will only run if pre-parsing command line option is ON. */
-  CONFIGURATION configuration_name END_CONFIGURATION   /* rule that is only expected to be used during preparse state */
-	{$$ = NULL; 
-	 if (get_preparse_state())    {library_element_symtable.insert($2, prev_declared_configuration_name_token);}
-	 else                         {print_err_msg(locl(@1), locf(@3), "no resource(s) nor program(s) defined in configuration declaration."); yynerrs++;}
-	 }
-/* POST_PARSING: The rules expected to be applied after the preparser runs. Will only run if pre-parsing command line option is ON. */
-| CONFIGURATION prev_declared_configuration_name
+/* FORWARD_DECLARED: The name was already declared by the pre-scanner. Will only run if pre-parsing command line option is ON (see prescan.hh). */
+  CONFIGURATION prev_declared_configuration_name
    global_var_declarations_list
    single_resource_declaration
-   {variable_name_symtable.pop();
-    direct_variable_symtable.pop();}
+   {context->variable_name_symtable.pop();
+    context->direct_variable_symtable.pop();}
    optional_access_declarations
    optional_instance_specific_initializations
   END_CONFIGURATION
 	{$$ = new configuration_declaration_c($2, $3, $4, $6, $7, locloc(@$));
-	 variable_name_symtable.pop();
-	 direct_variable_symtable.pop();
+	 context->variable_name_symtable.pop();
+	 context->direct_variable_symtable.pop();
 	}
 | CONFIGURATION prev_declared_configuration_name
    global_var_declarations_list
@@ -5994,22 +5922,22 @@ configuration_declaration:
    optional_instance_specific_initializations
  END_CONFIGURATION
 	{$$ = new configuration_declaration_c($2, $3, $4, $5, $6, locloc(@$));
-	 variable_name_symtable.pop();
-	 direct_variable_symtable.pop();
+	 context->variable_name_symtable.pop();
+	 context->direct_variable_symtable.pop();
 }
 /* STANDARD_PARSING: The rules expected to be applied in single-phase parsing. Will only run if pre-parsing command line option is OFF. */
 | CONFIGURATION configuration_name
    global_var_declarations_list
    single_resource_declaration
-   {variable_name_symtable.pop();
-    direct_variable_symtable.pop();}
+   {context->variable_name_symtable.pop();
+    context->direct_variable_symtable.pop();}
    optional_access_declarations
    optional_instance_specific_initializations
   END_CONFIGURATION
 	{$$ = new configuration_declaration_c($2, $3, $4, $6, $7, locloc(@$));
-	 variable_name_symtable.pop();
-	 direct_variable_symtable.pop();
-	 library_element_symtable.insert($2, prev_declared_configuration_name_token);
+	 context->variable_name_symtable.pop();
+	 context->direct_variable_symtable.pop();
+	 context->library_element_symtable.insert($2, prev_declared_configuration_name_token);
 	}
 | CONFIGURATION configuration_name
    global_var_declarations_list
@@ -6018,50 +5946,52 @@ configuration_declaration:
    optional_instance_specific_initializations
  END_CONFIGURATION
 	{$$ = new configuration_declaration_c($2, $3, $4, $5, $6, locloc(@$));
-	 variable_name_symtable.pop();
-	 direct_variable_symtable.pop();
-	 library_element_symtable.insert($2, prev_declared_configuration_name_token);
+	 context->variable_name_symtable.pop();
+	 context->direct_variable_symtable.pop();
+	 context->library_element_symtable.insert($2, prev_declared_configuration_name_token);
 }
 /* ERROR_CHECK_BEGIN */
+| CONFIGURATION configuration_name END_CONFIGURATION
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@3), "no resource(s) nor program(s) defined in configuration declaration."); context->yynerrs++;}
 | CONFIGURATION 
    global_var_declarations_list
    single_resource_declaration
-   {variable_name_symtable.pop();
-    direct_variable_symtable.pop();}
+   {context->variable_name_symtable.pop();
+    context->direct_variable_symtable.pop();}
    optional_access_declarations
    optional_instance_specific_initializations
   END_CONFIGURATION
-  {$$ = NULL; print_err_msg(locl(@1), locf(@2), "no configuration name defined in configuration declaration."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "no configuration name defined in configuration declaration."); context->yynerrs++;}
 | CONFIGURATION
    global_var_declarations_list
    resource_declaration_list
    optional_access_declarations
    optional_instance_specific_initializations
   END_CONFIGURATION
-  {$$ = NULL; print_err_msg(locl(@1), locf(@2), "no configuration name defined in configuration declaration."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "no configuration name defined in configuration declaration."); context->yynerrs++;}
 | CONFIGURATION error
    global_var_declarations_list
    single_resource_declaration
-   {variable_name_symtable.pop();
-    direct_variable_symtable.pop();}
+   {context->variable_name_symtable.pop();
+    context->direct_variable_symtable.pop();}
    optional_access_declarations
    optional_instance_specific_initializations
   END_CONFIGURATION
-  {$$ = NULL; print_err_msg(locf(@2), locl(@2), "invalid configuration name defined in configuration declaration."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "invalid configuration name defined in configuration declaration."); yyerrok;}
 | CONFIGURATION error
    global_var_declarations_list
    resource_declaration_list
    optional_access_declarations
    optional_instance_specific_initializations
   END_CONFIGURATION
-  {$$ = NULL; print_err_msg(locf(@2), locl(@2), "invalid configuration name defined in configuration declaration."); yyerrok;}
-/*  Rule already covered by the rule to handle the preparse state!
+  {$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "invalid configuration name defined in configuration declaration."); yyerrok;}
+/*  Only the case with no global variables is handled, by the 'CONFIGURATION configuration_name END_CONFIGURATION' rule above!
 | CONFIGURATION configuration_name
    global_var_declarations_list
    optional_access_declarations
    optional_instance_specific_initializations
   END_CONFIGURATION
-  {$$ = NULL; print_err_msg(locl(@3), locf(@4), "no resource(s) defined in configuration declaration."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@3), locf(@4), "no resource(s) defined in configuration declaration."); context->yynerrs++;}
 */
 | CONFIGURATION configuration_name
    global_var_declarations_list
@@ -6069,25 +5999,25 @@ configuration_declaration:
    optional_access_declarations
    optional_instance_specific_initializations
   END_CONFIGURATION
-  {$$ = NULL; print_err_msg(locf(@4), locl(@4), "invalid resource(s) defined in configuration declaration."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@4), locl(@4), "invalid resource(s) defined in configuration declaration."); yyerrok;}
 /*| CONFIGURATION configuration_name
    global_var_declarations_list
    single_resource_declaration
-   {variable_name_symtable.pop();
-    direct_variable_symtable.pop();}
+   {context->variable_name_symtable.pop();
+    context->direct_variable_symtable.pop();}
    optional_access_declarations
    optional_instance_specific_initializations
   END_OF_INPUT
-  {$$ = NULL; print_err_msg(locf(@1), locl(@2), "unclosed configuration declaration."); yyerrok;}*/
+  {$$ = NULL; print_err_msg(context, locf(@1), locl(@2), "unclosed configuration declaration."); yyerrok;}*/
 | CONFIGURATION configuration_name
    global_var_declarations_list
    resource_declaration_list
    optional_access_declarations
    optional_instance_specific_initializations
   END_OF_INPUT
-  {$$ = NULL; print_err_msg(locf(@1), locl(@2), "unclosed configuration declaration."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@1), locl(@2), "unclosed configuration declaration."); yyerrok;}
 | CONFIGURATION error END_CONFIGURATION
-	{$$ = NULL; print_err_msg(locf(@2), locl(@2), "unknown error in configuration declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "unknown error in configuration declaration."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -6142,34 +6072,34 @@ resource_declaration_list:
 	{$$ = $1; $$->add_element($2);}
 /* ERROR_CHECK_BEGIN */
 | resource_declaration_list error
-	{$$ = $1; print_err_msg(locf(@2), locl(@2), "unexpected token after resource declaration."); yyerrok;}
+	{$$ = $1; print_err_msg(context, locf(@2), locl(@2), "unexpected token after resource declaration."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
 
 resource_declaration:
-  RESOURCE {variable_name_symtable.push();direct_variable_symtable.push();} resource_name {variable_name_symtable.insert($3, prev_declared_resource_name_token);} ON resource_type_name
+  RESOURCE {context->variable_name_symtable.push();context->direct_variable_symtable.push();} resource_name {context->variable_name_symtable.insert($3, prev_declared_resource_name_token);} ON resource_type_name
    global_var_declarations_list
    single_resource_declaration
   END_RESOURCE
 	{$$ = new resource_declaration_c($3, $6, $7, $8, locloc(@$));
-	 variable_name_symtable.pop();
-	 direct_variable_symtable.pop();
-	 variable_name_symtable.insert($3, prev_declared_resource_name_token);
+	 context->variable_name_symtable.pop();
+	 context->direct_variable_symtable.pop();
+	 context->variable_name_symtable.insert($3, prev_declared_resource_name_token);
 	}
 /* ERROR_CHECK_BEGIN */
-| RESOURCE {variable_name_symtable.push();direct_variable_symtable.push();} ON resource_type_name
+| RESOURCE {context->variable_name_symtable.push();context->direct_variable_symtable.push();} ON resource_type_name
    global_var_declarations_list
    single_resource_declaration
   END_RESOURCE
-  {$$ = NULL; print_err_msg(locl(@1), locf(@3), "no resource name defined in resource declaration."); yynerrs++;}
-/*|	RESOURCE {variable_name_symtable.push();direct_variable_symtable.push();} resource_name ON resource_type_name
+  {$$ = NULL; print_err_msg(context, locl(@1), locf(@3), "no resource name defined in resource declaration."); context->yynerrs++;}
+/*|	RESOURCE {context->variable_name_symtable.push();context->direct_variable_symtable.push();} resource_name ON resource_type_name
    global_var_declarations_list
    single_resource_declaration
   END_OF_INPUT
-	{$$ = NULL; print_err_msg(locf(@1), locl(@5), "unclosed resource declaration."); yyerrok;}*/
+	{$$ = NULL; print_err_msg(context, locf(@1), locl(@5), "unclosed resource declaration."); yyerrok;}*/
 | RESOURCE error END_RESOURCE
-	{$$ = NULL; print_err_msg(locf(@2), locl(@2), "unknown error in resource declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "unknown error in resource declaration."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -6188,9 +6118,9 @@ task_configuration_list:
 	{$$ = $1; $$->add_element($2);}
 /* ERROR_CHECK_BEGIN */
 | task_configuration_list task_configuration error
-  {$$ = $1; print_err_msg(locl(@1), locf(@2), "';' missing at the end of task configuration in resource declaration."); yyerrok;}
+  {$$ = $1; print_err_msg(context, locl(@1), locf(@2), "';' missing at the end of task configuration in resource declaration."); yyerrok;}
 | task_configuration_list ';'
-  {$$ = $1; print_err_msg(locf(@2), locl(@2), "unexpected ';' after task configuration in resource declaration."); yynerrs++;}
+  {$$ = $1; print_err_msg(context, locf(@2), locl(@2), "unexpected ';' after task configuration in resource declaration."); context->yynerrs++;}
 /* ERROR_CHECK_END */
 ;
 
@@ -6203,13 +6133,13 @@ program_configuration_list:
 	{$$ = $1; $$->add_element($2);}
 /* ERROR_CHECK_BEGIN */
 | program_configuration error
-  {$$ = new program_configuration_list_c(locloc(@$)); print_err_msg(locl(@1), locf(@2), "';' missing at the end of program configuration in resource declaration."); yyerrok;}
+  {$$ = new program_configuration_list_c(locloc(@$)); print_err_msg(context, locl(@1), locf(@2), "';' missing at the end of program configuration in resource declaration."); yyerrok;}
 | program_configuration_list program_configuration error
-  {$$ = $1; print_err_msg(locl(@2), locf(@3), "';' missing at the end of program configuration in resource declaration."); yyerrok;}
+  {$$ = $1; print_err_msg(context, locl(@2), locf(@3), "';' missing at the end of program configuration in resource declaration."); yyerrok;}
 | program_configuration_list error ';'
-  {$$ = $1; print_err_msg(locf(@2), locl(@2), "invalid program configuration in resource declaration."); yyerrok;}
+  {$$ = $1; print_err_msg(context, locf(@2), locl(@2), "invalid program configuration in resource declaration."); yyerrok;}
 | program_configuration_list ';'
-  {$$ = $1; print_err_msg(locf(@2), locl(@2), "unexpected ';' after program configuration in resource declaration."); yynerrs++;}
+  {$$ = $1; print_err_msg(context, locf(@2), locl(@2), "unexpected ';' after program configuration in resource declaration."); context->yynerrs++;}
 /* ERROR_CHECK_END */
 ;
 
@@ -6222,13 +6152,13 @@ access_declarations:
 	{$$ = NULL;}
 // ERROR_CHECK_BEGIN //
 | VAR_ACCESS END_VAR
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "no variable declared in access variable(s) declaration."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "no variable declared in access variable(s) declaration."); context->yynerrs++;}
 | VAR_ACCESS error access_declaration_list END_VAR
-	{$$ = NULL; print_err_msg(locf(@2), locl(@2), "unexpected token after 'VAR_ACCESS' in access variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "unexpected token after 'VAR_ACCESS' in access variable(s) declaration."); yyerrok;}
 | VAR_ACCESS access_declaration_list error END_VAR
-	{$$ = NULL; print_err_msg(locf(@1), locl(@1), "unclosed access variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@1), locl(@1), "unclosed access variable(s) declaration."); yyerrok;}
 | VAR_ACCESS error END_VAR
-	{$$ = NULL; print_err_msg(locf(@2), locl(@2), "unknown error in access variable(s) declaration."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "unknown error in access variable(s) declaration."); yyerrok;}
 // ERROR_CHECK_END //
 ;
 
@@ -6239,16 +6169,16 @@ access_declaration_list:
 // ERROR_CHECK_BEGIN //
 | error ';'
   {$$ = // create a new list //;
-	 print_err_msg(locf(@1), locl(@1), "invalid access variable declaration."); yyerrok;}
+	 print_err_msg(context, locf(@1), locl(@1), "invalid access variable declaration."); yyerrok;}
 | access_declaration error
   {$$ = // create a new list //;
-	 print_err_msg(locl(@1), locf(@2), "';' missing at the end of access variable declaration."); yyerrok;}
+	 print_err_msg(context, locl(@1), locf(@2), "';' missing at the end of access variable declaration."); yyerrok;}
 | access_declaration_list access_declaration error
-  {$$ = $1; print_err_msg(locl(@2), locf(@3), "';' missing at the end of access variable declaration."); yyerrok;}
+  {$$ = $1; print_err_msg(context, locl(@2), locf(@3), "';' missing at the end of access variable declaration."); yyerrok;}
 | access_declaration_list error ';'
-  {$$ = $1; print_err_msg(locf(@2), locl(@2), "invalid access variable declaration."); yyerrok;}
+  {$$ = $1; print_err_msg(context, locf(@2), locl(@2), "invalid access variable declaration."); yyerrok;}
 | access_declaration_list ';'
-  {$$ = $1; print_err_msg(locf(@2), locl(@2), "unexpected ';' after access variable declaration."); yynerrs++;}
+  {$$ = $1; print_err_msg(context, locf(@2), locl(@2), "unexpected ';' after access variable declaration."); context->yynerrs++;}
 // ERROR_CHECK_END //
 ;
 
@@ -6343,13 +6273,13 @@ task_configuration:
 	{$$ = new task_configuration_c($2, $3, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | TASK task_initialization
-  {$$ = NULL; print_err_msg(locl(@1), locf(@2), "no task name defined in task declaration."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "no task name defined in task declaration."); context->yynerrs++;}
 | TASK error task_initialization
-  {$$ = NULL; print_err_msg(locf(@2), locl(@2), "invalid task name defined in task declaration."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "invalid task name defined in task declaration."); yyerrok;}
 | TASK task_name error
   {$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no task initialization defined in task declaration.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid task initialization in task declaration."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no task initialization defined in task declaration.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid task initialization in task declaration."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -6367,7 +6297,7 @@ task_name: any_identifier;
 
 task_initialization:
 //  '(' [SINGLE ASSIGN data_source ','] [INTERVAL ASSIGN data_source ','] PRIORITY ASSIGN integer ')' //
-  '(' {cmd_goto_task_init_state();} task_initialization_single task_initialization_interval task_initialization_priority ')'
+  '(' {cmd_goto_task_init_state(context);} task_initialization_single task_initialization_interval task_initialization_priority ')'
 	{$$ = new task_initialization_c($3, $4, $5, locloc(@$));}
 ;
 
@@ -6376,15 +6306,15 @@ task_initialization_single:
 // [SINGLE ASSIGN data_source ',']
   /* empty */
 	{$$ = NULL;}
-| SINGLE ASSIGN {cmd_pop_state();} data_source ',' {cmd_goto_task_init_state();} 
+| SINGLE ASSIGN {cmd_pop_state(context);} data_source ',' {cmd_goto_task_init_state(context);} 
 	{$$ = $4;}
 /* ERROR_CHECK_BEGIN */
-| SINGLE {cmd_pop_state();} data_source ',' {cmd_goto_task_init_state();}
-  {$$ = NULL; print_err_msg(locl(@1), locf(@3), "':=' missing after 'SINGLE' in task initialization."); yynerrs++;}
-| SINGLE ASSIGN {cmd_pop_state();} ',' {cmd_goto_task_init_state();}
-  {$$ = NULL; print_err_msg(locl(@2), locf(@4), "no data source defined in 'SINGLE' statement of task initialization."); yynerrs++;}
-| SINGLE ASSIGN {cmd_pop_state();} error ',' {cmd_goto_task_init_state();}
-  {$$ = NULL; print_err_msg(locf(@4), locl(@4), "invalid data source defined in 'SINGLE' statement of task initialization."); yyerrok;}
+| SINGLE {cmd_pop_state(context);} data_source ',' {cmd_goto_task_init_state(context);}
+  {$$ = NULL; print_err_msg(context, locl(@1), locf(@3), "':=' missing after 'SINGLE' in task initialization."); context->yynerrs++;}
+| SINGLE ASSIGN {cmd_pop_state(context);} ',' {cmd_goto_task_init_state(context);}
+  {$$ = NULL; print_err_msg(context, locl(@2), locf(@4), "no data source defined in 'SINGLE' statement of task initialization."); context->yynerrs++;}
+| SINGLE ASSIGN {cmd_pop_state(context);} error ',' {cmd_goto_task_init_state(context);}
+  {$$ = NULL; print_err_msg(context, locf(@4), locl(@4), "invalid data source defined in 'SINGLE' statement of task initialization."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -6393,15 +6323,15 @@ task_initialization_interval:
 // [INTERVAL ASSIGN data_source ','] 
   /* empty */
 	{$$ = NULL;}
-| INTERVAL ASSIGN {cmd_pop_state();} data_source ',' {cmd_goto_task_init_state();}
+| INTERVAL ASSIGN {cmd_pop_state(context);} data_source ',' {cmd_goto_task_init_state(context);}
 	{$$ = $4;}
 /* ERROR_CHECK_BEGIN */
-| INTERVAL {cmd_pop_state();} data_source ',' {cmd_goto_task_init_state();}
-  {$$ = NULL; print_err_msg(locl(@1), locf(@3), "':=' missing after 'INTERVAL' in task initialization.");}
-| INTERVAL ASSIGN {cmd_pop_state();} ',' {cmd_goto_task_init_state();}
-  {$$ = NULL; print_err_msg(locl(@2), locf(@4), "no data source defined in 'INTERVAL' statement of task initialization."); yynerrs++;}
-| INTERVAL ASSIGN {cmd_pop_state();} error ',' {cmd_goto_task_init_state();}
-  {$$ = NULL; print_err_msg(locf(@4), locl(@4), "invalid data source defined in 'INTERVAL' statement of task initialization."); yyerrok;}
+| INTERVAL {cmd_pop_state(context);} data_source ',' {cmd_goto_task_init_state(context);}
+  {$$ = NULL; print_err_msg(context, locl(@1), locf(@3), "':=' missing after 'INTERVAL' in task initialization.");}
+| INTERVAL ASSIGN {cmd_pop_state(context);} ',' {cmd_goto_task_init_state(context);}
+  {$$ = NULL; print_err_msg(context, locl(@2), locf(@4), "no data source defined in 'INTERVAL' statement of task initialization."); context->yynerrs++;}
+| INTERVAL ASSIGN {cmd_pop_state(context);} error ',' {cmd_goto_task_init_state(context);}
+  {$$ = NULL; print_err_msg(context, locf(@4), locl(@4), "invalid data source defined in 'INTERVAL' statement of task initialization."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -6409,15 +6339,15 @@ task_initialization_interval:
 
 task_initialization_priority:
 // PRIORITY ASSIGN integer
-  PRIORITY ASSIGN {cmd_pop_state();} integer 
+  PRIORITY ASSIGN {cmd_pop_state(context);} integer 
 	{$$ = $4;}
 /* ERROR_CHECK_BEGIN */
-| PRIORITY {cmd_pop_state();} integer
-  {$$ = NULL; print_err_msg(locl(@1), locf(@3), "':=' missing after 'PRIORITY' in task initialization."); yynerrs++;}
-| PRIORITY ASSIGN {cmd_pop_state();} error
+| PRIORITY {cmd_pop_state(context);} integer
+  {$$ = NULL; print_err_msg(context, locl(@1), locf(@3), "':=' missing after 'PRIORITY' in task initialization."); context->yynerrs++;}
+| PRIORITY ASSIGN {cmd_pop_state(context);} error
   {$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@4), "no priority number defined in 'PRIORITY' statement of task initialization.");}
-	 else {print_err_msg(locf(@4), locl(@4), "invalid priority number in 'PRIORITY' statement of task initialization."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@4), "no priority number defined in 'PRIORITY' statement of task initialization.");}
+	 else {print_err_msg(context, locf(@4), locl(@4), "invalid priority number in 'PRIORITY' statement of task initialization."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -6436,53 +6366,53 @@ program_configuration:
 //  PROGRAM [RETAIN | NON_RETAIN] program_name [WITH task_name] ':' program_type_name ['(' prog_conf_elements ')'] //
   PROGRAM program_name optional_task_name ':' prev_declared_program_type_name optional_prog_conf_elements
 	{$$ = new program_configuration_c(NULL, $2, $3, $5, $6, locloc(@$));
-	 variable_name_symtable.insert($2, prev_declared_program_name_token);
+	 context->variable_name_symtable.insert($2, prev_declared_program_name_token);
 	}
 | PROGRAM RETAIN program_name optional_task_name ':' prev_declared_program_type_name optional_prog_conf_elements
 	{$$ = new program_configuration_c(new retain_option_c(locloc(@2)), $3, $4, $6, $7, locloc(@$));
-	 variable_name_symtable.insert($3, prev_declared_program_name_token);
+	 context->variable_name_symtable.insert($3, prev_declared_program_name_token);
 	}
 | PROGRAM NON_RETAIN program_name optional_task_name ':' prev_declared_program_type_name optional_prog_conf_elements
 	{$$ = new program_configuration_c(new non_retain_option_c(locloc(@2)), $3, $4, $6, $7, locloc(@$));
-	 variable_name_symtable.insert($3, prev_declared_program_name_token);
+	 context->variable_name_symtable.insert($3, prev_declared_program_name_token);
 	}
 /* ERROR_CHECK_BEGIN */
 | PROGRAM program_name optional_task_name ':' identifier optional_prog_conf_elements
-  {$$ = NULL; print_err_msg(locf(@5), locl(@5), "invalid program type name after ':' in program configuration."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locf(@5), locl(@5), "invalid program type name after ':' in program configuration."); context->yynerrs++;}
 | PROGRAM RETAIN program_name optional_task_name ':' identifier optional_prog_conf_elements
-  {$$ = NULL; print_err_msg(locf(@6), locl(@6), "invalid program type name after ':' in program configuration."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locf(@6), locl(@6), "invalid program type name after ':' in program configuration."); context->yynerrs++;}
 | PROGRAM NON_RETAIN program_name optional_task_name ':' identifier optional_prog_conf_elements
-  {$$ = NULL; print_err_msg(locf(@6), locl(@6), "invalid program type name after ':' in program configuration."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locf(@6), locl(@6), "invalid program type name after ':' in program configuration."); context->yynerrs++;}
 | PROGRAM error program_name optional_task_name ':' prev_declared_program_type_name optional_prog_conf_elements
-  {$$ = NULL; print_err_msg(locf(@2), locl(@2), "unexpected token after 'PROGRAM' in program configuration."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "unexpected token after 'PROGRAM' in program configuration."); yyerrok;}
 | PROGRAM RETAIN error program_name optional_task_name ':' prev_declared_program_type_name optional_prog_conf_elements
-  {$$ = NULL; print_err_msg(locf(@3), locl(@3), "unexpected token after 'RETAIN' in retentive program configuration."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "unexpected token after 'RETAIN' in retentive program configuration."); yyerrok;}
 | PROGRAM NON_RETAIN error program_name optional_task_name ':' prev_declared_program_type_name optional_prog_conf_elements
-  {$$ = NULL; print_err_msg(locf(@3), locl(@3), "unexpected token after 'NON_RETAIN' in non-retentive program configuration."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "unexpected token after 'NON_RETAIN' in non-retentive program configuration."); yyerrok;}
 | PROGRAM optional_task_name ':' prev_declared_program_type_name optional_prog_conf_elements
-  {$$ = NULL; print_err_msg(locl(@1), locf(@2), "no program name defined in program configuration."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "no program name defined in program configuration."); context->yynerrs++;}
 | PROGRAM RETAIN optional_task_name ':' prev_declared_program_type_name optional_prog_conf_elements
-  {$$ = NULL; print_err_msg(locl(@2), locf(@3), "no program name defined in retentive program configuration."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@2), locf(@3), "no program name defined in retentive program configuration."); context->yynerrs++;}
 | PROGRAM NON_RETAIN optional_task_name ':' prev_declared_program_type_name optional_prog_conf_elements
-  {$$ = NULL; print_err_msg(locl(@2), locf(@3), "no program name defined in non-retentive program configuration."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@2), locf(@3), "no program name defined in non-retentive program configuration."); context->yynerrs++;}
 | PROGRAM error optional_task_name ':' prev_declared_program_type_name optional_prog_conf_elements
-  {$$ = NULL; print_err_msg(locf(@2), locl(@2), "invalid program name defined in program configuration."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "invalid program name defined in program configuration."); yyerrok;}
 | PROGRAM RETAIN error optional_task_name ':' prev_declared_program_type_name optional_prog_conf_elements
-  {$$ = NULL; print_err_msg(locf(@3), locl(@3), "invalid program name defined in retentive program configuration."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "invalid program name defined in retentive program configuration."); yyerrok;}
 | PROGRAM NON_RETAIN error optional_task_name ':' prev_declared_program_type_name optional_prog_conf_elements
-  {$$ = NULL; print_err_msg(locf(@3), locl(@3), "invalid program name defined in non-retentive program configuration."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "invalid program name defined in non-retentive program configuration."); yyerrok;}
 | PROGRAM program_name optional_task_name prev_declared_program_type_name optional_prog_conf_elements
-  {$$ = NULL; print_err_msg(locl(@3), locf(@4), "':' missing after program name or optional task name in program configuration."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@3), locf(@4), "':' missing after program name or optional task name in program configuration."); context->yynerrs++;}
 | PROGRAM RETAIN program_name optional_task_name prev_declared_program_type_name optional_prog_conf_elements
-  {$$ = NULL; print_err_msg(locl(@4), locf(@5), "':' missing after program name or optional task name in retentive program configuration."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@4), locf(@5), "':' missing after program name or optional task name in retentive program configuration."); context->yynerrs++;}
 | PROGRAM NON_RETAIN program_name optional_task_name prev_declared_program_type_name optional_prog_conf_elements
-  {$$ = NULL; print_err_msg(locl(@4), locf(@5), "':' missing after program name or optional task name in non-retentive program configuration."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@4), locf(@5), "':' missing after program name or optional task name in non-retentive program configuration."); context->yynerrs++;}
 | PROGRAM program_name optional_task_name ':' optional_prog_conf_elements
-  {$$ = NULL; print_err_msg(locl(@4), locf(@5), "no program type defined in program configuration."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@4), locf(@5), "no program type defined in program configuration."); context->yynerrs++;}
 | PROGRAM RETAIN program_name optional_task_name ':' optional_prog_conf_elements
-  {$$ = NULL; print_err_msg(locl(@5), locf(@6), "no program type defined in retentive program configuration."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@5), locf(@6), "no program type defined in retentive program configuration."); context->yynerrs++;}
 | PROGRAM NON_RETAIN program_name optional_task_name ':' optional_prog_conf_elements
-  {$$ = NULL; print_err_msg(locl(@5), locf(@6), "no program type defined in non-retentive program configuration."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@5), locf(@6), "no program type defined in non-retentive program configuration."); context->yynerrs++;}
 /* ERROR_CHECK_END */
 ;
 
@@ -6495,8 +6425,8 @@ optional_task_name:
 /* ERROR_CHECK_BEGIN */
 | WITH error
   {$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@1), locf(@2), "no task name defined in optional task name of program configuration.");}
-	 else {print_err_msg(locf(@2), locl(@2), "invalid task name in optional task name of program configuration."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@1), locf(@2), "no task name defined in optional task name of program configuration.");}
+	 else {print_err_msg(context, locf(@2), locl(@2), "invalid task name in optional task name of program configuration."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -6510,9 +6440,9 @@ optional_prog_conf_elements:
 	{$$ = $2;}
 /* ERROR_CHECK_BEGIN */
 | '(' error ')'
-  {$$ = NULL; print_err_msg(locf(@2), locl(@2), "invalid program configuration elements in program configuration."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "invalid program configuration elements in program configuration."); yyerrok;}
 | '(' prog_conf_elements error
-  {$$ = NULL; print_err_msg(locl(@2), locf(@3), "')' missing at the end of program configuration elements in program configuration."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locl(@2), locf(@3), "')' missing at the end of program configuration elements in program configuration."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -6524,11 +6454,11 @@ prog_conf_elements:
 	{$$ = $1; $$->add_element($3);}
 /* ERROR_CHECK_BEGIN */
 | prog_conf_elements prog_conf_element
-  {$$ = $1; print_err_msg(locl(@1), locf(@2), "',' missing in program configuration elements list."); yynerrs++;}
+  {$$ = $1; print_err_msg(context, locl(@1), locf(@2), "',' missing in program configuration elements list."); context->yynerrs++;}
 | prog_conf_elements ',' error
   {$$ = $1;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no value defined for program configuration element in program configuration list.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid value for program configuration element in program configuration list."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no value defined for program configuration element in program configuration list.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid value for program configuration element in program configuration list."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -6552,8 +6482,8 @@ fb_task:
 /* ERROR_CHECK_BEGIN */
 | any_identifier WITH error
   {$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no task name defined in function block configuration.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid task name in function block configuration."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no task name defined in function block configuration.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid task name in function block configuration."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -6597,21 +6527,21 @@ prog_cnxn:
 	{$$ = new prog_cnxn_sendto_c($1, $3, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | any_symbolic_variable constant
-  {$$ = NULL; print_err_msg(locl(@1), locf(@2), "':=' missing between parameter and value in program configuration element."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':=' missing between parameter and value in program configuration element."); context->yynerrs++;}
 | any_symbolic_variable enumerated_value
-  {$$ = NULL; print_err_msg(locl(@1), locf(@2), "':=' missing between parameter and value in program configuration element."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':=' missing between parameter and value in program configuration element."); context->yynerrs++;}
 | any_symbolic_variable data_sink
-  {$$ = NULL; print_err_msg(locl(@1), locf(@2), "':=' or '=>' missing between parameter and variable in program configuration element."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':=' or '=>' missing between parameter and variable in program configuration element."); context->yynerrs++;}
 | any_symbolic_variable ASSIGN error
   {$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no value or variable defined in program configuration assignment element.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid value or variable in program configuration assignment element."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no value or variable defined in program configuration assignment element.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid value or variable in program configuration assignment element."); yyclearin;}
 	 yyerrok;
 	}
 | any_symbolic_variable SENDTO error
   {$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no variable defined in program configuration sendto element.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid variable in program configuration sendto element."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no variable defined in program configuration sendto element.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid variable in program configuration sendto element."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -6634,13 +6564,13 @@ instance_specific_initializations:
 	{$$ = new instance_specific_initializations_c($2, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | VAR_CONFIG END_VAR
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "no variable declared in configuration variable(s) initialization."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "no variable declared in configuration variable(s) initialization."); context->yynerrs++;}
 | VAR_CONFIG error instance_specific_init_list END_VAR
-	{$$ = NULL; print_err_msg(locf(@2), locl(@2), "unexpected token after 'VAR_CONFIG' in configuration variable(s) initialization."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "unexpected token after 'VAR_CONFIG' in configuration variable(s) initialization."); yyerrok;}
 | VAR_CONFIG instance_specific_init_list error END_OF_INPUT
-	{$$ = NULL; print_err_msg(locf(@1), locl(@1), "unclosed configuration variable(s) initialization."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@1), locl(@1), "unclosed configuration variable(s) initialization."); yyerrok;}
 | VAR_CONFIG error END_VAR
-	{$$ = NULL; print_err_msg(locf(@2), locl(@2), "unknown error in configuration variable(s) initialization."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "unknown error in configuration variable(s) initialization."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -6652,15 +6582,15 @@ instance_specific_init_list:
 	{$$ = $1; $$->add_element($2);}
 /* ERROR_CHECK_BEGIN */
 | error ';'
-  {$$ = new instance_specific_init_list_c(locloc(@$)); print_err_msg(locf(@1), locl(@1), "invalid configuration variable initialization."); yyerrok;}
+  {$$ = new instance_specific_init_list_c(locloc(@$)); print_err_msg(context, locf(@1), locl(@1), "invalid configuration variable initialization."); yyerrok;}
 | instance_specific_init error
-  {$$ = new instance_specific_init_list_c(locloc(@$)); print_err_msg(locl(@1), locf(@2), "';' missing at the end of configuration variable initialization."); yyerrok;}
+  {$$ = new instance_specific_init_list_c(locloc(@$)); print_err_msg(context, locl(@1), locf(@2), "';' missing at the end of configuration variable initialization."); yyerrok;}
 | instance_specific_init_list instance_specific_init error
-  {$$ = $1; print_err_msg(locl(@2), locf(@3), "';' missing at the end of configuration variable initialization."); yyerrok;}
+  {$$ = $1; print_err_msg(context, locl(@2), locf(@3), "';' missing at the end of configuration variable initialization."); yyerrok;}
 | instance_specific_init_list error ';'
-  {$$ = $1; print_err_msg(locf(@2), locl(@2), "invalid configuration variable initialization."); yyerrok;}
+  {$$ = $1; print_err_msg(context, locf(@2), locl(@2), "invalid configuration variable initialization."); yyerrok;}
 | instance_specific_init_list ';'
-  {$$ = $1; print_err_msg(locf(@2), locl(@2), "unexpected ';' after configuration variable initialization."); yynerrs++;}
+  {$$ = $1; print_err_msg(context, locf(@2), locl(@2), "unexpected ';' after configuration variable initialization."); context->yynerrs++;}
 /* ERROR_CHECK_END */
 ;
 
@@ -6693,11 +6623,11 @@ fb_initialization:
 	{$$ = new fb_initialization_c($1, $3, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | function_block_type_name structure_initialization
-  {$$ = NULL; print_err_msg(locl(@1), locf(@2), "':=' missing between function block name and initialization in function block initialization."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':=' missing between function block name and initialization in function block initialization."); context->yynerrs++;}
 | function_block_type_name ASSIGN error
   {$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no initial value defined in function block initialization.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid initial value in function block initialization."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no initial value defined in function block initialization.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid initial value in function block initialization."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -6738,17 +6668,17 @@ il_instruction:
 	{$$ = new il_instruction_c($1, NULL, locf(@1), locl(@2));} /* locf(@1), locl(@2) is not a bug! We ignore trailing EOLs when determining symbol location! */
 /* ERROR_CHECK_BEGIN */
 | error eol_list
-	{$$ = NULL; print_err_msg(locf(@1), locl(@1), "invalid IL instruction."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@1), locl(@1), "invalid IL instruction."); yyerrok;}
 | il_incomplete_instruction error
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "EOL missing at the end of IL instruction."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "EOL missing at the end of IL instruction."); yyerrok;}
 | error ':' il_incomplete_instruction eol_list
-	{$$ = NULL; print_err_msg(locf(@1), locl(@1), "invalid label in IL instruction."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@1), locl(@1), "invalid label in IL instruction."); yyerrok;}
 | label il_incomplete_instruction eol_list
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "':' missing after label in IL instruction."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':' missing after label in IL instruction."); context->yynerrs++;}
 | label ':' error eol_list
-	{$$ = NULL; print_err_msg(locf(@3), locl(@3), "invalid IL instruction."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "invalid IL instruction."); yyerrok;}
 | label ':' il_incomplete_instruction error
-	{$$ = NULL; print_err_msg(locl(@3), locf(@4), "EOL missing at the end of IL instruction."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locl(@3), locf(@4), "EOL missing at the end of IL instruction."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -6899,19 +6829,19 @@ il_expression:
 	{$$ = new il_expression_c($1, NULL, $2, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | il_expr_operator_noclash '(' eol_list error
-  {$$ = NULL; print_err_msg(locl(@3), locf(@4), "')' missing at the end of IL expression."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locl(@3), locf(@4), "')' missing at the end of IL expression."); yyerrok;}
 | il_expr_operator_noclash '(' il_operand eol_list error
-  {$$ = NULL; print_err_msg(locl(@4), locf(@5), "')' missing at the end of IL expression."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locl(@4), locf(@5), "')' missing at the end of IL expression."); yyerrok;}
 | il_expr_operator_noclash '(' eol_list simple_instr_list error
-  {$$ = NULL; print_err_msg(locl(@4), locf(@5), "')' missing at the end of IL expression."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locl(@4), locf(@5), "')' missing at the end of IL expression."); yyerrok;}
 | il_expr_operator_noclash '(' il_operand eol_list simple_instr_list error
-  {$$ = NULL; print_err_msg(locl(@5), locf(@6), "')' missing at the end of IL expression."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locl(@5), locf(@6), "')' missing at the end of IL expression."); yyerrok;}
 | il_expr_operator_clash '(' il_operand eol_list error
-  {$$ = NULL; print_err_msg(locl(@4), locf(@5), "')' missing at the end of IL expression."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locl(@4), locf(@5), "')' missing at the end of IL expression."); yyerrok;}
 | il_expr_operator_clash '(' il_operand eol_list simple_instr_list error
-  {$$ = NULL; print_err_msg(locl(@5), locf(@6), "')' missing at the end of IL expression."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locl(@5), locf(@6), "')' missing at the end of IL expression."); yyerrok;}
 | il_expr_operator_clash_eol_list simple_instr_list error
-  {$$ = NULL; print_err_msg(locl(@2), locf(@3), "')' missing at the end of IL expression."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locl(@2), locf(@3), "')' missing at the end of IL expression."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -6921,7 +6851,7 @@ il_jump_operation:
 	{$$ = new il_jump_operation_c($1, $2, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | il_jump_operator error
-  {$$ = NULL; print_err_msg(locf(@2), locl(@2), "invalid label defined in IL jump operation."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "invalid label defined in IL jump operation."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -6941,36 +6871,36 @@ il_fb_call:
 /* ERROR_CHECK_BEGIN */
 | il_call_operator error
   {$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@1), locf(@2), "no function block name defined in IL function block call.");}
-	 else {print_err_msg(locf(@2), locl(@2), "invalid function block name in IL function block call."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@1), locf(@2), "no function block name defined in IL function block call.");}
+	 else {print_err_msg(context, locf(@2), locl(@2), "invalid function block name in IL function block call."); yyclearin;}
 	 yyerrok;
 	}
 | il_call_operator '(' ')'
-  {$$ = NULL; print_err_msg(locl(@1), locf(@2), "no function block name defined in IL function block call."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "no function block name defined in IL function block call."); context->yynerrs++;}
 | il_call_operator '(' eol_list ')'
-  {$$ = NULL; print_err_msg(locl(@1), locf(@2), "no function block name defined in IL function block call."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "no function block name defined in IL function block call."); context->yynerrs++;}
 | il_call_operator '(' il_operand_list ')'
-  {$$ = NULL; print_err_msg(locl(@1), locf(@2), "no function block name defined in IL function block call."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "no function block name defined in IL function block call."); context->yynerrs++;}
 | il_call_operator '(' eol_list il_param_list ')'
-  {$$ = NULL; print_err_msg(locl(@1), locf(@2), "no function block name defined in IL function block call."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "no function block name defined in IL function block call."); context->yynerrs++;}
 | il_call_operator error '(' ')'
-  {$$ = NULL; print_err_msg(locf(@2), locl(@2), "invalid function block name defined in IL function block call."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "invalid function block name defined in IL function block call."); yyerrok;}
 | il_call_operator error '(' eol_list ')'
-  {$$ = NULL; print_err_msg(locf(@2), locl(@2), "invalid function block name defined in IL function block call."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "invalid function block name defined in IL function block call."); yyerrok;}
 | il_call_operator error '(' il_operand_list ')'
-  {$$ = NULL; print_err_msg(locf(@2), locl(@2), "invalid function block name defined in IL function block call."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "invalid function block name defined in IL function block call."); yyerrok;}
 | il_call_operator error '(' eol_list il_param_list ')'
-  {$$ = NULL; print_err_msg(locf(@2), locl(@2), "invalid function block name defined in IL function block call."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "invalid function block name defined in IL function block call."); yyerrok;}
 | il_call_operator prev_declared_fb_name ')'
-  {$$ = NULL; print_err_msg(locl(@2), locf(@3), "'(' missing after function block name defined in IL function block call."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@2), locf(@3), "'(' missing after function block name defined in IL function block call."); context->yynerrs++;}
 | il_call_operator prev_declared_fb_name il_operand_list ')'
-  {$$ = NULL; print_err_msg(locl(@2), locf(@3), "'(' missing after function block name defined in IL function block call."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@2), locf(@3), "'(' missing after function block name defined in IL function block call."); context->yynerrs++;}
 | il_call_operator prev_declared_fb_name '(' error
-  {$$ = NULL; print_err_msg(locl(@3), locf(@4), "')' missing at the end of IL function block call."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locl(@3), locf(@4), "')' missing at the end of IL function block call."); yyerrok;}
 | il_call_operator prev_declared_fb_name '(' eol_list error
-  {$$ = NULL; print_err_msg(locl(@4), locf(@5), "')' missing at the end of IL function block call."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locl(@4), locf(@5), "')' missing at the end of IL function block call."); yyerrok;}
 | il_call_operator prev_declared_fb_name '(' il_operand_list error
-  {$$ = NULL; print_err_msg(locl(@4), locf(@5), "')' missing at the end of IL function block call."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locl(@4), locf(@5), "')' missing at the end of IL function block call."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -7040,11 +6970,11 @@ il_formal_funct_call:
 	{$$ = new il_formal_funct_call_c(il_operator_c_2_poutype_identifier_c($1), $2, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | function_name_no_clashes '(' eol_list error ')'
-  {$$ = NULL; print_err_msg(locf(@4), locl(@4), "invalid parameter list defined in IL formal function call."); yyerrok;} 
+  {$$ = NULL; print_err_msg(context, locf(@4), locl(@4), "invalid parameter list defined in IL formal function call."); yyerrok;} 
 | function_name_simpleop_clashes '(' eol_list error ')'
-  {$$ = NULL; print_err_msg(locf(@4), locl(@4), "invalid parameter list defined in IL formal function call."); yyerrok;} 
+  {$$ = NULL; print_err_msg(context, locf(@4), locl(@4), "invalid parameter list defined in IL formal function call."); yyerrok;} 
 | il_expr_operator_clash_eol_list error ')'
-  {$$ = NULL; print_err_msg(locf(@2), locl(@2), "invalid parameter list defined in IL formal function call."); yyerrok;} 
+  {$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "invalid parameter list defined in IL formal function call."); yyerrok;} 
 /* ERROR_CHECK_END */
 ;
 
@@ -7054,7 +6984,7 @@ il_expr_operator_clash_eol_list:
 	{$$ = $1;}
 /* ERROR_CHECK_BEGIN */
 | il_expr_operator_clash '(' error
-  {$$ = $1; print_err_msg(locl(@2), locf(@3), "EOL missing after '(' in IL instruction."); yyerrok;}
+  {$$ = $1; print_err_msg(context, locl(@2), locf(@3), "EOL missing after '(' in IL instruction."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -7081,11 +7011,11 @@ il_operand_list2:
 	{$$ = $1; $$->add_element($3);}
 /* ERROR_CHECK_BEGIN */
 | il_operand_list2 il_operand
-  {$$ = $1; print_err_msg(locl(@1), locf(@2), "',' missing in IL operand list."); yynerrs++;}
+  {$$ = $1; print_err_msg(context, locl(@1), locf(@2), "',' missing in IL operand list."); context->yynerrs++;}
 | il_operand ',' error
   {$$ = new il_operand_list_c(locloc(@$));
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no operand defined in IL operand list.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid operand name in IL operand list."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no operand defined in IL operand list.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid operand name in IL operand list."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -7109,9 +7039,9 @@ il_simple_instruction:
 	{$$ = new il_simple_instruction_c($1, locloc(@1));} /* locloc(@1) is not a bug! We ignore trailing EOLs when determining symbol location! */
 /* ERROR_CHECK_BEGIN */
 | il_expression error
-  {$$ = NULL; print_err_msg(locl(@1), locf(@2), "EOL missing after expression IL instruction."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "EOL missing after expression IL instruction."); yyerrok;}
 | il_formal_funct_call error
-  {$$ = NULL; print_err_msg(locl(@1), locf(@2), "EOL missing after formal function call IL instruction."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "EOL missing after formal function call IL instruction."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -7137,11 +7067,11 @@ il_param_list:
 	{$$ = new il_param_list_c(locloc(@$)); $$->add_element($1);}
 /* ERROR_CHECK_BEGIN */
 | il_param_instruction_list error
-  {$$ = $1; print_err_msg(locf(@2), locl(@2), "invalid parameter assignment in parameter assignment list."); yyerrok;}
+  {$$ = $1; print_err_msg(context, locf(@2), locl(@2), "invalid parameter assignment in parameter assignment list."); yyerrok;}
 | il_param_last_instruction il_param_last_instruction
-  {$$ = new il_param_list_c(locloc(@$)); print_err_msg(locl(@1), locf(@2), "',' missing at the end of parameter assignment in parameter assignment list."); yynerrs++;}
+  {$$ = new il_param_list_c(locloc(@$)); print_err_msg(context, locl(@1), locf(@2), "',' missing at the end of parameter assignment in parameter assignment list."); context->yynerrs++;}
 | il_param_instruction_list il_param_last_instruction il_param_last_instruction
-  {$$ = $1; print_err_msg(locl(@2), locf(@3), "',' missing at the end of parameter assignment in parameter assignment list."); yynerrs++;}
+  {$$ = $1; print_err_msg(context, locl(@2), locf(@3), "',' missing at the end of parameter assignment in parameter assignment list."); context->yynerrs++;}
 /* ERROR_CHECK_END */
 ;
 
@@ -7154,9 +7084,9 @@ il_param_instruction_list:
 	{$$ = $1; $$->add_element($2);}
 /* ERROR_CHECK_BEGIN */
 | il_param_last_instruction il_param_instruction
-  {$$ = new il_param_list_c(locloc(@$)); print_err_msg(locl(@1), locf(@2), "',' missing at the end of parameter assignment in parameter assignment list."); yynerrs++;}
+  {$$ = new il_param_list_c(locloc(@$)); print_err_msg(context, locl(@1), locf(@2), "',' missing at the end of parameter assignment in parameter assignment list."); context->yynerrs++;}
 | il_param_instruction_list il_param_last_instruction il_param_instruction
-  {$$ = $1; print_err_msg(locl(@2), locf(@3), "',' missing at the end of parameter assignment in parameter assignment list."); yynerrs++;}
+  {$$ = $1; print_err_msg(context, locl(@2), locf(@3), "',' missing at the end of parameter assignment in parameter assignment list."); context->yynerrs++;}
 /* ERROR_CHECK_END */
 ;
 
@@ -7166,9 +7096,9 @@ il_param_instruction:
 | il_param_out_assignment ',' eol_list
 /* ERROR_CHECK_BEGIN */
 | il_param_assignment ',' error
-  {$$ = NULL; print_err_msg(locl(@2), locf(@3), "EOL missing at the end of parameter assignment in parameter assignment list."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locl(@2), locf(@3), "EOL missing at the end of parameter assignment in parameter assignment list."); yyerrok;}
 | il_param_out_assignment ',' error
-  {$$ = NULL; print_err_msg(locl(@2), locf(@3), "EOL missing at the end of parameter out assignment in parameter assignment list."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locl(@2), locf(@3), "EOL missing at the end of parameter out assignment in parameter assignment list."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -7178,9 +7108,9 @@ il_param_last_instruction:
 | il_param_out_assignment eol_list
 /* ERROR_CHECK_BEGIN */
 | il_param_assignment error
-  {$$ = NULL; print_err_msg(locl(@1), locf(@2), "EOL missing at the end of last parameter assignment in parameter assignment list."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "EOL missing at the end of last parameter assignment in parameter assignment list."); yyerrok;}
 | il_param_out_assignment error
-  {$$ = NULL; print_err_msg(locl(@1), locf(@2), "EOL missing at the end of last parameter out assignment in parameter assignment list."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "EOL missing at the end of last parameter out assignment in parameter assignment list."); yyerrok;}
 /* ERROR_CHECK_END */
 
 ;
@@ -7193,21 +7123,21 @@ il_param_assignment:
 	{$$ = new il_param_assignment_c($1, NULL, $4, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | error il_operand
-  {$$ = NULL; print_err_msg(locf(@1), locl(@1), "invalid operator in parameter assignment."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@1), locl(@1), "invalid operator in parameter assignment."); yyerrok;}
 | error '(' eol_list simple_instr_list ')'
-  {$$ = NULL; print_err_msg(locf(@1), locl(@1), "invalid operator in parameter assignment."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@1), locl(@1), "invalid operator in parameter assignment."); yyerrok;}
 | il_assign_operator error
   {$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@1), locf(@2), "no operand defined in parameter assignment.");}
-	 else {print_err_msg(locf(@2), locl(@2), "invalid operand in parameter assignment."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@1), locf(@2), "no operand defined in parameter assignment.");}
+	 else {print_err_msg(context, locf(@2), locl(@2), "invalid operand in parameter assignment."); yyclearin;}
 	 yyerrok;
 	}
 | il_assign_operator '(' eol_list ')'
-  {$$ = NULL; print_err_msg(locl(@3), locf(@4), "no instruction list defined in parameter assignment."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@3), locf(@4), "no instruction list defined in parameter assignment."); context->yynerrs++;}
 | il_assign_operator '(' eol_list error ')'
-  {$$ = NULL; print_err_msg(locf(@4), locl(@4), "invalid instruction list defined in parameter assignment."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@4), locl(@4), "invalid instruction list defined in parameter assignment."); yyerrok;}
 | il_assign_operator '(' eol_list simple_instr_list error
-  {$$ = NULL; print_err_msg(locl(@4), locf(@5), "')' missing at the end of instruction list defined in parameter assignment."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locl(@4), locf(@5), "')' missing at the end of instruction list defined in parameter assignment."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -7218,8 +7148,8 @@ il_param_out_assignment:
 /* ERROR_CHECK_BEGIN */
 | il_assign_out_operator error
   {$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@1), locf(@2), "no variable defined in IL operand list.");}
-	 else {print_err_msg(locf(@2), locl(@2), "invalid variable in IL operand list."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@1), locf(@2), "no variable defined in IL operand list.");}
+	 else {print_err_msg(context, locf(@2), locl(@2), "invalid variable in IL operand list."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -7387,7 +7317,7 @@ il_assign_operator:
 	{$$ = new il_assign_operator_c(il_operator_c_2_identifier_c($1), locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | error ASSIGN
-  {$$ = NULL; print_err_msg(locf(@1), locl(@1), "invalid parameter defined in parameter assignment."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@1), locl(@1), "invalid parameter defined in parameter assignment."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -7460,11 +7390,11 @@ il_assign_out_operator:
 */
 /* ERROR_CHECK_BEGIN */
 | error SENDTO
-  {$$ = NULL; print_err_msg(locf(@1), locl(@1), "invalid parameter defined in parameter out assignment."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@1), locl(@1), "invalid parameter defined in parameter out assignment."); yyerrok;}
 | NOT SENDTO
-  {$$ = NULL; print_err_msg(locl(@1), locf(@2), "no parameter defined in parameter out assignment."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "no parameter defined in parameter out assignment."); context->yynerrs++;}
 | NOT error SENDTO
-  {$$ = NULL; print_err_msg(locf(@2), locl(@2), "invalid parameter defined in parameter out assignment."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "invalid parameter defined in parameter out assignment."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -7502,8 +7432,8 @@ expression:
 /* ERROR_CHECK_BEGIN */
 | expression OR error
   {$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no expression defined after 'OR' in ST expression.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid expression after 'OR' in ST expression."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no expression defined after 'OR' in ST expression.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid expression after 'OR' in ST expression."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -7532,8 +7462,8 @@ xor_expression:
 /* ERROR_CHECK_BEGIN */
 | xor_expression XOR error
   {$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no expression defined after 'XOR' in ST expression.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid expression after 'XOR' in ST expression."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no expression defined after 'XOR' in ST expression.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid expression after 'XOR' in ST expression."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -7557,20 +7487,20 @@ and_expression:
 /* ERROR_CHECK_BEGIN */
 | and_expression '&' error
   {$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no expression defined after '&' in ST expression.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid expression after '&' in ST expression."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no expression defined after '&' in ST expression.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid expression after '&' in ST expression."); yyclearin;}
 	 yyerrok;
 	}
 | and_expression AND error
   {$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no expression defined after 'AND' in ST expression.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid expression after 'AND' in ST expression."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no expression defined after 'AND' in ST expression.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid expression after 'AND' in ST expression."); yyclearin;}
 	 yyerrok;
 	}
 | and_expression AND2 error
   {$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no expression defined after '&' in ST expression.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid expression after '&' in ST expression."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no expression defined after '&' in ST expression.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid expression after '&' in ST expression."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -7585,14 +7515,14 @@ comparison:
 /* ERROR_CHECK_BEGIN */
 | comparison '=' error
   {$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no expression defined after '=' in ST expression.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid expression after '=' in ST expression."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no expression defined after '=' in ST expression.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid expression after '=' in ST expression."); yyclearin;}
 	 yyerrok;
 	}
 | comparison OPER_NE error
   {$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no expression defined after '<>' in ST expression.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid expression after '<>' in ST expression."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no expression defined after '<>' in ST expression.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid expression after '<>' in ST expression."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -7611,26 +7541,26 @@ equ_expression:
 /* ERROR_CHECK_BEGIN */
 | equ_expression '<' error
   {$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no expression defined after '<' in ST expression.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid expression after '<' in ST expression."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no expression defined after '<' in ST expression.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid expression after '<' in ST expression."); yyclearin;}
 	 yyerrok;
 	}
 | equ_expression '>' error
   {$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no expression defined after '>' in ST expression.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid expression after '>' in ST expression."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no expression defined after '>' in ST expression.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid expression after '>' in ST expression."); yyclearin;}
 	 yyerrok;
 	}
 | equ_expression OPER_LE error
   {$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no expression defined after '<=' in ST expression.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid expression after '<=' in ST expression."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no expression defined after '<=' in ST expression.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid expression after '<=' in ST expression."); yyclearin;}
 	 yyerrok;
 	}
 | equ_expression OPER_GE error
   {$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no expression defined after '>=' in ST expression.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid expression after '>=' in ST expression."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no expression defined after '>=' in ST expression.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid expression after '>=' in ST expression."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -7649,14 +7579,14 @@ add_expression:
 /* ERROR_CHECK_BEGIN */
 | add_expression '+' error
   {$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no expression defined after '+' in ST expression.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid expression after '+' in ST expression."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no expression defined after '+' in ST expression.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid expression after '+' in ST expression."); yyclearin;}
 	 yyerrok;
 	}
 | add_expression '-' error
   {$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no expression defined after '-' in ST expression.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid expression after '-' in ST expression."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no expression defined after '-' in ST expression.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid expression after '-' in ST expression."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -7677,20 +7607,20 @@ term:
 /* ERROR_CHECK_BEGIN */
 | term '*' error
   {$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no expression defined after '*' in ST expression.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid expression after '*' in ST expression."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no expression defined after '*' in ST expression.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid expression after '*' in ST expression."); yyclearin;}
 	 yyerrok;
 	}
 | term '/' error
   {$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no expression defined after '/' in ST expression.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid expression after '/' in ST expression."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no expression defined after '/' in ST expression.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid expression after '/' in ST expression."); yyclearin;}
 	 yyerrok;
 	}
 | term MOD error
   {$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no expression defined after 'MOD' in ST expression.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid expression after 'MOD' in ST expression."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no expression defined after 'MOD' in ST expression.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid expression after 'MOD' in ST expression."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -7707,8 +7637,8 @@ power_expression:
 /* ERROR_CHECK_BEGIN */
 | power_expression OPER_EXP error
   {$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no expression defined after '**' in ST expression.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid expression after '**' in ST expression."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no expression defined after '**' in ST expression.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid expression after '**' in ST expression."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -7724,14 +7654,14 @@ unary_expression:
 /* ERROR_CHECK_BEGIN */
 | '-' error
   {$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@1), locf(@2), "no expression defined after '-' in ST expression.");}
-	 else {print_err_msg(locf(@2), locl(@2), "invalid expression after '-' in ST expression."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@1), locf(@2), "no expression defined after '-' in ST expression.");}
+	 else {print_err_msg(context, locf(@2), locl(@2), "invalid expression after '-' in ST expression."); yyclearin;}
 	 yyerrok;
 	}
 | NOT error
   {$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@1), locf(@2), "no expression defined after 'NOT' in ST expression.");}
-	 else {print_err_msg(locf(@2), locl(@2), "invalid expression after 'NOT' in ST expression."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@1), locf(@2), "no expression defined after 'NOT' in ST expression.");}
+	 else {print_err_msg(context, locf(@2), locl(@2), "invalid expression after 'NOT' in ST expression."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -7802,7 +7732,7 @@ non_int_or_real_primary_expression:
 |  function_invocation
 /* ERROR_CHECK_BEGIN */
 | '(' expression error
-  {$$ = NULL; print_err_msg(locl(@2), locf(@3), "')' missing at the end of expression in ST expression."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locl(@2), locf(@3), "')' missing at the end of expression in ST expression."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -7817,7 +7747,7 @@ primary_expression:
 |  function_invocation
 /* ERROR_CHECK_BEGIN */
 | '(' expression error
-  {$$ = NULL; print_err_msg(locl(@2), locf(@3), "')' missing at the end of expression in ST expression."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locl(@2), locf(@3), "')' missing at the end of expression in ST expression."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -7857,20 +7787,20 @@ function_invocation:
 	{$$ = new function_invocation_c($1, NULL, $3, locloc(@$)); if (NULL == dynamic_cast<poutype_identifier_c*>($1)) ERROR;} // $1 should be a poutype_identifier_c
 | function_name_no_NOT_clashes '(' ')'
 	{if (NULL == dynamic_cast<poutype_identifier_c*>($1)) ERROR; // $1 should be a poutype_identifier_c
-	 if (runtime_options.allow_missing_var_in)
+	 if (context->options.allow_missing_var_in)
 		{$$ = new function_invocation_c($1, NULL, NULL, locloc(@$));}
 	 else
-		{$$ = NULL; print_err_msg(locl(@2), locf(@3), "no parameter defined in function invocation of ST expression."); yynerrs++;}
+		{$$ = NULL; print_err_msg(context, locl(@2), locf(@3), "no parameter defined in function invocation of ST expression."); context->yynerrs++;}
 	}
 /* ERROR_CHECK_BEGIN */ 
 | function_name_no_NOT_clashes param_assignment_formal_list ')'
-  {$$ = NULL; print_err_msg(locl(@1), locf(@2), "'(' missing after function name in ST expression."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "'(' missing after function name in ST expression."); context->yynerrs++;}
 | function_name_no_NOT_clashes '(' error ')'
-  {$$ = NULL; print_err_msg(locf(@3), locl(@3), "invalid parameter(s) defined in function invocation of ST expression."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "invalid parameter(s) defined in function invocation of ST expression."); yyerrok;}
 | function_name_no_NOT_clashes '(' param_assignment_formal_list error
-  {$$ = NULL; print_err_msg(locl(@3), locf(@4), "')' missing at the end of function invocation in ST expression."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locl(@3), locf(@4), "')' missing at the end of function invocation in ST expression."); yyerrok;}
 | function_name_no_NOT_clashes '(' param_assignment_nonformal_list error
-  {$$ = NULL; print_err_msg(locl(@3), locf(@4), "')' missing at the end of function invocation in ST expression."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locl(@3), locf(@4), "')' missing at the end of function invocation in ST expression."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -7889,13 +7819,13 @@ statement_list:
 	{$$ = $1; $$->add_element($2);}
 /* ERROR_CHECK_BEGIN */
 | statement error
-	{$$ = new statement_list_c(locloc(@$)); print_err_msg(locl(@1), locf(@2), "';' missing at the end of statement in ST statement."); yyerrok;}
+	{$$ = new statement_list_c(locloc(@$)); print_err_msg(context, locl(@1), locf(@2), "';' missing at the end of statement in ST statement."); yyerrok;}
 | statement_list statement error
-	{$$ = $1; print_err_msg(locl(@2), locf(@3), "';' missing at the end of statement in ST statement."); yyerrok;}
+	{$$ = $1; print_err_msg(context, locl(@2), locf(@3), "';' missing at the end of statement in ST statement."); yyerrok;}
 | statement_list error ';'
-	{$$ = $1; print_err_msg(locf(@2), locl(@2), "invalid statement in ST statement."); yyerrok;}
+	{$$ = $1; print_err_msg(context, locf(@2), locl(@2), "invalid statement in ST statement."); yyerrok;}
 | statement_list ';'
-	{$$ = $1; print_err_msg(locf(@2), locl(@2), "unexpected ';' after statement in ST statement."); yynerrs++;}
+	{$$ = $1; print_err_msg(context, locf(@2), locl(@2), "unexpected ';' after statement in ST statement."); context->yynerrs++;}
 /* ERROR_CHECK_END */
 ;
 
@@ -7909,9 +7839,9 @@ statement:
 	{ /* This is a non-standard extension (calling a function outside an ST expression!) */
 	  /* Only allow this if command line option has been selected...                     */
 	  $$ = $1; 
-	  if (!runtime_options.allow_void_datatype) {
-	    print_err_msg(locf(@1), locl(@1), "Function invocation in ST code is not allowed outside an expression. To allow this non-standard syntax, activate the apropriate command line option."); 
-	    yynerrs++;
+	  if (!context->options.allow_void_datatype) {
+	    print_err_msg(context, locf(@1), locl(@1), "Function invocation in ST code is not allowed outside an expression. To allow this non-standard syntax, activate the apropriate command line option."); 
+	    context->yynerrs++;
 	  }
 	}  
 ;
@@ -7925,11 +7855,11 @@ assignment_statement:
 	{$$ = new assignment_statement_c($1, $3, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | error ASSIGN expression
-  {$$ = NULL; print_err_msg(locf(@1), locl(@1), "invalid variable before ':=' in ST assignment statement."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@1), locl(@1), "invalid variable before ':=' in ST assignment statement."); yyerrok;}
 | variable ASSIGN error
 	{$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no expression defined after ':=' in ST assignment statement.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid expression after ':=' in ST assignment statement."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no expression defined after ':=' in ST assignment statement.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid expression after ':=' in ST assignment statement."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -7961,17 +7891,17 @@ fb_invocation:
 	{$$ = new fb_invocation_c($1, NULL, $3, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | prev_declared_fb_name ')'
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "'(' missing after function block name in ST statement."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "'(' missing after function block name in ST statement."); context->yynerrs++;}
 | prev_declared_fb_name param_assignment_formal_list ')'
-	{$$ = NULL; print_err_msg(locl(@1), locf(@2), "'(' missing after function block name in ST statement."); yynerrs++;}
+	{$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "'(' missing after function block name in ST statement."); context->yynerrs++;}
 | prev_declared_fb_name '(' error ')'
-	{$$ = NULL; print_err_msg(locf(@3), locl(@3), "invalid parameter list in function block invocation in ST statement."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "invalid parameter list in function block invocation in ST statement."); yyerrok;}
 | prev_declared_fb_name '(' error
-	{$$ = NULL; print_err_msg(locl(@2), locf(@3), "')' missing after parameter list of function block invocation in ST statement."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locl(@2), locf(@3), "')' missing after parameter list of function block invocation in ST statement."); yyerrok;}
 | prev_declared_fb_name '(' param_assignment_formal_list error
-	{$$ = NULL; print_err_msg(locl(@3), locf(@4), "')' missing after parameter list of function block invocation in ST statement."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locl(@3), locf(@4), "')' missing after parameter list of function block invocation in ST statement."); yyerrok;}
 | prev_declared_fb_name '(' param_assignment_nonformal_list error
-	{$$ = NULL; print_err_msg(locl(@3), locf(@4), "')' missing after parameter list of function block invocation in ST statement."); yyerrok;}
+	{$$ = NULL; print_err_msg(context, locl(@3), locf(@4), "')' missing after parameter list of function block invocation in ST statement."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -7988,8 +7918,8 @@ param_assignment_formal_list:
 /* ERROR_CHECK_BEGIN */
 | param_assignment_formal_list ',' error
   {$$ = $1;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no parameter assignment defined in ST parameter assignment list.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid parameter assignment in ST parameter assignment list."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no parameter assignment defined in ST parameter assignment list.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid parameter assignment in ST parameter assignment list."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -8007,8 +7937,8 @@ param_assignment_nonformal_list:
 /* ERROR_CHECK_BEGIN */
 | param_assignment_nonformal_list ',' error
   {$$ = $1;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no parameter assignment defined in ST parameter assignment list.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid parameter assignment in ST parameter assignment list."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no parameter assignment defined in ST parameter assignment list.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid parameter assignment in ST parameter assignment list."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -8089,45 +8019,45 @@ param_assignment_formal:
 /* ERROR_CHECK_BEGIN */
 | any_identifier ASSIGN error
   {$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no expression defined in ST formal parameter assignment.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid expression in ST formal parameter assignment."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no expression defined in ST formal parameter assignment.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid expression in ST formal parameter assignment."); yyclearin;}
 	 yyerrok;
 	}
 | en_identifier ASSIGN error
   {$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no expression defined in ST formal parameter assignment.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid expression in ST formal parameter assignment."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no expression defined in ST formal parameter assignment.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid expression in ST formal parameter assignment."); yyclearin;}
 	 yyerrok;
 	}
 | sendto_identifier SENDTO error
   {$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no expression defined in ST formal parameter out assignment.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid expression in ST formal parameter out assignment."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no expression defined in ST formal parameter out assignment.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid expression in ST formal parameter out assignment."); yyclearin;}
 	 yyerrok;
 	}
 /*
 | eno_identifier SENDTO error
   {$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no expression defined in ST formal parameter out assignment.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid expression in ST formal parameter out assignment."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no expression defined in ST formal parameter out assignment.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid expression in ST formal parameter out assignment."); yyclearin;}
 	 yyerrok;
 	}
 */
 | NOT SENDTO variable
-  {$$ = NULL; print_err_msg(locl(@1), locf(@2), "no parameter name defined in ST formal parameter out negated assignment."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "no parameter name defined in ST formal parameter out negated assignment."); context->yynerrs++;}
 | NOT error SENDTO variable
-  {$$ = NULL; print_err_msg(locf(@2), locl(@2), "invalid parameter name defined in ST formal parameter out negated assignment."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "invalid parameter name defined in ST formal parameter out negated assignment."); yyerrok;}
 | NOT sendto_identifier SENDTO error
   {$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@3), locf(@4), "no expression defined in ST formal parameter out negated assignment.");}
-	 else {print_err_msg(locf(@4), locl(@4), "invalid expression in ST formal parameter out negated assignment."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@3), locf(@4), "no expression defined in ST formal parameter out negated assignment.");}
+	 else {print_err_msg(context, locf(@4), locl(@4), "invalid expression in ST formal parameter out negated assignment."); yyclearin;}
 	 yyerrok;
 	}
 /*
 | NOT eno_identifier SENDTO error
   {$$ = NULL;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@3), locf(@4), "no expression defined in ST formal parameter out negated assignment.");}
-	 else {print_err_msg(locf(@4), locl(@4), "invalid expression in ST formal parameter out negated assignment."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@3), locf(@4), "no expression defined in ST formal parameter out negated assignment.");}
+	 else {print_err_msg(context, locf(@4), locl(@4), "invalid expression in ST formal parameter out negated assignment."); yyclearin;}
 	 yyerrok;
 	}
 */
@@ -8154,33 +8084,33 @@ if_statement:
 	{$$ = new if_statement_c($2, $4, $5, $7, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | IF THEN statement_list elseif_statement_list END_IF
-  {$$ = NULL; print_err_msg(locl(@1), locf(@2), "no test expression defined in ST 'IF' statement."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "no test expression defined in ST 'IF' statement."); context->yynerrs++;}
 | IF THEN statement_list elseif_statement_list ELSE statement_list END_IF
-  {$$ = NULL; print_err_msg(locl(@1), locf(@2), "no test expression defined in ST 'IF' statement."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "no test expression defined in ST 'IF' statement."); context->yynerrs++;}
 | IF error THEN statement_list elseif_statement_list END_IF
-  {$$ = NULL; print_err_msg(locf(@2), locl(@2), "invalid test expression defined for ST 'IF' statement."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "invalid test expression defined for ST 'IF' statement."); yyerrok;}
 | IF error THEN statement_list elseif_statement_list ELSE statement_list END_IF
-  {$$ = NULL; print_err_msg(locf(@2), locl(@2), "invalid test expression defined for ST 'IF' statement."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "invalid test expression defined for ST 'IF' statement."); yyerrok;}
 | IF expression error statement_list elseif_statement_list END_IF
-  {$$ = NULL; print_err_msg(locf(@3), locl(@3), "expecting 'THEN' after test expression in ST 'IF' statement."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "expecting 'THEN' after test expression in ST 'IF' statement."); yyerrok;}
 | IF expression error statement_list elseif_statement_list ELSE statement_list END_IF
-  {$$ = NULL; print_err_msg(locf(@3), locl(@3), "expecting 'THEN' after test expression in ST 'IF' statement."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "expecting 'THEN' after test expression in ST 'IF' statement."); yyerrok;}
 | IF expression THEN elseif_statement_list END_IF
-  {$$ = NULL; print_err_msg(locl(@3), locf(@4), "no statement defined after 'THEN' in ST 'IF' statement."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@3), locf(@4), "no statement defined after 'THEN' in ST 'IF' statement."); context->yynerrs++;}
 | IF expression THEN elseif_statement_list ELSE statement_list END_IF
-  {$$ = NULL; print_err_msg(locl(@3), locf(@4), "no statement defined after 'THEN' in ST 'IF' statement."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@3), locf(@4), "no statement defined after 'THEN' in ST 'IF' statement."); context->yynerrs++;}
 | IF expression THEN statement_list elseif_statement_list ELSE END_IF
-  {$$ = NULL; print_err_msg(locl(@6), locf(@7), "no statement defined after 'ELSE' in ST 'IF' statement."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@6), locf(@7), "no statement defined after 'ELSE' in ST 'IF' statement."); context->yynerrs++;}
 | IF expression THEN statement_list elseif_statement_list ELSE error END_IF
-  {$$ = NULL; print_err_msg(locf(@7), locl(@7), "invalid statement defined after 'ELSE' in ST 'IF' statement."); yynerrs++; yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@7), locl(@7), "invalid statement defined after 'ELSE' in ST 'IF' statement."); context->yynerrs++; yyerrok;}
 | IF expression error END_OF_INPUT
-  {$$ = NULL; print_err_msg(locf(@1), locl(@2), "unclosed 'IF' statement in ST."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@1), locl(@2), "unclosed 'IF' statement in ST."); yyerrok;}
 | IF expression THEN statement_list elseif_statement_list END_OF_INPUT
-  {$$ = NULL; print_err_msg(locf(@1), locl(@3), "unclosed 'IF' statement in ST."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locf(@1), locl(@3), "unclosed 'IF' statement in ST."); context->yynerrs++;}
 | IF expression THEN statement_list elseif_statement_list ELSE statement_list END_OF_INPUT
-  {$$ = NULL; print_err_msg(locf(@1), locl(@3), "unclosed 'IF' statement in ST."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locf(@1), locl(@3), "unclosed 'IF' statement in ST."); context->yynerrs++;}
 | IF error END_IF
-  {$$ = NULL; print_err_msg(locf(@2), locl(@2), "unknown error in ST 'IF' statement."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "unknown error in ST 'IF' statement."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -8198,13 +8128,13 @@ elseif_statement:
 	{$$ = new elseif_statement_c($2, $4, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | ELSIF THEN statement_list
-  {$$ = NULL; print_err_msg(locl(@1), locf(@2), "no test expression defined for 'ELSEIF' statement in ST 'IF' statement."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "no test expression defined for 'ELSEIF' statement in ST 'IF' statement."); context->yynerrs++;}
 | ELSIF error THEN statement_list
-  {$$ = NULL; print_err_msg(locf(@2), locl(@2), "invalid test expression defined for 'ELSEIF' statement in ST 'IF' statement."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "invalid test expression defined for 'ELSEIF' statement in ST 'IF' statement."); yyerrok;}
 | ELSIF expression error statement_list
-  {$$ = NULL; print_err_msg(locf(@3), locl(@3), "expecting 'THEN' after test expression in 'ELSEIF' statement of ST 'IF' statement."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "expecting 'THEN' after test expression in 'ELSEIF' statement of ST 'IF' statement."); yyerrok;}
 | ELSIF expression THEN error
-  {$$ = NULL; print_err_msg(locf(@4), locl(@4), "invalid statement list in 'ELSEIF' statement of ST 'IF' statement."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@4), locl(@4), "invalid statement list in 'ELSEIF' statement of ST 'IF' statement."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -8216,37 +8146,37 @@ case_statement:
 	{$$ = new case_statement_c($2, $4, $6, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | CASE OF case_element_list END_CASE
-  {$$ = NULL; print_err_msg(locl(@1), locf(@2), "no test expression defined in ST 'CASE' statement."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "no test expression defined in ST 'CASE' statement."); context->yynerrs++;}
 | CASE OF case_element_list ELSE statement_list END_CASE
-  {$$ = NULL; print_err_msg(locl(@1), locf(@2), "no test expression defined in ST 'CASE' statement."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "no test expression defined in ST 'CASE' statement."); context->yynerrs++;}
 | CASE error OF case_element_list END_CASE
-  {$$ = NULL; print_err_msg(locf(@2), locl(@2), "invalid test expression defined for ST 'CASE' statement."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "invalid test expression defined for ST 'CASE' statement."); yyerrok;}
 | CASE error OF case_element_list ELSE statement_list END_CASE
-  {$$ = NULL; print_err_msg(locf(@2), locl(@2), "invalid test expression defined for ST 'CASE' statement."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "invalid test expression defined for ST 'CASE' statement."); yyerrok;}
 | CASE expression error case_element_list END_CASE
-  {$$ = NULL; print_err_msg(locf(@3), locl(@3), "expecting 'OF' after test expression in ST 'CASE' statement."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "expecting 'OF' after test expression in ST 'CASE' statement."); yyerrok;}
 | CASE expression error case_element_list ELSE statement_list END_CASE
-  {$$ = NULL; print_err_msg(locf(@3), locl(@3), "expecting 'OF' after test expression in ST 'CASE' statement."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "expecting 'OF' after test expression in ST 'CASE' statement."); yyerrok;}
 | CASE expression OF END_CASE
-  {$$ = NULL; print_err_msg(locl(@3), locf(@4), "no case element(s) defined after 'OF' in ST 'CASE' statement."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@3), locf(@4), "no case element(s) defined after 'OF' in ST 'CASE' statement."); context->yynerrs++;}
 | CASE expression OF ELSE statement_list END_CASE
-  {$$ = NULL; print_err_msg(locl(@3), locf(@4), "no case element(s) defined after 'OF' in ST 'CASE' statement."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@3), locf(@4), "no case element(s) defined after 'OF' in ST 'CASE' statement."); context->yynerrs++;}
 | CASE expression OF error END_CASE
-  {$$ = NULL; print_err_msg(locf(@4), locl(@4), "invalid case element(s) defined after 'OF' in ST 'CASE' statement."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@4), locl(@4), "invalid case element(s) defined after 'OF' in ST 'CASE' statement."); yyerrok;}
 | CASE expression OF error ELSE statement_list END_CASE
-  {$$ = NULL; print_err_msg(locf(@4), locl(@4), "invalid case element(s) defined after 'OF' in ST 'CASE' statement."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@4), locl(@4), "invalid case element(s) defined after 'OF' in ST 'CASE' statement."); yyerrok;}
 | CASE expression OF case_element_list ELSE END_CASE
-  {$$ = NULL; print_err_msg(locl(@5), locf(@6), "no statement defined after 'ELSE' in ST 'CASE' statement."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@5), locf(@6), "no statement defined after 'ELSE' in ST 'CASE' statement."); context->yynerrs++;}
 | CASE expression OF case_element_list ELSE error END_CASE
-  {$$ = NULL; print_err_msg(locf(@6), locl(@6), "invalid statement defined after 'ELSE' in ST 'CASE' statement."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@6), locl(@6), "invalid statement defined after 'ELSE' in ST 'CASE' statement."); yyerrok;}
 | CASE expression error END_OF_INPUT
-  {$$ = NULL; print_err_msg(locf(@1), locl(@2), "unclosed 'CASE' statement in ST."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@1), locl(@2), "unclosed 'CASE' statement in ST."); yyerrok;}
 | CASE expression OF case_element_list END_OF_INPUT
-  {$$ = NULL; print_err_msg(locf(@1), locl(@3), "unclosed 'CASE' statement in ST."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locf(@1), locl(@3), "unclosed 'CASE' statement in ST."); context->yynerrs++;}
 | CASE expression OF case_element_list ELSE statement_list END_OF_INPUT
-  {$$ = NULL; print_err_msg(locf(@1), locl(@3), "unclosed 'CASE' statement in ST."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locf(@1), locl(@3), "unclosed 'CASE' statement in ST."); context->yynerrs++;}
 | CASE error END_CASE
-  {$$ = NULL; print_err_msg(locf(@2), locl(@2), "unknown error in ST 'CASE' statement."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "unknown error in ST 'CASE' statement."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -8265,9 +8195,9 @@ case_element:
 	{$$ = new case_element_c($1, $3, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | case_list statement_list
-  {$$ = NULL; print_err_msg(locl(@1), locf(@2), "':' missing after case list in ST 'CASE' statement."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "':' missing after case list in ST 'CASE' statement."); context->yynerrs++;}
 | case_list ':' error
-  {$$ = NULL; print_err_msg(locf(@3), locl(@3), "invalid statement in case element of ST 'CASE' statement."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "invalid statement in case element of ST 'CASE' statement."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -8280,8 +8210,8 @@ case_list:
 /* ERROR_CHECK_BEGIN */
 | case_list ',' error
   {$$ = $1;
-	 if (is_current_syntax_token()) {print_err_msg(locl(@2), locf(@3), "no case defined in case list of ST parameter assignment list.");}
-	 else {print_err_msg(locf(@3), locl(@3), "invalid case in case list of ST parameter assignment list."); yyclearin;}
+	 if (is_current_syntax_token(yychar)) {print_err_msg(context, locl(@2), locf(@3), "no case defined in case list of ST parameter assignment list.");}
+	 else {print_err_msg(context, locf(@3), locl(@3), "invalid case in case list of ST parameter assignment list."); yyclearin;}
 	 yyerrok;
 	}
 /* ERROR_CHECK_END */
@@ -8316,59 +8246,59 @@ for_statement:
 	{$$ = new for_statement_c($2, $4, $6, NULL, $8, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | FOR ASSIGN expression TO expression BY expression DO statement_list END_FOR
-  {$$ = NULL; print_err_msg(locl(@1), locf(@2), "no control variable defined in ST 'FOR' statement."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "no control variable defined in ST 'FOR' statement."); context->yynerrs++;}
 | FOR ASSIGN expression TO expression DO statement_list END_FOR
-  {$$ = NULL; print_err_msg(locl(@1), locf(@2), "no control variable defined in ST 'FOR' statement."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "no control variable defined in ST 'FOR' statement."); context->yynerrs++;}
 | FOR error ASSIGN expression TO expression BY expression DO statement_list END_FOR
-  {$$ = NULL; print_err_msg(locf(@2), locl(@2), "invalid control variable defined for ST 'FOR' statement."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "invalid control variable defined for ST 'FOR' statement."); yyerrok;}
 | FOR error ASSIGN expression TO expression DO statement_list END_FOR
-  {$$ = NULL; print_err_msg(locf(@2), locl(@2), "invalid control variable defined for ST 'FOR' statement."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "invalid control variable defined for ST 'FOR' statement."); yyerrok;}
 | FOR control_variable expression TO expression BY expression DO statement_list END_FOR
-  {$$ = NULL; print_err_msg(locl(@2), locf(@3), "':=' missing between control variable and start expression in ST 'FOR' statement."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@2), locf(@3), "':=' missing between control variable and start expression in ST 'FOR' statement."); context->yynerrs++;}
 | FOR control_variable expression TO expression DO statement_list END_FOR
-  {$$ = NULL; print_err_msg(locl(@2), locf(@3), "':=' missing between control variable and start expression in ST 'FOR' statement."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@2), locf(@3), "':=' missing between control variable and start expression in ST 'FOR' statement."); context->yynerrs++;}
 | FOR control_variable error expression TO expression BY expression DO statement_list END_FOR
-  {$$ = NULL; print_err_msg(locf(@3), locl(@3), "expecting ':=' between control variable and start expression in ST 'FOR' statement."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "expecting ':=' between control variable and start expression in ST 'FOR' statement."); yyerrok;}
 | FOR control_variable error expression TO expression DO statement_list END_FOR
-  {$$ = NULL; print_err_msg(locf(@3), locl(@3), "expecting ':=' between control variable and start expression in ST 'FOR' statement."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "expecting ':=' between control variable and start expression in ST 'FOR' statement."); yyerrok;}
 | FOR control_variable ASSIGN TO expression BY expression DO statement_list END_FOR
-  {$$ = NULL; print_err_msg(locl(@3), locf(@4), "no start expression defined in ST 'FOR' statement."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@3), locf(@4), "no start expression defined in ST 'FOR' statement."); context->yynerrs++;}
 | FOR control_variable ASSIGN TO expression DO statement_list END_FOR
-  {$$ = NULL; print_err_msg(locl(@3), locf(@4), "no start expression defined in ST 'FOR' statement."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@3), locf(@4), "no start expression defined in ST 'FOR' statement."); context->yynerrs++;}
 | FOR control_variable ASSIGN error TO expression BY expression DO statement_list END_FOR
-  {$$ = NULL; print_err_msg(locf(@4), locl(@4), "invalid start expression defined in ST 'FOR' statement."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@4), locl(@4), "invalid start expression defined in ST 'FOR' statement."); yyerrok;}
 | FOR control_variable ASSIGN error TO expression DO statement_list END_FOR
-  {$$ = NULL; print_err_msg(locf(@4), locl(@4), "invalid start expression in ST 'FOR' statement."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@4), locl(@4), "invalid start expression in ST 'FOR' statement."); yyerrok;}
 | FOR control_variable ASSIGN expression error expression BY expression DO statement_list END_FOR
-  {$$ = NULL; print_err_msg(locf(@5), locl(@5), "expecting 'TO' between start expression and end expression in ST 'FOR' statement."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@5), locl(@5), "expecting 'TO' between start expression and end expression in ST 'FOR' statement."); yyerrok;}
 | FOR control_variable ASSIGN expression error expression DO statement_list END_FOR
-  {$$ = NULL; print_err_msg(locf(@5), locl(@5), "expecting 'TO' between start expression and end expression in ST 'FOR' statement."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@5), locl(@5), "expecting 'TO' between start expression and end expression in ST 'FOR' statement."); yyerrok;}
 | FOR control_variable ASSIGN expression TO expression error expression DO statement_list END_FOR
-  {$$ = NULL; print_err_msg(locf(@7), locl(@7), "expecting 'BY' between end expression and step expression in ST 'FOR' statement."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@7), locl(@7), "expecting 'BY' between end expression and step expression in ST 'FOR' statement."); yyerrok;}
 | FOR control_variable ASSIGN expression TO expression BY expression error statement_list END_FOR
-  {$$ = NULL; print_err_msg(locf(@9), locl(@9), "expecting 'DO' after step expression in ST 'FOR' statement."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@9), locl(@9), "expecting 'DO' after step expression in ST 'FOR' statement."); yyerrok;}
 | FOR control_variable ASSIGN expression TO expression error statement_list END_FOR
-  {$$ = NULL; print_err_msg(locf(@7), locl(@7), "expecting 'DO' after end expression in ST 'FOR' statement."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@7), locl(@7), "expecting 'DO' after end expression in ST 'FOR' statement."); yyerrok;}
 | FOR control_variable ASSIGN expression TO expression BY expression DO END_FOR
-  {$$ = NULL; print_err_msg(locl(@9), locf(@10), "no statement(s) defined after 'DO' in ST 'FOR' statement."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@9), locf(@10), "no statement(s) defined after 'DO' in ST 'FOR' statement."); context->yynerrs++;}
 | FOR control_variable ASSIGN expression TO expression DO END_FOR
-  {$$ = NULL; print_err_msg(locl(@7), locf(@8), "no statement(s) defined after 'DO' in ST 'FOR' statement."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@7), locf(@8), "no statement(s) defined after 'DO' in ST 'FOR' statement."); context->yynerrs++;}
 | FOR control_variable ASSIGN expression TO expression BY expression DO error END_FOR
-  {$$ = NULL; print_err_msg(locf(@10), locl(@10), "invalid statement(s) defined after 'DO' in ST 'FOR' statement."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@10), locl(@10), "invalid statement(s) defined after 'DO' in ST 'FOR' statement."); yyerrok;}
 | FOR control_variable ASSIGN expression TO expression DO error END_FOR
-  {$$ = NULL; print_err_msg(locf(@8), locl(@8), "invalid statement(s) defined after 'DO' in ST 'FOR' statement."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@8), locl(@8), "invalid statement(s) defined after 'DO' in ST 'FOR' statement."); yyerrok;}
 | FOR control_variable error END_OF_INPUT
-  {$$ = NULL; print_err_msg(locf(@1), locl(@1), "unclosed 'FOR' statement in ST."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@1), locl(@1), "unclosed 'FOR' statement in ST."); yyerrok;}
 | FOR control_variable ASSIGN expression error END_OF_INPUT
-  {$$ = NULL; print_err_msg(locf(@1), locl(@1), "unclosed 'FOR' statement in ST."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@1), locl(@1), "unclosed 'FOR' statement in ST."); yyerrok;}
 | FOR control_variable ASSIGN expression TO expression DO statement_list END_OF_INPUT
-  {$$ = NULL; print_err_msg(locf(@1), locl(@1), "unclosed 'FOR' statement in ST."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locf(@1), locl(@1), "unclosed 'FOR' statement in ST."); context->yynerrs++;}
 | FOR control_variable ASSIGN expression TO expression BY expression error END_OF_INPUT
-  {$$ = NULL; print_err_msg(locf(@1), locl(@1), "unclosed 'FOR' statement in ST."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@1), locl(@1), "unclosed 'FOR' statement in ST."); yyerrok;}
 | FOR control_variable ASSIGN expression TO expression BY expression DO statement_list END_OF_INPUT
-  {$$ = NULL; print_err_msg(locf(@1), locl(@1), "unclosed 'FOR' statement in ST."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locf(@1), locl(@1), "unclosed 'FOR' statement in ST."); context->yynerrs++;}
 | FOR error END_FOR
-  {$$ = NULL; print_err_msg(locf(@2), locl(@2), "unknown error in ST 'FOR' statement."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "unknown error in ST 'FOR' statement."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -8404,21 +8334,21 @@ while_statement:
 	{$$ = new while_statement_c($2, $4, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | WHILE DO statement_list END_WHILE
-  {$$ = NULL; print_err_msg(locl(@1), locf(@2), "no test expression defined in ST 'WHILE' statement."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "no test expression defined in ST 'WHILE' statement."); context->yynerrs++;}
 | WHILE error DO statement_list END_WHILE
-  {$$ = NULL; print_err_msg(locf(@2), locl(@2), "invalid test expression defined for ST 'WHILE' statement."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "invalid test expression defined for ST 'WHILE' statement."); yyerrok;}
 | WHILE expression error statement_list END_WHILE
-  {$$ = NULL; print_err_msg(locf(@3), locl(@3), "expecting 'DO' after test expression in ST 'WHILE' statement."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@3), locl(@3), "expecting 'DO' after test expression in ST 'WHILE' statement."); yyerrok;}
 | WHILE expression DO END_WHILE
-  {$$ = NULL; print_err_msg(locl(@3), locf(@4), "no statement(s) defined after 'DO' in ST 'WHILE' statement."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@3), locf(@4), "no statement(s) defined after 'DO' in ST 'WHILE' statement."); context->yynerrs++;}
 | WHILE expression DO error END_WHILE
-  {$$ = NULL; print_err_msg(locf(@4), locl(@4), "invalid statement(s) defined after 'DO' in ST 'WHILE' statement."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@4), locl(@4), "invalid statement(s) defined after 'DO' in ST 'WHILE' statement."); yyerrok;}
 | WHILE expression error END_OF_INPUT
-  {$$ = NULL; print_err_msg(locf(@1), locl(@1), "unclosed 'WHILE' statement in ST."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@1), locl(@1), "unclosed 'WHILE' statement in ST."); yyerrok;}
 | WHILE expression DO statement_list END_OF_INPUT
-  {$$ = NULL; print_err_msg(locf(@1), locl(@1), "unclosed 'WHILE' statement in ST."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locf(@1), locl(@1), "unclosed 'WHILE' statement in ST."); context->yynerrs++;}
 | WHILE error END_WHILE
-  {$$ = NULL; print_err_msg(locf(@2), locl(@2), "unknown error in ST 'WHILE' statement."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "unknown error in ST 'WHILE' statement."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -8428,19 +8358,19 @@ repeat_statement:
 	{$$ = new repeat_statement_c($2, $4, locloc(@$));}
 /* ERROR_CHECK_BEGIN */
 | REPEAT UNTIL expression END_REPEAT
-  {$$ = NULL; print_err_msg(locl(@1), locf(@2), "no statement(s) defined after 'REPEAT' in ST 'REPEAT' statement."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locl(@1), locf(@2), "no statement(s) defined after 'REPEAT' in ST 'REPEAT' statement."); context->yynerrs++;}
 | REPEAT error UNTIL expression END_REPEAT
-  {$$ = NULL; print_err_msg(locf(@2), locl(@2), "invalid statement(s) defined after 'REPEAT' for ST 'REPEAT' statement."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "invalid statement(s) defined after 'REPEAT' for ST 'REPEAT' statement."); yyerrok;}
 | REPEAT statement_list UNTIL END_REPEAT
-  {$$ = NULL; print_err_msg(locl(@3), locf(@4), "no test expression defined after 'UNTIL' in ST 'REPEAT' statement.");}
+  {$$ = NULL; print_err_msg(context, locl(@3), locf(@4), "no test expression defined after 'UNTIL' in ST 'REPEAT' statement.");}
 | REPEAT statement_list UNTIL error END_REPEAT
-  {$$ = NULL; print_err_msg(locf(@4), locl(@4), "invalid test expression defined after 'UNTIL' in ST 'REPEAT' statement."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@4), locl(@4), "invalid test expression defined after 'UNTIL' in ST 'REPEAT' statement."); yyerrok;}
 | REPEAT statement_list END_OF_INPUT
-  {$$ = NULL; print_err_msg(locf(@1), locl(@1), "unclosed 'REPEAT' statement in ST."); yynerrs++;}
+  {$$ = NULL; print_err_msg(context, locf(@1), locl(@1), "unclosed 'REPEAT' statement in ST."); context->yynerrs++;}
 | REPEAT statement_list UNTIL expression error END_OF_INPUT
-  {$$ = NULL; print_err_msg(locf(@1), locl(@1), "unclosed 'REPEAT' statement in ST."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@1), locl(@1), "unclosed 'REPEAT' statement in ST."); yyerrok;}
 | REPEAT error END_REPEAT
-  {$$ = NULL; print_err_msg(locf(@2), locl(@2), "unknown error in ST 'REPEAT' statement."); yyerrok;}
+  {$$ = NULL; print_err_msg(context, locf(@2), locl(@2), "unknown error in ST 'REPEAT' statement."); yyerrok;}
 /* ERROR_CHECK_END */
 ;
 
@@ -8456,6 +8386,7 @@ exit_statement:
 %%
 
 #include <stdio.h>	/* required for printf() */
+#include "../config/config.h"
 #include <errno.h>
 #include "../util/symtable.hh"
 
@@ -8463,22 +8394,15 @@ exit_statement:
 
 
 /*************************************************************************************************/
-/* NOTE: These variables are really parameters we would like the stage2__ function to pass       */
-/*       to the yyparse() function. However, the yyparse() function is created automatically     */
-/*       by bison, so we cannot add parameters to this function. The only other                  */
-/*       option is to use global variables! yuck!                                                */ 
+/* The parameters stage2__() passes to yyparse(), in the parse_context_t (see stage1_2_priv.hh)  */
 /*************************************************************************************************/
 
-/* A global flag used to tell the parser if overloaded funtions should be allowed.
+/* allow_function_overloading: tells the parser if overloaded funtions should be allowed.
  * The IEC 61131-3 standard allows overloaded funtions in the standard library,
  * but disallows them in user code...
- *
- * In essence, a parameter we would like to pass to the yyparse() function but
- * have to do it using a global variable, as the yyparse() prototype is fixed by bison.
  */
-bool allow_function_overloading = false;
 
-/* | [var1_list ','] variable_name '..' */
+/* allow_extensible_function_parameters: | [var1_list ','] variable_name '..' */
 /* NOTE: This is an extension to the standard!!! */
 /* In order to be able to handle extensible standard functions
  * (i.e. standard functions that may have a variable number of
@@ -8498,17 +8422,20 @@ bool allow_function_overloading = false;
  * written code, so we only allow this extra syntax while parsing the 
  * 'header' file that declares all the standard IEC 61131-3 functions.
  */
-bool allow_extensible_function_parameters = false;
 
-/* A global flag used to tell the parser whether to allow use of DREF and '^' operators (defined in IEC 61131-3 v3) */
-bool allow_ref_dereferencing;
-/* A global flag used to tell the parser whether to allow use of REF_TO ANY datatypes (non-standard extension) */
-bool allow_ref_to_any = false;
-/* A global flag used to tell the parser whether to allow use of REF_TO as a struct or array element (non-standard extension) */
-bool allow_ref_to_in_derived_datatypes = false;
+/* allow_ref_dereferencing: tells the parser whether to allow use of DREF and '^' operators (defined in IEC 61131-3 v3) */
+/* allow_ref_to_any: tells the parser whether to allow use of REF_TO ANY datatypes (non-standard extension) */
+/* allow_ref_to_in_derived_datatypes: tells the parser whether to allow use of REF_TO as a struct or array element (non-standard extension) */
 
-/* A pointer to the root of the parsing tree that will be generated by bison. */
-symbol_c *tree_root;
+/* Set the parameters of the parse of either the standard library or the input file */
+static void set_parse_params(parse_context_t *context, bool library) {
+  context->allow_function_overloading           = library;
+  context->allow_extensible_function_parameters = library;
+  context->allow_ref_dereferencing              = context->options.ref_standard_extensions;
+  context->allow_ref_to_any                     = context->options.ref_nonstand_extensions;
+  context->allow_ref_to_in_derived_datatypes    = context->options.ref_nonstand_extensions;
+  //allow_ref_to_any = false;    /* we only allow REF_TO ANY in library functions/FBs, no matter what the user asks for in the command line */
+}
 
 
 
@@ -8516,21 +8443,25 @@ symbol_c *tree_root;
  * an error. Unfortunately it calls this function before executing the code that handles
  * the error itself, so we cannot print out the correct line numbers of the error location
  * over here.
- * Our solution is to store the current error message in a global variable, and have all
+ * Our solution is to store the current error message in the context, and have all
  * error action handlers call the function print_err_msg() after setting the location
  * (line number) variable correctly.
+ *
+ * NOTE: bison counts the syntax errors in a variable local to yyparse() (yynerrs), after
+ *       which it calls this function. We count them in the context instead, along with the
+ *       errors found by the action handlers.
  */
-const char *current_error_msg;
-void yyerror (const char *error_msg) {
-  current_error_msg = error_msg;
-/* fprintf(stderr, "error %d: %s\n", yynerrs // global variable //, error_msg); */
-/*  print_include_stack(); */
+void yyerror (YYLTYPE *locp, parse_context_t *context, const char *error_msg) {
+  context->current_error_msg = error_msg;
+  context->yynerrs++;
+/* fprintf(stderr, "error %d: %s\n", context->yynerrs, error_msg); */
+/*  print_include_stack(context); */
 }
 
 
 /* ERROR_CHECK_BEGIN */
-bool is_current_syntax_token() {
-  switch (yychar) {
+bool is_current_syntax_token(int token) {
+  switch (token) {
     case ';':
     case ',':
     case ')':
@@ -8561,7 +8492,9 @@ bool is_current_syntax_token() {
 /* ERROR_CHECK_END */
 
 
-void print_err_msg(int first_line,
+/* NOTE: also called from outside the parser (e.g. by the pre-scanner), with the context of the parse */
+void print_err_msg(parse_context_t *context,
+                   int first_line,
                    int first_column,
                    const char *first_filename,
                    long int first_order,
@@ -8575,7 +8508,7 @@ void print_err_msg(int first_line,
   if (first_filename == NULL) first_filename = unknown_file;
   if ( last_filename == NULL)  last_filename = unknown_file;
 
-  if (runtime_options.full_token_loc) {
+  if (context->options.full_token_loc) {
     if (first_filename == last_filename)
       fprintf(stderr, "%s:%d-%d..%d-%d: error: %s\n", first_filename, first_line, first_column, last_line, last_column, additional_error_msg);
     else
@@ -8583,8 +8516,8 @@ void print_err_msg(int first_line,
   } else {
       fprintf(stderr, "%s:%d: error: %s\n", first_filename, first_line, additional_error_msg);
   }
-  //fprintf(stderr, "error %d: %s\n", yynerrs /* a global variable */, additional_error_msg);
-  print_include_stack();
+  //fprintf(stderr, "error %d: %s\n", context->yynerrs, additional_error_msg);
+  print_include_stack(context);
 }
 
 
@@ -8597,7 +8530,7 @@ void print_err_msg(int first_line,
 /*
 identifier_c *token_2_identifier_c(char *value, ) {
   identifier_c tmp = new identifier_c(value, locloc(@$));
-	 if (!allow_function_overloading) {
+	 if (!context->allow_function_overloading) {
 	   fprintf(stderr, "Function overloading not allowed. Invalid identifier %s\n", ((token_c *)($$))->value);
 	   ERROR;
 	 }
@@ -8715,6 +8648,16 @@ identifier_c *il_operator_c_2_identifier_c(symbol_c *il_operator) {
 }
 
 
+static symbol_c *unchanged_pou(parse_context_t *context, symbol_c *name, int token) {
+  const char *name_str = ((token_c *)name)->value;
+  symbol_c   *pou      = incremental_pou_ast(name_str);
+  /* declare the POU, as the parser would have (unless already declared by the pre-scanner, with -p) */
+  if ((NULL != pou) && (context->library_element_symtable.find(name_str) == context->library_element_symtable.end()))
+    context->library_element_symtable.insert(name_str, token);
+  return pou;
+}
+
+
 #include "standard_function_names.c"
 
 const char *standard_function_block_names[] = {
@@ -8743,74 +8686,172 @@ NULL
 extern const char *INCLUDE_DIRECTORIES[];
 
 
-static int parse_files(const char *libfilename, const char *filename) {
-  /* first parse the standard library file... */  
-  /*   Do not debug the standard library, even if debug flag is set!
-  #if YYDEBUG
-    yydebug = 1;
-  #endif
-  */
-  FILE *libfile = NULL;
-  if((libfile = parse_file(libfilename)) == NULL) {
-    char *errmsg = strdup2("Error opening library file ", libfilename);
-    perror(errmsg);
-    free(errmsg);
-    /* we give up... */
-    return -1;
-  }
+/* The copy of the standard library kept in memory (see stage1_2_cache_library()).
+ * NOTE: The copy is kept in a memory buffer whenever possible (instead of a temporary file).
+ */
+static bool  cache_library = false;
+#if defined(HAVE_OPEN_MEMSTREAM) && defined(HAVE_FMEMOPEN)
+static char  *library_cache      = NULL;
+static size_t library_cache_size = 0;
 
-  allow_function_overloading           = true;
-  allow_extensible_function_parameters = true;
-  allow_ref_dereferencing              = runtime_options.ref_standard_extensions;
-  allow_ref_to_any                     = runtime_options.ref_nonstand_extensions;
-  allow_ref_to_in_derived_datatypes    = runtime_options.ref_nonstand_extensions;
-  if (yyparse() != 0) {
-    fprintf (stderr, "\nParsing failed because of too many consecutive syntax errors in standard library. Bailing out!\n");
-    exit(EXIT_FAILURE);
-  }
-  fclose(libfile);
+static void  drop_library_cache(void) {free(library_cache); library_cache = NULL;}
+static FILE *open_library_cache(void) {return (NULL == library_cache)? NULL : fmemopen(library_cache, library_cache_size, "rb");}
+static void  close_library_cache(FILE *in) {fclose(in);}
+static FILE *create_library_cache(void) {return open_memstream(&library_cache, &library_cache_size);}
+static bool  commit_library_cache(FILE *out) {return (0 == fclose(out));}  /* the buffer is only valid after fclose() */
+#else
+static FILE *library_cache = NULL;
+
+static void  drop_library_cache(void) {if (NULL != library_cache) fclose(library_cache); library_cache = NULL;}
+static FILE *open_library_cache(void) {if (NULL != library_cache) rewind(library_cache); return library_cache;}
+static void  close_library_cache(FILE *in) {}
+static FILE *create_library_cache(void) {return library_cache = tmpfile();}
+static bool  commit_library_cache(FILE *out) {return true;}
+#endif
+
+void stage1_2_cache_library(bool enable) {
+  cache_library = enable;
+  if (!enable) drop_library_cache();
+}
+
+void stage1_2_incremental_parse(bool enable) {incremental_parse_enable(enable);}
+
+
+/* the number of elements of tree_root declared by the standard library */
+static int library_elements = 0;
+
+int stage1_2_library_elements(void) {return library_elements;}
+
+
+/* load the standard library from the copy kept in memory. Returns < 0 if not available. */
+static int load_library_cache(parse_context_t *context, const char *libfilename) {
+  FILE *in = open_library_cache();
+  if (NULL == in) return -1;
+  int res = load_library_snapshot(context, libfilename, in);
+  close_library_cache(in);
+  if (res >= 0) return 0;
+  /* stale copy (e.g. the library source files have changed in the meantime) */
+  drop_library_cache();
+  return -1;
+}
+
+
+/* keep a copy of the standard library (currently in tree_root) in memory, if so requested */
+static void save_library_cache(parse_context_t *context, const char *libfilename) {
+  if (!cache_library || (NULL != library_cache)) return;
+  FILE *out = create_library_cache();
+  if (NULL == out) return;
+  bool ok = (save_library_snapshot(context, libfilename, out) >= 0);
+  if (!commit_library_cache(out) || !ok)
+    /* not a fatal error. We simply parse the library again the next time around! */
+    drop_library_cache();
+}
+
+
+static int parse_files(parse_context_t *context, const char *libfilename, const char *filename) {
+  /* the standard library is always parsed completely (-L only applies to the files included by the input file) */
+  forget_unused_lazy_pous();
+
+  /* first load the standard library from the copy kept in memory, or from a previously saved snapshot, if available... */
+  bool library_cached = !context->options.write_library_snapshot && (load_library_cache(context, libfilename) >= 0);
+  if (!library_cached && (context->options.write_library_snapshot ||
+      (load_library_snapshot(context, libfilename) < 0))) {
+    /* ...otherwise parse the standard library file... */  
+    /*   Do not debug the standard library, even if debug flag is set!
+    #if YYDEBUG
+      yydebug = 1;
+    #endif
+    */
+    FILE *libfile = NULL;
+    if((libfile = parse_file(context, libfilename)) == NULL) {
+      char *errmsg = strdup2("Error opening library file ", libfilename);
+      perror(errmsg);
+      free(errmsg);
+      /* we give up... */
+      return -1;
+    }
+
+    set_parse_params(context, true);
+    if (yyparse(context) != 0) {
+      fprintf (stderr, "\nParsing failed because of too many consecutive syntax errors in standard library. Bailing out!\n");
+      exit(EXIT_FAILURE);
+    }
+    fclose(libfile);
       
-  if (yynerrs > 0) {  /* NOTE: yynerrs is a global variable */
-    /* Hopefully the libraries do not contain any errors, so this should not occur! */
-    fprintf (stderr, "\n%d error(s) found in %s. Bailing out!\n", yynerrs, libfilename);
-    return -2;
+    if (context->yynerrs > 0) {
+      /* Hopefully the libraries do not contain any errors, so this should not occur! */
+      fprintf (stderr, "\n%d error(s) found in %s. Bailing out!\n", context->yynerrs, libfilename);
+      return -2;
+    }
+    /* the conversion functions of the enumerated datatypes (-c) used by the library itself */
+    create_enumtype_conversion_functions_c::add_to(context, context->tree_root);
+
+    /* NOTE: the snapshot must be saved before parsing the input file, as it stores the whole library_element_symtable! */
+    if (context->options.write_library_snapshot)
+      if (save_library_snapshot(context, libfilename) < 0)
+        return -1;
   }
+  if (!library_cached)
+    save_library_cache(context, libfilename);
+
+  list_c *library = dynamic_cast<list_c *>(context->tree_root);
+  library_elements = (NULL == library)? 0 : library->n;
 
   /* if by any chance the library is not complete, we now add the missing reserved keywords to the list!!!  */
   for(int i = 0; standard_function_block_names[i] != NULL; i++)
-    if (library_element_symtable.find(standard_function_block_names[i]) ==
-        library_element_symtable.end())
-      library_element_symtable.insert(standard_function_block_names[i], standard_function_block_name_token);
+    if (context->library_element_symtable.find(standard_function_block_names[i]) ==
+        context->library_element_symtable.end())
+      context->library_element_symtable.insert(standard_function_block_names[i], standard_function_block_name_token);
+
+  /* only building the library snapshot, no input file to parse */
+  if (filename == NULL)
+    return 0;
+
+  /* find the names of all the POUs and datatypes declared in the input file, to allow forward references,
+   * and/or the POUs of the included files that are not used by the input file, to skip them (lazy parsing)...
+   */
+  if (context->options.pre_parsing || context->options.lazy_parsing) {
+    int errors = prescan_file(context, filename, context->options.pre_parsing, context->options.lazy_parsing);
+    if (errors > 0) {
+      fprintf (stderr, "\n%d error(s) found. Bailing out!\n", errors);
+      return -4;
+    }
+    /* NOTE: if the file could not be read (errors < 0), parse_file() will report the error next. */
+  }
 
   /* now parse the input file... */
   #if YYDEBUG
     yydebug = 1;
   #endif
   FILE *mainfile = NULL;
-  if ((mainfile = parse_file(filename)) == NULL) {
+  if ((mainfile = parse_file(context, filename)) == NULL) {
     char *errmsg = strdup2("Error opening main file ", filename);
     perror(errmsg);
     free(errmsg);
     return -3;
   }
 
-  allow_function_overloading           = false;
-  allow_extensible_function_parameters = false;
-  allow_ref_dereferencing              = runtime_options.ref_standard_extensions;
-  allow_ref_to_any                     = runtime_options.ref_nonstand_extensions;
-  allow_ref_to_in_derived_datatypes    = runtime_options.ref_nonstand_extensions;
-  //allow_ref_to_any = false;    /* we only allow REF_TO ANY in library functions/FBs, no matter what the user asks for in the command line */
+  set_parse_params(context, false);
 
-  if (yyparse() != 0) {
+  /* the POUs that did not change since the file was last parsed (compile server only) */
+  incremental_parse_begin(context, filename);
+  if (yyparse(context) != 0) {
     fprintf (stderr, "\nParsing failed because of too many consecutive syntax errors. Bailing out!\n");
-    exit(EXIT_FAILURE);
+    fclose(mainfile);
+    incremental_parse_end(NULL, 0);
+    return -4;
   }
   fclose(mainfile);
   
-  if (yynerrs > 0) {
-    fprintf (stderr, "\n%d error(s) found. Bailing out!\n", yynerrs /* global variable */);
-    exit(EXIT_FAILURE);
+  if (context->yynerrs > 0) {
+    fprintf (stderr, "\n%d error(s) found. Bailing out!\n", context->yynerrs);
+    incremental_parse_end(NULL, 0);
+    return -4;
   }
+  incremental_parse_end(context->tree_root, library_elements);
+
+  /* now that we know which ones are called, build the conversion functions of the enumerated datatypes (-c) */
+  create_enumtype_conversion_functions_c::add_to(context, context->tree_root, library_elements);
 
   return 0;
 }  
@@ -8819,74 +8860,57 @@ static int parse_files(const char *libfilename, const char *filename) {
 
 
 
-/* We parse the input source code twice!!
- *  1st pass -->  Pre-parsing
- *  -------------------------
- *  The intention of the first pass is to fill up the library_element_symtable with the names of all
- *  the POUs (Functions, FBs, Programs and Configurations), as well as all the Derived Datatypes.
- * 
- *  During this pass POUs are only parsed until their name is obtained, and the remaining source
- *  code (variable declarations and body) is completely thrown away by flex. Datatype declarations
- *  however are parsed normally!
- *
- *  At the end of the pre-parsing, the AST will contain only the derived datatype declarations,
- *  and this tree will be trown away (by simply resetting tree_root = NULL).
- *  More importantly, the library_element_symtable will contain the names of all the POUs and 
- *  derived datatypes.
- *
- *  2st pass -->  Normal parsing
- *  ----------------------------
- *  In this second parse the whole source code is parsed correctly, and the AST is generated
- *  completely.
+/* Forward references (-p command line option)
+ * -------------------------------------------
+ *  Before parsing the input file, parse_files() asks the pre-scanner (see prescan.hh) to fill up
+ *  the library_element_symtable with the names of all the POUs (Functions, FBs, Programs and
+ *  Configurations), as well as all the Derived Datatypes, declared in the input file.
  *
- *  However, if the pre-parsing has been done before this normal parsing, the POUs may appear
- *  in the source code in any order, as calling a POU (e.g. calling a function) that has not yet
- *  been declared will no longer generate a parsing error because the name of the function being 
- *  called is already in the library_element_symtable.
+ *  The POUs may then appear in the source code in any order, as calling a POU (e.g. calling a
+ *  function) that has not yet been declared will no longer generate a parsing error because the
+ *  name of the function being called is already in the library_element_symtable.
  *
  *  Declaring variables of datatypes that have not yet been declared will also be possible, as the
  *  datatypes will also already be in the library_element_symtable!
+ *
+ *  NOTE: Previously this was done by parsing the whole source code twice, the first time with
+ *        bison in a 'preparse' state, in which flex skipped the POUs as soon as their name was
+ *        obtained. The pre-scanner does the same job without building (and throwing away) an AST,
+ *        and without parsing the standard library a second time.
  */
 
-int stage2__(const char *filename, 
+int stage2__(parse_context_t *context,
+             const char *filename, 
              symbol_c **tree_root_ref
             ) {             
   char *libfilename = NULL;
 
   /* Determine the full path name of the standard library file... */
-  if (runtime_options.includedir != NULL)
-    INCLUDE_DIRECTORIES[0] = runtime_options.includedir;
+  if (context->options.includedir != NULL)
+    INCLUDE_DIRECTORIES[0] = context->options.includedir;
 
   if ((libfilename = strdup3(INCLUDE_DIRECTORIES[0], "/", LIBFILE)) == NULL) {
     fprintf (stderr, "Out of memory. Bailing out!\n");
     exit(EXIT_FAILURE);
   }
 
-  /*******************************/
-  /* Do the  PRE parsing run...! */
-  /*******************************/
-  if (runtime_options.pre_parsing) {
-    // fprintf (stderr, "----> Starting pre-parsing!\n");
-    tree_root = NULL;
-    set_preparse_state();
-    if (parse_files(libfilename, filename) < 0)
-      exit(EXIT_FAILURE);
-    // TODO: delete the current AST. For the moment, we leave all the objects in memory (not much of an issue in a program that always runs to completion).
-  }
   /*******************************/
   /* Do the main parsing run...! */
   /*******************************/
-  // fprintf (stderr, "----> Starting normal parsing!\n");
-  tree_root = NULL;
-  rst_preparse_state();
-  if (parse_files(libfilename, filename) < 0)
-    exit(EXIT_FAILURE);
+  context->tree_root = NULL;
+  /* NOTE: errors in the input file are not fatal (the caller decides whether to bail out), so
+   *       that several files may be compiled in a single run (see the -B and -S command line options).
+   */
+  if (parse_files(context, libfilename, filename) < 0) {
+    free(libfilename);
+    return -1;
+  }
   
 
   /* Final clean-up... */
   free(libfilename);
   if (tree_root_ref != NULL)
-    *tree_root_ref = tree_root;
+    *tree_root_ref = context->tree_root;
 
   return 0;
 }
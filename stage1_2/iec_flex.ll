@@ -96,6 +96,16 @@
 %option nounput
 */
 
+/* Generate a reentrant scanner, that keeps all its state in a yyscan_t (and in the
+ * parse_context_t of the parse, its extra data, see stage1_2_priv.hh) instead of in
+ * global variables. The value and the location of each token are handed back to the
+ * (pure, i.e. reentrant) bison parser through the pointers passed to the scanner.
+ */
+%option reentrant
+%option bison-bridge
+%option bison-locations
+%option extra-type="parse_context_t *"
+
 /* The '%option debug' makes the generated scanner run in
  * debug mode.
 %option debug
@@ -126,6 +136,16 @@
 /* Required for strdup() */
 #include <string.h>
 
+/* Required for HAVE_MMAP, used to decide whether the input files may be memory mapped */
+#include "../config/config.h"
+#if defined(HAVE_MMAP) && defined(HAVE_SYS_MMAN_H)
+#define MMAP_INPUT_FILES
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+#endif
+
 /* Required only for the declaration of abstract syntax classes
  * (class symbol_c; class token_c; class list_c;)
  * These will not be used in flex, but the token type union defined
@@ -134,6 +154,9 @@
  */
 #include "../absyntax/absyntax.hh"
 
+/* Required for intern_string(), used to store the value of the tokens */
+#include "../absyntax/intern_pool.hh"
+
 
 /* iec_bison.hh is generated by bison.
  * Contains the definition of the token constants, and the
@@ -141,33 +164,21 @@
  */
 #include "iec_bison.hh"
 #include "stage1_2_priv.hh"
+#include "prescan.hh"
+#include "incremental_parse.hh"
 
 
-/* Variable defined by the bison parser,
- * where the value of the tokens will be stored
+/* The scanner generated by flex. Bison calls it through yylex() (defined at the end of this file),
+ * which hands it the scanner kept in the parse_context_t.
+ * The value of the tokens is stored in *yylval, and their location in *yylloc.
+ * Note that the name of the file currently being parsed (yyextra->current_filename) is updated
+ * apropriately whenever flex comes across an (*#include <filename> *) directive...
  */
-extern YYSTYPE yylval;
-
-/* The name of the file currently being parsed...
- * Note that flex accesses and updates this global variable
- * apropriately whenever it comes across an (*#include <filename> *) directive...
- */
-const char *current_filename = NULL;
-
+#define YY_DECL int scan_token(YYSTYPE *yylval_param, YYLTYPE *yylloc_param, yyscan_t yyscanner)
 
 
-/* Variable defined by the bison parser.
- * It must be initialised with the location
- * of the token being parsed.
- * This is only needed if we want to keep
- * track of the locations, in order to give
- * more meaningful error messages!
- */
-/*
- *extern YYLTYPE yylloc;
-b*/
 #define YY_INPUT(buf,result,max_size)  {\
-    result = GetNextChar(buf, max_size);\
+    result = GetNextChar(yyextra->current_tracking, buf, max_size);\
     if (  result <= 0  )\
       result = YY_NULL;\
     }
@@ -178,21 +189,22 @@ b*/
  * back to the bison parser...
  */
 #define YY_USER_ACTION {\
-	previous_tracking   =*current_tracking;					\
-	yylloc.first_line   = current_tracking->lineNumber;			\
-	yylloc.first_column = current_tracking->currentChar;			\
-	yylloc.first_file   = current_filename;					\
-	yylloc.first_order  = current_order;					\
+	parse_context_t *context = yyextra;					\
+	context->previous_tracking = *context->current_tracking;		\
+	yylloc->first_line   = context->current_tracking->lineNumber;		\
+	yylloc->first_column = context->current_tracking->currentChar;		\
+	yylloc->first_file   = context->current_filename;			\
+	yylloc->first_order  = context->current_order;				\
 	\
-	UpdateTracking(yytext);							\
+	UpdateTracking(context->current_tracking, yytext);			\
 	\
-	yylloc.last_line    = current_tracking->lineNumber;			\
-	yylloc.last_column  = current_tracking->currentChar - 1;		\
-	yylloc.last_file    = current_filename;					\
-	yylloc.last_order   = current_order;					\
+	yylloc->last_line    = context->current_tracking->lineNumber;		\
+	yylloc->last_column  = context->current_tracking->currentChar - 1;	\
+	yylloc->last_file    = context->current_filename;			\
+	yylloc->last_order   = context->current_order;				\
 	\
-	current_tracking->currentTokenStart = current_tracking->currentChar;	\
-	current_order++;							\
+	context->current_tracking->currentTokenStart = context->current_tracking->currentChar;	\
+	context->current_order++;						\
 	}
 
 
@@ -216,8 +228,8 @@ b*/
  * Searches first in the variables, and only if not found
  * does it continue searching in the library elements
  */
-//token_id_t get_identifier_token(const char *identifier_str);
-int get_identifier_token(const char *identifier_str);
+//token_id_t get_identifier_token(parse_context_t *context, const char *identifier_str);
+int get_identifier_token(parse_context_t *context, const char *identifier_str);
 %}
 
 
@@ -226,17 +238,17 @@ int get_identifier_token(const char *identifier_str);
 /***************************************************/
 
 %{
-void UpdateTracking(const char *text);
+void UpdateTracking(tracking_t *tracking, const char *text);
 /* return the character back to the input stream. */
-void unput_char(const char c);
+void unput_char(const char c, yyscan_t yyscanner);
 /* return all the text in the current token back to the input stream. */
-void unput_text(int n);
+void unput_text(int n, yyscan_t yyscanner);
 /* return all the text in the current token back to the input stream, 
  * but first return to the stream an additional character to mark the end of the token. 
  */
-void unput_and_mark(const char mark_char);
+void unput_and_mark(const char mark_char, yyscan_t yyscanner);
 
-void include_file(const char *include_filename);
+void include_file(const char *include_filename, yyscan_t yyscanner);
 
 /* The body_state tries to find a ';' before a END_PROGRAM, END_FUNCTION or END_FUNCTION_BLOCK or END_ACTION
  * and ignores ';' inside comments and pragmas. This means that we cannot do this in a signle lex rule.
@@ -244,13 +256,13 @@ void include_file(const char *include_filename);
  * once we have decided if we are parsing ST or IL code. The following functions manage that buffer used by
  * the body_state.
  */
-void  append_bodystate_buffer(const char *text, int is_whitespace = 0);
-void   unput_bodystate_buffer(void);
-int  isempty_bodystate_buffer(void);
-void     del_bodystate_buffer(void);
+void  append_bodystate_buffer(const char *text, int is_whitespace, yyscan_t yyscanner);
+void   unput_bodystate_buffer(yyscan_t yyscanner);
+int  isempty_bodystate_buffer(yyscan_t yyscanner);
+void     del_bodystate_buffer(yyscan_t yyscanner);
 
 
-int GetNextChar(char *b, int maxBuffer);
+int GetNextChar(tracking_t *tracking, char *b, int maxBuffer);
 %}
 
 
@@ -360,31 +372,22 @@ int GetNextChar(char *b, int maxBuffer);
  *       Unfortunately, flex will join '_' and '4h' to create a legal {identifier} '_4h',
  *       and return that identifier instead! So, we added this state!
  *
- * The ignore_pou_state state is only used when bison says it is doing the pre-parsing.
- * During pre-parsing, the main state machine will only transition between
- * INITIAL and ignore_pou_state, and from here back to INITIAL. All other
- * transitions are inhibited. This inhibition is actually just enforced by making
- * sure that the INITIAL ---> ignore_pou_state transition is tested before all other
- * transitions coming out of INITIAL state. All other transitions are unaffected, as they
- * never get a chance to be evaluated when bison is doing pre-parsing.
- * Pre-parsing is a first quick scan through the whole input source code simply
- * to determine the list of POUs and datatypes that will be defined in that
- * code. Basically, the objective is to fill up the previously_declared_xxxxx
- * maps, without processing the code itself. Once these maps have been filled up,
- * bison will throw away the AST (abstract syntax tree) created up to that point, 
- * and scan through the same source code again, but this time creating a correct AST.
- * This pre-scan allows the source code to reference POUs and datatypes that are
- * only declared after they are used!
+ * The ignore_pou_state state is only used to skip the POUs that bison does not need to parse,
+ * i.e. the POUs of the included files not used by the input file (lazy parsing, -L), and the
+ * POUs of the input file that did not change since it was last parsed (incremental parsing, -S).
+ * Flex then only returns the name of the POU, and its closing END_XXX keyword.
+ * NOTE: The forward references (-p) are handled by a separate pre-scanner (see prescan.hh),
+ *       that does not go through flex at all.
  * 
  *
  * Here is a main state machine...
  *                                                                         --+  
  *                                                                           |  these states are
- *              +------------> get_pou_name_state  ----> ignore_pou_state    |  only active 
- *              |                                            |               |  when bison is 
- *              |  ------------------------------------------+               |  doing the 
- *              |  |                                                         |  pre-parsing!!
- *              |  v                                                       --+
+ *              +------------> skip_pou_name_state ----> ignore_pou_state    |  only active 
+ *              |                   |                        |               |  when lazy or
+ *              |  -----------------|------------------------+               |  incremental
+ *              |  |                v                                        |  parsing!!
+ *              |  v             header_state                              --+
  *       +---> INITIAL <-------> config
  *       |        \
  *       |        V
@@ -415,10 +418,13 @@ int GetNextChar(char *b, int maxBuffer);
  *   
  * 
  * Possible state changes are:
- *   INITIAL -> goto(ignore_pou_state)
- *               (This transition state is only used when bison says it is doing the pre-parsing.)
- *               (This transition takes precedence over all other transitions!)
- *               (when a FUNCTION, FUNCTION_BLOCK, PROGRAM or CONFIGURATION is found)
+ *   INITIAL -> goto(skip_pou_name_state)
+ *               (when a FUNCTION, FUNCTION_BLOCK or PROGRAM is found, with lazy or incremental parsing)
+ *   skip_pou_name_state -> goto(ignore_pou_state)
+ *               (when the POU of an included file is not used by the input file (-L), see prescan.hh,
+ *                or the POU of the input file did not change since it was last parsed, see incremental_parse.hh)
+ *   skip_pou_name_state -> goto(header_state)
+ *               (otherwise)
  * 
  *   INITIAL -> goto(config_state)
  *                (when a CONFIGURATION is found)
@@ -453,7 +459,7 @@ int GetNextChar(char *b, int maxBuffer);
  *                     (when a END_FUNCTION, END_FUNCTION_BLOCK, or END_PROGRAM is found)
  * 
  *   ignore_pou_state   -> goto(INITIAL)
- *                         (when a END_FUNCTION, END_FUNCTION_BLOCK, END_PROGRAM or END_CONFIGURATION is found)
+ *                         (when a END_FUNCTION, END_FUNCTION_BLOCK, or END_PROGRAM is found)
  *   vardecl_list_state -> goto(INITIAL)
  *                         (when a END_FUNCTION, END_FUNCTION_BLOCK, or END_PROGRAM is found)
  *   config_state       -> goto(INITIAL)
@@ -478,9 +484,9 @@ int GetNextChar(char *b, int maxBuffer);
  */
 
 
-/* Bison is in the pre-parsing stage, and we are parsing a POU. Ignore everything up to the end of the POU! */
+/* We are skipping a POU (lazy or incremental parsing). Ignore everything up to the end of the POU! */
 %x ignore_pou_state
-%x get_pou_name_state
+%x skip_pou_name_state
 
 /* we are parsing a configuration. */
 %s config_state
@@ -550,7 +556,7 @@ file_include_pragma			{file_include_pragma_beg}{file_include_pragma_filename}{fi
 
 %{
 
-/* A counter to track the order by which each token is processed.
+/* yyextra->current_order: A counter to track the order by which each token is processed.
  * NOTE: This counter is not exactly linear (i.e., it does not get incremented by 1 for each token).
  *       i.e.. it may get incremented by more than one between two consecutive tokens.
  *       This is due to the fact that the counter gets incremented every 'user action' in flex,
@@ -558,33 +564,19 @@ file_include_pragma			{file_include_pragma_beg}{file_include_pragma_filename}{fi
  *       Nevertheless this is still OK, as we are only interested in the relative
  *       ordering of tokens...
  */
-static long int current_order = 0;
-  
-typedef struct {
-    int eof;
-    int lineNumber;
-    int currentChar;
-    int lineLength;
-    int currentTokenStart;
-    FILE *in_file;
-  } tracking_t;
+
+/* yyextra->current_tracking, yyextra->include_stack: the position of flex in the file being parsed,
+ * and in each of the files that included it (see tracking_t and include_stack_t in stage1_2_priv.hh).
+ */
 
 /* A forward declaration of a function defined at the end of this file. */
 void FreeTracking(tracking_t *tracking);
 
-
-#define MAX_INCLUDE_DEPTH 16
-
-typedef struct {
-	  YY_BUFFER_STATE buffer_state;
-	  tracking_t *env;
-	  const char *filename;
-	} include_stack_t;
-
-tracking_t * current_tracking = NULL;
-tracking_t  previous_tracking;
-include_stack_t include_stack[MAX_INCLUDE_DEPTH];
-int include_stack_ptr = 0;
+/* The POUs that are skipped: with lazy parsing (-L), those of the included files that are not used (see prescan.hh),
+ * and with incremental parsing, those of the input file that did not change (see incremental_parse.hh)
+ */
+static bool skip_pou_state(parse_context_t *context) {return context->options.lazy_parsing || incremental_parse_active();}
+static bool skip_pou(parse_context_t *context, const char *pou_name) {return (context->include_stack_ptr > 0)? lazy_pou_unused(pou_name) : incremental_pou_unchanged(pou_name);}
 
 const char *INCLUDE_DIRECTORIES[] = {
 	DEFAULT_LIBDIR,
@@ -956,29 +948,29 @@ incompl_location	%[IQM]\*
 	/***********************************************************/
 	/* Handle requests sent by bison for flex to change state. */
 	/***********************************************************/
-	if (get_goto_body_state()) {
-	  yy_push_state(body_state);
-	  rst_goto_body_state();
+	if (get_goto_body_state(yyextra)) {
+	  yy_push_state(body_state, yyscanner);
+	  rst_goto_body_state(yyextra);
 	}
 
-	if (get_goto_sfc_qualifier_state()) {
-	  yy_push_state(sfc_qualifier_state);
-	  rst_goto_sfc_qualifier_state();
+	if (get_goto_sfc_qualifier_state(yyextra)) {
+	  yy_push_state(sfc_qualifier_state, yyscanner);
+	  rst_goto_sfc_qualifier_state(yyextra);
 	}
 
-	if (get_goto_sfc_priority_state()) {
-	  yy_push_state(sfc_priority_state);
-	  rst_goto_sfc_priority_state();
+	if (get_goto_sfc_priority_state(yyextra)) {
+	  yy_push_state(sfc_priority_state, yyscanner);
+	  rst_goto_sfc_priority_state(yyextra);
 	}
 
-	if (get_goto_task_init_state()) {
-	  yy_push_state(task_init_state);
-	  rst_goto_task_init_state();
+	if (get_goto_task_init_state(yyextra)) {
+	  yy_push_state(task_init_state, yyscanner);
+	  rst_goto_task_init_state(yyextra);
 	}
 
-	if (get_pop_state()) {
-	  yy_pop_state();
-	  rst_pop_state();
+	if (get_pop_state(yyextra)) {
+	  yy_pop_state(yyscanner);
+	  rst_pop_state(yyextra);
 	}
 
 	/***************************/
@@ -986,7 +978,7 @@ incompl_location	%[IQM]\*
 	/***************************/
 
 	/* We start off by searching for the pragmas we handle in the lexical parser. */
-<INITIAL>{file_include_pragma}	unput_text(0); yy_push_state(include_beg);
+<INITIAL>{file_include_pragma}	unput_text(0, yyscanner); yy_push_state(include_beg, yyscanner);
 
 	/* Pragmas sent to syntax analyser (bison) */
 	/* NOTE: In the vardecl_list_state we only process the pragmas between two consecutive VAR .. END_VAR blocks.
@@ -1000,21 +992,21 @@ incompl_location	%[IQM]\*
 {enable_code_generation_pragma}					return enable_code_generation_pragma_token;
 <vardecl_list_state>{disable_code_generation_pragma}/(VAR)	return disable_code_generation_pragma_token; 
 <vardecl_list_state>{enable_code_generation_pragma}/(VAR)	return enable_code_generation_pragma_token;  
-<body_state>{disable_code_generation_pragma}			append_bodystate_buffer(yytext); /* in body state we do not process any tokens, we simply store them for later processing! */
-<body_state>{enable_code_generation_pragma}			append_bodystate_buffer(yytext); /* in body state we do not process any tokens, we simply store them for later processing! */
+<body_state>{disable_code_generation_pragma}			append_bodystate_buffer(yytext, 0, yyscanner); /* in body state we do not process any tokens, we simply store them for later processing! */
+<body_state>{enable_code_generation_pragma}			append_bodystate_buffer(yytext, 0, yyscanner); /* in body state we do not process any tokens, we simply store them for later processing! */
 	/* Any other pragma we find, we just pass it up to the syntax parser...   */
 	/* Note that the <body_state> state is exclusive, so we have to include it here too. */
-<body_state>{pragma}					append_bodystate_buffer(yytext); /* in body state we do not process any tokens, we simply store them for later processing! */
+<body_state>{pragma}					append_bodystate_buffer(yytext, 0, yyscanner); /* in body state we do not process any tokens, we simply store them for later processing! */
 {pragma}	{/* return the pragmma without the enclosing '{' and '}' */
 		 int cut = yytext[1]=='{'?2:1;
 		 yytext[strlen(yytext)-cut] = '\0';
-		 yylval.ID=strdup(yytext+cut);
+		 yylval->ID=strdup(yytext+cut);
 		 return pragma_token;
 		}
 <vardecl_list_state>{pragma}/(VAR) {/* return the pragmma without the enclosing '{' and '}' */
 		 int cut = yytext[1]=='{'?2:1;
 		 yytext[strlen(yytext)-cut] = '\0';
-		 yylval.ID=strdup(yytext+cut);
+		 yylval->ID=strdup(yytext+cut);
 		 return pragma_token;
 		}
 
@@ -1026,9 +1018,9 @@ incompl_location	%[IQM]\*
 
 <include_filename>{file_include_pragma_filename}	{
 			  /* set the internal state variables of lexical analyser to process a new include file */
-			  include_file(yytext);
+			  include_file(yytext, yyscanner);
 			  /* switch to whatever state was active before the include file */
-			  yy_pop_state();
+			  yy_pop_state(yyscanner);
 			  /* now process the new file... */
 			}
 
@@ -1052,9 +1044,9 @@ incompl_location	%[IQM]\*
 			       *       As a corollory, flex can never safely close the main input file, and we must ask
 			       *       bison to close it!
 			       */
-			  if (include_stack_ptr == 0) {
+			  if (yyextra->include_stack_ptr == 0) {
 			      // fclose(yyin);           // Must not do this!!
-			      // FreeTracking(current_tracking); // Must not do this!!
+			      // FreeTracking(yyextra->current_tracking); // Must not do this!!
 			      /* yyterminate() terminates the scanner and returns a 0 to the 
 			       * scanner's  caller, indicating "all done".
 			       *	
@@ -1065,12 +1057,12 @@ incompl_location	%[IQM]\*
 			       */ 	
 			    yyterminate();
 			  } else {
-			    fclose(yyin);
-			    FreeTracking(current_tracking);
-			    --include_stack_ptr;
-			    yy_delete_buffer(YY_CURRENT_BUFFER);
-			    yy_switch_to_buffer((include_stack[include_stack_ptr]).buffer_state);
-			    current_tracking = include_stack[include_stack_ptr].env;
+			    if (NULL != yyin) fclose(yyin); /* yyin is NULL when scanning a memory mapped file */
+			    FreeTracking(yyextra->current_tracking);
+			    --yyextra->include_stack_ptr;
+			    yy_delete_buffer(YY_CURRENT_BUFFER, yyscanner);
+			    yy_switch_to_buffer((yyextra->include_stack[yyextra->include_stack_ptr]).buffer_state, yyscanner);
+			    yyextra->current_tracking = yyextra->include_stack[yyextra->include_stack_ptr].env;
 			      /* removing constness of char *. This is safe actually,
 			       * since the only real const char * that is stored on the stack is
 			       * the first one (i.e. the one that gets stored in include_stack[0],
@@ -1082,15 +1074,15 @@ incompl_location	%[IQM]\*
 			     *       This will later be used to provide correct error
 			     *       messages during semantic analysis (stage 3)
 			     */
-			    /* free((char *)current_filename); */
-			    current_filename = include_stack[include_stack_ptr].filename;
-			    yy_push_state(include_end);
+			    /* free((char *)yyextra->current_filename); */
+			    yyextra->current_filename = yyextra->include_stack[yyextra->include_stack_ptr].filename;
+			    yy_push_state(include_end, yyscanner);
 			  }
 			}
 
-<include_end>{file_include_pragma_end}	yy_pop_state();
+<include_end>{file_include_pragma_end}	yy_pop_state(yyscanner);
 	/* handle the artificial file includes created by include_string(), which do not end with a '}' */
-<include_end>.				unput_text(0); yy_pop_state(); 
+<include_end>.				unput_text(0, yyscanner); yy_pop_state(yyscanner); 
 
 
 	/*********************************/
@@ -1099,22 +1091,29 @@ incompl_location	%[IQM]\*
 
 	/* INITIAL -> header_state */
 <INITIAL>{
-FUNCTION{st_whitespace} 		if (get_preparse_state()) BEGIN(get_pou_name_state); else {BEGIN(header_state);/* printf("\nChanging to header_state\n"); */} return FUNCTION;
-FUNCTION_BLOCK{st_whitespace}		if (get_preparse_state()) BEGIN(get_pou_name_state); else {BEGIN(header_state);/* printf("\nChanging to header_state\n"); */} return FUNCTION_BLOCK;
-PROGRAM{st_whitespace}			if (get_preparse_state()) BEGIN(get_pou_name_state); else {BEGIN(header_state);/* printf("\nChanging to header_state\n"); */} return PROGRAM;
-CONFIGURATION{st_whitespace}		if (get_preparse_state()) BEGIN(get_pou_name_state); else {BEGIN(config_state);/* printf("\nChanging to config_state\n"); */} return CONFIGURATION;
+FUNCTION{st_whitespace} 		if (skip_pou_state(yyextra)) BEGIN(skip_pou_name_state); else {BEGIN(header_state);/* printf("\nChanging to header_state\n"); */} return FUNCTION;
+FUNCTION_BLOCK{st_whitespace}		if (skip_pou_state(yyextra)) BEGIN(skip_pou_name_state); else {BEGIN(header_state);/* printf("\nChanging to header_state\n"); */} return FUNCTION_BLOCK;
+PROGRAM{st_whitespace}			if (skip_pou_state(yyextra)) BEGIN(skip_pou_name_state); else {BEGIN(header_state);/* printf("\nChanging to header_state\n"); */} return PROGRAM;
+CONFIGURATION{st_whitespace}		BEGIN(config_state);/* printf("\nChanging to config_state\n"); */ return CONFIGURATION;
 }
 
-<get_pou_name_state>{
-{identifier}			BEGIN(ignore_pou_state); yylval.ID=strdup(yytext); return identifier_token;
-.				BEGIN(ignore_pou_state); unput_text(0);
+	/* lazy (-L) and incremental parsing: skip the POUs that are not used, or did not change (see skip_pou()) */
+<skip_pou_name_state>{
+{identifier}			{if (skip_pou(yyextra, yytext)) {BEGIN(ignore_pou_state); yylval->ID=(char *)intern_string(yytext); return identifier_token;}
+				 BEGIN(header_state); unput_text(0, yyscanner);
+				}
+.|\n				BEGIN(header_state); unput_text(0, yyscanner);
 }
 
 <ignore_pou_state>{
-END_FUNCTION			unput_text(0); BEGIN(INITIAL);
-END_FUNCTION_BLOCK		unput_text(0); BEGIN(INITIAL);
-END_PROGRAM			unput_text(0); BEGIN(INITIAL);
-END_CONFIGURATION		unput_text(0); BEGIN(INITIAL);
+END_FUNCTION			unput_text(0, yyscanner); BEGIN(INITIAL);
+END_FUNCTION_BLOCK		unput_text(0, yyscanner); BEGIN(INITIAL);
+END_PROGRAM			unput_text(0, yyscanner); BEGIN(INITIAL);
+	/* the END_XXX inside identifiers and strings (e.g. MY_END_FUNCTION, 'END_PROGRAM') do not end the POU */
+{identifier}			{}
+\'([^'$]|\$(.|\n))*\'		{}
+\"([^"$]|\$(.|\n))*\"		{}
+[^[:alnum:]_'"(]+		{}/* Ignore text inside POU! (whitespace and operators, a whole run at a time) */
 .|\n				{}/* Ignore text inside POU! (including the '\n' character!)) */
 }
 
@@ -1157,11 +1156,11 @@ VAR_EXTERNAL			|
 VAR_GLOBAL			|
 VAR_TEMP			|
 VAR_CONFIG			|
-VAR_ACCESS			unput_text(0); BEGIN(vardecl_list_state);
+VAR_ACCESS			unput_text(0, yyscanner); BEGIN(vardecl_list_state);
 
 END_FUNCTION			| /* execute the next rule's action, i.e. fall-through! */
 END_FUNCTION_BLOCK		| 
-END_PROGRAM			unput_text(0); BEGIN(vardecl_list_state); 
+END_PROGRAM			unput_text(0, yyscanner); BEGIN(vardecl_list_state); 
 				/* Notice that we do NOT go directly to body_state, as that requires a push().
 				 * If we were to puch to body_state here, then the corresponding pop() at the
 				 *end of body_state would return to header_state.
@@ -1190,11 +1189,11 @@ VAR_GLOBAL{st_whitespace_char}		|
 VAR_TEMP{st_whitespace_char}		|
 VAR_CONFIG{st_whitespace_char}		|
 VAR_ACCESS{st_whitespace_char}		|
-VAR{st_whitespace_char}			unput_text(0); yy_push_state(vardecl_state); //printf("\nChanging to vardecl_state\n");
+VAR{st_whitespace_char}			unput_text(0, yyscanner); yy_push_state(vardecl_state, yyscanner); //printf("\nChanging to vardecl_state\n");
 
-END_FUNCTION{st_whitespace}		unput_text(0); BEGIN(INITIAL);
-END_FUNCTION_BLOCK{st_whitespace}	unput_text(0); BEGIN(INITIAL);
-END_PROGRAM{st_whitespace}		unput_text(0); BEGIN(INITIAL);
+END_FUNCTION{st_whitespace}		unput_text(0, yyscanner); BEGIN(INITIAL);
+END_FUNCTION_BLOCK{st_whitespace}	unput_text(0, yyscanner); BEGIN(INITIAL);
+END_PROGRAM{st_whitespace}		unput_text(0, yyscanner); BEGIN(INITIAL);
 
 				/* NOTE: Handling of whitespace...
 				 *   - Must come __before__ the next rule for any single character '.'
@@ -1204,13 +1203,13 @@ END_PROGRAM{st_whitespace}		unput_text(0); BEGIN(INITIAL);
 {st_whitespace}			/* Eat any whitespace */ 
 
 				/* anything else, just change to body_state! */
-.				unput_text(0); yy_push_state(body_state); //printf("\nChanging to body_state\n");
+.				unput_text(0, yyscanner); yy_push_state(body_state, yyscanner); //printf("\nChanging to body_state\n");
 }
 
 
 	/* vardecl_list_state -> pop to $previous_state (vardecl_list_state) */
 <vardecl_state>{
-END_VAR				yy_pop_state(); return END_VAR; /* pop back to vardecl_list_state */
+END_VAR				yy_pop_state(yyscanner); return END_VAR; /* pop back to vardecl_list_state */
 }
 
 
@@ -1230,16 +1229,16 @@ END_VAR				yy_pop_state(); return END_VAR; /* pop back to vardecl_list_state */
 				  * However, it is possible to enter the body_state from other states (e.g. when 
 				  * parsing SFC code, that contains transitions or actions in other languages)
 				  */
-				 append_bodystate_buffer(yytext, 1 /* is whitespace */); 
+				 append_bodystate_buffer(yytext, 1 /* is whitespace */, yyscanner); 
 				}
 	/* 'INITIAL_STEP' always used in beginning of SFCs !! */
-INITIAL_STEP			{ if (isempty_bodystate_buffer())	{unput_text(0); del_bodystate_buffer(); BEGIN(sfc_state);}
-				  else					{append_bodystate_buffer(yytext);}
+INITIAL_STEP			{ if (isempty_bodystate_buffer(yyscanner))	{unput_text(0, yyscanner); del_bodystate_buffer(yyscanner); BEGIN(sfc_state);}
+				  else					{append_bodystate_buffer(yytext, 0, yyscanner);}
 				}
  
 	/* ':=', at the very beginning of a 'body', occurs only in transitions and not Function, FB, or Program bodies! */
-:=				{ if (isempty_bodystate_buffer())	{unput_text(0); del_bodystate_buffer(); BEGIN(st_state);} /* We do _not_ return a start_ST_body_token here, as bison does not expect it! */
-				  else				 	{append_bodystate_buffer(yytext);}
+:=				{ if (isempty_bodystate_buffer(yyscanner))	{unput_text(0, yyscanner); del_bodystate_buffer(yyscanner); BEGIN(st_state);} /* We do _not_ return a start_ST_body_token here, as bison does not expect it! */
+				  else				 	{append_bodystate_buffer(yytext, 0, yyscanner);}
 				}
  
 	/* check if ';' occurs before an END_FUNCTION, END_FUNCTION_BLOCK, END_PROGRAM, END_ACTION or END_TRANSITION. (If true => we are parsing ST; If false => parsing IL). */
@@ -1247,10 +1246,10 @@ END_ACTION			| /* execute the next rule's action, i.e. fall-through! */
 END_FUNCTION			|
 END_FUNCTION_BLOCK		|
 END_TRANSITION   		|
-END_PROGRAM			{ append_bodystate_buffer(yytext); unput_bodystate_buffer(); BEGIN(il_state); /*printf("returning start_IL_body_token\n");*/ return start_IL_body_token;}
-.|\n				{ append_bodystate_buffer(yytext);
+END_PROGRAM			{ append_bodystate_buffer(yytext, 0, yyscanner); unput_bodystate_buffer(yyscanner); BEGIN(il_state); /*printf("returning start_IL_body_token\n");*/ return start_IL_body_token;}
+.|\n				{ append_bodystate_buffer(yytext, 0, yyscanner);
 				  if (strcmp(yytext, ";") == 0)
-				    {unput_bodystate_buffer(); BEGIN(st_state); /*printf("returning start_ST_body_token\n");*/ return start_ST_body_token;}
+				    {unput_bodystate_buffer(yyscanner); BEGIN(st_state); /*printf("returning start_ST_body_token\n");*/ return start_ST_body_token;}
 				}
 	/* The following rules are not really necessary. They just make compilation faster in case the ST Statement List starts with one fot he following... */
 RETURN				| /* execute the next rule's action, i.e. fall-through! */
@@ -1259,8 +1258,8 @@ CASE				|
 FOR				|
 WHILE				|
 EXIT				|
-REPEAT				{ if (isempty_bodystate_buffer())	{unput_text(0); del_bodystate_buffer(); BEGIN(st_state); return start_ST_body_token;}
-				  else				 	{append_bodystate_buffer(yytext);}
+REPEAT				{ if (isempty_bodystate_buffer(yyscanner))	{unput_text(0, yyscanner); del_bodystate_buffer(yyscanner); BEGIN(st_state); return start_ST_body_token;}
+				  else				 	{append_bodystate_buffer(yytext, 0, yyscanner);}
 				}
 
 }	/* end of body_state lexical parser */
@@ -1268,18 +1267,18 @@ REPEAT				{ if (isempty_bodystate_buffer())	{unput_text(0); del_bodystate_buffer
 
 	/* (il_state | st_state) -> pop to $previous_state (vardecl_list_state or sfc_state) */
 <il_state,st_state>{
-END_FUNCTION		yy_pop_state(); unput_text(0);
-END_FUNCTION_BLOCK	yy_pop_state(); unput_text(0);
-END_PROGRAM		yy_pop_state(); unput_text(0);
-END_TRANSITION		yy_pop_state(); unput_text(0);
-END_ACTION		yy_pop_state(); unput_text(0);
+END_FUNCTION		yy_pop_state(yyscanner); unput_text(0, yyscanner);
+END_FUNCTION_BLOCK	yy_pop_state(yyscanner); unput_text(0, yyscanner);
+END_PROGRAM		yy_pop_state(yyscanner); unput_text(0, yyscanner);
+END_TRANSITION		yy_pop_state(yyscanner); unput_text(0, yyscanner);
+END_ACTION		yy_pop_state(yyscanner); unput_text(0, yyscanner);
 }
 
 	/* sfc_state -> pop to $previous_state (vardecl_list_state or sfc_state) */
 <sfc_state>{
-END_FUNCTION		yy_pop_state(); unput_text(0);
-END_FUNCTION_BLOCK	yy_pop_state(); unput_text(0);
-END_PROGRAM		yy_pop_state(); unput_text(0);
+END_FUNCTION		yy_pop_state(yyscanner); unput_text(0, yyscanner);
+END_FUNCTION_BLOCK	yy_pop_state(yyscanner); unput_text(0, yyscanner);
+END_PROGRAM		yy_pop_state(yyscanner); unput_text(0, yyscanner);
 }
 
 	/* config -> INITIAL */
@@ -1301,13 +1300,17 @@ END_CONFIGURATION	BEGIN(INITIAL); return END_CONFIGURATION;
  */
 
 	/* The comments */
-<get_pou_name_state,ignore_pou_state,body_state,vardecl_list_state>{comment_beg}		yy_push_state(comment_state);
-{comment_beg}						yy_push_state(comment_state);
+<skip_pou_name_state,ignore_pou_state,body_state,vardecl_list_state>{comment_beg}		yy_push_state(comment_state, yyscanner);
+{comment_beg}						yy_push_state(comment_state, yyscanner);
 <comment_state>{
-{comment_beg}						{if (get_opt_nested_comments()) yy_push_state(comment_state);}
-{comment_end}						yy_pop_state();
-.							/* Ignore text inside comment! */
-\n							/* Ignore text inside comment! */
+{comment_beg}						{if (get_opt_nested_comments(yyextra)) yy_push_state(comment_state, yyscanner);}
+{comment_end}						yy_pop_state(yyscanner);
+	/* NOTE: The text inside the comment is skipped a whole run at a time, up to the next '(' or '*' (that may
+	 *       start or end a comment), instead of one character (and one action) at a time. UpdateTracking()
+	 *       counts the lines of the run.
+	 */
+[^(*]+							/* Ignore text inside comment! (including the '\n' characters) */
+"("|"*"							/* Ignore text inside comment! */
 }
 
 	/*****************************************/
@@ -1346,7 +1349,7 @@ END_CONFIGURATION	BEGIN(INITIAL); return END_CONFIGURATION;
 	 *       in the mercurial repository to figure out the missing code!
 	 */
  /*
-{identifier} 	{int token = get_identifier_token(yytext);
+{identifier} 	{int token = get_identifier_token(yyextra, yytext);
 		 // fprintf(stderr, "flex: analysing identifier '%s'...", yytext); 
 		 if ((token == prev_declared_variable_name_token) ||
 //		     (token == prev_declared_derived_function_name_token) || // DO NOT add this condition!
@@ -1357,7 +1360,7 @@ END_CONFIGURATION	BEGIN(INITIAL); return END_CONFIGURATION;
                   *       'MOD' et al must be removed from the 
                   *       library_symbol_table as a default function name!
 		  * //
-		   yylval.ID=strdup(yytext);
+		   yylval->ID=(char *)intern_string(yytext);
 		   // fprintf(stderr, "returning token %d\n", token); 
 		   return token;
 		 }
@@ -1380,10 +1383,10 @@ END_CONFIGURATION	BEGIN(INITIAL); return END_CONFIGURATION;
 	/******************************************************/
 
 
-REF	{if (get_opt_ref_standard_extensions()) return REF;        else{REJECT;}}		/* Keyword in IEC 61131-3 v3 */
-DREF	{if (get_opt_ref_standard_extensions()) return DREF;       else{REJECT;}}		/* Keyword in IEC 61131-3 v3 */
-REF_TO	{if (get_opt_ref_standard_extensions()) return REF_TO;     else{REJECT;}}		/* Keyword in IEC 61131-3 v3 */
-NULL	{if (get_opt_ref_standard_extensions()) return NULL_token; else{REJECT;}}		/* Keyword in IEC 61131-3 v3 */
+REF	{if (get_opt_ref_standard_extensions(yyextra)) return REF;        else{REJECT;}}		/* Keyword in IEC 61131-3 v3 */
+DREF	{if (get_opt_ref_standard_extensions(yyextra)) return DREF;       else{REJECT;}}		/* Keyword in IEC 61131-3 v3 */
+REF_TO	{if (get_opt_ref_standard_extensions(yyextra)) return REF_TO;     else{REJECT;}}		/* Keyword in IEC 61131-3 v3 */
+NULL	{if (get_opt_ref_standard_extensions(yyextra)) return NULL_token; else{REJECT;}}		/* Keyword in IEC 61131-3 v3 */
 
 EN	return EN;			/* Keyword */
 ENO	return ENO;			/* Keyword */
@@ -1395,14 +1398,14 @@ ENO	return ENO;			/* Keyword */
 TRUE		return TRUE;		/* Keyword */
 BOOL#1  	return boolean_true_literal_token;
 BOOL#TRUE	return boolean_true_literal_token;
-SAFEBOOL#1	{if (get_opt_safe_extensions()) {return safeboolean_true_literal_token;} else{REJECT;}} /* Keyword (Data Type) */ 
-SAFEBOOL#TRUE	{if (get_opt_safe_extensions()) {return safeboolean_true_literal_token;} else{REJECT;}} /* Keyword (Data Type) */
+SAFEBOOL#1	{if (get_opt_safe_extensions(yyextra)) {return safeboolean_true_literal_token;} else{REJECT;}} /* Keyword (Data Type) */ 
+SAFEBOOL#TRUE	{if (get_opt_safe_extensions(yyextra)) {return safeboolean_true_literal_token;} else{REJECT;}} /* Keyword (Data Type) */
 
 FALSE		return FALSE;		/* Keyword */
 BOOL#0  	return boolean_false_literal_token;
 BOOL#FALSE  	return boolean_false_literal_token;
-SAFEBOOL#0	{if (get_opt_safe_extensions()) {return safeboolean_false_literal_token;} else{REJECT;}} /* Keyword (Data Type) */ 
-SAFEBOOL#FALSE	{if (get_opt_safe_extensions()) {return safeboolean_false_literal_token;} else{REJECT;}} /* Keyword (Data Type) */
+SAFEBOOL#0	{if (get_opt_safe_extensions(yyextra)) {return safeboolean_false_literal_token;} else{REJECT;}} /* Keyword (Data Type) */ 
+SAFEBOOL#FALSE	{if (get_opt_safe_extensions(yyextra)) {return safeboolean_false_literal_token;} else{REJECT;}} /* Keyword (Data Type) */
 
 
 	/************************/
@@ -1459,7 +1462,7 @@ DATE_AND_TIME	return DATE_AND_TIME;	/* Keyword (Data Type) */
 TIME_OF_DAY	return TIME_OF_DAY;	/* Keyword (Data Type) */
 
 					/* A non-standard extension! */
-VOID		{if (runtime_options.allow_void_datatype) {return VOID;}          else {REJECT;}} 
+VOID		{if (yyextra->options.allow_void_datatype) {return VOID;}          else {REJECT;}} 
 
 
 	/*****************************************************************/
@@ -1475,39 +1478,39 @@ VOID		{if (runtime_options.allow_void_datatype) {return VOID;}          else {RE
          *        We only support these extensions and keywords
          *        if the apropriate command line option is given.
          */
-SAFEBOOL	     {if (get_opt_safe_extensions()) {return SAFEBOOL;}          else {REJECT;}} 
+SAFEBOOL	     {if (get_opt_safe_extensions(yyextra)) {return SAFEBOOL;}          else {REJECT;}} 
 
-SAFEBYTE	     {if (get_opt_safe_extensions()) {return SAFEBYTE;}          else {REJECT;}} 
-SAFEWORD	     {if (get_opt_safe_extensions()) {return SAFEWORD;}          else {REJECT;}} 
-SAFEDWORD	     {if (get_opt_safe_extensions()) {return SAFEDWORD;}         else{REJECT;}}
-SAFELWORD	     {if (get_opt_safe_extensions()) {return SAFELWORD;}         else{REJECT;}}
+SAFEBYTE	     {if (get_opt_safe_extensions(yyextra)) {return SAFEBYTE;}          else {REJECT;}} 
+SAFEWORD	     {if (get_opt_safe_extensions(yyextra)) {return SAFEWORD;}          else {REJECT;}} 
+SAFEDWORD	     {if (get_opt_safe_extensions(yyextra)) {return SAFEDWORD;}         else{REJECT;}}
+SAFELWORD	     {if (get_opt_safe_extensions(yyextra)) {return SAFELWORD;}         else{REJECT;}}
                
-SAFEREAL	     {if (get_opt_safe_extensions()) {return SAFESINT;}          else{REJECT;}}
-SAFELREAL    	     {if (get_opt_safe_extensions()) {return SAFELREAL;}         else{REJECT;}}
+SAFEREAL	     {if (get_opt_safe_extensions(yyextra)) {return SAFESINT;}          else{REJECT;}}
+SAFELREAL    	     {if (get_opt_safe_extensions(yyextra)) {return SAFELREAL;}         else{REJECT;}}
                   
-SAFESINT	     {if (get_opt_safe_extensions()) {return SAFESINT;}          else{REJECT;}}
-SAFEINT	             {if (get_opt_safe_extensions()) {return SAFEINT;}           else{REJECT;}}
-SAFEDINT	     {if (get_opt_safe_extensions()) {return SAFEDINT;}          else{REJECT;}}
-SAFELINT             {if (get_opt_safe_extensions()) {return SAFELINT;}          else{REJECT;}}
+SAFESINT	     {if (get_opt_safe_extensions(yyextra)) {return SAFESINT;}          else{REJECT;}}
+SAFEINT	             {if (get_opt_safe_extensions(yyextra)) {return SAFEINT;}           else{REJECT;}}
+SAFEDINT	     {if (get_opt_safe_extensions(yyextra)) {return SAFEDINT;}          else{REJECT;}}
+SAFELINT             {if (get_opt_safe_extensions(yyextra)) {return SAFELINT;}          else{REJECT;}}
 
-SAFEUSINT            {if (get_opt_safe_extensions()) {return SAFEUSINT;}         else{REJECT;}}
-SAFEUINT             {if (get_opt_safe_extensions()) {return SAFEUINT;}          else{REJECT;}}
-SAFEUDINT            {if (get_opt_safe_extensions()) {return SAFEUDINT;}         else{REJECT;}}
-SAFEULINT            {if (get_opt_safe_extensions()) {return SAFEULINT;}         else{REJECT;}}
+SAFEUSINT            {if (get_opt_safe_extensions(yyextra)) {return SAFEUSINT;}         else{REJECT;}}
+SAFEUINT             {if (get_opt_safe_extensions(yyextra)) {return SAFEUINT;}          else{REJECT;}}
+SAFEUDINT            {if (get_opt_safe_extensions(yyextra)) {return SAFEUDINT;}         else{REJECT;}}
+SAFEULINT            {if (get_opt_safe_extensions(yyextra)) {return SAFEULINT;}         else{REJECT;}}
 
  /* SAFESTRING and SAFEWSTRING are not yet supported, i.e. checked correctly, in the semantic analyser (stage 3) */
  /*  so it is best not to support them at all... */
  /*
-SAFEWSTRING          {if (get_opt_safe_extensions()) {return SAFEWSTRING;}       else{REJECT;}}
-SAFESTRING           {if (get_opt_safe_extensions()) {return SAFESTRING;}        else{REJECT;}}
+SAFEWSTRING          {if (get_opt_safe_extensions(yyextra)) {return SAFEWSTRING;}       else{REJECT;}}
+SAFESTRING           {if (get_opt_safe_extensions(yyextra)) {return SAFESTRING;}        else{REJECT;}}
  */
 
-SAFETIME             {if (get_opt_safe_extensions()) {return SAFETIME;}          else{REJECT;}}
-SAFEDATE             {if (get_opt_safe_extensions()) {return SAFEDATE;}          else{REJECT;}}
-SAFEDT               {if (get_opt_safe_extensions()) {return SAFEDT;}            else{REJECT;}}
-SAFETOD              {if (get_opt_safe_extensions()) {return SAFETOD;}           else{REJECT;}}
-SAFEDATE_AND_TIME    {if (get_opt_safe_extensions()) {return SAFEDATE_AND_TIME;} else{REJECT;}}
-SAFETIME_OF_DAY      {if (get_opt_safe_extensions()) {return SAFETIME_OF_DAY;}   else{REJECT;}}
+SAFETIME             {if (get_opt_safe_extensions(yyextra)) {return SAFETIME;}          else{REJECT;}}
+SAFEDATE             {if (get_opt_safe_extensions(yyextra)) {return SAFEDATE;}          else{REJECT;}}
+SAFEDT               {if (get_opt_safe_extensions(yyextra)) {return SAFEDT;}            else{REJECT;}}
+SAFETOD              {if (get_opt_safe_extensions(yyextra)) {return SAFETOD;}           else{REJECT;}}
+SAFEDATE_AND_TIME    {if (get_opt_safe_extensions(yyextra)) {return SAFEDATE_AND_TIME;} else{REJECT;}}
+SAFETIME_OF_DAY      {if (get_opt_safe_extensions(yyextra)) {return SAFETIME_OF_DAY;}   else{REJECT;}}
 
 	/********************************/
 	/* B 1.3.2 - Generic data types */
@@ -1853,64 +1856,64 @@ EXIT		return EXIT;		/* Keyword */
 	/********************************************/
 	/* B.1.4.1   Directly Represented Variables */
 	/********************************************/
-{direct_variable}   {yylval.ID=strdup(yytext); return get_direct_variable_token(yytext);}
+{direct_variable}   {yylval->ID=(char *)intern_string(yytext); return get_direct_variable_token(yyextra, yytext);}
 
 
 	/******************************************/
 	/* B 1.4.3 - Declaration & Initialisation */
 	/******************************************/
-{incompl_location}	{yylval.ID=strdup(yytext); return incompl_location_token;}
+{incompl_location}	{yylval->ID=(char *)intern_string(yytext); return incompl_location_token;}
 
 
 	/************************/
 	/* B 1.2.3.1 - Duration */
 	/************************/
-{fixed_point}		{yylval.ID=strdup(yytext); return fixed_point_token;}
-{interval}		{/*fprintf(stderr, "entering time_literal_state ##%s##\n", yytext);*/ unput_and_mark('#'); yy_push_state(time_literal_state);}
+{fixed_point}		{yylval->ID=(char *)intern_string(yytext); return fixed_point_token;}
+{interval}		{/*fprintf(stderr, "entering time_literal_state ##%s##\n", yytext);*/ unput_and_mark('#', yyscanner); yy_push_state(time_literal_state, yyscanner);}
 {erroneous_interval}	{return erroneous_interval_token;}
 
 <time_literal_state>{
-{integer}d		{yylval.ID=strdup(yytext); yylval.ID[yyleng-1] = '\0'; return integer_d_token;}
-{integer}h		{yylval.ID=strdup(yytext); yylval.ID[yyleng-1] = '\0'; return integer_h_token;}
-{integer}m		{yylval.ID=strdup(yytext); yylval.ID[yyleng-1] = '\0'; return integer_m_token;}
-{integer}s		{yylval.ID=strdup(yytext); yylval.ID[yyleng-1] = '\0'; return integer_s_token;}
-{integer}ms		{yylval.ID=strdup(yytext); yylval.ID[yyleng-2] = '\0'; return integer_ms_token;}
-{fixed_point}d		{yylval.ID=strdup(yytext); yylval.ID[yyleng-1] = '\0'; return fixed_point_d_token;}
-{fixed_point}h		{yylval.ID=strdup(yytext); yylval.ID[yyleng-1] = '\0'; return fixed_point_h_token;}
-{fixed_point}m		{yylval.ID=strdup(yytext); yylval.ID[yyleng-1] = '\0'; return fixed_point_m_token;}
-{fixed_point}s		{yylval.ID=strdup(yytext); yylval.ID[yyleng-1] = '\0'; return fixed_point_s_token;}
-{fixed_point}ms		{yylval.ID=strdup(yytext); yylval.ID[yyleng-2] = '\0'; return fixed_point_ms_token;}
+{integer}d		{yylval->ID=(char *)intern_string(yytext, yyleng-1); return integer_d_token;}
+{integer}h		{yylval->ID=(char *)intern_string(yytext, yyleng-1); return integer_h_token;}
+{integer}m		{yylval->ID=(char *)intern_string(yytext, yyleng-1); return integer_m_token;}
+{integer}s		{yylval->ID=(char *)intern_string(yytext, yyleng-1); return integer_s_token;}
+{integer}ms		{yylval->ID=(char *)intern_string(yytext, yyleng-2); return integer_ms_token;}
+{fixed_point}d		{yylval->ID=(char *)intern_string(yytext, yyleng-1); return fixed_point_d_token;}
+{fixed_point}h		{yylval->ID=(char *)intern_string(yytext, yyleng-1); return fixed_point_h_token;}
+{fixed_point}m		{yylval->ID=(char *)intern_string(yytext, yyleng-1); return fixed_point_m_token;}
+{fixed_point}s		{yylval->ID=(char *)intern_string(yytext, yyleng-1); return fixed_point_s_token;}
+{fixed_point}ms		{yylval->ID=(char *)intern_string(yytext, yyleng-2); return fixed_point_ms_token;}
 
 _			/* do nothing - eat it up!*/
-\#			{/*fprintf(stderr, "popping from time_literal_state (###)\n");*/ yy_pop_state(); return end_interval_token;}
+\#			{/*fprintf(stderr, "popping from time_literal_state (###)\n");*/ yy_pop_state(yyscanner); return end_interval_token;}
 .			{/*fprintf(stderr, "time_literal_state: found invalid character '%s'. Aborting!\n", yytext);*/ ERROR;}
 \n			{ERROR;}
 }
 	/*******************************/
 	/* B.1.2.2   Character Strings */
 	/*******************************/
-{double_byte_character_string} {yylval.ID=strdup(yytext); return double_byte_character_string_token;}
-{single_byte_character_string} {yylval.ID=strdup(yytext); return single_byte_character_string_token;}
+{double_byte_character_string} {yylval->ID=(char *)intern_string(yytext); return double_byte_character_string_token;}
+{single_byte_character_string} {yylval->ID=(char *)intern_string(yytext); return single_byte_character_string_token;}
 
 
 	/******************************/
 	/* B.1.2.1   Numeric literals */
 	/******************************/
-{integer}		{yylval.ID=strdup(yytext); return integer_token;}
-{real}			{yylval.ID=strdup(yytext); return real_token;}
-{binary_integer}	{yylval.ID=strdup(yytext); return binary_integer_token;}
-{octal_integer} 	{yylval.ID=strdup(yytext); return octal_integer_token;}
-{hex_integer} 		{yylval.ID=strdup(yytext); return hex_integer_token;}
+{integer}		{yylval->ID=(char *)intern_string(yytext); return integer_token;}
+{real}			{yylval->ID=(char *)intern_string(yytext); return real_token;}
+{binary_integer}	{yylval->ID=(char *)intern_string(yytext); return binary_integer_token;}
+{octal_integer} 	{yylval->ID=(char *)intern_string(yytext); return octal_integer_token;}
+{hex_integer} 		{yylval->ID=(char *)intern_string(yytext); return hex_integer_token;}
 
 
 	/*****************************************/
 	/* B.1.1 Letters, digits and identifiers */
 	/*****************************************/
-<st_state>{identifier}/({st_whitespace_or_pragma_or_comment})"=>"	{yylval.ID=strdup(yytext); return sendto_identifier_token;}
-<il_state>{identifier}/({il_whitespace_or_pragma_or_comment})"=>"	{yylval.ID=strdup(yytext); return sendto_identifier_token;}
-{identifier} 				{yylval.ID=strdup(yytext);
-					 // printf("returning identifier...: %s, %d\n", yytext, get_identifier_token(yytext));
-					 return get_identifier_token(yytext);}
+<st_state>{identifier}/({st_whitespace_or_pragma_or_comment})"=>"	{yylval->ID=(char *)intern_string(yytext); return sendto_identifier_token;}
+<il_state>{identifier}/({il_whitespace_or_pragma_or_comment})"=>"	{yylval->ID=(char *)intern_string(yytext); return sendto_identifier_token;}
+{identifier} 				{yylval->ID=(char *)intern_string(yytext);
+					 // printf("returning identifier...: %s, %d\n", yytext, get_identifier_token(yyextra, yytext));
+					 return get_identifier_token(yyextra, yylval->ID);}
 
 
 
@@ -1953,33 +1956,41 @@ tracking_t *GetNewTracking(FILE* in_file) {
   new_env->lineLength  = 0;
   new_env->currentTokenStart = 0;
   new_env->in_file = in_file;
+  new_env->mapped_file = NULL;
   return new_env;
 }
 
 
+/* Forward declarations of functions defined later. */
+void unmap_input_file(tracking_t *tracking);
+void modified_input_file(tracking_t *tracking);
+
 void FreeTracking(tracking_t *tracking) {
+  unmap_input_file(tracking);
   delete tracking;
 }
 
 
-void UpdateTracking(const char *text) {
+void UpdateTracking(tracking_t *tracking, const char *text) {
   const char *newline, *token = text;
   while ((newline = strchr(token, '\n')) != NULL) {
     token = newline + 1;
-    current_tracking->lineNumber++;
-    current_tracking->currentChar = 1;
+    tracking->lineNumber++;
+    tracking->currentChar = 1;
   }
-  current_tracking->currentChar += strlen(token);
+  tracking->currentChar += strlen(token);
 }
 
 
-/* GetNextChar: reads a character from input */
-int GetNextChar(char *b, int maxBuffer) {
-  int res = fgetc(current_tracking->in_file);
-  if ( res == EOF ) 
+/* GetNextChar: reads the next block of characters from input (up to maxBuffer) */
+/* NOTE: flex keeps the characters read ahead in the buffer of the current file (each included file has
+ *       its own buffer), so there is no need to read one character at a time.
+ */
+int GetNextChar(tracking_t *tracking, char *b, int maxBuffer) {
+  if (maxBuffer <= 0)
     return 0;
-  *b = (char)res;
-  return 1;
+  size_t res = fread(b, 1, maxBuffer, tracking->in_file);
+  return (int)res;
 }
 
 
@@ -1989,36 +2000,169 @@ int GetNextChar(char *b, int maxBuffer) {
 /***********************************/
 
 /* print the include file stack to stderr... */
-void print_include_stack(void) {
+void print_include_stack(parse_context_t *context) {
   int i;
 
-  if ((include_stack_ptr - 1) >= 0)
+  if ((context->include_stack_ptr - 1) >= 0)
     fprintf (stderr, "in file "); 
-  for (i = include_stack_ptr - 1; i >= 0; i--)
-    fprintf (stderr, "included from file %s:%d\n", include_stack[i].filename, include_stack[i].env->lineNumber);
+  for (i = context->include_stack_ptr - 1; i >= 0; i--)
+    fprintf (stderr, "included from file %s:%d\n", context->include_stack[i].filename, context->include_stack[i].env->lineNumber);
+}
+
+
+
+/*****************************/
+/* Memory mapped input files */
+/*****************************/
+
+/* When runtime_options.mmap_input is set, every input file is mapped into memory, and flex scans
+ * it in place (using yy_scan_buffer()) instead of copying it into its own buffer through the FILE * stream.
+ *
+ * yy_scan_buffer() requires the buffer to end with two YY_END_OF_BUFFER_CHAR ('\0'), so we first reserve
+ * a (zero filled) anonymous memory region 2 bytes longer than the file, and then map the file over it.
+ * The file is mapped MAP_PRIVATE (i.e. copy on write) as flex writes into the buffer it is scanning.
+ * Most of these writes are undone before flex continues scanning (the '\0' placed after yytext, the characters
+ * returned to the input stream by unput_text() and unput_bodystate_buffer()), but not all of them
+ * (unput_and_mark() shifts the text it returns). The mapped_file_t records when the latter happens.
+ *
+ * The mappings are never unmapped, so a file that is parsed more than once (i.e. a file included several
+ * times, or parsed again by a later compilation in the same run) is only mapped once. The mapping is only
+ * re-used if the file has not changed in the meantime, and is not currently being scanned by an outer
+ * (*#include ...*), and its contents are restored first if they were modified while being scanned.
+ *
+ * Whenever a file cannot be mapped (e.g. it is a pipe), it is read through the FILE * stream, as usual.
+ *
+ * NOTE: The mappings are shared by all the scanners, so only one of them may be scanning a given file in place.
+ */
+#ifdef MMAP_INPUT_FILES
+typedef struct mapped_file_s {
+    dev_t  dev;
+    ino_t  ino;
+    off_t  size;
+    time_t mtime;
+    char  *buffer;
+    bool   in_use;   /* the file is currently being scanned by flex */
+    bool   modified; /* buffer no longer holds the original file contents */
+  } mapped_file_t;
+
+static std::vector<mapped_file_t *> mapped_files;
+#endif
+
+
+#ifdef MMAP_INPUT_FILES
+/* Stop re-using a mapping. Its memory is never released, as flex may still be using it. */
+static void forget_mapped_file(mapped_file_t *mapped_file) {
+  for (unsigned int i = 0; i < mapped_files.size(); i++)
+    if (mapped_files[i] == mapped_file) {mapped_files.erase(mapped_files.begin() + i); return;}
+}
+#endif
+
+
+/* Map the (already open) filehandle into memory, and switch flex to scan it in place.
+ * Returns true on success, or false if the file must be read through the filehandle instead.
+ */
+static bool map_input_file(FILE *filehandle, yyscan_t yyscanner) {
+#ifndef MMAP_INPUT_FILES
+  return false;
+#else
+  parse_context_t *context = yyget_extra(yyscanner);
+  struct stat st;
+  if (!context->options.mmap_input) return false;
+  if ((fstat(fileno(filehandle), &st) < 0) || !S_ISREG(st.st_mode)) return false;
+
+  mapped_file_t *mapped_file = NULL;
+  for (unsigned int i = 0; i < mapped_files.size(); i++)
+    if ((mapped_files[i]->dev == st.st_dev) && (mapped_files[i]->ino == st.st_ino)) mapped_file = mapped_files[i];
+
+  if ((NULL != mapped_file) && (mapped_file->in_use)) return false;
+  if ((NULL != mapped_file) && ((mapped_file->size != st.st_size) || (mapped_file->mtime != st.st_mtime))) {
+    forget_mapped_file(mapped_file); /* the file changed since it was mapped */
+    mapped_file = NULL;
+  }
+
+  if (NULL == mapped_file) {
+    size_t len = (size_t)st.st_size + 2;
+    char *buffer = (char *)mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (MAP_FAILED == buffer) return false;
+    if ((st.st_size > 0) && (MAP_FAILED == mmap(buffer, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fileno(filehandle), 0))) {
+      munmap(buffer, len);
+      return false;
+    }
+    mapped_file = new mapped_file_t;
+    mapped_file->dev      = st.st_dev;
+    mapped_file->ino      = st.st_ino;
+    mapped_file->size     = st.st_size;
+    mapped_file->mtime    = st.st_mtime;
+    mapped_file->buffer   = buffer;
+    mapped_file->in_use   = false;
+    mapped_file->modified = false;
+    mapped_files.push_back(mapped_file);
+  }
+
+  if (mapped_file->modified) {
+    /* mapping the file again over the same memory discards the private (modified) copy of its pages */
+    if (MAP_FAILED == mmap(mapped_file->buffer, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fileno(filehandle), 0)) {
+      forget_mapped_file(mapped_file); /* the memory is no longer mapped to anything sensible! */
+      return false;
+    }
+    mapped_file->modified = false;
+  }
+
+  /* NOTE: yy_scan_buffer() also switches flex to the new buffer */
+  if (NULL == yy_scan_buffer(mapped_file->buffer, st.st_size + 2, yyscanner)) ERROR;
+  mapped_file->in_use = true;
+  context->current_tracking->mapped_file = mapped_file;
+  return true;
+#endif
+}
+
+
+/* flex has finished scanning the file tracked by tracking (nothing to do if it was not mapped into memory). */
+void unmap_input_file(tracking_t *tracking) {
+#ifdef MMAP_INPUT_FILES
+  if (NULL == tracking->mapped_file) return;
+  tracking->mapped_file->in_use = false;
+  tracking->mapped_file = NULL;
+#endif
+}
+
+
+/* flex changed the text of the file tracked by tracking (nothing to do if it was not mapped into memory). */
+void modified_input_file(tracking_t *tracking) {
+#ifdef MMAP_INPUT_FILES
+  if (NULL != tracking->mapped_file) tracking->mapped_file->modified = true;
+#endif
 }
 
 
 
 /* set the internal state variables of lexical analyser to process a new include file */
-void handle_include_file_(FILE *filehandle, const char *filename) {
-  if (include_stack_ptr >= MAX_INCLUDE_DEPTH) {
+void handle_include_file_(FILE *filehandle, const char *filename, yyscan_t yyscanner) {
+  struct yyguts_t *yyg = (struct yyguts_t *)yyscanner;
+  parse_context_t *context = yyextra;
+  if (context->include_stack_ptr >= MAX_INCLUDE_DEPTH) {
     fprintf(stderr, "Includes nested too deeply\n");
     exit( 1 );
   }
   
   yyin = filehandle;
   
-  include_stack[include_stack_ptr].buffer_state = YY_CURRENT_BUFFER;
-  include_stack[include_stack_ptr].env = current_tracking;
-  include_stack[include_stack_ptr].filename = current_filename;
+  context->include_stack[context->include_stack_ptr].buffer_state = YY_CURRENT_BUFFER;
+  context->include_stack[context->include_stack_ptr].env = context->current_tracking;
+  context->include_stack[context->include_stack_ptr].filename = context->current_filename;
   
-  current_filename = strdup(filename);
-  current_tracking = GetNewTracking(yyin);
-  include_stack_ptr++;
+  context->current_filename = strdup(filename);
+  context->current_tracking = GetNewTracking(yyin);
+  context->include_stack_ptr++;
 
   /* switch input buffer to new file... */
-  yy_switch_to_buffer(yy_create_buffer(yyin, YY_BUF_SIZE));
+  if (map_input_file(filehandle, yyscanner)) {
+    /* Flex is now scanning a copy (in memory) of the file, so we no longer need to read from it. */
+    fclose(filehandle);
+    context->current_tracking->in_file = NULL;
+    return;
+  }
+  yy_switch_to_buffer(yy_create_buffer(yyin, YY_BUF_SIZE, yyscanner), yyscanner);
 }
 
 
@@ -2026,7 +2170,7 @@ void handle_include_file_(FILE *filehandle, const char *filename) {
 /* insert the code (in <source_code>) into the source code we are parsing.
  * This is done by creating an artificial file with that new source code, and then 'including' the file
  */
-void include_string_(const char *source_code) {
+void include_string_(const char *source_code, yyscan_t yyscanner) {
   FILE *tmp_file = tmpfile();
   
   if(tmp_file == NULL) {
@@ -2038,14 +2182,14 @@ void include_string_(const char *source_code) {
   rewind(tmp_file);
 
   /* now parse the tmp file, by asking flex to handle it as if it had been included with the (*#include ... *) pragma... */
-  handle_include_file_(tmp_file, "");
+  handle_include_file_(tmp_file, "", yyscanner);
 //fclose(tmp_file);  /* do NOT close file. It must only be closed when we finish reading from it! */
 }
 
 
 
 /* Open an include file, and set the internal state variables of lexical analyser to process a new include file */
-void include_file(const char *filename) {
+void include_file(const char *filename, yyscan_t yyscanner) {
   FILE *filehandle = NULL;
   
   for (int i = 0; (INCLUDE_DIRECTORIES[i] != NULL) && (filehandle == NULL); i++) {
@@ -2065,14 +2209,15 @@ void include_file(const char *filename) {
   }
 
   /* now process the new file... */
-  handle_include_file_(filehandle, filename);
+  handle_include_file_(filehandle, filename, yyscanner);
 }
 
 
 
 /* return the specified character to the input stream */
 /* WARNING: this function destroys the contents of yytext */
-void unput_char(const char c) {
+void unput_char(const char c, yyscan_t yyscanner) {
+  struct yyguts_t *yyg = (struct yyguts_t *)yyscanner;
   /* NOTE: The following uncomented code is not necessary as we currently use a different algorithm:
    *          - make a backup/snapshot of the current tracking data (in previous_tracking variable)
    *             (done in YY_USER_ACTION)
@@ -2101,17 +2246,18 @@ void unput_char(const char c) {
 
 
 /* return all the text in the current token back to the input stream, except the first n chars. */
-void unput_text(int n) {
+void unput_text(int n, yyscan_t yyscanner) {
+  struct yyguts_t *yyg = (struct yyguts_t *)yyscanner;
   if (n < 0) ERROR;
   signed int i; // must be signed! The iterartion may end with -1 when this function is called with n=0 !!
 
   char *yycopy = strdup( yytext ); /* unput_char() destroys yytext, so we copy it first */
   for (int i = yyleng-1; i >= n; i--)
-    unput_char(yycopy[i]);
+    unput_char(yycopy[i], yyscanner);
 
-  *current_tracking = previous_tracking;
+  *yyextra->current_tracking = yyextra->previous_tracking;
   yycopy[n] = '\0';
-  UpdateTracking(yycopy);
+  UpdateTracking(yyextra->current_tracking, yycopy);
   
   free(yycopy);
 }
@@ -2121,14 +2267,17 @@ void unput_text(int n) {
 /* return all the text in the current token back to the input stream, 
  * but first return to the stream an additional character to mark the end of the token. 
  */
-void unput_and_mark(const char mark_char) {
+void unput_and_mark(const char mark_char, yyscan_t yyscanner) {
+  struct yyguts_t *yyg = (struct yyguts_t *)yyscanner;
+  /* The text returned to the input stream is shifted by one char, so it no longer matches the original file */
+  modified_input_file(yyextra->current_tracking);
   char *yycopy = strdup( yytext ); /* unput_char() destroys yytext, so we copy it first */
-  unput_char(mark_char);
+  unput_char(mark_char, yyscanner);
   for (int i = yyleng-1; i >= 0; i--)
-    unput_char(yycopy[i]);
+    unput_char(yycopy[i], yyscanner);
 
   free(yycopy);
-  *current_tracking = previous_tracking;
+  *yyextra->current_tracking = yyextra->previous_tracking;
 }
 
 
@@ -2139,48 +2288,48 @@ void unput_and_mark(const char mark_char) {
  * once we have decided if we are parsing ST or IL code. The following functions manage that buffer used by
  * the body_state.
  */
-/* The buffer used by the body_state state */
-char *bodystate_buffer        = NULL;
-bool  bodystate_is_whitespace = 1; // TRUE (1) if buffer is empty, or only contains whitespace.
-tracking_t bodystate_init_tracking;
+/* The buffer used by the body_state state is yyextra->bodystate_buffer */
 
 /* append text to bodystate_buffer */
-void  append_bodystate_buffer(const char *text, int is_whitespace) {
-  // printf("<<<append_bodystate_buffer>>> %d <%s><%s>\n", bodystate_buffer, text, (NULL != bodystate_buffer)?bodystate_buffer:"NULL");
+void  append_bodystate_buffer(const char *text, int is_whitespace, yyscan_t yyscanner) {
+  parse_context_t *context = yyget_extra(yyscanner);
+  // printf("<<<append_bodystate_buffer>>> %d <%s><%s>\n", context->bodystate_buffer, text, (NULL != context->bodystate_buffer)?context->bodystate_buffer:"NULL");
   long int old_len = 0;
   // make backup of tracking if we are starting off a new body_state_buffer
-  if (NULL == bodystate_buffer) bodystate_init_tracking = *current_tracking;
+  if (NULL == context->bodystate_buffer) context->bodystate_init_tracking = *context->current_tracking;
   // set bodystate_is_whitespace flag if we are starting a new buffer
-  if (NULL == bodystate_buffer) bodystate_is_whitespace = 1;
+  if (NULL == context->bodystate_buffer) context->bodystate_is_whitespace = 1;
   // set bodystate_is_whitespace flag to FALSE if we are adding non white space to buffer
-  if (!is_whitespace)           bodystate_is_whitespace = 0;
+  if (!is_whitespace)                    context->bodystate_is_whitespace = 0;
 
-  if (NULL != bodystate_buffer) old_len = strlen(bodystate_buffer);
-  bodystate_buffer = (char *)realloc(bodystate_buffer, old_len + strlen(text) + 1);
-  if (NULL == bodystate_buffer) ERROR;
-  strcpy(bodystate_buffer + old_len, text);
-  //printf("=<%s> %d %d\n", (NULL != bodystate_buffer)?bodystate_buffer:NULL, old_len + strlen(text) + 1, bodystate_buffer);
+  if (NULL != context->bodystate_buffer) old_len = strlen(context->bodystate_buffer);
+  context->bodystate_buffer = (char *)realloc(context->bodystate_buffer, old_len + strlen(text) + 1);
+  if (NULL == context->bodystate_buffer) ERROR;
+  strcpy(context->bodystate_buffer + old_len, text);
+  //printf("=<%s> %d %d\n", (NULL != context->bodystate_buffer)?context->bodystate_buffer:NULL, old_len + strlen(text) + 1, context->bodystate_buffer);
 }
 
 /* Return all data in bodystate_buffer back to flex, and empty bodystate_buffer. */
-void   unput_bodystate_buffer(void) {
-  if (NULL == bodystate_buffer) ERROR;
-  // printf("<<<unput_bodystate_buffer>>>\n%s\n", bodystate_buffer);
+void   unput_bodystate_buffer(yyscan_t yyscanner) {
+  parse_context_t *context = yyget_extra(yyscanner);
+  if (NULL == context->bodystate_buffer) ERROR;
+  // printf("<<<unput_bodystate_buffer>>>\n%s\n", context->bodystate_buffer);
   
-  for (long int i = strlen(bodystate_buffer)-1; i >= 0; i--)
-    unput_char(bodystate_buffer[i]);
+  for (long int i = strlen(context->bodystate_buffer)-1; i >= 0; i--)
+    unput_char(context->bodystate_buffer[i], yyscanner);
   
-  free(bodystate_buffer);
-  bodystate_buffer        = NULL;
-  bodystate_is_whitespace = 1;  
-  *current_tracking = bodystate_init_tracking;
+  free(context->bodystate_buffer);
+  context->bodystate_buffer        = NULL;
+  context->bodystate_is_whitespace = 1;  
+  *context->current_tracking = context->bodystate_init_tracking;
 }
 
 
 /* Return true if bodystate_buffer is empty or ony contains whitespace!! */
-int  isempty_bodystate_buffer(void) {
-  if (NULL == bodystate_buffer) return 1;
-  if (bodystate_is_whitespace)  return 1;
+int  isempty_bodystate_buffer(yyscan_t yyscanner) {
+  parse_context_t *context = yyget_extra(yyscanner);
+  if (NULL == context->bodystate_buffer) return 1;
+  if (context->bodystate_is_whitespace)  return 1;
   return 0;
 }
 
@@ -2190,15 +2339,16 @@ int  isempty_bodystate_buffer(void) {
  * will be prepended to the next text block of code being appended to bodystate_buffer,
  * which may cause trouble if it is IL code
  */
-void  del_bodystate_buffer(void) {
-  free(bodystate_buffer);
-  bodystate_buffer        = NULL;
-  bodystate_is_whitespace = 1;  
+void  del_bodystate_buffer(yyscan_t yyscanner) {
+  parse_context_t *context = yyget_extra(yyscanner);
+  free(context->bodystate_buffer);
+  context->bodystate_buffer        = NULL;
+  context->bodystate_is_whitespace = 1;  
 }
 
 
 /* Called by flex when it reaches the end-of-file */
-int yywrap(void)
+int yywrap(yyscan_t yyscanner)
 {
   /* We reached the end of the input file... */
 
@@ -2223,7 +2373,41 @@ int yywrap(void)
 
 /* The following functions will be called from inside bison code! */
 
-void include_string(const char *source_code) {include_string_(source_code);}
+void include_string(parse_context_t *context, const char *source_code) {include_string_(source_code, context->scanner);}
+
+
+/* The token parser called by bison, i.e. the scanner of the context. */
+int yylex(YYSTYPE *yylval_param, YYLTYPE *yylloc_param, parse_context_t *context) {
+  return scan_token(yylval_param, yylloc_param, context->scanner);
+}
+
+
+/* Create the scanner of a new compilation. */
+void init_lexer(parse_context_t *context) {
+  context->bodystate_is_whitespace = 1;
+  if (0 != yylex_init_extra(context, &context->scanner)) {
+    perror("Error creating the lexical analyser");
+    exit(EXIT_FAILURE);
+  }
+}
+
+
+/* Discard all the state of the scanner, including any left over from a compilation that failed midway. */
+void destroy_lexer(parse_context_t *context) {
+  /* NOTE: The main input file is closed by bison, so only the include files that are still open are closed here. */
+  for (; context->include_stack_ptr > 0; context->include_stack_ptr--) {
+    if (NULL != context->current_tracking->in_file) fclose(context->current_tracking->in_file);
+    FreeTracking(context->current_tracking);
+    context->current_tracking = context->include_stack[context->include_stack_ptr - 1].env;
+  }
+  if (NULL != context->current_tracking) FreeTracking(context->current_tracking);
+  context->current_tracking = NULL;
+  context->current_filename = NULL;
+  del_bodystate_buffer(context->scanner);
+  /* frees all the buffers and the start condition stack */
+  yylex_destroy(context->scanner);
+  context->scanner = NULL;
+}
 
 
 /* Tell flex which file to parse. This function will not imediately start parsing the file.
@@ -2232,13 +2416,19 @@ void include_string(const char *source_code) {include_string_(source_code);}
  * Returns NULL on error opening the file (and a valid errno), or 0 on success.
  * Caller must close the file!
  */
-FILE *parse_file(const char *filename) {
+FILE *parse_file(parse_context_t *context, const char *filename) {
   FILE *filehandle = NULL;
+  yyscan_t yyscanner = context->scanner;
 
   if((filehandle = fopen(filename, "r")) != NULL) {
-    yyin = filehandle;
-    current_filename = strdup(filename);
-    current_tracking = GetNewTracking(yyin);
+    /* If the previous file was scanned in place, the current buffer will never read from yyin! */
+    bool new_buffer = (NULL != context->current_tracking) && (NULL != context->current_tracking->mapped_file);
+    if (NULL != context->current_tracking) unmap_input_file(context->current_tracking);
+    yyset_in(filehandle, yyscanner);
+    context->current_filename = strdup(filename);
+    context->current_tracking = GetNewTracking(filehandle);
+    if (map_input_file(filehandle, yyscanner)) return filehandle; /* NOTE: Caller must still close the file! */
+    if (new_buffer) yy_switch_to_buffer(yy_create_buffer(filehandle, YY_BUF_SIZE, yyscanner), yyscanner);
   }
   return filehandle;
 }
@@ -2256,25 +2446,28 @@ FILE *parse_file(const char *filename) {
 
 #include "../util/symtable.hh"
 
-yystype yylval;
-YYLTYPE yylloc;
+/* NOTE: yylval and yylloc are macros in a reentrant scanner */
+YYSTYPE token_value;
+YYLTYPE token_location;
 
 
 
 
-int get_identifier_token(const char *identifier_str) {return 0;}
-int get_direct_variable_token(const char *direct_variable_str) {return 0;}
+int get_identifier_token(parse_context_t *context, const char *identifier_str) {return 0;}
+int get_direct_variable_token(parse_context_t *context, const char *direct_variable_str) {return 0;}
 
 
 int main(int argc, char **argv) {
 
-  FILE *in_file;
+  FILE *in_file = stdin;
   int res;
+  parse_context_t context = parse_context_t();  /* value initialised, i.e. all options off */
+
+  init_lexer(&context);
 	
   if (argc == 1) {
     /* Work as an interactive (command line) parser... */
-    while((res=yylex()))
-      fprintf(stderr, "(line %d)token: %d\n", yylineno, res);
+    context.current_filename = "<stdin>";
   } else {
     /* Work as non-interactive (file) parser... */
     if((in_file = fopen(argv[1], "r")) == NULL) {
@@ -2283,16 +2476,16 @@ int main(int argc, char **argv) {
       free(errmsg);
       return -1;
     }
-
-    /* parse the file... */
-    yyin = in_file;
-    current_filename = argv[1];
-    while(1) {
-      res=yylex();
-      fprintf(stderr, "(line %d)token: %d (%s)\n", yylineno, res, yylval.ID);
-    }
+    context.current_filename = argv[1];
   }
-	
+
+  /* parse the file... */
+  yyset_in(in_file, context.scanner);
+  context.current_tracking = GetNewTracking(in_file);
+  while((res=yylex(&token_value, &token_location, &context)))
+    fprintf(stderr, "(line %d)token: %d\n", token_location.first_line, res);
+
+  destroy_lexer(&context);
 	return 0;
 
 }
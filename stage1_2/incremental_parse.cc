@@ -0,0 +1,261 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+/*
+ * Incremental parsing of the input file, for the compile server (see incremental_parse.hh).
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "../config/config.h"
+#include "../absyntax/absyntax.hh"
+#include "../absyntax/visitor.hh"
+#include "../absyntax_utils/serialize_ast.hh"
+#include "../main.hh"
+#include "prescan.hh"
+#include "incremental_parse.hh"
+
+
+
+/* A POU of the previous parse */
+typedef struct {
+    std::string text;    /* its source code */
+    int         column;  /* where its source code started */
+    int         line;    /* where its source code started when ast was serialized */
+    std::string ast;     /* the (serialized) AST built from its source code */
+  } cached_pou_t;
+
+static bool                                 enabled = false;
+static std::string                          cached_filename;
+static std::string                          cached_outline;
+static std::map<std::string, cached_pou_t>  cached_pous;       /* by (upper case) name */
+
+/* the input file currently being parsed */
+static bool                                 active = false;
+static std::string                          current_filename;
+static std::string                          text;
+static std::string                          outline;
+static std::vector<prescan_pou_extent_t>    extents;
+static std::map<std::string, int>           unchanged_pous;    /* the POUs taken from cached_pous, with the line they now start at */
+
+
+static std::string upper_case(const char *str) {
+  std::string res(str);
+  for (unsigned int i = 0; i < res.size(); i++) res[i] = toupper((unsigned char)res[i]);
+  return res;
+}
+
+
+
+/* The stream the ASTs are serialized to, and read back from */
+#if defined(HAVE_OPEN_MEMSTREAM) && defined(HAVE_FMEMOPEN)
+static bool write_ast(symbol_c *pou, std::string &ast) {
+  char  *buffer = NULL;
+  size_t size   = 0;
+  FILE  *out    = open_memstream(&buffer, &size);
+  if (NULL == out) return false;
+  serialize_ast_c s(out);
+  s.write_symbol(pou);
+  bool ok = !s.failed();
+  if (0 != fclose(out)) ok = false;  /* the buffer is only valid after fclose() */
+  if (ok) ast.assign(buffer, size);
+  free(buffer);
+  return ok;
+}
+
+static FILE *open_ast(const std::string &ast) {return fmemopen((void *)ast.data(), ast.size(), "rb");}
+#else
+static bool write_ast(symbol_c *pou, std::string &ast) {
+  FILE *out = tmpfile();
+  if (NULL == out) return false;
+  serialize_ast_c s(out);
+  s.write_symbol(pou);
+  bool ok = !s.failed() && (0 == fflush(out));
+  rewind(out);
+  char   buffer[16*1024];
+  size_t n;
+  ast.clear();
+  while (ok && ((n = fread(buffer, 1, sizeof(buffer), out)) > 0)) ast.append(buffer, n);
+  fclose(out);
+  return ok;
+}
+
+static FILE *open_ast(const std::string &ast) {
+  FILE *in = tmpfile();
+  if (NULL == in) return NULL;
+  if ((fwrite(ast.data(), 1, ast.size(), in) != ast.size()) || (0 != fflush(in))) {fclose(in); return NULL;}
+  rewind(in);
+  return in;
+}
+#endif
+
+
+
+/* Move all the locations of a (copy of a) POU by the same number of lines */
+class move_locations_c: public fcall_iterator_visitor_c {
+  private:
+    int                  lines;
+    std::set<symbol_c *> moved;  /* the symbols shared by several parents are only moved once */
+
+  public:
+    move_locations_c(int lines_) {lines = lines_;}
+
+    void prefix_fcall(symbol_c *symbol) {
+      if (!moved.insert(symbol).second) return;
+      symbol->first_line += lines;
+      symbol->last_line  += lines;
+    }
+};
+
+
+
+static void forget_cached_pous(void) {
+  cached_filename.clear();
+  cached_outline.clear();
+  cached_pous.clear();
+}
+
+
+void incremental_parse_enable(bool enable) {
+  enabled = enable;
+  if (!enable) forget_cached_pous();
+}
+
+
+bool incremental_parse_active(void) {return active;}
+
+
+void incremental_parse_begin(parse_context_t *context, const char *filename) {
+  active = false;
+  unchanged_pous.clear();
+  if (!enabled) return;
+  if (prescan_outline(context, filename, text, outline, extents) < 0) return;  /* the parser will complain about the file */
+  active = true;
+  current_filename = filename;
+
+  if ((cached_filename != filename) || (cached_outline != outline)) return;
+  for (unsigned int i = 0; i < extents.size(); i++) {
+    std::map<std::string, cached_pou_t>::iterator pou = cached_pous.find(extents[i].name);
+    if (cached_pous.end() == pou) continue;
+    if (pou->second.column != extents[i].column) continue;
+    if (text.compare(extents[i].begin, extents[i].end - extents[i].begin, pou->second.text) != 0) continue;
+    unchanged_pous[extents[i].name] = extents[i].line;
+  }
+}
+
+
+bool incremental_pou_unchanged(const char *pou_name) {
+  if (unchanged_pous.empty()) return false;
+  return unchanged_pous.find(upper_case(pou_name)) != unchanged_pous.end();
+}
+
+
+symbol_c *incremental_pou_ast(const char *pou_name) {
+  std::string name = upper_case(pou_name);
+  std::map<std::string, int>::iterator unchanged = unchanged_pous.find(name);
+  if (unchanged_pous.end() == unchanged) return NULL;
+  cached_pou_t &pou = cached_pous[name];
+
+  FILE *in = open_ast(pou.ast);
+  if (NULL == in) ERROR_MSG("unable to read back the AST of POU %s.", pou_name);  /* flex has already skipped its source code! */
+  deserialize_ast_c d(in);  /* reads the whole stream */
+  fclose(in);
+  symbol_c *ast = d.read_symbol();
+  if (d.failed() || (NULL == ast)) ERROR_MSG("unable to read back the AST of POU %s.", pou_name);
+
+  if (unchanged->second != pou.line) {
+    move_locations_c move_locations(unchanged->second - pou.line);
+    ast->accept(move_locations);
+  }
+  return ast;
+}
+
+
+/* the name of a FUNCTION, FUNCTION_BLOCK or PROGRAM, NULL for the other library elements */
+static const char *pou_name(symbol_c *element) {
+  symbol_c *name = NULL;
+  if      (function_declaration_c       *f = dynamic_cast<function_declaration_c       *>(element)) name = f->derived_function_name;
+  else if (function_block_declaration_c *f = dynamic_cast<function_block_declaration_c *>(element)) name = f->fblock_name;
+  else if (program_declaration_c        *p = dynamic_cast<program_declaration_c        *>(element)) name = p->program_type_name;
+  token_c *token = dynamic_cast<token_c *>(name);
+  return (NULL == token)? NULL : token->value;
+}
+
+
+void incremental_parse_end(symbol_c *tree_root, int first_element) {
+  bool was_active = active;
+  active = false;
+  if (!enabled || !was_active) return;
+
+  list_c *library = dynamic_cast<list_c *>(tree_root);
+  if (NULL == library) {
+    /* the file had errors */
+    forget_cached_pous();
+    unchanged_pous.clear();
+    return;
+  }
+
+  std::map<std::string, cached_pou_t> pous;
+  std::map<std::string, prescan_pou_extent_t *> extent_of;
+  for (unsigned int i = 0; i < extents.size(); i++) extent_of[extents[i].name] = &extents[i];
+
+  for (int i = first_element; i < library->n; i++) {
+    const char *name_str = pou_name(library->get_element(i));
+    if (NULL == name_str) continue;
+    std::string name = upper_case(name_str);
+    std::map<std::string, prescan_pou_extent_t *>::iterator extent = extent_of.find(name);
+    if (extent_of.end() == extent) continue;  /* declared in an included file */
+
+    if (unchanged_pous.find(name) != unchanged_pous.end()) {
+      /* taken from the previous parse, keep the AST (still at the lines where it was serialized) */
+      pous[name] = cached_pous[name];
+      continue;
+    }
+    cached_pou_t &pou = pous[name];
+    pou.text   = text.substr(extent->second->begin, extent->second->end - extent->second->begin);
+    pou.column = extent->second->column;
+    pou.line   = extent->second->line;
+    if (!write_ast(library->get_element(i), pou.ast)) pous.erase(name);  /* not fatal, it will be parsed again next time */
+  }
+
+  cached_pous.swap(pous);
+  cached_filename = current_filename;
+  cached_outline.swap(outline);
+  unchanged_pous.clear();
+}
@@ -0,0 +1,88 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+/*
+ * Incremental parsing of the input file, for the compile server (-S command line option).
+ *
+ * IDEs send the same input file to the compile server over and over, after each change made by the
+ * user, which usually only changes the body of a single POU. Before the input file is parsed, it is
+ * pre-scanned to find the extent (i.e. the source code) of each FUNCTION, FUNCTION_BLOCK and PROGRAM
+ * it declares, and its outline: the source code outside of these POUs (the datatypes, configurations,
+ * and pragmas), the kind and name of each POU, and the source code of all the included files (see
+ * prescan_outline()).
+ *
+ * When the outline is the same as the one of the previous (error free) parse of the same file, every
+ * POU starts with the same library_element_symtable and lexer state as it did then. Each POU whose
+ * source code has not changed either (and that still starts in the same column) is then skipped by flex
+ * (in its ignore_pou_state), and bison takes its AST from a copy of the one it built the previous time.
+ * The locations of the copy are moved to the lines the POU now starts at. Only the POUs that did change
+ * are lexed and parsed again.
+ *
+ * The copies are kept serialized (see serialize_ast.hh), as the AST handed to stage 3 gets annotated.
+ * As the standard library kept in memory (see stage1_2_cache_library()), each parse gets a new AST.
+ *
+ * NOTE: The 'order' of the locations of the copy is left as it was (it is only used to sort the
+ *       locations of a single POU, in the error messages of stage 4).
+ */
+
+
+#ifndef _INCREMENTAL_PARSE_HH
+#define _INCREMENTAL_PARSE_HH
+
+#include "../absyntax/absyntax.hh"
+
+/* defined in stage1_2_priv.hh */
+typedef struct parse_context_s parse_context_t;
+
+
+/* Keep the POUs of the parsed input files, for the following parses of the same file (or forget them) */
+void incremental_parse_enable(bool enable);
+
+/* Whether the POUs of the input file currently being parsed may be taken from the previous parse */
+bool incremental_parse_active(void);
+
+/* Before parsing the input file: find its POUs unchanged since the previous parse of the same file */
+void incremental_parse_begin(parse_context_t *context, const char *filename);
+
+/* Whether the POU of the input file is unchanged, i.e. may be skipped by flex */
+bool incremental_pou_unchanged(const char *pou_name);
+
+/* A new copy of the AST of the unchanged POU, at the location of its current source code (NULL if none) */
+symbol_c *incremental_pou_ast(const char *pou_name);
+
+/* After parsing the input file: remember its POUs, i.e. the elements of the library tree_root starting
+ * at first_element (NULL if the file had errors, to forget them)
+ */
+void incremental_parse_end(symbol_c *tree_root, int first_element);
+
+
+#endif /* _INCREMENTAL_PARSE_HH */
@@ -0,0 +1,279 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+/*
+ * Precompiled snapshot of the standard library.
+ *
+ * Snapshot file layout (see serialize_ast.hh for the encoding of each entry):
+ *   - magic string, format version, schema signature of absyntax.def
+ *   - list of library source files: (name, full path, mtime, size), terminated by a NULL name
+ *   - library_element_symtable entries: (name, category), terminated by a NULL name
+ *   - the library AST (a library_c)
+ *
+ * The symtable is stored before the AST so that the pre-parsing run may stop reading early.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <set>
+#include <string>
+
+#include "../absyntax/absyntax.hh"
+#include "../absyntax/visitor.hh"
+#include "../absyntax_utils/serialize_ast.hh"
+#include "../main.hh"
+#include "stage1_2.hh"
+#include "iec_bison.hh"
+#include "stage1_2_priv.hh"
+#include "library_snapshot.hh"
+
+
+#define SNAPSHOT_MAGIC   "matiec library snapshot"
+#define SNAPSHOT_VERSION 1
+
+extern const char *INCLUDE_DIRECTORIES[];
+
+
+/* The token ids generated by bison change whenever the grammar changes, so the snapshot
+ * stores the index into this table instead of the token id itself.
+ */
+static const int library_element_categories[] = {
+  prev_declared_simple_type_name_token,
+  prev_declared_subrange_type_name_token,
+  prev_declared_enumerated_type_name_token,
+  prev_declared_array_type_name_token,
+  prev_declared_structure_type_name_token,
+  prev_declared_string_type_name_token,
+  prev_declared_ref_type_name_token,
+  prev_declared_derived_function_name_token,
+  prev_declared_derived_function_block_name_token,
+  prev_declared_program_type_name_token,
+  prev_declared_configuration_name_token,
+  standard_function_block_name_token,
+  -1 /* end of array marker! Do not remove! */
+};
+
+static int category_index(int token) {
+  for (int i = 0; library_element_categories[i] >= 0; i++)
+    if (library_element_categories[i] == token) return i;
+  return -1;
+}
+
+static int category_token(int64_t index) {
+  for (int i = 0; library_element_categories[i] >= 0; i++)
+    if (i == index) return library_element_categories[i];
+  return -1;
+}
+
+
+
+/* The command line options that change the result of parsing the library. */
+static std::string snapshot_filename(parse_context_t *context, const char *libfilename) {
+  std::string key;
+  if (context->options.allow_void_datatype)      key += 'b';
+  if (context->options.allow_missing_var_in)     key += 'i';
+  if (context->options.conversion_functions)     key += 'c';
+  if (context->options.disable_implicit_en_eno)  key += 'e';
+  if (context->options.full_token_loc)           key += 'f';
+  if (context->options.nested_comments)          key += 'n';
+  if (context->options.nonliteral_in_array_size) key += 'a';
+  if (context->options.ref_standard_extensions)  key += 'r';
+  if (context->options.ref_nonstand_extensions)  key += 'R';
+  if (context->options.safe_extensions)          key += 's';
+
+  std::string name(libfilename);
+  if (!key.empty()) name += "." + key;
+  return name + ".snapshot";
+}
+
+
+
+/* Find the file that flex would open for a file name stored in the AST.
+ * The library file itself is stored with its full path, all others (i.e. the included files)
+ * are stored with the name used in the (*#include ... *) pragma.
+ */
+static std::string resolve_source_file(const char *libfilename, const char *name, struct stat *st) {
+  if (strcmp(name, libfilename) == 0) {
+    if (stat(name, st) == 0) return name;
+    return "";
+  }
+  for (int i = 0; INCLUDE_DIRECTORIES[i] != NULL; i++) {
+    std::string full_name = std::string(INCLUDE_DIRECTORIES[i]) + "/" + name;
+    if (stat(full_name.c_str(), st) == 0) return full_name;
+  }
+  return "";
+}
+
+
+/* Collect the names of all the files the library was parsed from. */
+class get_source_files_c: public fcall_iterator_visitor_c {
+  public:
+    std::set<std::string> files;
+
+    void prefix_fcall(symbol_c *symbol) {
+      add_file(symbol->first_file);
+      add_file(symbol->last_file);
+    }
+
+    void add_file(const char *name) {
+      /* NOTE: code parsed from a string (e.g. include_string()) is stored with an empty file name. */
+      if ((NULL != name) && ('\0' != *name)) files.insert(name);
+    }
+};
+
+
+
+
+int load_library_snapshot(parse_context_t *context, const char *libfilename) {
+  std::string filename = snapshot_filename(context, libfilename);
+  FILE *in = fopen(filename.c_str(), "rb");
+  if (NULL == in) return -1;
+  int res = load_library_snapshot(context, libfilename, in);
+  fclose(in);
+  return res;
+}
+
+
+int load_library_snapshot(parse_context_t *context, const char *libfilename, FILE *in) {
+  deserialize_ast_c d(in);
+
+  /* header... */
+  const char *magic = d.read_string();
+  if ((NULL == magic) || (strcmp(magic, SNAPSHOT_MAGIC) != 0)) return -1;
+  if (d.read_int() != SNAPSHOT_VERSION)                     return -1;
+  if (d.read_int() != serialize_ast_c::schema_signature())  return -1;
+  if (d.failed()) return -1;
+
+  /* check none of the library source files has changed since the snapshot was created... */
+  for (const char *name = d.read_string(); NULL != name; name = d.read_string()) {
+    const char *path  = d.read_string();
+    int64_t     mtime = d.read_int();
+    int64_t     size  = d.read_int();
+    struct stat st;
+    if (d.failed() || (NULL == path)) return -1;
+    if (resolve_source_file(libfilename, name, &st) != path) return -1;
+    if ((mtime != (int64_t)st.st_mtime) || (size != (int64_t)st.st_size)) return -1;
+  }
+  if (d.failed()) return -1;
+
+  /* library_element_symtable entries... */
+  std::vector<std::pair<const char *, int> > entries;
+  for (const char *name = d.read_string(); NULL != name; name = d.read_string()) {
+    int token = category_token(d.read_int());
+    if (token < 0) return -1;
+    entries.push_back(std::make_pair(name, token));
+  }
+  if (d.failed()) return -1;
+
+  /* the library itself... */
+  list_c *library = dynamic_cast<list_c *>(d.read_symbol());
+  if (d.failed() || (NULL == library)) return -1;
+
+  /* The snapshot is valid. Only now do we start changing the parser state! */
+  for (unsigned int i = 0; i < entries.size(); i++)
+    context->library_element_symtable.insert(entries[i].first, entries[i].second);
+
+  if (NULL == context->tree_root) context->tree_root = library;
+  else {
+    list_c *tree_root = dynamic_cast<list_c *>(context->tree_root);
+    if (NULL == tree_root) ERROR;
+    for (int i = 0; i < library->n; i++)
+      tree_root->add_element(library->get_element(i));
+  }
+  return 0;
+}
+
+
+
+
+int save_library_snapshot(parse_context_t *context, const char *libfilename) {
+  std::string filename = snapshot_filename(context, libfilename);
+  std::string tmp_filename = filename + ".tmp";
+  FILE *out = fopen(tmp_filename.c_str(), "wb");
+  if (NULL == out) {
+    perror(("Error creating library snapshot " + tmp_filename).c_str());
+    return -1;
+  }
+
+  bool failed = (save_library_snapshot(context, libfilename, out) < 0);
+  if (fclose(out) != 0) failed = true;
+  if (failed || (rename(tmp_filename.c_str(), filename.c_str()) != 0)) {
+    perror(("Error writing library snapshot " + filename).c_str());
+    remove(tmp_filename.c_str());
+    return -1;
+  }
+  return 0;
+}
+
+
+int save_library_snapshot(parse_context_t *context, const char *libfilename, FILE *out) {
+  symbol_c *library_root = context->tree_root;
+  serialize_ast_c s(out);
+  s.write_string(SNAPSHOT_MAGIC);
+  s.write_int(SNAPSHOT_VERSION);
+  s.write_int(serialize_ast_c::schema_signature());
+
+  get_source_files_c source_files;
+  source_files.add_file(libfilename);
+  if (NULL != library_root) library_root->accept(source_files);
+  for (std::set<std::string>::iterator i = source_files.files.begin(); i != source_files.files.end(); i++) {
+    struct stat st;
+    std::string path = resolve_source_file(libfilename, i->c_str(), &st);
+    if (path.empty()) {
+      fprintf(stderr, "Error creating library snapshot: could not find library source file %s\n", i->c_str());
+      return -1;
+    }
+    s.write_string(i->c_str());
+    s.write_string(path.c_str());
+    s.write_int(st.st_mtime);
+    s.write_int(st.st_size);
+  }
+  s.write_string(NULL);
+
+  for (library_element_symtable_t::iterator i = context->library_element_symtable.begin(); i != context->library_element_symtable.end(); i++) {
+    int index = category_index(i->second);
+    if (index < 0) ERROR;
+    s.write_string(i->first);
+    s.write_int(index);
+  }
+  s.write_string(NULL);
+
+  if (NULL == library_root) library_root = new library_c();
+  s.write_symbol(library_root);
+
+  if (fflush(out) != 0) return -1;
+  return s.failed()? -1 : 0;
+}
@@ -0,0 +1,83 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+/*
+ * Precompiled snapshot of the standard library.
+ *
+ * Parsing the standard library (ieclib.txt, and all the files it includes) takes up most
+ * of the time needed to compile a small project. The snapshot stores the AST produced
+ * by parsing the library, together with the entries it added to the library_element_symtable,
+ * so that later runs of the compiler may load it instead of parsing the library again.
+ *
+ * The snapshot is stored next to the library file, in <libfile>.<key>.snapshot
+ * where <key> lists the command line options that change the way the library is parsed
+ * (e.g. ieclib.txt.rs.snapshot when called with -r -s, or ieclib.txt.snapshot if none is used),
+ * so a separate snapshot is needed for each combination of these options. A snapshot is silently ignored (and the library parsed normally)
+ * whenever it was created by a different version of the compiler, or any of the
+ * library source files has changed since the snapshot was created.
+ *
+ * NOTE: The function_symtable, function_block_type_symtable, etc. are not stored, as these
+ *       are filled in from the AST by absyntax_utils_init(), which is run after stage1_2.
+ */
+
+
+#ifndef _LIBRARY_SNAPSHOT_HH
+#define _LIBRARY_SNAPSHOT_HH
+
+#include <stdio.h>
+#include "../absyntax/absyntax.hh"
+
+/* defined in stage1_2_priv.hh */
+typedef struct parse_context_s parse_context_t;
+
+
+/* Load the library from the snapshot corresponding to libfilename (and the options of the parse).
+ * The library elements are appended to context->tree_root (a new library_c is created if it is NULL),
+ * and its entries added to context->library_element_symtable.
+ *
+ * Returns 0 on success, or < 0 if no valid snapshot is available (in which case nothing is changed).
+ */
+int load_library_snapshot(parse_context_t *context, const char *libfilename);
+
+/* Save a snapshot of the library, whose elements are currently stored in context->tree_root (may be NULL if the library is empty).
+ * Returns 0 on success, or < 0 on error (an error message will have been printed to stderr).
+ */
+int save_library_snapshot(parse_context_t *context, const char *libfilename);
+
+/* The same as above, but reading/writing the snapshot from/to an already open stream (read from its current position).
+ * Used to keep the library in memory (in a temporary file) when compiling several files in a single run.
+ */
+int load_library_snapshot(parse_context_t *context, const char *libfilename, FILE *in);
+int save_library_snapshot(parse_context_t *context, const char *libfilename, FILE *out);
+
+
+#endif /* _LIBRARY_SNAPSHOT_HH */
@@ -0,0 +1,547 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+/*
+ * Pre-scanning of the source code, to support forward references (-p command line option).
+ *
+ * The datatype declarations must be classified exactly as the parser would classify them
+ * (simple, subrange, enumerated, array, structure, string or reference datatype), as the
+ * parser will later expect a token of that category whenever the datatype name is used.
+ * Following the syntax in iec_bison.yy, the category is decided by what follows the ':'
+ *    '('                  --> enumerated
+ *    ARRAY                --> array
+ *    STRUCT               --> structure
+ *    REF_TO               --> reference
+ *    <name> '('           --> subrange   (e.g. INT (1..10))
+ *    <name> '['           --> string     (e.g. STRING [10])
+ *    <name>               --> same category as the datatype <name>, or a simple datatype
+ *                             if <name> is not a derived datatype (e.g. INT, TIME, STRING, ...)
+ * Since <name> may itself only be declared later on, these last declarations are only
+ * classified once the whole source code has been scanned.
+ *
+ * Lazy parsing of the included files (-L command line option): every identifier found in the
+ * source code is taken to be a (possible) reference to the POU with that name. The FUNCTIONs and
+ * FUNCTION_BLOCKs declared in the files {#include}d by the input file are only needed when such a
+ * reference to them is found in the code of the input file itself, in the datatype declarations,
+ * or in another POU of the included files that is itself needed. This over-estimates the POUs used
+ * (e.g. a variable named as a FB), but never misses one (except when only called from a pragma,
+ * i.e. from embedded C code).
+ */
+
+
+#include <stdio.h>
+#include <ctype.h>
+#include <string.h>
+#include <strings.h>
+#include <string>
+#include <vector>
+#include <set>
+#include <map>
+
+#include "../absyntax/absyntax.hh"
+#include "../absyntax/intern_pool.hh"
+#include "../main.hh"
+#include "stage1_2.hh"
+#include "iec_bison.hh"
+#include "stage1_2_priv.hh"
+#include "prescan.hh"
+
+
+#define MAX_INCLUDE_DEPTH 16  /* same limit as used by flex */
+
+extern const char *INCLUDE_DIRECTORIES[];
+
+/* defined in iec_bison.yy */
+typedef struct parse_context_s parse_context_t;
+void print_err_msg(parse_context_t *context,
+                   int first_line, int first_column, const char *first_filename, long int first_order,
+                   int last_line,  int last_column,  const char *last_filename,  long int last_order,
+                   const char *additional_error_msg);
+
+
+
+typedef enum {tk_eof, tk_identifier, tk_assign, tk_char} prescan_token_kind_t;
+
+typedef struct {
+    prescan_token_kind_t kind;
+    const char *text;     /* tk_identifier: first char of the identifier (not NUL terminated!) */
+    size_t      len;      /* tk_identifier: length  of the identifier                          */
+    char        c;        /* tk_char:       the char itself                                    */
+    int         line;
+    const char *filename;
+  } prescan_token_t;
+
+
+/* the POUs of the included files that are not needed by the input file (-L), upper case */
+static std::set<std::string> unused_lazy_pous;
+
+static std::string upper_case(const char *text, size_t len) {
+  std::string res(text, len);
+  for (unsigned int i = 0; i < res.size(); i++) res[i] = toupper((unsigned char)res[i]);
+  return res;
+}
+
+
+class prescan_c {
+  public:
+    prescan_c(parse_context_t *context_, bool forward_references_, bool lazy_pous_)
+      {context = context_; errors = 0; have_peeked = false; forward_references = forward_references_; lazy_pous = lazy_pous_; refs = &needed; extents = NULL; outline_end = 0;}
+   ~prescan_c(void) {for (unsigned int i = 0; i < files.size(); i++) delete files[i];}
+
+    int  errors;
+    bool push_file(const char *filename, const char *full_name);
+    void scan(void);
+    void find_unused_lazy_pous(void);
+    /* only find the extents of the POUs of the file, and its outline (see prescan_outline()) */
+    void find_outline(std::vector<prescan_pou_extent_t> *extents_) {extents = extents_;}
+    void get_outline(std::string &text, std::string &outline);
+
+  private:
+    typedef struct {
+        std::string text;
+        size_t      pos;
+        int         line;
+        const char *filename;
+      } source_t;
+    typedef struct {
+        prescan_token_t name;
+        const char     *target;  /* interned */
+      } alias_t;
+
+    /* NOTE: the files are only deleted by the destructor, as the tokens point to their text */
+    std::vector<source_t *> files;    /* all the files read so far */
+    std::vector<source_t *> sources;  /* the stack of files currently being scanned (innermost at the back) */
+    std::vector<alias_t>  aliases;  /* datatype declarations of the form 'name : other_name' */
+    parse_context_t      *context;  /* of the parse that follows (its options, and its library_element_symtable) */
+    prescan_token_t       peeked;
+    bool                  have_peeked;
+    bool                  forward_references;  /* -p: declare the names found */
+    bool                  lazy_pous;           /* -L: find the POUs of the included files that are not needed */
+    /* the identifiers found in the code that is always parsed (i.e. the POUs that are needed), and in each
+     * FUNCTION and FUNCTION_BLOCK of the included files (the POUs they need, if they are themselves needed)
+     */
+    std::set<std::string>                          needed;
+    std::map<std::string, std::set<std::string> >  lazy_refs;
+    std::set<std::string>                         *refs;  /* where the identifiers currently found go (lazy_pous only) */
+    std::vector<prescan_pou_extent_t>             *extents;   /* the POUs of the file, NULL when not finding its outline */
+    std::string                                    outline;   /* the outline of the file, up to the last POU found */
+    size_t                                         outline_end; /* the end of the last POU found */
+    std::string                                    included;  /* the text of the included files */
+
+    prescan_token_t next_token(bool follow_includes);
+    void            unget_token(prescan_token_t token) {peeked = token; have_peeked = true;}
+    bool            skip_comment(source_t &src);
+    bool            skip_pragma(source_t &src, bool follow_includes);
+
+    bool is_keyword(const prescan_token_t &token, const char *keyword);
+    bool is_char   (const prescan_token_t &token, char c) {return (tk_char == token.kind) && (c == token.c);}
+    prescan_token_t skip_until(const char *end_keyword);
+    void skip_type_declaration(int depth);
+    void scan_type_declarations(void);
+    void declare(const prescan_token_t &name, int token);
+    void add_extent(const prescan_token_t &keyword, const prescan_token_t &name, const prescan_token_t &end);
+    void error(const prescan_token_t &token, const char *msg);
+};
+
+
+
+/**********************************/
+/* The (very) simplified lexer... */
+/**********************************/
+
+bool prescan_c::push_file(const char *filename, const char *full_name) {
+  FILE *in = fopen(full_name, "rb");
+  if (NULL == in) return false;
+
+  source_t *src = new source_t;
+  char buf[16*1024];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), in)) > 0) src->text.append(buf, n);
+  fclose(in);
+  src->pos      = 0;
+  src->line     = 1;
+  src->filename = intern_string(filename);
+  if ((NULL != extents) && !files.empty()) included += src->text;
+  files.push_back(src);
+  sources.push_back(src);
+  return true;
+}
+
+
+/* Skip a (* comment *), which may be nested if the -n command line option was given.
+ * Returns false if the comment is not terminated.
+ */
+bool prescan_c::skip_comment(source_t &src) {
+  int depth = 0;
+  const std::string &t = src.text;
+  while (src.pos < t.size()) {
+    if        ((t[src.pos] == '(') && (src.pos + 1 < t.size()) && (t[src.pos + 1] == '*')) {
+      src.pos += 2;
+      if ((depth == 0) || context->options.nested_comments) depth++;
+    } else if ((t[src.pos] == '*') && (src.pos + 1 < t.size()) && (t[src.pos + 1] == ')')) {
+      src.pos += 2;
+      if (--depth == 0) return true;
+    } else {
+      if (t[src.pos] == '\n') src.line++;
+      src.pos++;
+    }
+  }
+  return false;
+}
+
+
+/* Skip a {pragma} or {{pragma}}. If it is an {#include "<filename>"} directive, and follow_includes is set,
+ * the included file is pushed onto the sources stack.
+ * Returns false if the pragma is not terminated.
+ */
+bool prescan_c::skip_pragma(source_t &src, bool follow_includes) {
+  const std::string &t = src.text;
+  size_t start = src.pos;
+  bool   double_brace = (start + 1 < t.size()) && (t[start + 1] == '{');
+  size_t end = double_brace? t.find("}}", start + 2) : t.find('}', start + 1);
+  if (std::string::npos == end) return false;
+  for (size_t i = start; i < end; i++) if (t[i] == '\n') src.line++;
+  src.pos = end + (double_brace? 2 : 1);
+
+  /* {#include "<filename>"} */
+  if (double_brace || !follow_includes)       return true;
+  if (t.compare(start, 9, "{#include") != 0)  return true;
+  size_t first = t.find('"', start + 9);
+  size_t last  = (first < end)? t.find('"', first + 1) : std::string::npos;
+  if ((std::string::npos == last) || (last > end)) return true; /* the parser will complain about this later */
+  if (sources.size() >= MAX_INCLUDE_DEPTH)          return true; /* the parser will complain about this later */
+
+  std::string include_name = t.substr(first + 1, last - first - 1);
+  for (int i = 0; INCLUDE_DIRECTORIES[i] != NULL; i++) {
+    std::string full_name = std::string(INCLUDE_DIRECTORIES[i]) + "/" + include_name;
+    if (push_file(include_name.c_str(), full_name.c_str())) return true;
+  }
+  return true; /* the parser will complain about the missing file later */
+}
+
+
+prescan_token_t prescan_c::next_token(bool follow_includes) {
+  prescan_token_t token;
+
+  if (have_peeked) {have_peeked = false; return peeked;}
+
+  while (!sources.empty()) {
+    source_t &src = *sources.back();
+    const std::string &t = src.text;
+
+    if (src.pos >= t.size()) {sources.pop_back(); continue;}
+
+    char c = t[src.pos];
+    token.line     = src.line;
+    token.filename = src.filename;
+
+    /* whitespace */
+    if (c == '\n')                 {src.line++; src.pos++; continue;}
+    if (isspace((unsigned char)c)) {src.pos++; continue;}
+
+    /* comments and pragmas */
+    if ((c == '(') && (src.pos + 1 < t.size()) && (t[src.pos + 1] == '*')) {
+      if (!skip_comment(src)) src.pos = t.size();
+      continue;
+    }
+    if (c == '{') {
+      if (!skip_pragma(src, follow_includes)) src.pos = t.size();
+      continue;
+    }
+
+    /* strings (the '$' escapes the next char) */
+    if ((c == '\'') || (c == '"')) {
+      for (src.pos++; (src.pos < t.size()) && (t[src.pos] != c); src.pos++) {
+        if (t[src.pos] == '$')  src.pos++;
+        else if (t[src.pos] == '\n') src.line++;
+      }
+      src.pos++;
+      continue;
+    }
+
+    /* identifiers, keywords, and numbers (returned as identifiers, but these are never used) */
+    if (isalnum((unsigned char)c) || (c == '_')) {
+      size_t start = src.pos;
+      while ((src.pos < t.size()) && (isalnum((unsigned char)t[src.pos]) || (t[src.pos] == '_'))) src.pos++;
+      token.kind = tk_identifier;
+      token.text = t.data() + start;
+      token.len  = src.pos - start;
+      if (lazy_pous && (NULL != refs)) refs->insert(upper_case(token.text, token.len));
+      return token;
+    }
+
+    if ((c == ':') && (src.pos + 1 < t.size()) && (t[src.pos + 1] == '=')) {
+      src.pos += 2;
+      token.kind = tk_assign;
+      return token;
+    }
+
+    src.pos++;
+    token.kind = tk_char;
+    token.c    = c;
+    return token;
+  }
+
+  token.kind     = tk_eof;
+  token.line     = 0;
+  token.filename = NULL;
+  return token;
+}
+
+
+
+/****************************************/
+/* The (very) simplified syntax parser. */
+/****************************************/
+
+bool prescan_c::is_keyword(const prescan_token_t &token, const char *keyword) {
+  return (tk_identifier == token.kind) && (strlen(keyword) == token.len) && (strncasecmp(token.text, keyword, token.len) == 0);
+}
+
+
+void prescan_c::error(const prescan_token_t &token, const char *msg) {
+  print_err_msg(context, token.line, 0, token.filename, 0, token.line, 0, token.filename, 0, msg);
+  errors++;
+}
+
+
+/* skip all tokens, up to and including the end_keyword (which is returned, or tk_eof if not found) */
+prescan_token_t prescan_c::skip_until(const char *end_keyword) {
+  prescan_token_t token;
+  do {token = next_token(false);} while ((tk_eof != token.kind) && !is_keyword(token, end_keyword));
+  return token;
+}
+
+
+/* skip the remainder of a datatype declaration, up to and including the ';' that terminates it.
+ * depth is the number of '(', '[' and STRUCT already consumed that have not yet been closed.
+ */
+void prescan_c::skip_type_declaration(int depth) {
+  for (prescan_token_t token = next_token(true); tk_eof != token.kind; token = next_token(true)) {
+    if      (is_char(token, '(') || is_char(token, '[') || is_keyword(token, "STRUCT"))     depth++;
+    else if (is_char(token, ')') || is_char(token, ']') || is_keyword(token, "END_STRUCT")) depth--;
+    else if (is_char(token, ';') && (depth <= 0)) return;
+    else if (is_keyword(token, "END_TYPE")) {unget_token(token); return;} /* missing ';', let the parser complain */
+  }
+}
+
+
+/* the datatype declarations between TYPE and END_TYPE */
+void prescan_c::scan_type_declarations(void) {
+  for (prescan_token_t name = next_token(true); tk_eof != name.kind; name = next_token(true)) {
+    if (is_keyword(name, "END_TYPE")) return;
+    if (tk_identifier != name.kind) {if (!is_char(name, ';')) skip_type_declaration(0); continue;}
+
+    prescan_token_t token = next_token(true);
+    if (!is_char(token, ':')) {unget_token(token); skip_type_declaration(0); continue;}
+
+    token = next_token(true);
+    if      (is_char   (token, '('))      {declare(name, prev_declared_enumerated_type_name_token); skip_type_declaration(1);}
+    else if (is_keyword(token, "ARRAY"))  {declare(name, prev_declared_array_type_name_token);      skip_type_declaration(0);}
+    else if (is_keyword(token, "STRUCT")) {declare(name, prev_declared_structure_type_name_token);  skip_type_declaration(1);}
+    else if (is_keyword(token, "REF_TO")) {declare(name, prev_declared_ref_type_name_token);        skip_type_declaration(0);}
+    else if (tk_identifier == token.kind) {
+      prescan_token_t target = token;
+      token = next_token(true);
+      if      (is_char(token, '('))       {declare(name, prev_declared_subrange_type_name_token);   skip_type_declaration(1);}
+      else if (is_char(token, '['))       {declare(name, prev_declared_string_type_name_token);     skip_type_declaration(1);}
+      else {
+        alias_t alias = {name, intern_string(target.text, target.len)};
+        aliases.push_back(alias);
+        unget_token(token);
+        skip_type_declaration(0);
+      }
+    }
+    else {unget_token(token); skip_type_declaration(0);}
+  }
+}
+
+
+void prescan_c::declare(const prescan_token_t &name, int token) {
+  if (isdigit((unsigned char)name.text[0])) return; /* a number, not an identifier! The parser will complain about this later. */
+  const char *name_str = intern_string(name.text, name.len);
+  library_element_symtable_t::iterator iter = context->library_element_symtable.find(name_str);
+
+  if (context->library_element_symtable.end() != iter) {
+    if (iter->second != token)
+      error(name, "Invalid identifier. Name already used by another datatype or POU.");
+    /* same check as done by the parser in derived_function_name (we never allow overloading in the user's source code) */
+    else if (prev_declared_derived_function_name_token == token)
+      error(name, "Function overloading not allowed. Invalid identifier.");
+    return;
+  }
+  context->library_element_symtable.insert(name_str, token);
+
+  /* declare the conversion functions that the parser will generate for enumerated datatypes
+   * (see create_enumtype_conversion_functions.cc)
+   */
+  if ((prev_declared_enumerated_type_name_token == token) && context->options.conversion_functions) {
+    static const char *types[] = {"STRING", "SINT", "INT", "DINT", "LINT", "USINT", "UINT", "UDINT", "ULINT", NULL};
+    std::string enum_name = name_str;
+    for (int i = 0; types[i] != NULL; i++) {
+      context->library_element_symtable.insert(intern_string((std::string(types[i]) + "_TO_" + enum_name).c_str()), prev_declared_derived_function_name_token);
+      context->library_element_symtable.insert(intern_string((enum_name + "_TO_" + types[i]).c_str()),             prev_declared_derived_function_name_token);
+    }
+  }
+}
+
+
+void prescan_c::scan(void) {
+  for (prescan_token_t token = next_token(true); tk_eof != token.kind; token = next_token(true)) {
+    const char *end_keyword = NULL;
+    int         category    = 0;
+    if      (is_keyword(token, "FUNCTION"))       {end_keyword = "END_FUNCTION";       category = prev_declared_derived_function_name_token;}
+    else if (is_keyword(token, "FUNCTION_BLOCK")) {end_keyword = "END_FUNCTION_BLOCK"; category = prev_declared_derived_function_block_name_token;}
+    else if (is_keyword(token, "PROGRAM"))        {end_keyword = "END_PROGRAM";        category = prev_declared_program_type_name_token;}
+    else if (is_keyword(token, "CONFIGURATION"))  {end_keyword = "END_CONFIGURATION";  category = prev_declared_configuration_name_token;}
+    else if (is_keyword(token, "TYPE"))           {scan_type_declarations(); continue;}
+    else continue;
+
+    /* NOTE: the POU body is skipped with follow_includes = false, just like flex only handles
+     *       (*#include ...*) directives outside of the POUs.
+     */
+    refs = NULL;  /* the name of the POU is not a reference to it */
+    prescan_token_t name = next_token(false);
+    refs = &needed;
+    if ((NULL != extents) && (sources.size() == 1) && (tk_identifier == name.kind) && (prev_declared_configuration_name_token != category)) {
+      add_extent(token, name, skip_until(end_keyword));
+      continue;
+    }
+    if ((tk_identifier == name.kind) && forward_references) declare(name, category);
+    if (!lazy_pous || (tk_identifier != name.kind)) {skip_until(end_keyword); continue;}
+
+    /* NOTE: a POU declared twice is always needed, so the parser sees both declarations, and complains about it. */
+    std::string pou_name = upper_case(name.text, name.len);
+    bool lazy = (sources.size() > 1) && (prev_declared_program_type_name_token != category)
+                                     && (prev_declared_configuration_name_token != category);
+    if   (lazy && (lazy_refs.find(pou_name) == lazy_refs.end())) refs = &lazy_refs[pou_name];
+    else needed.insert(pou_name);
+    skip_until(end_keyword);
+    refs = &needed;
+  }
+
+  /* Now classify the 'name : other_name' datatype declarations. Several passes may be needed,
+   * as other_name may itself be declared as an alias of a datatype declared later on.
+   */
+  for (bool progress = true; progress; ) {
+    progress = false;
+    for (unsigned int i = 0; i < aliases.size(); i++) {
+      library_element_symtable_t::iterator iter = context->library_element_symtable.find(aliases[i].target);
+      if (context->library_element_symtable.end() == iter) continue;
+      int category = iter->second;
+      if (   (prev_declared_subrange_type_name_token   != category) && (prev_declared_enumerated_type_name_token != category)
+          && (prev_declared_array_type_name_token      != category) && (prev_declared_structure_type_name_token  != category)
+          && (prev_declared_string_type_name_token     != category) && (prev_declared_ref_type_name_token        != category))
+        category = prev_declared_simple_type_name_token;
+      declare(aliases[i].name, category);
+      aliases.erase(aliases.begin() + i--);
+      progress = true;
+    }
+  }
+  /* the remaining ones are aliases of elementary datatypes (or of undeclared names, which the parser will complain about) */
+  for (unsigned int i = 0; i < aliases.size(); i++)
+    declare(aliases[i].name, prev_declared_simple_type_name_token);
+}
+
+
+
+
+/* A FUNCTION, FUNCTION_BLOCK or PROGRAM of the input file, from its keyword up to its end keyword */
+void prescan_c::add_extent(const prescan_token_t &keyword, const prescan_token_t &name, const prescan_token_t &end) {
+  if (tk_eof == end.kind) return;  /* the parser will complain about it */
+  const std::string &t = files[0]->text;
+  prescan_pou_extent_t extent;
+  extent.name   = upper_case(name.text, name.len);
+  extent.begin  = keyword.text - t.data();
+  extent.end    = end.text + end.len - t.data();
+  extent.line   = keyword.line;
+  size_t line_start = t.rfind('\n', extent.begin);
+  extent.column = extent.begin - ((std::string::npos == line_start)? 0 : line_start + 1) + 1;
+  extents->push_back(extent);
+
+  /* the outline has the kind and name of the POU instead of its source code */
+  outline.append(t, outline_end, extent.begin - outline_end);
+  outline += upper_case(keyword.text, keyword.len) + " " + extent.name;
+  outline_end = extent.end;
+}
+
+
+void prescan_c::get_outline(std::string &text, std::string &outline_) {
+  text = files[0]->text;
+  outline_  = outline;
+  outline_.append(text, outline_end, std::string::npos);
+  outline_ += included;
+}
+
+
+/* the POUs of the included files not reachable from the needed ones (i.e., from the POUs they reference) */
+void prescan_c::find_unused_lazy_pous(void) {
+  std::vector<std::string> todo(needed.begin(), needed.end());
+  while (!todo.empty()) {
+    std::map<std::string, std::set<std::string> >::iterator pou = lazy_refs.find(todo.back());
+    todo.pop_back();
+    if (lazy_refs.end() == pou) continue;
+    for (std::set<std::string>::iterator ref = pou->second.begin(); ref != pou->second.end(); ref++)
+      if (needed.insert(*ref).second) todo.push_back(*ref);
+  }
+  for (std::map<std::string, std::set<std::string> >::iterator pou = lazy_refs.begin(); pou != lazy_refs.end(); pou++)
+    if (needed.find(pou->first) == needed.end()) unused_lazy_pous.insert(pou->first);
+}
+
+
+int prescan_file(parse_context_t *context, const char *filename, bool forward_references, bool lazy_pous) {
+  prescan_c prescan(context, forward_references, lazy_pous);
+  unused_lazy_pous.clear();
+  if (!prescan.push_file(filename, filename)) return -1;
+  prescan.scan();
+  if (lazy_pous) prescan.find_unused_lazy_pous();
+  return prescan.errors;
+}
+
+
+void forget_unused_lazy_pous(void) {unused_lazy_pous.clear();}
+
+
+int prescan_outline(parse_context_t *context, const char *filename, std::string &text, std::string &outline, std::vector<prescan_pou_extent_t> &extents) {
+  prescan_c prescan(context, false, false);
+  extents.clear();
+  prescan.find_outline(&extents);
+  if (!prescan.push_file(filename, filename)) return -1;
+  prescan.scan();
+  prescan.get_outline(text, outline);
+  return 0;
+}
+
+bool lazy_pou_unused(const char *pou_name) {
+  if (unused_lazy_pous.empty()) return false;
+  return unused_lazy_pous.find(upper_case(pou_name, strlen(pou_name))) != unused_lazy_pous.end();
+}
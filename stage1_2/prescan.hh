@@ -0,0 +1,103 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+/*
+ * Pre-scanning of the source code, to support forward references (-p command line option).
+ *
+ * Before the input file is parsed, it is quickly scanned for the headers of all the
+ * POUs (FUNCTION, FUNCTION_BLOCK, PROGRAM, CONFIGURATION) and the datatypes declared
+ * inside TYPE ... END_TYPE, and their names are added to the library_element_symtable.
+ * The parser will then accept references to POUs and datatypes that are only declared
+ * later on in the source code.
+ *
+ * The pre-scanner only understands the little syntax it needs to find these names
+ * (comments, pragmas, strings, (*#include ...*) directives, and the structure of the
+ * datatype declarations). It does not build any AST, and the source code is only checked
+ * for errors by the parser that runs next.
+ *
+ * Lazy parsing of the included files (-L command line option): the pre-scanner also finds
+ * the FUNCTIONs and FUNCTION_BLOCKs of the {#include}d files (e.g. vendor libraries) that
+ * are not referenced, directly or through other POUs, by the input file. flex then skips
+ * these POUs (in its ignore_pou_state), so their variable declarations and bodies are neither
+ * parsed, nor checked by stage 3, nor compiled by stage 4. The POUs that are referenced are
+ * parsed as usual. The standard library is always parsed completely (it is usually loaded
+ * from a snapshot anyway, see library_snapshot.hh).
+ */
+
+
+#ifndef _PRESCAN_HH
+#define _PRESCAN_HH
+
+#include <string>
+#include <vector>
+
+/* defined in stage1_2_priv.hh */
+typedef struct parse_context_s parse_context_t;
+
+
+/* Pre-scan the file (and all the files it includes), adding the names of the
+ * declared POUs and datatypes to the library_element_symtable of the parse (if forward_references),
+ * and finding the POUs of the included files that are not used (if lazy_pous).
+ * Must be called after the standard library has been parsed (or loaded).
+ *
+ * Returns the number of errors found (an error message will have been printed to stderr for each),
+ * or < 0 if the file could not be read (nothing is printed, the parser will report it).
+ */
+int prescan_file(parse_context_t *context, const char *filename, bool forward_references, bool lazy_pous);
+
+/* Whether the FUNCTION or FUNCTION_BLOCK, declared in an included file, was found not to be used by
+ * the last pre-scanned file (always false if it was not pre-scanned with lazy_pous).
+ */
+bool lazy_pou_unused(const char *pou_name);
+
+/* Forget the unused POUs found by the last call to prescan_file() (e.g. before parsing the standard library). */
+void forget_unused_lazy_pous(void);
+
+
+/* A FUNCTION, FUNCTION_BLOCK or PROGRAM declared in the file itself (not in a file it includes) */
+typedef struct {
+    std::string name;         /* upper case */
+    size_t      begin, end;   /* the bytes of the file, from the POU keyword up to and including its END_ keyword */
+    int         line, column; /* of the POU keyword */
+  } prescan_pou_extent_t;
+
+/* Pre-scan the file only to find the extents of its POUs (see incremental_parse.hh), and its outline: the source
+ * code of the file, with the kind and name of each of these POUs instead of its source code, followed by the source
+ * code of all the files it includes. The source code of the file itself is returned in text.
+ * Nothing is added to the library_element_symtable.
+ *
+ * Returns < 0 if the file could not be read.
+ */
+int prescan_outline(parse_context_t *context, const char *filename, std::string &text, std::string &outline, std::vector<prescan_pou_extent_t> &extents);
+
+
+#endif /* _PRESCAN_HH */
@@ -60,132 +60,107 @@
 /* Part 1: Concepts and Function Blocks,              */
 /* Version 1.0 – Official Release                   */
 /******************************************************/
-bool get_opt_safe_extensions() {return runtime_options.safe_extensions;}
+bool get_opt_safe_extensions(parse_context_t *context) {return context->options.safe_extensions;}
 
 /************************************/
 /* whether to allow nested comments */
 /************************************/
-bool get_opt_nested_comments() {return runtime_options.nested_comments;}
+bool get_opt_nested_comments(parse_context_t *context) {return context->options.nested_comments;}
 
 /**************************************************************************/
 /* whether to allow REF(), DREF(), REF_TO, NULL and ^ operators/keywords  */
 /**************************************************************************/
-bool get_opt_ref_standard_extensions() {return runtime_options.ref_standard_extensions;}
-
-
-/**********************************************************************************************/
-/* whether bison is doing the pre-parsing, where POU bodies and var declarations are ignored! */
-/**********************************************************************************************/
-static bool preparse_state__ = false;
-
-void set_preparse_state(void) {preparse_state__ = true; }
-void rst_preparse_state(void) {preparse_state__ = false;}
-bool get_preparse_state(void) {return preparse_state__;}     // returns true if bison is in preparse state
+bool get_opt_ref_standard_extensions(parse_context_t *context) {return context->options.ref_standard_extensions;}
 
 
 /****************************************************/
 /* Controlling the entry to the body_state in flex. */
 /****************************************************/
-static int goto_body_state__ = 0;
-
-void cmd_goto_body_state(void) {goto_body_state__ = 1;}
-int  get_goto_body_state(void) {return goto_body_state__;}
-void rst_goto_body_state(void) {goto_body_state__ = 0;}
+void cmd_goto_body_state(parse_context_t *context) {context->parse_state.goto_body_state = 1;}
+int  get_goto_body_state(parse_context_t *context) {return context->parse_state.goto_body_state;}
+void rst_goto_body_state(parse_context_t *context) {context->parse_state.goto_body_state = 0;}
 
 /*************************************************************/
 /* Controlling the entry to the sfc_qualifier_state in flex. */
 /*************************************************************/
-static int goto_sfc_qualifier_state__ = 0;
-
-void cmd_goto_sfc_qualifier_state(void) {goto_sfc_qualifier_state__ = 1;}
-int  get_goto_sfc_qualifier_state(void) {return goto_sfc_qualifier_state__;}
-void rst_goto_sfc_qualifier_state(void) {goto_sfc_qualifier_state__ = 0;}
+void cmd_goto_sfc_qualifier_state(parse_context_t *context) {context->parse_state.goto_sfc_qualifier_state = 1;}
+int  get_goto_sfc_qualifier_state(parse_context_t *context) {return context->parse_state.goto_sfc_qualifier_state;}
+void rst_goto_sfc_qualifier_state(parse_context_t *context) {context->parse_state.goto_sfc_qualifier_state = 0;}
 
 /*************************************************************/
 /* Controlling the entry to the sfc_priority_state in flex.  */
 /*************************************************************/
-static int goto_sfc_priority_state__ = 0;
-
-void cmd_goto_sfc_priority_state(void) {goto_sfc_priority_state__ = 1;}
-int  get_goto_sfc_priority_state(void) {return goto_sfc_priority_state__;}
-void rst_goto_sfc_priority_state(void) {goto_sfc_priority_state__ = 0;}
+void cmd_goto_sfc_priority_state(parse_context_t *context) {context->parse_state.goto_sfc_priority_state = 1;}
+int  get_goto_sfc_priority_state(parse_context_t *context) {return context->parse_state.goto_sfc_priority_state;}
+void rst_goto_sfc_priority_state(parse_context_t *context) {context->parse_state.goto_sfc_priority_state = 0;}
 
 /*************************************************************/
 /* Controlling the entry to the sfc_qualifier_state in flex. */
 /*************************************************************/
-static int goto_task_init_state__ = 0;
-
-void cmd_goto_task_init_state(void) {goto_task_init_state__ = 1;}
-int  get_goto_task_init_state(void) {return goto_task_init_state__;}
-void rst_goto_task_init_state(void) {goto_task_init_state__ = 0;}
+void cmd_goto_task_init_state(parse_context_t *context) {context->parse_state.goto_task_init_state = 1;}
+int  get_goto_task_init_state(parse_context_t *context) {return context->parse_state.goto_task_init_state;}
+void rst_goto_task_init_state(parse_context_t *context) {context->parse_state.goto_task_init_state = 0;}
 
 /****************************************************************/
 /* Returning to state in flex previously pushed onto the stack. */
 /****************************************************************/
-static int pop_state__ = 0;
-
-void cmd_pop_state(void) {pop_state__ = 1;}
-int  get_pop_state(void) {return pop_state__;}
-void rst_pop_state(void) {pop_state__ = 0;}
+void cmd_pop_state(parse_context_t *context) {context->parse_state.pop_state = 1;}
+int  get_pop_state(parse_context_t *context) {return context->parse_state.pop_state;}
+void rst_pop_state(parse_context_t *context) {context->parse_state.pop_state = 0;}
 
 
 /*********************************/
-/* The global symbol tables...   */
+/* The symbol tables of a parse  */
 /*********************************/
 /* NOTE: only accessed indirectly by the lexical parser (flex)
  *       through the function get_identifier_token()
  */
-/* A symbol table to store all the library elements */
-/* e.g.: <function_name , function_decl>
- *       <fb_name , fb_decl>
- *       <type_name , type_decl>
- *       <program_name , program_decl>
- *       <configuration_name , configuration_decl>
- */
-/* static */ library_element_symtable_t library_element_symtable;
-
-/* A symbol table to store the declared variables of
- * the function currently being parsed...
- */
-/* static */ variable_name_symtable_t   variable_name_symtable;
-
-/* A symbol table to store the declared direct variables of
- * the function currently being parsed...
- */
-/* static */ direct_variable_symtable_t direct_variable_symtable;
+/* The token of the library element, or 0 if identifier_str is not a library element */
+int library_element_symtable_t::get_token(const char *identifier_str) {
+  /* Identifiers returned by flex are interned, so their (case folded) interned copy identifies them in the cache */
+  if (!is_interned(identifier_str)) {
+    iterator iter = find(identifier_str);
+    return (iter != end())? iter->second : 0;
+  }
+
+  const char          *folded = interned_folded(identifier_str);
+  token_cache_entry_t &entry  = token_cache[interned_hash(identifier_str) & (TOKEN_CACHE_SIZE - 1)];
+  if (entry.folded != folded) {
+    iterator iter = find(identifier_str);
+    entry.folded = folded;
+    entry.token  = (iter != end())? iter->second : 0;
+  }
+  return entry.token;
+}
 
 /* Function only called from within flex!
  *
- * search for a symbol in either of the two symbol tables
- * declared above, and return the token id of the first
- * symbol found.
+ * search for a symbol in either of the symbol tables of the
+ * parse, and return the token id of the first symbol found.
  * Searches first in the variables, and only if not found
  * does it continue searching in the library elements
  */
-int get_identifier_token(const char *identifier_str) {
+int get_identifier_token(parse_context_t *context, const char *identifier_str) {
 //  std::cout << "get_identifier_token(" << identifier_str << "): \n";
-  variable_name_symtable_t  ::iterator iter1;
-  library_element_symtable_t::iterator iter2;
-
-  if ((iter1 = variable_name_symtable.find(identifier_str)) != variable_name_symtable.end())
-    return iter1->second;
-    
-  if ((iter2 = library_element_symtable.find(identifier_str)) != library_element_symtable.end())
-    return iter2->second;
-  
-  return identifier_token;
+  variable_name_symtable_t::iterator iter;
+
+  if ((iter = context->variable_name_symtable.find(identifier_str)) != context->variable_name_symtable.end())
+    return iter->second;
+
+  int token = context->library_element_symtable.get_token(identifier_str);
+  return (token != 0)? token : identifier_token;
 }
 
 /* Function only called from within flex!
  *
- * search for a symbol in direct variables symbol table
- * declared above, and return the token id of the first
+ * search for a symbol in the direct variables symbol table
+ * of the parse, and return the token id of the first
  * symbol found.
  */
-int get_direct_variable_token(const char *direct_variable_str) {
+int get_direct_variable_token(parse_context_t *context, const char *direct_variable_str) {
   direct_variable_symtable_t::iterator iter;
 
-  if ((iter = direct_variable_symtable.find(direct_variable_str)) != direct_variable_symtable.end())
+  if ((iter = context->direct_variable_symtable.find(direct_variable_str)) != context->direct_variable_symtable.end())
     return iter->second;
 
   return direct_variable_token;
@@ -230,22 +205,32 @@ char *strdup3(const char *a, const char *b, const char *c) {
 /***********************************************************************/
 /***********************************************************************/
 
-int stage2__(const char *filename, 
+int stage2__(parse_context_t *context,
+             const char *filename, 
              symbol_c **tree_root_ref
             );
 
 
 int stage1_2(const char *filename, symbol_c **tree_root_ref) {
+      /* Start off from a clean state, even if stage1_2() has already been called before (e.g. to compile another file).
+       * NOTE: the AST built by any previous call is left untouched.
+       * NOTE: the context is value initialised (i.e. with all its plain members set to 0), and
+       *       comes with its own (empty) symbol tables.
+       */
+      parse_context_t *context = new parse_context_t();
+      context->options = runtime_options;
+      init_lexer(context);
+
       /* NOTE: we only call stage2 (bison - syntax analysis) directly, as stage 2 will itself call stage1 (flex - lexical analysis)
        *       automatically as needed
        */
 
       /* NOTE: Since we do not call stage1__ (flex) directly, we cannot directly pass any parameters to that function either.
-       *       In this case, we use callback functions, i.e. stage1__ (i.e. flex) will call functions defined in this file
-       *       whenever it needs info/parameters coming from stage1_2().
-       *       These callback functions will get their data from local (to this file) global variables...
-       *       We now set those variables...
+       *       Bison passes the context on to flex, which gets its info/parameters coming from stage1_2() from there.
        */
-  return stage2__(filename, tree_root_ref);
+  int res = stage2__(context, filename, tree_root_ref);
+  destroy_lexer(context);
+  delete context;
+  return res;
 }
 
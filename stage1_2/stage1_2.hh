@@ -47,6 +47,22 @@
 
 int stage1_2(const char *filename, symbol_c **tree_root);
 
+/* Keep a copy of the standard library in memory, so that any following calls to stage1_2() (e.g. to compile
+ * several files in a single run) load that copy instead of parsing the library again.
+ * Each call to stage1_2() still gets its own (new) library AST, as stage3 and stage4 annotate the AST they work on.
+ */
+void stage1_2_cache_library(bool enable);
+
+/* Keep (a copy of the AST of) the POUs of each parsed input file, so that the following calls to stage1_2() for the
+ * same file only lex and parse again the POUs that changed in the meantime (see incremental_parse.hh).
+ */
+void stage1_2_incremental_parse(bool enable);
+
+/* The number of elements at the start of the library_c returned by the last call to stage1_2() that were declared
+ * in the standard library (the elements declared in the input file all follow these).
+ */
+int stage1_2_library_elements(void);
+
 
 
 
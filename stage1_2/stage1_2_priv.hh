@@ -57,8 +57,9 @@
  * This file includes the interface through which the lexical parser (stage 1 - flex)
  * and the syntax analyser (stage 2 - bison) interact between themselves.
  *
- * This is mostly through direct access to shared global variables, however some
- * of the global variables will only be accessed through some accessor functions.
+ * Both flex and bison are reentrant. All the state of a parse is kept in a parse_context_t,
+ * that stage1_2() passes to yyparse(), which in turn passes it to yylex(). Some of it is
+ * only accessed through some accessor functions.
  *
  * This file also includes the interface between the main stage1_2() functions and 
  * the flex lexical parser.
@@ -70,6 +71,148 @@
 
 
 
+/*************************************************************/
+/*************************************************************/
+/****                                                    *****/
+/****  T h e    S t a t e    o f    a    P a r s e       *****/
+/****                                                    *****/
+/*************************************************************/
+/*************************************************************/
+
+/* The state shared by flex, bison, and stage1_2(), that is specific to each compilation
+ * (i.e. to each call to stage1_2()).
+ */
+typedef struct {
+    int  goto_body_state;           /* flex must enter the body_state          */
+    int  goto_sfc_qualifier_state;  /* flex must enter the sfc_qualifier_state */
+    int  goto_sfc_priority_state;   /* flex must enter the sfc_priority_state  */
+    int  goto_task_init_state;      /* flex must enter the task_init_state     */
+    int  pop_state;                 /* flex must return to the state previously pushed onto the stack */
+  } parse_state_t;
+
+/* The position of flex in each of the files being parsed */
+typedef struct tracking_s {
+    int eof;
+    int lineNumber;
+    int currentChar;
+    int lineLength;
+    int currentTokenStart;
+    FILE *in_file;
+    struct mapped_file_s *mapped_file; /* NULL unless the file is being scanned in place (see map_input_file() in iec_flex.ll) */
+  } tracking_t;
+
+/* The files whose parsing was interrupted by an (*#include ...*), along with the flex buffer of each one */
+#define MAX_INCLUDE_DEPTH 16
+
+typedef struct {
+    struct yy_buffer_state *buffer_state;  /* i.e. a YY_BUFFER_STATE */
+    tracking_t *env;
+    const char *filename;
+  } include_stack_t;
+
+/*********************************/
+/* The symbol tables of a parse  */
+/*********************************/
+/* NOTE: only accessed indirectly by the lexical parser (flex)
+ *       through the function get_identifier_token()
+ *
+ *       Bison accesses these data structures directly.
+ *
+ *       In essence, they are a data passing mechanism between Bison and Flex.
+ */
+/* A symbol table to store all the library elements */
+/* e.g.: <function_name , function_decl>
+ *       <fb_name , fb_decl>
+ *       <type_name , type_decl>
+ *       <program_name , program_decl>
+ *       <configuration_name , configuration_decl>
+ */
+/* The token of the (interned) identifiers looked up by get_identifier_token() is kept in a small
+ * direct mapped cache, so that most identifiers are classified without searching this table.
+ * NOTE: library elements are never removed from this table (only by clear()).
+ */
+class library_element_symtable_t: public symtable_c<int> {
+  public:
+    library_element_symtable_t(void): token_cache(TOKEN_CACHE_SIZE) {clear_token_cache();}
+    void insert(const char *identifier_str, int token) {symtable_c<int>::insert(identifier_str, token); forget_token(identifier_str);}
+    void insert(const symbol_c *symbol,     int token) {
+      const token_c *name = dynamic_cast<const token_c *>(symbol);
+      if (name == NULL) ERROR;
+      insert(name->value, token);
+    }
+    void clear(void) {symtable_c<int>::clear(); clear_token_cache();}
+    /* The token of the library element, or 0 if identifier_str is not a library element */
+    int get_token(const char *identifier_str);
+
+  private:
+    enum {TOKEN_CACHE_SIZE = 4096};  /* must be a power of 2 */
+    typedef struct {
+        const char *folded;  /* interned_folded() of the identifier, or NULL if the entry is free */
+        int         token;   /* 0 if not a library element */
+      } token_cache_entry_t;
+    std::vector<token_cache_entry_t> token_cache;  /* indexed by interned_hash() of the identifiers */
+    void clear_token_cache(void) {for (unsigned int i = 0; i < token_cache.size(); i++) token_cache[i].folded = NULL;}
+    void forget_token     (const char *identifier_str) {token_cache[interned_hash(identifier_str) & (TOKEN_CACHE_SIZE - 1)].folded = NULL;}
+};
+
+/* A symbol table to store the declared variables of
+ * the function currently being parsed...
+ */
+typedef symtable_c<int>             variable_name_symtable_t;
+
+/* A symbol table to store the declared direct variables of
+ * the function currently being parsed...
+ */
+typedef symtable_c<int>             direct_variable_symtable_t;
+
+
+
+/* NOTE: bison declares parse_context_t (as struct parse_context_s) in iec_bison.hh, as it is the type of
+ *       the parameter of yyparse().
+ */
+struct parse_context_s {
+    /* flex's own state (a yyscan_t). Its extra data (yyextra) is this parse_context_t */
+    void *scanner;
+
+    /* set by bison, read by flex */
+    parse_state_t parse_state;
+
+    /* The command line options of the compilation (a copy of runtime_options, taken by stage1_2()) */
+    runtime_options_t options;
+
+    /* The parameters of the parse, set by stage2__() before calling yyparse()
+     * (see the comments at the end of iec_bison.yy).
+     */
+    bool allow_function_overloading;
+    bool allow_extensible_function_parameters;
+    bool allow_ref_dereferencing;
+    bool allow_ref_to_any;
+    bool allow_ref_to_in_derived_datatypes;
+
+    /* The results of the parse */
+    symbol_c   *tree_root;          /* the root of the parsing tree generated by bison                */
+    int         yynerrs;            /* the number of errors found                                      */
+    const char *current_error_msg;  /* the message of the last syntax error reported by bison to yyerror() */
+
+    /* The state of flex */
+    const char     *current_filename;  /* the file currently being parsed, updated on every (*#include ...*) */
+    long int        current_order;     /* the order by which each token is processed (see iec_flex.ll)       */
+    tracking_t     *current_tracking;
+    tracking_t      previous_tracking;
+    include_stack_t include_stack[MAX_INCLUDE_DEPTH];
+    int             include_stack_ptr;
+    char           *bodystate_buffer;         /* the text consumed by the body_state (see iec_flex.ll) */
+    bool            bodystate_is_whitespace;  /* TRUE (1) if buffer is empty, or only contains whitespace. */
+    tracking_t      bodystate_init_tracking;
+
+    /* The symbol tables, filled in by bison and read by flex (see above) */
+    library_element_symtable_t library_element_symtable;
+    variable_name_symtable_t   variable_name_symtable;
+    direct_variable_symtable_t direct_variable_symtable;
+  };
+
+
+
 /*************************************************************/
 /*************************************************************/
 /****                                                    *****/
@@ -86,17 +229,17 @@
 /* Part 1: Concepts and Function Blocks,              */
 /* Version 1.0 – Official Release                     */
 /******************************************************/
-bool get_opt_safe_extensions();
+bool get_opt_safe_extensions(parse_context_t *context);
 
 /************************************/
 /* whether to allow nested comments */
 /************************************/
-bool get_opt_nested_comments();
+bool get_opt_nested_comments(parse_context_t *context);
 
 /**************************************************************************/
 /* whether to allow REF(), DREF(), REF_TO, NULL and ^ operators/keywords  */
 /**************************************************************************/
-bool get_opt_ref_standard_extensions();
+bool get_opt_ref_standard_extensions(parse_context_t *context);
 
 
 
@@ -113,7 +256,7 @@ bool get_opt_ref_standard_extensions();
 /* print the include file stack to stderr... */
 /*********************************************/
 /* This is a service that flex provides to bison... */
-void print_include_stack(void);
+void print_include_stack(parse_context_t *context);
 
 /*****************************************************/
 /* Ask flex to include the source code in the string */
@@ -126,7 +269,26 @@ void print_include_stack(void);
  * between user defined (i.e. derived) enumerated datatypes, and some basic datatypes 
  * (e.g. INT, STRING, etc...)
  */
-void include_string(const char *source_code);
+void include_string(parse_context_t *context, const char *source_code);
+
+
+/**************************************/
+/* Create and destroy a flex scanner. */
+/**************************************/
+/* This is a service that flex provides to stage1_2()... */
+/* init_lexer() sets up the scanner of a new compilation in (the otherwise zeroed) context.
+ * destroy_lexer() releases all its state (input buffers, include file stack, ...), including the
+ * state left over by a parse that failed midway. Must not be called while parsing!
+ */
+void init_lexer(parse_context_t *context);
+void destroy_lexer(parse_context_t *context);
+
+
+/*****************************************/
+/* The token parser generated by flex... */
+/*****************************************/
+/* This is a service that flex provides to bison... */
+int yylex(YYSTYPE *yylval_param, YYLTYPE *yylloc_param, parse_context_t *context);
 
 
 /**********************************/
@@ -139,106 +301,69 @@ void include_string(const char *source_code);
  * Returns NULL on error opening the file (and a valid errno), or 0 on success.
  * Caller must close the file!
  */
-FILE *parse_file(const char *filename);
-
+FILE *parse_file(parse_context_t *context, const char *filename);
 
-/**********************************************************************************************/
-/* whether bison is doing the pre-parsing, where POU bodies and var declarations are ignored! */
-/**********************************************************************************************/
-void set_preparse_state(void);
-void rst_preparse_state(void);
-bool get_preparse_state();  // returns true if bison is in preparse state
 
 /****************************************************/
 /* Controlling the entry to the body_state in flex. */
 /****************************************************/
-void cmd_goto_body_state(void);
-int  get_goto_body_state(void);
-void rst_goto_body_state(void);
+void cmd_goto_body_state(parse_context_t *context);
+int  get_goto_body_state(parse_context_t *context);
+void rst_goto_body_state(parse_context_t *context);
 
 
 /*************************************************************/
 /* Controlling the entry to the sfc_qualifier_state in flex. */
 /*************************************************************/
-void cmd_goto_sfc_qualifier_state(void);
-int  get_goto_sfc_qualifier_state(void);
-void rst_goto_sfc_qualifier_state(void);
+void cmd_goto_sfc_qualifier_state(parse_context_t *context);
+int  get_goto_sfc_qualifier_state(parse_context_t *context);
+void rst_goto_sfc_qualifier_state(parse_context_t *context);
 
 
 /*************************************************************/
 /* Controlling the entry to the sfc_priority_state in flex.  */
 /*************************************************************/
-void cmd_goto_sfc_priority_state(void);
-int  get_goto_sfc_priority_state(void);
-void rst_goto_sfc_priority_state(void);
+void cmd_goto_sfc_priority_state(parse_context_t *context);
+int  get_goto_sfc_priority_state(parse_context_t *context);
+void rst_goto_sfc_priority_state(parse_context_t *context);
 
 
 /*********************************************************/
 /* Controlling the entry to the task_init_state in flex. */
 /*********************************************************/
-void cmd_goto_task_init_state(void);
-int  get_goto_task_init_state(void);
-void rst_goto_task_init_state(void);
+void cmd_goto_task_init_state(parse_context_t *context);
+int  get_goto_task_init_state(parse_context_t *context);
+void rst_goto_task_init_state(parse_context_t *context);
 
 
 /****************************************************************/
 /* Returning to state in flex previously pushed onto the stack. */
 /****************************************************************/
-void cmd_pop_state(void);
-int  get_pop_state(void);
-void rst_pop_state(void);
-
+void cmd_pop_state(parse_context_t *context);
+int  get_pop_state(parse_context_t *context);
+void rst_pop_state(parse_context_t *context);
 
 
-/*********************************/
-/* The global symbol tables...   */
-/*********************************/
-/* NOTE: only accessed indirectly by the lexical parser (flex)
- *       through the function get_identifier_token()
- *
- *       Bison accesses these data structures directly.
- *
- *       In essence, they are a data passing mechanism between Bison and Flex.
- */
-/* A symbol table to store all the library elements */
-/* e.g.: <function_name , function_decl>
- *       <fb_name , fb_decl>
- *       <type_name , type_decl>
- *       <program_name , program_decl>
- *       <configuration_name , configuration_decl>
- */
-typedef symtable_c<int>             library_element_symtable_t;
-extern  library_element_symtable_t  library_element_symtable;
 
-/* A symbol table to store the declared variables of
- * the function currently being parsed...
- */
-typedef symtable_c<int>             variable_name_symtable_t;
-extern  variable_name_symtable_t    variable_name_symtable;
 
-/* A symbol table to store the declared direct variables of
- * the function currently being parsed...
- */
-typedef symtable_c<int>             direct_variable_symtable_t;
-extern  direct_variable_symtable_t  direct_variable_symtable;
 
 /* Function only called from within flex!
  *
- * search for a symbol in either of the two symbol tables
- * declared above, and return the token id of the first
- * symbol found.
+ * search for a symbol in either of the symbol tables of the
+ * parse (the variables, and the library elements), and return
+ * the token id of the first symbol found.
  * Searches first in the variables, and only if not found
  * does it continue searching in the library elements
  */
-int get_identifier_token(const char *identifier_str);
+int get_identifier_token(parse_context_t *context, const char *identifier_str);
 
 /* Function only called from within flex!
  *
- * search for a symbol in direct variables symbol table
- * declared above, and return the token id of the first
+ * search for a symbol in the direct variables symbol table
+ * of the parse, and return the token id of the first
  * symbol found.
  */
-int get_direct_variable_token(const char *direct_variable_str);
+int get_direct_variable_token(parse_context_t *context, const char *direct_variable_str);
 
 
 /*************************************************************/
@@ -37,11 +37,17 @@
  *   - Check whether array subscript values fall within the allowed range.
  *     Note that for the checking of subscript values to work correctly, we need to have constant folding working too:
  *     array_var[8 + 99] can not be checked without constant folding.
+ *   - Determine the range of the values taken by the (integer) variables and by the sums and differences
+ *     of values with a known range (see get_value_range()). Inside a FOR loop that does
+ *     not change its control variable, the range of the control variable is also limited by the initial and
+ *     final values of the loop.
+ *     Stage 4 leaves out the __CHECK_<subrange>() of the values that are always inside the subrange.
  */
 
 
 #include "array_range_check.hh"
 #include <limits>  // required for std::numeric_limits<XXX>
+#include <algorithm>  // required for std::min() and std::max()
 
 
 #define FIRST_(symbol1, symbol2) (((symbol1)->first_order < (symbol2)->first_order)   ? (symbol1) : (symbol2))
@@ -50,7 +56,7 @@
 #define STAGE3_ERROR(error_level, symbol1, symbol2, ...) {                                                                  \
   if (current_display_error_level >= error_level) {                                                                         \
     fprintf(stderr, "%s:%d-%d..%d-%d: error: ",                                                                             \
-            FIRST_(symbol1,symbol2)->first_file, FIRST_(symbol1,symbol2)->first_line, FIRST_(symbol1,symbol2)->first_column,\
+            FIRST_(symbol1,symbol2)->first_file.c_str(), FIRST_(symbol1,symbol2)->first_line, FIRST_(symbol1,symbol2)->first_column,\
                                                  LAST_(symbol1,symbol2) ->last_line,  LAST_(symbol1,symbol2) ->last_column);\
     fprintf(stderr, __VA_ARGS__);                                                                                           \
     fprintf(stderr, "\n");                                                                                                  \
@@ -61,7 +67,7 @@
 
 #define STAGE3_WARNING(symbol1, symbol2, ...) {                                                                             \
     fprintf(stderr, "%s:%d-%d..%d-%d: warning: ",                                                                           \
-            FIRST_(symbol1,symbol2)->first_file, FIRST_(symbol1,symbol2)->first_line, FIRST_(symbol1,symbol2)->first_column,\
+            FIRST_(symbol1,symbol2)->first_file.c_str(), FIRST_(symbol1,symbol2)->first_line, FIRST_(symbol1,symbol2)->first_column,\
                                                  LAST_(symbol1,symbol2) ->last_line,  LAST_(symbol1,symbol2) ->last_column);\
     fprintf(stderr, __VA_ARGS__);                                                                                           \
     fprintf(stderr, "\n");                                                                                                  \
@@ -87,10 +93,26 @@ static inline int cmp_unsigned_signed(const uint64_t u, const int64_t s) {
   return -1;
 }
 
+annotation_table_c<array_range_check_c::value_range_t> array_range_check_c::value_ranges;
+
+
+bool array_range_check_c::get_value_range(symbol_c *expression, int64_t &lower, int64_t &upper) {
+	if (NULL == expression) return false;
+	if (get_datatype_info_c::get_int64_value(expression, lower)) {upper = lower; return true;}
+	value_range_t value_range = value_ranges.get(expression);
+	if (!value_range.valid) return false;
+	lower = value_range.lower;
+	upper = value_range.upper;
+	return true;
+}
+
+
 array_range_check_c::array_range_check_c(symbol_c *ignore) {
 	error_count = 0;
 	current_display_error_level = 0;
 	search_varfb_instance_type = NULL;
+	search_var_instance_decl = NULL;
+	current_scope = NULL;
 }
 
 
@@ -286,9 +308,79 @@ void *array_range_check_c::visit(array_initial_elements_c *symbol) {
 /*************************************/
 /* B 1.4.2 - Multi-element variables */
 /*************************************/
+/*  The range of the values of a variable is the range of its datatype, limited by the range of the FOR loops
+ *  using it as control variable.
+ *  Since the variables of a subrange datatype are always assigned a checked value, their values are known to be
+ *  inside the subrange, but only if they can not be written from outside the POU: not for the located variables
+ *  (nor the VAR_EXTERNAL, that may reference one), the VAR_IN_OUT, nor the inputs of a PROGRAM, which are
+ *  assigned without any check. The elements of the arrays and structures only get the range of the elementary datatypes.
+ */
+void array_range_check_c::set_variable_range(symbol_c *symbol, symbolic_variable_c *variable) {
+	int64_t lower, upper;
+	if (!get_datatype_info_c::get_int_range(symbol->datatype, lower, upper)) return;
+	if (get_datatype_info_c::is_subrange(symbol->datatype)) {
+		if ((NULL == variable) || (NULL == search_var_instance_decl)) return;
+		unsigned int vartype = search_var_instance_decl->get_vartype(variable);
+		bool is_local = (   (vartype == search_var_instance_decl_c::private_vt) || (vartype == search_var_instance_decl_c::temp_vt)
+		                 || (vartype == search_var_instance_decl_c::output_vt)
+		                 || ((vartype == search_var_instance_decl_c::input_vt) && (NULL == dynamic_cast<program_declaration_c *>(current_scope))));
+		if (!is_local) return;
+	}
+
+	if (NULL != variable)
+		for (int i = (int)for_ranges.size() - 1; i >= 0; i--)
+			if (0 == compare_identifiers(for_ranges[i].var_name, variable->var_name)) {
+				lower = std::max(lower, for_ranges[i].lower);
+				upper = std::min(upper, for_ranges[i].upper);
+				break;
+			}
+	if (lower <= upper)
+		value_ranges.set(symbol, value_range_t(lower, upper));
+}
+
+
+/*  The range of l_exp + r_exp (r_sign = 1) or l_exp - r_exp (r_sign = -1), when it fits in the datatype of the expression,
+ *  i.e. when the sum never overflows.
+ */
+void array_range_check_c::set_sum_range(symbol_c *symbol, symbol_c *l_exp, symbol_c *r_exp, int r_sign) {
+	int64_t l_lower, l_upper, r_lower, r_upper, type_lower, type_upper;
+	if (   !get_value_range(l_exp, l_lower, l_upper)
+	    || !get_value_range(r_exp, r_lower, r_upper)
+	    || !get_datatype_info_c::get_int_range(symbol->datatype, type_lower, type_upper))
+		return;
+	if (r_sign < 0) {
+		if (r_lower == INT64_MIN) return;
+		int64_t tmp = r_lower; r_lower = -r_upper; r_upper = -tmp;
+	}
+	/* do the sums in a way that never overflows */
+	if ((r_lower < 0) && (l_lower < INT64_MIN - r_lower)) return;
+	if ((r_upper > 0) && (l_upper > INT64_MAX - r_upper)) return;
+	int64_t lower = l_lower + r_lower;
+	int64_t upper = l_upper + r_upper;
+	if ((lower < type_lower) || (upper > type_upper)) return;
+	value_ranges.set(symbol, value_range_t(lower, upper));
+}
+
+
+// SYM_REF2(symbolic_variable_c, var_name, unused)
+void *array_range_check_c::visit(symbolic_variable_c *symbol) {
+	set_variable_range(symbol, symbol);
+	return NULL;
+}
+
+
 void *array_range_check_c::visit(array_variable_c *symbol) {
 	check_dimension_count(symbol);
 	check_bounds(symbol);
+	set_variable_range(symbol, NULL);
+	return NULL;
+}
+
+
+// SYM_REF2(structured_variable_c, record_variable, field_selector)
+void *array_range_check_c::visit(structured_variable_c *symbol) {
+	symbol->record_variable->accept(*this);
+	set_variable_range(symbol, NULL);
 	return NULL;
 }
 
@@ -303,12 +395,14 @@ void *array_range_check_c::visit(array_variable_c *symbol) {
 void *array_range_check_c::visit(function_declaration_c *symbol) {
 	symbol->var_declarations_list->accept(*this); // required for visiting subrange_c
 	search_varfb_instance_type = new search_varfb_instance_type_c(symbol);
-	// search_var_instance_decl = new search_var_instance_decl_c(symbol);
+	search_var_instance_decl = new search_var_instance_decl_c(symbol);
+	current_scope = symbol;
 	symbol->function_body->accept(*this);
 	delete search_varfb_instance_type;
-	// delete search_var_instance_decl;
+	delete search_var_instance_decl;
 	search_varfb_instance_type = NULL;
-	// search_var_instance_decl = NULL;
+	search_var_instance_decl = NULL;
+	current_scope = NULL;
 	return NULL;
 }
 
@@ -319,12 +413,14 @@ void *array_range_check_c::visit(function_declaration_c *symbol) {
 void *array_range_check_c::visit(function_block_declaration_c *symbol) {
 	symbol->var_declarations->accept(*this); // required for visiting subrange_c
 	search_varfb_instance_type = new search_varfb_instance_type_c(symbol);
-	// search_var_instance_decl = new search_var_instance_decl_c(symbol);
+	search_var_instance_decl = new search_var_instance_decl_c(symbol);
+	current_scope = symbol;
 	symbol->fblock_body->accept(*this);
 	delete search_varfb_instance_type;
-	// delete search_var_instance_decl;
+	delete search_var_instance_decl;
 	search_varfb_instance_type = NULL;
-	// search_var_instance_decl = NULL;
+	search_var_instance_decl = NULL;
+	current_scope = NULL;
 	return NULL;
 }
 
@@ -335,14 +431,92 @@ void *array_range_check_c::visit(function_block_declaration_c *symbol) {
 void *array_range_check_c::visit(program_declaration_c *symbol) {
 	symbol->var_declarations->accept(*this); // required for visiting subrange_c
 	search_varfb_instance_type = new search_varfb_instance_type_c(symbol);
-	// search_var_instance_decl = new search_var_instance_decl_c(symbol);
+	search_var_instance_decl = new search_var_instance_decl_c(symbol);
+	current_scope = symbol;
 	symbol->function_block_body->accept(*this);
 	delete search_varfb_instance_type;
-	// delete search_var_instance_decl;
+	delete search_var_instance_decl;
 	search_varfb_instance_type = NULL;
-	// search_var_instance_decl = NULL;
+	search_var_instance_decl = NULL;
+	current_scope = NULL;
 	return NULL;
 }
 
 
 
+/***************************************/
+/* B.3 - Language ST (Structured Text) */
+/***************************************/
+/***********************/
+/* B 3.1 - Expressions */
+/***********************/
+void *array_range_check_c::visit(add_expression_c *symbol) {
+	symbol->l_exp->accept(*this);
+	symbol->r_exp->accept(*this);
+	set_sum_range(symbol, symbol->l_exp, symbol->r_exp,  1);
+	return NULL;
+}
+
+void *array_range_check_c::visit(sub_expression_c *symbol) {
+	symbol->l_exp->accept(*this);
+	symbol->r_exp->accept(*this);
+	set_sum_range(symbol, symbol->l_exp, symbol->r_exp, -1);
+	return NULL;
+}
+
+void *array_range_check_c::visit(neg_expression_c *symbol) {
+	int64_t lower, upper, type_lower, type_upper;
+	symbol->exp->accept(*this);
+	if (   !get_value_range(symbol->exp, lower, upper)
+	    || !get_datatype_info_c::get_int_range(symbol->datatype, type_lower, type_upper)
+	    || (lower == INT64_MIN) || (-upper < type_lower) || (-lower > type_upper))
+		return NULL;
+	value_ranges.set(symbol, value_range_t(-upper, -lower));
+	return NULL;
+}
+
+
+/********************************/
+/* B 3.2.4 Iteration Statements */
+/********************************/
+/*  FOR control_variable ASSIGN expression TO expression [BY expression] DO statement_list END_FOR */
+// SYM_REF5(for_statement_c, control_variable, beg_expression, end_expression, by_expression, statement_list)
+/*  The body of a FOR loop with a constant BY value only runs with the control variable between the initial and the
+ *  final values, as long as the body does not change the control variable (see for_variable_changed_c), and the
+ *  control variable is not changed from outside the POU either (i.e. it is not a VAR_EXTERNAL, VAR_IN_OUT, ...).
+ *  The control variable must also never overflow when incremented past the final value.
+ */
+void *array_range_check_c::visit(for_statement_c *symbol) {
+	symbol->control_variable->accept(*this);
+	symbol->beg_expression->accept(*this);
+	symbol->end_expression->accept(*this);
+	if (NULL != symbol->by_expression) symbol->by_expression->accept(*this);
+
+	symbolic_variable_c *control_variable = dynamic_cast<symbolic_variable_c *>(symbol->control_variable);
+	int64_t by = 1, by_upper, beg_lower, beg_upper, end_lower, end_upper, type_lower, type_upper;
+	bool has_for_range = (   (NULL != control_variable) && (NULL != search_var_instance_decl)
+	                      && ((NULL == symbol->by_expression) || get_value_range(symbol->by_expression, by, by_upper))
+	                      && ((NULL == symbol->by_expression) || (by == by_upper))
+	                      && (by != 0) && (by != INT64_MIN)
+	                      && get_value_range(symbol->beg_expression, beg_lower, beg_upper)
+	                      && get_value_range(symbol->end_expression, end_lower, end_upper)
+	                      && get_datatype_info_c::get_int_range(control_variable->datatype, type_lower, type_upper));
+	if (has_for_range) {
+		unsigned int vartype = search_var_instance_decl->get_vartype(control_variable);
+		has_for_range = (   (vartype == search_var_instance_decl_c::private_vt) || (vartype == search_var_instance_decl_c::temp_vt)
+		                 || (vartype == search_var_instance_decl_c::output_vt)  || (vartype == search_var_instance_decl_c::input_vt));
+	}
+	if (has_for_range)
+		has_for_range = (by > 0)? ((type_upper >= INT64_MIN + by) && (end_upper <= type_upper - by))
+		                        : ((type_lower <= INT64_MAX + by) && (end_lower >= type_lower - by));
+	if (has_for_range)
+		has_for_range = !for_variable_changed_c::get(symbol, control_variable->var_name);
+
+	if (has_for_range) {
+		for_range_t for_range = {control_variable->var_name, (by > 0)? beg_lower : end_lower, (by > 0)? end_upper : beg_upper};
+		for_ranges.push_back(for_range);
+	}
+	symbol->statement_list->accept(*this);
+	if (has_for_range) for_ranges.pop_back();
+	return NULL;
+}
@@ -31,7 +31,7 @@
  *
  */
 
-// #include <vector>
+#include <vector>
 #include "../absyntax_utils/absyntax_utils.hh"
 // #include "datatype_functions.hh"
 
@@ -40,18 +40,44 @@
 class array_range_check_c: public iterator_visitor_c {
 
   private:
+    /* The range of the values an integer expression is proven to take (lower <= value <= upper), in the AST last checked */
+    class value_range_t {
+      public:
+        bool    valid;
+        int64_t lower, upper;
+        value_range_t(void) {valid = false; lower = upper = 0;}
+        value_range_t(int64_t lower_, int64_t upper_) {valid = true; lower = lower_; upper = upper_;}
+    };
+    static annotation_table_c<value_range_t> value_ranges;
+
     search_varfb_instance_type_c *search_varfb_instance_type;
+    search_var_instance_decl_c   *search_var_instance_decl;
+    symbol_c *current_scope;
     int error_count;
     int current_display_error_level;
 
+    /* The values taken by the control variables of the FOR loops being visited (see visit(for_statement_c *)) */
+    typedef struct {symbol_c *var_name; int64_t lower, upper;} for_range_t;
+    std::vector<for_range_t> for_ranges;
+
     void check_dimension_count(array_variable_c *symbol);
     void check_bounds(array_variable_c *symbol);
+    void set_variable_range(symbol_c *symbol, symbolic_variable_c *variable);
+    void set_sum_range(symbol_c *symbol, symbol_c *l_exp, symbol_c *r_exp, int r_sign);
 
   public:
     array_range_check_c(symbol_c *ignore);
     virtual ~array_range_check_c(void);
     int get_error_count();
 
+    /* The range of the values of an integer expression: its constant value (see constant_folding_c), or the range
+     * of values it was proven to take. Returns false if neither is known.
+     * Used by stage 4 to leave out the __CHECK_<subrange>() of the values that are always inside the subrange.
+     */
+    static bool get_value_range(symbol_c *expression, int64_t &lower, int64_t &upper);
+    /* Forget the value ranges of the previous AST (its symbols' ids may be reused, see symbol_c::release_arena()) */
+    static void clear_value_ranges(void) {value_ranges.clear();}
+
     /*************************/
     /* B.1 - Common elements */
     /*************************/
@@ -71,7 +97,9 @@ class array_range_check_c: public iterator_visitor_c {
     /*************************************/
     /* B 1.4.2 - Multi-element variables */
     /*************************************/
+    void *visit(symbolic_variable_c *symbol);
     void *visit(array_variable_c *symbol);
+    void *visit(structured_variable_c *symbol);
 
     /**************************************/
     /* B 1.5 - Program organisation units */
@@ -91,6 +119,21 @@ class array_range_check_c: public iterator_visitor_c {
     /**********************/
     void *visit(program_declaration_c *symbol);
 
+    /***************************************/
+    /* B.3 - Language ST (Structured Text) */
+    /***************************************/
+    /***********************/
+    /* B 3.1 - Expressions */
+    /***********************/
+    void *visit(add_expression_c *symbol);
+    void *visit(sub_expression_c *symbol);
+    void *visit(neg_expression_c *symbol);
+
+    /********************************/
+    /* B 3.2.4 Iteration Statements */
+    /********************************/
+    void *visit(for_statement_c *symbol);
+
 }; /* array_range_check_c */
 
 
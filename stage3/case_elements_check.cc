@@ -52,7 +52,7 @@
 #define STAGE3_ERROR(error_level, symbol1, symbol2, ...) {                                                                  \
   if (current_display_error_level >= error_level) {                                                                         \
     fprintf(stderr, "%s:%d-%d..%d-%d: error: ",                                                                             \
-            FIRST_(symbol1,symbol2)->first_file, FIRST_(symbol1,symbol2)->first_line, FIRST_(symbol1,symbol2)->first_column,\
+            FIRST_(symbol1,symbol2)->first_file.c_str(), FIRST_(symbol1,symbol2)->first_line, FIRST_(symbol1,symbol2)->first_column,\
                                                  LAST_(symbol1,symbol2) ->last_line,  LAST_(symbol1,symbol2) ->last_column);\
     fprintf(stderr, __VA_ARGS__);                                                                                           \
     fprintf(stderr, "\n");                                                                                                  \
@@ -63,7 +63,7 @@
 
 #define STAGE3_WARNING(symbol1, symbol2, ...) {                                                                             \
     fprintf(stderr, "%s:%d-%d..%d-%d: warning: ",                                                                           \
-            FIRST_(symbol1,symbol2)->first_file, FIRST_(symbol1,symbol2)->first_line, FIRST_(symbol1,symbol2)->first_column,\
+            FIRST_(symbol1,symbol2)->first_file.c_str(), FIRST_(symbol1,symbol2)->first_line, FIRST_(symbol1,symbol2)->first_column,\
                                                  LAST_(symbol1,symbol2) ->last_line,  LAST_(symbol1,symbol2) ->last_column);\
     fprintf(stderr, __VA_ARGS__);                                                                                           \
     fprintf(stderr, "\n");                                                                                                  \
@@ -81,6 +81,8 @@ case_elements_check_c::case_elements_check_c(symbol_c *ignore) {
   warning_found = false;
   error_count = 0;
   current_display_error_level = 0;
+  /* only visit the code containing CASE statements (case_list_c only appears inside these) */
+  relevant_kinds = symbol_c::kind_bit(case_statement_c_kind);
 }
 
 
@@ -141,6 +141,8 @@
 #include <stdlib.h> /* required for malloc() */
 
 #include <string.h>  /* required for strlen() */
+#include <strings.h> /* required for strcasecmp() */
+#include <ctype.h>   /* required for toupper() */
 // #include <stdlib.h>  /* required for atoi() */
 #include <errno.h>   /* required for errno */
 
@@ -157,7 +159,7 @@
 #define STAGE3_ERROR(error_level, symbol1, symbol2, ...) {                                                                  \
   if (current_display_error_level >= error_level) {                                                                         \
     fprintf(stderr, "%s:%d-%d..%d-%d: error: ",                                                                             \
-            FIRST_(symbol1,symbol2)->first_file, FIRST_(symbol1,symbol2)->first_line, FIRST_(symbol1,symbol2)->first_column,\
+            FIRST_(symbol1,symbol2)->first_file.c_str(), FIRST_(symbol1,symbol2)->first_line, FIRST_(symbol1,symbol2)->first_column,\
                                                  LAST_(symbol1,symbol2) ->last_line,  LAST_(symbol1,symbol2) ->last_column);\
     fprintf(stderr, __VA_ARGS__);                                                                                           \
     fprintf(stderr, "\n");                                                                                                  \
@@ -168,7 +170,7 @@
 
 #define STAGE3_WARNING(symbol1, symbol2, ...) {                                                                             \
     fprintf(stderr, "%s:%d-%d..%d-%d: warning: ",                                                                           \
-            FIRST_(symbol1,symbol2)->first_file, FIRST_(symbol1,symbol2)->first_line, FIRST_(symbol1,symbol2)->first_column,\
+            FIRST_(symbol1,symbol2)->first_file.c_str(), FIRST_(symbol1,symbol2)->first_line, FIRST_(symbol1,symbol2)->first_column,\
                                                  LAST_(symbol1,symbol2) ->last_line,  LAST_(symbol1,symbol2) ->last_column);\
     fprintf(stderr, __VA_ARGS__);                                                                                           \
     fprintf(stderr, "\n");                                                                                                  \
@@ -730,6 +732,182 @@ static void *handle_pow(symbol_c *symbol, symbol_c *oper1, symbol_c *oper2) {
 }
 
 
+
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+/***        Functions to evaluate calls to standard functions        ***/
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+
+/* Only the standard functions that have no side effects, and whose result depends only on the
+ * value of their input parameters, are evaluated (ABS, MIN, MAX, LIMIT, EXPT, SHR, MOVE, and
+ * the conversions between the numeric, bit string and BOOL types).
+ *
+ * NOTE: Since the datatype of the function invocation is not yet known (this is done before the
+ *       fill/narrow candidate datatypes algorithm), the generic functions (e.g. ABS) are evaluated
+ *       for all the const values of the parameters, just like the ST operators.
+ *       The conversion functions instead only set the const value of the type they convert to,
+ *       and only when the converted value lies within the range of that type (so the cases in
+ *       which the conversion would be truncated or rounded at runtime are never evaluated here).
+ */
+
+/* the elementary types the conversion functions (<from>_TO_<to>) are evaluated for */
+typedef struct {
+	const char *name;
+	char        kind;   /* 'b' -> BOOL, 's' -> signed integer, 'u' -> unsigned integer or bit string, 'r' -> real */
+	int64_t     min;
+	uint64_t    max;
+} conv_type_t;
+
+static const conv_type_t conv_types[] = {
+	{"BOOL",  'b',         0, 1         },
+	{"SINT",  's',  INT8_MIN, INT8_MAX  },
+	{"INT",   's', INT16_MIN, INT16_MAX },
+	{"DINT",  's', INT32_MIN, INT32_MAX },
+	{"LINT",  's', INT64_MIN, INT64_MAX },
+	{"USINT", 'u',         0, UINT8_MAX },
+	{"UINT",  'u',         0, UINT16_MAX},
+	{"UDINT", 'u',         0, UINT32_MAX},
+	{"ULINT", 'u',         0, UINT64_MAX},
+	{"BYTE",  'u',         0, UINT8_MAX },
+	{"WORD",  'u',         0, UINT16_MAX},
+	{"DWORD", 'u',         0, UINT32_MAX},
+	{"LWORD", 'u',         0, UINT64_MAX},
+	{"REAL",  'r',         0, 0         },
+	{"LREAL", 'r',         0, 0         },
+	{NULL,    0,           0, 0         }
+};
+
+static const conv_type_t *find_conv_type(const char *name, size_t len) {
+	for (int i = 0; conv_types[i].name != NULL; i++)
+		if ((strlen(conv_types[i].name) == len) && (strncasecmp(conv_types[i].name, name, len) == 0))
+			return &conv_types[i];
+	return NULL;
+}
+
+
+/* <from>_TO_<to> */
+static bool is_conversion(const char *fname) {
+	std::string upper_fname(fname);
+	for (unsigned int i = 0; i < upper_fname.size(); i++) upper_fname[i] = toupper(upper_fname[i]);
+	return (NULL != strstr(upper_fname.c_str(), "_TO_"));
+}
+
+static void *handle_conversion(symbol_c *symbol, const char *fname, symbol_c *oper) {
+	std::string upper_fname(fname);
+	for (unsigned int i = 0; i < upper_fname.size(); i++) upper_fname[i] = toupper(upper_fname[i]);
+	const char *function_name = upper_fname.c_str();
+	const char *sep = strstr(function_name, "_TO_");
+	if ((NULL == sep) || (NULL == oper)) return NULL;
+	const conv_type_t *from = find_conv_type(function_name, sep - function_name);
+	const conv_type_t *to   = find_conv_type(sep + 4, strlen(sep + 4));
+	if ((NULL == from) || (NULL == to)) return NULL;
+
+	if (from->kind == 'r') {
+		/* the rounding of real values to integers is left to the runtime */
+		if ((to->kind != 'r') || !VALID_CVALUE(real64, oper)) return NULL;
+		real64_t value = GET_CVALUE(real64, oper);
+		if ((strcmp(to->name, "REAL") == 0) && ((value > REAL32_MAX) || (value < -REAL32_MAX))) return NULL;
+		SET_CVALUE(real64, symbol, value);
+		return NULL;
+	}
+
+	/* the integer value being converted, as its absolute value and sign */
+	uint64_t value;
+	bool     negative = false;
+	switch (from->kind) {
+		case 'b': if (!VALID_CVALUE(  bool, oper)) return NULL; value = GET_CVALUE(bool, oper)? 1 : 0; break;
+		case 'u': if (!VALID_CVALUE(uint64, oper)) return NULL; value = GET_CVALUE(uint64, oper);      break;
+		case 's': if (!VALID_CVALUE( int64, oper)) return NULL;
+		          negative = (GET_CVALUE(int64, oper) < 0);
+		          value    = negative? -(uint64_t)GET_CVALUE(int64, oper) : (uint64_t)GET_CVALUE(int64, oper);
+		          break;
+		default : return NULL;
+	}
+
+	switch (to->kind) {
+		case 'r': SET_CVALUE(real64, symbol, negative? -(real64_t)value : (real64_t)value); break;
+		case 'b': if (!negative && (value <= to->max)) SET_CVALUE(  bool, symbol, value != 0);        break;
+		case 'u': if (!negative && (value <= to->max)) SET_CVALUE(uint64, symbol, value);             break;
+		case 's': if (negative) {
+		            if (value <= -(uint64_t)to->min) SET_CVALUE(int64, symbol, (int64_t)(0 - value));
+		          } else {
+		            if (value <= to->max)            SET_CVALUE(int64, symbol, (int64_t)value);
+		          }
+		          break;
+	}
+	return NULL;
+}
+
+
+static void *handle_abs(symbol_c *symbol, symbol_c *oper) {
+	if (NULL == oper) return NULL;
+	if (VALID_CVALUE(uint64, oper)) SET_CVALUE(uint64, symbol, GET_CVALUE(uint64, oper));
+	if (VALID_CVALUE( int64, oper)) {
+		if (GET_CVALUE(int64, oper) == INT64_MIN) SET_OVFLOW(int64, symbol);
+		else SET_CVALUE(int64, symbol, (GET_CVALUE(int64, oper) < 0)? -GET_CVALUE(int64, oper) : GET_CVALUE(int64, oper));
+	}
+	if (VALID_CVALUE(real64, oper)) SET_CVALUE(real64, symbol, fabs(GET_CVALUE(real64, oper)));
+	return NULL;
+}
+
+
+static void *handle_shr(symbol_c *symbol, symbol_c *oper, symbol_c *count) {
+	if ((NULL == oper) || (NULL == count)) return NULL;
+	/* shifting by the size of the type (or more) is left to the runtime */
+	if (VALID_CVALUE(uint64, oper) && VALID_CVALUE(uint64, count) && (GET_CVALUE(uint64, count) < 64))
+		SET_CVALUE(uint64, symbol, GET_CVALUE(uint64, oper) >> GET_CVALUE(uint64, count));
+	return NULL;
+}
+
+
+/* MIN() and MAX() -> extensible functions, with any number of parameters */
+#define DO_MINMAX_OPER(dtype, operation, opers) {                                                                        \
+	bool all_valid = true;                                                                                            \
+	for (unsigned int i = 0; i < opers.size(); i++)                                                                   \
+		if (!VALID_CVALUE(dtype, opers[i])) {all_valid = false; break;}                                           \
+	if (all_valid) {                                                                                                  \
+		SET_CVALUE(dtype, symbol, GET_CVALUE(dtype, opers[0]));                                                   \
+		for (unsigned int i = 1; i < opers.size(); i++)                                                           \
+			if (GET_CVALUE(dtype, opers[i]) operation GET_CVALUE(dtype, symbol))                              \
+				SET_CVALUE(dtype, symbol, GET_CVALUE(dtype, opers[i]));                                   \
+	}                                                                                                                 \
+}
+
+static void *handle_min(symbol_c *symbol, std::vector<symbol_c *> &opers) {
+	if (opers.empty()) return NULL;
+	DO_MINMAX_OPER(uint64, <, opers);
+	DO_MINMAX_OPER( int64, <, opers);
+	DO_MINMAX_OPER(real64, <, opers);
+	return NULL;
+}
+
+static void *handle_max(symbol_c *symbol, std::vector<symbol_c *> &opers) {
+	if (opers.empty()) return NULL;
+	DO_MINMAX_OPER(uint64, >, opers);
+	DO_MINMAX_OPER( int64, >, opers);
+	DO_MINMAX_OPER(real64, >, opers);
+	return NULL;
+}
+
+
+/* LIMIT(MN, IN, MX) is defined as MIN(MAX(IN, MN), MX) */
+static void *handle_limit(symbol_c *symbol, symbol_c *mn, symbol_c *in, symbol_c *mx) {
+	if ((NULL == mn) || (NULL == in) || (NULL == mx)) return NULL;
+	std::vector<symbol_c *> opers;
+	opers.push_back(in);
+	opers.push_back(mn);
+	handle_max(symbol, opers);
+	opers.clear();
+	opers.push_back(symbol);
+	opers.push_back(mx);
+	handle_min(symbol, opers);
+	return NULL;
+}
+
+
 /***********************************************************************/
 /***********************************************************************/
 /***********************************************************************/
@@ -1216,6 +1394,473 @@ void *constant_folding_c::visit( power_expression_c *symbol) {symbol->l_exp->acc
 void *constant_folding_c::visit(   neg_expression_c *symbol) {symbol->  exp->accept(*this); return handle_neg(symbol, symbol->exp);}
 void *constant_folding_c::visit(   not_expression_c *symbol) {symbol->  exp->accept(*this); return handle_not(symbol, symbol->exp);}
 
+/* Get the value passed to the parameter 'param_name' (or in position 'param_pos' when called with non formal parameters).
+ * Returns NULL if not passed.
+ */
+static symbol_c *get_fcall_param(function_invocation_c *symbol, const char *param_name, int param_pos) {
+  if (NULL != symbol->nonformal_param_list) {
+    list_c *list = (list_c *)symbol->nonformal_param_list;
+    return (param_pos < list->n)? list->get_element(param_pos) : NULL;
+  }
+  if (NULL != symbol->formal_param_list) {
+    list_c *list = (list_c *)symbol->formal_param_list;
+    for (int i = 0; i < list->n; i++) {
+      input_variable_param_assignment_c *param = dynamic_cast<input_variable_param_assignment_c *>(list->get_element(i));
+      if ((NULL != param) && (strcasecmp(((token_c *)param->variable_name)->value, param_name) == 0))
+        return param->expression;
+    }
+  }
+  return NULL;
+}
+
+/* The number of input parameters passed in the call, or -1 if it uses EN, ENO, or any output parameter */
+static int get_fcall_param_count(function_invocation_c *symbol) {
+  if (NULL != symbol->nonformal_param_list) return ((list_c *)symbol->nonformal_param_list)->n;
+  if (NULL == symbol->formal_param_list)    return 0;
+  list_c *list = (list_c *)symbol->formal_param_list;
+  for (int i = 0; i < list->n; i++) {
+    input_variable_param_assignment_c *param = dynamic_cast<input_variable_param_assignment_c *>(list->get_element(i));
+    if ((NULL == param) || (strcasecmp(((token_c *)param->variable_name)->value, "EN") == 0))
+      return -1;
+  }
+  return list->n;
+}
+
+/* The user defined FUNCTIONs called with constant parameters are evaluated at compile time, by interpreting
+ * their body (i.e. the function is run by the compiler), so that the call is replaced by its result, like for the
+ * standard functions above.
+ *
+ * Only the FUNCTIONs that have no side effects, and whose result depends only on the value of their input
+ * parameters, are evaluated. These are the FUNCTIONs written in ST, that:
+ *   - only declare VAR_INPUT and VAR (or VAR CONSTANT) variables (and the implicit EN and ENO),
+ *     all of the elementary types of conv_types[] (i.e. no arrays, structures, strings, FB instances, ...);
+ *   - do not use any value of type REAL. Constant folding computes all the REAL values in double precision,
+ *     while the generated C code computes them in float, so the compiler could get a different result
+ *     (e.g. A + 1.0E-10 - A) than the runtime. LREAL values are computed in double by both;
+ *   - only use assignments to those variables, IF, CASE (with integer labels), FOR, WHILE, REPEAT, EXIT and RETURN,
+ *     and the expressions that constant folding evaluates, including calls to other such FUNCTIONs;
+ *   - assign a value to the function's result (which the declarations of the standard functions never do).
+ * The evaluation is abandoned (and the call is then left to the runtime) as soon as anything else is found, when a
+ * value assigned to a variable does not lie within the range of its datatype (where the runtime would have it
+ * truncated), or when the function runs for too long (e.g. an endless loop).
+ *
+ * The const_value annotations of the body of the evaluated FUNCTION are used to run it, and are restored
+ * afterwards, so the FUNCTION's own (run time) code is generated just like before.
+ */
+#define EVALUATOR_MAX_DEPTH 16       /* of the calls to FUNCTIONs that call FUNCTIONs that ... */
+#define EVALUATOR_MAX_STEPS 100000   /* the number of statements run, in all the nested calls */
+
+/* Saves the const_value of every symbol in a sub-tree, to later restore them */
+class save_const_values_c: public fcall_iterator_visitor_c {
+  private:
+    std::vector<std::pair<symbol_c *, const_value_c> > saved;
+  public:
+    void prefix_fcall(symbol_c *symbol) {saved.push_back(std::make_pair(symbol, symbol->const_value));}
+    void restore(void) {for (unsigned int i = 0; i < saved.size(); i++) saved[i].first->const_value = saved[i].second;}
+};
+
+/* Finds whether any expression (or variable) in a sub-tree is of type REAL */
+class uses_real_c: public fcall_iterator_visitor_c {
+  public:
+    bool found;
+    uses_real_c(symbol_c *symbol) {found = false; symbol->accept(*this);}
+    void prefix_fcall(symbol_c *symbol) {
+      if (   (NULL != symbol->datatype)
+          && (   get_datatype_info_c::is_type_equal(symbol->datatype, &get_datatype_info_c::real_type_name)
+              || get_datatype_info_c::is_type_equal(symbol->datatype, &get_datatype_info_c::safereal_type_name)))
+        found = true;
+    }
+};
+
+/* Resets the const_value of every symbol in a sub-tree (i.e. forgets the values of a previous evaluation) */
+class reset_const_values_c: public fcall_iterator_visitor_c {
+  public:
+    void prefix_fcall(symbol_c *symbol) {symbol->const_value = const_value_c();}
+};
+
+
+class function_evaluator_c: public constant_folding_c {
+  private:
+    typedef enum {st_next, st_exit, st_return, st_fail} status_t;
+    typedef struct {
+      const conv_type_t *type;
+      const_value_c      value;
+      bool               assigned;
+    } variable_t;
+
+    std::map<std::string, variable_t> variables;
+    std::string                       result_name;
+
+    static int  depth;
+    static long steps;   /* only reset by the outermost evaluation */
+
+    static std::string key(const char *name) {
+      std::string str(name);
+      for (unsigned int i = 0; i < str.size(); i++) str[i] = toupper(str[i]);
+      return str;
+    }
+
+    /* The type of the variables (one of conv_types[]), or NULL if not supported (including REAL, see above) */
+    static const conv_type_t *get_type(symbol_c *type) {
+      symbol_c *basetype = search_base_type_c::get_basetype_decl(type);
+      if ((NULL == basetype) || !get_datatype_info_c::is_ANY_ELEMENTARY(basetype)) return NULL;
+      if (   get_datatype_info_c::is_type_equal(basetype, &get_datatype_info_c::real_type_name)
+          || get_datatype_info_c::is_type_equal(basetype, &get_datatype_info_c::safereal_type_name)) return NULL;
+      const char *name = get_datatype_info_c::get_id_str(basetype);
+      return find_conv_type(name, strlen(name));
+    }
+
+    /* The value, converted to the type of the variable. Returns false if it is not representable in that type. */
+    static bool convert(const conv_type_t *type, const_value_c &value, const_value_c &result) {
+      result = const_value_c();
+      switch (type->kind) {
+        case 'b': if (!value._bool.is_valid()) return false;
+                  result._bool.set(value._bool.get());
+                  return true;
+        case 's': if (!value._int64.is_valid() || (value._int64.get() < type->min)) return false;
+                  if ((value._int64.get() > 0) && ((uint64_t)value._int64.get() > type->max)) return false;
+                  result._int64.set(value._int64.get());
+                  return true;
+        case 'u': if (!value._uint64.is_valid() || (value._uint64.get() > type->max)) return false;
+                  result._uint64.set(value._uint64.get());
+                  return true;
+        case 'r': if (!value._real64.is_valid()) return false;
+                  result._real64.set(value._real64.get());  /* LREAL only (see get_type()) */
+                  return true;
+      }
+      return false;
+    }
+
+    /* Evaluate the expression, with the current values of the variables */
+    const_value_c &evaluate(symbol_c *expression) {
+      reset_const_values_c reset_const_values;
+      expression->accept(reset_const_values);
+      expression->accept(*this);
+      return expression->const_value;
+    }
+
+    /* The value of the parameters passed in the call (param_value) was already determined by the caller, in its own context */
+    bool add_variable(token_c *name, symbol_c *type, symbol_c *init_value, symbol_c *param_value = NULL) {
+      variable_t variable;
+      variable.type     = get_type(type);
+      variable.assigned = false;
+      if (NULL == variable.type) return false;
+      if (NULL != param_value) {
+        if (!convert(variable.type, param_value->const_value, variable.value)) return false;
+        variables[key(name->value)] = variable;
+        return true;
+      }
+      if (NULL == init_value) init_value = type_initial_value_c::get(type);
+      if ((NULL == init_value) || !convert(variable.type, evaluate(init_value), variable.value)) return false;
+      variables[key(name->value)] = variable;
+      return true;
+    }
+
+    /* VAR_INPUT, VAR, and VAR CONSTANT of simple elementary types (var1_init_decl_c), and EN and ENO */
+    bool add_variables(symbol_c *decl_list, bool inputs, function_invocation_c *call, int &param_pos) {
+      list_c *list = dynamic_cast<list_c *>(decl_list);
+      if (NULL == list) return false;
+      for (int i = 0; i < list->n; i++) {
+        symbol_c *decl = list->get_element(i);
+        en_param_declaration_c  *en_decl  = dynamic_cast<en_param_declaration_c  *>(decl);
+        eno_param_declaration_c *eno_decl = dynamic_cast<eno_param_declaration_c *>(decl);
+        var1_init_decl_c        *var_decl = dynamic_cast<var1_init_decl_c        *>(decl);
+        boolean_true_c           true_value;
+        if      (NULL !=  en_decl) {if (!add_variable((token_c *)en_decl ->name, &get_datatype_info_c::bool_type_name, &true_value)) return false;}
+        else if (NULL != eno_decl) {if (!add_variable((token_c *)eno_decl->name, &get_datatype_info_c::bool_type_name, &true_value)) return false;}
+        else if (NULL == var_decl) return false;
+        else {
+          list_c   *var_list = dynamic_cast<list_c *>(var_decl->var1_list);
+          symbol_c *type     = spec_init_sperator_c::get_spec(var_decl->spec_init);
+          if (NULL == var_list) return false;
+          for (int v = 0; v < var_list->n; v++) {
+            token_c  *name  = dynamic_cast<token_c *>(var_list->get_element(v));
+            if (NULL == name) return false;  /* e.g. the extensible parameters of the standard functions */
+            symbol_c *value = inputs? get_fcall_param(call, name->value, param_pos++) : NULL;
+            if (!add_variable(name, type, spec_init_sperator_c::get_init(var_decl->spec_init), value)) return false;
+          }
+        }
+      }
+      return true;
+    }
+
+    static bool only_eno(symbol_c *decl_list) {
+      list_c *list = dynamic_cast<list_c *>(decl_list);
+      for (int i = 0; (NULL != list) && (i < list->n); i++)
+        if (NULL == dynamic_cast<eno_param_declaration_c *>(list->get_element(i))) return false;
+      return (NULL != list);
+    }
+
+    bool add_declarations(function_declaration_c *f_decl, function_invocation_c *call) {
+      list_c *list = dynamic_cast<list_c *>(f_decl->var_declarations_list);
+      if (NULL == list) return false;
+      int param_pos = 0;
+      for (int i = 0; i < list->n; i++) {
+        symbol_c *decls = list->get_element(i);
+        input_declarations_c  *input_decls  = dynamic_cast<input_declarations_c  *>(decls);
+        output_declarations_c *output_decls = dynamic_cast<output_declarations_c *>(decls);
+        function_var_decls_c  *var_decls    = dynamic_cast<function_var_decls_c  *>(decls);
+        if      (NULL != input_decls)  {if (!add_variables(input_decls ->input_declaration_list, true,  call, param_pos)) return false;}
+        else if (NULL != output_decls) {if (!only_eno(output_decls->var_init_decl_list) ||
+                                            !add_variables(output_decls->var_init_decl_list,     false, call, param_pos)) return false;}
+        else if (NULL != var_decls)    {if (!add_variables(var_decls   ->decl_list,              false, call, param_pos)) return false;}
+        else return false;
+      }
+      /* all the parameters passed in the call must be input parameters of the function */
+      if (get_fcall_param_count(call) > param_pos) return false;
+      if (NULL != call->formal_param_list) {
+        list_c *params = (list_c *)call->formal_param_list;
+        for (int i = 0; i < params->n; i++) {
+          input_variable_param_assignment_c *param = dynamic_cast<input_variable_param_assignment_c *>(params->get_element(i));
+          if ((NULL == param) || (variables.count(key(((token_c *)param->variable_name)->value)) == 0)) return false;
+        }
+      }
+      /* the function's result */
+      token_c *name = dynamic_cast<token_c *>(f_decl->derived_function_name);
+      if ((NULL == name) || !add_variable(name, f_decl->type_name, NULL)) return false;
+      result_name = key(name->value);
+      return true;
+    }
+
+    variable_t *get_variable(symbol_c *symbol) {
+      symbolic_variable_c *variable = dynamic_cast<symbolic_variable_c *>(symbol);
+      if (NULL == variable) return NULL;
+      std::map<std::string, variable_t>::iterator i = variables.find(key(get_var_name_c::get_name(variable->var_name)->value));
+      return (i == variables.end())? NULL : &i->second;
+    }
+
+    bool assign(symbol_c *l_exp, const_value_c &value) {
+      variable_t *variable = get_variable(l_exp);
+      if ((NULL == variable) || !convert(variable->type, value, variable->value)) return false;
+      variable->assigned = true;
+      return true;
+    }
+
+    /* returns 1 (TRUE), 0 (FALSE), or -1 if not a BOOL value */
+    int condition(symbol_c *expression) {
+      const_value_c &value = evaluate(expression);
+      return value._bool.is_valid()? (value._bool.get()? 1 : 0) : -1;
+    }
+
+    /* returns 1 if cv1 > cv2, 0 if equal, -1 if less, or -2 if the values can not be compared as values of the type */
+    static int compare(const conv_type_t *type, const_value_c &cv1, const_value_c &cv2) {
+      switch (type->kind) {
+        case 's': if (!cv1. _int64.is_valid() || !cv2. _int64.is_valid()) return -2;
+                  return (cv1. _int64.get() > cv2. _int64.get())? 1 : (cv1. _int64.get() == cv2. _int64.get())? 0 : -1;
+        case 'u': if (!cv1._uint64.is_valid() || !cv2._uint64.is_valid()) return -2;
+                  return (cv1._uint64.get() > cv2._uint64.get())? 1 : (cv1._uint64.get() == cv2._uint64.get())? 0 : -1;
+      }
+      return -2;
+    }
+
+    status_t run_list(symbol_c *statement_list) {
+      list_c *list = dynamic_cast<list_c *>(statement_list);
+      if (NULL == list) return (NULL == statement_list)? st_next : st_fail;
+      for (int i = 0; i < list->n; i++) {
+        status_t status = run(list->get_element(i));
+        if (st_next != status) return status;
+      }
+      return st_next;
+    }
+
+    status_t run_if(if_statement_c *symbol) {
+      int cond = condition(symbol->expression);
+      if (cond < 0) return st_fail;
+      if (cond > 0) return run_list(symbol->statement_list);
+      list_c *elseif_list = dynamic_cast<list_c *>(symbol->elseif_statement_list);
+      for (int i = 0; (NULL != elseif_list) && (i < elseif_list->n); i++) {
+        elseif_statement_c *elseif = dynamic_cast<elseif_statement_c *>(elseif_list->get_element(i));
+        if (NULL == elseif) return st_fail;
+        cond = condition(elseif->expression);
+        if (cond < 0) return st_fail;
+        if (cond > 0) return run_list(elseif->statement_list);
+      }
+      return run_list(symbol->else_statement_list);
+    }
+
+    status_t run_case(case_statement_c *symbol) {
+      const_value_c value = evaluate(symbol->expression);
+      const conv_type_t *type = value._int64.is_valid()? find_conv_type("LINT", 4) : find_conv_type("ULINT", 5);
+      list_c *elements = dynamic_cast<list_c *>(symbol->case_element_list);
+      if (NULL == elements) return st_fail;
+      for (int i = 0; i < elements->n; i++) {
+        case_element_c *element = dynamic_cast<case_element_c *>(elements->get_element(i));
+        list_c         *labels  = (NULL == element)? NULL : dynamic_cast<list_c *>(element->case_list);
+        if (NULL == labels) return st_fail;
+        for (int l = 0; l < labels->n; l++) {
+          subrange_c *subrange = dynamic_cast<subrange_c *>(labels->get_element(l));
+          int cmp_lower, cmp_upper;
+          if (NULL == subrange) {
+            cmp_lower = cmp_upper = compare(type, value, evaluate(labels->get_element(l)));
+          } else {
+            cmp_lower = compare(type, value, evaluate(subrange->lower_limit));
+            cmp_upper = compare(type, value, evaluate(subrange->upper_limit));
+          }
+          if ((-2 == cmp_lower) || (-2 == cmp_upper)) return st_fail;
+          if ((cmp_lower >= 0) && (cmp_upper <= 0)) return run_list(element->statement_list);
+        }
+      }
+      return run_list(symbol->statement_list);
+    }
+
+    /* The loops run like the code generated by stage4 (generate_c_st_c): the end and BY values are evaluated once */
+    status_t run_for(for_statement_c *symbol) {
+      variable_t *control = get_variable(symbol->control_variable);
+      if ((NULL == control) || !assign(symbol->control_variable, evaluate(symbol->beg_expression))) return st_fail;
+      const_value_c end_value, by_value;
+      if (!convert(control->type, evaluate(symbol->end_expression), end_value)) return st_fail;
+      if (NULL == symbol->by_expression) {
+        by_value._int64.set(1); by_value._uint64.set(1);
+      } else if (!convert(control->type, evaluate(symbol->by_expression), by_value)) return st_fail;
+      const_value_c zero;
+      zero._int64.set(0); zero._uint64.set(0);
+      int by_sign = compare(control->type, by_value, zero);
+      if (-2 == by_sign) return st_fail;
+      while (true) {
+        int cmp = compare(control->type, control->value, end_value);
+        if (-2 == cmp) return st_fail;
+        if ((by_sign > 0)? (cmp > 0) : (cmp < 0)) return st_next;
+        status_t status = run_list(symbol->statement_list);
+        if (st_exit == status) return st_next;
+        if (st_next != status) return status;
+        /* control := control + by */
+        const_value_c sum;
+        if (control->type->kind == 's') {
+          int64_t a = control->value._int64.get(), b = by_value._int64.get();
+          if (((b > 0) && (a > INT64_MAX - b)) || ((b < 0) && (a < INT64_MIN - b))) return st_fail;
+          sum._int64.set(a + b);
+        } else {
+          if (control->value._uint64.get() > UINT64_MAX - by_value._uint64.get()) return st_fail;
+          sum._uint64.set(control->value._uint64.get() + by_value._uint64.get());
+        }
+        if (!convert(control->type, sum, control->value)) return st_fail;
+        if (++steps > EVALUATOR_MAX_STEPS) return st_fail;
+      }
+    }
+
+    status_t run_loop(symbol_c *expression, symbol_c *statement_list, bool test_first, bool until) {
+      while (true) {
+        if (test_first) {
+          int cond = condition(expression);
+          if (cond < 0) return st_fail;
+          if ((cond > 0) == until) return st_next;
+        }
+        status_t status = run_list(statement_list);
+        if (st_exit == status) return st_next;
+        if (st_next != status) return status;
+        if (!test_first) {
+          int cond = condition(expression);
+          if (cond < 0) return st_fail;
+          if ((cond > 0) == until) return st_next;
+        }
+        if (++steps > EVALUATOR_MAX_STEPS) return st_fail;
+      }
+    }
+
+    status_t run(symbol_c *statement) {
+      if (++steps > EVALUATOR_MAX_STEPS) return st_fail;
+      assignment_statement_c *assignment = dynamic_cast<assignment_statement_c *>(statement);
+      if (NULL != assignment) return assign(assignment->l_exp, evaluate(assignment->r_exp))? st_next : st_fail;
+      if (NULL != dynamic_cast<if_statement_c     *>(statement)) return run_if  ((if_statement_c   *)statement);
+      if (NULL != dynamic_cast<case_statement_c   *>(statement)) return run_case((case_statement_c *)statement);
+      if (NULL != dynamic_cast<for_statement_c    *>(statement)) return run_for ((for_statement_c  *)statement);
+      while_statement_c  *while_statement  = dynamic_cast<while_statement_c  *>(statement);
+      repeat_statement_c *repeat_statement = dynamic_cast<repeat_statement_c *>(statement);
+      if (NULL != while_statement)  return run_loop(while_statement ->expression, while_statement ->statement_list, true,  false);
+      if (NULL != repeat_statement) return run_loop(repeat_statement->expression, repeat_statement->statement_list, false, true);
+      if (NULL != dynamic_cast<exit_statement_c   *>(statement)) return st_exit;
+      if (NULL != dynamic_cast<return_statement_c *>(statement)) return st_return;
+      return st_fail;
+    }
+
+    /* the variables read in the expressions */
+    void *visit(symbolic_variable_c *symbol) {
+      variable_t *variable = get_variable(symbol);
+      if (NULL != variable) symbol->const_value = variable->value;
+      return NULL;
+    }
+
+  public:
+    function_evaluator_c(void): constant_folding_c(NULL) {}
+
+    /* Evaluate the call to the function. Returns false if it can not be evaluated at compile time. */
+    bool evaluate_call(function_declaration_c *f_decl, function_invocation_c *call, const_value_c &result) {
+      if (NULL == dynamic_cast<statement_list_c *>(f_decl->function_body)) return false;  /* not ST */
+      if (uses_real_c(f_decl->function_body).found) return false;
+      if (depth >= EVALUATOR_MAX_DEPTH) return false;
+      if (0 == depth) steps = 0;
+
+      /* NOTE: evaluating the initial values of the variables (literals) gives them the const_value they always have */
+      if (!add_declarations(f_decl, call)) return false;
+
+      save_const_values_c saved;
+      f_decl->function_body->accept(saved);
+      depth++;
+      status_t status = run_list(f_decl->function_body);
+      /* NOTE: an EXIT outside of a loop (st_exit) is not evaluated */
+      bool ok = ((st_next == status) || (st_return == status)) && variables[result_name].assigned;
+      if (ok) result = variables[result_name].value;
+      depth--;
+      saved.restore();
+      return ok;
+    }
+};
+
+int  function_evaluator_c::depth = 0;
+long function_evaluator_c::steps = 0;
+
+
+/* A call to a user defined FUNCTION, with constant parameters */
+static void *handle_user_function(function_invocation_c *symbol) {
+  /* forget the value of a previous visit (e.g. of another instance of the FB this call is in) */
+  symbol->const_value = const_value_c();
+  if (function_symtable.count(symbol->function_name) != 1) return NULL;  /* unknown, or overloaded */
+  function_declaration_c *f_decl = function_symtable.find(symbol->function_name)->second;
+  if (NULL == f_decl) return NULL;
+
+  function_evaluator_c evaluator;
+  const_value_c        result;
+  if (evaluator.evaluate_call(f_decl, symbol, result))
+    symbol->const_value = result;
+  return NULL;
+}
+
+
+/*    function_name '(' [param_assignment_list] ')' */
+/* NOTE: The parameter 'called_function_declaration', 'extensible_param_count' and 'candidate_functions' are used to pass data between the stage 3 and stage 4. */
+// SYM_REF3(function_invocation_c, function_name, formal_param_list, nonformal_param_list, symbol_c *called_function_declaration; int extensible_param_count; std::vector <symbol_c *> candidate_functions;)
+void *constant_folding_c::visit(function_invocation_c *symbol) {
+  /* do constant folding of the parameters first... */
+  if (NULL != symbol->   formal_param_list) symbol->   formal_param_list->accept(*this);
+  if (NULL != symbol->nonformal_param_list) symbol->nonformal_param_list->accept(*this);
+
+  token_c *function_name = dynamic_cast<token_c *>(symbol->function_name);
+  if (NULL == function_name) return NULL;
+  const char *fname = function_name->value;
+  int param_count = get_fcall_param_count(symbol);
+
+  if      ((param_count == 1) && (strcasecmp(fname, "ABS" ) == 0)) return handle_abs (symbol, get_fcall_param(symbol, "IN", 0));
+  else if ((param_count == 1) && (strcasecmp(fname, "MOVE") == 0)) return handle_move(symbol, get_fcall_param(symbol, "IN", 0));
+  else if ((param_count == 2) && (strcasecmp(fname, "EXPT") == 0)) return handle_pow (symbol, get_fcall_param(symbol, "IN1", 0), get_fcall_param(symbol, "IN2", 1));
+  else if ((param_count == 2) && (strcasecmp(fname, "SHR" ) == 0)) return handle_shr (symbol, get_fcall_param(symbol, "IN",  0), get_fcall_param(symbol, "N",   1));
+  else if ((param_count == 3) && (strcasecmp(fname, "LIMIT") == 0))
+    return handle_limit(symbol, get_fcall_param(symbol, "MN", 0), get_fcall_param(symbol, "IN", 1), get_fcall_param(symbol, "MX", 2));
+  else if ((param_count >= 1) && ((strcasecmp(fname, "MIN") == 0) || (strcasecmp(fname, "MAX") == 0))) {
+    std::vector<symbol_c *> opers;
+    for (int i = 0; i < param_count; i++) {
+      char param_name[32];
+      snprintf(param_name, sizeof(param_name), "IN%d", i + 1);
+      symbol_c *oper = get_fcall_param(symbol, param_name, i);
+      if (NULL == oper) return NULL;
+      opers.push_back(oper);
+    }
+    return (strcasecmp(fname, "MIN") == 0)? handle_min(symbol, opers) : handle_max(symbol, opers);
+  }
+  else if ((param_count == 1) && is_conversion(fname)) return handle_conversion(symbol, fname, get_fcall_param(symbol, "IN", 0));
+  else if  (param_count >= 0) return handle_user_function(symbol);
+  return NULL;
+}
+
 
 
 
@@ -1240,8 +1885,10 @@ constant_propagation_c::constant_propagation_c(symbol_c *symbol)
     current_resource = NULL;
     current_configuration = NULL;
     fixed_init_value_ = false;
+    constant_var_ = false;
     function_pou_ = false;
     values = NULL;
+    constant_values = NULL;
   }
 
 
@@ -1388,14 +2035,21 @@ void *constant_propagation_c::visit(library_c *symbol) {
 /*********************/
 /* B 1.4 - Variables */
 /*********************/
-#if DO_CONSTANT_PROPAGATION__
+/* NOTE: While the constant propagation algorithm is disabled, we still know the value of the CONSTANT
+ *       variables (including the VAR_EXTERNAL CONSTANT, whose value comes from the VAR_GLOBAL of the
+ *       configuration/resource in which the POU is instantiated), so we use those.
+ */
 void *constant_propagation_c::visit(symbolic_variable_c *symbol) {
 	std::string varName = get_var_name_c::get_name(symbol->var_name)->value;
+#if DO_CONSTANT_PROPAGATION__
 	if (values->count(varName) > 0) 
 		symbol->const_value = (*values)[varName];
+#else
+	if ((NULL != constant_values) && (constant_values->count(varName) > 0))
+		symbol->const_value = (*constant_values)[varName];
+#endif  // DO_CONSTANT_PROPAGATION__
 	return NULL;
 }
-#endif  // DO_CONSTANT_PROPAGATION__
 
 void *constant_propagation_c::visit(symbolic_constant_c *symbol) {
 	std::string varName = get_var_name_c::get_name(symbol->var_name)->value;
@@ -1409,10 +2063,17 @@ void *constant_propagation_c::visit(symbolic_constant_c *symbol) {
 /* B 1.4.3 - Declaration & Initialisation */
 /******************************************/
   
-void *constant_propagation_c::handle_var_decl(symbol_c *var_list, bool fixed_init_value) {
+void *constant_propagation_c::handle_var_decl(symbol_c *var_list, bool fixed_init_value, bool constant_var) {
+  /* NOTE: var_list may contain FB instances, whose FB type declaration is then visited recursively, so
+   *       we must restore the flags of the variable declarations currently being handled (and not reset them!)
+   */
+  bool prev_fixed_init_value = fixed_init_value_;
+  bool prev_constant_var     = constant_var_;
   fixed_init_value_ = fixed_init_value;
+  constant_var_     = constant_var;
   var_list->accept(*this); 
-  fixed_init_value_ = false; 
+  fixed_init_value_ = prev_fixed_init_value; 
+  constant_var_     = prev_constant_var; 
   return NULL;
 }
 
@@ -1480,6 +2141,8 @@ void *constant_propagation_c::handle_var_list_decl(symbol_c *var_list, symbol_c
         // Notice that global variables are also placed in the values map!!
         var_global_values[var_name->value] = init_value->const_value;
     }
+    if (constant_var_)
+      (*constant_values)[var_name->value] = init_value->const_value;
   }
   return NULL;
 }
@@ -1561,7 +2224,7 @@ void *constant_propagation_c::visit(input_output_declarations_c *symbol) {return
 /* VAR [CONSTANT] var_init_decl_list END_VAR */
 /* option -> may be NULL ! */
 //SYM_REF2(var_declarations_c, option, var_init_decl_list)
-void *constant_propagation_c::visit(var_declarations_c *symbol) {return handle_var_decl(symbol->var_init_decl_list, false);}
+void *constant_propagation_c::visit(var_declarations_c *symbol) {return handle_var_decl(symbol->var_init_decl_list, is_constant(symbol->option), is_constant(symbol->option));}
 
 /*  VAR RETAIN var_init_decl_list END_VAR */
 //SYM_REF1(retentive_var_declarations_c, var_init_decl_list)             // Not needed since we inherit from iterator_visitor_c!
@@ -1585,7 +2248,7 @@ SYM_REF3(located_var_decl_c, variable_name, location, located_var_spec_init)
 /*| VAR_EXTERNAL [CONSTANT] external_declaration_list END_VAR */
 /* option -> may be NULL ! */
 // SYM_REF2(external_var_declarations_c, option, external_declaration_list)
-void *constant_propagation_c::visit(external_var_declarations_c *symbol) {return handle_var_decl(symbol->external_declaration_list, is_constant(symbol->option));}
+void *constant_propagation_c::visit(external_var_declarations_c *symbol) {return handle_var_decl(symbol->external_declaration_list, is_constant(symbol->option), is_constant(symbol->option));}
 
 /* helper symbol for external_var_declarations */
 /*| external_declaration_list external_declaration';' */
@@ -1628,6 +2291,8 @@ void *constant_propagation_c::visit(external_declaration_c *symbol) {
 //  (*values)[symbol->global_var_name->get_value()] = symbol->specification->const_value;
     (*values)[get_var_name_c::get_name(symbol->global_var_name)->value] = symbol->specification->const_value;
   }
+  if (constant_var_)
+    (*constant_values)[get_var_name_c::get_name(symbol->global_var_name)->value] = symbol->specification->const_value;
   // If the datatype specification is a subrange or array, do constant folding of all the literals in that type declaration... (ex: literals in array subrange limits)
   symbol->specification->accept(*this);  // should never get to change the const_value of the symbol->specification symbol (only its children!).
   return NULL;
@@ -1656,7 +2321,7 @@ void *constant_propagation_c::visit(external_declaration_c *symbol) {
  * Nevertheless, since constant folding is idem-potent, it is simpler to just call handle_var_decl() instead
  * of writing some code specific for this situation!
  */
-void *constant_propagation_c::visit(global_var_declarations_c *symbol) {return handle_var_decl(symbol->global_var_decl_list, is_constant(symbol->option));}
+void *constant_propagation_c::visit(global_var_declarations_c *symbol) {return handle_var_decl(symbol->global_var_decl_list, is_constant(symbol->option), is_constant(symbol->option));}
 
 
 /* helper symbol for global_var_declarations */
@@ -1740,8 +2405,11 @@ SYM_LIST(var_init_decl_list_c)
 //SYM_REF4(function_declaration_c, derived_function_name, type_name, var_declarations_list, function_body, enumvalue_symtable_t enumvalue_symtable;)
 void *constant_propagation_c::visit(function_declaration_c *symbol) {
 	map_values_t local_values, *prev_pou_values;
+	map_values_t local_constant_values, *prev_pou_constant_values;
 	prev_pou_values = values; // store the current values map of whoever called this Function (a program, configuration, or resource)
+	prev_pou_constant_values = constant_values;
 	values = &local_values;
+	constant_values = &local_constant_values;
 	var_global_values.push(); /* Create inner scope - Not really needed, but do it just to be consistent. */
 
 	/* Add initial value of all declared variables into Values map. */
@@ -1752,6 +2420,7 @@ void *constant_propagation_c::visit(function_declaration_c *symbol) {
 
 	var_global_values.pop(); /* Delete inner scope */
 	values = prev_pou_values;
+	constant_values = prev_pou_constant_values;
 	return NULL;
 }
 
@@ -1766,7 +2435,7 @@ void *constant_propagation_c::visit(function_declaration_c *symbol) {
 /* option -> storage method, CONSTANT or <null> */
 // SYM_REF2(function_var_decls_c, option, decl_list)
 // NOTE: function_var_decls_c is only used inside Functions, so it is safe to call with fixed_init_value_ = true 
-void *constant_propagation_c::visit(function_var_decls_c *symbol) {return handle_var_decl(symbol->decl_list, true);}
+void *constant_propagation_c::visit(function_var_decls_c *symbol) {return handle_var_decl(symbol->decl_list, true, is_constant(symbol->option));}
 
 /* intermediate helper symbol for function_var_decls */
 // SYM_LIST(var2_init_decl_list_c) // Not needed since we inherit from iterator_c
@@ -1780,8 +2449,11 @@ void *constant_propagation_c::visit(function_var_decls_c *symbol) {return handle
 //SYM_REF3(function_block_declaration_c, fblock_name, var_declarations, fblock_body, enumvalue_symtable_t enumvalue_symtable;)
 void *constant_propagation_c::visit(function_block_declaration_c *symbol) {
 	map_values_t local_values, *prev_pou_values;
+	map_values_t local_constant_values, *prev_pou_constant_values;
 	prev_pou_values = values; // store the current values map of whoever instantited this FB (a program, configuration, or resource)
+	prev_pou_constant_values = constant_values;
 	values = &local_values;
+	constant_values = &local_constant_values;
 	var_global_values.push(); /* Create inner scope */
 
 	/* Add initial value of all declared variables into Values map. */
@@ -1791,6 +2463,7 @@ void *constant_propagation_c::visit(function_block_declaration_c *symbol) {
 
 	var_global_values.pop(); /* Delete inner scope */
 	values = prev_pou_values;
+	constant_values = prev_pou_constant_values;
 	return NULL;
 }
 
@@ -1814,8 +2487,11 @@ void *constant_propagation_c::visit(non_retentive_var_decls_c *symbol) {return h
 //SYM_REF3(program_declaration_c, program_type_name, var_declarations, function_block_body, enumvalue_symtable_t enumvalue_symtable;)
 void *constant_propagation_c::visit(program_declaration_c *symbol) {
 	map_values_t local_values, *prev_pou_values;
+	map_values_t local_constant_values, *prev_pou_constant_values;
 	prev_pou_values = values; // store the current values map of whoever instantited this Program (a configuration, or resource)
+	prev_pou_constant_values = constant_values;
 	values = &local_values;
+	constant_values = &local_constant_values;
 	var_global_values.push(); /* Create inner scope */
 
 	/* Add initial value of all declared variables into Values map. */
@@ -1825,6 +2501,7 @@ void *constant_propagation_c::visit(program_declaration_c *symbol) {
 
 	var_global_values.pop(); /* Delete inner scope */
 	values = prev_pou_values;
+	constant_values = prev_pou_constant_values;
 	return NULL;
 }
 
@@ -1845,8 +2522,9 @@ END_CONFIGURATION
 // SYM_REF5(configuration_declaration_c, configuration_name, global_var_declarations, resource_declarations, access_declarations, instance_specific_initializations, 
 //          enumvalue_symtable_t enumvalue_symtable; localvar_symbmap_t localvar_symbmap; localvar_symbvec_t localvar_symbvec;)
 void *constant_propagation_c::visit(configuration_declaration_c *symbol) {
-	map_values_t local_values;
+	map_values_t local_values, local_constant_values;
 	values = &local_values;
+	constant_values = &local_constant_values;
 	var_global_values.clear(); /* Clear global variables map */
 
 	/* Add initial value of all declared variables into Values map. */
@@ -1856,6 +2534,7 @@ void *constant_propagation_c::visit(configuration_declaration_c *symbol) {
 	current_configuration = NULL;
 
 	values = NULL;
+	constant_values = NULL;
 	return NULL;
 }
 
@@ -1875,6 +2554,7 @@ END_RESOURCE
 void *constant_propagation_c::visit(resource_declaration_c *symbol) {
 	var_global_values.push(); /* Create inner scope */
 	values->push(); /* Create inner scope */
+	constant_values->push(); /* Create inner scope */
 
 	/* Add initial value of all declared variables into Values map. */
 	function_pou_ = false;
@@ -1887,6 +2567,7 @@ void *constant_propagation_c::visit(resource_declaration_c *symbol) {
 
 	var_global_values.pop(); /* Delete inner scope */
 	values->pop(); /* Delete inner scope */
+	constant_values->pop(); /* Delete inner scope */
 	return NULL;
 }
 
@@ -187,7 +187,7 @@ class constant_folding_c : public iterator_visitor_c {
     void *visit( power_expression_c *symbol);
     void *visit(   neg_expression_c *symbol);
     void *visit(   not_expression_c *symbol);
-    //void *visit(function_invocation_c *symbol); /* TODO */
+    void *visit(function_invocation_c *symbol);
 };
 
 
@@ -212,16 +212,19 @@ class constant_propagation_c : public constant_folding_c {
     symbol_c *current_resource;
     symbol_c *current_configuration;
     map_values_t *values;
+    map_values_t *constant_values; /* the values of the CONSTANT variables only (always known, even without constant propagation) */
     map_values_t var_global_values;
     /* A stack of all the FB declarations currently being recursively constant propagated */
     std::deque<function_block_declaration_c *> fbs_currently_being_visited; // We use a deque instead of stack, so we can search in the stack using direct access to its elements!
 
     void *handle_var_list_decl(symbol_c *var_list, symbol_c *type_decl, bool is_global_var = false);
-    void *handle_var_decl     (symbol_c *var_list, bool fixed_init_value);
+    void *handle_var_decl     (symbol_c *var_list, bool fixed_init_value, bool constant_var = false);
     // Flag to indicate whether the variables in the variable declaration list will always have a fixed value when the POU is executed!
     // VAR CONSTANT ... END_VAR will always be true
     // VAR          ... END_VAR will always be true for functions (who initialise local variables every time they are called), but false for FBs and PROGRAMS
     bool fixed_init_value_; 
+    // Flag to indicate whether the variables in the variable declaration list are CONSTANT variables (VAR CONSTANT, VAR_GLOBAL CONSTANT, VAR_EXTERNAL CONSTANT)
+    bool constant_var_;
     bool function_pou_;
     bool is_constant(symbol_c *option);
     bool is_retain  (symbol_c *option);
@@ -237,9 +240,7 @@ class constant_propagation_c : public constant_folding_c {
     /*********************/
     /* B 1.4 - Variables */
     /*********************/
-    #if DO_CONSTANT_PROPAGATION__
     void *visit(symbolic_variable_c *symbol);
-    #endif // DO_CONSTANT_PROPAGATION__
     void *visit(symbolic_constant_c *symbol);
                              
     /******************************************/
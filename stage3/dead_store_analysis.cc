@@ -0,0 +1,183 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2015  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+
+/*
+ * Dead store analysis:
+ *   - Find the assignments to local variables whose value is always overwritten
+ *     before it is read (see dead_store_analysis.hh).
+ */
+
+
+#include "dead_store_analysis.hh"
+
+
+
+/* Find out how a statement (or expression) uses a variable */
+class variable_use_c: public iterator_visitor_c {
+  private:
+    symbol_c *variable_name;
+
+  public:
+    bool is_used;       /* the variable is referenced (read or written) */
+    bool has_exit;      /* contains an EXIT or RETURN statement */
+    bool has_call;      /* contains a function call */
+
+    variable_use_c(symbol_c *symbol, symbol_c *variable_name_) {
+      variable_name = variable_name_;
+      is_used = has_exit = has_call = false;
+      symbol->accept(*this);
+    }
+
+    void *visit(identifier_c          *symbol) {if ((NULL != variable_name) && (compare_identifiers(symbol, variable_name) == 0)) is_used = true; return NULL;}
+    void *visit(exit_statement_c      *symbol) {has_exit = true; return NULL;}
+    void *visit(return_statement_c    *symbol) {has_exit = true; return NULL;}
+    void *visit(function_invocation_c *symbol) {has_call = true; return iterator_visitor_c::visit(symbol);}
+};
+
+
+/* Find the variables passed to REF() */
+class referenced_variables_c: public iterator_visitor_c {
+  private:
+    std::vector<symbol_c *> &variables;
+
+  public:
+    referenced_variables_c(symbol_c *symbol, std::vector<symbol_c *> &variables_): variables(variables_) {
+      variables.clear();
+      if (NULL != symbol) symbol->accept(*this);
+    }
+
+    void *visit(ref_expression_c *symbol) {
+      symbol_c *name = get_var_name_c::get_name(symbol->exp);
+      if (NULL != name) variables.push_back(name);
+      return NULL;
+    }
+};
+
+
+
+
+annotation_table_c<bool> dead_store_analysis_c::dead_stores;
+
+
+dead_store_analysis_c::dead_store_analysis_c(symbol_c *ignore) {
+  /* forget the annotations of the previous AST (its symbols' ids may be reused, see symbol_c::release_arena()) */
+  dead_stores.clear();
+  search_var_instance_decl = NULL;
+  in_function = false;
+}
+
+
+dead_store_analysis_c::~dead_store_analysis_c(void) {
+}
+
+
+int dead_store_analysis_c::get_error_count() {
+  return 0;
+}
+
+
+/* Returns true if assignments to this variable may be removed when they are dead */
+bool dead_store_analysis_c::is_candidate(symbol_c *variable) {
+  symbolic_variable_c *symbolic_variable = dynamic_cast<symbolic_variable_c *>(variable);
+  if (NULL == symbolic_variable) return false;  /* arrays and structures are not handled */
+  if (!get_datatype_info_c::is_ANY_ELEMENTARY(symbolic_variable->datatype)) return false;
+
+  search_var_instance_decl_c::vt_t vartype = search_var_instance_decl->get_vartype(symbolic_variable);
+  if (!(   (search_var_instance_decl_c::temp_vt == vartype)
+        || ((search_var_instance_decl_c::private_vt == vartype) && in_function)))
+    return false;
+
+  for (unsigned int i = 0; i < referenced_variables.size(); i++)
+    if (compare_identifiers(referenced_variables[i], symbolic_variable->var_name) == 0) return false;
+  return true;
+}
+
+
+void dead_store_analysis_c::analyse(statement_list_c *symbol) {
+  for (int i = 0; i < symbol->n; i++) {
+    assignment_statement_c *assignment = dynamic_cast<assignment_statement_c *>(symbol->get_element(i));
+    if ((NULL == assignment) || !is_candidate(assignment->l_exp)) continue;
+
+    symbol_c *variable_name = ((symbolic_variable_c *)assignment->l_exp)->var_name;
+    variable_use_c value_use(assignment->r_exp, variable_name);
+    if (value_use.has_call) continue;
+
+    for (int j = i + 1; j < symbol->n; j++) {
+      assignment_statement_c *next_assignment = dynamic_cast<assignment_statement_c *>(symbol->get_element(j));
+      if (   (NULL != next_assignment)
+          && (NULL != dynamic_cast<symbolic_variable_c *>(next_assignment->l_exp))
+          && (compare_identifiers(((symbolic_variable_c *)next_assignment->l_exp)->var_name, variable_name) == 0)) {
+        variable_use_c next_value_use(next_assignment->r_exp, variable_name);
+        if (!next_value_use.is_used) dead_stores.set(assignment, true);
+        break;
+      }
+      variable_use_c statement_use(symbol->get_element(j), variable_name);
+      if (statement_use.is_used || statement_use.has_exit) break;
+    }
+  }
+}
+
+
+void dead_store_analysis_c::visit_pou(symbol_c *pou, symbol_c *body, bool is_function) {
+  search_var_instance_decl = new search_var_instance_decl_c(pou);
+  in_function = is_function;
+  referenced_variables_c find_referenced_variables(body, referenced_variables);
+  body->accept(*this);
+  delete search_var_instance_decl;
+  search_var_instance_decl = NULL;
+}
+
+
+/**************************************/
+/* B.1.5 - Program organization units */
+/**************************************/
+void *dead_store_analysis_c::visit(function_declaration_c       *symbol) {visit_pou(symbol, symbol->function_body,       true ); return NULL;}
+void *dead_store_analysis_c::visit(function_block_declaration_c *symbol) {visit_pou(symbol, symbol->fblock_body,         false); return NULL;}
+void *dead_store_analysis_c::visit(program_declaration_c        *symbol) {visit_pou(symbol, symbol->function_block_body, false); return NULL;}
+
+
+/****************************************/
+/* B.2 - Language IL (Instruction List) */
+/****************************************/
+void *dead_store_analysis_c::visit(instruction_list_c *symbol) {return NULL;}
+
+
+/********************/
+/* B 3.2 Statements */
+/********************/
+void *dead_store_analysis_c::visit(statement_list_c *symbol) {
+  analyse(symbol);
+  /* also analyse the statement lists nested inside these statements (IF, CASE, loops) */
+  return iterator_visitor_c::visit(symbol);
+}
+
@@ -0,0 +1,102 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2015  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+
+/*
+ * Dead store analysis:
+ *   - Find the assignments to local variables whose value is always overwritten
+ *     before it is read, and annotate them (see is_dead_store()), so stage 4 does not
+ *     generate code for them.
+ *       For example:
+ *         VAR_TEMP tmp : INT; END_VAR
+ *           tmp := a + b;     <- dead store, tmp is assigned again before being read
+ *           c   := d;
+ *           tmp := a - b;     
+ *           e   := tmp;
+ *
+ *   The analysis is done on each list of ST statements. Only the following assignments are considered:
+ *     - to a variable of an elementary data type, declared in VAR_TEMP, or in the VAR of a FUNCTION.
+ *       (The VAR of FBs and PROGRAMs may be read by the configuration, through access paths.)
+ *     - to a variable that is never passed to REF() (it would then be accessible through a pointer).
+ *     - of an expression without function calls (these may have side effects, so must be executed).
+ *   The assignment is dead if a later statement in the same statement list assigns the variable again, and
+ *   none of the statements in between (nor the value being assigned) reference the variable, nor contain an
+ *   EXIT or RETURN.
+ *
+ *   IL code is not analysed.
+ */
+
+#include "../absyntax_utils/absyntax_utils.hh"
+
+
+
+class dead_store_analysis_c: public iterator_visitor_c {
+
+  private:
+    /* the assignment statements found to be dead stores, in the AST last analysed */
+    static annotation_table_c<bool> dead_stores;
+
+    search_var_instance_decl_c *search_var_instance_decl;
+    bool                        in_function;
+    /* the variables passed to REF() in the current POU */
+    std::vector<symbol_c *>     referenced_variables;
+
+    bool is_candidate(symbol_c *variable);
+    void analyse(statement_list_c *symbol);
+    void visit_pou(symbol_c *pou, symbol_c *body, bool is_function);
+
+  public:
+    dead_store_analysis_c(symbol_c *ignore);
+    virtual ~dead_store_analysis_c(void);
+    int get_error_count();
+
+    /* Returns true if the value of the assignment statement is always overwritten before it is read */
+    static bool is_dead_store(symbol_c *assignment) {return dead_stores.get(assignment);}
+
+    /**************************************/
+    /* B.1.5 - Program organization units */
+    /**************************************/
+    void *visit(function_declaration_c       *symbol);
+    void *visit(function_block_declaration_c *symbol);
+    void *visit(program_declaration_c        *symbol);
+
+    /****************************************/
+    /* B.2 - Language IL (Instruction List) */
+    /****************************************/
+    void *visit(instruction_list_c *symbol);
+
+    /********************/
+    /* B 3.2 Statements */
+    /********************/
+    void *visit(statement_list_c *symbol);
+}; /* dead_store_analysis_c */
+
@@ -51,7 +51,7 @@
 #define STAGE3_ERROR(error_level, symbol1, symbol2, ...) {                                                                  \
   if (current_display_error_level >= error_level) {                                                                         \
     fprintf(stderr, "%s:%d-%d..%d-%d: error: ",                                                                             \
-            FIRST_(symbol1,symbol2)->first_file, FIRST_(symbol1,symbol2)->first_line, FIRST_(symbol1,symbol2)->first_column,\
+            FIRST_(symbol1,symbol2)->first_file.c_str(), FIRST_(symbol1,symbol2)->first_line, FIRST_(symbol1,symbol2)->first_column,\
                                                  LAST_(symbol1,symbol2) ->last_line,  LAST_(symbol1,symbol2) ->last_column);\
     fprintf(stderr, __VA_ARGS__);                                                                                           \
     fprintf(stderr, "\n");                                                                                                  \
@@ -62,7 +62,7 @@
 
 #define STAGE3_WARNING(symbol1, symbol2, ...) {                                                                             \
     fprintf(stderr, "%s:%d-%d..%d-%d: warning: ",                                                                           \
-            FIRST_(symbol1,symbol2)->first_file, FIRST_(symbol1,symbol2)->first_line, FIRST_(symbol1,symbol2)->first_column,\
+            FIRST_(symbol1,symbol2)->first_file.c_str(), FIRST_(symbol1,symbol2)->first_line, FIRST_(symbol1,symbol2)->first_column,\
                                                  LAST_(symbol1,symbol2) ->last_line,  LAST_(symbol1,symbol2) ->last_column);\
     fprintf(stderr, __VA_ARGS__);                                                                                           \
     fprintf(stderr, "\n");                                                                                                  \
@@ -98,6 +98,9 @@ class check_extern_c: public iterator_visitor_c {
     }
         
     ~check_extern_c(void) {}
+
+    /* forget the declarations checked in any AST previously handled (i.e. when compiling several files in one run) */
+    static void reset(void) {checked_decl.clear(); error_count = 0;}
     
     
     
@@ -231,6 +234,7 @@ declaration_check_c::declaration_check_c(symbol_c *ignore) {
   current_pou_decl = NULL;
   current_resource_decl = NULL;
   error_count = 0;
+  check_extern_c::reset();
 }
 
 declaration_check_c::~declaration_check_c(void) {
@@ -493,11 +493,66 @@ void *fill_candidate_datatypes_c::handle_function_call(symbol_c *f_call, symbol_
                                                        std::vector <symbol_c *> *candidate_datatypes,
                                                        std::vector <symbol_c *> *candidate_functions) {
   */
+/* Build the key used to memoise the resolution of a call to an overloaded function.
+ * Which of the overloaded functions are compatible with a call only depends on the name of the function,
+ * and on the candidate datatypes of the parameters being passed (as well as on their names and directions,
+ * in formal calls), so calls with the same key are compatible with the same function declarations.
+ *
+ * Elementary datatypes are identified by their class (any two elementary datatypes of the same class are
+ * equal, see get_datatype_info_c::is_type_equal()), and all others by the symbol that declares them.
+ *
+ * Returns false if the call can not be memoised.
+ */
+bool fill_candidate_datatypes_c::get_overload_key(symbol_c *fcall, generic_function_call_t &fcall_data, std::string &key) {
+	token_c *function_name = dynamic_cast<token_c *>(fcall_data.function_name);
+	if (NULL == function_name) return false;
+	key = function_name->value;
+	for (unsigned int i = 0; i < key.size(); i++) key[i] = toupper(key[i]);
+	key += '(';
+
+	function_call_param_iterator_c fcp_iterator(fcall);
+	bool formal_call = (NULL != fcall_data.formal_operand_list);
+	if (formal_call) key += 'F';
+	while (true) {
+		symbol_c *param_value;
+		if (!formal_call) {
+			if (NULL == (param_value = fcp_iterator.next_nf())) break;
+		} else {
+			symbol_c *param_name = fcp_iterator.next_f();
+			if (NULL == param_name) break;
+			token_c *name = dynamic_cast<token_c *>(param_name);
+			if (NULL == name) return false;
+			if (NULL == (param_value = fcp_iterator.get_current_value())) return false;
+			key += (function_call_param_iterator_c::assign_out == fcp_iterator.get_assign_direction())? '>' : '=';
+			key += name->value;
+			key += '\0';
+		}
+		std::vector <symbol_c *> &datatypes = param_value->candidate_datatypes;
+		uint32_t count = datatypes.size();
+		key.append((const char *)&count, sizeof(count));
+		for (unsigned int i = 0; i < datatypes.size(); i++) {
+			if (get_datatype_info_c::is_ANY_ELEMENTARY_compatible(datatypes[i])) {
+				key += 'E';
+				key += datatypes[i]->absyntax_cname();
+				key += '\0';
+			} else {
+				key += 'P';
+				key.append((const char *)&datatypes[i], sizeof(datatypes[i]));
+			}
+		}
+	}
+	key += ')';
+	return true;
+}
+
+
 void fill_candidate_datatypes_c::handle_function_call(symbol_c *fcall, generic_function_call_t fcall_data) {
 	function_declaration_c *f_decl;
 	list_c *parameter_list;
 	list_c *parameter_candidate_datatypes;
 	symbol_c *returned_parameter_type;
+	std::string key;
+	bool memoise = false;
 
 	if (debug) std::cout << "function()\n";
 
@@ -527,6 +582,23 @@ void fill_candidate_datatypes_c::handle_function_call(symbol_c *fcall, generic_f
 			fcall_data.candidate_functions.push_back(f_decl);
 		
 	}
+	else {
+		/* Overloaded function (e.g. ADD, MUL, SEL, ..., *_TO_*). Has a call with the same parameter datatypes already been resolved? */
+		memoise = get_overload_key(fcall, fcall_data, key);
+		overload_cache_t::iterator cached = memoise? overload_cache.find(key) : overload_cache.end();
+		if (cached != overload_cache.end()) {
+			for (unsigned int i = 0; i < cached->second.size(); i++) {
+				f_decl = cached->second[i];
+				returned_parameter_type = base_type(f_decl->type_name);		
+				if (add_datatype_to_candidate_list(fcall, returned_parameter_type))
+					fcall_data.candidate_functions.push_back(f_decl);
+			}
+			if (debug) std::cout << "end_function() [" << fcall->candidate_datatypes.size() << "] result (memoised).\n";
+			return;
+		}
+	}
+
+	std::vector<function_declaration_c *> compatible_decls;
 	for(; lower != upper; lower++) {
 		bool compatible = false;
 		
@@ -535,6 +607,7 @@ void fill_candidate_datatypes_c::handle_function_call(symbol_c *fcall, generic_f
 		if (NULL != fcall_data.nonformal_operand_list) compatible=match_nonformal_call(fcall, f_decl);
 		if (NULL != fcall_data.   formal_operand_list) compatible=   match_formal_call(fcall, f_decl);
 		if (compatible) {
+			compatible_decls.push_back(f_decl);
 			/* Add the data type returned by the called functions. 
 			 * However, only do this if this data type is not already present in the candidate_datatypes list_c
 			 */
@@ -544,6 +617,8 @@ void fill_candidate_datatypes_c::handle_function_call(symbol_c *fcall, generic_f
 				fcall_data.candidate_functions.push_back(f_decl);
 		}
 	}
+	if (memoise)
+		overload_cache[key] = compatible_decls;
 	if (debug) std::cout << "end_function() [" << fcall->candidate_datatypes.size() << "] result.\n";
 	return;
 }
@@ -690,6 +765,8 @@ symbol_c *fill_candidate_datatypes_c::base_type(symbol_c *symbol) {
 /***************************/
 /* main entry function! */
 void *fill_candidate_datatypes_c::visit(library_c *symbol) {
+	/* forget the enumeration constants of any AST previously handled (i.e. when compiling several files in one run) */
+	global_enumerated_value_symtable.reset();
 	symbol->accept(populate_globalenumvalue_symtable);
 	/* Now let the base class iterator_visitor_c iterate through all the library elements */
 	return iterator_visitor_c::visit(symbol);  
@@ -50,6 +50,9 @@
  */
 
 
+#include <map>
+#include <string>
+#include <vector>
 #include "../absyntax_utils/absyntax_utils.hh"
 #include "datatype_functions.hh"
 
@@ -91,6 +94,11 @@ class fill_candidate_datatypes_c: public iterator_visitor_c {
     bool  match_nonformal_call(symbol_c *f_call, symbol_c *f_decl);
     bool  match_formal_call   (symbol_c *f_call, symbol_c *f_decl, symbol_c **first_param_datatype = NULL);
     void  handle_function_call(symbol_c *fcall, generic_function_call_t fcall_data);
+
+    /* The function declarations found to be compatible with previous calls to overloaded functions (see handle_function_call()) */
+    typedef std::map<std::string, std::vector<function_declaration_c *> > overload_cache_t;
+    overload_cache_t overload_cache;
+    bool  get_overload_key    (symbol_c *fcall, generic_function_call_t &fcall_data, std::string &key);
     void *handle_implicit_il_fb_call(symbol_c *il_instruction, const char *param_name,   symbol_c *&called_fb_declaration);
     void *handle_S_and_R_operator   (symbol_c *symbol,         const char *operator_str, symbol_c *&called_fb_declaration);
     void *handle_equality_comparison(const struct widen_entry widen_table[], symbol_c *symbol, symbol_c *l_expr, symbol_c *r_expr);
@@ -0,0 +1,229 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2015  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+
+/*
+ * Idempotent FB analysis:
+ *   - Find the FUNCTION_BLOCKs whose outputs only depend on the values of their inputs
+ *     (see idempotent_fb_analysis.hh).
+ */
+
+
+#include "idempotent_fb_analysis.hh"
+#include <strings.h>
+
+
+
+annotation_table_c<bool> idempotent_fb_analysis_c::idempotent_fbs;
+
+
+idempotent_fb_analysis_c::idempotent_fb_analysis_c(symbol_c *ignore) {
+  /* forget the annotations of the previous AST (its symbols' ids may be reused, see symbol_c::release_arena()) */
+  idempotent_fbs.clear();
+  search_var_instance_decl = NULL;
+  in_function = false;
+  idempotent = false;
+  pure_functions = new std::map<symbol_c *, bool>;
+  owns_pure_functions = true;
+}
+
+
+/* The analysis of a FUNCTION called by the POU being analysed */
+idempotent_fb_analysis_c::idempotent_fb_analysis_c(std::map<symbol_c *, bool> *pure_functions_, symbol_c *pou, bool is_function) {
+  search_var_instance_decl = new search_var_instance_decl_c(pou);
+  in_function = is_function;
+  idempotent = false;
+  pure_functions = pure_functions_;
+  owns_pure_functions = false;
+}
+
+
+idempotent_fb_analysis_c::~idempotent_fb_analysis_c(void) {
+  delete search_var_instance_decl;
+  if (owns_pure_functions) delete pure_functions;
+}
+
+
+int idempotent_fb_analysis_c::get_error_count() {
+  return 0;
+}
+
+
+/* Returns true if the body only uses the variables as described in idempotent_fb_analysis.hh */
+bool idempotent_fb_analysis_c::analyse(symbol_c *body) {
+  /* only ST is analysed */
+  if (NULL == dynamic_cast<statement_list_c *>(body)) return false;
+  idempotent = true;
+  body->accept(*this);
+  return idempotent;
+}
+
+
+bool idempotent_fb_analysis_c::is_pure_function(symbol_c *f_decl) {
+  function_declaration_c *function = dynamic_cast<function_declaration_c *>(f_decl);
+  if (NULL == function) return false;
+  std::map<symbol_c *, bool>::iterator known = pure_functions->find(function);
+  if (known != pure_functions->end()) return known->second;
+
+  /* FUNCTIONs may not be recursive, but we do not want to loop forever if one is */
+  (*pure_functions)[function] = false;
+  idempotent_fb_analysis_c function_analysis(pure_functions, function, true);
+  bool pure = function_analysis.analyse(function->function_body);
+  (*pure_functions)[function] = pure;
+  return pure;
+}
+
+
+/* The variable is written to (as opposed to being read) */
+void idempotent_fb_analysis_c::write(symbol_c *variable) {
+  array_variable_c      *array_variable      = dynamic_cast<array_variable_c      *>(variable);
+  structured_variable_c *structured_variable = dynamic_cast<structured_variable_c *>(variable);
+  symbolic_variable_c   *symbolic_variable   = dynamic_cast<symbolic_variable_c   *>(variable);
+
+  if (NULL != array_variable) {
+    /* the subscripts are read */
+    array_variable->subscript_list->accept(*this);
+    write(array_variable->subscripted_variable);
+    return;
+  }
+  if (NULL != structured_variable) {
+    write(structured_variable->record_variable);
+    return;
+  }
+  if (NULL == symbolic_variable) {idempotent = false; return;}  /* e.g. a dereferenced pointer */
+
+  search_var_instance_decl_c::vt_t vartype = search_var_instance_decl->get_vartype(symbolic_variable);
+  if (in_function) {
+    /* the variables of a FUNCTION only live during the call (the VAR_IN_OUT are read by the caller) */
+    if (   (search_var_instance_decl_c::external_vt == vartype)
+        || (search_var_instance_decl_c::global_vt   == vartype)
+        || (search_var_instance_decl_c::located_vt  == vartype)
+        || (NULL == search_var_instance_decl->get_decl(symbolic_variable)))
+      idempotent = false;
+    return;
+  }
+
+  if (search_var_instance_decl_c::output_vt == vartype) {
+    /* ENO is also set by the code controlling the execution of the FB, whenever the body is called */
+    token_c *name = get_var_name_c::get_name(symbolic_variable);
+    if ((NULL == name) || (strcasecmp(name->value, "ENO") == 0)) idempotent = false;
+    return;
+  }
+  if (   (search_var_instance_decl_c::input_vt == vartype)
+      || (search_var_instance_decl_c::temp_vt  == vartype))
+    return;
+  idempotent = false;
+}
+
+
+/**************************************/
+/* B.1.5 - Program organization units */
+/**************************************/
+/* the FUNCTIONs are only analysed when called from a FUNCTION_BLOCK */
+void *idempotent_fb_analysis_c::visit(function_declaration_c       *symbol) {return NULL;}
+void *idempotent_fb_analysis_c::visit(program_declaration_c        *symbol) {return NULL;}
+
+void *idempotent_fb_analysis_c::visit(function_block_declaration_c *symbol) {
+  search_var_instance_decl = new search_var_instance_decl_c(symbol);
+  in_function = false;
+  idempotent_fbs.set(symbol, analyse(symbol->fblock_body));
+  delete search_var_instance_decl;
+  search_var_instance_decl = NULL;
+  return NULL;
+}
+
+
+/*********************/
+/* B 1.4 - Variables */
+/*********************/
+/* any variable that is read */
+void *idempotent_fb_analysis_c::visit(symbolic_variable_c *symbol) {
+  if (NULL == search_var_instance_decl) ERROR;
+  search_var_instance_decl_c::vt_t vartype = search_var_instance_decl->get_vartype(symbol);
+  if (in_function) {
+    write(symbol);  /* the same variables may be read and written */
+    return NULL;
+  }
+  if (   (search_var_instance_decl_c::input_vt == vartype)
+      || (search_var_instance_decl_c::temp_vt  == vartype))
+    return NULL;
+  if (   (search_var_instance_decl_c::private_vt    == vartype)
+      && (search_var_instance_decl_c::constant_opt  == search_var_instance_decl->get_option(symbol)))
+    return NULL;
+  /* the outputs keep the value of the previous call, and the other variables may have been changed since */
+  idempotent = false;
+  return NULL;
+}
+
+void *idempotent_fb_analysis_c::visit(direct_variable_c *symbol) {idempotent = false; return NULL;}
+
+
+/********************/
+/* 2.1.6 - Pragmas  */
+/********************/
+/* embedded C code, that may do anything */
+void *idempotent_fb_analysis_c::visit(pragma_c *symbol) {idempotent = false; return NULL;}
+
+
+/***************************************/
+/* B.3 - Language ST (Structured Text) */
+/***************************************/
+void *idempotent_fb_analysis_c::visit(ref_expression_c   *symbol) {idempotent = false; return NULL;}
+void *idempotent_fb_analysis_c::visit(deref_expression_c *symbol) {idempotent = false; return NULL;}
+void *idempotent_fb_analysis_c::visit(deref_operator_c   *symbol) {idempotent = false; return NULL;}
+
+void *idempotent_fb_analysis_c::visit(function_invocation_c *symbol) {
+  if (!is_pure_function(symbol->called_function_declaration)) {idempotent = false; return NULL;}
+  /* the values passed to the function are read, except those of the output parameters (see below) */
+  if (NULL != symbol->formal_param_list)    symbol->formal_param_list   ->accept(*this);
+  if (NULL != symbol->nonformal_param_list) symbol->nonformal_param_list->accept(*this);
+  return NULL;
+}
+
+
+/********************/
+/* B 3.2 Statements */
+/********************/
+void *idempotent_fb_analysis_c::visit(assignment_statement_c *symbol) {
+  write(symbol->l_exp);
+  symbol->r_exp->accept(*this);
+  return NULL;
+}
+
+/* the FB instances keep their own state */
+void *idempotent_fb_analysis_c::visit(fb_invocation_c *symbol) {idempotent = false; return NULL;}
+
+/* [NOT] variable_name '=>' variable */
+void *idempotent_fb_analysis_c::visit(output_variable_param_assignment_c *symbol) {
+  write(symbol->variable);
+  return NULL;
+}
@@ -0,0 +1,117 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2015  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+
+/*
+ * Idempotent FB analysis:
+ *   - Find the FUNCTION_BLOCKs whose outputs only depend on the values of their inputs, and annotate
+ *     their declaration (see is_idempotent_fb()). Calling an instance of such a FB again, with the
+ *     same values in its inputs, leaves its outputs unchanged, so stage 4 may skip its body (see -O I).
+ *
+ *   A FB is idempotent if its body is written in ST, and it only:
+ *     - reads its VAR_INPUT, VAR_TEMP and VAR CONSTANT variables (and never reads its VAR_OUTPUT);
+ *     - writes its VAR_INPUT, VAR_OUTPUT (except ENO) and VAR_TEMP variables;
+ *     - calls FUNCTIONs that are themselves free of side effects, i.e. written in ST, only accessing their
+ *       own variables, and only calling such FUNCTIONs (the standard functions all are).
+ *   The body may not contain any pragma (i.e. embedded C code, which also is how the standard timers read
+ *   __CURRENT_TIME), FB call, directly represented variable, REF() nor dereference.
+ *
+ *   Since the outputs are never read, the value of each output after the body ran is either one that only
+ *   depends on the inputs, or the value it had before (when the body did not assign it), so running the body
+ *   a second time with the same inputs does not change them.
+ *
+ *   IL and SFC bodies are not analysed.
+ */
+
+#include "../absyntax_utils/absyntax_utils.hh"
+
+
+
+class idempotent_fb_analysis_c: public iterator_visitor_c {
+
+  private:
+    /* the FUNCTION_BLOCK declarations found to be idempotent, in the AST last analysed */
+    static annotation_table_c<bool> idempotent_fbs;
+
+    search_var_instance_decl_c *search_var_instance_decl;
+    bool                        in_function;
+    bool                        idempotent;
+    /* the FUNCTIONs already analysed, and whether they are free of side effects (shared with the analysis of the called FUNCTIONs) */
+    std::map<symbol_c *, bool> *pure_functions;
+    bool                        owns_pure_functions;
+
+    idempotent_fb_analysis_c(std::map<symbol_c *, bool> *pure_functions_, symbol_c *pou, bool is_function);
+    bool analyse(symbol_c *body);
+    bool is_pure_function(symbol_c *f_decl);
+    void write(symbol_c *variable);
+
+  public:
+    idempotent_fb_analysis_c(symbol_c *ignore);
+    virtual ~idempotent_fb_analysis_c(void);
+    int get_error_count();
+
+    /* Returns true if the outputs of the FUNCTION_BLOCK (declaration) only depend on the values of its inputs */
+    static bool is_idempotent_fb(symbol_c *fb_decl) {return idempotent_fbs.get(fb_decl);}
+
+    /**************************************/
+    /* B.1.5 - Program organization units */
+    /**************************************/
+    void *visit(function_declaration_c       *symbol);
+    void *visit(function_block_declaration_c *symbol);
+    void *visit(program_declaration_c        *symbol);
+
+    /*********************/
+    /* B 1.4 - Variables */
+    /*********************/
+    void *visit(symbolic_variable_c *symbol);
+    void *visit(direct_variable_c   *symbol);
+
+    /********************/
+    /* 2.1.6 - Pragmas  */
+    /********************/
+    void *visit(pragma_c *symbol);
+
+    /***************************************/
+    /* B.3 - Language ST (Structured Text) */
+    /***************************************/
+    void *visit(ref_expression_c      *symbol);
+    void *visit(deref_expression_c    *symbol);
+    void *visit(deref_operator_c      *symbol);
+    void *visit(function_invocation_c *symbol);
+
+    /********************/
+    /* B 3.2 Statements */
+    /********************/
+    void *visit(assignment_statement_c             *symbol);
+    void *visit(fb_invocation_c                    *symbol);
+    void *visit(output_variable_param_assignment_c *symbol);
+}; /* idempotent_fb_analysis_c */
@@ -0,0 +1,171 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+/*
+ * Incremental checking of the POUs, when checking the same file over and over without generating any code.
+ * 
+ * See the comments in incremental_check.hh for more details.
+ */
+
+#include "incremental_check.hh"
+#include "../main.hh" // required for ERROR() and ERROR_MSG() macros.
+#include "../absyntax/visitor.hh"
+#include "../absyntax_utils/absyntax_utils.hh"
+#include <string.h>
+#include <ctype.h>
+
+
+
+/* A fingerprint (64 bit FNV-1a hash) of the classes and values of all the symbols of a sub-tree.
+ * The locations of the symbols are not included, so a POU does not change if it was only moved within the file.
+ */
+class check_fingerprint_c: public fcall_iterator_visitor_c {
+  private:
+    uint64_t hash;
+
+  public:
+    check_fingerprint_c(void) {hash = 14695981039346656037ULL;}
+    uint64_t get(void) {return hash;}
+
+    void add(const void *data, size_t len) {
+      for (size_t i = 0; i < len; i++) {
+        hash ^= ((const unsigned char *)data)[i];
+        hash *= 1099511628211ULL;
+      }
+    }
+    void add(const char *str) {if (NULL != str) add(str, strlen(str) + 1); else add("", 1);}
+    void add(symbol_c *symbol) {if (NULL != symbol) symbol->accept(*this); else add("NULL");}
+
+    void prefix_fcall(symbol_c *symbol) {
+      add(symbol->absyntax_cname());
+      token_c *token = dynamic_cast<token_c *>(symbol);
+      if (NULL != token) add(token->value);
+    }
+    void suffix_fcall(symbol_c *symbol) {add(")");}
+};
+
+
+/* Add everything a POU is checked against to the fingerprint, i.e. everything in the library except the bodies of the POUs */
+static void add_context(check_fingerprint_c &fingerprint, list_c *library) {
+  bool options[] = {runtime_options.allow_void_datatype,     runtime_options.allow_missing_var_in,
+                    runtime_options.disable_implicit_en_eno, runtime_options.safe_extensions,
+                    runtime_options.conversion_functions,    runtime_options.ref_standard_extensions,
+                    runtime_options.ref_nonstand_extensions, runtime_options.nonliteral_in_array_size,
+                    runtime_options.relaxed_datatype_model};
+  fingerprint.add(options, sizeof(options));
+  for (int i = 0; i < library->n; i++) {
+    symbol_c *element = library->get_element(i);
+    function_declaration_c       *f_decl  = dynamic_cast<function_declaration_c       *>(element);
+    function_block_declaration_c *fb_decl = dynamic_cast<function_block_declaration_c *>(element);
+    program_declaration_c        *p_decl  = dynamic_cast<program_declaration_c        *>(element);
+    if      (NULL != f_decl)  {fingerprint.add(f_decl ->derived_function_name); fingerprint.add(f_decl->type_name); fingerprint.add(f_decl->var_declarations_list);}
+    else if (NULL != fb_decl) {fingerprint.add(fb_decl->fblock_name);           fingerprint.add(fb_decl->var_declarations);}
+    else if (NULL != p_decl)  {fingerprint.add(p_decl ->program_type_name);     fingerprint.add(p_decl->var_declarations);}
+    else                      {fingerprint.add(element);}
+  }
+}
+
+
+/* The name of the POU, and the file it is declared in (the same file may declare it again, after an edit) */
+static std::string pou_key(symbol_c *pou, const char *name) {
+  std::string key = (NULL == pou->first_file)? "" : pou->first_file.c_str();
+  key += ":";
+  for (const char *c = name; *c != '\0'; c++) key += toupper(*c);
+  return key;
+}
+
+
+/* A copy of the POU, with an empty body */
+static symbol_c *new_empty_pou(symbol_c *pou) {
+  function_declaration_c       *f_decl  = dynamic_cast<function_declaration_c       *>(pou);
+  function_block_declaration_c *fb_decl = dynamic_cast<function_block_declaration_c *>(pou);
+  program_declaration_c        *p_decl  = dynamic_cast<program_declaration_c        *>(pou);
+  /* NOTE: the copy keeps all the annotations (and the location in the source code) */
+  if (NULL != f_decl)  {f_decl  = new function_declaration_c      (*f_decl);  f_decl ->function_body       = new statement_list_c(); return f_decl; }
+  if (NULL != fb_decl) {fb_decl = new function_block_declaration_c(*fb_decl); fb_decl->fblock_body         = new statement_list_c(); return fb_decl;}
+  if (NULL != p_decl)  {p_decl  = new program_declaration_c       (*p_decl);  p_decl ->function_block_body = new statement_list_c(); return p_decl; }
+  ERROR;
+  return NULL;
+}
+
+
+
+std::map<std::string, uint64_t>                incremental_check_c::clean_pous;
+uint64_t                                       incremental_check_c::clean_context = 0;
+std::vector<std::pair<std::string, uint64_t> > incremental_check_c::checked_pous;
+
+
+symbol_c *incremental_check_c::create_new_tree(symbol_c *tree, int first_pou) {
+  checked_pous.clear();
+  library_c *old_tree = dynamic_cast<library_c *>(tree);
+  if (NULL == old_tree) return tree;
+
+  check_fingerprint_c context;
+  add_context(context, old_tree);
+  if (context.get() != clean_context) {
+    /* all the POUs must be checked again */
+    clean_pous.clear();
+    clean_context = context.get();
+  }
+
+  library_c *new_tree = new library_c;
+  *((symbol_c *)new_tree) = *((symbol_c *)tree); // copy any annotations from tree to new_tree;
+  new_tree->clear(); // remove all elements from list.
+  bool changed = false;
+  for (int i = 0; i < old_tree->n; i++) {
+    symbol_c *element = old_tree->get_element(i);
+    if (   (i >= first_pou)
+        && (   (NULL != dynamic_cast<function_declaration_c       *>(element))
+            || (NULL != dynamic_cast<function_block_declaration_c *>(element))
+            || (NULL != dynamic_cast<program_declaration_c        *>(element)))) {
+      check_fingerprint_c fingerprint;
+      fingerprint.add(element);
+      std::string key = pou_key(element, get_datatype_info_c::get_id_str(element));
+      std::map<std::string, uint64_t>::iterator clean = clean_pous.find(key);
+      if ((clean != clean_pous.end()) && (clean->second == fingerprint.get())) {
+        element = new_empty_pou(element);
+        changed = true;
+      } else {
+        checked_pous.push_back(std::make_pair(key, fingerprint.get()));
+      }
+    }
+    new_tree->add_element(element);
+  }
+  return changed? new_tree : tree;
+}
+
+
+void incremental_check_c::set_clean(void) {
+  for (unsigned int i = 0; i < checked_pous.size(); i++)
+    clean_pous[checked_pous[i].first] = checked_pous[i].second;
+  checked_pous.clear();
+}
@@ -0,0 +1,75 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+/*
+ * Incremental checking of the POUs (-k command line option, i.e. when only looking for errors in the
+ * input file, without generating any code), for IDEs that check the same project over and over with
+ * the compile server (-S command line option), after each change made by the user.
+ * 
+ * The POUs (FUNCTIONs, FUNCTION_BLOCKs and PROGRAMs) of the input file found to be error free are
+ * remembered, along with a fingerprint of their contents and a fingerprint of the context they were
+ * checked in: the declarations of all the POUs (but not their bodies), the datatypes, and the
+ * configurations. The next time the same file is checked, the POUs with the same fingerprints (i.e. the
+ * POUs that have not been changed, when only the bodies of other POUs were) keep their declarations
+ * in the tree handed to the stage 3 passes, but their bodies are replaced by empty ones. Any change to
+ * the context (e.g. to the parameters of a FUNCTION) has all the POUs checked again.
+ * 
+ * As is done by remove_unused_pous_c, the original abstract syntax tree (AST) is not changed: the
+ * new library_c object points to the *same* objects of the original AST, except for the new objects
+ * of the POUs whose body is not checked (that point to the same name and variable declarations).
+ * The bodies that are not checked get no stage 3 annotations, so no code may be generated from that AST!
+ */
+
+#include "../absyntax/absyntax.hh"
+#include <map>
+#include <string>
+#include <vector>
+
+
+class incremental_check_c {
+
+  private:
+    /* the POUs found to be error free, with the fingerprint of their contents, all with the same context */
+    static std::map<std::string, uint64_t>                clean_pous;
+    static uint64_t                                       clean_context;
+    /* the POUs whose body is checked in the tree last created */
+    static std::vector<std::pair<std::string, uint64_t> > checked_pous;
+
+  public:
+    /* create a new tree where the POUs starting with element first_pou that were already found to have no errors
+     * have an empty body (or return the old tree, if no such POUs are found)
+     */
+    static symbol_c *create_new_tree(symbol_c *old_tree, int first_pou);
+    /* the stage 3 passes found no error in the tree last created */
+    static void      set_clean(void);
+
+};   /* class incremental_check_c */
@@ -0,0 +1,377 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2015  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+
+/*
+ * Independent networks analysis:
+ *   - Split the statements of each PROGRAM body into networks that access no variable written by
+ *     another network (see independent_networks_analysis.hh).
+ */
+
+
+#include "independent_networks_analysis.hh"
+#include <ctype.h>
+#include <string.h>
+#include <vector>
+
+
+/* the key of all the located and directly represented variables */
+#define LOCATED_KEY "%"
+/* the prefix of the keys of the global variables */
+#define GLOBAL_PREFIX "::"
+
+
+/* The groups of statements connected by conflicts (union-find) */
+static int find_network(std::vector<int> &network, int stmt) {
+  while (network[stmt] != stmt) stmt = network[stmt] = network[network[stmt]];
+  return stmt;
+}
+
+static void join_networks(std::vector<int> &network, int a, int b) {
+  a = find_network(network, a);
+  b = find_network(network, b);
+  /* the network is named after its first statement */
+  if (a < b) network[b] = a;
+  if (b < a) network[a] = b;
+}
+
+
+/* The pragma of the standard timers (and RTC), that copies the current time into a variable of the FB instance:
+ *   {__SET_VAR(data__->,CURRENT_TIME,,__CURRENT_TIME)}
+ */
+static bool is_current_time_pragma(const char *value) {
+  static const char prefix[] = "{__SET_VAR(data__->,";
+  static const char suffix[] = ",,__CURRENT_TIME)}";
+  std::string code;
+  for (const char *c = value; *c != '\0'; c++)
+    if (!isspace((unsigned char)*c)) code += *c;
+  if (code.size() <= strlen(prefix) + strlen(suffix)) return false;
+  if (code.compare(0, strlen(prefix), prefix) != 0) return false;
+  if (code.compare(code.size() - strlen(suffix), strlen(suffix), suffix) != 0) return false;
+  for (size_t i = strlen(prefix); i < code.size() - strlen(suffix); i++)
+    if (!isalnum((unsigned char)code[i]) && (code[i] != '_')) return false;
+  return true;
+}
+
+
+
+annotation_table_c<int> independent_networks_analysis_c::networks;
+
+
+independent_networks_analysis_c::independent_networks_analysis_c(symbol_c *ignore) {
+  /* forget the annotations of the previous AST (its symbols' ids may be reused, see symbol_c::release_arena()) */
+  networks.clear();
+  search_var_instance_decl = NULL;
+  in_program = false;
+  accesses = NULL;
+  pou_accesses = new std::map<symbol_c *, access_set_t>;
+  owns_pou_accesses = true;
+}
+
+
+/* The analysis of a FUNCTION or FB called by the PROGRAM being analysed */
+independent_networks_analysis_c::independent_networks_analysis_c(std::map<symbol_c *, access_set_t> *pou_accesses_, symbol_c *pou) {
+  search_var_instance_decl = new search_var_instance_decl_c(pou);
+  in_program = false;
+  accesses = NULL;
+  pou_accesses = pou_accesses_;
+  owns_pou_accesses = false;
+}
+
+
+independent_networks_analysis_c::~independent_networks_analysis_c(void) {
+  delete search_var_instance_decl;
+  if (owns_pou_accesses) delete pou_accesses;
+}
+
+
+int independent_networks_analysis_c::get_error_count() {
+  return 0;
+}
+
+
+/* Annotate the top level statements of the body with their network */
+void independent_networks_analysis_c::analyse_program(program_declaration_c *program, statement_list_c *body) {
+  std::vector<access_set_t> stmt_accesses(body->n);
+  std::vector<int>          network(body->n);
+  bool                      single_network = false;
+
+  search_var_instance_decl = new search_var_instance_decl_c(program);
+  in_program = true;
+  for (int i = 0; i < body->n; i++) {
+    stmt_accesses[i].unknown = false;
+    accesses = &stmt_accesses[i];
+    body->get_element(i)->accept(*this);
+    if (accesses->unknown) single_network = true;
+    network[i] = i;
+  }
+  accesses = NULL;
+  delete search_var_instance_decl;
+  search_var_instance_decl = NULL;
+
+  /* the statements accessing each variable, and whether they write it */
+  std::map<std::string, std::vector<std::pair<int, bool> > > stmts;
+  for (int i = 0; i < body->n && !single_network; i++) {
+    std::set<std::string>::iterator key;
+    for (key = stmt_accesses[i].reads.begin();  key != stmt_accesses[i].reads.end();  key++) stmts[*key].push_back(std::make_pair(i, false));
+    for (key = stmt_accesses[i].writes.begin(); key != stmt_accesses[i].writes.end(); key++) stmts[*key].push_back(std::make_pair(i, true));
+  }
+
+  std::map<std::string, std::vector<std::pair<int, bool> > >::iterator var;
+  std::vector<std::pair<int, bool> > &located = stmts[LOCATED_KEY];
+  for (var = stmts.begin(); var != stmts.end(); var++) {
+    int writer = -1;
+    for (unsigned int j = 0; j < var->second.size(); j++)
+      if (var->second[j].second) writer = var->second[j].first;
+    if (writer >= 0)
+      for (unsigned int j = 0; j < var->second.size(); j++) join_networks(network, writer, var->second[j].first);
+
+    /* a global variable may also be located */
+    if (var->first.compare(0, strlen(GLOBAL_PREFIX), GLOBAL_PREFIX) != 0) continue;
+    for (unsigned int j = 0; j < var->second.size(); j++)
+      for (unsigned int k = 0; k < located.size(); k++)
+        if (var->second[j].second || located[k].second) join_networks(network, var->second[j].first, located[k].first);
+  }
+
+  /* number the networks in the order of their first statement */
+  int count = 0;
+  std::map<int, int> number;
+  for (int i = 0; i < body->n; i++) {
+    int first = single_network? 0 : find_network(network, i);
+    if (number.find(first) == number.end()) number[first] = count++;
+    networks.set(body->get_element(i), number[first]);
+  }
+  networks.set(body, count);
+}
+
+
+/* The global variables accessed by the called FUNCTION or FB (and by the POUs it calls) are also accessed by the caller */
+void independent_networks_analysis_c::analyse_call(symbol_c *pou_decl) {
+  function_declaration_c       *function       = dynamic_cast<function_declaration_c       *>(pou_decl);
+  function_block_declaration_c *function_block = dynamic_cast<function_block_declaration_c *>(pou_decl);
+  symbol_c                     *pou_body       = NULL;
+  if (NULL != function)       pou_body = function      ->function_body;
+  if (NULL != function_block) pou_body = function_block->fblock_body;
+  if (NULL == pou_body) {accesses->unknown = true; return;}
+
+  std::map<symbol_c *, access_set_t>::iterator known = pou_accesses->find(pou_decl);
+  if (known == pou_accesses->end()) {
+    /* FUNCTIONs and FBs may not be recursive, but we do not want to loop forever if one is */
+    (*pou_accesses)[pou_decl].unknown = true;
+    access_set_t pou_access_set;
+    pou_access_set.unknown = (NULL == dynamic_cast<statement_list_c *>(pou_body));  /* only ST is analysed */
+    if (!pou_access_set.unknown) {
+      independent_networks_analysis_c pou_analysis(pou_accesses, pou_decl);
+      pou_analysis.accesses = &pou_access_set;
+      pou_body->accept(pou_analysis);
+    }
+    known = pou_accesses->find(pou_decl);
+    known->second = pou_access_set;
+  }
+
+  accesses->reads .insert(known->second.reads .begin(), known->second.reads .end());
+  accesses->writes.insert(known->second.writes.begin(), known->second.writes.end());
+  if (known->second.unknown) accesses->unknown = true;
+}
+
+
+/* The key of the variable, or "" if it only lives in the current call of the FUNCTION or FB being analysed */
+std::string independent_networks_analysis_c::get_key(symbolic_variable_c *variable) {
+  token_c *name = get_var_name_c::get_name(variable);
+  if (NULL == name) {accesses->unknown = true; return "";}
+
+  /* the identifiers are not case sensitive */
+  std::string key;
+  for (const char *c = name->value; *c != '\0'; c++) key += toupper((unsigned char)*c);
+
+  switch (search_var_instance_decl->get_vartype(variable)) {
+    case search_var_instance_decl_c::external_vt:
+    case search_var_instance_decl_c::global_vt:
+      return GLOBAL_PREFIX + key;
+    case search_var_instance_decl_c::located_vt:
+      return LOCATED_KEY;
+    case search_var_instance_decl_c::inoutput_vt:
+      /* may point to any variable of the caller (the variables passed to a FB or FUNCTION are written by the caller) */
+      return in_program? LOCATED_KEY : "";
+    default:
+      return in_program? key : "";
+  }
+}
+
+
+/* The variable is read */
+void independent_networks_analysis_c::read(symbol_c *variable) {
+  symbolic_variable_c *symbolic_variable = dynamic_cast<symbolic_variable_c *>(variable);
+  if (NULL == symbolic_variable) {accesses->unknown = true; return;}
+  std::string key = get_key(symbolic_variable);
+  if (!key.empty()) accesses->reads.insert(key);
+}
+
+
+/* The variable is written to (as opposed to being read) */
+void independent_networks_analysis_c::write(symbol_c *variable) {
+  array_variable_c      *array_variable      = dynamic_cast<array_variable_c      *>(variable);
+  structured_variable_c *structured_variable = dynamic_cast<structured_variable_c *>(variable);
+  symbolic_variable_c   *symbolic_variable   = dynamic_cast<symbolic_variable_c   *>(variable);
+  direct_variable_c     *direct_variable     = dynamic_cast<direct_variable_c     *>(variable);
+
+  if (NULL != array_variable) {
+    /* the subscripts are read */
+    array_variable->subscript_list->accept(*this);
+    write(array_variable->subscripted_variable);
+    return;
+  }
+  if (NULL != structured_variable) {
+    write(structured_variable->record_variable);
+    return;
+  }
+  if (NULL != direct_variable) {accesses->writes.insert(LOCATED_KEY); return;}
+  if (NULL == symbolic_variable) {accesses->unknown = true; return;}  /* e.g. a dereferenced pointer */
+  std::string key = get_key(symbolic_variable);
+  if (!key.empty()) accesses->writes.insert(key);
+}
+
+
+/* The value passed to a parameter of a FB or FUNCTION call: a variable may be passed to a VAR_IN_OUT, and written */
+void independent_networks_analysis_c::pass(symbol_c *expression) {
+  if (   (NULL != dynamic_cast<symbolic_variable_c   *>(expression))
+      || (NULL != dynamic_cast<array_variable_c      *>(expression))
+      || (NULL != dynamic_cast<structured_variable_c *>(expression))
+      || (NULL != dynamic_cast<direct_variable_c     *>(expression)))
+    write(expression);
+  else
+    expression->accept(*this);
+}
+
+
+/**************************************/
+/* B.1.5 - Program organization units */
+/**************************************/
+/* the FUNCTIONs and FBs are only analysed when called from a PROGRAM */
+void *independent_networks_analysis_c::visit(function_declaration_c       *symbol) {return NULL;}
+void *independent_networks_analysis_c::visit(function_block_declaration_c *symbol) {return NULL;}
+
+void *independent_networks_analysis_c::visit(program_declaration_c *symbol) {
+  statement_list_c *body = dynamic_cast<statement_list_c *>(symbol->function_block_body);
+  if (NULL != body) analyse_program(symbol, body);
+  return NULL;
+}
+
+
+/********************************/
+/* B 1.7 Configuration elements */
+/********************************/
+void *independent_networks_analysis_c::visit(configuration_declaration_c *symbol) {return NULL;}
+
+
+/**********************/
+/* B 1.3 - Data types */
+/**********************/
+void *independent_networks_analysis_c::visit(data_type_declaration_c *symbol) {return NULL;}
+
+
+/*********************/
+/* B 1.4 - Variables */
+/*********************/
+/* any variable that is read */
+void *independent_networks_analysis_c::visit(symbolic_variable_c *symbol) {read(symbol); return NULL;}
+
+void *independent_networks_analysis_c::visit(direct_variable_c *symbol) {
+  if (NULL != accesses) accesses->reads.insert(LOCATED_KEY);
+  return NULL;
+}
+
+
+/********************/
+/* 2.1.6 - Pragmas  */
+/********************/
+/* embedded C code, that may do anything */
+void *independent_networks_analysis_c::visit(pragma_c *symbol) {
+  if ((NULL != accesses) && !is_current_time_pragma(symbol->value)) accesses->unknown = true;
+  return NULL;
+}
+
+
+/***************************************/
+/* B.3 - Language ST (Structured Text) */
+/***************************************/
+void *independent_networks_analysis_c::visit(ref_expression_c   *symbol) {accesses->unknown = true; return NULL;}
+void *independent_networks_analysis_c::visit(deref_expression_c *symbol) {accesses->unknown = true; return NULL;}
+void *independent_networks_analysis_c::visit(deref_operator_c   *symbol) {accesses->unknown = true; return NULL;}
+
+void *independent_networks_analysis_c::visit(function_invocation_c *symbol) {
+  analyse_call(symbol->called_function_declaration);
+  if (NULL != symbol->formal_param_list) symbol->formal_param_list->accept(*this);
+  list_c *nonformal_param_list = dynamic_cast<list_c *>(symbol->nonformal_param_list);
+  if (NULL != nonformal_param_list)
+    for (int i = 0; i < nonformal_param_list->n; i++) pass(nonformal_param_list->get_element(i));
+  return NULL;
+}
+
+
+/********************/
+/* B 3.2 Statements */
+/********************/
+void *independent_networks_analysis_c::visit(assignment_statement_c *symbol) {
+  write(symbol->l_exp);
+  symbol->r_exp->accept(*this);
+  return NULL;
+}
+
+/* jumps over the statements that follow, in every network */
+void *independent_networks_analysis_c::visit(return_statement_c *symbol) {
+  if (in_program) accesses->unknown = true;
+  return NULL;
+}
+
+/* the FB instance keeps its own state, and is written by the call */
+void *independent_networks_analysis_c::visit(fb_invocation_c *symbol) {
+  write(symbol->fb_name);
+  analyse_call(symbol->called_fb_declaration);
+  if (NULL != symbol->formal_param_list) symbol->formal_param_list->accept(*this);
+  list_c *nonformal_param_list = dynamic_cast<list_c *>(symbol->nonformal_param_list);
+  if (NULL != nonformal_param_list)
+    for (int i = 0; i < nonformal_param_list->n; i++) pass(nonformal_param_list->get_element(i));
+  return NULL;
+}
+
+/* variable_name ':=' expression */
+void *independent_networks_analysis_c::visit(input_variable_param_assignment_c *symbol) {
+  pass(symbol->expression);
+  return NULL;
+}
+
+/* [NOT] variable_name '=>' variable */
+void *independent_networks_analysis_c::visit(output_variable_param_assignment_c *symbol) {
+  write(symbol->variable);
+  return NULL;
+}
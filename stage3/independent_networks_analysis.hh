@@ -0,0 +1,155 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2015  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+
+/*
+ * Independent networks analysis:
+ *   - Split the statements of each PROGRAM body into networks, i.e. groups of statements that access
+ *     no variable written by the statements of another network, and annotate each statement with the
+ *     number of its network, and the body with the number of networks (see get_network() and get_network_count()).
+ *     The networks may then run in any order, or concurrently (see -O N in stage 4), as long as the
+ *     statements of each network run in their original order.
+ *
+ *   The read and write sets of each top level statement of the body are made of:
+ *     - the PROGRAM's own variables, keyed by the name of the whole variable (an element of an ARRAY,
+ *       or a field of a STRUCT, is an access to the whole variable);
+ *     - the global variables (through the VAR_EXTERNAL), keyed by their name;
+ *     - the located variables and the directly represented variables, all with the same key, since
+ *       two different locations may overlap (e.g. %QW0 and %QX0.3). A global variable may also be
+ *       located, so writing a located variable conflicts with any access to a global variable, and
+ *       writing a global variable with any access to a located variable.
+ *   The variables passed to a FB or FUNCTION call are written (they may be a VAR_IN_OUT). Calling a FB
+ *   instance writes the instance, and calling a FB or FUNCTION also accesses the global (and located)
+ *   variables accessed by the body of the called POU (and of the POUs it calls), found by analysing it.
+ *
+ *   Two statements conflict when one of them writes a variable accessed by the other, and the networks
+ *   are the groups of statements connected by conflicts. The body is a single network when any of its
+ *   statements (or a POU it calls) contains:
+ *     - a RETURN, in the body of the PROGRAM itself;
+ *     - a REF() or a dereference, that may access any variable;
+ *     - a pragma (i.e. embedded C code, that may do anything), except for the one used by the standard
+ *       timers to read __CURRENT_TIME into their instance;
+ *     - a call to a FB or FUNCTION whose body is not written in ST.
+ *
+ *   IL and SFC bodies are not analysed, and are a single network.
+ */
+
+#include "../absyntax_utils/absyntax_utils.hh"
+#include <map>
+#include <set>
+#include <string>
+
+
+
+class independent_networks_analysis_c: public iterator_visitor_c {
+
+  private:
+    /* the variables accessed by a statement, or by the body of a POU */
+    typedef struct {
+      std::set<std::string> reads;
+      std::set<std::string> writes;
+      bool                  unknown;  /* may access any variable */
+    } access_set_t;
+
+    /* the number of the network of each top level statement, and the number of networks of each body, in the AST last analysed */
+    static annotation_table_c<int> networks;
+
+    search_var_instance_decl_c *search_var_instance_decl;
+    bool                        in_program;  /* only the variables of a PROGRAM are shared by its statements */
+    access_set_t               *accesses;
+    /* the FUNCTIONs and FBs already analysed, and the global variables they access (shared with the analysis of the called POUs) */
+    std::map<symbol_c *, access_set_t> *pou_accesses;
+    bool                                owns_pou_accesses;
+
+    independent_networks_analysis_c(std::map<symbol_c *, access_set_t> *pou_accesses_, symbol_c *pou);
+    void analyse_program(program_declaration_c *program, statement_list_c *body);
+    void analyse_call(symbol_c *pou_decl);
+    std::string get_key(symbolic_variable_c *variable);
+    void read(symbol_c *variable);
+    void write(symbol_c *variable);
+    void pass(symbol_c *expression);
+
+  public:
+    independent_networks_analysis_c(symbol_c *ignore);
+    virtual ~independent_networks_analysis_c(void);
+    int get_error_count();
+
+    /* The number of networks of a PROGRAM body written in ST (0 for the bodies that were not analysed) */
+    static int get_network_count(symbol_c *body)      {return networks.get(body);}
+    /* The number of the network (0 ... get_network_count() - 1) a top level statement of such a body belongs to */
+    static int get_network      (symbol_c *statement) {return networks.get(statement);}
+
+    /**************************************/
+    /* B.1.5 - Program organization units */
+    /**************************************/
+    void *visit(function_declaration_c       *symbol);
+    void *visit(function_block_declaration_c *symbol);
+    void *visit(program_declaration_c        *symbol);
+
+    /********************************/
+    /* B 1.7 Configuration elements */
+    /********************************/
+    void *visit(configuration_declaration_c  *symbol);
+
+    /**********************/
+    /* B 1.3 - Data types */
+    /**********************/
+    void *visit(data_type_declaration_c      *symbol);
+
+    /*********************/
+    /* B 1.4 - Variables */
+    /*********************/
+    void *visit(symbolic_variable_c *symbol);
+    void *visit(direct_variable_c   *symbol);
+
+    /********************/
+    /* 2.1.6 - Pragmas  */
+    /********************/
+    void *visit(pragma_c *symbol);
+
+    /***************************************/
+    /* B.3 - Language ST (Structured Text) */
+    /***************************************/
+    void *visit(ref_expression_c      *symbol);
+    void *visit(deref_expression_c    *symbol);
+    void *visit(deref_operator_c      *symbol);
+    void *visit(function_invocation_c *symbol);
+
+    /********************/
+    /* B 3.2 Statements */
+    /********************/
+    void *visit(assignment_statement_c             *symbol);
+    void *visit(return_statement_c                 *symbol);
+    void *visit(fb_invocation_c                    *symbol);
+    void *visit(input_variable_param_assignment_c  *symbol);
+    void *visit(output_variable_param_assignment_c *symbol);
+}; /* independent_networks_analysis_c */
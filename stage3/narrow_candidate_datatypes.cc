@@ -1198,6 +1198,9 @@ void *narrow_candidate_datatypes_c::visit(il_fb_call_c *symbol) {
 	/* Let the il_call_operator (CAL, CALC, or CALCN) set the datatype of prev_il_instruction... */
 	symbol->il_call_operator->datatype = symbol->datatype;
 	symbol->il_call_operator->accept(*this);
+
+	/* Store the value passed to each parameter, for stage 4 */
+	function_call_param_iterator_c::bind(symbol, fb_decl);
 	return NULL;
 }
 
@@ -1218,6 +1221,9 @@ void *narrow_candidate_datatypes_c::visit(il_formal_funct_call_c *symbol) {
   
 	narrow_function_invocation(symbol, fcall_param);
 	/* The desired datatype of the previous il instruction was already set by narrow_function_invocation() */
+
+	/* Store the value passed to each parameter, for stage 4 */
+	function_call_param_iterator_c::bind(symbol, symbol->called_function_declaration);
 	return NULL;
 }
 
@@ -1664,6 +1670,9 @@ void *narrow_candidate_datatypes_c::visit(function_invocation_c *symbol) {
 	};
   
 	narrow_function_invocation(symbol, fcall_param);
+
+	/* Store the value passed to each parameter, for stage 4 */
+	function_call_param_iterator_c::bind(symbol, symbol->called_function_declaration);
 	return NULL;
 }
 
@@ -1708,6 +1717,8 @@ void *narrow_candidate_datatypes_c::visit(fb_invocation_c *symbol) {
 	if (NULL != symbol->nonformal_param_list)  narrow_nonformal_call(symbol, fb_decl);
 	if (NULL != symbol->   formal_param_list)     narrow_formal_call(symbol, fb_decl);
 
+	/* Store the value passed to each parameter, for stage 4 */
+	function_call_param_iterator_c::bind(symbol, symbol->called_fb_declaration);
 	return NULL;
 }
 
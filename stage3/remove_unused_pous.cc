@@ -0,0 +1,224 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+/*
+ * Remove the POUs and derived datatypes that are not used by any configuration.
+ * 
+ * Starting with the CONFIGURATIONs, follow all the references to POU types (poutype_identifier_c)
+ * and derived datatypes (derived_datatype_identifier_c) made by the used POUs and datatypes, until no more
+ * used POUs or datatypes are found. Enumerated values may be referenced without the name of their datatype,
+ * so any identifier that is also the name of an enumerated value is considered a reference to the enumerated
+ * datatype(s) that declare that value (this may keep a few unused enumerated datatypes, which is harmless).
+ * 
+ * See the comments in remove_unused_pous.hh for more details.
+ */
+
+#include "remove_unused_pous.hh"
+#include "../main.hh" // required for ERROR() and ERROR_MSG() macros.
+#include "../absyntax_utils/absyntax_utils.hh"
+#include <ctype.h>
+
+
+
+/* Visit a used POU or datatype declaration, and tell remove_unused_pous_c about all the names it references. */
+class find_pou_references_c: public iterator_visitor_c {
+  private:
+    remove_unused_pous_c *remove_unused_pous;
+  public:
+    find_pou_references_c(remove_unused_pous_c *remove_unused_pous_) {remove_unused_pous = remove_unused_pous_;}
+  /*******************************************/
+  /* B 1.1 - Letters, digits and identifiers */
+  /*******************************************/
+  void *visit(                    identifier_c *symbol) {remove_unused_pous->add_enum_reference(symbol); return NULL;}
+  void *visit(   derived_datatype_identifier_c *symbol) {remove_unused_pous->add_reference     (symbol); return NULL;}
+  void *visit(            poutype_identifier_c *symbol) {remove_unused_pous->add_reference     (symbol); return NULL;}
+};   /* class find_pou_references_c */
+
+
+
+
+
+
+/************************************************************/
+/************************************************************/
+/******   The main class: Remove Unused POUs          *******/
+/************************************************************/
+/************************************************************/
+
+// constructor & destructor
+remove_unused_pous_c:: remove_unused_pous_c(void) {
+  find_pou_references = new find_pou_references_c(this);
+}
+
+remove_unused_pous_c::~remove_unused_pous_c(void) {
+  delete find_pou_references;
+}
+
+
+/* IEC 61131-3 identifiers are case insensitive */
+std::string remove_unused_pous_c::folded_name(const char *name) {
+  std::string folded(name);
+  for (unsigned int i = 0; i < folded.size(); i++)  folded[i] = toupper(folded[i]);
+  return folded;
+}
+
+
+void remove_unused_pous_c::add_declaration(symbol_c *declaration, const char *name) {
+  if (NULL == name) ERROR;
+  declarations[folded_name(name)].push_back(declaration);
+
+  /* remember the values declared by enumerated datatypes */
+  enumerated_type_declaration_c *enum_declaration = dynamic_cast<enumerated_type_declaration_c *>(declaration);
+  if (NULL == enum_declaration) return;
+  enumerated_spec_init_c *spec_init = dynamic_cast<enumerated_spec_init_c *>(enum_declaration->enumerated_spec_init);
+  if (NULL == spec_init) ERROR;
+  enumerated_value_list_c *value_list = dynamic_cast<enumerated_value_list_c *>(spec_init->enumerated_specification);
+  if (NULL == value_list) return;  // an enumerated datatype derived from another one (i.e. TYPE enum2_t : enum1_t := ...; END_TYPE)
+  for (int i = 0; i < value_list->n; i++) {
+    enumerated_value_c *value = dynamic_cast<enumerated_value_c *>(value_list->get_element(i));
+    if (NULL == value) ERROR;
+    token_c *value_name = dynamic_cast<token_c *>(value->value);
+    if (NULL == value_name) ERROR;
+    enumerated_values[folded_name(value_name->value)].push_back(declaration);
+  }
+}
+
+
+void remove_unused_pous_c::add_used_symbol(symbol_c *declaration) {
+  if (used_symbols.find(declaration) != used_symbols.end()) return; // already handled
+  used_symbols.insert(declaration);
+  pending_symbols.push_back(declaration);
+}
+
+
+void remove_unused_pous_c::add_reference(symbol_c *name) {
+  token_c *token = dynamic_cast<token_c *>(name);
+  if (NULL == token) ERROR;
+  declarations_t::iterator iter = declarations.find(folded_name(token->value));
+  if (iter == declarations.end()) return;  // a standard function, or an undeclared POU/datatype (an error already reported in stage 3)
+  /* NOTE: we do not try to find which of the overloaded functions is actually called. All of them are kept. */
+  for (unsigned int i = 0; i < iter->second.size(); i++)  add_used_symbol(iter->second[i]);
+}
+
+
+void remove_unused_pous_c::add_enum_reference(symbol_c *name) {
+  token_c *token = dynamic_cast<token_c *>(name);
+  if (NULL == token) ERROR;
+  declarations_t::iterator iter = enumerated_values.find(folded_name(token->value));
+  if (iter == enumerated_values.end()) return;  // not an enumerated value
+  for (unsigned int i = 0; i < iter->second.size(); i++)  add_used_symbol(iter->second[i]);
+}
+
+
+/* Returns the old_declaration itself if all its datatypes are used, NULL if none are used, or otherwise
+ * a new data_type_declaration_c with only the used datatypes.
+ */
+data_type_declaration_c *remove_unused_pous_c::new_data_type_declaration(data_type_declaration_c *old_declaration) {
+  list_c *old_list = dynamic_cast<list_c *>(old_declaration->type_declaration_list);
+  if (NULL == old_list) ERROR;
+
+  int used_count = 0;
+  for (int i = 0; i < old_list->n; i++)
+    if (used_symbols.find(old_list->get_element(i)) != used_symbols.end()) used_count++;
+  if (used_count == old_list->n) return old_declaration;
+  if (used_count == 0)           return NULL;
+
+  type_declaration_list_c *new_list = new type_declaration_list_c;
+  *((symbol_c *)new_list) = *((symbol_c *)old_list); // copy any annotations (and the location in the source code)
+  new_list->clear();
+  for (int i = 0; i < old_list->n; i++)
+    if (used_symbols.find(old_list->get_element(i)) != used_symbols.end())
+      new_list->add_element(old_list->get_element(i));
+  data_type_declaration_c *new_declaration = new data_type_declaration_c(new_list);
+  *((symbol_c *)new_declaration) = *((symbol_c *)old_declaration); // copy any annotations (and the location in the source code)
+  return new_declaration;
+}
+
+
+
+library_c *remove_unused_pous_c::create_new_tree(symbol_c *tree) {return create_new_tree(tree, -1);}
+
+
+library_c *remove_unused_pous_c::create_new_tree(symbol_c *tree, int first_used) {
+  library_c *old_tree = dynamic_cast<library_c *>(tree);
+  if (NULL == old_tree) ERROR;
+
+  /* find all the POUs and datatypes declared in the library, and the configurations */
+  for (int i = 0; i < old_tree->n; i++) {
+    symbol_c *element = old_tree->get_element(i);
+    bool used = (first_used >= 0) && (i >= first_used);
+    data_type_declaration_c *data_type_declaration = dynamic_cast<data_type_declaration_c *>(element);
+    if (NULL != data_type_declaration) {
+      list_c *type_list = dynamic_cast<list_c *>(data_type_declaration->type_declaration_list);
+      if (NULL == type_list) ERROR;
+      for (int j = 0; j < type_list->n; j++) {
+        add_declaration(type_list->get_element(j), get_datatype_info_c::get_id_str(type_list->get_element(j)));
+        if (used) add_used_symbol(type_list->get_element(j));
+      }
+    } else if (   (NULL != dynamic_cast<function_declaration_c       *>(element))
+               || (NULL != dynamic_cast<function_block_declaration_c *>(element))
+               || (NULL != dynamic_cast<program_declaration_c        *>(element))) {
+      add_declaration(element, get_datatype_info_c::get_id_str(element));
+      if (used) add_used_symbol(element);
+    } else if (NULL != dynamic_cast<configuration_declaration_c *>(element)) {
+      add_used_symbol(element);
+    }
+  }
+
+  /* a library of POUs being compiled on its own => keep everything */
+  if (pending_symbols.empty()) return old_tree;
+
+  /* follow the references made by the used POUs and datatypes */
+  while (!pending_symbols.empty()) {
+    symbol_c *symbol = pending_symbols.back();
+    pending_symbols.pop_back();
+    symbol->accept(*find_pou_references);
+  }
+
+  /* create the new tree, keeping everything that is not an unused POU or datatype (e.g. pragmas) */
+  library_c *new_tree = new library_c;
+  *((symbol_c *)new_tree) = *((symbol_c *)tree); // copy any annotations from tree to new_tree;
+  new_tree->clear(); // remove all elements from list.
+  for (int i = 0; i < old_tree->n; i++) {
+    symbol_c *element = old_tree->get_element(i);
+    data_type_declaration_c *data_type_declaration = dynamic_cast<data_type_declaration_c *>(element);
+    if (NULL != data_type_declaration) {
+      element = new_data_type_declaration(data_type_declaration);
+      if (NULL == element) continue;
+    } else if (   (NULL != dynamic_cast<function_declaration_c       *>(element))
+               || (NULL != dynamic_cast<function_block_declaration_c *>(element))
+               || (NULL != dynamic_cast<program_declaration_c        *>(element))) {
+      if (used_symbols.find(element) == used_symbols.end()) continue;
+    }
+    new_tree->add_element(element);
+  }
+  return new_tree;
+}
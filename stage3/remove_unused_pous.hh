@@ -0,0 +1,94 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+/*
+ * Remove the POUs and derived datatypes that are not used by any configuration (-U command line option).
+ * 
+ * Libraries of POUs (e.g. supplied by a vendor) are usually included in their entirety in the source
+ * code, even though a project only uses a few of their POUs. This utility class determines which POUs
+ * (FUNCTIONs, FUNCTION_BLOCKs and PROGRAMs) and derived datatypes are reachable from the CONFIGURATIONs
+ * in the library, and creates a new library containing only those, so stage4 does not generate code for
+ * the others.
+ * 
+ * As is done by remove_forward_dependencies_c, the original abstract syntax tree (AST) is not destroyed.
+ * The new library_c object points to the *same* objects of the original AST, in the same order. Only the
+ * TYPE ... END_TYPE declarations that contain unused datatypes are replaced by new data_type_declaration_c
+ * objects (pointing to the used datatype declarations).
+ * 
+ * If the library does not contain any CONFIGURATION (i.e. it is a library of POUs being compiled on its own),
+ * nothing is removed.
+ *
+ * It is also used by stage 3 so the standard library POUs are only analysed when used by the input file: all the
+ * elements declared in the input file are then considered used, whether or not it contains a CONFIGURATION.
+ */
+
+#include "../absyntax/absyntax.hh"
+#include "../absyntax/visitor.hh"
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+
+class find_pou_references_c;
+
+
+class remove_unused_pous_c {
+
+  private:
+    /* the library elements (POUs and datatype declarations) that declare each name (more than one for overloaded functions) */
+    typedef std::map<std::string, std::vector<symbol_c *> > declarations_t;
+    declarations_t               declarations;
+    declarations_t               enumerated_values;  // the enumerated datatype declarations that declare each enumerated value
+    std::set <symbol_c *>        used_symbols;       // the POUs and datatype declarations found to be in use
+    std::vector <symbol_c *>     pending_symbols;    // the used POUs and datatype declarations whose references have not yet been followed
+    find_pou_references_c       *find_pou_references;
+
+  public:
+     remove_unused_pous_c(void);
+    ~remove_unused_pous_c(void);
+    library_c *create_new_tree(symbol_c *old_tree);  // create a new tree with only the POUs and datatypes used by the configurations
+    /* create a new tree with elements first_used onwards, and only the POUs and datatypes used by these among the elements before them */
+    library_c *create_new_tree(symbol_c *old_tree, int first_used);
+
+    /* called by find_pou_references_c for every name referenced by a used POU or datatype */
+    void  add_reference      (symbol_c *name);
+    void  add_enum_reference (symbol_c *name);
+
+  private:
+    static std::string folded_name(const char *name);
+    void  add_declaration(symbol_c *declaration, const char *name);
+    void  add_used_symbol(symbol_c *declaration);
+    data_type_declaration_c *new_data_type_declaration(data_type_declaration_c *old_declaration);
+
+};   /* class remove_unused_pous_c */
+
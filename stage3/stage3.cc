@@ -32,6 +32,10 @@
  *
  */
 
+#include <string.h>
+#include <vector>
+#include <string>
+
 #include "stage3.hh"
 
 #include "flow_control_analysis.hh"
@@ -46,6 +50,11 @@
 #include "declaration_check.hh"
 #include "enum_declaration_check.hh"
 #include "remove_forward_dependencies.hh"
+#include "remove_unused_pous.hh"
+#include "incremental_check.hh"
+#include "dead_store_analysis.hh"
+#include "idempotent_fb_analysis.hh"
+#include "independent_networks_analysis.hh"
 
 
 
@@ -72,6 +81,34 @@ static int declaration_safety(symbol_c *tree_root){
     return declaration_check.get_error_count();
 }
 
+/* Dead store analysis assumes that data type analysis has already been completed,
+ * so be sure to run type_safety() before dead_store_analysis().
+ * It changes the annotations of the AST, so it is not a checker.
+ */
+static int dead_store_analysis(symbol_c *tree_root){
+    dead_store_analysis_c dead_store_analysis(tree_root);
+    tree_root->accept(dead_store_analysis);
+    return dead_store_analysis.get_error_count();
+}
+
+/* Idempotent FB analysis uses the FUNCTIONs called (called_function_declaration) found by the data type
+ * analysis, so be sure to run type_safety() before idempotent_fb_analysis().
+ */
+static int idempotent_fb_analysis(symbol_c *tree_root){
+    idempotent_fb_analysis_c idempotent_fb_analysis(tree_root);
+    tree_root->accept(idempotent_fb_analysis);
+    return idempotent_fb_analysis.get_error_count();
+}
+
+/* Independent networks analysis uses the FBs and FUNCTIONs called (called_fb_declaration, called_function_declaration)
+ * found by the data type analysis, so be sure to run type_safety() before independent_networks_analysis().
+ */
+static int independent_networks_analysis(symbol_c *tree_root){
+    independent_networks_analysis_c independent_networks_analysis(tree_root);
+    tree_root->accept(independent_networks_analysis);
+    return independent_networks_analysis.get_error_count();
+}
+
 static int flow_control_analysis(symbol_c *tree_root){
     flow_control_analysis_c flow_control_analysis(tree_root);
     tree_root->accept(flow_control_analysis);
@@ -101,7 +138,9 @@ static int type_safety(symbol_c *tree_root){
 	narrow_candidate_datatypes_c narrow_candidate_datatypes(tree_root);
 	tree_root->accept(narrow_candidate_datatypes);
 	print_datatypes_error_c print_datatypes_error(tree_root);
-	tree_root->accept(print_datatypes_error);
+	/* print_datatypes_error_c leaves the AST as it found it, so it is not needed to generate the code */
+	if (!runtime_options.trusted_input)
+		tree_root->accept(print_datatypes_error);
 	forced_narrow_candidate_datatypes_c forced_narrow_candidate_datatypes(tree_root);
 	tree_root->accept(forced_narrow_candidate_datatypes);
 	return print_datatypes_error.get_error_count();
@@ -109,32 +148,17 @@ static int type_safety(symbol_c *tree_root){
 
 
 /* Left value checking assumes that data type analysis has already been completed,
- * so be sure to call type_safety() before calling this function
- */
-static int lvalue_check(symbol_c *tree_root){
-	lvalue_check_c lvalue_check(tree_root);
-	tree_root->accept(lvalue_check);
-	return lvalue_check.get_error_count();
-}
-
-/* Array range check assumes that constant folding has been completed!
- * so be sure to call constant_folding() before calling this function!
- */
-static int array_range_check(symbol_c *tree_root){
-	array_range_check_c array_range_check(tree_root);
-	tree_root->accept(array_range_check);
-	return array_range_check.get_error_count();
-}
-
-
-/* Case options check assumes that constant folding has been completed!
- * so be sure to call constant_folding() before calling this function!
+ * so be sure to run type_safety() before lvalue_check_c.
+ *
+ * Array range check assumes that constant folding has been completed!
+ * so be sure to run constant_folding() before array_range_check_c!
+ *
+ * Case options check assumes that constant folding has been completed!
+ * so be sure to run constant_folding() before case_elements_check_c!
+ *
+ * These three checkers only read the annotations left in the AST by the previous passes, and
+ * only keep state that is local to each POU, so they are run fused together (see stage3_passes[]).
  */
-static int case_elements_check(symbol_c *tree_root){
-	case_elements_check_c case_elements_check(tree_root);
-	tree_root->accept(case_elements_check);
-	return case_elements_check.get_error_count();
-}
 
 
 /* Removing forward dependencies only makes sense when stage1_2 is run with the pre-parsing option.
@@ -155,21 +179,164 @@ static int remove_forward_dependencies(symbol_c *tree_root, symbol_c **ordered_t
 }
 
 
-int stage3(symbol_c *tree_root, symbol_c **ordered_tree_root) {
+/* Removing the unused POUs and datatypes (-U command line option) is done on the (ordered) tree that is
+ * handed to stage4, once all the stage 3 verifications have been done on the complete library.
+ */
+static void remove_unused_pous(symbol_c **ordered_tree_root) {
+	if (!runtime_options.remove_unused_pous)  return;
+	if (NULL == ordered_tree_root)            return;
+
+	remove_unused_pous_c remove_unused_pous;
+	*ordered_tree_root = remove_unused_pous.create_new_tree(*ordered_tree_root);
+	if (NULL == *ordered_tree_root)  ERROR;
+}
+
+
+
+/* The standard library contains hundreds of FUNCTIONs and FUNCTION_BLOCKs, of which a program only uses a
+ * few. The stage 3 passes only analyse those used by the input file (and all the elements declared in the
+ * input file), so the library POUs never used are not checked, and do not get any stage 3 annotations.
+ * This is fine, as their code is never generated (stage4 only generates the code of the POUs of the
+ * standard library that are used, or does not generate it at all).
+ * The tree handed to stage4 still contains the whole library.
+ */
+static symbol_c *checked_tree(symbol_c *tree_root, int library_elements) {
+	if (library_elements <= 0)  return tree_root;
+
+	remove_unused_pous_c remove_unused_pous;
+	symbol_c *new_tree_root = remove_unused_pous.create_new_tree(tree_root, library_elements);
+	if (NULL == new_tree_root)  ERROR;
+	return new_tree_root;
+}
+
+
+
+/* The stage 3 passes, in the order in which they are run.
+ *
+ * Each pass lists the passes it depends on, i.e. the passes that must be run before it.
+ * stage3() verifies these dependencies, so any change to this table that breaks one is caught right away.
+ *
+ * Passes are either a function that does all the work (PASS()), or a visitor class (CHECKER()).
+ * Checkers must only read the annotations left by previous passes, and only keep state local to
+ * each library element (POU, datatype declaration, configuration). Consecutive checkers are fused:
+ * the library is walked only once, and each library element is visited by all the fused checkers
+ * in turn (while it is still in the cache), instead of each checker walking the whole AST on its own.
+ * A checker may therefore not depend on another checker it is fused with.
+ *
+ * The diagnostic passes only look for errors in the source code, and do not change the AST (nor anything
+ * else used to generate the code). They are skipped when the input is trusted (-K), and the passes that
+ * are needed to generate the code may therefore not depend on them.
+ */
+typedef struct {
+  const char  *name;
+  bool         diagnostic;
+  int        (*run)(symbol_c *tree_root);              /* NULL for checkers */
+  visitor_c *(*new_checker)(symbol_c *tree_root);      /* NULL for passes   */
+  int        (*get_error_count)(visitor_c *checker);   /* NULL for passes   */
+  const char  *depends_on[4];                          /* NULL terminated!  */
+} stage3_pass_t;
+
+template <class checker_c> static visitor_c *new_checker    (symbol_c  *tree_root) {return new checker_c(tree_root);}
+template <class checker_c> static int        get_error_count(visitor_c *checker)   {return static_cast<checker_c *>(checker)->get_error_count();}
+
+#define PASS(function)     function, NULL,                   NULL
+#define CHECKER(checker_c) NULL,     new_checker<checker_c>, get_error_count<checker_c>
+
+static const stage3_pass_t stage3_passes[] = {
+  {"enum_declaration_check", true,  PASS(enum_declaration_check),       {NULL}},
+  {"flow_control_analysis",  false, PASS(flow_control_analysis),        {NULL}},
+  {"constant_propagation",   false, PASS(constant_propagation),         {"flow_control_analysis", NULL}},
+  {"declaration_safety",     true,  PASS(declaration_safety),           {"constant_propagation", NULL}},
+  {"type_safety",            false, PASS(type_safety),                  {"flow_control_analysis", "constant_propagation", NULL}},
+  {"lvalue_check",           true,  CHECKER(lvalue_check_c),            {"type_safety", NULL}},
+  {"array_range_check",      true,  CHECKER(array_range_check_c),       {"constant_propagation", NULL}},
+  {"case_elements_check",    true,  CHECKER(case_elements_check_c),     {"constant_propagation", NULL}},
+  {"dead_store_analysis",    false, PASS(dead_store_analysis),          {"type_safety", NULL}},
+  {"idempotent_fb_analysis", false, PASS(idempotent_fb_analysis),       {"type_safety", NULL}},
+  {"independent_networks_analysis", false, PASS(independent_networks_analysis), {"type_safety", NULL}},
+  {NULL, false, NULL, NULL, NULL, {NULL}} /* end of table marker! Do not remove! */
+};
+
+#undef PASS
+#undef CHECKER
+
+
+/* Verify that all the dependencies of the pass are run before the passes starting at stage3_passes[first] */
+static void check_dependencies(const stage3_pass_t *pass, int first) {
+	for (int d = 0; NULL != pass->depends_on[d]; d++) {
+		int i;
+		for (i = 0; (i < first) && (strcmp(stage3_passes[i].name, pass->depends_on[d]) != 0); i++);
+		if (i == first) ERROR_MSG("stage 3 pass %s must be run after %s.", pass->name, pass->depends_on[d]);
+		if (stage3_passes[i].diagnostic && !pass->diagnostic)
+			ERROR_MSG("stage 3 pass %s may not depend on the diagnostic pass %s.", pass->name, pass->depends_on[d]);
+	}
+}
+
+
+/* Run the checkers stage3_passes[first] ... stage3_passes[last-1] in a single walk of the library */
+static int run_fused_checkers(symbol_c *tree_root, int first, int last) {
+	std::vector<visitor_c *> checkers;
+	std::vector<int>         passes;   /* the index in stage3_passes[] of each checker */
+	std::string name;
+	for (int i = first; i < last; i++) {
+		if (runtime_options.trusted_input && stage3_passes[i].diagnostic)  continue;
+		checkers.push_back(stage3_passes[i].new_checker(tree_root));
+		passes.push_back(i);
+		name += (checkers.size() == 1)? "" : " + ";
+		name += stage3_passes[i].name;
+	}
+
+	if (checkers.empty())  return 0;
+	time_report_c time_report(name.c_str());
+	list_c *library = dynamic_cast<list_c *>(tree_root);
+	if (NULL == library) {
+		for (unsigned int c = 0; c < checkers.size(); c++)
+			tree_root->accept(*checkers[c]);
+	} else {
+		for (int e = 0; e < library->n; e++)
+			for (unsigned int c = 0; c < checkers.size(); c++)
+				library->get_element(e)->accept(*checkers[c]);
+	}
+
 	int error_count = 0;
-	error_count += enum_declaration_check(tree_root);
-	error_count += flow_control_analysis(tree_root);
-	error_count += constant_propagation(tree_root);
-	error_count += declaration_safety(tree_root);
-	error_count += type_safety(tree_root);
-	error_count += lvalue_check(tree_root);
-	error_count += array_range_check(tree_root);
-	error_count += case_elements_check(tree_root);
-	error_count += remove_forward_dependencies(tree_root, ordered_tree_root);
+	for (unsigned int c = 0; c < checkers.size(); c++) {
+		error_count += stage3_passes[passes[c]].get_error_count(checkers[c]);
+		delete checkers[c];
+	}
+	return error_count;
+}
+
+
+int stage3(symbol_c *tree_root, symbol_c **ordered_tree_root, int library_elements) {
+	int error_count = 0;
+	symbol_c *checked_tree_root = tree_root;
+	/* stage 4 reads the value ranges even when array_range_check_c is not run (-K) */
+	array_range_check_c::clear_value_ranges();
+	/* only check again the POUs changed since the last time this file was checked (see incremental_check.hh) */
+	if (runtime_options.check_only)
+		{time_report_c time_report("select_changed_pous");      checked_tree_root = incremental_check_c::create_new_tree(checked_tree_root, library_elements);}
+	{time_report_c time_report("select_used_library_pous"); checked_tree_root = checked_tree(checked_tree_root, library_elements);}
+	for (int i = 0, last; NULL != stage3_passes[i].name; i = last) {
+		/* find the consecutive checkers that may be fused with this one */
+		for (last = i + 1; (NULL != stage3_passes[i].new_checker) && (NULL != stage3_passes[last].new_checker); last++);
+		for (int j = i; j < last; j++)
+			check_dependencies(&stage3_passes[j], i);
+
+		if (runtime_options.trusted_input && stage3_passes[i].diagnostic && (NULL != stage3_passes[i].run))
+			continue;
+		if (NULL != stage3_passes[i].run) {
+			time_report_c time_report(stage3_passes[i].name);
+			error_count += stage3_passes[i].run(checked_tree_root);
+		} else
+			error_count += run_fused_checkers(checked_tree_root, i, last);
+	}
+	{time_report_c time_report("remove_forward_dependencies"); error_count += remove_forward_dependencies(tree_root, ordered_tree_root);}
+	{time_report_c time_report("remove_unused_pous");          remove_unused_pous(ordered_tree_root);}
 	
 	if (error_count > 0) {
 		fprintf(stderr, "%d error(s) found. Bailing out!\n", error_count); 
 		return -1;
 	}
+	if (runtime_options.check_only)  incremental_check_c::set_clean();
 	return 0;
 }
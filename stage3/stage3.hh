@@ -36,6 +36,9 @@
 #include "../util/symtable.hh"
 
 
-int stage3(symbol_c *tree_root, symbol_c **ordered_tree_root);
+/* The first library_elements elements of tree_root are the standard library (see stage1_2_library_elements()).
+ * Those not used by the other elements are not analysed.
+ */
+int stage3(symbol_c *tree_root, symbol_c **ordered_tree_root, int library_elements = 0);
 
 #endif /* _STAGE3_HH */
@@ -0,0 +1,379 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2003-2011  Mario de Sousa (msousa@fe.up.pt)
+ *  Copyright (C) 2007-2011  Laurent Bessard and Edouard Tisserant
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+
+/*
+ * The POUs and variables seen by the stage4 generators that translate the
+ * ST code on their own (generate_llvm, generate_bytecode and generate_cc).
+ *
+ * Each generator supports a few elementary datatypes, and maps them to its own
+ * representation. It therefore instantiates the classes below with a backend_t
+ * class holding:
+ *   - type_t               : the representation of an elementary datatype;
+ *   - var_data_t           : the data the generator adds to each variable;
+ *   - pou_data_t           : the data the generator adds to each POU;
+ *   - elementary_type()    : the type_t of a datatype, NULL if not supported;
+ *   - generating()         : the stage4err() id of the generator ("while generating ...");
+ *   - generator()          : the name of the generator, in the error messages.
+ */
+
+
+
+/*
+ * POU_TABLE.HH
+ */
+
+
+#ifndef _POU_TABLE_HH
+#define _POU_TABLE_HH
+
+
+#include <string>
+#include <vector>
+#include <map>
+#include <stdlib.h>
+
+#include "../../absyntax_utils/absyntax_utils.hh"
+#include "../../main.hh" // required for ERROR() and ERROR_MSG() macros.
+#include "../stage4.hh"
+
+
+/* The name of an identifier, in upper case */
+std::string upper_case_name(symbol_c *symbol);
+
+
+/* Finds whether an expression reads a variable, or calls a function (i.e. is not made of literals only) */
+class reads_variable_c: public iterator_visitor_c {
+  public:
+    bool found;
+    reads_variable_c(void): found(false) {}
+
+    void *visit(symbolic_variable_c   *symbol) {found = true; return NULL;}
+    void *visit(structured_variable_c *symbol) {found = true; return NULL;}
+    void *visit(array_variable_c      *symbol) {found = true; return NULL;}
+    void *visit(direct_variable_c     *symbol) {found = true; return NULL;}
+    void *visit(function_invocation_c *symbol) {found = true; return NULL;}
+};
+
+
+
+
+template <class backend_t> class stage4_pou_c;
+
+template <class backend_t>
+class stage4_var_c: public backend_t::var_data_t {
+  public:
+    typedef enum {input_vt, output_vt, inout_vt, private_vt, temp_vt, external_vt, global_vt, result_vt} vartype_t;
+
+    std::string name;          /* in upper case */
+    vartype_t vartype;
+    symbol_c *symbol;          /* the name, as declared */
+    symbol_c *type_name;
+    const typename backend_t::type_t *type;  /* NULL for FB instances */
+    stage4_pou_c<backend_t> *fb;             /* the FB type of the FB instances */
+    symbol_c *init;            /* the initial value, may be NULL */
+    bool constant;
+    int field;                 /* the index of the variable in the FB and PROGRAM instances, -1 if not in the instance */
+
+    stage4_var_c(void)
+      : vartype(private_vt), symbol(NULL), type_name(NULL), type(NULL), fb(NULL), init(NULL), constant(false), field(-1) {}
+};
+
+
+template <class backend_t>
+class stage4_pou_c: public backend_t::pou_data_t {
+  public:
+    typedef enum {function_pk, function_block_pk, program_pk} kind_t;
+    typedef enum {new_ps, collecting_ps, ready_ps, failed_ps} state_t;
+
+    kind_t kind;
+    state_t state;
+    std::string name;          /* in upper case */
+    symbol_c *decl;
+    symbol_c *var_declarations;
+    symbol_c *body;
+    bool enabled;              /* false for the POUs declared between {disable code generation} and {enable code generation} */
+    bool provided;             /* implemented by the runtime library of the generator, so its body need not be supported */
+    const typename backend_t::type_t *return_type;  /* FUNCTIONs only, NULL for VOID */
+    std::vector<stage4_var_c<backend_t> > vars;
+    unsigned index;            /* the position of the POU in stage4_pou_table_c::collected */
+
+    stage4_var_c<backend_t> *find(const std::string &var_name) {
+      for (size_t i = 0; i < vars.size(); i++)
+        if (vars[i].name == var_name) return &vars[i];
+      return NULL;
+    }
+};
+
+
+
+/* All the POUs of the library. The variables of a POU are only collected when the POU is
+ * first used (get()), or when its code must be generated (collect()).
+ * The POUs whose code generation was disabled (e.g. the standard FBs) and that are not
+ * supported are then silently ignored, unless they are used.
+ */
+template <class backend_t>
+class stage4_pou_table_c {
+  public:
+    typedef stage4_pou_c<backend_t> pou_t;
+    typedef stage4_var_c<backend_t> var_t;
+
+    std::map<std::string, pou_t *> pous;
+    std::vector<pou_t *> collected;  /* in the order the collection ended, i.e. the FB types before the POUs that use them */
+
+    pou_t *add(typename pou_t::kind_t kind, symbol_c *name, symbol_c *decl, symbol_c *var_declarations, symbol_c *body, bool enabled) {
+      pou_t *pou = new pou_t();
+      pou->kind = kind;
+      pou->state = pou_t::new_ps;
+      pou->name = upper_case_name(name);
+      pou->decl = decl;
+      pou->var_declarations = var_declarations;
+      pou->body = body;
+      pou->enabled = enabled;
+      pou->provided = false;
+      pou->return_type = NULL;
+      pou->index = 0;
+      /* a POU declared again after the library (e.g. in a later file) replaces the earlier one */
+      pous[pou->name] = pou;
+      return pou;
+    }
+
+    pou_t *find(const std::string &name) {
+      typename std::map<std::string, pou_t *>::iterator i = pous.find(name);
+      return (i == pous.end())? NULL : i->second;
+    }
+
+    pou_t *find_function(symbol_c *decl) {
+      if (NULL == decl) return NULL;
+      function_declaration_c *function = dynamic_cast<function_declaration_c *>(decl);
+      if (NULL == function) return NULL;
+      pou_t *pou = find(upper_case_name(function->derived_function_name));
+      if ((NULL == pou) || (pou->decl != decl) || !pou->enabled) return NULL;
+      collect(pou, decl);
+      return pou;
+    }
+
+    pou_t *get(symbol_c *type_name, typename pou_t::kind_t kind) {
+      if (NULL == dynamic_cast<token_c *>(type_name)) return NULL;
+      pou_t *pou = find(upper_case_name(type_name));
+      if ((NULL == pou) || (pou->kind != kind)) return NULL;
+      return collect(pou, type_name)? pou : NULL;
+    }
+
+    /* Collect the variables of a POU (defined after stage4_vardecl_c) */
+    bool collect(pou_t *pou, symbol_c *used_at);
+};
+
+
+/* Fills in the variables declared in a POU, or in a configuration or resource (the globals) */
+template <class backend_t>
+class stage4_vardecl_c: public null_visitor_c {
+  private:
+    typedef stage4_pou_c<backend_t> pou_t;
+    typedef stage4_var_c<backend_t> var_t;
+
+    stage4_pou_table_c<backend_t> &pous;
+    std::vector<var_t> &vars;
+    typename var_t::vartype_t current_vartype;
+    bool current_constant;
+    bool quiet;
+
+  public:
+    bool failed;
+
+    stage4_vardecl_c(stage4_pou_table_c<backend_t> &pous_, std::vector<var_t> &vars_, typename var_t::vartype_t vartype, bool quiet_)
+      : pous(pous_), vars(vars_), current_vartype(vartype), current_constant(false), quiet(quiet_), failed(false) {}
+
+  private:
+    void unsupported(symbol_c *symbol, const char *what) {
+      failed = true;
+      if (!quiet) {stage4err(backend_t::generating(), symbol, symbol, "%s not supported by the %s.", what, backend_t::generator()); exit(EXIT_FAILURE);}
+    }
+
+    void set_vartype(typename var_t::vartype_t vartype, symbol_c *option) {
+      current_vartype  = vartype;
+      current_constant = (NULL != dynamic_cast<constant_option_c *>(option));
+    }
+
+    void add(symbol_c *name, symbol_c *spec) {
+      var_t var;
+      simple_spec_init_c   *simple   = dynamic_cast<simple_spec_init_c   *>(spec);
+      subrange_spec_init_c *subrange = dynamic_cast<subrange_spec_init_c *>(spec);
+
+      var.name      = upper_case_name(name);
+      var.vartype   = current_vartype;
+      var.symbol    = name;
+      var.type_name = spec;
+      var.constant  = current_constant;
+      if (NULL != simple)   {var.type_name = simple  ->simple_specification;   var.init = simple  ->constant;}
+      if (NULL != subrange) {var.type_name = subrange->subrange_specification; var.init = subrange->signed_integer;}
+      var.type = backend_t::elementary_type(var.type_name);
+      var.fb   = (NULL != var.type)? NULL : pous.get(var.type_name, pou_t::function_block_pk);
+      if ((NULL == var.type) && (NULL == var.fb))
+        {unsupported(spec, "The datatype of this variable is"); return;}
+      vars.push_back(var);
+    }
+
+    void add_list(symbol_c *names, symbol_c *spec) {
+      list_c *list = dynamic_cast<list_c *>(names);
+      if (NULL == list) ERROR;
+      for (int i = 0; i < list->n; i++) add(list->get_element(i), spec);
+    }
+
+  public:
+    void *visit_list(list_c *list) {
+      for (int i = 0; i < list->n; i++) list->get_element(i)->accept(*this);
+      return NULL;
+    }
+
+    /******************************************/
+    /* B 1.4.3 - Declaration & Initialisation */
+    /******************************************/
+    void *visit(input_declarations_c *symbol)          {set_vartype(var_t::input_vt, NULL); return symbol->input_declaration_list->accept(*this);}
+    void *visit(input_declaration_list_c *symbol)      {return visit_list(symbol);}
+    void *visit(en_param_declaration_c *symbol)        {set_vartype(var_t::input_vt,  NULL); add(symbol->name, symbol->type_decl); return NULL;}
+    void *visit(eno_param_declaration_c *symbol)       {set_vartype(var_t::output_vt, NULL); add(symbol->name, symbol->type);      return NULL;}
+    void *visit(var1_init_decl_c *symbol)              {add_list(symbol->var1_list, symbol->spec_init); return NULL;}
+    void *visit(fb_name_decl_c *symbol) {
+      fb_spec_init_c *fb_spec = dynamic_cast<fb_spec_init_c *>(symbol->fb_spec_init);
+      if (NULL == fb_spec) ERROR;
+      if (NULL != fb_spec->structure_initialization) {unsupported(symbol, "The initial values of FB instances are"); return NULL;}
+      add_list(symbol->fb_name_list, fb_spec->function_block_type_name);
+      return NULL;
+    }
+    void *visit(output_declarations_c *symbol)         {set_vartype(var_t::output_vt, NULL); return symbol->var_init_decl_list->accept(*this);}
+    void *visit(input_output_declarations_c *symbol)   {set_vartype(var_t::inout_vt,  NULL); return symbol->var_declaration_list->accept(*this);}
+    void *visit(var_declaration_list_c *symbol)        {return visit_list(symbol);}
+    void *visit(var_declarations_c *symbol)            {set_vartype(var_t::private_vt, symbol->option); return symbol->var_init_decl_list->accept(*this);}
+    void *visit(retentive_var_declarations_c *symbol)  {set_vartype(var_t::private_vt, NULL); return symbol->var_init_decl_list->accept(*this);}
+    void *visit(external_var_declarations_c *symbol)   {set_vartype(var_t::external_vt, symbol->option); return symbol->external_declaration_list->accept(*this);}
+    void *visit(external_declaration_list_c *symbol)   {return visit_list(symbol);}
+    void *visit(external_declaration_c *symbol)        {add(symbol->global_var_name, symbol->specification); return NULL;}
+    void *visit(global_var_declarations_c *symbol)     {set_vartype(var_t::global_vt, symbol->option); return symbol->global_var_decl_list->accept(*this);}
+    void *visit(global_var_decl_list_c *symbol)        {return visit_list(symbol);}
+    void *visit(global_var_decl_c *symbol) {
+      global_var_spec_c *spec = dynamic_cast<global_var_spec_c *>(symbol->global_var_spec);
+      if ((NULL == symbol->type_specification) || ((NULL != spec) && (NULL != spec->location)))
+        {unsupported(symbol, "Located variables are"); return NULL;}
+      if (NULL != spec) add(spec->global_var_name, symbol->type_specification);
+      else              add_list(symbol->global_var_spec, symbol->type_specification);
+      return NULL;
+    }
+    void *visit(var_init_decl_list_c *symbol)          {return visit_list(symbol);}
+
+    void *visit(located_var_declarations_c *symbol)            {unsupported(symbol, "Located variables are"); return NULL;}
+    void *visit(incompl_located_var_declarations_c *symbol)    {unsupported(symbol, "Located variables are"); return NULL;}
+    void *visit(edge_declaration_c *symbol)                    {unsupported(symbol, "R_EDGE and F_EDGE inputs are"); return NULL;}
+    void *visit(array_var_init_decl_c *symbol)                 {unsupported(symbol, "Arrays are"); return NULL;}
+    void *visit(array_var_declaration_c *symbol)               {unsupported(symbol, "Arrays are"); return NULL;}
+    void *visit(structured_var_init_decl_c *symbol)            {unsupported(symbol, "Structures are"); return NULL;}
+    void *visit(structured_var_declaration_c *symbol)          {unsupported(symbol, "Structures are"); return NULL;}
+    void *visit(single_byte_string_var_declaration_c *symbol)  {unsupported(symbol, "Strings are"); return NULL;}
+    void *visit(double_byte_string_var_declaration_c *symbol)  {unsupported(symbol, "Strings are"); return NULL;}
+
+    /**************************************/
+    /* B.1.5 - Program organization units */
+    /**************************************/
+    void *visit(var_declarations_list_c *symbol)       {return visit_list(symbol);}
+    void *visit(function_var_decls_c *symbol)          {set_vartype(var_t::private_vt, symbol->option); return symbol->decl_list->accept(*this);}
+    void *visit(var2_init_decl_list_c *symbol)         {return visit_list(symbol);}
+    void *visit(temp_var_decls_c *symbol)              {set_vartype(var_t::temp_vt, NULL); return symbol->var_decl_list->accept(*this);}
+    void *visit(temp_var_decls_list_c *symbol)         {return visit_list(symbol);}
+    void *visit(non_retentive_var_decls_c *symbol)     {set_vartype(var_t::private_vt, NULL); return symbol->var_decl_list->accept(*this);}
+};
+
+
+template <class backend_t>
+bool stage4_pou_table_c<backend_t>::collect(pou_t *pou, symbol_c *used_at) {
+#define POU_TABLE_ERROR(symbol, ...) {stage4err(backend_t::generating(), symbol, symbol, __VA_ARGS__); exit(EXIT_FAILURE);}
+  switch (pou->state) {
+    case pou_t::ready_ps     : return true;
+    case pou_t::failed_ps    : return false;
+    case pou_t::collecting_ps: POU_TABLE_ERROR(used_at, "Recursive FB instances are not allowed."); break;
+    case pou_t::new_ps       : break;
+  }
+  pou->state = pou_t::collecting_ps;
+
+  /* the POUs whose code generation was disabled are only generated if supported */
+  stage4_vardecl_c<backend_t> vardecl(*this, pou->vars, var_t::private_vt, !pou->enabled);
+  if (NULL != pou->var_declarations) pou->var_declarations->accept(vardecl);
+
+  if (pou_t::function_pk == pou->kind) {
+    function_declaration_c *function = dynamic_cast<function_declaration_c *>(pou->decl);
+    if (!get_datatype_info_c::is_VOID(function->type_name)) {
+      var_t result;
+      result.name      = pou->name;
+      result.vartype   = var_t::result_vt;
+      result.symbol    = function->derived_function_name;
+      result.type_name = function->type_name;
+      result.type      = backend_t::elementary_type(function->type_name);
+      pou->return_type = result.type;
+      if (NULL == result.type) {
+        if (pou->enabled) POU_TABLE_ERROR(function->type_name, "The datatype returned by this FUNCTION is not supported by the %s.", backend_t::generator());
+        vardecl.failed = true;
+      }
+      pou->vars.push_back(result);
+    }
+    for (size_t i = 0; i < pou->vars.size(); i++)
+      if ((NULL != pou->vars[i].fb) && (var_t::external_vt != pou->vars[i].vartype)) {
+        if (pou->enabled) POU_TABLE_ERROR(pou->vars[i].symbol, "FUNCTIONs may not declare FB instances.");
+        vardecl.failed = true;
+      }
+  } else {
+    int field = 0;
+    for (size_t i = 0; i < pou->vars.size(); i++)
+      switch (pou->vars[i].vartype) {
+        case var_t::input_vt  :
+        case var_t::output_vt :
+        case var_t::inout_vt  :
+        case var_t::private_vt: pou->vars[i].field = field++; break;
+        default               : break;
+      }
+  }
+
+  if (!pou->provided && (NULL == dynamic_cast<statement_list_c *>(pou->body))) {
+    if (pou->enabled) POU_TABLE_ERROR(pou->decl, "Only the POUs written in ST are supported by the %s.", backend_t::generator());
+    vardecl.failed = true;
+  }
+
+  pou->state = vardecl.failed? pou_t::failed_ps : pou_t::ready_ps;
+  if (!vardecl.failed) {
+    pou->index = collected.size();
+    collected.push_back(pou);
+  }
+  return !vardecl.failed;
+#undef POU_TABLE_ERROR
+}
+
+
+#endif /*  _POU_TABLE_HH */
@@ -0,0 +1,1489 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2003-2011  Mario de Sousa (msousa@fe.up.pt)
+ *  Copyright (C) 2007-2011  Laurent Bessard and Edouard Tisserant
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+/*
+ * This is part of the 4th stage that generates
+ * a compact bytecode image (PLC.iecb) of the ST code,
+ * run by the interpreter in lib/C/iec_bytecode.h.
+ *
+ * Reloading an image only takes mapping the file and checking it, so a new version of the
+ * program may be loaded without compiling and linking C code, and many copies of the
+ * configuration may be run side by side (e.g. for simulation), each in its own __bc_vm_t.
+ *
+ * The bytecode works on cells (see iec_bytecode_ops.h), each holding a value of any of the
+ * supported elementary types:
+ *  - the instance of a FUNCTION_BLOCK or PROGRAM is a range of cells, with a cell for each
+ *    VAR_INPUT, VAR_OUTPUT, VAR_IN_OUT and VAR (in the order of their declaration), followed
+ *    by its FB instances (in place), its VAR_TEMPs, and the temporaries of the expressions.
+ *    The body of the FB runs with the instance as its frame, so the instructions use the
+ *    variables of the FB (and of its FB instances) directly as operands;
+ *  - the frame of a FUNCTION is allocated on the stack of the interpreter when called, with
+ *    the result in cell 0 and the parameters (in the order of function_param_iterator_c) in
+ *    the cells 1, 2, ..., copied in and out of the frame of the caller;
+ *  - the global variables of the configuration and of the resources, and the PROGRAM
+ *    instances, are in the globals, accessed by LDG and STG (and CALLFBG).
+ * The VAR_IN_OUT of the FB instances are copied in and out of the instance when it is called,
+ * as done by generate_c.
+ *
+ * The image also holds a symbol table with the global variables and the variables of the
+ * PROGRAM instances (<RESOURCE>.<INSTANCE>.<VARIABLE>), so they may be read and written by
+ * their names.
+ *
+ * Only the subset of the language supported by generate_llvm is supported:
+ *  - POUs written in ST (plus the standard FBs written in ST, e.g. R_TRIG, CTU, SR, when
+ *    they are used);
+ *  - the elementary types BOOL, SINT, INT, DINT, LINT, USINT, UINT, UDINT, ULINT, BYTE,
+ *    WORD, DWORD, LWORD, REAL and LREAL (and the types derived from these), and FB instances;
+ *  - the standard functions *_TO_*, TRUNC, MOVE, ABS, SQRT, LN, LOG, EXP, SIN, COS, TAN,
+ *    ASIN, ACOS, ATAN, EXPT, MIN, MAX, LIMIT and SEL;
+ *  - a single configuration, with periodic tasks.
+ * Anything else (strings, arrays, structures, enumerations, TIME and dates, located variables,
+ * IL and SFC bodies, SINGLE tasks, ...) is reported as an error.
+ *
+ * The image is written in the byte order of the host running the compiler, and is refused
+ * (__BC_ERROR_VERSION) by an interpreter running on a host with another byte order.
+ *
+ * NOTE: The integer divisions (and MOD) by 0 return 0, instead of trapping.
+ */
+
+
+#include <string>
+#include <vector>
+#include <map>
+#include <limits>
+#include <typeinfo>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "generate_bytecode.hh"
+#include "../../absyntax_utils/absyntax_utils.hh"
+#include "../../main.hh" // required for ERROR() and ERROR_MSG() macros.
+#include "../stage4.hh"
+#include "../common/pou_table.hh"
+#include "../common/calculate_time.hh"
+
+/* the definitions of the image (the interpreter itself is not used here) */
+#define __BC_NO_MMAP
+#include "../../lib/C/iec_bytecode.h"
+
+
+#define STAGE4_ERROR(symbol1, symbol2, ...) {stage4err("while generating bytecode", symbol1, symbol2, __VA_ARGS__); exit(EXIT_FAILURE);}
+
+#define VALID_CVALUE(dtype, symbol)           ((symbol)->const_value._##dtype.is_valid())
+#define GET_CVALUE(dtype, symbol)             ((symbol)->const_value._##dtype.get())
+
+/* the largest operand of an instruction, i.e. the size limit of the frames, of the globals and of the constants */
+#define BC_MAX_OPERAND 0xFFFF
+
+
+
+
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+
+
+/* Parse command line options passed from main.c !! */
+int  stage4_parse_options(char *options) {return 0;}
+void stage4_reset_options(void) {}
+bool stage4_requires_stage3(void) {return true;}
+
+void stage4_print_options(void) {
+  printf("          (no options available when generating bytecode)\n");
+}
+
+
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+
+
+/* The representation of an elementary IEC 61131-3 type in a cell */
+typedef struct {
+  int  bits;
+  bool is_signed;
+  bool is_real;
+  bool is_bool;
+  int  id;            /* __BC_TYPE_*, in the symbol table */
+} bc_type_t;
+
+static const bc_type_t bc_bool__  = { 1, false, false, true,  __BC_TYPE_BOOL };
+static const bc_type_t bc_sint__  = { 8, true,  false, false, __BC_TYPE_SINT };
+static const bc_type_t bc_int__   = {16, true,  false, false, __BC_TYPE_INT  };
+static const bc_type_t bc_dint__  = {32, true,  false, false, __BC_TYPE_DINT };
+static const bc_type_t bc_lint__  = {64, true,  false, false, __BC_TYPE_LINT };
+static const bc_type_t bc_usint__ = { 8, false, false, false, __BC_TYPE_USINT};
+static const bc_type_t bc_uint__  = {16, false, false, false, __BC_TYPE_UINT };
+static const bc_type_t bc_udint__ = {32, false, false, false, __BC_TYPE_UDINT};
+static const bc_type_t bc_ulint__ = {64, false, false, false, __BC_TYPE_ULINT};
+static const bc_type_t bc_real__  = {32, true,  true,  false, __BC_TYPE_REAL };
+static const bc_type_t bc_lreal__ = {64, true,  true,  false, __BC_TYPE_LREAL};
+
+
+/* Returns the representation of a datatype, or NULL if it is not one of the supported elementary types */
+static const bc_type_t *bc_elementary_type(symbol_c *type) {
+  if (NULL == type) return NULL;
+  symbol_c *base = search_base_type_c::get_basetype_decl(type);
+  if (NULL == base) return NULL;
+
+#define BC_TYPE(type_name, bc_type)                                                                \
+  if ((typeid(*base) == typeid(type_name##_type_name_c)) || (typeid(*base) == typeid(safe##type_name##_type_name_c))) \
+    return &bc_type;
+
+  BC_TYPE(bool,  bc_bool__ )
+  BC_TYPE(sint,  bc_sint__ )
+  BC_TYPE(int,   bc_int__  )
+  BC_TYPE(dint,  bc_dint__ )
+  BC_TYPE(lint,  bc_lint__ )
+  BC_TYPE(usint, bc_usint__)
+  BC_TYPE(uint,  bc_uint__ )
+  BC_TYPE(udint, bc_udint__)
+  BC_TYPE(ulint, bc_ulint__)
+  BC_TYPE(byte,  bc_usint__)
+  BC_TYPE(word,  bc_uint__ )
+  BC_TYPE(dword, bc_udint__)
+  BC_TYPE(lword, bc_ulint__)
+  BC_TYPE(real,  bc_real__ )
+  BC_TYPE(lreal, bc_lreal__)
+#undef BC_TYPE
+  return NULL;
+}
+
+
+/* The instruction wrapping a 64 bit result to a type (-1 if none is needed) */
+static int bc_wrap_op(const bc_type_t *type) {
+  if (type->is_bool) return -1;
+  if (type->is_real) return (32 == type->bits)? __BC_OP_F32 : -1;
+  switch (type->bits) {
+    case  8: return type->is_signed? __BC_OP_SX8  : __BC_OP_ZX8;
+    case 16: return type->is_signed? __BC_OP_SX16 : __BC_OP_ZX16;
+    case 32: return type->is_signed? __BC_OP_SX32 : __BC_OP_ZX32;
+    default: return -1;
+  }
+}
+
+
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+
+
+/* The classes of the POUs and of their variables (see ../common/pou_table.hh) */
+class bc_backend_t {
+  public:
+    typedef bc_type_t type_t;
+    struct var_data_t {
+      int cell;                /* the first cell of the variable in the frame (or in the globals), -1 if not yet laid out */
+      var_data_t(void): cell(-1) {}
+    };
+    struct pou_data_t {
+      __bc_pou_t image;        /* the entry of the POU in the image */
+      pou_data_t(void) {memset(&image, 0, sizeof(image));}
+    };
+
+    static const type_t *elementary_type(symbol_c *type) {return bc_elementary_type(type);}
+    static const char *generating(void) {return "while generating bytecode";}
+    static const char *generator(void)  {return "bytecode generator";}
+};
+
+typedef stage4_var_c<bc_backend_t>       bc_var_t;
+typedef stage4_pou_c<bc_backend_t>       bc_pou_c;
+typedef stage4_pou_table_c<bc_backend_t> bc_pou_table_c;
+typedef stage4_vardecl_c<bc_backend_t>   bc_vardecl_c;
+
+
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+
+
+/* Where a variable of an elementary type, or an FB instance, is */
+typedef struct {
+  bc_var_t *global;          /* the global variable (or PROGRAM instance) holding it, NULL if in the frame */
+  unsigned cell;             /* the cell in the frame, or from the first cell of the global */
+  const bc_type_t *type;     /* NULL for FB instances */
+  bc_pou_c *fb;
+} bc_location_t;
+
+
+class generate_bytecode_c: public null_visitor_c {
+  private:
+    stage4out_c &s4o;
+    const char *builddir;
+
+    bc_pou_table_c pous;
+    std::vector<bc_var_t> globals;   /* the global variables, and then the PROGRAM instances */
+    std::vector<configuration_declaration_c *> configurations;
+
+    /* the image being generated */
+    std::vector<__bc_cell_t>    consts;
+    std::map<uint64_t, unsigned> const_index;
+    std::vector<__bc_instr_t>   code;
+    std::vector<__bc_program_t> programs;
+    std::vector<__bc_symbol_t>  symbols;
+    std::string names;
+    /* the G operands, set once the globals are laid out */
+    typedef struct {size_t pc; int operand; bc_var_t *global; unsigned offset;} relocation_t;
+    std::vector<relocation_t> relocations;
+
+    /* the POU being generated */
+    bc_pou_c *pou;
+    unsigned temp_base;        /* the first free cell, at the start of each statement */
+    unsigned temp_top;         /* the first free cell */
+    std::vector<int> labels;   /* the address of each label */
+    typedef struct {size_t pc; int label;} fixup_t;
+    std::vector<fixup_t> fixups;
+    std::vector<int> exit_labels;
+    int end_label;
+
+    /* the expression being generated */
+    const bc_type_t *expr_type;
+    unsigned dst;              /* the cell receiving the value of the expression */
+    bool evaluated;
+
+  public:
+    generate_bytecode_c(stage4out_c *s4o_ptr, const char *builddir_): s4o(*s4o_ptr), builddir(builddir_) {
+      pou = NULL;
+      temp_base = temp_top = 0;
+      end_label = -1;
+      expr_type = NULL;
+      dst = 0;
+      evaluated = false;
+      names.push_back('\0');  /* the empty name, at offset 0 */
+    }
+    ~generate_bytecode_c(void) {}
+
+
+  private:
+  /*************************/
+  /* Emitting instructions */
+  /*************************/
+    size_t emit(int op, unsigned a = 0, unsigned b = 0, unsigned c = 0) {
+      __bc_instr_t instr;
+      instr.op = op;
+      instr.a  = a;
+      instr.b  = b;
+      instr.c  = c;
+      code.push_back(instr);
+      return code.size() - 1;
+    }
+
+    int new_label(void) {labels.push_back(-1); return labels.size() - 1;}
+    void place(int label) {labels[label] = code.size();}
+    /* JMP <label>, or JZ/JNZ <cond>, <label> */
+    void jump(int op, unsigned cond, int label) {
+      fixup_t fixup = {emit(op, cond), label};
+      fixups.push_back(fixup);
+    }
+    void jump(int label) {jump(__BC_OP_JMP, 0, label);}
+
+    void begin_code(void) {
+      labels.clear();
+      fixups.clear();
+      exit_labels.clear();
+    }
+    /* Set the targets of the jumps of the code generated since begin_code() */
+    void end_code(void) {
+      for (size_t i = 0; i < fixups.size(); i++) {
+        __bc_instr_t *instr = &code[fixups[i].pc];
+        uint32_t target = labels[fixups[i].label];
+        if (__BC_OP_JMP == instr->op) {instr->a = target & 0xFFFF; instr->b = target >> 16;}
+        else                          {instr->b = target & 0xFFFF; instr->c = target >> 16;}
+      }
+      labels.clear();
+      fixups.clear();
+    }
+
+    /* An instruction with a G operand (the operand <operand> of the instruction is <offset> cells into a global) */
+    void emit_global(int op, unsigned a, unsigned b, int operand, bc_var_t *global, unsigned offset) {
+      relocation_t relocation = {emit(op, a, b), operand, global, offset};
+      relocations.push_back(relocation);
+    }
+
+    void unsupported(symbol_c *symbol, const char *what) {
+      STAGE4_ERROR(symbol, symbol, "%s not supported by the bytecode generator.", what);
+    }
+
+    unsigned add_name(const std::string &str) {
+      unsigned offset = names.size();
+      names += str;
+      names.push_back('\0');
+      return offset;
+    }
+
+
+  /******************/
+  /* Cells          */
+  /******************/
+    /* Cells of the frame, for the temporaries of a statement */
+    unsigned new_temps(unsigned count, symbol_c *symbol) {
+      unsigned first = temp_top;
+      temp_top += count;
+      if (temp_top > BC_MAX_OPERAND) STAGE4_ERROR(symbol, symbol, "The frame of this POU is too large for the bytecode (more than %d cells).", BC_MAX_OPERAND);
+      if (temp_top > pou->image.cells) pou->image.cells = temp_top;
+      return first;
+    }
+    unsigned new_temp(symbol_c *symbol) {return new_temps(1, symbol);}
+
+    unsigned konst(__bc_cell_t value, symbol_c *symbol) {
+      std::map<uint64_t, unsigned>::iterator i = const_index.find(value.u);
+      if (i != const_index.end()) return i->second;
+      if (consts.size() >= BC_MAX_OPERAND) STAGE4_ERROR(symbol, symbol, "Too many constants for the bytecode (more than %d).", BC_MAX_OPERAND);
+      consts.push_back(value);
+      return const_index[value.u] = consts.size() - 1;
+    }
+
+
+  /*************/
+  /* Constants */
+  /*************/
+    /* A value as held in a cell of a type, i.e. sign or zero extended, or rounded to float */
+    static __bc_cell_t int_cell(uint64_t value, const bc_type_t *type) {
+      __bc_cell_t cell;
+      if (type->is_real)        cell.r = type->is_signed? (double)(int64_t)value : (double)value;
+      else if (type->is_bool)   cell.i = (0 != value);
+      else if (type->bits < 64) cell.u = type->is_signed? (uint64_t)(((int64_t)(value << (64 - type->bits))) >> (64 - type->bits))
+                                                        : value & ((1ULL << type->bits) - 1);
+      else                      cell.u = value;
+      return cell;
+    }
+    static __bc_cell_t real_cell(double value, const bc_type_t *type) {
+      __bc_cell_t cell;
+      cell.r = (32 == type->bits)? (double)(float)value : value;
+      return cell;
+    }
+
+    /* The constant value of a symbol (from the constant folding in stage 3) as a type,
+     * returns false if the symbol has no constant value.
+     */
+    static bool constant(symbol_c *symbol, const bc_type_t *type, __bc_cell_t &value) {
+      if (NULL == symbol) return false;
+      if (type->is_real) {
+        if      (VALID_CVALUE(real64, symbol)) value = real_cell(GET_CVALUE(real64, symbol), type);
+        else if (VALID_CVALUE( int64, symbol)) value = real_cell(GET_CVALUE( int64, symbol), type);
+        else if (VALID_CVALUE(uint64, symbol)) value = real_cell(GET_CVALUE(uint64, symbol), type);
+        else return false;
+      } else if (type->is_bool) {
+        if      (VALID_CVALUE(  bool, symbol)) value.i = GET_CVALUE(bool, symbol)? 1 : 0;
+        else if (VALID_CVALUE( int64, symbol)) value.i = (0 != GET_CVALUE( int64, symbol))? 1 : 0;
+        else if (VALID_CVALUE(uint64, symbol)) value.i = (0 != GET_CVALUE(uint64, symbol))? 1 : 0;
+        else return false;
+      } else {
+        if      (VALID_CVALUE( int64, symbol)) value = int_cell(GET_CVALUE( int64, symbol), type);
+        else if (VALID_CVALUE(uint64, symbol)) value = int_cell(GET_CVALUE(uint64, symbol), type);
+        else if (VALID_CVALUE(  bool, symbol)) value.i = GET_CVALUE(bool, symbol)? 1 : 0;
+        else return false;
+      }
+      return true;
+    }
+
+    /* The initial value of a variable, as a constant */
+    unsigned initial_value(bc_var_t *var) {
+      __bc_cell_t value;
+      if (NULL != var->init) {
+        if (!constant(var->init, var->type, value))
+          STAGE4_ERROR(var->init, var->init, "The initial value must be a constant.");
+        return konst(value, var->init);
+      }
+      /* the default initial value of the (derived) type */
+      if (!constant(type_initial_value_c::get(var->type_name), var->type, value)) value.u = 0;
+      return konst(value, var->symbol);
+    }
+
+
+  /*************/
+  /* Variables */
+  /*************/
+    bc_var_t *find_var(symbol_c *name) {
+      bc_var_t *var = (NULL == pou)? NULL : pou->find(upper_case_name(name));
+      if (NULL == var) STAGE4_ERROR(name, name, "Undeclared variable.");
+      return var;
+    }
+
+    bc_var_t *global_var(bc_var_t *var) {
+      for (size_t i = 0; i < globals.size(); i++)
+        if ((globals[i].name == var->name) && (bc_var_t::global_vt == globals[i].vartype)) {
+          /* the same representation is enough (e.g. a VAR_EXTERNAL of a type derived from the type of the global) */
+          if ((globals[i].type != var->type) || (globals[i].fb != var->fb))
+            STAGE4_ERROR(var->symbol, var->symbol, "The datatype of the VAR_EXTERNAL is not the datatype of its global variable.");
+          return &globals[i];
+        }
+      STAGE4_ERROR(var->symbol, var->symbol, "The global variable of this VAR_EXTERNAL is not declared in the configuration.");
+      return NULL; // humour the compiler!
+    }
+
+    /* The location of a variable, and its type (or FB type) */
+    bc_location_t location(symbol_c *symbol) {
+      symbolic_variable_c   *variable = dynamic_cast<symbolic_variable_c   *>(symbol);
+      structured_variable_c *field    = dynamic_cast<structured_variable_c *>(symbol);
+      bc_location_t loc;
+
+      if (NULL != variable) {
+        bc_var_t *var = find_var(variable->var_name);
+        loc.global = (bc_var_t::external_vt == var->vartype)? global_var(var) : NULL;
+        loc.cell   = (NULL != loc.global)? 0 : var->cell;
+        loc.type   = var->type;
+        loc.fb     = var->fb;
+        return loc;
+      }
+      if (NULL != field) {
+        loc = location(field->record_variable);
+        if (NULL == loc.fb) unsupported(symbol, "Structures are");
+        bc_var_t *var = loc.fb->find(upper_case_name(field->field_selector));
+        if ((NULL == var) || (var->cell < 0) || (bc_var_t::temp_vt == var->vartype))
+          STAGE4_ERROR(symbol, symbol, "This variable of the FB instance may not be accessed.");
+        loc.cell += var->cell;
+        loc.type  = var->type;
+        loc.fb    = var->fb;
+        return loc;
+      }
+      unsupported(symbol, "Arrays, pointers and direct variables are");
+      return loc; // humour the compiler!
+    }
+
+    /* The location of a variable of an elementary type */
+    bc_location_t elementary_location(symbol_c *symbol) {
+      bc_location_t loc = location(symbol);
+      if (NULL == loc.type) unsupported(symbol, "Using FB instances as values is");
+      return loc;
+    }
+
+    /* The cell holding the value of a variable (a temporary, for the globals) */
+    unsigned read(const bc_location_t &loc, symbol_c *symbol) {
+      if (NULL == loc.global) return loc.cell;
+      unsigned t = new_temp(symbol);
+      emit_global(__BC_OP_LDG, t, 0, 1, loc.global, loc.cell);
+      return t;
+    }
+    void read(const bc_location_t &loc, unsigned cell) {
+      if (NULL != loc.global) emit_global(__BC_OP_LDG, cell, 0, 1, loc.global, loc.cell);
+      else if (cell != loc.cell) emit(__BC_OP_MOV, cell, loc.cell);
+    }
+    void write(const bc_location_t &loc, unsigned cell) {
+      if (NULL != loc.global) emit_global(__BC_OP_STG, 0, cell, 0, loc.global, loc.cell);
+      else if (cell != loc.cell) emit(__BC_OP_MOV, loc.cell, cell);
+    }
+
+    bool is_constant_var(symbol_c *symbol) {
+      symbolic_variable_c *variable = dynamic_cast<symbolic_variable_c *>(symbol);
+      return (NULL != variable) && find_var(variable->var_name)->constant;
+    }
+
+
+  /***************/
+  /* Expressions */
+  /***************/
+    void wrap(unsigned cell, const bc_type_t *type) {
+      int op = bc_wrap_op(type);
+      if (op >= 0) emit(op, cell, cell);
+    }
+
+    /* Converts a value from one type to another, as the *_TO_* standard functions */
+    void convert(unsigned to_cell, unsigned from_cell, const bc_type_t *from, const bc_type_t *to) {
+      if ((from == to) || (from->is_bool && !to->is_real)) {
+        if (from_cell != to_cell) emit(__BC_OP_MOV, to_cell, from_cell);
+        return;
+      }
+      if (to->is_bool) {emit(from->is_real? __BC_OP_R2B : __BC_OP_I2B, to_cell, from_cell); return;}
+      if (from->is_real && to->is_real) {
+        if (32 == to->bits) emit(__BC_OP_F32, to_cell, from_cell);
+        else if (from_cell != to_cell) emit(__BC_OP_MOV, to_cell, from_cell);
+        return;
+      }
+      if (to->is_real) {
+        emit((from->is_signed || from->is_bool)? __BC_OP_I2R : __BC_OP_U2R, to_cell, from_cell);
+        wrap(to_cell, to);
+        return;
+      }
+      /* rounded to the nearest integer (halfway cases away from zero), the negative values to 0 for the unsigned types */
+      if (from->is_real) emit(to->is_signed? __BC_OP_R2I : __BC_OP_R2U, to_cell, from_cell);
+      else if (from_cell != to_cell) emit(__BC_OP_MOV, to_cell, from_cell);
+      wrap(to_cell, to);
+    }
+
+    /* Evaluates an expression, as a type (NULL -> the datatype of the expression), into a cell */
+    void eval(symbol_c *expr, const bc_type_t *type, unsigned cell) {
+      const bc_type_t *own = bc_elementary_type(expr->datatype);
+      if (NULL == type) type = own;
+      if (NULL == type) STAGE4_ERROR(expr, expr, "The datatype of this expression is not supported by the bytecode generator.");
+
+      __bc_cell_t c;
+      reads_variable_c reads_variable;
+      expr->accept(reads_variable);
+      if ((!reads_variable.found || is_constant_var(expr)) && constant(expr, type, c)) {emit(__BC_OP_LDK, cell, konst(c, expr)); return;}
+      if ((NULL != own) && (own != type)) {convert(cell, operand(expr, own), own, type); return;}
+
+      const bc_type_t *saved_type = expr_type;
+      unsigned saved_dst = dst;
+      expr_type = type;
+      dst = cell;
+      evaluated = false;
+      expr->accept(*this);
+      if (!evaluated) unsupported(expr, "This expression is");
+      expr_type = saved_type;
+      dst = saved_dst;
+    }
+
+    /* A cell holding the value of an expression: the variable itself, if in the frame, or a temporary */
+    unsigned operand(symbol_c *expr, const bc_type_t *type) {
+      if ((NULL != dynamic_cast<symbolic_variable_c *>(expr)) || (NULL != dynamic_cast<structured_variable_c *>(expr))) {
+        bc_location_t loc = location(expr);
+        if ((NULL == loc.global) && (NULL != loc.type) && ((loc.type == type) || (NULL == type)) && !is_constant_var(expr))
+          return loc.cell;
+      }
+      unsigned t = new_temp(expr);
+      eval(expr, type, t);
+      return t;
+    }
+
+    /* The value of a BOOL expression */
+    unsigned condition(symbol_c *expr) {return operand(expr, &bc_bool__);}
+
+    void *done(void) {evaluated = true; return NULL;}
+
+    void *arithmetic(symbol_c *symbol, symbol_c *l_exp, symbol_c *r_exp, int int_op, int real_op) {
+      const bc_type_t *type = expr_type;
+      int op = type->is_bool? -1 : type->is_real? real_op : int_op;
+      if (op < 0) unsupported(symbol, "This operation on this datatype is");
+      unsigned l = operand(l_exp, type);
+      unsigned r = operand(r_exp, type);
+      emit(op, dst, l, r);
+      wrap(dst, type);
+      return done();
+    }
+
+    /* Integer division (DIV and MOD), returns 0 for a division by 0 */
+    void *division(symbol_c *symbol, symbol_c *l_exp, symbol_c *r_exp, int int_op, int uint_op, int real_op) {
+      const bc_type_t *type = expr_type;
+      if (type->is_real || type->is_bool) return arithmetic(symbol, l_exp, r_exp, -1, real_op);
+      return arithmetic(symbol, l_exp, r_exp, type->is_signed? int_op : uint_op, -1);
+    }
+
+    /* AND, OR, XOR on BOOL and the bit strings */
+    void *bitwise(symbol_c *symbol, symbol_c *l_exp, symbol_c *r_exp, int op) {
+      if (expr_type->is_real) unsupported(symbol, "This operation on this datatype is");
+      unsigned l = operand(l_exp, expr_type);
+      unsigned r = operand(r_exp, expr_type);
+      emit(op, dst, l, r);
+      return done();
+    }
+
+    /* <swap> evaluates r_exp <op> l_exp, for > and >= */
+    void *comparison(symbol_c *symbol, symbol_c *l_exp, symbol_c *r_exp, int int_op, int uint_op, int real_op, bool swap) {
+      const bc_type_t *type = bc_elementary_type(l_exp->datatype);
+      if (NULL == type) type = bc_elementary_type(r_exp->datatype);
+      if (NULL == type) unsupported(symbol, "Comparing values of this datatype is");
+      unsigned l = operand(l_exp, type);
+      unsigned r = operand(r_exp, type);
+      int op = type->is_real? real_op : type->is_signed? int_op : uint_op;
+      if (swap) emit(op, dst, r, l);
+      else      emit(op, dst, l, r);
+      return done();
+    }
+
+    void expt(symbol_c *symbol, symbol_c *in1, symbol_c *in2) {
+      const bc_type_t *type = expr_type;
+      if (!type->is_real) unsupported(symbol, "EXPT on this datatype is");
+      unsigned base     = operand(in1, &bc_lreal__);
+      unsigned exponent = operand(in2, &bc_lreal__);
+      emit(__BC_OP_POW, dst, base, exponent);
+      wrap(dst, type);
+    }
+
+    void math(symbol_c *symbol, symbol_c *in, int function) {
+      const bc_type_t *type = expr_type;
+      if (!type->is_real) unsupported(symbol, "This function on this datatype is");
+      emit(__BC_OP_MATH, dst, operand(in, type), function);
+      wrap(dst, type);
+    }
+
+    /* A parameter of a call to a standard function, by its name (formal calls) or position (non formal calls) */
+    symbol_c *call_param(function_invocation_c *symbol, const std::string &name, int index) {
+      if (NULL != symbol->nonformal_param_list) {
+        list_c *list = dynamic_cast<list_c *>(symbol->nonformal_param_list);
+        return ((NULL != list) && (index >= 0) && (index < list->n))? list->get_element(index) : NULL;
+      }
+      function_call_param_iterator_c call_param_iterator(symbol);
+      return call_param_iterator.search_f(name.c_str());
+    }
+
+    symbol_c *required_param(function_invocation_c *symbol, const std::string &name, int index) {
+      symbol_c *param = call_param(symbol, name, index);
+      if (NULL == param) STAGE4_ERROR(symbol, symbol, "Missing parameter %s.", name.c_str());
+      return param;
+    }
+
+    void standard_function(function_invocation_c *symbol) {
+      const bc_type_t *type = expr_type;
+      std::string name = upper_case_name(symbol->function_name);
+
+      if ((NULL != call_param(symbol, "EN", -1)) || (NULL != call_param(symbol, "ENO", -1)))
+        unsupported(symbol, "The EN and ENO parameters of the standard functions are");
+
+      if ((name.find("_TO_") != std::string::npos) || (name == "TRUNC")) {
+        symbol_c *in = required_param(symbol, "IN", 0);
+        const bc_type_t *from = bc_elementary_type(in->datatype);
+        if ((NULL == from) || (name.find("BCD") != std::string::npos)) unsupported(symbol, "This conversion is");
+        if (name != "TRUNC") {convert(dst, operand(in, from), from, type); return;}
+        if (!from->is_real || type->is_real || type->is_bool) unsupported(symbol, "TRUNC on this datatype is");
+        emit(__BC_OP_TRUNC, dst, operand(in, from));
+        wrap(dst, type);
+        return;
+      }
+      if (name == "MOVE") {eval(required_param(symbol, "IN", 0), type, dst); return;}
+      if (name == "ABS") {
+        if (type->is_real) {math(symbol, required_param(symbol, "IN", 0), __BC_MATH_ABS); return;}
+        if (type->is_bool) unsupported(symbol, "ABS on BOOL is");
+        if (!type->is_signed) {eval(required_param(symbol, "IN", 0), type, dst); return;}
+        emit(__BC_OP_ABS_I, dst, operand(required_param(symbol, "IN", 0), type));
+        wrap(dst, type);
+        return;
+      }
+      if (name == "SQRT") {math(symbol, required_param(symbol, "IN", 0), __BC_MATH_SQRT); return;}
+      if (name == "LN"  ) {math(symbol, required_param(symbol, "IN", 0), __BC_MATH_LN  ); return;}
+      if (name == "LOG" ) {math(symbol, required_param(symbol, "IN", 0), __BC_MATH_LOG ); return;}
+      if (name == "EXP" ) {math(symbol, required_param(symbol, "IN", 0), __BC_MATH_EXP ); return;}
+      if (name == "SIN" ) {math(symbol, required_param(symbol, "IN", 0), __BC_MATH_SIN ); return;}
+      if (name == "COS" ) {math(symbol, required_param(symbol, "IN", 0), __BC_MATH_COS ); return;}
+      if (name == "TAN" ) {math(symbol, required_param(symbol, "IN", 0), __BC_MATH_TAN ); return;}
+      if (name == "ASIN") {math(symbol, required_param(symbol, "IN", 0), __BC_MATH_ASIN); return;}
+      if (name == "ACOS") {math(symbol, required_param(symbol, "IN", 0), __BC_MATH_ACOS); return;}
+      if (name == "ATAN") {math(symbol, required_param(symbol, "IN", 0), __BC_MATH_ATAN); return;}
+      if (name == "EXPT") {expt(symbol, required_param(symbol, "IN1", 0), required_param(symbol, "IN2", 1)); return;}
+      if ((name == "MIN") || (name == "MAX")) {
+        if (type->is_bool) unsupported(symbol, "MIN and MAX on BOOL are");
+        int op = type->is_real? ((name == "MIN")? __BC_OP_MIN_R : __BC_OP_MAX_R)
+               : (name == "MIN")? (type->is_signed? __BC_OP_MIN_I : __BC_OP_MIN_U)
+                                : (type->is_signed? __BC_OP_MAX_I : __BC_OP_MAX_U);
+        symbol_c *in = call_param(symbol, "IN2", 1);
+        if (NULL == in) {eval(required_param(symbol, "IN1", 0), type, dst); return;}
+        unsigned v = operand(required_param(symbol, "IN1", 0), type);
+        for (int i = 2; NULL != in; i++) {
+          unsigned r = operand(in, type);
+          char next_name[16];
+          snprintf(next_name, sizeof(next_name), "IN%d", i + 1);
+          in = call_param(symbol, next_name, i);
+          /* only the last result goes to dst, which may be read by the parameters */
+          unsigned result = (NULL == in)? dst : new_temp(symbol);
+          emit(op, result, v, r);
+          v = result;
+        }
+        return;
+      }
+      if (name == "LIMIT") {
+        if (type->is_bool) unsupported(symbol, "LIMIT on BOOL is");
+        unsigned mn = operand(required_param(symbol, "MN", 0), type);
+        unsigned in = operand(required_param(symbol, "IN", 1), type);
+        unsigned mx = operand(required_param(symbol, "MX", 2), type);
+        unsigned t  = new_temp(symbol);
+        emit(type->is_real? __BC_OP_MIN_R : type->is_signed? __BC_OP_MIN_I : __BC_OP_MIN_U, t, in, mx);
+        emit(type->is_real? __BC_OP_MAX_R : type->is_signed? __BC_OP_MAX_I : __BC_OP_MAX_U, dst, t, mn);
+        return;
+      }
+      if (name == "SEL") {
+        unsigned g = condition(required_param(symbol, "G", 0));
+        unsigned result = dst;
+        int in0_label = new_label(), end_label = new_label();
+        jump(__BC_OP_JZ, g, in0_label);
+        eval(required_param(symbol, "IN1", 2), type, result);
+        jump(end_label);
+        place(in0_label);
+        eval(required_param(symbol, "IN0", 1), type, result);
+        place(end_label);
+        return;
+      }
+      unsupported(symbol, "This standard function is");
+    }
+
+    void call_function(function_invocation_c *symbol, bc_pou_c *function) {
+      function_param_iterator_c fp_iterator(function->decl);
+      function_call_param_iterator_c function_call_param_iterator(symbol);
+      identifier_c *param_name;
+      std::vector<std::pair<unsigned, symbol_c *> > outputs;  /* the cells copied out of the frame, and where to */
+      bc_var_t *en = function->find("EN");
+      bool has_en = (NULL != en) && (bc_var_t::input_vt == en->vartype);
+
+      /* the result and the parameters, in consecutive cells */
+      unsigned params = 0;
+      for (function_param_iterator_c count(function->decl); NULL != count.next(); ) params++;
+      unsigned base = new_temps(1 + params, symbol);
+      for (unsigned i = 1; NULL != (param_name = fp_iterator.next()); i++) {
+        bc_var_t *param = function->find(upper_case_name(param_name));
+        if (NULL == param) ERROR;
+
+        /* Get the value from a foo(<param_name> = <param_value>) style call */
+        symbol_c *param_value = function_call_param_iterator.search_f(param_name);
+        /* Get the value from a foo(<param_value>) style call */
+        /* When using the informal invocation style, user can not pass values to EN or ENO parameters if these
+         * were implicitly defined!
+         */
+        if ((param_value == NULL) && !fp_iterator.is_en_eno_param_implicit())
+          param_value = function_call_param_iterator.next_nf();
+
+        switch (fp_iterator.param_direction()) {
+          case function_param_iterator_c::direction_in:
+            if (NULL != param_value) eval(param_value, param->type, base + i);
+            else                     emit(__BC_OP_LDK, base + i, initial_value(param));
+            break;
+          case function_param_iterator_c::direction_out:
+            if (NULL == param_value) break;
+            /* a FUNCTION that is not enabled leaves its outputs untouched */
+            if (has_en) read(elementary_location(param_value), base + i);
+            outputs.push_back(std::make_pair(base + i, param_value));
+            break;
+          case function_param_iterator_c::direction_inout: {
+            if (NULL == param_value) STAGE4_ERROR(symbol, symbol, "Missing VAR_IN_OUT parameter %s.", param_name->value);
+            bc_location_t loc = elementary_location(param_value);
+            if (loc.type != param->type) STAGE4_ERROR(param_value, param_value, "The datatype of this variable is not the datatype of the VAR_IN_OUT.");
+            read(loc, base + i);
+            outputs.push_back(std::make_pair(base + i, param_value));
+            break;
+          }
+          default:
+            break;
+        }
+      }
+
+      emit(__BC_OP_CALL, base, function->index);
+
+      for (size_t i = 0; i < outputs.size(); i++) {
+        bc_location_t loc = elementary_location(outputs[i].second);
+        const bc_type_t *type = bc_elementary_type(outputs[i].second->datatype);
+        if (NULL == type) type = loc.type;
+        if (type != loc.type) {
+          unsigned t = new_temp(symbol);
+          convert(t, outputs[i].first, type, loc.type);
+          write(loc, t);
+        } else {
+          write(loc, outputs[i].first);
+        }
+      }
+      if (NULL != function->return_type) convert(dst, base, function->return_type, expr_type);
+    }
+
+
+  public:
+  /********************/
+  /* 2.1.6 - Pragmas  */
+  /********************/
+    void *visit(enable_code_generation_pragma_c * symbol)   {code_enabled = true;  return NULL;}
+    void *visit(disable_code_generation_pragma_c * symbol)  {code_enabled = false; return NULL;}
+
+  /**************************************/
+  /* B.1.5 - Program organization units */
+  /**************************************/
+    void *visit(library_c *symbol) {
+      code_enabled = true;
+      for (int i = 0; i < symbol->n; i++) symbol->get_element(i)->accept(*this);
+      generate_image();
+      return NULL;
+    }
+
+    void *visit(function_declaration_c *symbol) {
+      pous.add(bc_pou_c::function_pk, symbol->derived_function_name, symbol, symbol->var_declarations_list, symbol->function_body, code_enabled);
+      return NULL;
+    }
+    void *visit(function_block_declaration_c *symbol) {
+      pous.add(bc_pou_c::function_block_pk, symbol->fblock_name, symbol, symbol->var_declarations, symbol->fblock_body, code_enabled);
+      return NULL;
+    }
+    void *visit(program_declaration_c *symbol) {
+      pous.add(bc_pou_c::program_pk, symbol->program_type_name, symbol, symbol->var_declarations, symbol->function_block_body, code_enabled);
+      return NULL;
+    }
+    void *visit(configuration_declaration_c *symbol) {
+      if (code_enabled) configurations.push_back(symbol);
+      return NULL;
+    }
+
+  private:
+    bool code_enabled;
+
+
+  /*****************************/
+  /* Generating the POUs' code */
+  /*****************************/
+    void layout(bc_var_t *var, unsigned &cells) {
+      var->cell = cells;
+      cells += (NULL != var->fb)? var->fb->image.cells : 1;
+      if (cells > BC_MAX_OPERAND) STAGE4_ERROR(var->symbol, var->symbol, "The frame of this POU is too large for the bytecode (more than %d cells).", BC_MAX_OPERAND);
+    }
+
+    void begin_pou(bc_pou_c *pou_, unsigned cells) {
+      pou = pou_;
+      pou->image.cells = temp_base = temp_top = cells;
+      pou->image.body  = code.size();
+      begin_code();
+      end_label = new_label();
+    }
+    void end_pou(void) {
+      place(end_label);
+      emit(__BC_OP_RET);
+      end_code();
+      pou->image.body_size = code.size() - pou->image.body;
+      pou = NULL;
+    }
+
+    /* The EN/ENO handling of FUNCTIONs and FBs: if (!EN) {ENO = FALSE; goto <disabled_label>;} */
+    void check_en(int disabled_label) {
+      bc_var_t *en  = pou->find("EN");
+      bc_var_t *eno = pou->find("ENO");
+      if ((NULL == en) || (en->vartype != bc_var_t::input_vt)) return;
+      int enabled_label = new_label();
+      jump(__BC_OP_JNZ, en->cell, enabled_label);
+      if ((NULL != eno) && (eno->vartype == bc_var_t::output_vt)) emit(__BC_OP_LDK, eno->cell, konst(int_cell(0, &bc_bool__), eno->symbol));
+      jump(disabled_label);
+      place(enabled_label);
+    }
+    void set_eno(void) {
+      bc_var_t *en  = pou->find("EN");
+      bc_var_t *eno = pou->find("ENO");
+      if ((NULL == en) || (en->vartype != bc_var_t::input_vt)) return;
+      if ((NULL != eno) && (eno->vartype == bc_var_t::output_vt)) emit(__BC_OP_LDK, eno->cell, konst(int_cell(1, &bc_bool__), eno->symbol));
+    }
+
+    void generate_function(bc_pou_c *function) {
+      function_param_iterator_c fp_iterator(function->decl);
+      identifier_c *param_name;
+      unsigned cells = 1;  /* cell 0 holds the result */
+
+      bc_var_t *result = function->find(function->name);
+      if ((NULL != result) && (bc_var_t::result_vt == result->vartype)) result->cell = 0;
+      while ((param_name = fp_iterator.next()) != NULL) {
+        bc_var_t *param = function->find(upper_case_name(param_name));
+        if (NULL == param) ERROR;
+        layout(param, cells);
+      }
+      function->image.params = cells - 1;
+      for (size_t i = 0; i < function->vars.size(); i++)
+        if ((bc_var_t::private_vt == function->vars[i].vartype) || (bc_var_t::temp_vt == function->vars[i].vartype))
+          layout(&function->vars[i], cells);
+
+      begin_pou(function, cells);
+      for (size_t i = 0; i < function->vars.size(); i++) {
+        bc_var_t *var = &function->vars[i];
+        if ((bc_var_t::private_vt == var->vartype) || (bc_var_t::temp_vt == var->vartype) || (bc_var_t::result_vt == var->vartype))
+          emit(__BC_OP_LDK, var->cell, initial_value(var));
+      }
+      /* a FUNCTION that is not enabled leaves its outputs untouched (the caller copies in their values) */
+      check_en(end_label);
+      for (size_t i = 0; i < function->vars.size(); i++) {
+        bc_var_t *var = &function->vars[i];
+        if ((bc_var_t::output_vt == var->vartype) && (var->name != "ENO"))
+          emit(__BC_OP_LDK, var->cell, initial_value(var));
+      }
+      set_eno();
+      function->body->accept(*this);
+      end_pou();
+    }
+
+    void generate_fb(bc_pou_c *fb) {
+      unsigned cells = 0, nested = 0;
+      for (size_t i = 0; i < fb->vars.size(); i++)
+        switch (fb->vars[i].vartype) {
+          case bc_var_t::input_vt  :
+          case bc_var_t::output_vt :
+          case bc_var_t::inout_vt  :
+          case bc_var_t::private_vt: if (NULL == fb->vars[i].fb) layout(&fb->vars[i], cells); break;
+          default                  : break;
+        }
+      for (size_t i = 0; i < fb->vars.size(); i++)
+        if ((NULL != fb->vars[i].fb) && (bc_var_t::private_vt == fb->vars[i].vartype)) {
+          layout(&fb->vars[i], cells);
+          if (fb->vars[i].fb->image.cells > nested) nested = fb->vars[i].fb->image.cells;
+        } else if ((NULL != fb->vars[i].fb) && (bc_var_t::external_vt != fb->vars[i].vartype)) {
+          unsupported(fb->vars[i].symbol, "FB instances declared as parameters or VAR_TEMP are");
+        }
+      for (size_t i = 0; i < fb->vars.size(); i++)
+        if (bc_var_t::temp_vt == fb->vars[i].vartype) layout(&fb->vars[i], cells);
+
+      /* the body */
+      begin_pou(fb, cells);
+      for (size_t i = 0; i < fb->vars.size(); i++)
+        if (bc_var_t::temp_vt == fb->vars[i].vartype) emit(__BC_OP_LDK, fb->vars[i].cell, initial_value(&fb->vars[i]));
+      check_en(end_label);
+      set_eno();
+      fb->body->accept(*this);
+      end_pou();
+      /* an instance is larger than the instances nested in it, which the interpreter checks to be sure the nesting ends */
+      if (fb->image.cells <= nested) fb->image.cells = nested + 1;
+
+      /* the initialisation of the instances */
+      fb->image.init = code.size();
+      for (size_t i = 0; i < fb->vars.size(); i++) {
+        bc_var_t *var = &fb->vars[i];
+        if ((var->cell < 0) || (bc_var_t::temp_vt == var->vartype)) continue;
+        if (NULL != var->fb) emit(__BC_OP_INITFB, var->cell, var->fb->index);
+        else                 emit(__BC_OP_LDK, var->cell, initial_value(var));
+      }
+      emit(__BC_OP_RET);
+      fb->image.init_size = code.size() - fb->image.init;
+    }
+
+
+  /*******************************/
+  /* Generating the configuration */
+  /*******************************/
+    void collect_globals(symbol_c *global_var_declarations) {
+      if (NULL == global_var_declarations) return;
+      size_t first = globals.size();
+      bc_vardecl_c vardecl(pous, globals, bc_var_t::global_vt, false);
+      global_var_declarations->accept(vardecl);
+      for (size_t i = first; i < globals.size(); i++)
+        for (size_t j = 0; j < i; j++)
+          if (globals[i].name == globals[j].name)
+            STAGE4_ERROR(globals[i].symbol, globals[i].symbol, "The bytecode generator requires the global variables to have distinct names.");
+    }
+
+    /* The PROGRAM instances of each resource, with the ticks between the runs of its task */
+    void collect_programs(std::string resource_name, single_resource_declaration_c *resource, unsigned long long common_ticktime) {
+      std::map<std::string, unsigned long long> task_ticks;  /* the ticks between the runs of each task */
+      list_c *tasks         = dynamic_cast<list_c *>(resource->task_configuration_list);
+      list_c *program_confs = dynamic_cast<list_c *>(resource->program_configuration_list);
+
+      for (int i = 0; (NULL != tasks) && (i < tasks->n); i++) {
+        task_configuration_c  *task = dynamic_cast<task_configuration_c  *>(tasks->get_element(i));
+        task_initialization_c *task_init = dynamic_cast<task_initialization_c *>(task->task_initialization);
+        if (NULL != task_init->single_data_source) unsupported(task, "SINGLE tasks are");
+        unsigned long long interval = calculate_time(task_init->interval_data_source);
+        task_ticks[upper_case_name(task->task_name)] = (0 == interval)? 1 : interval / common_ticktime;
+      }
+
+      for (int i = 0; (NULL != program_confs) && (i < program_confs->n); i++) {
+        program_configuration_c *program = dynamic_cast<program_configuration_c *>(program_confs->get_element(i));
+        if (NULL != program->prog_conf_elements) unsupported(program, "The configuration elements of PROGRAM instances are");
+        bc_pou_c *type = pous.get(program->program_type_name, bc_pou_c::program_pk);
+        if (NULL == type) STAGE4_ERROR(program->program_type_name, program->program_type_name, "Unknown PROGRAM type.");
+
+        bc_var_t var;
+        var.name      = resource_name + "." + upper_case_name(program->program_name);
+        var.vartype   = bc_var_t::private_vt;
+        var.symbol    = program->program_name;
+        var.type_name = program->program_type_name;
+        var.type      = NULL;
+        var.fb        = type;
+        var.init      = NULL;
+        var.constant  = false;
+        var.cell      = -1;
+        globals.push_back(var);
+
+        unsigned long long ticks = (NULL == program->task_name)? 1 : task_ticks[upper_case_name(program->task_name)];
+        if (ticks > 0xFFFFFFFFULL) STAGE4_ERROR(program, program, "The interval of the task is too long for the bytecode.");
+        __bc_program_t entry;
+        entry.name     = add_name(var.name);
+        entry.pou      = type->index;
+        entry.instance = 0;  /* set once the globals are laid out */
+        entry.period   = ticks;
+        programs.push_back(entry);
+      }
+    }
+
+    /* The tick of the resources, i.e. the GCD of the intervals of the tasks (in ns) */
+    static unsigned long long gcd(unsigned long long a, unsigned long long b) {
+      while (0 != b) {unsigned long long t = a % b; a = b; b = t;}
+      return a;
+    }
+
+    unsigned long long common_ticktime(configuration_declaration_c *configuration) {
+      unsigned long long ticktime = 0;
+      std::vector<single_resource_declaration_c *> resources = get_resources(configuration, NULL);
+      for (size_t r = 0; r < resources.size(); r++) {
+        list_c *tasks = dynamic_cast<list_c *>(resources[r]->task_configuration_list);
+        for (int i = 0; (NULL != tasks) && (i < tasks->n); i++) {
+          task_configuration_c  *task = dynamic_cast<task_configuration_c  *>(tasks->get_element(i));
+          task_initialization_c *task_init = dynamic_cast<task_initialization_c *>(task->task_initialization);
+          ticktime = gcd(ticktime, calculate_time(task_init->interval_data_source));
+        }
+      }
+      return ticktime;
+    }
+
+    std::vector<single_resource_declaration_c *> get_resources(configuration_declaration_c *configuration, std::vector<std::string> *resource_names) {
+      std::vector<single_resource_declaration_c *> resources;
+      single_resource_declaration_c *single = dynamic_cast<single_resource_declaration_c *>(configuration->resource_declarations);
+      list_c *list = dynamic_cast<list_c *>(configuration->resource_declarations);
+      if (NULL != single) {
+        resources.push_back(single);
+        if (NULL != resource_names) resource_names->push_back("RESOURCE");
+      }
+      for (int i = 0; (NULL != list) && (i < list->n); i++) {
+        resource_declaration_c *resource = dynamic_cast<resource_declaration_c *>(list->get_element(i));
+        single = dynamic_cast<single_resource_declaration_c *>(resource->resource_declaration);
+        if (NULL == single) ERROR;
+        resources.push_back(single);
+        if (NULL != resource_names) resource_names->push_back(upper_case_name(resource->resource_name));
+      }
+      return resources;
+    }
+
+    /* The symbols of the elementary variables of an instance (and of its FB instances) in the globals */
+    void add_symbols(const std::string &prefix, bc_pou_c *fb, unsigned base) {
+      for (size_t i = 0; i < fb->vars.size(); i++) {
+        bc_var_t *var = &fb->vars[i];
+        if ((var->cell < 0) || (bc_var_t::temp_vt == var->vartype)) continue;
+        if (NULL != var->fb) {add_symbols(prefix + var->name + ".", var->fb, base + var->cell); continue;}
+        __bc_symbol_t symbol = {add_name(prefix + var->name), base + var->cell, (uint32_t)var->type->id};
+        symbols.push_back(symbol);
+      }
+    }
+
+    /* Lay out the globals: the elementary global variables, then the FB instances and the PROGRAM instances */
+    unsigned layout_globals(void) {
+      unsigned cells = 0;
+      for (int pass = 0; pass < 2; pass++)
+        for (size_t i = 0; i < globals.size(); i++)
+          if ((NULL == globals[i].fb) == (0 == pass)) {
+            globals[i].cell = cells;
+            cells += (NULL != globals[i].fb)? globals[i].fb->image.cells : 1;
+            if (cells > BC_MAX_OPERAND) STAGE4_ERROR(globals[i].symbol, globals[i].symbol, "The global variables are too large for the bytecode (more than %d cells).", BC_MAX_OPERAND);
+          }
+      for (size_t i = 0; i < relocations.size(); i++) {
+        __bc_instr_t *instr = &code[relocations[i].pc];
+        unsigned cell = relocations[i].global->cell + relocations[i].offset;
+        switch (relocations[i].operand) {
+          case 0 : instr->a = cell; break;
+          case 1 : instr->b = cell; break;
+          default: instr->c = cell; break;
+        }
+      }
+      return cells;
+    }
+
+    /* The code initialising the globals and the PROGRAM instances, and their symbols */
+    void generate_globals_init(uint32_t &init, uint32_t &init_size) {
+      size_t program = 0;
+      init = code.size();
+      for (size_t i = 0; i < globals.size(); i++) {
+        bc_var_t *var = &globals[i];
+        if (NULL == var->fb) {
+          emit(__BC_OP_LDK, var->cell, initial_value(var));
+          __bc_symbol_t symbol = {add_name(var->name), (uint32_t)var->cell, (uint32_t)var->type->id};
+          symbols.push_back(symbol);
+        } else {
+          emit(__BC_OP_INITFB, var->cell, var->fb->index);
+          add_symbols(var->name + ".", var->fb, var->cell);
+          if (bc_var_t::private_vt == var->vartype) programs[program++].instance = var->cell;
+        }
+      }
+      emit(__BC_OP_RET);
+      init_size = code.size() - init;
+    }
+
+
+    template<typename element_type> static void append(std::string &image, const std::vector<element_type> &elements) {
+      if (!elements.empty()) image.append((const char *)&elements[0], elements.size() * sizeof(element_type));
+    }
+
+    void generate_image(void) {
+      __bc_header_t header;
+      memset(&header, 0, sizeof(header));
+
+      if (configurations.size() > 1)
+        STAGE4_ERROR(configurations[1], configurations[1], "The bytecode generator supports a single CONFIGURATION.");
+      for (size_t c = 0; c < configurations.size(); c++) {
+        collect_globals(configurations[c]->global_var_declarations);
+        list_c *list = dynamic_cast<list_c *>(configurations[c]->resource_declarations);
+        for (int i = 0; (NULL != list) && (i < list->n); i++)
+          collect_globals(dynamic_cast<resource_declaration_c *>(list->get_element(i))->global_var_declarations);
+      }
+      for (std::map<std::string, bc_pou_c *>::iterator i = pous.pous.begin(); i != pous.pous.end(); i++)
+        if (i->second->enabled) pous.collect(i->second, i->second->decl);
+      for (size_t c = 0; c < configurations.size(); c++) {
+        std::vector<std::string> resource_names;
+        std::vector<single_resource_declaration_c *> resources = get_resources(configurations[c], &resource_names);
+        header.common_ticktime = common_ticktime(configurations[c]);
+        for (size_t r = 0; r < resources.size(); r++)
+          collect_programs(resource_names[r], resources[r], header.common_ticktime);
+      }
+
+      /* the FUNCTIONs first called by the code being generated are collected (and generated) after it */
+      for (size_t i = 0; i < pous.collected.size(); i++) {
+        bc_pou_c *p = pous.collected[i];
+        if (bc_pou_c::function_pk != p->kind) generate_fb(p);
+        else                                  generate_function(p);
+      }
+      if (pous.collected.size() > BC_MAX_OPERAND)
+        STAGE4_ERROR(pous.collected[0]->decl, pous.collected[0]->decl, "Too many POUs for the bytecode (more than %d).", BC_MAX_OPERAND);
+
+      header.global_cells = layout_globals();
+      generate_globals_init(header.init, header.init_size);
+
+      std::vector<__bc_pou_t> pou_entries;
+      for (size_t i = 0; i < pous.collected.size(); i++) {
+        pous.collected[i]->image.name = add_name(pous.collected[i]->name);
+        pous.collected[i]->image.kind = (bc_pou_c::function_pk == pous.collected[i]->kind)? __BC_FUNCTION
+                                      : (bc_pou_c::program_pk  == pous.collected[i]->kind)? __BC_PROGRAM : __BC_FUNCTION_BLOCK;
+        pou_entries.push_back(pous.collected[i]->image);
+      }
+
+      memcpy(header.magic, __BC_MAGIC, sizeof(header.magic));
+      header.version       = __BC_VERSION;
+      header.byte_order    = __BC_BYTE_ORDER;
+      header.const_count   = consts.size();
+      header.code_size     = code.size();
+      header.pou_count     = pou_entries.size();
+      header.program_count = programs.size();
+      header.symbol_count  = symbols.size();
+      header.names_size    = names.size();
+
+      std::string image((const char *)&header, sizeof(header));
+      append(image, consts);
+      append(image, code);
+      append(image, pou_entries);
+      append(image, programs);
+      append(image, symbols);
+      image += names;
+
+      stage4out_c iecb(builddir, "PLC", "iecb");
+      iecb.print(image);
+    }
+
+
+  public:
+  /***************************************/
+  /* B.3 - Language ST (Structured Text) */
+  /***************************************/
+  /***********************/
+  /* B 3.1 - Expressions */
+  /***********************/
+    void *variable(symbol_c *symbol) {
+      bc_location_t loc = elementary_location(symbol);
+      if (loc.type == expr_type) read(loc, dst);
+      else                       convert(dst, read(loc, symbol), loc.type, expr_type);
+      return done();
+    }
+    void *visit(symbolic_variable_c   *symbol) {return variable(symbol);}
+    void *visit(structured_variable_c *symbol) {return variable(symbol);}
+
+    void *visit(     or_expression_c *symbol) {return bitwise(symbol, symbol->l_exp, symbol->r_exp, __BC_OP_OR );}
+    void *visit(    xor_expression_c *symbol) {return bitwise(symbol, symbol->l_exp, symbol->r_exp, __BC_OP_XOR);}
+    void *visit(    and_expression_c *symbol) {return bitwise(symbol, symbol->l_exp, symbol->r_exp, __BC_OP_AND);}
+    void *visit(    equ_expression_c *symbol) {return comparison(symbol, symbol->l_exp, symbol->r_exp, __BC_OP_EQ_I, __BC_OP_EQ_I, __BC_OP_EQ_R, false);}
+    void *visit( notequ_expression_c *symbol) {return comparison(symbol, symbol->l_exp, symbol->r_exp, __BC_OP_NE_I, __BC_OP_NE_I, __BC_OP_NE_R, false);}
+    void *visit(     lt_expression_c *symbol) {return comparison(symbol, symbol->l_exp, symbol->r_exp, __BC_OP_LT_I, __BC_OP_LT_U, __BC_OP_LT_R, false);}
+    void *visit(     gt_expression_c *symbol) {return comparison(symbol, symbol->l_exp, symbol->r_exp, __BC_OP_LT_I, __BC_OP_LT_U, __BC_OP_LT_R, true );}
+    void *visit(     le_expression_c *symbol) {return comparison(symbol, symbol->l_exp, symbol->r_exp, __BC_OP_LE_I, __BC_OP_LE_U, __BC_OP_LE_R, false);}
+    void *visit(     ge_expression_c *symbol) {return comparison(symbol, symbol->l_exp, symbol->r_exp, __BC_OP_LE_I, __BC_OP_LE_U, __BC_OP_LE_R, true );}
+    void *visit(    add_expression_c *symbol) {return arithmetic(symbol, symbol->l_exp, symbol->r_exp, __BC_OP_ADD_I, __BC_OP_ADD_R);}
+    void *visit(    sub_expression_c *symbol) {return arithmetic(symbol, symbol->l_exp, symbol->r_exp, __BC_OP_SUB_I, __BC_OP_SUB_R);}
+    void *visit(    mul_expression_c *symbol) {return arithmetic(symbol, symbol->l_exp, symbol->r_exp, __BC_OP_MUL_I, __BC_OP_MUL_R);}
+    void *visit(    div_expression_c *symbol) {return division(symbol, symbol->l_exp, symbol->r_exp, __BC_OP_DIV_I, __BC_OP_DIV_U, __BC_OP_DIV_R);}
+    void *visit(    mod_expression_c *symbol) {return division(symbol, symbol->l_exp, symbol->r_exp, __BC_OP_MOD_I, __BC_OP_MOD_U, -1);}
+    void *visit(  power_expression_c *symbol) {expt(symbol, symbol->l_exp, symbol->r_exp); return done();}
+    void *visit(    neg_expression_c *symbol) {
+      if (expr_type->is_bool) unsupported(symbol, "This operation on this datatype is");
+      emit(expr_type->is_real? __BC_OP_NEG_R : __BC_OP_NEG_I, dst, operand(symbol->exp, expr_type));
+      wrap(dst, expr_type);
+      return done();
+    }
+    void *visit(    not_expression_c *symbol) {
+      if (expr_type->is_real) unsupported(symbol, "This operation on this datatype is");
+      emit(expr_type->is_bool? __BC_OP_NOT_B : __BC_OP_NOT, dst, operand(symbol->exp, expr_type));
+      wrap(dst, expr_type);
+      return done();
+    }
+
+    void *visit(function_invocation_c *symbol) {
+      bc_pou_c *function = pous.find_function(symbol->called_function_declaration);
+      if (NULL != function) {
+        if (NULL == function->return_type) unsupported(symbol, "Calling VOID FUNCTIONs in expressions is");
+        call_function(symbol, function);
+      } else {
+        standard_function(symbol);
+      }
+      return done();
+    }
+
+
+  /********************/
+  /* B 3.2 Statements */
+  /********************/
+    void *visit(statement_list_c *symbol) {
+      for (int i = 0; i < symbol->n; i++) {
+        symbol->get_element(i)->accept(*this);
+        temp_top = temp_base;
+      }
+      return NULL;
+    }
+
+    /*********************************/
+    /* B 3.2.1 Assignment Statements */
+    /*********************************/
+    void *visit(assignment_statement_c *symbol) {
+      bc_location_t loc = elementary_location(symbol->l_exp);
+      if (NULL == loc.global) {eval(symbol->r_exp, loc.type, loc.cell); return NULL;}
+      write(loc, operand(symbol->r_exp, loc.type));
+      return NULL;
+    }
+
+    /*****************************************/
+    /* B 3.2.2 Subprogram Control Statements */
+    /*****************************************/
+    void *visit(return_statement_c *symbol) {
+      jump(end_label);
+      return NULL;
+    }
+
+    void *visit(fb_invocation_c *symbol) {
+      bc_location_t instance = location(symbol->fb_name);
+      bc_pou_c *fb = instance.fb;
+      if (NULL == fb) unsupported(symbol, "Calling this FB is");
+
+      function_param_iterator_c fp_iterator(fb->decl);
+      function_call_param_iterator_c function_call_param_iterator(symbol);
+      identifier_c *param_name;
+
+      /* the inputs (and the in_outs, copied in and out of the instance as in generate_c) */
+      while ((param_name = fp_iterator.next()) != NULL) {
+        symbol_c *param_value = function_call_param_iterator.search_f(param_name);
+        if ((param_value == NULL) && !fp_iterator.is_en_eno_param_implicit())
+          param_value = function_call_param_iterator.next_nf();
+        if (param_value == NULL) continue;
+        function_param_iterator_c::param_direction_t param_direction = fp_iterator.param_direction();
+        if ((param_direction != function_param_iterator_c::direction_in) && (param_direction != function_param_iterator_c::direction_inout)) continue;
+        bc_var_t *param = fb->find(upper_case_name(param_name));
+        if ((NULL == param) || (NULL == param->type)) unsupported(param_value, "Passing FB instances as parameters is");
+        bc_location_t field = instance;
+        field.cell += param->cell;
+        field.type  = param->type;
+        field.fb    = NULL;
+        if (NULL == field.global) eval(param_value, param->type, field.cell);
+        else                      write(field, operand(param_value, param->type));
+      }
+
+      if (NULL == instance.global) emit(__BC_OP_CALLFB, instance.cell, fb->index);
+      else                         emit_global(__BC_OP_CALLFBG, 0, fb->index, 0, instance.global, instance.cell);
+
+      /* the outputs */
+      fp_iterator.reset();
+      function_call_param_iterator.reset();
+      while ((param_name = fp_iterator.next()) != NULL) {
+        symbol_c *param_value = function_call_param_iterator.search_f(param_name);
+        if ((param_value == NULL) && !fp_iterator.is_en_eno_param_implicit())
+          param_value = function_call_param_iterator.next_nf();
+        if (param_value == NULL) continue;
+        function_param_iterator_c::param_direction_t param_direction = fp_iterator.param_direction();
+        if ((param_direction != function_param_iterator_c::direction_out) && (param_direction != function_param_iterator_c::direction_inout)) continue;
+        bc_var_t *param = fb->find(upper_case_name(param_name));
+        if ((NULL == param) || (NULL == param->type)) unsupported(param_value, "Passing FB instances as parameters is");
+        bc_location_t field = instance;
+        field.cell += param->cell;
+        bc_location_t loc = elementary_location(param_value);
+        unsigned v = read(field, symbol);
+        if (param->type != loc.type) {
+          unsigned t = new_temp(symbol);
+          convert(t, v, param->type, loc.type);
+          v = t;
+        }
+        write(loc, v);
+      }
+      return NULL;
+    }
+
+    /***********************************/
+    /* B 3.2.3 Selection Statements */
+    /***********************************/
+    /* if (<match>) {<statement_list>; goto <end_label>;}, and continue with the code for !<match> */
+    void branch(unsigned match, symbol_c *statement_list, int end_label) {
+      int else_label = new_label();
+      jump(__BC_OP_JZ, match, else_label);
+      if (NULL != statement_list) statement_list->accept(*this);
+      jump(end_label);
+      place(else_label);
+    }
+
+    void *visit(if_statement_c *symbol) {
+      int end_label = new_label();
+      branch(condition(symbol->expression), symbol->statement_list, end_label);
+      list_c *elseif_list = dynamic_cast<list_c *>(symbol->elseif_statement_list);
+      for (int i = 0; (NULL != elseif_list) && (i < elseif_list->n); i++) {
+        elseif_statement_c *elseif = dynamic_cast<elseif_statement_c *>(elseif_list->get_element(i));
+        temp_top = temp_base;
+        branch(condition(elseif->expression), elseif->statement_list, end_label);
+      }
+      if (NULL != symbol->else_statement_list) symbol->else_statement_list->accept(*this);
+      place(end_label);
+      return NULL;
+    }
+
+    void *visit(case_statement_c *symbol) {
+      const bc_type_t *type = bc_elementary_type(symbol->expression->datatype);
+      if ((NULL == type) || type->is_real) unsupported(symbol->expression, "CASE on this datatype is");
+      /* the selector is kept while the statements of the elements run */
+      unsigned saved_base = temp_base;
+      unsigned selector = new_temp(symbol);
+      eval(symbol->expression, type, selector);
+      temp_base = temp_top;
+      int end_label = new_label();
+
+      list_c *elements = dynamic_cast<list_c *>(symbol->case_element_list);
+      for (int i = 0; (NULL != elements) && (i < elements->n); i++) {
+        case_element_c *element = dynamic_cast<case_element_c *>(elements->get_element(i));
+        list_c *case_list = dynamic_cast<list_c *>(element->case_list);
+        int body_label = new_label(), next_label = new_label();
+        for (int j = 0; (NULL != case_list) && (j < case_list->n); j++) {
+          symbol_c *item = case_list->get_element(j);
+          subrange_c *range = dynamic_cast<subrange_c *>(item);
+          unsigned m = new_temp(item);
+          if (NULL != range) {
+            unsigned upper = new_temp(item);
+            emit(type->is_signed? __BC_OP_LE_I : __BC_OP_LE_U, m, operand(range->lower_limit, type), selector);
+            emit(type->is_signed? __BC_OP_LE_I : __BC_OP_LE_U, upper, selector, operand(range->upper_limit, type));
+            emit(__BC_OP_AND, m, m, upper);
+          } else {
+            emit(__BC_OP_EQ_I, m, selector, operand(item, type));
+          }
+          jump(__BC_OP_JNZ, m, body_label);
+          temp_top = temp_base;
+        }
+        jump(next_label);
+        place(body_label);
+        if (NULL != element->statement_list) element->statement_list->accept(*this);
+        jump(end_label);
+        place(next_label);
+      }
+      if (NULL != symbol->statement_list) symbol->statement_list->accept(*this);
+      place(end_label);
+      temp_base = saved_base;
+      return NULL;
+    }
+
+    /********************************/
+    /* B 3.2.4 Iteration Statements */
+    /********************************/
+    void *visit(for_statement_c *symbol) {
+      bc_location_t control = elementary_location(symbol->control_variable);
+      const bc_type_t *type = control.type;
+      if (type->is_real || type->is_bool) unsupported(symbol->control_variable, "FOR loops on this datatype are");
+      int le = type->is_signed? __BC_OP_LE_I : __BC_OP_LE_U;
+
+      /* the end and the increment are kept while the loop runs */
+      unsigned saved_base = temp_base;
+      unsigned value = (NULL == control.global)? control.cell : new_temp(symbol);
+      unsigned end = new_temp(symbol), by = new_temp(symbol), more = new_temp(symbol);
+      eval(symbol->beg_expression, type, value);
+      write(control, value);
+      eval(symbol->end_expression, type, end);
+      if (NULL != symbol->by_expression) eval(symbol->by_expression, type, by);
+      else                               emit(__BC_OP_LDK, by, konst(int_cell(1, type), symbol));
+      temp_base = temp_top;
+      /* the sign of BY, if known at compile time (0 if not) */
+      int by_sign = 1;
+      if ((NULL != symbol->by_expression) && type->is_signed) {
+        if      (VALID_CVALUE( int64, symbol->by_expression)) by_sign = (GET_CVALUE(int64, symbol->by_expression) < 0)? -1 : 1;
+        else if (!VALID_CVALUE(uint64, symbol->by_expression)) by_sign = 0;
+      }
+
+      int cond_label = new_label(), exit_label = new_label();
+      place(cond_label);
+      read(control, value);
+      if      (by_sign > 0) emit(le, more, value, end);
+      else if (by_sign < 0) emit(le, more, end, value);
+      else {
+        int down_label = new_label(), test_label = new_label();
+        emit(__BC_OP_LDK, more, konst(int_cell(0, type), symbol));
+        emit(__BC_OP_LT_I, more, more, by);
+        jump(__BC_OP_JZ, more, down_label);
+        emit(le, more, value, end);
+        jump(test_label);
+        place(down_label);
+        emit(le, more, end, value);
+        place(test_label);
+      }
+      jump(__BC_OP_JZ, more, exit_label);
+      exit_labels.push_back(exit_label);
+      if (NULL != symbol->statement_list) symbol->statement_list->accept(*this);
+      exit_labels.pop_back();
+      read(control, value);
+      emit(__BC_OP_ADD_I, value, value, by);
+      wrap(value, type);
+      write(control, value);
+      jump(cond_label);
+      place(exit_label);
+      temp_base = saved_base;
+      return NULL;
+    }
+
+    void *visit(while_statement_c *symbol) {
+      int cond_label = new_label(), exit_label = new_label();
+      place(cond_label);
+      jump(__BC_OP_JZ, condition(symbol->expression), exit_label);
+      temp_top = temp_base;
+      exit_labels.push_back(exit_label);
+      if (NULL != symbol->statement_list) symbol->statement_list->accept(*this);
+      exit_labels.pop_back();
+      jump(cond_label);
+      place(exit_label);
+      return NULL;
+    }
+
+    void *visit(repeat_statement_c *symbol) {
+      int body_label = new_label(), exit_label = new_label();
+      place(body_label);
+      exit_labels.push_back(exit_label);
+      if (NULL != symbol->statement_list) symbol->statement_list->accept(*this);
+      exit_labels.pop_back();
+      jump(__BC_OP_JZ, condition(symbol->expression), body_label);
+      place(exit_label);
+      return NULL;
+    }
+
+    void *visit(exit_statement_c *symbol) {
+      if (exit_labels.empty()) STAGE4_ERROR(symbol, symbol, "EXIT outside of a loop.");
+      jump(exit_labels.back());
+      return NULL;
+    }
+}; /* class generate_bytecode_c */
+
+
+
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+
+
+
+
+visitor_c *new_code_generator(stage4out_c *s4o, const char *builddir)  {return new generate_bytecode_c(s4o, builddir);}
+void delete_code_generator(visitor_c *code_generator) {delete code_generator;}
@@ -25,20 +25,37 @@
 #include <string>
 #include <iostream>
 #include <sstream>
+#include <fstream>
 #include <typeinfo>
 #include <list>
 #include <map>
+#include <set>
+#include <algorithm>
 #include <sstream>
 #include <strings.h>
+#include <sys/stat.h>
 
 
 #include "../../util/symtable.hh"
 #include "../../util/dsymtable.hh"
 #include "../../absyntax/visitor.hh"
 #include "../../absyntax_utils/absyntax_utils.hh"
+#include "../../stage3/dead_store_analysis.hh"
+#include "../../stage3/array_range_check.hh"
+#include "../../stage3/idempotent_fb_analysis.hh"
+#include "../../stage3/independent_networks_analysis.hh"
 #include "../../main.hh" // required for ERROR() and ERROR_MSG() macros.
 
 #include "../stage4.hh"
+#include "../common/calculate_time.hh"
+
+#include "../../config/config.h"
+#if defined(HAVE_WORKING_FORK) && defined(HAVE_SYS_WAIT_H)
+  /* generate the files of the POUs in parallel, in several processes (-O j=<n> option) */
+  #define PARALLEL_STAGE4
+  #include <unistd.h>
+  #include <sys/wait.h>
+#endif
 
 //#define DEBUG
 #ifdef DEBUG
@@ -83,6 +100,12 @@
 
 #define FB_FUNCTION_SUFFIX "_body__"
 
+/* Idem as body, but for the FB body function without the code that controls its execution
+ * (i.e. that tests EN and sets ENO). Called directly by the POUs that do not use the EN/ENO
+ * of the FB instance (see -O e).
+ */
+#define FB_NOENENO_FUNCTION_SUFFIX "_body_noeneno__"
+
 /* Idem as body, but for initializer FB function */
 #define FB_INIT_SUFFIX "_init__"
 
@@ -109,6 +132,7 @@
 /* Variable declaration symbol for accessor macros */
 #define DECLARE_VAR "__DECLARE_VAR"
 #define DECLARE_GLOBAL "__DECLARE_GLOBAL"
+#define DECLARE_GLOBAL_SNAPSHOT "__DECLARE_GLOBAL_SNAPSHOT"
 #define DECLARE_GLOBAL_FB "__DECLARE_GLOBAL_FB"
 #define DECLARE_GLOBAL_LOCATION "__DECLARE_GLOBAL_LOCATION"
 #define DECLARE_GLOBAL_LOCATED "__DECLARE_GLOBAL_LOCATED"
@@ -178,7 +202,65 @@
 
 static int generate_line_directives__ = 0;
 static int generate_pou_filepairs__   = 0;
+static int generate_pou_units__       = 0;  /* each POU in a separately compiled translation unit (implies generate_pou_filepairs__) */
 static int generate_plc_state_backup_fuctions__ = 0;
+static int generate_pou_jobs__        = 1;  /* number of processes generating the <pou_name>.c/.h files (only with generate_pou_filepairs__) */
+static int disable_variable_forcing__ = 0;  /* generate code that does not support forcing variables (no force flag checks) */
+static int sort_instance_variables__  = 0;  /* declare the variables of FB and PROGRAM instances sorted by alignment */
+static int hot_cold_fields__          = 0;  /* declare the variables of FB and PROGRAM instances the most used by the body first */
+static int skip_unused_fb_eneno__     = 0;  /* call FB instances whose EN/ENO are not used without the code that controls their execution */
+static int int64_time__               = 0;  /* TIME, DATE, DT and TOD are a single 64 bit count of nanoseconds */
+static int tick_timers__              = 0;  /* the TP, TON and TOF standard FBs count the ticks of the resources, instead of reading __CURRENT_TIME */
+static int timer_wheel__              = 0;  /* the running TP, TON and TOF timers are kept in a timer wheel (implies tick_timers__) */
+static int std_lib_object__           = 0;  /* the standard functions and FBs are linked from a separately compiled object (iec_std_lib.c) */
+static int std_lib_used__             = 0;  /* only the standard functions listed in the generated STD_LIB_USED.h are compiled */
+static int sfc_active_steps__         = 0;  /* the SFCs keep a set of their active steps, and only handle those on each scan */
+static int sfc_no_debug__             = 0;  /* the SFCs have no debug tables (__debug_transition_list, __nb_steps, ...) */
+static int sfc_single_sequence__      = 0;  /* the SFCs made of a single sequence are a switch() on their active step (implies sfc_no_debug__) */
+static int parallel_networks__        = 0;  /* the independent networks of the PROGRAM bodies run in parallel, on the worker pool of their resource */
+static int il_defvar_struct__         = 0;  /* the IL current result (__IL_DEFVAR) is a struct, instead of a union */
+static int inline_function_size__     = 0;  /* with generate_pou_units__, the FUNCTIONs with at most this many statements are static inline in their <pou_name>.h */
+static int amalgamate__               = 0;  /* the configuration, resources and POUs are also included in a single AMALGAMATION.c, with static POUs */
+static int fb_init_image__            = 0;  /* the FB instances are initialised by copying the first instance of their type that was initialised */
+static int array_bounds_check__       = 0;  /* the array subscripts not known to be within the limits of the array are checked at runtime */
+static int debug_table__              = 0;  /* also generate VARIABLES.c, with a table of the variables listed in VARIABLES.csv */
+static int retain_segment__           = 0;  /* the state saved by the backup functions is in a single contiguous segment (implies generate_plc_state_backup_fuctions__) */
+static int retain_dirty__             = 0;  /* the writes to the RETAIN variables mark the pages of the retain segment as dirty (implies retain_segment__) */
+static int process_image__            = 0;  /* also generate PROCESS_IMAGE.h/.c, with the located variables of each area in a single struct */
+static int direct_globals__           = 0;  /* the ST code accesses the global variables (declared only once in the library) directly, instead of through the VAR_EXTERNAL */
+static int profile_pous__             = 0;  /* the body of each POU adds the time it took to the counters of its POU type */
+static int task_stats__               = 0;  /* the resources record the execution time, jitter and overruns of each of their tasks */
+static int stmt_counters__            = 0;  /* each ST statement and IL instruction increments a counter of its source line */
+static int layout_descriptors__       = 0;  /* the layout of the FB and PROGRAM instances is described by tables, for the online change */
+static int memory_report__            = 0;  /* also generate MEMORY_REPORT.c, reporting the memory used by the instances */
+static int wcet_estimate__            = 0;  /* also generate WCET.csv, with the estimated worst case execution time of each POU and task */
+static int depends_file__             = 0;  /* also generate DEPENDS.mk, with the dependencies of the generated files */
+static int event_tasks__               = 0;  /* the SINGLE tasks also run from the events posted to their trigger entry point */
+static int resource_context__         = 0;  /* the current time and the debug flag are read from the context of the running resource */
+static int skip_unchanged_fbs__       = 0;  /* the body of the idempotent FBs is skipped when their inputs did not change since the previous call */
+static int task_data__                = 0;  /* the PROGRAM instances, and the globals written by a single task, are in a cache aligned section per task */
+static int restrict_instances__       = 0;  /* the FB and PROGRAM bodies take a restrict pointer to the instance, and read the inputs they never write from const copies */
+static int input_recorder__           = 0;  /* also generate RECORDER.c, and config_run__() records the inputs of each cycle, for their replay */
+static int global_snapshots__         = 0;  /* each resource works on its own copy of the configuration's globals, exchanged at the cycle boundary */
+static std::vector<std::string> shared_image_vars__;  /* the paths of the variables of the shared image (-O S=file), none without it */
+static bool load_stmt_profile(const char *filename);  /* the profile used to give hints to the C compiler, see generate_c_pgo.cc */
+static bool load_wcet_costs(const char *filename);    /* the cost table of the target, see generate_c_wcet.cc */
+static std::string get_task_data_placement(symbol_c *domain, symbol_c *name);  /* only used with task_data__, see generate_c_taskdata.cc */
+
+/* The variables of the shared image: one path of VARIABLES.csv per line (the empty lines, and those starting with '#', are ignored) */
+static bool load_shared_image_vars(const char *filename) {
+  std::ifstream file(filename);
+  std::string   line;
+  if (!file.is_open()) return false;
+  shared_image_vars__.clear();
+  while (std::getline(file, line)) {
+    size_t first = line.find_first_not_of(" \t\r");
+    size_t last  = line.find_last_not_of (" \t\r");
+    if ((first == std::string::npos) || (line[first] == '#')) continue;
+    shared_image_vars__.push_back(line.substr(first, last - first + 1));
+  }
+  return !shared_image_vars__.empty();
+}
 
 #ifdef __unix__
 /* Parse command line options passed from main.c !! */
@@ -186,12 +268,94 @@ static int generate_plc_state_backup_fuctions__ = 0;
 int  stage4_parse_options(char *options) {
   enum {LINE_OPT = 0,  
         SEPTFILE_OPT,
-        BACKUP_OPT    /* option to generate function to backup and restore internal PLC state */
+        BACKUP_OPT,   /* option to generate function to backup and restore internal PLC state */
+        UNITS_OPT,    /* option to compile each POU as a separate translation unit */
+        JOBS_OPT,     /* option to generate the files of the POUs in parallel */
+        NOFORCE_OPT,  /* option to generate code without support for forcing variables */
+        SORT_OPT,     /* option to sort the variables of the FB and PROGRAM instances by alignment */
+        ENENO_OPT,    /* option to skip the EN/ENO handling of FB instances that do not use them */
+        TIME64_OPT,   /* option to represent TIME, DATE, DT and TOD as a 64 bit count of nanoseconds */
+        TIMERS_OPT,   /* option to have the standard timer FBs count the ticks of the resources */
+        WHEEL_OPT,    /* option to keep the running standard timer FBs in a timer wheel */
+        STDLIB_OPT,   /* option to only declare the prototypes of the standard functions and FBs */
+        STDUSED_OPT,  /* option to only compile the standard functions used by the generated code */
+        ACTSTEP_OPT,  /* option to have the SFCs only handle their active steps */
+        SFCNODBG_OPT, /* option to generate the SFCs without the debug tables */
+        ILREG_OPT,    /* option to have the IL current result in a struct (so it may be kept in registers) */
+        INLINE_OPT,   /* option to define the small FUNCTIONs as static inline in their header */
+        AMALGAM_OPT,  /* option to generate the whole program as a single translation unit */
+        FBIMAGE_OPT,  /* option to initialise the FB instances from a copy of an initialised instance */
+        BOUNDS_OPT,   /* option to check the array subscripts at runtime */
+        DBGTABLE_OPT, /* option to generate the table of the debug variables */
+        RETAINSEG_OPT, /* option to place the PLC state saved by the backup functions in a contiguous segment */
+        DIRTY_OPT,    /* option to keep track of the pages of the retain segment written by the program */
+        PIMAGE_OPT,   /* option to place the located variables in a process image per area */
+        DIRECTGV_OPT, /* option to access the global variables directly from the POUs */
+        PROFILE_OPT,  /* option to measure the execution time of each POU type */
+        TASKSTATS_OPT, /* option to record the cycle statistics of each task */
+        COUNTERS_OPT, /* option to count the executions of each statement */
+        PGO_OPT,      /* option to give hints to the C compiler from the counts of the statements */
+        LAYOUT_OPT,   /* option to generate the layout descriptors of the FB and PROGRAM instances */
+        MEMORY_OPT,   /* option to generate the report of the memory used by the instances */
+        WCET_OPT,     /* option to estimate the worst case execution time of the tasks */
+        DEPENDS_OPT,  /* option to generate the dependencies of the generated files, for make */
+        SHARED_OPT,   /* option to copy the given variables to a shared image at the end of each cycle */
+        EVENTS_OPT,   /* option to give the SINGLE tasks an entry point to post events to */
+        CONTEXT_OPT,  /* option to give each resource its own execution context (current time, debug flag) */
+        UNCHANGED_OPT, /* option to skip the body of the idempotent FBs when their inputs did not change */
+        SEQUENCE_OPT, /* option to lower the SFCs made of a single sequence to a switch() on their active step */
+        PARALLEL_OPT, /* option to run the independent networks of the PROGRAMs in parallel */
+        HOTCOLD_OPT,  /* option to declare the variables of the FB and PROGRAM instances the most used first */
+        TASKDATA_OPT, /* option to place the data of each task in its own cache lines */
+        RESTRICT_OPT, /* option to tell the C compiler the instances of the FB and PROGRAM bodies are not aliased */
+        RECORDER_OPT, /* option to record the inputs of each cycle, to replay them offline */
+        SNAPSHOT_OPT  /* option to give each resource its own copy of the configuration's globals */
         /*, SOME_OTHER_OPT, YET_ANOTHER_OPT */};
   char *const token[] = {
         /*       LINE_OPT*/(char *)"l",
         /*   SEPTFILE_OPT*/(char *)"p",
         /*     BACKUP_OPT*/(char *)"b",
+        /*      UNITS_OPT*/(char *)"u",
+        /*       JOBS_OPT*/(char *)"j",
+        /*    NOFORCE_OPT*/(char *)"f",
+        /*       SORT_OPT*/(char *)"s",
+        /*      ENENO_OPT*/(char *)"e",
+        /*     TIME64_OPT*/(char *)"t",
+        /*     TIMERS_OPT*/(char *)"k",
+        /*      WHEEL_OPT*/(char *)"w",
+        /*     STDLIB_OPT*/(char *)"x",
+        /*    STDUSED_OPT*/(char *)"m",
+        /*    ACTSTEP_OPT*/(char *)"a",
+        /*   SFCNODBG_OPT*/(char *)"d",
+        /*      ILREG_OPT*/(char *)"r",
+        /*     INLINE_OPT*/(char *)"i",
+        /*    AMALGAM_OPT*/(char *)"g",
+        /*    FBIMAGE_OPT*/(char *)"c",
+        /*     BOUNDS_OPT*/(char *)"v",
+        /*   DBGTABLE_OPT*/(char *)"y",
+        /*  RETAINSEG_OPT*/(char *)"n",
+        /*      DIRTY_OPT*/(char *)"z",
+        /*     PIMAGE_OPT*/(char *)"q",
+        /*   DIRECTGV_OPT*/(char *)"h",
+        /*    PROFILE_OPT*/(char *)"o",
+        /*  TASKSTATS_OPT*/(char *)"T",
+        /*   COUNTERS_OPT*/(char *)"C",
+        /*        PGO_OPT*/(char *)"P",
+        /*     LAYOUT_OPT*/(char *)"L",
+        /*     MEMORY_OPT*/(char *)"M",
+        /*       WCET_OPT*/(char *)"W",
+        /*    DEPENDS_OPT*/(char *)"D",
+        /*     SHARED_OPT*/(char *)"S",
+        /*     EVENTS_OPT*/(char *)"E",
+        /*    CONTEXT_OPT*/(char *)"R",
+        /*  UNCHANGED_OPT*/(char *)"I",
+        /*   SEQUENCE_OPT*/(char *)"Q",
+        /*   PARALLEL_OPT*/(char *)"N",
+        /*    HOTCOLD_OPT*/(char *)"H",
+        /*   TASKDATA_OPT*/(char *)"A",
+        /*   RESTRICT_OPT*/(char *)"X",
+        /*   RECORDER_OPT*/(char *)"B",
+        /*   SNAPSHOT_OPT*/(char *)"G",
         /* SOME_OTHER_OPT, ...             */
         NULL };
   /* unfortunately, the above commented out syntax for array initialization is valid in C, but not in C++ */
@@ -205,9 +369,110 @@ int  stage4_parse_options(char *options) {
       case     LINE_OPT: generate_line_directives__            = 1; break;
       case SEPTFILE_OPT: generate_pou_filepairs__              = 1; break;
       case   BACKUP_OPT: generate_plc_state_backup_fuctions__  = 1; break;
+      case    UNITS_OPT: generate_pou_units__                  = 1;
+                         generate_pou_filepairs__              = 1; break;
+      case     JOBS_OPT: if ((NULL == value) || (atoi(value) < 1)) {
+                           fprintf(stderr, "Invalid number of jobs: -O j=%s\n", (NULL == value)? "" : value);
+                           return -1;
+                         }
+#ifdef PARALLEL_STAGE4
+                         generate_pou_jobs__ = atoi(value);
+#endif
+                         break;
+      case  NOFORCE_OPT: disable_variable_forcing__            = 1; break;
+      case     SORT_OPT: sort_instance_variables__             = 1; break;
+      case    ENENO_OPT: skip_unused_fb_eneno__                = 1; break;
+      case   TIME64_OPT: int64_time__                          = 1; break;
+      case   TIMERS_OPT: tick_timers__                         = 1; break;
+      case    WHEEL_OPT: timer_wheel__                         = 1;
+                         tick_timers__                         = 1; break;
+      case   STDLIB_OPT: std_lib_object__                      = 1; break;
+      case  STDUSED_OPT: std_lib_used__                        = 1; break;
+      case  ACTSTEP_OPT: sfc_active_steps__                    = 1; break;
+      case SFCNODBG_OPT: sfc_no_debug__                        = 1; break;
+      case    ILREG_OPT: il_defvar_struct__                    = 1; break;
+      case   INLINE_OPT: if ((NULL == value) || (atoi(value) < 1)) {
+                           fprintf(stderr, "Invalid number of statements: -O i=%s\n", (NULL == value)? "" : value);
+                           return -1;
+                         }
+                         inline_function_size__ = atoi(value);
+                         break;
+      case  AMALGAM_OPT: amalgamate__                          = 1; break;
+      case  FBIMAGE_OPT: fb_init_image__                       = 1; break;
+      case   BOUNDS_OPT: array_bounds_check__                  = 1; break;
+      case DBGTABLE_OPT: debug_table__                         = 1; break;
+      case RETAINSEG_OPT: retain_segment__                     = 1;
+                         generate_plc_state_backup_fuctions__  = 1; break;
+      case    DIRTY_OPT: retain_dirty__                        = 1;
+                         retain_segment__                      = 1;
+                         generate_plc_state_backup_fuctions__  = 1; break;
+      case   PIMAGE_OPT: process_image__                       = 1; break;
+      case DIRECTGV_OPT: direct_globals__                      = 1; break;
+      case  PROFILE_OPT: profile_pous__                        = 1; break;
+      case TASKSTATS_OPT: task_stats__                         = 1; break;
+      case COUNTERS_OPT: stmt_counters__                       = 1; break;
+      case      PGO_OPT: if ((NULL == value) || !load_stmt_profile(value)) {
+                           fprintf(stderr, "Unable to read the profile: -O P=%s\n", (NULL == value)? "" : value);
+                           return -1;
+                         }
+                         break;
+      case   LAYOUT_OPT: layout_descriptors__                  = 1; break;
+      case   MEMORY_OPT: memory_report__                       = 1; break;
+      case     WCET_OPT: if ((NULL != value) && !load_wcet_costs(value)) {
+                           fprintf(stderr, "Unable to read the cost table: -O W=%s\n", value);
+                           return -1;
+                         }
+                         wcet_estimate__ = 1;
+                         break;
+      case  DEPENDS_OPT: depends_file__                        = 1; break;
+      case   SHARED_OPT: if ((NULL == value) || !load_shared_image_vars(value)) {
+                           fprintf(stderr, "Unable to read the variables of the shared image: -O S=%s\n", (NULL == value)? "" : value);
+                           return -1;
+                         }
+                         break;
+      case   EVENTS_OPT: event_tasks__                         = 1; break;
+      case  CONTEXT_OPT: resource_context__                    = 1; break;
+      case UNCHANGED_OPT: skip_unchanged_fbs__                 = 1; break;
+      case SEQUENCE_OPT: sfc_single_sequence__                 = 1;
+                         sfc_no_debug__                        = 1; break;
+      case PARALLEL_OPT: parallel_networks__                   = 1; break;
+      case  HOTCOLD_OPT: hot_cold_fields__                     = 1; break;
+      case TASKDATA_OPT: task_data__                           = 1; break;
+      case RESTRICT_OPT: restrict_instances__                  = 1; break;
+      case RECORDER_OPT: input_recorder__                      = 1; break;
+      case SNAPSHOT_OPT: global_snapshots__                    = 1; break;
       default          : fprintf(stderr, "Unrecognized option: -O %s\n", value); return -1; break;
      }
   }     
+  if (amalgamate__ && generate_pou_units__) {
+    fprintf(stderr, "Options -O g and -O u may not be used together\n");
+    return -1;
+  }
+  if (resource_context__ && timer_wheel__) {
+    /* the timer wheel is shared by all the resources */
+    fprintf(stderr, "Options -O R and -O w may not be used together\n");
+    return -1;
+  }
+  if (parallel_networks__ && (timer_wheel__ || retain_dirty__ || profile_pous__ || stmt_counters__)) {
+    /* the timer wheel, the dirty pages, and the counters are updated without any locking */
+    fprintf(stderr, "Option -O N may not be used together with -O w, -O z, -O o nor -O C\n");
+    return -1;
+  }
+  if (input_recorder__ && resource_context__) {
+    /* the replay sets a single current time */
+    fprintf(stderr, "Options -O B and -O R may not be used together\n");
+    return -1;
+  }
+  if (task_data__ && retain_segment__) {
+    /* the globals and PROGRAM instances may only be in one section */
+    fprintf(stderr, "Option -O A may not be used together with -O n nor -O z\n");
+    return -1;
+  }
+  if (global_snapshots__ && (task_data__ || direct_globals__)) {
+    /* the copies of the globals are not placed in the sections of the tasks, and the POUs must reach the globals through the VAR_EXTERNALs */
+    fprintf(stderr, "Option -O G may not be used together with -O A nor -O h\n");
+    return -1;
+  }
   return 0;
 }
 
@@ -217,6 +482,47 @@ void stage4_print_options(void) {
   printf("      l : insert '#line' directives in generated C code.\n"); 
   printf("      p : place each POU in a separate pair of files (<pou_name>.c, <pou_name>.h).\n"); 
   printf("      b : generate functions to backup and restore internal PLC state.\n"); 
+  printf("      u : like 'p', but each <pou_name>.c is compiled on its own (see the generated POUS.mk), instead of being included in POUS.c.\n"); 
+  printf("    j=n : with 'p' or 'u', generate the files of the POUs using n processes in parallel.\n"); 
+  printf("      f : generate code without support for forcing variables (faster, but variables can no longer be forced).\n"); 
+  printf("      s : declare the variables of FB and PROGRAM instances sorted by alignment, so less memory is lost to padding.\n"); 
+  printf("      e : call the FB instances whose EN and ENO are never used without testing EN and setting ENO (EN can no longer be forced).\n"); 
+  printf("      t : represent TIME, DATE, DT and TOD as a 64 bit count of nanoseconds (the runtime must be compiled with USE_INT64_TIME too).\n"); 
+  printf("      k : the TP, TON and TOF timers count the ticks passed to the resources, instead of reading __CURRENT_TIME.\n"); 
+  printf("      w : like 'k', but the running timers are kept in a timer wheel, that updates their outputs on the tick they expire.\n"); 
+  printf("      x : the standard functions and FBs are not compiled with the generated code, but linked from the object compiled from iec_std_lib.c.\n"); 
+  printf("      m : only compile the standard functions called by the generated code (listed in the generated STD_LIB_USED.h).\n"); 
+  printf("      a : the SFCs keep the set of their active steps, and only update those (and their action associations) on each scan.\n"); 
+  printf("      d : the SFCs have no debug copy of their transitions (these can no longer be forced, and are only seen by the debugger once they fire).\n"); 
+  printf("      r : the IL current result is a struct with a member for each type, instead of a union, so the C compiler may keep it in registers.\n"); 
+  printf("    i=n : with 'u', the FUNCTIONs with at most n statements are defined as static inline in their <pou_name>.h, so they may be inlined in the other POUs.\n");
+  printf("      g : also generate AMALGAMATION.c, that includes the configuration, the resources and the POUs, and compile only that file. The POU functions are static.\n");
+  printf("      c : the FB instances are initialised by copying an image of their type, kept from the first instance initialised (uses memory for two images per FB type).\n");
+  printf("      v : check at runtime the array subscripts that are not known to be within the limits of the array (constants, subrange types, and FOR loops with constant limits).\n");
+  printf("      y : also generate VARIABLES.c, with a table of the address, type and size of the variables listed in VARIABLES.csv, and a hash table to find them by name. config_run__() applies the queued requests to force variables before each cycle, and copies the traced variables to a ring buffer after it.\n");
+  printf("      n : like 'b', but the global variables and the PROGRAM instances are placed in a contiguous segment (see iec_retain.h), so config_backup__() is a single memcpy(), and the segment has a layout usable to restore it after the program was changed.\n");
+  printf("      z : like 'n', but writing a RETAIN variable marks its page of the segment as dirty, and config_backup_dirty__() only saves the dirty pages.\n");
+  printf("      q : also generate PROCESS_IMAGE.h and PROCESS_IMAGE.c, with the located variables of each area (%%I, %%Q, %%M) in a single struct, and a table of their offsets (see iec_process_image.h).\n");
+  printf("      h : the VAR_EXTERNAL of the POUs that refer to a global variable declared only once in the whole library are read and written (in ST, and read in IL) directly in the global, instead of through a pointer (the VAR_EXTERNAL themselves can then no longer be forced, only the global).\n");
+  printf("      o : the body of each FUNCTION, FUNCTION_BLOCK and PROGRAM adds the time it took (read with __profile_now(), defined by the runtime) to the counters of its POU type (see iec_profile.h).\n");
+  printf("      T : the resources record, in <resource>_task_stats__[] (also listed in config_task_stats__[]), the execution time (last, min, max, average), the jitter histogram and the overruns of each task (times read with __task_stats_now(), defined by the runtime, see iec_task_stats.h).\n");
+  printf("      C : each ST statement and IL instruction increments a counter of its source file and line, which __stmt_counters_dump() writes out (see iec_counters.h).\n");
+  printf(" P=file : use the counts written by __stmt_counters_dump() (see 'C') to mark the IF, ELSIF and CASE branches almost always (or never) taken as likely (or unlikely), sort the exclusive ELSIF branches by frequency, and mark the POUs as hot or cold.\n");
+  printf("      L : also generate a table describing the layout of the instances of each FUNCTION_BLOCK and PROGRAM, and of the global variables, so the runtime may migrate the state of the PLC to a new version of the program between two cycles (online change, see iec_online_change.h).\n");
+  printf("      M : also generate MEMORY_REPORT.c, which writes a JSON report of the size of each FUNCTION_BLOCK and PROGRAM type and of its variables, of the global variables and of the PROGRAM instances, with the bytes taken by the flags, the RETAIN variables and the located variables, and the totals of each task and resource. The sizes are those of the C compiler that compiles it (see iec_memory_report.h).\n");
+  printf(" W[=file] : also generate WCET.csv, with a static estimate of the worst case execution time of each POU and task (in ns, from the cost of each operation in the given cost table, or in a default one), next to the interval of the task, and warn about the tasks that may overrun (see generate_c_wcet.cc).\n");
+  printf("      D : also generate DEPENDS.mk, a fragment for make listing the IEC 61131-3 source files, the generated files, the source files each one came from, and the generated headers included by each C file, so the build may be incremental (see generate_c_depend.cc).\n");
+  printf(" S=file : also generate SHARED_IMAGE.c, so the variables listed in the file (one path of VARIABLES.csv per line) are copied at the end of each cycle to a shared memory segment with a documented layout, which other processes may map to read consistent snapshots of the values (see iec_shared_image.h).\n");
+  printf("      E : each task with a SINGLE input also gets an entry point, <resource>__<task>_trigger__(), to post events to it (e.g. from an interrupt handler), and <resource>_run_events__() runs the tasks with pending events, so they may react without waiting for the next tick (see iec_event_tasks.h).\n");
+  printf("      R : each resource has its own execution context, <resource>_context__, from which the code it runs reads the current time and the debug flag (and with 'k' the tick count), instead of the process wide __CURRENT_TIME and __DEBUG, so several resources may run concurrently on different clocks (see iec_resource_context.h).\n");
+  printf("      I : the FUNCTION_BLOCKs whose outputs only depend on their inputs (see stage3/idempotent_fb_analysis.hh) keep a copy of the inputs of the previous call, and skip their body when these did not change (an output changed, e.g. forced, from outside the program then keeps its value until the inputs change).\n");
+  printf("      Q : like 'd', but the SFCs made of a single sequence (a single initial step, no simultaneous divergence or convergence, and a PRIORITY on all the transitions of the steps with several of them) keep the number of their active step, and on each scan only test its transitions, in a switch() on that number (their steps can no longer be activated by forcing them).\n");
+  printf("      N : the body of each PROGRAM written in ST is split into networks, i.e. groups of statements that access no variable written by another network (see stage3/independent_networks_analysis.hh), and the PROGRAMs with several networks run them in parallel, on the worker threads of the pool of their resource, <resource>_parallel_pool__ (see iec_parallel.h, the runtime must then be linked with -lpthread). May not be used with 'w', 'z', 'o' nor 'C'.\n");
+  printf("      H : declare the variables of the FB and PROGRAM instances ordered by how much their body uses them (the number of accesses in the code, or with 'P' the number of times these ran): first the elementary variables and pointers that are used, then the FB instances and structures that are used, then the variables never used, and the STRINGs and ARRAYs last, each group sorted by alignment (as with 's'), so fewer cache lines are touched by each call.\n");
+  printf("      A : the PROGRAM instances, and the global variables written by a single task, are placed in a section per task (or per resource, for the PROGRAMs with no task), each starting on a new cache line, so the tasks running on different cores do not write to the same cache lines, and warn about the global variables written by several tasks (see iec_task_data.h). May not be used with 'n' nor 'z'.\n");
+  printf("      X : the body of each FUNCTION_BLOCK and PROGRAM takes a restrict pointer to its instance, and the ST bodies read the VAR_INPUTs (of elementary types, other than STRINGs) they never write, nor pass to a VAR_IN_OUT or REF(), from const copies made on entry, so the C compiler may keep the variables in registers across the writes to the VAR_EXTERNAL, VAR_IN_OUT and located variables. A variable of a FB instance may then not be passed to a VAR_IN_OUT of that same instance.\n");
+  printf("      B : also generate RECORDER.c, with a table of the %%I located variables, and config_run__() then appends, at the start of each cycle, the tick, the current time and the inputs that changed to a ring buffer, from which the runtime may write a log of the inputs of the program on site. The same program replays the log, at full speed and with the same results, for the analysis of its performance (see iec_input_recorder.h and tests/replay.sh). May not be used with 'R'.\n");
+  printf("      G : each resource reads and writes its own copy of the global variables of the configuration (other than the located ones and the FB instances), and config_exchange__(), called by config_run__() once the resources have run, copies the values written by each resource to the globals, and then the globals to the copies of all the resources. The resources may then run concurrently, each on its own thread (see config_resource_run__[]), as long as the runtime calls config_exchange__() between the cycles (see iec_global_snapshot.h). May not be used with 'A' nor 'h'.\n");
 }
 #else /* not __unix__ */
 /* getsubopt isn't supported with mingw, 
@@ -225,6 +531,102 @@ void stage4_print_options(void) {}
 int  stage4_parse_options(char *options) {return 0;}
 #endif 
 
+
+/* Print the #define directives that select the variant of the C library (iec_std_lib.h, accessor.h, ...)
+ * matching the generated code. Must be printed before any of the library headers is included.
+ */
+static void print_library_defines(stage4out_c &s4o) {
+  if (runtime_options.disable_implicit_en_eno) {
+    // If we are not generating the EN and ENO parameters for functions and FB,
+    //   then make sure we use the standard library version compiled without these parameters too!
+    s4o.print("#ifndef DISABLE_EN_ENO_PARAMETERS\n");
+    s4o.print("#define DISABLE_EN_ENO_PARAMETERS\n");
+    s4o.print("#endif\n");
+  }
+  if (disable_variable_forcing__) {
+    s4o.print("#ifndef DISABLE_VARIABLE_FORCING\n");
+    s4o.print("#define DISABLE_VARIABLE_FORCING\n");
+    s4o.print("#endif\n");
+  }
+  if (int64_time__) {
+    s4o.print("#ifndef USE_INT64_TIME\n");
+    s4o.print("#define USE_INT64_TIME\n");
+    s4o.print("#endif\n");
+  }
+  if (tick_timers__) {
+    s4o.print("#ifndef USE_TICK_TIMERS\n");
+    s4o.print("#define USE_TICK_TIMERS\n");
+    s4o.print("#endif\n");
+  }
+  if (timer_wheel__) {
+    s4o.print("#ifndef USE_TIMER_WHEEL\n");
+    s4o.print("#define USE_TIMER_WHEEL\n");
+    s4o.print("#endif\n");
+  }
+  if (std_lib_object__) {
+    s4o.print("#ifndef USE_STD_LIB_OBJECT\n");
+    s4o.print("#define USE_STD_LIB_OBJECT\n");
+    s4o.print("#endif\n");
+  }
+  if (il_defvar_struct__) {
+    s4o.print("#ifndef USE_IL_DEFVAR_STRUCT\n");
+    s4o.print("#define USE_IL_DEFVAR_STRUCT\n");
+    s4o.print("#endif\n");
+  }
+  if (retain_segment__) {
+    s4o.print("#ifndef USE_RETAIN_SEGMENT\n");
+    s4o.print("#define USE_RETAIN_SEGMENT\n");
+    s4o.print("#endif\n");
+  }
+  if (retain_dirty__) {
+    s4o.print("#ifndef USE_RETAIN_DIRTY\n");
+    s4o.print("#define USE_RETAIN_DIRTY\n");
+    s4o.print("#endif\n");
+  }
+  if (profile_pous__) {
+    s4o.print("#ifndef USE_POU_PROFILE\n");
+    s4o.print("#define USE_POU_PROFILE\n");
+    s4o.print("#endif\n");
+  }
+  if (task_stats__) {
+    s4o.print("#ifndef USE_TASK_STATS\n");
+    s4o.print("#define USE_TASK_STATS\n");
+    s4o.print("#endif\n");
+  }
+  if (stmt_counters__) {
+    s4o.print("#ifndef USE_STMT_COUNTERS\n");
+    s4o.print("#define USE_STMT_COUNTERS\n");
+    s4o.print("#endif\n");
+  }
+  if (layout_descriptors__) {
+    s4o.print("#ifndef USE_ONLINE_CHANGE\n");
+    s4o.print("#define USE_ONLINE_CHANGE\n");
+    s4o.print("#endif\n");
+  }
+  if (resource_context__) {
+    s4o.print("#ifndef USE_RESOURCE_CONTEXT\n");
+    s4o.print("#define USE_RESOURCE_CONTEXT\n");
+    s4o.print("#endif\n");
+  }
+  if (parallel_networks__) {
+    s4o.print("#ifndef USE_PARALLEL_NETWORKS\n");
+    s4o.print("#define USE_PARALLEL_NETWORKS\n");
+    s4o.print("#endif\n");
+  }
+  if (task_data__) {
+    s4o.print("#ifndef USE_TASK_DATA\n");
+    s4o.print("#define USE_TASK_DATA\n");
+    s4o.print("#endif\n");
+  }
+  if (global_snapshots__) {
+    s4o.print("#ifndef USE_GLOBAL_SNAPSHOTS\n");
+    s4o.print("#define USE_GLOBAL_SNAPSHOTS\n");
+    s4o.print("#endif\n");
+  }
+  if (std_lib_used__)
+    s4o.print("#include \"STD_LIB_USED.h\"\n");  /* see generate_c_stdlib.cc */
+}
+
 /***********************************************************************/
 /***********************************************************************/
 /***********************************************************************/
@@ -237,6 +639,16 @@ int  stage4_parse_options(char *options) {return 0;}
 #include "generate_c_configbody.cc"
 #include "generate_location_list.cc"
 #include "generate_var_list.cc"
+#include "generate_c_fingerprint.cc"
+#include "generate_c_layout.cc"
+#include "generate_c_memory.cc"
+#include "generate_c_pgo.cc"
+#include "generate_c_stdlib.cc"
+#include "generate_c_depend.cc"
+#include "generate_c_taskdata.cc"
+
+static std_lib_usage_c std_lib_usage;  /* only used with std_lib_used__ */
+static generated_depends_c generated_depends;  /* only used with depends_file__ */
 
 /***********************************************************************/
 /***********************************************************************/
@@ -468,6 +880,17 @@ class analyse_variable_c: public search_visitor_c {
      *      fb1.fb2.struct1.real   returns datatype of struct1
      *      struct1.real           returns datatype of struct1
      */
+    /* returns true if the variable is not inside a FB instance */
+    /* eg:
+     *      fb1.fb2.struct1.real   returns FALSE
+     *      struct1.real           returns TRUE
+     */
+    static bool is_in_scope(symbol_c *symbol) {
+      find_first_nonfb(symbol);
+      return (NULL == singleton_->last_fb);
+    }
+
+
     static search_var_instance_decl_c::vt_t first_nonfb_vardecltype(symbol_c *symbol, symbol_c *scope) {
       if (NULL == symbol) ERROR;
       if (!get_datatype_info_c::is_type_valid(symbol->datatype)) ERROR;
@@ -529,115 +952,159 @@ class analyse_variable_c: public search_visitor_c {
 
 analyse_variable_c *analyse_variable_c::singleton_ = NULL;
 
+
+
 /***********************************************************************/
 /***********************************************************************/
 /***********************************************************************/
 /***********************************************************************/
 
+/* With direct_globals__ (-O h), the global variables that may be accessed directly by the POUs.
+ *
+ * In the C code, every VAR_EXTERNAL is a pointer, set by __INIT_EXTERNAL() to the address
+ * of the global with the same name (returned by __GET_GLOBAL_<name>(), of which there may only
+ * be one in the program). When the global is declared by a single configuration or resource of
+ * the library, its C variable (<domain>__<name>) is therefore known when generating the POUs,
+ * and the POUs may access it directly, without going through the pointer.
+ *
+ * Only the globals of an elementary or named datatype (not a FB) that are not located are
+ * accessed directly. The VAR_EXTERNAL still point to the globals, so any code that still goes
+ * through them (IL assignments, SFC actions, ...) accesses the same variable.
+ */
+typedef struct {
+  std::string c_name;  /* e.g. CONFIG0__VAR1, empty if the global may not be accessed directly */
+  std::string c_type;  /* e.g. __IEC_INT_t */
+} direct_global_t;
 
-#include "generate_c_st.cc"
-#include "generate_c_il.cc"
-#include "generate_c_inlinefcall.cc"
+static std::map<std::string, direct_global_t> direct_globals_map__;
 
-/***********************************************************************/
-/***********************************************************************/
-/***********************************************************************/
-/***********************************************************************/
+class find_direct_globals_c: public iterator_visitor_c {
+  private:
+    std::string domain;
+    symbol_c   *current_type;
 
-#define MILLISECOND ((unsigned long long)1000000)
-#define SECOND 1000 * MILLISECOND
+    static std::string upper(const char *str) {
+      std::string res(str);
+      for (unsigned int i = 0; i < res.size(); i++) res[i] = toupper((unsigned char)res[i]);
+      return res;
+    }
 
-#define ULL_MAX std::numeric_limits<unsigned long long>::max()
-#define UL_MAX std::numeric_limits<uint32_t>::max()
+    void add_global(symbol_c *var_name, bool direct) {
+      token_c *token = dynamic_cast<token_c *>(var_name);
+      if (NULL == token) ERROR;
+      std::string name = upper(token->value);
+      direct_global_t global;
+
+      if (direct_globals_map__.find(name) != direct_globals_map__.end())
+        direct = false;  /* declared more than once */
+      if (direct && (NULL != current_type)) {
+        derived_datatype_identifier_c *type_name = dynamic_cast<derived_datatype_identifier_c *>(current_type);
+        if      (NULL != type_name)
+          global.c_type = "__IEC_" + upper(type_name->value) + "_t";
+        else if (get_datatype_info_c::is_ANY_ELEMENTARY(current_type)) {
+          std::string type = upper(get_datatype_info_c::get_id_str(current_type));
+          /* the SAFExxx datatypes are the same as the xxx datatypes in the C code */
+          if (type.compare(0, 4, "SAFE") == 0) type.erase(0, 4);
+          global.c_type = "__IEC_" + type + "_t";
+        }
+        if (!global.c_type.empty())
+          global.c_name = domain + "__" + name;
+      }
+      direct_globals_map__[name] = global;
+    }
 
-/* unsigned long long -> multiply and add : time_var += interval * multiplier  */
-/*  note: multiplier must be <> 0 due to overflow test                         */
-#define ULL_MUL_ADD(time_var, interval, multiplier, overflow_flag) {                       \
-    /* Test overflow on MUL by pre-condition: If (ULL_MAX / a) < b => overflow! */         \
-    overflow_flag |= ((ULL_MAX / (multiplier)) < GET_CVALUE(uint64, interval));            \
-    /* Test overflow on ADD by pre-condition: If (ULL_MAX - a) < b => overflow! */         \
-    overflow_flag |= ((ULL_MAX - (GET_CVALUE(uint64, interval) * multiplier)) < time_var); \
-    time_var += GET_CVALUE(uint64, interval) * (multiplier);                               \
-}
+  public:
+    find_direct_globals_c(void) {current_type = NULL;}
 
-/* long double -> multiply and add : time_var += interval * multiplier  */
-#define LDB_MUL_ADD(time_var, interval, multiplier) {  \
-    time_var += GET_CVALUE(real64, interval) * (multiplier);               \
-}
+    static void find(symbol_c *library) {
+      find_direct_globals_c find_direct_globals;
+      direct_globals_map__.clear();
+      library->accept(find_direct_globals);
+    }
 
+    /* the POUs do not declare any global variables (nor any of the datatypes) */
+    void *visit(data_type_declaration_c      *symbol) {return NULL;}
+    void *visit(function_declaration_c       *symbol) {return NULL;}
+    void *visit(function_block_declaration_c *symbol) {return NULL;}
+    void *visit(program_declaration_c        *symbol) {return NULL;}
 
-unsigned long long calculate_time(symbol_c *symbol) {
-  if (NULL == symbol) return 0;
-  
-  interval_c *interval = dynamic_cast<interval_c *>(symbol);
-  duration_c *duration = dynamic_cast<duration_c *>(symbol);
-  
-  if ((NULL == interval) && (NULL == duration))
-  	  {STAGE4_ERROR(symbol, symbol, "This type of interval value is not currently supported"); ERROR;}
-
-  if (NULL != duration) {
-    /* SYM_REF2(duration_c, neg, interval) */
-    if (duration->neg != NULL)
-      {STAGE4_ERROR(duration, duration, "Negative TIME literals for interval are not currently supported"); ERROR;}
-    return calculate_time(duration->interval);
-  }
+    void *visit(configuration_declaration_c *symbol) {
+      domain = upper(((token_c *)symbol->configuration_name)->value);
+      if (NULL != symbol->global_var_declarations) symbol->global_var_declarations->accept(*this);
+      symbol->resource_declarations->accept(*this);
+      return NULL;
+    }
 
-  if (NULL != interval) {
-    /* SYM_REF5(interval_c, days, hours, minutes, seconds, milliseconds) */
-      unsigned long long int time_ull = 0; 
-      long double            time_ld  = 0;
-      bool                   ovflow   = false;
-      
-      if (NULL != interval->milliseconds) {
-        if      (VALID_CVALUE( int64, interval->milliseconds) &&           GET_CVALUE( int64, interval->milliseconds) < 0) ERROR; // interval elements should always be positive!
-        if      (VALID_CVALUE(uint64, interval->milliseconds)) ULL_MUL_ADD(time_ull, interval->milliseconds,  MILLISECOND, ovflow)
-        else if (VALID_CVALUE(real64, interval->milliseconds)) LDB_MUL_ADD(time_ld , interval->milliseconds,  MILLISECOND)
-        else ERROR; // if (NULL != interval->milliseconds) is true, then it must have a valid constant value!
-      }
-   
-      if (NULL != interval->seconds     ) {
-        if      (VALID_CVALUE( int64, interval->seconds     ) &&           GET_CVALUE( int64, interval->seconds     ) < 0) ERROR; // interval elements should always be positive!
-        if      (VALID_CVALUE(uint64, interval->seconds     )) ULL_MUL_ADD(time_ull, interval->seconds,       SECOND, ovflow)
-        else if (VALID_CVALUE(real64, interval->seconds     )) LDB_MUL_ADD(time_ld , interval->seconds,       SECOND)
-        else ERROR; // if (NULL != interval->seconds) is true, then it must have a valid constant value!
-      }
+    void *visit(resource_declaration_c *symbol) {
+      std::string config_domain = domain;
+      domain = upper(((token_c *)symbol->resource_name)->value);
+      if (NULL != symbol->global_var_declarations) symbol->global_var_declarations->accept(*this);
+      domain = config_domain;
+      return NULL;
+    }
 
-      if (NULL != interval->minutes     ) {
-        if      (VALID_CVALUE( int64, interval->minutes     ) &&           GET_CVALUE( int64, interval->minutes     ) < 0) ERROR; // interval elements should always be positive!
-        if      (VALID_CVALUE(uint64, interval->minutes     )) ULL_MUL_ADD(time_ull, interval->minutes,       SECOND * 60, ovflow)
-        else if (VALID_CVALUE(real64, interval->minutes     )) LDB_MUL_ADD(time_ld , interval->minutes,       SECOND * 60)
-        else ERROR; // if (NULL != interval->minutes) is true, then it must have a valid constant value!
-      }
+    void *visit(single_resource_declaration_c *symbol) {return NULL;}
+
+    /*| global_var_spec ':' [located_var_spec_init|function_block_type_name] */
+    // SYM_REF2(global_var_decl_c, global_var_spec, type_specification)
+    void *visit(global_var_decl_c *symbol) {
+      current_type = spec_init_sperator_c::get_spec(symbol->type_specification);
+      if (   (NULL != current_type) && get_datatype_info_c::is_type_valid(current_type)
+          && get_datatype_info_c::is_function_block(current_type))
+        current_type = NULL;
+      symbol->global_var_spec->accept(*this);
+      current_type = NULL;
+      return NULL;
+    }
 
-      if (NULL != interval->hours       ) {
-        if      (VALID_CVALUE( int64, interval->hours       ) &&           GET_CVALUE( int64, interval->hours       ) < 0) ERROR; // interval elements should always be positive!
-        if      (VALID_CVALUE(uint64, interval->hours       )) ULL_MUL_ADD(time_ull, interval->hours,         SECOND * 60 * 60, ovflow)
-        else if (VALID_CVALUE(real64, interval->hours       )) LDB_MUL_ADD(time_ld , interval->hours,         SECOND * 60 * 60)
-        else ERROR; // if (NULL != interval->hours) is true, then it must have a valid constant value!
-      }
+    /*| global_var_name location */
+    // SYM_REF2(global_var_spec_c, global_var_name, location)
+    void *visit(global_var_spec_c *symbol) {
+      if (NULL != symbol->global_var_name) add_global(symbol->global_var_name, false);
+      return NULL;
+    }
 
-      if (NULL != interval->days        ) {
-        if      (VALID_CVALUE( int64, interval->days        ) &&           GET_CVALUE( int64, interval->days        ) < 0) ERROR; // interval elements should always be positive!
-        if      (VALID_CVALUE(uint64, interval->days        )) ULL_MUL_ADD(time_ull, interval->days,          SECOND * 60 * 60 * 24, ovflow)
-        else if (VALID_CVALUE(real64, interval->days        )) LDB_MUL_ADD(time_ld , interval->days,          SECOND * 60 * 60 * 24)
-        else ERROR; // if (NULL != interval->days) is true, then it must have a valid constant value!
-      }
+    /*| global_var_list ',' global_var_name */
+    //SYM_LIST(global_var_list_c)
+    void *visit(global_var_list_c *symbol) {
+      for (int i = 0; i < symbol->n; i++) add_global(symbol->get_element(i), true);
+      return NULL;
+    }
+};
 
-      /* Test overflow on ADD by pre-condition: If (ULL_MAX - a) < b => overflow! */
-      ovflow |= ((ULL_MAX - time_ull) < (unsigned long long)time_ld);
-      time_ull += time_ld;
-      
-      if (ovflow) {
-        /* time is being stored in ns resolution (MILLISECOND #define is set to 1000000)    */
-        /* time is being stored in unsigned long long (ISO C99 guarantees at least 64 bits) */
-        /* 2⁶64ns works out to around 584.5 years, assuming 365.25 days per year            */
-        STAGE4_ERROR(symbol, symbol, "Internal overflow calculating task interval (must be < 584 years).");
-      }
 
-      return time_ull;
-  };
-  ERROR; // should never reach this point!
-  return 0; // humour the compiler!
+/* With direct_globals__, the global that the variable (that must be a VAR_EXTERNAL) refers to,
+ * if it may be accessed directly (see find_direct_globals_c), or NULL.
+ */
+static const direct_global_t *get_direct_global(symbol_c *symbol) {
+  if (!direct_globals__) return NULL;
+  if (!analyse_variable_c::is_in_scope(symbol)) return NULL;
+  token_c *var_name = get_var_name_c::get_name(symbol);
+  if (NULL == var_name) return NULL;
+  std::string name(var_name->value);
+  for (unsigned int i = 0; i < name.size(); i++) name[i] = toupper((unsigned char)name[i]);
+  std::map<std::string, direct_global_t>::iterator global = direct_globals_map__.find(name);
+  if ((global == direct_globals_map__.end()) || global->second.c_name.empty()) return NULL;
+  return &global->second;
+}
+
+
+/* With restrict_instances__ (-O X), the VAR_INPUTs (in upper case) that the body of the FB or PROGRAM being generated
+ * reads from the const copies made on its entry, __input_<name>__ (see find_const_inputs_c), instead of from the instance.
+ */
+static std::set<std::string> const_inputs__;
+
+static bool is_const_input_name(const char *var_name) {
+  std::string name(var_name);
+  for (unsigned int i = 0; i < name.size(); i++) name[i] = toupper((unsigned char)name[i]);
+  return const_inputs__.count(name) > 0;
+}
+
+static bool is_const_input(symbol_c *symbol) {
+  if (const_inputs__.empty()) return false;
+  symbolic_variable_c *variable = dynamic_cast<symbolic_variable_c *>(symbol);
+  token_c *var_name = (NULL == variable)? NULL : dynamic_cast<token_c *>(variable->var_name);
+  return (NULL != var_name) && is_const_input_name(var_name->value);
 }
 
 /***********************************************************************/
@@ -645,6 +1112,26 @@ unsigned long long calculate_time(symbol_c *symbol) {
 /***********************************************************************/
 /***********************************************************************/
 
+
+/* The number of the inline function (see generate_c_inlinefcall.cc) called instead of each call to a function
+ * with output parameters. The calls in the same POU whose inline functions would be identical share a single one.
+ */
+static annotation_table_c<int> inline_fcall_number;
+
+
+#include "generate_c_eneno.cc"
+#include "generate_c_strpool.cc"
+#include "generate_c_st.cc"
+#include "generate_c_il.cc"
+#include "generate_c_inlinefcall.cc"
+
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+
+#define UL_MAX std::numeric_limits<uint32_t>::max()
+
 class calculate_common_ticktime_c: public iterator_visitor_c {
   private:
     unsigned long long common_ticktime;
@@ -661,10 +1148,17 @@ class calculate_common_ticktime_c: public iterator_visitor_c {
     /* after common_period ticks, all task period align again */
     unsigned long common_period;
 
+    /* The intervals of all the periodic tasks, and whether some program must run on every tick
+     * (i.e. it is not associated to any task, or to a task that is not periodic).
+     */
+    std::set<unsigned long long> task_intervals;
+    bool every_tick;
+
   public:
     calculate_common_ticktime_c(void){
       common_ticktime = 0;
       common_period = 1; /* first tick time equals single/first task period */
+      every_tick = false;
     }
     
     unsigned long long GCM(unsigned long long a, unsigned long long b) {
@@ -732,10 +1226,53 @@ class calculate_common_ticktime_c: public iterator_visitor_c {
           STAGE4_ERROR(symbol, symbol, "Internal overflow calculating least common multiple of task intervals (must be < 584 years).");
         }
       }
+      /* the generated code checks the SINGLE data source of a task on every tick */
+      if ((symbol->single_data_source != NULL) || (symbol->interval_data_source == NULL) || (calculate_time(symbol->interval_data_source) == 0))
+        every_tick = true;
+      else
+        task_intervals.insert(calculate_time(symbol->interval_data_source));
       return NULL;
     }
+
+//SYM_REF6(program_configuration_c, retain_option, program_name, task_name, program_type_name, prog_conf_elements, unused)
+    void *visit(program_configuration_c *symbol) {
+      if (symbol->task_name == NULL) every_tick = true;
+      return NULL;
+    }
+
+    /* Print a function returning the next tick (after 'tick') on which at least one task is due to run.
+     * The runtime may then sleep until that tick, instead of calling config_run__() on every single tick.
+     * Note that between the calls the resources' run functions check whether each task is due
+     * using (tick % <task period>), so the runtime may skip the ticks on which no task is due.
+     */
+    void print_next_tick_function(stage4out_c &s4o) {
+      s4o.print("unsigned long config_next_tick__(unsigned long tick) {\n");
+      s4o.indent_right();
+      if (every_tick || task_intervals.empty()) {
+        s4o.print(s4o.indent_spaces + "return tick + 1;\n");
+      } else {
+        s4o.print(s4o.indent_spaces + "unsigned long next, first;\n");
+        std::set<unsigned long long>::iterator i = task_intervals.begin();
+        for (bool first = true; i != task_intervals.end(); i++, first = false) {
+          unsigned long long period = *i / common_ticktime; /* in ticks */
+          s4o.print(s4o.indent_spaces + (first? "first" : "next"));
+          s4o.print(" = tick + ");
+          s4o.print_long_integer(period);
+          s4o.print(" - (tick % ");
+          s4o.print_long_integer(period);
+          s4o.print(");\n");
+          if (!first) s4o.print(s4o.indent_spaces + "if (next < first) first = next;\n");
+        }
+        s4o.print(s4o.indent_spaces + "return first;\n");
+      }
+      s4o.indent_left();
+      s4o.print("}\n");
+    }
 };    
 
+
+#include "generate_c_wcet.cc"
+
 /***********************************************************************/
 /***********************************************************************/
 /***********************************************************************/
@@ -828,6 +1365,176 @@ void *generate_c_SFC_IL_ST_c::visit(statement_list_c *symbol) {
 
 
 
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+
+/* The FUNCTIONs defined as static inline in their <pou_name>.h (only with generate_pou_units__ and inline_function_size__).
+ * Chosen by generate_c_c, in the order in which the POUs are declared, before the files of each POU are generated.
+ */
+static std::set<symbol_c *> inline_functions;
+
+/* The size of the body of a POU: the number of ST statements, or IL instructions, it contains (including the nested ones) */
+class count_statements_c: public iterator_visitor_c {
+  private:
+    int count;
+
+  public:
+    static int get(symbol_c *body) {
+      count_statements_c count_statements;
+      count_statements.count = 0;
+      body->accept(count_statements);
+      return count_statements.count;
+    }
+
+  private:
+    void *visit(instruction_list_c *symbol) {count += symbol->n; return iterator_visitor_c::visit(symbol);}
+    void *visit(statement_list_c   *symbol) {count += symbol->n; return iterator_visitor_c::visit(symbol);}
+};
+
+
+/* The number of accesses to each variable (by its name, in upper case) made by the body of a POU, for hot_cold_fields__.
+ * With a profile (-O P), each access counts the number of times its source line ran (the lines not in the profile count once).
+ */
+class count_variable_accesses_c: public iterator_visitor_c {
+  private:
+    std::map<std::string, unsigned long long> *accesses;
+
+    void add(symbol_c *reference, symbol_c *name) {
+      token_c *token = dynamic_cast<token_c *>(name);
+      if (NULL == token) return;
+      unsigned long long count = 1;
+      if ((NULL != stmt_profile__) && !stmt_profile__->get_count(reference, count)) count = 1;
+      std::string key;
+      for (const char *c = token->value; *c != '\0'; c++) key += toupper((unsigned char)*c);
+      (*accesses)[key] += count;
+    }
+
+  public:
+    static void get(symbol_c *body, std::map<std::string, unsigned long long> &accesses) {
+      count_variable_accesses_c count_variable_accesses;
+      count_variable_accesses.accesses = &accesses;
+      body->accept(count_variable_accesses);
+    }
+
+  private:
+    void *visit(symbolic_variable_c *symbol) {add(symbol, symbol->var_name); return NULL;}
+    void *visit(fb_invocation_c     *symbol) {add(symbol, symbol->fb_name);  return iterator_visitor_c::visit(symbol);}
+    void *visit(il_fb_call_c        *symbol) {add(symbol, symbol->fb_name);  return iterator_visitor_c::visit(symbol);}
+};
+
+
+/* With restrict_instances__ (-O X), the VAR_INPUTs of a FB or PROGRAM whose ST body may read them from a const copy
+ * made on its entry: those of an elementary type (other than the STRINGs) that the body reads, but never writes, passes
+ * to a parameter that may be a VAR_IN_OUT (any non formal parameter), nor takes a REF() to.
+ */
+class find_const_inputs_c: public iterator_visitor_c {
+  private:
+    std::set<std::string> reads;
+    std::set<std::string> writes;
+    symbol_c             *called_pou;  /* the POU called by the invocation whose parameters are visited */
+
+    static std::string key(symbol_c *name) {
+      token_c *token = dynamic_cast<token_c *>(name);
+      std::string res((NULL == token)? "" : token->value);
+      for (unsigned int i = 0; i < res.size(); i++) res[i] = toupper((unsigned char)res[i]);
+      return res;
+    }
+
+    void write(symbol_c *variable) {
+      array_variable_c      *array_variable      = dynamic_cast<array_variable_c      *>(variable);
+      structured_variable_c *structured_variable = dynamic_cast<structured_variable_c *>(variable);
+      symbolic_variable_c   *symbolic_variable   = dynamic_cast<symbolic_variable_c   *>(variable);
+      if (NULL != array_variable) {
+        array_variable->subscript_list->accept(*this);
+        write(array_variable->subscripted_variable);
+      }
+      else if (NULL != structured_variable) write(structured_variable->record_variable);
+      else if (NULL != symbolic_variable)   writes.insert(key(symbolic_variable->var_name));
+      else variable->accept(*this);
+    }
+
+    /* a variable passed to a parameter that may be a VAR_IN_OUT */
+    void pass(symbol_c *expression) {
+      if (   (NULL != dynamic_cast<symbolic_variable_c   *>(expression))
+          || (NULL != dynamic_cast<array_variable_c      *>(expression))
+          || (NULL != dynamic_cast<structured_variable_c *>(expression)))
+        write(expression);
+      else
+        expression->accept(*this);
+    }
+
+    void visit_call(symbol_c *pou, symbol_c *formal_param_list, symbol_c *nonformal_param_list) {
+      symbol_c *saved_called_pou = called_pou;
+      called_pou = pou;
+      if (NULL != formal_param_list) formal_param_list->accept(*this);
+      list_c *list = dynamic_cast<list_c *>(nonformal_param_list);
+      for (int i = 0; (NULL != list) && (i < list->n); i++) pass(list->get_element(i));
+      called_pou = saved_called_pou;
+    }
+
+  public:
+    find_const_inputs_c(void) {called_pou = NULL;}
+
+    static void find(symbol_c *pou, symbol_c *body, std::set<std::string> &inputs) {
+      inputs.clear();
+      if (NULL == dynamic_cast<statement_list_c *>(body)) return;  /* only the ST bodies */
+      find_const_inputs_c find_const_inputs;
+      body->accept(find_const_inputs);
+
+      function_param_iterator_c fp_iterator(pou);
+      identifier_c *param_name;
+      while ((param_name = fp_iterator.next()) != NULL) {
+        if (fp_iterator.param_direction() != function_param_iterator_c::direction_in) continue;
+        if (0 == strcasecmp(param_name->value, "EN")) continue;   /* tested before the body runs */
+        symbol_c *type = fp_iterator.param_type();
+        if (   !get_datatype_info_c::is_type_valid(type) || !get_datatype_info_c::is_ANY_ELEMENTARY(type)
+            ||  get_datatype_info_c::is_ANY_STRING(type)) continue;
+        std::string name = key(param_name);
+        if ((find_const_inputs.reads.count(name) > 0) && (find_const_inputs.writes.count(name) == 0)) inputs.insert(name);
+      }
+    }
+
+  private:
+    void *visit(symbolic_variable_c *symbol) {reads.insert(key(symbol->var_name)); return NULL;}
+    void *visit(ref_expression_c    *symbol) {write(symbol->exp); return NULL;}
+
+    void *visit(assignment_statement_c *symbol) {
+      write(symbol->l_exp);
+      symbol->r_exp->accept(*this);
+      return NULL;
+    }
+
+    void *visit(function_invocation_c *symbol) {
+      visit_call(symbol->called_function_declaration, symbol->formal_param_list, symbol->nonformal_param_list);
+      return NULL;
+    }
+
+    void *visit(fb_invocation_c *symbol) {
+      visit_call(symbol->called_fb_declaration, symbol->formal_param_list, symbol->nonformal_param_list);
+      return NULL;
+    }
+
+    /* variable_name ':=' expression */
+    void *visit(input_variable_param_assignment_c *symbol) {
+      bool inout = true;  /* when in doubt */
+      if (NULL != called_pou) {
+        function_param_iterator_c fp_iterator(called_pou);
+        if (NULL != fp_iterator.search(symbol->variable_name))
+          inout = (fp_iterator.param_direction() == function_param_iterator_c::direction_inout);
+      }
+      if (inout) pass(symbol->expression);
+      else       symbol->expression->accept(*this);
+      return NULL;
+    }
+
+    /* [NOT] variable_name '=>' variable */
+    void *visit(output_variable_param_assignment_c *symbol) {write(symbol->variable); return NULL;}
+};
+
+
 /***********************************************************************/
 /***********************************************************************/
 /***********************************************************************/
@@ -841,6 +1548,135 @@ class generate_c_pous_c {
    */ 
 
   private:
+    /* Declare the variables of a FB or PROGRAM instance data structure.
+     * With -O s they are declared sorted by alignment (largest first), which keeps the padding to a minimum.
+     */
+    static void print_instance_variables(generate_c_vardecl_c *vardecl, symbol_c *var_declarations, bool sorted = sort_instance_variables__) {
+      static const int alignments[] = {8, 4, 2, 1, 0 /* end of array marker! Do not remove! */};
+      if (!sorted) {vardecl->print(var_declarations); return;}
+      for (int i = 0; alignments[i] != 0; i++) {
+        vardecl->set_wanted_alignment(alignments[i]);
+        vardecl->print(var_declarations);
+      }
+    }
+
+    /* Declare the interface (IN, OUT, IN_OUT, and EN, ENO of the FBs) and then the private variables (TEMP, private,
+     * located and external) of a FB or PROGRAM instance data structure.
+     * With -O H all of them are instead declared ordered by how much the body uses them, each group sorted by alignment
+     * (see generate_c_vardecl_c::set_wanted_heat()).
+     */
+    static void print_instance_data(stage4out_c &s4o, const char *pou_kind, unsigned int interface_vartypes, symbol_c *var_declarations, symbol_c *body) {
+      static const generate_c_vardecl_c::var_heat_t heats[] = {generate_c_vardecl_c::hot_vh,  generate_c_vardecl_c::warm_vh,
+                                                               generate_c_vardecl_c::cold_vh, generate_c_vardecl_c::large_vh,
+                                                               generate_c_vardecl_c::any_vh /* end of array marker! Do not remove! */};
+      const unsigned int private_vartypes = generate_c_vardecl_c::temp_vt    |
+                                            generate_c_vardecl_c::private_vt |
+                                            generate_c_vardecl_c::located_vt |
+                                            generate_c_vardecl_c::external_vt;
+      generate_c_vardecl_c interface_vardecl(&s4o, generate_c_vardecl_c::local_vf, interface_vartypes);
+      generate_c_vardecl_c private_vardecl  (&s4o, generate_c_vardecl_c::local_vf, private_vartypes);
+
+      if (!hot_cold_fields__) {
+        s4o.print(s4o.indent_spaces + "// " + pou_kind + " Interface - IN, OUT, IN_OUT variables\n");
+        print_instance_variables(&interface_vardecl, var_declarations);
+        s4o.print("\n");
+        s4o.print(s4o.indent_spaces + "// " + pou_kind + " private variables - TEMP, private and located variables\n");
+        print_instance_variables(&private_vardecl, var_declarations);
+        return;
+      }
+
+      std::map<std::string, unsigned long long> accesses;
+      count_variable_accesses_c::get(body, accesses);
+      s4o.print(s4o.indent_spaces + "// " + pou_kind + " variables - IN, OUT, IN_OUT, TEMP, private and located variables, the most used first\n");
+      for (int i = 0; heats[i] != generate_c_vardecl_c::any_vh; i++) {
+        interface_vardecl.set_wanted_heat(heats[i], &accesses);
+        private_vardecl  .set_wanted_heat(heats[i], &accesses);
+        print_instance_variables(&interface_vardecl, var_declarations, true);
+        print_instance_variables(&private_vardecl,   var_declarations, true);
+      }
+    }
+
+    /* With amalgamate__ the POUs are only called from within AMALGAMATION.c */
+    static void print_linkage(stage4out_c &s4o) {
+      if (amalgamate__) s4o.print("static ");
+    }
+
+    /* With a profile (-O P), the POUs that never ran are cold, and those that run the most are hot, see generate_c_pgo.cc */
+    static void print_temperature(stage4out_c &s4o, symbol_c *pou) {
+      if (NULL == stmt_profile__) return;
+      switch (stmt_profile__->pou_temperature(pou)) {
+        case  1: s4o.print("__HOT_POU ");  break;
+        case -1: s4o.print("__COLD_POU "); break;
+        default: break;
+      }
+    }
+
+    /* With profile_pous__ (-O o), the counters of the POU type, see iec_profile.h */
+    static void print_profile_declaration(stage4out_c &s4o, symbol_c *pou_name) {
+      generate_c_base_and_typeid_c print_base(&s4o);
+      s4o.print("__PROFILE_DECLARE(");
+      pou_name->accept(print_base);
+      s4o.print(")\n");
+    }
+
+    static void print_profile_end(stage4out_c &s4o, symbol_c *pou_name) {
+      generate_c_base_and_typeid_c print_base(&s4o);
+      s4o.print(s4o.indent_spaces + "__PROFILE_END(");
+      pou_name->accept(print_base);
+      s4o.print(")\n");
+    }
+
+    /* With parallel_networks__ (-O N), the body of a PROGRAM split into several networks (see stage3/independent_networks_analysis.hh) */
+    static statement_list_c *get_parallel_networks(program_declaration_c *symbol) {
+      statement_list_c *body = dynamic_cast<statement_list_c *>(symbol->function_block_body);
+      if (!parallel_networks__ || (NULL == body) || (independent_networks_analysis_c::get_network_count(body) < 2)) return NULL;
+      return body;
+    }
+
+    /* The functions running each network of the PROGRAM body, e.g. 'static void TEST_network0__(void *data)',
+     * and the table of these functions, TEST_networks__[], that the body hands to __parallel_run() (see iec_parallel.h).
+     */
+    static void print_network_functions(stage4out_c &s4o, program_declaration_c *symbol, statement_list_c *body) {
+      generate_c_base_and_typeid_c print_base(&s4o);
+      string_literal_pool_c        string_literal_pool(symbol);
+
+      for (int network = 0; network < independent_networks_analysis_c::get_network_count(body); network++) {
+        /* the statements of the network, in their original order */
+        statement_list_c network_body;
+        for (int i = 0; i < body->n; i++)
+          if (independent_networks_analysis_c::get_network(body->get_element(i)) == network) network_body.add_element(body->get_element(i));
+
+        s4o.print("static void ");
+        symbol->program_type_name->accept(print_base);
+        s4o.print("_network");
+        s4o.print(network);
+        s4o.print("__(void *data) {\n");
+        s4o.indent_right();
+        s4o.print(s4o.indent_spaces);
+        symbol->program_type_name->accept(print_base);
+        s4o.print(restrict_instances__? " *__RESTRICT " FB_FUNCTION_PARAM " = (" : " *" FB_FUNCTION_PARAM " = (");
+        symbol->program_type_name->accept(print_base);
+        s4o.print(" *)data;\n");
+        string_literal_pool.print_declarations(s4o, &network_body);
+        generate_c_SFC_IL_ST_c generate_c_code(&s4o, symbol->program_type_name, symbol, FB_FUNCTION_PARAM"->");
+        network_body.accept(generate_c_code);
+        s4o.indent_left();
+        s4o.print(s4o.indent_spaces + "}\n\n");
+      }
+
+      s4o.print("static __parallel_network_t ");
+      symbol->program_type_name->accept(print_base);
+      s4o.print("_networks__[] = {");
+      for (int network = 0; network < independent_networks_analysis_c::get_network_count(body); network++) {
+        if (network > 0) s4o.print(", ");
+        symbol->program_type_name->accept(print_base);
+        s4o.print("_network");
+        s4o.print(network);
+        s4o.print("__");
+      }
+      s4o.print("};\n\n");
+    }
+
     static void print_end_of_block_label(stage4out_c &s4o) {
       /* Print and __end label for return statements!
        * If label is not used by at least one goto, compiler will generate a warning.
@@ -882,10 +1718,21 @@ class generate_c_pous_c {
       generate_c_base_and_typeid_c   print_base(&s4o);
       
       TRACE("function_declaration_c");
+
+      /* A static inline FUNCTION is completely defined in the .h file, instead of only being declared there */
+      bool is_inline = (inline_functions.count(symbol) > 0);
+      if (is_inline && !print_declaration) {s4o.print("// FUNCTION defined as static inline in the header file\n"); return;}
+      if (is_inline) print_declaration = false;
     
       /* (A) Function declaration... */
+      /* the counters of the profile, see iec_profile.h */
+      if (profile_pous__ && !print_declaration && !is_inline) print_profile_declaration(s4o, symbol->derived_function_name);
+
       /* (A.1) Function return type */
       s4o.print("// FUNCTION\n");
+      if (is_inline) s4o.print("static inline ");
+      else           print_linkage(s4o);
+      print_temperature(s4o, symbol);
       symbol->type_name->accept(print_base); /* return type */
       s4o.print(" ");
       /* (A.2) Function name */
@@ -916,9 +1763,12 @@ class generate_c_pous_c {
       s4o.print("\n" + s4o.indent_spaces + "{\n");
     
       /* (B) Function local variable declaration */
-      /* (B.1) Variables declared in ST source code */
       s4o.indent_right();
-      
+
+      /* (B.0) Constants with the string literals used in the function code */
+      string_literal_pool_c(symbol).print_declarations(s4o);
+
+      /* (B.1) Variables declared in ST source code */
       vardecl = new generate_c_vardecl_c(&s4o,
                     generate_c_vardecl_c::localinit_vf,
                     generate_c_vardecl_c::output_vt   |
@@ -1009,10 +1859,12 @@ class generate_c_pous_c {
       }
     
       /* (C) Function body */
+      if (profile_pous__ && !is_inline) s4o.print(s4o.indent_spaces + "__PROFILE_BEGIN\n");
       generate_c_SFC_IL_ST_c generate_c_code(&s4o, symbol->derived_function_name, symbol);
       symbol->function_body->accept(generate_c_code);
       
       print_end_of_block_label(s4o);
+      if (profile_pous__ && !is_inline) print_profile_end(s4o, symbol->derived_function_name);
       
       vardecl = new generate_c_vardecl_c(&s4o,
                     generate_c_vardecl_c::foutputassign_vf,
@@ -1047,6 +1899,116 @@ class generate_c_pous_c {
      */
     /*  FUNCTION_BLOCK derived_function_block_name io_OR_other_var_declarations function_block_body END_FUNCTION_BLOCK */
     //SYM_REF4(function_block_declaration_c, fblock_name, var_declarations, fblock_body, unused)
+    /* Print the interface of a FB body function, e.g. 'void TON_body__(TON *data__)' */
+    static void print_fb_body_interface(function_block_declaration_c *symbol, stage4out_c &s4o, const char *suffix) {
+      generate_c_base_and_typeid_c print_base(&s4o);
+      print_linkage(s4o);
+      print_temperature(s4o, symbol);
+      s4o.print("void ");
+      symbol->fblock_name->accept(print_base);
+      s4o.print(suffix);
+      s4o.print("(");
+      /* first and only parameter is a pointer to the data */
+      symbol->fblock_name->accept(print_base);
+      s4o.print(restrict_instances__? " *__RESTRICT " : " *");
+      s4o.print(FB_FUNCTION_PARAM);
+      s4o.print(")");
+    }
+
+    /* With restrict_instances__, declare the const copies of the inputs the ST body only reads (see find_const_inputs_c),
+     * and have the body read these instead (until the next call to clear_const_inputs()).
+     */
+    static void print_const_inputs(symbol_c *pou, symbol_c *body, stage4out_c &s4o) {
+      generate_c_base_and_typeid_c print_base(&s4o);
+      const_inputs__.clear();
+      if (!restrict_instances__) return;
+      find_const_inputs_c::find(pou, body, const_inputs__);
+      if (const_inputs__.empty()) return;
+      s4o.print(s4o.indent_spaces + "// Const copies of the inputs\n");
+      function_param_iterator_c fp_iterator(pou);
+      identifier_c *param_name;
+      while ((param_name = fp_iterator.next()) != NULL) {
+        if (!is_const_input_name(param_name->value)) continue;
+        s4o.print(s4o.indent_spaces + "const ");
+        fp_iterator.param_type()->accept(print_base);
+        s4o.print(" __input_");
+        param_name->accept(print_base);
+        s4o.print("__ = " GET_VAR "(" FB_FUNCTION_PARAM "->");
+        param_name->accept(print_base);
+        s4o.print(",);\n");
+      }
+      s4o.print("\n");
+    }
+
+    static void clear_const_inputs(void) {const_inputs__.clear();}
+
+    /* The start of the FB initialisation function, with fb_init_image__ (see B.1.1 and B.4 below).
+     * The initial values of the FB variables are all constants, and the pointers to the
+     * global (external) variables are the same for all the instances, so the instances of
+     * the FB type are all initialised to the same image (one with, and one without, retain).
+     */
+    static void print_fb_init_image_copy(function_block_declaration_c *symbol, stage4out_c &s4o) {
+      generate_c_base_and_typeid_c print_base(&s4o);
+      s4o.print(s4o.indent_spaces + "static ");
+      symbol->fblock_name->accept(print_base);
+      s4o.print(" __init_image__[2];\n");
+      s4o.print(s4o.indent_spaces + "static BOOL __init_image_valid__[2] = {0, 0};\n");
+      s4o.print(s4o.indent_spaces + "if (__init_image_valid__[retain != 0]) {*" FB_FUNCTION_PARAM " = __init_image__[retain != 0]; return;}\n\n");
+    }
+
+    /* The copy of the inputs of the previous call of the idempotent FBs, with skip_unchanged_fbs__ (see C.3.2 below) */
+    static bool skips_unchanged_inputs(function_block_declaration_c *symbol) {
+      return skip_unchanged_fbs__ && idempotent_fb_analysis_c::is_idempotent_fb(symbol);
+    }
+
+    static void print_previous_inputs_declaration(function_block_declaration_c *symbol, stage4out_c &s4o) {
+      generate_c_base_and_typeid_c print_base(&s4o);
+      s4o.print(s4o.indent_spaces + "// The inputs of the previous call (the body is skipped while they do not change)\n");
+      s4o.print(s4o.indent_spaces + "BOOL __previous_inputs_valid__;\n");
+      function_param_iterator_c fp_iterator(symbol);
+      identifier_c *param_name;
+      while ((param_name = fp_iterator.next()) != NULL) {
+        if (fp_iterator.param_direction() != function_param_iterator_c::direction_in) continue;
+        s4o.print(s4o.indent_spaces);
+        fp_iterator.param_type()->accept(print_base);
+        s4o.print(" __previous_");
+        param_name->accept(print_base);
+        s4o.print("__;\n");
+      }
+    }
+
+    /* Return from the body when the inputs have the same values as in the previous call, and otherwise keep them.
+     * The values are compared bytewise, so values that are equal but differ in their representation
+     * (e.g. -0.0 and 0.0, or the bytes after the end of a STRING) run the body, which is always safe.
+     */
+    static void print_previous_inputs_check(function_block_declaration_c *symbol, stage4out_c &s4o) {
+      generate_c_base_and_typeid_c print_base(&s4o);
+      s4o.print(s4o.indent_spaces + "// Skip the body when the inputs did not change\n");
+      s4o.print(s4o.indent_spaces + "{\n");
+      s4o.indent_right();
+      s4o.print(s4o.indent_spaces + "BOOL __inputs_changed = !" FB_FUNCTION_PARAM "->__previous_inputs_valid__;\n");
+      function_param_iterator_c fp_iterator(symbol);
+      identifier_c *param_name;
+      while ((param_name = fp_iterator.next()) != NULL) {
+        if (fp_iterator.param_direction() != function_param_iterator_c::direction_in) continue;
+        s4o.print(s4o.indent_spaces + "{");
+        fp_iterator.param_type()->accept(print_base);
+        s4o.print(" __input = " GET_VAR "(" FB_FUNCTION_PARAM "->");
+        param_name->accept(print_base);
+        s4o.print(",);\n");
+        s4o.print(s4o.indent_spaces + " __inputs_changed |= (memcmp(&__input, &" FB_FUNCTION_PARAM "->__previous_");
+        param_name->accept(print_base);
+        s4o.print("__, sizeof(__input)) != 0);\n");
+        s4o.print(s4o.indent_spaces + " " FB_FUNCTION_PARAM "->__previous_");
+        param_name->accept(print_base);
+        s4o.print("__ = __input;}\n");
+      }
+      s4o.print(s4o.indent_spaces + "if (!__inputs_changed) return;\n");
+      s4o.print(s4o.indent_spaces + FB_FUNCTION_PARAM "->__previous_inputs_valid__ = 1;\n");
+      s4o.indent_left();
+      s4o.print(s4o.indent_spaces + "}\n\n");
+    }
+
     static void handle_function_block(function_block_declaration_c *symbol, stage4out_c &s4o, bool print_declaration) {
       generate_c_vardecl_c          *vardecl;
       generate_c_sfcdecl_c          *sfcdecl;
@@ -1063,34 +2025,25 @@ class generate_c_pous_c {
         s4o.indent_right();
 
         /* (A.2) Public variables: i.e. the function parameters... */
-        s4o.print(s4o.indent_spaces + "// FB Interface - IN, OUT, IN_OUT variables\n");
-        vardecl = new generate_c_vardecl_c(&s4o,
-                                           generate_c_vardecl_c::local_vf,
-                                           generate_c_vardecl_c::input_vt    |
-                                           generate_c_vardecl_c::output_vt   |
-                                           generate_c_vardecl_c::inoutput_vt |
-                                           generate_c_vardecl_c::en_vt       |
-                                           generate_c_vardecl_c::eno_vt);
-        vardecl->print(symbol->var_declarations);
-        delete vardecl;
-        s4o.print("\n");
-
         /* (A.3) Private internal variables */
-        s4o.print(s4o.indent_spaces + "// FB private variables - TEMP, private and located variables\n");
-        vardecl = new generate_c_vardecl_c(&s4o,
-                                           generate_c_vardecl_c::local_vf,
-                                           generate_c_vardecl_c::temp_vt    |
-                                           generate_c_vardecl_c::private_vt |
-                                           generate_c_vardecl_c::located_vt |
-                                           generate_c_vardecl_c::external_vt);
-        vardecl->print(symbol->var_declarations);
-        delete vardecl;
+        print_instance_data(s4o, "FB", generate_c_vardecl_c::input_vt    |
+                                       generate_c_vardecl_c::output_vt   |
+                                       generate_c_vardecl_c::inoutput_vt |
+                                       generate_c_vardecl_c::en_vt       |
+                                       generate_c_vardecl_c::eno_vt,
+                            symbol->var_declarations, symbol->fblock_body);
         
         /* (A.4) Generate private internal variables for SFC */
         sfcdecl = new generate_c_sfcdecl_c(&s4o, symbol);
         sfcdecl->generate(symbol->fblock_body, generate_c_sfcdecl_c::sfcdecl_sd);
         delete sfcdecl;
         s4o.print("\n");
+
+        /* (A.4.1) The inputs of the previous call (skip_unchanged_fbs__) */
+        if (skips_unchanged_inputs(symbol)) {
+          print_previous_inputs_declaration(symbol, s4o);
+          s4o.print("\n");
+        }
       
         /* (A.5) Function Block data structure type name. */
         s4o.indent_left();
@@ -1098,6 +2051,9 @@ class generate_c_pous_c {
         symbol->fblock_name->accept(print_base);
         s4o.print(";\n\n");
       }
+
+      /* (A.7) The layout of the instances (layout_descriptors__), see generate_c_layout.cc */
+      if (layout_descriptors__) generate_c_layout_c::generate(s4o, symbol->fblock_name, symbol->var_declarations, print_declaration);
       
       if (!print_declaration) {
         /* (A.6) Function Block inline function declaration for function invocation */
@@ -1108,7 +2064,9 @@ class generate_c_pous_c {
       
       /* (B) Constructor */
       /* (B.1) Constructor name... */
-      s4o.print(s4o.indent_spaces + "void ");
+      s4o.print(s4o.indent_spaces);
+      print_linkage(s4o);
+      s4o.print("void ");
       symbol->fblock_name->accept(print_base);
       s4o.print(FB_INIT_SUFFIX);
       s4o.print("(");
@@ -1124,6 +2082,9 @@ class generate_c_pous_c {
       } else {
         s4o.print(" {\n");
         s4o.indent_right();
+
+        /* (B.1.1) The instances initialised after the first one (with the same retain) are a copy of it (fb_init_image__) */
+        if (fb_init_image__) print_fb_init_image_copy(symbol, s4o);
       
         /* (B.2) Member initializations... */
         s4o.print(s4o.indent_spaces);
@@ -1140,10 +2101,18 @@ class generate_c_pous_c {
         vardecl->print(symbol->var_declarations, NULL, FB_FUNCTION_PARAM"->");
         delete vardecl;
         s4o.print("\n");
+        if (skips_unchanged_inputs(symbol))
+          s4o.print(s4o.indent_spaces + FB_FUNCTION_PARAM "->__previous_inputs_valid__ = 0;\n");
             
         /* (B.3) Generate private internal variables for SFC */
         sfcdecl = new generate_c_sfcdecl_c(&s4o, symbol, FB_FUNCTION_PARAM"->");
         sfcdecl->generate(symbol->fblock_body, generate_c_sfcdecl_c::sfcinit_sd);
+
+        /* (B.4) Keep the image of the initialised instance */
+        if (fb_init_image__) {
+          s4o.print(s4o.indent_spaces + "__init_image__[retain != 0] = *" FB_FUNCTION_PARAM ";\n");
+          s4o.print(s4o.indent_spaces + "__init_image_valid__[retain != 0] = 1;\n");
+        }
       
         s4o.indent_left();
         s4o.print(s4o.indent_spaces + "}\n\n");
@@ -1158,32 +2127,71 @@ class generate_c_pous_c {
       }
       
       /* (C.3) Function declaration */
+      // Only generate the code that controls the execution of the function's body if the
+      // function contains a declaration of both the EN and ENO variables
+      search_var_instance_decl_c search_var(symbol);
+      identifier_c  en_var("EN");
+      identifier_c eno_var("ENO");
+      bool has_eneno =    (search_var.get_vartype(& en_var) == search_var_instance_decl_c::input_vt)
+                       && (search_var.get_vartype(&eno_var) == search_var_instance_decl_c::output_vt);
+
+      /* the counters of the profile, see iec_profile.h */
+      if (profile_pous__ && !print_declaration) print_profile_declaration(s4o, symbol->fblock_name);
+
       s4o.print("// Code part\n");
-      /* function interface */
-      s4o.print("void ");
-      symbol->fblock_name->accept(print_base);
-      s4o.print(FB_FUNCTION_SUFFIX);
-      s4o.print("(");
-      /* first and only parameter is a pointer to the data */
-      symbol->fblock_name->accept(print_base);
-      s4o.print(" *");
-      s4o.print(FB_FUNCTION_PARAM);
-      s4o.print(")");
+      /* The FB body without the code controlling its execution is placed in a function of its own, 
+       * so it may be called directly by the POUs that do not use EN/ENO (see -O e)
+       */
+      print_fb_body_interface(symbol, s4o, has_eneno? FB_NOENENO_FUNCTION_SUFFIX : FB_FUNCTION_SUFFIX);
 
       if (print_declaration) {
         s4o.print(";\n");
+        if (has_eneno) {
+          print_fb_body_interface(symbol, s4o, FB_FUNCTION_SUFFIX);
+          s4o.print(";\n");
+        }
       } else {
         s4o.print(" {\n");
         s4o.indent_right();
 
-        // Only generate the code that controls the execution of the function's body if the
-        // function contains a declaration of both the EN and ENO variables
-        search_var_instance_decl_c search_var(symbol);
-        identifier_c  en_var("EN");
-        identifier_c eno_var("ENO");
-        if (   (search_var.get_vartype(& en_var) == search_var_instance_decl_c::input_vt)
-            && (search_var.get_vartype(&eno_var) == search_var_instance_decl_c::output_vt)) {
+        /* (C.3.1) Constants with the string literals used in the FB code */
+        string_literal_pool_c(symbol).print_declarations(s4o);
 
+        /* (C.3.2) Idempotent FBs called with the same inputs as before (skip_unchanged_fbs__) */
+        if (skips_unchanged_inputs(symbol)) print_previous_inputs_check(symbol, s4o);
+
+        /* (C.3.3) Const copies of the inputs the body only reads (restrict_instances__) */
+        print_const_inputs(symbol, symbol->fblock_body, s4o);
+
+        /* (C.4) Initialize TEMP variables */
+        /* function body */
+        s4o.print(s4o.indent_spaces + "// Initialise TEMP variables\n");
+        vardecl = new generate_c_vardecl_c(&s4o,
+                                           generate_c_vardecl_c::init_vf,
+                                           generate_c_vardecl_c::temp_vt);
+        vardecl->print(symbol->var_declarations, NULL,  FB_FUNCTION_PARAM"->");
+        delete vardecl;
+        s4o.print("\n");
+      
+        /* (C.5) Function code */
+        if (profile_pous__) s4o.print(s4o.indent_spaces + "__PROFILE_BEGIN\n");
+        generate_c_SFC_IL_ST_c generate_c_code(&s4o, symbol->fblock_name, symbol, FB_FUNCTION_PARAM"->");
+        symbol->fblock_body->accept(generate_c_code);
+        clear_const_inputs();
+        print_end_of_block_label(s4o);
+        if (profile_pous__) print_profile_end(s4o, symbol->fblock_name);
+        s4o.print(s4o.indent_spaces + "return;\n");
+        s4o.indent_left();
+        s4o.print(s4o.indent_spaces + "} // ");
+        symbol->fblock_name->accept(print_base);
+        s4o.print(has_eneno? FB_NOENENO_FUNCTION_SUFFIX : FB_FUNCTION_SUFFIX);
+        s4o.print(s4o.indent_spaces + "() \n\n");
+
+        if (has_eneno) {
+          /* (C.5.1) Function controlling the execution of the FB body */
+          print_fb_body_interface(symbol, s4o, FB_FUNCTION_SUFFIX);
+          s4o.print(" {\n");
+          s4o.indent_right();
           s4o.print(s4o.indent_spaces + "// Control execution\n");
           s4o.print(s4o.indent_spaces + "if (!");
           s4o.print(GET_VAR);
@@ -1202,35 +2210,25 @@ class generate_c_pous_c {
           s4o.print(s4o.indent_spaces + "else {\n");
           s4o.indent_right();
           s4o.print(s4o.indent_spaces);
-          s4o.print(SET_VAR);
+          s4o.print(SET_VAR);
+          s4o.print("(");
+          s4o.print(FB_FUNCTION_PARAM);
+          s4o.print("->,ENO,,__BOOL_LITERAL(TRUE));\n");
+          s4o.indent_left();
+          s4o.print(s4o.indent_spaces + "}\n");
+          s4o.print(s4o.indent_spaces);
+          symbol->fblock_name->accept(print_base);
+          s4o.print(FB_NOENENO_FUNCTION_SUFFIX);
           s4o.print("(");
           s4o.print(FB_FUNCTION_PARAM);
-          s4o.print("->,ENO,,__BOOL_LITERAL(TRUE));\n");
+          s4o.print(");\n");
           s4o.indent_left();
-          s4o.print(s4o.indent_spaces + "}\n");
+          s4o.print(s4o.indent_spaces + "} // ");
+          symbol->fblock_name->accept(print_base);
+          s4o.print(FB_FUNCTION_SUFFIX);
+          s4o.print(s4o.indent_spaces + "() \n\n");
         }
       
-        /* (C.4) Initialize TEMP variables */
-        /* function body */
-        s4o.print(s4o.indent_spaces + "// Initialise TEMP variables\n");
-        vardecl = new generate_c_vardecl_c(&s4o,
-                                           generate_c_vardecl_c::init_vf,
-                                           generate_c_vardecl_c::temp_vt);
-        vardecl->print(symbol->var_declarations, NULL,  FB_FUNCTION_PARAM"->");
-        delete vardecl;
-        s4o.print("\n");
-      
-        /* (C.5) Function code */
-        generate_c_SFC_IL_ST_c generate_c_code(&s4o, symbol->fblock_name, symbol, FB_FUNCTION_PARAM"->");
-        symbol->fblock_body->accept(generate_c_code);
-        print_end_of_block_label(s4o);
-        s4o.print(s4o.indent_spaces + "return;\n");
-        s4o.indent_left();
-        s4o.print(s4o.indent_spaces + "} // ");
-        symbol->fblock_name->accept(print_base);
-        s4o.print(FB_FUNCTION_SUFFIX);
-        s4o.print(s4o.indent_spaces + "() \n\n");
-      
         /* (C.6) Step undefinitions */
         sfcdecl = new generate_c_sfcdecl_c(&s4o, symbol, FB_FUNCTION_PARAM"->");
         sfcdecl->generate(symbol->fblock_body, generate_c_sfcdecl_c::stepundef_sd);
@@ -1274,26 +2272,11 @@ class generate_c_pous_c {
         s4o.indent_right();
       
         /* (A.2) Public variables: i.e. the program parameters... */
-        s4o.print(s4o.indent_spaces + "// PROGRAM Interface - IN, OUT, IN_OUT variables\n");
-        vardecl = new generate_c_vardecl_c(&s4o,
-                                           generate_c_vardecl_c::local_vf,
-                                           generate_c_vardecl_c::input_vt  |
-                                           generate_c_vardecl_c::output_vt |
-                                           generate_c_vardecl_c::inoutput_vt);
-        vardecl->print(symbol->var_declarations);
-        delete vardecl;
-        s4o.print("\n");
-  
         /* (A.3) Private internal variables */
-        s4o.print(s4o.indent_spaces + "// PROGRAM private variables - TEMP, private and located variables\n");
-        vardecl = new generate_c_vardecl_c(&s4o,
-                      generate_c_vardecl_c::local_vf,
-                      generate_c_vardecl_c::temp_vt    |
-                      generate_c_vardecl_c::private_vt |
-                      generate_c_vardecl_c::located_vt |
-                      generate_c_vardecl_c::external_vt);
-        vardecl->print(symbol->var_declarations);
-        delete vardecl;
+        print_instance_data(s4o, "PROGRAM", generate_c_vardecl_c::input_vt  |
+                                            generate_c_vardecl_c::output_vt |
+                                            generate_c_vardecl_c::inoutput_vt,
+                            symbol->var_declarations, symbol->function_block_body);
       
         /* (A.4) Generate private internal variables for SFC */
         sfcdecl = new generate_c_sfcdecl_c(&s4o, symbol);
@@ -1307,6 +2290,9 @@ class generate_c_pous_c {
         symbol->program_type_name->accept(print_base);
         s4o.print(";\n\n");
       }
+
+      /* (A.7) The layout of the instances (layout_descriptors__), see generate_c_layout.cc */
+      if (layout_descriptors__) generate_c_layout_c::generate(s4o, symbol->program_type_name, symbol->var_declarations, print_declaration);
       
       if (!print_declaration) {      
         /* (A.6) Function Block inline function declaration for function invocation */
@@ -1317,7 +2303,9 @@ class generate_c_pous_c {
     
       /* (B) Constructor */
       /* (B.1) Constructor name... */
-      s4o.print(s4o.indent_spaces + "void ");
+      s4o.print(s4o.indent_spaces);
+      print_linkage(s4o);
+      s4o.print("void ");
       symbol->program_type_name->accept(print_base);
       s4o.print(FB_INIT_SUFFIX);
       s4o.print("(");
@@ -1366,18 +2354,26 @@ class generate_c_pous_c {
         /* (C.2) Action definitions */
         sfcdecl->generate(symbol->function_block_body, generate_c_sfcdecl_c::actiondef_sd);
         delete sfcdecl;
+
+        /* (C.2.1) The networks run in parallel, with parallel_networks__ (see C.5 below) */
+        if (NULL != get_parallel_networks(symbol)) print_network_functions(s4o, symbol, get_parallel_networks(symbol));
       }
       
       /* (C.3) Function declaration */
+      /* the counters of the profile, see iec_profile.h */
+      if (profile_pous__ && !print_declaration) print_profile_declaration(s4o, symbol->program_type_name);
+
       s4o.print("// Code part\n");
       /* function interface */
+      print_linkage(s4o);
+      print_temperature(s4o, symbol);
       s4o.print("void ");
       symbol->program_type_name->accept(print_base);
       s4o.print(FB_FUNCTION_SUFFIX);
       s4o.print("(");
       /* first and only parameter is a pointer to the data */
       symbol->program_type_name->accept(print_base);
-      s4o.print(" *");
+      s4o.print(restrict_instances__? " *__RESTRICT " : " *");
       s4o.print(FB_FUNCTION_PARAM);
       s4o.print(")");
 
@@ -1386,6 +2382,13 @@ class generate_c_pous_c {
       } else {
         s4o.print(" {\n");
         s4o.indent_right();
+
+        /* (C.3.1) Constants with the string literals used in the program code (those of the networks run in parallel are in their own function) */
+        statement_list_c *networks = get_parallel_networks(symbol);
+        if (NULL == networks) string_literal_pool_c(symbol).print_declarations(s4o);
+
+        /* (C.3.2) Const copies of the inputs the body only reads (restrict_instances__, not in the networks run in parallel) */
+        if (NULL == networks) print_const_inputs(symbol, symbol->function_block_body, s4o);
           
         /* (C.4) Initialize TEMP variables */
         /* function body */
@@ -1398,9 +2401,21 @@ class generate_c_pous_c {
         s4o.print("\n");
       
         /* (C.5) Function code */
-        generate_c_SFC_IL_ST_c generate_c_code(&s4o, symbol->program_type_name, symbol, FB_FUNCTION_PARAM"->");
-        symbol->function_block_body->accept(generate_c_code);
+        if (profile_pous__) s4o.print(s4o.indent_spaces + "__PROFILE_BEGIN\n");
+        if (NULL != networks) {
+          /* the networks run in parallel, and all of them ran when __parallel_run() returns (see iec_parallel.h) */
+          s4o.print(s4o.indent_spaces + "__parallel_run(");
+          symbol->program_type_name->accept(print_base);
+          s4o.print("_networks__, " FB_FUNCTION_PARAM ", ");
+          s4o.print(independent_networks_analysis_c::get_network_count(networks));
+          s4o.print(");\n");
+        } else {
+          generate_c_SFC_IL_ST_c generate_c_code(&s4o, symbol->program_type_name, symbol, FB_FUNCTION_PARAM"->");
+          symbol->function_block_body->accept(generate_c_code);
+          clear_const_inputs();
+        }
         print_end_of_block_label(s4o);
+        if (profile_pous__) print_profile_end(s4o, symbol->program_type_name);
         s4o.print(s4o.indent_spaces + "return;\n");
         s4o.indent_left();
         s4o.print(s4o.indent_spaces + "} // ");
@@ -1448,10 +2463,41 @@ class generate_c_config_c: public generate_c_base_and_typeid_c {
       initprotos_dt,
       initdeclare_dt,
       runprotos_dt,
-      rundeclare_dt
+      rundeclare_dt,
+      runtable_dt,
+      contexttable_dt,
+      taskstatstable_dt
     } declaretype_t;
 
     declaretype_t wanted_declaretype;
+    /* with -O G, the index of the resource whose copies of the globals its initialisation binds to */
+    int resource_index;
+
+    /* With -O G, print macro(name) for each global variable of the configuration that the resources
+     * get a copy of, i.e. all but the located ones and the FB instances (see iec_global_snapshot.h).
+     */
+    void print_global_snapshots(symbol_c *global_var_declarations, const char *macro) {
+      list_c *declarations = dynamic_cast<list_c *>(global_var_declarations);
+      if (NULL == declarations) return;
+      for (int i = 0; i < declarations->n; i++) {
+        global_var_declarations_c *block = dynamic_cast<global_var_declarations_c *>(declarations->get_element(i));
+        if (NULL == block) ERROR;
+        list_c *decl_list = dynamic_cast<list_c *>(block->global_var_decl_list);
+        if (NULL == decl_list) ERROR;
+        for (int j = 0; j < decl_list->n; j++) {
+          global_var_decl_c *decl = dynamic_cast<global_var_decl_c *>(decl_list->get_element(j));
+          if (NULL == decl) ERROR;
+          global_var_list_c *names = dynamic_cast<global_var_list_c *>(decl->global_var_spec);
+          if (NULL == names) continue; /* a located global */
+          if (get_datatype_info_c::is_function_block(spec_init_sperator_c::get_spec(decl->type_specification))) continue;
+          for (int k = 0; k < names->n; k++) {
+            s4o.print(s4o.indent_spaces + macro + "(");
+            names->get_element(k)->accept(*this);
+            s4o.print(")\n");
+          }
+        }
+      }
+    }
 
     
 public:
@@ -1494,25 +2540,42 @@ void *visit(configuration_declaration_c *symbol) {
   s4o.print("/* Editing this file is not recommended... */\n");
   s4o.print("/*******************************************/\n\n");
   
-  if (runtime_options.disable_implicit_en_eno) {
-    // If we are not generating the EN and ENO parameters for functions and FB,
-    //   then make sure we use the standard library version compiled without these parameters too!
-    s4o.print("#ifndef DISABLE_EN_ENO_PARAMETERS\n");
-    s4o.print("#define DISABLE_EN_ENO_PARAMETERS\n");
-    s4o.print("#endif\n");
-  }
+  print_library_defines(s4o);
   
   s4o.print("#include \"iec_std_lib.h\"\n\n");
   s4o.print("#include \"accessor.h\"\n\n"); 
   s4o.print("#include \"POUS.h\"\n\n");
+  if (debug_table__) {
+    s4o.print("#include \"iec_debug_trace.h\"\n");
+    s4o.print("#include \"iec_debug_force.h\"\n\n");
+  }
+  if (!shared_image_vars__.empty())
+    s4o.print("#include \"iec_shared_image.h\"\n\n");
+  if (input_recorder__)
+    s4o.print("#include \"iec_input_recorder.h\"\n\n");
 
   /* (A) configuration declaration... */
   /* (A.1) configuration name in comment */
   s4o.print("// CONFIGURATION ");
   symbol->configuration_name->accept(*this);
   s4o.print("\n");
+  if (resource_context__) {
+    s4o.print("__resource_context_t config_context__; /*the context of config_init__(), see iec_resource_context.h*/\n");
+    s4o.print("__thread __resource_context_t *__current_resource_context = &config_context__; /*set by the resources' entry points*/\n");
+  }
+  if (parallel_networks__)
+    s4o.print("__thread __parallel_pool_t *__current_parallel_pool = NULL; /*set by the resources' entry points, see iec_parallel.h*/\n");
+  
+  if (global_snapshots__) {
+    list_c *resources = dynamic_cast<list_c *>(symbol->resource_declarations);
+    s4o.print("#define __GLOBAL_SNAPSHOT_RESOURCES ");
+    s4o.print((NULL == resources)? 1 : resources->n);
+    s4o.print("\n");
+    s4o.print("static int __snapshot_resource__ = -1; /*the resource being initialised, see iec_global_snapshot.h*/\n");
+  }
   
   /* (A.2) Global variables */
+  if (task_data__) print_task_data_alignment(s4o, symbol->configuration_name);
   vardecl = new generate_c_vardecl_c(&s4o,
                                      generate_c_vardecl_c::local_vf,
                                      generate_c_vardecl_c::global_vt,
@@ -1530,6 +2593,15 @@ void *visit(configuration_declaration_c *symbol) {
   delete vardecl;
   s4o_incl.print("\n");
 
+  /* (A.4) Exchange of the copies of the global variables of each resource (-O G) */
+  if (global_snapshots__) {
+    s4o.print(s4o.indent_spaces + "void config_exchange__(void) {\n");
+    s4o.indent_right();
+    print_global_snapshots(symbol->global_var_declarations, "__EXCHANGE_GLOBAL");
+    s4o.indent_left();
+    s4o.print(s4o.indent_spaces + "}\n\n");
+  }
+
   /* (B) Initialisation Function */
   /* (B.1) Ressources initialisation protos... */
   wanted_declaretype = initprotos_dt;
@@ -1545,6 +2617,12 @@ void *visit(configuration_declaration_c *symbol) {
   s4o.print("BOOL retain;\n");
   s4o.print(s4o.indent_spaces);
   s4o.print("retain = 0;\n");
+  if (resource_context__)
+    /* the global FB instances of the configuration are initialised in the configuration's context */
+    s4o.print(s4o.indent_spaces + "__current_resource_context = &config_context__;\n");
+  if (timer_wheel__)
+    /* the wheel must be empty before the timers are initialised (see __tick_timer_init() in iec_timer_wheel.h) */
+    s4o.print(s4o.indent_spaces + "__timer_wheel_init();\n");
   
   /* (B.3) Global variables initializations... */
   s4o.print(s4o.indent_spaces);
@@ -1557,8 +2635,14 @@ void *visit(configuration_declaration_c *symbol) {
   s4o.print("\n");
   
   /* (B.3) Resources initializations... */
+  /* with -O G, each resource binds its VAR_EXTERNALs to its own copies, initialised from the globals */
+  if (global_snapshots__)
+    print_global_snapshots(symbol->global_var_declarations, "__INIT_GLOBAL_SNAPSHOT");
   wanted_declaretype = initdeclare_dt;
+  resource_index = 0;
   symbol->resource_declarations->accept(*this);
+  if (global_snapshots__)
+    s4o.print(s4o.indent_spaces + "__snapshot_resource__ = -1;\n");
   
   s4o.indent_left();
   s4o.print(s4o.indent_spaces + "}\n\n");
@@ -1575,14 +2659,76 @@ void *visit(configuration_declaration_c *symbol) {
   s4o.print(FB_RUN_SUFFIX);
   s4o.print("(unsigned long tick) {\n");
   s4o.indent_right();
+  if (debug_table__)
+    /* apply the requests to force and set variables posted since the previous cycle */
+    s4o.print(s4o.indent_spaces + "__debug_force_cycle();\n");
+  if (input_recorder__)
+    /* record the inputs of the cycle (including the forced ones), before the resources read them */
+    s4o.print(s4o.indent_spaces + "__input_recorder_cycle(tick);\n");
 
   /* (C.3) Resources initializations... */
   wanted_declaretype = rundeclare_dt;
   symbol->resource_declarations->accept(*this);
+  if (global_snapshots__)
+    /* the values written by the resources during the cycle become those of the globals */
+    s4o.print(s4o.indent_spaces + "config_exchange__();\n");
+  if (debug_table__)
+    /* copy the traced variables to the trace ring buffer, once the cycle is over */
+    s4o.print(s4o.indent_spaces + "__debug_trace_cycle(tick);\n");
+  if (!shared_image_vars__.empty())
+    /* publish the values of the cycle to the other processes */
+    s4o.print(s4o.indent_spaces + "__shared_image_cycle(tick);\n");
 
   /* (C.3) Close Public Function body */
   s4o.indent_left();
-  s4o.print(s4o.indent_spaces + "}\n");
+  s4o.print(s4o.indent_spaces + "}\n\n");
+
+  /* (D) Table of the resources' run functions */
+  /* A runtime that does not call config_run__() may call these functions directly, once per tick.
+   * The resources share the configuration's global variables, so they may only run concurrently (e.g.
+   * each on its own thread) when compiled with -O G, each resource then working on its own copy of the
+   * globals. The runtime must call config_exchange__() once all the resources are done with a cycle,
+   * and before any of them starts the next one (see iec_global_snapshot.h).
+   */
+  s4o.print(s4o.indent_spaces + "void (*config_resource_run__[])(unsigned long tick) = {\n");
+  s4o.indent_right();
+  wanted_declaretype = runtable_dt;
+  symbol->resource_declarations->accept(*this);
+  s4o.print(s4o.indent_spaces + "NULL\n");
+  s4o.indent_left();
+  s4o.print(s4o.indent_spaces + "};\n");
+  s4o.print(s4o.indent_spaces + "int config_resource_count__ = sizeof(config_resource_run__) / sizeof(config_resource_run__[0]) - 1;\n");
+  if (resource_context__) {
+    /* the context of each resource, in the same order, whose current_time (and debug) the runtime sets */
+    s4o.print(s4o.indent_spaces + "__resource_context_t *config_resource_context__[] = {\n");
+    s4o.indent_right();
+    wanted_declaretype = contexttable_dt;
+    symbol->resource_declarations->accept(*this);
+    s4o.print(s4o.indent_spaces + "NULL\n");
+    s4o.indent_left();
+    s4o.print(s4o.indent_spaces + "};\n");
+  }
+  if (task_stats__) {
+    /* the table of the statistics of the tasks of each resource, in the same order (see iec_task_stats.h) */
+    s4o.print(s4o.indent_spaces + "__task_stats_t *config_task_stats__[] = {\n");
+    s4o.indent_right();
+    wanted_declaretype = taskstatstable_dt;
+    symbol->resource_declarations->accept(*this);
+    s4o.print(s4o.indent_spaces + "NULL\n");
+    s4o.indent_left();
+    s4o.print(s4o.indent_spaces + "};\n");
+  }
+
+  /* (E) The state of the PLC, i.e. the global variables and the PROGRAM instances (layout_descriptors__) */
+  /* The runtime gets the tables of the old and of the new version of the program with this function
+   * to migrate the state between them (see __online_change() in iec_online_change.h).
+   */
+  if (layout_descriptors__) {
+    s4o.print("\n");
+    s4o.print(s4o.indent_spaces + "const __layout_instance_t *config_layout__(unsigned long *count) {\n");
+    s4o.print(s4o.indent_spaces + "  return __layout_instances(count);\n");
+    s4o.print(s4o.indent_spaces + "}\n");
+  }
 
   return NULL;
 }
@@ -1598,8 +2744,23 @@ void *visit(resource_declaration_c *symbol) {
     else {
       s4o.print(FB_RUN_SUFFIX);
       s4o.print("(unsigned long tick);\n");
+      if (resource_context__) {
+        s4o.print(s4o.indent_spaces + "extern __resource_context_t ");
+        symbol->resource_name->accept(*this);
+        s4o.print("_context__;\n");
+      }
+      if (task_stats__) {
+        s4o.print(s4o.indent_spaces + "extern __task_stats_t ");
+        symbol->resource_name->accept(*this);
+        s4o.print("_task_stats__[];\n");
+      }
     }
   }
+  if (wanted_declaretype == initdeclare_dt && global_snapshots__) {
+    s4o.print(s4o.indent_spaces + "__snapshot_resource__ = ");
+    s4o.print(resource_index++);
+    s4o.print(";\n");
+  }
   if (wanted_declaretype == initdeclare_dt || wanted_declaretype == rundeclare_dt) {
     s4o.print(s4o.indent_spaces);
     symbol->resource_name->accept(*this);
@@ -1612,6 +2773,21 @@ void *visit(resource_declaration_c *symbol) {
       s4o.print("(tick);\n");
     }
   }
+  if (wanted_declaretype == runtable_dt) {
+    s4o.print(s4o.indent_spaces);
+    symbol->resource_name->accept(*this);
+    s4o.print(FB_RUN_SUFFIX ",\n");
+  }
+  if (wanted_declaretype == contexttable_dt) {
+    s4o.print(s4o.indent_spaces + "&");
+    symbol->resource_name->accept(*this);
+    s4o.print("_context__,\n");
+  }
+  if (wanted_declaretype == taskstatstable_dt) {
+    s4o.print(s4o.indent_spaces);
+    symbol->resource_name->accept(*this);
+    s4o.print("_task_stats__,\n");
+  }
   return NULL;
 }
 
@@ -1625,8 +2801,14 @@ void *visit(single_resource_declaration_c *symbol) {
     else {
       s4o.print(FB_RUN_SUFFIX);
       s4o.print("(unsigned long tick);\n");
+      if (resource_context__)
+        s4o.print(s4o.indent_spaces + "extern __resource_context_t RESOURCE_context__;\n");
+      if (task_stats__)
+        s4o.print(s4o.indent_spaces + "extern __task_stats_t RESOURCE_task_stats__[];\n");
     }
   }
+  if (wanted_declaretype == initdeclare_dt && global_snapshots__)
+    s4o.print(s4o.indent_spaces + "__snapshot_resource__ = 0;\n");
   if (wanted_declaretype == initdeclare_dt || wanted_declaretype == rundeclare_dt) {
     s4o.print(s4o.indent_spaces + "RESOURCE");
     if (wanted_declaretype == initdeclare_dt) {
@@ -1638,6 +2820,15 @@ void *visit(single_resource_declaration_c *symbol) {
       s4o.print("(tick);\n");
     }
   }
+  if (wanted_declaretype == runtable_dt) {
+    s4o.print(s4o.indent_spaces + "RESOURCE" FB_RUN_SUFFIX ",\n");
+  }
+  if (wanted_declaretype == contexttable_dt) {
+    s4o.print(s4o.indent_spaces + "&RESOURCE_context__,\n");
+  }
+  if (wanted_declaretype == taskstatstable_dt) {
+    s4o.print(s4o.indent_spaces + "RESOURCE_task_stats__,\n");
+  }
   return NULL;
 }
 
@@ -1677,6 +2868,8 @@ class generate_c_resources_c: public generate_c_base_and_typeid_c {
       current_resource_name = NULL;
       current_task_name = NULL;
       current_global_vars = NULL;
+      current_program_configurations = NULL;
+      current_task_configurations = NULL;
       configuration_name = false;
     };
 
@@ -1685,15 +2878,32 @@ class generate_c_resources_c: public generate_c_base_and_typeid_c {
       delete search_resource_instance;
     }
 
+    /* The end of the code of the resource, after its backup functions (amalgamate__) */
+    void print_undefines(symbol_c *resource_body) {
+      single_resource_declaration_c *single_resource = dynamic_cast<single_resource_declaration_c *>(resource_body);
+      if (NULL == single_resource) ERROR;
+      wanted_declaretype = undefine_dt;
+      single_resource->program_configuration_list->accept(*this);
+    }
+
     typedef enum {
       declare_dt,
       init_dt,
-      run_dt
+      run_dt,
+      taskrun_dt,   /* the run function of each task */
+      tasktable_dt, /* the table of the tasks of the resource */
+      taskstats_dt, /* the table of the statistics of the tasks of the resource (task_stats__) */
+      undefine_dt   /* the end of the resource code (amalgamate__) */
     } declaretype_t;
 
     declaretype_t wanted_declaretype;
 
     unsigned long long common_ticktime;
+
+    /* The programs of the resource currently being generated (used by taskrun_dt) */
+    symbol_c *current_program_configurations;
+    /* The tasks of the resource currently being generated (used by task_stats__) */
+    list_c *current_task_configurations;
     
     const char *current_program_name;
 
@@ -1807,13 +3017,7 @@ END_RESOURCE
       s4o.print("/* Editing this file is not recommended... */\n");
       s4o.print("/*******************************************/\n\n");
   
-      if (runtime_options.disable_implicit_en_eno) {
-        // If we are not generating the EN and ENO parameters for functions and FB,
-        //   then make sure we use the standard library version compiled without these parameters too!
-        s4o.print("#ifndef DISABLE_EN_ENO_PARAMETERS\n");
-        s4o.print("#define DISABLE_EN_ENO_PARAMETERS\n");
-        s4o.print("#endif\n");
-      }
+      print_library_defines(s4o);
       
       s4o.print("#include \"iec_std_lib.h\"\n\n");
       
@@ -1824,6 +3028,16 @@ END_RESOURCE
       s4o.print("\n\n");
       
       s4o.print("extern unsigned long long common_ticktime__;\n\n");
+      if (resource_context__) {
+        s4o.print("__resource_context_t ");
+        current_resource_name->accept(*this);
+        s4o.print("_context__; /*see iec_resource_context.h*/\n\n");
+      }
+      if (parallel_networks__) {
+        s4o.print("__parallel_pool_t ");
+        current_resource_name->accept(*this);
+        s4o.print("_parallel_pool__; /*see iec_parallel.h*/\n\n");
+      }
 
       s4o.print("#include \"accessor.h\"\n");
       s4o.print("#include \"POUS.h\"\n\n");
@@ -1832,8 +3046,11 @@ END_RESOURCE
       current_configuration->accept(*this);
       configuration_name = false;
       s4o.print(".h\"\n");
+      if (event_tasks__)
+        s4o.print("#include \"iec_event_tasks.h\"\n");
 
       /* (A.2) Global variables... */
+      if (task_data__) print_task_data_alignment(s4o, current_resource_name);
       if (current_global_vars != NULL) {
         vardecl = new generate_c_vardecl_c(&s4o,
                                            generate_c_vardecl_c::local_vf,
@@ -1857,6 +3074,21 @@ END_RESOURCE
       
       s4o.print("\n");
       
+      /* (A.6) Task statistics (see iec_task_stats.h)... */
+      current_task_configurations = dynamic_cast<list_c *>(symbol->task_configuration_list);
+      if (NULL == current_task_configurations) ERROR;
+      if (task_stats__) {
+        s4o.print("__task_stats_t ");
+        current_resource_name->accept(*this);
+        s4o.print("_task_stats__[] = {\n");
+        s4o.indent_right();
+        wanted_declaretype = taskstats_dt;
+        symbol->task_configuration_list->accept(*this);
+        s4o.print(s4o.indent_spaces + "{NULL}\n");
+        s4o.indent_left();
+        s4o.print("};\n\n");
+      }
+      
       /* (B) resource initialisation function... */
       /* (B.1) initialisation function name... */
       s4o.print("void ");
@@ -1868,6 +3100,12 @@ END_RESOURCE
       s4o.print("BOOL retain;\n");
       s4o.print(s4o.indent_spaces);
       s4o.print("retain = 0;\n");
+      print_enter_context();
+      if (parallel_networks__) {
+        s4o.print(s4o.indent_spaces + "__parallel_pool_start(&");
+        current_resource_name->accept(*this);
+        s4o.print("_parallel_pool__);\n");
+      }
       
       /* (B.2) Global variables initialisations... */
       if (current_global_vars != NULL) {
@@ -1899,6 +3137,18 @@ END_RESOURCE
       s4o.print(FB_RUN_SUFFIX);
       s4o.print("(unsigned long tick) {\n");
       s4o.indent_right();
+      print_enter_context();
+
+      if (tick_timers__) {
+        /* Keep the 64 bit count of ticks used by the timers (see USE_TICK_TIMERS in iec_std_lib.h).
+         * NOTE: tick may be only 32 bits wide, and the runtime may skip the ticks on which no task is due.
+         */
+        s4o.print(s4o.indent_spaces + "__CURRENT_TICK += (unsigned long)(tick - (unsigned long)__CURRENT_TICK);\n");
+        if (timer_wheel__)
+          /* update the outputs of the timers that expired, before the tasks read them */
+          s4o.print(s4o.indent_spaces + "__timer_wheel_advance(__CURRENT_TICK);\n");
+        s4o.print("\n");
+      }
       
       wanted_declaretype = run_dt;
       
@@ -1908,9 +3158,49 @@ END_RESOURCE
       /* (C.3) Program run declaration... */
       symbol->program_configuration_list->accept(*this);
       
+      /* (C.4) End of the tasks that ran... */
+      if (task_stats__) {
+        for (int i = 0; i < current_task_configurations->n; i++) {
+          task_configuration_c *task = dynamic_cast<task_configuration_c *>(current_task_configurations->get_element(i));
+          if (NULL == task) ERROR;
+          s4o.print(s4o.indent_spaces + "if (");
+          task->task_name->accept(*this);
+          s4o.print(") __task_stats_end(&");
+          print_task_stats(task->task_name);
+          s4o.print(");\n");
+        }
+      }
+      
       s4o.indent_left();
       s4o.print("}\n\n");
       
+      /* (D) The tasks of the resource... */
+      /* A preemptive runtime may run each task on its own thread, at the task's priority (e.g. with POSIX SCHED_FIFO),
+       * instead of calling the resource run function on every tick. Note that the programs that are not associated
+       * to any task are only run by the resource run function.
+       */
+      /* (D.1) Task run functions... */
+      wanted_declaretype = taskrun_dt;
+      current_program_configurations = symbol->program_configuration_list;
+      symbol->task_configuration_list->accept(*this);
+      current_program_configurations = NULL;
+      
+      /* (D.2) Events of the SINGLE tasks (see iec_event_tasks.h)... */
+      if (event_tasks__)
+        print_run_events_function();
+      
+      /* (D.3) Task table... */
+      s4o.print("__IEC_TASK_t ");
+      current_resource_name->accept(*this);
+      s4o.print("_tasks__[] = {\n");
+      s4o.indent_right();
+      wanted_declaretype = tasktable_dt;
+      symbol->task_configuration_list->accept(*this);
+      s4o.print(s4o.indent_spaces + "{NULL, 0, 0, NULL}\n");
+      s4o.indent_left();
+      s4o.print("};\n\n");
+      
+      current_task_configurations = NULL;
       if (single_resource) {
         delete current_resource_name;
         current_resource_name = NULL;
@@ -1924,12 +3214,31 @@ END_RESOURCE
       switch (wanted_declaretype) {
         case declare_dt:
           s4o.print(s4o.indent_spaces);
+          if (retain_segment__) s4o.print("__RETAIN_SEGMENT ");
+          if (task_data__) s4o.print(get_task_data_placement(current_resource_name, symbol->program_name) + " ");
           symbol->program_type_name->accept(*this);
           s4o.print(" ");
           current_resource_name->accept(*this);
           s4o.print("__");
           symbol->program_name->accept(*this);
-          s4o.print(";\n#define ");
+          s4o.print(";\n");
+          if (retain_segment__) {
+            s4o.print("__RETAIN_LAYOUT(");
+            current_resource_name->accept(*this);
+            s4o.print("__");
+            symbol->program_name->accept(*this);
+            s4o.print(")\n");
+          }
+          if (layout_descriptors__) {
+            s4o.print("__LAYOUT_INSTANCE(");
+            symbol->program_type_name->accept(*this);
+            s4o.print(", ");
+            current_resource_name->accept(*this);
+            s4o.print("__");
+            symbol->program_name->accept(*this);
+            s4o.print(")\n");
+          }
+          s4o.print("#define ");
           symbol->program_name->accept(*this);
           s4o.print(" ");
           current_resource_name->accept(*this);
@@ -1961,37 +3270,216 @@ END_RESOURCE
             s4o.indent_right(); 
           }
         
-          wanted_assigntype = assign_at;
-          if (symbol->prog_conf_elements != NULL)
-            symbol->prog_conf_elements->accept(*this);
-          
-          s4o.print(s4o.indent_spaces);
-          symbol->program_type_name->accept(*this);
-          s4o.print(FB_FUNCTION_SUFFIX);
-          s4o.print("(&");
-          symbol->program_name->accept(*this);
-          s4o.print(");\n");
-          
-          wanted_assigntype = send_at;
-          if (symbol->prog_conf_elements != NULL)
-            symbol->prog_conf_elements->accept(*this);
+          if (task_stats__ && (symbol->task_name != NULL)) {
+            s4o.print(s4o.indent_spaces + "__TASK_STATS_PROGRAM_BEGIN(");
+            print_task_stats(symbol->task_name);
+            s4o.print(")\n");
+          }
+          print_program_call(symbol);
+          if (task_stats__ && (symbol->task_name != NULL)) {
+            s4o.print(s4o.indent_spaces + "__TASK_STATS_PROGRAM_END(");
+            print_task_stats(symbol->task_name);
+            s4o.print(")\n");
+          }
           
           if (symbol->task_name != NULL) {
             s4o.indent_left();
             s4o.print(s4o.indent_spaces + "}\n");
           }
           break;
+        case taskrun_dt:
+          /* only the programs associated to the task whose run function is being generated */
+          if ((symbol->task_name == NULL) || (compare_identifiers(symbol->task_name, current_task_name) != 0))
+            break;
+          { identifier_c *tmp_id = dynamic_cast<identifier_c*>(symbol->program_name);
+            if (NULL == tmp_id) ERROR;
+            current_program_name = tmp_id->value;
+          }
+          print_program_call(symbol);
+          break;
+        case undefine_dt:
+          /* the following resources, in the same AMALGAMATION.c, may have programs with the same names */
+          s4o.print("#undef ");
+          symbol->program_name->accept(*this);
+          s4o.print("\n");
+          break;
         default:
           break;
       }
       return NULL;
     }
     
+    /* Run the program, copying the values of its inputs before, and of its outputs after the call */
+    void print_program_call(program_configuration_c *symbol) {
+      wanted_assigntype = assign_at;
+      if (symbol->prog_conf_elements != NULL)
+        symbol->prog_conf_elements->accept(*this);
+      
+      s4o.print(s4o.indent_spaces);
+      symbol->program_type_name->accept(*this);
+      s4o.print(FB_FUNCTION_SUFFIX);
+      s4o.print("(&");
+      symbol->program_name->accept(*this);
+      s4o.print(");\n");
+      
+      wanted_assigntype = send_at;
+      if (symbol->prog_conf_elements != NULL)
+        symbol->prog_conf_elements->accept(*this);
+    }
+
+    /* The statistics of a task of the current resource, in the table of the resource (task_stats__) */
+    void print_task_stats(symbol_c *task_name) {
+      int i;
+      for (i = 0; i < current_task_configurations->n; i++) {
+        task_configuration_c *task = dynamic_cast<task_configuration_c *>(current_task_configurations->get_element(i));
+        if ((NULL != task) && (compare_identifiers(task->task_name, task_name) == 0)) break;
+      }
+      if (i >= current_task_configurations->n) ERROR;
+      current_resource_name->accept(*this);
+      s4o.print("_task_stats__[");
+      s4o.print(i);
+      s4o.print("]");
+    }
+
+    void print_task_run_function_name(void) {
+      current_resource_name->accept(*this);
+      s4o.print("__");
+      current_task_name->accept(*this);
+      s4o.print(FB_RUN_SUFFIX);
+    }
+
+    void print_task_trigger_function_name(void) {
+      current_resource_name->accept(*this);
+      s4o.print("__");
+      current_task_name->accept(*this);
+      s4o.print("_trigger__");
+    }
+
+    static bool is_single_task(task_configuration_c *task) {
+      task_initialization_c *task_initialization = dynamic_cast<task_initialization_c *>(task->task_initialization);
+      if (NULL == task_initialization) ERROR;
+      return (NULL != task_initialization->single_data_source);
+    }
+
+    static long long task_priority(task_configuration_c *task) {
+      task_initialization_c *task_initialization = dynamic_cast<task_initialization_c *>(task->task_initialization);
+      if (NULL == task_initialization) ERROR;
+      symbol_c *priority = task_initialization->priority_data_source;
+      if ((NULL != priority) && VALID_CVALUE(uint64, priority)) return GET_CVALUE(uint64, priority);
+      if ((NULL != priority) && VALID_CVALUE( int64, priority)) return GET_CVALUE( int64, priority);
+      return 0;
+    }
+
+    /* The entry points of the resource make its context (see iec_resource_context.h), and its worker pool, the current ones of the calling thread */
+    void print_enter_context(void) {
+      if (parallel_networks__) {
+        /* the PROGRAMs run their networks on the workers of the resource (see iec_parallel.h) */
+        s4o.print(s4o.indent_spaces + "__current_parallel_pool = &");
+        current_resource_name->accept(*this);
+        s4o.print("_parallel_pool__;\n");
+      }
+      if (!resource_context__) return;
+      s4o.print(s4o.indent_spaces + "__current_resource_context = &");
+      current_resource_name->accept(*this);
+      s4o.print("_context__;\n");
+    }
+
+    /* <resource>_run_events__(): runs the SINGLE tasks once for each of their pending events, the highest priority
+     * (i.e. the lowest PRIORITY) first, and returns the number of tasks run.
+     */
+    void print_run_events_function(void) {
+      std::multimap<long long, task_configuration_c *> single_tasks;
+      for (int i = 0; i < current_task_configurations->n; i++) {
+        task_configuration_c *task = dynamic_cast<task_configuration_c *>(current_task_configurations->get_element(i));
+        if (NULL == task) ERROR;
+        if (is_single_task(task)) single_tasks.insert(std::make_pair(task_priority(task), task));
+      }
+
+      s4o.print("int ");
+      current_resource_name->accept(*this);
+      s4o.print("_run_events__(void) {\n");
+      s4o.indent_right();
+      s4o.print(s4o.indent_spaces + "int count = 0;\n");
+      s4o.print(s4o.indent_spaces + "for (;;) {\n");
+      s4o.indent_right();
+      std::multimap<long long, task_configuration_c *>::iterator task;
+      for (task = single_tasks.begin(); task != single_tasks.end(); task++) {
+        current_task_name = task->second->task_name;
+        s4o.print(s4o.indent_spaces + "if (__event_task_take(&");
+        current_task_name->accept(*this);
+        s4o.print("_events__)) {");
+        print_task_run_function_name();
+        s4o.print("(); count++; continue;}\n");
+      }
+      current_task_name = NULL;
+      s4o.print(s4o.indent_spaces + "return count;\n");
+      s4o.indent_left();
+      s4o.print(s4o.indent_spaces + "}\n");
+      s4o.indent_left();
+      s4o.print("}\n\n");
+    }
+
 /*  TASK task_name task_initialization */
 //SYM_REF2(task_configuration_c, task_name, task_initialization)
     void *visit(task_configuration_c *symbol) {
       current_task_name = symbol->task_name;
       switch (wanted_declaretype) {
+        case taskrun_dt:
+          s4o.print("void ");
+          print_task_run_function_name();
+          s4o.print("(void) {\n");
+          s4o.indent_right();
+          print_enter_context();
+          if (task_stats__) {
+            s4o.print(s4o.indent_spaces + "__task_stats_begin_task(&");
+            print_task_stats(current_task_name);
+            s4o.print(");\n");
+            s4o.print(s4o.indent_spaces + "__TASK_STATS_PROGRAM_BEGIN(");
+            print_task_stats(current_task_name);
+            s4o.print(")\n");
+          }
+          current_program_configurations->accept(*this);
+          if (task_stats__) {
+            s4o.print(s4o.indent_spaces + "__TASK_STATS_PROGRAM_END(");
+            print_task_stats(current_task_name);
+            s4o.print(")\n");
+            s4o.print(s4o.indent_spaces + "__task_stats_end(&");
+            print_task_stats(current_task_name);
+            s4o.print(");\n");
+          }
+          s4o.indent_left();
+          s4o.print("}\n\n");
+          if (event_tasks__ && is_single_task(symbol)) {
+            s4o.print("void ");
+            print_task_trigger_function_name();
+            s4o.print("(void) {__event_task_post(&");
+            current_task_name->accept(*this);
+            s4o.print("_events__);}\n\n");
+          }
+          break;
+        case taskstats_dt:
+          s4o.print(s4o.indent_spaces + "{\"");
+          current_task_name->accept(*this);
+          s4o.print("\", ");
+          symbol->task_initialization->accept(*this);
+          s4o.print(", ");
+          s4o.print_long_long_integer(common_ticktime * (1000000 / MILLISECOND));
+          s4o.print("},\n");
+          break;
+        case tasktable_dt:
+          s4o.print(s4o.indent_spaces + "{\"");
+          current_task_name->accept(*this);
+          s4o.print("\", ");
+          symbol->task_initialization->accept(*this);
+          s4o.print(", ");
+          print_task_run_function_name();
+          if (event_tasks__) {
+            s4o.print(", ");
+            if (is_single_task(symbol)) print_task_trigger_function_name();
+            else                        s4o.print("NULL");
+          }
+          s4o.print("},\n");
+          break;
         case declare_dt:
           s4o.print(s4o.indent_spaces + "BOOL ");
           current_task_name->accept(*this);
@@ -2006,6 +3494,14 @@ END_RESOURCE
           break;
         case run_dt:
           symbol->task_initialization->accept(*this);
+          if (task_stats__) {
+            /* with tick_timers__, the 64 bit count of ticks does not wrap around */
+            s4o.print(s4o.indent_spaces + "if (");
+            current_task_name->accept(*this);
+            s4o.print(") __task_stats_begin(&");
+            print_task_stats(current_task_name);
+            s4o.print(tick_timers__? ", __CURRENT_TICK);\n" : ", tick);\n");
+          }
           break;
         default:
           break;
@@ -2018,11 +3514,37 @@ END_RESOURCE
 //SYM_REF4(task_initialization_c, single_data_source, interval_data_source, priority_data_source, unused)
     void *visit(task_initialization_c *symbol) {
       switch (wanted_declaretype) {
+        case tasktable_dt:
+          /* priority, period (in ns, 0 for tasks that are not periodic) */
+          if      ((NULL != symbol->priority_data_source) && VALID_CVALUE(uint64, symbol->priority_data_source))
+            s4o.print_long_long_integer(GET_CVALUE(uint64, symbol->priority_data_source), false);
+          else if ((NULL != symbol->priority_data_source) && VALID_CVALUE( int64, symbol->priority_data_source))
+            s4o.print(GET_CVALUE(int64, symbol->priority_data_source));
+          else
+            s4o.print("0");
+          s4o.print(", ");
+          if ((symbol->single_data_source == NULL) && (symbol->interval_data_source != NULL)) {
+            s4o.print_long_long_integer(calculate_time(symbol->interval_data_source) * (1000000 / MILLISECOND));
+          } else
+            s4o.print("0");
+          break;
+        case taskstats_dt:
+          /* period (in ns, 0 for tasks that are not periodic) */
+          if ((symbol->single_data_source == NULL) && (symbol->interval_data_source != NULL))
+            s4o.print_long_long_integer(calculate_time(symbol->interval_data_source) * (1000000 / MILLISECOND));
+          else
+            s4o.print("0");
+          break;
         case declare_dt:
           if (symbol->single_data_source != NULL) {
             s4o.print(s4o.indent_spaces + "R_TRIG ");
             current_task_name->accept(*this);
             s4o.print("_R_TRIG;\n");
+            if (event_tasks__) {
+              s4o.print(s4o.indent_spaces + "__event_task_t ");
+              current_task_name->accept(*this);
+              s4o.print("_events__;\n");
+            }
           }
           break;
         case init_dt:
@@ -2032,6 +3554,11 @@ END_RESOURCE
             s4o.print("(&");
             current_task_name->accept(*this);
             s4o.print("_R_TRIG, retain);\n");
+            if (event_tasks__) {
+              s4o.print(s4o.indent_spaces);
+              current_task_name->accept(*this);
+              s4o.print("_events__ = 0;\n");
+            }
           }
           break;
         case run_dt:
@@ -2073,6 +3600,12 @@ END_RESOURCE
             s4o.print("(");
             current_task_name->accept(*this);
             s4o.print("_R_TRIG.Q)");
+            if (event_tasks__) {
+              /* the events not yet run by <resource>_run_events__() */
+              s4o.print(" | __event_task_take_all(&");
+              current_task_name->accept(*this);
+              s4o.print("_events__)");
+            }
           }
           else {
             s4o.print(s4o.indent_spaces);
@@ -2413,6 +3946,47 @@ class generate_c_backup_config_c: public generate_c_base_and_typeid_c {
     virtual ~generate_c_backup_config_c(void) {}
 
     
+  private:
+    /* With USE_RETAIN_SEGMENT (-O n), all the state is in the retain segment (see iec_retain.h),
+     * so it is saved (and restored) in one go, after a header with the version of its layout.
+     * A segment saved with another layout is not restored (the variables keep their initial values).
+     * The runtime must then restore the variables one by one, using __retain_restore_var().
+     */
+    void print_segment_functions(void) {
+      s4o.print("\n");
+      s4o.print("void config" BACKUP_ "(void **buffer, int *maxsize) {\n");
+      s4o.print("  __retain_header_t header;\n");
+      s4o.print("  header.version = __retain_layout_version();\n");
+      s4o.print("  header.size    = __retain_segment_size();\n");
+      s4o.print("  " BACKUP_ "(&header, sizeof(header), buffer, maxsize);\n");
+      s4o.print("  " BACKUP_ "(__retain_segment(), header.size, buffer, maxsize);\n");
+      if (retain_dirty__)
+        s4o.print("  if (*maxsize >= 0) memset(&__retain_dirty, 0, sizeof(__retain_dirty));\n");
+      s4o.print("}\n");
+      s4o.print("\n");
+      s4o.print("void config" RESTORE_ "(void **buffer, int *maxsize) {\n");
+      s4o.print("  __retain_header_t header;\n");
+      s4o.print("  " RESTORE_ "(&header, sizeof(header), buffer, maxsize);\n");
+      s4o.print("  if (*maxsize < 0) return;\n");
+      s4o.print("  if ((header.version != __retain_layout_version()) || (header.size != __retain_segment_size())) return;\n");
+      s4o.print("  " RESTORE_ "(__retain_segment(), header.size, buffer, maxsize);\n");
+      if (retain_dirty__)
+        s4o.print("  if (*maxsize >= 0) memset(&__retain_dirty, 0, sizeof(__retain_dirty));\n");
+      s4o.print("}\n");
+      if (!retain_dirty__) return;
+
+      /* With USE_RETAIN_DIRTY (-O z), the runtime calls config_backup_dirty__() to save the pages
+       * written since the last call. Their offsets are within the segment, i.e. after the header
+       * saved by config_backup__().
+       */
+      s4o.print("\n");
+      s4o.print("__retain_dirty_t __retain_dirty = {1}; /*all the pages are dirty before the first backup, see iec_retain.h*/\n");
+      s4o.print("\n");
+      s4o.print("void config_backup_dirty__(void (*write)(unsigned long offset, const void *data, unsigned long size)) {\n");
+      s4o.print("  __retain_flush_dirty(write);\n");
+      s4o.print("}\n");
+    }
+
   public:
     /********************/
     /* 2.1.6 - Pragmas  */
@@ -2445,6 +4019,10 @@ class generate_c_backup_config_c: public generate_c_base_and_typeid_c {
       s4o.print("  *maxsize -= varsize;\n");
       s4o.print("}\n");
       
+      if (retain_segment__) {
+        print_segment_functions();
+        return NULL;
+      }
       
       generate_c_vardecl_c vardecl = generate_c_vardecl_c(&s4o,
                                          generate_c_vardecl_c::local_vf,
@@ -2531,6 +4109,15 @@ class generate_c_c: public iterator_visitor_c {
     
     unsigned long long common_ticktime;
 
+    pou_fingerprints_c pou_fingerprints;  /* only used with generate_pou_filepairs__ */
+    generate_c_memory_c memory_report;    /* only used with memory_report__ */
+    generate_c_wcet_c   wcet_estimate;    /* only used with wcet_estimate__ */
+    std::vector<std::string> pou_units;   /* the <pou_name>.c files, only used with generate_pou_units__ */
+    std::vector<std::pair<symbol_c *, const char *> > deferred_pous; /* POUs left for the worker processes (generate_pou_jobs__ > 1) */
+    std::set<symbol_c *> declared_functions;  /* the FUNCTIONs already visited (including the standard functions) */
+    std::string config_unit;                  /* the <config_name>.c file */
+    std::vector<std::string> resource_units;  /* the <resource_name>.c files of the configuration */
+
   public:
     generate_c_c(stage4out_c *s4o_ptr, const char *builddir): 
             s4o(*s4o_ptr),
@@ -2539,15 +4126,138 @@ class generate_c_c: public iterator_visitor_c {
             located_variables_s4o(builddir, "LOCATED_VARIABLES","h"),
             variables_s4o(builddir, "VARIABLES","csv"),
             generate_c_typedecl         (&pous_incl_s4o),
-            generate_c_implicit_typedecl(&pous_incl_s4o, &generate_c_typedecl)
+            generate_c_implicit_typedecl(&pous_incl_s4o, &generate_c_typedecl),
+            pou_fingerprints(builddir)
     {
       current_builddir = builddir;
       current_configuration = NULL;
       allow_output = true;
+      std_lib_usage.set_builddir(builddir);
+      generated_depends.set_builddir(builddir);
+      std_lib_usage.add_file("POUS.c");
     }
             
     ~generate_c_c(void) {}
 
+  private:
+    /* The start of a <pou_name>.c file that is compiled on its own (generate_pou_units__) */
+    void print_unit_header(stage4out_c &s4o_c) {
+      print_library_defines(s4o_c);
+      /* POUS.h includes iec_std_lib.h, accessor.h, and the <pou_name>.h of every POU */
+      s4o_c.print("#include \"POUS.h\"\n");
+    }
+
+    /* Print the code of any POU, to either the <pou_name>.h or the <pou_name>.c file */
+    static void print_pou(symbol_c *symbol, stage4out_c &s4o, bool print_declaration) {
+      function_declaration_c       *function       = dynamic_cast<function_declaration_c       *>(symbol);
+      function_block_declaration_c *function_block = dynamic_cast<function_block_declaration_c *>(symbol);
+      program_declaration_c        *program        = dynamic_cast<program_declaration_c        *>(symbol);
+      if      (NULL != function)       generate_c_pous_c::handle_function      (function,       s4o, print_declaration);
+      else if (NULL != function_block) generate_c_pous_c::handle_function_block(function_block, s4o, print_declaration);
+      else if (NULL != program)        generate_c_pous_c::handle_program       (program,        s4o, print_declaration);
+      else ERROR;
+    }
+
+    /* Whether the FUNCTION is small enough to be static inline in its <pou_name>.h (inline_function_size__).
+     * Since POUS.h includes the <pou_name>.h files in the order in which the POUs are declared,
+     * it may only call the FUNCTIONs declared before it.
+     */
+    bool is_small_function(function_declaration_c *symbol) {
+      if (!generate_pou_units__ || (0 == inline_function_size__)) return false;
+      if (count_statements_c::get(symbol->function_body) > inline_function_size__) return false;
+      function_call_iterator_c fc_iterator(symbol->function_body);
+      for (symbol_c *fcall; (fcall = fc_iterator.next()) != NULL; ) {
+        symbol_c *f_decl = NULL;
+        function_invocation_c  *st_fcall  = dynamic_cast<function_invocation_c  *>(fcall);
+        il_function_call_c     *il_fcall  = dynamic_cast<il_function_call_c     *>(fcall);
+        il_formal_funct_call_c *il_ffcall = dynamic_cast<il_formal_funct_call_c *>(fcall);
+        if (NULL != st_fcall ) f_decl = st_fcall ->called_function_declaration;
+        if (NULL != il_fcall ) f_decl = il_fcall ->called_function_declaration;
+        if (NULL != il_ffcall) f_decl = il_ffcall->called_function_declaration;
+        if ((NULL == f_decl) || (0 == declared_functions.count(f_decl))) return false;
+      }
+      return true;
+    }
+
+    /* Generate the AMALGAMATION.c file (amalgamate__), a single translation unit with the whole program.
+     * Each <resource_name>.c includes POUS.c, which is only expanded in the first one.
+     */
+    void generate_amalgamation(void) {
+      stage4out_c amalgamation_s4o(current_builddir, "AMALGAMATION", "c");
+      amalgamation_s4o.print("/*******************************************/\n");
+      amalgamation_s4o.print("/*     FILE GENERATED BY iec2c             */\n");
+      amalgamation_s4o.print("/* Editing this file is not recommended... */\n");
+      amalgamation_s4o.print("/*******************************************/\n\n");
+      amalgamation_s4o.print("/* The whole program, to be compiled (instead of the files it includes) as a single translation unit */\n\n");
+      amalgamation_s4o.print("#include \"");
+      amalgamation_s4o.print(config_unit);
+      amalgamation_s4o.print("\"\n");
+      for (unsigned int i = 0; i < resource_units.size(); i++) {
+        amalgamation_s4o.print("#include \"");
+        amalgamation_s4o.print(resource_units[i]);
+        amalgamation_s4o.print("\"\n");
+      }
+    }
+
+    /* Generate the <pou_name>.c and <pou_name>.h files (generate_pou_filepairs__) */
+    void generate_pou_filepair(symbol_c *symbol, const char *pou_name) {
+      stage4out_c s4o_c(current_builddir, pou_name, "c");
+      stage4out_c s4o_h(current_builddir, pou_name, "h");
+      if (generate_pou_units__) print_unit_header(s4o_c);
+      else {s4o_c.print("#include \""); s4o_c.print(pou_name); s4o_c.print(".h\"\n");}
+      s4o_h.print("#ifndef __");  s4o_h.print(pou_name); s4o_h.print("_H\n");
+      s4o_h.print("#define __");  s4o_h.print(pou_name); s4o_h.print("_H\n");
+      generate_c_implicit_typedecl_c generate_c_implicit_typedecl__(&s4o_h);
+      symbol->accept(generate_c_implicit_typedecl__); /* generate implicitly delcared datatypes (arrays and ref_to) */
+      print_pou(symbol, s4o_h, true);  /* generate the <pou_name>.h file */
+      print_pou(symbol, s4o_c, false); /* generate the <pou_name>.c file */
+      s4o_h.print("#endif /* __");  s4o_h.print(pou_name); s4o_h.print("_H */\n");
+    }
+
+    /* Generate the files of the deferred POUs, split among generate_pou_jobs__ worker processes.
+     * Each worker only writes its own <pou_name>.c/.h files, so the result does not depend on the
+     * order in which the workers run. The parent waits for all of them, and stops if any one fails.
+     */
+    void generate_deferred_pous(void) {
+      if (deferred_pous.empty()) return;
+#ifdef PARALLEL_STAGE4
+      int jobs = std::min((int)deferred_pous.size(), generate_pou_jobs__);
+      /* do not let both processes write what is still buffered (stdout, and the files already open) */
+      fflush(NULL);
+      std::cout.flush();
+
+      int running = 0;
+      for (int job = 0; job < jobs; job++) {
+        pid_t pid = fork();
+        if (pid > 0) {running++; continue;}
+        if (pid == 0) {
+          std::cout.setstate(std::ios::failbit); /* the parent has already listed the generated files */
+          for (unsigned int i = job; i < deferred_pous.size(); i += jobs)
+            generate_pou_filepair(deferred_pous[i].first, deferred_pous[i].second);
+          fflush(stderr);
+          /* NOTE: _exit() and not exit(), so the child does not write out the buffers it shares with the parent (POUS.c, ...) */
+          _exit(0);
+        }
+        /* could not start the new process, so generate its share of the POUs right here */
+        for (unsigned int i = job; i < deferred_pous.size(); i += jobs)
+          generate_pou_filepair(deferred_pous[i].first, deferred_pous[i].second);
+      }
+
+      bool failed = false;
+      for (; running > 0; running--) {
+        int status;
+        if ((wait(&status) < 0) || !WIFEXITED(status) || (0 != WEXITSTATUS(status))) failed = true;
+      }
+      if (failed) exit(EXIT_FAILURE); /* the worker has already printed the error message */
+#else
+      for (unsigned int i = 0; i < deferred_pous.size(); i++)
+        generate_pou_filepair(deferred_pous[i].first, deferred_pous[i].second);
+#endif
+      deferred_pous.clear();
+    }
+
+  public:
+
 
 
 /********************/
@@ -2580,21 +4290,47 @@ class generate_c_c: public iterator_visitor_c {
     void *visit(library_c *symbol) {
       pous_incl_s4o.print("#ifndef __POUS_H\n#define __POUS_H\n\n");
       
-      if (runtime_options.disable_implicit_en_eno) {
-        // If we are not generating the EN and ENO parameters for functions and FB,
-        //   then make sure we use the standard library version compiled without these parameters too!
-        pous_incl_s4o.print("#ifndef DISABLE_EN_ENO_PARAMETERS\n");
-        pous_incl_s4o.print("#define DISABLE_EN_ENO_PARAMETERS\n");
-        pous_incl_s4o.print("#endif\n");
-      }
+      print_library_defines(pous_incl_s4o);
       
       pous_incl_s4o.print("#include \"accessor.h\"\n#include \"iec_std_lib.h\"\n\n");
 
+      if (direct_globals__) find_direct_globals_c::find(symbol);
+
+      /* each <resource_name>.c includes POUS.c, but AMALGAMATION.c must only contain it once */
+      if (amalgamate__) pous_s4o.print("#ifndef __POUS_C\n#define __POUS_C\n\n");
+
+      if (generate_pou_filepairs__) pou_fingerprints.load(symbol);
       for(int i = 0; i < symbol->n; i++) {
+        generated_depends.add_source(symbol->get_element(i));
         symbol->get_element(i)->accept(*this);
       }
+      generate_deferred_pous();
+      if (generate_pou_filepairs__) pou_fingerprints.save();
+      if (generate_pou_units__) {
+        /* POUS.c is included in the code of each resource, so it must not contain any of the POUs. */
+        pous_s4o.print("/* Each POU is compiled as a separate translation unit (listed in POUS.mk) */\n");
+        stage4out_c pous_mk_s4o(current_builddir, "POUS", "mk");
+        pous_mk_s4o.print("# FILE GENERATED BY iec2c\n");
+        pous_mk_s4o.print("# The C files to compile (and link) along with the configuration and resources.\n");
+        pous_mk_s4o.print("POUS_SRCS =");
+        for (unsigned int i = 0; i < pou_units.size(); i++) {
+          pous_mk_s4o.print(" \\\n  ");
+          pous_mk_s4o.print(pou_units[i]);
+        }
+        pous_mk_s4o.print("\n");
+      }
+
+      /* the globals the POUs access directly (see find_direct_globals_c), after the declaration of their datatypes */
+      if (direct_globals__) {
+        std::map<std::string, direct_global_t>::iterator global;
+        for (global = direct_globals_map__.begin(); global != direct_globals_map__.end(); global++)
+          if (!global->second.c_name.empty())
+            pous_incl_s4o.print("extern " + global->second.c_type + " " + global->second.c_name + ";\n");
+        pous_incl_s4o.print("\n");
+      }
 
       pous_incl_s4o.print("#endif //__POUS_H\n");
+      if (amalgamate__) pous_s4o.print("\n#endif //__POUS_C\n");
       
       generate_var_list_c generate_var_list(&variables_s4o, symbol);
       generate_var_list.generate_programs(symbol);
@@ -2602,9 +4338,30 @@ class generate_c_c: public iterator_visitor_c {
       variables_s4o.print("\n// Ticktime\n");
       variables_s4o.print_long_long_integer(common_ticktime, false);
       variables_s4o.print("\n");
+      if (debug_table__) {
+        stage4out_c debug_table_s4o(current_builddir, "VARIABLES", "c");
+        generate_var_list.generate_debug_table(debug_table_s4o);
+      }
+      if (!shared_image_vars__.empty()) {
+        stage4out_c shared_image_s4o(current_builddir, "SHARED_IMAGE", "c");
+        generate_var_list.generate_shared_image(shared_image_s4o, shared_image_vars__);
+      }
 
       generate_location_list_c generate_location_list(&located_variables_s4o);
       symbol->accept(generate_location_list);
+      if (process_image__) {
+        stage4out_c process_image_h_s4o(current_builddir, "PROCESS_IMAGE", "h");
+        stage4out_c process_image_c_s4o(current_builddir, "PROCESS_IMAGE", "c");
+        generate_location_list.generate_process_images(process_image_h_s4o, process_image_c_s4o);
+      }
+      if (input_recorder__) {
+        stage4out_c recorder_s4o(current_builddir, "RECORDER", "c");
+        generate_location_list.generate_input_recorder(recorder_s4o);
+      }
+      if (memory_report__) {
+        stage4out_c memory_report_s4o(current_builddir, "MEMORY_REPORT", "c");
+        memory_report.generate(memory_report_s4o);
+      }
       return NULL;
     }
 
@@ -2645,23 +4402,24 @@ class generate_c_c: public iterator_visitor_c {
       if (!allow_output) return NULL;\
       if (generate_pou_filepairs__) {\
         const char *pou_name = get_datatype_info_c::get_id_str(pname);\
-        stage4out_c s4o_c(current_builddir, pou_name, "c");\
-        stage4out_c s4o_h(current_builddir, pou_name, "h");\
-        s4o_c.print("#include \""); s4o_c.print(pou_name); s4o_c.print(".h\"\n");\
-        s4o_h.print("#ifndef __");  s4o_h.print(pou_name); s4o_h.print("_H\n");\
-        s4o_h.print("#define __");  s4o_h.print(pou_name); s4o_h.print("_H\n");\
-        generate_c_implicit_typedecl_c generate_c_implicit_typedecl__(&s4o_h);\
-        symbol->accept(generate_c_implicit_typedecl__); /* generate implicitly delcared datatypes (arrays and ref_to) */\
-        generate_c_pous_c::fname(symbol, s4o_h, true); /* generate the <pou_name>.h file */\
-        generate_c_pous_c::fname(symbol, s4o_c, false);/* generate the <pou_name>.c file */\
-        s4o_h.print("#endif /* __");  s4o_h.print(pou_name); s4o_h.print("_H */\n");\
+        generated_depends.add_pou_files(pou_name, symbol);\
+        if (pou_fingerprints.unchanged(symbol, pou_name)) {\
+          /* keep the files generated in the previous run, but still list them like the others. */\
+          std::cout << pou_name << ".c\n" << pou_name << ".h\n";\
+        } else if ((generate_pou_jobs__ > 1) && !stage4out_c::archiving()) {\
+          /* generated later, by the worker processes. List the files now, so they keep their order. */\
+          /* NOTE: not when streaming the files (iec2c -A), each worker would write its own frames. */\
+          std::cout << pou_name << ".c\n" << pou_name << ".h\n";\
+          deferred_pous.push_back(std::make_pair((symbol_c *)symbol, pou_name));\
+        } else {\
+          generate_pou_filepair(symbol, pou_name);\
+        }\
         /* add #include directives to the POUS.h and POUS.c files... */\
         pous_incl_s4o.print("#include \"");\
-        pous_s4o.     print("#include \"");\
         pous_incl_s4o.print(pou_name);\
-        pous_s4o.     print(pou_name);\
         pous_incl_s4o.print(".h\"\n");\
-        pous_s4o.     print(".c\"\n");\
+        if (generate_pou_units__) {pou_units.push_back(std::string(pou_name) + ".c"); std_lib_usage.add_file(pou_units.back());}\
+        else {pous_s4o.print("#include \""); pous_s4o.print(pou_name); pous_s4o.print(".c\"\n");}\
       } else {\
         symbol->accept(generate_c_implicit_typedecl);\
         generate_c_pous_c::fname(symbol, pous_incl_s4o, true);\
@@ -2672,6 +4430,9 @@ class generate_c_c: public iterator_visitor_c {
 /* B 1.5.1 - Functions */
 /***********************/      
     void *visit(function_declaration_c *symbol) {
+      if (allow_output && is_small_function(symbol)) inline_functions.insert(symbol);
+      declared_functions.insert(symbol);
+      if (allow_output && wcet_estimate__) wcet_estimate.add_pou(symbol);
       handle_pou(handle_function,symbol->derived_function_name)
       return NULL;
     }
@@ -2680,6 +4441,9 @@ class generate_c_c: public iterator_visitor_c {
 /* B 1.5.2 - Function Blocks */
 /*****************************/
     void *visit(function_block_declaration_c *symbol) {
+      if (allow_output && layout_descriptors__) generate_c_layout_c::add_fb_type(symbol->fblock_name);
+      if (allow_output && memory_report__) memory_report.add_pou("FUNCTION_BLOCK", symbol->fblock_name, symbol->var_declarations);
+      if (allow_output && wcet_estimate__) wcet_estimate.add_pou(symbol);
       handle_pou(handle_function_block,symbol->fblock_name)
       return NULL;
     }
@@ -2688,6 +4452,8 @@ class generate_c_c: public iterator_visitor_c {
 /* B 1.5.3 - Programs */
 /**********************/    
     void *visit(program_declaration_c *symbol) {
+      if (allow_output && memory_report__) memory_report.add_pou("PROGRAM", symbol->program_type_name, symbol->var_declarations);
+      if (allow_output && wcet_estimate__) wcet_estimate.add_pou(symbol);
       handle_pou(handle_program,symbol->program_type_name)
       return NULL;
     }
@@ -2708,6 +4474,7 @@ class generate_c_c: public iterator_visitor_c {
       }
 
       current_configuration = symbol;
+      if (task_data__) analyse_task_data(symbol);
 
       {
         calculate_common_ticktime_c calculate_common_ticktime;
@@ -2720,7 +4487,9 @@ class generate_c_c: public iterator_visitor_c {
 
         symbol->configuration_name->accept(*this);
         
+        config_unit = std::string(current_name) + ".c";
         stage4out_c config_s4o(current_builddir, current_name, "c");
+        std_lib_usage.add_file(std::string(current_name) + ".c");
         stage4out_c config_incl_s4o(current_builddir, current_name, "h");
         generate_c_config_c generate_c_config(&config_s4o, &config_incl_s4o);
         symbol->accept(generate_c_config);
@@ -2730,9 +4499,16 @@ class generate_c_c: public iterator_visitor_c {
         config_s4o.print(" * ");
         config_s4o.print_long_long_integer(1000000 / MILLISECOND);
         config_s4o.print("; /*ns*/\n");
+        if (tick_timers__ && !resource_context__)
+          config_s4o.print("unsigned long long __CURRENT_TICK = 0; /*tick, maintained by the resources' run functions*/\n");
+        if (profile_pous__)
+          config_s4o.print("unsigned long long __profile_children = 0; /*see iec_profile.h*/\n");
+        if (timer_wheel__)
+          config_s4o.print("__timer_wheel_t __TIMER_WHEEL; /*the running timers, see iec_timer_wheel.h*/\n");
         config_s4o.print("unsigned long greatest_tick_count__ = (unsigned long)");
         config_s4o.print_long_integer(calculate_common_ticktime.get_greatest_tick_count());
         config_s4o.print("; /*tick*/\n");
+        calculate_common_ticktime.print_next_tick_function(config_s4o);
 
         if (generate_plc_state_backup_fuctions__ > 0) {
           generate_c_backup_config_c generate_backup = generate_c_backup_config_c(&config_s4o);
@@ -2740,7 +4516,15 @@ class generate_c_c: public iterator_visitor_c {
         }
       }
 
+      if (memory_report__) symbol->accept(memory_report);
+      if (wcet_estimate__) {
+        stage4out_c wcet_s4o(current_builddir, "WCET", "csv");
+        wcet_estimate.generate(wcet_s4o, symbol, common_ticktime);
+      }
+
+      resource_units.clear();
       symbol->resource_declarations->accept(*this);
+      if (amalgamate__) generate_amalgamation();
 
       current_configuration = NULL;
       return NULL;
@@ -2751,17 +4535,23 @@ class generate_c_c: public iterator_visitor_c {
         symbol->global_var_declarations->accept(generate_c_implicit_typedecl);
       symbol->resource_name->accept(*this);
       stage4out_c resources_s4o(current_builddir, current_name, "c");
+      std_lib_usage.add_file(std::string(current_name) + ".c");
+      resource_units.push_back(std::string(current_name) + ".c");
       generate_c_resources_c generate_c_resources(&resources_s4o, current_configuration, symbol, common_ticktime);
       symbol->accept(generate_c_resources);
-      if (generate_plc_state_backup_fuctions__ > 0) {
+      /* with retain_segment__, the configuration saves the whole state, including that of the resources */
+      if ((generate_plc_state_backup_fuctions__ > 0) && !retain_segment__) {
         generate_c_backup_resource_c generate_backup = generate_c_backup_resource_c(&resources_s4o);
         symbol->accept(generate_backup);
       }
+      if (amalgamate__) generate_c_resources.print_undefines(symbol->resource_declaration);
       return NULL;
     }
 
     void *visit(single_resource_declaration_c *symbol) {
       stage4out_c resources_s4o(current_builddir, "RESOURCE", "c");
+      std_lib_usage.add_file("RESOURCE.c");
+      resource_units.push_back("RESOURCE.c");
       generate_c_resources_c generate_c_resources(&resources_s4o, current_configuration, symbol, common_ticktime);
       symbol->accept(generate_c_resources);
       return NULL;
@@ -2781,7 +4571,68 @@ class generate_c_c: public iterator_visitor_c {
 
 
 
+/* Restore the defaults of all the options, before parsing those of another target (iec2c -G) */
+void stage4_reset_options(void) {
+  generate_line_directives__           = 0;
+  generate_pou_filepairs__             = 0;
+  generate_pou_units__                 = 0;
+  generate_plc_state_backup_fuctions__ = 0;
+  generate_pou_jobs__                  = 1;
+  disable_variable_forcing__           = 0;
+  sort_instance_variables__            = 0;
+  hot_cold_fields__                    = 0;
+  skip_unused_fb_eneno__               = 0;
+  int64_time__                         = 0;
+  tick_timers__                        = 0;
+  timer_wheel__                        = 0;
+  std_lib_object__                     = 0;
+  std_lib_used__                       = 0;
+  sfc_active_steps__                   = 0;
+  sfc_no_debug__                       = 0;
+  sfc_single_sequence__                = 0;
+  parallel_networks__                  = 0;
+  il_defvar_struct__                   = 0;
+  inline_function_size__               = 0;
+  amalgamate__                         = 0;
+  fb_init_image__                      = 0;
+  array_bounds_check__                 = 0;
+  debug_table__                        = 0;
+  retain_segment__                     = 0;
+  retain_dirty__                       = 0;
+  process_image__                      = 0;
+  direct_globals__                     = 0;
+  profile_pous__                       = 0;
+  task_stats__                         = 0;
+  stmt_counters__                      = 0;
+  layout_descriptors__                 = 0;
+  memory_report__                      = 0;
+  wcet_estimate__                      = 0;
+  depends_file__                       = 0;
+  event_tasks__                        = 0;
+  resource_context__                   = 0;
+  skip_unchanged_fbs__                 = 0;
+  task_data__                          = 0;
+  restrict_instances__                 = 0;
+  input_recorder__                     = 0;
+  global_snapshots__                   = 0;
+  shared_image_vars__.clear();
+  delete stmt_profile__;
+  stmt_profile__ = NULL;
+  wcet_costs__.clear();  /* the default costs are set again by init_wcet_costs() */
+}
+
+bool stage4_requires_stage3(void) {return true;}
+
+
 visitor_c *new_code_generator(stage4out_c *s4o, const char *builddir)  {return new generate_c_c(s4o, builddir);}
-void delete_code_generator(visitor_c *code_generator) {delete code_generator;}
+void delete_code_generator(visitor_c *code_generator) {
+  delete code_generator;  /* closes all the generated files */
+  if (std_lib_used__) std_lib_usage.generate();
+  if (depends_file__)  generated_depends.generate();
+  /* the annotations of this AST, whose symbols (and their ids) may be reused by the next one (see symbol_c::release_arena()) */
+  inline_functions.clear();
+  inline_fcall_number.clear();
+  implicit_type_id.clear();
+}
 
 
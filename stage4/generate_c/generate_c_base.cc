@@ -23,6 +23,7 @@
  */
 
 #include <string.h>
+#include <strings.h>
 
 
 
@@ -59,6 +60,14 @@ typedef struct
   function_param_iterator_c::param_direction_t param_direction;
 } FUNCTION_PARAM;
 
+/* The id of the C datatype that generate_c_typedecl_c or generate_implicit_typedecl_c declared for
+ * an implicitly defined datatype (e.g. the array_specification_c of VAR a: ARRAY [3..5] of INT END_VAR),
+ * stored in the symbols of that datatype. NULL for all other symbols.
+ */
+static annotation_table_c<symbol_c *> implicit_type_id;
+
+
+
 #define DECLARE_PARAM_LIST()\
   std::list<FUNCTION_PARAM*> param_list;\
   std::list<FUNCTION_PARAM*>::iterator pt;\
@@ -128,7 +137,69 @@ class generate_c_base_c: public iterator_visitor_c {
       s4o.print(symbol->first_file);
       s4o.print("\"\n");    
     }
+
+    /* The counter of the executions of a statement (stmt_counters__, see iec_counters.h) */
+    void print_stmt_counter(symbol_c *symbol) {
+      if (!stmt_counters__) return; /* global variable stmt_counters__ is defined in generate_c.cc */
+      if (NULL == symbol->first_file) return;
+      s4o.print("__STMT_COUNT(\"");
+      s4o.print(symbol->first_file);
+      s4o.print("\", ");
+      s4o.print(symbol->first_line);
+      s4o.print(") ");
+    }
     
+    /* Whether the (non constant) subscript is known to be within the lower and upper limits (array_bounds_check__).
+     * Here only when its datatype is a subrange within these limits.
+     */
+    virtual bool is_subscript_in_range(symbol_c *subscript, int64_t lower, int64_t upper) {
+      subrange_specification_c *subrange_spec = dynamic_cast<subrange_specification_c *>(subscript->datatype);
+      subrange_c *subrange = (NULL == subrange_spec)? NULL : dynamic_cast<subrange_c *>(subrange_spec->subrange);
+      if ((NULL == subrange) || !VALID_CVALUE(int64, subrange->lower_limit) || !VALID_CVALUE(int64, subrange->upper_limit)) return false;
+      return (GET_CVALUE(int64, subrange->lower_limit) >= lower) && (GET_CVALUE(int64, subrange->upper_limit) <= upper);
+    }
+
+    /* Print the C subscript of an array, i.e. the subscript minus the lower limit of its dimension (dimension is a subrange_c).
+     * The lower limit is folded into a constant subscript, and left out when it is 0.
+     * With array_bounds_check__, the subscripts that may be out of range are checked by __check_subscript().
+     */
+    void print_subscript(symbol_c *subscript, symbol_c *dimension) {
+      subrange_c *subrange = dynamic_cast<subrange_c *>(dimension);
+      if ((NULL != subrange) && VALID_CVALUE(int64, subrange->lower_limit)) {
+        int64_t lower = GET_CVALUE(int64, subrange->lower_limit);
+        if (   VALID_CVALUE(int64, subscript)
+            && (GET_CVALUE(int64, subscript) >= lower)
+            && ((lower >= 0) || (GET_CVALUE(int64, subscript) <= INT64_MAX + lower))) {
+          s4o.print("[");
+          s4o.print((long long int)(GET_CVALUE(int64, subscript) - lower));
+          s4o.print("]");
+          return;
+        }
+        if (   array_bounds_check__ && VALID_CVALUE(int64, subrange->upper_limit)
+            && !is_subscript_in_range(subscript, lower, GET_CVALUE(int64, subrange->upper_limit))) {
+          s4o.print("[__check_subscript(");
+          subscript->accept(*this);
+          s4o.print(", ");
+          s4o.print((long long int)lower);
+          s4o.print(", ");
+          s4o.print((long long int)GET_CVALUE(int64, subrange->upper_limit));
+          s4o.print(")]");
+          return;
+        }
+        if (0 == lower) {
+          s4o.print("[(");
+          subscript->accept(*this);
+          s4o.print(")]");
+          return;
+        }
+      }
+      s4o.print("[(");
+      subscript->accept(*this);
+      s4o.print(") - (");
+      dimension->accept(*this);
+      s4o.print(")]");
+    }
+
     void *print_token(token_c *token, int offset = 0) {
       return s4o.printupper((token->value)+offset);
     }
@@ -249,6 +320,33 @@ class generate_c_base_c: public iterator_visitor_c {
       return NULL;
     }
 
+    /* The C library provides fixed arity versions of the most commonly used extensible standard
+     * functions (e.g. ADD_INT__N2(), ADD__INT__INT__N3(), ...; see __fixed_arity in iec_std_functions.h),
+     * which the C compiler is able to inline, unlike the versions taking a va_list.
+     * They take exactly the same parameters (including the number of operands), so to call them we
+     * only need to print this suffix after the name of the function.
+     * 
+     *   extensible_param_count: number of operands passed to the extensible parameter,
+     *                            or 0 if the function being called is not extensible.
+     */
+    void print_fixed_arity_suffix(symbol_c *function_name, int extensible_param_count) {
+      static const char *fixed_arity_functions[] = {"ADD", "MUL", "AND", "OR", "XOR", "MAX", "MIN", "CONCAT",
+                                                    "GT", "GE", "EQ", "LE", "LT", NULL};
+      if ((extensible_param_count < 2) || (extensible_param_count > 4)) return;
+      token_c *name = dynamic_cast<token_c *>(function_name);
+      if (NULL == name) return;
+      for (int i = 0; fixed_arity_functions[i] != NULL; i++) {
+        size_t len = strlen(fixed_arity_functions[i]);
+        /* match both the overloaded (ADD) and the explicitly typed (ADD_INT) functions */
+        if ((strncasecmp(name->value, fixed_arity_functions[i], len) == 0) &&
+            ((name->value[len] == '\0') || (name->value[len] == '_'))) {
+          s4o.print("__N");
+          s4o.print(extensible_param_count);
+          return;
+        }
+      }
+    }
+
     /* Call a standard library function that does a comparison (GT, NE, EQ, LT, ...)
      * NOTE: Typically, the function will have the following parameters: 
      *         1st parameter: EN  (enable)
@@ -276,6 +374,8 @@ class generate_c_base_c: public iterator_visitor_c {
       s4o.print(function); // the GT, LE, ... part
       s4o.print("_");  // the '_' part...
       compare_type->accept(*this); // the TIME, DATE, ... part.
+      if (strcmp(function, "NE") != 0)
+        s4o.print("__N2"); // call the fixed arity version of the extensible function (see print_fixed_arity_suffix())
       s4o.print("(");  // start of parameters to function call...
       // Determine whether this function has the EN parameter
       //    (we just check the base LE, GT, .. function, as it should have
@@ -304,6 +404,13 @@ class generate_c_base_c: public iterator_visitor_c {
           bool temp = false) {
       if (!get_datatype_info_c::is_type_valid(type)) ERROR;
       bool is_subrange = get_datatype_info_c::is_subrange(type);
+      /* no need to check the values that are always inside the subrange (see array_range_check_c) */
+      int64_t lower, upper, value_lower, value_upper;
+      if (   is_subrange && (NULL == fb_name) && !temp
+          && get_datatype_info_c::get_int_range  (type,  lower,       upper)
+          && array_range_check_c::get_value_range(value, value_lower, value_upper)
+          && (value_lower >= lower) && (value_upper <= upper))
+        is_subrange = false;
       if (is_subrange) {
         s4o.print("__CHECK_");
         type->accept(*this);
@@ -432,7 +539,8 @@ class generate_c_base_c: public iterator_visitor_c {
       return print_token(symbol);
     }
 
-    void *visit(single_byte_character_string_c *symbol) {
+    /* Convert a string literal into the parameters of __STRING_LITERAL(), i.e. <count>,"<C string>" */
+    static std::string string_literal_params(single_byte_character_string_c *symbol) {
       std::string str = "";
       unsigned int count = 0; 
       str += '"';
@@ -481,10 +589,14 @@ class generate_c_base_c: public iterator_visitor_c {
       } /* for() */
 
       str += '"';
+      char count_str[16];
+      snprintf(count_str, sizeof(count_str), "%u", count);
+      return std::string(count_str) + "," + str;
+    }
+
+    void *visit(single_byte_character_string_c *symbol) {
       s4o.print("__STRING_LITERAL(");
-      s4o.print(count); 
-      s4o.print(",");
-      s4o.print(str);
+      s4o.print(string_literal_params(symbol));
       s4o.print(")");
       return NULL;
     }
@@ -503,9 +615,51 @@ class generate_c_base_c: public iterator_visitor_c {
 void *visit(neg_time_c *symbol) {s4o.print("-1"); /* negative time value */; return NULL;}
 
 
+/* Calculate the (rounded) number of nanoseconds of an interval.
+ * Returns false if some element of the interval does not have a constant value, or the result does not fit in 63 bits.
+ */
+static bool get_interval_ns(symbol_c *symbol, long long int *ns) {
+  interval_c *interval = dynamic_cast<interval_c *>(symbol);
+  if (NULL == interval) return false;
+  /* SYM_REF5(interval_c, days, hours, minutes, seconds, milliseconds) */
+  symbol_c         *element[]    = {interval->milliseconds, interval->seconds, interval->minutes, interval->hours, interval->days};
+  const long double multiplier[] = {1e6,                    1e9,               60e9,              3600e9,          86400e9};
+  long double total = 0;
+  for (int i = 0; i < 5; i++) {
+    if      (NULL == element[i]) continue;
+    if      (VALID_CVALUE(uint64, element[i])) total += GET_CVALUE(uint64, element[i]) * multiplier[i];
+    else if (VALID_CVALUE(real64, element[i])) total += GET_CVALUE(real64, element[i]) * multiplier[i];
+    else return false;
+  }
+  if ((total < 0) || (total >= 9.2e18)) return false;
+  *ns = (long long int)(total + 0.5);
+  return true;
+}
+
+/* Print a constant IEC_TIMESPEC, already calculated from the literal (in nanoseconds).
+ * We do not leave this to the __xxx_to_timespec() macros, so the C compiler does not have to
+ * evaluate the long double expressions these expand to for every literal in the program.
+ */
+void print_timespec_ns(bool negative, long long int ns) {
+  const char *sign = negative? "-" : "";
+  if (int64_time__) {
+    /* TIME is a count of nanoseconds (see USE_INT64_TIME in iec_types.h) */
+    s4o.print("__ns_to_timespec("); s4o.print(sign); s4o.print(ns); s4o.print("LL)");
+    return;
+  }
+  s4o.print("__timespec(");
+  s4o.print(sign); s4o.print(ns / 1000000000LL); s4o.print(", ");
+  s4o.print(sign); s4o.print(ns % 1000000000LL); s4o.print(")");
+}
+
 /* SYM_REF2(duration_c, neg, interval) */
 void *visit(duration_c *symbol) {
   TRACE("duration_c");
+  long long int ns;
+  if (get_interval_ns(symbol->interval, &ns)) {
+    print_timespec_ns(NULL != symbol->neg, ns);
+    return NULL;
+  }
   s4o.print("__time_to_timespec(");
   
   if (NULL == symbol->neg)    s4o.print("1");  /* positive time value */
@@ -552,9 +706,70 @@ void *visit(interval_c *symbol) {
 /* B 1.2.3.2 - Time of day and Date */
 /************************************/
 
+/* Calculate the (rounded) number of nanoseconds since midnight of a daytime.
+ * Returns false if some element of the daytime does not have a constant value.
+ */
+static bool get_daytime_ns(symbol_c *symbol, long long int *ns) {
+  daytime_c *daytime = dynamic_cast<daytime_c *>(symbol);
+  if (NULL == daytime) return false;
+  /* SYM_REF4(daytime_c, day_hour, day_minute, day_second, unused) */
+  symbol_c         *element[]    = {daytime->day_second, daytime->day_minute, daytime->day_hour};
+  const long double multiplier[] = {1e9,                 60e9,                3600e9};
+  long double total = 0;
+  for (int i = 0; i < 3; i++) {
+    if      (NULL == element[i]) return false;
+    if      (VALID_CVALUE(uint64, element[i])) total += GET_CVALUE(uint64, element[i]) * multiplier[i];
+    else if (VALID_CVALUE(real64, element[i])) total += GET_CVALUE(real64, element[i]) * multiplier[i];
+    else return false;
+  }
+  if ((total < 0) || (total >= 9.2e18)) return false;
+  *ns = (long long int)(total + 0.5);
+  return true;
+}
+
+/* Calculate the number of seconds since the epoch (1970-01-01) of a date, using the same
+ * algorithm as __date_to_timespec() in iec_std_lib.h.
+ * Returns false if some element of the date does not have a constant value, or the date is invalid
+ * (in which case __date_to_timespec() is left to report the error at runtime, as before).
+ */
+static bool get_date_s(symbol_c *symbol, long long int *s) {
+  static const int mon_yday[2][13] = {
+    { 0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334, 365}, /* Normal years. */
+    { 0, 31, 60, 91, 121, 152, 182, 213, 244, 274, 305, 335, 366}  /* Leap years.   */
+  };
+  date_literal_c *date = dynamic_cast<date_literal_c *>(symbol);
+  if (NULL == date) return false;
+  /* SYM_REF4(date_literal_c, year, month, day, unused) */
+  if ((NULL == date->year) || (NULL == date->month) || (NULL == date->day)) return false;
+  if (!VALID_CVALUE(uint64, date->year) || !VALID_CVALUE(uint64, date->month) || !VALID_CVALUE(uint64, date->day)) return false;
+  if (GET_CVALUE(uint64, date->year) > 1000000) return false;
+  long long int year  = GET_CVALUE(uint64, date->year);
+  long long int month = GET_CVALUE(uint64, date->month);
+  long long int day   = GET_CVALUE(uint64, date->day);
+  int leap = (year % 4 == 0 && (year % 100 != 0 || year % 400 == 0));
+  if ((month < 1) || (month > 12) || (day > 31)) return false;
+  long long int yday = mon_yday[leap][month - 1] + day;
+  if (yday > mon_yday[leap][month]) return false;
+
+  long long int a4   = (year >> 2) - !(year & 3);
+  long long int b4   = (1970 >> 2) - !(1970 & 3);
+  long long int a100 = a4 / 25 - (a4 % 25 < 0);
+  long long int b100 = b4 / 25 - (b4 % 25 < 0);
+  long long int a400 = a100 >> 2;
+  long long int b400 = b100 >> 2;
+  long long int intervening_leap_days = (a4 - b4) - (a100 - b100) + (a400 - b400);
+  *s = ((year - 1970) * 365 + intervening_leap_days + yday - 1) * 24 * 60 * 60;
+  return true;
+}
+
 /* SYM_REF2(time_of_day_c, daytime, unused) */
 void *visit(time_of_day_c *symbol) {
   TRACE("time_of_day_c");
+  long long int ns;
+  if (get_daytime_ns(symbol->daytime, &ns)) {
+    print_timespec_ns(false, ns);
+    return NULL;
+  }
   s4o.print("__tod_to_timespec(");
   symbol->daytime->accept(*this);
   s4o.print(")");
@@ -577,6 +792,11 @@ void *visit(daytime_c *symbol) {
 /* SYM_REF2(date_c, date_literal, unused) */
 void *visit(date_c *symbol) {
   TRACE("date_c");
+  long long int sec;
+  if (get_date_s(symbol->date_literal, &sec) && (sec >= 0) && (sec < 9200000000LL)) {
+    print_timespec_ns(false, sec * 1000000000LL);
+    return NULL;
+  }
   s4o.print("__date_to_timespec(");
   symbol->date_literal->accept(*this);
   s4o.print(")");
@@ -599,6 +819,12 @@ void *visit(date_literal_c *symbol) {
 /* SYM_REF2(date_and_time_c, date_literal, daytime) */
 void *visit(date_and_time_c *symbol) {
   TRACE("date_and_time_c");
+  long long int sec, ns;
+  if (get_date_s(symbol->date_literal, &sec) && get_daytime_ns(symbol->daytime, &ns)
+      && (sec >= 0) && (sec < 9200000000LL) && (ns < 9200000000000000000LL - sec * 1000000000LL)) {
+    print_timespec_ns(false, sec * 1000000000LL + ns);
+    return NULL;
+  }
   s4o.print("__dt_to_timespec(");
   symbol->daytime->accept(*this);
   s4o.print(", ");
@@ -867,6 +1093,42 @@ class generate_c_base_and_typeid_c: public generate_c_base_c {
      generate_c_base_and_typeid_c(stage4out_c *s4o_ptr): generate_c_base_c(s4o_ptr) {}
     ~generate_c_base_and_typeid_c(void) {}
 
+    /* Print the value stage3 determined for an expression (a call to a standard function with constant
+     * parameters, or a CONSTANT variable), as a literal of the expression's datatype.
+     * Returns false, without printing anything, if the value is not known for that datatype.
+     */
+    bool print_folded_value(symbol_c *symbol) {
+      symbol_c *type = symbol->datatype;
+      if (!get_datatype_info_c::is_type_valid(type)) return false;
+      /* only for the elementary datatypes, whose C type name is printed by visiting the datatype */
+      if (!get_datatype_info_c::is_ANY_ELEMENTARY(type) && !get_datatype_info_c::is_ANY_SAFEELEMENTARY(type)) return false;
+
+      if        (get_datatype_info_c::is_BOOL_compatible(type)) {
+        if (!VALID_CVALUE(bool, symbol)) return false;
+        s4o.print(GET_CVALUE(bool, symbol)? "TRUE" : "FALSE");
+      } else if (get_datatype_info_c::is_ANY_signed_INT_compatible(type)) {
+        if (!VALID_CVALUE(int64, symbol)) return false;
+        if (GET_CVALUE(int64, symbol) == INT64_MIN) return false; /* no C literal for this one */
+        s4o.print("(("); type->accept(*this); s4o.print(")");
+        s4o.print((long long int)GET_CVALUE(int64, symbol));
+        s4o.print(")");
+      } else if (get_datatype_info_c::is_ANY_unsigned_INT_compatible(type) || get_datatype_info_c::is_ANY_nBIT_compatible(type)) {
+        if (!VALID_CVALUE(uint64, symbol)) return false;
+        s4o.print("(("); type->accept(*this); s4o.print(")");
+        s4o.print_long_long_integer(GET_CVALUE(uint64, symbol));
+        s4o.print(")");
+      } else if (get_datatype_info_c::is_ANY_REAL_compatible(type)) {
+        if (!VALID_CVALUE(real64, symbol)) return false;
+        char str[64];
+        snprintf(str, sizeof(str), "%.17g", (double)GET_CVALUE(real64, symbol));
+        s4o.print("(("); type->accept(*this); s4o.print(")");
+        s4o.print(str);
+        s4o.print(")");
+      } else
+        return false;
+      return true;
+    }
+
 
 /*************************/
 /* B.1 - Common elements */
@@ -923,9 +1185,9 @@ void *visit(enumerated_value_c *symbol) {}
 
 /*  identifier ':' array_spec_init */
 void *visit(array_type_declaration_c *symbol) {
-  int implicit_id_count = symbol->anotations_map.count("generate_c_annotaton__implicit_type_id");
-  if (1 != implicit_id_count) ERROR;
-  return symbol->anotations_map["generate_c_annotaton__implicit_type_id"]->accept(*this);
+  symbol_c *type_id = implicit_type_id.get(symbol);
+  if (NULL == type_id) ERROR;
+  return type_id->accept(*this);
 }
 
 
@@ -933,17 +1195,16 @@ void *visit(array_type_declaration_c *symbol) {
 /* array_specification [ASSIGN array_initialization] */
 /* array_initialization may be NULL ! */
 void *visit(array_spec_init_c *symbol) {
-  int implicit_id_count = symbol->anotations_map.count("generate_c_annotaton__implicit_type_id");
-  if (1 == implicit_id_count) return symbol->anotations_map["generate_c_annotaton__implicit_type_id"]->accept(*this);
-  if (0 == implicit_id_count) return symbol->datatype->accept(*this);
-  return NULL;
+  symbol_c *type_id = implicit_type_id.get(symbol);
+  if (NULL != type_id) return type_id->accept(*this);
+  return symbol->datatype->accept(*this);
 }
 
 /* ARRAY '[' array_subrange_list ']' OF non_generic_type_name */
 void *visit(array_specification_c *symbol) {
-  int implicit_id_count = symbol->anotations_map.count("generate_c_annotaton__implicit_type_id");
-  if (1 != implicit_id_count) ERROR;
-  return symbol->anotations_map["generate_c_annotaton__implicit_type_id"]->accept(*this);
+  symbol_c *type_id = implicit_type_id.get(symbol);
+  if (NULL == type_id) ERROR;
+  return type_id->accept(*this);
 }
 
 
@@ -970,13 +1231,12 @@ void *visit(initialized_structure_c *symbol) {return symbol->structure_type_name
 /* ref_spec:  REF_TO (non_generic_type_name | function_block_type_name) */
 // SYM_REF1(ref_spec_c, type_name)
 void *visit(ref_spec_c *symbol) { 
-  int implicit_id_count = symbol->anotations_map.count("generate_c_annotaton__implicit_type_id");
-  if (implicit_id_count  > 1) ERROR;
-  if (implicit_id_count == 1) {
+  symbol_c *type_id = implicit_type_id.get(symbol);
+  if (NULL != type_id) {
       /* this is part of an implicitly declared datatype (i.e. inside a variable decaration), for which an equivalent C datatype
        * has already been defined. So, we simly print out the id of that C datatpe...
        */
-    return symbol->anotations_map["generate_c_annotaton__implicit_type_id"]->accept(*this);
+    return type_id->accept(*this);
   }
   /* This is NOT part of an implicitly declared datatype (i.e. we are being called from an visit(ref_type_decl_c *),
    * through the visit(ref_spec_init_c*)), so we need to simply print out the name of the datatype we reference to.
@@ -1000,10 +1260,9 @@ void *visit(ref_spec_init_c *symbol) {
    *       we will keep track of the datatypes that have already been declared, and henceforth
    *       only declare the datatypes that have not been previously defined.
    */
-  int implicit_id_count = symbol->anotations_map.count("generate_c_annotaton__implicit_type_id");
-  if (1  < implicit_id_count) ERROR;
-  if (1 == implicit_id_count)
-    return symbol->anotations_map["generate_c_annotaton__implicit_type_id"]->accept(*this);
+  symbol_c *type_id = implicit_type_id.get(symbol);
+  if (NULL != type_id)
+    return type_id->accept(*this);
   return symbol->ref_spec->accept(*this); // this is probably pointing to an ***_identifier_c !!
 }
 
@@ -1019,9 +1278,7 @@ void *visit(ref_type_decl_c *symbol) {
    *       we will keep track of the datatypes that have already been declared, and henceforth
    *       only declare the datatypes that have not been previously defined.
    */
-  int implicit_id_count = symbol->anotations_map.count("generate_c_annotaton__implicit_type_id");
-  if (0 != implicit_id_count) ERROR;
-  //symbol->anotations_map["generate_c_annotaton__implicit_type_id"]->accept(generate_c_base);
+  if (NULL != implicit_type_id.get(symbol)) ERROR;
   return symbol->ref_type_name->accept(*this);
 }
 
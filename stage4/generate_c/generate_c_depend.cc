@@ -0,0 +1,180 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+
+/*
+ * The dependencies of the generated files (iec2c -O D), written to DEPENDS.mk, a fragment to be
+ * included by the Makefile of the user, with:
+ *   IEC2C_SOURCES : the IEC 61131-3 source files read by iec2c (including the files they include,
+ *                   and the standard library);
+ *   IEC2C_OUTPUTS : all the files generated by iec2c;
+ *   IEC2C_C_SRCS  : the generated C files to compile, i.e. those not #included by another one;
+ *   a rule with the IEC 61131-3 source files each generated file came from. The <pou_name>.c/.h
+ *   files (-O p) only depend on the file declaring their POU, the others on all the sources;
+ *   a rule with the generated headers each C file to compile includes, directly or not, for
+ *   its object file (<name>.o, next to the C file).
+ * All the paths are those given to iec2c, i.e. relative to the directory in which it was run.
+ *
+ * Since iec2c does not touch the generated files whose contents did not change (see stage4out_c),
+ * and with -O p keeps the files of the unchanged POUs, make then only recompiles the C files that
+ * actually changed, or that include a header that did.
+ *
+ * Like STD_LIB_USED.h, the #include directives are found by scanning the generated files, once they
+ * have all been written out. The headers that iec2c did not generate (iec_std_lib.h, ...) are not listed.
+ */
+
+
+#define DEPENDS_FILENAME "DEPENDS"
+
+
+class generated_depends_c {
+  private:
+    std::string                                   builddir;
+    size_t                                        first_file;   /* the first of stage4out_c::opened_files() generated in this run */
+    std::vector<std::string>                      files;        /* the files generated, in the order they were opened */
+    std::set<std::string>                         sources;      /* all the IEC 61131-3 source files */
+    std::map<std::string, std::string>            pou_sources;  /* the source file of the <pou_name>.c/.h files */
+    std::map<std::string, std::vector<std::string> > includes;  /* the generated files #included by each generated file */
+
+    std::string path(const std::string &filename) {
+      return builddir.empty()? filename : builddir + "/" + filename;
+    }
+
+    void add_file(const std::string &filename) {
+      if (std::find(files.begin(), files.end(), filename) == files.end()) files.push_back(filename);
+    }
+
+    void scan_file(const std::string &filename) {
+      std::string text;
+      if (!stage4out_c::read_file(builddir.empty()? NULL : builddir.c_str(), filename, text)) return;
+      std::vector<std::string> &file_includes = includes[filename];
+      for (size_t line = 0; line < text.size(); line = text.find('\n', line), line += (line == std::string::npos)? 0 : 1) {
+        if (text.compare(line, 10, "#include \"") != 0) continue;
+        size_t end = text.find_first_of("\"\n", line + 10);
+        if ((std::string::npos == end) || ('"' != text[end])) continue;
+        std::string include = text.substr(line + 10, end - (line + 10));
+        if (std::find(files.begin(), files.end(), include) != files.end()) file_includes.push_back(include);
+      }
+    }
+
+    /* All the generated files #included by the file, directly or not */
+    void add_includes(const std::string &filename, std::set<std::string> &all) {
+      std::vector<std::string> &file_includes = includes[filename];
+      for (unsigned int i = 0; i < file_includes.size(); i++)
+        if (all.insert(file_includes[i]).second) add_includes(file_includes[i], all);
+    }
+
+    static bool is_c_file(const std::string &filename) {
+      return (filename.size() > 2) && (filename.compare(filename.size() - 2, 2, ".c") == 0);
+    }
+
+  public:
+    generated_depends_c(void) {first_file = 0;}
+
+    /* Called when the code generator is created (maybe more than once, with iec2c -B and -S) */
+    void set_builddir(const char *dir) {
+      builddir   = (NULL == dir)? "" : dir;
+      first_file = stage4out_c::opened_files().size();
+      files.clear();
+      sources.clear();
+      pou_sources.clear();
+      includes.clear();
+    }
+
+    /* Called for every library element (including those of the standard library) */
+    void add_source(symbol_c *symbol) {
+      if ((NULL != symbol->first_file) && ('\0' != symbol->first_file[0])) sources.insert(symbol->first_file.c_str());
+      if ((NULL != symbol->last_file ) && ('\0' != symbol->last_file [0])) sources.insert(symbol->last_file.c_str());
+    }
+
+    /* Called for the <pou_name>.c/.h files, including those not generated by this process
+     * (unchanged, or generated by the worker processes)
+     */
+    void add_pou_files(const char *pou_name, symbol_c *symbol) {
+      const char *source = ((NULL != symbol->first_file) && ('\0' != symbol->first_file[0]))? symbol->first_file : NULL;
+      std::string extensions[] = {".c", ".h"};
+      for (int i = 0; i < 2; i++) {
+        add_file(pou_name + extensions[i]);
+        if (NULL != source) pou_sources[pou_name + extensions[i]] = source;
+      }
+    }
+
+    /* Generate the DEPENDS.mk file. Must only be called once all the other generated files have been closed! */
+    void generate(void) {
+      const std::vector<std::string> &opened = stage4out_c::opened_files();
+      for (size_t i = first_file; i < opened.size(); i++) add_file(opened[i]);
+      for (unsigned int i = 0; i < files.size(); i++) scan_file(files[i]);
+
+      /* the C files included by another one are not compiled on their own */
+      std::set<std::string> included;
+      for (unsigned int i = 0; i < files.size(); i++)
+        included.insert(includes[files[i]].begin(), includes[files[i]].end());
+
+      stage4out_c s4o(builddir.empty()? NULL : builddir.c_str(), DEPENDS_FILENAME, "mk");
+      s4o.print("# FILE GENERATED BY iec2c\n");
+      s4o.print("# The dependencies of the files generated by iec2c, relative to the directory in which it was run.\n\n");
+
+      s4o.print("IEC2C_SOURCES =");
+      for (std::set<std::string>::iterator i = sources.begin(); i != sources.end(); i++)
+        s4o.print(" \\\n  " + *i);
+      s4o.print("\n\nIEC2C_OUTPUTS =");
+      for (unsigned int i = 0; i < files.size(); i++)
+        s4o.print(" \\\n  " + path(files[i]));
+      s4o.print(" \\\n  " + path(DEPENDS_FILENAME ".mk"));
+      s4o.print("\n\nIEC2C_C_SRCS =");
+      for (unsigned int i = 0; i < files.size(); i++)
+        if (is_c_file(files[i]) && (included.count(files[i]) == 0))
+          s4o.print(" \\\n  " + path(files[i]));
+      s4o.print("\n\n");
+
+      s4o.print("# The IEC 61131-3 source files each generated file came from\n");
+      std::map<std::string, std::string>::iterator pou;
+      for (pou = pou_sources.begin(); pou != pou_sources.end(); pou++)
+        s4o.print(path(pou->first) + ": " + pou->second + "\n");
+      for (unsigned int i = 0; i < files.size(); i++)
+        if (pou_sources.count(files[i]) == 0)
+          s4o.print(path(files[i]) + " ");
+      s4o.print(path(DEPENDS_FILENAME ".mk") + ": $(IEC2C_SOURCES)\n\n");
+
+      s4o.print("# The generated files (headers, and C files) included by each C file to compile\n");
+      for (unsigned int i = 0; i < files.size(); i++) {
+        if (!is_c_file(files[i]) || (included.count(files[i]) > 0)) continue;
+        std::string object = files[i].substr(0, files[i].size() - 2) + ".o";
+        std::set<std::string> headers;
+        add_includes(files[i], headers);
+        s4o.print(path(object) + ": " + path(files[i]));
+        for (std::set<std::string>::iterator h = headers.begin(); h != headers.end(); h++)
+          s4o.print(" " + path(*h));
+        s4o.print("\n");
+      }
+    }
+};
@@ -0,0 +1,206 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+
+/*
+ * Find the FB instances of a POU whose EN and ENO parameters are never used (see '-O e').
+ *
+ * When the EN input of a FB instance is never set, it keeps its initial value (TRUE), and when the ENO
+ * output is never read its value does not matter. The POU may then call the <fb_type>_body_noeneno__()
+ * function of that instance, which skips the code controlling the execution of the FB (i.e. testing EN
+ * and setting ENO).
+ *
+ * This is only done for FB instances declared in a VAR or VAR_TEMP block of the POU, referenced by a
+ * plain identifier, and only if the POU does not:
+ *   - access the EN or ENO of the instance (e.g. 'fb.EN := x', 'y := fb.ENO', ...);
+ *   - pass the EN or ENO parameters when calling the instance (e.g. 'fb(EN := x, ENO => y)';
+ *     note that the EN and ENO may also be passed in a non formal call, when they were
+ *     explicitly declared in the FB);
+ *   - use the instance in any way other than calling it or accessing its other parameters
+ *     (e.g. passing it to a VAR_IN_OUT parameter);
+ *   - initialise the EN or ENO of any FB instance in its declarations.
+ *
+ * NOTE: the EN of an instance may still be changed from outside the PLC program (e.g. by forcing it
+ *       from a debugger), which is why this is not done by default.
+ */
+
+
+class fb_eneno_usage_c: public iterator_visitor_c {
+  private:
+    /* the (upper case) names of the variables whose EN/ENO may be used */
+    std::set<std::string> used;
+    /* set if the EN/ENO of any FB instance is initialised in the POU declarations */
+    bool eneno_initialized;
+    symbol_c *scope;
+    bool analysed;
+    search_var_instance_decl_c *search_var_instance_decl;
+
+    static const char *get_simple_name(symbol_c *symbol) {
+      symbolic_variable_c *sv = dynamic_cast<symbolic_variable_c *>(symbol);
+      if (NULL != sv) symbol = sv->var_name;
+      identifier_c *id = dynamic_cast<identifier_c *>(symbol);
+      return (NULL == id)? NULL : id->value;
+    }
+
+    static std::string upper(const char *str) {
+      std::string res(str);
+      for (unsigned int i = 0; i < res.size(); i++) res[i] = toupper(res[i]);
+      return res;
+    }
+
+    static bool is_eneno(symbol_c *symbol) {
+      const char *name = get_simple_name(symbol);
+      return (NULL != name) && ((strcasecmp(name, "EN") == 0) || (strcasecmp(name, "ENO") == 0));
+    }
+
+    /* Returns true if a non formal call to the FB may pass a value to its EN or ENO parameters,
+     * i.e. they were explicitly declared in the FB.
+     */
+    static bool nonformal_passes_eneno(symbol_c *fb_decl) {
+      if (NULL == fb_decl) return true;  /* we can not tell, so assume the worst! */
+      function_param_iterator_c fp_iterator(fb_decl);
+      identifier_c *param_name;
+      while ((param_name = fp_iterator.next()) != NULL)
+        if (is_eneno(param_name) && !fp_iterator.is_en_eno_param_implicit()) return true;
+      return false;
+    }
+
+    template <class operator_c> static symbol_c *called_fb(symbol_c *il_operator) {
+      operator_c *op = dynamic_cast<operator_c *>(il_operator);
+      return (NULL == op)? NULL : op->called_fb_declaration;
+    }
+
+    void mark(symbol_c *fb_name) {
+      const char *name = get_simple_name(fb_name);
+      if (NULL != name) used.insert(upper(name));
+    }
+
+    /* Handle a call to a FB instance, with the formal and non formal parameters being passed */
+    void fb_call(symbol_c *fb_name, symbol_c *fb_decl, list_c *formal_param_list, symbol_c *nonformal_param_list) {
+      /* the name of the FB instance being called is not marked as used, unless ... */
+      if (NULL == get_simple_name(fb_name)) fb_name->accept(*this);
+      if ((NULL != nonformal_param_list) && nonformal_passes_eneno(fb_decl)) mark(fb_name);
+      if (NULL != formal_param_list)
+        for (int i = 0; i < formal_param_list->n; i++) {
+          symbol_c *param = formal_param_list->get_element(i);
+          input_variable_param_assignment_c  *in_param  = dynamic_cast<input_variable_param_assignment_c  *>(param);
+          output_variable_param_assignment_c *out_param = dynamic_cast<output_variable_param_assignment_c *>(param);
+          il_param_assignment_c              *il_in     = dynamic_cast<il_param_assignment_c              *>(param);
+          il_param_out_assignment_c          *il_out    = dynamic_cast<il_param_out_assignment_c          *>(param);
+          symbol_c *param_name = NULL;
+          if (NULL != in_param)  param_name = in_param ->variable_name;
+          if (NULL != out_param) param_name = out_param->variable_name;
+          if ((NULL != il_in)  && (NULL != dynamic_cast<il_assign_operator_c     *>(il_in ->il_assign_operator)))
+            param_name = dynamic_cast<il_assign_operator_c     *>(il_in ->il_assign_operator)->variable_name;
+          if ((NULL != il_out) && (NULL != dynamic_cast<il_assign_out_operator_c *>(il_out->il_assign_out_operator)))
+            param_name = dynamic_cast<il_assign_out_operator_c *>(il_out->il_assign_out_operator)->variable_name;
+          if ((NULL == param_name) || is_eneno(param_name)) mark(fb_name);
+        }
+      /* visit the values being passed to the parameters */
+      if (NULL != formal_param_list)    formal_param_list   ->accept(*this);
+      if (NULL != nonformal_param_list) nonformal_param_list->accept(*this);
+    }
+
+  public:
+    fb_eneno_usage_c(symbol_c *scope) {
+      eneno_initialized = false;
+      analysed = false;
+      this->scope = scope;
+      search_var_instance_decl = new search_var_instance_decl_c(scope);
+    }
+    virtual ~fb_eneno_usage_c(void) {delete search_var_instance_decl;}
+
+    /* Returns true if the POU may call the FB instance <fb_name> without the code that controls its execution. */
+    bool is_eneno_unused(symbol_c *fb_name, symbol_c *fb_decl) {
+      if ((!skip_unused_fb_eneno__) || (NULL == scope)) return false;
+      /* the POU is only analysed the first time it is needed */
+      if (!analysed) {scope->accept(*this); analysed = true;}
+      if (eneno_initialized) return false;
+      const char *name = get_simple_name(fb_name);
+      if ((NULL == name) || (NULL == fb_decl)) return false;
+      if (used.find(upper(name)) != used.end()) return false;
+
+      search_var_instance_decl_c::vt_t vartype = search_var_instance_decl->get_vartype(fb_name);
+      if ((search_var_instance_decl_c::private_vt != vartype) && (search_var_instance_decl_c::temp_vt != vartype)) return false;
+
+      /* does the FB have the EN and ENO parameters, and therefore a <fb_type>_body_noeneno__() function? */
+      search_var_instance_decl_c search_fb_var(fb_decl);
+      identifier_c  en_var("EN");
+      identifier_c eno_var("ENO");
+      return (   (search_fb_var.get_vartype(& en_var) == search_var_instance_decl_c::input_vt)
+              && (search_fb_var.get_vartype(&eno_var) == search_var_instance_decl_c::output_vt));
+    }
+
+    /* any other use of a variable */
+    void *visit(symbolic_variable_c *symbol) {mark(symbol); return NULL;}
+
+    /*  record_variable '.' field_selector */
+    void *visit(structured_variable_c *symbol) {
+      /* accessing the other parameters of the FB instance (e.g. 'fb.Q') does not change its EN or ENO */
+      if (is_eneno(symbol->field_selector) || (NULL == get_simple_name(symbol->record_variable)))
+        symbol->record_variable->accept(*this);
+      return NULL;
+    }
+
+    /* structure_element_name ASSIGN value */
+    void *visit(structure_element_initialization_c *symbol) {
+      if (is_eneno(symbol->structure_element_name)) eneno_initialized = true;
+      return iterator_visitor_c::visit(symbol);
+    }
+
+    /* fb_name '(' [param_assignment_list] ')' */
+    void *visit(fb_invocation_c *symbol) {
+      fb_call(symbol->fb_name, symbol->called_fb_declaration, dynamic_cast<list_c *>(symbol->formal_param_list), symbol->nonformal_param_list);
+      return NULL;
+    }
+
+    /* il_call_operator prev_declared_fb_name ['(' [il_operand_list | il_param_list] ')'] */
+    void *visit(il_fb_call_c *symbol) {
+      fb_call(symbol->fb_name, symbol->called_fb_declaration, dynamic_cast<list_c *>(symbol->il_param_list), symbol->il_operand_list);
+      return NULL;
+    }
+
+    /* The implicit FB calls of IL (S1, R1, CLK, CU, CD, PV, IN, PT, and S, R when applied to a FB instance)
+     * only set one input parameter of the FB instance.
+     */
+    void *visit(il_simple_operation_c *symbol) {
+      symbol_c *op = symbol->il_simple_operator;
+      bool fb_operator =    (NULL != called_fb< S_operator_c>(op)) || (NULL != called_fb< R_operator_c>(op))
+                         || (NULL != called_fb<S1_operator_c>(op)) || (NULL != called_fb<R1_operator_c>(op))
+                         || (NULL != called_fb<CLK_operator_c>(op))
+                         || (NULL != called_fb<CU_operator_c>(op)) || (NULL != called_fb<CD_operator_c>(op))
+                         || (NULL != called_fb<PV_operator_c>(op))
+                         || (NULL != called_fb<IN_operator_c>(op)) || (NULL != called_fb<PT_operator_c>(op));
+      if (fb_operator && (NULL != get_simple_name(symbol->il_operand))) return NULL;
+      return iterator_visitor_c::visit(symbol);
+    }
+}; /* fb_eneno_usage_c */
@@ -0,0 +1,182 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+
+/*
+ * Fingerprints of the POUs, used to avoid generating again the files of a POU that has not changed
+ * since the previous run (only when each POU is placed in a separate pair of files, i.e. '-O p' or '-O u').
+ *
+ * The fingerprint of a POU is a hash of:
+ *   - the whole POU (the class of each symbol, and the value of each token);
+ *   - the context the POU is compiled in, i.e. all the datatype declarations, configurations, and the
+ *     interfaces (name and variable declarations) of all POUs, along with the code generation options
+ *     and the version of the compiler itself.
+ * The bodies of the other POUs are not included, so changing the code of a POU will only
+ * change its own fingerprint. Changing any declaration will change all fingerprints.
+ *
+ * The fingerprints are stored in the POUS.fingerprints file of the build directory, with one
+ * '<pou_name> <fingerprint>' line for each POU.
+ */
+
+
+#define FINGERPRINTS_FILENAME "POUS.fingerprints"
+
+
+class pou_fingerprint_c: public fcall_iterator_visitor_c {
+  private:
+    uint64_t hash;
+    bool locations;  /* include the location of the symbols (when they are in the #line directives) */
+
+  public:
+    void add(const void *data, size_t len) {
+      /* 64 bit FNV-1a */
+      for (size_t i = 0; i < len; i++) {
+        hash ^= ((const unsigned char *)data)[i];
+        hash *= 1099511628211ULL;
+      }
+    }
+    void add(const char *str)  {if (NULL != str) add(str, strlen(str) + 1); else add("", 1);}
+    void add(int64_t value)    {add(&value, sizeof(value));}
+
+    pou_fingerprint_c(bool locations = true) {hash = 14695981039346656037ULL; this->locations = locations;}
+    uint64_t get(void) {return hash;}
+
+    void prefix_fcall(symbol_c *symbol) {
+      add(symbol->absyntax_cname());
+      token_c *token = dynamic_cast<token_c *>(symbol);
+      if (NULL != token) add(token->value);
+      /* the #line directives include the location of the symbols... */
+      if (locations && generate_line_directives__) {add(symbol->first_file); add((int64_t)symbol->first_line);}
+    }
+    void suffix_fcall(symbol_c *symbol) {add(")");}
+
+    /* Add the context all POUs are compiled in, i.e. everything in the library except the bodies of the POUs */
+    void add_context(list_c *library) {
+      add(__DATE__ " " __TIME__);  /* the compiler itself */
+      add((int64_t)generate_line_directives__);
+      add((int64_t)generate_pou_units__);
+      add((int64_t)generate_plc_state_backup_fuctions__);
+      add((int64_t)disable_variable_forcing__);
+      add((int64_t)sort_instance_variables__);
+      add((int64_t)hot_cold_fields__);
+      add((int64_t)skip_unused_fb_eneno__);
+      add((int64_t)int64_time__);
+      add((int64_t)tick_timers__);
+      add((int64_t)timer_wheel__);
+      add((int64_t)std_lib_object__);
+      add((int64_t)std_lib_used__);
+      add((int64_t)sfc_active_steps__);
+      add((int64_t)sfc_no_debug__);
+      add((int64_t)sfc_single_sequence__);
+      add((int64_t)parallel_networks__);
+      add((int64_t)il_defvar_struct__);
+      add((int64_t)inline_function_size__);
+      add((int64_t)amalgamate__);
+      add((int64_t)fb_init_image__);
+      add((int64_t)array_bounds_check__);
+      add((int64_t)direct_globals__);
+      add((int64_t)profile_pous__);
+      add((int64_t)task_stats__);
+      add((int64_t)stmt_counters__);
+      add((int64_t)layout_descriptors__);
+      add((int64_t)task_data__);
+      add((int64_t)restrict_instances__);
+      add((int64_t)runtime_options.disable_implicit_en_eno);
+      for (int i = 0; i < library->n; i++) {
+        symbol_c *element = library->get_element(i);
+        function_declaration_c       *f_decl  = dynamic_cast<function_declaration_c       *>(element);
+        function_block_declaration_c *fb_decl = dynamic_cast<function_block_declaration_c *>(element);
+        program_declaration_c        *p_decl  = dynamic_cast<program_declaration_c        *>(element);
+        if      (NULL != f_decl)  {f_decl ->derived_function_name->accept(*this); f_decl->type_name->accept(*this); f_decl->var_declarations_list->accept(*this);}
+        else if (NULL != fb_decl) {fb_decl->fblock_name          ->accept(*this); fb_decl->var_declarations->accept(*this);}
+        else if (NULL != p_decl)  {p_decl ->program_type_name    ->accept(*this); p_decl ->var_declarations->accept(*this);}
+        else element->accept(*this);
+      }
+    }
+};
+
+
+
+class pou_fingerprints_c {
+  private:
+    std::string filename;
+    uint64_t context;
+    std::map<std::string, uint64_t> previous, current;
+
+  public:
+    pou_fingerprints_c(const char *builddir) {
+      filename = (NULL == builddir)? "" : std::string(builddir) + "/";
+      filename += FINGERPRINTS_FILENAME;
+      context = 0;
+    }
+
+    void load(list_c *library) {
+      pou_fingerprint_c fingerprint;
+      fingerprint.add_context(library);
+      context = fingerprint.get();
+
+      /* when streaming the files (iec2c -A), the files of all the POUs must be generated */
+      if (stage4out_c::archiving()) return;
+      FILE *f = fopen(filename.c_str(), "r");
+      if (NULL == f) return;
+      char name[1024];
+      unsigned long long value;
+      while (fscanf(f, "%1023s %llx", name, &value) == 2)
+        previous[name] = value;
+      fclose(f);
+    }
+
+    /* Returns true if the POU has not changed since the last time its files were generated */
+    bool unchanged(symbol_c *pou, const char *pou_name) {
+      pou_fingerprint_c fingerprint;
+      pou->accept(fingerprint);
+      uint64_t value = fingerprint.get() ^ context;
+      current[pou_name] = value;
+
+      std::map<std::string, uint64_t>::iterator i = previous.find(pou_name);
+      if ((i == previous.end()) || (i->second != value)) return false;
+      /* ... and make sure nobody deleted the files in the meantime */
+      std::string dir = filename.substr(0, filename.length() - strlen(FINGERPRINTS_FILENAME));
+      struct stat st;
+      return (   (stat((dir + pou_name + ".c").c_str(), &st) == 0)
+              && (stat((dir + pou_name + ".h").c_str(), &st) == 0));
+    }
+
+    void save(void) {
+      if (stage4out_c::archiving()) return;  /* the build directory is not written to */
+      FILE *f = fopen(filename.c_str(), "w");
+      if (NULL == f) {perror(("Error writing " + filename).c_str()); return;}
+      for (std::map<std::string, uint64_t>::iterator i = current.begin(); i != current.end(); i++)
+        fprintf(f, "%s %016llx\n", i->first.c_str(), (unsigned long long)i->second);
+      if (fclose(f) != 0) perror(("Error writing " + filename).c_str());
+    }
+};
@@ -186,6 +186,8 @@ class generate_c_il_c: public generate_c_base_and_typeid_c, il_default_variable_
 
     search_varfb_instance_type_c *search_varfb_instance_type;
     search_var_instance_decl_c   *search_var_instance_decl;
+    fb_eneno_usage_c             *fb_eneno_usage;
+    string_literal_pool_c        *string_literal_pool;
 
     symbol_c* current_array_type;
     symbol_c* current_param_type;
@@ -205,6 +207,8 @@ class generate_c_il_c: public generate_c_base_and_typeid_c, il_default_variable_
       search_fb_instance_decl    = new search_fb_instance_decl_c   (scope);
       search_varfb_instance_type = new search_varfb_instance_type_c(scope);
       search_var_instance_decl   = new search_var_instance_decl_c  (scope);
+      fb_eneno_usage             = new fb_eneno_usage_c            (scope);
+      string_literal_pool        = new string_literal_pool_c       (scope);
       
       current_operand = NULL;
       current_array_type = NULL;
@@ -219,6 +223,8 @@ class generate_c_il_c: public generate_c_base_and_typeid_c, il_default_variable_
       delete search_fb_instance_decl;
       delete search_varfb_instance_type;
       delete search_var_instance_decl;
+      delete fb_eneno_usage;
+      delete string_literal_pool;
     }
 
     void generate(instruction_list_c *il) {
@@ -352,6 +358,22 @@ class generate_c_il_c: public generate_c_base_and_typeid_c, il_default_variable_
 
     void *print_getter(symbol_c *symbol) {
       unsigned int vartype = search_var_instance_decl->get_vartype(symbol);
+      if ((vartype == search_var_instance_decl_c::external_vt) && (wanted_variablegeneration != fparam_output_vg)) {
+        const direct_global_t *global = get_direct_global(symbol);
+        if (NULL != global) {
+          /* access the global directly, instead of through the pointer in the VAR_EXTERNAL */
+          variablegeneration_t old_wanted_variablegeneration = wanted_variablegeneration;
+          s4o.print(GET_VAR);
+          s4o.print("(");
+          s4o.print(global->c_name);
+          s4o.print(",");
+          wanted_variablegeneration = complextype_suffix_vg;
+          symbol->accept(*this);
+          s4o.print(")");
+          wanted_variablegeneration = old_wanted_variablegeneration;
+          return NULL;
+        }
+      }
       if (wanted_variablegeneration == fparam_output_vg) {
         if (vartype == search_var_instance_decl_c::external_vt) {
           if (!get_datatype_info_c::is_type_valid    (symbol->datatype)) ERROR;
@@ -482,6 +504,16 @@ void *visit(il_default_variable_c *symbol) {
 }
 
 
+/*******************************/
+/* B.1.2.2   Character Strings */
+/*******************************/
+void *visit(single_byte_character_string_c *symbol) {
+  /* use the constant declared at the start of the C function with the POU code (see string_literal_pool_c) */
+  if (string_literal_pool->print_literal(s4o, symbol)) return NULL;
+  return generate_c_base_c::visit(symbol);
+}
+
+
 private:
 
 
@@ -521,6 +553,11 @@ void *visit(symbolic_variable_c *symbol) {
     case complextype_suffix_vg:
       break;
     default:
+      /* reads of CONSTANT variables are replaced by their value, as in ST */
+      if ((wanted_variablegeneration == expression_vg) &&
+          (search_var_instance_decl->get_option(symbol) == search_var_instance_decl_c::constant_opt) &&
+          print_folded_value(symbol))
+        break;
       if (this->is_variable_prefix_null()) {
         vartype = search_var_instance_decl->get_vartype(symbol);
         if (wanted_variablegeneration == fparam_output_vg) {
@@ -660,11 +697,7 @@ void *visit(subscript_list_c *symbol) {
     symbol_c* dimension = array_dimension_iterator->next();
     if (dimension == NULL) ERROR;
 
-    s4o.print("[(");
-    symbol->get_element(i)->accept(*this);
-    s4o.print(") - (");
-    dimension->accept(*this);
-    s4o.print(")]");
+    print_subscript(symbol->get_element(i), dimension);
   }
   delete array_dimension_iterator;
   return NULL;
@@ -733,6 +766,9 @@ void *visit(il_instruction_c *symbol) {
     s4o.print(s4o.indent_spaces);
   }
 
+  /* after the label, so the jumps to it are counted too */
+  print_stmt_counter(symbol);
+
   if (NULL != symbol->il_instruction) {
     symbol->il_instruction->accept(*this);
   }  
@@ -910,7 +946,7 @@ void *visit(il_function_call_c *symbol) {
       print_function_parameter_data_types_c overloaded_func_suf(&s4o);
       f_decl->accept(overloaded_func_suf);
     }
-    s4o.print(fcall_number);
+    s4o.print((0 != inline_fcall_number.get(symbol))? inline_fcall_number.get(symbol) : fcall_number);
   }
   else {
     if (function_name != NULL) {
@@ -924,6 +960,7 @@ void *visit(il_function_call_c *symbol) {
     }
     if (function_type_suffix != NULL)
       function_type_suffix->accept(*this);
+    print_fixed_arity_suffix(function_name, found_first_extensible_parameter? symbol->extensible_param_count : 0);
   }
   s4o.print("(");
   s4o.indent_right();
@@ -1072,15 +1109,8 @@ void *visit(il_fb_call_c *symbol) {
   for(int i = 1; (param_name = fp_iterator.next()) != NULL; i++) {
     function_param_iterator_c::param_direction_t param_direction = fp_iterator.param_direction();
 
-    /* Get the value from a foo(<param_name> = <param_value>) style call */
-    symbol_c *param_value = function_call_param_iterator.search_f(param_name);
-
-    /* Get the value from a foo(<param_value>) style call */
-    /* When using the informal invocation style, user can not pass values to EN or ENO parameters if these
-     * were implicitly defined!
-     */
-    if ((param_value == NULL) && !fp_iterator.is_en_eno_param_implicit())
-      param_value = function_call_param_iterator.next_nf();
+    /* Get the value from a foo(<param_name> = <param_value>) or a foo(<param_value>) style call */
+    symbol_c *param_value = function_call_param_iterator.next_param_value(param_name->value, fp_iterator.is_en_eno_param_implicit());
 
     /* We do not yet support embedded IL lists, so we abort the compiler if we find one */
     {simple_instr_list_c *instruction_list = dynamic_cast<simple_instr_list_c *>(param_value);
@@ -1110,7 +1140,10 @@ void *visit(il_fb_call_c *symbol) {
 
   /* now call the function... */
   function_block_type_name->accept(*this);
-  s4o.print(FB_FUNCTION_SUFFIX);
+  if (fb_eneno_usage->is_eneno_unused(symbol->fb_name, fb_decl))
+    s4o.print(FB_NOENENO_FUNCTION_SUFFIX);
+  else
+    s4o.print(FB_FUNCTION_SUFFIX);
   s4o.print("(");
   if (search_var_instance_decl->get_vartype(symbol->fb_name) != search_var_instance_decl_c::external_vt)
     s4o.print("&");
@@ -1126,15 +1159,8 @@ void *visit(il_fb_call_c *symbol) {
   for(int i = 1; (param_name = fp_iterator.next()) != NULL; i++) {
     function_param_iterator_c::param_direction_t param_direction = fp_iterator.param_direction();
 
-    /* Get the value from a foo(<param_name> = <param_value>) style call */
-    symbol_c *param_value = function_call_param_iterator.search_f(param_name);
-
-    /* Get the value from a foo(<param_value>) style call */
-    /* When using the informal invocation style, user can not pass values to EN or ENO parameters if these
-     * were implicitly defined!
-     */
-    if ((param_value == NULL) && !fp_iterator.is_en_eno_param_implicit())
-      param_value = function_call_param_iterator.next_nf();
+    /* Get the value from a foo(<param_name> = <param_value>) or a foo(<param_value>) style call */
+    symbol_c *param_value = function_call_param_iterator.next_param_value(param_name->value, fp_iterator.is_en_eno_param_implicit());
 
     /* now output the value assignment */
     if (param_value != NULL)
@@ -1231,21 +1257,8 @@ void *visit(il_formal_funct_call_c *symbol) {
 
     symbol_c *param_value = NULL;
 
-    /* Get the value from a foo(<param_name> = <param_value>) style call */
-    if (param_value == NULL)
-      param_value = function_call_param_iterator.search_f(param_name);
-
-    /* Get the value from a foo(<param_value>) style call */
-    /* NOTE: the following line of code is not required in this case, but it doesn't
-     * harm to leave it in, as in the case of a formal syntax function call,
-     * it will always return NULL.
-     * We leave it in in case we later decide to merge this part of the code together
-     * with the function calling code in generate_c_st_c, which does require
-     * the following line...
-     */
-    if ((param_value == NULL) && !fp_iterator.is_en_eno_param_implicit()) {
-      param_value = function_call_param_iterator.next_nf();
-    }
+    /* Get the value from a foo(<param_name> = <param_value>) or a foo(<param_value>) style call */
+    param_value = function_call_param_iterator.next_param_value(param_name->value, fp_iterator.is_en_eno_param_implicit());
     
     /* if no more parameter values in function call, and the current parameter
      * of the function declaration is an extensible parameter, we
@@ -1269,7 +1282,7 @@ void *visit(il_formal_funct_call_c *symbol) {
     ADD_PARAM_LIST(param_name, param_value, param_type, fp_iterator.param_direction())
   }
   
-  if (function_call_param_iterator.next_nf() != NULL) ERROR;
+  if (!function_call_param_iterator.is_bound() && (function_call_param_iterator.next_nf() != NULL)) ERROR;
 
   bool has_output_params = false;
 
@@ -1317,7 +1330,7 @@ void *visit(il_formal_funct_call_c *symbol) {
       print_function_parameter_data_types_c overloaded_func_suf(&s4o);
       f_decl->accept(overloaded_func_suf);
     }
-    s4o.print(fcall_number);
+    s4o.print((0 != inline_fcall_number.get(symbol))? inline_fcall_number.get(symbol) : fcall_number);
   }
   else {
     if (function_name != NULL) {
@@ -1331,6 +1344,7 @@ void *visit(il_formal_funct_call_c *symbol) {
     }  
     if (function_type_suffix != NULL)
       function_type_suffix->accept(*this);
+    print_fixed_arity_suffix(function_name, found_first_extensible_parameter? symbol->extensible_param_count : 0);
   }
   s4o.print("(");
   s4o.indent_right();
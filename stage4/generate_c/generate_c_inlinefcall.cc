@@ -58,6 +58,9 @@ class generate_c_inlinefcall_c: public generate_c_base_and_typeid_c {
 
     variablegeneration_t wanted_variablegeneration;
 
+    /* The inline functions already generated for this POU (their code, without their number), and their number */
+    std::map<std::string, int> inline_functions;
+
   public:
     generate_c_inlinefcall_c(stage4out_c *s4o_ptr, symbol_c *name, symbol_c *scope, const char *variable_prefix = NULL)
     : generate_c_base_and_typeid_c(s4o_ptr),
@@ -88,11 +91,17 @@ class generate_c_inlinefcall_c: public generate_c_base_and_typeid_c {
 
 
 
-    void generate_inline(symbol_c *function_name,
+    /* Print the inline function for a call (fcall) to a function with output parameters. When this POU already has an
+     * identical one (i.e. for a call to the same function, with the output parameters bound to the same variables),
+     * the call uses that one instead (see inline_fcall_number).
+     */
+    void generate_inline(symbol_c *fcall,
+            symbol_c *function_name,
             symbol_c *function_type_prefix,
             symbol_c *function_type_suffix,
             std::list<FUNCTION_PARAM*> param_list,
-            function_declaration_c *f_decl = NULL) {
+            function_declaration_c *f_decl = NULL,
+            int extensible_param_count = 0) {
 
       std::list<FUNCTION_PARAM*>::iterator pt;
       generating_inlinefunction = true;
@@ -104,6 +113,7 @@ class generate_c_inlinefcall_c: public generate_c_base_and_typeid_c {
       }
 
       s4o.print(s4o.indent_spaces);
+      s4o.begin_capture();
       s4o.print("static inline ");      
       function_type_prefix->accept(*this);
       s4o.print(" __");
@@ -119,7 +129,8 @@ class generate_c_inlinefcall_c: public generate_c_base_and_typeid_c {
       if (function_type_suffix) {
         function_type_suffix->accept(*this);
       }
-      s4o.print(fcall_number);
+      std::string name = s4o.end_capture();
+      s4o.begin_capture();
       s4o.print("(");
       s4o.indent_right();
 
@@ -172,6 +183,7 @@ class generate_c_inlinefcall_c: public generate_c_base_and_typeid_c {
 
       if (function_type_suffix)
         function_type_suffix->accept(*this);
+      print_fixed_arity_suffix(function_name, extensible_param_count);
       s4o.print("(");
       s4o.indent_right();
 
@@ -206,6 +218,18 @@ class generate_c_inlinefcall_c: public generate_c_base_and_typeid_c {
 
       s4o.indent_left();
       s4o.print(s4o.indent_spaces + "}\n\n");
+      std::string code = name + s4o.end_capture();
+
+      std::map<std::string, int>::iterator previous = inline_functions.find(code);
+      if ((previous != inline_functions.end()) && s4o.is_output_enabled()) {
+        inline_fcall_number.set(fcall, previous->second);
+      } else {
+        inline_functions[code] = fcall_number;
+        inline_fcall_number.set(fcall, fcall_number);
+        s4o.print(name);
+        s4o.print(fcall_number);
+        s4o.print(code.substr(name.size()));
+      }
 
       generating_inlinefunction = false;
     }
@@ -562,7 +586,8 @@ class generate_c_inlinefcall_c: public generate_c_base_and_typeid_c {
         f_decl = NULL; 
 
       if (has_output_params)
-        generate_inline(function_name, function_type_prefix, function_type_suffix, param_list, f_decl);
+        generate_inline(symbol, function_name, function_type_prefix, function_type_suffix, param_list, f_decl,
+                        found_first_extensible_parameter? symbol->extensible_param_count : 0);
 
       CLEAR_PARAM_LIST()
       return NULL;
@@ -665,21 +690,8 @@ class generate_c_inlinefcall_c: public generate_c_base_and_typeid_c {
       
         symbol_c *param_value = NULL;
       
-        /* Get the value from a foo(<param_name> = <param_value>) style call */
-        if (param_value == NULL)
-          param_value = function_call_param_iterator.search_f(param_name);
-      
-        /* Get the value from a foo(<param_value>) style call */
-        /* NOTE: the following line of code is not required in this case, but it doesn't
-         * harm to leave it in, as in the case of a formal syntax function call,
-         * it will always return NULL.
-         * We leave it in in case we later decide to merge this part of the code together
-         * with the function calling code in generate_c_st_c, which does require
-         * the following line...
-         */
-        if ((param_value == NULL) && !fp_iterator.is_en_eno_param_implicit()) {
-          param_value = function_call_param_iterator.next_nf();
-        }
+        /* Get the value from a foo(<param_name> = <param_value>) or a foo(<param_value>) style call */
+        param_value = function_call_param_iterator.next_param_value(param_name->value, fp_iterator.is_en_eno_param_implicit());
         
         /* if no more parameter values in function call, and the current parameter
          * of the function declaration is an extensible parameter, we
@@ -703,7 +715,7 @@ class generate_c_inlinefcall_c: public generate_c_base_and_typeid_c {
         ADD_PARAM_LIST(param_name, param_value, param_type, fp_iterator.param_direction())
       }
 
-      if (function_call_param_iterator.next_nf() != NULL) ERROR;
+      if (!function_call_param_iterator.is_bound() && (function_call_param_iterator.next_nf() != NULL)) ERROR;
 
       bool has_output_params = false;
 
@@ -724,7 +736,8 @@ class generate_c_inlinefcall_c: public generate_c_base_and_typeid_c {
         f_decl = NULL; 
 
       if (has_output_params)
-        generate_inline(function_name, function_type_prefix, function_type_suffix, param_list, f_decl);
+        generate_inline(symbol, function_name, function_type_prefix, function_type_suffix, param_list, f_decl,
+                        found_first_extensible_parameter? symbol->extensible_param_count : 0);
 
       CLEAR_PARAM_LIST()
       return NULL;
@@ -839,14 +852,8 @@ class generate_c_inlinefcall_c: public generate_c_base_and_typeid_c {
 
         symbol_c *param_value = NULL;
     
-        /* Get the value from a foo(<param_name> = <param_value>) style call */
-        if (param_value == NULL)
-          param_value = function_call_param_iterator.search_f(param_name);
-
-        /* Get the value from a foo(<param_value>) style call */
-        if ((param_value == NULL) && !fp_iterator.is_en_eno_param_implicit()) {
-          param_value = function_call_param_iterator.next_nf();
-        }
+        /* Get the value from a foo(<param_name> = <param_value>) or a foo(<param_value>) style call */
+        param_value = function_call_param_iterator.next_param_value(param_name->value, fp_iterator.is_en_eno_param_implicit());
         
         /* if no more parameter values in function call, and the current parameter
          * of the function declaration is an extensible parameter, we
@@ -866,7 +873,7 @@ class generate_c_inlinefcall_c: public generate_c_base_and_typeid_c {
       } /* for(...) */
       // symbol->parameter_assignment->accept(*this);
 
-      if (function_call_param_iterator.next_nf() != NULL) ERROR;
+      if (!function_call_param_iterator.is_bound() && (function_call_param_iterator.next_nf() != NULL)) ERROR;
 
       bool has_output_params = false;
 
@@ -887,7 +894,8 @@ class generate_c_inlinefcall_c: public generate_c_base_and_typeid_c {
         f_decl = NULL; 
 
       if (has_output_params)
-        generate_inline(function_name, function_type_prefix, function_type_suffix, param_list, f_decl);
+        generate_inline(symbol, function_name, function_type_prefix, function_type_suffix, param_list, f_decl,
+                        found_first_extensible_parameter? symbol->extensible_param_count : 0);
 
       CLEAR_PARAM_LIST()
 
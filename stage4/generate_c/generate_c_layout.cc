@@ -0,0 +1,275 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+
+/*
+ * The layout descriptors of the FB and PROGRAM instances (iec2c -O L), used by the runtime to
+ * migrate the state of the PLC to a new version of the program (online change, see
+ * lib/C/iec_online_change.h).
+ *
+ * For every FUNCTION_BLOCK and PROGRAM, the .c file gets a table with an entry for each variable of
+ * its instances (name, type, offset, size, and whether it is a value, an FB instance, or a pointer),
+ * and a <pou_name>_layout__ pointing to it, declared in the .h file.
+ *
+ * The version of a layout is a hash of the name, type and kind of each of its variables. The entries
+ * of the variables of a derived datatype (ARRAY, STRUCT, enumeration, ...) also have a hash of the
+ * declaration of the datatype, so a variable keeps its initial value when its type was changed,
+ * even if it kept its name and size.
+ *
+ * The internal variables of the SFCs (the state of the steps and actions) are not described: after an
+ * online change, the SFCs start again from their initial step.
+ */
+
+
+/* A stage4out_c that keeps what is printed, instead of writing it out */
+class stage4out_string_c: public stage4out_c {
+  public:
+    stage4out_string_c(void) {buffer_limit = (size_t)-1;}
+    ~stage4out_string_c(void) {buffer.clear();}
+
+    std::string get(void) {std::string value; value.swap(buffer); return value;}
+};
+
+
+/* The user FUNCTION_BLOCKs, i.e. those that have a layout (the standard FBs do not) */
+static std::set<std::string> layout_fb_types;
+
+
+class generate_c_layout_c: public iterator_visitor_c {
+  public:
+    typedef enum {
+      value_lk,    /* __LAYOUT_VALUE   */
+      fb_lk,       /* __LAYOUT_FB      */
+      pointer_lk   /* __LAYOUT_POINTER */
+    } layoutkind_t;
+
+    typedef struct {
+      std::string  name;
+      std::string  type;
+      layoutkind_t kind;
+      uint64_t     type_hash;
+      bool         is_fb;     /* of a FUNCTION_BLOCK type (also for the pointers) */
+      bool         retain;    /* declared RETAIN */
+      bool         located;   /* a pointer to a located variable, i.e. to the memory of the runtime */
+      bool         named;     /* false for a located global variable declared with only its location */
+    } field_t;
+
+  private:
+    std::vector<field_t> fields;
+    bool retain;              /* declaring RETAIN variables */
+
+    stage4out_string_c           str_s4o;
+    generate_c_base_and_typeid_c print_base;
+
+    std::string to_string(symbol_c *symbol) {
+      symbol->accept(print_base);
+      return str_s4o.get();
+    }
+
+    /* The type of the variables, as generate_c_vardecl_c declares them (see update_type_init() there) */
+    static symbol_c *get_type(symbol_c *spec_init) {
+      symbol_c *type = spec_init_sperator_c::get_spec(spec_init);
+      if (NULL == type) ERROR;
+      if (NULL == type->datatype) ERROR;
+      if (get_datatype_info_c::is_array(type)) type = type->datatype;
+      return type;
+    }
+
+    void add_field(symbol_c *name, symbol_c *type, layoutkind_t kind, bool located = false) {
+      field_t field;
+      field.name      = to_string(name);
+      field.type      = to_string(type);
+      field.kind      = kind;
+      field.type_hash = 0;
+      field.is_fb     = get_datatype_info_c::is_function_block(type);
+      field.retain    = retain;
+      field.located   = located;
+      field.named     = true;
+      symbol_c *type_decl = search_base_type_c::get_basetype_decl(type);
+      if ((value_lk == kind) && (NULL != type_decl) && !get_datatype_info_c::is_ANY_ELEMENTARY(type)) {
+        pou_fingerprint_c fingerprint(false);
+        type_decl->accept(fingerprint);
+        field.type_hash = fingerprint.get();
+      }
+      fields.push_back(field);
+    }
+
+    void add_fields(symbol_c *var_list, symbol_c *spec_init) {
+      list_c *list = dynamic_cast<list_c *>(var_list);
+      if (NULL == list) ERROR;
+      symbol_c *type = get_type(spec_init);
+      layoutkind_t kind = get_datatype_info_c::is_function_block(type)? fb_lk : value_lk;
+      for (int i = 0; i < list->n; i++) add_field(list->get_element(i), type, kind);
+    }
+
+    uint64_t version(void) {
+      pou_fingerprint_c fingerprint(false);
+      for (unsigned int i = 0; i < fields.size(); i++) {
+        fingerprint.add(fields[i].name.c_str());
+        fingerprint.add(fields[i].type.c_str());
+        fingerprint.add((int64_t)fields[i].kind);
+        fingerprint.add((int64_t)fields[i].type_hash);
+      }
+      return fingerprint.get();
+    }
+
+    generate_c_layout_c(void): print_base(&str_s4o) {retain = false;}
+
+    void *visit_section(symbol_c *option, symbol_c *list) {
+      retain = (NULL != dynamic_cast<retain_option_c *>(option));
+      list->accept(*this);
+      retain = false;
+      return NULL;
+    }
+
+  public:
+    /* The variables of a FB or PROGRAM instance (or the global variables), in the order they are declared */
+    static std::vector<field_t> get_fields(symbol_c *var_declarations) {
+      generate_c_layout_c layout;
+      var_declarations->accept(layout);
+      return layout.fields;
+    }
+
+    /* Called for every user FUNCTION_BLOCK, before any code using it is generated */
+    static void add_fb_type(symbol_c *fb_name) {
+      generate_c_layout_c layout;
+      layout_fb_types.insert(layout.to_string(fb_name));
+    }
+
+    /* Print the declaration (in the .h file) or the definition (in the .c file) of the layout of a FB or PROGRAM */
+    static void generate(stage4out_c &s4o, symbol_c *pou_name, symbol_c *var_declarations, bool print_declaration) {
+      generate_c_base_and_typeid_c print_base(&s4o);
+      if (print_declaration) {
+        /* NOTE: not static with amalgamate__, see __LAYOUT_GLOBAL_FB() in iec_online_change.h */
+        s4o.print("extern const __layout_t ");
+        pou_name->accept(print_base);
+        s4o.print("_layout__;\n\n");
+        return;
+      }
+
+      generate_c_layout_c layout;
+      layout.fields = get_fields(var_declarations);
+      const char *kinds[] = {"__LAYOUT_VALUE", "__LAYOUT_FB", "__LAYOUT_POINTER"};
+
+      /* the table of the variables... */
+      s4o.print("// Layout of the instances, for the online change (see iec_online_change.h)\n");
+      if (layout.fields.size() > 0) {
+        s4o.print("static const __layout_field_t __layout_fields__");
+        pou_name->accept(print_base);
+        s4o.print("[] = {\n");
+        for (unsigned int i = 0; i < layout.fields.size(); i++) {
+          field_t &field = layout.fields[i];
+          s4o.print("  __LAYOUT_FIELD(");
+          pou_name->accept(print_base);
+          s4o.print(", " + field.name + ", \"" + field.type + "\", " + kinds[field.kind] + ", ");
+          s4o.print_long_long_integer(field.type_hash);
+          if ((fb_lk == field.kind) && (layout_fb_types.count(field.type) > 0))
+            s4o.print(", &" + field.type + "_layout__),\n");
+          else
+            s4o.print(", NULL),\n");
+        }
+        s4o.print("};\n");
+      }
+
+      /* ... and the layout itself */
+      s4o.print("const __layout_t ");
+      pou_name->accept(print_base);
+      s4o.print("_layout__ = {\"");
+      pou_name->accept(print_base);
+      s4o.print("\", ");
+      s4o.print_long_long_integer(layout.version());
+      s4o.print(", sizeof(");
+      pou_name->accept(print_base);
+      s4o.print("), ");
+      s4o.print((unsigned long)layout.fields.size());
+      if (layout.fields.size() > 0) {
+        s4o.print(", __layout_fields__");
+        pou_name->accept(print_base);
+      } else {
+        s4o.print(", NULL");
+      }
+      s4o.print("};\n\n");
+    }
+
+  private:
+/******************************************/
+/* B 1.4.3 - Declaration & Initialisation */
+/******************************************/
+    void *visit(input_declarations_c *symbol)          {return visit_section(symbol->option, symbol->input_declaration_list);}
+    void *visit(output_declarations_c *symbol)         {return visit_section(symbol->option, symbol->var_init_decl_list);}
+    void *visit(var_declarations_c *symbol)            {return visit_section(symbol->option, symbol->var_init_decl_list);}
+    void *visit(located_var_declarations_c *symbol)    {return visit_section(symbol->option, symbol->located_var_decl_list);}
+    void *visit(global_var_declarations_c *symbol)     {return visit_section(symbol->option, symbol->global_var_decl_list);}
+    void *visit(retentive_var_declarations_c *symbol)  {
+      retain = true;
+      symbol->var_init_decl_list->accept(*this);
+      retain = false;
+      return NULL;
+    }
+
+    /* The EN and ENO of a FB */
+    void *visit(en_param_declaration_c *symbol)  {add_field(symbol->name, get_type(symbol->type_decl), value_lk); return NULL;}
+    void *visit(eno_param_declaration_c *symbol) {add_field(symbol->name, get_type(symbol->type),      value_lk); return NULL;}
+
+    void *visit(var1_init_decl_c *symbol)             {add_fields(symbol->var1_list,    symbol->spec_init);             return NULL;}
+    void *visit(array_var_init_decl_c *symbol)        {add_fields(symbol->var1_list,    symbol->array_spec_init);       return NULL;}
+    void *visit(structured_var_init_decl_c *symbol)   {add_fields(symbol->var1_list,    symbol->initialized_structure); return NULL;}
+    void *visit(array_var_declaration_c *symbol)      {add_fields(symbol->var1_list,    symbol->array_specification);   return NULL;}
+    void *visit(structured_var_declaration_c *symbol) {add_fields(symbol->var1_list,    symbol->structure_type_name);   return NULL;}
+    void *visit(fb_name_decl_c *symbol)               {add_fields(symbol->fb_name_list, symbol->fb_spec_init);          return NULL;}
+
+    /* The located variables point to the memory of the runtime */
+    void *visit(located_var_decl_c *symbol) {
+      add_field((NULL != symbol->variable_name)? symbol->variable_name : symbol->location,
+                get_type(symbol->located_var_spec_init), pointer_lk, true);
+      return NULL;
+    }
+
+    /* The global variables (not used for the layouts of the POUs, see __LAYOUT_GLOBAL() in iec_online_change.h) */
+    void *visit(global_var_decl_c *symbol) {
+      global_var_spec_c *located = dynamic_cast<global_var_spec_c *>(symbol->global_var_spec);
+      if (NULL == located) {add_fields(symbol->global_var_spec, symbol->type_specification); return NULL;}
+      add_field((NULL != located->global_var_name)? located->global_var_name : located->location,
+                get_type(symbol->type_specification), pointer_lk, true);
+      fields.back().named = (NULL != located->global_var_name);
+      return NULL;
+    }
+
+    /* The VAR_EXTERNAL point to the global variables */
+    void *visit(external_declaration_c *symbol) {
+      add_field(symbol->global_var_name, get_type(symbol->specification), pointer_lk);
+      return NULL;
+    }
+
+    /* generate_c_vardecl_c does not declare these either */
+    void *visit(incompl_located_var_declarations_c *symbol) {return NULL;}
+};
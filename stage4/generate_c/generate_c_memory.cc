@@ -0,0 +1,202 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+
+/*
+ * The memory report (iec2c -O M): MEMORY_REPORT.c, with tables of the variables of every
+ * FUNCTION_BLOCK and PROGRAM, of the global variables, and of the PROGRAM instances of each
+ * resource (see lib/C/iec_memory_report.h).
+ *
+ * iec2c does not know the size of the C types on the target, so the tables only hold the names of
+ * the variables and their types: the sizes and offsets are given by sizeof() and offsetof() in the
+ * C code, i.e. by the C compiler that compiles MEMORY_REPORT.c, for its target ABI.
+ *
+ * The variables are found by generate_c_layout_c, so they are those of the layout descriptors of
+ * the online change (iec2c -O L).
+ */
+
+
+class generate_c_memory_c: public iterator_visitor_c {
+  private:
+    typedef generate_c_layout_c::field_t field_t;
+
+    std::string types;      /* the entries of the tables, in the order they are found */
+    std::string type_vars;
+    std::string globals;
+    std::string instances;
+
+    std::string current_domain;    /* the name of the configuration or resource declaring the global variables */
+    std::string current_resource;  /* empty for the configuration */
+
+    stage4out_string_c           str_s4o;
+    generate_c_base_and_typeid_c print_base;
+
+    std::string to_string(symbol_c *symbol) {
+      symbol->accept(print_base);
+      return str_s4o.get();
+    }
+
+    std::string resource_str(void) {
+      return current_resource.empty()? "NULL" : "\"" + current_resource + "\"";
+    }
+
+    void add_globals(symbol_c *global_var_declarations) {
+      if (NULL == global_var_declarations) return;
+      std::vector<field_t> fields = generate_c_layout_c::get_fields(global_var_declarations);
+      for (unsigned int i = 0; i < fields.size(); i++) {
+        field_t &field = fields[i];
+        std::string retain = field.retain? "1" : "0";
+        if      (!field.named)
+          globals += "  __MEMORY_GLOBAL_LOCATION(" + resource_str() + ", " + field.name + ", " + field.type + "),\n";
+        else if (field.located)
+          globals += "  __MEMORY_GLOBAL_LOCATED("  + resource_str() + ", " + current_domain + ", " + field.name + ", " + field.type + "),\n";
+        else if (field.is_fb)
+          globals += "  __MEMORY_GLOBAL_FB("       + resource_str() + ", " + current_domain + ", " + field.name + ", " + field.type + ", " + retain + "),\n";
+        else
+          globals += "  __MEMORY_GLOBAL("          + resource_str() + ", " + current_domain + ", " + field.name + ", " + field.type + ", " + retain + "),\n";
+      }
+    }
+
+  public:
+    generate_c_memory_c(void): print_base(&str_s4o) {}
+
+    /* Called for every user FUNCTION_BLOCK and PROGRAM */
+    void add_pou(const char *kind, symbol_c *pou_name, symbol_c *var_declarations) {
+      std::string name = to_string(pou_name);
+      std::vector<field_t> fields = generate_c_layout_c::get_fields(var_declarations);
+      if (fields.size() > 0) {
+        type_vars += "static const __memory_var_t __memory_vars__" + name + "[] = {\n";
+        for (unsigned int i = 0; i < fields.size(); i++) {
+          field_t &field = fields[i];
+          std::string retain = field.retain? "1" : "0";
+          if      (field.located)
+            type_vars += "  __MEMORY_LOCATED_VAR(" + name + ", " + field.name + ", " + field.type + "),\n";
+          else if (generate_c_layout_c::pointer_lk == field.kind)  /* VAR_EXTERNAL */
+            type_vars += std::string(field.is_fb? "  __MEMORY_FB_VAR(" : "  __MEMORY_VAR(") + name + ", " + field.name + ", " + field.type + ", __MEMORY_EXTERNAL, 0),\n";
+          else if (generate_c_layout_c::fb_lk == field.kind)
+            type_vars += "  __MEMORY_FB_VAR(" + name + ", " + field.name + ", " + field.type + ", __MEMORY_FB, " + retain + "),\n";
+          else
+            type_vars += "  __MEMORY_VAR("    + name + ", " + field.name + ", " + field.type + ", __MEMORY_VALUE, " + retain + "),\n";
+        }
+        type_vars += "};\n";
+      }
+      char count[32];
+      snprintf(count, sizeof(count), "%lu", (unsigned long)fields.size());
+      types += "  {\"" + name + "\", \"" + kind + "\", sizeof(" + name + "), " + count + ", "
+             + ((fields.size() > 0)? "__memory_vars__" + name : std::string("NULL")) + "},\n";
+    }
+
+    /* Print the MEMORY_REPORT.c file */
+    void generate(stage4out_c &s4o) {
+      s4o.print("/*******************************************/\n");
+      s4o.print("/*     FILE GENERATED BY iec2c             */\n");
+      s4o.print("/* Editing this file is not recommended... */\n");
+      s4o.print("/*******************************************/\n\n");
+      s4o.print("/* The memory used by the instances, as laid out by the C compiler (see iec_memory_report.h).\n");
+      s4o.print(" * Compile with MEMORY_REPORT_MAIN defined for a program writing the report to stdout.\n");
+      s4o.print(" */\n\n");
+      print_library_defines(s4o);
+      s4o.print("#include \"POUS.h\"\n");
+      s4o.print("#include \"iec_memory_report.h\"\n\n");
+
+      s4o.print(type_vars);
+      s4o.print("\nstatic const __memory_type_t __memory_types__[] = {\n");
+      s4o.print(types);
+      s4o.print("  {NULL}\n};\n\n");
+      s4o.print("static const __memory_var_t __memory_globals__[] = {\n");
+      s4o.print(globals);
+      s4o.print("  {NULL}\n};\n\n");
+      s4o.print("static const __memory_instance_t __memory_instances__[] = {\n");
+      s4o.print(instances);
+      s4o.print("  {NULL}\n};\n\n");
+
+      s4o.print("void __memory_report(FILE *file) {\n");
+      s4o.print("  __memory_report_json(file, __memory_types__, __memory_globals__, __memory_instances__);\n");
+      s4o.print("}\n\n");
+
+      s4o.print("#ifdef MEMORY_REPORT_MAIN\n");
+      s4o.print("/* the variables the standard library expects from the configuration (never used here) */\n");
+      if (resource_context__)
+        s4o.print("__thread __resource_context_t *__current_resource_context;\n");
+      else
+        s4o.print("TIME __CURRENT_TIME;\nBOOL __DEBUG;\n");
+      if (tick_timers__ && !resource_context__)
+        s4o.print("unsigned long long __CURRENT_TICK;\n");
+      if (tick_timers__)
+        s4o.print("unsigned long long common_ticktime__;\n");
+      if (timer_wheel__)
+        s4o.print("__timer_wheel_t __TIMER_WHEEL;\n");
+      s4o.print("\nint main(void) {\n");
+      s4o.print("  __memory_report(stdout);\n");
+      s4o.print("  return 0;\n");
+      s4o.print("}\n");
+      s4o.print("#endif\n");
+    }
+
+/********************************/
+/* B 1.7 Configuration elements */
+/********************************/
+    void *visit(configuration_declaration_c *symbol) {
+      current_domain = to_string(symbol->configuration_name);
+      current_resource.clear();
+      add_globals(symbol->global_var_declarations);
+      symbol->resource_declarations->accept(*this);
+      return NULL;
+    }
+
+    void *visit(resource_declaration_c *symbol) {
+      current_domain = current_resource = to_string(symbol->resource_name);
+      add_globals(symbol->global_var_declarations);
+      symbol->resource_declaration->accept(*this);
+      current_resource.clear();
+      return NULL;
+    }
+
+    /* the configuration with a single resource, that has no name */
+    void *visit(single_resource_declaration_c *symbol) {
+      bool unnamed = current_resource.empty();
+      if (unnamed) current_resource = "RESOURCE";
+      symbol->program_configuration_list->accept(*this);
+      if (unnamed) current_resource.clear();
+      return NULL;
+    }
+
+/*  PROGRAM [RETAIN | NON_RETAIN] program_name [WITH task_name] ':' program_type_name ['(' prog_conf_elements ')'] */
+//SYM_REF6(program_configuration_c, retain_option, program_name, task_name, program_type_name, prog_conf_elements, unused)
+    void *visit(program_configuration_c *symbol) {
+      std::string task = (NULL == symbol->task_name)? "NULL" : "\"" + to_string(symbol->task_name) + "\"";
+      std::string retain = (NULL != dynamic_cast<retain_option_c *>(symbol->retain_option))? "1" : "0";
+      instances += "  __MEMORY_INSTANCE(" + current_resource + ", " + to_string(symbol->program_name) + ", "
+                 + to_string(symbol->program_type_name) + ", " + task + ", " + retain + "),\n";
+      return NULL;
+    }
+};
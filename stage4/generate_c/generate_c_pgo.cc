@@ -0,0 +1,154 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+
+/*
+ * The profile of the statements executed by the PLC (iec2c -O P=<file>).
+ *
+ * The profile is the dump of the counters generated with -O C (see __stmt_counters_dump() in
+ * lib/C/iec_counters.h), i.e. a text file with one line per counter:
+ *     <file>:<line> <count>
+ * The counts of the same source line are added together.
+ *
+ * The code is then generated with:
+ *  - __LIKELY()/__UNLIKELY() on the conditions of the IF, ELSIF and CASE branches that are
+ *    (almost) always, or (almost) never taken. The number of times a branch was taken is the count
+ *    of its first statement;
+ *  - the ELSIF branches sorted by the number of times they were taken, when their conditions
+ *    may not be TRUE at the same time (see generate_c_st_c);
+ *  - __COLD_POU on the FUNCTIONs, FUNCTION_BLOCKs and PROGRAMs none of whose statements ever ran
+ *    (e.g. alarm handling and commissioning code), which gcc places in the .text.unlikely section,
+ *    and __HOT_POU on those that take a large share of the statements executed.
+ * The statements of a POU are those on the lines between its first and last line.
+ *
+ * NOTE: The profile only describes the source it was recorded with. The lines of the POUs that
+ *       were changed since, and of the statements sharing a line with the IF statement, are
+ *       ignored, or give worse hints.
+ */
+
+
+#include <fstream>
+
+
+/* the branches taken (or not taken) at most once in BRANCH_HINT_RATIO times get a hint */
+#define BRANCH_HINT_RATIO   20
+/* the branches reached fewer times do not get a hint */
+#define BRANCH_HINT_MIN     16
+/* the POUs that execute at least this share of all the statements (in %) are hot */
+#define HOT_POU_PERCENT      5
+
+
+class stmt_profile_c {
+  private:
+    typedef std::pair<std::string, long int> line_t;
+    std::map<line_t, unsigned long long> counts;
+    unsigned long long total;
+
+  public:
+    stmt_profile_c(void) {total = 0;}
+
+    bool load(const char *filename) {
+      std::ifstream file(filename);
+      std::string   line;
+      if (!file.is_open()) return false;
+      while (std::getline(file, line)) {
+        /* the file name may contain ':' and ' ', but not the line number and count */
+        size_t space = line.rfind(' ');
+        size_t colon = (space == std::string::npos)? std::string::npos : line.rfind(':', space);
+        if ((colon == std::string::npos) || (colon == 0)) continue;
+        long int           line_number = strtol  (line.c_str() + colon + 1, NULL, 10);
+        unsigned long long count       = strtoull(line.c_str() + space + 1, NULL, 10);
+        counts[line_t(line.substr(0, colon), line_number)] += count;
+        total += count;
+      }
+      return true;
+    }
+
+    /* The count of the line a statement starts on. Returns false if the line is not in the profile */
+    bool get_count(symbol_c *symbol, unsigned long long &count) {
+      if ((NULL == symbol) || (NULL == symbol->first_file)) return false;
+      std::map<line_t, unsigned long long>::iterator i = counts.find(line_t(symbol->first_file, symbol->first_line));
+      if (i == counts.end()) return false;
+      count = i->second;
+      return true;
+    }
+
+    /* The count of the first statement of a statement list, if it is not on the same line as the statement that contains the list */
+    bool get_first_count(symbol_c *statement_list, symbol_c *parent, unsigned long long &count) {
+      list_c *list = dynamic_cast<list_c *>(statement_list);
+      if ((NULL == list) || (list->n == 0)) return false;
+      symbol_c *first = list->get_element(0);
+      if ((NULL != parent) && (first->first_line == parent->first_line)) return false;
+      return get_count(first, count);
+    }
+
+    /* 1 if the branch is almost always taken, -1 if almost never, 0 if no hint */
+    static int branch_hint(unsigned long long taken, unsigned long long reached) {
+      if ((reached < BRANCH_HINT_MIN) || (taken > reached)) return 0;
+      if (taken * BRANCH_HINT_RATIO <= reached) return -1;
+      if ((reached - taken) * BRANCH_HINT_RATIO <= reached) return 1;
+      return 0;
+    }
+
+    /* 1 if the POU is hot, -1 if it is cold (none of its statements ran), 0 otherwise (or not in the profile) */
+    int pou_temperature(symbol_c *pou) {
+      if ((NULL == pou->first_file) || (0 == total)) return 0;
+      std::map<line_t, unsigned long long>::iterator i   = counts.lower_bound(line_t(pou->first_file, pou->first_line));
+      std::map<line_t, unsigned long long>::iterator end = counts.upper_bound(line_t(pou->first_file, pou->last_line));
+      if (i == end) return 0;
+      unsigned long long count = 0;
+      for (; i != end; i++) count += i->second;
+      if (0 == count) return -1;
+      if (count * 100 >= total * HOT_POU_PERCENT) return 1;
+      return 0;
+    }
+};
+
+
+static stmt_profile_c *stmt_profile__ = NULL;
+
+static bool load_stmt_profile(const char *filename) {
+  stmt_profile_c *profile = new stmt_profile_c();
+  if (!profile->load(filename)) {delete profile; return false;}
+  delete stmt_profile__;
+  stmt_profile__ = profile;
+  return true;
+}
+
+
+/* Print the condition of a branch, inside __LIKELY()/__UNLIKELY() if it has a hint */
+static void print_branch_condition(stage4out_c &s4o, visitor_c &visitor, symbol_c *condition, int hint) {
+  if      (hint > 0) s4o.print("__LIKELY(");
+  else if (hint < 0) s4o.print("__UNLIKELY(");
+  condition->accept(visitor);
+  if (hint != 0) s4o.print(")");
+}
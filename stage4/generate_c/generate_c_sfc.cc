@@ -60,6 +60,9 @@ class generate_c_sfc_elements_c: public generate_c_base_and_typeid_c {
     symbol_c *current_action;
 
     sfcgeneration_t wanted_sfcgeneration;
+
+    bool single_sequence; /* the SFC is lowered to a switch() on its active step (see generate_c_sfc_c::generate_single_sequence()) */
+    bool step_switch;     /* the action associations of each step are a case of a switch() on the step number */
     
   public:
     generate_c_sfc_elements_c(stage4out_c *s4o_ptr, symbol_c *name, symbol_c *scope, const char *variable_prefix = NULL)
@@ -69,6 +72,8 @@ class generate_c_sfc_elements_c: public generate_c_base_and_typeid_c {
       generate_c_code = new generate_c_SFC_IL_ST_c(s4o_ptr, name, scope, variable_prefix);
       search_var_instance_decl = new search_var_instance_decl_c(scope);
       this->set_variable_prefix(variable_prefix);
+      single_sequence = false;
+      step_switch = sfc_active_steps__;
     }
     
     ~generate_c_sfc_elements_c(void) {
@@ -89,6 +94,62 @@ class generate_c_sfc_elements_c: public generate_c_base_and_typeid_c {
 
     void reset_transition_number(void) {transition_number = 0;}
 
+    void set_single_sequence(bool single_sequence) {
+      this->single_sequence = single_sequence;
+      step_switch = single_sequence || sfc_active_steps__;
+    }
+
+    bool has_transitions(symbol_c *step_name) {
+      std::list<TRANSITION>::iterator pt;
+      for(pt = transition_list.begin(); pt != transition_list.end(); pt++)
+        if (0 == compare_identifiers(sfc_single_step(pt->symbol->from_steps), step_name)) return true;
+      return false;
+    }
+
+    /* Print the tests of the transitions from a step of a single sequence, in the order they are tested by the
+     * generic code (i.e. by priority). The first one that fires clears the transitions tested after it, moves
+     * the active step to the step it goes to, and leaves the switch() on the active step.
+     */
+    void print_step_transitions(symbol_c *step_name) {
+      std::list<TRANSITION>::iterator pt, next;
+      wanted_sfcgeneration = transitiontest_sg;
+      for(pt = transition_list.begin(); pt != transition_list.end(); pt++) {
+        if (0 != compare_identifiers(sfc_single_step(pt->symbol->from_steps), step_name)) continue;
+        symbol_c *to_step = sfc_single_step(pt->symbol->to_steps);
+        transition_number = pt->index;
+        pt->symbol->transition_condition->accept(*this);
+        s4o.print(s4o.indent_spaces + "if (");
+        s4o.print(GET_VAR);
+        s4o.print("(");
+        print_variable_prefix();
+        s4o.print("__transition_list[");
+        print_transition_number();
+        s4o.print("])) {\n");
+        s4o.indent_right();
+        for(next = pt, next++; next != transition_list.end(); next++) {
+          if (0 != compare_identifiers(sfc_single_step(next->symbol->from_steps), step_name)) continue;
+          s4o.print(s4o.indent_spaces);
+          s4o.print(SET_VAR);
+          s4o.print("(");
+          print_variable_prefix();
+          s4o.print(",__transition_list[");
+          s4o.print(next->index);
+          s4o.print("],,0);\n");
+        }
+        print_reset_step(step_name);
+        print_set_step(to_step);
+        s4o.print(s4o.indent_spaces);
+        print_variable_prefix();
+        s4o.print("__current_step = ");
+        s4o.print(SFC_STEP_ACTION_PREFIX);
+        to_step->accept(*this);
+        s4o.print(";\n");
+        s4o.print(s4o.indent_spaces + "break;\n");
+        s4o.indent_left();
+        s4o.print(s4o.indent_spaces + "}\n");
+      }
+    }
+
     void generate(symbol_c *symbol, sfcgeneration_t generation_type) {
       wanted_sfcgeneration = generation_type;
       switch (wanted_sfcgeneration) {
@@ -145,6 +206,17 @@ class generate_c_sfc_elements_c: public generate_c_base_and_typeid_c {
       s4o.print(",,1);\n" + s4o.indent_spaces);
       print_step_argument(step_name, "T.value");
       s4o.print(" = __time_to_timespec(1, 0, 0, 0, 0, 0);\n");
+      if (sfc_active_steps__ && !single_sequence) {
+        s4o.print(s4o.indent_spaces);
+        print_variable_prefix();
+        s4o.print("__active_steps[");
+        s4o.print(SFC_STEP_ACTION_PREFIX);
+        step_name->accept(*this);
+        s4o.print(" / 32] |= (DWORD)1 << (");
+        s4o.print(SFC_STEP_ACTION_PREFIX);
+        step_name->accept(*this);
+        s4o.print(" % 32);\n");
+      }
     }
     
 /*********************************************/
@@ -159,7 +231,15 @@ class generate_c_sfc_elements_c: public generate_c_base_and_typeid_c {
             symbol->step_name->accept(*this);
             s4o.print(" action associations\n");
             current_step = symbol->step_name;
-            s4o.print(s4o.indent_spaces + "{\n");
+            s4o.print(s4o.indent_spaces);
+            if (step_switch) {
+              /* we are inside the switch() on the number of the step (see generate_c_sfc_c) */
+              s4o.print("case ");
+              s4o.print(SFC_STEP_ACTION_PREFIX);
+              symbol->step_name->accept(*this);
+              s4o.print(": ");
+            }
+            s4o.print("{\n");
             s4o.indent_right();
             s4o.print(s4o.indent_spaces + "char active = ");
             s4o.print(GET_VAR);
@@ -173,6 +253,8 @@ class generate_c_sfc_elements_c: public generate_c_base_and_typeid_c {
             print_step_argument(current_step, "prev_state");
             s4o.print(";\n\n");
             symbol->action_association_list->accept(*this);
+            if (step_switch)
+              s4o.print(s4o.indent_spaces + "break;\n");
             s4o.indent_left();
             s4o.print(s4o.indent_spaces + "}\n\n");
           }
@@ -191,7 +273,15 @@ class generate_c_sfc_elements_c: public generate_c_base_and_typeid_c {
             symbol->step_name->accept(*this);
             s4o.print(" action associations\n");
             current_step = symbol->step_name;
-            s4o.print(s4o.indent_spaces + "{\n");
+            s4o.print(s4o.indent_spaces);
+            if (step_switch) {
+              /* we are inside the switch() on the number of the step (see generate_c_sfc_c) */
+              s4o.print("case ");
+              s4o.print(SFC_STEP_ACTION_PREFIX);
+              symbol->step_name->accept(*this);
+              s4o.print(": ");
+            }
+            s4o.print("{\n");
             s4o.indent_right();
             s4o.print(s4o.indent_spaces + "char active = ");
             s4o.print(GET_VAR);
@@ -205,6 +295,8 @@ class generate_c_sfc_elements_c: public generate_c_base_and_typeid_c {
             print_step_argument(current_step, "prev_state");
             s4o.print(";\n\n");
             symbol->action_association_list->accept(*this);
+            if (step_switch)
+              s4o.print(s4o.indent_spaces + "break;\n");
             s4o.indent_left();
             s4o.print(s4o.indent_spaces + "}\n\n");
           }
@@ -266,14 +358,16 @@ class generate_c_sfc_elements_c: public generate_c_base_and_typeid_c {
           s4o.print(s4o.indent_spaces + "}\n");
           s4o.print(s4o.indent_spaces + "else {\n");
           s4o.indent_right();
-          // Calculate transition value for debug
-          s4o.print(s4o.indent_spaces + "if (__DEBUG) {\n");
-          s4o.indent_right();
-          wanted_sfcgeneration = transitiontestdebug_sg;
-          symbol->transition_condition->accept(*this);
-          wanted_sfcgeneration = transitiontest_sg;
-          s4o.indent_left();
-          s4o.print(s4o.indent_spaces + "}\n");
+          if (!sfc_no_debug__) {
+            // Calculate transition value for debug
+            s4o.print(s4o.indent_spaces + "if (__DEBUG) {\n");
+            s4o.indent_right();
+            wanted_sfcgeneration = transitiontestdebug_sg;
+            symbol->transition_condition->accept(*this);
+            wanted_sfcgeneration = transitiontest_sg;
+            s4o.indent_left();
+            s4o.print(s4o.indent_spaces + "}\n");
+          }
           s4o.print(s4o.indent_spaces);
           s4o.print(SET_VAR);
           s4o.print("(");
@@ -361,7 +455,7 @@ class generate_c_sfc_elements_c: public generate_c_base_and_typeid_c {
             symbol->transition_condition_st->accept(*generate_c_st);
             s4o.print(");\n");
           }
-          if (wanted_sfcgeneration == transitiontest_sg) {
+          if ((wanted_sfcgeneration == transitiontest_sg) && !sfc_no_debug__) {
             s4o.print(s4o.indent_spaces + "if (__DEBUG) {\n");
             s4o.indent_right();
             s4o.print(s4o.indent_spaces);
@@ -701,182 +795,235 @@ class generate_c_sfc_c: public generate_c_base_and_typeid_c {
       return var_decl != NULL;
     }
 
-/*********************************************/
-/* B.1.6  Sequential function chart elements */
-/*********************************************/
-    
-    void *visit(sequential_function_chart_c *symbol) {
-      int i;
-      
-      generate_c_sfc_elements->reset_transition_number();
-      for(i = 0; i < symbol->n; i++) {
-        symbol->get_element(i)->accept(*this);
-        generate_c_sfc_elements->generate(symbol->get_element(i), generate_c_sfc_elements_c::transitionlist_sg);
+    /* Print the number of entries of one of the SFC tables (nb_name is __nb_steps, __nb_actions or __nb_transitions).
+     * Without the SFC debug tables (-O d), these are not stored in each instance, but taken from the size of the table.
+     */
+    void print_table_size(const char *nb_name) {
+      const char *table_name = (strcmp(nb_name, "__nb_steps"  ) == 0)? "__step_list"   :
+                               (strcmp(nb_name, "__nb_actions") == 0)? "__action_list" : "__transition_list";
+      if (!sfc_no_debug__) {
+        print_variable_prefix();
+        s4o.print(nb_name);
+        return;
       }
-      
-      s4o.print(s4o.indent_spaces +"INT i;\n");
-      s4o.print(s4o.indent_spaces +"TIME elapsed_time, current_time;\n\n");
-      
-      /* generate elapsed_time initializations */
-      s4o.print(s4o.indent_spaces + "// Calculate elapsed_time\n");
-      s4o.print(s4o.indent_spaces +"current_time = __CURRENT_TIME;\n");
-      s4o.print(s4o.indent_spaces +"elapsed_time = __time_sub(current_time, ");
+      s4o.print("(sizeof(");
       print_variable_prefix();
-      s4o.print("__lasttick_time);\n");
-      s4o.print(s4o.indent_spaces);
+      s4o.print(table_name);
+      s4o.print(") / sizeof(");
       print_variable_prefix();
-      s4o.print("__lasttick_time = current_time;\n");
-      
-      /* generate transition initializations */
-      s4o.print(s4o.indent_spaces + "// Transitions initialization\n");
-      s4o.print(s4o.indent_spaces + "if (__DEBUG) {\n");
+      s4o.print(table_name);
+      s4o.print("[0]))");
+    }
+
+    /* Returns true if the step has an action association that does something even when the step is neither
+     * active nor deactivated in the current scan (the P, P1 and P0 qualifiers reset the action, or variable).
+     */
+    bool is_always_handled(list_c *action_association_list) {
+      for (int i = 0; i < action_association_list->n; i++) {
+        action_association_c *association = dynamic_cast<action_association_c *>(action_association_list->get_element(i));
+        action_qualifier_c   *qualifier   = (NULL == association)? NULL : dynamic_cast<action_qualifier_c *>(association->action_qualifier);
+        token_c              *name        = (NULL == qualifier  )? NULL : dynamic_cast<token_c *>(qualifier->action_qualifier);
+        if (NULL == name) continue;
+        if ((strcmp(name->value, "P") == 0) || (strcmp(name->value, "P1") == 0) || (strcmp(name->value, "P0") == 0))
+          return true;
+      }
+      return false;
+    }
+
+    /* Print the loop that goes through the steps in the set of active steps (see sfc_active_steps__), in the
+     * order they are declared, with 'i' the step number, 'w' and 'j' the word and bit of the step in the set.
+     * When always_mask is not NULL, the steps in it are handled too. The caller must close the loop.
+     * For the single sequences (see generate_single_sequence()), the set is instead made of the steps in
+     * always_mask, the active step, and the step that was active at the start of the scan.
+     */
+    void print_active_steps_loop(std::vector<unsigned long> *always_mask = NULL, bool single_sequence = false) {
+      s4o.print(s4o.indent_spaces + "for (w = 0; w < (");
+      print_table_size("__nb_steps");
+      s4o.print(" + 31) / 32; w++) {\n");
       s4o.indent_right();
-      s4o.print(s4o.indent_spaces + "for (i = 0; i < ");
-      print_variable_prefix();
-      s4o.print("__nb_transitions; i++) {\n");
+      if (single_sequence) {
+        s4o.print(s4o.indent_spaces + "bits = __always_handled_steps[w];\n");
+        print_step_bit("__previous_step");
+        print_step_bit("__current_step");
+      } else {
+        s4o.print(s4o.indent_spaces + "bits = ");
+        print_variable_prefix();
+        s4o.print("__active_steps[w]");
+        if (NULL != always_mask) {
+          s4o.print(" | __always_handled_steps[w]");
+        }
+        s4o.print(";\n");
+      }
+      s4o.print(s4o.indent_spaces + "for (j = 0; bits != 0; j++, bits >>= 1) {\n");
       s4o.indent_right();
-      s4o.print(s4o.indent_spaces);
+      s4o.print(s4o.indent_spaces + "if (!(bits & 1)) continue;\n");
+      s4o.print(s4o.indent_spaces + "i = w * 32 + j;\n");
+    }
+
+    /* Add the step in the step number variable (__current_step or __previous_step) to the bits of word w */
+    void print_step_bit(const char *step_variable) {
+      s4o.print(s4o.indent_spaces + "if (w == ");
       print_variable_prefix();
-      s4o.print("__transition_list[i] = ");
+      s4o.print(step_variable);
+      s4o.print(" / 32) bits |= (DWORD)1 << (");
       print_variable_prefix();
-      s4o.print("__debug_transition_list[i];\n");
+      s4o.print(step_variable);
+      s4o.print(" % 32);\n");
+    }
+
+    void print_active_steps_loop_end(void) {
       s4o.indent_left();
       s4o.print(s4o.indent_spaces + "}\n");
       s4o.indent_left();
       s4o.print(s4o.indent_spaces + "}\n");
+    }
 
-      /* generate step initializations */
-      s4o.print(s4o.indent_spaces + "// Steps initialization\n");
-      s4o.print(s4o.indent_spaces + "for (i = 0; i < ");
-      print_variable_prefix();
-      s4o.print("__nb_steps; i++) {\n");
-      s4o.indent_right();
-      s4o.print(s4o.indent_spaces);
-      print_variable_prefix();
-      s4o.print("__step_list[i].prev_state = ");
-      s4o.print(GET_VAR);
-      s4o.print("(");
-      print_variable_prefix();
-      s4o.print("__step_list[i].X);\n");
-      s4o.print(s4o.indent_spaces + "if (");
-      s4o.print(GET_VAR);
-      s4o.print("(");
+    /* Fill in the set of the steps whose action associations are handled even when they are not active */
+    bool get_always_mask(sequential_function_chart_c *symbol, std::vector<unsigned long> &always_mask) {
+      int step_number = 0;
+      bool any = false;
+      for(int i = 0; i < symbol->n; i++) {
+        list_c *action_association_list = NULL;
+        initial_step_c *initial_step = dynamic_cast<initial_step_c *>(symbol->get_element(i));
+        step_c         *step         = dynamic_cast<step_c         *>(symbol->get_element(i));
+        if (NULL != initial_step) action_association_list = (list_c *)initial_step->action_association_list;
+        if (NULL != step)         action_association_list = (list_c *)step->action_association_list;
+        if ((NULL == initial_step) && (NULL == step)) continue;
+        if (always_mask.size() <= (unsigned)step_number / 32) always_mask.push_back(0);
+        if (is_always_handled(action_association_list)) {
+          always_mask[step_number / 32] |= 1UL << (step_number % 32);
+          any = true;
+        }
+        step_number++;
+      }
+      return any;
+    }
+
+    void print_always_mask(std::vector<unsigned long> &always_mask) {
+      s4o.print(s4o.indent_spaces +"UINT w, j;\n");
+      s4o.print(s4o.indent_spaces +"DWORD bits;\n");
+      s4o.print(s4o.indent_spaces +"static const DWORD __always_handled_steps[] = {");
+      for(unsigned int k = 0; k < always_mask.size(); k++) {
+        if (k != 0) s4o.print(", ");
+        s4o.print(always_mask[k]);
+      }
+      s4o.print("};\n");
+    }
+
+    /* The time elapsed since the previous scan */
+    void print_elapsed_time(void) {
+      s4o.print(s4o.indent_spaces + "// Calculate elapsed_time\n");
+      s4o.print(s4o.indent_spaces +"current_time = __CURRENT_TIME;\n");
+      s4o.print(s4o.indent_spaces +"elapsed_time = __time_sub(current_time, ");
       print_variable_prefix();
-      s4o.print("__step_list[i].X)) {\n");
-      s4o.indent_right();
+      s4o.print("__lasttick_time);\n");
       s4o.print(s4o.indent_spaces);
       print_variable_prefix();
-      s4o.print("__step_list[i].T.value = __time_add(");
-      print_variable_prefix();
-      s4o.print("__step_list[i].T.value, elapsed_time);\n");
-      s4o.indent_left();
-      s4o.print(s4o.indent_spaces + "}\n");
-      s4o.indent_left();
-      s4o.print(s4o.indent_spaces + "}\n");
+      s4o.print("__lasttick_time = current_time;\n");
+    }
+
+    /* Returns true if an action association has a qualifier that stores (S, R, SL, SD, DS) its action
+     * (or variable), i.e. that uses the set, reset and remaining times of the action tables.
+     */
+    bool has_stored_actions(sequential_function_chart_c *symbol) {
+      for (int i = 0; i < symbol->n; i++) {
+        list_c *action_association_list = NULL;
+        initial_step_c *initial_step = dynamic_cast<initial_step_c *>(symbol->get_element(i));
+        step_c         *step         = dynamic_cast<step_c         *>(symbol->get_element(i));
+        if (NULL != initial_step) action_association_list = (list_c *)initial_step->action_association_list;
+        if (NULL != step)         action_association_list = (list_c *)step->action_association_list;
+        for (int j = 0; (NULL != action_association_list) && (j < action_association_list->n); j++) {
+          action_association_c *association = dynamic_cast<action_association_c *>(action_association_list->get_element(j));
+          action_qualifier_c   *qualifier   = (NULL == association)? NULL : dynamic_cast<action_qualifier_c *>(association->action_qualifier);
+          token_c              *name        = (NULL == qualifier  )? NULL : dynamic_cast<token_c *>(qualifier->action_qualifier);
+          if (NULL == name) continue;
+          if ((strcmp(name->value, "S" ) == 0) || (strcmp(name->value, "R" ) == 0) || (strcmp(name->value, "SL") == 0) ||
+              (strcmp(name->value, "SD") == 0) || (strcmp(name->value, "DS") == 0))
+            return true;
+        }
+      }
+      return false;
+    }
 
-      /* generate action initializations */
+    /* Without stored actions, the set, reset and remaining times of the actions are never changed from 0 */
+    void print_actions_initialization(bool stored_actions = true) {
       s4o.print(s4o.indent_spaces + "// Actions initialization\n");
       s4o.print(s4o.indent_spaces + "for (i = 0; i < ");
-      print_variable_prefix();
-      s4o.print("__nb_actions; i++) {\n");
+      print_table_size("__nb_actions");
+      s4o.print("; i++) {\n");
       s4o.indent_right();
       s4o.print(s4o.indent_spaces);
       s4o.print(SET_VAR);
       s4o.print("(");
       print_variable_prefix();
       s4o.print(",__action_list[i].state,,0);\n");
-      s4o.print(s4o.indent_spaces);
-      print_variable_prefix();
-      s4o.print("__action_list[i].set = 0;\n");
-      s4o.print(s4o.indent_spaces);
-      print_variable_prefix();
-      s4o.print("__action_list[i].reset = 0;\n");
-      s4o.print(s4o.indent_spaces + "if (");
-      s4o.print("__time_cmp(");
-      print_variable_prefix();
-      s4o.print("__action_list[i].set_remaining_time, __time_to_timespec(1, 0, 0, 0, 0, 0)) > 0) {\n");
-      s4o.indent_right();
-      s4o.print(s4o.indent_spaces);
-      print_variable_prefix();
-      s4o.print("__action_list[i].set_remaining_time = __time_sub(");
-      print_variable_prefix();
-      s4o.print("__action_list[i].set_remaining_time, elapsed_time);\n");
-      s4o.print(s4o.indent_spaces + "if (");
-      s4o.print("__time_cmp(");
-      print_variable_prefix();
-      s4o.print("__action_list[i].set_remaining_time, __time_to_timespec(1, 0, 0, 0, 0, 0)) <= 0) {\n");
-      s4o.indent_right();
-      s4o.print(s4o.indent_spaces);
-      print_variable_prefix();
-      s4o.print("__action_list[i].set_remaining_time = __time_to_timespec(1, 0, 0, 0, 0, 0);\n");
-      s4o.print(s4o.indent_spaces);
-      print_variable_prefix();
-      s4o.print("__action_list[i].set = 1;\n");
-      s4o.indent_left();
-      s4o.print(s4o.indent_spaces + "}\n");
-      s4o.indent_left();
-      s4o.print(s4o.indent_spaces + "}\n");
-      s4o.print(s4o.indent_spaces + "if (");
-      s4o.print("__time_cmp(");
-      print_variable_prefix();
-      s4o.print("__action_list[i].reset_remaining_time, __time_to_timespec(1, 0, 0, 0, 0, 0)) > 0) {\n");
-      s4o.indent_right();
-      s4o.print(s4o.indent_spaces);
-      print_variable_prefix();
-      s4o.print("__action_list[i].reset_remaining_time = __time_sub(");
-      print_variable_prefix();
-      s4o.print("__action_list[i].reset_remaining_time, elapsed_time);\n");
-      s4o.print(s4o.indent_spaces + "if (");
-      s4o.print("__time_cmp(");
-      print_variable_prefix();
-      s4o.print("__action_list[i].reset_remaining_time, __time_to_timespec(1, 0, 0, 0, 0, 0)) <= 0) {\n");
-      s4o.indent_right();
-      s4o.print(s4o.indent_spaces);
-      print_variable_prefix();
-      s4o.print("__action_list[i].reset_remaining_time = __time_to_timespec(1, 0, 0, 0, 0, 0);\n");
-      s4o.print(s4o.indent_spaces);
-      print_variable_prefix();
-      s4o.print("__action_list[i].reset = 1;\n");
-      s4o.indent_left();
-      s4o.print(s4o.indent_spaces + "}\n");
-      s4o.indent_left();
-      s4o.print(s4o.indent_spaces + "}\n");
+      if (stored_actions) {
+        s4o.print(s4o.indent_spaces);
+        print_variable_prefix();
+        s4o.print("__action_list[i].set = 0;\n");
+        s4o.print(s4o.indent_spaces);
+        print_variable_prefix();
+        s4o.print("__action_list[i].reset = 0;\n");
+        s4o.print(s4o.indent_spaces + "if (");
+        s4o.print("__time_cmp(");
+        print_variable_prefix();
+        s4o.print("__action_list[i].set_remaining_time, __time_to_timespec(1, 0, 0, 0, 0, 0)) > 0) {\n");
+        s4o.indent_right();
+        s4o.print(s4o.indent_spaces);
+        print_variable_prefix();
+        s4o.print("__action_list[i].set_remaining_time = __time_sub(");
+        print_variable_prefix();
+        s4o.print("__action_list[i].set_remaining_time, elapsed_time);\n");
+        s4o.print(s4o.indent_spaces + "if (");
+        s4o.print("__time_cmp(");
+        print_variable_prefix();
+        s4o.print("__action_list[i].set_remaining_time, __time_to_timespec(1, 0, 0, 0, 0, 0)) <= 0) {\n");
+        s4o.indent_right();
+        s4o.print(s4o.indent_spaces);
+        print_variable_prefix();
+        s4o.print("__action_list[i].set_remaining_time = __time_to_timespec(1, 0, 0, 0, 0, 0);\n");
+        s4o.print(s4o.indent_spaces);
+        print_variable_prefix();
+        s4o.print("__action_list[i].set = 1;\n");
+        s4o.indent_left();
+        s4o.print(s4o.indent_spaces + "}\n");
+        s4o.indent_left();
+        s4o.print(s4o.indent_spaces + "}\n");
+        s4o.print(s4o.indent_spaces + "if (");
+        s4o.print("__time_cmp(");
+        print_variable_prefix();
+        s4o.print("__action_list[i].reset_remaining_time, __time_to_timespec(1, 0, 0, 0, 0, 0)) > 0) {\n");
+        s4o.indent_right();
+        s4o.print(s4o.indent_spaces);
+        print_variable_prefix();
+        s4o.print("__action_list[i].reset_remaining_time = __time_sub(");
+        print_variable_prefix();
+        s4o.print("__action_list[i].reset_remaining_time, elapsed_time);\n");
+        s4o.print(s4o.indent_spaces + "if (");
+        s4o.print("__time_cmp(");
+        print_variable_prefix();
+        s4o.print("__action_list[i].reset_remaining_time, __time_to_timespec(1, 0, 0, 0, 0, 0)) <= 0) {\n");
+        s4o.indent_right();
+        s4o.print(s4o.indent_spaces);
+        print_variable_prefix();
+        s4o.print("__action_list[i].reset_remaining_time = __time_to_timespec(1, 0, 0, 0, 0, 0);\n");
+        s4o.print(s4o.indent_spaces);
+        print_variable_prefix();
+        s4o.print("__action_list[i].reset = 1;\n");
+        s4o.indent_left();
+        s4o.print(s4o.indent_spaces + "}\n");
+        s4o.indent_left();
+        s4o.print(s4o.indent_spaces + "}\n");
+      }
       s4o.indent_left();
       s4o.print(s4o.indent_spaces + "}\n\n");
-      
-      /* generate transition tests */
-      s4o.print(s4o.indent_spaces + "// Transitions fire test\n");
-      generate_c_sfc_elements->generate((symbol_c *)symbol, generate_c_sfc_elements_c::transitiontest_sg);
-      s4o.print("\n");
-      
-      /* generate transition reset steps */
-      s4o.print(s4o.indent_spaces + "// Transitions reset steps\n");
-      generate_c_sfc_elements->reset_transition_number();
-      for(i = 0; i < symbol->n; i++) {
-        generate_c_sfc_elements->generate(symbol->get_element(i), generate_c_sfc_elements_c::stepreset_sg);
-      }
-      s4o.print("\n");
-      
-      /* generate transition set steps */
-      s4o.print(s4o.indent_spaces + "// Transitions set steps\n");
-      generate_c_sfc_elements->reset_transition_number();
-      for(i = 0; i < symbol->n; i++) {
-        generate_c_sfc_elements->generate(symbol->get_element(i), generate_c_sfc_elements_c::stepset_sg);
-      }
-      s4o.print("\n");
-      
-      /* generate step association */
-      s4o.print(s4o.indent_spaces + "// Steps association\n");
-      for(i = 0; i < symbol->n; i++) {
-        generate_c_sfc_elements->generate(symbol->get_element(i), generate_c_sfc_elements_c::actionassociation_sg);
-      }
-      s4o.print("\n");
-      
-      /* generate action state evaluation */
+    }
+
+    void print_actions_evaluation(void) {
       s4o.print(s4o.indent_spaces + "// Actions state evaluation\n");
       s4o.print(s4o.indent_spaces + "for (i = 0; i < ");
-      print_variable_prefix();
-      s4o.print("__nb_actions; i++) {\n");
+      print_table_size("__nb_actions");
+      s4o.print("; i++) {\n");
       s4o.indent_right();
       s4o.print(s4o.indent_spaces + "if (");
       print_variable_prefix();
@@ -911,10 +1058,12 @@ class generate_c_sfc_c: public generate_c_base_and_typeid_c {
       s4o.print("__action_list[i].stored);\n");
       s4o.indent_left();
       s4o.print(s4o.indent_spaces + "}\n\n");
-      
-      /* generate action execution */
+    }
+
+    void print_actions_execution(sequential_function_chart_c *symbol, bool stored_actions) {
+      int i;
       s4o.print(s4o.indent_spaces + "// Actions execution\n");
-      {
+      if (stored_actions) {
         std::list<VARIABLE>::iterator pt;
         for(pt = variable_list.begin(); pt != variable_list.end(); pt++) {
 
@@ -970,6 +1119,302 @@ class generate_c_sfc_c: public generate_c_base_and_typeid_c {
         generate_c_sfc_elements->generate(symbol->get_element(i), generate_c_sfc_elements_c::actionbody_sg);
       }
       s4o.print("\n");
+    }
+
+    /* Print the min or max of the step that was active at the start of the scan, and the active step */
+    void print_first_last_step(bool last) {
+      s4o.print("((");
+      print_variable_prefix();
+      s4o.print("__previous_step < ");
+      print_variable_prefix();
+      s4o.print("__current_step)? ");
+      print_variable_prefix();
+      s4o.print(last? "__current_step : " : "__previous_step : ");
+      print_variable_prefix();
+      s4o.print(last? "__previous_step)" : "__current_step)");
+    }
+
+    /* Update the prev_state (and the elapsed time, if active) of the step in a step number variable */
+    void print_step_update(const char *step_variable) {
+      std::string step = std::string("__step_list[") + (is_variable_prefix_null()? "" : get_variable_prefix()) + step_variable + "]";
+      s4o.print(s4o.indent_spaces);
+      print_variable_prefix();
+      s4o.print(step + ".prev_state = ");
+      s4o.print(GET_VAR);
+      s4o.print("(");
+      print_variable_prefix();
+      s4o.print(step + ".X);\n");
+      s4o.print(s4o.indent_spaces + "if (");
+      s4o.print(GET_VAR);
+      s4o.print("(");
+      print_variable_prefix();
+      s4o.print(step + ".X)) {\n");
+      s4o.indent_right();
+      s4o.print(s4o.indent_spaces);
+      print_variable_prefix();
+      s4o.print(step + ".T.value = __time_add(");
+      print_variable_prefix();
+      s4o.print(step + ".T.value, elapsed_time);\n");
+      s4o.indent_left();
+      s4o.print(s4o.indent_spaces + "}\n");
+    }
+
+    /* With -O Q, an SFC made of a single sequence (see is_single_sequence_sfc()) only ever has one active step,
+     * whose number is kept in __current_step, and __previous_step is the step that was active at the start of
+     * the previous scan. All other steps are neither active, nor were active on the previous scan.
+     * So each scan only updates these two steps, only tests the transitions of the active step, in a switch()
+     * on its number, and only handles the action associations of these two steps (and of the steps with a P,
+     * P1 or P0 association), in the order of their declaration. The action tables are only updated by the
+     * qualifiers that store their action (S, R, SL, SD, DS), so the rest of their handling is left out when
+     * these are not used.
+     */
+    void generate_single_sequence(sequential_function_chart_c *symbol) {
+      int i;
+      std::vector<unsigned long> always_mask;
+      bool always_handled = get_always_mask(symbol, always_mask);
+      bool stored_actions = has_stored_actions(symbol);
+
+      generate_c_sfc_elements->set_single_sequence(true);
+
+      s4o.print(s4o.indent_spaces +"INT i;\n");
+      if (always_handled)
+        print_always_mask(always_mask);
+      s4o.print(s4o.indent_spaces +"TIME elapsed_time, current_time;\n\n");
+
+      print_elapsed_time();
+
+      /* generate step initializations */
+      s4o.print(s4o.indent_spaces + "// Steps initialization (the step deactivated on the previous scan, and the active step)\n");
+      print_step_update("__previous_step");
+      print_step_update("__current_step");
+      s4o.print(s4o.indent_spaces);
+      print_variable_prefix();
+      s4o.print("__previous_step = ");
+      print_variable_prefix();
+      s4o.print("__current_step;\n");
+
+      print_actions_initialization(stored_actions);
+
+      /* generate transition tests */
+      s4o.print(s4o.indent_spaces + "// Transitions fire test (the transitions of the active step)\n");
+      s4o.print(s4o.indent_spaces + "switch (");
+      print_variable_prefix();
+      s4o.print("__current_step) {\n");
+      s4o.indent_right();
+      for(i = 0; i < symbol->n; i++) {
+        initial_step_c *initial_step = dynamic_cast<initial_step_c *>(symbol->get_element(i));
+        step_c         *step         = dynamic_cast<step_c         *>(symbol->get_element(i));
+        symbol_c       *step_name    = (NULL != initial_step)? initial_step->step_name : (NULL != step)? step->step_name : NULL;
+        if ((NULL == step_name) || !generate_c_sfc_elements->has_transitions(step_name)) continue;
+        s4o.print(s4o.indent_spaces + "case ");
+        s4o.print(SFC_STEP_ACTION_PREFIX);
+        step_name->accept(*this);
+        s4o.print(":\n");
+        s4o.indent_right();
+        generate_c_sfc_elements->print_step_transitions(step_name);
+        s4o.print(s4o.indent_spaces + "break;\n");
+        s4o.indent_left();
+      }
+      s4o.print(s4o.indent_spaces + "default: break;\n");
+      s4o.indent_left();
+      s4o.print(s4o.indent_spaces + "}\n\n");
+
+      /* generate step association */
+      s4o.print(s4o.indent_spaces + "// Steps association\n");
+      if (always_handled) {
+        print_active_steps_loop(&always_mask, true);
+      } else {
+        s4o.print(s4o.indent_spaces + "for (i = ");
+        print_first_last_step(false);
+        s4o.print("; ; i = ");
+        print_first_last_step(true);
+        s4o.print(") {\n");
+        s4o.indent_right();
+      }
+      s4o.print(s4o.indent_spaces + "switch (i) {\n");
+      s4o.indent_right();
+      for(i = 0; i < symbol->n; i++) {
+        generate_c_sfc_elements->generate(symbol->get_element(i), generate_c_sfc_elements_c::actionassociation_sg);
+      }
+      s4o.print(s4o.indent_spaces + "default: break;\n");
+      s4o.indent_left();
+      s4o.print(s4o.indent_spaces + "}\n");
+      if (always_handled) {
+        print_active_steps_loop_end();
+      } else {
+        s4o.print(s4o.indent_spaces + "if (i == ");
+        print_first_last_step(true);
+        s4o.print(") break;\n");
+        s4o.indent_left();
+        s4o.print(s4o.indent_spaces + "}\n");
+      }
+      s4o.print("\n");
+
+      if (stored_actions)
+        print_actions_evaluation();
+      print_actions_execution(symbol, stored_actions);
+    }
+
+/*********************************************/
+/* B.1.6  Sequential function chart elements */
+/*********************************************/
+    
+    void *visit(sequential_function_chart_c *symbol) {
+      int i;
+      std::vector<unsigned long> always_mask; /* the steps whose action associations are handled even when they are not active */
+      
+      generate_c_sfc_elements->reset_transition_number();
+      for(i = 0; i < symbol->n; i++) {
+        symbol->get_element(i)->accept(*this);
+        generate_c_sfc_elements->generate(symbol->get_element(i), generate_c_sfc_elements_c::transitionlist_sg);
+      }
+      
+      if (is_single_sequence_sfc(symbol)) {
+        generate_single_sequence(symbol);
+        return NULL;
+      }
+
+      s4o.print(s4o.indent_spaces +"INT i;\n");
+      if (sfc_active_steps__) {
+        get_always_mask(symbol, always_mask);
+        print_always_mask(always_mask);
+      }
+      s4o.print(s4o.indent_spaces +"TIME elapsed_time, current_time;\n\n");
+      
+      print_elapsed_time();
+      
+      /* generate transition initializations */
+      /* (without the debug tables, the transitions can not be forced, and are all set by the transition tests) */
+      if (!sfc_no_debug__) {
+        s4o.print(s4o.indent_spaces + "// Transitions initialization\n");
+        s4o.print(s4o.indent_spaces + "if (__DEBUG) {\n");
+        s4o.indent_right();
+        s4o.print(s4o.indent_spaces + "for (i = 0; i < ");
+        print_table_size("__nb_transitions");
+        s4o.print("; i++) {\n");
+        s4o.indent_right();
+        s4o.print(s4o.indent_spaces);
+        print_variable_prefix();
+        s4o.print("__transition_list[i] = ");
+        print_variable_prefix();
+        s4o.print("__debug_transition_list[i];\n");
+        s4o.indent_left();
+        s4o.print(s4o.indent_spaces + "}\n");
+        s4o.indent_left();
+        s4o.print(s4o.indent_spaces + "}\n");
+      }
+
+      /* generate step initializations */
+      s4o.print(s4o.indent_spaces + "// Steps initialization\n");
+      if (sfc_active_steps__) {
+        /* Only the steps in the set of active steps may be active, or have been active on the previous scan.
+         * Once their prev_state is updated, the ones no longer active are removed from the set.
+         */
+        print_active_steps_loop();
+        s4o.print(s4o.indent_spaces);
+        print_variable_prefix();
+        s4o.print("__step_list[i].prev_state = ");
+        s4o.print(GET_VAR);
+        s4o.print("(");
+        print_variable_prefix();
+        s4o.print("__step_list[i].X);\n");
+        s4o.print(s4o.indent_spaces + "if (");
+        s4o.print(GET_VAR);
+        s4o.print("(");
+        print_variable_prefix();
+        s4o.print("__step_list[i].X)) {\n");
+        s4o.indent_right();
+        s4o.print(s4o.indent_spaces);
+        print_variable_prefix();
+        s4o.print("__step_list[i].T.value = __time_add(");
+        print_variable_prefix();
+        s4o.print("__step_list[i].T.value, elapsed_time);\n");
+        s4o.indent_left();
+        s4o.print(s4o.indent_spaces + "}\n");
+        s4o.print(s4o.indent_spaces + "else {\n");
+        s4o.indent_right();
+        s4o.print(s4o.indent_spaces);
+        print_variable_prefix();
+        s4o.print("__active_steps[w] &= ~((DWORD)1 << j);\n");
+        s4o.indent_left();
+        s4o.print(s4o.indent_spaces + "}\n");
+        print_active_steps_loop_end();
+      } else {
+        s4o.print(s4o.indent_spaces + "for (i = 0; i < ");
+        print_table_size("__nb_steps");
+        s4o.print("; i++) {\n");
+        s4o.indent_right();
+        s4o.print(s4o.indent_spaces);
+        print_variable_prefix();
+        s4o.print("__step_list[i].prev_state = ");
+        s4o.print(GET_VAR);
+        s4o.print("(");
+        print_variable_prefix();
+        s4o.print("__step_list[i].X);\n");
+        s4o.print(s4o.indent_spaces + "if (");
+        s4o.print(GET_VAR);
+        s4o.print("(");
+        print_variable_prefix();
+        s4o.print("__step_list[i].X)) {\n");
+        s4o.indent_right();
+        s4o.print(s4o.indent_spaces);
+        print_variable_prefix();
+        s4o.print("__step_list[i].T.value = __time_add(");
+        print_variable_prefix();
+        s4o.print("__step_list[i].T.value, elapsed_time);\n");
+        s4o.indent_left();
+        s4o.print(s4o.indent_spaces + "}\n");
+        s4o.indent_left();
+        s4o.print(s4o.indent_spaces + "}\n");
+      }
+
+      print_actions_initialization();
+      
+      /* generate transition tests */
+      s4o.print(s4o.indent_spaces + "// Transitions fire test\n");
+      generate_c_sfc_elements->generate((symbol_c *)symbol, generate_c_sfc_elements_c::transitiontest_sg);
+      s4o.print("\n");
+      
+      /* generate transition reset steps */
+      s4o.print(s4o.indent_spaces + "// Transitions reset steps\n");
+      generate_c_sfc_elements->reset_transition_number();
+      for(i = 0; i < symbol->n; i++) {
+        generate_c_sfc_elements->generate(symbol->get_element(i), generate_c_sfc_elements_c::stepreset_sg);
+      }
+      s4o.print("\n");
+      
+      /* generate transition set steps */
+      s4o.print(s4o.indent_spaces + "// Transitions set steps\n");
+      generate_c_sfc_elements->reset_transition_number();
+      for(i = 0; i < symbol->n; i++) {
+        generate_c_sfc_elements->generate(symbol->get_element(i), generate_c_sfc_elements_c::stepset_sg);
+      }
+      s4o.print("\n");
+      
+      /* generate step association */
+      s4o.print(s4o.indent_spaces + "// Steps association\n");
+      if (sfc_active_steps__) {
+        /* The set now also contains the steps deactivated by the transitions of this scan.
+         * The other steps are neither active, activated nor deactivated, so their action associations do nothing.
+         */
+        print_active_steps_loop(&always_mask);
+        s4o.print(s4o.indent_spaces + "switch (i) {\n");
+        s4o.indent_right();
+      }
+      for(i = 0; i < symbol->n; i++) {
+        generate_c_sfc_elements->generate(symbol->get_element(i), generate_c_sfc_elements_c::actionassociation_sg);
+      }
+      if (sfc_active_steps__) {
+        s4o.print(s4o.indent_spaces + "default: break;\n");
+        s4o.indent_left();
+        s4o.print(s4o.indent_spaces + "}\n");
+        print_active_steps_loop_end();
+      }
+      s4o.print("\n");
+      
+      print_actions_evaluation();
+      
+      print_actions_execution(symbol, true);
       
       return NULL;
     }
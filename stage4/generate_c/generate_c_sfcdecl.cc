@@ -27,6 +27,43 @@ typedef struct
   identifier_c *symbol;
 } VARIABLE;
 
+
+/* The step of the FROM or TO steps of a transition, if these are a single step (NULL otherwise) */
+static symbol_c *sfc_single_step(symbol_c *steps) {
+  steps_c *from_to = dynamic_cast<steps_c *>(steps);
+  if (NULL == from_to) return NULL;
+  if (NULL != from_to->step_name) return from_to->step_name;
+  list_c *step_name_list = dynamic_cast<list_c *>(from_to->step_name_list);
+  if ((NULL != step_name_list) && (1 == step_name_list->n)) return step_name_list->get_element(0);
+  return NULL;
+}
+
+/* Returns true if, with -O Q, the body is an SFC made of a single sequence, that is lowered to a switch() on
+ * its active step (see generate_c_sfc_c::generate_single_sequence()). It must have a single initial step, each
+ * transition must go from a single step to a single step (no simultaneous divergence or convergence), and the
+ * steps with several transitions must give all of them a PRIORITY (the transitions without one all fire
+ * together). Only one of its steps is then ever active.
+ */
+static bool is_single_sequence_sfc(symbol_c *body) {
+  sequential_function_chart_c *sfc = dynamic_cast<sequential_function_chart_c *>(body);
+  int initial_steps = 0;
+  if (!sfc_single_sequence__ || (NULL == sfc)) return false;
+  for (int i = 0; i < sfc->n; i++) {
+    if (NULL != dynamic_cast<initial_step_c *>(sfc->get_element(i))) initial_steps++;
+    transition_c *transition = dynamic_cast<transition_c *>(sfc->get_element(i));
+    if (NULL == transition) continue;
+    symbol_c *from_step = sfc_single_step(transition->from_steps);
+    if ((NULL == from_step) || (NULL == sfc_single_step(transition->to_steps))) return false;
+    for (int j = 0; j < sfc->n; j++) {
+      transition_c *other = dynamic_cast<transition_c *>(sfc->get_element(j));
+      if ((NULL == other) || (other == transition) || ((NULL != transition->integer) && (NULL != other->integer))) continue;
+      symbol_c *other_from_step = sfc_single_step(other->from_steps);
+      if ((NULL != other_from_step) && (0 == compare_identifiers(from_step, other_from_step))) return false;
+    }
+  }
+  return 1 == initial_steps;
+}
+
 /***********************************************************************/
 /***********************************************************************/
 /***********************************************************************/
@@ -54,6 +91,7 @@ class generate_c_sfcdecl_c: protected generate_c_base_and_typeid_c {
     std::list<VARIABLE> variable_list;
     
     sfcdeclaration_t wanted_sfcdeclaration;
+    bool single_sequence;  /* see is_single_sequence_sfc() */
 
     search_var_instance_decl_c *search_var_instance_decl;
     
@@ -68,6 +106,26 @@ class generate_c_sfcdecl_c: protected generate_c_base_and_typeid_c {
       delete search_var_instance_decl;
     }
     
+    /* Print the number of entries of one of the SFC tables (nb_name is __nb_steps, __nb_actions or __nb_transitions).
+     * Without the SFC debug tables (-O d), these are not stored in each instance, but taken from the size of the table.
+     */
+    void print_table_size(const char *nb_name) {
+      const char *table_name = (strcmp(nb_name, "__nb_steps"  ) == 0)? "__step_list"   :
+                               (strcmp(nb_name, "__nb_actions") == 0)? "__action_list" : "__transition_list";
+      if (!sfc_no_debug__) {
+        print_variable_prefix();
+        s4o.print(nb_name);
+        return;
+      }
+      s4o.print("(sizeof(");
+      print_variable_prefix();
+      s4o.print(table_name);
+      s4o.print(") / sizeof(");
+      print_variable_prefix();
+      s4o.print(table_name);
+      s4o.print("[0]))");
+    }
+
     void generate(symbol_c *symbol, sfcdeclaration_t declaration_type) {
       wanted_sfcdeclaration = declaration_type;
 
@@ -82,6 +140,7 @@ class generate_c_sfcdecl_c: protected generate_c_base_and_typeid_c {
       step_number = 0;
       action_number = 0;
       transition_number = 0;
+      single_sequence = is_single_sequence_sfc(symbol);
       switch (wanted_sfcdeclaration) {
         case sfcdecl_sd:
           for(int i = 0; i < symbol->n; i++)
@@ -91,13 +150,25 @@ class generate_c_sfcdecl_c: protected generate_c_base_and_typeid_c {
           s4o.print(s4o.indent_spaces + "STEP __step_list[");
           s4o.print(step_number);
           s4o.print("];\n");
-          s4o.print(s4o.indent_spaces + "UINT __nb_steps;\n");
+          if (!sfc_no_debug__)
+            s4o.print(s4o.indent_spaces + "UINT __nb_steps;\n");
+          if (single_sequence) {
+            /* the number of the active step, and of the step that was active at the start of the previous scan */
+            s4o.print(s4o.indent_spaces + "UINT __current_step;\n");
+            s4o.print(s4o.indent_spaces + "UINT __previous_step;\n");
+          } else if (sfc_active_steps__) {
+            /* set of the steps that are active, or were active at the start of the current scan (a bit for each step) */
+            s4o.print(s4o.indent_spaces + "DWORD __active_steps[");
+            s4o.print((step_number + 31) / 32);
+            s4o.print("];\n");
+          }
           
           /* actions table declaration */
           s4o.print(s4o.indent_spaces + "ACTION __action_list[");
           s4o.print(action_number);
           s4o.print("];\n");
-          s4o.print(s4o.indent_spaces + "UINT __nb_actions;\n");
+          if (!sfc_no_debug__)
+            s4o.print(s4o.indent_spaces + "UINT __nb_actions;\n");
           
           /* transitions table declaration */
           s4o.print(s4o.indent_spaces + "__IEC_BOOL_t __transition_list[");
@@ -105,10 +176,12 @@ class generate_c_sfcdecl_c: protected generate_c_base_and_typeid_c {
           s4o.print("];\n");
           
           /* transitions debug table declaration */
-          s4o.print(s4o.indent_spaces + "__IEC_BOOL_t __debug_transition_list[");
-          s4o.print(transition_number);
-          s4o.print("];\n");
-          s4o.print(s4o.indent_spaces + "UINT __nb_transitions;\n");
+          if (!sfc_no_debug__) {
+            s4o.print(s4o.indent_spaces + "__IEC_BOOL_t __debug_transition_list[");
+            s4o.print(transition_number);
+            s4o.print("];\n");
+            s4o.print(s4o.indent_spaces + "UINT __nb_transitions;\n");
+          }
           
           /* last_ticktime declaration */
           s4o.print(s4o.indent_spaces + "TIME __lasttick_time;\n");
@@ -121,25 +194,38 @@ class generate_c_sfcdecl_c: protected generate_c_base_and_typeid_c {
           wanted_sfcdeclaration = stepcount_sd;
           for(int i = 0; i < symbol->n; i++)
             symbol->get_element(i)->accept(*this);
-          s4o.print(s4o.indent_spaces);
-          print_variable_prefix();
-          s4o.print("__nb_steps = ");
-          s4o.print(step_number);
-          s4o.print(";\n");
+          if (!sfc_no_debug__) {
+            s4o.print(s4o.indent_spaces);
+            print_variable_prefix();
+            s4o.print("__nb_steps = ");
+            s4o.print(step_number);
+            s4o.print(";\n");
+          }
           step_number = 0;
           wanted_sfcdeclaration = sfcinit_sd;
           
           /* steps table initialisation */
           s4o.print(s4o.indent_spaces + "static const STEP temp_step = {{0, 0}, 0, {{0, 0}, 0}};\n");
           s4o.print(s4o.indent_spaces + "for(i = 0; i < ");
-          print_variable_prefix();
-          s4o.print("__nb_steps; i++) {\n");
+          print_table_size("__nb_steps");
+          s4o.print("; i++) {\n");
           s4o.indent_right();
           s4o.print(s4o.indent_spaces);
           print_variable_prefix();
           s4o.print("__step_list[i] = temp_step;\n");
           s4o.indent_left();
           s4o.print(s4o.indent_spaces + "}\n");
+          if (sfc_active_steps__ && !single_sequence) {
+            s4o.print(s4o.indent_spaces + "for(i = 0; i < (");
+            print_table_size("__nb_steps");
+            s4o.print(" + 31) / 32; i++) {\n");
+            s4o.indent_right();
+            s4o.print(s4o.indent_spaces);
+            print_variable_prefix();
+            s4o.print("__active_steps[i] = 0;\n");
+            s4o.indent_left();
+            s4o.print(s4o.indent_spaces + "}\n");
+          }
           for(int i = 0; i < symbol->n; i++)
             symbol->get_element(i)->accept(*this);
           
@@ -147,19 +233,21 @@ class generate_c_sfcdecl_c: protected generate_c_base_and_typeid_c {
           wanted_sfcdeclaration = actioncount_sd;
           for(int i = 0; i < symbol->n; i++)
             symbol->get_element(i)->accept(*this);
-          s4o.print(s4o.indent_spaces);
-          print_variable_prefix();
-          s4o.print("__nb_actions = ");
-          s4o.print(action_number);
-          s4o.print(";\n");
+          if (!sfc_no_debug__) {
+            s4o.print(s4o.indent_spaces);
+            print_variable_prefix();
+            s4o.print("__nb_actions = ");
+            s4o.print(action_number);
+            s4o.print(";\n");
+          }
           action_number = 0;
           wanted_sfcdeclaration = sfcinit_sd;
           
           /* actions table initialisation */
           s4o.print(s4o.indent_spaces + "static const ACTION temp_action = {0, {0, 0}, 0, 0, {0, 0}, {0, 0}};\n");
           s4o.print(s4o.indent_spaces + "for(i = 0; i < ");
-          print_variable_prefix();
-          s4o.print("__nb_actions; i++) {\n");
+          print_table_size("__nb_actions");
+          s4o.print("; i++) {\n");
           s4o.indent_right();
           s4o.print(s4o.indent_spaces);
           print_variable_prefix();
@@ -171,11 +259,13 @@ class generate_c_sfcdecl_c: protected generate_c_base_and_typeid_c {
           wanted_sfcdeclaration = transitioncount_sd;
           for(int i = 0; i < symbol->n; i++)
             symbol->get_element(i)->accept(*this);
-          s4o.print(s4o.indent_spaces);
-          print_variable_prefix();
-          s4o.print("__nb_transitions = ");
-          s4o.print(transition_number);
-          s4o.print(";\n");
+          if (!sfc_no_debug__) {
+            s4o.print(s4o.indent_spaces);
+            print_variable_prefix();
+            s4o.print("__nb_transitions = ");
+            s4o.print(transition_number);
+            s4o.print(";\n");
+          }
           transition_number = 0;
           wanted_sfcdeclaration = sfcinit_sd;
 
@@ -266,6 +356,23 @@ class generate_c_sfcdecl_c: protected generate_c_base_and_typeid_c {
           s4o.print(",__step_list[");
           s4o.print(step_number);
           s4o.print("].X,,1);\n");
+          if (single_sequence) {
+            s4o.print(s4o.indent_spaces);
+            print_variable_prefix();
+            s4o.print("__current_step = ");
+            print_variable_prefix();
+            s4o.print("__previous_step = ");
+            s4o.print(step_number);
+            s4o.print(";\n");
+          } else if (sfc_active_steps__) {
+            s4o.print(s4o.indent_spaces);
+            print_variable_prefix();
+            s4o.print("__active_steps[");
+            s4o.print(step_number / 32);
+            s4o.print("] |= (DWORD)1 << ");
+            s4o.print(step_number % 32);
+            s4o.print(";\n");
+          }
           step_number++;
           break;
         case stepdef_sd:
@@ -44,6 +44,119 @@
 /***********************************************************************/
 
 
+/* Determine whether a CASE statement may be generated as a C switch(), and with which case labels.
+ *
+ * This is possible when the selector is an integer or an enumerated value, and all the case labels
+ * are constants (which constant folding will have determined for the integer ones). The subranges are
+ * expanded into one case label for each value they contain, so the C compiler may build a jump table.
+ *
+ * IEC 61131-3 executes the first case_element that contains the selector's value, while a C
+ * switch() does not allow the same value in more than one case label. Values already used by a previous
+ * case_element are therefore left out (case_elements_check_c will have warned about them), and any
+ * case_element left without values is never executed.
+ *
+ * The EXIT statement is generated as a C 'break', which inside a switch() would no longer exit the
+ * enclosing loop. CASE statements that contain an EXIT (of an enclosing loop) are left as if()...else if().
+ */
+class case_switch_c: public iterator_visitor_c {
+  public:
+    static const unsigned int max_labels = 1024;  /* do not generate switch() with more case labels than this */
+
+    bool                  is_enumerated, is_signed;
+    /* the case labels of each case_element: the values (of integers), or the enumerated_value_c symbols */
+    std::vector<std::vector<uint64_t> >   values;
+    std::vector<std::vector<symbol_c *> > enum_values;
+
+  private:
+    std::set<uint64_t>    used_values;
+    std::set<std::string> used_enum_values;
+    unsigned int          label_count;
+    bool                  has_exit;
+
+    bool get_value(symbol_c *symbol, uint64_t &value) {
+      if (is_signed) {
+        if (!symbol->const_value._int64.is_valid()) return false;
+        if (symbol->const_value._int64.get() == INT64_MIN) return false; /* no C literal for this one */
+        value = (uint64_t)symbol->const_value._int64.get();
+        return true;
+      }
+      if (!symbol->const_value._uint64.is_valid()) return false;
+      value = symbol->const_value._uint64.get();
+      return true;
+    }
+
+    void add_value(uint64_t value) {
+      if (used_values.insert(value).second) {values.back().push_back(value); label_count++;}
+    }
+
+    bool add_label(symbol_c *label) {
+      subrange_c *subrange = dynamic_cast<subrange_c *>(label);
+      if (is_enumerated) {
+        enumerated_value_c *enum_value = dynamic_cast<enumerated_value_c *>(label);
+        token_c            *name       = (NULL == enum_value)? NULL : dynamic_cast<token_c *>(enum_value->value);
+        if (NULL == name) return false;
+        std::string key(name->value);
+        std::transform(key.begin(), key.end(), key.begin(), ::toupper);
+        if (used_enum_values.insert(key).second) {enum_values.back().push_back(label); label_count++;}
+        return true;
+      }
+      uint64_t lower, upper;
+      if (NULL == subrange) {
+        if (!get_value(label, lower)) return false;
+        add_value(lower);
+        return true;
+      }
+      if (!get_value(subrange->lower_limit, lower) || !get_value(subrange->upper_limit, upper)) return false;
+      if (is_signed? ((int64_t)lower > (int64_t)upper) : (lower > upper)) return true; /* empty subrange */
+      if (upper - lower >= max_labels) return false;
+      for (uint64_t value = lower; ; value++) {
+        add_value(value);
+        if (label_count > max_labels) return false;
+        if (value == upper) break;
+      }
+      return true;
+    }
+
+  public:
+    /* Returns true if the CASE statement can be generated as a switch() */
+    bool analyse(case_statement_c *symbol) {
+      symbol_c *type = symbol->expression->datatype;
+      values.clear(); enum_values.clear(); used_values.clear(); used_enum_values.clear();
+      label_count = 0;
+      is_enumerated = get_datatype_info_c::is_enumerated(type);
+      is_signed     = !get_datatype_info_c::is_ANY_unsigned_INT_compatible(type);
+      if (!is_enumerated && !get_datatype_info_c::is_ANY_INT_compatible(type)) return false;
+
+      list_c *case_element_list = dynamic_cast<list_c *>(symbol->case_element_list);
+      if (NULL == case_element_list) return false;
+      for (int i = 0; i < case_element_list->n; i++) {
+        case_element_c *case_element = dynamic_cast<case_element_c *>(case_element_list->get_element(i));
+        list_c         *case_list    = (NULL == case_element)? NULL : dynamic_cast<list_c *>(case_element->case_list);
+        if (NULL == case_list) return false;
+        values.push_back(std::vector<uint64_t>());
+        enum_values.push_back(std::vector<symbol_c *>());
+        for (int j = 0; j < case_list->n; j++)
+          if (!add_label(case_list->get_element(j))) return false;
+      }
+      if (label_count > max_labels) return false;
+
+      has_exit = false;
+      symbol->case_element_list->accept(*this);
+      if (NULL != symbol->statement_list) symbol->statement_list->accept(*this);
+      return !has_exit;
+    }
+
+    /* look for EXIT statements, but not inside loops (they exit those loops) */
+    void *visit(exit_statement_c   *symbol) {has_exit = true; return NULL;}
+    void *visit(for_statement_c    *symbol) {return NULL;}
+    void *visit(while_statement_c  *symbol) {return NULL;}
+    void *visit(repeat_statement_c *symbol) {return NULL;}
+    /* no need to look inside the expressions */
+    void *visit(case_list_c        *symbol) {return NULL;}
+};
+
+
+
 class generate_c_st_c: public generate_c_base_and_typeid_c {
 
   public:
@@ -71,6 +184,9 @@ class generate_c_st_c: public generate_c_base_and_typeid_c {
     search_fb_instance_decl_c    *search_fb_instance_decl;
     search_varfb_instance_type_c *search_varfb_instance_type;
     search_var_instance_decl_c   *search_var_instance_decl;
+    fb_eneno_usage_c             *fb_eneno_usage;
+    string_literal_pool_c        *string_literal_pool;
+    case_switch_c                 case_switch;
     
     symbol_c *scope_;
 
@@ -84,12 +200,25 @@ class generate_c_st_c: public generate_c_base_and_typeid_c {
 
     variablegeneration_t wanted_variablegeneration;
 
+    /* CONSTANT variables are printed as a literal with their value (when known), except where their address is needed */
+    bool fold_constant_variables;
+
+    /* The values taken by the control variables of the FOR loops being generated (array_bounds_check__),
+     * when the limits of the loop are constant, and the loop does not change its control variable.
+     */
+    typedef struct {symbol_c *var_name; int64_t min, max;} for_range_t;
+    std::vector<for_range_t> for_ranges;
+    /* the hint for the condition of the next case_element_c printed (-O P, see generate_c_pgo.cc) */
+    int case_element_hint;
+
   public:
     generate_c_st_c(stage4out_c *s4o_ptr, symbol_c *name, symbol_c *scope, const char *variable_prefix = NULL)
     : generate_c_base_and_typeid_c(s4o_ptr) {
       search_fb_instance_decl    = new search_fb_instance_decl_c   (scope);
       search_varfb_instance_type = new search_varfb_instance_type_c(scope);
       search_var_instance_decl   = new search_var_instance_decl_c  (scope);
+      fb_eneno_usage             = new fb_eneno_usage_c            (scope);
+      string_literal_pool        = new string_literal_pool_c       (scope);
       scope_ = scope;
       
       this->set_variable_prefix(variable_prefix);
@@ -98,12 +227,16 @@ class generate_c_st_c: public generate_c_base_and_typeid_c {
       fcall_number = 0;
       fbname = name;
       wanted_variablegeneration = expression_vg;
+      fold_constant_variables = true;
+      case_element_hint = 0;
     }
 
     virtual ~generate_c_st_c(void) {
       delete search_fb_instance_decl;
       delete search_varfb_instance_type;
       delete search_var_instance_decl;
+      delete fb_eneno_usage;
+      delete string_literal_pool;
     }
 
 
@@ -119,8 +252,41 @@ class generate_c_st_c: public generate_c_base_and_typeid_c {
 
 
 
+/* With array_bounds_check__, a subscript is also in range when it is the control variable of a FOR loop whose limits are within range */
+bool is_subscript_in_range(symbol_c *subscript, int64_t lower, int64_t upper) {
+  symbolic_variable_c *variable = dynamic_cast<symbolic_variable_c *>(subscript);
+  if (NULL != variable)
+    for (int i = (int)for_ranges.size() - 1; i >= 0; i--)
+      if (0 == compare_identifiers(for_ranges[i].var_name, variable->var_name))
+        return (for_ranges[i].min >= lower) && (for_ranges[i].max <= upper);
+  return generate_c_base_and_typeid_c::is_subscript_in_range(subscript, lower, upper);
+}
+
 void *print_getter(symbol_c *symbol) {
+  if ((wanted_variablegeneration == expression_vg) && is_const_input(symbol)) {
+    /* the const copy of the input made on entry to the body (restrict_instances__, see find_const_inputs_c) */
+    s4o.print("__input_");
+    dynamic_cast<symbolic_variable_c *>(symbol)->var_name->accept(*this);
+    s4o.print("__");
+    return NULL;
+  }
   unsigned int vartype = analyse_variable_c::first_nonfb_vardecltype(symbol, scope_);
+  if ((vartype == search_var_instance_decl_c::external_vt) && (wanted_variablegeneration != fparam_output_vg)) {
+    const direct_global_t *global = get_direct_global(symbol);
+    if (NULL != global) {
+      /* access the global directly, instead of through the pointer in the VAR_EXTERNAL */
+      variablegeneration_t old_wanted_variablegeneration = wanted_variablegeneration;
+      s4o.print(GET_VAR);
+      s4o.print("(");
+      s4o.print(global->c_name);
+      s4o.print(",");
+      wanted_variablegeneration = complextype_suffix_vg;
+      symbol->accept(*this);
+      s4o.print(")");
+      wanted_variablegeneration = old_wanted_variablegeneration;
+      return NULL;
+    }
+  }
   if (wanted_variablegeneration == fparam_output_vg) {
     if (vartype == search_var_instance_decl_c::external_vt) {
       if (!get_datatype_info_c::is_type_valid    (symbol->datatype)) ERROR;
@@ -169,11 +335,16 @@ void *print_setter(symbol_c* symbol,
         symbol_c* fb_symbol = NULL,
         symbol_c* fb_value = NULL) {
  
+  const direct_global_t *global = NULL;
   if (fb_symbol == NULL) {
     unsigned int vartype = analyse_variable_c::first_nonfb_vardecltype(symbol, scope_);
     symbol_c *first_nonfb = analyse_variable_c::find_first_nonfb(symbol);
     if (first_nonfb == NULL) ERROR;
-    if (vartype == search_var_instance_decl_c::external_vt) {
+    if (vartype == search_var_instance_decl_c::external_vt)
+      global = get_direct_global(symbol);
+    if (NULL != global)
+      s4o.print(SET_VAR);  /* access the global directly, instead of through the pointer in the VAR_EXTERNAL */
+    else if (vartype == search_var_instance_decl_c::external_vt) {
       if (!get_datatype_info_c::is_type_valid    (first_nonfb->datatype)) ERROR;
       if ( get_datatype_info_c::is_function_block(first_nonfb->datatype)) // handle situation where we are copying a complete fb -> fb1.fb2.fb3 := fb4 (and fb3 is external!)
         s4o.print(SET_EXTERNAL_FB);
@@ -203,6 +374,13 @@ void *print_setter(symbol_c* symbol,
     symbol->accept(*this);
     s4o.print(",");
     s4o.print(",");    
+  } else if (NULL != global) {
+    s4o.print(",");
+    s4o.print(global->c_name);
+    s4o.print(",");
+    wanted_variablegeneration = complextype_suffix_vg;
+    symbol->accept(*this);
+    s4o.print(",");
   } else {
     print_variable_prefix();
     s4o.print(",");    
@@ -220,6 +398,15 @@ void *print_setter(symbol_c* symbol,
   return NULL;
 }
 
+/*******************************/
+/* B.1.2.2   Character Strings */
+/*******************************/
+void *visit(single_byte_character_string_c *symbol) {
+  /* use the constant declared at the start of the C function with the POU code (see string_literal_pool_c) */
+  if (string_literal_pool->print_literal(s4o, symbol)) return NULL;
+  return generate_c_base_c::visit(symbol);
+}
+
 /********************************/
 /* B 1.3.3 - Derived data types */
 /********************************/
@@ -245,6 +432,12 @@ void *visit(enumerated_type_declaration_c *symbol) {
 /*********************/
 /* B 1.4 - Variables */
 /*********************/
+bool print_folded_constant_variable(symbolic_variable_c *symbol) {
+  if (!fold_constant_variables || (wanted_variablegeneration != expression_vg)) return false;
+  if (search_var_instance_decl->get_option(symbol) != search_var_instance_decl_c::constant_opt) return false;
+  return print_folded_value(symbol);
+}
+
 void *visit(symbolic_variable_c *symbol) {
   switch (wanted_variablegeneration) {
     case complextype_base_vg:
@@ -260,10 +453,11 @@ void *visit(symbolic_variable_c *symbol) {
           s4o.print(")");
         }
         else {
-          generate_c_base_c::visit(symbol);
+          if (!print_folded_constant_variable(symbol))
+            generate_c_base_c::visit(symbol);
         }
       }
-      else
+      else if (!print_folded_constant_variable(symbol))
         print_getter(symbol);
       break;
   }
@@ -421,11 +615,7 @@ void *visit(subscript_list_c *symbol) {
     symbol_c* dimension = array_dimension_iterator->next();
     if (dimension == NULL) ERROR;
 
-    s4o.print("[(");
-    symbol->get_element(i)->accept(*this);
-    s4o.print(") - (");
-    dimension->accept(*this);
-    s4o.print(")]");
+    print_subscript(symbol->get_element(i), dimension);
   }
   delete array_dimension_iterator;
   return NULL;
@@ -545,7 +735,9 @@ void *visit(ref_expression_c *symbol) {
   if (this->is_variable_prefix_null()) {  
     /* For code in FUNCTIONs */
     s4o.print("&(");  
+    fold_constant_variables = false;
     symbol->exp->accept(*this);    
+    fold_constant_variables = true;
     s4o.print(")");  
   } else {
     /* For code in FBs, and PROGRAMS... */
@@ -702,10 +894,18 @@ void *visit(mod_expression_c *symbol) {
   return NULL;
 }
 
+/* The integer exponents are computed by squaring (see __expt_int() in iec_std_lib.h), which the
+ * C compiler unrolls into a few multiplications when the exponent is a constant.
+ */
 void *visit(power_expression_c *symbol) {
-  s4o.print("__expt((LREAL)(");
+  const char *exponent_type = "LREAL";
+  if      (get_datatype_info_c::is_ANY_signed_INT_compatible  (symbol->r_exp->datatype)) {s4o.print("__expt_int((LREAL)(");  exponent_type = "LINT"; }
+  else if (get_datatype_info_c::is_ANY_unsigned_INT_compatible(symbol->r_exp->datatype)) {s4o.print("__expt_uint((LREAL)("); exponent_type = "ULINT";}
+  else                                                                                    s4o.print("__expt((LREAL)(");
   symbol->l_exp->accept(*this);
-  s4o.print("), (LREAL)(");
+  s4o.print("), (");
+  s4o.print(exponent_type);
+  s4o.print(")(");
   symbol->r_exp->accept(*this);
   s4o.print("))");
   return NULL;
@@ -720,6 +920,9 @@ void *visit(not_expression_c *symbol) {
 }
 
 void *visit(function_invocation_c *symbol) {
+  /* a call to a standard function, whose value stage3 has already determined */
+  if (print_folded_value(symbol)) return NULL;
+
   symbol_c* function_name = NULL;
   DECLARE_PARAM_LIST()
 
@@ -788,14 +991,8 @@ void *visit(function_invocation_c *symbol) {
     
     symbol_c *param_value = NULL;
     
-    /* Get the value from a foo(<param_name> = <param_value>) style call */
-    if (param_value == NULL)
-      param_value = function_call_param_iterator.search_f(param_name);
-
-    /* Get the value from a foo(<param_value>) style call */
-    if ((param_value == NULL) && !fp_iterator.is_en_eno_param_implicit()) {
-      param_value = function_call_param_iterator.next_nf();
-    }
+    /* Get the value from a foo(<param_name> = <param_value>) or a foo(<param_value>) style call */
+    param_value = function_call_param_iterator.next_param_value(param_name->value, fp_iterator.is_en_eno_param_implicit());
 
     /* if no more parameter values in function call, and the current parameter
      * of the function declaration is an extensible parameter, we
@@ -815,7 +1012,7 @@ void *visit(function_invocation_c *symbol) {
   } /* for(...) */
   // symbol->parameter_assignment->accept(*this);
   
-  if (function_call_param_iterator.next_nf() != NULL) ERROR;
+  if (!function_call_param_iterator.is_bound() && (function_call_param_iterator.next_nf() != NULL)) ERROR;
 
   bool has_output_params = false;
 
@@ -846,7 +1043,7 @@ void *visit(function_invocation_c *symbol) {
       print_function_parameter_data_types_c overloaded_func_suf(&s4o);
       f_decl->accept(overloaded_func_suf);
     }
-    s4o.print(fcall_number);
+    s4o.print((0 != inline_fcall_number.get(symbol))? inline_fcall_number.get(symbol) : fcall_number);
   }
   else {
     function_name->accept(*this);
@@ -856,6 +1053,7 @@ void *visit(function_invocation_c *symbol) {
       print_function_parameter_data_types_c overloaded_func_suf(&s4o);
       f_decl->accept(overloaded_func_suf);
     }
+    print_fixed_arity_suffix(function_name, found_first_extensible_parameter? symbol->extensible_param_count : 0);
   }
   s4o.print("(");
   s4o.indent_right();
@@ -925,8 +1123,11 @@ void *visit(function_invocation_c *symbol) {
 /********************/
 void *visit(statement_list_c *symbol) {
   for(int i = 0; i < symbol->n; i++) {
+    /* assignments whose value is always overwritten before being read (see stage3/dead_store_analysis.hh) */
+    if (dead_store_analysis_c::is_dead_store(symbol->get_element(i))) continue;
     print_line_directive(symbol->get_element(i));
     s4o.print(s4o.indent_spaces);
+    print_stmt_counter(symbol->get_element(i));
     symbol->get_element(i)->accept(*this);
     s4o.print(";\n");
   }
@@ -986,15 +1187,8 @@ void *visit(fb_invocation_c *symbol) {
     
     /*fprintf(stderr, "param : %s\n", param_name->value);*/
     
-    /* Get the value from a foo(<param_name> = <param_value>) style call */
-    symbol_c *param_value = function_call_param_iterator.search_f(param_name);
-
-    /* Get the value from a foo(<param_value>) style call */
-    /* When using the informal invocation style, user can not pass values to EN or ENO parameters if these
-     * were implicitly defined!
-     */
-    if ((param_value == NULL) && !fp_iterator.is_en_eno_param_implicit())
-      param_value = function_call_param_iterator.next_nf();
+    /* Get the value from a foo(<param_name> = <param_value>) or a foo(<param_value>) style call */
+    symbol_c *param_value = function_call_param_iterator.next_param_value(param_name->value, fp_iterator.is_en_eno_param_implicit());
 
     symbol_c *param_type = fp_iterator.param_type();
     if (param_type == NULL) ERROR;
@@ -1019,7 +1213,10 @@ void *visit(fb_invocation_c *symbol) {
 
   /* now call the function... */
   function_block_type_name->accept(*this);
-  s4o.print(FB_FUNCTION_SUFFIX);
+  if (fb_eneno_usage->is_eneno_unused(symbol->fb_name, fb_decl))
+    s4o.print(FB_NOENENO_FUNCTION_SUFFIX);
+  else
+    s4o.print(FB_FUNCTION_SUFFIX);
   s4o.print("(");
   if (search_var_instance_decl->get_vartype(symbol->fb_name) != search_var_instance_decl_c::external_vt)
     s4o.print("&");
@@ -1035,15 +1232,8 @@ void *visit(fb_invocation_c *symbol) {
   for(int i = 1; (param_name = fp_iterator.next()) != NULL; i++) {
     function_param_iterator_c::param_direction_t param_direction = fp_iterator.param_direction();
 
-    /* Get the value from a foo(<param_name> = <param_value>) style call */
-    symbol_c *param_value = function_call_param_iterator.search_f(param_name);
-
-    /* Get the value from a foo(<param_value>) style call */
-    /* When using the informal invocation style, user can not pass values to EN or ENO parameters if these
-     * were implicitly defined!
-     */
-    if ((param_value == NULL) && !fp_iterator.is_en_eno_param_implicit())
-      param_value = function_call_param_iterator.next_nf();
+    /* Get the value from a foo(<param_name> = <param_value>) or a foo(<param_value>) style call */
+    symbol_c *param_value = function_call_param_iterator.next_param_value(param_name->value, fp_iterator.is_en_eno_param_implicit());
 
     /* now output the value assignment */
     if (param_value != NULL)
@@ -1124,22 +1314,85 @@ void *visit(not_paramassign_c *symbol) {
 /********************************/
 /* B 3.2.3 Selection Statements */
 /********************************/
+/* The code of the branches that can never be executed is not printed. It is still visited however (with the
+ * output disabled), so the calls to functions with output parameters keep the same numbering as the
+ * inline functions generated for them by generate_c_inlinefcall_c.
+ */
+void *print_dead_code(symbol_c *symbol) {
+  if (NULL == symbol) return NULL;
+  bool output_enabled = s4o.is_output_enabled();
+  s4o.disable_output();
+  symbol->accept(*this);
+  if (output_enabled) s4o.enable_output();
+  else                s4o.disable_output();
+  return NULL;
+}
+
 void *visit(if_statement_c *symbol) {
-  s4o.print("if (");
-  symbol->expression->accept(*this);
-  s4o.print(") {\n");
-  s4o.indent_right();
-  symbol->statement_list->accept(*this);
-  s4o.indent_left();
-  symbol->elseif_statement_list->accept(*this);
+  /* The IF and ELSIF branches, in order */
+  std::vector<symbol_c *> conditions, statements;
+  conditions.push_back(symbol->expression);
+  statements.push_back(symbol->statement_list);
+  list_c *elseif_list = dynamic_cast<list_c *>(symbol->elseif_statement_list);
+  for (int i = 0; (NULL != elseif_list) && (i < elseif_list->n); i++) {
+    elseif_statement_c *elseif = dynamic_cast<elseif_statement_c *>(elseif_list->get_element(i));
+    if (NULL == elseif) ERROR;
+    conditions.push_back(elseif->expression);
+    statements.push_back(elseif->statement_list);
+  }
 
-  if (symbol->else_statement_list != NULL) {
-    s4o.print(s4o.indent_spaces); s4o.print("} else {\n");
+  /* With a profile (-O P), the number of times the IF was reached, and each branch was taken (see generate_c_pgo.cc) */
+  unsigned long long reached = 0;
+  std::vector<unsigned long long> taken(conditions.size(), 0);
+  bool profiled = (NULL != stmt_profile__) && stmt_profile__->get_count(symbol, reached);
+  for (unsigned int i = 0; profiled && (i < conditions.size()); i++)
+    profiled = stmt_profile__->get_first_count(statements[i], symbol, taken[i]);
+  /* the branches that may not be taken on the same scan are tested in the order of the number of times they were taken */
+  if (profiled && exclusive_conditions(conditions)) {
+    for (unsigned int i = 1; i < conditions.size(); i++)
+      for (unsigned int j = i; (j > 0) && (taken[j-1] < taken[j]); j--) {
+        std::swap(conditions[j-1], conditions[j]);
+        std::swap(statements[j-1], statements[j]);
+        std::swap(taken     [j-1], taken     [j]);
+      }
+  }
+
+  /* Branches whose condition is always FALSE, and those following a condition that is always TRUE, are dropped */
+  bool printed_if = false;  /* the start of the if chain has already been printed */
+  bool always_taken = false;  /* found a branch whose condition is always TRUE */
+  for (unsigned int i = 0; i < conditions.size(); i++) {
+    int condition = always_taken? -1 : constant_condition(conditions[i]);
+    if (condition < 0) {
+      print_dead_code(conditions[i]);
+      print_dead_code(statements[i]);
+      continue;
+    }
+    if (printed_if) {s4o.print(s4o.indent_spaces); s4o.print("} else ");}
+    if (condition == 0) {
+      s4o.print("if (");
+      print_branch_condition(s4o, *this, conditions[i], profiled? stmt_profile_c::branch_hint(taken[i], reached) : 0);
+      s4o.print(") ");
+      reached -= std::min(reached, taken[i]);
+    } else
+      always_taken = true;
+    s4o.print("{\n");
+    s4o.indent_right();
+    statements[i]->accept(*this);
+    s4o.indent_left();
+    printed_if = true;
+  }
+
+  if (always_taken)
+    print_dead_code(symbol->else_statement_list);
+  else if (symbol->else_statement_list != NULL) {
+    if (printed_if) {s4o.print(s4o.indent_spaces); s4o.print("} else ");}
+    s4o.print("{\n");
     s4o.indent_right();
     symbol->else_statement_list->accept(*this);
     s4o.indent_left();
+    printed_if = true;
   }
-  s4o.print(s4o.indent_spaces); s4o.print("}");
+  if (printed_if) {s4o.print(s4o.indent_spaces); s4o.print("}");}
   return NULL;
 }
 
@@ -1171,25 +1424,145 @@ void *visit(case_statement_c *symbol) {
   s4o.print(" __case_expression = ");
   symbol->expression->accept(*this);
   s4o.print(";\n");
-  symbol->case_element_list->accept(*this);
+  if (case_switch.analyse(symbol))
+    print_case_switch(symbol);
+  else {
+    /* the case elements are tested in order, so each is only reached when the previous ones were not taken */
+    list_c *case_element_list = dynamic_cast<list_c *>(symbol->case_element_list);
+    std::vector<unsigned long long> taken;
+    unsigned long long reached = 0;
+    bool profiled = get_case_profile(symbol, reached, taken);
+    for (int i = 0; i < case_element_list->n; i++) {
+      s4o.print(s4o.indent_spaces + ((0 == i)? "if " : "else if "));
+      case_element_hint = profiled? stmt_profile_c::branch_hint(taken[i], reached) : 0;
+      if (profiled) reached -= std::min(reached, taken[i]);
+      case_element_list->get_element(i)->accept(*this);
+    }
+    if (symbol->statement_list != NULL) {
+      s4o.print(s4o.indent_spaces + "else {\n");
+      s4o.indent_right();
+      symbol->statement_list->accept(*this);
+      s4o.indent_left();
+      s4o.print(s4o.indent_spaces + "}\n");
+    }
+  }
+  s4o.indent_left();
+  s4o.print(s4o.indent_spaces + "}");
+  return NULL;
+}
+
+
+/* helper function for case_statement: print it as a switch(), with the case labels found by case_switch */
+void print_case_switch(case_statement_c *symbol) {
+  list_c *case_element_list = dynamic_cast<list_c *>(symbol->case_element_list);
+  /* NOTE: case_switch.analyse() will already have checked the case elements. A copy is made of the case
+   *       labels it found, since the statements below may contain another CASE that calls it again.
+   */
+  std::vector<std::vector<uint64_t> >   values      = case_switch.values;
+  std::vector<std::vector<symbol_c *> > enum_values = case_switch.enum_values;
+  bool                                  is_signed   = case_switch.is_signed;
+  /* With a profile (-O P), the value of the case element (with a single value) that is almost always taken */
+  std::vector<unsigned long long> taken;
+  unsigned long long reached = 0;
+  int expected = -1;
+  if (get_case_profile(symbol, reached, taken))
+    for (int i = 0; i < case_element_list->n; i++)
+      if ((values[i].size() == 1) && enum_values[i].empty() && (stmt_profile_c::branch_hint(taken[i], reached) > 0))
+        expected = i;
+  if (expected < 0)
+    s4o.print(s4o.indent_spaces + "switch (__case_expression) {\n");
+  else {
+    s4o.print(s4o.indent_spaces + "switch (__EXPECTED_VALUE(__case_expression, ");
+    if (is_signed) s4o.print((long long int)(int64_t)values[expected][0]);
+    else           s4o.print_long_long_integer(values[expected][0]);
+    s4o.print(")) {\n");
+  }
+  s4o.indent_right();
+  for (int i = 0; i < case_element_list->n; i++) {
+    case_element_c *case_element = dynamic_cast<case_element_c *>(case_element_list->get_element(i));
+    if (values[i].empty() && enum_values[i].empty()) continue;  /* all its values are in previous case elements */
+    for (unsigned int j = 0; j < values[i].size(); j++) {
+      s4o.print(s4o.indent_spaces + "case ");
+      if (is_signed) s4o.print((long long int)(int64_t)values[i][j]);
+      else           s4o.print_long_long_integer(values[i][j]);
+      s4o.print(":\n");
+    }
+    for (unsigned int j = 0; j < enum_values[i].size(); j++) {
+      s4o.print(s4o.indent_spaces + "case ");
+      enum_values[i][j]->accept(*this);
+      s4o.print(":\n");
+    }
+    s4o.print(s4o.indent_spaces + "{\n");
+    s4o.indent_right();
+    case_element->statement_list->accept(*this);
+    s4o.print(s4o.indent_spaces + "break;\n");
+    s4o.indent_left();
+    s4o.print(s4o.indent_spaces + "}\n");
+  }
   if (symbol->statement_list != NULL) {
-    s4o.print(s4o.indent_spaces + "else {\n");
+    s4o.print(s4o.indent_spaces + "default: {\n");
     s4o.indent_right();
     symbol->statement_list->accept(*this);
+    s4o.print(s4o.indent_spaces + "break;\n");
     s4o.indent_left();
     s4o.print(s4o.indent_spaces + "}\n");
   }
   s4o.indent_left();
-  s4o.print(s4o.indent_spaces + "}");
-  return NULL;
+  s4o.print(s4o.indent_spaces + "}\n");
 }
 
 
+/* helper function for case_statement: with a profile (-O P), the number of times the CASE
+ * was reached, and each of its case elements was taken (see generate_c_pgo.cc)
+ */
+bool get_case_profile(case_statement_c *symbol, unsigned long long &reached, std::vector<unsigned long long> &taken) {
+  list_c *case_element_list = dynamic_cast<list_c *>(symbol->case_element_list);
+  if ((NULL == stmt_profile__) || (NULL == case_element_list) || !stmt_profile__->get_count(symbol, reached)) return false;
+  taken.assign(case_element_list->n, 0);
+  for (int i = 0; i < case_element_list->n; i++) {
+    case_element_c *case_element = dynamic_cast<case_element_c *>(case_element_list->get_element(i));
+    if ((NULL == case_element) || !stmt_profile__->get_first_count(case_element->statement_list, symbol, taken[i])) return false;
+  }
+  return true;
+}
+
+/* helper function for if_statement: whether at most one of the conditions may be TRUE, i.e. they
+ * all compare the same variable to different constants, so they may be tested in any order.
+ */
+static bool exclusive_conditions(std::vector<symbol_c *> &conditions) {
+  symbol_c *var_name = NULL;
+  std::vector<std::pair<bool, uint64_t> > values;  /* (negative, value) */
+  for (unsigned int i = 0; i < conditions.size(); i++) {
+    equ_expression_c *equ = dynamic_cast<equ_expression_c *>(conditions[i]);
+    if ((NULL == equ) || (0 != constant_condition(equ))) return false;
+    symbolic_variable_c *variable = dynamic_cast<symbolic_variable_c *>(equ->l_exp);
+    symbol_c            *value    = equ->r_exp;
+    if (NULL == variable) {variable = dynamic_cast<symbolic_variable_c *>(equ->r_exp); value = equ->l_exp;}
+    if (NULL == variable) return false;
+    if (NULL == var_name) var_name = variable->var_name;
+    else if (0 != compare_identifiers(var_name, variable->var_name)) return false;
+    std::pair<bool, uint64_t> constant;
+    if      (value->const_value._int64.is_valid())  constant = std::make_pair(value->const_value._int64.get() < 0, (uint64_t)value->const_value._int64.get());
+    else if (value->const_value._uint64.is_valid()) constant = std::make_pair(false, value->const_value._uint64.get());
+    else return false;
+    for (unsigned int j = 0; j < values.size(); j++)
+      if (values[j] == constant) return false;
+    values.push_back(constant);
+  }
+  return true;
+}
+
 /* helper symbol for case_statement */
 void *visit(case_element_list_c *symbol) {return print_list(symbol, s4o.indent_spaces+"if ", s4o.indent_spaces+"else if ");}
 
 void *visit(case_element_c *symbol) {
+  /* the hint is only for this case element, not for the ones of a CASE in its statements */
+  int hint = case_element_hint;
+  case_element_hint = 0;
+  if      (hint > 0) s4o.print("(__LIKELY");
+  else if (hint < 0) s4o.print("(__UNLIKELY");
   symbol->case_list->accept(*this);
+  if (hint != 0) s4o.print(")");
   s4o.print(" {\n");
   s4o.indent_right();
   symbol->statement_list->accept(*this);
@@ -1232,12 +1605,65 @@ void *visit(case_list_c *symbol) {
 /********************************/
 /* B 3.2.4 Iteration Statements */
 /********************************/
+/* helper functions for the FOR loop */
+/* Returns true if the expression's value is known at compile time */
+static bool is_constant_int(symbol_c *symbol) {
+  return symbol->const_value._int64.is_valid() || symbol->const_value._uint64.is_valid();
+}
+
+/* Returns the sign of the constant BY expression of a FOR loop: 1 (positive), -1 (zero or negative), or 0 (not constant) */
+static int constant_by_sign(symbol_c *symbol) {
+  if (symbol->const_value._int64.is_valid())  return (symbol->const_value._int64.get()  > 0)? 1 : -1;
+  if (symbol->const_value._uint64.is_valid()) return (symbol->const_value._uint64.get() > 0)? 1 : -1;
+  return 0;
+}
+
+/* 1 if the condition is always TRUE, -1 if always FALSE, 0 if not a constant (i.e. folded by stage3) condition */
+static int constant_condition(symbol_c *expression) {
+  if (!expression->const_value._bool.is_valid()) return 0;
+  return expression->const_value._bool.get()? 1 : -1;
+}
+
 void *visit(for_statement_c *symbol) {
   /* Due to the way the GET/SET_GLOBAL accessor macros access VAR_GLOBAL variables,
    * these varibles cannot be used within a C for(;;) loop.
    * We must therefore implemnt the FOR END_FOR loop as a C while() loop
+   *
+   * The end and the increment (BY) values are evaluated only once, before the loop starts, and stored
+   * in local variables (unless they are constants). The loop test then no longer has to re-read
+   * these values (with the GET_VAR macros) on every iteration. When the sign of the increment value is
+   * known at compile time, only the comparison for that direction is generated.
    */
+  identifier_c end_value("__for_end");
+  identifier_c by_value ("__for_by");
+  symbol_c *end_expression = symbol->end_expression;
+  symbol_c *by_expression  = symbol->by_expression;
+  int       by_sign        = (NULL == by_expression)? 1 : constant_by_sign(by_expression);
+  bool      cache_end      = !is_constant_int(end_expression);
+  bool      cache_by       = (0 == by_sign);
+  end_value.datatype = symbol->control_variable->datatype; // set the stage3 anottation we need
+  by_value .datatype = symbol->control_variable->datatype; // set the stage3 anottation we need
+
   s4o.print("/* FOR ... */\n" + s4o.indent_spaces);
+  if (cache_end || cache_by) {
+    s4o.print("{\n");
+    s4o.indent_right();
+    if (cache_end) {
+      s4o.print(s4o.indent_spaces);
+      symbol->control_variable->datatype->accept(*this);
+      s4o.print(" ");
+      end_value.accept(*this);
+      s4o.print(";\n");
+    }
+    if (cache_by) {
+      s4o.print(s4o.indent_spaces);
+      symbol->control_variable->datatype->accept(*this);
+      s4o.print(" ");
+      by_value.accept(*this);
+      s4o.print(";\n");
+    }
+    s4o.print(s4o.indent_spaces);
+  }
   /* For the initialization part, we create an assignment_statement_c   */
   /* and have this visitor visit it!                                    */ 
   assignment_statement_c ini_assignment(symbol->control_variable, symbol->beg_expression);
@@ -1245,14 +1671,29 @@ void *visit(for_statement_c *symbol) {
   //symbol->control_variable->accept(*this);  // this does not work for VAR_GLOBAL variables
   //s4o.print(" = ");
   //symbol->beg_expression->accept(*this);
+  if (cache_end) {
+    s4o.print(";\n" + s4o.indent_spaces);
+    end_value.accept(*this);
+    s4o.print(" = ");
+    end_expression->accept(*this);
+    end_expression = &end_value;
+  }
+  if (cache_by) {
+    s4o.print(";\n" + s4o.indent_spaces);
+    by_value.accept(*this);
+    s4o.print(" = ");
+    by_expression->accept(*this);
+    by_expression = &by_value;
+  }
   
   /* comparison // check for end of loop */
   s4o.print(";\n" + s4o.indent_spaces + "while( ");
-  if (symbol->by_expression == NULL) {
-    /* increment by 1 */    
+  if (by_sign != 0) {
+    /* increment by 1, or by a constant value */
     symbol->control_variable->accept(*this);
-    s4o.print(" <= ");
-    symbol->end_expression->accept(*this);
+    s4o.print((by_sign > 0)? " <= (" : " >= (");
+    end_expression->accept(*this);
+    s4o.print(")");
   } else {
     /* increment by user defined value  */
     /* The user defined increment value may be negative, in which case
@@ -1263,27 +1704,41 @@ void *visit(for_statement_c *symbol) {
      * to use has to be done at runtime.
      */
     s4o.print("((");
-    symbol->by_expression->accept(*this);
+    by_expression->accept(*this);
     s4o.print(") > 0)? (");
     symbol->control_variable->accept(*this);
     s4o.print(" <= (");
-    symbol->end_expression->accept(*this);
+    end_expression->accept(*this);
     s4o.print(")) : (");
     symbol->control_variable->accept(*this);
     s4o.print(" >= (");
-    symbol->end_expression->accept(*this);
+    end_expression->accept(*this);
     s4o.print(")) ");
   }
   s4o.print(" ) {\n");
   
   /* the body part */
+  /* The accesses to the arrays using the control variable as subscript need not be checked (array_bounds_check__)
+   * if the loop limits are within the limits of the array, since the loop only ever runs with values between them.
+   */
+  symbolic_variable_c *control_variable = dynamic_cast<symbolic_variable_c *>(symbol->control_variable);
+  bool has_for_range = (   array_bounds_check__ && (NULL != control_variable)
+                        && VALID_CVALUE(int64, symbol->beg_expression) && VALID_CVALUE(int64, symbol->end_expression)
+                        && !for_variable_changed_c::get(symbol, control_variable->var_name));
+  if (has_for_range) {
+    for_range_t for_range = {control_variable->var_name,
+                             std::min(GET_CVALUE(int64, symbol->beg_expression), GET_CVALUE(int64, symbol->end_expression)),
+                             std::max(GET_CVALUE(int64, symbol->beg_expression), GET_CVALUE(int64, symbol->end_expression))};
+    for_ranges.push_back(for_range);
+  }
   s4o.indent_right();
   symbol->statement_list->accept(*this);
+  if (has_for_range) for_ranges.pop_back();
 
   /* increment part */
   s4o.print(s4o.indent_spaces + "/* BY ... (of FOR loop) */\n");
   s4o.print(s4o.indent_spaces); 
-  if (symbol->by_expression == NULL) {
+  if (by_expression == NULL) {
     /* increment by 1 */    
     /* For the increment part, we create an add_expression_c and assignment_statement_c   */
     /* and have this visitor vist the latter!                                             */ 
@@ -1301,7 +1756,7 @@ void *visit(for_statement_c *symbol) {
     /* increment by user defined value  */
     /* For the increment part, we create an add_expression_c and assignment_statement_c   */
     /* and have this visitor vist the latter!                                             */ 
-    add_expression_c       add_expression(symbol->control_variable, symbol->by_expression);
+    add_expression_c       add_expression(symbol->control_variable, by_expression);
     assignment_statement_c inc_assignment(symbol->control_variable, &add_expression);
     add_expression.datatype = symbol->control_variable->datatype; // set the stage3 anottation we need
     inc_assignment.accept(*this);
@@ -1313,10 +1768,20 @@ void *visit(for_statement_c *symbol) {
   
   s4o.indent_left();
   s4o.print(";\n" + s4o.indent_spaces + "} /* END_FOR */");
+  if (cache_end || cache_by) {
+    s4o.indent_left();
+    s4o.print("\n" + s4o.indent_spaces + "}");
+  }
   return NULL;
 }
 
 void *visit(while_statement_c *symbol) {
+  /* the loop is dropped when its condition is always FALSE */
+  if (constant_condition(symbol->expression) < 0) {
+    print_dead_code(symbol->expression);
+    print_dead_code(symbol->statement_list);
+    return NULL;
+  }
   s4o.print("while (");
   symbol->expression->accept(*this);
   s4o.print(") {\n");
@@ -0,0 +1,123 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+
+/*
+ * The list of the standard functions used by the generated code (only with '-O m').
+ *
+ * Once all the C files have been generated, they are scanned for the names of the standard
+ * functions they call (e.g. ADD__INT__INT__INT, INT_TO_REAL, SIN_REAL, ...), and the STD_LIB_USED.h
+ * file is generated with a '#define __STD_USED_<name> ~,1' for each one of them. The generated C
+ * files include STD_LIB_USED.h before iec_std_lib.h, which will then only compile the code of the
+ * standard functions that were listed (see USE_STD_LIB_USED in iec_std_lib.h).
+ *
+ * The names are taken from the generated C code itself (and not from the AST), as that is the only place
+ * where the name of every C function called is sure to be found, whatever code generated the call
+ * (function invocations in ST and IL, IL operators, comparisons of TIME and STRING, ...), and including
+ * the files of the POUs that were generated in a previous run or by the worker processes.
+ * Any identifier starting with the name of a function (followed by '_') is listed. Listing a name
+ * that is not a standard function is harmless.
+ */
+
+
+#define STD_LIB_USED_FILENAME "STD_LIB_USED"
+
+
+class std_lib_usage_c {
+  private:
+    std::string              builddir;
+    std::vector<std::string> files;     /* the C files compiled by the user, i.e. where we start scanning */
+    std::set<std::string>    scanned;   /* the files already scanned, including the #included ones */
+    std::set<std::string>    checked;   /* the identifiers already checked */
+    std::set<std::string>    used;      /* the (possible) names of the standard functions in use */
+
+    /* Returns true if the identifier is the name of a function, or starts with the name of a function followed by '_' */
+    static bool is_function_name(const std::string &identifier) {
+      for (size_t pos = identifier.find('_', 1); ; pos = identifier.find('_', pos + 1)) {
+        std::string prefix = identifier.substr(0, pos);
+        if (function_symtable.count(prefix.c_str()) > 0) return true;
+        if (std::string::npos == pos) return false;
+      }
+    }
+
+    void check_identifier(const std::string &identifier) {
+      /* The standard functions are all upper case. Those starting with '__' are always compiled. */
+      if ((identifier.compare(0, 2, "__") == 0) || !checked.insert(identifier).second) return;
+      for (size_t i = 0; i < identifier.size(); i++)
+        if (islower(identifier[i])) return;
+      if (is_function_name(identifier)) used.insert(identifier);
+    }
+
+    void scan_file(const std::string &filename) {
+      if (!scanned.insert(filename).second) return;
+      std::string text;
+      if (!stage4out_c::read_file(builddir.empty()? NULL : builddir.c_str(), filename, text))
+        return;  /* not generated by us, e.g. iec_std_lib.h */
+
+      std::vector<std::string> includes;
+      for (size_t i = 0; i < text.size(); ) {
+        char c = text[i];
+        if (isalpha(c) || ('_' == c)) {
+          size_t start = i;
+          while ((i < text.size()) && (isalnum(text[i]) || ('_' == text[i]))) i++;
+          check_identifier(text.substr(start, i - start));
+        } else if (isdigit(c)) {
+          /* skip numbers, so the suffix of 1.0E10 or 16#FF is not taken as an identifier */
+          while ((i < text.size()) && (isalnum(text[i]) || ('_' == text[i]) || ('.' == text[i]))) i++;
+        } else if (('#' == c) && (text.compare(i, 10, "#include \"") == 0)) {
+          size_t start = i + 10, end = text.find('"', start);
+          if (std::string::npos == end) break;
+          includes.push_back(text.substr(start, end - start));
+          i = end + 1;
+        } else i++;
+      }
+      for (unsigned int i = 0; i < includes.size(); i++) scan_file(includes[i]);
+    }
+
+  public:
+    void set_builddir(const char *dir) {builddir = (NULL == dir)? "" : dir;}
+    void add_file    (std::string filename) {files.push_back(filename);}
+
+    /* Generate the STD_LIB_USED.h file. Must only be called once all the generated files have been closed! */
+    void generate(void) {
+      for (unsigned int i = 0; i < files.size(); i++) scan_file(files[i]);
+      stage4out_c s4o(builddir.empty()? NULL : builddir.c_str(), STD_LIB_USED_FILENAME, "h");
+      s4o.print("/* FILE GENERATED BY iec2c */\n");
+      s4o.print("/* The standard functions called by the generated code (see USE_STD_LIB_USED in iec_std_lib.h) */\n");
+      s4o.print("#ifndef __STD_LIB_USED_H\n");
+      s4o.print("#define __STD_LIB_USED_H\n\n");
+      s4o.print("#define USE_STD_LIB_USED\n\n");
+      for (std::set<std::string>::iterator i = used.begin(); i != used.end(); i++)
+        s4o.print("#define __STD_USED_" + *i + " ~,1\n");
+      s4o.print("\n#endif /* __STD_LIB_USED_H */\n");
+    }
+};
@@ -0,0 +1,138 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+
+/*
+ * The pool of the string literals used in the code of a POU.
+ *
+ * Every distinct string literal used in the body of a POU is declared only once, as a static const STRING
+ * at the start of the C function that contains the code of the POU, e.g.:
+ *     __DECLARE_STRING_LITERAL(__str_literal_1, 5, "hello")
+ * and the code of the POU then accesses this constant (e.g. 'x := 'hello';' ---> 'x = __str_literal_1;')
+ * instead of building a new STRING with __STRING_LITERAL() every time the literal is used.
+ *
+ * The literals are numbered in the order they appear in the POU body, so the generate_c_st_c and
+ * generate_c_il_c objects that print the code of the POU find the same names as the code that printed
+ * the declarations, without having to share the pool.
+ *
+ * NOTE: Literals in the declarations of the POU (i.e. the initial values of the variables) are not placed
+ *       in the pool, as these are only used once, when the variables are initialised.
+ */
+
+
+class string_literal_pool_c: public iterator_visitor_c {
+  private:
+    symbol_c *scope;
+    bool collected;
+    /* the number of each literal, indexed by the parameters of its __STRING_LITERAL() */
+    std::map<std::string, int> index;
+    std::vector<std::string>   literals;
+
+    static symbol_c *get_body(symbol_c *scope) {
+      function_declaration_c       *function       = dynamic_cast<function_declaration_c       *>(scope);
+      function_block_declaration_c *function_block = dynamic_cast<function_block_declaration_c *>(scope);
+      program_declaration_c        *program        = dynamic_cast<program_declaration_c        *>(scope);
+      if (NULL != function)       return function      ->function_body;
+      if (NULL != function_block) return function_block->fblock_body;
+      if (NULL != program)        return program       ->function_block_body;
+      return NULL;
+    }
+
+    /* the POU body is only searched for literals the first time it is needed */
+    void collect(void) {
+      if (collected) return;
+      collected = true;
+      symbol_c *body = get_body(scope);
+      if (NULL != body) body->accept(*this);
+    }
+
+    static void print_name(stage4out_c &s4o, int number) {
+      s4o.print("__str_literal_");
+      s4o.print(number);
+    }
+
+    static void print_declaration(stage4out_c &s4o, int number, const std::string &params) {
+      s4o.print(s4o.indent_spaces + "__DECLARE_STRING_LITERAL(");
+      print_name(s4o, number);
+      s4o.print(", ");
+      s4o.print(params);
+      s4o.print(")\n");
+    }
+
+  public:
+    string_literal_pool_c(symbol_c *scope) {
+      this->scope = scope;
+      collected = false;
+    }
+    virtual ~string_literal_pool_c(void) {}
+
+    /* Print the declarations of the literals, to be placed at the start of the function containing the POU body */
+    void print_declarations(stage4out_c &s4o) {
+      collect();
+      if (literals.empty()) return;
+      s4o.print(s4o.indent_spaces + "// String literals\n");
+      for (unsigned int i = 0; i < literals.size(); i++) print_declaration(s4o, i + 1, literals[i]);
+      s4o.print("\n");
+    }
+
+    /* Print the declarations of the literals used by only a part of the POU body (e.g. a network of a PROGRAM
+     * placed in its own function, with parallel_networks__), with the numbers they have in the whole body.
+     */
+    void print_declarations(stage4out_c &s4o, symbol_c *code) {
+      collect();
+      string_literal_pool_c used(scope);
+      used.collected = true;
+      code->accept(used);
+      if (used.literals.empty()) return;
+      s4o.print(s4o.indent_spaces + "// String literals\n");
+      for (unsigned int i = 0; i < used.literals.size(); i++) print_declaration(s4o, index[used.literals[i]], used.literals[i]);
+      s4o.print("\n");
+    }
+
+    /* Print the name of the constant holding the literal. Returns false (and prints nothing) if it is not in the pool. */
+    bool print_literal(stage4out_c &s4o, single_byte_character_string_c *symbol) {
+      collect();
+      std::map<std::string, int>::iterator i = index.find(generate_c_base_c::string_literal_params(symbol));
+      if (i == index.end()) return false;
+      print_name(s4o, i->second);
+      return true;
+    }
+
+    void *visit(single_byte_character_string_c *symbol) {
+      std::string params = generate_c_base_c::string_literal_params(symbol);
+      if (index.find(params) != index.end()) return NULL;
+      literals.push_back(params);
+      index[params] = literals.size();
+      return NULL;
+    }
+}; /* string_literal_pool_c */
+
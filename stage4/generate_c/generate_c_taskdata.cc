@@ -0,0 +1,365 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2015  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+
+/*
+ * The placement of the data of each task (iec2c -O A).
+ *
+ * The owner of a PROGRAM instance is the task it runs WITH, or its resource when it has no task.
+ * The owner of a global variable (of the configuration, or of a resource) is the only owner of the
+ * PROGRAM instances writing it, which is found from:
+ *  - the global variables each POU writes, through its VAR_EXTERNAL: those assigned to (or to one of
+ *    their elements or fields), passed to a parameter of a FB or FUNCTION call (it may be a VAR_IN_OUT),
+ *    connected to an output of such a call, and the global FB instances called. The POU also writes
+ *    the globals written by the POUs it calls. The IL and SFC bodies may write any of their non CONSTANT
+ *    VAR_EXTERNAL (but only the calls are followed);
+ *  - the outputs of the PROGRAM instance connected to a global variable (PROGRAM ... (out => var)).
+ * A VAR_EXTERNAL refers to the global of its resource with the same name, or else to the one of the
+ * configuration.
+ *
+ * The PROGRAM instances and the globals with an owner are declared in the section of their owner
+ * (__TASK_DATA(<owner>)), which starts on a new cache line (__TASK_DATA_ALIGN(<domain>, <owner>)), and those
+ * written by several owners each in a cache line of their own (__SHARED_DATA), with a warning, since
+ * the tasks writing them still share that cache line. See iec_task_data.h.
+ *
+ * NOTE: The writes through a REF_TO, and by embedded C code (pragmas), are not seen.
+ */
+
+
+#include <stdarg.h>
+
+
+/* the non located global variables, "<domain>__<name>" (the domain is the resource, or the configuration) */
+static std::map<std::string, symbol_c *>             task_data_globals;
+/* the placement of the PROGRAM instances and global variables, by "<domain>__<name>" */
+static std::map<std::string, std::string>            task_data_placements;
+/* the owners of the variables declared in each domain */
+static std::map<std::string, std::set<std::string> > task_data_owners;
+/* the global variables written by each POU, by their name (once the POU is analysed) */
+static std::map<symbol_c *, std::set<std::string> >  task_data_pou_writes;
+
+
+/* The name of the symbol, as in the generated C code, in upper case (the identifiers are not case sensitive) */
+static std::string task_data_name(symbol_c *symbol) {
+  stage4out_string_c           str_s4o;
+  generate_c_base_and_typeid_c print_base(&str_s4o);
+  symbol->accept(print_base);
+  std::string name = str_s4o.get();
+  for (unsigned int i = 0; i < name.size(); i++) name[i] = toupper((unsigned char)name[i]);
+  return name;
+}
+
+
+static void task_data_warning(symbol_c *symbol, const char *msg, ...) {
+  va_list argptr;
+  va_start(argptr, msg);
+  if ((NULL != symbol) && (NULL != symbol->first_file))
+    fprintf(stderr, "%s:%d-%d..%d-%d: ", symbol->first_file.c_str(), symbol->first_line, symbol->first_column,
+                                         symbol->last_line, symbol->last_column);
+  fprintf(stderr, "warning: ");
+  vfprintf(stderr, msg, argptr);
+  fprintf(stderr, "\n");
+  va_end(argptr);
+}
+
+
+
+/* The names of the non located global variables of a VAR_GLOBAL list */
+class generate_c_taskdata_globals_c: public iterator_visitor_c {
+  private:
+    std::string domain;
+
+  public:
+    generate_c_taskdata_globals_c(std::string domain_): domain(domain_) {}
+
+    /*| global_var_spec ':' [located_var_spec_init|function_block_type_name] */
+    void *visit(global_var_decl_c *symbol) {
+      /* the located global variables ([global_var_name] location) only point to the memory of the runtime */
+      list_c *names = dynamic_cast<global_var_list_c *>(symbol->global_var_spec);
+      if (NULL == names) return NULL;
+      for (int i = 0; i < names->n; i++)
+        task_data_globals[domain + "__" + task_data_name(names->get_element(i))] = names->get_element(i);
+      return NULL;
+    }
+};
+
+
+
+/* The global variables written by the body of a POU */
+class generate_c_taskdata_c: public iterator_visitor_c {
+  private:
+    search_var_instance_decl_c *search_var_instance_decl;
+    std::set<std::string>      &writes;
+
+    generate_c_taskdata_c(symbol_c *pou, std::set<std::string> &writes_): writes(writes_) {
+      search_var_instance_decl = new search_var_instance_decl_c(pou);
+    }
+
+    ~generate_c_taskdata_c(void) {
+      delete search_var_instance_decl;
+    }
+
+    void add_call(symbol_c *pou_decl) {
+      if (NULL == pou_decl) return;
+      const std::set<std::string> &pou_writes = get_writes(pou_decl);
+      writes.insert(pou_writes.begin(), pou_writes.end());
+    }
+
+    /* The variable is written to (as opposed to being read) */
+    void write(symbol_c *variable) {
+      array_variable_c      *array_variable      = dynamic_cast<array_variable_c      *>(variable);
+      structured_variable_c *structured_variable = dynamic_cast<structured_variable_c *>(variable);
+      symbolic_variable_c   *symbolic_variable   = dynamic_cast<symbolic_variable_c   *>(variable);
+
+      if (NULL != array_variable) {
+        array_variable->subscript_list->accept(*this);
+        write(array_variable->subscripted_variable);
+        return;
+      }
+      if (NULL != structured_variable) {write(structured_variable->record_variable); return;}
+      if (NULL == symbolic_variable) {variable->accept(*this); return;}  /* e.g. a dereferenced pointer */
+      token_c *name = get_var_name_c::get_name(symbolic_variable);
+      search_var_instance_decl_c::vt_t vartype = search_var_instance_decl->get_vartype(symbolic_variable);
+      if ((NULL != name) && ((search_var_instance_decl_c::external_vt == vartype) || (search_var_instance_decl_c::global_vt == vartype)))
+        writes.insert(task_data_name(name));
+    }
+
+    /* The value passed to a parameter of a FB or FUNCTION call: a variable may be passed to a VAR_IN_OUT, and written */
+    void pass(symbol_c *expression) {
+      if (   (NULL != dynamic_cast<symbolic_variable_c   *>(expression))
+          || (NULL != dynamic_cast<array_variable_c      *>(expression))
+          || (NULL != dynamic_cast<structured_variable_c *>(expression)))
+        write(expression);
+      else
+        expression->accept(*this);
+    }
+
+    void pass_nonformal(symbol_c *nonformal_param_list) {
+      list_c *list = dynamic_cast<list_c *>(nonformal_param_list);
+      if (NULL != list)
+        for (int i = 0; i < list->n; i++) pass(list->get_element(i));
+    }
+
+    static symbol_c *get_body(symbol_c *pou, symbol_c **var_declarations) {
+      function_declaration_c       *function       = dynamic_cast<function_declaration_c       *>(pou);
+      function_block_declaration_c *function_block = dynamic_cast<function_block_declaration_c *>(pou);
+      program_declaration_c        *program        = dynamic_cast<program_declaration_c        *>(pou);
+      if (NULL != function)       {*var_declarations = function      ->var_declarations_list; return function      ->function_body;}
+      if (NULL != function_block) {*var_declarations = function_block->var_declarations;      return function_block->fblock_body;}
+      if (NULL != program)        {*var_declarations = program       ->var_declarations;      return program       ->function_block_body;}
+      return NULL;
+    }
+
+  public:
+    /* The global variables written by the POU, and by the POUs it calls */
+    static const std::set<std::string> &get_writes(symbol_c *pou) {
+      std::map<symbol_c *, std::set<std::string> >::iterator known = task_data_pou_writes.find(pou);
+      if (known != task_data_pou_writes.end()) return known->second;
+
+      /* FUNCTIONs and FBs may not be recursive, but we do not want to loop forever if one is */
+      std::set<std::string> &writes = task_data_pou_writes[pou];
+      symbol_c *var_declarations = NULL;
+      symbol_c *body = get_body(pou, &var_declarations);
+      if (NULL == body) return writes;
+      generate_c_taskdata_c analysis(pou, writes);
+      body->accept(analysis);
+      /* only the ST bodies are analysed, the others may write any of their VAR_EXTERNAL */
+      if ((NULL == dynamic_cast<statement_list_c *>(body)) && (NULL != var_declarations))
+        var_declarations->accept(analysis);
+      return writes;
+    }
+
+    /*| VAR_EXTERNAL [CONSTANT] external_declaration_list END_VAR */
+    void *visit(external_var_declarations_c *symbol) {
+      if (NULL == dynamic_cast<constant_option_c *>(symbol->option)) symbol->external_declaration_list->accept(*this);
+      return NULL;
+    }
+
+    /*  global_var_name ':' (simple_specification|subrange_specification|enumerated_specification|array_specification|prev_declared_structure_type_name|function_block_type_name */
+    void *visit(external_declaration_c *symbol) {
+      writes.insert(task_data_name(symbol->global_var_name));
+      return NULL;
+    }
+
+    /***************************************/
+    /* B.3 - Language ST (Structured Text) */
+    /***************************************/
+    void *visit(function_invocation_c *symbol) {
+      add_call(symbol->called_function_declaration);
+      if (NULL != symbol->formal_param_list) symbol->formal_param_list->accept(*this);
+      pass_nonformal(symbol->nonformal_param_list);
+      return NULL;
+    }
+
+    /********************/
+    /* B 3.2 Statements */
+    /********************/
+    void *visit(assignment_statement_c *symbol) {
+      write(symbol->l_exp);
+      symbol->r_exp->accept(*this);
+      return NULL;
+    }
+
+    /* the FB instance keeps its own state, and is written by the call */
+    void *visit(fb_invocation_c *symbol) {
+      write(symbol->fb_name);
+      add_call(symbol->called_fb_declaration);
+      if (NULL != symbol->formal_param_list) symbol->formal_param_list->accept(*this);
+      pass_nonformal(symbol->nonformal_param_list);
+      return NULL;
+    }
+
+    /* variable_name ':=' expression */
+    void *visit(input_variable_param_assignment_c *symbol) {
+      pass(symbol->expression);
+      return NULL;
+    }
+
+    /* [NOT] variable_name '=>' variable */
+    void *visit(output_variable_param_assignment_c *symbol) {
+      write(symbol->variable);
+      return NULL;
+    }
+
+    /****************************************/
+    /* B.2 - Language IL (Instruction List) */
+    /****************************************/
+    /* the IL bodies may write any of their VAR_EXTERNAL, only the POUs they call are added */
+    void *visit(il_function_call_c     *symbol) {add_call(symbol->called_function_declaration); return NULL;}
+    void *visit(il_formal_funct_call_c *symbol) {add_call(symbol->called_function_declaration); return NULL;}
+    void *visit(il_fb_call_c           *symbol) {add_call(symbol->called_fb_declaration);       return NULL;}
+};
+
+
+
+/* Find the owner of the PROGRAM instances and global variables of the configuration, and warn about
+ * the global variables written by several owners.
+ */
+static void analyse_task_data(configuration_declaration_c *configuration) {
+  std::string config_name = task_data_name(configuration->configuration_name);
+  std::map<std::string, std::set<std::string> > writers;  /* the owners writing each global variable */
+
+  task_data_globals.clear();
+  task_data_placements.clear();
+  task_data_owners.clear();
+  task_data_pou_writes.clear();
+  if (NULL != configuration->global_var_declarations) {
+    generate_c_taskdata_globals_c globals(config_name);
+    configuration->global_var_declarations->accept(globals);
+  }
+
+  /* a configuration with a single resource, or a list of resources */
+  std::vector<std::pair<std::string, single_resource_declaration_c *> > resources;
+  list_c *resource_list = dynamic_cast<list_c *>(configuration->resource_declarations);
+  if (NULL == resource_list) {
+    resources.push_back(std::make_pair(std::string("RESOURCE"), dynamic_cast<single_resource_declaration_c *>(configuration->resource_declarations)));
+  } else {
+    for (int i = 0; i < resource_list->n; i++) {
+      resource_declaration_c *resource = dynamic_cast<resource_declaration_c *>(resource_list->get_element(i));
+      if (NULL == resource) ERROR;
+      std::string resource_name = task_data_name(resource->resource_name);
+      if (NULL != resource->global_var_declarations) {
+        generate_c_taskdata_globals_c globals(resource_name);
+        resource->global_var_declarations->accept(globals);
+      }
+      resources.push_back(std::make_pair(resource_name, dynamic_cast<single_resource_declaration_c *>(resource->resource_declaration)));
+    }
+  }
+
+  for (unsigned int r = 0; r < resources.size(); r++) {
+    std::string resource_name = resources[r].first;
+    if (NULL == resources[r].second) ERROR;
+    list_c *programs = dynamic_cast<list_c *>(resources[r].second->program_configuration_list);
+    if (NULL == programs) ERROR;
+    for (int p = 0; p < programs->n; p++) {
+      program_configuration_c *program = dynamic_cast<program_configuration_c *>(programs->get_element(p));
+      if (NULL == program) ERROR;
+      std::string owner = resource_name;
+      if (NULL != program->task_name) owner += "__" + task_data_name(program->task_name);
+      task_data_placements[resource_name + "__" + task_data_name(program->program_name)] = "__TASK_DATA(" + owner + ")";
+      task_data_owners[resource_name].insert(owner);
+
+      program_type_symtable_t::iterator iter = program_type_symtable.find(program->program_type_name);
+      if (iter == program_type_symtable.end()) ERROR;
+      std::set<std::string> writes = generate_c_taskdata_c::get_writes(iter->second);
+      /* the outputs of the PROGRAM connected to a global variable (any_symbolic_variable '=>' data_sink) */
+      list_c *elements = dynamic_cast<list_c *>(program->prog_conf_elements);
+      for (int i = 0; (NULL != elements) && (i < elements->n); i++) {
+        prog_cnxn_sendto_c *sendto = dynamic_cast<prog_cnxn_sendto_c *>(elements->get_element(i));
+        if ((NULL != sendto) && (NULL != dynamic_cast<symbolic_variable_c *>(sendto->data_sink)))
+          writes.insert(task_data_name(get_var_name_c::get_name(sendto->data_sink)));
+      }
+
+      /* the global of the resource with the same name, or else the one of the configuration */
+      for (std::set<std::string>::iterator name = writes.begin(); name != writes.end(); name++) {
+        if      (task_data_globals.count(resource_name + "__" + *name) > 0) writers[resource_name + "__" + *name].insert(owner);
+        else if (task_data_globals.count(config_name   + "__" + *name) > 0) writers[config_name   + "__" + *name].insert(owner);
+      }
+    }
+  }
+
+  /* the globals no task writes stay where the C compiler puts them */
+  for (std::map<std::string, std::set<std::string> >::iterator global = writers.begin(); global != writers.end(); global++) {
+    std::string domain = global->first.substr(0, global->first.find("__"));
+    if (1 == global->second.size()) {
+      task_data_placements[global->first] = "__TASK_DATA(" + *global->second.begin() + ")";
+      task_data_owners[domain].insert(*global->second.begin());
+      continue;
+    }
+    task_data_placements[global->first] = "__SHARED_DATA";
+    std::string owners;
+    for (std::set<std::string>::iterator owner = global->second.begin(); owner != global->second.end(); owner++)
+      owners += (owners.empty()? "" : ", ") + *owner;
+    task_data_warning(task_data_globals[global->first], "global variable %s is written by several tasks (%s), which will share its cache line.",
+                      global->first.c_str(), owners.c_str());
+  }
+}
+
+
+/* The placement of a global variable or PROGRAM instance of the domain (a resource, or the configuration),
+ * or "" to leave it where the C compiler puts it.
+ */
+static std::string get_task_data_placement(symbol_c *domain, symbol_c *name) {
+  if ((NULL == domain) || task_data_placements.empty()) return "";
+  std::map<std::string, std::string>::iterator placement = task_data_placements.find(task_data_name(domain) + "__" + task_data_name(name));
+  return (placement == task_data_placements.end())? "" : placement->second;
+}
+
+
+/* Start the sections of the variables declared in the domain on a new cache line */
+static void print_task_data_alignment(stage4out_c &s4o, symbol_c *domain) {
+  std::string            domain_name = task_data_name(domain);
+  std::set<std::string> &owners      = task_data_owners[domain_name];
+  for (std::set<std::string>::iterator owner = owners.begin(); owner != owners.end(); owner++)
+    s4o.print("__TASK_DATA_ALIGN(" + domain_name + ", " + *owner + ")\n");
+  if (!owners.empty()) s4o.print("\n");
+}
@@ -33,8 +33,8 @@
  * 
  * 
  * Both the generate_c_typedecl_c and the generate_c_implicit_typedecl_c may set a stage4
- * annotation (in the stage4 annotation map of each symbol_c) named 
- *   "generate_c_annotaton__implicit_type_id"
+ * annotation (in the annotation_table_c declared in generate_c_base.cc) named 
+ *   implicit_type_id
  * If this annotation is set, the generate_c_base_c will print out this value instead of 
  * the datatype's name!
  * 
@@ -498,8 +498,21 @@ void *visit(enumerated_type_declaration_c *symbol) {
   current_typedefinition = enumerated_td;
   current_type_name = symbol->enumerated_type_name;
 
-  s4o_incl.print("__DECLARE_ENUMERATED_TYPE(");
-  current_type_name->accept(*generate_c_typeid);
+  /* The variables of an enumerated type with a list of values are stored in the smallest
+   * unsigned integer type that can hold all the values (usually a single byte), instead of a C enum.
+   */
+  enumerated_spec_init_c  *spec_init  = dynamic_cast<enumerated_spec_init_c *>(symbol->enumerated_spec_init);
+  enumerated_value_list_c *value_list = (NULL == spec_init)? NULL : dynamic_cast<enumerated_value_list_c *>(spec_init->enumerated_specification);
+  if (NULL != value_list) {
+    s4o_incl.print("__DECLARE_COMPACT_ENUMERATED_TYPE(");
+    current_type_name->accept(*generate_c_typeid);
+    if      (value_list->n <= 0x100)   s4o_incl.print(", USINT");
+    else if (value_list->n <= 0x10000) s4o_incl.print(", UINT");
+    else                               s4o_incl.print(", UDINT");
+  } else {
+    s4o_incl.print("__DECLARE_ENUMERATED_TYPE(");
+    current_type_name->accept(*generate_c_typeid);
+  }
   s4o_incl.print(",\n");
   s4o_incl.indent_right();
   symbol->enumerated_spec_init->accept(*this); // always calls enumerated_spec_init_c
@@ -568,9 +581,9 @@ void *visit(array_type_declaration_c *symbol) {
   current_typedefinition = none_td;
 
 end:  
-  symbol                 ->anotations_map["generate_c_annotaton__implicit_type_id"] = id;
-  symbol->datatype       ->anotations_map["generate_c_annotaton__implicit_type_id"] = id;
-  symbol->array_spec_init->anotations_map["generate_c_annotaton__implicit_type_id"] = id; // probably not needed, bu let's play safe.
+  implicit_type_id.set(symbol                 , id);
+  implicit_type_id.set(symbol->datatype       , id);
+  implicit_type_id.set(symbol->array_spec_init, id); // probably not needed, bu let's play safe.
   
   return NULL;
 }
@@ -1012,9 +1025,8 @@ void *visit(direct_variable_c *symbol) {
  * It will do the same for implicitly declared REF_TO datatypes.
  * 
  * Each new implicitly datatype will be atributed an alias, and a C datatype will be declared for that alias.
- * The alias itself will be stored (annotated) in the datatype object in the AST, using the annotation
- * map reserved for stage4 anotations. The alias is stored under the "generate_c_annotaton__implicit_type_id"
- * entry, and this entry will then be used whenever the name of the datatype is needed (to declare a varable,
+ * The alias itself will be stored (annotated) in the datatype object in the AST, using the implicit_type_id
+ * stage4 annotation (see generate_c_base.cc), and this annotation will then be used whenever the name of the datatype is needed (to declare a varable,
  * for example). 
  * 
  * The class will be called once for each POU declaration, and once for each derived datatype declaration.
@@ -1068,7 +1080,7 @@ class generate_c_implicit_typedecl_c: public iterator_visitor_c {
       ref_spec_init_c   ref_spec(symbol, NULL);
       ref_type_decl_c   ref_decl(id, &ref_spec);
       ref_decl.accept(*generate_c_typedecl_);
-      symbol->anotations_map["generate_c_annotaton__implicit_type_id"] = id;
+      implicit_type_id.set(symbol, id);
       return NULL;
     }
 
@@ -1078,10 +1090,9 @@ class generate_c_implicit_typedecl_c: public iterator_visitor_c {
     // SYM_REF2(ref_spec_init_c, ref_spec, ref_initialization)
     void *visit(ref_spec_init_c *symbol) {
       symbol->ref_spec->accept(*this); //--> always calls ref_spec_c or derived_datatype_identifier_c
-      int implicit_id_count = symbol->ref_spec->anotations_map.count("generate_c_annotaton__implicit_type_id");
-      if (implicit_id_count  > 1) ERROR;
-      if (implicit_id_count == 1)
-        symbol->anotations_map["generate_c_annotaton__implicit_type_id"] = symbol->ref_spec->anotations_map["generate_c_annotaton__implicit_type_id"];
+      symbol_c *type_id = implicit_type_id.get(symbol->ref_spec);
+      if (NULL != type_id)
+        implicit_type_id.set(symbol, type_id);
       return NULL;
     }
 
@@ -1099,10 +1110,9 @@ class generate_c_implicit_typedecl_c: public iterator_visitor_c {
     /* array_initialization may be NULL ! */
     void *visit(array_spec_init_c *symbol) {
       symbol->array_specification->accept(*this); //--> always calls array_specification_c or derived_datatype_identifier_c
-      int implicit_id_count = symbol->array_specification->anotations_map.count("generate_c_annotaton__implicit_type_id");
-      if (implicit_id_count  > 1) ERROR;
-      if (implicit_id_count == 1)
-        symbol->anotations_map["generate_c_annotaton__implicit_type_id"] = symbol->array_specification->anotations_map["generate_c_annotaton__implicit_type_id"];
+      symbol_c *type_id = implicit_type_id.get(symbol->array_specification);
+      if (NULL != type_id)
+        implicit_type_id.set(symbol, type_id);
       return NULL;
     }
 
@@ -1119,7 +1129,7 @@ class generate_c_implicit_typedecl_c: public iterator_visitor_c {
       array_decl.datatype = symbol->datatype;
       array_spec.datatype = symbol->datatype;
       array_decl.accept(*generate_c_typedecl_);
-      symbol->anotations_map["generate_c_annotaton__implicit_type_id"] = id;
+      implicit_type_id.set(symbol, id);
       return NULL;
     }
     
@@ -131,6 +131,14 @@ class generate_c_array_initialization_c: public generate_c_base_and_typeid_c {
 
       if (array_default_initialization != NULL && defined_values_count < array_size)
         array_default_initialization->accept(*this);
+      /* The C compiler fills in the elements left out at the end of the initializer with zeros,
+       * so large arrays with only a few initialised elements do not need all their values printed.
+       */
+      if ((defined_values_count < array_size) && is_zero_value(array_default_value)) {
+        if (defined_values_count == 0)
+          array_default_value->accept(*this);
+        defined_values_count = array_size;
+      }
       if (defined_values_count < array_size) {
         for (unsigned long long int i = defined_values_count; i < array_size; i++) {
           if (defined_values_count > 0)
@@ -143,6 +151,17 @@ class generate_c_array_initialization_c: public generate_c_base_and_typeid_c {
       s4o.print("}}");
     }
     
+    /* Whether the value of an array element is 0 in C */
+    static bool is_zero_value(symbol_c *value) {
+      integer_c         *integer = dynamic_cast<integer_c         *>(value);
+      real_c            *real    = dynamic_cast<real_c            *>(value);
+      boolean_literal_c *boolean = dynamic_cast<boolean_literal_c *>(value);
+      if (NULL != integer) return (strcmp(integer->value, "0") == 0);
+      if (NULL != real)    return (strcmp(real->value, "0") == 0) || (strcmp(real->value, "0.0") == 0);
+      if (NULL != boolean) return (NULL != dynamic_cast<boolean_false_c *>(boolean->value));
+      return false;
+    }
+
     void *visit(identifier_c *type_name) {
       type_symtable_t::iterator iter = type_symtable.end();
       switch (current_mode) {
@@ -202,13 +221,12 @@ class generate_c_array_initialization_c: public generate_c_base_and_typeid_c {
           if (array_default_value == NULL) ERROR;
           break;
         case typedecl_am: {
-            int implicit_id_count = symbol->anotations_map.count("generate_c_annotaton__implicit_type_id");
-            if (implicit_id_count  > 1) ERROR;
-            if (implicit_id_count == 1)
+            symbol_c *type_id = implicit_type_id.get(symbol);
+            if (NULL != type_id)
                 /* this is part of an implicitly declared datatype (i.e. inside a variable decaration), for which an equivalent C datatype
                  * has already been defined. So, we simly print out the id of that C datatpe...
                  */
-              symbol->anotations_map["generate_c_annotaton__implicit_type_id"]->accept(*this);
+              type_id->accept(*this);
             else
               symbol->non_generic_type_name->accept(*this);
             break;
@@ -864,6 +882,9 @@ class generate_c_vardecl_c: protected generate_c_base_and_typeid_c {
                   globalprototype_vf
                  } varformat_t;
 
+    /* How much the POU body uses a variable of its instance, see set_wanted_heat() */
+    typedef enum {any_vh, hot_vh, warm_vh, cold_vh, large_vh} var_heat_t;
+
 
   private:
     /* variable used to store the types of variables that need to be processed... */
@@ -893,6 +914,43 @@ class generate_c_vardecl_c: protected generate_c_base_and_typeid_c {
      * specific global variable declaration (with #define...)*/
     symbol_c *resource_name;
 
+    /* true while declaring the global variables of the configuration itself (with -O G, each
+     * resource has its own copy of these, see iec_global_snapshot.h)
+     */
+    bool configuration_globals;
+
+    /* See set_wanted_alignment() */
+    int wanted_alignment;
+    bool is_wanted_alignment(symbol_c *type) {
+      return (wanted_varformat != local_vf) || (wanted_alignment == 0) || (wanted_alignment == alignment_of(type));
+    }
+
+    /* See set_wanted_heat() */
+    var_heat_t wanted_heat;
+    const std::map<std::string, unsigned long long> *variable_accesses;
+    /* name == NULL for the variables accessed on every call of the POU (EN, ENO) */
+    bool is_wanted_heat(symbol_c *type, symbol_c *name, bool is_pointer = false) {
+      return (wanted_varformat != local_vf) || (wanted_heat == any_vh) || (wanted_heat == heat_of(type, name, is_pointer));
+    }
+
+    var_heat_t heat_of(symbol_c *type, symbol_c *name, bool is_pointer) {
+      if (!is_pointer && (NULL != type) && (   get_datatype_info_c::is_ANY_STRING_compatible(type)
+                                            || get_datatype_info_c::is_array(type)))
+        return large_vh;
+      if (NULL != name) {
+        token_c *token = dynamic_cast<token_c *>(name);
+        if ((NULL == token) || (NULL == variable_accesses)) return cold_vh;
+        std::string key;
+        for (const char *c = token->value; *c != '\0'; c++) key += toupper((unsigned char)*c);
+        std::map<std::string, unsigned long long>::const_iterator accesses = variable_accesses->find(key);
+        if ((accesses == variable_accesses->end()) || (0 == accesses->second)) return cold_vh;
+      }
+      if (!is_pointer && (NULL != type) && (   get_datatype_info_c::is_function_block(type)
+                                            || get_datatype_info_c::is_structure(type)))
+        return warm_vh;
+      return hot_vh;
+    }
+
     /* Holds the references to the type and initial value
      * of the variables currently being declared.
      * Please read the comment under var1_init_decl_c for further
@@ -920,7 +978,7 @@ class generate_c_vardecl_c: protected generate_c_base_and_typeid_c {
       */
       }
       /* When handling arrays we must make sure that we use the base datatype, since arrays use an aliased name in the C code!
-       *   This is done using a stage4 annotation (on the base datatype class) named "generate_c_annotaton__implicit_type_id"
+       *   This is done using a stage4 annotation (on the base datatype class) named implicit_type_id
        *   Note that we do this only _after_ determining the initial value, since in principle the derived array could have
        *   a default initial different to the base array datatype!
        */
@@ -1005,12 +1063,14 @@ class generate_c_vardecl_c: protected generate_c_base_and_typeid_c {
       list_c *list = dynamic_cast<list_c *>(symbol);
       /* should NEVER EVER occur!! */
       if (list == NULL) ERROR;
+      if (!is_wanted_alignment(this->current_var_type_symbol)) return NULL;
 
       /* now to produce the c equivalent... */
       if ((wanted_varformat == local_vf) ||
           (wanted_varformat == init_vf) ||
           (wanted_varformat == localinit_vf)) {
         for(int i = 0; i < list->n; i++) {
+          if (!is_wanted_heat(this->current_var_type_symbol, list->get_element(i), (current_vartype & inoutput_vt) != 0)) continue;
           s4o.print(s4o.indent_spaces);
           if (wanted_varformat == local_vf) {
             if (!is_fb) {
@@ -1192,10 +1252,60 @@ class generate_c_vardecl_c: protected generate_c_base_and_typeid_c {
       globalnamespace         = NULL;
       nv = NULL;
       resource_name = res_name;
+      wanted_alignment = 0;
+      wanted_heat = any_vh;
+      variable_accesses = NULL;
+      configuration_globals = false;
     }
 
     ~generate_c_vardecl_c(void) {}
 
+    /* The alignment (in bytes) of the C variables (__IEC_<type>_t, ...) declared for the IEC 61131-3
+     * variables of the given datatype. Pointers and the datatypes whose alignment is target
+     * dependent (or is not simple to calculate: arrays, structures, FBs, ...) are given the largest
+     * alignment, 8.
+     */
+    static int alignment_of(symbol_c *type) {
+      symbol_c *base = (NULL == type)? NULL : search_base_type_c::get_basetype_decl(type);
+      if (NULL == base) return 8;
+      const std::type_info &t = typeid(*base);
+      if ((t == typeid(bool_type_name_c )) || (t == typeid(safebool_type_name_c )) ||
+          (t == typeid(sint_type_name_c )) || (t == typeid(safesint_type_name_c )) ||
+          (t == typeid(usint_type_name_c)) || (t == typeid(safeusint_type_name_c)) ||
+          (t == typeid(byte_type_name_c )) || (t == typeid(safebyte_type_name_c )))
+        return 1;
+      if ((t == typeid(int_type_name_c  )) || (t == typeid(safeint_type_name_c  )) ||
+          (t == typeid(uint_type_name_c )) || (t == typeid(safeuint_type_name_c )) ||
+          (t == typeid(word_type_name_c )) || (t == typeid(safeword_type_name_c )))
+        return 2;
+      if ((t == typeid(dint_type_name_c )) || (t == typeid(safedint_type_name_c )) ||
+          (t == typeid(udint_type_name_c)) || (t == typeid(safeudint_type_name_c)) ||
+          (t == typeid(dword_type_name_c)) || (t == typeid(safedword_type_name_c)) ||
+          (t == typeid(real_type_name_c )) || (t == typeid(safereal_type_name_c )))
+        return 4;
+      return 8;
+    }
+
+    /* Only declare the variables with this alignment (local_vf only). 0 declares all variables.
+     * Used to declare the variables of a POU instance sorted by alignment, so as little
+     * memory as possible is lost to padding (stage4 option -O s).
+     */
+    void set_wanted_alignment(int alignment) {wanted_alignment = alignment;}
+
+    /* Only declare the variables of this heat (local_vf only), given the number of accesses to each variable
+     * (by its name, in upper case) made by the POU body. any_vh declares all variables.
+     * Used to declare the variables of a POU instance with those the body uses the most first, so fewer cache
+     * lines are touched by each call (stage4 option -O H):
+     *   hot_vh  : the elementary variables, and pointers (VAR_IN_OUT, VAR_EXTERNAL, located), that are accessed;
+     *   warm_vh : the FB instances and structures that are accessed;
+     *   cold_vh : the variables that are never accessed (e.g. configuration parameters);
+     *   large_vh: the STRINGs and ARRAYs, whether accessed or not.
+     */
+    void set_wanted_heat(var_heat_t heat, const std::map<std::string, unsigned long long> *accesses) {
+      wanted_heat = heat;
+      variable_accesses = accesses;
+    }
+
     void print(symbol_c *symbol, symbol_c *scope = NULL, const char *variable_prefix = NULL) {
       this->set_variable_prefix(variable_prefix);
       if (globalinit_vf == wanted_varformat)
@@ -1347,6 +1457,8 @@ void *visit(edge_declaration_c *symbol) {
 void *visit(en_param_declaration_c *symbol) {
   TRACE("en_declaration_c");
   update_type_init(symbol->type_decl);
+  if (!is_wanted_alignment(this->current_var_type_symbol)) return NULL;
+  if (!is_wanted_heat(this->current_var_type_symbol, NULL)) return NULL;
   if (wanted_varformat == finterface_vf) {
     finterface_var_count++;
   }  
@@ -1404,6 +1516,8 @@ void *visit(en_param_declaration_c *symbol) {
 
 void *visit(eno_param_declaration_c *symbol) {
   TRACE("eno_declaration_c");
+  if (!is_wanted_alignment(symbol->type)) return NULL;
+  if (!is_wanted_heat(symbol->type, NULL)) return NULL;
   if (wanted_varformat == finterface_vf) {
     finterface_var_count++;
   }
@@ -1783,6 +1897,8 @@ void *visit(located_var_decl_c *symbol) {
   /* now to produce the c equivalent... */
   switch(wanted_varformat) {
     case local_vf:
+      if (!is_wanted_alignment(NULL)) break; /* declared as a pointer */
+      if (!is_wanted_heat(NULL, symbol->variable_name, true)) break;
       s4o.print(s4o.indent_spaces);
       s4o.print(DECLARE_LOCATED);
       s4o.print("(");
@@ -1927,6 +2043,8 @@ void *visit(external_declaration_c *symbol) {
   switch (wanted_varformat) {
     case local_vf:
     case localinit_vf:
+      if (!is_wanted_alignment(NULL)) break; /* declared as a pointer */
+      if (!is_wanted_heat(NULL, symbol->global_var_name, true)) break;
       s4o.print(s4o.indent_spaces);
       if (is_fb)
         s4o.print(DECLARE_EXTERNAL_FB);
@@ -2151,12 +2269,19 @@ void *visit(global_var_list_c *symbol) {
     case local_vf:
     case localinit_vf:
       for(int i = 0; i < list->n; i++) {
+        /* with -O A, in the section of the task writing it (see generate_c_taskdata.cc) */
+        std::string placement = get_task_data_placement(this->resource_name, list->get_element(i));
         s4o.print(s4o.indent_spaces);
         if (is_fb)
           s4o.print(DECLARE_GLOBAL_FB);
+        else if (global_snapshots__ && configuration_globals)
+          s4o.print(DECLARE_GLOBAL_SNAPSHOT);
         else
           s4o.print(DECLARE_GLOBAL);
-        s4o.print("(");
+        if (!placement.empty())
+          s4o.print(std::string("_AT(") + placement + ",");
+        else
+          s4o.print("(");
         this->current_var_type_symbol->accept(*this);
         s4o.print(",");
         if(this->resource_name != NULL)
@@ -2481,8 +2606,10 @@ SYM_REF6(configuration_declaration_c, configuration_name, global_var_declaration
 void *visit(configuration_declaration_c *symbol) {
   TRACE("configuration_declaration_c");
 
+  configuration_globals = true;
   if(symbol->global_var_declarations)
     symbol->global_var_declarations->accept(*this); // will contain VAR_GLOBAL declarations!!
+  configuration_globals = false;
   symbol->resource_declarations->accept(*this);   // will contain PROGRAM declarations!!
   return NULL;
 }
@@ -0,0 +1,539 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+
+/*
+ * The static estimate of the worst case execution time of each POU and task (iec2c -O W[=<file>]).
+ *
+ * The cost of a POU is the cost of the longest path through its body, i.e. the sum of the costs of
+ * the operations it does (variable accesses, arithmetic, comparisons, branches, calls, ...), each
+ * taken from a cost table:
+ *  - IF and CASE statements cost their conditions, plus the most expensive of their branches;
+ *  - FOR loops cost their body times the number of iterations, when the limits and increment are
+ *    constants. The loops without a known bound (WHILE, REPEAT, and the other FOR loops) are
+ *    counted once, and make the estimate of the POU (and of the tasks calling it) unbounded;
+ *  - the calls to FUNCTIONs and FB instances cost the call itself, plus the cost of the called POU
+ *    (found through the call graph resolved by stage 3). The standard functions have a fixed cost;
+ *  - the IL instructions are all counted, and a jump back to a previous instruction (found with the
+ *    links between the IL instructions left by flow_control_analysis_c) is a loop without a bound;
+ *  - all the steps, actions and transitions of the SFCs are counted, as if they were all active.
+ * The cost of a task is the sum of the costs of its PROGRAM instances.
+ *
+ * The costs are in ns. The default cost table holds rough figures for a 32 bit microcontroller
+ * running at about 100 MHz, with a floating point unit. For any other target, give the table
+ * measured on the target itself, as a text file with one '<operation> <cost>' line per operation
+ * (with the names of the default table below, '#' starts a comment), with -O W=<file>.
+ *
+ * The estimate of each POU and task, next to the interval of the task, is written to WCET.csv.
+ * A warning is printed for every task whose estimate exceeds WCET_WARN_PERCENT of its interval,
+ * or that has no bound, and for every resource whose tasks, when all due on the same tick, take
+ * longer than the tick itself.
+ *
+ * NOTE: This is an estimate, not a proof: it ignores the caches, the interrupts, the time spent in
+ *       the runtime, and the ST code does not map exactly to the operations in the cost table.
+ */
+
+
+#include <fstream>
+#include <stdarg.h>
+
+
+/* the tasks whose estimate exceeds this share of their interval (in %) get a warning */
+#define WCET_WARN_PERCENT  80
+
+
+static const struct {const char *name; double cost;} wcet_default_costs[] = {
+  {"variable",         1.0},  /* reading or writing a variable */
+  {"array_index",      4.0},  /* each subscript of an array (including the bounds check) */
+  {"assign",           1.0},  /* an assignment */
+  {"add",              1.0},  /* +, - (integers) */
+  {"mul",              2.0},  /* * (integers) */
+  {"div",             10.0},  /* /, MOD (integers) */
+  {"expt",           200.0},  /* ** */
+  {"compare",          1.0},  /* =, <>, <, >, <=, >= (integers) */
+  {"logic",            1.0},  /* AND, OR, XOR, NOT */
+  {"real_add",         2.0},  /* +, - (REAL and LREAL) */
+  {"real_mul",         2.0},  /* * (REAL and LREAL) */
+  {"real_div",        15.0},  /* / (REAL and LREAL) */
+  {"real_compare",     2.0},  /* =, <>, <, >, <=, >= (REAL and LREAL) */
+  {"branch",           3.0},  /* each condition of an IF, CASE or loop */
+  {"call",            20.0},  /* a call to a FUNCTION */
+  {"fb_call",         30.0},  /* a call to an FB instance */
+  {"std_function",    50.0},  /* a call to a standard function (SIN, LIMIT, the conversions, ...) */
+  {"il_instruction",   2.0},  /* an IL instruction */
+  {"sfc_step",        20.0},  /* a step of an SFC */
+  {"sfc_transition",   5.0},  /* a transition of an SFC */
+  {NULL, 0}
+};
+
+
+static std::map<std::string, double> wcet_costs__;  /* the cost table in use, see load_wcet_costs() */
+
+static void init_wcet_costs(void) {
+  if (!wcet_costs__.empty()) return;
+  for (int i = 0; NULL != wcet_default_costs[i].name; i++)
+    wcet_costs__[wcet_default_costs[i].name] = wcet_default_costs[i].cost;
+}
+
+/* Load the cost table of the target. The operations not in the file keep their default cost. */
+static bool load_wcet_costs(const char *filename) {
+  init_wcet_costs();
+  std::ifstream file(filename);
+  std::string   line;
+  if (!file.is_open()) return false;
+  while (std::getline(file, line)) {
+    size_t comment = line.find('#');
+    if (comment != std::string::npos) line.erase(comment);
+    char name[64];
+    double cost;
+    int n = sscanf(line.c_str(), "%63s %lf", name, &cost);
+    if (n <= 0) continue;  /* empty line */
+    if ((n != 2) || (wcet_costs__.count(name) == 0) || (cost < 0)) {
+      fprintf(stderr, "%s: invalid cost table entry: %s\n", filename, line.c_str());
+      return false;
+    }
+    wcet_costs__[name] = cost;
+  }
+  return true;
+}
+
+
+static void wcet_warning(symbol_c *symbol, const char *msg, ...) {
+  va_list argptr;
+  va_start(argptr, msg);
+  if ((NULL != symbol) && (NULL != symbol->first_file))
+    fprintf(stderr, "%s:%d-%d..%d-%d: ", symbol->first_file.c_str(), symbol->first_line, symbol->first_column,
+                                         symbol->last_line, symbol->last_column);
+  fprintf(stderr, "warning: ");
+  vfprintf(stderr, msg, argptr);
+  fprintf(stderr, "\n");
+  va_end(argptr);
+}
+
+
+
+class generate_c_wcet_c: public iterator_visitor_c {
+  private:
+    typedef struct {
+      double cost;
+      bool   bounded;  /* false if it has a loop without a known bound */
+    } wcet_t;
+
+    std::set<symbol_c *>           user_pous;   /* the POUs with code generated, i.e. not those of the standard library */
+    std::vector<symbol_c *>        pou_order;
+    std::map<symbol_c *, wcet_t>   pou_costs;   /* the estimates already computed */
+    wcet_t                         current;     /* the estimate of what is being visited */
+
+    stage4out_string_c           str_s4o;
+    generate_c_base_and_typeid_c print_base;
+
+    std::string to_string(symbol_c *symbol) {
+      symbol->accept(print_base);
+      return str_s4o.get();
+    }
+
+    void add(const char *operation) {current.cost += wcet_costs__[operation];}
+
+    void add(const wcet_t &wcet) {
+      current.cost   += wcet.cost;
+      current.bounded = current.bounded && wcet.bounded;
+    }
+
+    /* The estimate of a symbol, on its own */
+    wcet_t estimate(symbol_c *symbol) {
+      wcet_t saved = current;
+      current.cost    = 0;
+      current.bounded = true;
+      if (NULL != symbol) symbol->accept(*this);
+      wcet_t result = current;
+      current = saved;
+      return result;
+    }
+
+    static void add_max(wcet_t &max, const wcet_t &wcet) {
+      if (wcet.cost > max.cost) max.cost = wcet.cost;
+      max.bounded = max.bounded && wcet.bounded;
+    }
+
+    static symbol_c *get_body(symbol_c *pou) {
+      function_declaration_c       *function       = dynamic_cast<function_declaration_c       *>(pou);
+      function_block_declaration_c *function_block = dynamic_cast<function_block_declaration_c *>(pou);
+      program_declaration_c        *program        = dynamic_cast<program_declaration_c        *>(pou);
+      if (NULL != function)       return function->function_body;
+      if (NULL != function_block) return function_block->fblock_body;
+      if (NULL != program)        return program->function_block_body;
+      return NULL;
+    }
+
+    /* The estimate of a call to a FUNCTION, not counting its parameters */
+    void add_function_call(symbol_c *function_decl) {
+      if ((NULL == function_decl) || (user_pous.count(function_decl) == 0)) {add("std_function"); return;}
+      add("call");
+      add(pou_cost(function_decl));
+    }
+
+    /* The estimate of a call to an FB instance, not counting its parameters */
+    void add_fb_call(symbol_c *fb_decl) {
+      add("fb_call");
+      if (NULL != fb_decl) add(pou_cost(fb_decl));
+    }
+
+    /* The operations on REAL and LREAL have their own cost */
+    void add_arithmetic(symbol_c *datatype, const char *operation, const char *real_operation) {
+      add(((NULL != datatype) && get_datatype_info_c::is_ANY_REAL(datatype))? real_operation : operation);
+    }
+
+    static bool get_constant(symbol_c *symbol, int64_t &value) {
+      if (NULL == symbol) return false;
+      if (VALID_CVALUE( int64, symbol)) {value = GET_CVALUE(int64, symbol); return true;}
+      if (VALID_CVALUE(uint64, symbol) && (GET_CVALUE(uint64, symbol) <= (uint64_t)INT64_MAX)) {value = GET_CVALUE(uint64, symbol); return true;}
+      return false;
+    }
+
+    static std::string format_cost(const wcet_t &wcet) {
+      char str[64];
+      snprintf(str, sizeof(str), "%s%.0f", wcet.bounded? "" : ">=", wcet.cost);
+      return str;
+    }
+
+    static std::string format_number(unsigned long long value) {
+      char str[32];
+      snprintf(str, sizeof(str), "%llu", value);
+      return str;
+    }
+
+    static std::string format_load(const wcet_t &wcet, unsigned long long interval) {
+      if (0 == interval) return "";
+      char str[32];
+      snprintf(str, sizeof(str), "%.1f%%", wcet.cost * 100 / interval);
+      return str;
+    }
+
+  public:
+    generate_c_wcet_c(void): print_base(&str_s4o) {
+      init_wcet_costs();
+      current.cost    = 0;
+      current.bounded = true;
+    }
+
+    /* Called for every user FUNCTION, FUNCTION_BLOCK and PROGRAM */
+    void add_pou(symbol_c *pou) {
+      user_pous.insert(pou);
+      pou_order.push_back(pou);
+    }
+
+    /* The estimate of one execution of the body of a POU */
+    wcet_t pou_cost(symbol_c *pou) {
+      std::map<symbol_c *, wcet_t>::iterator i = pou_costs.find(pou);
+      if (i != pou_costs.end()) return i->second;
+      /* a POU calling itself (not allowed by IEC 61131-3) has no bound */
+      wcet_t unbounded = {0, false};
+      pou_costs[pou] = unbounded;
+      wcet_t wcet = estimate(get_body(pou));
+      pou_costs[pou] = wcet;
+      return wcet;
+    }
+
+    /* Print WCET.csv, and the warnings about the tasks that may overrun */
+    void generate(stage4out_c &s4o, configuration_declaration_c *configuration, unsigned long long common_ticktime) {
+      s4o.print("// Estimate of the worst case execution time, in ns (see iec2c -O W)\n");
+      s4o.print("// POUs: kind;name;estimate\n");
+      for (unsigned int i = 0; i < pou_order.size(); i++) {
+        symbol_c *pou = pou_order[i];
+        function_declaration_c       *function       = dynamic_cast<function_declaration_c       *>(pou);
+        function_block_declaration_c *function_block = dynamic_cast<function_block_declaration_c *>(pou);
+        program_declaration_c        *program        = dynamic_cast<program_declaration_c        *>(pou);
+        if      (NULL != function)       s4o.print("FUNCTION;"       + to_string(function->derived_function_name));
+        else if (NULL != function_block) s4o.print("FUNCTION_BLOCK;" + to_string(function_block->fblock_name));
+        else if (NULL != program)        s4o.print("PROGRAM;"        + to_string(program->program_type_name));
+        else ERROR;
+        s4o.print(";" + format_cost(pou_cost(pou)) + ";\n");
+      }
+
+      s4o.print("\n// Tasks: resource;task;interval;estimate;load\n");
+      /* a configuration with a single resource, or a list of resources */
+      list_c *resources = dynamic_cast<list_c *>(configuration->resource_declarations);
+      if (NULL == resources) {
+        generate_resource(s4o, "RESOURCE", configuration->resource_declarations, common_ticktime);
+      } else {
+        for (int i = 0; i < resources->n; i++) {
+          resource_declaration_c *resource = dynamic_cast<resource_declaration_c *>(resources->get_element(i));
+          if (NULL == resource) ERROR;
+          generate_resource(s4o, to_string(resource->resource_name), resource->resource_declaration, common_ticktime);
+        }
+      }
+    }
+
+  private:
+    void generate_resource(stage4out_c &s4o, std::string resource_name, symbol_c *resource_declaration, unsigned long long common_ticktime) {
+      single_resource_declaration_c *resource = dynamic_cast<single_resource_declaration_c *>(resource_declaration);
+      if (NULL == resource) ERROR;
+      list_c *tasks    = dynamic_cast<list_c *>(resource->task_configuration_list);
+      list_c *programs = dynamic_cast<list_c *>(resource->program_configuration_list);
+      if (NULL == programs) ERROR;
+      wcet_t resource_wcet = {0, true};  /* all the tasks due on the same tick */
+
+      /* the tasks (index -1 for the programs not associated to any task, which run on every tick) */
+      for (int t = -1; t < ((NULL == tasks)? 0 : tasks->n); t++) {
+        task_configuration_c *task = (t < 0)? NULL : dynamic_cast<task_configuration_c *>(tasks->get_element(t));
+        std::string task_name = (NULL == task)? "" : to_string(task->task_name);
+        wcet_t wcet = {0, true};
+        int count = 0;
+        for (int p = 0; p < programs->n; p++) {
+          program_configuration_c *program = dynamic_cast<program_configuration_c *>(programs->get_element(p));
+          if (NULL == program) ERROR;
+          if ((NULL == program->task_name)? (NULL != task) : ((NULL == task) || (to_string(program->task_name) != task_name))) continue;
+          program_type_symtable_t::iterator iter = program_type_symtable.find(program->program_type_name);
+          if (iter == program_type_symtable.end()) ERROR;
+          wcet_t program_wcet = pou_cost(iter->second);
+          wcet.cost   += program_wcet.cost;
+          wcet.bounded = wcet.bounded && program_wcet.bounded;
+          count++;
+        }
+        if ((NULL == task) && (0 == count)) continue;
+
+        /* the programs with no task, and the tasks with a SINGLE trigger, are checked on every tick */
+        task_initialization_c *init = (NULL == task)? NULL : dynamic_cast<task_initialization_c *>(task->task_initialization);
+        unsigned long long interval = ((NULL == task) || (NULL == init) || (NULL != init->single_data_source))? 0 : calculate_time(init->interval_data_source);
+        if (NULL == task) interval = common_ticktime;
+        resource_wcet.cost   += wcet.cost;
+        resource_wcet.bounded = resource_wcet.bounded && wcet.bounded;
+
+        s4o.print(resource_name + ";" + task_name + ";" + format_number(interval) + ";" + format_cost(wcet) + ";" + format_load(wcet, interval) + ";\n");
+        std::string what = (NULL == task)? "the programs of resource " + resource_name + " with no task" : "task " + task_name + " of resource " + resource_name;
+        if (!wcet.bounded)
+          wcet_warning(task, "no bound on the execution time of %s (a loop with no constant bound), estimated >= %.0f ns.", what.c_str(), wcet.cost);
+        if ((interval > 0) && (wcet.cost > interval))
+          wcet_warning(task, "%s will overrun: estimated worst case execution time of %.0f ns, for an interval of %llu ns.", what.c_str(), wcet.cost, interval);
+        else if ((interval > 0) && (wcet.cost * 100 > (double)interval * WCET_WARN_PERCENT))
+          wcet_warning(task, "%s may overrun: estimated worst case execution time of %.0f ns, for an interval of %llu ns.", what.c_str(), wcet.cost, interval);
+      }
+
+      s4o.print(resource_name + ";;" + format_number(common_ticktime) + ";" + format_cost(resource_wcet) + ";" + format_load(resource_wcet, common_ticktime) + ";\n");
+      if (resource_wcet.cost > common_ticktime)
+        wcet_warning(resource_declaration, "the tasks of resource %s, when all due on the same tick, take an estimated %.0f ns, longer than the %llu ns tick.",
+                     resource_name.c_str(), resource_wcet.cost, common_ticktime);
+    }
+
+  public:
+/*********************/
+/* B 1.4 - Variables */
+/*********************/
+    void *visit(symbolic_variable_c *symbol) {add("variable"); return NULL;}
+
+/*************************************/
+/* B 1.4.2 - Multi-element variables */
+/*************************************/
+    void *visit(array_variable_c *symbol) {
+      symbol->subscripted_variable->accept(*this);
+      symbol->subscript_list->accept(*this);
+      list_c *subscripts = dynamic_cast<list_c *>(symbol->subscript_list);
+      for (int i = 0; (NULL != subscripts) && (i < subscripts->n); i++) add("array_index");
+      return NULL;
+    }
+
+/********************************************/
+/* B 1.6 Sequential Function Chart elements */
+/********************************************/
+    /* all the steps, actions and transitions are counted, as if all the steps were active */
+    void *visit(initial_step_c *symbol) {add("sfc_step"); return iterator_visitor_c::visit(symbol);}
+    void *visit(        step_c *symbol) {add("sfc_step"); return iterator_visitor_c::visit(symbol);}
+    void *visit(  transition_c *symbol) {
+      add("sfc_transition");
+      if (NULL != symbol->transition_condition) symbol->transition_condition->accept(*this);
+      return NULL;
+    }
+
+/****************************************/
+/* B.2 - Language IL (Instruction List) */
+/****************************************/
+    /* a jump back to an earlier instruction is a loop, with no known bound */
+    void *visit(instruction_list_c *symbol) {
+      std::map<symbol_c *, int> index;
+      for (int i = 0; i < symbol->n; i++) index[symbol->get_element(i)] = i;
+      for (int i = 0; i < symbol->n; i++) {
+        il_instruction_c *instruction = dynamic_cast<il_instruction_c *>(symbol->get_element(i));
+        if (NULL == instruction) continue;
+        for (unsigned int p = 0; p < instruction->prev_il_instruction.size(); p++) {
+          std::map<symbol_c *, int>::iterator prev = index.find(instruction->prev_il_instruction[p]);
+          if ((prev != index.end()) && (prev->second >= i)) current.bounded = false;
+        }
+        instruction->accept(*this);
+      }
+      return NULL;
+    }
+
+    void *visit(il_instruction_c        *symbol) {add("il_instruction"); return iterator_visitor_c::visit(symbol);}
+    void *visit(il_simple_instruction_c *symbol) {add("il_instruction"); return iterator_visitor_c::visit(symbol);}
+
+    void *visit(il_function_call_c     *symbol) {iterator_visitor_c::visit(symbol); add_function_call(symbol->called_function_declaration); return NULL;}
+    void *visit(il_formal_funct_call_c *symbol) {iterator_visitor_c::visit(symbol); add_function_call(symbol->called_function_declaration); return NULL;}
+    void *visit(il_fb_call_c           *symbol) {iterator_visitor_c::visit(symbol); add_fb_call(symbol->called_fb_declaration);           return NULL;}
+
+    /* the IL operators that call an FB instance (S1 FF1, CLK RTRIG1, ...) */
+    void *visit(  S_operator_c *symbol) {add_fb_call(symbol->called_fb_declaration); return NULL;}
+    void *visit(  R_operator_c *symbol) {add_fb_call(symbol->called_fb_declaration); return NULL;}
+    void *visit( S1_operator_c *symbol) {add_fb_call(symbol->called_fb_declaration); return NULL;}
+    void *visit( R1_operator_c *symbol) {add_fb_call(symbol->called_fb_declaration); return NULL;}
+    void *visit(CLK_operator_c *symbol) {add_fb_call(symbol->called_fb_declaration); return NULL;}
+    void *visit( CU_operator_c *symbol) {add_fb_call(symbol->called_fb_declaration); return NULL;}
+    void *visit( CD_operator_c *symbol) {add_fb_call(symbol->called_fb_declaration); return NULL;}
+    void *visit( PV_operator_c *symbol) {add_fb_call(symbol->called_fb_declaration); return NULL;}
+    void *visit( IN_operator_c *symbol) {add_fb_call(symbol->called_fb_declaration); return NULL;}
+    void *visit( PT_operator_c *symbol) {add_fb_call(symbol->called_fb_declaration); return NULL;}
+
+    void *visit( MUL_operator_c *symbol) {add("mul"); return NULL;}
+    void *visit( DIV_operator_c *symbol) {add("div"); return NULL;}
+    void *visit( MOD_operator_c *symbol) {add("div"); return NULL;}
+
+/***************************************/
+/* B.3 - Language ST (Structured Text) */
+/***************************************/
+/***********************/
+/* B 3.1 - Expressions */
+/***********************/
+    void *visit(    or_expression_c *symbol) {iterator_visitor_c::visit(symbol); add("logic"); return NULL;}
+    void *visit(   xor_expression_c *symbol) {iterator_visitor_c::visit(symbol); add("logic"); return NULL;}
+    void *visit(   and_expression_c *symbol) {iterator_visitor_c::visit(symbol); add("logic"); return NULL;}
+    void *visit(   not_expression_c *symbol) {iterator_visitor_c::visit(symbol); add("logic"); return NULL;}
+    void *visit(   equ_expression_c *symbol) {iterator_visitor_c::visit(symbol); add_arithmetic(symbol->l_exp->datatype, "compare", "real_compare"); return NULL;}
+    void *visit(notequ_expression_c *symbol) {iterator_visitor_c::visit(symbol); add_arithmetic(symbol->l_exp->datatype, "compare", "real_compare"); return NULL;}
+    void *visit(    lt_expression_c *symbol) {iterator_visitor_c::visit(symbol); add_arithmetic(symbol->l_exp->datatype, "compare", "real_compare"); return NULL;}
+    void *visit(    gt_expression_c *symbol) {iterator_visitor_c::visit(symbol); add_arithmetic(symbol->l_exp->datatype, "compare", "real_compare"); return NULL;}
+    void *visit(    le_expression_c *symbol) {iterator_visitor_c::visit(symbol); add_arithmetic(symbol->l_exp->datatype, "compare", "real_compare"); return NULL;}
+    void *visit(    ge_expression_c *symbol) {iterator_visitor_c::visit(symbol); add_arithmetic(symbol->l_exp->datatype, "compare", "real_compare"); return NULL;}
+    void *visit(   add_expression_c *symbol) {iterator_visitor_c::visit(symbol); add_arithmetic(symbol->datatype, "add", "real_add"); return NULL;}
+    void *visit(   sub_expression_c *symbol) {iterator_visitor_c::visit(symbol); add_arithmetic(symbol->datatype, "add", "real_add"); return NULL;}
+    void *visit(   neg_expression_c *symbol) {iterator_visitor_c::visit(symbol); add_arithmetic(symbol->datatype, "add", "real_add"); return NULL;}
+    void *visit(   mul_expression_c *symbol) {iterator_visitor_c::visit(symbol); add_arithmetic(symbol->datatype, "mul", "real_mul"); return NULL;}
+    void *visit(   div_expression_c *symbol) {iterator_visitor_c::visit(symbol); add_arithmetic(symbol->datatype, "div", "real_div"); return NULL;}
+    void *visit(   mod_expression_c *symbol) {iterator_visitor_c::visit(symbol); add("div");  return NULL;}
+    void *visit( power_expression_c *symbol) {iterator_visitor_c::visit(symbol); add("expt"); return NULL;}
+
+    void *visit(function_invocation_c *symbol) {
+      iterator_visitor_c::visit(symbol);
+      add_function_call(symbol->called_function_declaration);
+      return NULL;
+    }
+
+/*********************************/
+/* B 3.2.1 Assignment Statements */
+/*********************************/
+    void *visit(assignment_statement_c *symbol) {iterator_visitor_c::visit(symbol); add("assign"); return NULL;}
+
+/*****************************************/
+/* B 3.2.2 Subprogram Control Statements */
+/*****************************************/
+    void *visit(fb_invocation_c *symbol) {
+      if (NULL != symbol->formal_param_list)    symbol->formal_param_list   ->accept(*this);
+      if (NULL != symbol->nonformal_param_list) symbol->nonformal_param_list->accept(*this);
+      add_fb_call(symbol->called_fb_declaration);
+      return NULL;
+    }
+
+/********************************/
+/* B 3.2.3 Selection Statements */
+/********************************/
+    /* all the conditions, and the most expensive of the branches */
+    void *visit(if_statement_c *symbol) {
+      wcet_t branches = estimate(symbol->statement_list);
+      add(estimate(symbol->expression));
+      add("branch");
+      list_c *elseifs = dynamic_cast<list_c *>(symbol->elseif_statement_list);
+      for (int i = 0; (NULL != elseifs) && (i < elseifs->n); i++) {
+        elseif_statement_c *elseif = dynamic_cast<elseif_statement_c *>(elseifs->get_element(i));
+        if (NULL == elseif) ERROR;
+        add(estimate(elseif->expression));
+        add("branch");
+        add_max(branches, estimate(elseif->statement_list));
+      }
+      add_max(branches, estimate(symbol->else_statement_list));
+      add(branches);
+      return NULL;
+    }
+
+    /* the selector compared to every case, and the most expensive of the branches */
+    void *visit(case_statement_c *symbol) {
+      wcet_t branches = estimate(symbol->statement_list);
+      add(estimate(symbol->expression));
+      list_c *elements = dynamic_cast<list_c *>(symbol->case_element_list);
+      for (int i = 0; (NULL != elements) && (i < elements->n); i++) {
+        case_element_c *element = dynamic_cast<case_element_c *>(elements->get_element(i));
+        if (NULL == element) ERROR;
+        list_c *cases = dynamic_cast<list_c *>(element->case_list);
+        for (int c = 0; (NULL != cases) && (c < cases->n); c++) add("branch");
+        add_max(branches, estimate(element->statement_list));
+      }
+      add(branches);
+      return NULL;
+    }
+
+/********************************/
+/* B 3.2.4 Iteration Statements */
+/********************************/
+    void *visit(for_statement_c *symbol) {
+      int64_t beg, end, by = 1;
+      double iterations = 1;
+      bool bounded = get_constant(symbol->beg_expression, beg) && get_constant(symbol->end_expression, end)
+                  && ((NULL == symbol->by_expression) || get_constant(symbol->by_expression, by)) && (0 != by);
+      if (bounded) {
+        if      ((by > 0) && (end >= beg)) iterations = (double)(((uint64_t)end - (uint64_t)beg) / (uint64_t) by) + 1;
+        else if ((by < 0) && (end <= beg)) iterations = (double)(((uint64_t)beg - (uint64_t)end) / (uint64_t)-by) + 1;
+        else                               iterations = 0;
+      }
+      add(estimate(symbol->beg_expression));
+      add(estimate(symbol->end_expression));
+      add(estimate(symbol->by_expression));
+      /* each iteration: the body, the test, and the increment of the control variable */
+      wcet_t body = estimate(symbol->statement_list);
+      current.cost   += iterations * (body.cost + wcet_costs__["branch"] + wcet_costs__["add"] + wcet_costs__["assign"]) + wcet_costs__["branch"];
+      current.bounded = current.bounded && body.bounded && bounded;
+      return NULL;
+    }
+
+    /* counted as a single iteration, with no bound */
+    void *visit(while_statement_c *symbol) {
+      add(estimate(symbol->expression));
+      add(estimate(symbol->statement_list));
+      add("branch");
+      current.bounded = false;
+      return NULL;
+    }
+
+    void *visit(repeat_statement_c *symbol) {
+      add(estimate(symbol->statement_list));
+      add(estimate(symbol->expression));
+      add("branch");
+      current.bounded = false;
+      return NULL;
+    }
+};
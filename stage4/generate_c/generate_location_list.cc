@@ -30,7 +30,69 @@ class generate_location_list_c: public iterator_visitor_c {
   private:
     symbol_c *current_var_type_symbol;
     generate_c_base_c *generate_c_base;
-    
+
+    /* the located variables, for the process images (see generate_process_images()) */
+    typedef struct {
+      std::string name;      /* the name of the pointer to the variable, e.g. __IX0_0 */
+      std::string location;  /* e.g. %IX0.0 */
+      std::string type;      /* e.g. BOOL */
+      char area;             /* I, Q or M */
+      int  rank;             /* 0 for L, ..., 4 for X, so the largest variables are first in the image */
+      std::vector<unsigned long> address;
+    } located_var_t;
+    std::vector<located_var_t> located_vars;
+    std::set<std::string> located_names;
+
+    static bool located_var_lt(const located_var_t &a, const located_var_t &b) {
+      if (a.area != b.area) return a.area < b.area;
+      if (a.rank != b.rank) return a.rank < b.rank;
+      return a.address < b.address;
+    }
+
+    void add_located_var(const char *location) {
+      located_var_t var;
+      const char *c;
+
+      var.location = location;
+      var.name = "__";
+      for (c = location + 1; *c != '\0'; c++)
+        var.name += (*c == '.')? '_' : (char)toupper((unsigned char)*c);
+      /* the same location may be declared more than once */
+      if (!located_names.insert(var.name).second) return;
+
+      const char *type = get_datatype_info_c::get_id_str(current_var_type_symbol);
+      if (NULL == type) ERROR;
+      var.type = type;
+      var.area = toupper((unsigned char)location[1]);
+      c = location + 2;
+      switch (toupper((unsigned char)*c)) {
+        case 'L': var.rank = 0; c++; break;
+        case 'D': var.rank = 1; c++; break;
+        case 'W': var.rank = 2; c++; break;
+        case 'B': var.rank = 3; c++; break;
+        case 'X': var.rank = 4; c++; break;
+        default : var.rank = 4; break;
+      }
+      while (*c != '\0') {
+        char *end;
+        var.address.push_back(strtoul(c, &end, 10));
+        c = (*end == '.')? end + 1 : end;
+        if (end == c) break;  /* not a number, the address is not valid */
+      }
+      located_vars.push_back(var);
+    }
+
+    void print_image_name(stage4out_c &s4o_img, char area) {
+      s4o_img.print("__PROCESS_IMAGE_");
+      s4o_img.print(std::string(1, area));
+    }
+
+    void print_image_type(stage4out_c &s4o_img, char area) {
+      s4o_img.print("__process_image_");
+      s4o_img.print(std::string(1, area));
+      s4o_img.print("_t");
+    }
+
   public:
     generate_location_list_c(stage4out_c *s4o_ptr): s4o(*s4o_ptr) {
       generate_c_base = new generate_c_base_c(s4o_ptr);
@@ -96,6 +158,7 @@ class generate_location_list_c: public iterator_visitor_c {
         s4o.print(",");
         s4o.printlocation_comasep((symbol->value)+1);
         s4o.print(")\n");
+        add_located_var(symbol->value);
       }
       return NULL;
     }
@@ -151,4 +214,167 @@ class generate_location_list_c: public iterator_visitor_c {
       return NULL;
     }
 
+
+  public:
+    /* With -O q, generate PROCESS_IMAGE.h and PROCESS_IMAGE.c (see iec_process_image.h), once this
+     * visitor has gone through the whole library.
+     *
+     * The located variables of each area (%I, %Q, %M) are the members of the struct of the
+     * process image of that area, the largest ones first (so there is no padding), and then in
+     * the order of their address. The pointers to the located variables (e.g. __IX0_0), which the
+     * runtime would otherwise define using LOCATED_VARIABLES.h, point into the process images.
+     */
+    void generate_process_images(stage4out_c &s4o_h, stage4out_c &s4o_c) {
+      std::vector<char> areas;
+
+      std::sort(located_vars.begin(), located_vars.end(), located_var_lt);
+      for (unsigned int i = 0; i < located_vars.size(); i++)
+        if (areas.empty() || (areas.back() != located_vars[i].area))
+          areas.push_back(located_vars[i].area);
+
+      s4o_h.print("/*******************************************/\n");
+      s4o_h.print("/*     FILE GENERATED BY iec2c             */\n");
+      s4o_h.print("/* Editing this file is not recommended... */\n");
+      s4o_h.print("/*******************************************/\n\n");
+      s4o_h.print("#ifndef __PROCESS_IMAGE_H\n");
+      s4o_h.print("#define __PROCESS_IMAGE_H\n\n");
+      s4o_h.print("#include \"iec_process_image.h\"\n\n");
+      for (unsigned int a = 0; a < areas.size(); a++) {
+        s4o_h.print("typedef struct {\n");
+        for (unsigned int i = 0; i < located_vars.size(); i++) {
+          if (located_vars[i].area != areas[a]) continue;
+          s4o_h.print("  " + located_vars[i].type + " " + located_vars[i].name + "; /* " + located_vars[i].location + " */\n");
+        }
+        s4o_h.print("} ");
+        print_image_type(s4o_h, areas[a]);
+        s4o_h.print(";\nextern ");
+        print_image_type(s4o_h, areas[a]);
+        s4o_h.print(" ");
+        print_image_name(s4o_h, areas[a]);
+        s4o_h.print(";\n\n");
+      }
+      s4o_h.print("#endif //__PROCESS_IMAGE_H\n");
+
+      s4o_c.print("/*******************************************/\n");
+      s4o_c.print("/*     FILE GENERATED BY iec2c             */\n");
+      s4o_c.print("/* Editing this file is not recommended... */\n");
+      s4o_c.print("/*******************************************/\n\n");
+      print_library_defines(s4o_c);
+      s4o_c.print("#include <stddef.h>\n");
+      s4o_c.print("#include \"iec_std_lib.h\"\n");
+      s4o_c.print("#include \"PROCESS_IMAGE.h\"\n\n");
+      for (unsigned int a = 0; a < areas.size(); a++) {
+        print_image_type(s4o_c, areas[a]);
+        s4o_c.print(" ");
+        print_image_name(s4o_c, areas[a]);
+        s4o_c.print(";\n");
+      }
+      s4o_c.print("\n");
+      for (unsigned int i = 0; i < located_vars.size(); i++) {
+        s4o_c.print(located_vars[i].type + " *" + located_vars[i].name + " = &");
+        print_image_name(s4o_c, located_vars[i].area);
+        s4o_c.print("." + located_vars[i].name + ";\n");
+      }
+      s4o_c.print("\n");
+      for (unsigned int a = 0; a < areas.size(); a++) {
+        s4o_c.print("static const __process_image_var_t __process_image_");
+        s4o_c.print(std::string(1, areas[a]));
+        s4o_c.print("_vars[] = {\n");
+        for (unsigned int i = 0; i < located_vars.size(); i++) {
+          if (located_vars[i].area != areas[a]) continue;
+          s4o_c.print("  {\"" + located_vars[i].location + "\", offsetof(");
+          print_image_type(s4o_c, areas[a]);
+          s4o_c.print(", " + located_vars[i].name + "), sizeof(" + located_vars[i].type + ")},\n");
+        }
+        s4o_c.print("};\n\n");
+      }
+      /* NOTE: the array always has at least one element, as C does not allow empty arrays */
+      s4o_c.print("const unsigned long __process_images_count = ");
+      s4o_c.print(areas.size());
+      s4o_c.print(";\n\n");
+      s4o_c.print("const __process_image_t __process_images[] = {\n");
+      for (unsigned int a = 0; a < areas.size(); a++) {
+        s4o_c.print("  {'" + std::string(1, areas[a]) + "', &");
+        print_image_name(s4o_c, areas[a]);
+        s4o_c.print(", sizeof(");
+        print_image_name(s4o_c, areas[a]);
+        s4o_c.print("), __process_image_" + std::string(1, areas[a]) + "_vars, sizeof(__process_image_" + std::string(1, areas[a]) + "_vars) / sizeof(__process_image_var_t)},\n");
+      }
+      if (areas.empty())
+        s4o_c.print("  {0, NULL, 0, NULL, 0}\n");
+      s4o_c.print("};\n");
+    }
+
+
+    /* With -O B, generate RECORDER.c (see iec_input_recorder.h), once this visitor has gone
+     * through the whole library.
+     *
+     * The inputs recorded are the %I located variables, in the same order as in the process image
+     * of the inputs (-O q). The layout hash changes when the program has other inputs (or changes
+     * their type), so the replay refuses the logs recorded with another version of the program.
+     */
+    void generate_input_recorder(stage4out_c &s4o_c) {
+      std::vector<located_var_t> inputs;
+      std::string layout;
+
+      std::sort(located_vars.begin(), located_vars.end(), located_var_lt);
+      for (unsigned int i = 0; i < located_vars.size(); i++) {
+        if (located_vars[i].area != 'I') continue;
+        if (inputs.size() == 65535) {
+          /* the records refer to the inputs by a 16 bit index */
+          fprintf(stderr, "Warning: only the first 65535 %%I located variables are recorded (-O B)\n");
+          break;
+        }
+        inputs.push_back(located_vars[i]);
+        layout += located_vars[i].location + ":" + located_vars[i].type + ";";
+      }
+      /* 32 bit FNV-1a */
+      uint32_t hash = 2166136261U;
+      for (unsigned int i = 0; i < layout.size(); i++)
+        hash = (hash ^ (unsigned char)toupper(layout[i])) * 16777619U;
+
+      s4o_c.print("/*******************************************/\n");
+      s4o_c.print("/*     FILE GENERATED BY iec2c             */\n");
+      s4o_c.print("/* Editing this file is not recommended... */\n");
+      s4o_c.print("/*******************************************/\n\n");
+      s4o_c.print("/* The inputs recorded at the start of each cycle, see iec_input_recorder.h */\n\n");
+      print_library_defines(s4o_c);
+      s4o_c.print("#include <stddef.h>\n");
+      s4o_c.print("#include \"iec_std_lib.h\"\n");
+      s4o_c.print("#include \"iec_input_recorder.h\"\n\n");
+
+      /* the pointers to the located variables, defined by the runtime (or by PROCESS_IMAGE.c) */
+      for (unsigned int i = 0; i < inputs.size(); i++)
+        s4o_c.print("extern " + inputs[i].type + " *" + inputs[i].name + ";\n");
+      s4o_c.print("\n");
+
+      /* the values of the previous record, laid out by the C compiler */
+      s4o_c.print("typedef struct {\n");
+      for (unsigned int i = 0; i < inputs.size(); i++)
+        s4o_c.print("  " + inputs[i].type + " " + inputs[i].name + "; /* " + inputs[i].location + " */\n");
+      if (inputs.empty())
+        s4o_c.print("  char unused;\n");
+      s4o_c.print("} __input_values_t;\n\n");
+      s4o_c.print("static __input_values_t __input_values;\n");
+      s4o_c.print("unsigned char *const __input_recorder_values = (unsigned char *)&__input_values;\n");
+      s4o_c.print("const unsigned long __input_values_size = sizeof(__input_values_t);\n\n");
+
+      s4o_c.print("__input_recorder_t __input_recorder;\n\n");
+      s4o_c.print("const unsigned long __input_layout = ");
+      s4o_c.print((unsigned long)hash);
+      s4o_c.print("UL;\n\n");
+
+      /* NOTE: the array always has at least one element, as C does not allow empty arrays */
+      s4o_c.print("const unsigned long __input_vars_count = ");
+      s4o_c.print((unsigned long)inputs.size());
+      s4o_c.print(";\n\n");
+      s4o_c.print("const __input_var_t __input_vars[] = {\n");
+      for (unsigned int i = 0; i < inputs.size(); i++)
+        s4o_c.print("  {\"" + inputs[i].location + "\", (void **)&" + inputs[i].name + ", offsetof(__input_values_t, "
+                    + inputs[i].name + "), sizeof(" + inputs[i].type + ")},\n");
+      if (inputs.empty())
+        s4o_c.print("  {NULL, NULL, 0, 0}\n");
+      s4o_c.print("};\n");
+    }
+
 }; /* generate_location_list_c */
@@ -238,6 +238,24 @@ class generate_var_list_c: protected generate_c_base_and_typeid_c {
     bool configuration_defined;
     std::list<SYMBOL> current_symbol_list;
     search_type_symbol_c *search_type_symbol;
+
+    /* The entries of the debug variable table (-O y, see lib/C/iec_debug_table.h), one for each
+     * variable listed in the "Variables" section, collected while that section is generated.
+     */
+    typedef struct {
+      std::string path;        /* the path of the variable, as in VARIABLES.csv */
+      std::string c_name;      /* the variable in the generated C code (empty if not known) */
+      std::string c_type;      /* the C type, for the variables not inside a POU instance (empty for the others) */
+      std::string type_id;     /* __DEBUG_TYPE_<type> */
+      std::string value_type;  /* the type whose sizeof() is the size of the value */
+      bool        pointer;     /* a __IEC_<type>_p, or a pointer to an FB instance */
+    } debug_var_t;
+    std::vector<debug_var_t> debug_vars;
+    /* How the variables of the current scope are named in the generated C code:
+     * "<configuration>__", "<resource>__", "<resource>__<program>.", "<resource>__<program>.<fb>.", ...
+     * An empty string if not known.
+     */
+    std::vector<std::string> current_c_prefix;
     
   public:
     generate_var_list_c(stage4out_c *s4o_ptr, symbol_c *scope)
@@ -276,6 +294,7 @@ class generate_var_list_c: protected generate_c_base_and_typeid_c {
     void generate_variables(symbol_c *symbol) {
       s4o.print("// Variables\n");
       current_var_number = 0;
+      debug_vars.clear();
       configuration_defined = false;
       current_declarationtype = variables_dt;
       symbol->accept(*this);
@@ -302,6 +321,7 @@ class generate_var_list_c: protected generate_c_base_and_typeid_c {
           default:
            break;
       }
+      add_debug_var(symbol);
       print_var_number();
       s4o.print(";");
       switch (search_type_symbol->current_var_type_category) {
@@ -353,7 +373,9 @@ class generate_var_list_c: protected generate_c_base_and_typeid_c {
               current_name->symbol = symbol;
               tmp_var_type = this->current_var_type_symbol;
               current_symbol_list.push_back(*current_name);
+              current_c_prefix.push_back(debug_vars.back().c_name.empty()? "" : debug_vars.back().c_name + ".");
               this->current_var_type_symbol->accept(*this);
+              current_c_prefix.pop_back();
               current_symbol_list.pop_back();
               this->current_var_type_symbol = tmp_var_type;
           }
@@ -407,6 +429,229 @@ class generate_var_list_c: protected generate_c_base_and_typeid_c {
     }
 
 
+    /*****************************************************/
+    /* The debug variable table (-O y), in VARIABLES.c    */
+    /*****************************************************/
+    static std::string upper_str(const char *str) {
+      std::string upper(str);
+      for (unsigned int i = 0; i < upper.size(); i++)  upper[i] = toupper(upper[i]);
+      return upper;
+    }
+
+    static std::string token_str(symbol_c *symbol) {
+      token_c *token = dynamic_cast<token_c *>(symbol);
+      if (NULL == token) ERROR;
+      return upper_str(token->value);
+    }
+
+    static std::string number_str(unsigned int number) {
+      char str[16];
+      snprintf(str, sizeof(str), "%u", number);
+      return str;
+    }
+
+    /* the path of the variables, as printed by print_symbol_list() */
+    std::string symbol_list_str(void) {
+      std::string path;
+      std::list<SYMBOL>::iterator pt;
+      for(pt = current_symbol_list.begin(); pt != current_symbol_list.end(); pt++)
+        path += token_str(pt->symbol) + ".";
+      return path;
+    }
+
+    std::string steps_str(steps_c *symbol) {
+      if (symbol->step_name != NULL)  return token_str(symbol->step_name);
+      list_c *list = dynamic_cast<list_c *>(symbol->step_name_list);
+      if (NULL == list) ERROR;
+      std::string str;
+      for (int i = 0; i < list->n; i++)
+        str += ((i == 0)? "" : ",") + token_str(list->get_element(i));
+      return str;
+    }
+
+    /* the BOOL variables of the SFCs */
+    void add_debug_sfc_var(std::string path, std::string c_suffix) {
+      debug_var_t var;
+      var.path       = symbol_list_str() + path;
+      var.c_name     = (current_c_prefix.empty() || current_c_prefix.back().empty())? "" : current_c_prefix.back() + c_suffix;
+      var.type_id    = "__DEBUG_TYPE_BOOL";
+      var.value_type = "BOOL";
+      var.pointer    = false;
+      debug_vars.push_back(var);
+    }
+
+    void add_debug_var(symbol_c *symbol) {
+      debug_var_t var;
+      var.path    = symbol_list_str() + token_str(symbol);
+      var.pointer = (this->current_var_class_category != none_vcc);
+      const char *type_name = get_datatype_info_c::get_id_str(this->current_var_type_name);
+      if (search_type_symbol->current_var_type_category == search_type_symbol_c::function_block_vtc) {
+        var.type_id = "__DEBUG_TYPE_FB";
+      } else if (NULL != dynamic_cast<enumerated_type_declaration_c *>(this->current_var_type_symbol)) {
+        var.type_id = "__DEBUG_TYPE_ENUM";
+      } else if (get_datatype_info_c::is_ANY_ELEMENTARY    (this->current_var_type_symbol)
+              || get_datatype_info_c::is_ANY_SAFEELEMENTARY(this->current_var_type_symbol)) {
+        std::string base_name = get_datatype_info_c::get_id_str(this->current_var_type_symbol);
+        /* the SAFExxx datatypes are stored as the xxx datatypes */
+        if (base_name.compare(0, 4, "SAFE") == 0)  base_name = base_name.substr(4);
+        var.type_id = "__DEBUG_TYPE_" + base_name;
+      }
+
+      /* the unnamed located variables, and the variables of anonymous datatypes (e.g. STRING[20]), are not in the table */
+      bool known = (NULL != dynamic_cast<identifier_c *>(symbol)) && (NULL != type_name) && !var.type_id.empty()
+                && !current_c_prefix.empty() && !current_c_prefix.back().empty();
+      if (known) {
+        var.c_name     = current_c_prefix.back() + token_str(symbol);
+        var.value_type = upper_str(type_name);
+        /* the variables of the configuration and the resources (including the program instances) must be declared in VARIABLES.c */
+        std::string prefix = current_c_prefix.back();
+        if (prefix.compare(prefix.size() - 2, 2, "__") == 0) {
+          if      (search_type_symbol->current_var_type_category == search_type_symbol_c::function_block_vtc)  var.c_type = var.value_type;
+          else if (var.pointer)  var.c_type = "__IEC_" + var.value_type + "_p";
+          else                   var.c_type = "__IEC_" + var.value_type + "_t";
+        }
+      }
+      debug_vars.push_back(var);
+    }
+
+    /* NOTE: This must compute the same hash as __debug_hash(), in lib/C/iec_debug_table.h */
+    static uint32_t debug_hash(const std::string &path) {
+      uint32_t hash = 2166136261U;
+      for (unsigned int i = 0; i < path.size(); i++)
+        hash = (hash ^ (unsigned char)toupper(path[i])) * 16777619U;
+      return hash;
+    }
+
+    /* Print VARIABLES.c. Must be called after generate_variables(). */
+    void generate_debug_table(stage4out_c &s4o_c) {
+      unsigned int count = debug_vars.size();
+      s4o_c.print("/*******************************************/\n");
+      s4o_c.print("/*     FILE GENERATED BY iec2c             */\n");
+      s4o_c.print("/* Editing this file is not recommended... */\n");
+      s4o_c.print("/*******************************************/\n\n");
+      s4o_c.print("/* The table of the variables listed in VARIABLES.csv, see iec_debug_table.h, iec_debug_trace.h and iec_debug_force.h */\n\n");
+      print_library_defines(s4o_c);
+      s4o_c.print("#include \"iec_std_lib.h\"\n");
+      s4o_c.print("#include \"accessor.h\"\n");
+      s4o_c.print("#include \"POUS.h\"\n");
+      s4o_c.print("#include \"iec_debug_trace.h\"\n");
+      s4o_c.print("#include \"iec_debug_force.h\"\n\n");
+      s4o_c.print("__debug_trace_t __debug_trace;\n");
+      s4o_c.print("__debug_force_t __debug_force;\n\n");
+
+      /* the variables of the configuration and the resources */
+      for (unsigned int i = 0; i < count; i++) {
+        if (debug_vars[i].c_type.empty()) continue;
+        s4o_c.print("extern " + debug_vars[i].c_type + " " + debug_vars[i].c_name + ";\n");
+      }
+      s4o_c.print("\n");
+
+      /* NOTE: the arrays always have at least one element, as C does not allow empty arrays */
+      s4o_c.print("const unsigned long __debug_vars_count = ");
+      s4o_c.print(count);
+      s4o_c.print(";\n\n");
+      s4o_c.print("const __debug_var_t __debug_vars[] = {\n");
+      for (unsigned int i = 0; i < count; i++) {
+        const debug_var_t &var = debug_vars[i];
+        s4o_c.print(s4o_c.indent_level);
+        if (var.c_name.empty())
+          s4o_c.print("{NULL, 0, 0, 0}");
+        else
+          s4o_c.print("{(void *)&(" + var.c_name + "), " + var.type_id + ", " + (var.pointer? "__DEBUG_VAR_POINTER" : "0")
+                      + ", sizeof(" + var.value_type + ")}");
+        s4o_c.print(", /* ");
+        s4o_c.print(i);
+        s4o_c.print(" */\n");
+      }
+      if (count == 0)  s4o_c.print(s4o_c.indent_level + "{NULL, 0, 0, 0}\n");
+      s4o_c.print("};\n\n");
+
+      s4o_c.print("const char *const __debug_var_paths[] = {\n");
+      for (unsigned int i = 0; i < count; i++)
+        s4o_c.print(s4o_c.indent_level + "\"" + debug_vars[i].path + "\",\n");
+      if (count == 0)  s4o_c.print(s4o_c.indent_level + "NULL\n");
+      s4o_c.print("};\n\n");
+
+      /* an open addressing hash table (with linear probing), with at least twice as many slots as variables */
+      unsigned long slots = 2;
+      while (slots < 2 * (unsigned long)count)  slots *= 2;
+      std::vector<long> hash_table(slots, -1);
+      for (unsigned int i = 0; i < count; i++) {
+        unsigned long slot = debug_hash(debug_vars[i].path) & (slots - 1);
+        while (hash_table[slot] >= 0)  slot = (slot + 1) & (slots - 1);
+        hash_table[slot] = i;
+      }
+      s4o_c.print("const unsigned long __debug_var_hash_mask = ");
+      s4o_c.print(slots - 1);
+      s4o_c.print(";\n\n");
+      s4o_c.print("const long __debug_var_hash[] = {");
+      for (unsigned long slot = 0; slot < slots; slot++) {
+        if (slot % 16 == 0)  s4o_c.print("\n" + s4o_c.indent_level);
+        s4o_c.print(hash_table[slot]);
+        if (slot < slots - 1) s4o_c.print(",");
+      }
+      s4o_c.print("\n};\n");
+    }
+
+
+    /* Print SHARED_IMAGE.c (-O S=file), with the variables listed in the given file (see iec_shared_image.h),
+     * in the order they are listed. Must be called after generate_variables().
+     */
+    void generate_shared_image(stage4out_c &s4o_c, const std::vector<std::string> &paths) {
+      std::map<std::string, unsigned int> index;
+      for (unsigned int i = 0; i < debug_vars.size(); i++)  index[debug_vars[i].path] = i;
+
+      std::vector<unsigned int> shared;
+      for (unsigned int i = 0; i < paths.size(); i++) {
+        std::map<std::string, unsigned int>::iterator var = index.find(upper_str(paths[i].c_str()));
+        if ((var == index.end()) || debug_vars[var->second].c_name.empty() || (debug_vars[var->second].type_id == "__DEBUG_TYPE_FB"))
+          fprintf(stderr, "Warning: %s may not be placed in the shared image (-O S), as it is not a variable of an elementary or enumerated type in VARIABLES.csv\n", paths[i].c_str());
+        else
+          shared.push_back(var->second);
+      }
+
+      s4o_c.print("/*******************************************/\n");
+      s4o_c.print("/*     FILE GENERATED BY iec2c             */\n");
+      s4o_c.print("/* Editing this file is not recommended... */\n");
+      s4o_c.print("/*******************************************/\n\n");
+      s4o_c.print("/* The variables copied to the shared image at the end of each cycle, see iec_shared_image.h */\n\n");
+      print_library_defines(s4o_c);
+      s4o_c.print("#include \"iec_std_lib.h\"\n");
+      s4o_c.print("#include \"accessor.h\"\n");
+      s4o_c.print("#include \"POUS.h\"\n");
+      s4o_c.print("#include \"iec_shared_image.h\"\n\n");
+      s4o_c.print("__shared_image_header_t *__shared_image = NULL;\n\n");
+
+      /* the variables of the configuration and the resources */
+      for (unsigned int i = 0; i < shared.size(); i++) {
+        if (debug_vars[shared[i]].c_type.empty()) continue;
+        s4o_c.print("extern " + debug_vars[shared[i]].c_type + " " + debug_vars[shared[i]].c_name + ";\n");
+      }
+      s4o_c.print("\n");
+
+      /* the hash of the layout, i.e. of the paths and types of the variables */
+      std::string layout;
+      for (unsigned int i = 0; i < shared.size(); i++)
+        layout += debug_vars[shared[i]].path + ":" + debug_vars[shared[i]].value_type + ";";
+      s4o_c.print("const unsigned long __shared_image_layout = ");
+      s4o_c.print((unsigned long)debug_hash(layout));
+      s4o_c.print("UL;\n\n");
+
+      /* NOTE: the array always has at least one element, as C does not allow empty arrays */
+      s4o_c.print("const unsigned long __shared_vars_count = ");
+      s4o_c.print((unsigned long)shared.size());
+      s4o_c.print(";\n\n");
+      s4o_c.print("const __shared_var_t __shared_vars[] = {\n");
+      for (unsigned int i = 0; i < shared.size(); i++) {
+        const debug_var_t &var = debug_vars[shared[i]];
+        s4o_c.print(s4o_c.indent_level + "{\"" + var.path + "\", (void *)&(" + var.c_name + "), " + var.type_id + ", "
+                    + (var.pointer? "__DEBUG_VAR_POINTER" : "0") + ", sizeof(" + var.value_type + ")},\n");
+      }
+      if (shared.size() == 0)  s4o_c.print(s4o_c.indent_level + "{NULL, NULL, 0, 0, 0}\n");
+      s4o_c.print("};\n");
+    }
+
+
 /********************************/
 /* B 1.3.3 - Derived data types */
 /********************************/
@@ -872,6 +1117,7 @@ class generate_var_list_c: protected generate_c_base_and_typeid_c {
     /* INITIAL_STEP step_name ':' action_association_list END_STEP */
     //SYM_REF2(initial_step_c, step_name, action_association_list)
     void *visit(initial_step_c *symbol) {
+      add_debug_sfc_var(token_str(symbol->step_name) + ".X", "__step_list[" + number_str(step_number) + "].X");
       print_var_number();
       s4o.print(";VAR;");
       print_symbol_list();
@@ -888,6 +1134,7 @@ class generate_var_list_c: protected generate_c_base_and_typeid_c {
     /* STEP step_name ':' action_association_list END_STEP */
     //SYM_REF2(step_c, step_name, action_association_list)
     void *visit(step_c *symbol) {
+      add_debug_sfc_var(token_str(symbol->step_name) + ".X", "__step_list[" + number_str(step_number) + "].X");
       print_var_number();
       s4o.print(";VAR;");
       print_symbol_list();
@@ -910,6 +1157,11 @@ class generate_var_list_c: protected generate_c_base_and_typeid_c {
     /* integer -> may be NULL ! */
     //SYM_REF5(transition_c, transition_name, integer, from_steps, to_steps, transition_condition)
     void *visit(transition_c *symbol) {
+      steps_c *from_steps = dynamic_cast<steps_c *>(symbol->from_steps);
+      steps_c *to_steps   = dynamic_cast<steps_c *>(symbol->to_steps);
+      if ((NULL == from_steps) || (NULL == to_steps)) ERROR;
+      add_debug_sfc_var(steps_str(from_steps) + "->" + steps_str(to_steps),
+                        (sfc_no_debug__? "__transition_list[" : "__debug_transition_list[") + number_str(transition_number) + "]");
       print_var_number();
       s4o.print(";VAR;");
       print_symbol_list();
@@ -918,7 +1170,8 @@ class generate_var_list_c: protected generate_c_base_and_typeid_c {
       symbol->to_steps->accept(*this);
       s4o.print(";");
       print_symbol_list();
-      s4o.print("__debug_transition_list[");
+      /* without the SFC debug tables (-O d), the debugger can only see if the transition fired */
+      s4o.print(sfc_no_debug__? "__transition_list[" : "__debug_transition_list[");
       print_transition_number();
       s4o.print("];BOOL;BOOL;\n");
       transition_number++;
@@ -951,6 +1204,7 @@ class generate_var_list_c: protected generate_c_base_and_typeid_c {
     /* ACTION action_name ':' function_block_body END_ACTION */
     //SYM_REF2(action_c, action_name, function_block_body)
     void *visit(action_c *symbol) {
+      add_debug_sfc_var(token_str(symbol->action_name) + ".Q", "__action_list[" + number_str(action_number) + "].state");
       print_var_number();
       s4o.print(";VAR;");
       print_symbol_list();
@@ -1018,6 +1272,7 @@ class generate_var_list_c: protected generate_c_base_and_typeid_c {
       current_name = new SYMBOL;
       current_name->symbol = symbol->configuration_name;
       current_symbol_list.push_back(*current_name);
+      current_c_prefix.push_back(token_str(symbol->configuration_name) + "__");
       configuration_defined = true;
       
       switch (current_declarationtype) {
@@ -1030,6 +1285,7 @@ class generate_var_list_c: protected generate_c_base_and_typeid_c {
       }
 
       symbol->resource_declarations->accept(*this);
+      current_c_prefix.pop_back();
       current_symbol_list.pop_back();
       configuration_defined = false;
       return NULL;
@@ -1046,6 +1302,7 @@ class generate_var_list_c: protected generate_c_base_and_typeid_c {
       current_name = new SYMBOL;
       current_name->symbol = symbol->resource_name;
       current_symbol_list.push_back(*current_name);
+      current_c_prefix.push_back(token_str(symbol->resource_name) + "__");
 
       switch (current_declarationtype) {
         case variables_dt:
@@ -1059,6 +1316,7 @@ class generate_var_list_c: protected generate_c_base_and_typeid_c {
       
       symbol->resource_declaration->accept(*this);
       
+      current_c_prefix.pop_back();
       current_symbol_list.pop_back();
       return NULL;
     }
@@ -1066,7 +1324,13 @@ class generate_var_list_c: protected generate_c_base_and_typeid_c {
     /* task_configuration_list program_configuration_list */
     //SYM_REF2(single_resource_declaration_c, task_configuration_list, program_configuration_list)
     void *visit(single_resource_declaration_c *symbol) {
+      /* The programs of a configuration declared without any RESOURCE ... END_RESOURCE belong to
+       * an implicit resource named RESOURCE (see generate_c_resources_c).
+       */
+      bool implicit_resource = (current_c_prefix.size() == 1);  /* only the configuration's prefix */
+      if (implicit_resource) current_c_prefix.push_back("RESOURCE__");
       symbol->program_configuration_list->accept(*this);
+      if (implicit_resource) current_c_prefix.pop_back();
       return NULL;
     }
     
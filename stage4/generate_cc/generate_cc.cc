@@ -0,0 +1,1356 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2003-2011  Mario de Sousa (msousa@fe.up.pt)
+ *  Copyright (C) 2007-2011  Laurent Bessard and Edouard Tisserant
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+/*
+ * This is part of the 4th stage that generates
+ * C++ code (PLC.cc) equivalent to the ST code.
+ *
+ * The generated code includes the C++ standard library of lib/CC/iec_std_lib.hh, in which each
+ * standard function is a single (constexpr) template, so the C++ compiler resolves the overloads,
+ * the number of inputs of the extensible functions, and the TIME arithmetic at compile time, and
+ * may inline all of them. PLC.cc must be compiled as C++14 (e.g. g++ -std=c++14 -O2 -I lib/CC),
+ * and linked with a runtime compiled with USE_INT64_TIME (that defines __CURRENT_TIME), or else
+ * with -O m=<ticks>, that adds a main() running the configuration for that many ticks.
+ *
+ * PLC.cc defines (all names in upper case, as IEC 61131-3 is not case sensitive):
+ *  - for each FUNCTION:
+ *        <ret> <NAME>(<params>)
+ *    with the parameters in the order of their declaration, the VAR_INPUTs (and EN) by value,
+ *    the VAR_OUTPUTs (and ENO) by address (<NAME>__out, may be NULL), and the VAR_IN_OUTs by
+ *    reference;
+ *  - for each FUNCTION_BLOCK and PROGRAM, the type of its instances:
+ *        struct <NAME> {<variables>; void init(BOOL retain); void body(void);};
+ *    with a member for each VAR_INPUT, VAR_OUTPUT, VAR_IN_OUT and VAR, in the order of their
+ *    declaration, accessed directly (without the accessor macros of the C code). The VAR_IN_OUT of
+ *    the FB instances are copied in and out of the instance when it is called, as done by generate_c.
+ *    The standard timers TON, TOF and TP are those of iec_std_lib.hh (iec::TON, ...);
+ *  - the global variables GLOBAL__<NAME>, which the VAR_EXTERNALs access directly;
+ *  - for each resource, its PROGRAM instances <RESOURCE>__<INSTANCE>, and
+ *        void <RESOURCE>_init__(void)
+ *        void <RESOURCE>_run__(unsigned long tick)
+ *  - for the configuration, with the same C linkage as the code of generate_c:
+ *        unsigned long long common_ticktime__          (in ns)
+ *        void config_init__(void)
+ *        void config_run__(unsigned long tick)
+ *
+ * Only a subset of the language is supported:
+ *  - POUs written in ST (plus the standard FBs written in ST, e.g. R_TRIG, CTU, SR, when
+ *    they are used);
+ *  - the elementary types BOOL, SINT, INT, DINT, LINT, USINT, UINT, UDINT, ULINT, BYTE,
+ *    WORD, DWORD, LWORD, REAL, LREAL, TIME, DATE, TOD and DT (and the types derived from
+ *    these), and FB instances;
+ *  - the non string standard functions of tables 22 to 30 (except the BCD conversions), with
+ *    or without EN/ENO;
+ *  - periodic tasks.
+ * Anything else (strings, arrays, structures, enumerations, date literals, located variables,
+ * IL and SFC bodies, SINGLE tasks, ...) is reported as an error.
+ *
+ * NOTE: The integer divisions (and MOD) by 0 return 0, instead of trapping.
+ */
+
+
+#include <string>
+#include <sstream>
+#include <vector>
+#include <map>
+#include <limits>
+#include <typeinfo>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "generate_cc.hh"
+#include "../../absyntax_utils/absyntax_utils.hh"
+#include "../../main.hh" // required for ERROR() and ERROR_MSG() macros.
+#include "../stage4.hh"
+#include "../common/pou_table.hh"
+#include "../common/calculate_time.hh"
+
+
+#define STAGE4_ERROR(symbol1, symbol2, ...) {stage4err("while generating C++ code", symbol1, symbol2, __VA_ARGS__); exit(EXIT_FAILURE);}
+
+#define VALID_CVALUE(dtype, symbol)           ((symbol)->const_value._##dtype.is_valid())
+#define GET_CVALUE(dtype, symbol)             ((symbol)->const_value._##dtype.get())
+
+
+
+
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+
+
+/* the number of ticks run by the main() generated for testing (0 -> no main()) */
+static unsigned long long main_ticks__ = 0;
+
+
+#ifdef __unix__
+/* Parse command line options passed from main.c !! */
+#include <stdlib.h> // for getsubopt()
+int  stage4_parse_options(char *options) {
+  enum {MAIN_OPT = 0   /* option to generate a main() running the configuration for a number of ticks */
+        /*, SOME_OTHER_OPT, YET_ANOTHER_OPT */};
+  char *const token[] = {
+        /*       MAIN_OPT*/(char *)"m",
+        /* SOME_OTHER_OPT, ...             */
+        NULL };
+  /* unfortunately, the above commented out syntax for array initialization is valid in C, but not in C++ */
+
+  char *subopts = options;
+  char *value;
+
+  while (*subopts != '\0') {
+    switch (getsubopt(&subopts, token, &value)) {
+      case     MAIN_OPT: if ((NULL == value) || (strtoull(value, NULL, 10) < 1)) {
+                           fprintf(stderr, "Invalid number of ticks: -O m=%s\n", (NULL == value)? "" : value);
+                           return -1;
+                         }
+                         main_ticks__ = strtoull(value, NULL, 10);
+                         break;
+      default          : fprintf(stderr, "Unrecognized option: -O %s\n", value); return -1; break;
+     }
+  }
+  return 0;
+}
+
+
+void stage4_print_options(void) {
+  printf("          (options must be separated by commas. Example: 'm=100')\n");
+  printf("    m=n : also define main() and __CURRENT_TIME, that call config_init__() and then config_run__() for the ticks 0 to n-1, so PLC.cc may be run without a runtime.\n");
+}
+#else /* not __unix__ */
+/* getsubopt isn't supported with mingw,
+ *  then stage4 options aren't available on windows*/
+void stage4_print_options(void) {}
+int  stage4_parse_options(char *options) {return 0;}
+#endif
+
+void stage4_reset_options(void) {main_ticks__ = 0;}
+bool stage4_requires_stage3(void) {return true;}
+
+
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+
+
+/* The C++ type of an elementary IEC 61131-3 type (see iec_std_lib.hh) */
+typedef struct {
+  const char *name;   /* the type in C++ */
+  int  bits;
+  bool is_signed;
+  bool is_real;
+  bool is_bool;
+  bool is_time;       /* TIME, DATE, TOD and DT */
+} cc_type_t;
+
+static const cc_type_t cc_bool__  = {"BOOL",   8, false, false, true,  false};
+static const cc_type_t cc_sint__  = {"SINT",   8, true,  false, false, false};
+static const cc_type_t cc_int__   = {"INT",   16, true,  false, false, false};
+static const cc_type_t cc_dint__  = {"DINT",  32, true,  false, false, false};
+static const cc_type_t cc_lint__  = {"LINT",  64, true,  false, false, false};
+static const cc_type_t cc_usint__ = {"USINT",  8, false, false, false, false};
+static const cc_type_t cc_uint__  = {"UINT",  16, false, false, false, false};
+static const cc_type_t cc_udint__ = {"UDINT", 32, false, false, false, false};
+static const cc_type_t cc_ulint__ = {"ULINT", 64, false, false, false, false};
+static const cc_type_t cc_byte__  = {"BYTE",   8, false, false, false, false};
+static const cc_type_t cc_word__  = {"WORD",  16, false, false, false, false};
+static const cc_type_t cc_dword__ = {"DWORD", 32, false, false, false, false};
+static const cc_type_t cc_lword__ = {"LWORD", 64, false, false, false, false};
+static const cc_type_t cc_real__  = {"REAL",  32, true,  true,  false, false};
+static const cc_type_t cc_lreal__ = {"LREAL", 64, true,  true,  false, false};
+static const cc_type_t cc_time__  = {"TIME",  64, true,  false, false, true };
+static const cc_type_t cc_date__  = {"DATE",  64, true,  false, false, true };
+static const cc_type_t cc_tod__   = {"TOD",   64, true,  false, false, true };
+static const cc_type_t cc_dt__    = {"DT",    64, true,  false, false, true };
+
+
+/* Returns the C++ type of a datatype, or NULL if it is not one of the supported elementary types */
+static const cc_type_t *cc_elementary_type(symbol_c *type) {
+  if (NULL == type) return NULL;
+  symbol_c *base = search_base_type_c::get_basetype_decl(type);
+  if (NULL == base) return NULL;
+
+#define CC_TYPE(type_name, cc_type)                                                                \
+  if ((typeid(*base) == typeid(type_name##_type_name_c)) || (typeid(*base) == typeid(safe##type_name##_type_name_c))) \
+    return &cc_type;
+
+  CC_TYPE(bool,  cc_bool__ )
+  CC_TYPE(sint,  cc_sint__ )
+  CC_TYPE(int,   cc_int__  )
+  CC_TYPE(dint,  cc_dint__ )
+  CC_TYPE(lint,  cc_lint__ )
+  CC_TYPE(usint, cc_usint__)
+  CC_TYPE(uint,  cc_uint__ )
+  CC_TYPE(udint, cc_udint__)
+  CC_TYPE(ulint, cc_ulint__)
+  CC_TYPE(byte,  cc_byte__ )
+  CC_TYPE(word,  cc_word__ )
+  CC_TYPE(dword, cc_dword__)
+  CC_TYPE(lword, cc_lword__)
+  CC_TYPE(real,  cc_real__ )
+  CC_TYPE(lreal, cc_lreal__)
+  CC_TYPE(time,  cc_time__ )
+  CC_TYPE(date,  cc_date__ )
+  CC_TYPE(tod,   cc_tod__  )
+  CC_TYPE(dt,    cc_dt__   )
+#undef CC_TYPE
+  return NULL;
+}
+
+
+template<typename value_type> static std::string cc_num(value_type value) {
+  std::ostringstream str;
+  str << value;
+  return str.str();
+}
+
+
+/* A C++ integer literal (the literals that do not fit an int get their LL or ULL suffix) */
+static std::string cc_int_literal(int64_t value) {
+  if (value == std::numeric_limits<int64_t>::min()) return "(-9223372036854775807LL - 1)";
+  if ((value > std::numeric_limits<int32_t>::max()) || (value < -std::numeric_limits<int32_t>::max())) return cc_num(value) + "LL";
+  return cc_num(value);
+}
+
+static std::string cc_uint_literal(uint64_t value) {
+  if (value > (uint64_t)std::numeric_limits<int32_t>::max()) return cc_num(value) + "ULL";
+  return cc_num(value);
+}
+
+
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+
+
+/* The classes of the POUs and of their variables (see ../common/pou_table.hh) */
+class cc_backend_t {
+  public:
+    typedef cc_type_t type_t;
+    struct var_data_t {};
+    struct pou_data_t {};
+
+    static const type_t *elementary_type(symbol_c *type) {return cc_elementary_type(type);}
+    static const char *generating(void) {return "while generating C++ code";}
+    static const char *generator(void)  {return "C++ generator";}
+};
+
+typedef stage4_var_c<cc_backend_t>       cc_var_t;
+typedef stage4_pou_c<cc_backend_t>       cc_pou_c;
+typedef stage4_pou_table_c<cc_backend_t> cc_pou_table_c;
+typedef stage4_vardecl_c<cc_backend_t>   cc_vardecl_c;
+
+
+/* The type of the instances of an FB or PROGRAM in C++ (the POUs provided by iec_std_lib.hh are in the iec namespace) */
+static std::string cc_pou_type(cc_pou_c *pou) {return pou->provided? "iec::" + pou->name : pou->name;}
+
+
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+
+
+class generate_cc_c: public null_visitor_c {
+  private:
+    stage4out_c &s4o;
+    const char *builddir;
+
+    cc_pou_table_c pous;
+    std::vector<cc_var_t> globals;
+    std::map<std::string, cc_var_t *> externals;    /* the globals not declared in the library */
+    std::vector<configuration_declaration_c *> configurations;
+
+    /* the function being generated */
+    cc_pou_c *pou;
+    std::ostringstream *code;
+    std::string indent;
+    int tmp_count;
+    int loop_depth;
+    bool uses_end_label;
+
+    /* the expression being generated */
+    const cc_type_t *expr_type;
+    std::string result;
+
+  public:
+    generate_cc_c(stage4out_c *s4o_ptr, const char *builddir_): s4o(*s4o_ptr), builddir(builddir_) {
+      pou = NULL;
+      code = NULL;
+      tmp_count = loop_depth = 0;
+      uses_end_label = false;
+      expr_type = NULL;
+    }
+    ~generate_cc_c(void) {}
+
+
+  private:
+  /***********************/
+  /* Emitting statements */
+  /***********************/
+    void emit(const std::string &statement) {*code << indent << statement << "\n";}
+    void open_block(const std::string &head) {emit(head.empty()? "{" : head + " {"); indent += "  ";}
+    void close_block(const std::string &tail = "}") {indent.erase(indent.size() - 2); emit(tail);}
+    std::string new_tmp(const std::string &prefix) {return "__" + prefix + cc_num(tmp_count++);}
+
+    void begin_function(cc_pou_c *pou_) {
+      pou = pou_;
+      code = new std::ostringstream();
+      indent = "  ";
+      tmp_count = loop_depth = 0;
+      uses_end_label = false;
+    }
+    void end_function(std::ostringstream &module, const std::string &header) {
+      module << header << " {\n" << code->str() << "}\n\n";
+      delete code;
+      code = NULL;
+      pou = NULL;
+    }
+
+    void unsupported(symbol_c *symbol, const char *what) {
+      STAGE4_ERROR(symbol, symbol, "%s not supported by the C++ generator.", what);
+    }
+
+
+  /*************/
+  /* Constants */
+  /*************/
+    static std::string int_constant(uint64_t value, const cc_type_t *type) {
+      if (!type->is_signed) {
+        if (type->bits < 64) value &= (((uint64_t)1) << type->bits) - 1;
+        return std::string(type->name) + "(" + cc_uint_literal(value) + ")";
+      }
+      int64_t bits = (type->bits < 64)? ((int64_t)(value << (64 - type->bits))) >> (64 - type->bits) : (int64_t)value;
+      return std::string(type->name) + "(" + cc_int_literal(bits) + ")";
+    }
+
+    static bool real_constant(double value, const cc_type_t *type, std::string &str) {
+      if (isinf(value) || isnan(value)) return false;
+      char buf[40];
+      snprintf(buf, sizeof(buf), (32 == type->bits)? "%.9g" : "%.17g", value);
+      str = buf;
+      if (str.find_first_of(".e") == std::string::npos) str += ".0";
+      if (32 == type->bits) str += "f";
+      return true;
+    }
+
+    /* The constant value of a symbol (from the constant folding in stage 3) as a type,
+     * returns false if the symbol has no constant value.
+     */
+    static bool constant(symbol_c *symbol, const cc_type_t *type, std::string &value) {
+      if (NULL == symbol) return false;
+      if (type->is_time) return false;
+      if (type->is_real) {
+        if      (VALID_CVALUE(real64, symbol)) return real_constant(GET_CVALUE(real64, symbol), type, value);
+        else if (VALID_CVALUE( int64, symbol)) return real_constant(GET_CVALUE( int64, symbol), type, value);
+        else if (VALID_CVALUE(uint64, symbol)) return real_constant(GET_CVALUE(uint64, symbol), type, value);
+        else return false;
+      } else if (type->is_bool) {
+        if      (VALID_CVALUE(  bool, symbol)) value = GET_CVALUE(bool, symbol)? "true" : "false";
+        else if (VALID_CVALUE( int64, symbol)) value = (0 != GET_CVALUE( int64, symbol))? "true" : "false";
+        else if (VALID_CVALUE(uint64, symbol)) value = (0 != GET_CVALUE(uint64, symbol))? "true" : "false";
+        else return false;
+      } else {
+        if      (VALID_CVALUE( int64, symbol)) value = int_constant(GET_CVALUE( int64, symbol), type);
+        else if (VALID_CVALUE(uint64, symbol)) value = int_constant(GET_CVALUE(uint64, symbol), type);
+        else if (VALID_CVALUE(  bool, symbol)) value = int_constant(GET_CVALUE(bool, symbol)? 1 : 0, type);
+        else return false;
+      }
+      return true;
+    }
+
+    /* The initial value of a variable */
+    std::string initial_value(cc_var_t *var) {
+      symbol_c *init = (NULL != var->init)? var->init : type_initial_value_c::get(var->type_name);
+      std::string value;
+      if (NULL != init) {
+        reads_variable_c reads_variable;
+        init->accept(reads_variable);
+        if (!reads_variable.found && constant(init, var->type, value)) return value;
+        /* the TIME literals are not folded by stage 3 */
+        if (!reads_variable.found && var->type->is_time && (NULL != dynamic_cast<duration_c *>(init))) return value_of(init, var->type);
+        if (NULL != var->init) STAGE4_ERROR(var->init, var->init, "The initial value must be a constant.");
+      }
+      /* the default initial value of the elementary types is 0 */
+      return std::string(var->type->name) + "()";
+    }
+
+
+  /*************/
+  /* Variables */
+  /*************/
+    cc_var_t *find_var(symbol_c *name) {
+      cc_var_t *var = (NULL == pou)? NULL : pou->find(upper_case_name(name));
+      if (NULL == var) STAGE4_ERROR(name, name, "Undeclared variable.");
+      return var;
+    }
+
+    std::string global_ref(cc_var_t *var) {
+      for (size_t i = 0; i < globals.size(); i++)
+        if (globals[i].name == var->name) {
+          /* the same C++ type is enough (e.g. a VAR_EXTERNAL of a type derived from the type of the global) */
+          bool same_type = (globals[i].type == var->type);
+          if (!same_type || (globals[i].fb != var->fb))
+            STAGE4_ERROR(var->symbol, var->symbol, "The datatype of the VAR_EXTERNAL is not the datatype of its global variable.");
+          return "GLOBAL__" + var->name;
+        }
+      /* not declared in this library, assume it is declared in another translation unit */
+      externals[var->name] = var;
+      return "GLOBAL__" + var->name;
+    }
+
+    std::string var_ref(cc_var_t *var) {
+      switch (var->vartype) {
+        case cc_var_t::external_vt: return global_ref(var);
+        case cc_var_t::result_vt  : return "__res";
+        default                   : return var->name;  /* the locals and parameters of FUNCTIONs, the members of FBs and PROGRAMs */
+      }
+    }
+
+    /* The C++ lvalue of a variable, and its type (or FB type) */
+    std::string ref(symbol_c *symbol, const cc_type_t **type, cc_pou_c **fb) {
+      symbolic_variable_c   *variable = dynamic_cast<symbolic_variable_c   *>(symbol);
+      structured_variable_c *field    = dynamic_cast<structured_variable_c *>(symbol);
+
+      if (NULL != variable) {
+        cc_var_t *var = find_var(variable->var_name);
+        *type = var->type;
+        *fb   = var->fb;
+        return var_ref(var);
+      }
+      if (NULL != field) {
+        const cc_type_t *record_type;
+        cc_pou_c *record_fb;
+        std::string record = ref(field->record_variable, &record_type, &record_fb);
+        if (NULL == record_fb) unsupported(symbol, "Structures are");
+        cc_var_t *var = record_fb->find(upper_case_name(field->field_selector));
+        if ((NULL == var) || (var->field < 0)) STAGE4_ERROR(symbol, symbol, "This variable of the FB instance may not be accessed.");
+        *type = var->type;
+        *fb   = var->fb;
+        return record + "." + var->name;
+      }
+      unsupported(symbol, "Arrays, pointers and direct variables are");
+      return ""; // humour the compiler!
+    }
+
+    /* The lvalue of a variable of an elementary type */
+    std::string elementary_ref(symbol_c *symbol, const cc_type_t **type) {
+      cc_pou_c *fb;
+      std::string r = ref(symbol, type, &fb);
+      if (NULL == *type) unsupported(symbol, "Using FB instances as values is");
+      return r;
+    }
+
+    bool is_constant_var(symbol_c *symbol) {
+      symbolic_variable_c *variable = dynamic_cast<symbolic_variable_c *>(symbol);
+      return (NULL != variable) && find_var(variable->var_name)->constant;
+    }
+
+
+  /***************/
+  /* Expressions */
+  /***************/
+    /* Converts a value from one type to another, as the *_TO_* standard functions */
+    static std::string convert(const std::string &v, const cc_type_t *from, const cc_type_t *to) {
+      if (from == to) return v;
+      return "iec::convert<" + std::string(to->name) + ">(" + v + ")";
+    }
+
+    /* The type of a literal whose datatype was left generic by stage 3 (e.g. the ANY_NUM of TIME * 2) */
+    static const cc_type_t *literal_type(symbol_c *expr) {
+      if (VALID_CVALUE(real64, expr)) return &cc_lreal__;
+      if (VALID_CVALUE( int64, expr)) return &cc_lint__;
+      if (VALID_CVALUE(uint64, expr)) return &cc_ulint__;
+      if (VALID_CVALUE(  bool, expr)) return &cc_bool__;
+      return NULL;
+    }
+
+    /* The value of an expression, as a type (NULL -> the datatype of the expression) */
+    std::string value_of(symbol_c *expr, const cc_type_t *type) {
+      const cc_type_t *own = cc_elementary_type(expr->datatype);
+      if ((NULL == type) && (NULL == own)) type = literal_type(expr);
+      if (NULL == type) type = own;
+      if (NULL == type) STAGE4_ERROR(expr, expr, "The datatype of this expression is not supported by the C++ generator.");
+
+      std::string c;
+      reads_variable_c reads_variable;
+      expr->accept(reads_variable);
+      if ((!reads_variable.found || is_constant_var(expr)) && constant(expr, type, c)) return c;
+      if ((NULL != own) && (own != type)) return convert(value_of(expr, own), own, type);
+
+      const cc_type_t *saved_type = expr_type;
+      expr_type = type;
+      result.clear();
+      expr->accept(*this);
+      std::string v = result;
+      expr_type = saved_type;
+      if (v.empty()) unsupported(expr, "This expression is");
+      return v;
+    }
+
+    /* The value of a BOOL expression */
+    std::string condition(symbol_c *expr) {
+      return value_of(expr, &cc_bool__);
+    }
+
+    /* The operands of the TIME arithmetic keep their own types (e.g. TOD + TIME, TIME * REAL),
+     * all others are of the type of the expression.
+     */
+    std::string operand(symbol_c *expr) {
+      return value_of(expr, expr_type->is_time? NULL : expr_type);
+    }
+
+    void *arithmetic(symbol_c *symbol, symbol_c *l_exp, symbol_c *r_exp, const char *op) {
+      const cc_type_t *type = expr_type;
+      if (type->is_bool) unsupported(symbol, "This operation on this datatype is");
+      std::string l = operand(l_exp);
+      std::string r = operand(r_exp);
+      /* the integer operations are wrapped to the type of the expression, instead of being promoted to int */
+      if (type->is_real || type->is_time) result = "(" + l + " " + op + " " + r + ")";
+      else                                result = std::string(type->name) + "(" + l + " " + op + " " + r + ")";
+      return NULL;
+    }
+
+    /* DIV and MOD (the integer divisions by 0 return 0) */
+    void *division(symbol_c *symbol, symbol_c *l_exp, symbol_c *r_exp, const char *function) {
+      if (expr_type->is_bool || (expr_type->is_real && (strcmp(function, "MOD") == 0)))
+        unsupported(symbol, "This operation on this datatype is");
+      if (expr_type->is_real) return arithmetic(symbol, l_exp, r_exp, "/");
+      std::string l = operand(l_exp);
+      std::string r = operand(r_exp);
+      result = "iec::" + std::string(function) + "(" + l + ", " + r + ")";
+      return NULL;
+    }
+
+    /* AND, OR, XOR on BOOL and the bit strings */
+    void *bitwise(symbol_c *symbol, symbol_c *l_exp, symbol_c *r_exp, const char *bool_op, const char *bit_op) {
+      if (expr_type->is_real || expr_type->is_time) unsupported(symbol, "This operation on this datatype is");
+      std::string l = value_of(l_exp, expr_type);
+      std::string r = value_of(r_exp, expr_type);
+      if (expr_type->is_bool) result = "(" + l + " " + bool_op + " " + r + ")";
+      else                    result = std::string(expr_type->name) + "(" + l + " " + bit_op + " " + r + ")";
+      return NULL;
+    }
+
+    void *comparison(symbol_c *symbol, symbol_c *l_exp, symbol_c *r_exp, const char *op) {
+      const cc_type_t *type = cc_elementary_type(l_exp->datatype);
+      if (NULL == type) type = cc_elementary_type(r_exp->datatype);
+      if (NULL == type) unsupported(symbol, "Comparing values of this datatype is");
+      std::string l = value_of(l_exp, type);
+      std::string r = value_of(r_exp, type);
+      result = convert("(" + l + " " + op + " " + r + ")", &cc_bool__, expr_type);
+      return NULL;
+    }
+
+    /* A parameter of a call to a standard function, by its name (formal calls) or position (non formal calls) */
+    symbol_c *call_param(function_invocation_c *symbol, const std::string &name, int index) {
+      if (NULL != symbol->nonformal_param_list) {
+        list_c *list = dynamic_cast<list_c *>(symbol->nonformal_param_list);
+        return ((NULL != list) && (index >= 0) && (index < list->n))? list->get_element(index) : NULL;
+      }
+      function_call_param_iterator_c call_param_iterator(symbol);
+      return call_param_iterator.search_f(name.c_str());
+    }
+
+    symbol_c *required_param(function_invocation_c *symbol, const std::string &name, int index) {
+      symbol_c *param = call_param(symbol, name, index);
+      if (NULL == param) STAGE4_ERROR(symbol, symbol, "Missing parameter %s.", name.c_str());
+      return param;
+    }
+
+    /* The inputs <prefix><first>, <prefix><first + 1>, ... of an extensible standard function, from position <index> */
+    std::string extensible_params(function_invocation_c *symbol, const char *prefix, int first, int index, bool own_type) {
+      std::string params;
+      symbol_c *in;
+      for (int i = 0; NULL != (in = call_param(symbol, prefix + cc_num(first + i), index + i)); i++)
+        params += (params.empty()? "" : ", ") + (own_type? value_of(in, NULL) : operand(in));
+      if (params.empty()) STAGE4_ERROR(symbol, symbol, "Missing parameter %s%d.", prefix, first);
+      return params;
+    }
+
+    /* The standard function, without its EN/ENO */
+    std::string standard_call(function_invocation_c *symbol, std::string name) {
+      const cc_type_t *type = expr_type;
+      std::string type_name(type->name);
+
+      if ((name.find("_TO_") != std::string::npos) || (name == "TRUNC")) {
+        symbol_c *in = required_param(symbol, "IN", 0);
+        const cc_type_t *from = cc_elementary_type(in->datatype);
+        if ((NULL == from) || (name.find("BCD") != std::string::npos)) unsupported(symbol, "This conversion is");
+        if (name != "TRUNC") return convert(value_of(in, from), from, type);
+        if (!from->is_real || type->is_real || type->is_bool || type->is_time) unsupported(symbol, "TRUNC on this datatype is");
+        return "iec::trunc<" + type_name + ">(" + value_of(in, from) + ")";
+      }
+
+      /* the explicitly typed TIME arithmetic of table 30 (ADD_TIME, SUB_DT_DT, MULTIME, ...) is the overloaded function */
+      if      ((name.compare(0, 4, "ADD_") == 0) && (name.find("TIME") != std::string::npos)) name = "ADD";
+      else if ((name.compare(0, 4, "SUB_") == 0) && ((name.find("TIME") != std::string::npos) || (name.find("DATE") != std::string::npos)
+                                                  || (name.find("TOD") != std::string::npos) || (name.find("DT") != std::string::npos))) name = "SUB";
+      else if ((name == "MUL_TIME") || (name == "MULTIME")) name = "MUL";
+      else if ((name == "DIV_TIME") || (name == "DIVTIME")) name = "DIV";
+
+      if (name == "MOVE") return value_of(required_param(symbol, "IN", 0), type);
+      if (name == "ABS") {
+        if (type->is_bool || type->is_time) unsupported(symbol, "ABS on this datatype is");
+        return "iec::ABS(" + value_of(required_param(symbol, "IN", 0), type) + ")";
+      }
+      if ((name == "SQRT") || (name == "LN")   || (name == "LOG")  || (name == "EXP")  || (name == "SIN") ||
+          (name == "COS")  || (name == "TAN")  || (name == "ASIN") || (name == "ACOS") || (name == "ATAN")) {
+        if (!type->is_real) unsupported(symbol, "This function on this datatype is");
+        return "iec::" + name + "(" + value_of(required_param(symbol, "IN", 0), type) + ")";
+      }
+      if (name == "EXPT") {
+        if (!type->is_real) unsupported(symbol, "EXPT on this datatype is");
+        return "iec::EXPT(" + value_of(required_param(symbol, "IN1", 0), type) + ", " + value_of(required_param(symbol, "IN2", 1), NULL) + ")";
+      }
+      if ((name == "ADD") || (name == "MUL") || (name == "MIN") || (name == "MAX")) {
+        if (type->is_bool && ((name == "ADD") || (name == "MUL"))) unsupported(symbol, "This function on BOOL is");
+        return "iec::" + name + "(" + extensible_params(symbol, "IN", 1, 0, false) + ")";
+      }
+      if ((name == "AND") || (name == "OR") || (name == "XOR")) {
+        if (type->is_real || type->is_time) unsupported(symbol, "This function on this datatype is");
+        return "iec::" + name + "(" + extensible_params(symbol, "IN", 1, 0, false) + ")";
+      }
+      if ((name == "SUB") || (name == "DIV") || (name == "MOD")) {
+        if (type->is_bool || ((name == "MOD") && (type->is_real || type->is_time))) unsupported(symbol, "This function on this datatype is");
+        return "iec::" + name + "(" + operand(required_param(symbol, "IN1", 0)) + ", " + operand(required_param(symbol, "IN2", 1)) + ")";
+      }
+      if (name == "NOT") {
+        if (type->is_real || type->is_time) unsupported(symbol, "NOT on this datatype is");
+        return "iec::NOT(" + value_of(required_param(symbol, "IN", 0), type) + ")";
+      }
+      if ((name == "SHL") || (name == "SHR") || (name == "ROL") || (name == "ROR")) {
+        if (type->is_real || type->is_time) unsupported(symbol, "This function on this datatype is");
+        return "iec::" + name + "(" + value_of(required_param(symbol, "IN", 0), type) + ", " + value_of(required_param(symbol, "N", 1), NULL) + ")";
+      }
+      if (name == "LIMIT") {
+        return "iec::LIMIT(" + value_of(required_param(symbol, "MN", 0), type) + ", " + value_of(required_param(symbol, "IN", 1), type) + ", "
+                             + value_of(required_param(symbol, "MX", 2), type) + ")";
+      }
+      if (name == "SEL") {
+        return "iec::SEL(" + condition(required_param(symbol, "G", 0)) + ", " + value_of(required_param(symbol, "IN0", 1), type) + ", "
+                           + value_of(required_param(symbol, "IN1", 2), type) + ")";
+      }
+      if (name == "MUX") {
+        std::string k = value_of(required_param(symbol, "K", 0), NULL);
+        std::string params;
+        symbol_c *in;
+        for (int i = 0; NULL != (in = call_param(symbol, "IN" + cc_num(i), i + 1)); i++) params += ", " + value_of(in, type);
+        if (params.empty()) STAGE4_ERROR(symbol, symbol, "Missing parameter IN0.");
+        return "iec::MUX(" + k + params + ")";
+      }
+      if ((name == "GT") || (name == "GE") || (name == "EQ") || (name == "LE") || (name == "LT") || (name == "NE")) {
+        symbol_c *in1 = required_param(symbol, "IN1", 0);
+        const cc_type_t *in_type = cc_elementary_type(in1->datatype);
+        if (NULL == in_type) unsupported(symbol, "Comparing values of this datatype is");
+        std::string params;
+        symbol_c *in;
+        for (int i = 0; NULL != (in = call_param(symbol, "IN" + cc_num(i + 1), i)); i++)
+          params += (params.empty()? "" : ", ") + value_of(in, in_type);
+        return convert("iec::" + name + "(" + params + ")", &cc_bool__, type);
+      }
+      if (name == "CONCAT_DATE_TOD") {
+        if (type != &cc_dt__) unsupported(symbol, "This function on this datatype is");
+        return "iec::CONCAT_DATE_TOD(" + value_of(required_param(symbol, "IN1", 0), &cc_date__) + ", " + value_of(required_param(symbol, "IN2", 1), &cc_tod__) + ")";
+      }
+      unsupported(symbol, "This standard function is");
+      return ""; // humour the compiler!
+    }
+
+    std::string standard_function(function_invocation_c *symbol) {
+      std::string call = standard_call(symbol, upper_case_name(symbol->function_name));
+
+      /* only the calls that pass EN or ENO get the EN/ENO handling */
+      symbol_c *en  = call_param(symbol, "EN",  -1);
+      symbol_c *eno = call_param(symbol, "ENO", -1);
+      if ((NULL == en) && (NULL == eno)) return call;
+      std::string eno_ref = "NULL";
+      if (NULL != eno) {
+        const cc_type_t *eno_type;
+        eno_ref = "&" + elementary_ref(eno, &eno_type);
+        if (!eno_type->is_bool) unsupported(eno, "Passing ENO to a variable that is not a BOOL is");
+      }
+      return "iec::call_en(" + ((NULL != en)? condition(en) : std::string("true")) + ", " + eno_ref + ", [&]() {return " + call + ";})";
+    }
+
+    std::string call_function(function_invocation_c *symbol, cc_pou_c *function) {
+      function_param_iterator_c fp_iterator(function->decl);
+      function_call_param_iterator_c function_call_param_iterator(symbol);
+      identifier_c *param_name;
+      std::string args;
+
+      while ((param_name = fp_iterator.next()) != NULL) {
+        cc_var_t *param = function->find(upper_case_name(param_name));
+        if (NULL == param) ERROR;
+
+        /* Get the value from a foo(<param_name> = <param_value>) style call */
+        symbol_c *param_value = function_call_param_iterator.search_f(param_name);
+        /* Get the value from a foo(<param_value>) style call */
+        /* When using the informal invocation style, user can not pass values to EN or ENO parameters if these
+         * were implicitly defined!
+         */
+        if ((param_value == NULL) && !fp_iterator.is_en_eno_param_implicit())
+          param_value = function_call_param_iterator.next_nf();
+
+        const cc_type_t *type;
+        switch (fp_iterator.param_direction()) {
+          case function_param_iterator_c::direction_in:
+            args += (args.empty()? "" : ", ") + ((NULL != param_value)? value_of(param_value, param->type) : initial_value(param));
+            break;
+          case function_param_iterator_c::direction_out:
+            args += (args.empty()? "" : ", ") + ((NULL != param_value)? "&" + elementary_ref(param_value, &type) : std::string("NULL"));
+            break;
+          case function_param_iterator_c::direction_inout:
+            if (NULL == param_value) STAGE4_ERROR(symbol, symbol, "Missing VAR_IN_OUT parameter %s.", param_name->value);
+            args += (args.empty()? "" : ", ") + elementary_ref(param_value, &type);
+            break;
+          default:
+            break;
+        }
+      }
+      return function->name + "(" + args + ")";
+    }
+
+
+  public:
+  /********************/
+  /* 2.1.6 - Pragmas  */
+  /********************/
+    void *visit(enable_code_generation_pragma_c * symbol)   {code_enabled = true;  return NULL;}
+    void *visit(disable_code_generation_pragma_c * symbol)  {code_enabled = false; return NULL;}
+
+  /**************************************/
+  /* B.1.5 - Program organization units */
+  /**************************************/
+    void *visit(library_c *symbol) {
+      code_enabled = true;
+      for (int i = 0; i < symbol->n; i++) symbol->get_element(i)->accept(*this);
+      generate_module();
+      return NULL;
+    }
+
+    void *visit(function_declaration_c *symbol) {
+      pous.add(cc_pou_c::function_pk, symbol->derived_function_name, symbol, symbol->var_declarations_list, symbol->function_body, code_enabled);
+      return NULL;
+    }
+    void *visit(function_block_declaration_c *symbol) {
+      cc_pou_c *fb = pous.add(cc_pou_c::function_block_pk, symbol->fblock_name, symbol, symbol->var_declarations, symbol->fblock_body, code_enabled);
+      /* the standard timers read __CURRENT_TIME with embedded C code, so they come with the C++ library instead */
+      fb->provided = !code_enabled && ((fb->name == "TON") || (fb->name == "TOF") || (fb->name == "TP"));
+      return NULL;
+    }
+    void *visit(program_declaration_c *symbol) {
+      pous.add(cc_pou_c::program_pk, symbol->program_type_name, symbol, symbol->var_declarations, symbol->function_block_body, code_enabled);
+      return NULL;
+    }
+    void *visit(configuration_declaration_c *symbol) {
+      if (code_enabled) configurations.push_back(symbol);
+      return NULL;
+    }
+
+  private:
+    bool code_enabled;
+
+
+  /*********************************/
+  /* Generating the POUs' functions */
+  /*********************************/
+    std::string declaration(cc_var_t *var) {
+      return ((NULL != var->type)? std::string(var->type->name) : cc_pou_type(var->fb)) + " " + var_ref(var);
+    }
+
+    /* The EN/ENO handling of FUNCTIONs and FBs: if (!EN) {ENO = false; <disabled>} ENO = true; */
+    void check_en(const std::string &disabled) {
+      cc_var_t *en  = pou->find("EN");
+      cc_var_t *eno = pou->find("ENO");
+      if ((NULL == en) || (en->vartype != cc_var_t::input_vt)) return;
+      bool has_eno = (NULL != eno) && (eno->vartype == cc_var_t::output_vt);
+      emit("if (!" + var_ref(en) + ") {" + (has_eno? var_ref(eno) + " = false; " : std::string("")) + disabled + "}");
+      if (has_eno) emit(var_ref(eno) + " = true;");
+    }
+
+    void generate_function(std::ostringstream &module, cc_pou_c *function, std::ostringstream &prototypes) {
+      function_param_iterator_c fp_iterator(function->decl);
+      identifier_c *param_name;
+      std::vector<cc_var_t *> outputs;
+      std::string params;
+
+      begin_function(function);
+      while ((param_name = fp_iterator.next()) != NULL) {
+        cc_var_t *param = function->find(upper_case_name(param_name));
+        if (NULL == param) ERROR;
+        switch (fp_iterator.param_direction()) {
+          case function_param_iterator_c::direction_in:
+            params += (params.empty()? "" : ", ") + declaration(param);
+            break;
+          case function_param_iterator_c::direction_out:
+            params += (params.empty()? "" : ", ") + std::string(param->type->name) + " *" + param->name + "__out";
+            emit(declaration(param) + " = " + initial_value(param) + ";");
+            outputs.push_back(param);
+            break;
+          case function_param_iterator_c::direction_inout:
+            params += (params.empty()? "" : ", ") + std::string(param->type->name) + " &" + param->name;
+            break;
+          default:
+            break;
+        }
+      }
+      for (size_t i = 0; i < function->vars.size(); i++)
+        if ((cc_var_t::private_vt == function->vars[i].vartype) || (cc_var_t::temp_vt == function->vars[i].vartype) || (cc_var_t::result_vt == function->vars[i].vartype))
+          emit(declaration(&function->vars[i]) + " = " + initial_value(&function->vars[i]) + ";");
+
+      std::string ret = (NULL == function->return_type)? "return;" : "return __res;";
+      std::string disabled;
+      for (size_t i = 0; i < outputs.size(); i++)
+        if (outputs[i]->name == "ENO") disabled = "if (NULL != ENO__out) *ENO__out = ENO; ";
+      check_en(disabled + ret);
+      emit("");
+      function->body->accept(*this);
+
+      if (uses_end_label) *code << "__end:;\n";
+      if (!outputs.empty()) emit("");
+      for (size_t i = 0; i < outputs.size(); i++)
+        emit("if (NULL != " + outputs[i]->name + "__out) *" + outputs[i]->name + "__out = " + outputs[i]->name + ";");
+      if (NULL != function->return_type) emit(ret);
+
+      std::string header = ((NULL == function->return_type)? std::string("void") : std::string(function->return_type->name)) + " " + function->name + "(" + params + ")";
+      prototypes << header << ";\n";
+      end_function(module, header);
+    }
+
+    /* The type of the instances of a FB or PROGRAM */
+    void generate_struct(std::ostringstream &module, cc_pou_c *fb) {
+      module << "struct " << fb->name << " {\n";
+      for (size_t i = 0; i < fb->vars.size(); i++)
+        if (fb->vars[i].field >= 0) module << "  " << declaration(&fb->vars[i]) << ";\n";
+      module << "\n  void init(BOOL retain);\n  void body(void);\n};\n\n";
+    }
+
+    void generate_fb(std::ostringstream &module, cc_pou_c *fb) {
+      /* the initialisation of the instances */
+      begin_function(fb);
+      for (size_t i = 0; i < fb->vars.size(); i++) {
+        cc_var_t *var = &fb->vars[i];
+        if (var->field < 0) continue;
+        if (NULL != var->fb) emit(var->name + ".init(retain);");
+        else                 emit(var->name + " = " + initial_value(var) + ";");
+      }
+      end_function(module, "void " + fb->name + "::init(BOOL retain)");
+
+      /* the body */
+      begin_function(fb);
+      for (size_t i = 0; i < fb->vars.size(); i++)
+        if (cc_var_t::temp_vt == fb->vars[i].vartype) emit(declaration(&fb->vars[i]) + " = " + initial_value(&fb->vars[i]) + ";");
+      check_en("return;");
+      fb->body->accept(*this);
+      end_function(module, "void " + fb->name + "::body(void)");
+    }
+
+
+  /*******************************/
+  /* Generating the configuration */
+  /*******************************/
+    void collect_globals(symbol_c *global_var_declarations) {
+      if (NULL == global_var_declarations) return;
+      size_t first = globals.size();
+      cc_vardecl_c vardecl(pous, globals, cc_var_t::global_vt, false);
+      global_var_declarations->accept(vardecl);
+      for (size_t i = first; i < globals.size(); i++)
+        for (size_t j = 0; j < i; j++)
+          if (globals[i].name == globals[j].name)
+            STAGE4_ERROR(globals[i].symbol, globals[i].symbol, "The C++ generator requires the global variables to have distinct names.");
+    }
+
+    void generate_globals(std::ostringstream &module, std::ostringstream &init) {
+      for (size_t i = 0; i < globals.size(); i++) {
+        cc_var_t *var = &globals[i];
+        std::string name = "GLOBAL__" + var->name;
+        if (NULL != var->fb) {
+          module << cc_pou_type(var->fb) << " " << name << ";\n";
+          init << "  " << name << ".init(false);\n";
+        } else {
+          std::string value = initial_value(var);
+          module << var->type->name << " " << name << " = " << value << ";\n";
+          init << "  " << name << " = " << value << ";\n";
+        }
+      }
+      for (std::map<std::string, cc_var_t *>::iterator i = externals.begin(); i != externals.end(); i++)
+        module << "extern " << ((NULL != i->second->type)? std::string(i->second->type->name) : cc_pou_type(i->second->fb)) << " GLOBAL__" << i->first << ";\n";
+      module << "\n";
+    }
+
+    void generate_resource(std::ostringstream &module, std::string resource_name, single_resource_declaration_c *resource, unsigned long long common_ticktime) {
+      std::map<std::string, unsigned long long> task_ticks;  /* the ticks between the runs of each task */
+      list_c *tasks    = dynamic_cast<list_c *>(resource->task_configuration_list);
+      list_c *programs = dynamic_cast<list_c *>(resource->program_configuration_list);
+      std::ostringstream init, run;
+
+      for (int i = 0; (NULL != tasks) && (i < tasks->n); i++) {
+        task_configuration_c  *task = dynamic_cast<task_configuration_c  *>(tasks->get_element(i));
+        task_initialization_c *task_init = dynamic_cast<task_initialization_c *>(task->task_initialization);
+        if (NULL != task_init->single_data_source) unsupported(task, "SINGLE tasks are");
+        unsigned long long interval = calculate_time(task_init->interval_data_source);
+        task_ticks[upper_case_name(task->task_name)] = (0 == interval)? 1 : interval / common_ticktime;
+      }
+
+      for (int i = 0; (NULL != programs) && (i < programs->n); i++) {
+        program_configuration_c *program = dynamic_cast<program_configuration_c *>(programs->get_element(i));
+        if (NULL != program->prog_conf_elements) unsupported(program, "The configuration elements of PROGRAM instances are");
+        cc_pou_c *type = pous.get(program->program_type_name, cc_pou_c::program_pk);
+        if (NULL == type) STAGE4_ERROR(program->program_type_name, program->program_type_name, "Unknown PROGRAM type.");
+        std::string instance = resource_name + "__" + upper_case_name(program->program_name);
+        module << cc_pou_type(type) << " " << instance << ";\n";
+        init << "  " << instance << ".init(false);\n";
+
+        unsigned long long ticks = (NULL == program->task_name)? 1 : task_ticks[upper_case_name(program->task_name)];
+        if (ticks <= 1) run << "  " << instance << ".body();\n";
+        else            run << "  if (0 == tick % " << ticks << ") " << instance << ".body();\n";
+      }
+      module << "\nvoid " << resource_name << "_init__(void) {\n" << init.str() << "}\n\n";
+      module << "void " << resource_name << "_run__(unsigned long tick) {\n" << run.str() << "}\n\n";
+    }
+
+    /* The tick of the resources, i.e. the GCD of the intervals of the tasks (in ns) */
+    static unsigned long long gcd(unsigned long long a, unsigned long long b) {
+      while (0 != b) {unsigned long long t = a % b; a = b; b = t;}
+      return a;
+    }
+
+    unsigned long long common_ticktime(configuration_declaration_c *configuration) {
+      unsigned long long ticktime = 0;
+      std::vector<single_resource_declaration_c *> resources = get_resources(configuration, NULL);
+      for (size_t r = 0; r < resources.size(); r++) {
+        list_c *tasks = dynamic_cast<list_c *>(resources[r]->task_configuration_list);
+        for (int i = 0; (NULL != tasks) && (i < tasks->n); i++) {
+          task_configuration_c  *task = dynamic_cast<task_configuration_c  *>(tasks->get_element(i));
+          task_initialization_c *task_init = dynamic_cast<task_initialization_c *>(task->task_initialization);
+          ticktime = gcd(ticktime, calculate_time(task_init->interval_data_source));
+        }
+      }
+      return ticktime;
+    }
+
+    std::vector<single_resource_declaration_c *> get_resources(configuration_declaration_c *configuration, std::vector<std::string> *names) {
+      std::vector<single_resource_declaration_c *> resources;
+      single_resource_declaration_c *single = dynamic_cast<single_resource_declaration_c *>(configuration->resource_declarations);
+      list_c *list = dynamic_cast<list_c *>(configuration->resource_declarations);
+      if (NULL != single) {
+        resources.push_back(single);
+        if (NULL != names) names->push_back("RESOURCE");
+      }
+      for (int i = 0; (NULL != list) && (i < list->n); i++) {
+        resource_declaration_c *resource = dynamic_cast<resource_declaration_c *>(list->get_element(i));
+        single = dynamic_cast<single_resource_declaration_c *>(resource->resource_declaration);
+        if (NULL == single) ERROR;
+        resources.push_back(single);
+        if (NULL != names) names->push_back(upper_case_name(resource->resource_name));
+      }
+      return resources;
+    }
+
+    void generate_configuration(std::ostringstream &module, std::ostringstream &globals_init, configuration_declaration_c *configuration) {
+      std::vector<std::string> names;
+      std::vector<single_resource_declaration_c *> resources = get_resources(configuration, &names);
+      unsigned long long ticktime = common_ticktime(configuration);
+
+      /* the entry points called by the runtime, as those of the C code */
+      module << "extern \"C\" {\n\n";
+      module << "unsigned long long common_ticktime__ = " << ticktime << "ULL; /*ns*/\n\n";
+      for (size_t r = 0; r < resources.size(); r++)
+        generate_resource(module, names[r], resources[r], ticktime);
+
+      module << "void config_init__(void) {\n" << globals_init.str();
+      for (size_t r = 0; r < resources.size(); r++) module << "  " << names[r] << "_init__();\n";
+      module << "}\n\n";
+      module << "void config_run__(unsigned long tick) {\n";
+      for (size_t r = 0; r < resources.size(); r++) module << "  " << names[r] << "_run__(tick);\n";
+      module << "}\n\n";
+      module << "} /* extern \"C\" */\n\n";
+    }
+
+    void generate_main(std::ostringstream &module) {
+      module << "int64_t __CURRENT_TIME = 0;\n\n"
+             << "int main(void) {\n"
+             << "  config_init__();\n"
+             << "  for (unsigned long tick = 0; tick < " << main_ticks__ << "UL; tick++) {\n"
+             << "    __CURRENT_TIME = (int64_t)tick * common_ticktime__;\n"
+             << "    config_run__(tick);\n"
+             << "  }\n"
+             << "  return 0;\n"
+             << "}\n\n";
+    }
+
+
+    void generate_module(void) {
+      std::ostringstream module, structs, prototypes, pou_code, globals_init;
+
+      if (configurations.size() > 1)
+        STAGE4_ERROR(configurations[1], configurations[1], "The C++ generator supports a single CONFIGURATION.");
+      for (size_t c = 0; c < configurations.size(); c++) {
+        collect_globals(configurations[c]->global_var_declarations);
+        list_c *list = dynamic_cast<list_c *>(configurations[c]->resource_declarations);
+        for (int i = 0; (NULL != list) && (i < list->n); i++)
+          collect_globals(dynamic_cast<resource_declaration_c *>(list->get_element(i))->global_var_declarations);
+      }
+      for (std::map<std::string, cc_pou_c *>::iterator i = pous.pous.begin(); i != pous.pous.end(); i++)
+        if (i->second->enabled) pous.collect(i->second, i->second->decl);
+      /* the PROGRAM instances */
+      for (size_t c = 0; c < configurations.size(); c++) {
+        std::vector<single_resource_declaration_c *> resources = get_resources(configurations[c], NULL);
+        for (size_t r = 0; r < resources.size(); r++) {
+          list_c *programs = dynamic_cast<list_c *>(resources[r]->program_configuration_list);
+          for (int i = 0; (NULL != programs) && (i < programs->n); i++) {
+            program_configuration_c *program = dynamic_cast<program_configuration_c *>(programs->get_element(i));
+            pous.get(program->program_type_name, cc_pou_c::program_pk);
+          }
+        }
+      }
+
+      /* the FUNCTIONs may call FUNCTIONs collected after them, and the FBs may call all of them */
+      for (size_t i = 0; i < pous.collected.size(); i++) {
+        cc_pou_c *p = pous.collected[i];
+        if (p->provided) continue;
+        if      (cc_pou_c::function_pk != p->kind) {generate_struct(structs, p); generate_fb(pou_code, p);}
+        else if (p->enabled)                       generate_function(pou_code, p, prototypes);
+      }
+
+      module << "/* C++ code generated by iec2cc from IEC 61131-3 code */\n\n";
+      module << "#include \"iec_std_lib.hh\"\n\n";
+      module << structs.str();
+      if (!prototypes.str().empty()) module << prototypes.str() << "\n";
+      generate_globals(module, globals_init);
+      module << pou_code.str();
+      for (size_t c = 0; c < configurations.size(); c++)
+        generate_configuration(module, globals_init, configurations[c]);
+      if ((0 != main_ticks__) && !configurations.empty())
+        generate_main(module);
+
+      stage4out_c cc(builddir, "PLC", "cc");
+      cc.print(module.str());
+    }
+
+
+  public:
+  /***************************************/
+  /* B.3 - Language ST (Structured Text) */
+  /***************************************/
+  /***********************/
+  /* B 3.1 - Expressions */
+  /***********************/
+    void *visit(symbolic_variable_c *symbol) {
+      const cc_type_t *type;
+      std::string r = elementary_ref(symbol, &type);
+      result = convert(r, type, expr_type);
+      return NULL;
+    }
+    void *visit(structured_variable_c *symbol) {
+      const cc_type_t *type;
+      std::string r = elementary_ref(symbol, &type);
+      result = convert(r, type, expr_type);
+      return NULL;
+    }
+
+    /* the TIME literals (not folded by stage 3) */
+    void *visit(duration_c *symbol) {
+      if (!expr_type->is_time) unsupported(symbol, "This TIME literal is");
+      unsigned long long ns = calculate_time(symbol->interval);
+      if (ns > (unsigned long long)std::numeric_limits<int64_t>::max()) STAGE4_ERROR(symbol, symbol, "TIME literal out of range.");
+      int64_t value = (NULL != symbol->neg)? -(int64_t)ns : (int64_t)ns;
+      result = convert("TIME(" + cc_int_literal(value) + ")", &cc_time__, expr_type);
+      return NULL;
+    }
+
+    void *visit(     or_expression_c *symbol) {return bitwise(symbol, symbol->l_exp, symbol->r_exp, "||", "|");}
+    void *visit(    xor_expression_c *symbol) {return bitwise(symbol, symbol->l_exp, symbol->r_exp, "!=", "^");}
+    void *visit(    and_expression_c *symbol) {return bitwise(symbol, symbol->l_exp, symbol->r_exp, "&&", "&");}
+    void *visit(    equ_expression_c *symbol) {return comparison(symbol, symbol->l_exp, symbol->r_exp, "==");}
+    void *visit( notequ_expression_c *symbol) {return comparison(symbol, symbol->l_exp, symbol->r_exp, "!=");}
+    void *visit(     lt_expression_c *symbol) {return comparison(symbol, symbol->l_exp, symbol->r_exp, "<" );}
+    void *visit(     gt_expression_c *symbol) {return comparison(symbol, symbol->l_exp, symbol->r_exp, ">" );}
+    void *visit(     le_expression_c *symbol) {return comparison(symbol, symbol->l_exp, symbol->r_exp, "<=");}
+    void *visit(     ge_expression_c *symbol) {return comparison(symbol, symbol->l_exp, symbol->r_exp, ">=");}
+    void *visit(    add_expression_c *symbol) {return arithmetic(symbol, symbol->l_exp, symbol->r_exp, "+");}
+    void *visit(    sub_expression_c *symbol) {return arithmetic(symbol, symbol->l_exp, symbol->r_exp, "-");}
+    void *visit(    mul_expression_c *symbol) {return arithmetic(symbol, symbol->l_exp, symbol->r_exp, "*");}
+    void *visit(    div_expression_c *symbol) {return division(symbol, symbol->l_exp, symbol->r_exp, "DIV");}
+    void *visit(    mod_expression_c *symbol) {return division(symbol, symbol->l_exp, symbol->r_exp, "MOD");}
+    void *visit(  power_expression_c *symbol) {
+      if (!expr_type->is_real) unsupported(symbol, "EXPT on this datatype is");
+      result = "iec::EXPT(" + value_of(symbol->l_exp, expr_type) + ", " + value_of(symbol->r_exp, NULL) + ")";
+      return NULL;
+    }
+    void *visit(    neg_expression_c *symbol) {
+      if (expr_type->is_bool) unsupported(symbol, "This operation on this datatype is");
+      std::string v = value_of(symbol->exp, expr_type);
+      result = (expr_type->is_real || expr_type->is_time)? "(-" + v + ")" : std::string(expr_type->name) + "(-" + v + ")";
+      return NULL;
+    }
+    void *visit(    not_expression_c *symbol) {
+      if (expr_type->is_real || expr_type->is_time) unsupported(symbol, "This operation on this datatype is");
+      std::string v = value_of(symbol->exp, expr_type);
+      result = expr_type->is_bool? "(!" + v + ")" : std::string(expr_type->name) + "(~" + v + ")";
+      return NULL;
+    }
+
+    void *visit(function_invocation_c *symbol) {
+      cc_pou_c *function = pous.find_function(symbol->called_function_declaration);
+      if (NULL != function) {
+        if (NULL == function->return_type) unsupported(symbol, "Calling VOID FUNCTIONs in expressions is");
+        result = call_function(symbol, function);
+      } else {
+        result = standard_function(symbol);
+      }
+      return NULL;
+    }
+
+
+  /********************/
+  /* B 3.2 Statements */
+  /********************/
+    void *visit(statement_list_c *symbol) {
+      for (int i = 0; i < symbol->n; i++) symbol->get_element(i)->accept(*this);
+      return NULL;
+    }
+
+    /*********************************/
+    /* B 3.2.1 Assignment Statements */
+    /*********************************/
+    void *visit(assignment_statement_c *symbol) {
+      const cc_type_t *type;
+      std::string lvalue = elementary_ref(symbol->l_exp, &type);
+      emit(lvalue + " = " + value_of(symbol->r_exp, type) + ";");
+      return NULL;
+    }
+
+    /*****************************************/
+    /* B 3.2.2 Subprogram Control Statements */
+    /*****************************************/
+    void *visit(return_statement_c *symbol) {
+      if (cc_pou_c::function_pk != pou->kind) {emit("return;"); return NULL;}
+      /* the outputs of the FUNCTION are copied out after its body */
+      emit("goto __end;");
+      uses_end_label = true;
+      return NULL;
+    }
+
+    void *visit(fb_invocation_c *symbol) {
+      const cc_type_t *type;
+      cc_pou_c *fb;
+      std::string instance = ref(symbol->fb_name, &type, &fb);
+      if (NULL == fb) unsupported(symbol, "Calling this FB is");
+
+      function_param_iterator_c fp_iterator(fb->decl);
+      function_call_param_iterator_c function_call_param_iterator(symbol);
+      identifier_c *param_name;
+
+      /* the inputs (and the in_outs, copied in and out of the instance as in generate_c) */
+      while ((param_name = fp_iterator.next()) != NULL) {
+        symbol_c *param_value = function_call_param_iterator.search_f(param_name);
+        if ((param_value == NULL) && !fp_iterator.is_en_eno_param_implicit())
+          param_value = function_call_param_iterator.next_nf();
+        if (param_value == NULL) continue;
+        function_param_iterator_c::param_direction_t param_direction = fp_iterator.param_direction();
+        if ((param_direction != function_param_iterator_c::direction_in) && (param_direction != function_param_iterator_c::direction_inout)) continue;
+        cc_var_t *param = fb->find(upper_case_name(param_name));
+        if ((NULL == param) || (NULL == param->type)) unsupported(param_value, "Passing FB instances as parameters is");
+        emit(instance + "." + param->name + " = " + value_of(param_value, param->type) + ";");
+      }
+
+      emit(instance + ".body();");
+
+      /* the outputs */
+      fp_iterator.reset();
+      function_call_param_iterator.reset();
+      while ((param_name = fp_iterator.next()) != NULL) {
+        symbol_c *param_value = function_call_param_iterator.search_f(param_name);
+        if ((param_value == NULL) && !fp_iterator.is_en_eno_param_implicit())
+          param_value = function_call_param_iterator.next_nf();
+        if (param_value == NULL) continue;
+        function_param_iterator_c::param_direction_t param_direction = fp_iterator.param_direction();
+        if ((param_direction != function_param_iterator_c::direction_out) && (param_direction != function_param_iterator_c::direction_inout)) continue;
+        cc_var_t *param = fb->find(upper_case_name(param_name));
+        if ((NULL == param) || (NULL == param->type)) unsupported(param_value, "Passing FB instances as parameters is");
+        const cc_type_t *var_type;
+        std::string lvalue = elementary_ref(param_value, &var_type);
+        emit(lvalue + " = " + convert(instance + "." + param->name, param->type, var_type) + ";");
+      }
+      return NULL;
+    }
+
+    /***********************************/
+    /* B 3.2.3 Selection Statements */
+    /***********************************/
+    void *visit(if_statement_c *symbol) {
+      open_block("if (" + condition(symbol->expression) + ")");
+      if (NULL != symbol->statement_list) symbol->statement_list->accept(*this);
+      list_c *elseif_list = dynamic_cast<list_c *>(symbol->elseif_statement_list);
+      for (int i = 0; (NULL != elseif_list) && (i < elseif_list->n); i++) {
+        elseif_statement_c *elseif = dynamic_cast<elseif_statement_c *>(elseif_list->get_element(i));
+        close_block("} else if (" + condition(elseif->expression) + ") {");
+        indent += "  ";
+        if (NULL != elseif->statement_list) elseif->statement_list->accept(*this);
+      }
+      if (NULL != symbol->else_statement_list) {
+        close_block("} else {");
+        indent += "  ";
+        symbol->else_statement_list->accept(*this);
+      }
+      close_block();
+      return NULL;
+    }
+
+    /* An if chain on the value of the selector (rather than a C++ switch, so that the EXIT inside a
+     * CASE still breaks out of the enclosing loop).
+     */
+    void *visit(case_statement_c *symbol) {
+      const cc_type_t *type = cc_elementary_type(symbol->expression->datatype);
+      if ((NULL == type) || type->is_real || type->is_time) unsupported(symbol->expression, "CASE on this datatype is");
+      std::string selector = new_tmp("case");
+
+      open_block("");
+      emit(std::string(type->name) + " " + selector + " = " + value_of(symbol->expression, type) + ";");
+      bool first = true;
+      list_c *elements = dynamic_cast<list_c *>(symbol->case_element_list);
+      for (int i = 0; (NULL != elements) && (i < elements->n); i++) {
+        case_element_c *element = dynamic_cast<case_element_c *>(elements->get_element(i));
+        list_c *case_list = dynamic_cast<list_c *>(element->case_list);
+        std::string match;
+        for (int j = 0; (NULL != case_list) && (j < case_list->n); j++) {
+          symbol_c *item = case_list->get_element(j);
+          subrange_c *range = dynamic_cast<subrange_c *>(item);
+          std::string m;
+          if (NULL != range) m = "((" + selector + " >= " + value_of(range->lower_limit, type) + ") && (" + selector + " <= " + value_of(range->upper_limit, type) + "))";
+          else               m = "(" + selector + " == " + value_of(item, type) + ")";
+          match += (match.empty()? "" : " || ") + m;
+        }
+        if (match.empty()) continue;
+        if (first) open_block("if (" + match + ")");
+        else      {close_block("} else if (" + match + ") {"); indent += "  ";}
+        first = false;
+        if (NULL != element->statement_list) element->statement_list->accept(*this);
+      }
+      if (NULL != symbol->statement_list) {
+        if (first) open_block("");
+        else      {close_block("} else {"); indent += "  ";}
+        first = false;
+        symbol->statement_list->accept(*this);
+      }
+      if (!first) close_block();
+      close_block();
+      return NULL;
+    }
+
+    /********************************/
+    /* B 3.2.4 Iteration Statements */
+    /********************************/
+    void *visit(for_statement_c *symbol) {
+      const cc_type_t *type;
+      std::string control = elementary_ref(symbol->control_variable, &type);
+      if (type->is_real || type->is_bool || type->is_time) unsupported(symbol->control_variable, "FOR loops on this datatype are");
+      std::string type_name(type->name);
+
+      /* the end and step are evaluated once, after the initial value */
+      open_block("");
+      emit(control + " = " + value_of(symbol->beg_expression, type) + ";");
+      std::string end = new_tmp("end");
+      emit(type_name + " " + end + " = " + value_of(symbol->end_expression, type) + ";");
+      std::string by = "1";
+      /* the sign of BY, if known at compile time (0 if not) */
+      int by_sign = 1;
+      if (NULL != symbol->by_expression) {
+        by = new_tmp("by");
+        emit(type_name + " " + by + " = " + value_of(symbol->by_expression, type) + ";");
+        if (type->is_signed) {
+          if      (VALID_CVALUE( int64, symbol->by_expression)) by_sign = (GET_CVALUE(int64, symbol->by_expression) < 0)? -1 : 1;
+          else if (!VALID_CVALUE(uint64, symbol->by_expression)) by_sign = 0;
+        }
+      }
+      std::string more;
+      if      (by_sign > 0) more = control + " <= " + end;
+      else if (by_sign < 0) more = control + " >= " + end;
+      else                  more = "(" + by + " > 0)? (" + control + " <= " + end + ") : (" + control + " >= " + end + ")";
+      open_block("for (; " + more + "; " + control + " = " + type_name + "(" + control + " + " + by + "))");
+      loop_depth++;
+      if (NULL != symbol->statement_list) symbol->statement_list->accept(*this);
+      loop_depth--;
+      close_block();
+      close_block();
+      return NULL;
+    }
+
+    void *visit(while_statement_c *symbol) {
+      open_block("while (" + condition(symbol->expression) + ")");
+      loop_depth++;
+      if (NULL != symbol->statement_list) symbol->statement_list->accept(*this);
+      loop_depth--;
+      close_block();
+      return NULL;
+    }
+
+    void *visit(repeat_statement_c *symbol) {
+      open_block("do");
+      loop_depth++;
+      if (NULL != symbol->statement_list) symbol->statement_list->accept(*this);
+      loop_depth--;
+      close_block("} while (!" + condition(symbol->expression) + ");");
+      return NULL;
+    }
+
+    void *visit(exit_statement_c *symbol) {
+      if (0 == loop_depth) STAGE4_ERROR(symbol, symbol, "EXIT outside of a loop.");
+      emit("break;");
+      return NULL;
+    }
+}; /* class generate_cc_c */
+
+
+
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+
+
+
+
+visitor_c *new_code_generator(stage4out_c *s4o, const char *builddir)  {return new generate_cc_c(s4o, builddir);}
+void delete_code_generator(visitor_c *code_generator) {delete code_generator;}
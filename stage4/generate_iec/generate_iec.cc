@@ -69,6 +69,8 @@
 /* Parse command line options passed from main.c !! */
 
 int  stage4_parse_options(char *options) {return 0;}
+void stage4_reset_options(void) {}
+bool stage4_requires_stage3(void) {return false;}  /* the code is printed back as it was parsed */
 
 void stage4_print_options(void) {
   printf("          (no options available when generating IEC 61131-3 code)\n"); 
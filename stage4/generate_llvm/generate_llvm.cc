@@ -0,0 +1,1365 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2003-2011  Mario de Sousa (msousa@fe.up.pt)
+ *  Copyright (C) 2007-2011  Laurent Bessard and Edouard Tisserant
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+/*
+ * This is part of the 4th stage that generates
+ * an LLVM IR module (PLC.ll) equivalent to the ST code.
+ *
+ * The module may be compiled with llc (or clang) into an object linked with the runtime,
+ * or run directly by the LLVM JIT (lli), in which case -O m=<ticks> adds a main() that
+ * initialises the configuration and runs it for that many ticks.
+ *
+ * The module defines (all names in upper case, as IEC 61131-3 is not case sensitive):
+ *  - for each FUNCTION:
+ *        <ret> @<NAME>(<params>)
+ *    with the parameters in the order of their declaration, the VAR_INPUTs (and EN) by value,
+ *    the VAR_OUTPUTs (and ENO) and VAR_IN_OUTs by address (the VAR_OUTPUTs may be null);
+ *  - for each FUNCTION_BLOCK and PROGRAM, the type %pou.<NAME> of its instances (a field
+ *    for each VAR_INPUT, VAR_OUTPUT, VAR_IN_OUT and VAR, in the order of their declaration), and
+ *        void @<NAME>_init__(ptr %data__, i8 %retain)
+ *        void @<NAME>_body__(ptr %data__)
+ *    The VAR_IN_OUT of the FB instances are copied in and out of the instance when it is
+ *    called, as done by generate_c;
+ *  - the global variables @GLOBAL__<NAME>, which the VAR_EXTERNALs access directly;
+ *  - for each resource, its PROGRAM instances @<RESOURCE>__<INSTANCE>, and
+ *        void @<RESOURCE>_init__()
+ *        void @<RESOURCE>_run__(i64 %tick)
+ *  - for the configuration:
+ *        i64 @common_ticktime__          (in ns)
+ *        void @config_init__()
+ *        void @config_run__(i64 %tick)
+ *
+ * Only a subset of the language is supported:
+ *  - POUs written in ST (plus the standard FBs written in ST, e.g. R_TRIG, CTU, SR, when
+ *    they are used);
+ *  - the elementary types BOOL, SINT, INT, DINT, LINT, USINT, UINT, UDINT, ULINT, BYTE,
+ *    WORD, DWORD, LWORD, REAL and LREAL (and the types derived from these), and FB instances;
+ *  - the standard functions *_TO_*, TRUNC, MOVE, ABS, SQRT, LN, LOG, EXP, SIN, COS, TAN,
+ *    ASIN, ACOS, ATAN, EXPT, MIN, MAX, LIMIT and SEL;
+ *  - periodic tasks.
+ * Anything else (strings, arrays, structures, enumerations, TIME and dates, located variables,
+ * IL and SFC bodies, SINGLE tasks, ...) is reported as an error.
+ *
+ * NOTE: The integer divisions (and MOD) by 0 return 0, instead of trapping. The signed divisions
+ *       by -1 never overflow: DIV wraps around (the most negative value divided by -1 is itself),
+ *       and MOD returns 0. This matches the bytecode interpreter (lib/C/iec_bytecode.h), whereas
+ *       the C code generated by iec2c leaves these cases to the C compiler (undefined behaviour).
+ */
+
+
+#include <string>
+#include <sstream>
+#include <vector>
+#include <map>
+#include <limits>
+#include <typeinfo>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "generate_llvm.hh"
+#include "../../absyntax_utils/absyntax_utils.hh"
+#include "../../main.hh" // required for ERROR() and ERROR_MSG() macros.
+#include "../stage4.hh"
+#include "../common/pou_table.hh"
+#include "../common/calculate_time.hh"
+
+
+#define STAGE4_ERROR(symbol1, symbol2, ...) {stage4err("while generating LLVM IR", symbol1, symbol2, __VA_ARGS__); exit(EXIT_FAILURE);}
+
+#define VALID_CVALUE(dtype, symbol)           ((symbol)->const_value._##dtype.is_valid())
+#define GET_CVALUE(dtype, symbol)             ((symbol)->const_value._##dtype.get())
+
+
+
+
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+
+
+/* the number of ticks run by the main() generated for lli (0 -> no main()) */
+static unsigned long long main_ticks__ = 0;
+
+
+#ifdef __unix__
+/* Parse command line options passed from main.c !! */
+#include <stdlib.h> // for getsubopt()
+int  stage4_parse_options(char *options) {
+  enum {MAIN_OPT = 0   /* option to generate a main() running the configuration for a number of ticks */
+        /*, SOME_OTHER_OPT, YET_ANOTHER_OPT */};
+  char *const token[] = {
+        /*       MAIN_OPT*/(char *)"m",
+        /* SOME_OTHER_OPT, ...             */
+        NULL };
+  /* unfortunately, the above commented out syntax for array initialization is valid in C, but not in C++ */
+
+  char *subopts = options;
+  char *value;
+
+  while (*subopts != '\0') {
+    switch (getsubopt(&subopts, token, &value)) {
+      case     MAIN_OPT: if ((NULL == value) || (strtoull(value, NULL, 10) < 1)) {
+                           fprintf(stderr, "Invalid number of ticks: -O m=%s\n", (NULL == value)? "" : value);
+                           return -1;
+                         }
+                         main_ticks__ = strtoull(value, NULL, 10);
+                         break;
+      default          : fprintf(stderr, "Unrecognized option: -O %s\n", value); return -1; break;
+     }
+  }
+  return 0;
+}
+
+
+void stage4_print_options(void) {
+  printf("          (options must be separated by commas. Example: 'm=100')\n");
+  printf("    m=n : also define main(), that calls config_init__() and then config_run__() for the ticks 0 to n-1, so PLC.ll may be run with lli.\n");
+}
+#else /* not __unix__ */
+/* getsubopt isn't supported with mingw,
+ *  then stage4 options aren't available on windows*/
+void stage4_print_options(void) {}
+int  stage4_parse_options(char *options) {return 0;}
+#endif
+
+void stage4_reset_options(void) {main_ticks__ = 0;}
+bool stage4_requires_stage3(void) {return true;}
+
+
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+
+
+/* The LLVM type of an elementary IEC 61131-3 type */
+typedef struct {
+  const char *ir;     /* the type in LLVM IR */
+  int  bits;
+  bool is_signed;
+  bool is_real;
+  bool is_bool;       /* BOOL is an i8 holding 0 or 1, as in the C code */
+} llvm_type_t;
+
+static const llvm_type_t llvm_bool__  = {"i8",      8, false, false, true };
+static const llvm_type_t llvm_sint__  = {"i8",      8, true,  false, false};
+static const llvm_type_t llvm_int__   = {"i16",    16, true,  false, false};
+static const llvm_type_t llvm_dint__  = {"i32",    32, true,  false, false};
+static const llvm_type_t llvm_lint__  = {"i64",    64, true,  false, false};
+static const llvm_type_t llvm_usint__ = {"i8",      8, false, false, false};
+static const llvm_type_t llvm_uint__  = {"i16",    16, false, false, false};
+static const llvm_type_t llvm_udint__ = {"i32",    32, false, false, false};
+static const llvm_type_t llvm_ulint__ = {"i64",    64, false, false, false};
+static const llvm_type_t llvm_real__  = {"float",  32, true,  true,  false};
+static const llvm_type_t llvm_lreal__ = {"double", 64, true,  true,  false};
+
+
+/* Returns the LLVM type of a datatype, or NULL if it is not one of the supported elementary types */
+static const llvm_type_t *llvm_elementary_type(symbol_c *type) {
+  if (NULL == type) return NULL;
+  symbol_c *base = search_base_type_c::get_basetype_decl(type);
+  if (NULL == base) return NULL;
+
+#define LLVM_TYPE(type_name, llvm_type)                                                            \
+  if ((typeid(*base) == typeid(type_name##_type_name_c)) || (typeid(*base) == typeid(safe##type_name##_type_name_c))) \
+    return &llvm_type;
+
+  LLVM_TYPE(bool,  llvm_bool__ )
+  LLVM_TYPE(sint,  llvm_sint__ )
+  LLVM_TYPE(int,   llvm_int__  )
+  LLVM_TYPE(dint,  llvm_dint__ )
+  LLVM_TYPE(lint,  llvm_lint__ )
+  LLVM_TYPE(usint, llvm_usint__)
+  LLVM_TYPE(uint,  llvm_uint__ )
+  LLVM_TYPE(udint, llvm_udint__)
+  LLVM_TYPE(ulint, llvm_ulint__)
+  LLVM_TYPE(byte,  llvm_usint__)
+  LLVM_TYPE(word,  llvm_uint__ )
+  LLVM_TYPE(dword, llvm_udint__)
+  LLVM_TYPE(lword, llvm_ulint__)
+  LLVM_TYPE(real,  llvm_real__ )
+  LLVM_TYPE(lreal, llvm_lreal__)
+#undef LLVM_TYPE
+  return NULL;
+}
+
+
+template<typename value_type> static std::string llvm_num(value_type value) {
+  std::ostringstream str;
+  str << value;
+  return str.str();
+}
+
+
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+
+
+/* The classes of the POUs and of their variables (see ../common/pou_table.hh) */
+class llvm_backend_t {
+  public:
+    typedef llvm_type_t type_t;
+    struct var_data_t {};
+    struct pou_data_t {};
+
+    static const type_t *elementary_type(symbol_c *type) {return llvm_elementary_type(type);}
+    static const char *generating(void) {return "while generating LLVM IR";}
+    static const char *generator(void)  {return "LLVM IR generator";}
+};
+
+typedef stage4_var_c<llvm_backend_t>       llvm_var_t;
+typedef stage4_pou_c<llvm_backend_t>       llvm_pou_c;
+typedef stage4_pou_table_c<llvm_backend_t> llvm_pou_table_c;
+typedef stage4_vardecl_c<llvm_backend_t>   llvm_vardecl_c;
+
+
+/* The type of the instances of an FB or PROGRAM in LLVM IR */
+static std::string llvm_ir_type(llvm_pou_c *pou) {return "%pou." + pou->name;}
+
+
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+
+
+class generate_llvm_c: public null_visitor_c {
+  private:
+    stage4out_c &s4o;
+    const char *builddir;
+
+    llvm_pou_table_c pous;
+    std::vector<llvm_var_t> globals;
+    std::map<std::string, llvm_var_t *> externals;    /* the globals not declared in the library */
+    std::vector<configuration_declaration_c *> configurations;
+    std::map<std::string, std::string> declarations;  /* the external functions called, and their declarations */
+
+    /* the function being generated */
+    llvm_pou_c *pou;
+    std::ostringstream *code;
+    int tmp_count;
+    int label_count;
+    std::vector<std::string> exit_labels;
+
+    /* the expression being generated */
+    const llvm_type_t *expr_type;
+    std::string result;
+
+  public:
+    generate_llvm_c(stage4out_c *s4o_ptr, const char *builddir_): s4o(*s4o_ptr), builddir(builddir_) {
+      pou = NULL;
+      code = NULL;
+      tmp_count = label_count = 0;
+      expr_type = NULL;
+    }
+    ~generate_llvm_c(void) {}
+
+
+  private:
+  /*************************/
+  /* Emitting instructions */
+  /*************************/
+    void emit(const std::string &instruction) {*code << "  " << instruction << "\n";}
+    std::string compute(const std::string &instruction) {
+      std::string tmp = "%t" + llvm_num(tmp_count++);
+      emit(tmp + " = " + instruction);
+      return tmp;
+    }
+    std::string new_label(void) {return "L" + llvm_num(label_count++);}
+    void start_block(const std::string &label) {*code << label << ":\n";}
+    /* Jump to a label. Any code that follows (e.g. the statements after an EXIT) is in a new (unreachable) block */
+    void jump(const std::string &label) {
+      emit("br label %" + label);
+      start_block(new_label());
+    }
+    void declare(const std::string &function, const std::string &declaration) {declarations[function] = declaration;}
+
+    void begin_function(llvm_pou_c *pou_) {
+      pou = pou_;
+      code = new std::ostringstream();
+      tmp_count = label_count = 0;
+      exit_labels.clear();
+    }
+    void end_function(std::ostringstream &module, const std::string &header) {
+      module << header << " {\nentry:\n" << code->str() << "}\n\n";
+      delete code;
+      code = NULL;
+      pou = NULL;
+    }
+
+    void unsupported(symbol_c *symbol, const char *what) {
+      STAGE4_ERROR(symbol, symbol, "%s not supported by the LLVM IR generator.", what);
+    }
+
+
+  /*************/
+  /* Constants */
+  /*************/
+    static std::string int_constant(uint64_t value, const llvm_type_t *type) {
+      /* LLVM IR wants the integer constants as the signed value of their bits */
+      int64_t bits = (type->bits < 64)? ((int64_t)(value << (64 - type->bits))) >> (64 - type->bits) : (int64_t)value;
+      return llvm_num(bits);
+    }
+
+    static std::string real_constant(double value, const llvm_type_t *type) {
+      /* LLVM IR wants the float constants as the hex of the double with the same value */
+      if (32 == type->bits) value = (float)value;
+      uint64_t bits;
+      memcpy(&bits, &value, sizeof(bits));
+      char str[32];
+      snprintf(str, sizeof(str), "0x%016llX", (unsigned long long)bits);
+      return str;
+    }
+
+    /* The constant value of a symbol (from the constant folding in stage 3) as a type,
+     * returns false if the symbol has no constant value.
+     */
+    static bool constant(symbol_c *symbol, const llvm_type_t *type, std::string &value) {
+      if (NULL == symbol) return false;
+      if (type->is_real) {
+        if      (VALID_CVALUE(real64, symbol)) value = real_constant(GET_CVALUE(real64, symbol), type);
+        else if (VALID_CVALUE( int64, symbol)) value = real_constant(GET_CVALUE( int64, symbol), type);
+        else if (VALID_CVALUE(uint64, symbol)) value = real_constant(GET_CVALUE(uint64, symbol), type);
+        else return false;
+      } else if (type->is_bool) {
+        if      (VALID_CVALUE(  bool, symbol)) value = GET_CVALUE(bool, symbol)? "1" : "0";
+        else if (VALID_CVALUE( int64, symbol)) value = (0 != GET_CVALUE( int64, symbol))? "1" : "0";
+        else if (VALID_CVALUE(uint64, symbol)) value = (0 != GET_CVALUE(uint64, symbol))? "1" : "0";
+        else return false;
+      } else {
+        if      (VALID_CVALUE( int64, symbol)) value = int_constant(GET_CVALUE( int64, symbol), type);
+        else if (VALID_CVALUE(uint64, symbol)) value = int_constant(GET_CVALUE(uint64, symbol), type);
+        else if (VALID_CVALUE(  bool, symbol)) value = GET_CVALUE(bool, symbol)? "1" : "0";
+        else return false;
+      }
+      return true;
+    }
+
+    /* The initial value of a variable */
+    std::string initial_value(llvm_var_t *var) {
+      std::string value;
+      if (NULL != var->init) {
+        if (!constant(var->init, var->type, value))
+          STAGE4_ERROR(var->init, var->init, "The initial value must be a constant.");
+        return value;
+      }
+      /* the default initial value of the (derived) type */
+      if (constant(type_initial_value_c::get(var->type_name), var->type, value)) return value;
+      return var->type->is_real? "0.0" : "0";
+    }
+
+
+  /*************/
+  /* Variables */
+  /*************/
+    llvm_var_t *find_var(symbol_c *name) {
+      llvm_var_t *var = (NULL == pou)? NULL : pou->find(upper_case_name(name));
+      if (NULL == var) STAGE4_ERROR(name, name, "Undeclared variable.");
+      return var;
+    }
+
+    std::string global_address(llvm_var_t *var) {
+      for (size_t i = 0; i < globals.size(); i++)
+        if (globals[i].name == var->name) {
+          /* the same representation is enough (e.g. a VAR_EXTERNAL of a type derived from the type of the global) */
+          bool same_type = (globals[i].type == var->type) ||
+                           ((NULL != globals[i].type) && (NULL != var->type) && (strcmp(globals[i].type->ir, var->type->ir) == 0));
+          if (!same_type || (globals[i].fb != var->fb))
+            STAGE4_ERROR(var->symbol, var->symbol, "The datatype of the VAR_EXTERNAL is not the datatype of its global variable.");
+          return "@GLOBAL__" + var->name;
+        }
+      /* not declared in this library, assume it is declared in another module */
+      externals[var->name] = var;
+      return "@GLOBAL__" + var->name;
+    }
+
+    std::string field_address(llvm_pou_c *fb, const std::string &instance, llvm_var_t *var) {
+      return compute("getelementptr inbounds " + llvm_ir_type(fb) + ", ptr " + instance + ", i32 0, i32 " + llvm_num(var->field));
+    }
+
+    std::string var_address(llvm_var_t *var) {
+      switch (var->vartype) {
+        case llvm_var_t::external_vt: return global_address(var);
+        case llvm_var_t::temp_vt    :
+        case llvm_var_t::result_vt  : return "%v." + var->name;
+        case llvm_var_t::inout_vt   : if (llvm_pou_c::function_pk == pou->kind) return "%a." + var->name; break;
+        default                     : break;
+      }
+      if (llvm_pou_c::function_pk == pou->kind) return "%v." + var->name;
+      return field_address(pou, "%data__", var);
+    }
+
+    /* The address of a variable, and its type (or FB type) */
+    std::string address(symbol_c *symbol, const llvm_type_t **type, llvm_pou_c **fb) {
+      symbolic_variable_c   *variable = dynamic_cast<symbolic_variable_c   *>(symbol);
+      structured_variable_c *field    = dynamic_cast<structured_variable_c *>(symbol);
+
+      if (NULL != variable) {
+        llvm_var_t *var = find_var(variable->var_name);
+        *type = var->type;
+        *fb   = var->fb;
+        return var_address(var);
+      }
+      if (NULL != field) {
+        const llvm_type_t *record_type;
+        llvm_pou_c *record_fb;
+        std::string record = address(field->record_variable, &record_type, &record_fb);
+        if (NULL == record_fb) unsupported(symbol, "Structures are");
+        llvm_var_t *var = record_fb->find(upper_case_name(field->field_selector));
+        if ((NULL == var) || (var->field < 0)) STAGE4_ERROR(symbol, symbol, "This variable of the FB instance may not be accessed.");
+        *type = var->type;
+        *fb   = var->fb;
+        return field_address(record_fb, record, var);
+      }
+      unsupported(symbol, "Arrays, pointers and direct variables are");
+      return ""; // humour the compiler!
+    }
+
+    /* The address of a variable of an elementary type */
+    std::string elementary_address(symbol_c *symbol, const llvm_type_t **type) {
+      llvm_pou_c *fb;
+      std::string addr = address(symbol, type, &fb);
+      if (NULL == *type) unsupported(symbol, "Using FB instances as values is");
+      return addr;
+    }
+
+    bool is_constant_var(symbol_c *symbol) {
+      symbolic_variable_c *variable = dynamic_cast<symbolic_variable_c *>(symbol);
+      return (NULL != variable) && find_var(variable->var_name)->constant;
+    }
+
+
+  /***************/
+  /* Expressions */
+  /***************/
+    /* Converts a value from one type to another, as the *_TO_* standard functions */
+    std::string convert(const std::string &v, const llvm_type_t *from, const llvm_type_t *to) {
+      if (from == to) return v;
+      if (to->is_bool) {
+        if (from->is_bool) return v;
+        std::string c = from->is_real? compute("fcmp une " + std::string(from->ir) + " " + v + ", 0.0")
+                                     : compute("icmp ne "  + std::string(from->ir) + " " + v + ", 0");
+        return compute("zext i1 " + c + " to i8");
+      }
+      if (from->is_real && to->is_real)
+        return compute(std::string((from->bits < to->bits)? "fpext " : "fptrunc ") + from->ir + " " + v + " to " + to->ir);
+      if (to->is_real)
+        return compute(std::string(from->is_signed? "sitofp " : "uitofp ") + from->ir + " " + v + " to " + to->ir);
+      if (from->is_real) {
+        /* rounded to the nearest integer (halfway cases away from zero), the negative values to 0 for the unsigned types */
+        std::string d = convert(v, from, &llvm_lreal__);
+        declare("llvm.round.f64", "declare double @llvm.round.f64(double)");
+        d = compute("call double @llvm.round.f64(double " + d + ")");
+        if (!to->is_signed) {
+          std::string negative = compute("fcmp olt double " + d + ", 0.0");
+          d = compute("select i1 " + negative + ", double 0.0, double " + d);
+        }
+        std::string i = compute(std::string(to->is_signed? "fptosi" : "fptoui") + " double " + d + " to i64");
+        return (to->bits < 64)? compute("trunc i64 " + i + " to " + to->ir) : i;
+      }
+      if (from->bits == to->bits) return v;
+      if (from->bits > to->bits) return compute("trunc " + std::string(from->ir) + " " + v + " to " + to->ir);
+      return compute(std::string(from->is_signed? "sext " : "zext ") + from->ir + " " + v + " to " + to->ir);
+    }
+
+    /* The value of an expression, as a type (NULL -> the datatype of the expression) */
+    std::string value(symbol_c *expr, const llvm_type_t *type) {
+      const llvm_type_t *own = llvm_elementary_type(expr->datatype);
+      if (NULL == type) type = own;
+      if (NULL == type) STAGE4_ERROR(expr, expr, "The datatype of this expression is not supported by the LLVM IR generator.");
+
+      std::string c;
+      reads_variable_c reads_variable;
+      expr->accept(reads_variable);
+      if ((!reads_variable.found || is_constant_var(expr)) && constant(expr, type, c)) return c;
+      if ((NULL != own) && (own != type)) return convert(value(expr, own), own, type);
+
+      const llvm_type_t *saved_type = expr_type;
+      expr_type = type;
+      result.clear();
+      expr->accept(*this);
+      std::string v = result;
+      expr_type = saved_type;
+      if (v.empty()) unsupported(expr, "This expression is");
+      return v;
+    }
+
+    /* The value of a BOOL expression, as an i1 */
+    std::string condition(symbol_c *expr) {
+      return compute("icmp ne i8 " + value(expr, &llvm_bool__) + ", 0");
+    }
+
+    void *arithmetic(symbol_c *symbol, symbol_c *l_exp, symbol_c *r_exp, const char *int_op, const char *uint_op, const char *real_op) {
+      const llvm_type_t *type = expr_type;
+      const char *op = type->is_bool? NULL : type->is_real? real_op : type->is_signed? int_op : uint_op;
+      if (NULL == op) unsupported(symbol, "This operation on this datatype is");
+      std::string l = value(l_exp, type);
+      std::string r = value(r_exp, type);
+      result = compute(std::string(op) + " " + type->ir + " " + l + ", " + r);
+      return NULL;
+    }
+
+    /* Integer division (DIV and MOD), returns 0 for a division by 0.
+     * The signed division of the most negative value by -1 overflows, and sdiv/srem then return poison,
+     * so the divisions by -1 are not done either: DIV returns the negated value (wrapping around, i.e.
+     * the most negative value for itself), and MOD returns 0. This is what the bytecode interpreter does too.
+     */
+    void *division(symbol_c *symbol, symbol_c *l_exp, symbol_c *r_exp, const char *int_op, const char *uint_op, const char *real_op) {
+      const llvm_type_t *type = expr_type;
+      if (type->is_real || type->is_bool) return arithmetic(symbol, l_exp, r_exp, NULL, NULL, real_op);
+      std::string ir(type->ir);
+      std::string l = value(l_exp, type);
+      std::string r = value(r_exp, type);
+      std::string zero = compute("icmp eq " + ir + " " + r + ", 0");
+      if (!type->is_signed) {
+        std::string divisor = compute("select i1 " + zero + ", " + ir + " 1, " + ir + " " + r);
+        std::string q = compute(std::string(uint_op) + " " + ir + " " + l + ", " + divisor);
+        result = compute("select i1 " + zero + ", " + ir + " 0, " + ir + " " + q);
+        return NULL;
+      }
+      std::string minus_one = compute("icmp eq " + ir + " " + r + ", -1");
+      std::string special   = compute("or i1 " + zero + ", " + minus_one);
+      std::string divisor   = compute("select i1 " + special + ", " + ir + " 1, " + ir + " " + r);
+      std::string q = compute(std::string(int_op) + " " + ir + " " + l + ", " + divisor);
+      /* with a divisor of 1, sdiv returns l and srem returns 0 */
+      std::string by_minus_one = (0 == strcmp(int_op, "sdiv"))? compute("sub " + ir + " 0, " + l) : std::string("0");
+      q      = compute("select i1 " + minus_one + ", " + ir + " " + by_minus_one + ", " + ir + " " + q);
+      result = compute("select i1 " + zero + ", " + ir + " 0, " + ir + " " + q);
+      return NULL;
+    }
+
+    /* AND, OR, XOR on BOOL and the bit strings */
+    void *bitwise(symbol_c *symbol, symbol_c *l_exp, symbol_c *r_exp, const char *op) {
+      if (expr_type->is_real) unsupported(symbol, "This operation on this datatype is");
+      std::string l = value(l_exp, expr_type);
+      std::string r = value(r_exp, expr_type);
+      result = compute(std::string(op) + " " + expr_type->ir + " " + l + ", " + r);
+      return NULL;
+    }
+
+    void *comparison(symbol_c *symbol, symbol_c *l_exp, symbol_c *r_exp, const char *int_cond, const char *uint_cond, const char *real_cond) {
+      const llvm_type_t *type = llvm_elementary_type(l_exp->datatype);
+      if (NULL == type) type = llvm_elementary_type(r_exp->datatype);
+      if (NULL == type) unsupported(symbol, "Comparing values of this datatype is");
+      std::string l = value(l_exp, type);
+      std::string r = value(r_exp, type);
+      std::string c = type->is_real? compute("fcmp " + std::string(real_cond) + " " + type->ir + " " + l + ", " + r)
+                                   : compute("icmp " + std::string(type->is_signed? int_cond : uint_cond) + " " + type->ir + " " + l + ", " + r);
+      result = convert(compute("zext i1 " + c + " to i8"), &llvm_bool__, expr_type);
+      return NULL;
+    }
+
+    std::string min_max(const std::string &a, const std::string &b, const llvm_type_t *type, bool is_min) {
+      std::string ir(type->ir);
+      std::string c = type->is_real? compute(std::string("fcmp ") + (is_min? "olt " : "ogt ") + ir + " " + a + ", " + b)
+                                   : compute(std::string("icmp ") + (is_min? (type->is_signed? "slt " : "ult ") : (type->is_signed? "sgt " : "ugt ")) + ir + " " + a + ", " + b);
+      return compute("select i1 " + c + ", " + ir + " " + a + ", " + ir + " " + b);
+    }
+
+    /* A REAL function, from an LLVM intrinsic (on float and double) or from libm (on double) */
+    std::string math(symbol_c *symbol, symbol_c *in, const char *intrinsic, const char *libm) {
+      const llvm_type_t *type = expr_type;
+      if (!type->is_real) unsupported(symbol, "This function on this datatype is");
+      if (NULL != intrinsic) {
+        std::string function = std::string("llvm.") + intrinsic + ((32 == type->bits)? ".f32" : ".f64");
+        declare(function, "declare " + std::string(type->ir) + " @" + function + "(" + type->ir + ")");
+        return compute("call " + std::string(type->ir) + " @" + function + "(" + type->ir + " " + value(in, type) + ")");
+      }
+      declare(libm, "declare double @" + std::string(libm) + "(double)");
+      std::string d = compute("call double @" + std::string(libm) + "(double " + value(in, &llvm_lreal__) + ")");
+      return convert(d, &llvm_lreal__, type);
+    }
+
+    std::string expt(symbol_c *symbol, symbol_c *in1, symbol_c *in2) {
+      const llvm_type_t *type = expr_type;
+      if (!type->is_real) unsupported(symbol, "EXPT on this datatype is");
+      std::string base     = value(in1, &llvm_lreal__);
+      std::string exponent = value(in2, &llvm_lreal__);
+      declare("llvm.pow.f64", "declare double @llvm.pow.f64(double, double)");
+      return convert(compute("call double @llvm.pow.f64(double " + base + ", double " + exponent + ")"), &llvm_lreal__, type);
+    }
+
+    /* A parameter of a call to a standard function, by its name (formal calls) or position (non formal calls) */
+    symbol_c *call_param(function_invocation_c *symbol, const std::string &name, int index) {
+      if (NULL != symbol->nonformal_param_list) {
+        list_c *list = dynamic_cast<list_c *>(symbol->nonformal_param_list);
+        return ((NULL != list) && (index >= 0) && (index < list->n))? list->get_element(index) : NULL;
+      }
+      function_call_param_iterator_c call_param_iterator(symbol);
+      return call_param_iterator.search_f(name.c_str());
+    }
+
+    symbol_c *required_param(function_invocation_c *symbol, const std::string &name, int index) {
+      symbol_c *param = call_param(symbol, name, index);
+      if (NULL == param) STAGE4_ERROR(symbol, symbol, "Missing parameter %s.", name.c_str());
+      return param;
+    }
+
+    std::string standard_function(function_invocation_c *symbol) {
+      const llvm_type_t *type = expr_type;
+      std::string name = upper_case_name(symbol->function_name);
+
+      if ((NULL != call_param(symbol, "EN", -1)) || (NULL != call_param(symbol, "ENO", -1)))
+        unsupported(symbol, "The EN and ENO parameters of the standard functions are");
+
+      if ((name.find("_TO_") != std::string::npos) || (name == "TRUNC")) {
+        symbol_c *in = required_param(symbol, "IN", 0);
+        const llvm_type_t *from = llvm_elementary_type(in->datatype);
+        if ((NULL == from) || (name.find("BCD") != std::string::npos)) unsupported(symbol, "This conversion is");
+        if (name != "TRUNC") return convert(value(in, from), from, type);
+        if (!from->is_real || type->is_real || type->is_bool) unsupported(symbol, "TRUNC on this datatype is");
+        return compute(std::string(type->is_signed? "fptosi " : "fptoui ") + from->ir + " " + value(in, from) + " to " + type->ir);
+      }
+      if (name == "MOVE") return value(required_param(symbol, "IN", 0), type);
+      if (name == "ABS") {
+        if (type->is_real) return math(symbol, required_param(symbol, "IN", 0), "fabs", NULL);
+        std::string v = value(required_param(symbol, "IN", 0), type);
+        if (!type->is_signed) return v;
+        std::string negative = compute("icmp slt " + std::string(type->ir) + " " + v + ", 0");
+        std::string minus    = compute("sub " + std::string(type->ir) + " 0, " + v);
+        return compute("select i1 " + negative + ", " + type->ir + " " + minus + ", " + type->ir + " " + v);
+      }
+      if (name == "SQRT") return math(symbol, required_param(symbol, "IN", 0), "sqrt",  NULL);
+      if (name == "LN"  ) return math(symbol, required_param(symbol, "IN", 0), "log",   NULL);
+      if (name == "LOG" ) return math(symbol, required_param(symbol, "IN", 0), "log10", NULL);
+      if (name == "EXP" ) return math(symbol, required_param(symbol, "IN", 0), "exp",   NULL);
+      if (name == "SIN" ) return math(symbol, required_param(symbol, "IN", 0), "sin",   NULL);
+      if (name == "COS" ) return math(symbol, required_param(symbol, "IN", 0), "cos",   NULL);
+      if (name == "TAN" ) return math(symbol, required_param(symbol, "IN", 0), NULL,    "tan");
+      if (name == "ASIN") return math(symbol, required_param(symbol, "IN", 0), NULL,    "asin");
+      if (name == "ACOS") return math(symbol, required_param(symbol, "IN", 0), NULL,    "acos");
+      if (name == "ATAN") return math(symbol, required_param(symbol, "IN", 0), NULL,    "atan");
+      if (name == "EXPT") return expt(symbol, required_param(symbol, "IN1", 0), required_param(symbol, "IN2", 1));
+      if ((name == "MIN") || (name == "MAX")) {
+        if (type->is_bool) unsupported(symbol, "MIN and MAX on BOOL are");
+        std::string v = value(required_param(symbol, "IN1", 0), type);
+        symbol_c *in;
+        for (int i = 1; NULL != (in = call_param(symbol, "IN" + llvm_num(i + 1), i)); i++)
+          v = min_max(v, value(in, type), type, name == "MIN");
+        return v;
+      }
+      if (name == "LIMIT") {
+        if (type->is_bool) unsupported(symbol, "LIMIT on BOOL is");
+        std::string mn = value(required_param(symbol, "MN", 0), type);
+        std::string in = value(required_param(symbol, "IN", 1), type);
+        std::string mx = value(required_param(symbol, "MX", 2), type);
+        return min_max(min_max(in, mx, type, true), mn, type, false);
+      }
+      if (name == "SEL") {
+        std::string g   = condition(required_param(symbol, "G", 0));
+        std::string in0 = value(required_param(symbol, "IN0", 1), type);
+        std::string in1 = value(required_param(symbol, "IN1", 2), type);
+        return compute("select i1 " + g + ", " + type->ir + " " + in1 + ", " + type->ir + " " + in0);
+      }
+      unsupported(symbol, "This standard function is");
+      return ""; // humour the compiler!
+    }
+
+    std::string call_function(function_invocation_c *symbol, llvm_pou_c *function) {
+      function_param_iterator_c fp_iterator(function->decl);
+      function_call_param_iterator_c function_call_param_iterator(symbol);
+      identifier_c *param_name;
+      std::string args;
+
+      while ((param_name = fp_iterator.next()) != NULL) {
+        llvm_var_t *param = function->find(upper_case_name(param_name));
+        if (NULL == param) ERROR;
+
+        /* Get the value from a foo(<param_name> = <param_value>) style call */
+        symbol_c *param_value = function_call_param_iterator.search_f(param_name);
+        /* Get the value from a foo(<param_value>) style call */
+        /* When using the informal invocation style, user can not pass values to EN or ENO parameters if these
+         * were implicitly defined!
+         */
+        if ((param_value == NULL) && !fp_iterator.is_en_eno_param_implicit())
+          param_value = function_call_param_iterator.next_nf();
+
+        const llvm_type_t *type;
+        switch (fp_iterator.param_direction()) {
+          case function_param_iterator_c::direction_in:
+            args += (args.empty()? "" : ", ") + std::string(param->type->ir) + " " + ((NULL != param_value)? value(param_value, param->type) : initial_value(param));
+            break;
+          case function_param_iterator_c::direction_out:
+            args += (args.empty()? "ptr " : ", ptr ") + ((NULL != param_value)? elementary_address(param_value, &type) : std::string("null"));
+            break;
+          case function_param_iterator_c::direction_inout:
+            if (NULL == param_value) STAGE4_ERROR(symbol, symbol, "Missing VAR_IN_OUT parameter %s.", param_name->value);
+            args += (args.empty()? "ptr " : ", ptr ") + elementary_address(param_value, &type);
+            break;
+          default:
+            break;
+        }
+      }
+      return compute("call " + std::string(function->return_type->ir) + " @" + function->name + "(" + args + ")");
+    }
+
+
+  public:
+  /********************/
+  /* 2.1.6 - Pragmas  */
+  /********************/
+    void *visit(enable_code_generation_pragma_c * symbol)   {code_enabled = true;  return NULL;}
+    void *visit(disable_code_generation_pragma_c * symbol)  {code_enabled = false; return NULL;}
+
+  /**************************************/
+  /* B.1.5 - Program organization units */
+  /**************************************/
+    void *visit(library_c *symbol) {
+      code_enabled = true;
+      for (int i = 0; i < symbol->n; i++) symbol->get_element(i)->accept(*this);
+      generate_module();
+      return NULL;
+    }
+
+    void *visit(function_declaration_c *symbol) {
+      pous.add(llvm_pou_c::function_pk, symbol->derived_function_name, symbol, symbol->var_declarations_list, symbol->function_body, code_enabled);
+      return NULL;
+    }
+    void *visit(function_block_declaration_c *symbol) {
+      pous.add(llvm_pou_c::function_block_pk, symbol->fblock_name, symbol, symbol->var_declarations, symbol->fblock_body, code_enabled);
+      return NULL;
+    }
+    void *visit(program_declaration_c *symbol) {
+      pous.add(llvm_pou_c::program_pk, symbol->program_type_name, symbol, symbol->var_declarations, symbol->function_block_body, code_enabled);
+      return NULL;
+    }
+    void *visit(configuration_declaration_c *symbol) {
+      if (code_enabled) configurations.push_back(symbol);
+      return NULL;
+    }
+
+  private:
+    bool code_enabled;
+
+
+  /*********************************/
+  /* Generating the POUs' functions */
+  /*********************************/
+    void init_local(llvm_var_t *var) {
+      emit("%v." + var->name + " = alloca " + var->type->ir);
+      emit("store " + std::string(var->type->ir) + " " + initial_value(var) + ", ptr %v." + var->name);
+    }
+
+    /* Copy an output of a FUNCTION to the address given by the caller, if not null */
+    void copy_out(llvm_var_t *var) {
+      std::string copy_label = new_label(), next_label = new_label();
+      std::string given = compute("icmp ne ptr %a." + var->name + ", null");
+      emit("br i1 " + given + ", label %" + copy_label + ", label %" + next_label);
+      start_block(copy_label);
+      std::string v = compute("load " + std::string(var->type->ir) + ", ptr %v." + var->name);
+      emit("store " + std::string(var->type->ir) + " " + v + ", ptr %a." + var->name);
+      emit("br label %" + next_label);
+      start_block(next_label);
+    }
+
+    /* The EN/ENO handling of FUNCTIONs and FBs: if (!EN) {ENO = FALSE; goto <disabled_label>;} ENO = TRUE; */
+    void check_en(const std::string &disabled_label) {
+      llvm_var_t *en  = pou->find("EN");
+      llvm_var_t *eno = pou->find("ENO");
+      if ((NULL == en) || (en->vartype != llvm_var_t::input_vt)) return;
+      std::string enabled_label = new_label(), not_enabled_label = new_label();
+      emit("br i1 " + compute("icmp ne i8 " + compute("load i8, ptr " + var_address(en)) + ", 0") + ", label %" + enabled_label + ", label %" + not_enabled_label);
+      start_block(not_enabled_label);
+      if ((NULL != eno) && (eno->vartype == llvm_var_t::output_vt)) emit("store i8 0, ptr " + var_address(eno));
+      emit("br label %" + disabled_label);
+      start_block(enabled_label);
+      if ((NULL != eno) && (eno->vartype == llvm_var_t::output_vt)) emit("store i8 1, ptr " + var_address(eno));
+    }
+
+    void generate_function(std::ostringstream &module, llvm_pou_c *function) {
+      function_param_iterator_c fp_iterator(function->decl);
+      identifier_c *param_name;
+      std::vector<llvm_var_t *> outputs;
+      std::string params;
+
+      begin_function(function);
+      while ((param_name = fp_iterator.next()) != NULL) {
+        llvm_var_t *param = function->find(upper_case_name(param_name));
+        if (NULL == param) ERROR;
+        switch (fp_iterator.param_direction()) {
+          case function_param_iterator_c::direction_in:
+            params += (params.empty()? "" : ", ") + std::string(param->type->ir) + " %a." + param->name;
+            emit("%v." + param->name + " = alloca " + param->type->ir);
+            emit("store " + std::string(param->type->ir) + " %a." + param->name + ", ptr %v." + param->name);
+            break;
+          case function_param_iterator_c::direction_out:
+            params += (params.empty()? "ptr %a." : ", ptr %a.") + param->name;
+            init_local(param);
+            outputs.push_back(param);
+            break;
+          case function_param_iterator_c::direction_inout:
+            params += (params.empty()? "ptr %a." : ", ptr %a.") + param->name;
+            break;
+          default:
+            break;
+        }
+      }
+      for (size_t i = 0; i < function->vars.size(); i++)
+        if ((llvm_var_t::private_vt == function->vars[i].vartype) || (llvm_var_t::temp_vt == function->vars[i].vartype) || (llvm_var_t::result_vt == function->vars[i].vartype))
+          init_local(&function->vars[i]);
+
+      check_en("disabled");
+      function->body->accept(*this);
+      emit("br label %end");
+
+      std::string ret_type = (NULL == function->return_type)? "void" : function->return_type->ir;
+      std::string ret = "ret void";
+      start_block("disabled");
+      for (size_t i = 0; i < outputs.size(); i++)
+        if (outputs[i]->name == "ENO") copy_out(outputs[i]);
+      if (NULL != function->return_type) ret = "ret " + ret_type + " " + compute("load " + ret_type + ", ptr %v." + function->name);
+      emit(ret);
+      start_block("end");
+      for (size_t i = 0; i < outputs.size(); i++) copy_out(outputs[i]);
+      if (NULL != function->return_type) ret = "ret " + ret_type + " " + compute("load " + ret_type + ", ptr %v." + function->name);
+      emit(ret);
+      end_function(module, "define " + ret_type + " @" + function->name + "(" + params + ")");
+    }
+
+    void generate_fb(std::ostringstream &module, llvm_pou_c *fb) {
+      /* the type of the instances */
+      std::string fields;
+      for (size_t i = 0; i < fb->vars.size(); i++)
+        if (fb->vars[i].field >= 0)
+          fields += (fields.empty()? "" : ", ") + ((NULL != fb->vars[i].type)? std::string(fb->vars[i].type->ir) : llvm_ir_type(fb->vars[i].fb));
+      module << llvm_ir_type(fb) << " = type {" << fields << "}\n\n";
+
+      /* the initialisation of the instances */
+      begin_function(fb);
+      for (size_t i = 0; i < fb->vars.size(); i++) {
+        llvm_var_t *var = &fb->vars[i];
+        if (var->field < 0) continue;
+        std::string addr = field_address(fb, "%data__", var);
+        if (NULL != var->fb) emit("call void @" + var->fb->name + "_init__(ptr " + addr + ", i8 %retain)");
+        else                 emit("store " + std::string(var->type->ir) + " " + initial_value(var) + ", ptr " + addr);
+      }
+      emit("ret void");
+      end_function(module, "define void @" + fb->name + "_init__(ptr %data__, i8 %retain)");
+
+      /* the body */
+      begin_function(fb);
+      for (size_t i = 0; i < fb->vars.size(); i++)
+        if (llvm_var_t::temp_vt == fb->vars[i].vartype) init_local(&fb->vars[i]);
+      check_en("end");
+      fb->body->accept(*this);
+      emit("br label %end");
+      start_block("end");
+      emit("ret void");
+      end_function(module, "define void @" + fb->name + "_body__(ptr %data__)");
+    }
+
+
+  /*******************************/
+  /* Generating the configuration */
+  /*******************************/
+    void collect_globals(symbol_c *global_var_declarations) {
+      if (NULL == global_var_declarations) return;
+      size_t first = globals.size();
+      llvm_vardecl_c vardecl(pous, globals, llvm_var_t::global_vt, false);
+      global_var_declarations->accept(vardecl);
+      for (size_t i = first; i < globals.size(); i++)
+        for (size_t j = 0; j < i; j++)
+          if (globals[i].name == globals[j].name)
+            STAGE4_ERROR(globals[i].symbol, globals[i].symbol, "The LLVM IR generator requires the global variables to have distinct names.");
+    }
+
+    void generate_globals(std::ostringstream &module, std::ostringstream &init) {
+      for (size_t i = 0; i < globals.size(); i++) {
+        llvm_var_t *var = &globals[i];
+        std::string addr = "@GLOBAL__" + var->name;
+        if (NULL != var->fb) {
+          module << addr << " = global " << llvm_ir_type(var->fb) << " zeroinitializer\n";
+          init << "  call void @" << var->fb->name << "_init__(ptr " << addr << ", i8 0)\n";
+        } else {
+          module << addr << " = global " << var->type->ir << " " << initial_value(var) << "\n";
+          init << "  store " << var->type->ir << " " << initial_value(var) << ", ptr " << addr << "\n";
+        }
+      }
+      for (std::map<std::string, llvm_var_t *>::iterator i = externals.begin(); i != externals.end(); i++)
+        module << "@GLOBAL__" << i->first << " = external global " << ((NULL != i->second->type)? std::string(i->second->type->ir) : llvm_ir_type(i->second->fb)) << "\n";
+      module << "\n";
+    }
+
+    void generate_resource(std::ostringstream &module, std::string resource_name, single_resource_declaration_c *resource, unsigned long long common_ticktime) {
+      std::map<std::string, unsigned long long> task_ticks;  /* the ticks between the runs of each task */
+      list_c *tasks    = dynamic_cast<list_c *>(resource->task_configuration_list);
+      list_c *programs = dynamic_cast<list_c *>(resource->program_configuration_list);
+      std::ostringstream init, run;
+      int labels = 0;
+
+      for (int i = 0; (NULL != tasks) && (i < tasks->n); i++) {
+        task_configuration_c  *task = dynamic_cast<task_configuration_c  *>(tasks->get_element(i));
+        task_initialization_c *task_init = dynamic_cast<task_initialization_c *>(task->task_initialization);
+        if (NULL != task_init->single_data_source) unsupported(task, "SINGLE tasks are");
+        unsigned long long interval = calculate_time(task_init->interval_data_source);
+        task_ticks[upper_case_name(task->task_name)] = (0 == interval)? 1 : interval / common_ticktime;
+      }
+
+      for (int i = 0; (NULL != programs) && (i < programs->n); i++) {
+        program_configuration_c *program = dynamic_cast<program_configuration_c *>(programs->get_element(i));
+        if (NULL != program->prog_conf_elements) unsupported(program, "The configuration elements of PROGRAM instances are");
+        llvm_pou_c *type = pous.get(program->program_type_name, llvm_pou_c::program_pk);
+        if (NULL == type) STAGE4_ERROR(program->program_type_name, program->program_type_name, "Unknown PROGRAM type.");
+        std::string instance = "@" + resource_name + "__" + upper_case_name(program->program_name);
+        module << instance << " = global " << llvm_ir_type(type) << " zeroinitializer\n";
+        init << "  call void @" << type->name << "_init__(ptr " << instance << ", i8 0)\n";
+
+        unsigned long long ticks = (NULL == program->task_name)? 1 : task_ticks[upper_case_name(program->task_name)];
+        if (ticks <= 1) {
+          run << "  call void @" << type->name << "_body__(ptr " << instance << ")\n";
+        } else {
+          std::string l = llvm_num(labels++);
+          run << "  %r" << l << " = urem i64 %tick, " << ticks << "\n";
+          run << "  %c" << l << " = icmp eq i64 %r" << l << ", 0\n";
+          run << "  br i1 %c" << l << ", label %run" << l << ", label %next" << l << "\n";
+          run << "run" << l << ":\n";
+          run << "  call void @" << type->name << "_body__(ptr " << instance << ")\n";
+          run << "  br label %next" << l << "\n";
+          run << "next" << l << ":\n";
+        }
+      }
+      module << "\ndefine void @" << resource_name << "_init__() {\nentry:\n" << init.str() << "  ret void\n}\n\n";
+      module << "define void @" << resource_name << "_run__(i64 %tick) {\nentry:\n" << run.str() << "  ret void\n}\n\n";
+    }
+
+    /* The tick of the resources, i.e. the GCD of the intervals of the tasks (in ns) */
+    static unsigned long long gcd(unsigned long long a, unsigned long long b) {
+      while (0 != b) {unsigned long long t = a % b; a = b; b = t;}
+      return a;
+    }
+
+    unsigned long long common_ticktime(configuration_declaration_c *configuration) {
+      unsigned long long ticktime = 0;
+      std::vector<single_resource_declaration_c *> resources = get_resources(configuration, NULL);
+      for (size_t r = 0; r < resources.size(); r++) {
+        list_c *tasks = dynamic_cast<list_c *>(resources[r]->task_configuration_list);
+        for (int i = 0; (NULL != tasks) && (i < tasks->n); i++) {
+          task_configuration_c  *task = dynamic_cast<task_configuration_c  *>(tasks->get_element(i));
+          task_initialization_c *task_init = dynamic_cast<task_initialization_c *>(task->task_initialization);
+          ticktime = gcd(ticktime, calculate_time(task_init->interval_data_source));
+        }
+      }
+      return ticktime;
+    }
+
+    std::vector<single_resource_declaration_c *> get_resources(configuration_declaration_c *configuration, std::vector<std::string> *names) {
+      std::vector<single_resource_declaration_c *> resources;
+      single_resource_declaration_c *single = dynamic_cast<single_resource_declaration_c *>(configuration->resource_declarations);
+      list_c *list = dynamic_cast<list_c *>(configuration->resource_declarations);
+      if (NULL != single) {
+        resources.push_back(single);
+        if (NULL != names) names->push_back("RESOURCE");
+      }
+      for (int i = 0; (NULL != list) && (i < list->n); i++) {
+        resource_declaration_c *resource = dynamic_cast<resource_declaration_c *>(list->get_element(i));
+        single = dynamic_cast<single_resource_declaration_c *>(resource->resource_declaration);
+        if (NULL == single) ERROR;
+        resources.push_back(single);
+        if (NULL != names) names->push_back(upper_case_name(resource->resource_name));
+      }
+      return resources;
+    }
+
+    void generate_configuration(std::ostringstream &module, std::ostringstream &globals_init, configuration_declaration_c *configuration) {
+      std::vector<std::string> names;
+      std::vector<single_resource_declaration_c *> resources = get_resources(configuration, &names);
+      unsigned long long ticktime = common_ticktime(configuration);
+
+      module << "@common_ticktime__ = global i64 " << ticktime << "\n\n";
+      for (size_t r = 0; r < resources.size(); r++)
+        generate_resource(module, names[r], resources[r], ticktime);
+
+      module << "define void @config_init__() {\nentry:\n" << globals_init.str();
+      for (size_t r = 0; r < resources.size(); r++) module << "  call void @" << names[r] << "_init__()\n";
+      module << "  ret void\n}\n\n";
+      module << "define void @config_run__(i64 %tick) {\nentry:\n";
+      for (size_t r = 0; r < resources.size(); r++) module << "  call void @" << names[r] << "_run__(i64 %tick)\n";
+      module << "  ret void\n}\n\n";
+    }
+
+    void generate_main(std::ostringstream &module) {
+      module << "define i32 @main() {\n"
+             << "entry:\n"
+             << "  call void @config_init__()\n"
+             << "  br label %loop\n"
+             << "loop:\n"
+             << "  %tick = phi i64 [0, %entry], [%next, %loop]\n"
+             << "  call void @config_run__(i64 %tick)\n"
+             << "  %next = add i64 %tick, 1\n"
+             << "  %more = icmp ult i64 %next, " << main_ticks__ << "\n"
+             << "  br i1 %more, label %loop, label %done\n"
+             << "done:\n"
+             << "  ret i32 0\n"
+             << "}\n\n";
+    }
+
+
+    void generate_module(void) {
+      std::ostringstream module, pou_code, globals_init;
+
+      if (configurations.size() > 1)
+        STAGE4_ERROR(configurations[1], configurations[1], "The LLVM IR generator supports a single CONFIGURATION.");
+      for (size_t c = 0; c < configurations.size(); c++) {
+        collect_globals(configurations[c]->global_var_declarations);
+        list_c *list = dynamic_cast<list_c *>(configurations[c]->resource_declarations);
+        for (int i = 0; (NULL != list) && (i < list->n); i++)
+          collect_globals(dynamic_cast<resource_declaration_c *>(list->get_element(i))->global_var_declarations);
+      }
+      for (std::map<std::string, llvm_pou_c *>::iterator i = pous.pous.begin(); i != pous.pous.end(); i++)
+        if (i->second->enabled) pous.collect(i->second, i->second->decl);
+      /* the PROGRAM instances */
+      for (size_t c = 0; c < configurations.size(); c++) {
+        std::vector<single_resource_declaration_c *> resources = get_resources(configurations[c], NULL);
+        for (size_t r = 0; r < resources.size(); r++) {
+          list_c *programs = dynamic_cast<list_c *>(resources[r]->program_configuration_list);
+          for (int i = 0; (NULL != programs) && (i < programs->n); i++) {
+            program_configuration_c *program = dynamic_cast<program_configuration_c *>(programs->get_element(i));
+            pous.get(program->program_type_name, llvm_pou_c::program_pk);
+          }
+        }
+      }
+
+      for (size_t i = 0; i < pous.collected.size(); i++) {
+        llvm_pou_c *p = pous.collected[i];
+        if      (llvm_pou_c::function_pk != p->kind) generate_fb(pou_code, p);
+        else if (p->enabled)                         generate_function(pou_code, p);
+      }
+
+      module << "; LLVM IR generated by iec2ll from IEC 61131-3 code\n\n";
+      generate_globals(module, globals_init);
+      module << pou_code.str();
+      for (size_t c = 0; c < configurations.size(); c++)
+        generate_configuration(module, globals_init, configurations[c]);
+      if ((0 != main_ticks__) && !configurations.empty())
+        generate_main(module);
+      for (std::map<std::string, std::string>::iterator i = declarations.begin(); i != declarations.end(); i++)
+        module << i->second << "\n";
+
+      stage4out_c ll(builddir, "PLC", "ll");
+      ll.print(module.str());
+    }
+
+
+  public:
+  /***************************************/
+  /* B.3 - Language ST (Structured Text) */
+  /***************************************/
+  /***********************/
+  /* B 3.1 - Expressions */
+  /***********************/
+    void *visit(symbolic_variable_c *symbol) {
+      const llvm_type_t *type;
+      std::string addr = elementary_address(symbol, &type);
+      result = convert(compute("load " + std::string(type->ir) + ", ptr " + addr), type, expr_type);
+      return NULL;
+    }
+    void *visit(structured_variable_c *symbol) {
+      const llvm_type_t *type;
+      std::string addr = elementary_address(symbol, &type);
+      result = convert(compute("load " + std::string(type->ir) + ", ptr " + addr), type, expr_type);
+      return NULL;
+    }
+
+    void *visit(     or_expression_c *symbol) {return bitwise(symbol, symbol->l_exp, symbol->r_exp, "or" );}
+    void *visit(    xor_expression_c *symbol) {return bitwise(symbol, symbol->l_exp, symbol->r_exp, "xor");}
+    void *visit(    and_expression_c *symbol) {return bitwise(symbol, symbol->l_exp, symbol->r_exp, "and");}
+    void *visit(    equ_expression_c *symbol) {return comparison(symbol, symbol->l_exp, symbol->r_exp, "eq",  "eq",  "oeq");}
+    void *visit( notequ_expression_c *symbol) {return comparison(symbol, symbol->l_exp, symbol->r_exp, "ne",  "ne",  "une");}
+    void *visit(     lt_expression_c *symbol) {return comparison(symbol, symbol->l_exp, symbol->r_exp, "slt", "ult", "olt");}
+    void *visit(     gt_expression_c *symbol) {return comparison(symbol, symbol->l_exp, symbol->r_exp, "sgt", "ugt", "ogt");}
+    void *visit(     le_expression_c *symbol) {return comparison(symbol, symbol->l_exp, symbol->r_exp, "sle", "ule", "ole");}
+    void *visit(     ge_expression_c *symbol) {return comparison(symbol, symbol->l_exp, symbol->r_exp, "sge", "uge", "oge");}
+    void *visit(    add_expression_c *symbol) {return arithmetic(symbol, symbol->l_exp, symbol->r_exp, "add", "add", "fadd");}
+    void *visit(    sub_expression_c *symbol) {return arithmetic(symbol, symbol->l_exp, symbol->r_exp, "sub", "sub", "fsub");}
+    void *visit(    mul_expression_c *symbol) {return arithmetic(symbol, symbol->l_exp, symbol->r_exp, "mul", "mul", "fmul");}
+    void *visit(    div_expression_c *symbol) {return division(symbol, symbol->l_exp, symbol->r_exp, "sdiv", "udiv", "fdiv");}
+    void *visit(    mod_expression_c *symbol) {return division(symbol, symbol->l_exp, symbol->r_exp, "srem", "urem", NULL);}
+    void *visit(  power_expression_c *symbol) {result = expt(symbol, symbol->l_exp, symbol->r_exp); return NULL;}
+    void *visit(    neg_expression_c *symbol) {
+      if (expr_type->is_bool) unsupported(symbol, "This operation on this datatype is");
+      std::string v = value(symbol->exp, expr_type);
+      result = expr_type->is_real? compute("fneg " + std::string(expr_type->ir) + " " + v)
+                                 : compute("sub "  + std::string(expr_type->ir) + " 0, " + v);
+      return NULL;
+    }
+    void *visit(    not_expression_c *symbol) {
+      if (expr_type->is_real) unsupported(symbol, "This operation on this datatype is");
+      std::string v = value(symbol->exp, expr_type);
+      result = compute("xor " + std::string(expr_type->ir) + " " + v + (expr_type->is_bool? ", 1" : ", -1"));
+      return NULL;
+    }
+
+    void *visit(function_invocation_c *symbol) {
+      llvm_pou_c *function = pous.find_function(symbol->called_function_declaration);
+      if (NULL != function) {
+        if (NULL == function->return_type) unsupported(symbol, "Calling VOID FUNCTIONs in expressions is");
+        result = call_function(symbol, function);
+      } else {
+        result = standard_function(symbol);
+      }
+      return NULL;
+    }
+
+
+  /********************/
+  /* B 3.2 Statements */
+  /********************/
+    void *visit(statement_list_c *symbol) {
+      for (int i = 0; i < symbol->n; i++) symbol->get_element(i)->accept(*this);
+      return NULL;
+    }
+
+    /*********************************/
+    /* B 3.2.1 Assignment Statements */
+    /*********************************/
+    void *visit(assignment_statement_c *symbol) {
+      const llvm_type_t *type;
+      std::string addr = elementary_address(symbol->l_exp, &type);
+      emit("store " + std::string(type->ir) + " " + value(symbol->r_exp, type) + ", ptr " + addr);
+      return NULL;
+    }
+
+    /*****************************************/
+    /* B 3.2.2 Subprogram Control Statements */
+    /*****************************************/
+    void *visit(return_statement_c *symbol) {
+      jump("end");
+      return NULL;
+    }
+
+    void *visit(fb_invocation_c *symbol) {
+      const llvm_type_t *type;
+      llvm_pou_c *fb;
+      std::string instance = address(symbol->fb_name, &type, &fb);
+      if (NULL == fb) unsupported(symbol, "Calling this FB is");
+
+      function_param_iterator_c fp_iterator(fb->decl);
+      function_call_param_iterator_c function_call_param_iterator(symbol);
+      identifier_c *param_name;
+
+      /* the inputs (and the in_outs, copied in and out of the instance as in generate_c) */
+      while ((param_name = fp_iterator.next()) != NULL) {
+        symbol_c *param_value = function_call_param_iterator.search_f(param_name);
+        if ((param_value == NULL) && !fp_iterator.is_en_eno_param_implicit())
+          param_value = function_call_param_iterator.next_nf();
+        if (param_value == NULL) continue;
+        function_param_iterator_c::param_direction_t param_direction = fp_iterator.param_direction();
+        if ((param_direction != function_param_iterator_c::direction_in) && (param_direction != function_param_iterator_c::direction_inout)) continue;
+        llvm_var_t *param = fb->find(upper_case_name(param_name));
+        if ((NULL == param) || (NULL == param->type)) unsupported(param_value, "Passing FB instances as parameters is");
+        std::string v = value(param_value, param->type);
+        emit("store " + std::string(param->type->ir) + " " + v + ", ptr " + field_address(fb, instance, param));
+      }
+
+      emit("call void @" + fb->name + "_body__(ptr " + instance + ")");
+
+      /* the outputs */
+      fp_iterator.reset();
+      function_call_param_iterator.reset();
+      while ((param_name = fp_iterator.next()) != NULL) {
+        symbol_c *param_value = function_call_param_iterator.search_f(param_name);
+        if ((param_value == NULL) && !fp_iterator.is_en_eno_param_implicit())
+          param_value = function_call_param_iterator.next_nf();
+        if (param_value == NULL) continue;
+        function_param_iterator_c::param_direction_t param_direction = fp_iterator.param_direction();
+        if ((param_direction != function_param_iterator_c::direction_out) && (param_direction != function_param_iterator_c::direction_inout)) continue;
+        llvm_var_t *param = fb->find(upper_case_name(param_name));
+        if ((NULL == param) || (NULL == param->type)) unsupported(param_value, "Passing FB instances as parameters is");
+        const llvm_type_t *var_type;
+        std::string addr = elementary_address(param_value, &var_type);
+        std::string v = compute("load " + std::string(param->type->ir) + ", ptr " + field_address(fb, instance, param));
+        emit("store " + std::string(var_type->ir) + " " + convert(v, param->type, var_type) + ", ptr " + addr);
+      }
+      return NULL;
+    }
+
+    /***********************************/
+    /* B 3.2.3 Selection Statements */
+    /***********************************/
+    /* if (<match>) {<statement_list>; goto <end_label>;}, and continue with the code for !<match> */
+    void branch(const std::string &match, symbol_c *statement_list, const std::string &end_label) {
+      std::string then_label = new_label(), else_label = new_label();
+      emit("br i1 " + match + ", label %" + then_label + ", label %" + else_label);
+      start_block(then_label);
+      if (NULL != statement_list) statement_list->accept(*this);
+      emit("br label %" + end_label);
+      start_block(else_label);
+    }
+
+    void *visit(if_statement_c *symbol) {
+      std::string end_label = new_label();
+      branch(condition(symbol->expression), symbol->statement_list, end_label);
+      list_c *elseif_list = dynamic_cast<list_c *>(symbol->elseif_statement_list);
+      for (int i = 0; (NULL != elseif_list) && (i < elseif_list->n); i++) {
+        elseif_statement_c *elseif = dynamic_cast<elseif_statement_c *>(elseif_list->get_element(i));
+        branch(condition(elseif->expression), elseif->statement_list, end_label);
+      }
+      if (NULL != symbol->else_statement_list) symbol->else_statement_list->accept(*this);
+      emit("br label %" + end_label);
+      start_block(end_label);
+      return NULL;
+    }
+
+    void *visit(case_statement_c *symbol) {
+      const llvm_type_t *type = llvm_elementary_type(symbol->expression->datatype);
+      if ((NULL == type) || type->is_real) unsupported(symbol->expression, "CASE on this datatype is");
+      std::string ir(type->ir);
+      std::string selector = value(symbol->expression, type);
+      std::string end_label = new_label();
+
+      list_c *elements = dynamic_cast<list_c *>(symbol->case_element_list);
+      for (int i = 0; (NULL != elements) && (i < elements->n); i++) {
+        case_element_c *element = dynamic_cast<case_element_c *>(elements->get_element(i));
+        list_c *case_list = dynamic_cast<list_c *>(element->case_list);
+        std::string match;
+        for (int j = 0; (NULL != case_list) && (j < case_list->n); j++) {
+          symbol_c *item = case_list->get_element(j);
+          subrange_c *range = dynamic_cast<subrange_c *>(item);
+          std::string m;
+          if (NULL != range) {
+            std::string lower = compute("icmp " + std::string(type->is_signed? "sge " : "uge ") + ir + " " + selector + ", " + value(range->lower_limit, type));
+            std::string upper = compute("icmp " + std::string(type->is_signed? "sle " : "ule ") + ir + " " + selector + ", " + value(range->upper_limit, type));
+            m = compute("and i1 " + lower + ", " + upper);
+          } else {
+            m = compute("icmp eq " + ir + " " + selector + ", " + value(item, type));
+          }
+          match = match.empty()? m : compute("or i1 " + match + ", " + m);
+        }
+        if (match.empty()) continue;
+        branch(match, element->statement_list, end_label);
+      }
+      if (NULL != symbol->statement_list) symbol->statement_list->accept(*this);
+      emit("br label %" + end_label);
+      start_block(end_label);
+      return NULL;
+    }
+
+    /********************************/
+    /* B 3.2.4 Iteration Statements */
+    /********************************/
+    void *visit(for_statement_c *symbol) {
+      const llvm_type_t *type;
+      std::string control = elementary_address(symbol->control_variable, &type);
+      if (type->is_real || type->is_bool) unsupported(symbol->control_variable, "FOR loops on this datatype are");
+      std::string ir(type->ir);
+
+      emit("store " + ir + " " + value(symbol->beg_expression, type) + ", ptr " + control);
+      std::string end = value(symbol->end_expression, type);
+      std::string by  = (NULL != symbol->by_expression)? value(symbol->by_expression, type) : "1";
+      /* the sign of BY, if known at compile time (0 if not) */
+      int by_sign = 1;
+      if ((NULL != symbol->by_expression) && type->is_signed) {
+        if      (VALID_CVALUE( int64, symbol->by_expression)) by_sign = (GET_CVALUE(int64, symbol->by_expression) < 0)? -1 : 1;
+        else if (!VALID_CVALUE(uint64, symbol->by_expression)) by_sign = 0;
+      }
+
+      std::string cond_label = new_label(), body_label = new_label(), exit_label = new_label();
+      emit("br label %" + cond_label);
+      start_block(cond_label);
+      std::string v = compute("load " + ir + ", ptr " + control);
+      std::string more;
+      std::string le = type->is_signed? "sle " : "ule ";
+      if      (by_sign > 0) more = compute("icmp " + le + ir + " " + v + ", " + end);
+      else if (by_sign < 0) more = compute("icmp sge " + ir + " " + v + ", " + end);
+      else {
+        std::string up   = compute("icmp sgt " + ir + " " + by + ", 0");
+        std::string less = compute("icmp sle " + ir + " " + v + ", " + end);
+        std::string grtr = compute("icmp sge " + ir + " " + v + ", " + end);
+        more = compute("select i1 " + up + ", i1 " + less + ", i1 " + grtr);
+      }
+      emit("br i1 " + more + ", label %" + body_label + ", label %" + exit_label);
+      start_block(body_label);
+      exit_labels.push_back(exit_label);
+      if (NULL != symbol->statement_list) symbol->statement_list->accept(*this);
+      exit_labels.pop_back();
+      std::string next = compute("add " + ir + " " + compute("load " + ir + ", ptr " + control) + ", " + by);
+      emit("store " + ir + " " + next + ", ptr " + control);
+      emit("br label %" + cond_label);
+      start_block(exit_label);
+      return NULL;
+    }
+
+    void *visit(while_statement_c *symbol) {
+      std::string cond_label = new_label(), body_label = new_label(), exit_label = new_label();
+      emit("br label %" + cond_label);
+      start_block(cond_label);
+      emit("br i1 " + condition(symbol->expression) + ", label %" + body_label + ", label %" + exit_label);
+      start_block(body_label);
+      exit_labels.push_back(exit_label);
+      if (NULL != symbol->statement_list) symbol->statement_list->accept(*this);
+      exit_labels.pop_back();
+      emit("br label %" + cond_label);
+      start_block(exit_label);
+      return NULL;
+    }
+
+    void *visit(repeat_statement_c *symbol) {
+      std::string body_label = new_label(), exit_label = new_label();
+      emit("br label %" + body_label);
+      start_block(body_label);
+      exit_labels.push_back(exit_label);
+      if (NULL != symbol->statement_list) symbol->statement_list->accept(*this);
+      exit_labels.pop_back();
+      emit("br i1 " + condition(symbol->expression) + ", label %" + exit_label + ", label %" + body_label);
+      start_block(exit_label);
+      return NULL;
+    }
+
+    void *visit(exit_statement_c *symbol) {
+      if (exit_labels.empty()) STAGE4_ERROR(symbol, symbol, "EXIT outside of a loop.");
+      jump(exit_labels.back());
+      return NULL;
+    }
+}; /* class generate_llvm_c */
+
+
+
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+
+
+
+
+visitor_c *new_code_generator(stage4out_c *s4o, const char *builddir)  {return new generate_llvm_c(s4o, builddir);}
+void delete_code_generator(visitor_c *code_generator) {delete code_generator;}
+
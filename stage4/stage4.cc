@@ -42,8 +42,12 @@
 // #include <stdio.h>  /* required for NULL */
 #include <string>
 #include <iostream>
-#include <fstream>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <map>
 
 #include "stage4.hh"
 #include "../main.hh" // required for ERROR() and ERROR_MSG() macros.
@@ -61,7 +65,7 @@ void stage4err(const char *stage4_generator_id, symbol_c *symbol1, symbol_c *sym
 
     if ((symbol1 != NULL) && (symbol2 != NULL))
       fprintf(stderr, "%s:%d-%d..%d-%d: ",
-              FIRST_(symbol1,symbol2)->first_file, FIRST_(symbol1,symbol2)->first_line, FIRST_(symbol1,symbol2)->first_column,
+              FIRST_(symbol1,symbol2)->first_file.c_str(), FIRST_(symbol1,symbol2)->first_line, FIRST_(symbol1,symbol2)->first_column,
                                                    LAST_(symbol1,symbol2) ->last_line,  LAST_(symbol1,symbol2) ->last_column);
 
     fprintf(stderr, "error %s: ", stage4_generator_id);
@@ -73,12 +77,80 @@ void stage4err(const char *stage4_generator_id, symbol_c *symbol1, symbol_c *sym
 
 
 
-stage4out_c::stage4out_c(std::string indent_level):
-	m_file(NULL) {
-  out = &std::cout;
+/* Size of the buffer to which all the generated code is printed, before being written to the file. */
+#define STAGE4OUT_BUFFER_SIZE (1024*1024)
+
+
+stage4out_c::stage4out_c(std::string indent_level) {
+  file = NULL;
+  /* Do not keep anything in the buffer, so what we print to stdout is not reordered
+   * in relation to anything else printed to std::cout (e.g. the names of the generated files).
+   */
+  buffer_limit = 0;
+  archived = false;
   this->indent_level = indent_level;
   this->indent_spaces = "";
   allow_output = true;
+  capture_start = std::string::npos;
+}
+
+static std::vector<std::string> opened_files__;
+
+const std::vector<std::string> &stage4out_c::opened_files(void) {return opened_files__;}
+
+
+/* With iec2c -A <fd>, the generated files are not written into their directory, but streamed to the
+ * file descriptor fd (e.g. a pipe to the next step of a build pipeline), one after the other, each in
+ * a frame made of a header line with the length (in bytes) and the path of the file, followed by its
+ * contents:
+ *   <length> <path>\n<contents>
+ * The path is the one the file would otherwise have been written to (i.e. including the build directory).
+ * A copy of the files is kept, for the code generators that read back the files they generated
+ * (see read_file()).
+ */
+static std::map<std::string, std::string> archived_files__;
+
+bool stage4out_c::archiving(void) {return runtime_options.archive_fd >= 0;}
+
+static void write_archive(const char *data, size_t len) {
+  while (len > 0) {
+    ssize_t written = write(runtime_options.archive_fd, data, len);
+    if ((written < 0) && (EINTR == errno)) continue;
+    if (written <= 0) {
+      std::cerr << "Error writing the generated files to file descriptor " << runtime_options.archive_fd << "\n";
+      exit(EXIT_FAILURE);
+    }
+    data += written;
+    len  -= written;
+  }
+}
+
+void stage4out_c::write_frame(void) {
+  char header[64];
+  int len = snprintf(header, sizeof(header), "%lu ", (unsigned long)buffer.size());
+  write_archive(header, len);
+  write_archive(filepath.data(), filepath.size());
+  write_archive("\n", 1);
+  write_archive(buffer.data(), buffer.size());
+  archived_files__[filepath].swap(buffer);
+}
+
+bool stage4out_c::read_file(const char *dir, const std::string &filename, std::string &contents) {
+  std::string filepath = (NULL == dir)? filename : std::string(dir) + "/" + filename;
+  contents.clear();
+  if (archiving()) {
+    std::map<std::string, std::string>::iterator archived = archived_files__.find(filepath);
+    if (archived == archived_files__.end()) return false;
+    contents = archived->second;
+    return true;
+  }
+  FILE *file = fopen(filepath.c_str(), "r");
+  if (NULL == file) return false;
+  char buf[64*1024];
+  size_t len;
+  while ((len = fread(buf, 1, sizeof(buf), file)) > 0) contents.append(buf, len);
+  fclose(file);
+  return true;
 }
 
 stage4out_c::stage4out_c(const char *dir, const char *radix, const char *extension, std::string indent_level) {	
@@ -91,30 +163,114 @@ stage4out_c::stage4out_c(const char *dir, const char *radix, const char *extensi
     filepath += "/";
   }
   filepath += filename;
-  std::fstream *file = new std::fstream(filepath.c_str(), std::fstream::out);
-  if(file->fail()){
+  this->filepath = filepath;
+  this->tmp_filepath = filepath + ".tmp";
+  this->filename = filename;
+  opened_files__.push_back(filename);
+  this->indent_level = indent_level;
+  this->indent_spaces = "";
+  allow_output = true;
+  capture_start = std::string::npos;
+  archived = archiving();
+  if (archived) {
+    /* the whole file is kept in the buffer, and only written out (in a single frame) once complete */
+    file = NULL;
+    buffer_limit = (size_t)-1;
+    return;
+  }
+  file = fopen(tmp_filepath.c_str(), "w+");
+  if(NULL == file){
     std::cerr << "Cannot open " << filename << " for write access \n";
     exit(EXIT_FAILURE);
   }else{
     std::cout << filename << "\n";
   }
-  out = file;
-  m_file = file;
-  this->indent_level = indent_level;
-  this->indent_spaces = "";
-  allow_output = true;
+  buffer.reserve(STAGE4OUT_BUFFER_SIZE);
+  buffer_limit = STAGE4OUT_BUFFER_SIZE;
 }
 
 stage4out_c::~stage4out_c(void) {
-  if(m_file)
-  {
-    m_file->close();
-    delete m_file;
+  if (archived) {write_frame(); return;}
+  write_buffer();
+  if(file) close_file();
+}
+
+
+/* Returns true if both files have exactly the same contents */
+static bool same_contents(FILE *f1, FILE *f2) {
+  char buf1[64*1024], buf2[sizeof(buf1)];
+  rewind(f1); rewind(f2);
+  while (true) {
+    size_t len1 = fread(buf1, 1, sizeof(buf1), f1);
+    size_t len2 = fread(buf2, 1, sizeof(buf2), f2);
+    if ((len1 != len2) || (memcmp(buf1, buf2, len1) != 0)) return false;
+    if (len1 < sizeof(buf1)) return (feof(f1) && feof(f2) && !ferror(f1) && !ferror(f2));
   }
 }
 
+void stage4out_c::close_file(void) {
+  bool failed = (fflush(file) != 0);
+  bool unchanged = false;
+  if (!failed) {
+    FILE *old_file = fopen(filepath.c_str(), "r");
+    if (NULL != old_file) {
+      unchanged = same_contents(file, old_file);
+      fclose(old_file);
+    }
+  }
+  if (fclose(file) != 0) failed = true;
+  file = NULL;
+  
+  if (!failed) {
+    if (unchanged) {remove(tmp_filepath.c_str()); return;}
+    if (rename(tmp_filepath.c_str(), filepath.c_str()) == 0) return;
+  }
+  remove(tmp_filepath.c_str());
+  std::cerr << "Error writing to " << filename << "\n";
+  exit(EXIT_FAILURE);
+}
+
+void stage4out_c::write_buffer(void) {
+  if (buffer.empty()) return;
+  if (NULL == file) 
+    std::cout.write(buffer.data(), buffer.size());
+  else if (fwrite(buffer.data(), 1, buffer.size(), file) != buffer.size()) {
+    std::cerr << "Error writing to " << filename << "\n";
+    exit(EXIT_FAILURE);
+  }
+  buffer.clear();  /* keeps the allocated memory */
+}
+
+void stage4out_c::append(const char *str, size_t len) {
+  buffer.append(str, len);
+  if ((buffer.size() >= buffer_limit) && (std::string::npos == capture_start)) write_buffer();
+}
+
+void stage4out_c::append(char c) {
+  buffer.push_back(c);
+  if ((buffer.size() >= buffer_limit) && (std::string::npos == capture_start)) write_buffer();
+}
+
+/* The captured code is simply kept at the end of the buffer, and removed from it by end_capture() */
+void stage4out_c::begin_capture(void) {
+  if (std::string::npos != capture_start) ERROR;  /* captures may not be nested */
+  capture_start = buffer.size();
+}
+
+std::string stage4out_c::end_capture(void) {
+  if (std::string::npos == capture_start) ERROR;
+  std::string captured = buffer.substr(capture_start);
+  buffer.erase(capture_start);
+  capture_start = std::string::npos;
+  if (buffer.size() >= buffer_limit) write_buffer();
+  return captured;
+}
+
 void stage4out_c::flush(void) {
-  out->flush();
+  if (archived) return;  /* the frame is only written once the file is complete */
+  write_buffer();
+  if (NULL == file) std::cout.flush();
+  else              fflush(file);
 }
 
 void stage4out_c::enable_output(void) {
@@ -125,6 +281,10 @@ void stage4out_c::disable_output(void) {
   allow_output = false;
 }
 
+bool stage4out_c::is_output_enabled(void) {
+  return allow_output;
+}
+
 void stage4out_c::indent_right(void) {
   indent_spaces+=indent_level;
 }
@@ -136,30 +296,41 @@ void stage4out_c::indent_left(void) {
     indent_spaces.erase();
 }
 
-void *stage4out_c::print(           std::string value) {if (!allow_output) return NULL; *out << value; return NULL;}
-void *stage4out_c::print(           const char *value) {if (!allow_output) return NULL; *out << value; return NULL;}
+
+/* NOTE: the formats are the ones std::ostream uses by default, which is what we used to print with. */
+#define PRINT_NUMBER(format, value) {	\
+  if (!allow_output) return NULL;	\
+  char str[64];				\
+  int len = snprintf(str, sizeof(str), format, value);	\
+  if ((len < 0) || (len >= (int)sizeof(str))) ERROR;	\
+  append(str, len);			\
+  return NULL;				\
+}
+
+void *stage4out_c::print(           std::string value) {if (!allow_output) return NULL; append(value.data(), value.size()); return NULL;}
+void *stage4out_c::print(           const char *value) {if (!allow_output) return NULL; append(value, strlen(value));        return NULL;}
 //void *stage4out_c::print(               int64_t value) {if (!allow_output) return NULL; *out << value; return NULL;}
 //void *stage4out_c::print(              uint64_t value) {if (!allow_output) return NULL; *out << value; return NULL;}
-void *stage4out_c::print(              real64_t value) {if (!allow_output) return NULL; *out << value; return NULL;}
-void *stage4out_c::print(                   int value) {if (!allow_output) return NULL; *out << value; return NULL;}
-void *stage4out_c::print(              long int value) {if (!allow_output) return NULL; *out << value; return NULL;}
-void *stage4out_c::print(         long long int value) {if (!allow_output) return NULL; *out << value; return NULL;}
-void *stage4out_c::print(unsigned           int value) {if (!allow_output) return NULL; *out << value; return NULL;}
-void *stage4out_c::print(unsigned      long int value) {if (!allow_output) return NULL; *out << value; return NULL;}
-void *stage4out_c::print(unsigned long long int value) {if (!allow_output) return NULL; *out << value; return NULL;}
+void *stage4out_c::print(              real64_t value) PRINT_NUMBER("%g",   (double)value)
+void *stage4out_c::print(                   int value) PRINT_NUMBER("%d",   value)
+void *stage4out_c::print(              long int value) PRINT_NUMBER("%ld",  value)
+void *stage4out_c::print(         long long int value) PRINT_NUMBER("%lld", value)
+void *stage4out_c::print(unsigned           int value) PRINT_NUMBER("%u",   value)
+void *stage4out_c::print(unsigned      long int value) PRINT_NUMBER("%lu",  value)
+void *stage4out_c::print(unsigned long long int value) PRINT_NUMBER("%llu", value)
 
 
 void *stage4out_c::print_long_integer(unsigned long l_integer, bool suffix) {
   if (!allow_output) return NULL;
-  *out << l_integer;
-  if (suffix) *out << "UL";
+  print(l_integer);
+  if (suffix) append("UL", 2);
   return NULL;
 }
 
 void *stage4out_c::print_long_long_integer(unsigned long long ll_integer, bool suffix) {
   if (!allow_output) return NULL;
-  *out << ll_integer;
-  if (suffix) *out << "ULL";
+  print(ll_integer);
+  if (suffix) append("ULL", 3);
   return NULL;
 }
 
@@ -167,32 +338,32 @@ void *stage4out_c::print_long_long_integer(unsigned long long ll_integer, bool s
 void *stage4out_c::printupper(const char *str) {
   if (!allow_output) return NULL;
   for (int i = 0; str[i] != '\0'; i++)
-    *out << (unsigned char)toupper(str[i]);
+    append((char)toupper((unsigned char)str[i]));
   return NULL;
 }
 
 void *stage4out_c::printlocation(const char *str) {
   if (!allow_output) return NULL;
-  *out << "__";
+  append("__", 2);
   for (int i = 0; str[i] != '\0'; i++)
     if(str[i] == '.')
-      *out << '_';
+      append('_');
     else
-      *out << (unsigned char)toupper(str[i]);
+      append((char)toupper((unsigned char)str[i]));
   return NULL;
 }
 
 void *stage4out_c::printlocation_comasep(const char *str) {
   if (!allow_output) return NULL;
-  *out << (unsigned char)toupper(str[0]);
-  *out << ',';
-  *out << (unsigned char)toupper(str[1]);
-  *out << ',';
+  append((char)toupper((unsigned char)str[0]));
+  append(',');
+  append((char)toupper((unsigned char)str[1]));
+  append(',');
   for (int i = 2; str[i] != '\0'; i++)
     if(str[i] == '.')
-      *out << ',';
+      append(',');
     else
-      *out << (unsigned char)toupper(str[i]);
+      append((char)toupper((unsigned char)str[i]));
   return NULL;
 }
 
@@ -200,17 +371,7 @@ void *stage4out_c::printlocation_comasep(const char *str) {
 
 void *stage4out_c::printupper(std::string str) {
   if (!allow_output) return NULL;
-  /* The string standard class does not have a converter member function to upper case.
-   * We have to do it ourselves, a character at a time...
-   */
-#if 0
-  /* The C++ way of doint things... */
-  for (string::const_iterator p = str.begin(); p != str.end(); ++p)
-    *out << (unsigned char)toupper(*p);
-#else
-  /* Or more simply... */
-    printupper(str.c_str());
-#endif
+  printupper(str.c_str());
   return NULL;
 }
 
@@ -253,3 +414,17 @@ int stage4(symbol_c *tree_root, const char *builddir) {
   return 0;
 }
 
+
+int stage4(symbol_c *tree_root, const char *builddir, const char *radix, const char *extension) {
+  stage4out_c s4o(builddir, radix, extension);
+  visitor_c *generate_code = new_code_generator(&s4o, builddir);
+
+  if (NULL == generate_code) ERROR;
+
+  tree_root->accept(*generate_code);
+
+  delete_code_generator(generate_code);
+
+  return 0;
+}
+
@@ -39,6 +39,8 @@
 #ifndef _STAGE4_HH
 #define _STAGE4_HH
 
+#include <string>
+#include <vector>
 #include "../absyntax/absyntax.hh"
 
 
@@ -54,11 +56,15 @@ class stage4out_c {
     stage4out_c(std::string indent_level = "  ");
     stage4out_c(const char *dir, const char *radix, const char *extension, std::string indent_level = "  ");
     ~stage4out_c(void);
+
+    /* The names of all the files opened so far (relative to their directory), in the order in which they were opened */
+    static const std::vector<std::string> &opened_files(void);
     
     void flush(void);
     
     void enable_output(void);
     void disable_output(void);
+    bool is_output_enabled(void);
 
     void indent_right(void);
     void indent_left(void);
@@ -87,9 +93,42 @@ class stage4out_c {
 
     void *printlocation_comasep(const char *str);
 
+    /* Keep the code printed from now on, instead of writing it out, until end_capture() removes it
+     * from the output and returns it (e.g. to compare it with some code generated before).
+     */
+    void begin_capture(void);
+    std::string end_capture(void);
+
+    /* Whether the generated files are streamed as an archive to a file descriptor (iec2c -A), instead
+     * of being written into their directory. See stage4.cc for the format of the archive.
+     */
+    static bool archiving(void);
+    /* Get the contents of a file generated before, from the archive when archiving(), or else from its
+     * directory (dir may be NULL). Returns false if there is no such file.
+     */
+    static bool read_file(const char *dir, const std::string &filename, std::string &contents);
+
   protected:
-    std::ostream *out;
-    std::fstream *m_file;
+    /* The generated code is appended to a large buffer, which is only written out to the file once it is full
+     * (or when flush() is called), instead of going through an iostream for each of the (millions of) small
+     * strings and numbers that are printed.
+     */
+    FILE        *file;         /* NULL when printing to stdout */
+    std::string  filename;
+    /* The code is first written to a temporary file, which only replaces the file at filepath if the contents
+     * differ. Files whose contents do not change keep their timestamp, so 'make' will not rebuild them.
+     */
+    std::string  filepath, tmp_filepath;
+    std::string  buffer;
+    size_t       buffer_limit; /* size at which the buffer gets written out */
+    bool         archived;     /* the file goes to the archive (see archiving()) */
+    size_t       capture_start; /* where the captured code starts in the buffer, npos when not capturing */
+    
+    void append(const char *str, size_t len);
+    void append(char c);
+    void write_buffer(void);
+    void close_file(void);
+    void write_frame(void);
     
     /* A flag to tell whether to really print to the file, or to ignore any request to print to the file */
     /* This is used to implement the no_code_generation pragmas, that lets the user tell the compiler
@@ -103,9 +142,15 @@ class stage4out_c {
 
 
 int stage4(symbol_c *tree_root, const char *builddir);
+/* Generate the code into the file <builddir>/<radix>.<extension>, for the code generators that otherwise print it to stdout */
+int stage4(symbol_c *tree_root, const char *builddir, const char *radix, const char *extension);
 
 /* Functions to be implemented by each generate_XX version of stage 4 */
 int  stage4_parse_options(char *options);
 void stage4_print_options(void);
+/* Restore the default options (as before any call to stage4_parse_options()) */
+void stage4_reset_options(void);
+/* Whether the code generator needs the annotations left in the AST by stage 3 (only iec2iec -N works without them) */
+bool stage4_requires_stage3(void);
 
 #endif /* _STAGE4_HH */
@@ -0,0 +1,46 @@
+#!/bin/bash
+# matiec - a compiler for the programming languages defined in IEC 61131-3
+#
+# Copyright (C) 2003-2011  Mario de Sousa (msousa@fe.up.pt)
+# Copyright (C) 2007-2011  Laurent Bessard and Edouard Tisserant
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Shell script to build and run the scan cycle benchmark (see bench_main.c) for unix likes
+#
+# usage: ./bench.sh <file.st> [<bench args>]
+#   The IEC 61131-3 file must declare a CONFIGURATION. The iec2c options (IEC2C_FLAGS, e.g. "-O l")
+#   and the C compiler flags (CFLAGS, default -O2) are taken from the environment, so the same
+#   program may be compared across code generator options, e.g.:
+#     IEC2C_FLAGS="-O l" ./bench.sh prog.st -n 100000 > with_l.csv
+
+STFILE=$1
+
+shift
+
+CC=${CC:-gcc}
+CFLAGS=${CFLAGS:--O2}
+IEC2C=${IEC2C:-../iec2c}
+OUT=bench.out
+
+rm -rf $OUT; mkdir -p $OUT
+
+# -O T for the per task times, -O D for the list of the C files to compile
+$IEC2C -O T -O D $IEC2C_FLAGS -I ../lib -T $OUT $STFILE || exit 1
+
+SRCS=`sed -n '/^IEC2C_C_SRCS/,/^$/p' $OUT/DEPENDS.mk | sed '1d;s/\\\\//'`
+
+$CC -I ../lib/C -I $OUT -DUSE_TASK_STATS $CFLAGS bench_main.c $SRCS -l rt -lm -o $OUT/bench || exit 1
+
+$OUT/bench "$@"
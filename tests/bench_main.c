@@ -0,0 +1,247 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2003-2011  Mario de Sousa (msousa@fe.up.pt)
+ *  Copyright (C) 2007-2011  Laurent Bessard and Edouard Tisserant
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ *
+ *
+ * Scan cycle benchmark runtime (see bench.sh), replacing main.c and plc.c.
+ *
+ * Runs N cycles of the generated configuration, with pseudo random values in the %I located
+ * variables before each cycle, and prints the distribution of the execution times, in ns:
+ *   name,samples,min,p50,p99,max,mean
+ * one line for the whole cycles (config_run__()), and, when the code was generated with
+ * iec2c -O T, one line for each task (<resource number>/<task name>, from config_task_stats__[]).
+ *
+ * The cycles run back to back by default, with __CURRENT_TIME advancing by common_ticktime__
+ * on every cycle (so the timers behave as at the real rate), or else every period ns (-p), on
+ * the real clock.
+ *
+ * Usage: bench [-n cycles] [-p period_ns] [-s seed]
+ */
+
+#include "iec_std_lib.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/*
+ * Functions and variables provided by generated C softPLC
+ **/
+extern unsigned long long common_ticktime__;
+void config_run__(unsigned long tick);
+void config_init__(void);
+#ifdef USE_TASK_STATS
+extern __task_stats_t *config_task_stats__[];
+#endif
+#ifdef USE_RESOURCE_CONTEXT
+extern __resource_context_t *config_resource_context__[];
+extern __resource_context_t config_context__;
+#endif
+
+/*
+ *  Functions and variables to export to generated C softPLC
+ **/
+#ifndef USE_RESOURCE_CONTEXT
+TIME __CURRENT_TIME;
+BOOL __DEBUG;
+#endif
+
+#define __LOCATED_VAR(type, name, ...) type __##name;
+#include "LOCATED_VARIABLES.h"
+#undef __LOCATED_VAR
+#define __LOCATED_VAR(type, name, ...) type* name = &__##name;
+#include "LOCATED_VARIABLES.h"
+#undef __LOCATED_VAR
+
+static unsigned long long now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+#ifdef USE_TASK_STATS
+unsigned long long __task_stats_now(void) {return now_ns();}
+#endif
+
+/* The synthetic inputs (xorshift64) */
+static unsigned long long seed = 88172645463325252ULL;
+
+static unsigned long long random_value(void) {
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+    return seed;
+}
+
+#define __input_BOOL(name)  *name = random_value() & 1;
+#define __input_SINT(name)  *name = (SINT)random_value();
+#define __input_INT(name)   *name = (INT)random_value();
+#define __input_DINT(name)  *name = (DINT)random_value();
+#define __input_LINT(name)  *name = (LINT)random_value();
+#define __input_USINT(name) *name = (USINT)random_value();
+#define __input_UINT(name)  *name = (UINT)random_value();
+#define __input_UDINT(name) *name = (UDINT)random_value();
+#define __input_ULINT(name) *name = (ULINT)random_value();
+#define __input_BYTE(name)  *name = (BYTE)random_value();
+#define __input_WORD(name)  *name = (WORD)random_value();
+#define __input_DWORD(name) *name = (DWORD)random_value();
+#define __input_LWORD(name) *name = (LWORD)random_value();
+#define __input_REAL(name)  *name = (REAL)(random_value() % 200001) / 100 - 1000;
+#define __input_LREAL(name) *name = (LREAL)(random_value() % 200001) / 100 - 1000;
+/* the other types keep their initial value */
+#define __input_TIME(name)
+#define __input_DATE(name)
+#define __input_TOD(name)
+#define __input_DT(name)
+#define __input_STRING(name)
+
+static void set_inputs(void) {
+#define __LOCATED_VAR(type, name, area, ...) if (#area[0] == 'I') {__input_##type(name)}
+#include "LOCATED_VARIABLES.h"
+#undef __LOCATED_VAR
+}
+
+static void set_current_time(TIME now) {
+#ifdef USE_RESOURCE_CONTEXT
+    int i;
+    config_context__.current_time = now;
+    for (i = 0; NULL != config_resource_context__[i]; i++)
+        config_resource_context__[i]->current_time = now;
+#else
+    __CURRENT_TIME = now;
+#endif
+}
+
+/* The execution times of the cycles, or of the runs of a task */
+typedef struct {
+    const char *name;
+    unsigned long long *times;
+    unsigned long count;
+} samples_t;
+
+static int compare_times(const void *a, const void *b) {
+    unsigned long long x = *(const unsigned long long *)a, y = *(const unsigned long long *)b;
+    return (x > y) - (x < y);
+}
+
+static void report(samples_t *samples) {
+    unsigned long i;
+    unsigned long long total = 0;
+    unsigned long long *t = samples->times;
+    unsigned long n = samples->count;
+
+    if (0 == n) {printf("%s,0,,,,,\n", samples->name); return;}
+    qsort(t, n, sizeof(t[0]), compare_times);
+    for (i = 0; i < n; i++) total += t[i];
+    printf("%s,%lu,%llu,%llu,%llu,%llu,%llu\n", samples->name, n,
+           t[0], t[(n - 1) / 2], t[(n * 99 + 99) / 100 - 1], t[n - 1], total / n);
+}
+
+static unsigned long long *new_times(unsigned long count) {
+    unsigned long long *times = malloc(count * sizeof(times[0]));
+    if (NULL == times) {fprintf(stderr, "out of memory\n"); exit(1);}
+    return times;
+}
+
+int main(int argc,char **argv)
+{
+    int opt;
+    unsigned long cycles = 10000, tick;
+    unsigned long long period = 0, start, next, sim_time = 0;
+    samples_t cycle_samples = {"cycle"};
+#ifdef USE_TASK_STATS
+    int r, task, tasks = 0;
+    samples_t *task_samples;
+    unsigned long long *task_runs;
+#endif
+
+    while ((opt = getopt(argc, argv, "n:p:s:")) != -1) {
+        switch (opt) {
+            case 'n': cycles = strtoul(optarg, NULL, 10); break;
+            case 'p': period = strtoull(optarg, NULL, 10); break;
+            case 's': seed   = strtoull(optarg, NULL, 10) | 1; break;
+            default:
+                fprintf(stderr, "usage: %s [-n cycles] [-p period_ns] [-s seed]\n", argv[0]);
+                return 1;
+        }
+    }
+    if (0 == cycles) return 0;
+
+    cycle_samples.times = new_times(cycles);
+#ifdef USE_TASK_STATS
+    for (r = 0; NULL != config_task_stats__[r]; r++)
+        for (task = 0; NULL != config_task_stats__[r][task].name; task++) tasks++;
+    task_samples = calloc(tasks + 1, sizeof(task_samples[0]));
+    task_runs    = calloc(tasks + 1, sizeof(task_runs[0]));
+    tasks = 0;
+    for (r = 0; NULL != config_task_stats__[r]; r++)
+        for (task = 0; NULL != config_task_stats__[r][task].name; task++, tasks++) {
+            char *name = malloc(strlen(config_task_stats__[r][task].name) + 16);
+            sprintf(name, "%d/%s", r, config_task_stats__[r][task].name);
+            task_samples[tasks].name  = name;
+            task_samples[tasks].times = new_times(cycles);
+        }
+#endif
+
+    set_current_time(__timespec(0, 0));
+    config_init__();
+
+    next = now_ns();
+    for (tick = 0; tick < cycles; tick++) {
+        if (0 != period) {
+            struct timespec ts;
+            next += period;
+            while ((start = now_ns()) < next) {
+                unsigned long long wait = next - start;
+                ts.tv_sec = wait / 1000000000ULL; ts.tv_nsec = wait % 1000000000ULL;
+                nanosleep(&ts, NULL);
+            }
+            set_current_time(__timespec(start / 1000000000ULL, start % 1000000000ULL));
+        } else {
+            sim_time += common_ticktime__;
+            set_current_time(__timespec(sim_time / 1000000000ULL, sim_time % 1000000000ULL));
+        }
+        set_inputs();
+        start = now_ns();
+        config_run__(tick);
+        cycle_samples.times[cycle_samples.count++] = now_ns() - start;
+#ifdef USE_TASK_STATS
+        tasks = 0;
+        for (r = 0; NULL != config_task_stats__[r]; r++)
+            for (task = 0; NULL != config_task_stats__[r][task].name; task++, tasks++) {
+                __task_stats_t *stats = &config_task_stats__[r][task];
+                if (stats->runs == task_runs[tasks]) continue;  /* the task did not run on this tick */
+                task_runs[tasks] = stats->runs;
+                task_samples[tasks].times[task_samples[tasks].count++] = stats->last;
+            }
+#endif
+    }
+
+    printf("name,samples,min,p50,p99,max,mean\n");
+    report(&cycle_samples);
+#ifdef USE_TASK_STATS
+    for (task = 0; task < tasks; task++) report(&task_samples[task]);
+#endif
+    return 0;
+}
@@ -0,0 +1,108 @@
+# matiec - a compiler for the programming languages defined in IEC 61131-3
+#
+# Copyright (C) 2014  Mario de Sousa (msousa@fe.up.pt)
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+#
+# Generator of synthetic IEC 61131-3 programs, used to benchmark the compiler.
+#
+# usage: awk -v pous=<n> -v vars=<n> -v depth=<n> -v cases=<n> -v steps=<n> -f genprogram.awk
+#
+#   pous  : number of function blocks
+#   vars  : number of local variables (and assignment statements) in each function block
+#   depth : FB nesting depth - each FB contains an instance of the previous FB, in chains of 'depth' FBs
+#   cases : number of elements in the CASE statement of each function block
+#   steps : number of steps in the SFC of the program (0 for a program written in ST)
+#
+# The program is written to stdout.
+
+
+function gen_fb(i,    j, k) {
+  printf "FUNCTION_BLOCK FB_%d\n", i
+  printf "  VAR_INPUT  IN1  : INT; END_VAR\n"
+  printf "  VAR_OUTPUT OUT1 : INT; END_VAR\n"
+  printf "  VAR\n"
+  for (j = 0; j < vars; j++)
+    printf "    v%d : INT;\n", j
+  if (i % depth != 0)
+    printf "    sub : FB_%d;\n", i - 1
+  printf "  END_VAR\n"
+
+  printf "  v0 := IN1 + %d;\n", i
+  for (j = 1; j < vars; j++)
+    printf "  v%d := v%d * 2 + %d;\n", j, j - 1, j % 7
+  if (cases > 0) {
+    printf "  CASE IN1 OF\n"
+    for (k = 0; k < cases; k++)
+      printf "    %d: OUT1 := v%d + %d;\n", k, k % vars, k
+    printf "  ELSE\n    OUT1 := 0;\n  END_CASE;\n"
+  } else
+    printf "  OUT1 := v%d;\n", vars - 1
+  if (i % depth != 0)
+    printf "  sub(IN1 := OUT1);\n  OUT1 := sub.OUT1;\n"
+  printf "END_FUNCTION_BLOCK\n\n"
+}
+
+
+BEGIN {
+  if (pous  < 1) pous  = 1
+  if (vars  < 1) vars  = 1
+  if (depth < 1) depth = 1
+  if (cases < 0) cases = 0
+  if (steps < 0) steps = 0
+
+  printf "(* Synthetic benchmark program: pous=%d vars=%d depth=%d cases=%d steps=%d *)\n\n", pous, vars, depth, cases, steps
+
+  for (i = 0; i < pous; i++)
+    gen_fb(i)
+
+  # the program instantiates the last FB of each chain of nested FBs
+  ninst = 0
+  for (i = 0; i < pous; i++)
+    if ((i % depth == depth - 1) || (i == pous - 1))
+      inst[ninst++] = i
+
+  printf "PROGRAM main_prg\n"
+  printf "  VAR\n    x : INT;\n"
+  for (n = 0; n < ninst; n++)
+    printf "    fb%d : FB_%d;\n", n, inst[n]
+  printf "  END_VAR\n"
+
+  if (steps == 0) {
+    for (n = 0; n < ninst; n++)
+      printf "  fb%d(IN1 := x);\n  x := fb%d.OUT1;\n", n, n
+  } else {
+    printf "  INITIAL_STEP s0: END_STEP\n"
+    for (s = 1; s <= steps; s++) {
+      printf "  TRANSITION FROM s%d TO s%d := x >= %d; END_TRANSITION\n", s - 1, s, -s
+      printf "  STEP s%d: a%d(N); END_STEP\n", s, s
+      printf "  ACTION a%d:\n", s
+      if (ninst > 0)
+        printf "    fb%d(IN1 := x);\n    x := fb%d.OUT1;\n", s % ninst, s % ninst
+      else
+        printf "    x := x + 1;\n"
+      printf "  END_ACTION\n"
+    }
+    printf "  TRANSITION FROM s%d TO s0 := TRUE; END_TRANSITION\n", steps
+  }
+  printf "END_PROGRAM\n\n"
+
+  printf "CONFIGURATION config\n"
+  printf "  RESOURCE res ON PLC\n"
+  printf "    TASK tsk(INTERVAL := T#10ms, PRIORITY := 0);\n"
+  printf "    PROGRAM inst WITH tsk : main_prg;\n"
+  printf "  END_RESOURCE\n"
+  printf "END_CONFIGURATION\n"
+}
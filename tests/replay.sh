@@ -0,0 +1,47 @@
+#!/bin/bash
+# matiec - a compiler for the programming languages defined in IEC 61131-3
+#
+# Copyright (C) 2003-2011  Mario de Sousa (msousa@fe.up.pt)
+# Copyright (C) 2007-2011  Laurent Bessard and Edouard Tisserant
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Shell script to build and run the replay of a log of the inputs (see replay_main.c) for unix likes
+#
+# usage: ./replay.sh <file.st> <log file> [<replay args>]
+#   The IEC 61131-3 file must be the one of the program that recorded the log (iec2c -O B, see
+#   iec_input_recorder.h). As with bench.sh, the iec2c options (IEC2C_FLAGS) and the C compiler
+#   flags (CFLAGS, default -O2) are taken from the environment, so the code generator options may
+#   be compared on the inputs recorded on site, e.g.:
+#     IEC2C_FLAGS="-O l" ./replay.sh prog.st site.log -r 10 > with_l.csv
+
+STFILE=$1
+
+shift
+
+CC=${CC:-gcc}
+CFLAGS=${CFLAGS:--O2}
+IEC2C=${IEC2C:-../iec2c}
+OUT=replay.out
+
+rm -rf $OUT; mkdir -p $OUT
+
+# -O B for the table of the inputs, -O T for the per task times, -O D for the list of the C files to compile
+$IEC2C -O B -O T -O D $IEC2C_FLAGS -I ../lib -T $OUT $STFILE || exit 1
+
+SRCS=`sed -n '/^IEC2C_C_SRCS/,/^$/p' $OUT/DEPENDS.mk | sed '1d;s/\\\\//'`
+
+$CC -I ../lib/C -I $OUT -DUSE_TASK_STATS $CFLAGS replay_main.c $SRCS -l rt -lm -o $OUT/replay || exit 1
+
+$OUT/replay "$@"
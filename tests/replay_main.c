@@ -0,0 +1,256 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2003-2011  Mario de Sousa (msousa@fe.up.pt)
+ *  Copyright (C) 2007-2011  Laurent Bessard and Edouard Tisserant
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ *
+ *
+ * Replay runtime (see replay.sh), replacing main.c and plc.c.
+ *
+ * Runs the generated configuration (compiled with iec2c -O B) once for each record of a log of
+ * its inputs, written on site from the ring buffer of iec_input_recorder.h: before each cycle,
+ * the %I located variables and __CURRENT_TIME get their recorded values, and config_run__() is
+ * given the recorded tick. The cycles run back to back, and the distribution of their execution
+ * times is printed as by bench_main.c, in ns:
+ *   name,samples,min,p50,p99,max,mean
+ * one line for the whole cycles (config_run__()), and, when the code was generated with
+ * iec2c -O T, one line for each task (<resource number>/<task name>, from config_task_stats__[]).
+ *
+ * The log may be replayed several times (-r), each time from the initial state of config_init__().
+ *
+ * Usage: replay [-r repeat] <log file>
+ */
+
+#include "iec_std_lib.h"
+#include "iec_input_recorder.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/*
+ * Functions and variables provided by generated C softPLC
+ **/
+void config_run__(unsigned long tick);
+void config_init__(void);
+#ifdef USE_TASK_STATS
+extern __task_stats_t *config_task_stats__[];
+#endif
+
+/*
+ *  Functions and variables to export to generated C softPLC
+ **/
+TIME __CURRENT_TIME;
+BOOL __DEBUG;
+
+#define __LOCATED_VAR(type, name, ...) type __##name;
+#include "LOCATED_VARIABLES.h"
+#undef __LOCATED_VAR
+#define __LOCATED_VAR(type, name, ...) type* name = &__##name;
+#include "LOCATED_VARIABLES.h"
+#undef __LOCATED_VAR
+
+static unsigned long long now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+#ifdef USE_TASK_STATS
+unsigned long long __task_stats_now(void) {return now_ns();}
+#endif
+
+/* The execution times of the cycles, or of the runs of a task */
+typedef struct {
+    const char *name;
+    unsigned long long *times;
+    unsigned long count;
+} samples_t;
+
+static int compare_times(const void *a, const void *b) {
+    unsigned long long x = *(const unsigned long long *)a, y = *(const unsigned long long *)b;
+    return (x > y) - (x < y);
+}
+
+static void report(samples_t *samples) {
+    unsigned long i;
+    unsigned long long total = 0;
+    unsigned long long *t = samples->times;
+    unsigned long n = samples->count;
+
+    if (0 == n) {printf("%s,0,,,,,\n", samples->name); return;}
+    qsort(t, n, sizeof(t[0]), compare_times);
+    for (i = 0; i < n; i++) total += t[i];
+    printf("%s,%lu,%llu,%llu,%llu,%llu,%llu\n", samples->name, n,
+           t[0], t[(n - 1) / 2], t[(n * 99 + 99) / 100 - 1], t[n - 1], total / n);
+}
+
+static unsigned long long *new_times(unsigned long count) {
+    unsigned long long *times = malloc(count * sizeof(times[0]));
+    if (NULL == times) {fprintf(stderr, "out of memory\n"); exit(1);}
+    return times;
+}
+
+/* Read the whole log into memory */
+static unsigned char *read_log(const char *filename, unsigned long *size) {
+    FILE *file = fopen(filename, "rb");
+    unsigned char *log = NULL;
+    unsigned long allocated = 0, n;
+
+    if (NULL == file) {perror(filename); exit(1);}
+    *size = 0;
+    do {
+        if (*size == allocated) {
+            allocated = (0 == allocated)? 1024 * 1024 : 2 * allocated;
+            log = realloc(log, allocated);
+            if (NULL == log) {fprintf(stderr, "out of memory\n"); exit(1);}
+        }
+        n = fread(log + *size, 1, allocated - *size, file);
+        *size += n;
+    } while (n > 0);
+    fclose(file);
+    return log;
+}
+
+/* The number of records in the log, or -1 if it is not a log of the inputs of this program */
+static long count_records(const unsigned char *log, unsigned long size) {
+    __input_log_header_t header;
+    __input_record_t record;
+    unsigned long pos = sizeof(header);
+    long count = 0;
+
+    if (size < sizeof(header)) return -1;
+    memcpy(&header, log, sizeof(header));
+    if ((__INPUT_LOG_MAGIC != header.magic) || (__INPUT_LOG_VERSION != header.version) ||
+        (__input_layout != header.layout) || (__input_vars_count != header.count))
+        return -1;
+    while (size - pos >= sizeof(record)) {
+        memcpy(&record, log + pos, sizeof(record));
+        if ((record.size < sizeof(record)) || (size - pos < record.size)) break;
+        pos += record.size;
+        count++;
+    }
+    return count;
+}
+
+int main(int argc,char **argv)
+{
+    int opt, result = 0;
+    unsigned long repeat = 1, run, size, tick, lost = 0;
+    unsigned long long start;
+    unsigned char *log;
+    long records;
+    unsigned int flags;
+    TIME time;
+    __input_replay_t replay;
+    samples_t cycle_samples = {"cycle"};
+#ifdef USE_TASK_STATS
+    int r, task, tasks = 0;
+    samples_t *task_samples;
+    unsigned long long *task_runs;
+#endif
+
+    while ((opt = getopt(argc, argv, "r:")) != -1) {
+        switch (opt) {
+            case 'r': repeat = strtoul(optarg, NULL, 10); break;
+            default:
+                fprintf(stderr, "usage: %s [-r repeat] <log file>\n", argv[0]);
+                return 1;
+        }
+    }
+    if (optind != argc - 1) {
+        fprintf(stderr, "usage: %s [-r repeat] <log file>\n", argv[0]);
+        return 1;
+    }
+
+    log = read_log(argv[optind], &size);
+    records = count_records(log, size);
+    if (records < 0) {
+        fprintf(stderr, "%s is not a log of the inputs of this program (see iec_input_recorder.h)\n", argv[optind]);
+        return 1;
+    }
+    if ((0 == records) || (0 == repeat)) return 0;
+
+    cycle_samples.times = new_times(records * repeat);
+#ifdef USE_TASK_STATS
+    for (r = 0; NULL != config_task_stats__[r]; r++)
+        for (task = 0; NULL != config_task_stats__[r][task].name; task++) tasks++;
+    task_samples = calloc(tasks + 1, sizeof(task_samples[0]));
+    task_runs    = calloc(tasks + 1, sizeof(task_runs[0]));
+    tasks = 0;
+    for (r = 0; NULL != config_task_stats__[r]; r++)
+        for (task = 0; NULL != config_task_stats__[r][task].name; task++, tasks++) {
+            char *name = malloc(strlen(config_task_stats__[r][task].name) + 16);
+            sprintf(name, "%d/%s", r, config_task_stats__[r][task].name);
+            task_samples[tasks].name  = name;
+            task_samples[tasks].times = new_times(records * repeat);
+        }
+#endif
+
+    for (run = 0; run < repeat; run++) {
+        unsigned long record = 0;
+        __input_record_t first;
+
+        /* the initial state, at the time of the first record */
+        if (__input_replay_open(&replay, log, size) < 0) return 1;  /* already checked by count_records() */
+        memcpy(&first, log + sizeof(__input_log_header_t), sizeof(first));
+        __CURRENT_TIME = __timespec(first.time / 1000000000LL, first.time % 1000000000LL);
+        config_init__();
+#ifdef USE_TASK_STATS
+        tasks = 0;
+        for (r = 0; NULL != config_task_stats__[r]; r++)
+            for (task = 0; NULL != config_task_stats__[r][task].name; task++, tasks++)
+                task_runs[tasks] = config_task_stats__[r][task].runs;
+#endif
+        while ((result = __input_replay_next(&replay, &tick, &time, &flags)) == 1) {
+            if ((flags & __INPUT_RECORD_LOST) && (0 == run)) lost++;
+            __CURRENT_TIME = time;
+            start = now_ns();
+            config_run__(tick);
+            cycle_samples.times[cycle_samples.count++] = now_ns() - start;
+            record++;
+#ifdef USE_TASK_STATS
+            tasks = 0;
+            for (r = 0; NULL != config_task_stats__[r]; r++)
+                for (task = 0; NULL != config_task_stats__[r][task].name; task++, tasks++) {
+                    __task_stats_t *stats = &config_task_stats__[r][task];
+                    if (stats->runs == task_runs[tasks]) continue;  /* the task did not run on this tick */
+                    task_runs[tasks] = stats->runs;
+                    task_samples[tasks].times[task_samples[tasks].count++] = stats->last;
+                }
+#endif
+        }
+        if (result < 0) {
+            fprintf(stderr, "%s: record %lu is not valid\n", argv[optind], record);
+            return 1;
+        }
+    }
+    if (lost > 0)
+        fprintf(stderr, "Warning: records were lost in %lu places of the log (the ring buffer was full), the replay is not the run on site\n", lost);
+
+    printf("name,samples,min,p50,p99,max,mean\n");
+    report(&cycle_samples);
+#ifdef USE_TASK_STATS
+    for (task = 0; task < tasks; task++) report(&task_samples[task]);
+#endif
+    return 0;
+}
@@ -32,23 +32,78 @@
 
 
 #include <iostream>
-#include "symtable.hh"
+#include <string.h>
+#include <strings.h>
+#include "dsymtable.hh"
 #include "../main.hh" // required for ERROR() and ERROR_MSG() macros.
 
 
 
+template<typename value_type>
+dsymtable_c<value_type>::dsymtable_c(void) {
+  end_element.first  = NULL;
+  end_element.second = value_t();
+}
+
+
  /* clear all entries... */
 template<typename value_type>
 void dsymtable_c<value_type>::reset(void) {
-  _base.clear();
+  keys.clear();
+  slots.clear();
+}
+
+
+template<typename value_type>
+int dsymtable_c<value_type>::find_slot(const char *identifier_str) {
+  const char *folded = interned_folded(identifier_str);
+  uint32_t    hash   = (NULL != folded)? interned_hash(identifier_str) : nocase_hash(identifier_str, strlen(identifier_str));
+  int         mask   = slots.size() - 1;
+  for (int slot = hash & mask; ; slot = (slot + 1) & mask) {
+    int k = slots[slot];
+    if (k < 0) return slot;
+    if (keys[k].hash != hash) continue;
+    /* interned strings are equal if they have the same case folded form */
+    if ((NULL != folded)? (keys[k].folded == folded) : (strcasecmp(keys[k].elements[0].first, identifier_str) == 0))
+      return slot;
+  }
+}
+
+
+template<typename value_type>
+int dsymtable_c<value_type>::find_key(const char *identifier_str) {
+  if (slots.empty()) return -1;
+  return slots[find_slot(identifier_str)];
 }
 
 
 template<typename value_type>
 void dsymtable_c<value_type>::insert(const char *identifier_str, value_t new_value) {
   // std::cout << "store_identifier(" << identifier_str << "): \n";
-  std::pair<const char *, value_t> new_element(identifier_str, new_value);
-  /* iterator res = */ _base.insert(new_element);
+  element_t new_element;
+  new_element.first  = intern_string(identifier_str);
+  new_element.second = new_value;
+
+  int k = find_key(new_element.first);
+  if (k < 0) {
+    /* new identifier. Grow the hash table if more than half full... */
+    if (slots.size() < 2 * (keys.size() + 1)) {
+      unsigned int size = (slots.empty())? 64 : 2 * slots.size();
+      slots.assign(size, -1);
+      for (unsigned int i = 0; i < keys.size(); i++) {
+        int slot;
+        for (slot = keys[i].hash & (size - 1); slots[slot] >= 0; slot = (slot + 1) & (size - 1));
+        slots[slot] = i;
+      }
+    }
+    key_t key;
+    key.folded = interned_folded(new_element.first);
+    key.hash   = interned_hash  (new_element.first);
+    keys.push_back(key);
+    k = keys.size() - 1;
+    slots[find_slot(new_element.first)] = k;
+  }
+  keys[k].elements.push_back(new_element);
 }
 
 
@@ -98,18 +153,9 @@ const char * dsymtable_c<value_type>::symbol_to_string(const symbol_c *symbol) {
 /* debuging function... */
 template<typename value_type>
 void dsymtable_c<value_type>::print(void) {
-  for(iterator i = _base.begin();
-      i != _base.end();
+  for(iterator i = begin();
+      i != end();
       i++)
     std::cout << i->second << ":" << i->first << "\n";
   std::cout << "=====================\n";
 }
-
-
-
-
-
-
-
-
-
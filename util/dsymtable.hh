@@ -37,50 +37,74 @@
 #define _DSYMTABLE_HH
 
 #include "../absyntax/absyntax.hh"
+#include "../absyntax/intern_pool.hh"
 
-#include <map>
+#include <vector>
 #include <string>
 
 
 
 
+/* The symbol table is an open addressing hash table, indexed by the case insensitive hash of the
+ * identifiers. All identifiers are stored in the intern_pool, so comparing two identifiers is
+ * usually a simple pointer comparison.
+ *
+ * All the entries with the same identifier are stored together (in order of insertion), so
+ * iterating from lower_bound() to upper_bound() visits all the entries of an identifier.
+ */
 template<typename value_type> class dsymtable_c {
-  /* Case insensitive string compare copied from
-   * "The C++ Programming Language" - 3rd Edition
-   * by Bjarne Stroustrup, ISBN 0201889544.
-   */
-  class nocase_c {
-    public:
-      bool operator() (const std::string& x, const std::string& y) const {
-        std::string::const_iterator ix = x.begin();
-        std::string::const_iterator iy = y.begin();
-
-        for(; (ix != x.end()) && (iy != y.end()) && (toupper(*ix) == toupper(*iy)); ++ix, ++iy);
-        if (ix == x.end()) return (iy != y.end());
-        if (iy == y.end()) return false;
-        return (toupper(*ix) < toupper(*iy));
-      };
-  };
-
   public:
     typedef value_type value_t;
 
+    typedef struct {
+      const char *first;   /* the identifier (an interned string) */
+      value_t     second;  /* the value associated to the identifier */
+    } element_t;
+
   private:
-    /* Comparison between identifiers must ignore case, therefore the use of nocase_c */
-    typedef std::multimap<std::string, value_t, nocase_c> base_t;
-    base_t _base;
+    typedef struct {
+      const char            *folded;  /* case folded form of the identifier, used for comparisons */
+      uint32_t               hash;    /* interned_hash() of the identifier */
+      std::vector<element_t> elements;
+    } key_t;
+
+    std::vector<key_t> keys;
+    std::vector<int>   slots;        /* the hash table: index into keys[], or -1 for an empty slot */
+    element_t          end_element;  /* what end() points to. Some code (incorrectly) dereferences end(), and this is safer than crashing */
+
+    int find_slot(const char *identifier_str); /* slot of the identifier, or the empty slot where it should go */
+    int find_key (const char *identifier_str); /* index into keys[], or -1 if not found */
 
   public:
-  typedef typename base_t::iterator iterator;
-  typedef typename base_t::const_iterator const_iterator;
-  typedef typename base_t::reverse_iterator reverse_iterator;
-  typedef typename base_t::const_reverse_iterator const_reverse_iterator;
+  class iterator {
+    friend class dsymtable_c;
+    private:
+      dsymtable_c *table;
+      int          key;  /* -1 for end() */
+      int          pos;
+      iterator(dsymtable_c *table_, int key_, int pos_): table(table_), key(key_), pos(pos_) {}
+    public:
+      iterator(void): table(NULL), key(-1), pos(0) {}
+      element_t &operator* (void) const {return  (key < 0)? table->end_element :  table->keys[key].elements[pos];}
+      element_t *operator->(void) const {return  (key < 0)? &table->end_element : &table->keys[key].elements[pos];}
+      iterator  &operator++(void) {
+        if (++pos >= (int)table->keys[key].elements.size()) {
+          pos = 0;
+          if (++key >= (int)table->keys.size()) key = -1;
+        }
+        return *this;
+      }
+      iterator   operator++(int)        {iterator tmp = *this; ++*this; return tmp;}
+      bool operator==(const iterator &i) const {return (key == i.key) && (pos == i.pos) && ((key < 0) || (table == i.table));}
+      bool operator!=(const iterator &i) const {return !(*this == i);}
+  };
+  typedef iterator const_iterator;
 
   private:
     const char *symbol_to_string(const symbol_c *symbol);
 
   public:
-    dsymtable_c(void) {};
+    dsymtable_c(void);
 
     void reset(void); /* clear all entries... */
     
@@ -89,33 +113,27 @@ template<typename value_type> class dsymtable_c {
 
     /* Determine how many entries are associated to key identifier_str */ 
     /* returns: 0 if no entry is found, 1 if 1 entry is found, ..., n if n entries are found */
-    int count(const char *identifier_str)    {return _base.count(identifier_str);}
+    int count(const char *identifier_str)    {int k = find_key(identifier_str); return (k < 0)? 0 : keys[k].elements.size();}
     int count(const symbol_c *symbol)        {return count(symbol_to_string(symbol));}
     
     /* Search for an entry associated with identifier_str. Will return end() if not found */
-    iterator find(const char *identifier_str)        {return _base.find(identifier_str);}
+    iterator find(const char *identifier_str)        {int k = find_key(identifier_str); return iterator(this, k, 0);}
     iterator find(const symbol_c *symbol)            {return find(symbol_to_string(symbol));}
     
     /* Search for the first entry associated with (i.e. with key ==) identifier_str. Will return end() if not found (NOTE: end() != end_value()) */
-    iterator lower_bound(const char *identifier_str) {return ((count(identifier_str) == 0)? _base.end() : _base.lower_bound(identifier_str));}
+    iterator lower_bound(const char *identifier_str) {return find(identifier_str);}
     iterator lower_bound(const symbol_c *symbol)     {return lower_bound(symbol_to_string(symbol));}
     
-    /* Search for the first entry with key greater than identifier_str. Will return end() if not found */
-    iterator upper_bound(const char *identifier_str) {return ((count(identifier_str) == 0)? _base.end() : _base.upper_bound(identifier_str));}
+    /* Search for the first entry following the last entry associated with identifier_str. Will return end() if not found */
+    iterator upper_bound(const char *identifier_str) {int k = find_key(identifier_str); return iterator(this, ((k < 0) || (k+1 >= (int)keys.size()))? -1 : k+1, 0);}
     iterator upper_bound(const symbol_c *symbol)     {return upper_bound(symbol_to_string(symbol));}
 
     /* get the value to which an iterator is pointing to... */
     value_t get_value(const iterator i) {return i->second;}
 
   /* iterators pointing to beg/end of map... */
-    iterator begin() 			{return _base.begin();}
-    const_iterator begin() const	{return _base.begin();}
-    iterator end()			{return _base.end();}
-    const_iterator end() const 		{return _base.end();}
-    reverse_iterator rbegin()		{return _base.rbegin();}
-    const_reverse_iterator rbegin() const {return _base.rbegin();}
-    reverse_iterator rend() 		{return _base.rend();}
-    const_reverse_iterator rend() const	{return _base.rend();}
+    iterator begin() 			{return iterator(this, keys.empty()? -1 : 0, 0);}
+    iterator end()			{return iterator(this, -1, 0);}
 
     /* debuging function... */
     void print(void);
@@ -33,6 +33,8 @@
 
 
 #include <iostream>
+#include <string.h>
+#include <strings.h>
 #include "symtable.hh"
 #include "../main.hh" // required for ERROR() and ERROR_MSG() macros.
 
@@ -42,23 +44,28 @@
 
 
 template<typename value_type>
-symtable_c<value_type>::symtable_c(void) {inner_scope = NULL;}
+symtable_c<value_type>::symtable_c(void) {
+  slots_used = 0;
+  end_element.first  = NULL;
+  end_element.second = value_t();
+}
 
 
  /* clear all entries... */
 template<typename value_type>
 void symtable_c<value_type>::clear(void) {
-  _base.clear();
+  entries.clear();
+  free_entries.clear();
+  slots.clear();
+  slots_used = 0;
+  undo_log.clear();
+  scope_marks.clear();
 }
 
  /* create new inner scope */
 template<typename value_type>
 void symtable_c<value_type>::push(void) {
-  if (inner_scope != NULL) {
-    inner_scope->push();
-  } else {
-    inner_scope = new symtable_c();
-  }
+  scope_marks.push_back(undo_log.size());
 }
 
   /* clear most inner scope */
@@ -66,25 +73,106 @@ void symtable_c<value_type>::push(void) {
   /*         0 otherwise			*/
 template<typename value_type>
 int symtable_c<value_type>::pop(void) {
-  if (inner_scope != NULL) {
-    if (inner_scope->pop() == 1) {
-      delete inner_scope;
-      inner_scope = NULL;
-    }
-    return 0;
-  } else {
-    _base.clear();
+  if (scope_marks.empty()) {
+    clear();
     return 1;
   }
+
+  /* undo all insertions done in the inner most scope, most recent first */
+  int mark = scope_marks.back();
+  scope_marks.pop_back();
+  for (int i = undo_log.size() - 1; i >= mark; i--) {
+    int      e    = undo_log[i];
+    entry_t &entry = entries[e];
+    int      slot = find_slot(entry.element.first, entry.hash, entry.folded);
+    if (slots[slot] != e) ERROR; /* the entry being removed is not visible! */
+    if (entry.shadowed >= 0) {
+      entries[entry.shadowed].hidden = false;
+      slots[slot] = entry.shadowed;
+    } else {
+      slots[slot] = DELETED_SLOT;
+    }
+    entry.used = false;
+    free_entries.push_back(e);
+  }
+  undo_log.resize(mark);
+  return 0;
 }
 
+
+/* Returns the slot containing the identifier, or if not in the table, the slot where it should be placed */
 template<typename value_type>
-void symtable_c<value_type>::set(const symbol_c *symbol, value_t new_value) {
-  if (inner_scope != NULL) {
-    inner_scope->set(symbol, new_value);
-    return;
+int symtable_c<value_type>::find_slot(const char *identifier_str, uint32_t hash, const char *folded) {
+  int mask    = slots.size() - 1;
+  int deleted = -1;
+  for (int slot = hash & mask; ; slot = (slot + 1) & mask) {
+    int e = slots[slot];
+    if (e == EMPTY_SLOT)   return (deleted >= 0)? deleted : slot;
+    if (e == DELETED_SLOT) {if (deleted < 0) deleted = slot; continue;}
+    if (entries[e].hash != hash) continue;
+    /* interned strings are equal if they have the same case folded form */
+    if ((NULL != folded)? (entries[e].folded == folded) : (strcasecmp(entries[e].element.first, identifier_str) == 0))
+      return slot;
   }
+}
+
+
+/* Returns the visible entry for the identifier, or -1 if not found */
+template<typename value_type>
+int symtable_c<value_type>::find_entry(const char *identifier_str) {
+  if (slots.empty()) return -1;
+  const char *folded = interned_folded(identifier_str);
+  uint32_t    hash   = (NULL != folded)? interned_hash(identifier_str) : nocase_hash(identifier_str, strlen(identifier_str));
+  return slots[find_slot(identifier_str, hash, folded)];  /* EMPTY_SLOT and DELETED_SLOT are both < 0 */
+}
+
 
+template<typename value_type>
+int symtable_c<value_type>::new_entry(const char *identifier_str, value_t value, int level) {
+  entry_t entry;
+  entry.element.first  = intern_string(identifier_str);
+  entry.element.second = value;
+  entry.folded         = interned_folded(entry.element.first);
+  entry.hash           = interned_hash  (entry.element.first);
+  entry.level          = level;
+  entry.shadowed       = -1;
+  entry.hidden         = false;
+  entry.used           = true;
+
+  if (free_entries.empty()) {
+    entries.push_back(entry);
+    return entries.size() - 1;
+  }
+  int e = free_entries.back();
+  free_entries.pop_back();
+  entries[e] = entry;
+  return e;
+}
+
+
+/* Rebuild the hash table, with enough free slots to add new entries. */
+template<typename value_type>
+void symtable_c<value_type>::rehash(void) {
+  int visible = 0;
+  for (unsigned int e = 0; e < entries.size(); e++)
+    if (entries[e].used && !entries[e].hidden) visible++;
+
+  unsigned int size = 64;
+  while (size < 4 * (unsigned int)visible) size *= 2;
+  slots.assign(size, EMPTY_SLOT);
+  slots_used = 0;
+  for (unsigned int e = 0; e < entries.size(); e++)
+    if (entries[e].used && !entries[e].hidden) {
+      int slot;
+      for (slot = entries[e].hash & (size - 1); slots[slot] != EMPTY_SLOT; slot = (slot + 1) & (size - 1));
+      slots[slot] = e;
+      slots_used++;
+    }
+}
+
+
+template<typename value_type>
+void symtable_c<value_type>::set(const symbol_c *symbol, value_t new_value) {
   const token_c *name = dynamic_cast<const token_c *>(symbol);
   if (name == NULL)
     ERROR;
@@ -94,46 +182,45 @@ void symtable_c<value_type>::set(const symbol_c *symbol, value_t new_value) {
 
 template<typename value_type>
 void symtable_c<value_type>::set(const char *identifier_str, value_t new_value) {
-  if (inner_scope != NULL) {
-    inner_scope->set(identifier_str, new_value);
-    return;
-  }
-
   // std::cout << "set_identifier(" << identifier_str << "): \n";
-  iterator i = _base.find(identifier_str);
-  if (i == _base.end())
-    /* identifier not already in map! */
+  int e = find_entry(identifier_str);
+  if ((e < 0) || (entries[e].level != (int)scope_marks.size()))
+    /* identifier not already in map (of the current inner most scope)! */
     ERROR;
 
-  _base[identifier_str] = new_value;
+  entries[e].element.second = new_value;
 }
 
 template<typename value_type>
 void symtable_c<value_type>::insert(const char *identifier_str, value_t new_value) {
-  if (inner_scope != NULL) {
-    inner_scope->insert(identifier_str, new_value);
-    return;
-  }
-
   // std::cout << "store_identifier(" << identifier_str << "): \n";
-  iterator i = _base.find(identifier_str);
-  if ((i != _base.end()) && (i->second != new_value)) {ERROR;}  /* error inserting new identifier: identifier already in map associated to a different value */
-  if ((i != _base.end()) && (i->second == new_value)) {return;} /* identifier already in map associated with the same value */
+  int level = scope_marks.size();
+  if ((int)slots.size() < 2 * (slots_used + 1)) rehash();
+
+  const char *folded = interned_folded(identifier_str);
+  uint32_t    hash   = (NULL != folded)? interned_hash(identifier_str) : nocase_hash(identifier_str, strlen(identifier_str));
+  int         slot   = find_slot(identifier_str, hash, folded);
+  int         old    = slots[slot];
 
-  std::pair<const char *, value_t> new_element(identifier_str, new_value);
-  std::pair<iterator, bool> res = _base.insert(new_element);
-  if (!res.second) {ERROR;} /* unknown error inserting new identifier */
+  if ((old >= 0) && (entries[old].level == level)) {
+    if (entries[old].element.second != new_value) {ERROR;}  /* error inserting new identifier: identifier already in map associated to a different value */
+    return;                                                 /* identifier already in map associated with the same value */
+  }
+
+  int e = new_entry(identifier_str, new_value, level);
+  if (old >= 0) {
+    /* shadow the entry of an outer scope */
+    entries[old].hidden = true;
+    entries[e].shadowed = old;
+  } else if (old == EMPTY_SLOT) {
+    slots_used++;
+  }
+  slots[slot] = e;
+  if (level > 0) undo_log.push_back(e);
 }
 
 template<typename value_type>
 void symtable_c<value_type>::insert(const symbol_c *symbol, value_t new_value) {
-/*
-// not required...
-  if (inner_scope != NULL) {
-    inner_scope->insert(symbol, new_value);
-    return;
-  }
-*/
   const token_c *name = dynamic_cast<const token_c *>(symbol);
   if (name == NULL)
     ERROR;
@@ -142,43 +229,61 @@ void symtable_c<value_type>::insert(const symbol_c *symbol, value_t new_value) {
 
 
 template<typename value_type>
-int symtable_c<value_type>::count(const       char *identifier_str) {return _base.count(identifier_str)+((inner_scope == NULL)?0:inner_scope->count(identifier_str));}
+int symtable_c<value_type>::count(const       char *identifier_str) {
+  int res = 0;
+  for (int e = find_entry(identifier_str); e >= 0; e = entries[e].shadowed) res++;
+  return res;
+}
+
 template<typename value_type>
-int symtable_c<value_type>::count(const std::string identifier_str) {return _base.count(identifier_str)+((inner_scope == NULL)?0:inner_scope->count(identifier_str));}
+int symtable_c<value_type>::count(const std::string identifier_str) {return count(identifier_str.c_str());}
 
 
-// in the operator[] we delegate to find(), since that method will also search in the inner scopes!
 template<typename value_type>
-typename symtable_c<value_type>::value_t& symtable_c<value_type>::operator[] (const       char *identifier_str) {iterator i = find(identifier_str); return (i!=end())?i->second:_base[identifier_str];}
+typename symtable_c<value_type>::value_t& symtable_c<value_type>::operator[] (const       char *identifier_str) {
+  int e = find_entry(identifier_str);
+  if (e >= 0) return entries[e].element.second;
+
+  /* Not yet in the map. Like std::map, insert a new entry with the default value.
+   * NOTE: the new entry goes into the outer most scope, so it is not removed by pop().
+   *       This is safe, as the identifier is not present in any scope.
+   */
+  if ((int)slots.size() < 2 * (slots_used + 1)) rehash();
+  e = new_entry(identifier_str, value_t(), 0);
+  entry_t &entry = entries[e];
+  int slot = find_slot(entry.element.first, entry.hash, entry.folded);
+  if (slots[slot] == EMPTY_SLOT) slots_used++;
+  slots[slot] = e;
+  return entry.element.second;
+}
+
 template<typename value_type>
-typename symtable_c<value_type>::value_t& symtable_c<value_type>::operator[] (const std::string identifier_str) {iterator i = find(identifier_str); return (i!=end())?i->second:_base[identifier_str];}
+typename symtable_c<value_type>::value_t& symtable_c<value_type>::operator[] (const std::string identifier_str) {return (*this)[identifier_str.c_str()];}
 
 
 template<typename value_type>
-typename symtable_c<value_type>::iterator symtable_c<value_type>::end  (void) {return _base.end  ();}
+int symtable_c<value_type>::next_visible(int pos) {
+  for (pos++; pos < (int)entries.size(); pos++)
+    if (entries[pos].used && !entries[pos].hidden) return pos;
+  return -1;
+}
 
 template<typename value_type>
-typename symtable_c<value_type>::iterator symtable_c<value_type>::begin(void) {return _base.begin();}
+typename symtable_c<value_type>::iterator symtable_c<value_type>::end  (void) {return iterator(this, -1);}
+
+template<typename value_type>
+typename symtable_c<value_type>::iterator symtable_c<value_type>::begin(void) {return iterator(this, next_visible(-1));}
 
 /* returns end() if not found! */
 template<typename value_type>
 typename symtable_c<value_type>::iterator symtable_c<value_type>::find(const       char *identifier_str) {
-  iterator i;
-  if ((inner_scope != NULL) && ((i = inner_scope->find(identifier_str)) != inner_scope->end()))  // NOTE: must use the end() value of the inner scope!
-      return i;  // found in the lower level
-  /* if no lower level, or not found in lower level... */
-  return _base.find(identifier_str);
+  int e = find_entry(identifier_str);
+  return iterator(this, (e >= 0)? e : -1);
 }
 
 
 template<typename value_type>
-typename symtable_c<value_type>::iterator symtable_c<value_type>::find(const std::string identifier_str) {
-  iterator i;
-  if ((inner_scope != NULL) && ((i = inner_scope->find(identifier_str)) != inner_scope->end()))  // NOTE: must use the end() value of the inner scope!
-      return i;  // found in the lower level
-  /* if no lower level, or not found in lower level... */
-  return _base.find(identifier_str);
-}
+typename symtable_c<value_type>::iterator symtable_c<value_type>::find(const std::string identifier_str) {return find(identifier_str.c_str());}
 
 
 template<typename value_type>
@@ -194,21 +299,8 @@ typename symtable_c<value_type>::iterator symtable_c<value_type>::find(const   s
 /* debuging function... */
 template<typename value_type>
 void symtable_c<value_type>::print(void) {
-  for(iterator i = _base.begin();
-      i != _base.end();
-      i++)
-    std::cout << i->second << ":" << i->first << "\n";
+  for (unsigned int e = 0; e < entries.size(); e++)
+    if (entries[e].used)
+      std::cout << entries[e].element.second << ":" << entries[e].element.first << " (level " << entries[e].level << (entries[e].hidden? ", hidden)\n" : ")\n");
   std::cout << "=====================\n";
-
-  if (inner_scope != NULL) {
-    inner_scope->print();
-  }
 }
-
-
-
-
-
-
-
-
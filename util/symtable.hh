@@ -35,48 +35,78 @@
 #define _SYMTABLE_HH
 
 #include "../absyntax/absyntax.hh"
+#include "../absyntax/intern_pool.hh"
 
-#include <map>
+#include <deque>
+#include <vector>
 #include <string>
 
 
 
 
+/* The symbol table is an open addressing hash table, indexed by the case insensitive hash of the
+ * identifiers. All identifiers are stored in the intern_pool, so comparing two identifiers is
+ * usually a simple pointer comparison.
+ *
+ * Scopes are handled with an undo log: entries inserted in an inner scope shadow (i.e. hide) any
+ * entry with the same name in the outer scopes, and pop() simply undoes all the insertions done
+ * since the matching push(). A lookup therefore never has to walk through the scope levels.
+ */
 template<typename value_type> class symtable_c {
-  /* Case insensitive string compare copied from
-   * "The C++ Programming Language" - 3rd Edition
-   * by Bjarne Stroustrup, ISBN 0201889544.
-   */
-  class nocase_c {
-    public:
-      bool operator() (const std::string& x, const std::string& y) const {
-        std::string::const_iterator ix = x.begin();
-        std::string::const_iterator iy = y.begin();
-
-        for(; (ix != x.end()) && (iy != y.end()) && (toupper(*ix) == toupper(*iy)); ++ix, ++iy);
-        if (ix == x.end()) return (iy != y.end());
-        if (iy == y.end()) return false;
-        return (toupper(*ix) < toupper(*iy));
-      };
-  };
-
   public:
     typedef value_type value_t;
 
+    typedef struct {
+      const char *first;   /* the identifier (an interned string) */
+      value_t     second;  /* the value associated to the identifier */
+    } element_t;
+
   private:
-    /* Comparison between identifiers must ignore case, therefore the use of nocase_c */
-    typedef std::map<std::string, value_t, nocase_c> base_t;
-    base_t _base;
+    typedef struct {
+      element_t   element;
+      const char *folded;   /* case folded form of the identifier, used for comparisons */
+      uint32_t    hash;     /* interned_hash() of the identifier */
+      int         level;    /* scope level in which the entry was inserted */
+      int         shadowed; /* the entry (of an outer scope) hidden by this one, or -1 */
+      bool        hidden;   /* true if shadowed by an entry of an inner scope */
+      bool        used;     /* false if this is a free entry */
+    } entry_t;
+
+    std::deque <entry_t> entries;     /* NOTE: a deque, so references to the values remain valid when new entries are added */
+    std::vector<int>     free_entries;
+    std::vector<int>     slots;       /* the hash table: index of the visible entry, or one of EMPTY_SLOT, DELETED_SLOT */
+    int                  slots_used;  /* number of slots not set to EMPTY_SLOT */
+    std::vector<int>     undo_log;    /* the entries inserted in any inner scope, in order of insertion */
+    std::vector<int>     scope_marks; /* size of undo_log when each inner scope was created */
+    element_t            end_element; /* what end() points to. Some code (incorrectly) dereferences end(), and this is safer than crashing */
+
+    enum {EMPTY_SLOT = -1, DELETED_SLOT = -2};
+
+    int  find_slot  (const char *identifier_str, uint32_t hash, const char *folded); /* slot of the identifier, or the empty slot where it should go */
+    int  find_entry (const char *identifier_str);
+    int  new_entry  (const char *identifier_str, value_t value, int level);
+    void rehash     (void);
 
   public:
-  typedef typename base_t::iterator iterator;
-  typedef typename base_t::const_iterator const_iterator;
-  typedef typename base_t::reverse_iterator reverse_iterator;
-  typedef typename base_t::const_reverse_iterator const_reverse_iterator;
+  class iterator {
+    friend class symtable_c;
+    private:
+      symtable_c *table;
+      int         pos;    /* -1 for end() */
+      iterator(symtable_c *table_, int pos_): table(table_), pos(pos_) {}
+    public:
+      iterator(void): table(NULL), pos(-1) {}
+      element_t &operator* (void) const {return  (pos < 0)? table->end_element :  table->entries[pos].element;}
+      element_t *operator->(void) const {return  (pos < 0)? &table->end_element : &table->entries[pos].element;}
+      iterator  &operator++(void)       {pos = table->next_visible(pos); return *this;}
+      iterator   operator++(int)        {iterator tmp = *this; ++*this; return tmp;}
+      bool operator==(const iterator &i) const {return (pos == i.pos) && ((pos < 0) || (table == i.table));}
+      bool operator!=(const iterator &i) const {return !(*this == i);}
+  };
+  typedef iterator const_iterator;
 
   private:
-      /* pointer to symbol table of the next inner scope */
-    symtable_c *inner_scope;
+    int next_visible(int pos);
 
   public:
     symtable_c(void);
@@ -104,27 +134,15 @@ template<typename value_type> class symtable_c {
  // int count(const   symbol_c *identifier    ); // not yet implemented
     
     /* Search for an entry. Will return end() if not found */
+    /* NOTE: iterating from begin() to end() visits all visible entries (i.e. those not shadowed by
+     *       an entry in an inner scope), in no particular order.
+     */
     iterator               begin(void);
     iterator               end  (void);
     iterator               find (const char       *identifier_str);
     iterator               find (const std::string identifier_str);
     iterator               find (const symbol_c   *symbol        );
 
-
-  /* iterators ... */
-  /* NOTE: These member functions are incorrect, as the returned iterator will not iterate through the inner_scopes!! */
-  /*       We simply comment it all out, as they are not currently needed!                                            */
-  #if 0
-    iterator               find (const char *identifier_str)
-    iterator               begin()                          
-    const_iterator         begin()  const                   
-    iterator               end()                            
-    const_iterator         end()    const                   
-    reverse_iterator       rbegin()                         
-    const_reverse_iterator rbegin() const                   
-    reverse_iterator       rend()                           
-    const_reverse_iterator rend()   const                   
-  #endif
     /* debuging function... */
     void print(void);
 };